@@ -0,0 +1,67 @@
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Link-time and profile-guided optimization of the SDK libraries.
+#
+# configure_optimization(<target>) applies to <target>:
+# - Link-time optimization (IPO), when option LTO is ON and the compiler supports it. This lets the
+#   compiler inline the span helpers and other small functions across the source files.
+# - Profile-guided optimization, when PGO is set to GENERATE or USE, with GCC or clang:
+#   - GENERATE instruments the code, so that running it writes profiles into PGO_PROFILE_DIR.
+#   - USE optimizes the code with the profiles found in PGO_PROFILE_DIR.
+#   With clang, the raw profiles must be merged into PGO_PROFILE_DIR/default.profdata with
+#   `llvm-profdata merge` before building with USE.
+#
+
+set(PGO "" CACHE STRING "Profile-guided optimization phase: GENERATE, USE or empty to disable")
+set_property(CACHE PGO PROPERTY STRINGS "" GENERATE USE)
+set(PGO_PROFILE_DIR "${CMAKE_BINARY_DIR}/pgo-profiles" CACHE PATH
+    "Directory the profiles are written to, and read from, by profile-guided optimization builds")
+
+if(LTO)
+  include(CheckIPOSupported)
+  check_ipo_supported(RESULT AZ_IPO_SUPPORTED OUTPUT AZ_IPO_OUTPUT LANGUAGES C)
+  if(NOT AZ_IPO_SUPPORTED)
+    message(WARNING "LTO is not supported by this toolchain and will be ignored: ${AZ_IPO_OUTPUT}")
+  endif()
+endif()
+
+set(AZ_PGO_COMPILE_OPTIONS "")
+set(AZ_PGO_LINK_OPTIONS "")
+if(PGO STREQUAL "GENERATE")
+  if(CMAKE_C_COMPILER_ID MATCHES "GNU|Clang")
+    set(AZ_PGO_COMPILE_OPTIONS "-fprofile-generate=${PGO_PROFILE_DIR}")
+    set(AZ_PGO_LINK_OPTIONS "-fprofile-generate=${PGO_PROFILE_DIR}")
+  else()
+    message(WARNING "PGO is only supported with GCC and clang and will be ignored.")
+  endif()
+elseif(PGO STREQUAL "USE")
+  if(CMAKE_C_COMPILER_ID MATCHES "GNU")
+    # Functions the training workload never reached have no profile, which is expected.
+    set(AZ_PGO_COMPILE_OPTIONS
+      "-fprofile-use=${PGO_PROFILE_DIR}" -fprofile-correction -Wno-missing-profile)
+  elseif(CMAKE_C_COMPILER_ID MATCHES "Clang")
+    set(AZ_PGO_COMPILE_OPTIONS
+      "-fprofile-use=${PGO_PROFILE_DIR}/default.profdata"
+      -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date)
+  else()
+    message(WARNING "PGO is only supported with GCC and clang and will be ignored.")
+  endif()
+elseif(NOT PGO STREQUAL "")
+  message(FATAL_ERROR "PGO must be GENERATE, USE or empty, not '${PGO}'.")
+endif()
+
+function(configure_optimization target)
+  if(LTO AND AZ_IPO_SUPPORTED)
+    set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION ON)
+  endif()
+
+  if(AZ_PGO_COMPILE_OPTIONS)
+    target_compile_options(${target} PRIVATE ${AZ_PGO_COMPILE_OPTIONS})
+  endif()
+
+  # The instrumented libraries need the profiling runtime, wherever they are linked.
+  if(AZ_PGO_LINK_OPTIONS)
+    target_link_libraries(${target} PUBLIC ${AZ_PGO_LINK_OPTIONS})
+  endif()
+endfunction()
@@ -0,0 +1,38 @@
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Stack usage report of the SDK libraries.
+#
+# configure_stack_usage(<target>), when option STACK_USAGE is ON, makes GCC write the stack frame
+# of every function (.su) and the call graph (.ci) of <target> next to its object files. The
+# az_stack_usage_report target then adds up the frames along the deepest call chain of every public
+# function into <build directory>/stack_usage.txt. This requires GCC 10 or later, and Python 3.
+#
+
+set(AZ_STACK_USAGE_SUPPORTED OFF)
+if(STACK_USAGE)
+  find_program(AZ_PYTHON3 NAMES python3 python)
+  if(NOT CMAKE_C_COMPILER_ID STREQUAL "GNU" OR CMAKE_C_COMPILER_VERSION VERSION_LESS 10)
+    message(WARNING "STACK_USAGE requires GCC 10 or later and will be ignored.")
+  elseif(NOT AZ_PYTHON3)
+    message(WARNING "STACK_USAGE requires Python 3 and will be ignored.")
+  else()
+    set(AZ_STACK_USAGE_SUPPORTED ON)
+    add_custom_target(az_stack_usage_report
+      COMMAND ${AZ_PYTHON3} ${CMAKE_CURRENT_LIST_DIR}/../eng/scripts/stack_usage_report.py
+        --output ${CMAKE_BINARY_DIR}/stack_usage.txt
+        "$<TARGET_PROPERTY:az_stack_usage_report,AZ_STACK_USAGE_DIRECTORIES>"
+      COMMENT "Writing the stack usage of the SDK functions to ${CMAKE_BINARY_DIR}/stack_usage.txt"
+      COMMAND_EXPAND_LISTS
+      VERBATIM)
+  endif()
+endif()
+
+function(configure_stack_usage target)
+  if(AZ_STACK_USAGE_SUPPORTED)
+    target_compile_options(${target} PRIVATE -fstack-usage -fcallgraph-info=su)
+    set_property(TARGET az_stack_usage_report APPEND PROPERTY
+      AZ_STACK_USAGE_DIRECTORIES ${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/${target}.dir)
+    add_dependencies(az_stack_usage_report ${target})
+  endif()
+endfunction()
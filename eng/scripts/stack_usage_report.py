@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# SPDX-License-Identifier: MIT
+
+"""Reports the worst-case stack usage of the public SDK functions.
+
+Reads the call graphs (.ci) written by GCC with -fcallgraph-info=su, as configured by the
+STACK_USAGE CMake option, and adds up the stack frames along the deepest call chain of every
+public az_ function. The result is a lower bound when a function is flagged:
+
+  dynamic    its frame depends on run-time values (e.g. variable length arrays)
+  indirect   it calls through a function pointer (callbacks, HTTP policies), not followed
+  external   it calls functions outside the SDK libraries (libc, platform), counted as 0
+  recursive  its call graph has a cycle, followed once
+"""
+
+import argparse
+import os
+import re
+import sys
+
+_NODE = re.compile(r'^node: \{ title: "([^"]*)" label: "([^"]*)"')
+_EDGE = re.compile(r'^edge: \{ sourcename: "([^"]*)" targetname: "([^"]*)"(?: label: "([^"]*)")?')
+_FRAME = re.compile(r'\\n(\d+) bytes \(([a-z,]+)\)$')
+
+_INDIRECT_CALL = "__indirect_call"
+
+# A failed precondition calls the callback it gets from this function, and never returns.
+_PRECONDITION_CALLBACK = "az_precondition_failed_get_callback"
+
+
+class Function:
+    def __init__(self, name, location, frame, qualifier):
+        self.name = name
+        self.location = location
+        self.frame = frame
+        self.dynamic = qualifier != "static"
+        self.callees = []
+
+
+def read_call_graphs(directories):
+    functions = {}
+    edges = []
+    for directory in directories:
+        for root, _, files in os.walk(directory):
+            for file_name in files:
+                if not file_name.endswith(".ci"):
+                    continue
+                with open(os.path.join(root, file_name)) as call_graph:
+                    for line in call_graph:
+                        node = _NODE.match(line)
+                        if node:
+                            frame = _FRAME.search(node.group(2))
+                            if frame:
+                                label = node.group(2).split("\\n")
+                                functions[node.group(1)] = Function(
+                                    label[0], label[1], int(frame.group(1)), frame.group(2))
+                            continue
+                        edge = _EDGE.match(line)
+                        if edge:
+                            edges.append((edge.group(1), edge.group(2), edge.group(3)))
+
+    preconditions = {
+        (source, at) for source, target, at in edges if target == _PRECONDITION_CALLBACK
+    }
+    for source, target, at in edges:
+        if target == _INDIRECT_CALL and (source, at) in preconditions:
+            continue
+        if source in functions and target not in functions[source].callees:
+            functions[source].callees.append(target)
+    return functions
+
+
+def worst_case(functions, title, results, visiting):
+    """Returns (stack, flags, deepest callee title) of the function, memoized in results."""
+    if title in results:
+        return results[title]
+
+    function = functions[title]
+    flags = {"dynamic"} if function.dynamic else set()
+    deepest_stack = 0
+    deepest_callee = None
+
+    visiting.add(title)
+    for callee in function.callees:
+        if callee == _INDIRECT_CALL:
+            flags.add("indirect")
+        elif callee not in functions:
+            flags.add("external")
+        elif callee in visiting:
+            flags.add("recursive")
+        else:
+            stack, callee_flags, _ = worst_case(functions, callee, results, visiting)
+            flags |= callee_flags
+            if stack > deepest_stack:
+                deepest_stack = stack
+                deepest_callee = callee
+    visiting.discard(title)
+
+    results[title] = (function.frame + deepest_stack, flags, deepest_callee)
+    return results[title]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("directories", nargs="+", help="directories searched for .ci files")
+    parser.add_argument("--output", help="file the report is written to, instead of stdout")
+    parser.add_argument(
+        "--all", action="store_true", help="also report the internal and static functions")
+    arguments = parser.parse_args()
+
+    functions = read_call_graphs(arguments.directories)
+    if not functions:
+        sys.exit("No call graph found. Build with the STACK_USAGE option and GCC 10 or later.")
+
+    results = {}
+    rows = []
+    for title, function in functions.items():
+        # Static functions are titled with their file, public ones with their name only.
+        public = title == function.name and function.name.startswith("az_")
+        if public or arguments.all:
+            stack, flags, deepest_callee = worst_case(functions, title, results, set())
+
+            chain = []
+            while deepest_callee is not None:
+                chain.append(functions[deepest_callee].name)
+                deepest_callee = results[deepest_callee][2]
+
+            rows.append((stack, function, sorted(flags), chain))
+
+    rows.sort(key=lambda row: (-row[0], row[1].name))
+    lines = ["%8s %8s  %-60s %s" % ("worst", "frame", "function", "flags")]
+    for stack, function, flags, chain in rows:
+        lines.append("%8d %8d  %-60s %s" % (stack, function.frame, function.name, ",".join(flags)))
+        if chain:
+            lines.append("%18s-> %s" % ("", " -> ".join(chain)))
+
+    report = "\n".join(lines) + "\n"
+    if arguments.output:
+        with open(arguments.output, "w") as output:
+            output.write(report)
+    else:
+        sys.stdout.write(report)
+
+
+if __name__ == "__main__":
+    main()
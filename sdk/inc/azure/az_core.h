@@ -15,13 +15,17 @@
 #ifndef _az_CORE_H
 #define _az_CORE_H
 
+#include <azure/core/az_arena.h>
+#include <azure/core/az_cbor.h>
 #include <azure/core/az_config.h>
 #include <azure/core/az_context.h>
 #include <azure/core/az_credentials.h>
 #include <azure/core/az_http.h>
+#include <azure/core/az_http_instrumentation.h>
 #include <azure/core/az_http_transport.h>
 #include <azure/core/az_json.h>
 #include <azure/core/az_log.h>
+#include <azure/core/az_msgpack.h>
 #include <azure/core/az_platform.h>
 #include <azure/core/az_precondition.h>
 #include <azure/core/az_result.h>
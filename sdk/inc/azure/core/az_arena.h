@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief A bump allocator carving buffers out of a single #az_span.
+ *
+ * @details An arena lets all the buffers used to send one HTTP request (the URL, the headers and
+ * the response buffers of an #az_http_request and #az_http_response, along with what the transport
+ * needs to send them) come from one buffer, sized once, instead of being sized separately or
+ * allocated from the heap. Once the request completes, #az_arena_reset() frees all of them at once.
+ *
+ * @note You MUST NOT use any symbols (macros, functions, structures, enums, etc.)
+ * prefixed with an underscore ('_') directly in your application code. These symbols
+ * are part of Azure SDK's internal implementation; we do not document these symbols
+ * and they are subject to change in future versions of the SDK which would break your code.
+ */
+
+#ifndef _az_ARENA_H
+#define _az_ARENA_H
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/**
+ * @brief A buffer that smaller buffers are allocated from, one after the other, and that are all
+ * freed together.
+ *
+ * @remarks An arena is not thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span buffer;
+    int32_t used;
+  } _internal;
+} az_arena;
+
+/**
+ * @brief Creates an #az_arena allocating from \p buffer.
+ *
+ * @param[in] buffer The #az_span all the allocations are carved from. It must outlive the arena
+ * and everything allocated from it.
+ *
+ * @return An empty #az_arena.
+ */
+AZ_NODISCARD az_arena az_arena_create(az_span buffer);
+
+/**
+ * @brief Allocates \p size bytes from \p ref_arena.
+ *
+ * @remarks Allocations are aligned for any of the integer, floating point and pointer types, so
+ * that structures can be placed in them.
+ *
+ * @param[in,out] ref_arena The #az_arena to allocate from.
+ * @param[in] size The number of bytes to allocate.
+ * @param[out] out_span The allocated #az_span, of exactly \p size bytes.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The arena doesn't have \p size bytes left.
+ */
+AZ_NODISCARD az_result az_arena_allocate(az_arena* ref_arena, int32_t size, az_span* out_span);
+
+/**
+ * @brief Frees everything allocated from \p ref_arena, so that its whole buffer can be allocated
+ * again.
+ *
+ * @param[in,out] ref_arena The #az_arena to reset.
+ */
+AZ_INLINE void az_arena_reset(az_arena* ref_arena) { ref_arena->_internal.used = 0; }
+
+/**
+ * @brief Gets the number of bytes allocated from an #az_arena, including alignment padding, since
+ * it was created or last reset.
+ *
+ * @param[in] arena The #az_arena to query.
+ *
+ * @return The number of bytes in use.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_arena_get_used(az_arena const* arena)
+{
+  return arena->_internal.used;
+}
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_ARENA_H
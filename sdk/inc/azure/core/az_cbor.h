@@ -0,0 +1,493 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief This header defines the types and functions your application uses to read or write CBOR
+ * (Concise Binary Object Representation, https://tools.ietf.org/html/rfc8949) data items, a
+ * compact binary alternative to JSON for telemetry payloads.
+ *
+ * @note You MUST NOT use any symbols (macros, functions, structures, enums, etc.)
+ * prefixed with an underscore ('_') directly in your application code. These symbols
+ * are part of Azure SDK's internal implementation; we do not document these symbols
+ * and they are subject to change in future versions of the SDK which would break your code.
+ */
+
+#ifndef _az_CBOR_H
+#define _az_CBOR_H
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/**
+ * @brief The maximum depth of nested arrays and maps the #az_cbor_writer can write.
+ */
+#define _az_CBOR_WRITER_MAX_NESTING_DEPTH 64
+
+/**
+ * @brief The maximum depth of nested arrays and maps the #az_cbor_reader can read.
+ */
+#define _az_CBOR_READER_MAX_NESTING_DEPTH 16
+
+/**
+ * @brief Defines symbols for the various kinds of CBOR tokens that make up any CBOR data item.
+ */
+typedef enum
+{
+  AZ_CBOR_TOKEN_NONE, ///< There is no value (as distinct from #AZ_CBOR_TOKEN_NULL).
+  AZ_CBOR_TOKEN_UNSIGNED, ///< The token kind is an unsigned integer (major type 0).
+  AZ_CBOR_TOKEN_NEGATIVE, ///< The token kind is a negative integer (major type 1).
+  AZ_CBOR_TOKEN_BYTE_STRING, ///< The token kind is a byte string (major type 2).
+  AZ_CBOR_TOKEN_TEXT_STRING, ///< The token kind is a UTF-8 text string (major type 3).
+  AZ_CBOR_TOKEN_BEGIN_ARRAY, ///< The token kind is the start of an array (major type 4).
+  AZ_CBOR_TOKEN_END_ARRAY, ///< The token kind is the end of an array.
+  AZ_CBOR_TOKEN_BEGIN_MAP, ///< The token kind is the start of a map (major type 5).
+  AZ_CBOR_TOKEN_END_MAP, ///< The token kind is the end of a map.
+  AZ_CBOR_TOKEN_FALSE, ///< The token kind is the simple value `false`.
+  AZ_CBOR_TOKEN_TRUE, ///< The token kind is the simple value `true`.
+  AZ_CBOR_TOKEN_NULL, ///< The token kind is the simple value `null`.
+  AZ_CBOR_TOKEN_FLOAT, ///< The token kind is a half, single or double precision float.
+} az_cbor_token_kind;
+
+/**
+ * @brief Represents a CBOR token. The kind field indicates the type of the CBOR token and the slice
+ * represents the portion of the CBOR payload that holds the token value.
+ *
+ * @remarks An instance of #az_cbor_token must not outlive the lifetime of the #az_cbor_reader it
+ * came from.
+ */
+typedef struct
+{
+  /// This read-only field gives access to the content of a byte or text string, and it shouldn't
+  /// be modified by the caller. For any other token kind, it's the encoded head of the data item.
+  az_span slice;
+
+  // Avoid using enum as the first field within structs, to allow for { 0 } initialization.
+  // This is a workaround for IAR compiler warning [Pe188]: enumerated type mixed with another type.
+
+  /// This read-only field gives access to the type of the token returned by the #az_cbor_reader,
+  /// and it shouldn't be modified by the caller.
+  az_cbor_token_kind kind;
+
+  /// This read-only field gives the number of items of an array or the number of entries of a map
+  /// starting at this token, or -1 if it has an indefinite length. It is 0 for any other token.
+  int32_t size;
+
+  struct
+  {
+    /// The argument of the data item head: the value of an integer, or the bits of a float.
+    uint64_t argument;
+
+    /// The number of bytes of a float (2, 4 or 8). It is meaningless for any other token kind.
+    int32_t float_size;
+  } _internal;
+} az_cbor_token;
+
+/**
+ * @brief Gets the value of the CBOR token as a `uint64_t`.
+ *
+ * @param[in] cbor_token A pointer to an #az_cbor_token instance.
+ * @param[out] out_value A pointer to a variable to receive the value.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The integer value is returned.
+ * @retval #AZ_ERROR_CBOR_INVALID_STATE The kind is not #AZ_CBOR_TOKEN_UNSIGNED.
+ */
+AZ_NODISCARD az_result
+az_cbor_token_get_uint64(az_cbor_token const* cbor_token, uint64_t* out_value);
+
+/**
+ * @brief Gets the value of the CBOR token as an `int64_t`.
+ *
+ * @param[in] cbor_token A pointer to an #az_cbor_token instance.
+ * @param[out] out_value A pointer to a variable to receive the value.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The integer value is returned.
+ * @retval #AZ_ERROR_CBOR_INVALID_STATE The kind is not #AZ_CBOR_TOKEN_UNSIGNED or
+ * #AZ_CBOR_TOKEN_NEGATIVE.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR The value doesn't fit in an `int64_t`.
+ */
+AZ_NODISCARD az_result az_cbor_token_get_int64(az_cbor_token const* cbor_token, int64_t* out_value);
+
+/**
+ * @brief Gets the value of the CBOR token as a `double`.
+ *
+ * @param[in] cbor_token A pointer to an #az_cbor_token instance.
+ * @param[out] out_value A pointer to a variable to receive the value.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value is returned.
+ * @retval #AZ_ERROR_CBOR_INVALID_STATE The kind is not #AZ_CBOR_TOKEN_FLOAT,
+ * #AZ_CBOR_TOKEN_UNSIGNED or #AZ_CBOR_TOKEN_NEGATIVE.
+ *
+ * @remarks Integers are converted, with a loss of precision beyond 2^53.
+ */
+AZ_NODISCARD az_result az_cbor_token_get_double(az_cbor_token const* cbor_token, double* out_value);
+
+/**
+ * @brief Gets the value of the CBOR token as a `bool`.
+ *
+ * @param[in] cbor_token A pointer to an #az_cbor_token instance.
+ * @param[out] out_value A pointer to a variable to receive the value.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The boolean value is returned.
+ * @retval #AZ_ERROR_CBOR_INVALID_STATE The kind is not #AZ_CBOR_TOKEN_TRUE or
+ * #AZ_CBOR_TOKEN_FALSE.
+ */
+AZ_NODISCARD az_result az_cbor_token_get_bool(az_cbor_token const* cbor_token, bool* out_value);
+
+/**
+ * @brief Determines whether the CBOR token is a text string equal to the expected text.
+ *
+ * @param[in] cbor_token A pointer to an #az_cbor_token instance.
+ * @param[in] expected_text The text to compare the token against.
+ *
+ * @return `true` if the token is an #AZ_CBOR_TOKEN_TEXT_STRING with the same bytes as
+ * \p expected_text, `false` otherwise.
+ */
+AZ_NODISCARD bool az_cbor_token_is_text_equal(
+    az_cbor_token const* cbor_token,
+    az_span expected_text);
+
+/**
+ * @brief Provides forward-only, non-cached writing of CBOR data items into the provided buffer.
+ *
+ * @remarks #az_cbor_writer writes the shortest encoding of each data item (preferred
+ * serialization, RFC 8949 section 4.1), and arrays and maps with an indefinite length so that
+ * their size doesn't need to be known up front.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span destination_buffer;
+    int32_t bytes_written;
+    // For single contiguous buffer, bytes_written == total_bytes_written
+    int32_t total_bytes_written;
+    az_span_allocator_fn allocator_callback;
+    void* user_context;
+    int32_t depth;
+    // Bit i is set when the container at depth i + 1 is a map, needed for validation.
+    uint64_t map_stack;
+  } _internal;
+} az_cbor_writer;
+
+/**
+ * @brief Initializes an #az_cbor_writer which writes CBOR data items into a buffer.
+ *
+ * @param[out] out_cbor_writer A pointer to an #az_cbor_writer instance to initialize.
+ * @param destination_buffer An #az_span over the byte buffer where the CBOR data is to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK #az_cbor_writer is initialized successfully.
+ * @retval other Initialization failed.
+ */
+AZ_NODISCARD az_result
+az_cbor_writer_init(az_cbor_writer* out_cbor_writer, az_span destination_buffer);
+
+/**
+ * @brief Initializes an #az_cbor_writer which writes CBOR data items into a destination that can
+ * contain non-contiguous buffers.
+ *
+ * @param[out] out_cbor_writer A pointer to an #az_cbor_writer the instance to initialize.
+ * @param[in] first_destination_buffer An #az_span over the byte buffer where the CBOR data is to be
+ * written at the start.
+ * @param[in] allocator_callback An #az_span_allocator_fn callback function that provides the
+ * destination span to write the CBOR data to once the previous buffer is full or too small to
+ * contain the next data item head.
+ * @param user_context A context specific user-defined struct or set of fields that is passed
+ * through to calls to the #az_span_allocator_fn.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_cbor_writer is initialized successfully.
+ * @retval other Failure.
+ *
+ * @remarks The head of a data item is never split across buffers, so the allocator must provide
+ * buffers of at least 9 bytes. The content of strings can straddle buffers.
+ */
+AZ_NODISCARD az_result az_cbor_writer_chunked_init(
+    az_cbor_writer* out_cbor_writer,
+    az_span first_destination_buffer,
+    az_span_allocator_fn allocator_callback,
+    void* user_context);
+
+/**
+ * @brief Returns the #az_span containing the CBOR data written to the underlying buffer so far, in
+ * the last provided destination buffer.
+ *
+ * @param[in] cbor_writer A pointer to an #az_cbor_writer instance wrapping the destination buffer.
+ *
+ * @note Do NOT modify or override the contents of the returned #az_span unless you are no longer
+ * writing CBOR data into it.
+ *
+ * @return An #az_span containing the CBOR data built so far.
+ *
+ * @remarks When the destination is a set of non-contiguous buffers (using
+ * #az_cbor_writer_chunked_init()), this function only returns the data written into the last
+ * provided destination buffer.
+ */
+AZ_NODISCARD AZ_INLINE az_span
+az_cbor_writer_get_bytes_used_in_destination(az_cbor_writer const* cbor_writer)
+{
+  return az_span_slice(
+      cbor_writer->_internal.destination_buffer, 0, cbor_writer->_internal.bytes_written);
+}
+
+/**
+ * @brief Appends an unsigned integer into the buffer.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the value to.
+ * @param[in] value The value to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_cbor_writer_append_uint64(az_cbor_writer* ref_cbor_writer, uint64_t value);
+
+/**
+ * @brief Appends a signed integer into the buffer.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the value to.
+ * @param[in] value The value to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result az_cbor_writer_append_int64(az_cbor_writer* ref_cbor_writer, int64_t value);
+
+/**
+ * @brief Appends a floating point number into the buffer.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the value to.
+ * @param[in] value The value to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remarks The value is written as a half or single precision float when that doesn't lose any
+ * precision, which takes 3 or 5 bytes instead of 9.
+ */
+AZ_NODISCARD az_result az_cbor_writer_append_double(az_cbor_writer* ref_cbor_writer, double value);
+
+/**
+ * @brief Appends a boolean value into the buffer.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the value to.
+ * @param[in] value The value to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result az_cbor_writer_append_bool(az_cbor_writer* ref_cbor_writer, bool value);
+
+/**
+ * @brief Appends the `null` simple value into the buffer.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the value to.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result az_cbor_writer_append_null(az_cbor_writer* ref_cbor_writer);
+
+/**
+ * @brief Appends a UTF-8 text string into the buffer. This is also how the keys of a map are
+ * written.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the value to.
+ * @param[in] value The UTF-8 encoded text to be written. It is copied as is.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_cbor_writer_append_text_string(az_cbor_writer* ref_cbor_writer, az_span value);
+
+/**
+ * @brief Appends a byte string into the buffer.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the value to.
+ * @param[in] value The bytes to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_cbor_writer_append_byte_string(az_cbor_writer* ref_cbor_writer, az_span value);
+
+/**
+ * @brief Appends the beginning of an array of indefinite length into the buffer.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the start of the array to.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Array start was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ * @retval #AZ_ERROR_CBOR_NESTING_OVERFLOW The depth of the CBOR data exceeds the maximum allowed
+ * depth of 64.
+ */
+AZ_NODISCARD az_result az_cbor_writer_append_begin_array(az_cbor_writer* ref_cbor_writer);
+
+/**
+ * @brief Appends the beginning of a map of indefinite length into the buffer.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the start of the map to.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Map start was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ * @retval #AZ_ERROR_CBOR_NESTING_OVERFLOW The depth of the CBOR data exceeds the maximum allowed
+ * depth of 64.
+ */
+AZ_NODISCARD az_result az_cbor_writer_append_begin_map(az_cbor_writer* ref_cbor_writer);
+
+/**
+ * @brief Appends the end of the current array into the buffer.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the end of the array to.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Array end was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result az_cbor_writer_append_end_array(az_cbor_writer* ref_cbor_writer);
+
+/**
+ * @brief Appends the end of the current map into the buffer.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the end of the map to.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Map end was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result az_cbor_writer_append_end_map(az_cbor_writer* ref_cbor_writer);
+
+/**
+ * @brief Appends a series of signed integers as an array of the first one followed by the
+ * difference of each one from the previous one.
+ *
+ * @param[in,out] ref_cbor_writer A pointer to an #az_cbor_writer instance containing the buffer to
+ * append the array to.
+ * @param[in] values The series of integers.
+ * @param[in] values_count The number of integers in \p values.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The array was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remarks The differences of a slowly changing series, such as readings sampled at a fixed
+ * interval or in fixed-point units, are small numbers which take one or two bytes each. The reader
+ * gets the series back by adding each element of the array to the sum of the previous ones.
+ */
+AZ_NODISCARD az_result az_cbor_writer_append_int64_delta_array(
+    az_cbor_writer* ref_cbor_writer,
+    int64_t const* values,
+    int32_t values_count);
+
+/**
+ * @brief Returns the CBOR tokens contained within a CBOR buffer, one at a time.
+ *
+ * @remarks The token field is meant to be used as read-only to return the #az_cbor_token while
+ * reading the CBOR. Do NOT modify it.
+ *
+ * @remarks Arrays and maps of both definite and indefinite length are read, and an end token is
+ * returned after the last item of either. Tags are skipped over, and strings of indefinite length
+ * are not supported.
+ */
+typedef struct
+{
+  /// This read-only field gives access to the current token that the #az_cbor_reader has processed,
+  /// and it shouldn't be modified by the caller.
+  az_cbor_token token;
+
+  struct
+  {
+    az_span cbor_buffer;
+    int32_t bytes_consumed;
+    int32_t depth;
+    // The number of items left in each open container, or -1 when it has an indefinite length.
+    // The items of a map are its keys and values.
+    int32_t remaining_items[_az_CBOR_READER_MAX_NESTING_DEPTH];
+    // Bit i is set when the container at depth i + 1 is a map.
+    uint32_t map_stack;
+  } _internal;
+} az_cbor_reader;
+
+/**
+ * @brief Initializes an #az_cbor_reader to read the CBOR payload contained within the provided
+ * buffer.
+ *
+ * @param[out] out_cbor_reader A pointer to an #az_cbor_reader instance to initialize.
+ * @param[in] cbor_buffer An #az_span over the byte buffer containing the CBOR data item to read.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_cbor_reader is initialized successfully.
+ * @retval other Initialization failed.
+ */
+AZ_NODISCARD az_result az_cbor_reader_init(az_cbor_reader* out_cbor_reader, az_span cbor_buffer);
+
+/**
+ * @brief Reads the next token in the CBOR data and updates the reader's token field.
+ *
+ * @param[in,out] ref_cbor_reader A pointer to an #az_cbor_reader instance containing the CBOR to
+ * read.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The token was read successfully.
+ * @retval #AZ_ERROR_UNEXPECTED_END The end of the CBOR data was reached in the middle of a data
+ * item.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR An invalid or unsupported byte was encountered, or bytes follow
+ * the data item.
+ * @retval #AZ_ERROR_NOT_SUPPORTED A string of indefinite length was encountered.
+ * @retval #AZ_ERROR_CBOR_NESTING_OVERFLOW The depth of the CBOR data exceeds the maximum allowed
+ * depth of 16.
+ * @retval #AZ_ERROR_CBOR_READER_DONE No more CBOR data left to read.
+ */
+AZ_NODISCARD az_result az_cbor_reader_next_token(az_cbor_reader* ref_cbor_reader);
+
+/**
+ * @brief Reads and skips over any nested CBOR elements.
+ *
+ * @param[in,out] ref_cbor_reader A pointer to an #az_cbor_reader instance containing the CBOR to
+ * read.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The children of the current CBOR token are skipped successfully.
+ * @retval other The reader failed to read the children, as with #az_cbor_reader_next_token().
+ *
+ * @remarks If the current token kind is #AZ_CBOR_TOKEN_BEGIN_ARRAY or #AZ_CBOR_TOKEN_BEGIN_MAP,
+ * the reader is moved to the matching end token. Otherwise, the reader doesn't move.
+ */
+AZ_NODISCARD az_result az_cbor_reader_skip_children(az_cbor_reader* ref_cbor_reader);
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_CBOR_H
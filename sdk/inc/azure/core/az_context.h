@@ -15,6 +15,7 @@
 #ifndef _az_CONTEXT_H
 #define _az_CONTEXT_H
 
+#include <azure/core/az_platform.h>
 #include <azure/core/az_result.h>
 
 #include <stddef.h>
@@ -41,6 +42,10 @@ struct az_context
     int64_t expiration; // Time when context expires
     void const* key; // Pointers to the key & value (usually NULL)
     void const* value;
+    // The soonest expiration of this node and its parents, as of when it was created. It stays
+    // correct until a node is canceled, which changes the cancel epoch this was computed at.
+    int64_t effective_expiration;
+    uint32_t cancel_epoch;
   } _internal;
 };
 
@@ -76,6 +81,34 @@ az_context_create_with_expiration(az_context const* parent, int64_t expiration);
 AZ_NODISCARD az_context
 az_context_create_with_value(az_context const* parent, void const* key, void const* value);
 
+/**
+ * @brief Creates a new #az_context node that is a child of the specified parent, with an
+ * #az_platform_event cutting the waits of the operations using it short.
+ *
+ * @param[in] parent The #az_context node that is the parent to the new node.
+ * @param[in] wake_event The #az_platform_event to set, such as right after canceling the context,
+ * to end the waits of the operations using the new node or its children, such as the delays of
+ * the HTTP retry policy. It must remain valid for the lifetime of the new node.
+ *
+ * @return The new child #az_context node.
+ */
+AZ_NODISCARD az_context
+az_context_create_with_wake_event(az_context const* parent, az_platform_event* wake_event);
+
+/**
+ * @brief Gets the #az_platform_event of the nearest #az_context node, from the specified one up to
+ * its parents, created with az_context_create_with_wake_event().
+ *
+ * @param[in] context The #az_context node in the tree where checking starts.
+ * @param[out] out_wake_event Receives the #az_platform_event, or `NULL` if there is none.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The wake event is found.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND No node has a wake event.
+ */
+AZ_NODISCARD az_result
+az_context_get_wake_event(az_context const* context, az_platform_event** out_wake_event);
+
 /**
  * @brief Cancels the specified #az_context node; this cancels all the child nodes as well.
  *
@@ -86,6 +119,9 @@ void az_context_cancel(az_context* ref_context);
 /**
  * @brief Returns the soonest expiration time of this #az_context node or any of its parent nodes.
  *
+ * @remarks This takes constant time, unless a node was canceled since \p context was created, in
+ * which case its parents are walked.
+ *
  * @param[in] context A pointer to an #az_context node.
  * @return The soonest expiration time from this context and its parents.
  */
@@ -111,6 +111,166 @@ typedef enum
   = 511, ///< HTTP 511 Network Authentication Required.
 } az_http_status_code;
 
+/**
+ * @brief How the retry policy randomizes the delay before a retry, when the service didn't ask for
+ * a specific delay.
+ */
+typedef enum
+{
+  /// The delay doubles with each attempt, up to the maximum, without any randomization.
+  AZ_HTTP_POLICY_RETRY_JITTER_NONE = 0,
+
+  /// A random delay between 0 and the exponential delay of #AZ_HTTP_POLICY_RETRY_JITTER_NONE.
+  AZ_HTTP_POLICY_RETRY_JITTER_FULL = 1,
+
+  /// A random delay between the minimum delay and three times the previous delay, up to the
+  /// maximum. This spreads out the retries of many clients which failed at the same time.
+  AZ_HTTP_POLICY_RETRY_JITTER_DECORRELATED = 2,
+} az_http_policy_retry_jitter;
+
+/**
+ * @brief A token bucket limiting the retries of all the requests sharing it to a share of the
+ * requests made, so that a struggling service doesn't get flooded by retries.
+ *
+ * @details Initialize it with #az_http_policy_retry_budget_init() and point the
+ * az_http_policy_retry_options.retry_budget of every client that should share it to the same
+ * instance. Each request adds a fraction of a token to the bucket and each retry takes one whole
+ * token. A request that fails while the bucket is empty is not retried.
+ *
+ * @remarks It is safe to share a budget between threads when compiling with GCC or clang. With
+ * other compilers, concurrent updates may get lost, which only makes the limit approximate.
+ */
+typedef struct
+{
+  struct
+  {
+    int32_t tokens; // In hundredths of a retry.
+    int32_t max_tokens;
+    int32_t tokens_per_request;
+  } _internal;
+} az_http_policy_retry_budget;
+
+/**
+ * @brief Initializes an #az_http_policy_retry_budget, with a full bucket.
+ *
+ * @param[out] out_budget The #az_http_policy_retry_budget to initialize.
+ * @param[in] max_burst_retries The number of retries which can be made in a row, before retries
+ * are limited to \p retry_percent of the requests. Must be between 1 and 1000000.
+ * @param[in] retry_percent The number of retries allowed for every hundred requests, once the
+ * burst is used up. Must be between 0 and 100.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ */
+AZ_NODISCARD az_result az_http_policy_retry_budget_init(
+    az_http_policy_retry_budget* out_budget,
+    int32_t max_burst_retries,
+    int32_t retry_percent);
+
+/**
+ * @brief The number of buckets of the histograms of #az_http_metrics_values.
+ *
+ * @details The buckets count durations up to 10, 50, 100, 500, 1000, 5000 and 30000 milliseconds,
+ * and the last bucket counts the longer ones.
+ */
+enum
+{
+  AZ_HTTP_METRICS_LATENCY_BUCKETS = 8,
+};
+
+/**
+ * @brief The index, in az_http_metrics_values.retries_by_status, of each HTTP status code the
+ * retry policy retries.
+ */
+typedef enum
+{
+  AZ_HTTP_METRICS_STATUS_REQUEST_TIMEOUT = 0, ///< HTTP 408.
+  AZ_HTTP_METRICS_STATUS_TOO_MANY_REQUESTS = 1, ///< HTTP 429.
+  AZ_HTTP_METRICS_STATUS_INTERNAL_SERVER_ERROR = 2, ///< HTTP 500.
+  AZ_HTTP_METRICS_STATUS_BAD_GATEWAY = 3, ///< HTTP 502.
+  AZ_HTTP_METRICS_STATUS_SERVICE_UNAVAILABLE = 4, ///< HTTP 503.
+  AZ_HTTP_METRICS_STATUS_GATEWAY_TIMEOUT = 5, ///< HTTP 504.
+  AZ_HTTP_METRICS_STATUS_COUNT = 6, ///< The number of status codes counted.
+} az_http_metrics_status;
+
+/**
+ * @brief A snapshot of the counters of an #az_http_metrics, taken by #az_http_metrics_read().
+ *
+ * @details Every counter wraps around, so a reader sampling them periodically should use the
+ * difference between two snapshots, computed with unsigned arithmetic.
+ */
+typedef struct
+{
+  /// The requests which went through the retry policy.
+  uint32_t requests;
+
+  /// The attempts at sending those requests, including the retries.
+  uint32_t attempts;
+
+  /// The retries made.
+  uint32_t retries;
+
+  /// The retries made, by the status code of the response which caused them.
+  uint32_t retries_by_status[AZ_HTTP_METRICS_STATUS_COUNT];
+
+  /// The bytes of request body sent, counted once per attempt. Bodies of unknown length aren't
+  /// counted.
+  uint32_t bytes_sent;
+
+  /// The bytes of response received, including the status line and the headers.
+  uint32_t bytes_received;
+
+  /// The time, in milliseconds, spent waiting before retries.
+  uint32_t backoff_msec;
+
+  /// The number of attempts by how long they took, in the buckets described by
+  /// #AZ_HTTP_METRICS_LATENCY_BUCKETS.
+  uint32_t attempt_latency_histogram[AZ_HTTP_METRICS_LATENCY_BUCKETS];
+
+  /// The number of retries by how long they were waited for, in the same buckets.
+  uint32_t backoff_histogram[AZ_HTTP_METRICS_LATENCY_BUCKETS];
+} az_http_metrics_values;
+
+/**
+ * @brief Counters of what the retry policy does, which can be read at any time, without a log
+ * listener.
+ *
+ * @details Initialize it with #az_http_metrics_init() and point the
+ * az_http_policy_retry_options.metrics of the clients to measure to it. Read it with
+ * #az_http_metrics_read().
+ *
+ * @remarks Updating and reading the counters is lock-free when compiling with GCC or clang, so an
+ * instance can be shared between threads. With other compilers, concurrent updates may get lost.
+ */
+typedef struct
+{
+  struct
+  {
+    az_http_metrics_values values;
+  } _internal;
+} az_http_metrics;
+
+/**
+ * @brief Initializes an #az_http_metrics, with all its counters at 0.
+ *
+ * @param[out] out_metrics The #az_http_metrics to initialize.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ */
+AZ_NODISCARD az_result az_http_metrics_init(az_http_metrics* out_metrics);
+
+/**
+ * @brief Reads the counters of an #az_http_metrics.
+ *
+ * @details Each counter is read atomically, but the counters are not read all at once, so a
+ * request in progress may be counted in some of them only.
+ *
+ * @param[in] metrics The #az_http_metrics to read.
+ * @param[out] out_values The #az_http_metrics_values to copy the counters into.
+ */
+void az_http_metrics_read(az_http_metrics const* metrics, az_http_metrics_values* out_values);
+
 /**
  * @brief Allows you to customize the retry policy used by SDK clients whenever they perform an I/O
  * operation.
@@ -129,6 +289,16 @@ typedef struct
 
   /// Maximum number of retries.
   int32_t max_retries;
+
+  /// How the delay before a retry is randomized. Defaults to #AZ_HTTP_POLICY_RETRY_JITTER_NONE.
+  az_http_policy_retry_jitter jitter;
+
+  /// An optional #az_http_policy_retry_budget shared with other clients, or _NULL_ to only limit
+  /// retries with max_retries.
+  az_http_policy_retry_budget* retry_budget;
+
+  /// An optional #az_http_metrics to count the requests, retries and delays in, or _NULL_.
+  az_http_metrics* metrics;
 } az_http_policy_retry_options;
 
 typedef enum
@@ -139,6 +309,87 @@ typedef enum
   _az_HTTP_RESPONSE_KIND_EOF = 3,
 } _az_http_response_kind;
 
+/**
+ * @brief A slot of the optional header index of an #az_http_response.
+ *
+ * @details An array of these is supplied by the application through
+ * #az_http_response_set_header_index().
+ */
+typedef struct
+{
+  struct
+  {
+    uint32_t name_hash;
+    int32_t name_offset;
+    int32_t name_length;
+    int32_t value_offset;
+    int32_t value_length;
+  } _internal;
+} az_http_response_header_index_entry;
+
+/**
+ * @brief Represents the result of making an HTTP request.
+ * An application obtains this initialized structure by calling #az_http_response_get_status_line().
+ *
+ * @see https://tools.ietf.org/html/rfc7230#section-3.1.2
+ */
+// Member order is optimized for alignment.
+typedef struct
+{
+  az_span reason_phrase; ///< Reason Phrase.
+  az_http_status_code status_code; ///< Status Code.
+  uint8_t major_version; ///< HTTP Major Version.
+  uint8_t minor_version; ///< HTTP Minor Version.
+} az_http_response_status_line;
+
+/**
+ * @brief The kind of an #az_http_response_event.
+ */
+typedef enum
+{
+  AZ_HTTP_RESPONSE_EVENT_STATUS_LINE = 1, ///< The status line was received.
+  AZ_HTTP_RESPONSE_EVENT_HEADER = 2, ///< A header was received.
+  AZ_HTTP_RESPONSE_EVENT_END_OF_HEADERS = 3, ///< All the headers were received.
+  AZ_HTTP_RESPONSE_EVENT_BODY = 4, ///< A part of the body was received.
+} az_http_response_event_kind;
+
+/**
+ * @brief A part of an HTTP response that was just received, as passed to an
+ * #az_http_response_event_fn.
+ *
+ * @details All the spans point into the buffers the response is received into, so they remain
+ * valid for as long as those buffers do.
+ */
+typedef struct
+{
+  /// The status line, for #AZ_HTTP_RESPONSE_EVENT_STATUS_LINE.
+  az_http_response_status_line status_line;
+
+  /// The name of the header, for #AZ_HTTP_RESPONSE_EVENT_HEADER.
+  az_span name;
+
+  /// The value of the header for #AZ_HTTP_RESPONSE_EVENT_HEADER, or the bytes of the body that
+  /// were received for #AZ_HTTP_RESPONSE_EVENT_BODY.
+  az_span value;
+
+  /// What was received.
+  az_http_response_event_kind kind;
+} az_http_response_event;
+
+/**
+ * @brief Defines the signature of the callback function that is invoked as the parts of an HTTP
+ * response are received, see #az_http_response_set_event_callback().
+ *
+ * @param[in] event The part of the response that was received.
+ * @param[in] user_context The user context passed to #az_http_response_set_event_callback().
+ *
+ * @return #AZ_OK to continue receiving the response, or an error to abort it. The error is returned
+ * to the transport.
+ */
+typedef az_result (*az_http_response_event_fn)(
+    az_http_response_event const* event,
+    void* user_context);
+
 /**
  * @brief Allows you to parse an HTTP response's status line, headers, and body.
  *
@@ -159,6 +410,28 @@ typedef struct
       _az_http_response_kind next_kind;
       // After parsing an element, next_kind refers to the next expected element
     } parser;
+    struct
+    {
+      az_http_response_header_index_entry* entries;
+      int32_t capacity;
+      int32_t length; // -1 when the index has to be built before it is used.
+      int32_t indexed_written; // The value of written when the index was built.
+      int32_t unindexed_offset; // Where the headers that didn't fit start, or -1 if all fit.
+    } header_index;
+    struct
+    {
+      az_span_allocator_fn allocator_callback; // NULL when the body goes into http_response.
+      void* user_context;
+      az_span destination;
+      int32_t bytes_used; // Bytes written into destination.
+    } body_stream;
+    struct
+    {
+      az_http_response_event_fn callback; // NULL when no event is raised.
+      void* user_context;
+      int32_t parsed; // The bytes of http_response that were raised as events already.
+      _az_http_response_kind next_kind;
+    } events;
   } _internal;
 } az_http_response;
 
@@ -185,27 +458,31 @@ az_http_response_init(az_http_response* out_response, az_span buffer)
         .remaining = AZ_SPAN_EMPTY,
         .next_kind = _az_HTTP_RESPONSE_KIND_STATUS_LINE,
       },
+      .header_index = {
+        .entries = NULL,
+        .capacity = 0,
+        .length = -1,
+        .indexed_written = 0,
+        .unindexed_offset = -1,
+      },
+      .body_stream = {
+        .allocator_callback = NULL,
+        .user_context = NULL,
+        .destination = AZ_SPAN_EMPTY,
+        .bytes_used = 0,
+      },
+      .events = {
+        .callback = NULL,
+        .user_context = NULL,
+        .parsed = 0,
+        .next_kind = _az_HTTP_RESPONSE_KIND_STATUS_LINE,
+      },
     },
   };
 
   return AZ_OK;
 }
 
-/**
- * @brief Represents the result of making an HTTP request.
- * An application obtains this initialized structure by calling #az_http_response_get_status_line().
- *
- * @see https://tools.ietf.org/html/rfc7230#section-3.1.2
- */
-// Member order is optimized for alignment.
-typedef struct
-{
-  az_span reason_phrase; ///< Reason Phrase.
-  az_http_status_code status_code; ///< Status Code.
-  uint8_t major_version; ///< HTTP Major Version.
-  uint8_t minor_version; ///< HTTP Minor Version.
-} az_http_response_status_line;
-
 /**
  * @brief Returns the #az_http_response_status_line information within an HTTP response.
  *
@@ -249,6 +526,120 @@ AZ_NODISCARD az_result az_http_response_get_next_header(
     az_span* out_name,
     az_span* out_value);
 
+/**
+ * @brief Attaches an index to the response, so that #az_http_response_find_header() doesn't need to
+ * parse all the headers of the response on every call.
+ *
+ * @details The index is a hash table over the header names, which is filled in the first time
+ * #az_http_response_find_header() is called, and again whenever more data has been appended to the
+ * response since. If the response has more headers than \p index_entries can hold, the headers
+ * which are not indexed are still found by parsing the remainder of the response.
+ *
+ * @note The index must be set again if the response is re-initialized with
+ * #az_http_response_init().
+ *
+ * @param[in,out] ref_response A pointer to an #az_http_response instance.
+ * @param[in] index_entries An array of #az_http_response_header_index_entry that will hold the
+ * index. It must remain valid for as long as \p ref_response is used.
+ * @param[in] index_entries_length The number of elements in \p index_entries.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The index was attached successfully.
+ */
+AZ_NODISCARD az_result az_http_response_set_header_index(
+    az_http_response* ref_response,
+    az_http_response_header_index_entry* index_entries,
+    int32_t index_entries_length);
+
+/**
+ * @brief Makes transports write the response body into buffers provided by \p allocator_callback,
+ * rather than into the buffer the response was initialized with.
+ *
+ * @details The status line and headers still go into the response buffer, which then only needs to
+ * be large enough for them. Bodies of any size can be received this way, as each buffer is handed
+ * back to the application once it is full, by requesting the next one. The first call to the
+ * allocator has #az_span_allocator_context.bytes_used set to 0. When the response is complete,
+ * #az_http_response_get_bytes_used_in_body_destination() tells how much of the last buffer was
+ * written. #az_http_response_get_body() returns an empty body.
+ *
+ * @note If the request is retried, the body of every attempt is written to the allocator.
+ *
+ * @note The allocator must be set again if the response is re-initialized with
+ * #az_http_response_init().
+ *
+ * @param[in,out] ref_response A pointer to an #az_http_response instance.
+ * @param[in] allocator_callback An #az_span_allocator_fn callback function that provides the
+ * buffers to write the body into.
+ * @param[in] user_context Any struct that was provided by the user for their specific
+ * implementation, passed through to \p allocator_callback.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The allocator was set successfully.
+ */
+AZ_NODISCARD az_result az_http_response_set_body_allocator(
+    az_http_response* ref_response,
+    az_span_allocator_fn allocator_callback,
+    void* user_context);
+
+/**
+ * @brief Returns the number of bytes of the body written into the last buffer provided by the
+ * allocator set with #az_http_response_set_body_allocator().
+ *
+ * @param[in] response A pointer to an #az_http_response instance.
+ *
+ * @return The number of bytes written into the last buffer, or 0 if no buffer was requested.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+az_http_response_get_bytes_used_in_body_destination(az_http_response const* response)
+{
+  return response->_internal.body_stream.bytes_used;
+}
+
+/**
+ * @brief Makes the response raise an event for its status line, for each header, and for each part
+ * of the body, as soon as they are received, rather than only once the whole response is.
+ *
+ * @details The events are raised while the transport appends the response, by
+ * #az_http_response_append() and #az_http_response_append_body(), so an application can act on the
+ * status and headers before the body arrives, and process the body as it comes, for instance by
+ * collecting the parts into an array of spans for #az_json_reader_chunked_init(). Together with
+ * #az_http_response_set_body_allocator(), the body doesn't need to fit in a single buffer.
+ *
+ * @note The callback must be set before the response is received, and again if the response is
+ * re-initialized with #az_http_response_init(). If the request is retried, the events are raised
+ * again for every attempt, starting with #AZ_HTTP_RESPONSE_EVENT_STATUS_LINE.
+ *
+ * @param[in,out] ref_response A pointer to an #az_http_response instance.
+ * @param[in] event_callback An #az_http_response_event_fn callback function to invoke.
+ * @param[in] user_context Any struct that was provided by the user for their specific
+ * implementation, passed through to \p event_callback.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The callback was set successfully.
+ */
+AZ_NODISCARD az_result az_http_response_set_event_callback(
+    az_http_response* ref_response,
+    az_http_response_event_fn event_callback,
+    void* user_context);
+
+/**
+ * @brief Finds the value of the first HTTP response header with the given name.
+ *
+ * @details Header names are compared ignoring case. The parser state used by
+ * #az_http_response_get_next_header() and #az_http_response_get_body() is not changed.
+ *
+ * @param[in,out] ref_response A pointer to an #az_http_response instance.
+ * @param[in] name The name of the header to find.
+ * @param[out] out_value A pointer to an #az_span to receive the header's value.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The header was found.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND There is no header named \p name within the HTTP response.
+ * @retval other The HTTP response status line or headers could not be parsed.
+ */
+AZ_NODISCARD az_result
+az_http_response_find_header(az_http_response* ref_response, az_span name, az_span* out_value);
+
 /**
  * @brief Returns a span over the HTTP body within an HTTP response.
  *
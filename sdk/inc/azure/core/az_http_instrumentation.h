@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief This header defines the types and functions your application uses to measure where the
+ * time goes while the HTTP pipeline processes a request.
+ *
+ * @details The SDK notifies the application when each policy, each retry attempt and the transport
+ * begins and ends. It doesn't read any clock for it: the callback takes its own timestamps, with
+ * whatever clock resolution the application has available. Transports can in addition report the
+ * durations of the phases of a transfer they measured themselves, like the curl transport does.
+ *
+ * @note You MUST NOT use any symbols (macros, functions, structures, enums, etc.)
+ * prefixed with an underscore ('_') directly in your application code. These symbols
+ * are part of Azure SDK's internal implementation; we do not document these symbols
+ * and they are subject to change in future versions of the SDK which would break your code.
+ */
+
+#ifndef _az_HTTP_INSTRUMENTATION_H
+#define _az_HTTP_INSTRUMENTATION_H
+
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_result.h>
+
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/**
+ * @brief What an #az_http_instrumentation_event is about.
+ */
+typedef enum
+{
+  /// A pipeline policy, including the policies after it. The index is the position of the policy
+  /// in the pipeline, starting at 0.
+  AZ_HTTP_INSTRUMENTATION_POLICY = 1,
+
+  /// An attempt of the retry policy. The index is the attempt number, starting at 1.
+  AZ_HTTP_INSTRUMENTATION_RETRY_ATTEMPT = 2,
+
+  /// Sending the request and receiving the response through the transport.
+  AZ_HTTP_INSTRUMENTATION_TRANSPORT = 3,
+
+  /// Measured by the transport: the time until the host name was resolved.
+  AZ_HTTP_INSTRUMENTATION_TRANSPORT_NAME_LOOKUP = 4,
+
+  /// Measured by the transport: the time until the connection to the host was established.
+  AZ_HTTP_INSTRUMENTATION_TRANSPORT_CONNECT = 5,
+
+  /// Measured by the transport: the time until the TLS handshake was completed.
+  AZ_HTTP_INSTRUMENTATION_TRANSPORT_TLS_HANDSHAKE = 6,
+
+  /// Measured by the transport: the time until the first byte of the response was received.
+  AZ_HTTP_INSTRUMENTATION_TRANSPORT_FIRST_BYTE = 7,
+} az_http_instrumentation_kind;
+
+/**
+ * @brief Whether an #az_http_instrumentation_event marks a beginning, an end, or a duration that
+ * was measured already.
+ */
+typedef enum
+{
+  AZ_HTTP_INSTRUMENTATION_BEGIN = 1, ///< The operation begins.
+  AZ_HTTP_INSTRUMENTATION_END = 2, ///< The operation ended, with the result of the event.
+  AZ_HTTP_INSTRUMENTATION_MEASURED = 3, ///< The duration of the event was measured.
+} az_http_instrumentation_phase;
+
+/**
+ * @brief An instrumentation event, as passed to an #az_http_instrumentation_fn.
+ */
+typedef struct
+{
+  /// The request being processed.
+  az_http_request const* request;
+
+  /// For #AZ_HTTP_INSTRUMENTATION_MEASURED, the time in microseconds from the start of the
+  /// transfer until the end of the measured phase. 0 otherwise.
+  int64_t elapsed_usec;
+
+  /// The index of the event, see #az_http_instrumentation_kind.
+  int32_t index;
+
+  /// The result of the operation, for #AZ_HTTP_INSTRUMENTATION_END.
+  az_result result;
+
+  /// What the event is about.
+  az_http_instrumentation_kind kind;
+
+  /// Whether the event marks a beginning, an end, or a measured duration.
+  az_http_instrumentation_phase phase;
+} az_http_instrumentation_event;
+
+/**
+ * @brief Defines the signature of the callback function that application developers must provide
+ * to receive instrumentation events.
+ *
+ * @details The callback is invoked synchronously, from the thread processing the request, so that
+ * it can take the timestamp of #AZ_HTTP_INSTRUMENTATION_BEGIN and #AZ_HTTP_INSTRUMENTATION_END
+ * events itself. It should return quickly.
+ *
+ * @param[in] event The instrumentation event.
+ */
+typedef void (*az_http_instrumentation_fn)(az_http_instrumentation_event const* event);
+
+/**
+ * @brief Sets the function that will be invoked to report HTTP pipeline instrumentation events.
+ *
+ * @param[in] instrumentation_callback __[nullable]__ A pointer to the function that will be invoked
+ * for each event. If `NULL`, no function will be invoked.
+ *
+ * @remarks By default, this is `NULL`, which means, no function is invoked.
+ */
+void az_http_set_instrumentation_callback(az_http_instrumentation_fn instrumentation_callback);
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_HTTP_INSTRUMENTATION_H
@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief An HTTP transport serving canned responses from memory, without any network, to measure
+ * the cost of the HTTP pipeline itself and to test how policies react to given responses.
+ *
+ * @details The functions of this header, along with #az_http_client_send_request(), are
+ * implemented by the `az_loopbackhttp` library, which replaces the other HTTP transports.
+ *
+ * @note You MUST NOT use any symbols (macros, functions, structures, enums, etc.)
+ * prefixed with an underscore ('_') directly in your application code. These symbols
+ * are part of Azure SDK's internal implementation; we do not document these symbols
+ * and they are subject to change in future versions of the SDK which would break your code.
+ */
+
+#ifndef _az_HTTP_LOOPBACK_H
+#define _az_HTTP_LOOPBACK_H
+
+#include <azure/core/az_http.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/**
+ * @brief A response served by an #az_http_loopback.
+ */
+typedef struct
+{
+  /// The status code of the response.
+  az_http_status_code status_code;
+
+  /// The headers of the response, each of them as `name: value` followed by a CRLF, such as
+  /// `Retry-After: 1\r\n`. A `Content-Length` header is added for the body.
+  az_span headers;
+
+  /// The body of the response.
+  az_span body;
+} az_http_loopback_response;
+
+/**
+ * @brief The responses served by the loopback transport, in turn, with the latency of each
+ * request.
+ *
+ * @remarks An #az_http_loopback isn't thread-safe, it must only serve the requests of one thread at
+ * a time.
+ */
+typedef struct
+{
+  struct
+  {
+    az_http_loopback_response const* responses;
+    int32_t response_count;
+    int32_t latency_usec;
+    int32_t next_response;
+    int64_t request_count;
+  } _internal;
+} az_http_loopback;
+
+/**
+ * @brief Initializes an #az_http_loopback.
+ *
+ * @param[out] out_loopback The #az_http_loopback to initialize.
+ * @param[in] responses The responses to serve, in turn, the first one again after the last one. For
+ * instance, a 429 response followed by a 200 response makes every other request throttled. They
+ * must remain valid as long as \p out_loopback serves requests.
+ * @param[in] response_count The number of elements in \p responses.
+ * @param[in] latency_usec How long each request takes, in microseconds, such as the round trip
+ * time of the network. The transport spins on az_platform_clock_usec() rather than sleeping, to
+ * keep the scheduler out of the measurements. 0 serves responses at once.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ */
+AZ_NODISCARD az_result az_http_loopback_init(
+    az_http_loopback* out_loopback,
+    az_http_loopback_response const responses[],
+    int32_t response_count,
+    int32_t latency_usec);
+
+/**
+ * @brief Makes the loopback transport serve the requests of the process from \p loopback.
+ *
+ * @param[in] loopback __[nullable]__ The #az_http_loopback to serve the requests from. If `NULL`,
+ * #az_http_client_send_request() returns #AZ_ERROR_DEPENDENCY_NOT_PROVIDED.
+ */
+void az_http_loopback_set(az_http_loopback* loopback);
+
+/**
+ * @brief Gets the number of requests served by an #az_http_loopback, retries included.
+ *
+ * @param[in] loopback The #az_http_loopback to query.
+ *
+ * @return The number of requests served.
+ */
+AZ_NODISCARD AZ_INLINE int64_t az_http_loopback_get_request_count(az_http_loopback const* loopback)
+{
+  return loopback->_internal.request_count;
+}
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_HTTP_LOOPBACK_H
@@ -15,7 +15,9 @@
 #ifndef _az_HTTP_TRANSPORT_H
 #define _az_HTTP_TRANSPORT_H
 
+#include <azure/core/az_arena.h>
 #include <azure/core/az_http.h>
+#include <azure/core/az_log.h>
 #include <azure/core/az_span.h>
 
 #include <azure/core/_az_cfg_prefix.h>
@@ -70,6 +72,28 @@ typedef struct
  */
 typedef az_span _az_http_request_headers;
 
+/**
+ * @brief Defines the signature of the callback function that produces the body of an HTTP request
+ * chunk by chunk, so the body doesn't have to be in memory all at once.
+ *
+ * @param[in] user_context The context passed to #az_http_request_set_body_reader().
+ * @param[in] offset The position within the body to read from. Reads normally continue where the
+ * previous one ended, but the transport goes back to 0 when the request is sent again (for example
+ * by the retry policy).
+ * @param[out] destination The #az_span to write the next chunk of the body into.
+ * @param[out] out_size The number of bytes written into \p destination. 0 means the end of the
+ * body was reached.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval other Failure, which aborts sending the request.
+ */
+typedef AZ_NODISCARD az_result (*az_http_request_body_read_fn)(
+    void* user_context,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size);
+
 /**
  * @brief Structure used to represent an HTTP request.
  * It contains an HTTP method, URL, headers and body. It also contains
@@ -88,7 +112,27 @@ typedef struct
     int32_t headers_length;
     int32_t max_headers;
     int32_t retry_headers_start_byte_offset;
+    // The URL and headers az_http_request_reset() truncates the request back to.
+    struct
+    {
+      int32_t url_length;
+      int32_t query_start;
+      int32_t headers_length;
+    } saved;
     az_span body;
+    struct
+    {
+      az_http_request_body_read_fn read_callback; // NULL when the body is in body.
+      void* user_context;
+      int64_t length; // -1 when it is not known up front.
+    } body_reader;
+    // Set while the request goes through an asynchronous pipeline operation, NULL otherwise.
+    struct _az_http_pipeline_operation* pipeline_operation;
+    // The position, in the pipeline, of the policy processing the request. Only tracked while an
+    // instrumentation callback is set.
+    int32_t policy_depth;
+    // Where the transport allocates what it needs to send the request. NULL for the heap.
+    az_arena* arena;
   } _internal;
 } az_http_request;
 
@@ -185,6 +229,51 @@ AZ_NODISCARD az_result az_http_request_get_url(az_http_request const* request, a
  */
 AZ_NODISCARD az_result az_http_request_get_body(az_http_request const* request, az_span* out_body);
 
+/**
+ * @brief Checks whether the body of an HTTP request is produced by an #az_http_request_body_read_fn
+ * callback, in which case #az_http_request_get_body() returns an empty body.
+ *
+ * @remarks This function is expected to be used by transport layer only.
+ *
+ * @param[in] request The HTTP request.
+ *
+ * @return `true` if the body has to be read with #az_http_request_read_body().
+ */
+AZ_NODISCARD bool az_http_request_has_body_reader(az_http_request const* request);
+
+/**
+ * @brief Gets the size of the body of an HTTP request, in bytes.
+ *
+ * @remarks This function is expected to be used by transport layer only.
+ *
+ * @param[in] request The HTTP request.
+ *
+ * @return The size of the body, or -1 if the body is produced by a reader that didn't tell its size
+ * up front.
+ */
+AZ_NODISCARD int64_t az_http_request_get_body_length(az_http_request const* request);
+
+/**
+ * @brief Reads the next chunk of the body of an HTTP request, no matter whether it is held in a
+ * single #az_span or produced by an #az_http_request_body_read_fn.
+ *
+ * @remarks This function is expected to be used by transport layer only.
+ *
+ * @param[in] request The HTTP request.
+ * @param[in] offset The position within the body to read from.
+ * @param[out] destination The #az_span to copy the body into.
+ * @param[out] out_size The number of bytes written into \p destination, 0 at the end of the body.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval other The body reader failed.
+ */
+AZ_NODISCARD az_result az_http_request_read_body(
+    az_http_request const* request,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size);
+
 /**
  * @brief This function is expected to be used by transport adapters like curl. Use it to write
  * content from \p source to \p ref_response.
@@ -198,9 +287,30 @@ AZ_NODISCARD az_result az_http_request_get_body(az_http_request const* request,
  * @retval #AZ_OK Success.
  * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p response buffer is not big enough to contain the \p
  * source content.
+ * @retval #AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER The status line or a header could not be parsed
+ * while raising the events set with #az_http_response_set_event_callback().
+ * @retval other The event callback failed.
  */
 AZ_NODISCARD az_result az_http_response_append(az_http_response* ref_response, az_span source);
 
+/**
+ * @brief This function is expected to be used by transport adapters like curl. Use it to write
+ * the body content from \p source to \p ref_response.
+ *
+ * @details When an allocator was set with #az_http_response_set_body_allocator(), the content is
+ * written into the buffers it provides. Otherwise, this is the same as #az_http_response_append().
+ *
+ * @param[in,out] ref_response Pointer to an #az_http_response.
+ * @param[in] source This is an #az_span with the body content to be written into \p ref_response.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p response buffer is not big enough to contain the \p
+ * source content.
+ * @retval other The allocator failed to provide a buffer, or the event callback failed.
+ */
+AZ_NODISCARD az_result az_http_response_append_body(az_http_response* ref_response, az_span source);
+
 /**
  * @brief Returns the number of headers within the request.
  *
@@ -232,6 +342,169 @@ AZ_NODISCARD int32_t az_http_request_headers_count(az_http_request const* reques
 AZ_NODISCARD az_result
 az_http_client_send_request(az_http_request const* request, az_http_response* ref_response);
 
+/**
+ * @brief Sends an idempotent HTTP request, and sends it a second time if the first one hasn't
+ * completed within \p hedge_delay_msec. The response which completes first is used and the other
+ * request is canceled.
+ *
+ * @remarks This function is expected to be used by the hedging policy only. Transport adapters
+ * which can't have two requests in flight at once can return #AZ_ERROR_NOT_SUPPORTED, in which
+ * case the request is sent once with #az_http_client_send_request().
+ *
+ * @param[in] request Points to an #az_http_request to send. Only GET and HEAD requests are
+ * supported.
+ * @param[in,out] ref_response Points to an #az_http_response where the response to the first
+ * request will be written.
+ * @param[in,out] ref_hedge_response Points to an #az_http_response where the response to the
+ * second request, if any, will be written.
+ * @param[in] hedge_delay_msec How long to wait for the first request, in milliseconds, before
+ * sending the second one.
+ * @param[out] out_hedge_won Set to `true` when the response is in \p ref_hedge_response rather
+ * than in \p ref_response.
+ *
+ * @return An #az_result value indicating the result of the operation, see
+ * #az_http_client_send_request(). Once one of the requests failed, the result of the other one is
+ * returned.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The transport adapter doesn't support hedged requests, nothing
+ * was sent.
+ */
+AZ_NODISCARD az_result az_http_client_send_hedged_request(
+    az_http_request const* request,
+    az_http_response* ref_response,
+    az_http_response* ref_hedge_response,
+    int32_t hedge_delay_msec,
+    bool* out_hedge_won);
+
+/**
+ * @brief Sends several HTTP requests at once, and waits for all of their responses.
+ *
+ * @details Transport adapters which can have several requests in flight, such as the libcurl one,
+ * send them concurrently, so the batch takes about as long as its slowest request rather than the
+ * sum of all of them, without the application starting threads. Other transport adapters send them
+ * one after the other with #az_http_client_send_request().
+ *
+ * @remarks The requests are sent as they are, without going through the policies of a pipeline, so
+ * they aren't retried.
+ *
+ * @param[in] requests The requests to send.
+ * @param[in,out] ref_responses The responses, where the response to `requests[i]` is written into
+ * `ref_responses[i]`. Each one needs a buffer of its own.
+ * @param[out] out_results Where the result of sending `requests[i]`, see
+ * #az_http_client_send_request(), is written into `out_results[i]`.
+ * @param[in] count The number of requests, responses and results. Must be at least 1.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Every request was sent, and got a response.
+ * @retval other The result of the first request which failed. The results of all the requests
+ * are in \p out_results.
+ * @retval #AZ_ERROR_DEPENDENCY_NOT_PROVIDED No platform implementation was supplied to support this
+ * function.
+ */
+AZ_NODISCARD az_result az_http_client_send_requests(
+    az_http_request const requests[],
+    az_http_response ref_responses[],
+    az_result out_results[],
+    int32_t count);
+
+/**
+ * @brief Initializes the HTTP transport adapter, and optionally opens connections to the hosts the
+ * application will send requests to, so that the first requests don't pay for it.
+ *
+ * @remarks Call it once when the application starts, before it starts other threads, since it
+ * initializes the libraries of the transport adapter. Calling it again only opens connections.
+ *
+ * @param[in] context __[nullable]__ An #az_context bounding how long opening the connections
+ * takes. If `NULL`, #az_context_application is used.
+ * @param[in] urls __[nullable]__ The URLs of the hosts to connect to. Each host is sent a `HEAD`
+ * request for its URL, whose response is ignored.
+ * @param[in] url_count The number of elements in \p urls.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The transport adapter is initialized. Connecting to the hosts is only an
+ * optimization, so failing to do so isn't reported.
+ * @retval #AZ_ERROR_HTTP_ADAPTER The libraries of the transport adapter couldn't be initialized.
+ * @retval #AZ_ERROR_DEPENDENCY_NOT_PROVIDED No platform implementation was supplied to support this
+ * function.
+ */
+AZ_NODISCARD az_result
+az_http_client_init(az_context const* context, az_span const urls[], int32_t url_count);
+
+/**
+ * @brief The fields of an #AZ_LOG_HTTP_REQUEST or #AZ_LOG_HTTP_RESPONSE log message, given to an
+ * #az_http_log_record_fn before they are formatted as text.
+ */
+typedef struct
+{
+  /// #AZ_LOG_HTTP_REQUEST or #AZ_LOG_HTTP_RESPONSE.
+  az_log_classification classification;
+
+  /// The method of the request, empty if there is no request.
+  az_http_method method;
+
+  /// The URL of the request, empty if there is no request.
+  az_span url;
+
+  /// __[nullable]__ The request, whose headers can be read with #az_http_request_get_header().
+  az_http_request const* request;
+
+  /// __[nullable]__ The response, `NULL` for #AZ_LOG_HTTP_REQUEST. Its headers can be read with
+  /// #az_http_response_get_status_line() and #az_http_response_get_next_header() on a copy.
+  az_http_response const* response;
+
+  /// The status code of the response, or 0 for #AZ_LOG_HTTP_REQUEST and for an empty response.
+  az_http_status_code status_code;
+
+  /// How long the request took, in milliseconds, or -1 for #AZ_LOG_HTTP_REQUEST.
+  int64_t duration_msec;
+} az_http_log_record;
+
+/**
+ * @brief Defines the signature of the callback function which receives the HTTP request and
+ * response log messages as an #az_http_log_record, rather than as text.
+ *
+ * @param[in] record The fields of the log message. They are only valid during the call.
+ */
+typedef void (*az_http_log_record_fn)(az_http_log_record const* record);
+
+/**
+ * @brief Sets the function which receives the HTTP request and response log messages as an
+ * #az_http_log_record.
+ *
+ * @details When set, the #AZ_LOG_HTTP_REQUEST and #AZ_LOG_HTTP_RESPONSE messages are no longer
+ * formatted nor passed to the #az_log_message_fn, so a sink which only needs the status code and
+ * the duration doesn't pay for the formatting. Call #az_http_log_record_format() to get the text.
+ *
+ * @param[in] record_callback __[nullable]__ The function to call, after the
+ * #az_log_classification_filter_fn allowed the message. If `NULL`, messages are formatted and
+ * passed to the #az_log_message_fn, which is the default.
+ */
+#ifndef AZ_NO_LOGGING
+void az_http_log_set_record_callback(az_http_log_record_fn record_callback);
+#else
+AZ_INLINE void az_http_log_set_record_callback(az_http_log_record_fn record_callback)
+{
+  (void)record_callback;
+}
+#endif // AZ_NO_LOGGING
+
+/**
+ * @brief Formats an #az_http_log_record as the text that is passed to the #az_log_message_fn when
+ * no #az_http_log_record_fn is set.
+ *
+ * @param[in] record The #az_http_log_record to format.
+ * @param[in] destination The #az_span to write the text into. #AZ_LOG_MESSAGE_BUFFER_SIZE bytes are
+ * enough for the messages of most requests.
+ * @param[out] out_message The part of \p destination holding the text.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination is too small.
+ */
+AZ_NODISCARD az_result az_http_log_record_format(
+    az_http_log_record const* record,
+    az_span destination,
+    az_span* out_message);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_HTTP_TRANSPORT_H
@@ -55,6 +55,10 @@ typedef struct
     // Each subsequent bit is the parent / containing type (object or array).
     uint64_t az_json_stack;
     int32_t current_depth;
+    // Optional caller-provided words holding the states of the depths that no longer fit within
+    // az_json_stack, the outermost first, allowing 64 more levels of nesting per word.
+    uint64_t* extension;
+    int32_t extension_size;
   } _internal;
 } _az_json_bit_stack;
 
@@ -100,6 +104,24 @@ typedef struct
     /// optimization to avoid redundant checks. It is meaningless for any other token kind.
     bool string_has_escaped_chars;
 
+    /// A flag to indicate whether the JSON number is an integer (without a fraction or exponent)
+    /// whose magnitude fits in a uint64_t, in which case its value was recorded by the reader in
+    /// `number_is_negative` and `number_magnitude`, used as an optimization to avoid parsing the
+    /// number again. It is meaningless for any other token kind.
+    bool number_is_integer;
+
+    /// A flag to indicate whether the recorded integer JSON number starts with a '-' sign.
+    bool number_is_negative;
+
+    /// The absolute value of the recorded integer JSON number.
+    uint64_t number_magnitude;
+
+    /// The hash of a property name that doesn't contain any escaped characters and doesn't
+    /// straddle non-contiguous buffers, recorded by the reader as computed by
+    /// #az_json_property_name_hash(), used as an optimization to avoid comparing the name against
+    /// candidates that can't match. It is meaningless for any other token.
+    uint32_t property_name_hash;
+
     /// This is the first segment in the entire JSON payload, if it was non-contiguous. Otherwise,
     /// its set to #AZ_SPAN_EMPTY.
     az_span* pointer_to_first_buffer;
@@ -218,6 +240,8 @@ AZ_NODISCARD az_result az_json_token_get_int32(az_json_token const* json_token,
  * @retval #AZ_OK The number is returned.
  * @retval #AZ_ERROR_JSON_INVALID_STATE The kind is not #AZ_JSON_TOKEN_NUMBER.
  * @retval #AZ_ERROR_UNEXPECTED_CHAR The resulting \p out_value wouldn't be a finite double number.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The SDK was built with `AZ_NO_DOUBLE`, and the number is not an
+ * integer.
  */
 AZ_NODISCARD az_result az_json_token_get_double(az_json_token const* json_token, double* out_value);
 
@@ -243,6 +267,48 @@ AZ_NODISCARD az_result az_json_token_get_string(
     int32_t destination_max_size,
     int32_t* out_string_length);
 
+/**
+ * @brief Gets the JSON token's string without copying it, when it has nothing to unescape.
+ *
+ * @param[in] json_token A pointer to an #az_json_token instance.
+ * @param[out] out_string A pointer to an #az_span receiving the slice of the JSON text that is the
+ * string, without the surrounding quotes.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The string is returned.
+ * @retval #AZ_ERROR_JSON_INVALID_STATE The kind is not #AZ_JSON_TOKEN_STRING or
+ * #AZ_JSON_TOKEN_PROPERTY_NAME.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The string contains escaped characters, or straddles
+ * non-contiguous buffers, and has to be read with #az_json_token_get_string() or
+ * #az_json_token_unescape_in_place() instead.
+ */
+AZ_NODISCARD az_result
+az_json_token_get_string_slice(az_json_token const* json_token, az_span* out_string);
+
+/**
+ * @brief Gets the JSON token's string, unescaping it within the JSON text itself.
+ *
+ * @param[in] json_token A pointer to an #az_json_token instance.
+ * @param[out] out_string A pointer to an #az_span receiving the unescaped string, which starts
+ * where the token's slice does.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The string is returned.
+ * @retval #AZ_ERROR_JSON_INVALID_STATE The kind is not #AZ_JSON_TOKEN_STRING or
+ * #AZ_JSON_TOKEN_PROPERTY_NAME.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The string straddles non-contiguous buffers.
+ *
+ * @remarks Unescaping always shrinks the string, so it is done in place: the bytes of the token's
+ * slice are overwritten, and the JSON text must be in a writable buffer. After this, the token
+ * must not be read again, but the reader can carry on with the next tokens. When the string
+ * contains no escaped characters, it is returned as is, without any copy.
+ *
+ * @remarks Characters escaped in the form of `\uXXXX` are encoded in UTF-8, including surrogate
+ * pairs.
+ */
+AZ_NODISCARD az_result
+az_json_token_unescape_in_place(az_json_token const* json_token, az_span* out_string);
+
 /**
  * @brief Determines whether the unescaped JSON token value that the #az_json_token points to is
  * equal to the expected text within the provided byte span by doing a case-sensitive comparison.
@@ -260,18 +326,105 @@ AZ_NODISCARD bool az_json_token_is_text_equal(
     az_json_token const* json_token,
     az_span expected_text);
 
-/************************************ JSON WRITER ******************/
+/**
+ * @brief Computes the hash of a property name, which is what the #az_json_reader records for
+ * property name tokens.
+ *
+ * @param[in] name The unescaped property name.
+ *
+ * @return The 32-bit hash of \p name.
+ *
+ * @remarks Different names may have the same hash, so equal hashes must be confirmed by comparing
+ * the text itself.
+ */
+AZ_NODISCARD uint32_t az_json_property_name_hash(az_span name);
 
 /**
- * @brief Allows the user to define custom behavior when writing JSON using the #az_json_writer.
+ * @brief Gets the hash of a property name token, as recorded by the #az_json_reader while reading
+ * it.
+ *
+ * @param[in] json_token A pointer to an #az_json_token instance containing the property name.
+ * @param[out] out_hash A pointer to a variable to receive the hash, which is the same as the one
+ * returned by #az_json_property_name_hash() for the name.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The hash is returned.
+ * @retval #AZ_ERROR_JSON_INVALID_STATE The kind is not #AZ_JSON_TOKEN_PROPERTY_NAME.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The property name contains escaped characters or straddles
+ * non-contiguous buffers, so the reader didn't record its hash.
+ */
+AZ_NODISCARD az_result
+az_json_token_get_property_name_hash(az_json_token const* json_token, uint32_t* out_hash);
+
+/**
+ * @brief A table of known property names, with their hashes computed ahead of time, to find which
+ * one a property name token matches using #az_json_token_find_property_name().
  */
 typedef struct
 {
   struct
   {
-    /// Currently, this is unused, but needed as a placeholder since we can't have an empty struct.
-    bool unused;
+    az_span const* names;
+    uint32_t const* hashes;
+    int32_t size;
   } _internal;
+} az_json_property_name_table;
+
+/**
+ * @brief Initializes an #az_json_property_name_table, computing the hash of each name.
+ *
+ * @param[out] out_table A pointer to an #az_json_property_name_table instance to initialize.
+ * @param[in] names An array of the unescaped property names to find.
+ * @param[out] hashes An array of at least \p size elements, to receive the hash of each name.
+ * @param[in] size The number of \p names.
+ *
+ * @remarks The \p names and \p hashes arrays must outlive the table. A table of constant names
+ * only needs to be initialized once.
+ */
+void az_json_property_name_table_init(
+    az_json_property_name_table* out_table,
+    az_span const names[],
+    uint32_t hashes[],
+    int32_t size);
+
+/**
+ * @brief Finds the name within the \p table that the unescaped JSON token value is equal to.
+ *
+ * @param[in] json_token A pointer to an #az_json_token instance containing the JSON string token.
+ * @param[in] table A pointer to an #az_json_property_name_table instance containing the names to
+ * find.
+ *
+ * @return The index of the first name within the \p table equal to the token value, or -1 if there
+ * is none.
+ *
+ * @remarks For property names with a hash recorded by the #az_json_reader, only the names with the
+ * same hash are compared. Otherwise, every name is compared using #az_json_token_is_text_equal().
+ */
+AZ_NODISCARD int32_t az_json_token_find_property_name(
+    az_json_token const* json_token,
+    az_json_property_name_table const* table);
+
+/************************************ JSON WRITER ******************/
+
+/**
+ * @brief Allows the user to define custom behavior when writing JSON using the #az_json_writer.
+ */
+typedef struct
+{
+  /// __[nullable]__ An array of words the #az_json_writer uses to track the JSON objects and arrays
+  /// nested deeper than 64 levels, each word allowing 64 more levels. The default is `NULL`, which
+  /// limits the nesting to 64 levels.
+  /// The array must outlive the #az_json_writer, and is shared by any copies of it.
+  uint64_t* nesting_stack_extension;
+
+  /// The number of words in the #nesting_stack_extension array.
+  int32_t nesting_stack_extension_size;
+
+  /// When `true`, #az_json_writer_append_json_text() and
+  /// #az_json_writer_append_json_text_reference() trust the JSON text to be a single valid JSON
+  /// value, such as one written by another #az_json_writer, and append it without reading it
+  /// through. The default is `false`.
+  bool append_json_text_without_validation;
 } az_json_writer_options;
 
 /**
@@ -286,14 +439,27 @@ typedef struct
 AZ_NODISCARD AZ_INLINE az_json_writer_options az_json_writer_options_default()
 {
   az_json_writer_options options = (az_json_writer_options) {
-    ._internal = {
-      .unused = false,
-    },
+    .nesting_stack_extension = NULL,
+    .nesting_stack_extension_size = 0,
+    .append_json_text_without_validation = false,
   };
 
   return options;
 }
 
+/**
+ * @brief Defines the signature of the callback function that the caller must implement to receive
+ * the JSON text written by an #az_json_writer initialized with #az_json_writer_sink_init().
+ *
+ * @param[in] user_context The user-defined context passed to #az_json_writer_sink_init().
+ * @param[in] json_text The next part of the JSON text, which is only valid during the call.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval other Failure, after which the writer fails with #AZ_ERROR_NOT_ENOUGH_SPACE.
+ */
+typedef az_result (*az_json_writer_sink_fn)(void* user_context, az_span json_text);
+
 /**
  * @brief Provides forward-only, non-cached writing of UTF-8 encoded JSON text into the provided
  * buffer.
@@ -310,7 +476,17 @@ typedef struct
     // For single contiguous buffer, bytes_written == total_bytes_written
     int32_t total_bytes_written; // Currently, this is primarily used for testing.
     az_span_allocator_fn allocator_callback;
+    // For a writer flushing to a sink, the callback the destination buffer is handed to once full.
+    az_json_writer_sink_fn sink_callback;
     void* user_context;
+    // The number of buffers handed to the allocator callback, or to the sink, so far.
+    int32_t previous_buffer_count;
+    // For a vectored writer, the spans making up the JSON text so far, and the start of the slice
+    // of the destination buffer written since the last one.
+    az_span* vectors;
+    int32_t vectors_size;
+    int32_t vectors_count;
+    int32_t vector_start;
     bool need_comma;
     az_json_token_kind token_kind; // needed for validation, potentially #if/def with preconditions.
     _az_json_bit_stack bit_stack; // needed for validation, potentially #if/def with preconditions.
@@ -363,6 +539,88 @@ AZ_NODISCARD az_result az_json_writer_chunked_init(
     void* user_context,
     az_json_writer_options const* options);
 
+/**
+ * @brief Initializes an #az_json_writer which writes JSON text into a small working buffer, handing
+ * the buffer to a sink, such as a socket or a compressor, each time it is full.
+ *
+ * @param[out] out_json_writer A pointer to an #az_json_writer instance to initialize.
+ * @param[in] working_buffer An #az_span over the byte buffer the JSON text is written into, before
+ * being handed to the sink, of at least 64 bytes.
+ * @param[in] sink_callback An #az_json_writer_sink_fn callback function that receives the JSON text
+ * in the \p working_buffer, once it can't hold the next token, or when #az_json_writer_flush() is
+ * called.
+ * @param user_context A context specific user-defined struct or set of fields that is passed
+ * through to calls to the #az_json_writer_sink_fn.
+ * @param[in] options __[nullable]__ A reference to an #az_json_writer_options
+ * structure which defines custom behavior of the #az_json_writer. If `NULL` is passed, the writer
+ * will use the default options (i.e. #az_json_writer_options_default()).
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_json_writer is initialized successfully.
+ *
+ * @remarks The JSON text of any size is written with the \p working_buffer only, the text of long
+ * strings being split between calls to the sink. Once the JSON text is complete, the end of it
+ * must be handed to the sink with #az_json_writer_flush().
+ */
+AZ_NODISCARD az_result az_json_writer_sink_init(
+    az_json_writer* out_json_writer,
+    az_span working_buffer,
+    az_json_writer_sink_fn sink_callback,
+    void* user_context,
+    az_json_writer_options const* options);
+
+/**
+ * @brief Hands the JSON text written since the last call to the sink of an #az_json_writer
+ * initialized with #az_json_writer_sink_init().
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance flushing to a sink.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The JSON text was handed to the sink, or there was none.
+ * @retval other The error returned by the sink.
+ */
+AZ_NODISCARD az_result az_json_writer_flush(az_json_writer* ref_json_writer);
+
+/**
+ * @brief Initializes an #az_json_writer which writes JSON text into a buffer, while referencing the
+ * JSON text appended with #az_json_writer_append_json_text_reference() instead of copying it.
+ *
+ * @param[out] out_json_writer A pointer to an #az_json_writer instance to initialize.
+ * @param destination_buffer An #az_span over the byte buffer where the JSON text is to be written.
+ * @param[out] vectors An array receiving the spans that make up the JSON text, in order: slices of
+ * the \p destination_buffer, and the referenced JSON texts.
+ * @param[in] vectors_size The number of spans in the \p vectors array, at least 1.
+ * @param[in] options __[nullable]__ A reference to an #az_json_writer_options
+ * structure which defines custom behavior of the #az_json_writer. If `NULL` is passed, the writer
+ * will use the default options (i.e. #az_json_writer_options_default()).
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK #az_json_writer is initialized successfully.
+ *
+ * @remarks The spans can be handed as they are to a transport accepting a list of buffers, such as
+ * an `iovec` array, once #az_json_writer_get_vectors_count() completes them.
+ */
+AZ_NODISCARD az_result az_json_writer_vectored_init(
+    az_json_writer* out_json_writer,
+    az_span destination_buffer,
+    az_span vectors[],
+    int32_t vectors_size,
+    az_json_writer_options const* options);
+
+/**
+ * @brief Completes the spans that make up the JSON text written so far by a writer initialized with
+ * #az_json_writer_vectored_init(), and returns their number.
+ *
+ * @param[in,out] ref_json_writer A pointer to a vectored #az_json_writer instance.
+ *
+ * @return The number of spans at the start of the vectors array given to
+ * #az_json_writer_vectored_init(), which concatenated in order give the JSON text.
+ *
+ * @remarks The vectors array is updated with the slice of the destination buffer written since the
+ * last referenced JSON text, so this must be called again once more JSON text is appended.
+ */
+AZ_NODISCARD int32_t az_json_writer_get_vectors_count(az_json_writer* ref_json_writer);
+
 /**
  * @brief Returns the #az_span containing the JSON text written to the underlying buffer so far, in
  * the last provided destination buffer.
@@ -387,6 +645,62 @@ az_json_writer_get_bytes_used_in_destination(az_json_writer const* json_writer)
       json_writer->_internal.destination_buffer, 0, json_writer->_internal.bytes_written);
 }
 
+/**
+ * @brief The state of an #az_json_writer at some point, which the writer can be rolled back to with
+ * #az_json_writer_rollback().
+ */
+typedef struct
+{
+  struct
+  {
+    int32_t bytes_written;
+    int32_t total_bytes_written;
+    int32_t vectors_count;
+    int32_t vector_start;
+    int32_t previous_buffer_count;
+    bool need_comma;
+    az_json_token_kind token_kind;
+    _az_json_bit_stack bit_stack;
+  } _internal;
+} az_json_writer_checkpoint;
+
+/**
+ * @brief Gets a checkpoint of the current state of an #az_json_writer, to roll back the JSON text
+ * appended after it with #az_json_writer_rollback().
+ *
+ * @param[in] json_writer A pointer to an #az_json_writer instance.
+ *
+ * @return The #az_json_writer_checkpoint of the current state of the \p json_writer.
+ *
+ * @remarks For instance, an element that doesn't fit in a batch can be rolled back, so the batch
+ * can be closed and sent without it.
+ */
+AZ_NODISCARD az_json_writer_checkpoint
+az_json_writer_get_checkpoint(az_json_writer const* json_writer);
+
+/**
+ * @brief Rolls an #az_json_writer back to a checkpoint, as if the JSON text appended since, or
+ * partially appended before failing, had never been.
+ *
+ * @param[in,out] ref_json_writer A pointer to the #az_json_writer instance the \p checkpoint was
+ * taken from.
+ * @param[in] checkpoint A pointer to an #az_json_writer_checkpoint returned by
+ * #az_json_writer_get_checkpoint().
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The writer is rolled back to the \p checkpoint.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The writer handed a buffer to its allocator callback, or to its
+ * sink, since the \p checkpoint. The writer is left unchanged.
+ *
+ * @remarks The JSON text written since the \p checkpoint may be overwritten in the buffer. The
+ * states of the objects and arrays nested deeper than 64 levels are kept in the
+ * #az_json_writer_options.nesting_stack_extension, which isn't rolled back, so those open at the
+ * \p checkpoint must not be closed before rolling back.
+ */
+AZ_NODISCARD az_result az_json_writer_rollback(
+    az_json_writer* ref_json_writer,
+    az_json_writer_checkpoint const* checkpoint);
+
 /**
  * @brief Appends the UTF-8 text value (as a JSON string) into the buffer.
  *
@@ -418,7 +732,8 @@ AZ_NODISCARD az_result az_json_writer_append_string(az_json_writer* ref_json_wri
  * be incomplete.
  *
  * @remarks The function validates that the provided JSON to be appended is valid and properly
- * escaped, and fails otherwise.
+ * escaped, and fails otherwise, unless
+ * #az_json_writer_options.append_json_text_without_validation is set.
  *
  * @return An #az_result value indicating the result of the operation.
  * @retval #AZ_OK The provided \p json_text was appended successfully.
@@ -433,6 +748,30 @@ AZ_NODISCARD az_result az_json_writer_append_string(az_json_writer* ref_json_wri
 AZ_NODISCARD az_result
 az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_text);
 
+/**
+ * @brief Appends an existing UTF-8 encoded JSON text by reference, without copying it, to a writer
+ * initialized with #az_json_writer_vectored_init().
+ *
+ * @param[in,out] ref_json_writer A pointer to a vectored #az_json_writer instance.
+ * @param[in] json_text A single, possibly nested, valid, UTF-8 encoded, JSON value, as for
+ * #az_json_writer_append_json_text().
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The provided \p json_text was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The vectors array or the destination buffer is too small.
+ * @retval #AZ_ERROR_JSON_INVALID_STATE The \p ref_json_writer is in a state where the \p json_text
+ * cannot be appended because it would result in invalid JSON.
+ * @retval #AZ_ERROR_UNEXPECTED_END The provided \p json_text is invalid because it is incomplete
+ * and ends too early.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR The provided \p json_text is invalid because of an unexpected
+ * character.
+ *
+ * @remarks The \p json_text is validated as by #az_json_writer_append_json_text(), and becomes one
+ * of the vectors of the writer, so it must outlive them. Appending it uses up to two more vectors.
+ */
+AZ_NODISCARD az_result
+az_json_writer_append_json_text_reference(az_json_writer* ref_json_writer, az_span json_text);
+
 /**
  * @brief Appends the UTF-8 property name (as a JSON string) which is the first part of a name/value
  * pair of a JSON object.
@@ -449,6 +788,45 @@ az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_te
 AZ_NODISCARD az_result
 az_json_writer_append_property_name(az_json_writer* ref_json_writer, az_span name);
 
+/**
+ * @brief Returns a literal #az_span initializer of the JSON text of a property name, i.e. the
+ * quoted name followed by the colon separator, for #az_json_writer_append_escaped_property_name().
+ *
+ * @param[in] NAME A string literal of the property name, already escaped as a JSON string.
+ *
+ * @remarks For example, `AZ_JSON_NAME_LITERAL("temperature")` is the `"temperature":` JSON text.
+ */
+#define AZ_JSON_NAME_LITERAL(NAME) AZ_SPAN_LITERAL_FROM_STR("\"" NAME "\":")
+
+/**
+ * @brief Returns an #az_span of the JSON text of a property name, i.e. the quoted name followed by
+ * the colon separator, for #az_json_writer_append_escaped_property_name().
+ *
+ * @param[in] NAME A string literal of the property name, already escaped as a JSON string.
+ *
+ * @remarks For example, `AZ_JSON_NAME("temperature")` is the `"temperature":` JSON text.
+ */
+#define AZ_JSON_NAME(NAME) AZ_SPAN_FROM_STR("\"" NAME "\":")
+
+/**
+ * @brief Appends a property name, already quoted, escaped and followed by the colon separator,
+ * which is the first part of a name/value pair of a JSON object.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the property name to.
+ * @param[in] json_name The JSON text of the property name, such as the one built by
+ * #AZ_JSON_NAME(). It is copied as is.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The property name was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remarks Unlike #az_json_writer_append_property_name(), which escapes the name each time, this
+ * lets property names that are known in advance be escaped once, at compile time.
+ */
+AZ_NODISCARD az_result
+az_json_writer_append_escaped_property_name(az_json_writer* ref_json_writer, az_span json_name);
+
 /**
  * @brief Appends a boolean value (as a JSON literal `true` or `false`).
  *
@@ -475,6 +853,53 @@ AZ_NODISCARD az_result az_json_writer_append_bool(az_json_writer* ref_json_write
  */
 AZ_NODISCARD az_result az_json_writer_append_int32(az_json_writer* ref_json_writer, int32_t value);
 
+/**
+ * @brief Appends an `int64_t` number value.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the number to.
+ * @param[in] value The value to be written as a JSON number.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The number was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remark Unlike #az_json_writer_append_double(), every digit of the \p value is written exactly,
+ * including for magnitudes beyond `2^53`, such as 64-bit counters and epoch timestamps.
+ */
+AZ_NODISCARD az_result az_json_writer_append_int64(az_json_writer* ref_json_writer, int64_t value);
+
+/**
+ * @brief Appends a `uint64_t` number value.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the number to.
+ * @param[in] value The value to be written as a JSON number.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The number was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_json_writer_append_uint64(az_json_writer* ref_json_writer, uint64_t value);
+
+/**
+ * @brief Appends a UTC time as a JSON string holding its ISO 8601 timestamp, as written by
+ * az_span_format_iso8601() (for example, `"2021-03-04T05:06:07.089Z"`).
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the timestamp to.
+ * @param[in] unix_time_msec The number of milliseconds since `1970-01-01T00:00:00.000Z`, for a time
+ * within the years 0000 to 9999.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The timestamp was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ * @retval #AZ_ERROR_ARG The \p unix_time_msec is out of the years 0000 to 9999.
+ */
+AZ_NODISCARD az_result
+az_json_writer_append_iso8601(az_json_writer* ref_json_writer, int64_t unix_time_msec);
+
 /**
  * @brief Appends a `double` number value.
  *
@@ -488,7 +913,7 @@ AZ_NODISCARD az_result az_json_writer_append_int32(az_json_writer* ref_json_writ
  * @retval #AZ_OK The number was appended successfully.
  * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
  * @retval #AZ_ERROR_NOT_SUPPORTED The \p value contains an integer component that is too large and
- * would overflow beyond `2^53 - 1`.
+ * would overflow beyond `2^53 - 1`, or the SDK was built with `AZ_NO_DOUBLE`.
  *
  * @remark Only finite double values are supported. Values such as `NAN` and `INFINITY` are not
  * allowed and would lead to invalid JSON being written.
@@ -504,6 +929,29 @@ AZ_NODISCARD az_result az_json_writer_append_double(
     double value,
     int32_t fractional_digits);
 
+/**
+ * @brief Appends a `double` number value, with the fewest digits that parse back to the exact same
+ * value.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the number to.
+ * @param[in] value The value to be written as a JSON number.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The number was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The SDK was built with `AZ_NO_DOUBLE`.
+ *
+ * @remark Only finite double values are supported. Values such as `NAN` and `INFINITY` are not
+ * allowed and would lead to invalid JSON being written.
+ *
+ * @remark Unlike #az_json_writer_append_double(), any finite `double` is supported, and the
+ * number is written in scientific notation when its decimal exponent is less than -6 or greater
+ * than 20, as described by #az_span_dtoa_shortest().
+ */
+AZ_NODISCARD az_result
+az_json_writer_append_double_shortest(az_json_writer* ref_json_writer, double value);
+
 /**
  * @brief Appends the JSON literal `null`.
  *
@@ -526,7 +974,7 @@ AZ_NODISCARD az_result az_json_writer_append_null(az_json_writer* ref_json_write
  * @retval #AZ_OK Object start was appended successfully.
  * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
  * @retval #AZ_ERROR_JSON_NESTING_OVERFLOW The depth of the JSON exceeds the maximum allowed
- * depth of 64.
+ * depth of 64, or more with #az_json_writer_options.nesting_stack_extension.
  */
 AZ_NODISCARD az_result az_json_writer_append_begin_object(az_json_writer* ref_json_writer);
 
@@ -540,7 +988,7 @@ AZ_NODISCARD az_result az_json_writer_append_begin_object(az_json_writer* ref_js
  * @retval #AZ_OK Array start was appended successfully.
  * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
  * @retval #AZ_ERROR_JSON_NESTING_OVERFLOW The depth of the JSON exceeds the maximum allowed depth
- * of 64.
+ * of 64, or more with #az_json_writer_options.nesting_stack_extension.
  */
 AZ_NODISCARD az_result az_json_writer_append_begin_array(az_json_writer* ref_json_writer);
 
@@ -568,18 +1016,325 @@ AZ_NODISCARD az_result az_json_writer_append_end_object(az_json_writer* ref_json
  */
 AZ_NODISCARD az_result az_json_writer_append_end_array(az_json_writer* ref_json_writer);
 
-/************************************ JSON READER ******************/
+/**
+ * @brief Appends a JSON array of `int32_t` number values.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the array to.
+ * @param[in] values The values to be written as JSON numbers.
+ * @param[in] values_count The number of values in the \p values array.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The array was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remarks The array is written as by #az_json_writer_append_begin_array(), followed by
+ * #az_json_writer_append_int32() for each value, and #az_json_writer_append_end_array(), but the
+ * writer state is validated and updated only once for all the values.
+ *
+ * @remarks If the buffer runs out, the array is left partially written.
+ */
+AZ_NODISCARD az_result az_json_writer_append_int32_array(
+    az_json_writer* ref_json_writer,
+    int32_t const values[],
+    int32_t values_count);
 
 /**
- * @brief Allows the user to define custom behavior when reading JSON using the #az_json_reader.
+ * @brief Appends a JSON array of `int64_t` number values.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the array to.
+ * @param[in] values The values to be written as JSON numbers.
+ * @param[in] values_count The number of values in the \p values array.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The array was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remarks The writer state is validated and updated only once for all the values. If the buffer
+ * runs out, the array is left partially written.
+ */
+AZ_NODISCARD az_result az_json_writer_append_int64_array(
+    az_json_writer* ref_json_writer,
+    int64_t const values[],
+    int32_t values_count);
+
+/**
+ * @brief Appends a JSON array of `double` number values.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the array to.
+ * @param[in] values The values to be written as JSON numbers.
+ * @param[in] values_count The number of values in the \p values array.
+ * @param[in] fractional_digits The number of digits of each value to write after the decimal
+ * point and truncate the rest.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The array was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ * @retval #AZ_ERROR_NOT_SUPPORTED One of the \p values contains an integer component that is too
+ * large and would overflow beyond `2^53 - 1`.
+ *
+ * @remarks Each value is written as by #az_json_writer_append_double(). The writer state is
+ * validated and updated only once for all the values. If the buffer runs out, or a value isn't
+ * supported, the array is left partially written.
+ */
+AZ_NODISCARD az_result az_json_writer_append_double_array(
+    az_json_writer* ref_json_writer,
+    double const values[],
+    int32_t values_count,
+    int32_t fractional_digits);
+
+/**
+ * @brief Appends a JSON array of boolean values, as the JSON literals `true` and `false`.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the array to.
+ * @param[in] values The values to be written as JSON literals.
+ * @param[in] values_count The number of values in the \p values array.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The array was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remarks The writer state is validated and updated only once for all the values. If the buffer
+ * runs out, the array is left partially written.
+ */
+AZ_NODISCARD az_result az_json_writer_append_bool_array(
+    az_json_writer* ref_json_writer,
+    bool const values[],
+    int32_t values_count);
+
+/************************************ JSON TEMPLATE ******************/
+
+/**
+ * @brief The JSON text of messages sharing the same shape, written once with an #az_json_writer,
+ * and the offsets of the slots where their values go.
+ *
+ * @remarks An #az_json_template_writer produces each message by copying the text between the
+ * slots, and formatting the values into them, without the validation and state tracking of the
+ * #az_json_writer.
+ *
+ * @remarks An instance of #az_json_template must not outlive the lifetime of the slot offsets it
+ * was initialized with, or of the buffer of the #az_json_writer it was written with.
  */
 typedef struct
 {
   struct
   {
-    /// Currently, this is unused, but needed as a placeholder since we can't have an empty struct.
-    bool unused;
+    az_span json;
+    int32_t* slot_offsets;
+    int32_t slots_size;
+    int32_t slot_count;
   } _internal;
+} az_json_template;
+
+/**
+ * @brief Initializes an #az_json_template, before writing its JSON text.
+ *
+ * @param[out] out_json_template A pointer to an #az_json_template instance to initialize.
+ * @param[in] slot_offsets An array to record the offsets of the slots in.
+ * @param[in] slots_size The number of offsets in the \p slot_offsets array, i.e. the maximum number
+ * of slots.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_json_template is initialized successfully.
+ */
+AZ_NODISCARD az_result az_json_template_init(
+    az_json_template* out_json_template,
+    int32_t slot_offsets[],
+    int32_t slots_size);
+
+/**
+ * @brief Appends a slot, where a JSON value is written later by an #az_json_template_writer.
+ *
+ * @param[in,out] ref_json_template A pointer to an #az_json_template instance to record the slot
+ * in.
+ * @param[in,out] ref_json_writer A pointer to the #az_json_writer instance writing the JSON text of
+ * the template.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The slot was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The template has no more slot offsets, or the buffer is too
+ * small.
+ *
+ * @remarks The slot is written wherever a JSON value can be appended, such as after a property
+ * name, or within an array. Nothing but the comma separating it from a previous value is written.
+ *
+ * @remarks The \p ref_json_writer must write into a single contiguous buffer, i.e. it must be
+ * initialized with #az_json_writer_init().
+ */
+AZ_NODISCARD az_result az_json_template_append_slot(
+    az_json_template* ref_json_template,
+    az_json_writer* ref_json_writer);
+
+/**
+ * @brief Ends an #az_json_template, recording the JSON text written so far as its text.
+ *
+ * @param[in,out] ref_json_template A pointer to an #az_json_template instance to end.
+ * @param[in] json_writer A pointer to the #az_json_writer instance that wrote the JSON text of the
+ * template.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_json_template is ready to be used by an #az_json_template_writer.
+ */
+AZ_NODISCARD az_result
+az_json_template_end(az_json_template* ref_json_template, az_json_writer const* json_writer);
+
+/**
+ * @brief Writes a message from an #az_json_template, by filling its slots in order.
+ *
+ * @remarks An instance of #az_json_template_writer must not outlive the lifetime of the
+ * #az_json_template, or of the destination buffer, it was initialized with.
+ */
+typedef struct
+{
+  struct
+  {
+    az_json_template const* json_template;
+    az_span destination_buffer;
+    int32_t bytes_written;
+    // The index of the next slot to fill.
+    int32_t slot_index;
+  } _internal;
+} az_json_template_writer;
+
+/**
+ * @brief Initializes an #az_json_template_writer to write a message from an #az_json_template into
+ * the provided buffer.
+ *
+ * @param[out] out_json_template_writer A pointer to an #az_json_template_writer instance to
+ * initialize.
+ * @param[in] json_template A pointer to an ended #az_json_template.
+ * @param[out] destination_buffer An #az_span over the byte buffer where the message is written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_json_template_writer is initialized successfully.
+ */
+AZ_NODISCARD az_result az_json_template_writer_init(
+    az_json_template_writer* out_json_template_writer,
+    az_json_template const* json_template,
+    az_span destination_buffer);
+
+/**
+ * @brief Fills the next slot with a JSON string value, escaping it as needed.
+ *
+ * @param[in,out] ref_json_template_writer A pointer to an #az_json_template_writer instance.
+ * @param[in] value The UTF-8 encoded value to be written as a JSON string.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The slot was filled successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result az_json_template_writer_append_string(
+    az_json_template_writer* ref_json_template_writer,
+    az_span value);
+
+/**
+ * @brief Fills the next slot with a boolean value, as the JSON literal `true` or `false`.
+ *
+ * @param[in,out] ref_json_template_writer A pointer to an #az_json_template_writer instance.
+ * @param[in] value The value to be written as a JSON literal.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The slot was filled successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_json_template_writer_append_bool(az_json_template_writer* ref_json_template_writer, bool value);
+
+/**
+ * @brief Fills the next slot with an `int32_t` number value.
+ *
+ * @param[in,out] ref_json_template_writer A pointer to an #az_json_template_writer instance.
+ * @param[in] value The value to be written as a JSON number.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The slot was filled successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result az_json_template_writer_append_int32(
+    az_json_template_writer* ref_json_template_writer,
+    int32_t value);
+
+/**
+ * @brief Fills the next slot with a `double` number value.
+ *
+ * @param[in,out] ref_json_template_writer A pointer to an #az_json_template_writer instance.
+ * @param[in] value The value to be written as a JSON number.
+ * @param[in] fractional_digits The number of digits of the \p value to write after the decimal
+ * point and truncate the rest.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The slot was filled successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The \p value contains an integer component that is too large and
+ * would overflow beyond `2^53 - 1`.
+ *
+ * @remark The \p value is written as by #az_json_writer_append_double().
+ */
+AZ_NODISCARD az_result az_json_template_writer_append_double(
+    az_json_template_writer* ref_json_template_writer,
+    double value,
+    int32_t fractional_digits);
+
+/**
+ * @brief Fills the next slot with a `double` number value, with the fewest digits that parse back
+ * to the exact same value.
+ *
+ * @param[in,out] ref_json_template_writer A pointer to an #az_json_template_writer instance.
+ * @param[in] value The value to be written as a JSON number.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The slot was filled successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remark The \p value is written as by #az_json_writer_append_double_shortest().
+ */
+AZ_NODISCARD az_result az_json_template_writer_append_double_shortest(
+    az_json_template_writer* ref_json_template_writer,
+    double value);
+
+/**
+ * @brief Copies the JSON text following the last slot, and returns the complete message.
+ *
+ * @param[in,out] ref_json_template_writer A pointer to an #az_json_template_writer instance, whose
+ * slots are all filled.
+ * @param[out] out_json A pointer to an #az_span receiving the message written into the destination
+ * buffer.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The message was completed successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_json_template_writer_end(az_json_template_writer* ref_json_template_writer, az_span* out_json);
+
+/************************************ JSON READER ******************/
+
+/**
+ * @brief Allows the user to define custom behavior when reading JSON using the #az_json_reader.
+ */
+typedef struct
+{
+  /// __[nullable]__ An array of words the #az_json_reader uses to track the JSON objects and arrays
+  /// nested deeper than 64 levels, each word allowing 64 more levels. The default is `NULL`, which
+  /// limits the nesting to 64 levels.
+  /// The array must outlive the #az_json_reader, and is shared by any copies of it.
+  uint64_t* nesting_stack_extension;
+
+  /// The number of words in the #nesting_stack_extension array.
+  int32_t nesting_stack_extension_size;
+
+  /// When `true`, #az_json_reader_skip_children() skips objects and arrays by only looking for
+  /// their end, without validating their content. The default is `false`.
+  bool skip_children_without_validation;
+
+  /// When `true`, the #az_json_reader checks that strings, and property names, are valid UTF-8
+  /// (RFC 3629), while it reads them, and returns #AZ_ERROR_UNEXPECTED_CHAR otherwise. Escaped
+  /// characters (`\uXXXX`) aren't checked. The default is `false`, which accepts any byte that
+  /// isn't a control character.
+  bool validate_utf8;
 } az_json_reader_options;
 
 /**
@@ -594,9 +1349,10 @@ typedef struct
 AZ_NODISCARD AZ_INLINE az_json_reader_options az_json_reader_options_default()
 {
   az_json_reader_options options = (az_json_reader_options) {
-    ._internal = {
-      .unused = false,
-    },
+    .nesting_stack_extension = NULL,
+    .nesting_stack_extension_size = 0,
+    .skip_children_without_validation = false,
+    .validate_utf8 = false,
   };
 
   return options;
@@ -647,6 +1403,13 @@ typedef struct
 
     /// A copy of the options provided by the user.
     az_json_reader_options options;
+
+    /// The buffer the JSON text fed to an incremental reader is kept in, which is empty for the
+    /// other readers.
+    az_span incremental_buffer;
+
+    /// Flag which indicates that the end of the JSON text was fed to an incremental reader.
+    bool is_final_feed;
   } _internal;
 } az_json_reader;
 
@@ -689,6 +1452,8 @@ AZ_NODISCARD az_result az_json_reader_init(
  *
  * @return An #az_result value indicating the result of the operation.
  * @retval #AZ_OK The #az_json_reader is initialized successfully.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The SDK was built with `AZ_NO_JSON_READER_CHUNKS`, and \p
+ * number_of_buffers is greater than 1.
  * @retval other Initialization failed.
  *
  * @remarks The provided array of json buffers must not be empty, as that is invalid JSON, and
@@ -704,6 +1469,60 @@ AZ_NODISCARD az_result az_json_reader_chunked_init(
     int32_t number_of_buffers,
     az_json_reader_options const* options);
 
+/**
+ * @brief Initializes an #az_json_reader to read a JSON payload fed to it in pieces, as they are
+ * received, with #az_json_reader_feed().
+ *
+ * @param[out] out_json_reader A pointer to an #az_json_reader instance to initialize.
+ * @param[in] buffer An #az_span over the byte buffer the reader keeps the JSON text it was fed in,
+ * until it is read.
+ * @param[in] options __[nullable]__ A reference to an #az_json_reader_options structure which
+ * defines custom behavior of the #az_json_reader. If `NULL` is passed, the reader will use the
+ * default options (i.e. #az_json_reader_options_default()).
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_json_reader is initialized successfully.
+ * @retval other Initialization failed.
+ *
+ * @remarks Until the end of the JSON text is fed, #az_json_reader_next_token() and
+ * #az_json_reader_skip_children() return #AZ_ERROR_JSON_READER_NEED_MORE_DATA, instead of
+ * #AZ_ERROR_UNEXPECTED_END, when the text fed so far ends within what they read. The reader is
+ * then left as it was before the call, which can be repeated once more of the text is fed. Since
+ * characters may still follow the root value, #AZ_ERROR_JSON_READER_DONE is only returned once
+ * the final piece is fed.
+ *
+ * @remarks The \p buffer must be large enough for the largest token plus the largest piece fed,
+ * and, with #az_json_reader_skip_children(), for the objects and arrays skipped.
+ */
+AZ_NODISCARD az_result az_json_reader_incremental_init(
+    az_json_reader* out_json_reader,
+    az_span buffer,
+    az_json_reader_options const* options);
+
+/**
+ * @brief Feeds the next piece of the JSON text to an #az_json_reader initialized with
+ * #az_json_reader_incremental_init().
+ *
+ * @param[in,out] ref_json_reader A pointer to an incremental #az_json_reader instance.
+ * @param[in] json_piece An #az_span over the bytes following the JSON text fed so far, which may
+ * be empty.
+ * @param[in] is_final_piece `true` if the \p json_piece is the end of the JSON text, after which
+ * nothing more is fed.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The piece of JSON text was fed successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer of the reader can't hold the JSON text left to read
+ * and the \p json_piece. The reader is left unchanged.
+ *
+ * @remarks The JSON text left to read is moved to the start of the buffer of the reader, so the
+ * slice of the current token, and of the tokens read before, must not be used once a piece is fed.
+ * The \p json_piece is copied and doesn't need to outlive the call.
+ */
+AZ_NODISCARD az_result az_json_reader_feed(
+    az_json_reader* ref_json_reader,
+    az_span json_piece,
+    bool is_final_piece);
+
 /**
  * @brief Reads the next token in the JSON text and updates the reader state.
  *
@@ -714,7 +1533,11 @@ AZ_NODISCARD az_result az_json_reader_chunked_init(
  * @retval #AZ_OK The token was read successfully.
  * @retval #AZ_ERROR_UNEXPECTED_END The end of the JSON document is reached.
  * @retval #AZ_ERROR_UNEXPECTED_CHAR An invalid character is detected.
+ * @retval #AZ_ERROR_JSON_NESTING_OVERFLOW The JSON is nested deeper than 64 levels, or more with
+ * #az_json_reader_options.nesting_stack_extension.
  * @retval #AZ_ERROR_JSON_READER_DONE No more JSON text left to process.
+ * @retval #AZ_ERROR_JSON_READER_NEED_MORE_DATA The JSON text fed to an incremental reader so far
+ * ends within the next token.
  */
 AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader);
 
@@ -728,13 +1551,301 @@ AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader
  * @retval #AZ_OK The children of the current JSON token are skipped successfully.
  * @retval #AZ_ERROR_UNEXPECTED_END The end of the JSON document is reached.
  * @retval #AZ_ERROR_UNEXPECTED_CHAR An invalid character is detected.
+ * @retval #AZ_ERROR_JSON_READER_NEED_MORE_DATA The JSON text fed to an incremental reader so far
+ * ends within the children.
  *
  * @remarks If the current token kind is a property name, the reader first moves to the property
  * value. Then, if the token kind is start of an object or array, the reader moves to the matching
  * end object or array. For all other token kinds, the reader doesn't move and returns #AZ_OK.
+ *
+ * @remarks With #az_json_reader_options.skip_children_without_validation, the object or array is
+ * skipped by only tracking strings and the nesting of brackets, using SIMD instructions when
+ * available, so invalid JSON within it goes undetected.
  */
 AZ_NODISCARD az_result az_json_reader_skip_children(az_json_reader* ref_json_reader);
 
+/************************************ JSON PATHS ******************/
+
+enum
+{
+  _az_JSON_PATH_MAX_NAMES = 8, ///< The maximum number of property names in an #az_json_path.
+  _az_JSON_PATH_MAX_COUNT = 32, ///< The maximum number of paths #az_json_reader_select() matches.
+};
+
+/**
+ * @brief A JSON path, i.e. a sequence of nested property names, compiled for
+ * #az_json_reader_select().
+ *
+ * @remarks An instance of #az_json_path must not outlive the lifetime of the path text it was
+ * initialized from.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span path;
+    int32_t name_count;
+    // The offset of the end of each property name within path.
+    int32_t name_ends[_az_JSON_PATH_MAX_NAMES];
+    uint32_t name_hashes[_az_JSON_PATH_MAX_NAMES];
+  } _internal;
+} az_json_path;
+
+/**
+ * @brief Initializes an #az_json_path from the text of a path, such as `desired.targetTemperature`
+ * or `$version`.
+ *
+ * @param[out] out_json_path A pointer to an #az_json_path instance to initialize.
+ * @param[in] path The property names leading to the values to look for, separated by dots, and
+ * starting with a property of the root JSON object. The names are compared with the unescaped
+ * property names of the JSON.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_json_path is initialized successfully.
+ * @retval #AZ_ERROR_ARG The \p path contains an empty name, or more than 8 names.
+ *
+ * @remarks Property names containing a dot can't be part of a path.
+ */
+AZ_NODISCARD az_result az_json_path_init(az_json_path* out_json_path, az_span path);
+
+/**
+ * @brief Defines the signature of the callback function that #az_json_reader_select() calls for
+ * each JSON value it finds at one of the paths.
+ *
+ * @param[in,out] ref_json_reader A pointer to the #az_json_reader, whose current token is the start
+ * of the value found.
+ * @param[in] path_index The index of the matching path within the paths given to
+ * #az_json_reader_select().
+ * @param[in] user_context A pointer to the user context given to #az_json_reader_select().
+ *
+ * @return An #az_result value indicating the result of the operation. Failures stop the
+ * selection and are returned by #az_json_reader_select().
+ *
+ * @remarks The callback may read the value with the reader, either leaving it on the token that
+ * starts the value, or on the token that ends it.
+ */
+typedef AZ_NODISCARD az_result (*az_json_path_handler_fn)(
+    az_json_reader* ref_json_reader,
+    int32_t path_index,
+    void* user_context);
+
+/**
+ * @brief Reads a JSON object, calling \p handler for each of its values found at one of the \p
+ * paths, and skipping over the others.
+ *
+ * @param[in,out] ref_json_reader A pointer to an #az_json_reader instance, either on the start of
+ * the JSON object to read, or not having read any token yet.
+ * @param[in] paths An array of compiled paths to look for.
+ * @param[in] paths_count The number of paths, up to 32.
+ * @param[in] handler The callback to call for each value found.
+ * @param[in] user_context A pointer passed to \p handler.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The JSON object was read until its end.
+ * @retval #AZ_ERROR_UNEXPECTED_END The end of the JSON document is reached.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR An invalid character is detected.
+ * @retval other A failure returned by \p handler.
+ *
+ * @remarks The property names are hashed as they are read, and compared to the hashes of the
+ * names the paths expect at their depth, so that the cost of selecting values barely depends on
+ * the number of paths. Objects that no path goes through are skipped without looking at their
+ * property names.
+ *
+ * @remarks When a path is a prefix of another (such as `desired` and `desired.targetTemperature`),
+ * only the shorter one is matched, and of identical paths, only the first one. Values within arrays
+ * are never matched. If the JSON value read
+ * isn't an object, it is skipped.
+ */
+AZ_NODISCARD az_result az_json_reader_select(
+    az_json_reader* ref_json_reader,
+    az_json_path const paths[],
+    int32_t paths_count,
+    az_json_path_handler_fn handler,
+    void* user_context);
+
+/**
+ * @brief Defines the signature of the callback function that #az_json_transcode() calls for each
+ * JSON value it finds at one of the paths, to write the value that replaces it.
+ *
+ * @param[in,out] ref_json_reader A pointer to the #az_json_reader, whose current token is the start
+ * of the value found.
+ * @param[in,out] ref_json_writer A pointer to the #az_json_writer, which has written the property
+ * name of the value found.
+ * @param[in] path_index The index of the matching path within the paths given to
+ * #az_json_transcode().
+ * @param[in] user_context A pointer to the user context given to #az_json_transcode().
+ *
+ * @return An #az_result value indicating the result of the operation. Failures stop the
+ * transcoding and are returned by #az_json_transcode().
+ *
+ * @remarks The callback must write exactly one JSON value. It may read the value it replaces with
+ * the reader, either leaving it on the token that starts the value, or on the token that ends it.
+ */
+typedef AZ_NODISCARD az_result (*az_json_transcode_handler_fn)(
+    az_json_reader* ref_json_reader,
+    az_json_writer* ref_json_writer,
+    int32_t path_index,
+    void* user_context);
+
+/**
+ * @brief Copies a JSON object from a reader to a writer, calling \p handler to rewrite each of its
+ * values found at one of the \p paths, and copying everything else as is.
+ *
+ * @param[in,out] ref_json_reader A pointer to an #az_json_reader instance over a single buffer,
+ * either on the start of the JSON object to read, or not having read any token yet.
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance, in a state where a value
+ * can be appended.
+ * @param[in] paths An array of compiled paths of the values to rewrite.
+ * @param[in] paths_count The number of paths, up to 32.
+ * @param[in] handler The callback to call for each value found.
+ * @param[in] user_context A pointer passed to \p handler.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The JSON object was copied until its end.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The writer's buffer is too small.
+ * @retval #AZ_ERROR_UNEXPECTED_END The end of the JSON document is reached.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR The JSON value read isn't an object, or an invalid character
+ * is detected.
+ * @retval other A failure returned by \p handler.
+ *
+ * @remarks The end of the object is not written, so that properties can be appended to it before
+ * calling #az_json_writer_append_end_object().
+ *
+ * @remarks The properties are matched as by #az_json_reader_select(). The name/value pairs that no
+ * path goes through are copied from the JSON text as is, a run of consecutive ones at a time, with
+ * their values bounded by #az_json_reader_skip_children(), instead of being written again token by
+ * token. Their whitespace is kept, and their text isn't escaped or validated again by the writer.
+ */
+AZ_NODISCARD az_result az_json_transcode(
+    az_json_reader* ref_json_reader,
+    az_json_writer* ref_json_writer,
+    az_json_path const paths[],
+    int32_t paths_count,
+    az_json_transcode_handler_fn handler,
+    void* user_context);
+
+/************************************ JSON TAPE ******************/
+
+/**
+ * @brief An entry of an #az_json_tape, describing one JSON token.
+ */
+typedef struct
+{
+  struct
+  {
+    // The offset of the token slice within the JSON payload.
+    int32_t offset;
+    int32_t size;
+    // The index of the entry following the token's value: the one after the matching end of an
+    // object or array, after the value of a property name, or simply the next one.
+    int32_t next;
+    uint8_t kind;
+    bool string_has_escaped_chars;
+  } _internal;
+} az_json_tape_entry;
+
+/**
+ * @brief The tokens of a JSON payload, read once into a caller-provided array of entries, so that
+ * they can be looked up and skipped over in constant time, any number of times.
+ *
+ * @remarks An instance of #az_json_tape must not outlive the lifetime of the JSON payload or of
+ * the entries it was initialized with.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span json;
+    az_json_tape_entry* entries;
+    int32_t count;
+  } _internal;
+} az_json_tape;
+
+/**
+ * @brief Initializes an #az_json_tape by reading all of the tokens of the JSON payload contained
+ * within the provided buffer.
+ *
+ * @param[out] out_json_tape A pointer to an #az_json_tape instance to initialize.
+ * @param[in] json_buffer An #az_span over the byte buffer containing the JSON text to read.
+ * @param[out] entries An array of entries to fill, one for each token of the JSON text.
+ * @param[in] entries_size The number of entries in the \p entries array.
+ * @param[in] options __[nullable]__ A reference to an #az_json_reader_options structure which
+ * defines custom behavior of the #az_json_reader the JSON text is read with. If `NULL` is passed,
+ * the reader will use the default options (i.e. #az_json_reader_options_default()).
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The whole JSON text was read into the \p entries.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The JSON text has more tokens than \p entries_size.
+ * @retval #AZ_ERROR_UNEXPECTED_END The end of the JSON document is reached too early.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR An invalid character is detected.
+ * @retval #AZ_ERROR_JSON_NESTING_OVERFLOW The JSON is nested too deeply.
+ *
+ * @remarks The provided json buffer must not be empty, as that is invalid JSON.
+ */
+AZ_NODISCARD az_result az_json_tape_init(
+    az_json_tape* out_json_tape,
+    az_span json_buffer,
+    az_json_tape_entry* entries,
+    int32_t entries_size,
+    az_json_reader_options const* options);
+
+/**
+ * @brief Returns the number of tokens of the JSON text read into an #az_json_tape.
+ *
+ * @param[in] json_tape A pointer to an #az_json_tape instance.
+ *
+ * @return The number of tokens, whose indexes go from 0, the first token of the JSON text, to the
+ * number of tokens minus 1.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_json_tape_get_count(az_json_tape const* json_tape)
+{
+  return json_tape->_internal.count;
+}
+
+/**
+ * @brief Gets the token at \p index within an #az_json_tape.
+ *
+ * @param[in] json_tape A pointer to an #az_json_tape instance.
+ * @param[in] index The index of the token, from 0 to the number of tokens minus 1.
+ *
+ * @return The #az_json_token, as an #az_json_reader would have returned it, that can be used with
+ * the `az_json_token_get_*` functions.
+ */
+AZ_NODISCARD az_json_token az_json_tape_get_token(az_json_tape const* json_tape, int32_t index);
+
+/**
+ * @brief Returns the index of the token that follows the value starting at \p index, skipping over
+ * any nested JSON elements.
+ *
+ * @param[in] json_tape A pointer to an #az_json_tape instance.
+ * @param[in] index The index of a token, from 0 to the number of tokens minus 1.
+ *
+ * @return The index of the token following the matching end of an object or array, the token
+ * following the value of a property name, or `index + 1` for other tokens. It is the number of
+ * tokens when the value is the last one of the JSON text.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_json_tape_skip(az_json_tape const* json_tape, int32_t index)
+{
+  return json_tape->_internal.entries[index]._internal.next;
+}
+
+/**
+ * @brief Looks for a property of the JSON object starting at \p object_index within an
+ * #az_json_tape.
+ *
+ * @param[in] json_tape A pointer to an #az_json_tape instance.
+ * @param[in] object_index The index of an #AZ_JSON_TOKEN_BEGIN_OBJECT token.
+ * @param[in] name The property name to look for, compared with the unescaped property names.
+ *
+ * @return The index of the value of the first property named \p name, or -1 if the object has no
+ * such property.
+ *
+ * @remarks Only the property names of the object itself are compared, the nested JSON elements are
+ * skipped over.
+ */
+AZ_NODISCARD int32_t
+az_json_tape_find_property(az_json_tape const* json_tape, int32_t object_index, az_span name);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_JSON_H
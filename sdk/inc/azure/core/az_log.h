@@ -23,6 +23,7 @@
 #include <azure/core/az_result.h>
 #include <azure/core/az_span.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <azure/core/_az_cfg_prefix.h>
@@ -88,6 +89,8 @@ typedef bool (*az_log_classification_filter_fn)(az_log_classification classifica
  * `NULL`, no function will be invoked.
  *
  * @remarks By default, this is `NULL`, which means, no function is invoked.
+ * @remarks This function is thread-safe: a thread logging at the same time sees either the previous
+ * callback or this one.
  */
 #ifndef AZ_NO_LOGGING
 void az_log_set_message_callback(az_log_message_fn log_message_callback);
@@ -110,6 +113,10 @@ AZ_INLINE void az_log_set_message_callback(az_log_message_fn log_message_callbac
  * @remarks By default, this is `NULL`, in which case no function is invoked to check whether a
  * classification should be logged or not. The SDK assumes true, passing messages with any log
  * classification to the #az_log_message_fn provided to #az_log_set_message_callback().
+ * @remarks The answers of the filter for the SDK's own classifications are cached when this
+ * function or #az_log_set_message_callback() is called, so the filter must always give the same
+ * answer for a classification. To change what is logged, set the filter again. The filter is still
+ * invoked on every check of the other classifications.
  */
 #ifndef AZ_NO_LOGGING
 void az_log_set_classification_filter_callback(
@@ -122,6 +129,207 @@ AZ_INLINE void az_log_set_classification_filter_callback(
 }
 #endif // AZ_NO_LOGGING
 
+/**
+ * @brief A bounded queue of log messages, which lets the SDK hand log messages over to a thread of
+ * the application instead of calling the #az_log_message_fn on the thread that logs them.
+ *
+ * @details Once set with #az_log_set_queue(), logging a message only copies it into the next free
+ * record of the queue, without taking any lock, so a slow #az_log_message_fn no longer slows down
+ * the threads sending requests. A thread of the application calls #az_log_queue_drain() to pass
+ * the queued messages to the #az_log_message_fn. Messages logged while the queue is full are
+ * dropped, and counted.
+ *
+ * @remarks Any number of threads can log into the queue, but only one thread at a time may drain
+ * it. The queue is only lock-free when built with GCC or clang, otherwise it must only be used
+ * from a single thread.
+ */
+typedef struct
+{
+  struct
+  {
+    uint8_t* records;
+    int32_t record_size;
+    int32_t max_message_size;
+    uint32_t mask;
+    uint32_t enqueue_position;
+    uint32_t dequeue_position;
+    uint32_t dropped;
+  } _internal;
+} az_log_queue;
+
+#ifndef AZ_NO_LOGGING
+/**
+ * @brief Initializes an #az_log_queue, whose records are carved from \p buffer.
+ *
+ * @param[out] out_queue The #az_log_queue to initialize.
+ * @param[in] buffer The buffer holding the records. It must outlive the queue. The queue holds the
+ * largest power of two number of records that fit in it.
+ * @param[in] max_message_size The size of the messages each record can hold. Longer messages are
+ * truncated. Use #AZ_LOG_MESSAGE_BUFFER_SIZE to never truncate the messages of the SDK.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p buffer can't hold two records.
+ */
+AZ_NODISCARD az_result
+az_log_queue_init(az_log_queue* out_queue, az_span buffer, int32_t max_message_size);
+
+/**
+ * @brief Makes the SDK log messages into \p queue, rather than pass them to the
+ * #az_log_message_fn right away.
+ *
+ * @param[in] queue __[nullable]__ The #az_log_queue to log into. If `NULL`, messages are passed to
+ * the #az_log_message_fn as they are logged, which is the default.
+ *
+ * @remarks The #az_log_classification_filter_fn is still called as messages are logged, and a
+ * message is only queued when an #az_log_message_fn is set.
+ */
+void az_log_set_queue(az_log_queue* queue);
+
+/**
+ * @brief Passes the messages of \p ref_queue to the #az_log_message_fn, oldest first.
+ *
+ * @param[in,out] ref_queue The #az_log_queue to drain.
+ * @param[in] max_messages The maximum number of messages to pass, or -1 for all of them.
+ *
+ * @return The number of messages taken from the queue.
+ */
+int32_t az_log_queue_drain(az_log_queue* ref_queue, int32_t max_messages);
+
+/**
+ * @brief Gets the number of messages dropped because \p queue was full.
+ *
+ * @param[in] queue The #az_log_queue.
+ *
+ * @return The number of messages dropped since \p queue was initialized.
+ */
+AZ_NODISCARD uint32_t az_log_queue_get_dropped(az_log_queue const* queue);
+#else
+AZ_NODISCARD AZ_INLINE az_result
+az_log_queue_init(az_log_queue* out_queue, az_span buffer, int32_t max_message_size)
+{
+  (void)buffer;
+  (void)max_message_size;
+  *out_queue = (az_log_queue){ 0 };
+  return AZ_OK;
+}
+
+AZ_INLINE void az_log_set_queue(az_log_queue* queue) { (void)queue; }
+
+AZ_INLINE int32_t az_log_queue_drain(az_log_queue* ref_queue, int32_t max_messages)
+{
+  (void)ref_queue;
+  (void)max_messages;
+  return 0;
+}
+
+AZ_NODISCARD AZ_INLINE uint32_t az_log_queue_get_dropped(az_log_queue const* queue)
+{
+  (void)queue;
+  return 0;
+}
+#endif // AZ_NO_LOGGING
+
+/**
+ * @brief Samples and rate limits the log messages of one #az_log_classification, so that a
+ * classification logged on every message under load doesn't swamp the sink.
+ *
+ * @details Of the messages of its classification which the #az_log_classification_filter_fn
+ * allows, a sampler keeps one in every `sample_rate`, and then no more than `max_per_second` of
+ * those, after a burst of `max_burst`. The other messages are neither formatted nor passed to the
+ * #az_log_message_fn, and are counted. This is decided with atomic counters, without calling back
+ * into the application.
+ *
+ * @remarks Samplers are only lock-free when built with GCC or clang, otherwise they must only be
+ * used from a single thread. Rate limiting reads #az_platform_clock_msec(), and is skipped if the
+ * platform provides no clock.
+ */
+typedef struct
+{
+  struct
+  {
+    az_log_classification classification;
+    uint32_t sample_rate;
+    uint32_t max_per_second;
+    uint32_t max_burst_ticks;
+    uint32_t count;
+    uint32_t theoretical_arrival_ticks;
+    uint32_t suppressed;
+  } _internal;
+} az_log_sampler;
+
+#ifndef AZ_NO_LOGGING
+/**
+ * @brief Initializes an #az_log_sampler.
+ *
+ * @param[out] out_sampler The #az_log_sampler to initialize.
+ * @param[in] classification The #az_log_classification whose messages are sampled.
+ * @param[in] sample_rate Keep one message in every \p sample_rate, starting with the first one.
+ * Must be between 1 and 1000000, 1 keeps every message.
+ * @param[in] max_per_second The maximum number of messages kept per second, or 0 for no limit.
+ * Must be between 0 and 1000000.
+ * @param[in] max_burst The number of messages which can be kept in a row, above
+ * \p max_per_second. Must be between 1 and 1000000.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ */
+AZ_NODISCARD az_result az_log_sampler_init(
+    az_log_sampler* out_sampler,
+    az_log_classification classification,
+    int32_t sample_rate,
+    int32_t max_per_second,
+    int32_t max_burst);
+
+/**
+ * @brief Sets the samplers applied to the log messages.
+ *
+ * @param[in] samplers __[nullable]__ An array of #az_log_sampler, one per classification at most.
+ * It must outlive its use by the SDK. If `NULL`, messages are not sampled, which is the default.
+ * @param[in] samplers_count The number of elements in \p samplers.
+ *
+ * @remarks This must not be called while other threads are logging, or from several threads at
+ * the same time.
+ */
+void az_log_set_samplers(az_log_sampler* samplers, int32_t samplers_count);
+
+/**
+ * @brief Gets the number of messages a sampler didn't keep.
+ *
+ * @param[in] sampler The #az_log_sampler.
+ *
+ * @return The number of messages suppressed since \p sampler was initialized.
+ */
+AZ_NODISCARD uint32_t az_log_sampler_get_suppressed(az_log_sampler const* sampler);
+#else
+AZ_NODISCARD AZ_INLINE az_result az_log_sampler_init(
+    az_log_sampler* out_sampler,
+    az_log_classification classification,
+    int32_t sample_rate,
+    int32_t max_per_second,
+    int32_t max_burst)
+{
+  (void)classification;
+  (void)sample_rate;
+  (void)max_per_second;
+  (void)max_burst;
+  *out_sampler = (az_log_sampler){ 0 };
+  return AZ_OK;
+}
+
+AZ_INLINE void az_log_set_samplers(az_log_sampler* samplers, int32_t samplers_count)
+{
+  (void)samplers;
+  (void)samplers_count;
+}
+
+AZ_NODISCARD AZ_INLINE uint32_t az_log_sampler_get_suppressed(az_log_sampler const* sampler)
+{
+  (void)sampler;
+  return 0;
+}
+#endif // AZ_NO_LOGGING
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_LOG_H
@@ -0,0 +1,261 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief This header defines the types and functions your application uses to write MessagePack
+ * (https://github.com/msgpack/msgpack/blob/master/spec.md) data, following the same data model
+ * and call sequence as #az_json_writer.
+ *
+ * @note You MUST NOT use any symbols (macros, functions, structures, enums, etc.)
+ * prefixed with an underscore ('_') directly in your application code. These symbols
+ * are part of Azure SDK's internal implementation; we do not document these symbols
+ * and they are subject to change in future versions of the SDK which would break your code.
+ */
+
+#ifndef _az_MSGPACK_H
+#define _az_MSGPACK_H
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/**
+ * @brief The maximum depth of nested maps and arrays the #az_msgpack_writer can write.
+ */
+#define _az_MSGPACK_WRITER_MAX_NESTING_DEPTH 16
+
+/**
+ * @brief Provides forward-only, non-cached writing of MessagePack data into the provided buffer.
+ *
+ * @remarks Each function mirrors the #az_json_writer function of the same name, and the writer
+ * validates the sequence of calls the same way, so that the same serialization code can produce
+ * either format: JSON objects are written as MessagePack maps with string keys, and JSON arrays as
+ * MessagePack arrays. Numbers and strings take their most compact encoding.
+ *
+ * @remarks The number of entries of a map or an array is only known once it ends, so its header is
+ * written then, and the data written since its start may be moved back by up to 4 bytes.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span destination_buffer;
+    int32_t bytes_written;
+    az_json_token_kind token_kind; // needed for validation, potentially #if/def with preconditions.
+    _az_json_bit_stack bit_stack; // needed for validation, potentially #if/def with preconditions.
+    // The offset of the header of each open map or array, and the number of entries written so far.
+    int32_t container_offsets[_az_MSGPACK_WRITER_MAX_NESTING_DEPTH];
+    uint32_t container_counts[_az_MSGPACK_WRITER_MAX_NESTING_DEPTH];
+  } _internal;
+} az_msgpack_writer;
+
+/**
+ * @brief Initializes an #az_msgpack_writer which writes MessagePack data into a buffer.
+ *
+ * @param[out] out_msgpack_writer A pointer to an #az_msgpack_writer instance to initialize.
+ * @param destination_buffer An #az_span over the byte buffer where the MessagePack data is to be
+ * written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK #az_msgpack_writer is initialized successfully.
+ * @retval other Initialization failed.
+ */
+AZ_NODISCARD az_result
+az_msgpack_writer_init(az_msgpack_writer* out_msgpack_writer, az_span destination_buffer);
+
+/**
+ * @brief Returns the #az_span containing the MessagePack data written to the underlying buffer so
+ * far.
+ *
+ * @param[in] msgpack_writer A pointer to an #az_msgpack_writer instance wrapping the destination
+ * buffer.
+ *
+ * @note Do NOT modify or override the contents of the returned #az_span unless you are no longer
+ * writing MessagePack data into it.
+ *
+ * @return An #az_span containing the MessagePack data built so far.
+ *
+ * @remarks The data is only valid MessagePack once every map and array has ended.
+ */
+AZ_NODISCARD AZ_INLINE az_span
+az_msgpack_writer_get_bytes_used_in_destination(az_msgpack_writer const* msgpack_writer)
+{
+  return az_span_slice(
+      msgpack_writer->_internal.destination_buffer, 0, msgpack_writer->_internal.bytes_written);
+}
+
+/**
+ * @brief Appends the UTF-8 text value as a MessagePack string into the buffer.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the string value to.
+ * @param[in] value The UTF-8 encoded value to be written. It is copied as is.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The string value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_msgpack_writer_append_string(az_msgpack_writer* ref_msgpack_writer, az_span value);
+
+/**
+ * @brief Appends the UTF-8 property name as the key of the next entry of the current map.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the property name to.
+ * @param[in] name The UTF-8 encoded property name to be written. It is copied as is.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The property name was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_msgpack_writer_append_property_name(az_msgpack_writer* ref_msgpack_writer, az_span name);
+
+/**
+ * @brief Appends a boolean value into the buffer.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the value to.
+ * @param[in] value The value to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_msgpack_writer_append_bool(az_msgpack_writer* ref_msgpack_writer, bool value);
+
+/**
+ * @brief Appends an `int32_t` number value into the buffer.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the value to.
+ * @param[in] value The value to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_msgpack_writer_append_int32(az_msgpack_writer* ref_msgpack_writer, int32_t value);
+
+/**
+ * @brief Appends an `int64_t` number value into the buffer.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the value to.
+ * @param[in] value The value to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_msgpack_writer_append_int64(az_msgpack_writer* ref_msgpack_writer, int64_t value);
+
+/**
+ * @brief Appends a `uint64_t` number value into the buffer.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the value to.
+ * @param[in] value The value to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result
+az_msgpack_writer_append_uint64(az_msgpack_writer* ref_msgpack_writer, uint64_t value);
+
+/**
+ * @brief Appends a `double` number value into the buffer.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the value to.
+ * @param[in] value The value to be written.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remarks The value is written as a 32-bit float when that doesn't lose any precision, which takes
+ * 5 bytes instead of 9. Unlike JSON, NaN and infinities can be written.
+ */
+AZ_NODISCARD az_result
+az_msgpack_writer_append_double(az_msgpack_writer* ref_msgpack_writer, double value);
+
+/**
+ * @brief Appends the nil value into the buffer.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the value to.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result az_msgpack_writer_append_null(az_msgpack_writer* ref_msgpack_writer);
+
+/**
+ * @brief Appends the beginning of a map into the buffer.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the start of the map to.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Map start was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small to reserve the 5 bytes of the map
+ * header.
+ * @retval #AZ_ERROR_JSON_NESTING_OVERFLOW The depth of the data exceeds the maximum allowed depth
+ * of 16.
+ */
+AZ_NODISCARD az_result az_msgpack_writer_append_begin_object(az_msgpack_writer* ref_msgpack_writer);
+
+/**
+ * @brief Appends the beginning of an array into the buffer.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the start of the array to.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Array start was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small to reserve the 5 bytes of the array
+ * header.
+ * @retval #AZ_ERROR_JSON_NESTING_OVERFLOW The depth of the data exceeds the maximum allowed depth
+ * of 16.
+ */
+AZ_NODISCARD az_result az_msgpack_writer_append_begin_array(az_msgpack_writer* ref_msgpack_writer);
+
+/**
+ * @brief Appends the end of the current map, completing its header.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the end of the map to.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Map end was appended successfully.
+ */
+AZ_NODISCARD az_result az_msgpack_writer_append_end_object(az_msgpack_writer* ref_msgpack_writer);
+
+/**
+ * @brief Appends the end of the current array, completing its header.
+ *
+ * @param[in,out] ref_msgpack_writer A pointer to an #az_msgpack_writer instance containing the
+ * buffer to append the end of the array to.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Array end was appended successfully.
+ */
+AZ_NODISCARD az_result az_msgpack_writer_append_end_array(az_msgpack_writer* ref_msgpack_writer);
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_MSGPACK_H
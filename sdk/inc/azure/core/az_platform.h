@@ -38,6 +38,24 @@
  */
 AZ_NODISCARD az_result az_platform_clock_msec(int64_t* out_clock_msec);
 
+/**
+ * @brief Gets the monotonic platform clock in microseconds.
+ *
+ * @remark The moment of time where clock starts is undefined, but the clock never goes backwards,
+ * even when the wall clock is adjusted, so the difference between two values is the time elapsed
+ * between the calls. The resolution depends on the platform, and may be coarser than a
+ * microsecond.
+ *
+ * @param[out] out_clock_usec Monotonic platform clock in microseconds.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The platform has no monotonic clock.
+ * @retval #AZ_ERROR_DEPENDENCY_NOT_PROVIDED No platform implementation was supplied to support this
+ * function.
+ */
+AZ_NODISCARD az_result az_platform_clock_usec(int64_t* out_clock_usec);
+
 /**
  * @brief Tells the platform to sleep for a given number of milliseconds.
  *
@@ -53,6 +71,201 @@ AZ_NODISCARD az_result az_platform_clock_msec(int64_t* out_clock_msec);
  */
 AZ_NODISCARD az_result az_platform_sleep_msec(int32_t milliseconds);
 
+/**
+ * @brief An event a thread waits for, with a timeout, until another thread sets it.
+ *
+ * @details Waiting for an event rather than sleeping lets a delay be cut short, such as by a
+ * cancellation or an incoming message.
+ */
+typedef struct
+{
+  struct
+  {
+    // The platform object of the event, if any: an event handle on Windows, or an event group on
+    // an RTOS.
+    void* handle;
+    bool is_set;
+  } _internal;
+} az_platform_event;
+
+/**
+ * @brief Initializes an #az_platform_event, which is not set.
+ *
+ * @param[out] out_event The #az_platform_event to initialize.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_OUT_OF_MEMORY The platform couldn't allocate the event.
+ * @retval #AZ_ERROR_DEPENDENCY_NOT_PROVIDED No platform implementation was supplied to support this
+ * function.
+ */
+AZ_NODISCARD az_result az_platform_event_init(az_platform_event* out_event);
+
+/**
+ * @brief Sets an #az_platform_event, waking up the thread waiting for it, if any.
+ *
+ * @param[in,out] ref_event The #az_platform_event to set.
+ *
+ * @remarks This function may be called from any thread. Setting an event which is already set
+ * has no effect.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_DEPENDENCY_NOT_PROVIDED No platform implementation was supplied to support this
+ * function.
+ */
+AZ_NODISCARD az_result az_platform_event_set(az_platform_event* ref_event);
+
+/**
+ * @brief Waits until an #az_platform_event is set, or the timeout elapses, and resets it.
+ *
+ * @param[in,out] ref_event The #az_platform_event to wait for.
+ * @param[in] timeout_msec The longest time to wait, in milliseconds.
+ * @param[out] out_is_set Receives `true` if the event was set, or `false` if the timeout elapsed.
+ *
+ * @remarks Only one thread may wait for an event at a time.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_DEPENDENCY_NOT_PROVIDED No platform implementation was supplied to support this
+ * function.
+ */
+AZ_NODISCARD az_result
+az_platform_event_wait(az_platform_event* ref_event, int32_t timeout_msec, bool* out_is_set);
+
+/**
+ * @brief Releases the platform resources of an #az_platform_event.
+ *
+ * @param[in,out] ref_event The #az_platform_event to release. No thread may be waiting for it.
+ */
+void az_platform_event_deinit(az_platform_event* ref_event);
+
+/**
+ * @brief A function run by an #az_platform_executor.
+ *
+ * @param[in] work_context The context given to az_platform_executor_submit().
+ */
+typedef void (*az_platform_work_fn)(void* work_context);
+
+/**
+ * @brief A work item queued by an #az_platform_executor.
+ */
+typedef struct
+{
+  struct
+  {
+    az_platform_work_fn work;
+    void* work_context;
+  } _internal;
+} az_platform_work_item;
+
+// Defining the typedef first is necessary here since a worker refers to its executor.
+typedef struct az_platform_executor az_platform_executor;
+
+/**
+ * @brief A worker thread of an #az_platform_executor, with its deque of work items.
+ */
+typedef struct
+{
+  struct
+  {
+    az_platform_executor* executor;
+    // The platform object of the thread.
+    void* thread;
+    // The deque of the worker, a ring buffer of work items. The worker takes the newest item, and
+    // the others steal the oldest.
+    az_platform_work_item* items;
+    int32_t capacity;
+    int32_t first;
+    int32_t count;
+    int32_t index;
+  } _internal;
+} az_platform_executor_worker;
+
+/**
+ * @brief A fixed pool of worker threads running work items, each taking its own work first and
+ * stealing from the others when it has none.
+ */
+struct az_platform_executor
+{
+  struct
+  {
+    az_platform_executor_worker* workers;
+    int32_t worker_count;
+    // The worker whose deque receives the next work item.
+    int32_t next_worker;
+    // The number of work items submitted and not yet done.
+    int32_t pending_count;
+    bool is_stopping;
+  } _internal;
+};
+
+/**
+ * @brief Initializes an #az_platform_executor, and starts its worker threads.
+ *
+ * @param[out] out_executor The #az_platform_executor to initialize.
+ * @param[in] workers The workers of the executor, one thread each. It must remain valid until
+ * az_platform_executor_deinit() returns.
+ * @param[in] worker_count The number of elements in \p workers.
+ * @param[in] work_items The storage of the queued work items, shared evenly by the workers. It must
+ * remain valid until az_platform_executor_deinit() returns.
+ * @param[in] work_item_count The number of elements in \p work_items, which must be at least
+ * \p worker_count.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_OUT_OF_MEMORY The platform couldn't start the worker threads.
+ *
+ * @remarks Without a platform implementation, the executor has no threads, and
+ * az_platform_executor_submit() runs the work on the calling thread.
+ */
+AZ_NODISCARD az_result az_platform_executor_init(
+    az_platform_executor* out_executor,
+    az_platform_executor_worker workers[],
+    int32_t worker_count,
+    az_platform_work_item work_items[],
+    int32_t work_item_count);
+
+/**
+ * @brief Queues a work item, to be run by one of the workers of an #az_platform_executor.
+ *
+ * @param[in,out] ref_executor The #az_platform_executor to use for this call.
+ * @param[in] work The function to run.
+ * @param[in] work_context __[nullable]__ The context passed to \p work.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The work item is queued.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The deques of all the workers are full. Wait for some work to
+ * be done, such as with az_platform_executor_wait(), and submit again.
+ *
+ * @remarks This function may be called from any thread, including from a work item.
+ */
+AZ_NODISCARD az_result az_platform_executor_submit(
+    az_platform_executor* ref_executor,
+    az_platform_work_fn work,
+    void* work_context);
+
+/**
+ * @brief Waits until all the work items submitted to an #az_platform_executor are done, running
+ * queued work items on the calling thread in the meantime.
+ *
+ * @param[in,out] ref_executor The #az_platform_executor to use for this call.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ *
+ * @remarks It must not be called from a work item.
+ */
+AZ_NODISCARD az_result az_platform_executor_wait(az_platform_executor* ref_executor);
+
+/**
+ * @brief Stops the worker threads of an #az_platform_executor, once they have run all the queued
+ * work items.
+ *
+ * @param[in,out] ref_executor The #az_platform_executor to stop.
+ */
+void az_platform_executor_deinit(az_platform_executor* ref_executor);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_PLATFORM_H
@@ -29,6 +29,7 @@ enum
   _az_FACILITY_IOT = 0x5,
   _az_FACILITY_IOT_MQTT = 0x6,
   _az_FACILITY_ULIB = 0x7,
+  _az_FACILITY_CORE_CBOR = 0x8,
 };
 
 enum
@@ -109,6 +110,19 @@ enum az_result_core
   /// No more JSON text left to process.
   AZ_ERROR_JSON_READER_DONE = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_JSON, 3),
 
+  /// The JSON text fed to an incremental #az_json_reader so far ends within the next token.
+  AZ_ERROR_JSON_READER_NEED_MORE_DATA = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_JSON, 4),
+
+  // === CBOR error codes ===
+  /// The kind of the token being read is not compatible with the expected type of the value.
+  AZ_ERROR_CBOR_INVALID_STATE = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_CBOR, 1),
+
+  /// The CBOR depth is too large.
+  AZ_ERROR_CBOR_NESTING_OVERFLOW = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_CBOR, 2),
+
+  /// No more CBOR data left to process.
+  AZ_ERROR_CBOR_READER_DONE = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_CBOR, 3),
+
   // === HTTP error codes ===
   /// The #az_http_response instance is in an invalid state.
   AZ_ERROR_HTTP_INVALID_STATE = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_HTTP, 1),
@@ -137,6 +151,12 @@ enum az_result_core
   // === HTTP Adapter error codes ===
   /// Generic error in the HTTP transport adapter implementation.
   AZ_ERROR_HTTP_ADAPTER = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_HTTP, 9),
+
+  /// A policy suspended an asynchronous HTTP pipeline operation, which has to be resumed later.
+  AZ_ERROR_HTTP_PIPELINE_SUSPENDED = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_HTTP, 10),
+
+  /// The request wasn't sent, as its host kept failing recently. See the circuit breaker policy.
+  AZ_ERROR_HTTP_CIRCUIT_OPEN = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_HTTP, 11),
 };
 
 /**
@@ -371,9 +371,13 @@ AZ_NODISCARD az_result az_span_atoi32(az_span source, int32_t* out_number);
  * @retval #AZ_OK Success.
  * @retval #AZ_ERROR_UNEXPECTED_CHAR A non-ASCII digit or an invalid character is found within the
  * span, or the resulting \p out_number wouldn't be a finite `double` number.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The SDK was built with `AZ_NO_DOUBLE`.
  *
  * @remark The #az_span being parsed must contain a number that is finite. Values such as `NaN`,
  * `INFINITY`, and those that would overflow a `double` to `+/-inf` are not allowed.
+ *
+ * @remark The result is correctly rounded (to nearest, ties to even), for any number of digits,
+ * and doesn't depend on the C library or the current locale.
  */
 AZ_NODISCARD az_result az_span_atod(az_span source, double* out_number);
 
@@ -462,7 +466,8 @@ AZ_NODISCARD az_result az_span_u64toa(az_span destination, uint64_t source, az_s
  * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p destination is not big enough to contain the copied
  * bytes.
  * @retval #AZ_ERROR_NOT_SUPPORTED The \p source is not a finite decimal number or contains an
- * integer component that is too large and would overflow beyond `2^53 - 1`.
+ * integer component that is too large and would overflow beyond `2^53 - 1`, or the SDK was built
+ * with `AZ_NO_DOUBLE`.
  *
  * @remark Only finite `double` values are supported. Values such as `NaN` and `INFINITY` are not
  * allowed.
@@ -476,6 +481,263 @@ AZ_NODISCARD az_result az_span_u64toa(az_span destination, uint64_t source, az_s
 AZ_NODISCARD az_result
 az_span_dtoa(az_span destination, double source, int32_t fractional_digits, az_span* out_span);
 
+/**
+ * @brief Converts a `double` into the shortest sequence of digit characters (base 10 decimal
+ * notation) that parses back to the exact same `double`, and copies them to the \p destination
+ * #az_span starting at its 0-th index.
+ *
+ * @param destination The #az_span where the bytes should be copied to.
+ * @param[in] source The `double` whose number is copied to the \p destination #az_span as ASCII
+ * digits and characters.
+ * @param[out] out_span A pointer to an #az_span that receives the remainder of the \p destination
+ * #az_span after the `double` has been copied.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p destination is not big enough to contain the copied
+ * bytes.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The \p source is not a finite decimal number, or the SDK was
+ * built with `AZ_NO_DOUBLE`.
+ *
+ * @remark Only finite `double` values are supported. Values such as `NaN` and `INFINITY` are not
+ * allowed.
+ *
+ * @remark Unlike #az_span_dtoa(), any finite `double` is supported, without losing precision. Like
+ * JavaScript's `Number.prototype.toString()`, numbers whose decimal exponent is between -6 (for
+ * example, `0.000001`) and 20 (for example, `100000000000000000000`) are written in decimal
+ * notation, and other numbers in scientific notation (for example, `1.5e-7` or `1e+21`). Negative
+ * zero is written as `-0`. At most 25 bytes are written.
+ */
+AZ_NODISCARD az_result az_span_dtoa_shortest(az_span destination, double source, az_span* out_span);
+
+/**
+ * @brief Formats a UTC time as an ISO 8601 timestamp with a millisecond precision, such as
+ * `2021-03-04T05:06:07.089Z`, and copies it to the \p destination #az_span starting at its 0-th
+ * index.
+ *
+ * @param destination The #az_span where the bytes should be copied to.
+ * @param[in] unix_time_msec The number of milliseconds since `1970-01-01T00:00:00.000Z`, negative
+ * before it, for a time within the years 0000 to 9999.
+ * @param[out] out_span A pointer to an #az_span that receives the remainder of the \p destination
+ * #az_span after the timestamp has been copied.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p destination is smaller than the 24 bytes of the
+ * timestamp.
+ * @retval #AZ_ERROR_ARG The \p unix_time_msec is out of the years 0000 to 9999.
+ *
+ * @remark Unlike `gmtime()` and `strftime()`, this is reentrant and doesn't depend on the locale.
+ */
+AZ_NODISCARD az_result
+az_span_format_iso8601(az_span destination, int64_t unix_time_msec, az_span* out_span);
+
+/**
+ * @brief Parses an #az_span containing a UTC ISO 8601 timestamp, as written by
+ * az_span_format_iso8601(), into the number of milliseconds since `1970-01-01T00:00:00.000Z`.
+ *
+ * @param[in] source The #az_span containing the timestamp, in the `YYYY-MM-DDThh:mm:ssZ` format,
+ * with an optional fraction of a second before the `Z`, such as `.089`.
+ * @param[out] out_unix_time_msec The pointer to the variable that is to receive the time, negative
+ * before 1970.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR The \p source isn't in the format, or the date or the time of
+ * day doesn't exist.
+ *
+ * @remark The digits of the fraction of a second past the milliseconds are ignored.
+ */
+AZ_NODISCARD az_result az_span_parse_iso8601(az_span source, int64_t* out_unix_time_msec);
+
+/******************************  SPAN BUILDER  */
+
+/**
+ * @brief Appends bytes, numbers and URL-encoded text to an #az_span, checking only once, at the
+ * end, whether everything fit.
+ *
+ * @details Appending past the end of the destination doesn't fail: nothing more is written, but the
+ * length of everything appended keeps being counted, so that az_span_builder_get_length() gives the
+ * size the destination needs. az_span_builder_get_span() then returns #AZ_ERROR_NOT_ENOUGH_SPACE.
+ * A builder over #AZ_SPAN_EMPTY only measures.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span destination;
+    int32_t length;
+  } _internal;
+} az_span_builder;
+
+/**
+ * @brief Creates an #az_span_builder appending to \p destination, from its 0-th index.
+ *
+ * @param destination The #az_span to append to. Can be #AZ_SPAN_EMPTY, to only measure.
+ *
+ * @return The #az_span_builder.
+ */
+AZ_NODISCARD AZ_INLINE az_span_builder az_span_builder_create(az_span destination)
+{
+  return (az_span_builder){ ._internal = { .destination = destination, .length = 0 } };
+}
+
+/**
+ * @brief Appends the bytes of \p source.
+ *
+ * @param[in,out] ref_builder The #az_span_builder to append to.
+ * @param[in] source The #az_span whose bytes are appended.
+ */
+void az_span_builder_append(az_span_builder* ref_builder, az_span source);
+
+/**
+ * @brief Appends one byte.
+ *
+ * @param[in,out] ref_builder The #az_span_builder to append to.
+ * @param[in] byte The `uint8_t` to append.
+ */
+void az_span_builder_append_u8(az_span_builder* ref_builder, uint8_t byte);
+
+/**
+ * @brief Appends the ASCII digits of a `uint32_t`, as az_span_u32toa() writes them.
+ *
+ * @param[in,out] ref_builder The #az_span_builder to append to.
+ * @param[in] source The number to append.
+ */
+void az_span_builder_append_u32(az_span_builder* ref_builder, uint32_t source);
+
+/**
+ * @brief Appends the ASCII digits of an `int32_t`, as az_span_i32toa() writes them.
+ *
+ * @param[in,out] ref_builder The #az_span_builder to append to.
+ * @param[in] source The number to append.
+ */
+void az_span_builder_append_i32(az_span_builder* ref_builder, int32_t source);
+
+/**
+ * @brief Appends the ASCII digits of a `uint64_t`, as az_span_u64toa() writes them.
+ *
+ * @param[in,out] ref_builder The #az_span_builder to append to.
+ * @param[in] source The number to append.
+ */
+void az_span_builder_append_u64(az_span_builder* ref_builder, uint64_t source);
+
+/**
+ * @brief Appends the ASCII digits of an `int64_t`, as az_span_i64toa() writes them.
+ *
+ * @param[in,out] ref_builder The #az_span_builder to append to.
+ * @param[in] source The number to append.
+ */
+void az_span_builder_append_i64(az_span_builder* ref_builder, int64_t source);
+
+/**
+ * @brief Appends the URL-encoded bytes of \p source: the bytes other than letters, digits, `-`,
+ * `.`, `_` and `~` are percent-encoded.
+ *
+ * @param[in,out] ref_builder The #az_span_builder to append to.
+ * @param[in] source The #az_span whose bytes are URL-encoded. It must not overlap the destination.
+ */
+void az_span_builder_append_url_encoded(az_span_builder* ref_builder, az_span source);
+
+/**
+ * @brief Gets the length of everything appended, which is the size the destination needs, even if
+ * it was too small.
+ *
+ * @param[in] builder The #az_span_builder.
+ *
+ * @return The length, in bytes.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_span_builder_get_length(az_span_builder const* builder)
+{
+  return builder->_internal.length;
+}
+
+/**
+ * @brief Gets the slice of the destination holding everything appended.
+ *
+ * @param[in] builder The #az_span_builder.
+ * @param[out] out_span A pointer to an #az_span that receives the slice of the destination.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The destination is smaller than az_span_builder_get_length().
+ */
+AZ_NODISCARD az_result az_span_builder_get_span(az_span_builder const* builder, az_span* out_span);
+
+/******************************  BASE64  */
+
+/**
+ * @brief Encodes bytes as base64 text (RFC 4648, section 4), padded with `=` to a multiple of 4
+ * characters.
+ *
+ * @param[out] destination The #az_span the text is written to. It needs 4 bytes for every 3 bytes
+ * of \p source, rounded up.
+ * @param[in] source The bytes to encode.
+ * @param[out] out_written A pointer to an `int32_t` that receives the number of bytes written to
+ * \p destination.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination is too small.
+ */
+AZ_NODISCARD az_result
+az_span_base64_encode(az_span destination, az_span source, int32_t* out_written);
+
+/**
+ * @brief Decodes padded base64 text (RFC 4648, section 4).
+ *
+ * @param[out] destination The #az_span the bytes are written to. It needs 3 bytes for every 4
+ * characters of \p source, minus the padding.
+ * @param[in] source The base64 text to decode.
+ * @param[out] out_written A pointer to an `int32_t` that receives the number of bytes written to
+ * \p destination.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination is too small.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR \p source contains a character which isn't part of the base64
+ * alphabet.
+ * @retval #AZ_ERROR_UNEXPECTED_END The size of \p source isn't a multiple of 4.
+ */
+AZ_NODISCARD az_result
+az_span_base64_decode(az_span destination, az_span source, int32_t* out_written);
+
+/**
+ * @brief Encodes bytes as base64url text (RFC 4648, section 5), which uses `-` and `_` rather
+ * than `+` and `/`, without padding.
+ *
+ * @param[out] destination The #az_span the text is written to. It needs 4 bytes for every 3 bytes
+ * of \p source, and 2 or 3 bytes for the 1 or 2 bytes left.
+ * @param[in] source The bytes to encode.
+ * @param[out] out_written A pointer to an `int32_t` that receives the number of bytes written to
+ * \p destination.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination is too small.
+ */
+AZ_NODISCARD az_result
+az_span_base64url_encode(az_span destination, az_span source, int32_t* out_written);
+
+/**
+ * @brief Decodes base64url text (RFC 4648, section 5), with or without padding.
+ *
+ * @param[out] destination The #az_span the bytes are written to. It needs 3 bytes for every 4
+ * characters of \p source, and 1 or 2 bytes for the 2 or 3 characters left.
+ * @param[in] source The base64url text to decode.
+ * @param[out] out_written A pointer to an `int32_t` that receives the number of bytes written to
+ * \p destination.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination is too small.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR \p source contains a character which isn't part of the
+ * base64url alphabet.
+ * @retval #AZ_ERROR_UNEXPECTED_END \p source ends with a single character of a group of 4.
+ */
+AZ_NODISCARD az_result
+az_span_base64url_decode(az_span destination, az_span source, int32_t* out_written);
+
 /******************************  NON-CONTIGUOUS SPAN  */
 
 /**
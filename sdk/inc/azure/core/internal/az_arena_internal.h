@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#ifndef _az_ARENA_INTERNAL_H
+#define _az_ARENA_INTERNAL_H
+
+#include <azure/core/az_arena.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/*
+ * Code borrowing an arena for temporary buffers (like a transport sending a request) frees them by
+ * rewinding the arena to where it was, leaving what was allocated before in place.
+ */
+
+AZ_NODISCARD AZ_INLINE int32_t _az_arena_get_mark(az_arena const* arena)
+{
+  return arena->_internal.used;
+}
+
+AZ_INLINE void _az_arena_rewind(az_arena* ref_arena, int32_t mark)
+{
+  if (mark < ref_arena->_internal.used)
+  {
+    ref_arena->_internal.used = mark;
+  }
+}
+
+// Whether ptr was allocated from the arena, or comes from somewhere else.
+AZ_NODISCARD AZ_INLINE bool _az_arena_contains(az_arena const* arena, void const* ptr)
+{
+  uintptr_t const start = (uintptr_t)az_span_ptr(arena->_internal.buffer);
+  uintptr_t const address = (uintptr_t)ptr;
+  return address >= start && address < start + (uintptr_t)arena->_internal.used;
+}
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_ARENA_INTERNAL_H
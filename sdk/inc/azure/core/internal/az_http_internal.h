@@ -6,6 +6,7 @@
 
 #include <azure/core/az_context.h>
 #include <azure/core/az_http.h>
+#include <azure/core/az_http_instrumentation.h>
 #include <azure/core/az_http_transport.h>
 #include <azure/core/az_result.h>
 
@@ -26,6 +27,7 @@ typedef struct
   struct
   {
     _az_http_policy policies[_az_MAXIMUM_NUMBER_OF_POLICIES];
+    bool is_shared; // Set by _az_http_pipeline_share(), the policies no longer change.
   } _internal;
 } _az_http_pipeline;
 
@@ -89,6 +91,484 @@ _az_http_policy_apiversion_options_default()
  */
 AZ_NODISCARD az_http_policy_retry_options _az_http_policy_retry_options_default();
 
+enum
+{
+  /// The number of recent latencies the hedging policy keeps to pick its hedging delay from.
+  _az_HTTP_POLICY_HEDGING_LATENCY_SAMPLES = 32,
+};
+
+/**
+ * @brief Options for the hedging policy, which also keep the latencies it observed.
+ *
+ * @remarks As the latencies are updated by every request, and the response to a hedged request is
+ * received into hedge_response_buffer, a pipeline with a hedging policy must not process several
+ * requests at once.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span hedge_response_buffer;
+    int32_t percentile;
+    int32_t initial_delay_msec;
+    int32_t latencies_msec[_az_HTTP_POLICY_HEDGING_LATENCY_SAMPLES];
+    int32_t latency_count;
+  } _internal;
+} _az_http_policy_hedging_options;
+
+/**
+ * @brief Initialize _az_http_policy_hedging_options with default values.
+ *
+ * @details A request is sent again once it takes longer than the 95th percentile of the latencies
+ * of the recent requests, or 1 second until enough requests were made.
+ *
+ * @param[in] hedge_response_buffer The buffer to receive the response to the second request into.
+ * It must be as large as the response buffer of the requests sent through the policy.
+ */
+AZ_NODISCARD _az_http_policy_hedging_options
+_az_http_policy_hedging_options_default(az_span hedge_response_buffer);
+
+/**
+ * @brief Gets how long the hedging policy waits for a response before sending the request again.
+ */
+AZ_NODISCARD int32_t
+_az_http_policy_hedging_get_delay_msec(_az_http_policy_hedging_options const* options);
+
+enum
+{
+  /// The maximum number of headers a static headers policy can add to each request.
+  _az_HTTP_POLICY_STATIC_HEADERS_MAX = 4,
+};
+
+/**
+ * @brief Options for the static headers policy: headers and query parameters that are the same for
+ * every request, validated and encoded once.
+ *
+ * @details The query parameters are kept serialized as `name=value&name=value`, so that they are
+ * appended to the URL of each request with a single copy. The headers are appended the same way.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_http_request_header headers[_az_HTTP_POLICY_STATIC_HEADERS_MAX];
+    int32_t headers_length;
+    az_span query_buffer;
+    int32_t query_length;
+  } _internal;
+} _az_http_policy_static_headers_options;
+
+/**
+ * @brief Initialize _az_http_policy_static_headers_options with no headers and no query
+ * parameters.
+ *
+ * @param[in] query_buffer The buffer to keep the serialized query parameters into. It must outlive
+ * the options. Can be #AZ_SPAN_EMPTY when no query parameter is added.
+ */
+AZ_NODISCARD AZ_INLINE _az_http_policy_static_headers_options
+_az_http_policy_static_headers_options_default(az_span query_buffer)
+{
+  return (_az_http_policy_static_headers_options){
+    ._internal = {
+      .headers = { { 0 } },
+      .headers_length = 0,
+      .query_buffer = query_buffer,
+      .query_length = 0,
+    },
+  };
+}
+
+/**
+ * @brief Adds a header to the headers added to every request.
+ *
+ * @details The name and the value are trimmed, and the name is validated, here, once, instead of
+ * for every request. Both spans must outlive the options.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful
+ *         - #AZ_ERROR_ARG if the header name is empty or contains invalid characters
+ *         - #AZ_ERROR_NOT_ENOUGH_SPACE if #_az_HTTP_POLICY_STATIC_HEADERS_MAX headers were added
+ */
+AZ_NODISCARD az_result _az_http_policy_static_headers_options_add_header(
+    _az_http_policy_static_headers_options* ref_options,
+    az_span name,
+    az_span value);
+
+/**
+ * @brief Adds a query parameter to the query parameters added to every request.
+ *
+ * @param[in] is_value_url_encoded Whether \p value is URL-encoded already. If not, it is encoded
+ * here, once.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful
+ *         - #AZ_ERROR_NOT_ENOUGH_SPACE if the query buffer of the options is too small
+ */
+AZ_NODISCARD az_result _az_http_policy_static_headers_options_add_query_parameter(
+    _az_http_policy_static_headers_options* ref_options,
+    az_span name,
+    az_span value,
+    bool is_value_url_encoded);
+
+/**
+ * @brief Moves the headers and query parameters the API version and telemetry policies of a
+ * pipeline add to every request into \p ref_options, and replaces those policies by a single static
+ * headers policy.
+ *
+ * @details Call this once, when the client is initialized, before the pipeline processes any
+ * request. The pipeline keeps a pointer to \p ref_options, which must outlive it. The pipeline is
+ * left unchanged if it has neither policy, or if anything fails.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful
+ *         - Any error returned by _az_http_policy_static_headers_options_add_header() or
+ *           _az_http_policy_static_headers_options_add_query_parameter()
+ */
+AZ_NODISCARD az_result _az_http_pipeline_freeze(
+    _az_http_pipeline* ref_pipeline,
+    _az_http_policy_static_headers_options* ref_options);
+
+/**
+ * @brief Makes a pipeline shared, so that it can process requests from several threads at once.
+ *
+ * @details A pipeline can be shared when each of its policies only reads its options, keeping the
+ * state of a request in the request and its context: the API version, telemetry, static headers,
+ * credential, retry, logging and transport policies. The single flight and circuit breaker policies
+ * guard what they update with a lock, and can be shared too, except for the circuit breaker when
+ * the compiler has no atomic operations. The hedging, compression, rate limit and cache policies
+ * update their options with every request, so a pipeline with any of them can't be shared.
+ *
+ * Call this once the pipeline is built, and after _az_http_pipeline_freeze(), if it is used. From
+ * then on, the policies and their options must not change, and one pipeline serves every thread of
+ * a client instead of each thread building its own.
+ *
+ * @remarks The credential of a credential policy must itself be safe to use from several threads.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if the pipeline is shared
+ *         - #AZ_ERROR_NOT_SUPPORTED if one of its policies keeps state in its options, in which
+ *           case the pipeline is left unchanged
+ */
+AZ_NODISCARD az_result _az_http_pipeline_share(_az_http_pipeline* ref_pipeline);
+
+/**
+ * @brief Gets whether a pipeline was made shared by _az_http_pipeline_share().
+ */
+AZ_NODISCARD AZ_INLINE bool _az_http_pipeline_is_shared(_az_http_pipeline const* pipeline)
+{
+  return pipeline->_internal.is_shared;
+}
+
+enum
+{
+  /// The number of slots of the hash table the compression policy finds repeated bytes with.
+  _az_HTTP_POLICY_COMPRESSION_HASH_SIZE = 512,
+
+  /// The smallest work buffer the compression policy can use.
+  _az_HTTP_POLICY_COMPRESSION_MIN_WORK_BUFFER_SIZE = 256,
+};
+
+/**
+ * @brief Options for the compression policy, which gzip-compresses request bodies, along with the
+ * state of the body being compressed.
+ *
+ * @remarks As the state of the body being compressed is kept here, a pipeline with a compression
+ * policy must not process several requests at once.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span work_buffer;
+    int32_t min_body_size;
+    int32_t hash_heads[_az_HTTP_POLICY_COMPRESSION_HASH_SIZE];
+
+    // The body reader of the request being sent, which the body to compress is read from.
+    az_http_request_body_read_fn source_read_callback;
+    void* source_user_context;
+    int64_t source_offset;
+
+    // How much of the compressed body was read by the transport, and the compressed bytes that
+    // are ready to be read, within the output part of work_buffer.
+    int64_t compressed_offset;
+    int32_t pending_start;
+    int32_t pending_end;
+
+    uint32_t crc;
+    uint32_t bit_buffer;
+    int32_t bit_count;
+    bool started;
+    bool finished;
+  } _internal;
+} _az_http_policy_compression_options;
+
+/**
+ * @brief Initialize _az_http_policy_compression_options with default values.
+ *
+ * @details Bodies of at least 1 KB, and bodies read with a body reader whose length isn't known,
+ * are compressed.
+ *
+ * @param[in] work_buffer The buffer to compress into. A body in memory is only compressed if its
+ * compressed form fits. A body read with a body reader is compressed chunk by chunk, where a chunk
+ * is a little less than half of the buffer. It needs to be at least
+ * #_az_HTTP_POLICY_COMPRESSION_MIN_WORK_BUFFER_SIZE bytes.
+ */
+AZ_NODISCARD _az_http_policy_compression_options
+_az_http_policy_compression_options_default(az_span work_buffer);
+
+/**
+ * @brief Options for the rate limit policy, along with the state of its token bucket.
+ *
+ * @details The rate is adjusted to what the service accepts: it goes up by about one request per
+ * second every second while requests succeed, and halves whenever a request is throttled (HTTP
+ * 429 or 503), down to a tenth of a request per second. A `Retry-After` header on a throttled
+ * response also holds back every request until it is over.
+ *
+ * @remarks The rates are in thousandths of a request per second, so that a rate times a number of
+ * milliseconds is a number of tokens, in millionths of a request. As the bucket is updated by every
+ * request, a pipeline with a rate limit policy must
+ * not process several requests at once. Point the policies of several pipelines to the same
+ * options to pace them against a single quota, as long as they run on the same thread.
+ */
+typedef struct
+{
+  struct
+  {
+    int64_t tokens;
+    int64_t refilled_at_msec;
+    int64_t held_until_msec;
+    int32_t rate;
+    int32_t min_rate;
+    int32_t max_rate;
+  } _internal;
+} _az_http_policy_rate_limit_options;
+
+/**
+ * @brief Initialize _az_http_policy_rate_limit_options with default values.
+ *
+ * @details The rate starts at its maximum. The bucket holds one second worth of requests at the
+ * current rate, and at least one request, and starts full.
+ *
+ * @param[in] max_requests_per_second The quota of the service, which the rate never goes above.
+ * Must be between 1 and 1000000.
+ */
+AZ_NODISCARD _az_http_policy_rate_limit_options
+_az_http_policy_rate_limit_options_default(int32_t max_requests_per_second);
+
+/**
+ * @brief Takes a request worth of tokens from the bucket of the rate limit policy.
+ *
+ * @param[in] now_msec The time, as returned by az_platform_clock_msec().
+ *
+ * @return 0 if a request can be sent now, in which case its tokens were taken. Otherwise, how long
+ * to wait, in milliseconds, before trying again.
+ */
+AZ_NODISCARD int32_t _az_http_policy_rate_limit_acquire(
+    _az_http_policy_rate_limit_options* ref_options,
+    int64_t now_msec);
+
+/**
+ * @brief Adjusts the rate of the rate limit policy to the response to a request.
+ *
+ * @param[in] retry_after_msec The delay the service asked for, or -1 if it didn't.
+ * @param[in] now_msec The time, as returned by az_platform_clock_msec().
+ */
+void _az_http_policy_rate_limit_update(
+    _az_http_policy_rate_limit_options* ref_options,
+    az_http_status_code status_code,
+    int32_t retry_after_msec,
+    int64_t now_msec);
+
+enum
+{
+  /// The number of hosts the circuit breaker policy keeps track of.
+  _az_HTTP_POLICY_CIRCUIT_BREAKER_HOSTS = 8,
+};
+
+/**
+ * @brief The health of a host, as tracked by the circuit breaker policy.
+ */
+typedef struct
+{
+  struct
+  {
+    uint32_t host_hash;
+    int32_t requests;
+    int32_t failures;
+    int64_t window_start_msec;
+    int64_t opened_at_msec; // -1 while the circuit is closed.
+    int64_t used_at_msec;
+    bool is_used;
+  } _internal;
+} _az_http_policy_circuit_breaker_host;
+
+/**
+ * @brief Options for the circuit breaker policy, along with the health of the hosts it sent
+ * requests to.
+ *
+ * @details Once enough of the requests to a host fail within a window of time, the circuit of the
+ * host opens: its requests fail at once with #AZ_ERROR_HTTP_CIRCUIT_OPEN. After a while, a single
+ * request is let through as a probe. The circuit closes if it succeeds, and stays open for another
+ * while otherwise. A request fails if it can't be sent, or if the response is a 500, 502, 503 or
+ * 504. Throttling (HTTP 429) is not a failure, the host is healthy.
+ *
+ * @remarks The options can be shared by the pipelines of several threads, or by a pipeline shared
+ * with _az_http_pipeline_share(), so that they stop sending requests to an unhealthy host
+ * together. The hosts are guarded by a spin lock, only held while a host is looked up or updated,
+ * not while the request is sent. Without atomic operations (compilers other than GCC and Clang),
+ * the options must only be used from a single thread. When more hosts are used than the options
+ * keep track of, the least recently used one is forgotten.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_http_policy_circuit_breaker_host hosts[_az_HTTP_POLICY_CIRCUIT_BREAKER_HOSTS];
+    int32_t min_requests;
+    int32_t failure_percent;
+    int32_t window_msec;
+    int32_t open_msec;
+    int32_t lock;
+  } _internal;
+} _az_http_policy_circuit_breaker_options;
+
+/**
+ * @brief Initialize _az_http_policy_circuit_breaker_options with default values.
+ *
+ * @details The circuit of a host opens when at least half of at least 5 requests failed within 10
+ * seconds, and a probe is sent after 5 seconds.
+ */
+AZ_NODISCARD _az_http_policy_circuit_breaker_options
+_az_http_policy_circuit_breaker_options_default(void);
+
+/**
+ * @brief Checks whether a request can be sent to \p host, and if it is the probe of an open
+ * circuit, holds back the other requests for another while.
+ *
+ * @param[in] now_msec The time, as returned by az_platform_clock_msec().
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if the request can be sent
+ *         - #AZ_ERROR_HTTP_CIRCUIT_OPEN if the circuit of \p host is open
+ */
+AZ_NODISCARD az_result _az_http_policy_circuit_breaker_acquire(
+    _az_http_policy_circuit_breaker_options* ref_options,
+    az_span host,
+    int64_t now_msec);
+
+/**
+ * @brief Records whether a request to \p host failed, opening or closing its circuit.
+ *
+ * @param[in] now_msec The time, as returned by az_platform_clock_msec().
+ */
+void _az_http_policy_circuit_breaker_record(
+    _az_http_policy_circuit_breaker_options* ref_options,
+    az_span host,
+    bool failed,
+    int64_t now_msec);
+
+enum
+{
+  /// The number of responses the cache policy keeps.
+  _az_HTTP_POLICY_CACHE_ENTRIES = 8,
+};
+
+/**
+ * @brief A response kept by the cache policy, within a slot of its buffer, as the key of the
+ * request (its method, a space and its URL), the `ETag` and `Last-Modified` of the response, and
+ * the response itself, one after the other.
+ */
+typedef struct
+{
+  struct
+  {
+    uint32_t key_hash;
+    int32_t key_size;
+    int32_t etag_size;
+    int32_t last_modified_size;
+    int32_t response_size;
+    uint32_t used_at; // The use count of the options when the entry was last used.
+    bool is_used;
+  } _internal;
+} _az_http_policy_cache_entry;
+
+/**
+ * @brief Options for the cache policy, along with the responses it keeps.
+ *
+ * @details The buffer is split into #_az_HTTP_POLICY_CACHE_ENTRIES slots of the same size, each
+ * holding one response. Responses that don't fit in a slot aren't kept. When all slots are used,
+ * the least recently used response is replaced.
+ *
+ * @remarks As the responses are updated by every request, a pipeline with a cache policy must not
+ * process several requests at once. Point the policies of several pipelines to the same options to
+ * share the responses, as long as they run on the same thread.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span buffer;
+    _az_http_policy_cache_entry entries[_az_HTTP_POLICY_CACHE_ENTRIES];
+    uint32_t use_count;
+  } _internal;
+} _az_http_policy_cache_options;
+
+/**
+ * @brief Initialize _az_http_policy_cache_options with an empty cache.
+ *
+ * @param[in] buffer The buffer to keep the responses into. It must outlive the options. Each
+ * response, with its URL, must fit in an #_az_HTTP_POLICY_CACHE_ENTRIES th of it to be kept.
+ */
+AZ_NODISCARD _az_http_policy_cache_options _az_http_policy_cache_options_default(az_span buffer);
+
+enum
+{
+  /// The number of different requests the single flight policy can have in flight at once.
+  _az_HTTP_POLICY_SINGLE_FLIGHT_CALLS = 8,
+};
+
+// A request waiting for the response to an identical request in flight, on the stack of its thread.
+struct _az_http_policy_single_flight_waiter;
+
+/**
+ * @brief A request in flight, sent by the single flight policy on behalf of the identical requests
+ * waiting for it.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span method;
+    az_span url; // The URL of the request in flight, valid until the call is over.
+    az_span headers; // Its _az_http_request_header array, as it entered the policy.
+    uint32_t key_hash;
+    struct _az_http_policy_single_flight_waiter* waiters;
+    bool is_used;
+  } _internal;
+} _az_http_policy_single_flight_call;
+
+/**
+ * @brief Options for the single flight policy, along with the requests it has in flight.
+ *
+ * @details Unlike the options of the other policies, these are meant to be shared by the pipelines
+ * of several threads, which is what makes requests coalesce. The requests in flight are guarded by
+ * a spin lock, only held while they are looked up or their response is copied.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_http_policy_single_flight_call calls[_az_HTTP_POLICY_SINGLE_FLIGHT_CALLS];
+    int32_t lock;
+  } _internal;
+} _az_http_policy_single_flight_options;
+
+/**
+ * @brief Initialize _az_http_policy_single_flight_options with no request in flight.
+ */
+AZ_NODISCARD _az_http_policy_single_flight_options
+_az_http_policy_single_flight_options_default(void);
+
 // PipelinePolicies
 //   Policies are non-allocating caveat the TransportPolicy
 //   Transport policies can only allocate if the transport layer they call allocates
@@ -111,6 +591,94 @@ AZ_NODISCARD az_result az_http_pipeline_process(
     az_http_request* ref_request,
     az_http_response* ref_response);
 
+/**
+ * @brief State of an HTTP pipeline run that can be suspended by a policy and resumed later.
+ *
+ * @details While an operation is in flight, its request points back to it, so a policy can find
+ * out that it may suspend instead of blocking the calling thread. A policy suspends by calling
+ * #_az_http_pipeline_operation_suspend() and returning its result, which every policy ahead of it
+ * passes back unchanged. Resuming re-enters the pipeline at the suspended policy, so the
+ * policies ahead of it must not do any work after the next policy returns.
+ */
+typedef struct _az_http_pipeline_operation
+{
+  struct
+  {
+    _az_http_pipeline* pipeline;
+    az_http_request* request;
+    az_http_response* response;
+    _az_http_policy* resume_policy; // NULL when the operation is not suspended.
+    int64_t resume_at_msec;
+    int32_t retry_attempt; // Retry policy state, 0 when it hasn't suspended.
+    int32_t retry_delay_msec; // The delay the retry policy suspended for.
+  } _internal;
+} _az_http_pipeline_operation;
+
+/**
+ * @brief Starts an asynchronous run of the pipeline.
+ *
+ * @param[in,out] ref_pipeline The pipeline to run.
+ * @param[out] out_operation The operation state. It must stay valid until the operation completes.
+ * @param[in,out] ref_request HTTP request to send.
+ * @param[out] ref_response HTTP response to receive the result into.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_ERROR_HTTP_PIPELINE_SUSPENDED A policy suspended the operation, call
+ * #az_http_pipeline_process_resume() once #_az_http_pipeline_operation_get_resume_msec() is
+ * reached.
+ * @retval other The operation completed, with the same result #az_http_pipeline_process() would
+ * return.
+ */
+AZ_NODISCARD az_result az_http_pipeline_process_start(
+    _az_http_pipeline* ref_pipeline,
+    _az_http_pipeline_operation* out_operation,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+/**
+ * @brief Resumes a suspended pipeline operation.
+ *
+ * @details Calling it before the resume time is allowed, it returns
+ * #AZ_ERROR_HTTP_PIPELINE_SUSPENDED again without doing any work.
+ *
+ * @param[in,out] ref_operation An operation #az_http_pipeline_process_start() or a previous
+ * call to this function returned #AZ_ERROR_HTTP_PIPELINE_SUSPENDED for.
+ *
+ * @return An #az_result value indicating the result of the operation, see
+ * #az_http_pipeline_process_start().
+ */
+AZ_NODISCARD az_result az_http_pipeline_process_resume(_az_http_pipeline_operation* ref_operation);
+
+/**
+ * @brief Gets the time a suspended operation should be resumed at, in the same units as
+ * #az_platform_clock_msec().
+ */
+AZ_NODISCARD AZ_INLINE int64_t
+_az_http_pipeline_operation_get_resume_msec(_az_http_pipeline_operation const* operation)
+{
+  return operation->_internal.resume_at_msec;
+}
+
+/**
+ * @brief Suspends the operation at \p ref_policy. To be called by a policy, which returns the
+ * result.
+ *
+ * @param[in,out] ref_operation The operation of the request being processed.
+ * @param[in] ref_policy The suspending policy, which gets called again on resume.
+ * @param[in] resume_at_msec When the operation should be resumed.
+ *
+ * @return #AZ_ERROR_HTTP_PIPELINE_SUSPENDED
+ */
+AZ_NODISCARD AZ_INLINE az_result _az_http_pipeline_operation_suspend(
+    _az_http_pipeline_operation* ref_operation,
+    _az_http_policy* ref_policy,
+    int64_t resume_at_msec)
+{
+  ref_operation->_internal.resume_policy = ref_policy;
+  ref_operation->_internal.resume_at_msec = resume_at_msec;
+  return AZ_ERROR_HTTP_PIPELINE_SUSPENDED;
+}
+
 AZ_NODISCARD az_result az_http_pipeline_policy_apiversion(
     _az_http_policy* ref_policies,
     void* ref_options,
@@ -123,6 +691,26 @@ AZ_NODISCARD az_result az_http_pipeline_policy_telemetry(
     az_http_request* ref_request,
     az_http_response* ref_response);
 
+AZ_NODISCARD az_result az_http_pipeline_policy_static_headers(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+/**
+ * @brief Compresses the body of requests with gzip, and sets their `Content-Encoding` header.
+ *
+ * @details A body in memory is replaced by its compressed form while the request goes through the
+ * policies after this one. A body read with a body reader is compressed while the transport reads
+ * it, so its length is not known up front, and the transport sends it with chunked transfer
+ * encoding. Bodies that don't get smaller and bodies smaller than the minimum size are sent as is.
+ */
+AZ_NODISCARD az_result az_http_pipeline_policy_compression(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
 AZ_NODISCARD az_result az_http_pipeline_policy_retry(
     _az_http_policy* ref_policies,
     void* ref_options,
@@ -149,6 +737,90 @@ AZ_NODISCARD az_result az_http_pipeline_policy_transport(
     az_http_request* ref_request,
     az_http_response* ref_response);
 
+// Sends a GET or HEAD request only once while other threads send the same one: the requests made
+// while it is in flight wait for its response, which is copied into their own, with a shared
+// #_az_http_policy_single_flight_options. Requests are the same if they have the same method, URL
+// and headers, in the same order. Only the headers set before this policy count, so pipelines
+// adding different headers after it, such as the Authorization of different credentials, must not
+// share the options. Put it in front of the retry policy, so that the retries are shared too.
+// Other requests, and all requests when the compiler has no atomic operations or there is no
+// platform implementation for #az_platform_event, are sent as usual.
+AZ_NODISCARD az_result az_http_pipeline_policy_single_flight(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+// Keeps the responses to GET and HEAD requests which have an `ETag` or a `Last-Modified` header,
+// with a #_az_http_policy_cache_options. The next time the same URL is requested, the request is
+// made conditional with `If-None-Match` or `If-Modified-Since`, and a 304 Not Modified response is
+// replaced by the response that was kept. Responses received through an allocator aren't kept.
+AZ_NODISCARD az_result az_http_pipeline_policy_cache(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+// Fails requests at once, with #AZ_ERROR_HTTP_CIRCUIT_OPEN, while their host keeps failing, with a
+// #_az_http_policy_circuit_breaker_options. Put it after the retry policy, which then stops
+// retrying as soon as the circuit opens.
+AZ_NODISCARD az_result az_http_pipeline_policy_circuit_breaker(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+// Paces requests with a token bucket whose rate follows the throttling of the service, with a
+// #_az_http_policy_rate_limit_options. Put it after the retry policy, so that retries are paced
+// too.
+AZ_NODISCARD az_result az_http_pipeline_policy_rate_limit(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+// Sends GET and HEAD requests a second time if they take longer than usual to complete, and uses
+// whichever response comes first. Other requests are sent once. It takes the place of the transport
+// policy at the end of the pipeline, with a #_az_http_policy_hedging_options.
+AZ_NODISCARD az_result az_http_pipeline_policy_hedging(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+/**
+ * @brief Tells whether an instrumentation callback is set, see
+ * #az_http_set_instrumentation_callback().
+ */
+AZ_NODISCARD bool _az_http_instrumentation_enabled(void);
+
+/**
+ * @brief Invokes the instrumentation callback, if any, with an event built from the parameters.
+ *
+ * @param[in] request The request being processed.
+ * @param[in] kind What the event is about.
+ * @param[in] phase Whether the event marks a beginning, an end, or a measured duration.
+ * @param[in] index The policy position or the attempt number, see #az_http_instrumentation_kind.
+ * @param[in] result The result of the operation, for #AZ_HTTP_INSTRUMENTATION_END.
+ * @param[in] elapsed_usec The measured duration, for #AZ_HTTP_INSTRUMENTATION_MEASURED.
+ */
+void _az_http_instrumentation_write(
+    az_http_request const* request,
+    az_http_instrumentation_kind kind,
+    az_http_instrumentation_phase phase,
+    int32_t index,
+    az_result result,
+    int64_t elapsed_usec);
+
+/**
+ * @brief Processes the request by the first of \p ref_policies, reporting the
+ * #AZ_HTTP_INSTRUMENTATION_POLICY events around it.
+ */
+AZ_NODISCARD az_result _az_http_pipeline_process_instrumented_policy(
+    _az_http_policy* ref_policies,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
 AZ_NODISCARD AZ_INLINE az_result _az_http_pipeline_nextpolicy(
     _az_http_policy* ref_policies,
     az_http_request* ref_request,
@@ -161,6 +833,11 @@ AZ_NODISCARD AZ_INLINE az_result _az_http_pipeline_nextpolicy(
     return AZ_ERROR_HTTP_PIPELINE_INVALID_POLICY;
   }
 
+  if (_az_http_instrumentation_enabled())
+  {
+    return _az_http_pipeline_process_instrumented_policy(ref_policies, ref_request, ref_response);
+  }
+
   return ref_policies[0]._internal.process(
       &(ref_policies[1]), ref_policies[0]._internal.options, ref_request, ref_response);
 }
@@ -197,6 +874,97 @@ AZ_NODISCARD az_result az_http_request_init(
     az_span headers_buffer,
     az_span body);
 
+/**
+ * @brief Makes the current URL and headers of an HTTP request the ones az_http_request_reset()
+ * returns it to, and az_http_request_init_from_template() starts other requests with.
+ *
+ * @details Build the parts of a request that are the same every time (the URL with its static
+ * query parameters, and the static headers) once, then save them, so that a loop sending requests
+ * only adds what changes. #az_http_request_init() saves the initial URL, without any header.
+ *
+ * @param[in,out] ref_request HTTP request to save the URL and headers of.
+ */
+void az_http_request_save_template(az_http_request* ref_request);
+
+/**
+ * @brief Truncates the URL and headers of an HTTP request back to the ones saved by
+ * az_http_request_save_template(), and replaces its context and body, so that it can be sent
+ * again without being built from scratch.
+ *
+ * @remarks The query parameters and headers added after the template was saved are dropped, as is
+ * a body reader set by az_http_request_set_body_reader(). The arena, if any, is kept.
+ *
+ * @param[in,out] ref_request HTTP request to reset.
+ * @param[in] context A pointer to an #az_context node.
+ * @param[in] body The #az_span buffer that contains a payload for the request. Use #AZ_SPAN_EMPTY
+ * for requests that don't have a body.
+ */
+void az_http_request_reset(az_http_request* ref_request, az_context* context, az_span body);
+
+/**
+ * @brief Initializes an HTTP request with the URL and headers saved by
+ * az_http_request_save_template() on \p template_request, copied into its own buffers, such as for
+ * each thread sending requests built from the same template.
+ *
+ * @details The values of the headers aren't copied: they must outlive both requests, as they would
+ * have for \p template_request. The method is the one of \p template_request, and the new request
+ * has no arena.
+ *
+ * @param[out] out_request HTTP request to initialize.
+ * @param[in] template_request The HTTP request to copy the URL and headers of.
+ * @param[in] context A pointer to an #az_context node.
+ * @param[in] url The #az_span to copy the URL into, and to add query parameters to.
+ * @param[in] headers_buffer The #az_span to copy the headers into, and to add headers to.
+ * @param[in] body The #az_span buffer that contains a payload for the request. Use #AZ_SPAN_EMPTY
+ * for requests that don't have a body.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p url or \p headers_buffer is too small for the URL or the
+ * headers of the template.
+ */
+AZ_NODISCARD az_result az_http_request_init_from_template(
+    az_http_request* out_request,
+    az_http_request const* template_request,
+    az_context* context,
+    az_span url,
+    az_span headers_buffer,
+    az_span body);
+
+/**
+ * @brief Makes the transport read the body of an HTTP request through \p read_callback, rather
+ * than from the body #az_span given to #az_http_request_init(), so that large uploads can be
+ * produced chunk by chunk.
+ *
+ * @param[in,out] ref_request HTTP request to stream the body of.
+ * @param[in] read_callback An #az_http_request_body_read_fn that produces the body.
+ * @param[in] user_context Any struct that was provided by the user for their specific
+ * implementation, passed through to \p read_callback.
+ * @param[in] body_length The total size of the body, or -1 if it is not known up front, in which
+ * case it is sent with chunked transfer encoding.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ */
+AZ_NODISCARD az_result az_http_request_set_body_reader(
+    az_http_request* ref_request,
+    az_http_request_body_read_fn read_callback,
+    void* user_context,
+    int64_t body_length);
+
+/**
+ * @brief Makes the transport allocate the temporary buffers it needs to send an HTTP request (like
+ * the zero-terminated URL and headers libcurl expects) from \p arena, rather than from the heap.
+ *
+ * @remarks The transport frees what it allocated once the request was sent, leaving anything
+ * allocated before (like the buffers given to #az_http_request_init()) in place. When \p arena
+ * runs out of space, the transport falls back to the heap.
+ *
+ * @param[in,out] ref_request HTTP request to send with \p arena.
+ * @param[in] arena The #az_arena to allocate from, or NULL to allocate from the heap.
+ */
+void az_http_request_set_arena(az_http_request* ref_request, az_arena* arena);
+
 /**
  * @brief Set a query parameter at the end of url.
  *
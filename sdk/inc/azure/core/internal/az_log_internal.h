@@ -16,6 +16,10 @@
 bool _az_log_should_write(az_log_classification classification);
 void _az_log_write(az_log_classification classification, az_span message);
 
+// Returns whether a message which is about to be logged is kept by the #az_log_sampler of its
+// classification, if any, counting it against the sampler. #_az_log_write() already calls this.
+bool _az_log_sampler_keep(az_log_classification classification);
+
 #define _az_LOG_SHOULD_WRITE(classification) _az_log_should_write(classification)
 #define _az_LOG_WRITE(classification, message) _az_log_write(classification, message)
 
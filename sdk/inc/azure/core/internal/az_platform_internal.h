@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief The deques of the #az_platform_executor workers, shared by the platform implementations.
+ *
+ * @remarks The platform implementation serializes every call with its own lock.
+ */
+
+#ifndef _az_PLATFORM_INTERNAL_H
+#define _az_PLATFORM_INTERNAL_H
+
+#include <azure/core/az_platform.h>
+#include <azure/core/az_result.h>
+#include <azure/core/internal/az_precondition_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+AZ_INLINE void _az_platform_executor_init(
+    az_platform_executor* out_executor,
+    az_platform_executor_worker workers[],
+    int32_t worker_count,
+    az_platform_work_item work_items[],
+    int32_t work_item_count)
+{
+  _az_PRECONDITION_NOT_NULL(out_executor);
+  _az_PRECONDITION_NOT_NULL(workers);
+  _az_PRECONDITION_NOT_NULL(work_items);
+  _az_PRECONDITION(worker_count > 0);
+  _az_PRECONDITION(work_item_count >= worker_count);
+
+  *out_executor = (az_platform_executor){
+    ._internal = {
+      .workers = workers,
+      .worker_count = worker_count,
+      .next_worker = 0,
+      .pending_count = 0,
+      .is_stopping = false,
+    },
+  };
+
+  int32_t const capacity = work_item_count / worker_count;
+  for (int32_t i = 0; i < worker_count; i++)
+  {
+    workers[i] = (az_platform_executor_worker){
+      ._internal = {
+        .executor = out_executor,
+        .thread = NULL,
+        .items = work_items + (i * capacity),
+        .capacity = capacity,
+        .first = 0,
+        .count = 0,
+        .index = i,
+      },
+    };
+  }
+}
+
+// Queues a work item at the back of the first deque with space, starting from the next worker in
+// turn so that the work is spread over the workers.
+AZ_NODISCARD AZ_INLINE az_result
+_az_platform_executor_push(az_platform_executor* ref_executor, az_platform_work_item item)
+{
+  int32_t const worker_count = ref_executor->_internal.worker_count;
+  for (int32_t i = 0; i < worker_count; i++)
+  {
+    int32_t const index = (ref_executor->_internal.next_worker + i) % worker_count;
+    az_platform_executor_worker* const worker = &ref_executor->_internal.workers[index];
+    int32_t const capacity = worker->_internal.capacity;
+    if (worker->_internal.count < capacity)
+    {
+      worker->_internal.items[(worker->_internal.first + worker->_internal.count) % capacity]
+          = item;
+      worker->_internal.count++;
+
+      ref_executor->_internal.next_worker = (index + 1) % worker_count;
+      ref_executor->_internal.pending_count++;
+      return AZ_OK;
+    }
+  }
+
+  return AZ_ERROR_NOT_ENOUGH_SPACE;
+}
+
+// Takes the next work item to run by a worker, or by the thread waiting for the executor when
+// worker_index is -1. A worker takes the newest item of its own deque, still warm in its cache, and
+// otherwise steals the oldest item of the other deques, in turn from the next worker.
+AZ_NODISCARD AZ_INLINE bool _az_platform_executor_take(
+    az_platform_executor* ref_executor,
+    int32_t worker_index,
+    az_platform_work_item* out_item)
+{
+  if (worker_index >= 0)
+  {
+    az_platform_executor_worker* const own = &ref_executor->_internal.workers[worker_index];
+    if (own->_internal.count > 0)
+    {
+      own->_internal.count--;
+      *out_item = own->_internal.items
+                      [(own->_internal.first + own->_internal.count) % own->_internal.capacity];
+      return true;
+    }
+  }
+
+  int32_t const worker_count = ref_executor->_internal.worker_count;
+  for (int32_t i = 1; i <= worker_count; i++)
+  {
+    az_platform_executor_worker* const victim
+        = &ref_executor->_internal.workers[(worker_index + i + worker_count) % worker_count];
+    if (victim->_internal.count > 0)
+    {
+      *out_item = victim->_internal.items[victim->_internal.first];
+      victim->_internal.first = (victim->_internal.first + 1) % victim->_internal.capacity;
+      victim->_internal.count--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Marks a work item taken by _az_platform_executor_take() as done, and returns whether it was the
+// last pending one.
+AZ_NODISCARD AZ_INLINE bool _az_platform_executor_done(az_platform_executor* ref_executor)
+{
+  ref_executor->_internal.pending_count--;
+  return ref_executor->_internal.pending_count == 0;
+}
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_PLATFORM_INTERNAL_H
@@ -27,6 +27,12 @@
  *        code (or adding option -DPRECONDITIONS=OFF with cmake), all of the Azure SDK
  *        precondition checking will be excluding making the binary code smaller and faster. We
  *        recommend doing this before you ship your code.
+ *
+ *        If you also define the AZ_PRECONDITION_ASSUMPTIONS symbol (or add option
+ *        -DPRECONDITION_ASSUMPTIONS=ON with cmake, which only does so outside of Debug builds),
+ *        the preconditions are not checked but assumed to hold, which lets the optimizer drop the
+ *        checks they make redundant, such as the bounds checks of az_span functions. Breaking a
+ *        precondition is then undefined behavior.
  */
 
 #ifndef _az_PRECONDITION_INTERNAL_H
@@ -58,8 +64,32 @@ az_precondition_failed_fn az_precondition_failed_get_callback();
 #define _az_ANALYSIS_ASSUME(statement)
 #endif
 
+// _az_ASSUME() tells the optimizer that the condition holds, without checking it. GCC and clang
+// compile the condition into a branch to __builtin_unreachable(), which the optimizer removes along
+// with the condition, as long as the latter has no side effects, which is the case of
+// preconditions. Clang's __builtin_assume() is not used since it ignores conditions calling a
+// function, such as _az_span_is_valid(). MSVC's __assume() doesn't evaluate the condition at all.
+#if defined(__GNUC__) || defined(__clang__)
+#define _az_ASSUME(condition)  \
+  do                           \
+  {                            \
+    if (!(condition))          \
+    {                          \
+      __builtin_unreachable(); \
+    }                          \
+  } while (0)
+#elif defined(_MSC_VER)
+#define _az_ASSUME(condition) __assume(condition)
+#else
+#define _az_ASSUME(condition)
+#endif
+
 #ifdef AZ_NO_PRECONDITION_CHECKING
+#ifdef AZ_PRECONDITION_ASSUMPTIONS
+#define _az_PRECONDITION(condition) _az_ASSUME(condition)
+#else
 #define _az_PRECONDITION(condition)
+#endif // AZ_PRECONDITION_ASSUMPTIONS
 #else
 #define _az_PRECONDITION(condition)            \
   do                                           \
@@ -11,12 +11,58 @@
 AZ_NODISCARD AZ_INLINE int32_t
 _az_retry_calc_delay(int32_t attempt, int32_t retry_delay_msec, int32_t max_retry_delay_msec)
 {
-  // scale exponentially
-  int32_t const exponential_retry_after
-      = retry_delay_msec * (attempt <= 30 ? (int32_t)(1U << (uint32_t)attempt) : INT32_MAX);
+  // scale exponentially, in 64 bits so that large attempts saturate rather than overflow
+  int64_t const exponential_retry_after = (int64_t)retry_delay_msec
+      * (attempt <= 30 ? (int64_t)(1U << (uint32_t)attempt) : (int64_t)INT32_MAX);
 
   return exponential_retry_after > max_retry_delay_msec ? max_retry_delay_msec
-                                                        : exponential_retry_after;
+                                                        : (int32_t)exponential_retry_after;
+}
+
+/*
+ * Randomized delays, so that many clients failing at the same time don't retry in lockstep. The
+ * caller provides the random value, as there is no source of randomness in core.
+ */
+
+// "Full jitter": a uniformly random delay between 0 and the exponential delay.
+AZ_NODISCARD AZ_INLINE int32_t _az_retry_calc_delay_full_jitter(
+    int32_t attempt,
+    int32_t retry_delay_msec,
+    int32_t max_retry_delay_msec,
+    uint32_t random)
+{
+  int32_t delay = _az_retry_calc_delay(attempt, retry_delay_msec, max_retry_delay_msec);
+  if (delay < 0)
+  {
+    delay = max_retry_delay_msec;
+  }
+
+  return delay <= 0 ? 0 : (int32_t)(random % ((uint32_t)delay + 1U));
+}
+
+// "Decorrelated jitter": a uniformly random delay between the minimum delay and three times the
+// previous delay, capped at the maximum delay. Pass 0 as the previous delay for the first retry.
+AZ_NODISCARD AZ_INLINE int32_t _az_retry_calc_delay_decorrelated(
+    int32_t previous_delay_msec,
+    int32_t min_retry_delay_msec,
+    int32_t max_retry_delay_msec,
+    uint32_t random)
+{
+  int64_t upper = 3
+      * (int64_t)(previous_delay_msec > min_retry_delay_msec ? previous_delay_msec
+                                                              : min_retry_delay_msec);
+  if (upper > max_retry_delay_msec)
+  {
+    upper = max_retry_delay_msec;
+  }
+
+  if (upper <= min_retry_delay_msec)
+  {
+    return upper > 0 ? (int32_t)upper : 0;
+  }
+
+  return min_retry_delay_msec
+      + (int32_t)(random % (uint32_t)(upper - min_retry_delay_msec + 1));
 }
 
 #include <azure/core/_az_cfg_suffix.h>
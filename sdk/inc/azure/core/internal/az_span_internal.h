@@ -9,6 +9,7 @@
 #include <azure/core/internal/az_precondition_internal.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <azure/core/_az_cfg_prefix.h>
 
@@ -30,6 +31,88 @@ enum
   _az_SMALLEST_10_DIGIT_NUMBER = 1000000000,
 };
 
+/*
+ * Inline definitions of the hottest span primitives, which the functions exported by az_span.c
+ * call. When AZ_INLINE_CORE is defined (cmake option INLINE_CORE), the calls made by the SDK are
+ * redirected to them, so that they get inlined without link-time optimization. Applications keep
+ * calling the exported functions.
+ */
+
+AZ_NODISCARD AZ_INLINE az_span _az_span_slice(az_span span, int32_t start_index, int32_t end_index)
+{
+  _az_PRECONDITION_VALID_SPAN(span, 0, true);
+
+  // The following set of preconditions validate that:
+  //    0 <= end_index <= span.size
+  // And
+  //    0 <= start_index <= end_index
+  _az_PRECONDITION_RANGE(0, end_index, az_span_size(span));
+  _az_PRECONDITION((uint32_t)start_index <= (uint32_t)end_index);
+
+  return (az_span){
+    ._internal = { .ptr = az_span_ptr(span) + start_index, .size = end_index - start_index },
+  };
+}
+
+AZ_NODISCARD AZ_INLINE az_span _az_span_slice_to_end(az_span span, int32_t start_index)
+{
+  return _az_span_slice(span, start_index, az_span_size(span));
+}
+
+AZ_INLINE az_span _az_span_copy(az_span destination, az_span source)
+{
+  int32_t src_size = az_span_size(source);
+
+  _az_PRECONDITION_VALID_SPAN(destination, src_size, false);
+
+  // Even though the contract of this function is that the destination must be larger than source,
+  // cap the data move if the source is too large, to avoid memory corruption.
+  int32_t dest_size = az_span_size(destination);
+  if (src_size > dest_size)
+  {
+    src_size = dest_size;
+  }
+
+  // Also keeps GCC from assuming a negative size, once inlined, and failing Release builds with
+  // -Wstringop-overflow.
+  if (src_size <= 0)
+  {
+    return destination;
+  }
+
+  uint8_t* ptr = az_span_ptr(destination);
+  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
+  memmove((void*)ptr, (void const*)az_span_ptr(source), (size_t)src_size);
+
+  return _az_span_slice_to_end(destination, src_size);
+}
+
+AZ_INLINE az_span _az_span_copy_u8(az_span destination, uint8_t byte)
+{
+  _az_PRECONDITION_VALID_SPAN(destination, 1, false);
+
+  // Even though the contract of the function is that the destination must be at least 1 byte large,
+  // no-op if it is empty to avoid memory corruption.
+  int32_t dest_size = az_span_size(destination);
+  if (dest_size < 1)
+  {
+    return destination;
+  }
+
+  uint8_t* dst_ptr = az_span_ptr(destination);
+  dst_ptr[0] = byte;
+  return (az_span){ ._internal = { .ptr = dst_ptr + 1, .size = dest_size - 1 } };
+}
+
+#ifdef AZ_INLINE_CORE
+// Object-like macros, so that the names are redirected wherever they appear, and not only where
+// they are called.
+#define az_span_slice _az_span_slice
+#define az_span_slice_to_end _az_span_slice_to_end
+#define az_span_copy _az_span_copy
+#define az_span_copy_u8 _az_span_copy_u8
+#endif // AZ_INLINE_CORE
+
 // Use this helper to figure out how much the sliced_span has moved in comparison to the
 // original_span while writing and slicing a copy of the original.
 // The \p sliced_span must be some slice of the \p original_span (and have the same backing memory).
@@ -56,8 +139,10 @@ AZ_INLINE AZ_NODISCARD int32_t _az_span_diff(az_span sliced_span, az_span origin
  *         - #AZ_ERROR_NOT_ENOUGH_SPACE if the \p destination is not big enough to contain the
  * encoded bytes
  *
- * @remark If \p destination can't fit the \p source, some data may still be written to it, but the
- * \p out_length will be set to 0, and the function will return #AZ_ERROR_NOT_ENOUGH_SPACE.
+ * @remark If \p destination can't fit the \p source, some data may still be written to it, the
+ * \p out_length will be set to the size \p destination would have needed, and the function will
+ * return #AZ_ERROR_NOT_ENOUGH_SPACE. This makes calling #_az_span_url_encode_calc_length()
+ * beforehand unnecessary.
  * @remark The \p destination and \p source must not overlap.
  */
 AZ_NODISCARD az_result
@@ -75,8 +160,7 @@ AZ_NODISCARD int32_t _az_span_url_encode_calc_length(az_span source);
 /**
  * @brief String tokenizer for #az_span.
  *
- * @param[in] source The #az_span with the content to be searched on. It must be a non-empty
- * #az_span.
+ * @param[in] source The #az_span with the content to be searched on. It may be empty.
  * @param[in] delimiter The #az_span containing the delimiter to "split" `source` into tokens.  It
  * must be a non-empty #az_span.
  * @param[out] out_remainder The #az_span pointing to the remaining bytes in `source`, starting
@@ -95,6 +179,15 @@ az_span _az_span_token(
     az_span* out_remainder,
     int32_t* out_index);
 
+/**
+ * @brief Computes the CRC-32 (IEEE 802.3, as used by gzip and zlib) of the bytes of an #az_span.
+ *
+ * @param[in] crc The CRC-32 of the preceding bytes, or 0 to start a new one.
+ * @param[in] source The #az_span containing the bytes to add to the CRC-32.
+ * @return The CRC-32 of the preceding bytes followed by \p source.
+ */
+AZ_NODISCARD uint32_t _az_span_crc32(uint32_t crc, az_span source);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_SPAN_INTERNAL_H
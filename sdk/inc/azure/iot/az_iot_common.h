@@ -15,6 +15,7 @@
 #ifndef _az_IOT_CORE_H
 #define _az_IOT_CORE_H
 
+#include <azure/core/az_json.h>
 #include <azure/core/az_log.h>
 #include <azure/core/az_result.h>
 #include <azure/core/az_span.h>
@@ -140,6 +141,22 @@ typedef enum
 /// #AZ_SPAN_FROM_STR macro as a parameter, where needed.
 #define AZ_IOT_MESSAGE_PROPERTIES_CREATION_TIME "%24.ctime"
 
+/**
+ * @brief A slot of the optional index of an #az_iot_message_properties.
+ *
+ * @details An array of these is supplied by the application through
+ * #az_iot_message_properties_set_index().
+ */
+typedef struct
+{
+  struct
+  {
+    int32_t name_offset;
+    int32_t name_length;
+    int32_t value_length;
+  } _internal;
+} az_iot_message_properties_index_entry;
+
 /**
  * @brief Telemetry or C2D properties.
  *
@@ -151,6 +168,10 @@ typedef struct
     az_span properties_buffer;
     int32_t properties_written;
     uint32_t current_property_index;
+    az_iot_message_properties_index_entry* index;
+    int32_t index_capacity;
+    int32_t index_length;
+    int32_t indexed_length;
   } _internal;
 } az_iot_message_properties;
 
@@ -220,6 +241,30 @@ AZ_NODISCARD az_result az_iot_message_properties_find(
     az_span name,
     az_span* out_value);
 
+/**
+ * @brief Attaches an index to the properties, so that #az_iot_message_properties_find() doesn't
+ * need to parse the whole properties buffer on every call.
+ *
+ * @details The properties already present in the buffer are indexed by this call, and the
+ * properties added through #az_iot_message_properties_append() are indexed as they are appended.
+ * If there are more properties than \p index_entries can hold, the properties which are not indexed
+ * are still found by parsing the remainder of the buffer.
+ *
+ * @note The index must be set again if the properties are re-initialized with
+ * #az_iot_message_properties_init().
+ *
+ * @param[in] properties The #az_iot_message_properties to use for this call.
+ * @param[in] index_entries An array of #az_iot_message_properties_index_entry that will hold the
+ * index. It must remain valid for as long as \p properties is used.
+ * @param[in] index_entries_length The number of elements in \p index_entries.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The index was attached successfully.
+ */
+AZ_NODISCARD az_result az_iot_message_properties_set_index(
+    az_iot_message_properties* properties,
+    az_iot_message_properties_index_entry* index_entries,
+    int32_t index_entries_length);
+
 /**
  * @brief Iterates over the list of properties.
  *
@@ -235,6 +280,36 @@ AZ_NODISCARD az_result az_iot_message_properties_next(
     az_span* out_name,
     az_span* out_value);
 
+/**
+ * @brief The system properties of a message, such as of a C2D request.
+ *
+ * @details The values are as they appear in the MQTT topic, so they may be percent-encoded. Each
+ * one is #AZ_SPAN_EMPTY if the message doesn't have it.
+ */
+typedef struct
+{
+  az_span message_id; ///< The #AZ_IOT_MESSAGE_PROPERTIES_MESSAGE_ID property.
+  az_span correlation_id; ///< The #AZ_IOT_MESSAGE_PROPERTIES_CORRELATION_ID property.
+  az_span content_type; ///< The #AZ_IOT_MESSAGE_PROPERTIES_CONTENT_TYPE property.
+  az_span content_encoding; ///< The #AZ_IOT_MESSAGE_PROPERTIES_CONTENT_ENCODING property.
+} az_iot_message_system_properties;
+
+/**
+ * @brief Gets the system properties of a message, reading its properties once.
+ *
+ * @details The system property names are recognized whether their `$` is percent-encoded (as in
+ * #AZ_IOT_MESSAGE_PROPERTIES_MESSAGE_ID) or not. The iteration state of
+ * #az_iot_message_properties_next() is left unchanged.
+ *
+ * @param[in] properties The #az_iot_message_properties to use for this call.
+ * @param[out] out_system_properties The #az_iot_message_system_properties of the message.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The system properties were read, even if the message has none of them.
+ */
+AZ_NODISCARD az_result az_iot_message_properties_get_system_properties(
+    az_iot_message_properties const* properties,
+    az_iot_message_system_properties* out_system_properties);
+
 /**
  * @brief Checks if the status indicates a successful operation.
  *
@@ -277,6 +352,1097 @@ AZ_NODISCARD int32_t az_iot_calculate_retry_delay(
     int32_t max_retry_delay_msec,
     int32_t random_jitter_msec);
 
+/**
+ * @brief Calculates a randomized delay before retrying an operation that failed, using
+ * "decorrelated jitter".
+ *
+ * @details The delay is chosen uniformly between \p min_retry_delay_msec and three times
+ * \p previous_delay_msec, up to \p max_retry_delay_msec. Unlike the exponential delay of
+ * #az_iot_calculate_retry_delay(), devices which lost their connection at the same time end up
+ * retrying at different times, rather than all together.
+ *
+ * @param[in] operation_msec The time it took, in milliseconds, to perform the operation that
+ *                           failed.
+ * @param[in] previous_delay_msec The delay returned for the previous retry of the operation, or 0
+ *                                for the first retry.
+ * @param[in] min_retry_delay_msec The minimum time, in milliseconds, to wait before a retry.
+ * @param[in] max_retry_delay_msec The maximum time, in milliseconds, to wait before a retry.
+ * @param[in] random A random value, for instance from the random number generator of the device.
+ * @return The recommended delay in milliseconds.
+ */
+AZ_NODISCARD int32_t az_iot_calculate_retry_delay_decorrelated(
+    int32_t operation_msec,
+    int32_t previous_delay_msec,
+    int32_t min_retry_delay_msec,
+    int32_t max_retry_delay_msec,
+    uint32_t random);
+
+/**
+ * @brief Calculates the whole schedule of delays before the retries of a device, seeded by its
+ * identity, so that a fleet losing its connection at once reconnects spread over a window.
+ *
+ * @details Retry `i` waits for the exponential delay of #az_iot_calculate_retry_delay(), plus an
+ * offset within \p spread_msec. The offsets are derived from a hash of \p device_id and \p seed
+ * rather than drawn at each retry: they need no random number generator on the device, are the
+ * same each time the schedule is calculated, and are evenly distributed over the window across
+ * the devices of a fleet. Near \p max_retry_delay_msec, the window ends at the maximum delay.
+ *
+ * Pass the schedule to #az_iot_connection_options, or wait for `out_schedule_msec[i]` minus the
+ * time the failed operation took before retry `i`, and for the last delay once the schedule is
+ * exhausted.
+ *
+ * @param[in] device_id The identity of the device, such as its device ID or registration ID.
+ * @param[in] seed Changes the offsets of all the devices, for instance to use different ones on
+ * each hub.
+ * @param[in] min_retry_delay_msec The minimum time, in milliseconds, to wait before a retry.
+ * @param[in] max_retry_delay_msec The maximum time, in milliseconds, to wait before a retry.
+ * @param[in] spread_msec The width, in milliseconds, of the window the retries of a fleet are
+ * spread over. It is narrowed to `max_retry_delay_msec - min_retry_delay_msec`.
+ * @param[out] out_schedule_msec The delays before the retries, in milliseconds.
+ * @param[in] schedule_length The number of delays to calculate into \p out_schedule_msec.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The schedule was calculated successfully.
+ */
+AZ_NODISCARD az_result az_iot_calculate_retry_schedule(
+    az_span device_id,
+    uint32_t seed,
+    int32_t min_retry_delay_msec,
+    int32_t max_retry_delay_msec,
+    int32_t spread_msec,
+    int32_t out_schedule_msec[],
+    int32_t schedule_length);
+
+/*
+ *
+ * SAS token signing APIs
+ *
+ *   The signature returned by #az_iot_hub_client_sas_get_signature() or
+ *   #az_iot_provisioning_client_sas_get_signature() must be signed with HMAC-SHA256, using the
+ *   base64 decoded shared access key, and the result base64 encoded, before it is passed to
+ *   #az_iot_hub_client_sas_get_password() or #az_iot_provisioning_client_sas_get_password().
+ *   These APIs do it without requiring a crypto library.
+ */
+
+/// The size, in bytes, of an HMAC-SHA256 hash.
+#define AZ_IOT_HMAC_SHA256_SIZE 32
+
+/// The size, in bytes, of the base64 text of an HMAC-SHA256 hash.
+#define AZ_IOT_BASE64_HMAC_SHA256_SIZE 44
+
+/**
+ * @brief Defines the signature of the callback function that computes an HMAC-SHA256 hash, for
+ * instance with the crypto engine of a microcontroller.
+ *
+ * @param[in] key The key of the HMAC.
+ * @param[in] data The bytes to hash.
+ * @param[out] destination_hash The buffer the #AZ_IOT_HMAC_SHA256_SIZE bytes of the hash must be
+ * written to. It is at least #AZ_IOT_HMAC_SHA256_SIZE bytes long.
+ * @return An #az_result value indicating the result of the operation.
+ */
+typedef az_result (*az_iot_hmac_sha256_fn)(az_span key, az_span data, az_span destination_hash);
+
+/**
+ * @brief Sets the function used by #az_iot_hmac_sha256() and #az_iot_sas_key_sign() to compute
+ * HMAC-SHA256 hashes.
+ *
+ * @details By default, the hashes are computed in software, using the SHA-256 instructions of the
+ * processor when the compiler targets them (such as with `-msha` on x86, or `-march=armv8-a+crypto`
+ * on ARM).
+ *
+ * @param[in] hmac_sha256_callback __[nullable]__ A pointer to the function computing the hashes,
+ * or `NULL` to compute them in software.
+ */
+void az_iot_set_hmac_sha256_callback(az_iot_hmac_sha256_fn hmac_sha256_callback);
+
+/**
+ * @brief Computes the HMAC-SHA256 hash of some bytes.
+ *
+ * @param[in] key The key of the HMAC.
+ * @param[in] data The bytes to hash.
+ * @param[out] destination_hash The buffer the #AZ_IOT_HMAC_SHA256_SIZE bytes of the hash are
+ * written to.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The hash was computed successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination_hash is smaller than
+ * #AZ_IOT_HMAC_SHA256_SIZE.
+ */
+AZ_NODISCARD az_result az_iot_hmac_sha256(az_span key, az_span data, az_span destination_hash);
+
+/**
+ * @brief Encodes bytes as base64 text, with padding.
+ *
+ * @details The same as az_span_base64_encode().
+ *
+ * @param[out] destination_base64_text The buffer the base64 text is written to.
+ * @param[in] source_bytes The bytes to encode.
+ * @param[out] out_written The number of bytes written to \p destination_base64_text.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The bytes were encoded successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination_base64_text is too small.
+ */
+AZ_NODISCARD az_result
+az_iot_base64_encode(az_span destination_base64_text, az_span source_bytes, int32_t* out_written);
+
+/**
+ * @brief Decodes base64 text, with padding, such as a shared access key.
+ *
+ * @details The same as az_span_base64_decode().
+ *
+ * @param[out] destination_bytes The buffer the decoded bytes are written to.
+ * @param[in] source_base64_text The base64 text to decode.
+ * @param[out] out_written The number of bytes written to \p destination_bytes.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The text was decoded successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination_bytes is too small.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR \p source_base64_text contains a character which isn't part
+ * of the base64 alphabet.
+ * @retval #AZ_ERROR_UNEXPECTED_END The size of \p source_base64_text isn't a multiple of 4.
+ */
+AZ_NODISCARD az_result
+az_iot_base64_decode(az_span destination_bytes, az_span source_base64_text, int32_t* out_written);
+
+/**
+ * @brief A shared access key, prepared for signing SAS tokens.
+ *
+ * @details The HMAC-SHA256 states derived from the key are computed once by
+ * #az_iot_sas_key_init(), rather than for every token.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span key;
+    uint32_t inner_state[8];
+    uint32_t outer_state[8];
+  } _internal;
+} az_iot_sas_key;
+
+/**
+ * @brief Prepares a shared access key for signing SAS tokens.
+ *
+ * @param[out] out_sas_key The #az_iot_sas_key to initialize.
+ * @param[in] key The shared access key, already base64 decoded with #az_iot_base64_decode(). It
+ * must remain valid for as long as \p out_sas_key is used, since it is passed to the function set
+ * by #az_iot_set_hmac_sha256_callback(), if any.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The key was prepared successfully.
+ */
+AZ_NODISCARD az_result az_iot_sas_key_init(az_iot_sas_key* out_sas_key, az_span key);
+
+/**
+ * @brief Signs the signature of a SAS token, for
+ * #az_iot_hub_client_sas_get_password() or #az_iot_provisioning_client_sas_get_password().
+ *
+ * @param[in] sas_key The #az_iot_sas_key to sign with.
+ * @param[in] signature The signature returned by #az_iot_hub_client_sas_get_signature() or
+ * #az_iot_provisioning_client_sas_get_signature().
+ * @param[out] destination_base64_hmac_sha256 The buffer the base64 encoded HMAC-SHA256 hash of \p
+ * signature is written to. It must be at least #AZ_IOT_BASE64_HMAC_SHA256_SIZE bytes long.
+ * @param[out] out_base64_hmac_sha256 The slice of \p destination_base64_hmac_sha256 holding the
+ * base64 encoded hash.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The signature was signed successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination_base64_hmac_sha256 is too small.
+ */
+AZ_NODISCARD az_result az_iot_sas_key_sign(
+    az_iot_sas_key const* sas_key,
+    az_span signature,
+    az_span destination_base64_hmac_sha256,
+    az_span* out_base64_hmac_sha256);
+
+/*
+ *
+ * MQTT connection state machine
+ *
+ */
+
+/**
+ * @brief The state of an #az_iot_connection.
+ */
+typedef enum
+{
+  /// Not started, or stopped.
+  AZ_IOT_CONNECTION_STATE_DISCONNECTED = 0,
+
+  /// Waiting for the CONNACK of the MQTT CONNECT.
+  AZ_IOT_CONNECTION_STATE_CONNECTING = 1,
+
+  /// Waiting for the SUBACK of the MQTT SUBSCRIBE.
+  AZ_IOT_CONNECTION_STATE_SUBSCRIBING = 2,
+
+  /// Connected and subscribed: the application can publish.
+  AZ_IOT_CONNECTION_STATE_CONNECTED = 3,
+
+  /// Waiting until the retry delay elapses before connecting again.
+  AZ_IOT_CONNECTION_STATE_WAITING_TO_RETRY = 4,
+
+  /// The service rejected the connection with an error that retrying doesn't fix, such as an
+  /// authentication failure. #az_iot_connection_get_status() tells the cause.
+  AZ_IOT_CONNECTION_STATE_FAILED = 5,
+} az_iot_connection_state;
+
+/**
+ * @brief The kind of an #az_iot_connection_event.
+ */
+typedef enum
+{
+  /// The application wants to connect.
+  AZ_IOT_CONNECTION_EVENT_START = 1,
+
+  /// The MQTT CONNACK was received. The event's `return_code` is its connect return code.
+  AZ_IOT_CONNECTION_EVENT_CONNACK = 2,
+
+  /// The MQTT SUBACK was received. The event's `return_code` is its lowest granted QoS, or `0x80`
+  /// if a subscription failed.
+  AZ_IOT_CONNECTION_EVENT_SUBACK = 3,
+
+  /// The time returned by #az_iot_connection_get_deadline() was reached.
+  AZ_IOT_CONNECTION_EVENT_TIMEOUT = 4,
+
+  /// The transport or the MQTT connection was lost.
+  AZ_IOT_CONNECTION_EVENT_DISCONNECT = 5,
+
+  /// The application wants to disconnect.
+  AZ_IOT_CONNECTION_EVENT_STOP = 6,
+} az_iot_connection_event_type;
+
+/**
+ * @brief An event for #az_iot_connection_handle_event().
+ */
+typedef struct
+{
+  /// The kind of event.
+  az_iot_connection_event_type type;
+
+  /// The return code of a CONNACK or SUBACK event.
+  int32_t return_code;
+} az_iot_connection_event;
+
+/**
+ * @brief The transport operation the application performs after an event.
+ */
+typedef enum
+{
+  /// Nothing to do.
+  AZ_IOT_CONNECTION_ACTION_NONE = 0,
+
+  /// Open the transport and send the MQTT CONNECT, with fresh credentials.
+  AZ_IOT_CONNECTION_ACTION_CONNECT = 1,
+
+  /// Send the MQTT SUBSCRIBE for the topic filters of the features in use.
+  AZ_IOT_CONNECTION_ACTION_SUBSCRIBE = 2,
+
+  /// Close the MQTT connection and the transport.
+  AZ_IOT_CONNECTION_ACTION_DISCONNECT = 3,
+} az_iot_connection_action;
+
+/**
+ * @brief The timing of an #az_iot_connection, in milliseconds.
+ */
+typedef struct
+{
+  /// The time to wait for a CONNACK before retrying.
+  int32_t connect_timeout_msec;
+
+  /// The time to wait for a SUBACK before retrying.
+  int32_t subscribe_timeout_msec;
+
+  /// The minimum delay before a retry, passed to #az_iot_calculate_retry_delay().
+  int32_t min_retry_delay_msec;
+
+  /// The maximum delay before a retry, passed to #az_iot_calculate_retry_delay().
+  int32_t max_retry_delay_msec;
+
+  /// The delays before the retries, from #az_iot_calculate_retry_schedule(), or `NULL` to calculate
+  /// them with #az_iot_calculate_retry_delay() instead. The last delay is used once the schedule is
+  /// exhausted. The schedule must remain valid as long as the connection uses it.
+  int32_t const* retry_schedule_msec;
+
+  /// The number of delays in #retry_schedule_msec.
+  int32_t retry_schedule_length;
+
+  /// Whether to subscribe once connected. Without subscriptions, the connection is established
+  /// on CONNACK.
+  bool subscribe;
+} az_iot_connection_options;
+
+/**
+ * @brief Gets the default #az_iot_connection_options: 30 second timeouts, and the retry delays
+ * recommended by the MQTT state machine documentation.
+ *
+ * @return #az_iot_connection_options.
+ */
+AZ_NODISCARD az_iot_connection_options az_iot_connection_options_default();
+
+/**
+ * @brief A non-blocking MQTT connection state machine, for the connect, subscribe, retry and
+ * reconnect flow documented for the IoT clients.
+ *
+ * @details The state machine doesn't perform any I/O. The application feeds it the transport
+ * events with #az_iot_connection_handle_event(), performs the returned actions with its own MQTT
+ * stack, and sends a timeout event once #az_iot_connection_get_deadline() is reached. Since it
+ * never blocks, and holds no more than a few bytes of state, one thread can drive many device
+ * sessions.
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_connection_options options;
+    int64_t deadline;
+    int64_t operation_start;
+    az_iot_status status;
+    int16_t attempt;
+    uint8_t state;
+  } _internal;
+} az_iot_connection;
+
+/**
+ * @brief Initializes an #az_iot_connection, in the #AZ_IOT_CONNECTION_STATE_DISCONNECTED state.
+ *
+ * @param[out] connection The #az_iot_connection to initialize.
+ * @param[in] options __[nullable]__ A reference to an #az_iot_connection_options structure. If
+ * `NULL` is passed, the default options are used.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The connection was initialized successfully.
+ */
+AZ_NODISCARD az_result
+az_iot_connection_init(az_iot_connection* connection, az_iot_connection_options const* options);
+
+/**
+ * @brief Moves an #az_iot_connection to its next state, after an event.
+ *
+ * @details Unexpected events, such as a CONNACK while subscribing, or a timeout before the
+ * deadline, are ignored.
+ *
+ * @param[in,out] connection The #az_iot_connection to use for this call.
+ * @param[in] event The #az_iot_connection_event which occurred.
+ * @param[in] now_msec The current time, in milliseconds.
+ * @param[in] random_jitter_msec A random value between 0 and the maximum allowed jitter, passed to
+ * #az_iot_calculate_retry_delay() if the event leads to a retry. Ignored when the options have a
+ * retry schedule.
+ * @param[out] out_action The transport operation to perform.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The event was handled.
+ */
+AZ_NODISCARD az_result az_iot_connection_handle_event(
+    az_iot_connection* connection,
+    az_iot_connection_event event,
+    int64_t now_msec,
+    int32_t random_jitter_msec,
+    az_iot_connection_action* out_action);
+
+/**
+ * @brief Gets the state of an #az_iot_connection.
+ *
+ * @param[in] connection The #az_iot_connection to use for this call.
+ * @return The #az_iot_connection_state.
+ */
+AZ_NODISCARD AZ_INLINE az_iot_connection_state
+az_iot_connection_get_state(az_iot_connection const* connection)
+{
+  return (az_iot_connection_state)connection->_internal.state;
+}
+
+/**
+ * @brief Gets the time at which the application sends an #AZ_IOT_CONNECTION_EVENT_TIMEOUT event.
+ *
+ * @param[in] connection The #az_iot_connection to use for this call.
+ * @return The deadline, in milliseconds, or `INT64_MAX` if the connection doesn't wait for
+ * anything.
+ */
+AZ_NODISCARD AZ_INLINE int64_t az_iot_connection_get_deadline(az_iot_connection const* connection)
+{
+  return connection->_internal.deadline;
+}
+
+/**
+ * @brief Gets the outcome of the last connection attempt, as an #az_iot_status.
+ *
+ * @details CONNACK return codes are mapped so that #az_iot_status_retriable() tells which ones are
+ * worth retrying: a server unavailable CONNACK, which the services also use for throttling, maps
+ * to #AZ_IOT_STATUS_SERVER_ERROR, the authentication failures to #AZ_IOT_STATUS_UNAUTHORIZED,
+ * after which the credentials should be rotated or the device provisioned again, and the other
+ * refusals to #AZ_IOT_STATUS_BAD_REQUEST. Failed subscriptions map to #AZ_IOT_STATUS_SERVER_ERROR,
+ * and lost connections and timeouts to #AZ_IOT_STATUS_TIMEOUT, and are always retried.
+ *
+ * @param[in] connection The #az_iot_connection to use for this call.
+ * @return The #az_iot_status of the last connection attempt, or #AZ_IOT_STATUS_UNKNOWN if none
+ * completed.
+ */
+AZ_NODISCARD AZ_INLINE az_iot_status
+az_iot_connection_get_status(az_iot_connection const* connection)
+{
+  return connection->_internal.status;
+}
+
+/*
+ *
+ * QoS 1 in-flight window
+ *
+ */
+
+/**
+ * @brief A QoS 1 PUBLISH awaiting its PUBACK, tracked by an #az_iot_inflight_window.
+ */
+typedef struct
+{
+  /**
+   * The application's data for the message, such as its topic and payload.
+   */
+  void* context;
+
+  /**
+   * The time, in the application's clock units, after which the message is published again.
+   */
+  int64_t deadline;
+
+  /**
+   * The order in which the message was added to the window.
+   */
+  uint32_t sequence;
+
+  /**
+   * The number of times the message was published.
+   */
+  int32_t attempts;
+
+  /**
+   * The MQTT packet identifier of the message. Zero for a free slot.
+   */
+  uint16_t packet_id;
+} az_iot_inflight_publish;
+
+/**
+ * @brief A fixed-capacity window of QoS 1 messages awaiting their PUBACK, backed by an
+ * application buffer.
+ *
+ * @details Instead of waiting for the PUBACK of each message before publishing the next one, the
+ * application publishes as long as the window isn't full, and retires the messages as their
+ * PUBACKs arrive. The window hands out the MQTT packet identifiers, choosing them so that each one
+ * maps to its own slot, which makes acknowledging a message a constant-time lookup. Messages whose
+ * PUBACK doesn't arrive in time are published again, in their original order.
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_inflight_publish* publishes;
+    int64_t timeout;
+    uint32_t next_sequence;
+    int32_t capacity;
+    int32_t count;
+    uint16_t next_packet_id;
+  } _internal;
+} az_iot_inflight_window;
+
+/**
+ * @brief Initializes an #az_iot_inflight_window.
+ *
+ * @param[out] window The #az_iot_inflight_window to initialize.
+ * @param[in] publishes The buffer holding the window slots. It must remain valid for the lifetime
+ * of \p window.
+ * @param[in] capacity The number of elements in \p publishes, which is the largest number of
+ * messages awaiting their PUBACK. Must be a power of two, no larger than 32768.
+ * @param[in] timeout The time, in the application's clock units, to wait for a PUBACK before
+ * publishing a message again.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The window was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_inflight_window_init(
+    az_iot_inflight_window* window,
+    az_iot_inflight_publish* publishes,
+    int32_t capacity,
+    int64_t timeout);
+
+/**
+ * @brief Gets the number of messages awaiting their PUBACK in an #az_iot_inflight_window.
+ *
+ * @param[in] window The #az_iot_inflight_window to use for this call.
+ * @return The number of messages in flight.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_iot_inflight_window_count(az_iot_inflight_window const* window)
+{
+  return window->_internal.count;
+}
+
+/**
+ * @brief Checks whether an #az_iot_inflight_window can't take another message until a PUBACK
+ * arrives.
+ *
+ * @param[in] window The #az_iot_inflight_window to use for this call.
+ * @return `true` if the window is full.
+ */
+AZ_NODISCARD AZ_INLINE bool az_iot_inflight_window_is_full(az_iot_inflight_window const* window)
+{
+  return window->_internal.count == window->_internal.capacity;
+}
+
+/**
+ * @brief Starts tracking a message, giving back the packet identifier to publish it with.
+ *
+ * @param[in,out] window The #az_iot_inflight_window to use for this call.
+ * @param[in] context __[nullable]__ The application's data for the message, given back when it is
+ * acknowledged or has to be published again.
+ * @param[in] now The current time, in the application's clock units.
+ * @param[out] out_packet_id The MQTT packet identifier to publish the message with.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The message is tracked.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The window is full.
+ */
+AZ_NODISCARD az_result az_iot_inflight_window_add(
+    az_iot_inflight_window* window,
+    void* context,
+    int64_t now,
+    uint16_t* out_packet_id);
+
+/**
+ * @brief Retires the message a received PUBACK belongs to.
+ *
+ * @param[in,out] window The #az_iot_inflight_window to use for this call.
+ * @param[in] packet_id The packet identifier of the PUBACK.
+ * @param[out] out_publish __[nullable]__ If successful, contains the acknowledged message.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The message was acknowledged and is no longer tracked.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND \p packet_id isn't in flight, as for a duplicate PUBACK.
+ */
+AZ_NODISCARD az_result az_iot_inflight_window_acknowledge(
+    az_iot_inflight_window* window,
+    uint16_t packet_id,
+    az_iot_inflight_publish* out_publish);
+
+/**
+ * @brief Gets the earliest message whose PUBACK didn't arrive in time, to publish it again.
+ *
+ * @details Call repeatedly until it returns #AZ_ERROR_ITEM_NOT_FOUND to get all the messages to
+ * publish again, in the order they were added. Each one is then given another timeout. Publish it
+ * with the same packet identifier, and the DUP flag set.
+ *
+ * @param[in,out] window The #az_iot_inflight_window to use for this call.
+ * @param[in] now The current time, in the application's clock units.
+ * @param[out] out_publish The message to publish again.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK A message is to be published again.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND No message timed out.
+ */
+AZ_NODISCARD az_result az_iot_inflight_window_get_expired(
+    az_iot_inflight_window* window,
+    int64_t now,
+    az_iot_inflight_publish* out_publish);
+
+/**
+ * @brief Makes all the messages in flight due to be published again, as MQTT requires after
+ * reconnecting without a clean session.
+ *
+ * @param[in,out] window The #az_iot_inflight_window to use for this call.
+ */
+void az_iot_inflight_window_expire_all(az_iot_inflight_window* window);
+
+/**
+ * @brief Gets the earliest time at which a message will have to be published again.
+ *
+ * @param[in] window The #az_iot_inflight_window to use for this call.
+ * @param[out] out_deadline The earliest deadline, in the application's clock units.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The deadline was returned.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND No message is in flight.
+ */
+AZ_NODISCARD az_result az_iot_inflight_window_get_next_deadline(
+    az_iot_inflight_window const* window,
+    int64_t* out_deadline);
+
+/*
+ *
+ * Telemetry aggregation
+ *
+ */
+
+/**
+ * @brief The statistics of the values of a telemetry sensor over a window of time, sent as one
+ * telemetry message instead of one message per value.
+ *
+ * @details The count, minimum, maximum and mean of the values are kept as they are added, along
+ * with, when the application provides the room for it, a uniform random sample of the values, kept
+ * with reservoir sampling. Once the window elapses, the application writes the statistics into its
+ * telemetry message with az_iot_aggregator_append_json(), and resets the aggregator for the next
+ * window.
+ */
+typedef struct
+{
+  struct
+  {
+    double* samples;
+    int64_t window_length;
+    int64_t window_start;
+    double minimum;
+    double maximum;
+    double sum;
+    int32_t sample_capacity;
+    int32_t count;
+    uint32_t random_state;
+  } _internal;
+} az_iot_aggregator;
+
+/**
+ * @brief Initializes an #az_iot_aggregator.
+ *
+ * @param[out] aggregator The #az_iot_aggregator to initialize.
+ * @param[in] samples __[nullable]__ The buffer holding the sample of the values. It must remain
+ * valid for the lifetime of \p aggregator.
+ * @param[in] sample_capacity The number of elements in \p samples, which is the largest number of
+ * values in the sample, or 0 to only keep the statistics.
+ * @param[in] window_length The length of the windows, in the application's clock units.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The aggregator was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_aggregator_init(
+    az_iot_aggregator* aggregator,
+    double* samples,
+    int32_t sample_capacity,
+    int64_t window_length);
+
+/**
+ * @brief Adds a value to the window of an #az_iot_aggregator, starting the window with the first
+ * value.
+ *
+ * @param[in,out] aggregator The #az_iot_aggregator to use for this call.
+ * @param[in] value The value read from the sensor.
+ * @param[in] now The current time, in the application's clock units.
+ */
+void az_iot_aggregator_add(az_iot_aggregator* aggregator, double value, int64_t now);
+
+/**
+ * @brief Checks whether the window of an #az_iot_aggregator elapsed, and its statistics are to be
+ * sent.
+ *
+ * @param[in] aggregator The #az_iot_aggregator to use for this call.
+ * @param[in] now The current time, in the application's clock units.
+ * @return `true` if a value was added, and the window length passed since the first one.
+ */
+AZ_NODISCARD AZ_INLINE bool
+az_iot_aggregator_is_window_elapsed(az_iot_aggregator const* aggregator, int64_t now)
+{
+  return aggregator->_internal.count > 0
+      && now - aggregator->_internal.window_start >= aggregator->_internal.window_length;
+}
+
+/**
+ * @brief Gets the number of values added to the window of an #az_iot_aggregator.
+ *
+ * @param[in] aggregator The #az_iot_aggregator to use for this call.
+ * @return The number of values in the window.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_iot_aggregator_get_count(az_iot_aggregator const* aggregator)
+{
+  return aggregator->_internal.count;
+}
+
+/**
+ * @brief Gets the smallest value added to the window of an #az_iot_aggregator.
+ *
+ * @param[in] aggregator The #az_iot_aggregator to use for this call, with at least one value.
+ * @return The smallest value in the window.
+ */
+AZ_NODISCARD AZ_INLINE double az_iot_aggregator_get_minimum(az_iot_aggregator const* aggregator)
+{
+  return aggregator->_internal.minimum;
+}
+
+/**
+ * @brief Gets the largest value added to the window of an #az_iot_aggregator.
+ *
+ * @param[in] aggregator The #az_iot_aggregator to use for this call, with at least one value.
+ * @return The largest value in the window.
+ */
+AZ_NODISCARD AZ_INLINE double az_iot_aggregator_get_maximum(az_iot_aggregator const* aggregator)
+{
+  return aggregator->_internal.maximum;
+}
+
+/**
+ * @brief Gets the mean of the values added to the window of an #az_iot_aggregator.
+ *
+ * @param[in] aggregator The #az_iot_aggregator to use for this call, with at least one value.
+ * @return The mean of the values in the window.
+ */
+AZ_NODISCARD AZ_INLINE double az_iot_aggregator_get_mean(az_iot_aggregator const* aggregator)
+{
+  return aggregator->_internal.sum / aggregator->_internal.count;
+}
+
+/**
+ * @brief Appends the statistics of the window of an #az_iot_aggregator as a JSON object, such as
+ * `{"count":120,"min":20.5,"max":23.25,"mean":21.75,"samples":[21.5,22.75]}`.
+ *
+ * @param[in] aggregator The #az_iot_aggregator to use for this call, with at least one value.
+ * @param[in,out] ref_json_writer The #az_json_writer to append the object to, as a value.
+ * @param[in] fractional_digits The number of digits written after the decimal point of the values,
+ * as for az_json_writer_append_double().
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The statistics were appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer of the \p ref_json_writer is too small.
+ *
+ * @remarks The `samples` array is only written when the aggregator keeps a sample, in no particular
+ * order.
+ */
+AZ_NODISCARD az_result az_iot_aggregator_append_json(
+    az_iot_aggregator const* aggregator,
+    az_json_writer* ref_json_writer,
+    int32_t fractional_digits);
+
+/**
+ * @brief Empties the window of an #az_iot_aggregator, the next value added starting a new one.
+ *
+ * @param[in,out] aggregator The #az_iot_aggregator to use for this call.
+ */
+AZ_INLINE void az_iot_aggregator_reset(az_iot_aggregator* aggregator)
+{
+  aggregator->_internal.count = 0;
+}
+
+/**
+ * @brief A filter dropping the readings of a slowly changing sensor which are within a dead band
+ * around the last reading sent, so that only meaningful changes are sent as telemetry.
+ */
+typedef struct
+{
+  struct
+  {
+    double dead_band;
+    double last_sent_value;
+    int64_t max_interval;
+    int64_t last_sent_time;
+    bool has_sent;
+  } _internal;
+} az_iot_dead_band_filter;
+
+/**
+ * @brief Initializes an #az_iot_dead_band_filter.
+ *
+ * @param[out] filter The #az_iot_dead_band_filter to initialize.
+ * @param[in] dead_band How much a reading must differ from the last reading sent to be sent.
+ * @param[in] max_interval The longest time without sending a reading, after which a reading is sent
+ * even if it didn't change, in the application's clock units, or 0 for no limit.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The filter was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_dead_band_filter_init(
+    az_iot_dead_band_filter* filter,
+    double dead_band,
+    int64_t max_interval);
+
+/**
+ * @brief Checks whether a reading is to be sent, which makes it the last reading sent if it is.
+ *
+ * @param[in,out] filter The #az_iot_dead_band_filter to use for this call.
+ * @param[in] value The reading of the sensor.
+ * @param[in] now The current time, in the application's clock units.
+ * @return `true` if \p value is the first reading, differs from the last reading sent by more than
+ * the dead band, or the longest time without sending a reading passed.
+ */
+AZ_NODISCARD bool
+az_iot_dead_band_filter_should_send(az_iot_dead_band_filter* filter, double value, int64_t now);
+
+/*
+ *
+ * Publish scheduling
+ *
+ */
+
+/**
+ * @brief The classes of messages an #az_iot_publish_scheduler groups, each with its own latency
+ * budget.
+ */
+typedef enum
+{
+  /// Telemetry messages, including telemetry batches and the messages of a store-and-forward
+  /// queue.
+  AZ_IOT_PUBLISH_CLASS_TELEMETRY = 0,
+
+  /// Reported properties, including reported-properties batches.
+  AZ_IOT_PUBLISH_CLASS_REPORTED_PROPERTIES = 1,
+
+  /// Twin document requests, whose response the application waits for.
+  AZ_IOT_PUBLISH_CLASS_TWIN_REQUEST = 2,
+} az_iot_publish_class;
+
+/**
+ * @brief The latency budgets of an #az_iot_publish_scheduler, in milliseconds: how long a message
+ * of each class can wait for the next transmit window.
+ */
+typedef struct
+{
+  /// The latency budget of #AZ_IOT_PUBLISH_CLASS_TELEMETRY messages.
+  int32_t telemetry_latency_msec;
+
+  /// The latency budget of #AZ_IOT_PUBLISH_CLASS_REPORTED_PROPERTIES messages.
+  int32_t reported_properties_latency_msec;
+
+  /// The latency budget of #AZ_IOT_PUBLISH_CLASS_TWIN_REQUEST messages.
+  int32_t twin_request_latency_msec;
+} az_iot_publish_scheduler_options;
+
+/**
+ * @brief Gets the default #az_iot_publish_scheduler_options: telemetry waits up to a minute,
+ * reported properties up to 10 seconds, and twin requests are sent right away.
+ *
+ * @return #az_iot_publish_scheduler_options.
+ */
+AZ_NODISCARD az_iot_publish_scheduler_options az_iot_publish_scheduler_options_default();
+
+/**
+ * @brief Groups the messages a battery-powered device publishes into transmit windows, so that the
+ * radio wakes once per window rather than once per message.
+ *
+ * @details The application keeps its pending messages in its telemetry batch, reported-properties
+ * batch or store-and-forward queue, and tells the scheduler about each one with
+ * #az_iot_publish_scheduler_add(). The next window opens at
+ * #az_iot_publish_scheduler_get_deadline(), when the message with the least remaining latency
+ * budget is due: the application sleeps until then, wakes the radio, publishes every pending
+ * message whatever its class, and calls
+ * #az_iot_publish_scheduler_complete_window(). When the radio is awake anyway, such as when a
+ * batch is full or a cloud-to-device message arrived, publishing early and completing the window
+ * saves the next wake-up.
+ *
+ * Like #az_iot_connection, the scheduler performs no I/O and keeps no timer.
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_publish_scheduler_options options;
+    int64_t deadline;
+    int32_t pending_count[3];
+  } _internal;
+} az_iot_publish_scheduler;
+
+/**
+ * @brief Initializes an #az_iot_publish_scheduler, with no pending message.
+ *
+ * @param[out] scheduler The #az_iot_publish_scheduler to initialize.
+ * @param[in] options __[nullable]__ A reference to an #az_iot_publish_scheduler_options structure.
+ * If `NULL` is passed, the default options are used.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The scheduler was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_publish_scheduler_init(
+    az_iot_publish_scheduler* scheduler,
+    az_iot_publish_scheduler_options const* options);
+
+/**
+ * @brief Records a message waiting for the next transmit window, which opens no later than the
+ * latency budget of its class from now.
+ *
+ * @param[in,out] scheduler The #az_iot_publish_scheduler to use for this call.
+ * @param[in] publish_class The #az_iot_publish_class of the message.
+ * @param[in] now_msec The current time, in milliseconds.
+ */
+void az_iot_publish_scheduler_add(
+    az_iot_publish_scheduler* scheduler,
+    az_iot_publish_class publish_class,
+    int64_t now_msec);
+
+/**
+ * @brief Gets the time at which the next transmit window opens.
+ *
+ * @param[in] scheduler The #az_iot_publish_scheduler to use for this call.
+ * @return The time in milliseconds, or `INT64_MAX` when no message is pending.
+ */
+AZ_NODISCARD AZ_INLINE int64_t
+az_iot_publish_scheduler_get_deadline(az_iot_publish_scheduler const* scheduler)
+{
+  return scheduler->_internal.deadline;
+}
+
+/**
+ * @brief Checks whether the next transmit window is open, and the pending messages are to be
+ * published.
+ *
+ * @param[in] scheduler The #az_iot_publish_scheduler to use for this call.
+ * @param[in] now_msec The current time, in milliseconds.
+ * @return `true` if a message is pending and the deadline was reached.
+ */
+AZ_NODISCARD AZ_INLINE bool
+az_iot_publish_scheduler_is_window_open(az_iot_publish_scheduler const* scheduler, int64_t now_msec)
+{
+  return now_msec >= scheduler->_internal.deadline;
+}
+
+/**
+ * @brief Gets the number of messages of a class waiting for the next transmit window.
+ *
+ * @param[in] scheduler The #az_iot_publish_scheduler to use for this call.
+ * @param[in] publish_class The #az_iot_publish_class of the messages.
+ * @return The number of pending messages.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_iot_publish_scheduler_get_pending_count(
+    az_iot_publish_scheduler const* scheduler,
+    az_iot_publish_class publish_class)
+{
+  return scheduler->_internal.pending_count[publish_class];
+}
+
+/**
+ * @brief Records that the pending messages were published, the next message added starting the
+ * wait for a new transmit window.
+ *
+ * @param[in,out] scheduler The #az_iot_publish_scheduler to use for this call.
+ */
+void az_iot_publish_scheduler_complete_window(az_iot_publish_scheduler* scheduler);
+
+/*
+ *
+ * Receive buffer pool
+ *
+ */
+
+/**
+ * @brief A buffer of an #az_iot_receive_pool, holding one received MQTT message.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span buffer;
+    az_span topic;
+    az_span payload;
+    int32_t reference_count;
+  } _internal;
+} az_iot_receive_buffer;
+
+/**
+ * @brief A pool of fixed-size buffers that received MQTT messages are read into, and that are
+ * handed to the parsers and handlers of the messages without copying them.
+ *
+ * @details The application's MQTT stack reads each PUBLISH packet into a buffer acquired with
+ * #az_iot_receive_pool_acquire(), and records where its topic and payload are with
+ * #az_iot_receive_buffer_set_message(). The topic is then parsed, and the payload handled, within
+ * the buffer. A handler which keeps the message after it returns, such as to pass it to another
+ * task, retains the buffer with #az_iot_receive_buffer_retain(), and releases it once done. The
+ * buffer goes back to the pool when its last reference is released.
+ *
+ * @remarks An #az_iot_receive_pool is not thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_receive_buffer* buffers;
+    int32_t buffer_count;
+  } _internal;
+} az_iot_receive_pool;
+
+/**
+ * @brief Initializes an #az_iot_receive_pool, dividing its storage into buffers of equal size.
+ *
+ * @param[out] pool The #az_iot_receive_pool to initialize.
+ * @param[out] buffers An array of \p buffer_count elements, to hold the state of each buffer.
+ * @param[in] buffer_count The number of buffers, which is the largest number of messages held at
+ * once.
+ * @param[in] storage The memory the buffers are carved from, each of
+ * `az_span_size(storage) / buffer_count` bytes.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The pool was initialized successfully.
+ *
+ * @remarks \p buffers and \p storage must outlive \p pool.
+ */
+AZ_NODISCARD az_result az_iot_receive_pool_init(
+    az_iot_receive_pool* pool,
+    az_iot_receive_buffer buffers[],
+    int32_t buffer_count,
+    az_span storage);
+
+/**
+ * @brief Takes a free buffer from the pool, with a single reference, to read a message into.
+ *
+ * @param[in,out] pool The #az_iot_receive_pool to use for this call.
+ * @param[out] out_buffer The acquired #az_iot_receive_buffer.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK A buffer was acquired.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE Every buffer is in use. The application can stop reading
+ * from the network until a buffer is released.
+ */
+AZ_NODISCARD az_result
+az_iot_receive_pool_acquire(az_iot_receive_pool* pool, az_iot_receive_buffer** out_buffer);
+
+/**
+ * @brief Gets the memory of a buffer, which the MQTT stack reads the message into.
+ *
+ * @param[in] buffer The #az_iot_receive_buffer to use for this call.
+ * @return The memory of the buffer.
+ */
+AZ_NODISCARD AZ_INLINE az_span az_iot_receive_buffer_get_span(az_iot_receive_buffer const* buffer)
+{
+  return buffer->_internal.buffer;
+}
+
+/**
+ * @brief Records where the topic and the payload of the message read into a buffer are.
+ *
+ * @param[in,out] buffer The #az_iot_receive_buffer to use for this call.
+ * @param[in] topic The topic of the message, within the memory of \p buffer.
+ * @param[in] payload The payload of the message, within the memory of \p buffer.
+ */
+void az_iot_receive_buffer_set_message(
+    az_iot_receive_buffer* buffer,
+    az_span topic,
+    az_span payload);
+
+/**
+ * @brief Gets the topic of the message held in a buffer.
+ *
+ * @param[in] buffer The #az_iot_receive_buffer to use for this call.
+ * @return The topic, within the memory of the buffer.
+ */
+AZ_NODISCARD AZ_INLINE az_span az_iot_receive_buffer_get_topic(az_iot_receive_buffer const* buffer)
+{
+  return buffer->_internal.topic;
+}
+
+/**
+ * @brief Gets the payload of the message held in a buffer.
+ *
+ * @param[in] buffer The #az_iot_receive_buffer to use for this call.
+ * @return The payload, within the memory of the buffer.
+ */
+AZ_NODISCARD AZ_INLINE az_span
+az_iot_receive_buffer_get_payload(az_iot_receive_buffer const* buffer)
+{
+  return buffer->_internal.payload;
+}
+
+/**
+ * @brief Adds a reference to a buffer, keeping its message past the release of the other
+ * references.
+ *
+ * @param[in,out] buffer The #az_iot_receive_buffer to use for this call, acquired and not yet
+ * released.
+ */
+AZ_INLINE void az_iot_receive_buffer_retain(az_iot_receive_buffer* buffer)
+{
+  buffer->_internal.reference_count++;
+}
+
+/**
+ * @brief Removes a reference to a buffer, giving it back to its pool once no reference is left.
+ *
+ * @param[in,out] buffer The #az_iot_receive_buffer to use for this call, acquired and not yet
+ * released.
+ * @return `true` if that was the last reference, and the buffer is free.
+ */
+AZ_INLINE bool az_iot_receive_buffer_release(az_iot_receive_buffer* buffer)
+{
+  return --buffer->_internal.reference_count == 0;
+}
+
+/**
+ * @brief Gets the number of buffers of a pool in use.
+ *
+ * @param[in] pool The #az_iot_receive_pool to use for this call.
+ * @return The number of buffers with a reference.
+ */
+AZ_NODISCARD int32_t az_iot_receive_pool_get_used_count(az_iot_receive_pool const* pool);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_IOT_CORE_H
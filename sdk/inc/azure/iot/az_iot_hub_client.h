@@ -17,6 +17,7 @@
 #ifndef _az_IOT_HUB_CLIENT_H
 #define _az_IOT_HUB_CLIENT_H
 
+#include <azure/core/az_json.h>
 #include <azure/core/az_result.h>
 #include <azure/core/az_span.h>
 #include <azure/iot/az_iot_common.h>
@@ -57,16 +58,46 @@ typedef struct
   az_span model_id;
 } az_iot_hub_client_options;
 
+/**
+ * @brief The IoT Hub hostname, user agent and model ID shared by many #az_iot_hub_client
+ * instances, such as the devices hosted by a gateway.
+ *
+ * @details When the SDK is built with `AZ_IOT_HUB_CLIENT_COMPACT`, the clients initialized with
+ * az_iot_hub_client_init_from_config() refer to the config instead of keeping their own copy of
+ * these spans, and are counted as its references until az_iot_hub_client_deinit().
+ */
+typedef struct
+{
+  struct
+  {
+    az_span iot_hub_hostname;
+    az_span user_agent;
+    az_span model_id;
+    int32_t reference_count;
+  } _internal;
+} az_iot_hub_client_config;
+
 /**
  * @brief Azure IoT Hub Client.
+ *
+ * @details When the SDK is built with `AZ_IOT_HUB_CLIENT_COMPACT`, the client only keeps its device
+ * and module IDs, and refers to an #az_iot_hub_client_config for the rest: 56 bytes instead of 96
+ * on 64-bit targets.
  */
 typedef struct
 {
   struct
   {
+#ifdef AZ_IOT_HUB_CLIENT_COMPACT
+    az_iot_hub_client_config* config;
+    az_span device_id;
+    az_span module_id;
+#else
     az_span iot_hub_hostname;
     az_span device_id;
     az_iot_hub_client_options options;
+#endif // AZ_IOT_HUB_CLIENT_COMPACT
+    az_span sas_resource_uri;
   } _internal;
 } az_iot_hub_client;
 
@@ -96,11 +127,74 @@ AZ_NODISCARD az_iot_hub_client_options az_iot_hub_client_options_default();
  * values.
  * @return An #az_result value indicating the result of the operation.
  */
+#ifndef AZ_IOT_HUB_CLIENT_COMPACT
 AZ_NODISCARD az_result az_iot_hub_client_init(
     az_iot_hub_client* client,
     az_span iot_hub_hostname,
     az_span device_id,
     az_iot_hub_client_options const* options);
+#endif // AZ_IOT_HUB_CLIENT_COMPACT
+
+/**
+ * @brief Initializes an #az_iot_hub_client_config.
+ *
+ * @param[out] config The #az_iot_hub_client_config to initialize.
+ * @param[in] iot_hub_hostname The IoT Hub Hostname.
+ * @param[in] options __[nullable]__ The user agent and model ID of the clients. If `NULL` is
+ * passed, the default options are used. The `module_id` of the options is not used, as each client
+ * is given its own.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The config was initialized successfully.
+ *
+ * @remark The spans of the config must remain valid while any client refers to it.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_config_init(
+    az_iot_hub_client_config* config,
+    az_span iot_hub_hostname,
+    az_iot_hub_client_options const* options);
+
+/**
+ * @brief Gets the number of clients referring to an #az_iot_hub_client_config.
+ *
+ * @param[in] config The #az_iot_hub_client_config to use for this call.
+ * @return The number of clients initialized with the config and not yet deinitialized. Always 0
+ * when the SDK isn't built with `AZ_IOT_HUB_CLIENT_COMPACT`, as the clients copy its settings.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+az_iot_hub_client_config_get_reference_count(az_iot_hub_client_config const* config)
+{
+  return config->_internal.reference_count;
+}
+
+/**
+ * @brief Initializes an Azure IoT Hub Client with the settings of a shared
+ * #az_iot_hub_client_config.
+ *
+ * @param[out] client The #az_iot_hub_client to use for this call.
+ * @param[in,out] config The #az_iot_hub_client_config of the client. When the SDK is built with
+ * `AZ_IOT_HUB_CLIENT_COMPACT`, it must remain valid until az_iot_hub_client_deinit() is called.
+ * @param[in] device_id The Device ID, percent-encoded as for az_iot_hub_client_init().
+ * @param[in] module_id The module name, or #AZ_SPAN_EMPTY if a device identity is used.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The client was initialized successfully.
+ *
+ * @remark The reference count of \p config isn't thread-safe: clients sharing a config must be
+ * initialized and deinitialized from one thread, or under the application's lock.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_init_from_config(
+    az_iot_hub_client* client,
+    az_iot_hub_client_config* config,
+    az_span device_id,
+    az_span module_id);
+
+/**
+ * @brief Releases the #az_iot_hub_client_config an #az_iot_hub_client was initialized with, if
+ * it refers to one.
+ *
+ * @param[in,out] client The #az_iot_hub_client to use for this call. It must be initialized again
+ * before being used.
+ */
+void az_iot_hub_client_deinit(az_iot_hub_client* client);
 
 /**
  * @brief The HTTP URI Path necessary when connecting to IoT Hub using WebSockets.
@@ -134,6 +228,9 @@ AZ_NODISCARD az_result az_iot_hub_client_init(
  * successful, contains a null-terminated string with the user name that needs to be passed to the
  * MQTT client.
  * @param[in] mqtt_user_name_size The size, in bytes of \p mqtt_user_name.
+ * Use a `NULL` \p mqtt_user_name of size 0 to only measure the string:
+ * \p out_mqtt_user_name_length, which can't be `NULL` then, is set to its length, and nothing is
+ * written.
  * @param[out] out_mqtt_user_name_length __[nullable]__ Contains the string length, in bytes, of \p
  * mqtt_user_name. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -162,6 +259,9 @@ AZ_NODISCARD az_result az_iot_hub_client_get_user_name(
  * successful, contains a null-terminated string with the client ID that needs to be passed to the
  * MQTT client.
  * @param[in] mqtt_client_id_size The size, in bytes of \p mqtt_client_id.
+ * Use a `NULL` \p mqtt_client_id of size 0 to only measure the string:
+ * \p out_mqtt_client_id_length, which can't be `NULL` then, is set to its length, and nothing is
+ * written.
  * @param[out] out_mqtt_client_id_length __[nullable]__ Contains the string length, in bytes, of
  * \p mqtt_client_id. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -181,6 +281,26 @@ AZ_NODISCARD az_result az_iot_hub_client_get_client_id(
  *   Authentication is used.
  */
 
+/**
+ * @brief URL-encodes the resource URI of the SAS tokens once, for the client to copy it into every
+ * SAS signature and password from then on.
+ * @details Otherwise, az_iot_hub_client_sas_get_signature() and
+ * az_iot_hub_client_sas_get_password() URL-encode the IoT Hub hostname, device ID and module ID for
+ * every token. This is worthwhile when refreshing the SAS tokens of many clients.
+ *
+ * @param[in,out] client The #az_iot_hub_client to use for this call. Calling
+ * az_iot_hub_client_init() again clears the cached resource URI.
+ * @param[in] resource_uri_buffer A buffer with sufficient capacity to hold the URL-encoded resource
+ * URI, which must outlive the \p client.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The resource URI is cached.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p resource_uri_buffer is too small, in which case the
+ * resource URI keeps being encoded for every token.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_sas_cache_resource_uri(
+    az_iot_hub_client* client,
+    az_span resource_uri_buffer);
+
 /**
  * @brief Gets the Shared Access clear-text signature.
  * @details The application must obtain a valid clear-text signature using this API, sign it using
@@ -203,18 +323,22 @@ AZ_NODISCARD az_result az_iot_hub_client_get_client_id(
  * az_span signature = AZ_SPAN_FROM_STR(signature_str);
  * az_iot_hub_client_sas_get_signature(&client, expiration_time_in_seconds, signature, &signature);
  *
- * char decoded_sas_key[128] = { 0 };
- * base64_decode(base64_encoded_sas_key, decoded_sas_key);
+ * uint8_t decoded_sas_key[64];
+ * int32_t decoded_sas_key_size;
+ * az_iot_base64_decode(AZ_SPAN_FROM_BUFFER(decoded_sas_key), base64_encoded_sas_key,
+ *   &decoded_sas_key_size);
  *
- * char signed_bytes[256] = { 0 };
- * hmac_256(az_span_ptr(signature), az_span_size(signature), decoded_sas_key, signed_bytes);
+ * az_iot_sas_key sas_key;
+ * az_iot_sas_key_init(&sas_key, az_span_create(decoded_sas_key, decoded_sas_key_size));
  *
- * char signed_bytes_base64_encoded[256] = { 0 };
- * base64_encode(signed_bytes, signed_bytes_base64_encoded);
+ * uint8_t signed_bytes_base64_encoded[AZ_IOT_BASE64_HMAC_SHA256_SIZE];
+ * az_span signed_signature;
+ * az_iot_sas_key_sign(&sas_key, signature, AZ_SPAN_FROM_BUFFER(signed_bytes_base64_encoded),
+ *   &signed_signature);
  *
  * char final_password[512] = { 0 };
  * az_iot_hub_client_sas_get_password(client, expiration_time_in_seconds,
- *   AZ_SPAN_FROM_STR(signed_bytes_base64_encoded), final_password, sizeof(final_password), NULL);
+ *   signed_signature, final_password, sizeof(final_password), NULL);
  *
  * mqtt_set_password(&mqtt_client, final_password);
  * @endcode
@@ -247,6 +371,8 @@ AZ_NODISCARD az_result az_iot_hub_client_sas_get_signature(
  * reasons we recommend using one key per device instead of using a global policy key.
  * @param[out] mqtt_password A char buffer with sufficient capacity to hold the MQTT password.
  * @param[in] mqtt_password_size The size, in bytes of \p mqtt_password.
+ * Use a `NULL` \p mqtt_password of size 0 to only measure the string: \p out_mqtt_password_length,
+ * which can't be `NULL` then, is set to its length, and nothing is written.
  * @param[out] out_mqtt_password_length __[nullable]__ Contains the string length, in bytes, of \p
  * mqtt_password. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -263,6 +389,44 @@ AZ_NODISCARD az_result az_iot_hub_client_sas_get_password(
     size_t mqtt_password_size,
     size_t* out_mqtt_password_length);
 
+/**
+ * @brief Gets the MQTT passwords of many devices at once, such as for a protocol gateway or a
+ * device simulator.
+ *
+ * @details Each password is the one az_iot_hub_client_sas_get_password() gets for a client of the
+ * device without a module ID, once its signature is signed with \p sas_key. The key schedule of \p
+ * sas_key is computed once for all the devices, and the passwords are written one after the other
+ * into \p passwords_buffer, each followed by a null-terminator.
+ *
+ * @param[in] iot_hub_hostname The IoT Hub Hostname.
+ * @param[in] device_ids The IDs of the devices.
+ * @param[in] device_ids_length The number of elements in \p device_ids.
+ * @param[in] token_expiration_epoch_time The time, in seconds, from 1/1/1970.
+ * @param[in] sas_key The #az_iot_sas_key the tokens are signed with: either the key of a shared
+ * access policy, or the group key the keys of the devices are derived from.
+ * @param[in] derive_device_keys `true` if the key of each device is the HMAC-SHA256 of its ID with
+ * \p sas_key, as for the enrollment groups of the Device Provisioning Service. `false` to sign all
+ * the tokens with \p sas_key.
+ * @param[in] key_name The name of the shared access policy of \p sas_key, or #AZ_SPAN_EMPTY.
+ * @param[out] passwords_buffer A buffer with sufficient capacity to hold all the passwords.
+ * @param[out] out_passwords An array of \p device_ids_length spans, set to the password of each
+ * device within \p passwords_buffer, not including its null-terminator.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The passwords were generated successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p passwords_buffer is too small. The passwords which were
+ * generated before it ran out of space are set in \p out_passwords.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_sas_get_passwords(
+    az_span iot_hub_hostname,
+    az_span const* device_ids,
+    int32_t device_ids_length,
+    uint64_t token_expiration_epoch_time,
+    az_iot_sas_key const* sas_key,
+    bool derive_device_keys,
+    az_span key_name,
+    az_span passwords_buffer,
+    az_span* out_passwords);
+
 /*
  *
  * Telemetry APIs
@@ -278,6 +442,8 @@ AZ_NODISCARD az_result az_iot_hub_client_sas_get_password(
  * @param[out] mqtt_topic A buffer with sufficient capacity to hold the MQTT topic. If successful,
  * contains a null-terminated string with the topic that needs to be passed to the MQTT client.
  * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * Use a `NULL` \p mqtt_topic of size 0 to only measure the string: \p out_mqtt_topic_length, which
+ * can't be `NULL` then, is set to its length, and nothing is written.
  * @param[out] out_mqtt_topic_length __[nullable]__ Contains the string length, in bytes, of \p
  * mqtt_topic. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -290,6 +456,306 @@ AZ_NODISCARD az_result az_iot_hub_client_telemetry_get_publish_topic(
     size_t mqtt_topic_size,
     size_t* out_mqtt_topic_length);
 
+/**
+ * @brief Writes the part of the telemetry MQTT topic which doesn't change between messages:
+ * `devices/{device_id}[/modules/{module_id}]/messages/events/`.
+ *
+ * @details Call this once per client, keeping \p mqtt_topic around for the lifetime of the
+ * client. For each message, #az_iot_hub_client_telemetry_set_publish_topic_properties() then only
+ * appends the message properties after the prefix, instead of rebuilding the whole topic.
+ *
+ * @param[in] client The #az_iot_hub_client to use for this call.
+ * @param[out] mqtt_topic A buffer with sufficient capacity to hold the complete MQTT topic,
+ * including the properties of any message. If successful, contains a null-terminated string with
+ * the topic for a message without properties.
+ * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * Use a `NULL` \p mqtt_topic of size 0 to only measure the string: \p out_mqtt_topic_prefix_length,
+ * which can't be `NULL` then, is set to its length, and nothing is written.
+ * @param[out] out_mqtt_topic_prefix_length Contains the string length, in bytes, of the prefix
+ * written to \p mqtt_topic.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The topic prefix was written successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p mqtt_topic is too small to hold the prefix.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_get_publish_topic_prefix(
+    az_iot_hub_client const* client,
+    char* mqtt_topic,
+    size_t mqtt_topic_size,
+    size_t* out_mqtt_topic_prefix_length);
+
+/**
+ * @brief Completes a telemetry MQTT topic previously started by
+ * #az_iot_hub_client_telemetry_get_publish_topic_prefix(), by writing the message properties after
+ * the prefix.
+ *
+ * @param[in] properties An optional #az_iot_message_properties object (can be NULL).
+ * @param[in,out] mqtt_topic The buffer passed to
+ * #az_iot_hub_client_telemetry_get_publish_topic_prefix(). If successful, contains a
+ * null-terminated string with the topic that needs to be passed to the MQTT client.
+ * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * @param[in] mqtt_topic_prefix_length The prefix length returned by
+ * #az_iot_hub_client_telemetry_get_publish_topic_prefix().
+ * @param[out] out_mqtt_topic_length __[nullable]__ Contains the string length, in bytes, of \p
+ * mqtt_topic. Can be `NULL`.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The topic was completed successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p mqtt_topic is too small to hold the properties. The
+ * prefix is left untouched.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_set_publish_topic_properties(
+    az_iot_message_properties const* properties,
+    char* mqtt_topic,
+    size_t mqtt_topic_size,
+    size_t mqtt_topic_prefix_length,
+    size_t* out_mqtt_topic_length);
+
+/**
+ * @brief Collects telemetry messages into the body of a single message, as a JSON array.
+ *
+ * @details Each message is one element of the array. Publish the batch on the topic from
+ * #az_iot_hub_client_telemetry_get_publish_topic(), with the properties set by
+ * #az_iot_hub_client_telemetry_batch_append_properties() so that IoT Hub routing can query the
+ * body.
+ */
+typedef struct
+{
+  struct
+  {
+    az_json_writer writer;
+    az_span buffer;
+    int32_t max_count;
+    int32_t count;
+    int64_t max_delay;
+    int64_t first_message_time;
+  } _internal;
+} az_iot_hub_client_telemetry_batch;
+
+/**
+ * @brief Initializes an #az_iot_hub_client_telemetry_batch.
+ *
+ * @param[out] batch The #az_iot_hub_client_telemetry_batch to initialize.
+ * @param[in] buffer The buffer the batch body is written to. Its size is the largest body sent,
+ * which must be within the IoT Hub message size limit. It must remain valid for the lifetime of
+ * \p batch.
+ * @param[in] max_count The largest number of messages in a batch.
+ * @param[in] max_delay The longest time, in the application's clock units, a message may wait in
+ * the batch.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The batch was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_batch_init(
+    az_iot_hub_client_telemetry_batch* batch,
+    az_span buffer,
+    int32_t max_count,
+    int64_t max_delay);
+
+/**
+ * @brief Adds a telemetry message to the batch.
+ *
+ * @param[in,out] batch The #az_iot_hub_client_telemetry_batch to use for this call.
+ * @param[in] json_message The JSON text of the message, such as written by an #az_json_writer.
+ * @param[in] now The current time, in the same units as the \p max_delay of the batch.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The message was added.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The batch is full. Send it, clear it, and add the message
+ * again.
+ * @retval Other \p json_message isn't valid JSON text. The batch is left unchanged.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_batch_append(
+    az_iot_hub_client_telemetry_batch* batch,
+    az_span json_message,
+    int64_t now);
+
+/**
+ * @brief Checks whether the batch should be sent.
+ *
+ * @param[in] batch The #az_iot_hub_client_telemetry_batch to use for this call.
+ * @param[in] now The current time, in the same units as the \p max_delay of the batch.
+ * @return `true` if the batch has messages and either the oldest has waited for the maximum delay,
+ * or it holds the maximum number of messages.
+ */
+AZ_NODISCARD bool az_iot_hub_client_telemetry_batch_should_flush(
+    az_iot_hub_client_telemetry_batch const* batch,
+    int64_t now);
+
+/**
+ * @brief Gets the number of messages in the batch.
+ *
+ * @param[in] batch The #az_iot_hub_client_telemetry_batch to use for this call.
+ * @return The number of messages.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+az_iot_hub_client_telemetry_batch_count(az_iot_hub_client_telemetry_batch const* batch)
+{
+  return batch->_internal.count;
+}
+
+/**
+ * @brief Gets the body of the batch, to be published.
+ *
+ * @param[in,out] batch The #az_iot_hub_client_telemetry_batch to use for this call.
+ * @return The JSON array of the messages in the batch, within the batch buffer. It remains valid
+ * until the batch is changed.
+ */
+AZ_NODISCARD az_span
+az_iot_hub_client_telemetry_batch_get_payload(az_iot_hub_client_telemetry_batch* batch);
+
+/**
+ * @brief Removes all the messages from the batch, once it was sent.
+ *
+ * @param[in,out] batch The #az_iot_hub_client_telemetry_batch to use for this call.
+ */
+void az_iot_hub_client_telemetry_batch_clear(az_iot_hub_client_telemetry_batch* batch);
+
+/**
+ * @brief Appends the content type (`application/json`) and content encoding (`utf-8`) of a batch
+ * body to the properties of the message carrying it.
+ *
+ * @param[in,out] properties The #az_iot_message_properties of the batch message.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The properties were appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE There was not enough space to append the properties.
+ */
+AZ_NODISCARD az_result
+az_iot_hub_client_telemetry_batch_append_properties(az_iot_message_properties* properties);
+
+/**
+ * @brief Appends the content type (`application/cbor`) of a body written with #az_cbor_writer to
+ * the properties of the message carrying it.
+ *
+ * @param[in,out] properties The #az_iot_message_properties of the telemetry message.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The property was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE There was not enough space to append the property.
+ *
+ * @remarks IoT Hub routing can only query the body of JSON messages, so CBOR telemetry is routed on
+ * its properties alone.
+ */
+AZ_NODISCARD az_result
+az_iot_hub_client_telemetry_append_cbor_properties(az_iot_message_properties* properties);
+
+/**
+ * @brief Keeps telemetry messages, with their MQTT topic, while the device is offline.
+ *
+ * @details The messages are kept in a ring within a storage buffer that the application keeps
+ * across restarts, such as a memory-mapped file on POSIX or a RAM mirror of flash sectors on a
+ * microcontroller. Once #az_iot_hub_client_telemetry_queue_append() or
+ * #az_iot_hub_client_telemetry_queue_remove() returns, the application writes the storage back
+ * (for instance with `msync()`). Each message and the queue state are checked with a CRC-32, so a
+ * write interrupted by a power loss only loses the message being written.
+ *
+ * Once connected, the application drains the queue in batches: it reads up to the capacity of its
+ * #az_iot_inflight_window with an #az_iot_hub_client_telemetry_queue_cursor, publishes them, and
+ * removes the batch once every message was acknowledged.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span storage;
+    uint32_t generation;
+    int32_t head;
+    int32_t tail;
+    int32_t count;
+  } _internal;
+} az_iot_hub_client_telemetry_queue;
+
+/**
+ * @brief Reads the messages of an #az_iot_hub_client_telemetry_queue, oldest first, without
+ * removing them.
+ */
+typedef struct
+{
+  struct
+  {
+    int32_t offset;
+    int32_t remaining;
+  } _internal;
+} az_iot_hub_client_telemetry_queue_cursor;
+
+/**
+ * @brief Initializes an #az_iot_hub_client_telemetry_queue, restoring the messages kept in its
+ * storage.
+ *
+ * @param[out] queue The #az_iot_hub_client_telemetry_queue to initialize.
+ * @param[in,out] storage The storage buffer of the queue. It must remain valid for the lifetime of
+ * \p queue. If it doesn't hold a queue, such as the first time it is used, the queue starts empty.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The queue was initialized successfully.
+ */
+AZ_NODISCARD az_result
+az_iot_hub_client_telemetry_queue_init(az_iot_hub_client_telemetry_queue* queue, az_span storage);
+
+/**
+ * @brief Adds a telemetry message to the queue.
+ *
+ * @param[in,out] queue The #az_iot_hub_client_telemetry_queue to use for this call.
+ * @param[in] topic The MQTT topic the message is published on, such as from
+ * #az_iot_hub_client_telemetry_get_publish_topic().
+ * @param[in] payload The payload of the message.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The message was added.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The storage is full. The queue is left unchanged.
+ *
+ * @remarks A message takes 10 bytes of the storage besides its topic and payload. The queue state
+ * takes 40 bytes, and 6 more are kept free after the messages, so the topic and payload of the
+ * largest message that fits in an empty queue take the size of the storage less 56 bytes.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_queue_append(
+    az_iot_hub_client_telemetry_queue* queue,
+    az_span topic,
+    az_span payload);
+
+/**
+ * @brief Gets the number of messages in the queue.
+ *
+ * @param[in] queue The #az_iot_hub_client_telemetry_queue to use for this call.
+ * @return The number of messages.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+az_iot_hub_client_telemetry_queue_count(az_iot_hub_client_telemetry_queue const* queue)
+{
+  return queue->_internal.count;
+}
+
+/**
+ * @brief Initializes an #az_iot_hub_client_telemetry_queue_cursor to read from the oldest message.
+ *
+ * @param[in] queue The #az_iot_hub_client_telemetry_queue to read.
+ * @param[out] cursor The #az_iot_hub_client_telemetry_queue_cursor to initialize. It is invalidated
+ * by #az_iot_hub_client_telemetry_queue_remove().
+ */
+void az_iot_hub_client_telemetry_queue_cursor_init(
+    az_iot_hub_client_telemetry_queue const* queue,
+    az_iot_hub_client_telemetry_queue_cursor* cursor);
+
+/**
+ * @brief Reads the next message of the queue.
+ *
+ * @param[in] queue The #az_iot_hub_client_telemetry_queue to read.
+ * @param[in,out] cursor The #az_iot_hub_client_telemetry_queue_cursor to use for this call.
+ * @param[out] out_topic The MQTT topic of the message, within the queue storage.
+ * @param[out] out_payload The payload of the message, within the queue storage.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The message was read.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND Every message was read.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_queue_read(
+    az_iot_hub_client_telemetry_queue const* queue,
+    az_iot_hub_client_telemetry_queue_cursor* cursor,
+    az_span* out_topic,
+    az_span* out_payload);
+
+/**
+ * @brief Removes the oldest messages from the queue, once they were acknowledged.
+ *
+ * @param[in,out] queue The #az_iot_hub_client_telemetry_queue to use for this call.
+ * @param[in] count The number of messages to remove, at most the number in the queue.
+ */
+void az_iot_hub_client_telemetry_queue_remove(
+    az_iot_hub_client_telemetry_queue* queue,
+    int32_t count);
+
 /*
  *
  * Cloud-to-device (C2D) APIs
@@ -335,6 +801,31 @@ AZ_NODISCARD az_result az_iot_hub_client_c2d_parse_received_topic(
     az_span received_topic,
     az_iot_hub_client_c2d_request* out_request);
 
+/**
+ * @brief Same as #az_iot_hub_client_c2d_parse_received_topic(), also indexing the properties of
+ * the request so that each #az_iot_message_properties_find() on them doesn't parse the properties
+ * again.
+ *
+ * @param[in] client The #az_iot_hub_client to use for this call.
+ * @param[in] received_topic An #az_span containing the received topic.
+ * @param[in] index_entries An array of #az_iot_message_properties_index_entry that will hold the
+ * index, as for #az_iot_message_properties_set_index(). It must remain valid for as long as the
+ * properties of \p out_request are used.
+ * @param[in] index_entries_length The number of elements in \p index_entries.
+ * @param[out] out_request If the message is a C2D request, this will contain the
+ * #az_iot_hub_client_c2d_request, with indexed properties.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The topic is meant for this feature and the \p out_request was populated
+ * with relevant information.
+ * @retval #AZ_ERROR_IOT_TOPIC_NO_MATCH The topic does not match the expected format.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_c2d_parse_received_topic_indexed(
+    az_iot_hub_client const* client,
+    az_span received_topic,
+    az_iot_message_properties_index_entry* index_entries,
+    int32_t index_entries_length,
+    az_iot_hub_client_c2d_request* out_request);
+
 /*
  *
  * Methods APIs
@@ -386,6 +877,61 @@ AZ_NODISCARD az_result az_iot_hub_client_methods_parse_received_topic(
     az_span received_topic,
     az_iot_hub_client_method_request* out_request);
 
+/**
+ * @brief A table of the method names an application handles, built into a minimal perfect hash so
+ * that #az_iot_hub_client_method_table_find() compares a received name against a single candidate.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span const* names;
+    uint32_t* hashes;
+    int32_t* seeds;
+    int32_t* slots;
+    int32_t size;
+  } _internal;
+} az_iot_hub_client_method_table;
+
+/**
+ * @brief Initializes an #az_iot_hub_client_method_table, building the hash of its names.
+ *
+ * @param[out] table The #az_iot_hub_client_method_table to initialize.
+ * @param[in] names The method names the application handles, such as `component*command` names
+ * for Plug and Play commands.
+ * @param[out] hashes An array of \p size elements, to receive the hash of each name.
+ * @param[out] seeds An array of \p size elements, to receive the hash seeds.
+ * @param[out] slots An array of \p size elements, to receive the position of each name.
+ * @param[in] size The number of \p names.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The table was built successfully.
+ * @retval #AZ_ERROR_ARG A name appears more than once.
+ * @retval #AZ_ERROR_NOT_SUPPORTED Two different names have the same hash, so no perfect hash
+ * separates them.
+ *
+ * @remarks The \p names, \p hashes, \p seeds and \p slots arrays must outlive the table. A table of
+ * constant names only needs to be built once.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_method_table_init(
+    az_iot_hub_client_method_table* table,
+    az_span const names[],
+    uint32_t hashes[],
+    int32_t seeds[],
+    int32_t slots[],
+    int32_t size);
+
+/**
+ * @brief Finds a method name, such as the name of a received #az_iot_hub_client_method_request,
+ * within the table.
+ *
+ * @param[in] table The #az_iot_hub_client_method_table to use for this call.
+ * @param[in] name The method name to find.
+ * @return The index of \p name within the names of the table, or -1 if the application doesn't
+ * handle it.
+ */
+AZ_NODISCARD int32_t
+az_iot_hub_client_method_table_find(az_iot_hub_client_method_table const* table, az_span name);
+
 /**
  * @brief Gets the MQTT topic that must be used to respond to method requests.
  *
@@ -396,6 +942,8 @@ AZ_NODISCARD az_result az_iot_hub_client_methods_parse_received_topic(
  * @param[out] mqtt_topic A buffer with sufficient capacity to hold the MQTT topic. If successful,
  * contains a null-terminated string with the topic that needs to be passed to the MQTT client.
  * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * Use a `NULL` \p mqtt_topic of size 0 to only measure the string: \p out_mqtt_topic_length, which
+ * can't be `NULL` then, is set to its length, and nothing is written.
  * @param[out] out_mqtt_topic_length __[nullable]__ Contains the string length, in bytes, of \p
  * mqtt_topic. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -409,6 +957,49 @@ AZ_NODISCARD az_result az_iot_hub_client_methods_response_get_publish_topic(
     size_t mqtt_topic_size,
     size_t* out_mqtt_topic_length);
 
+/**
+ * @brief Same as #az_iot_hub_client_methods_response_get_publish_topic(), with a numeric request
+ * ID.
+ *
+ * @param[in] client The #az_iot_hub_client to use for this call.
+ * @param[in] request_id The request ID, as parsed by #az_iot_hub_client_parse_request_id() from
+ * the received #az_iot_hub_client_method_request request_id.
+ * @param[in] status A code that indicates the result of the method, as defined by the user.
+ * @param[out] mqtt_topic A buffer with sufficient capacity to hold the MQTT topic. If successful,
+ * contains a null-terminated string with the topic that needs to be passed to the MQTT client.
+ * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * Use a `NULL` \p mqtt_topic of size 0 to only measure the string: \p out_mqtt_topic_length, which
+ * can't be `NULL` then, is set to its length, and nothing is written.
+ * @param[out] out_mqtt_topic_length __[nullable]__ Contains the string length, in bytes, of \p
+ * mqtt_topic. Can be `NULL`.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The topic was retrieved successfully.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_methods_response_get_publish_topic_u64(
+    az_iot_hub_client const* client,
+    uint64_t request_id,
+    uint16_t status,
+    char* mqtt_topic,
+    size_t mqtt_topic_size,
+    size_t* out_mqtt_topic_length);
+
+/**
+ * @brief Parses a decimal request ID, as received in a #az_iot_hub_client_method_request or a
+ * #az_iot_hub_client_twin_response.
+ *
+ * @details Applications issuing numeric request IDs can correlate responses with an integer
+ * lookup instead of comparing strings.
+ *
+ * @param[in] request_id The request ID to parse.
+ * @param[out] out_request_id The parsed request ID.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The request ID was parsed successfully.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR \p request_id is not a decimal number that fits in a
+ * `uint64_t`.
+ */
+AZ_NODISCARD az_result
+az_iot_hub_client_parse_request_id(az_span request_id, uint64_t* out_request_id);
+
 /*
  *
  * Twin APIs
@@ -502,6 +1093,8 @@ AZ_NODISCARD az_result az_iot_hub_client_twin_parse_received_topic(
  * @param[out] mqtt_topic A buffer with sufficient capacity to hold the MQTT topic. If successful,
  * contains a null-terminated string with the topic that needs to be passed to the MQTT client.
  * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * Use a `NULL` \p mqtt_topic of size 0 to only measure the string: \p out_mqtt_topic_length, which
+ * can't be `NULL` then, is set to its length, and nothing is written.
  * @param[out] out_mqtt_topic_length __[nullable]__ Contains the string length, in bytes, of \p
  * mqtt_topic. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -514,6 +1107,32 @@ AZ_NODISCARD az_result az_iot_hub_client_twin_document_get_publish_topic(
     size_t mqtt_topic_size,
     size_t* out_mqtt_topic_length);
 
+/**
+ * @brief Same as #az_iot_hub_client_twin_document_get_publish_topic(), with a numeric request ID.
+ *
+ * @details The request ID is formatted in decimal straight into \p mqtt_topic, so applications
+ * keeping a counter don't need a separate buffer for it. Use #az_iot_hub_client_parse_request_id()
+ * to get the number back from the #az_iot_hub_client_twin_response request_id.
+ *
+ * @param[in] client The #az_iot_hub_client to use for this call.
+ * @param[in] request_id The request ID.
+ * @param[out] mqtt_topic A buffer with sufficient capacity to hold the MQTT topic. If successful,
+ * contains a null-terminated string with the topic that needs to be passed to the MQTT client.
+ * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * Use a `NULL` \p mqtt_topic of size 0 to only measure the string: \p out_mqtt_topic_length, which
+ * can't be `NULL` then, is set to its length, and nothing is written.
+ * @param[out] out_mqtt_topic_length __[nullable]__ Contains the string length, in bytes, of \p
+ * mqtt_topic. Can be `NULL`.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The topic was retrieved successfully.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_twin_document_get_publish_topic_u64(
+    az_iot_hub_client const* client,
+    uint64_t request_id,
+    char* mqtt_topic,
+    size_t mqtt_topic_size,
+    size_t* out_mqtt_topic_length);
+
 /**
  * @brief Gets the MQTT topic that must be used to submit a Twin PATCH request.
  * @note The payload of the MQTT publish message should contain a JSON document formatted according
@@ -524,6 +1143,8 @@ AZ_NODISCARD az_result az_iot_hub_client_twin_document_get_publish_topic(
  * @param[out] mqtt_topic A buffer with sufficient capacity to hold the MQTT topic. If successful,
  * contains a null-terminated string with the topic that needs to be passed to the MQTT client.
  * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * Use a `NULL` \p mqtt_topic of size 0 to only measure the string: \p out_mqtt_topic_length, which
+ * can't be `NULL` then, is set to its length, and nothing is written.
  * @param[out] out_mqtt_topic_length __[nullable]__ Contains the string length, in bytes, of \p
  * mqtt_topic. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -536,6 +1157,789 @@ AZ_NODISCARD az_result az_iot_hub_client_twin_patch_get_publish_topic(
     size_t mqtt_topic_size,
     size_t* out_mqtt_topic_length);
 
+/**
+ * @brief Same as #az_iot_hub_client_twin_patch_get_publish_topic(), with a numeric request ID.
+ *
+ * @details The request ID is formatted in decimal straight into \p mqtt_topic, so applications
+ * keeping a counter don't need a separate buffer for it. Use #az_iot_hub_client_parse_request_id()
+ * to get the number back from the #az_iot_hub_client_twin_response request_id.
+ *
+ * @param[in] client The #az_iot_hub_client to use for this call.
+ * @param[in] request_id The request ID.
+ * @param[out] mqtt_topic A buffer with sufficient capacity to hold the MQTT topic. If successful,
+ * contains a null-terminated string with the topic that needs to be passed to the MQTT client.
+ * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * Use a `NULL` \p mqtt_topic of size 0 to only measure the string: \p out_mqtt_topic_length, which
+ * can't be `NULL` then, is set to its length, and nothing is written.
+ * @param[out] out_mqtt_topic_length __[nullable]__ Contains the string length, in bytes, of \p
+ * mqtt_topic. Can be `NULL`.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The topic was retrieved successfully.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_twin_patch_get_publish_topic_u64(
+    az_iot_hub_client const* client,
+    uint64_t request_id,
+    char* mqtt_topic,
+    size_t mqtt_topic_size,
+    size_t* out_mqtt_topic_length);
+
+/**
+ * @brief Called by #az_iot_hub_client_twin_desired_apply() for a desired property whose value
+ * changed.
+ *
+ * @param[in] property_index The index of the property name in the #az_json_property_name_table
+ * the #az_iot_hub_client_twin_desired was initialized with.
+ * @param[in] property_value An #az_json_reader positioned on the property value, which the
+ * callback is free to read through.
+ * @param[in] version The `$version` of the desired properties being applied.
+ * @param[in] context The context passed to #az_iot_hub_client_twin_desired_init().
+ */
+typedef void (*az_iot_hub_client_twin_desired_property_fn)(
+    int32_t property_index,
+    az_json_reader* property_value,
+    int64_t version,
+    void* context);
+
+/**
+ * @brief Tracks the desired properties applied from twin GET responses and desired properties
+ * notifications, so each one is only handled when its value changes.
+ *
+ */
+typedef struct
+{
+  struct
+  {
+    az_json_property_name_table const* property_names;
+    uint32_t* value_hashes;
+    az_iot_hub_client_twin_desired_property_fn callback;
+    void* callback_context;
+    int64_t version;
+  } _internal;
+} az_iot_hub_client_twin_desired;
+
+/**
+ * @brief Initializes an #az_iot_hub_client_twin_desired.
+ *
+ * @param[out] twin The #az_iot_hub_client_twin_desired to initialize.
+ * @param[in] property_names The top-level desired properties to track. Components are tracked as a
+ * whole, like any other property.
+ * @param[in] value_hashes An array with one element per name in \p property_names, where a digest
+ * of the last value of each property is kept. It must remain valid for the lifetime of \p twin.
+ * @param[in] callback The #az_iot_hub_client_twin_desired_property_fn to call for each changed
+ * property.
+ * @param[in] context __[nullable]__ The context passed to \p callback.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The twin was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_twin_desired_init(
+    az_iot_hub_client_twin_desired* twin,
+    az_json_property_name_table const* property_names,
+    uint32_t value_hashes[],
+    az_iot_hub_client_twin_desired_property_fn callback,
+    void* context);
+
+/**
+ * @brief Gets the `$version` of the last desired properties applied, or -1 if none were.
+ *
+ * @param[in] twin The #az_iot_hub_client_twin_desired to use for this call.
+ * @return The `$version` of the last desired properties applied.
+ */
+AZ_NODISCARD AZ_INLINE int64_t
+az_iot_hub_client_twin_desired_get_version(az_iot_hub_client_twin_desired const* twin)
+{
+  return twin->_internal.version;
+}
+
+/**
+ * @brief Applies a received twin GET response or desired properties notification.
+ *
+ * @details Desired properties with a `$version` no newer than the last one applied are ignored,
+ * whether they come as duplicate notifications or as a GET response overtaken by a notification.
+ * Otherwise, the callback is called for each tracked property whose value differs from the last
+ * one applied. Tracked properties missing from a GET response keep their last value. Other twin
+ * responses, including failed GET responses, are ignored.
+ *
+ * @param[in,out] twin The #az_iot_hub_client_twin_desired to use for this call.
+ * @param[in] response The #az_iot_hub_client_twin_response parsed from the received topic.
+ * @param[in] payload The payload of the received message.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The message was applied or ignored.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The payload has no desired properties `$version`.
+ * @retval Other Failure reading the payload as JSON.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_twin_desired_apply(
+    az_iot_hub_client_twin_desired* twin,
+    az_iot_hub_client_twin_response const* response,
+    az_span payload);
+
+/**
+ * @brief A pending reported property in an #az_iot_hub_client_twin_reported_batch.
+ *
+ * @details Storage for the batch, provided by the application. Its fields are managed by the
+ * batch.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span component_name;
+    az_span property_name;
+    az_span value;
+  } _internal;
+} az_iot_hub_client_twin_reported_property;
+
+/**
+ * @brief Coalesces reported property updates, possibly from several components, into a single
+ * twin PATCH request.
+ *
+ * @details Updating a property which is already pending replaces its value. The batch should be
+ * sent when #az_iot_hub_client_twin_reported_batch_should_flush() says so, or when
+ * #az_iot_hub_client_twin_reported_batch_append() runs out of space.
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_hub_client_twin_reported_property* properties;
+    int32_t properties_capacity;
+    int32_t properties_count;
+    az_span values_buffer;
+    int32_t values_written;
+    int64_t max_delay;
+    int64_t first_update_time;
+  } _internal;
+} az_iot_hub_client_twin_reported_batch;
+
+/**
+ * @brief Initializes an #az_iot_hub_client_twin_reported_batch.
+ *
+ * @param[out] batch The #az_iot_hub_client_twin_reported_batch to initialize.
+ * @param[in] properties The storage for the pending properties. It must remain valid for the
+ * lifetime of \p batch.
+ * @param[in] properties_capacity The number of elements in \p properties.
+ * @param[in] values_buffer The buffer the JSON values of the pending properties are copied to. It
+ * must remain valid for the lifetime of \p batch.
+ * @param[in] max_delay The longest time, in the application's clock units, an update may wait in
+ * the batch.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The batch was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_twin_reported_batch_init(
+    az_iot_hub_client_twin_reported_batch* batch,
+    az_iot_hub_client_twin_reported_property* properties,
+    int32_t properties_capacity,
+    az_span values_buffer,
+    int64_t max_delay);
+
+/**
+ * @brief Adds a reported property update to the batch.
+ *
+ * @param[in,out] batch The #az_iot_hub_client_twin_reported_batch to use for this call.
+ * @param[in] component_name The name of the component the property belongs to, or #AZ_SPAN_EMPTY
+ * for a property of the root interface. Must remain valid until the batch is cleared.
+ * @param[in] property_name The name of the property. Must remain valid until the batch is cleared.
+ * @param[in] json_value The JSON text of the property value, such as written by an
+ * #az_json_writer. It is copied into the batch.
+ * @param[in] now The current time, in the same units as the \p max_delay of the batch.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The update was added.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The batch is full. Send it, clear it, and add the update
+ * again.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_twin_reported_batch_append(
+    az_iot_hub_client_twin_reported_batch* batch,
+    az_span component_name,
+    az_span property_name,
+    az_span json_value,
+    int64_t now);
+
+/**
+ * @brief Checks whether the batch should be sent.
+ *
+ * @param[in] batch The #az_iot_hub_client_twin_reported_batch to use for this call.
+ * @param[in] now The current time, in the same units as the \p max_delay of the batch.
+ * @return `true` if the batch has updates and either the oldest has waited for the maximum delay,
+ * or no more properties fit.
+ */
+AZ_NODISCARD bool az_iot_hub_client_twin_reported_batch_should_flush(
+    az_iot_hub_client_twin_reported_batch const* batch,
+    int64_t now);
+
+/**
+ * @brief Gets the number of pending reported property updates.
+ *
+ * @param[in] batch The #az_iot_hub_client_twin_reported_batch to use for this call.
+ * @return The number of pending updates.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+az_iot_hub_client_twin_reported_batch_count(az_iot_hub_client_twin_reported_batch const* batch)
+{
+  return batch->_internal.properties_count;
+}
+
+/**
+ * @brief Writes the pending updates as the payload of a twin PATCH request.
+ *
+ * @details The properties of each component are grouped in a single component object, marked with
+ * `"__t":"c"`. Publish the payload on the topic from
+ * #az_iot_hub_client_twin_patch_get_publish_topic(), then call
+ * #az_iot_hub_client_twin_reported_batch_clear().
+ *
+ * @param[in] batch The #az_iot_hub_client_twin_reported_batch to use for this call.
+ * @param[in] payload_buffer The buffer to write the payload to.
+ * @param[out] out_payload The slice of \p payload_buffer holding the payload.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The payload was written successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p payload_buffer is too small.
+ * @retval Other A pending value isn't valid JSON text.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_twin_reported_batch_get_payload(
+    az_iot_hub_client_twin_reported_batch const* batch,
+    az_span payload_buffer,
+    az_span* out_payload);
+
+/**
+ * @brief Removes all the pending updates, once they were sent.
+ *
+ * @param[in,out] batch The #az_iot_hub_client_twin_reported_batch to use for this call.
+ */
+void az_iot_hub_client_twin_reported_batch_clear(az_iot_hub_client_twin_reported_batch* batch);
+
+/*
+ *
+ * Request correlation APIs
+ *
+ */
+
+/**
+ * @brief An outstanding twin or method request, tracked by an
+ * #az_iot_hub_client_request_table.
+ *
+ */
+typedef struct
+{
+  /**
+   * The request ID given to the request. Zero for a free slot.
+   */
+  uint64_t request_id;
+
+  /**
+   * The time, in the application's clock units, after which the request is considered expired.
+   */
+  int64_t deadline;
+
+  /**
+   * The application's data for the request.
+   */
+  void* context;
+} az_iot_hub_client_pending_request;
+
+/**
+ * @brief A fixed-capacity table of outstanding requests, backed by an application buffer.
+ *
+ * @details The table hands out the numeric request IDs to use with
+ * #az_iot_hub_client_twin_document_get_publish_topic_u64(),
+ * #az_iot_hub_client_twin_patch_get_publish_topic_u64() and similar, choosing them so that each ID
+ * maps to its own slot. Resolving a response is then a constant-time lookup.
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_hub_client_pending_request* requests;
+    uint64_t next_request_id;
+    int32_t capacity;
+    int32_t count;
+  } _internal;
+} az_iot_hub_client_request_table;
+
+/**
+ * @brief Initializes an #az_iot_hub_client_request_table.
+ *
+ * @param[out] table The #az_iot_hub_client_request_table to initialize.
+ * @param[in] requests The buffer holding the table slots. It must remain valid for the lifetime of
+ * \p table.
+ * @param[in] capacity The number of elements in \p requests. Must be a power of two.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The table was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_request_table_init(
+    az_iot_hub_client_request_table* table,
+    az_iot_hub_client_pending_request* requests,
+    int32_t capacity);
+
+/**
+ * @brief Gets the number of outstanding requests in an #az_iot_hub_client_request_table.
+ *
+ * @param[in] table The #az_iot_hub_client_request_table to use for this call.
+ * @return The number of outstanding requests.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+az_iot_hub_client_request_table_count(az_iot_hub_client_request_table const* table)
+{
+  return table->_internal.count;
+}
+
+/**
+ * @brief Starts tracking a new request, giving back the request ID to publish it with.
+ *
+ * @param[in,out] table The #az_iot_hub_client_request_table to use for this call.
+ * @param[in] deadline The time, in the application's clock units, after which the request is
+ * considered expired.
+ * @param[in] context __[nullable]__ The application's data for the request, given back when the
+ * request is resolved or expires.
+ * @param[out] out_request_id The request ID to publish the request with.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The request is tracked.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The table is full.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_request_table_add(
+    az_iot_hub_client_request_table* table,
+    int64_t deadline,
+    void* context,
+    uint64_t* out_request_id);
+
+/**
+ * @brief Looks up and removes the request a received response belongs to.
+ *
+ * @param[in,out] table The #az_iot_hub_client_request_table to use for this call.
+ * @param[in] request_id The request ID of the response, such as
+ * #az_iot_hub_client_twin_response.request_id. Can be empty, as for desired properties
+ * notifications.
+ * @param[out] out_request __[nullable]__ If successful, contains the resolved request.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The request was found and is no longer tracked.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND \p request_id isn't an outstanding request from this table.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_request_table_resolve(
+    az_iot_hub_client_request_table* table,
+    az_span request_id,
+    az_iot_hub_client_pending_request* out_request);
+
+/**
+ * @brief Removes one request whose deadline has passed.
+ *
+ * @details Call repeatedly until it returns #AZ_ERROR_ITEM_NOT_FOUND to remove all expired
+ * requests.
+ *
+ * @param[in,out] table The #az_iot_hub_client_request_table to use for this call.
+ * @param[in] now The current time, in the same units as the deadlines.
+ * @param[out] out_request __[nullable]__ If successful, contains the expired request.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK An expired request was removed.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND No request has expired.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_request_table_remove_expired(
+    az_iot_hub_client_request_table* table,
+    int64_t now,
+    az_iot_hub_client_pending_request* out_request);
+
+/*
+ *
+ * Received topic APIs
+ *
+ */
+
+/**
+ * @brief The kind of message that arrived on a received topic.
+ *
+ */
+typedef enum
+{
+  AZ_IOT_HUB_CLIENT_TOPIC_TYPE_C2D = 1, ///< Cloud-to-device message.
+  AZ_IOT_HUB_CLIENT_TOPIC_TYPE_METHOD = 2, ///< Direct method request.
+  AZ_IOT_HUB_CLIENT_TOPIC_TYPE_TWIN = 3, ///< Twin response or desired properties notification.
+} az_iot_hub_client_topic_type;
+
+/**
+ * @brief A parsed received topic.
+ *
+ * @details Only the member of \p parsed corresponding to \p type is populated.
+ */
+typedef struct
+{
+  /**
+   * The parsed content of the topic.
+   */
+  union
+  {
+    az_iot_hub_client_c2d_request c2d; ///< Set when \p type is
+                                       ///< #AZ_IOT_HUB_CLIENT_TOPIC_TYPE_C2D.
+    az_iot_hub_client_method_request method; ///< Set when \p type is
+                                             ///< #AZ_IOT_HUB_CLIENT_TOPIC_TYPE_METHOD.
+    az_iot_hub_client_twin_response twin; ///< Set when \p type is
+                                          ///< #AZ_IOT_HUB_CLIENT_TOPIC_TYPE_TWIN.
+  } parsed;
+
+  /**
+   * The kind of message the topic was classified as.
+   */
+  az_iot_hub_client_topic_type type;
+} az_iot_hub_client_topic;
+
+/**
+ * @brief Attempts to parse a received message's topic for any of the C2D, methods or twin features.
+ *
+ * @details The topic prefix is inspected once and the topic is handed to the matching feature
+ * parser, instead of offering it to #az_iot_hub_client_c2d_parse_received_topic(),
+ * #az_iot_hub_client_methods_parse_received_topic() and
+ * #az_iot_hub_client_twin_parse_received_topic() one after another.
+ *
+ * @warning The topic must be a valid MQTT topic or the resulting behavior will be undefined.
+ *
+ * @param[in] client The #az_iot_hub_client to use for this call.
+ * @param[in] received_topic An #az_span containing the received topic.
+ * @param[out] out_topic If the topic is recognized, this will contain the type of the message and
+ * the corresponding parsed request or response.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The topic was recognized and \p out_topic was populated.
+ * @retval #AZ_ERROR_IOT_TOPIC_NO_MATCH The topic does not match any of the expected formats.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_topic_parse(
+    az_iot_hub_client const* client,
+    az_span received_topic,
+    az_iot_hub_client_topic* out_topic);
+
+/*
+ *
+ * Gateway APIs
+ *
+ */
+
+/**
+ * @brief The context of one device identity hosted by an #az_iot_hub_client_gateway.
+ *
+ * @details It holds the #az_iot_hub_client and the #az_iot_connection of the device, in less than
+ * 200 bytes on 64-bit targets, so that a gateway can host many thousands of identities.
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_hub_client client;
+    az_iot_connection connection;
+    void* context;
+    // The CRC-32 of the device ID, compared before the device ID itself when looking it up.
+    uint32_t device_id_hash;
+  } _internal;
+} az_iot_hub_client_gateway_device;
+
+/**
+ * @brief Gets the #az_iot_hub_client of a device hosted by a gateway, to get its topics and
+ * credentials with.
+ *
+ * @param[in] device The #az_iot_hub_client_gateway_device to use for this call.
+ * @return The #az_iot_hub_client of the device.
+ */
+AZ_NODISCARD AZ_INLINE az_iot_hub_client const*
+az_iot_hub_client_gateway_device_get_client(az_iot_hub_client_gateway_device const* device)
+{
+  return &device->_internal.client;
+}
+
+/**
+ * @brief Gets the #az_iot_connection of a device hosted by a gateway, to drive its MQTT
+ * connection with.
+ *
+ * @param[in] device The #az_iot_hub_client_gateway_device to use for this call.
+ * @return The #az_iot_connection of the device.
+ */
+AZ_NODISCARD AZ_INLINE az_iot_connection*
+az_iot_hub_client_gateway_device_get_connection(az_iot_hub_client_gateway_device* device)
+{
+  return &device->_internal.connection;
+}
+
+/**
+ * @brief Gets the application's data of a device hosted by a gateway.
+ *
+ * @param[in] device The #az_iot_hub_client_gateway_device to use for this call.
+ * @return The context given to #az_iot_hub_client_gateway_add_device().
+ */
+AZ_NODISCARD AZ_INLINE void*
+az_iot_hub_client_gateway_device_get_context(az_iot_hub_client_gateway_device const* device)
+{
+  return device->_internal.context;
+}
+
+/**
+ * @brief A pool of device identities sharing one IoT Hub, with one receive dispatcher for all of
+ * their MQTT connections.
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_hub_client_gateway_device* devices;
+    int32_t capacity;
+    int32_t count;
+    az_iot_hub_client_config config;
+    az_span module_id;
+    az_iot_connection_options connection_options;
+  } _internal;
+} az_iot_hub_client_gateway;
+
+/**
+ * @brief Initializes an #az_iot_hub_client_gateway.
+ *
+ * @param[out] gateway The #az_iot_hub_client_gateway to initialize.
+ * @param[in] devices The pool of device contexts. It must remain valid for the lifetime of
+ * \p gateway.
+ * @param[in] capacity The number of elements in \p devices.
+ * @param[in] iot_hub_hostname The IoT Hub Hostname of all the devices.
+ * @param[in] options __[nullable]__ The #az_iot_hub_client_options of all the devices. If `NULL`
+ * is passed, the default options are used. The devices share one #az_iot_hub_client_config.
+ * @param[in] connection_options __[nullable]__ The #az_iot_connection_options of all the devices.
+ * If `NULL` is passed, the default options are used.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The gateway was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_gateway_init(
+    az_iot_hub_client_gateway* gateway,
+    az_iot_hub_client_gateway_device devices[],
+    int32_t capacity,
+    az_span iot_hub_hostname,
+    az_iot_hub_client_options const* options,
+    az_iot_connection_options const* connection_options);
+
+/**
+ * @brief Gets the number of devices hosted by an #az_iot_hub_client_gateway.
+ *
+ * @param[in] gateway The #az_iot_hub_client_gateway to use for this call.
+ * @return The number of devices.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+az_iot_hub_client_gateway_count(az_iot_hub_client_gateway const* gateway)
+{
+  return gateway->_internal.count;
+}
+
+/**
+ * @brief Adds a device identity to an #az_iot_hub_client_gateway.
+ *
+ * @param[in,out] gateway The #az_iot_hub_client_gateway to use for this call.
+ * @param[in] device_id The Device ID, percent-encoded as for #az_iot_hub_client_init(). It must
+ * remain valid until the device is removed.
+ * @param[in] context __[nullable]__ The application's data for the device, such as its MQTT
+ * connection.
+ * @param[out] out_device The context of the device within the pool.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The device was added.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The pool is full.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_gateway_add_device(
+    az_iot_hub_client_gateway* gateway,
+    az_span device_id,
+    void* context,
+    az_iot_hub_client_gateway_device** out_device);
+
+/**
+ * @brief Removes a device identity from an #az_iot_hub_client_gateway, freeing its context.
+ *
+ * @param[in,out] gateway The #az_iot_hub_client_gateway to use for this call.
+ * @param[in,out] device The context returned by #az_iot_hub_client_gateway_add_device().
+ */
+void az_iot_hub_client_gateway_remove_device(
+    az_iot_hub_client_gateway* gateway,
+    az_iot_hub_client_gateway_device* device);
+
+/**
+ * @brief Finds a device identity hosted by an #az_iot_hub_client_gateway.
+ *
+ * @param[in] gateway The #az_iot_hub_client_gateway to use for this call.
+ * @param[in] device_id The percent-encoded Device ID to find.
+ * @param[out] out_device The context of the device.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The device was found.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The gateway doesn't host the device.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_gateway_find_device(
+    az_iot_hub_client_gateway* gateway,
+    az_span device_id,
+    az_iot_hub_client_gateway_device** out_device);
+
+/**
+ * @brief Dispatches a received topic to the device it is for, and classifies it with
+ * #az_iot_hub_client_topic_parse().
+ *
+ * @details Method and twin topics don't name their device, so they must be passed along with the
+ * device whose connection received them. Cloud-to-device topics name their device, which is found
+ * when \p device is `NULL`.
+ *
+ * @param[in] gateway The #az_iot_hub_client_gateway to use for this call.
+ * @param[in] device __[nullable]__ The device whose connection received the topic, if known.
+ * @param[in] received_topic An #az_span containing the received topic.
+ * @param[out] out_device The device the topic is for.
+ * @param[out] out_topic The type of the message and the corresponding parsed request or response.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The topic was recognized, and its device found.
+ * @retval #AZ_ERROR_IOT_TOPIC_NO_MATCH The topic does not match any of the expected formats.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The topic is for a device the gateway doesn't host, or
+ * \p device is `NULL` and the topic doesn't name its device.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_gateway_parse_received_topic(
+    az_iot_hub_client_gateway* gateway,
+    az_iot_hub_client_gateway_device* device,
+    az_span received_topic,
+    az_iot_hub_client_gateway_device** out_device,
+    az_iot_hub_client_topic* out_topic);
+
+/*
+ *
+ * Plug and Play component APIs
+ *
+ */
+
+/**
+ * @brief The components of a Plug and Play model, with the telemetry topic of each one built once
+ * and their names in an #az_iot_hub_client_method_table.
+ *
+ * @details Telemetry of a component carries its name in the `$.sub` property of the topic, which
+ * #az_iot_hub_client_pnp_components_get_telemetry_topic() returns ready to publish instead of
+ * formatting it for every message. The components of received twin properties and commands are
+ * found with a single name comparison, whatever the number of components.
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_hub_client_method_table table;
+    az_span* telemetry_topics;
+  } _internal;
+} az_iot_hub_client_pnp_components;
+
+/**
+ * @brief Initializes an #az_iot_hub_client_pnp_components, building the telemetry topic of each
+ * component.
+ *
+ * @param[out] components The #az_iot_hub_client_pnp_components to initialize.
+ * @param[in] client The #az_iot_hub_client whose device publishes the telemetry.
+ * @param[in] names The names of the components, as in the model.
+ * @param[out] hashes An array of \p size elements, as for #az_iot_hub_client_method_table_init().
+ * @param[out] seeds An array of \p size elements, as for #az_iot_hub_client_method_table_init().
+ * @param[out] slots An array of \p size elements, as for #az_iot_hub_client_method_table_init().
+ * @param[out] telemetry_topics An array of \p size elements, to receive the telemetry topic of
+ * each component, within \p topic_buffer.
+ * @param[in] size The number of components.
+ * @param[in] topic_buffer The buffer holding the null-terminated telemetry topics.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The components were initialized successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p topic_buffer is too small to hold the topics.
+ * @retval #AZ_ERROR_ARG A name appears more than once in \p names.
+ *
+ * @remarks The \p names, \p hashes, \p seeds, \p slots and \p telemetry_topics arrays, and
+ * \p topic_buffer, must outlive \p components.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_pnp_components_init(
+    az_iot_hub_client_pnp_components* components,
+    az_iot_hub_client const* client,
+    az_span const names[],
+    uint32_t hashes[],
+    int32_t seeds[],
+    int32_t slots[],
+    az_span telemetry_topics[],
+    int32_t size,
+    az_span topic_buffer);
+
+/**
+ * @brief Finds a component, such as the name of a top-level property of a received twin
+ * document.
+ *
+ * @param[in] components The #az_iot_hub_client_pnp_components to use for this call.
+ * @param[in] name The component name to find.
+ * @return The index of \p name within the names of the components, or -1 if the model doesn't
+ * have such a component.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_iot_hub_client_pnp_components_find(
+    az_iot_hub_client_pnp_components const* components,
+    az_span name)
+{
+  return az_iot_hub_client_method_table_find(&components->_internal.table, name);
+}
+
+/**
+ * @brief Gets the MQTT topic to publish the telemetry of a component on.
+ *
+ * @param[in] components The #az_iot_hub_client_pnp_components to use for this call.
+ * @param[in] component_index The index of the component within the names of the components.
+ * @return The topic, followed by a null terminator which isn't part of the #az_span.
+ */
+AZ_NODISCARD AZ_INLINE az_span az_iot_hub_client_pnp_components_get_telemetry_topic(
+    az_iot_hub_client_pnp_components const* components,
+    int32_t component_index)
+{
+  return components->_internal.telemetry_topics[component_index];
+}
+
+/**
+ * @brief Splits the name of a received command into its component and its command name.
+ *
+ * @details Commands of a component are received as methods named `{component}*{command}`, and
+ * commands of the default component as methods named `{command}`.
+ *
+ * @param[in] components The #az_iot_hub_client_pnp_components to use for this call.
+ * @param[in] method_name The name of the received #az_iot_hub_client_method_request.
+ * @param[out] out_component_index The index of the component of the command, or -1 for the
+ * default component.
+ * @param[out] out_command_name The name of the command, within \p method_name.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The command was split successfully.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The model doesn't have the component named in \p method_name.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_pnp_components_parse_command(
+    az_iot_hub_client_pnp_components const* components,
+    az_span method_name,
+    int32_t* out_component_index,
+    az_span* out_command_name);
+
+/**
+ * @brief Called by #az_iot_hub_client_pnp_components_visit_desired() for each desired property.
+ *
+ * @param[in] component_index The index of the component of the property, or -1 for a property of
+ * the default component.
+ * @param[in] property_name The name of the property.
+ * @param[in] property_value An #az_json_reader positioned on the property value, which the
+ * callback is free to read through.
+ * @param[in] version The `$version` of the desired properties being visited.
+ * @param[in] context The context passed to #az_iot_hub_client_pnp_components_visit_desired().
+ */
+typedef void (*az_iot_hub_client_pnp_property_fn)(
+    int32_t component_index,
+    az_json_token const* property_name,
+    az_json_reader* property_value,
+    int64_t version,
+    void* context);
+
+/**
+ * @brief Visits the desired properties of a received twin GET response or desired properties
+ * notification, calling back for each property of each component.
+ *
+ * @details The document is read once, from start to end. A top-level property named after a
+ * component whose value is an object holds the properties of that component, which are visited
+ * without its `__t` marker. Any other top-level property, except `$version`, is a property of the
+ * default component. Other twin responses, including failed GET responses, are ignored.
+ *
+ * @param[in] components The #az_iot_hub_client_pnp_components of the model.
+ * @param[in] response The #az_iot_hub_client_twin_response parsed from the received topic.
+ * @param[in] payload The payload of the received message.
+ * @param[in] callback The #az_iot_hub_client_pnp_property_fn to call for each property.
+ * @param[in] context __[nullable]__ The context passed to \p callback.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The properties were visited, or the response ignored.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The payload has no desired properties `$version`.
+ * @retval Other Failure reading the payload as JSON.
+ *
+ * @remarks A notification carries its `$version` in its topic. For a GET response, the `$version`
+ * is found first by skipping over the values of the desired properties, which the properties are
+ * then visited with.
+ */
+AZ_NODISCARD az_result az_iot_hub_client_pnp_components_visit_desired(
+    az_iot_hub_client_pnp_components const* components,
+    az_iot_hub_client_twin_response const* response,
+    az_span payload,
+    az_iot_hub_client_pnp_property_fn callback,
+    void* context);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_IOT_HUB_CLIENT_H
@@ -55,6 +55,7 @@ typedef struct
     az_span id_scope;
     az_span registration_id;
     az_iot_provisioning_client_options options;
+    az_span sas_resource_uri;
   } _internal;
 } az_iot_provisioning_client;
 
@@ -95,6 +96,9 @@ AZ_NODISCARD az_result az_iot_provisioning_client_init(
  * successful, contains a null-terminated string with the user name that needs to be passed to the
  * MQTT client.
  * @param[in] mqtt_user_name_size The size, in bytes of \p mqtt_user_name.
+ * Use a `NULL` \p mqtt_user_name of size 0 to only measure the string:
+ * \p out_mqtt_user_name_length, which can't be `NULL` then, is set to its length, and nothing is
+ * written.
  * @param[out] out_mqtt_user_name_length __[nullable]__ Contains the string length, in bytes, of \p
  * mqtt_user_name. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -113,6 +117,9 @@ AZ_NODISCARD az_result az_iot_provisioning_client_get_user_name(
  * successful, contains a null-terminated string with the client id that needs to be passed to the
  * MQTT client.
  * @param[in] mqtt_client_id_size The size, in bytes of \p mqtt_client_id.
+ * Use a `NULL` \p mqtt_client_id of size 0 to only measure the string:
+ * \p out_mqtt_client_id_length, which can't be `NULL` then, is set to its length, and nothing is
+ * written.
  * @param[out] out_mqtt_client_id_length __[nullable]__ Contains the string length, in bytes, of of
  * \p mqtt_client_id. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -135,6 +142,27 @@ AZ_NODISCARD az_result az_iot_provisioning_client_get_client_id(
  *   still be used to securely store and perform HMAC-SHA256 operations for SAS tokens.
  */
 
+/**
+ * @brief URL-encodes the resource URI of the SAS tokens once, for the client to copy it into every
+ * SAS signature and password from then on.
+ *
+ * Otherwise, az_iot_provisioning_client_sas_get_signature() and
+ * az_iot_provisioning_client_sas_get_password() URL-encode the ID scope and registration ID for
+ * every token. This is worthwhile when refreshing the SAS tokens of many clients.
+ *
+ * @param[in,out] client The #az_iot_provisioning_client to use for this call. Calling
+ * az_iot_provisioning_client_init() again clears the cached resource URI.
+ * @param[in] resource_uri_buffer A buffer with sufficient capacity to hold the URL-encoded resource
+ * URI, which must outlive the \p client.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The resource URI is cached.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p resource_uri_buffer is too small, in which case the
+ * resource URI keeps being encoded for every token.
+ */
+AZ_NODISCARD az_result az_iot_provisioning_client_sas_cache_resource_uri(
+    az_iot_provisioning_client* client,
+    az_span resource_uri_buffer);
+
 /**
  * @brief Gets the Shared Access clear-text signature.
  *
@@ -172,6 +200,8 @@ AZ_NODISCARD az_result az_iot_provisioning_client_sas_get_signature(
  * successful, contains a null-terminated string with the password that needs to be passed to the
  * MQTT client.
  * @param[in] mqtt_password_size The size, in bytes of \p mqtt_password.
+ * Use a `NULL` \p mqtt_password of size 0 to only measure the string: \p out_mqtt_password_length,
+ * which can't be `NULL` then, is set to its length, and nothing is written.
  * @param[out] out_mqtt_password_length __[nullable]__ Contains the string length, in bytes, of \p
  * mqtt_password. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation..
@@ -361,6 +391,8 @@ AZ_INLINE bool az_iot_provisioning_client_operation_complete(
  * successful, contains a null-terminated string with the topic filter that needs to be passed to
  * the MQTT client.
  * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * Use a `NULL` \p mqtt_topic of size 0 to only measure the string: \p out_mqtt_topic_length, which
+ * can't be `NULL` then, is set to its length, and nothing is written.
  * @param[out] out_mqtt_topic_length __[nullable]__ Contains the string length, in bytes, of \p
  * mqtt_topic. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -382,6 +414,8 @@ AZ_NODISCARD az_result az_iot_provisioning_client_register_get_publish_topic(
  * successful, contains a null-terminated string with the topic filter that needs to be passed to
  * the MQTT client.
  * @param[in] mqtt_topic_size The size, in bytes of \p mqtt_topic.
+ * Use a `NULL` \p mqtt_topic of size 0 to only measure the string: \p out_mqtt_topic_length, which
+ * can't be `NULL` then, is set to its length, and nothing is written.
  * @param[out] out_mqtt_topic_length __[nullable]__ Contains the string length, in bytes, of \p
  * mqtt_topic. Can be `NULL`.
  * @return An #az_result value indicating the result of the operation.
@@ -393,6 +427,354 @@ AZ_NODISCARD az_result az_iot_provisioning_client_query_status_get_publish_topic
     size_t mqtt_topic_size,
     size_t* out_mqtt_topic_length);
 
+/*
+ *
+ * Registration state caching APIs
+ *
+ */
+
+/**
+ * @brief Serializes the assigned hub and device ID of a completed registration, for the device to
+ * connect to its hub directly on its next boots.
+ *
+ * @details The cached state is bound to the ID scope and registration ID of \p client, and
+ * protected by a CRC-32, so that a cache written for another device, or corrupted in storage, is
+ * rejected by #az_iot_provisioning_client_registration_state_deserialize().
+ *
+ * @param[in] client The #az_iot_provisioning_client to use for this call.
+ * @param[in] state The #az_iot_provisioning_client_registration_state of a registration whose
+ * operation status is #AZ_IOT_PROVISIONING_STATUS_ASSIGNED.
+ * @param[in] expiration The time after which the cached state is no longer used, in the
+ * application's clock units, or `INT64_MAX` to use it until it's erased.
+ * @param[in] destination The buffer to write the cached state into.
+ * @param[out] out_cached_state The portion of \p destination holding the cached state, to store.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The state was serialized successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ */
+AZ_NODISCARD az_result az_iot_provisioning_client_registration_state_serialize(
+    az_iot_provisioning_client const* client,
+    az_iot_provisioning_client_registration_state const* state,
+    int64_t expiration,
+    az_span destination,
+    az_span* out_cached_state);
+
+/**
+ * @brief Restores the assigned hub and device ID cached by
+ * #az_iot_provisioning_client_registration_state_serialize().
+ *
+ * @details When this succeeds, the device can connect to its hub without registering with the
+ * provisioning service first. If the hub then rejects the connection, the application should
+ * erase the cached state and register again.
+ *
+ * @param[in] client The #az_iot_provisioning_client to use for this call.
+ * @param[in] cached_state The cached state, as stored by the application.
+ * @param[in] now The current time, in the application's clock units.
+ * @param[out] out_state The cached #az_iot_provisioning_client_registration_state. Its spans point
+ * into \p cached_state.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The cached state can be used.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The cached state is corrupted, was written for another device,
+ * or expired. The device should register with the provisioning service.
+ */
+AZ_NODISCARD az_result az_iot_provisioning_client_registration_state_deserialize(
+    az_iot_provisioning_client const* client,
+    az_span cached_state,
+    int64_t now,
+    az_iot_provisioning_client_registration_state* out_state);
+
+/*
+ *
+ * Registration scheduling APIs
+ *
+ */
+
+/**
+ * @brief The request to publish next for a registration, as returned by
+ * #az_iot_provisioning_client_scheduler_get_next().
+ *
+ */
+typedef enum
+{
+  /// Publish a register request, to the topic from
+  /// #az_iot_provisioning_client_register_get_publish_topic().
+  AZ_IOT_PROVISIONING_CLIENT_ACTION_REGISTER = 1,
+
+  /// Publish a query status request, to the topic from
+  /// #az_iot_provisioning_client_query_status_get_publish_topic() with the operation ID of the
+  /// registration.
+  AZ_IOT_PROVISIONING_CLIENT_ACTION_QUERY_STATUS = 2,
+} az_iot_provisioning_client_action;
+
+/**
+ * @brief The timing of the requests scheduled by an #az_iot_provisioning_client_scheduler, in the
+ * application's clock units.
+ *
+ */
+typedef struct
+{
+  /**
+   * The number of clock units in a second, to convert the `retry-after` of the responses.
+   */
+  int64_t units_per_second;
+
+  /**
+   * The time to wait for the response to a request before publishing it again.
+   */
+  int64_t response_timeout;
+
+  /**
+   * The time to wait before querying the status of an operation, or retrying a throttled request,
+   * when the response has no `retry-after`.
+   */
+  int64_t default_retry_after;
+} az_iot_provisioning_client_scheduler_options;
+
+/**
+ * @brief Gets the default #az_iot_provisioning_client_scheduler_options, for a clock counting
+ * milliseconds: a 30 second response timeout, and a 3 second polling interval.
+ *
+ * @return #az_iot_provisioning_client_scheduler_options.
+ */
+AZ_NODISCARD az_iot_provisioning_client_scheduler_options
+az_iot_provisioning_client_scheduler_options_default();
+
+/**
+ * @brief The provisioning of one device, driven by an #az_iot_provisioning_client_scheduler.
+ *
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_provisioning_client const* client;
+    void* context;
+    az_span operation_id_buffer;
+    az_span operation_id;
+    int64_t deadline;
+    // The position within the scheduler's heap, or -1 when not scheduled.
+    int32_t heap_index;
+    int32_t attempts;
+    uint8_t state;
+  } _internal;
+} az_iot_provisioning_client_registration;
+
+/**
+ * @brief Initializes an #az_iot_provisioning_client_registration.
+ *
+ * @param[out] registration The #az_iot_provisioning_client_registration to initialize.
+ * @param[in] client The #az_iot_provisioning_client of the device to provision. It must remain
+ * valid for the lifetime of \p registration.
+ * @param[in] operation_id_buffer A buffer to keep the operation ID received from the service
+ * into, until the operation completes. It must remain valid for the lifetime of \p registration.
+ * @param[in] context __[nullable]__ The application's data for the registration.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The registration was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_provisioning_client_registration_init(
+    az_iot_provisioning_client_registration* registration,
+    az_iot_provisioning_client const* client,
+    az_span operation_id_buffer,
+    void* context);
+
+/**
+ * @brief Gets the #az_iot_provisioning_client of a registration.
+ *
+ * @param[in] registration The #az_iot_provisioning_client_registration to use for this call.
+ * @return The client given to #az_iot_provisioning_client_registration_init().
+ */
+AZ_NODISCARD AZ_INLINE az_iot_provisioning_client const*
+az_iot_provisioning_client_registration_get_client(
+    az_iot_provisioning_client_registration const* registration)
+{
+  return registration->_internal.client;
+}
+
+/**
+ * @brief Gets the application's data of a registration.
+ *
+ * @param[in] registration The #az_iot_provisioning_client_registration to use for this call.
+ * @return The context given to #az_iot_provisioning_client_registration_init().
+ */
+AZ_NODISCARD AZ_INLINE void* az_iot_provisioning_client_registration_get_context(
+    az_iot_provisioning_client_registration const* registration)
+{
+  return registration->_internal.context;
+}
+
+/**
+ * @brief Gets the operation ID to query the status of a registration with.
+ *
+ * @param[in] registration The #az_iot_provisioning_client_registration to use for this call.
+ * @return The operation ID received last, or an empty #az_span if none was received yet.
+ */
+AZ_NODISCARD AZ_INLINE az_span az_iot_provisioning_client_registration_get_operation_id(
+    az_iot_provisioning_client_registration const* registration)
+{
+  return registration->_internal.operation_id;
+}
+
+/**
+ * @brief Gets the number of times the request to publish for a registration was returned by
+ * #az_iot_provisioning_client_scheduler_get_next() without getting a response.
+ *
+ * @details Applications can give up on a registration, with
+ * #az_iot_provisioning_client_scheduler_remove(), after a number of attempts.
+ *
+ * @param[in] registration The #az_iot_provisioning_client_registration to use for this call.
+ * @return The number of attempts of the current request, starting at 1 once it was returned.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_iot_provisioning_client_registration_get_attempts(
+    az_iot_provisioning_client_registration const* registration)
+{
+  return registration->_internal.attempts;
+}
+
+/**
+ * @brief Drives the register and query status requests of many registrations at once, scheduling
+ * each one at its deadline.
+ *
+ * @details The scheduler doesn't publish or wait by itself. The application asks it for the
+ * requests that are due with #az_iot_provisioning_client_scheduler_get_next(), passes it the
+ * responses with #az_iot_provisioning_client_scheduler_handle_response(), and can wait for
+ * messages until #az_iot_provisioning_client_scheduler_get_next_deadline() rather than polling at
+ * fixed intervals. The registrations are kept in a binary heap ordered by deadline, so that each
+ * of these calls takes at most a logarithmic time in the number of registrations.
+ */
+typedef struct
+{
+  struct
+  {
+    az_iot_provisioning_client_registration** heap;
+    int32_t capacity;
+    int32_t count;
+    az_iot_provisioning_client_scheduler_options options;
+  } _internal;
+} az_iot_provisioning_client_scheduler;
+
+/**
+ * @brief Initializes an #az_iot_provisioning_client_scheduler.
+ *
+ * @param[out] scheduler The #az_iot_provisioning_client_scheduler to initialize.
+ * @param[in] heap The buffer holding the scheduled registrations. It must remain valid for the
+ * lifetime of \p scheduler.
+ * @param[in] capacity The number of elements in \p heap.
+ * @param[in] options __[nullable]__ A reference to an
+ * #az_iot_provisioning_client_scheduler_options structure. If `NULL` is passed, the scheduler uses
+ * the default options, for a clock counting milliseconds.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The scheduler was initialized successfully.
+ */
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_init(
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* heap[],
+    int32_t capacity,
+    az_iot_provisioning_client_scheduler_options const* options);
+
+/**
+ * @brief Gets the number of registrations in progress in an
+ * #az_iot_provisioning_client_scheduler.
+ *
+ * @param[in] scheduler The #az_iot_provisioning_client_scheduler to use for this call.
+ * @return The number of registrations in progress.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+az_iot_provisioning_client_scheduler_count(az_iot_provisioning_client_scheduler const* scheduler)
+{
+  return scheduler->_internal.count;
+}
+
+/**
+ * @brief Starts a registration, with its register request due right away.
+ *
+ * @param[in,out] scheduler The #az_iot_provisioning_client_scheduler to use for this call.
+ * @param[in,out] registration The #az_iot_provisioning_client_registration to start. It must not
+ * be in progress already, and must remain valid until it completes or is removed.
+ * @param[in] now The current time, in the application's clock units.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The registration is in progress.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The scheduler is full.
+ */
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_add(
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* registration,
+    int64_t now);
+
+/**
+ * @brief Stops a registration in progress.
+ *
+ * @param[in,out] scheduler The #az_iot_provisioning_client_scheduler to use for this call.
+ * @param[in,out] registration The #az_iot_provisioning_client_registration to stop.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The registration is no longer in progress.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The registration isn't in progress.
+ */
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_remove(
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* registration);
+
+/**
+ * @brief Gets the earliest time at which a request will be due, or a response will time out.
+ *
+ * @param[in] scheduler The #az_iot_provisioning_client_scheduler to use for this call.
+ * @param[out] out_deadline The earliest deadline, in the application's clock units.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The deadline was returned.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND No registration is in progress.
+ */
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_get_next_deadline(
+    az_iot_provisioning_client_scheduler const* scheduler,
+    int64_t* out_deadline);
+
+/**
+ * @brief Gets one request that is due, for the application to publish.
+ *
+ * @details Call repeatedly until it returns #AZ_ERROR_ITEM_NOT_FOUND to get all the requests that
+ * are due. The registration then waits for the response until the response timeout, after which
+ * the same request is returned again.
+ *
+ * @param[in,out] scheduler The #az_iot_provisioning_client_scheduler to use for this call.
+ * @param[in] now The current time, in the application's clock units.
+ * @param[out] out_registration The registration to publish a request for.
+ * @param[out] out_action The request to publish.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK A request is due.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND No request is due.
+ */
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_get_next(
+    az_iot_provisioning_client_scheduler* scheduler,
+    int64_t now,
+    az_iot_provisioning_client_registration** out_registration,
+    az_iot_provisioning_client_action* out_action);
+
+/**
+ * @brief Moves a registration forward with the response to its last request.
+ *
+ * @details While the operation is assigning, its status is queried after the `retry-after` of the
+ * response. Throttled requests and server errors are published again after their `retry-after`.
+ * Otherwise, the operation is complete, and the registration is no longer in progress.
+ *
+ * @param[in,out] scheduler The #az_iot_provisioning_client_scheduler to use for this call.
+ * @param[in,out] registration The #az_iot_provisioning_client_registration the response was
+ * received for.
+ * @param[in] response The response, from
+ * #az_iot_provisioning_client_parse_received_topic_and_payload().
+ * @param[in] now The current time, in the application's clock units.
+ * @param[out] out_complete Set to `true` when the operation is complete, and the \p response has
+ * its authoritative result.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The response was handled.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The registration isn't in progress.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The operation ID doesn't fit the registration's buffer. The
+ * registration is no longer in progress.
+ */
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_handle_response(
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* registration,
+    az_iot_provisioning_client_register_response const* response,
+    int64_t now,
+    bool* out_complete);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_IOT_PROVISIONING_CLIENT_H
@@ -17,8 +17,11 @@
 
 #include <azure/core/az_result.h>
 #include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/iot/az_iot_common.h>
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include <azure/core/_az_cfg_prefix.h>
@@ -41,6 +44,32 @@ AZ_NODISCARD int32_t _az_iot_u32toa_size(uint32_t number);
  */
 AZ_NODISCARD int32_t _az_iot_u64toa_size(uint64_t number);
 
+/**
+ * @brief Checks the buffer of a function writing an MQTT string, which is either at least one
+ * byte, or `NULL` of size 0 to measure the string, in which case its length is needed.
+ */
+#define _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(buffer, buffer_size, out_length) \
+  _az_PRECONDITION(                                                            \
+      ((buffer) != NULL && (buffer_size) > 0)                                  \
+      || ((buffer) == NULL && (buffer_size) == 0 && (out_length) != NULL))
+
+/**
+ * @brief In measure mode, with a `NULL` buffer, returns #AZ_OK from the function writing an MQTT
+ * string once its length is set to `required_length`, which is only evaluated then.
+ */
+#define _az_IOT_RETURN_IF_MEASURING(buffer, required_length, out_length) \
+  do                                                                    \
+  {                                                                     \
+    if ((buffer) == NULL)                                               \
+    {                                                                   \
+      if ((out_length) != NULL)                                         \
+      {                                                                 \
+        *(out_length) = (size_t)(required_length);                      \
+      }                                                                 \
+      return AZ_OK;                                                     \
+    }                                                                   \
+  } while (0)
+
 /**
  * @brief Copies the url-encoded content of `source` span into `destination`, returning the free
  * remaining of `destination`.
@@ -54,6 +83,31 @@ AZ_NODISCARD int32_t _az_iot_u64toa_size(uint64_t number);
 AZ_NODISCARD az_result
 _az_span_copy_url_encode(az_span destination, az_span source, az_span* out_remainder);
 
+/**
+ * @brief Computes the HMAC-SHA256 hash of `data` with the key of `sas_key`, through the function
+ * set by az_iot_set_hmac_sha256_callback(), if any.
+ *
+ * @param[in] sas_key The #az_iot_sas_key to hash with.
+ * @param[in] data The bytes to hash.
+ * @param[out] out_hash The buffer the #AZ_IOT_HMAC_SHA256_SIZE bytes of the hash are written to.
+ * @return An `az_result` value.
+ */
+AZ_NODISCARD az_result
+_az_iot_sas_key_hmac_sha256(az_iot_sas_key const* sas_key, az_span data, uint8_t* out_hash);
+
+/**
+ * @brief Checks whether `source` begins with the content of `prefix`.
+ *
+ * @param[in] source The span to be checked.
+ * @param[in] prefix The expected beginning of `source`.
+ * @return `true` if the first bytes of `source` are equal to `prefix`, `false` otherwise.
+ */
+AZ_NODISCARD AZ_INLINE bool _az_span_starts_with(az_span source, az_span prefix)
+{
+  return az_span_size(source) >= az_span_size(prefix)
+      && az_span_is_content_equal(az_span_slice(source, 0, az_span_size(prefix)), prefix);
+}
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_IOT_CORE_INTERNAL_H
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_iot_hub_client_internal.h
+ *
+ * @brief Azure IoT Hub client internal definitions.
+ *
+ * @note You MUST NOT use any symbols (macros, functions, structures, enums, etc.)
+ * prefixed with an underscore ('_') directly in your application code. These symbols
+ * are part of Azure SDK's internal implementation; we do not document these symbols
+ * and they are subject to change in future versions of the SDK which would break your code.
+ */
+
+#ifndef _az_IOT_HUB_CLIENT_INTERNAL_H
+#define _az_IOT_HUB_CLIENT_INTERNAL_H
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/*
+ * The settings of a client, which compact clients read from their #az_iot_hub_client_config.
+ */
+
+AZ_NODISCARD AZ_INLINE az_span _az_iot_hub_client_get_hostname(az_iot_hub_client const* client)
+{
+#ifdef AZ_IOT_HUB_CLIENT_COMPACT
+  return client->_internal.config->_internal.iot_hub_hostname;
+#else
+  return client->_internal.iot_hub_hostname;
+#endif // AZ_IOT_HUB_CLIENT_COMPACT
+}
+
+AZ_NODISCARD AZ_INLINE az_span _az_iot_hub_client_get_module_id(az_iot_hub_client const* client)
+{
+#ifdef AZ_IOT_HUB_CLIENT_COMPACT
+  return client->_internal.module_id;
+#else
+  return client->_internal.options.module_id;
+#endif // AZ_IOT_HUB_CLIENT_COMPACT
+}
+
+AZ_NODISCARD AZ_INLINE az_span _az_iot_hub_client_get_user_agent(az_iot_hub_client const* client)
+{
+#ifdef AZ_IOT_HUB_CLIENT_COMPACT
+  return client->_internal.config->_internal.user_agent;
+#else
+  return client->_internal.options.user_agent;
+#endif // AZ_IOT_HUB_CLIENT_COMPACT
+}
+
+AZ_NODISCARD AZ_INLINE az_span _az_iot_hub_client_get_model_id(az_iot_hub_client const* client)
+{
+#ifdef AZ_IOT_HUB_CLIENT_COMPACT
+  return client->_internal.config->_internal.model_id;
+#else
+  return client->_internal.options.model_id;
+#endif // AZ_IOT_HUB_CLIENT_COMPACT
+}
+
+/**
+ * @brief Parses the C2D properties of a received topic.
+ *
+ * @param[in] topic_suffix The portion of the received topic that follows
+ * `/messages/devicebound/`.
+ * @param[out] out_request The #az_iot_hub_client_c2d_request to populate.
+ * @return An #az_result value indicating the result of the operation.
+ */
+AZ_NODISCARD az_result _az_iot_hub_client_c2d_parse_topic_suffix(
+    az_span topic_suffix,
+    az_iot_hub_client_c2d_request* out_request);
+
+/**
+ * @brief Parses the method name and request id of a received topic.
+ *
+ * @param[in] topic_suffix The portion of the received topic that follows `$iothub/methods/POST/`.
+ * @param[out] out_request The #az_iot_hub_client_method_request to populate.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_ERROR_IOT_TOPIC_NO_MATCH The request id is missing.
+ */
+AZ_NODISCARD az_result _az_iot_hub_client_methods_parse_topic_suffix(
+    az_span topic_suffix,
+    az_iot_hub_client_method_request* out_request);
+
+/**
+ * @brief Parses a twin response or desired properties topic.
+ *
+ * @param[in] topic_suffix The portion of the received topic that follows `$iothub/twin/`.
+ * @param[out] out_response The #az_iot_hub_client_twin_response to populate.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_ERROR_IOT_TOPIC_NO_MATCH The topic is neither a twin response nor a desired
+ * properties notification.
+ */
+AZ_NODISCARD az_result _az_iot_hub_client_twin_parse_topic_suffix(
+    az_span topic_suffix,
+    az_iot_hub_client_twin_response* out_response);
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_IOT_HUB_CLIENT_INTERNAL_H
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#ifndef AZ_BENCHMARK_H
+#define AZ_BENCHMARK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /*
+   * The measurements of one API, over all of its iterations.
+   */
+  typedef struct
+  {
+    char const* name; // The API measured.
+    int32_t iterations; // Number of times the API was called.
+    uint32_t cycles; // CPU cycles spent in all the iterations.
+    int32_t bytes; // Input bytes processed in all the iterations.
+    int32_t stack_bytes; // Peak stack used by one call, approximated by painting the stack.
+                         // Capped at the painted size, 2 KB.
+  } az_benchmark_result;
+
+  typedef void (*az_benchmark_report_fn)(az_benchmark_result const* result);
+
+  /*
+   * Returns the CPU cycle counter. Provided by the sketch of each board.
+   */
+  uint32_t az_benchmark_get_cycles(void);
+
+  /*
+   * Runs the JSON, span and IoT topic benchmarks, calling report for each of them.
+   *
+   * Returns 0 on success, non-zero if any of the APIs failed. The 32-bit cycle counter wraps after
+   * about 20 seconds at 200 MHz, so keep the iterations low enough for each API to complete
+   * before then.
+   */
+  int az_benchmark_run(int32_t iterations, az_benchmark_report_fn report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AZ_BENCHMARK_H
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <Arduino.h>
+
+#include "az_benchmark.h"
+
+// Number of calls of each API. Keep the slowest API under the wrap of the 32-bit cycle counter,
+// about 26 seconds at 160 MHz.
+#define BENCHMARK_ITERATIONS 1000
+
+static uint32_t cpu_frequency_mhz;
+
+// The Xtensa CCOUNT register, incremented on every CPU cycle.
+extern "C" uint32_t az_benchmark_get_cycles(void) { return ESP.getCycleCount(); }
+
+static void report(az_benchmark_result const* result)
+{
+  uint32_t const cycles_per_call = result->cycles / (uint32_t)result->iterations;
+  uint32_t const ns_per_call = (uint32_t)(((uint64_t)cycles_per_call * 1000) / cpu_frequency_mhz);
+  uint32_t const kb_per_second = result->cycles == 0
+      ? 0
+      : (uint32_t)(((uint64_t)result->bytes * cpu_frequency_mhz * 1000000) / result->cycles / 1024);
+
+  char line[160];
+  snprintf(
+      line,
+      sizeof(line),
+      "%-48s %10lu %10lu %10lu %8ld",
+      result->name,
+      (unsigned long)cycles_per_call,
+      (unsigned long)ns_per_call,
+      (unsigned long)kb_per_second,
+      (long)result->stack_bytes);
+  Serial.println(line);
+
+  // The serial output is slow, let the watchdog be fed between the benchmarks.
+  yield();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  cpu_frequency_mhz = ESP.getCpuFreqMHz();
+
+  Serial.print("Azure SDK for Embedded C benchmarks, ESP8266 at ");
+  Serial.print(cpu_frequency_mhz);
+  Serial.print(" MHz, ");
+  Serial.print(BENCHMARK_ITERATIONS);
+  Serial.println(" iterations.");
+
+  char header[160];
+  snprintf(
+      header,
+      sizeof(header),
+      "%-48s %10s %10s %10s %8s",
+      "api",
+      "cycles/op",
+      "ns/op",
+      "KB/s",
+      "stack");
+  Serial.println(header);
+
+  if (az_benchmark_run(BENCHMARK_ITERATIONS, report) != 0)
+  {
+    Serial.println("Benchmark FAILED");
+  }
+  else
+  {
+    Serial.println("Benchmark done. Run report_flash_footprint.sh on the sketch ELF for the flash "
+                   "footprint of each API.");
+  }
+}
+
+void loop() { delay(1000); }
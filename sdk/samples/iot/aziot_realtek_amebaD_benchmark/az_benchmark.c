@@ -0,0 +1,288 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/*
+ * Board independent benchmarks of the Azure SDK for Embedded C, run by the benchmark sketches.
+ * This file is the same for every board.
+ */
+
+#include <stdint.h>
+
+#include <az_iot_hub_client.h>
+#include <az_json.h>
+#include <az_result.h>
+#include <az_span.h>
+
+#include "az_benchmark.h"
+
+// The size of the stack painted below the frame of the benchmarks. It must be smaller than the
+// stack left to the sketch (4 KB in total on the ESP8266). The top of it, where the painting
+// function has its own frame, is left alone.
+#define AZ_BENCHMARK_STACK_PAINT_SIZE 2048
+#define AZ_BENCHMARK_STACK_PAINT_MARGIN 64
+#define AZ_BENCHMARK_STACK_PAINT 0xA5
+
+#define AZ_BENCHMARK_NOINLINE __attribute__((noinline))
+
+typedef az_result (*az_benchmark_fn)(void);
+
+static az_iot_hub_client benchmark_client;
+static uint8_t benchmark_buffer[256];
+static uint8_t* benchmark_stack_top;
+
+// Accumulates values read from the results, so that the compiler can't discard the calls.
+static volatile int32_t benchmark_sink;
+
+static az_span const benchmark_twin_document = AZ_SPAN_LITERAL_FROM_STR(
+    "{\"desired\":{\"targetTemperature\":21.5,\"telemetryInterval\":60,\"thermostat1\":{"
+    "\"__t\":\"c\",\"targetTemperature\":23.0},\"$version\":42},\"reported\":{"
+    "\"manufacturer\":\"contoso\",\"model\":\"thermostat\",\"swVersion\":\"1.0.3\","
+    "\"maxTempSinceLastReboot\":31.25,\"$version\":17}}");
+
+static az_span const benchmark_c2d_topic = AZ_SPAN_LITERAL_FROM_STR(
+    "devices/my_device/messages/devicebound/%24.mid=79eadb01-bd0d-472d-bd35-ccb76e70eab8&%24.to="
+    "%2Fdevices%2Fmy_device%2Fmessages%2FdeviceBound&%24.ct=application%2Fjson&alert=temperature");
+
+static az_span const benchmark_method_topic
+    = AZ_SPAN_LITERAL_FROM_STR("$iothub/methods/POST/getMaxMinReport/?$rid=2a");
+
+static az_span const benchmark_twin_topic
+    = AZ_SPAN_LITERAL_FROM_STR("$iothub/twin/res/204/?$rid=8&$version=43");
+
+static az_result benchmark_json_reader(void)
+{
+  az_json_reader reader;
+  az_result result = az_json_reader_init(&reader, benchmark_twin_document, NULL);
+  while (az_result_succeeded(result)
+         && az_result_succeeded(result = az_json_reader_next_token(&reader)))
+  {
+    benchmark_sink += (int32_t)reader.token.kind;
+  }
+
+  return result == AZ_ERROR_JSON_READER_DONE ? AZ_OK : result;
+}
+
+static az_result benchmark_json_writer(void)
+{
+  az_json_writer writer;
+  az_result result = az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(benchmark_buffer), NULL);
+  if (az_result_succeeded(result))
+  {
+    result = az_json_writer_append_begin_object(&writer);
+  }
+  if (az_result_succeeded(result))
+  {
+    result = az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("temperature"));
+  }
+  if (az_result_succeeded(result))
+  {
+    result = az_json_writer_append_double(&writer, 21.5, 2);
+  }
+  if (az_result_succeeded(result))
+  {
+    result = az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("msgCount"));
+  }
+  if (az_result_succeeded(result))
+  {
+    result = az_json_writer_append_int32(&writer, 12345);
+  }
+  if (az_result_succeeded(result))
+  {
+    result = az_json_writer_append_end_object(&writer);
+  }
+
+  benchmark_sink += az_span_size(az_json_writer_get_bytes_used_in_destination(&writer));
+  return result;
+}
+
+static az_result benchmark_span_numbers(void)
+{
+  az_span remainder;
+  az_result result
+      = az_span_u32toa(AZ_SPAN_FROM_BUFFER(benchmark_buffer), 4294967295U, &remainder);
+  if (az_result_succeeded(result))
+  {
+    uint32_t number = 0;
+    result = az_span_atou32(
+        az_span_slice(
+            AZ_SPAN_FROM_BUFFER(benchmark_buffer),
+            0,
+            (int32_t)sizeof(benchmark_buffer) - az_span_size(remainder)),
+        &number);
+    benchmark_sink += (int32_t)number;
+  }
+
+  return result;
+}
+
+static az_result benchmark_span_find(void)
+{
+  benchmark_sink += az_span_find(benchmark_c2d_topic, AZ_SPAN_FROM_STR("alert="));
+  return AZ_OK;
+}
+
+static az_result benchmark_c2d_parse(void)
+{
+  az_iot_hub_client_c2d_request request;
+  az_result result = az_iot_hub_client_c2d_parse_received_topic(
+      &benchmark_client, benchmark_c2d_topic, &request);
+  if (az_result_succeeded(result))
+  {
+    az_span value;
+    result = az_iot_message_properties_find(&request.properties, AZ_SPAN_FROM_STR("alert"), &value);
+    benchmark_sink += az_span_size(value);
+  }
+
+  return result;
+}
+
+static az_result benchmark_methods_parse(void)
+{
+  az_iot_hub_client_method_request request;
+  az_result const result = az_iot_hub_client_methods_parse_received_topic(
+      &benchmark_client, benchmark_method_topic, &request);
+  benchmark_sink += az_span_size(request.name);
+  return result;
+}
+
+static az_result benchmark_twin_parse(void)
+{
+  az_iot_hub_client_twin_response response;
+  az_result const result = az_iot_hub_client_twin_parse_received_topic(
+      &benchmark_client, benchmark_twin_topic, &response);
+  benchmark_sink += (int32_t)response.status;
+  return result;
+}
+
+static az_result benchmark_telemetry_topic(void)
+{
+  size_t length = 0;
+  az_result const result = az_iot_hub_client_telemetry_get_publish_topic(
+      &benchmark_client, NULL, (char*)benchmark_buffer, sizeof(benchmark_buffer), &length);
+  benchmark_sink += (int32_t)length;
+  return result;
+}
+
+static az_result benchmark_sas_signature(void)
+{
+  az_span signature;
+  az_result const result = az_iot_hub_client_sas_get_signature(
+      &benchmark_client, 1596000000, AZ_SPAN_FROM_BUFFER(benchmark_buffer), &signature);
+  benchmark_sink += az_span_size(signature);
+  return result;
+}
+
+// Fills the free stack below the frame of the caller with a known pattern. The stack grows down on
+// both the Xtensa and the ARM cores.
+static AZ_BENCHMARK_NOINLINE void benchmark_paint_stack(void)
+{
+  uint8_t* const frame = (uint8_t*)__builtin_frame_address(0);
+  benchmark_stack_top = frame;
+  for (volatile uint8_t* p = frame - AZ_BENCHMARK_STACK_PAINT_SIZE;
+       p < frame - AZ_BENCHMARK_STACK_PAINT_MARGIN;
+       p++)
+  {
+    *p = AZ_BENCHMARK_STACK_PAINT;
+  }
+}
+
+// Returns how deep below the frame of the caller the pattern was overwritten. A result of
+// AZ_BENCHMARK_STACK_PAINT_SIZE means that at least that much stack was used.
+static AZ_BENCHMARK_NOINLINE int32_t benchmark_measure_stack(void)
+{
+  volatile uint8_t const* p = benchmark_stack_top - AZ_BENCHMARK_STACK_PAINT_SIZE;
+  while (p < benchmark_stack_top - AZ_BENCHMARK_STACK_PAINT_MARGIN
+         && *p == AZ_BENCHMARK_STACK_PAINT)
+  {
+    p++;
+  }
+
+  return (int32_t)(benchmark_stack_top - p);
+}
+
+static int benchmark_run_one(
+    char const* name,
+    az_benchmark_fn fn,
+    int32_t bytes_per_call,
+    int32_t iterations,
+    az_benchmark_report_fn report)
+{
+  az_benchmark_result result = { name, iterations, 0, bytes_per_call * iterations, 0 };
+
+  // A single call on a painted stack tells its peak stack use.
+  benchmark_paint_stack();
+  if (az_result_failed(fn()))
+  {
+    return 1;
+  }
+  result.stack_bytes = benchmark_measure_stack();
+
+  uint32_t const start = az_benchmark_get_cycles();
+  for (int32_t i = 0; i < iterations; i++)
+  {
+    if (az_result_failed(fn()))
+    {
+      return 1;
+    }
+  }
+  result.cycles = az_benchmark_get_cycles() - start;
+
+  report(&result);
+  return 0;
+}
+
+int az_benchmark_run(int32_t iterations, az_benchmark_report_fn report)
+{
+  if (az_result_failed(az_iot_hub_client_init(
+          &benchmark_client,
+          AZ_SPAN_FROM_STR("myiothub.azure-devices.net"),
+          AZ_SPAN_FROM_STR("my_device"),
+          NULL)))
+  {
+    return 1;
+  }
+
+  int result = 0;
+  result |= benchmark_run_one(
+      "az_json_reader_next_token",
+      benchmark_json_reader,
+      az_span_size(benchmark_twin_document),
+      iterations,
+      report);
+  result |= benchmark_run_one("az_json_writer", benchmark_json_writer, 0, iterations, report);
+  result |= benchmark_run_one(
+      "az_span_u32toa+az_span_atou32", benchmark_span_numbers, 0, iterations, report);
+  result |= benchmark_run_one(
+      "az_span_find",
+      benchmark_span_find,
+      az_span_size(benchmark_c2d_topic),
+      iterations,
+      report);
+  result |= benchmark_run_one(
+      "az_iot_hub_client_c2d_parse_received_topic",
+      benchmark_c2d_parse,
+      az_span_size(benchmark_c2d_topic),
+      iterations,
+      report);
+  result |= benchmark_run_one(
+      "az_iot_hub_client_methods_parse_received_topic",
+      benchmark_methods_parse,
+      az_span_size(benchmark_method_topic),
+      iterations,
+      report);
+  result |= benchmark_run_one(
+      "az_iot_hub_client_twin_parse_received_topic",
+      benchmark_twin_parse,
+      az_span_size(benchmark_twin_topic),
+      iterations,
+      report);
+  result |= benchmark_run_one(
+      "az_iot_hub_client_telemetry_get_publish_topic",
+      benchmark_telemetry_topic,
+      0,
+      iterations,
+      report);
+  result |= benchmark_run_one(
+      "az_iot_hub_client_sas_get_signature", benchmark_sas_signature, 0, iterations, report);
+  return result;
+}
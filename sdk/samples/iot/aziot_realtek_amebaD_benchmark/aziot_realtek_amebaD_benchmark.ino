@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <Arduino.h>
+
+#include "az_benchmark.h"
+
+// Number of calls of each API. Keep the slowest API under the wrap of the 32-bit cycle counter,
+// about 21 seconds at 200 MHz.
+#define BENCHMARK_ITERATIONS 1000
+
+// The frequency of the KM4 core, which runs the Arduino sketch.
+#define BENCHMARK_CPU_FREQUENCY_MHZ 200
+
+// The Data Watchpoint and Trace unit of the Cortex-M33, whose CYCCNT register is incremented on
+// every CPU cycle once enabled.
+#define BENCHMARK_DEMCR (*(volatile uint32_t*)0xE000EDFC)
+#define BENCHMARK_DEMCR_TRCENA (1UL << 24)
+#define BENCHMARK_DWT_CTRL (*(volatile uint32_t*)0xE0001000)
+#define BENCHMARK_DWT_CTRL_CYCCNTENA (1UL << 0)
+#define BENCHMARK_DWT_CYCCNT (*(volatile uint32_t*)0xE0001004)
+
+static void enableCycleCounter()
+{
+  BENCHMARK_DEMCR |= BENCHMARK_DEMCR_TRCENA;
+  BENCHMARK_DWT_CYCCNT = 0;
+  BENCHMARK_DWT_CTRL |= BENCHMARK_DWT_CTRL_CYCCNTENA;
+}
+
+extern "C" uint32_t az_benchmark_get_cycles(void) { return BENCHMARK_DWT_CYCCNT; }
+
+static void report(az_benchmark_result const* result)
+{
+  uint32_t const cycles_per_call = result->cycles / (uint32_t)result->iterations;
+  uint32_t const ns_per_call
+      = (uint32_t)(((uint64_t)cycles_per_call * 1000) / BENCHMARK_CPU_FREQUENCY_MHZ);
+  uint32_t const kb_per_second = result->cycles == 0
+      ? 0
+      : (uint32_t)(((uint64_t)result->bytes * BENCHMARK_CPU_FREQUENCY_MHZ * 1000000)
+                   / result->cycles / 1024);
+
+  char line[160];
+  snprintf(
+      line,
+      sizeof(line),
+      "%-48s %10lu %10lu %10lu %8ld",
+      result->name,
+      (unsigned long)cycles_per_call,
+      (unsigned long)ns_per_call,
+      (unsigned long)kb_per_second,
+      (long)result->stack_bytes);
+  Serial.println(line);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  enableCycleCounter();
+
+  Serial.print("Azure SDK for Embedded C benchmarks, AmebaD KM4 at ");
+  Serial.print(BENCHMARK_CPU_FREQUENCY_MHZ);
+  Serial.print(" MHz, ");
+  Serial.print(BENCHMARK_ITERATIONS);
+  Serial.println(" iterations.");
+
+  char header[160];
+  snprintf(
+      header,
+      sizeof(header),
+      "%-48s %10s %10s %10s %8s",
+      "api",
+      "cycles/op",
+      "ns/op",
+      "KB/s",
+      "stack");
+  Serial.println(header);
+
+  if (az_benchmark_run(BENCHMARK_ITERATIONS, report) != 0)
+  {
+    Serial.println("Benchmark FAILED");
+  }
+  else
+  {
+    Serial.println("Benchmark done. Run report_flash_footprint.sh on the sketch ELF for the flash "
+                   "footprint of each API.");
+  }
+}
+
+void loop() { delay(1000); }
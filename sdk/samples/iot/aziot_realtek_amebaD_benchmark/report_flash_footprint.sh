@@ -0,0 +1,21 @@
+#!/bin/bash
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# SPDX-License-Identifier: MIT
+
+# Prints the flash footprint of the Azure SDK for Embedded C functions linked in a sketch, biggest
+# first, followed by the total. The ELF is left in the build folder printed by the Arduino IDE
+# when "Show verbose output during compilation" is enabled in its preferences.
+#
+# Usage: report_flash_footprint.sh <sketch ELF> [nm tool]
+
+if [ -z "$1" ]; then
+  echo >&2 "Usage: $0 <sketch ELF> [nm tool]"
+  exit 1
+fi
+
+NM=${2:-arm-none-eabi-nm}
+command -v "$NM" >/dev/null 2>&1 || { echo >&2 "Please add $NM, from the board toolchain, to the PATH."; exit 1; }
+
+# Code (t) and read-only data (r) symbols of the SDK, with their size.
+"$NM" --print-size --size-sort --reverse-sort --radix=d "$1" \
+  | awk '$3 ~ /^[tTrR]$/ && $4 ~ /^_?az_/ { printf "%8d %s\n", $2, $4; total += $2 } END { printf "%8d total\n", total }'
@@ -24,12 +24,8 @@
 #include <unistd.h>
 #endif
 
-#include <openssl/bio.h>
-#include <openssl/buffer.h>
-#include <openssl/evp.h>
-#include <openssl/hmac.h>
-
 #include <azure/az_core.h>
+#include <azure/az_iot.h>
 
 #include "iot_sample_common.h"
 
@@ -161,6 +157,7 @@ void iot_sample_read_environment_variables(
       case PAHO_IOT_HUB_METHODS_SAMPLE:
       case PAHO_IOT_HUB_PNP_COMPONENT_SAMPLE:
       case PAHO_IOT_HUB_PNP_SAMPLE:
+      case PAHO_IOT_HUB_TELEMETRY_ASYNC_SAMPLE:
       case PAHO_IOT_HUB_TELEMETRY_SAMPLE:
       case PAHO_IOT_HUB_TWIN_SAMPLE:
         out_env_vars->hub_device_id = AZ_SPAN_FROM_BUFFER(iot_sample_hub_device_id_buffer);
@@ -373,167 +370,6 @@ uint32_t iot_sample_get_epoch_expiration_time_from_minutes(uint32_t minutes)
   return (uint32_t)(time(NULL) + minutes * 60);
 }
 
-static void decode_base64_bytes(
-    az_span base64_encoded_bytes,
-    az_span decoded_bytes,
-    az_span* out_decoded_bytes)
-{
-  BIO* base64_decoder;
-  BIO* source_mem_bio;
-
-  memset(az_span_ptr(decoded_bytes), 0, (size_t)az_span_size(decoded_bytes));
-
-  // Create a BIO filter to process the bytes.
-  base64_decoder = BIO_new(BIO_f_base64());
-  if (base64_decoder == NULL)
-  {
-    IOT_SAMPLE_LOG_ERROR("Could not decode the SAS key: Failed to create BIO.");
-    exit(1);
-  }
-
-  // Get the source BIO to push through the filter.
-  source_mem_bio
-      = BIO_new_mem_buf(az_span_ptr(base64_encoded_bytes), (int)az_span_size(base64_encoded_bytes));
-  if (source_mem_bio == NULL)
-  {
-    BIO_free(base64_decoder);
-    IOT_SAMPLE_LOG_ERROR("Could not decode the SAS key: Failed to create BIO new memory buffer.");
-    exit(1);
-  }
-
-  // Push the memory through the filter.
-  source_mem_bio = BIO_push(base64_decoder, source_mem_bio);
-  if (source_mem_bio == NULL)
-  {
-    BIO_free(base64_decoder);
-    BIO_free(source_mem_bio);
-    IOT_SAMPLE_LOG_ERROR("Could not decode the SAS key: Failed to push memory through filter.");
-    exit(1);
-  }
-
-  // Set flags to not have a newline and close the BIO.
-  BIO_set_flags(source_mem_bio, BIO_FLAGS_BASE64_NO_NL);
-  BIO_set_close(source_mem_bio, BIO_CLOSE);
-
-  // Read the memory which was pushed through the filter.
-  int read_data = BIO_read(source_mem_bio, az_span_ptr(decoded_bytes), az_span_size(decoded_bytes));
-
-  // Set the output span.
-  if (read_data > 0)
-  {
-    *out_decoded_bytes = az_span_create(az_span_ptr(decoded_bytes), (int32_t)read_data);
-  }
-  else
-  {
-    IOT_SAMPLE_LOG_ERROR("Could not decode the SAS key: Data could not be read from BIO.");
-    exit(1);
-  }
-
-  // Free the BIO chain.
-  BIO_free_all(source_mem_bio);
-}
-
-static void hmac_sha256_sign_signature(
-    az_span decoded_key,
-    az_span signature,
-    az_span signed_signature,
-    az_span* out_signed_signature)
-{
-  unsigned int hmac_encode_len;
-  unsigned char const* hmac = HMAC(
-      EVP_sha256(),
-      (void*)az_span_ptr(decoded_key),
-      az_span_size(decoded_key),
-      az_span_ptr(signature),
-      (size_t)az_span_size(signature),
-      az_span_ptr(signed_signature),
-      &hmac_encode_len);
-
-  if (hmac != NULL)
-  {
-    *out_signed_signature = az_span_create(az_span_ptr(signed_signature), (int32_t)hmac_encode_len);
-  }
-  else
-  {
-    IOT_SAMPLE_LOG_ERROR("Could not sign the signature: Buffer is too small.");
-    exit(1);
-  }
-}
-
-static void base64_encode_bytes(
-    az_span decoded_bytes,
-    az_span base64_encoded_bytes,
-    az_span* out_base64_encoded_bytes)
-{
-  BIO* base64_encoder;
-  BIO* sink_mem_bio;
-  BUF_MEM* encoded_mem_ptr;
-
-  // Create a BIO filter to process the bytes.
-  base64_encoder = BIO_new(BIO_f_base64());
-  if (base64_encoder == NULL)
-  {
-    IOT_SAMPLE_LOG_ERROR("Could not base64 encode the password: Failed to create BIO.");
-    exit(1);
-  }
-
-  // Create a memory sink BIO to process bytes to.
-  sink_mem_bio = BIO_new(BIO_s_mem());
-  if (sink_mem_bio == NULL)
-  {
-    BIO_free(base64_encoder);
-    IOT_SAMPLE_LOG_ERROR("Could not base64 encode the password: Failed to create BIO.");
-    exit(1);
-  }
-
-  // Push the sink to the encoder.
-  base64_encoder = BIO_push(base64_encoder, sink_mem_bio);
-  if (base64_encoder == NULL)
-  {
-    BIO_free(sink_mem_bio);
-    BIO_free(base64_encoder);
-    IOT_SAMPLE_LOG_ERROR(
-        "Could not base64 encode the password: Failed to push memory through filter.");
-    exit(1);
-  }
-
-  // Set no newline flag for the encoder.
-  BIO_set_flags(base64_encoder, BIO_FLAGS_BASE64_NO_NL);
-
-  // Write the bytes to be encoded.
-  int const bytes_written
-      = BIO_write(base64_encoder, az_span_ptr(decoded_bytes), (int)az_span_size(decoded_bytes));
-  if (bytes_written < 1)
-  {
-    BIO_free(sink_mem_bio);
-    BIO_free(base64_encoder);
-    IOT_SAMPLE_LOG_ERROR("Could not base64 encode the password: Failed to write bytes.");
-    exit(1);
-  }
-
-  // Flush the BIO
-  BIO_flush(base64_encoder);
-
-  // Get the pointer to the encoded bytes.
-  BIO_get_mem_ptr(base64_encoder, &encoded_mem_ptr);
-
-  if ((size_t)az_span_size(base64_encoded_bytes) >= encoded_mem_ptr->length)
-  {
-    // Copy the bytes to the output and initialize output span.
-    memcpy(az_span_ptr(base64_encoded_bytes), encoded_mem_ptr->data, encoded_mem_ptr->length);
-    *out_base64_encoded_bytes
-        = az_span_create(az_span_ptr(base64_encoded_bytes), (int32_t)encoded_mem_ptr->length);
-  }
-  else
-  {
-    IOT_SAMPLE_LOG_ERROR("Could not base64 encode the password: Buffer is too small.");
-    exit(1);
-  }
-
-  // Free the BIO chain.
-  BIO_free_all(base64_encoder);
-}
-
 void iot_sample_generate_sas_base64_encoded_signed_signature(
     az_span sas_base64_encoded_key,
     az_span sas_signature,
@@ -543,19 +379,26 @@ void iot_sample_generate_sas_base64_encoded_signed_signature(
   IOT_SAMPLE_PRECONDITION_NOT_NULL(out_sas_base64_encoded_signed_signature);
 
   // Decode the sas base64 encoded key to use for HMAC signing.
-  char sas_decoded_key_buffer[64];
-  az_span sas_decoded_key = AZ_SPAN_FROM_BUFFER(sas_decoded_key_buffer);
-  decode_base64_bytes(sas_base64_encoded_key, sas_decoded_key, &sas_decoded_key);
-
-  // HMAC-SHA256 sign the signature with the decoded key.
-  char sas_hmac256_signed_signature_buffer[128];
-  az_span sas_hmac256_signed_signature = AZ_SPAN_FROM_BUFFER(sas_hmac256_signed_signature_buffer);
-  hmac_sha256_sign_signature(
-      sas_decoded_key, sas_signature, sas_hmac256_signed_signature, &sas_hmac256_signed_signature);
-
-  // Base64 encode the result of the HMAC signing.
-  base64_encode_bytes(
-      sas_hmac256_signed_signature,
-      sas_base64_encoded_signed_signature,
-      out_sas_base64_encoded_signed_signature);
+  uint8_t sas_decoded_key_buffer[64];
+  int32_t sas_decoded_key_size = 0;
+  IOT_SAMPLE_EXIT_IF_AZ_FAILED(
+      az_iot_base64_decode(
+          AZ_SPAN_FROM_BUFFER(sas_decoded_key_buffer),
+          sas_base64_encoded_key,
+          &sas_decoded_key_size),
+      "Could not decode the SAS key");
+
+  // HMAC-SHA256 sign the signature with the decoded key, and base64 encode the result.
+  az_iot_sas_key sas_key;
+  IOT_SAMPLE_EXIT_IF_AZ_FAILED(
+      az_iot_sas_key_init(&sas_key, az_span_create(sas_decoded_key_buffer, sas_decoded_key_size)),
+      "Could not initialize the SAS key");
+
+  IOT_SAMPLE_EXIT_IF_AZ_FAILED(
+      az_iot_sas_key_sign(
+          &sas_key,
+          sas_signature,
+          sas_base64_encoded_signed_signature,
+          out_sas_base64_encoded_signed_signature),
+      "Could not sign the signature");
 }
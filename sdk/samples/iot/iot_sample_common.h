@@ -152,6 +152,7 @@ typedef enum
   PAHO_IOT_HUB_PNP_COMPONENT_SAMPLE,
   PAHO_IOT_HUB_PNP_SAMPLE,
   PAHO_IOT_HUB_SAS_TELEMETRY_SAMPLE,
+  PAHO_IOT_HUB_TELEMETRY_ASYNC_SAMPLE,
   PAHO_IOT_HUB_TELEMETRY_SAMPLE,
   PAHO_IOT_HUB_TWIN_SAMPLE,
   PAHO_IOT_PROVISIONING_SAMPLE,
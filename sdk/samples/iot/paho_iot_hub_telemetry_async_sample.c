@@ -0,0 +1,607 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+// Required for CRITICAL_SECTION
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(push)
+// warning C4201: nonstandard extension used: nameless struct/union
+#pragma warning(disable : 4201)
+#endif
+#include <paho-mqtt/MQTTAsync.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <azure/az_core.h>
+#include <azure/az_iot.h>
+
+#include "iot_sample_common.h"
+
+#define SAMPLE_TYPE PAHO_IOT_HUB
+#define SAMPLE_NAME PAHO_IOT_HUB_TELEMETRY_ASYNC_SAMPLE
+
+#define MAX_TELEMETRY_MESSAGE_COUNT 100
+#define PIPELINED_WINDOW_CAPACITY 16 // Must be a power of two.
+#define PUBACK_TIMEOUT_MS (30 * 1000)
+#define EVENT_LOOP_WAIT_MS 100
+#define EVENT_QUEUE_CAPACITY 64
+#define MQTT_TIMEOUT_DISCONNECT_MS (10 * 1000)
+#define MAX_RETRY_JITTER_MS 5000
+#define MQTT_PUBLISH_QOS 1 // The in-flight window tracks QoS 1 PUBACKs.
+
+// The events the Paho callbacks hand over to the event loop.
+typedef enum
+{
+  SAMPLE_EVENT_CONNECTED,
+  SAMPLE_EVENT_CONNECT_FAILED,
+  SAMPLE_EVENT_CONNECTION_LOST,
+  SAMPLE_EVENT_PUBACK,
+} sample_event_type;
+
+typedef struct
+{
+  sample_event_type type;
+  int code; // The CONNACK return code, or the Paho return code of a failure.
+  uint16_t packet_id; // The in-flight window packet identifier of a PUBACK.
+} sample_event;
+
+static iot_sample_environment_variables env_vars;
+static az_iot_hub_client hub_client;
+static MQTTAsync mqtt_client;
+static char mqtt_client_username_buffer[128];
+static char telemetry_topic_buffer[128];
+
+static az_iot_connection connection;
+static az_iot_inflight_publish inflight_publishes[PIPELINED_WINDOW_CAPACITY];
+static az_iot_inflight_window inflight_window;
+
+// The Paho callbacks run on the Paho thread: they only queue an event and wake up the event loop,
+// which owns all the state above.
+static sample_event event_queue[EVENT_QUEUE_CAPACITY];
+static int32_t event_queue_head;
+static int32_t event_queue_count;
+static az_platform_event event_queue_signal;
+#ifdef _WIN32
+static CRITICAL_SECTION event_queue_lock;
+#else
+static pthread_mutex_t event_queue_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+// Functions
+static void create_and_configure_mqtt_client(void);
+static void connect_mqtt_client_to_iot_hub(void);
+static void send_telemetry_messages_to_iot_hub(int32_t window_capacity);
+static void disconnect_mqtt_client_from_iot_hub(void);
+
+static void run_event_loop_once(void);
+static void handle_connection_event(az_iot_connection_event event);
+static void perform_connection_action(az_iot_connection_action action);
+static void publish_telemetry_message(int32_t message_index, uint16_t packet_id);
+static int64_t get_clock_msec(void);
+
+static void push_event(sample_event event);
+static bool pop_event(sample_event* out_event);
+static void on_connect_success(void* context, MQTTAsync_successData* response);
+static void on_connect_failure(void* context, MQTTAsync_failureData* response);
+static void on_connection_lost(void* context, char* cause);
+static int on_message_arrived(
+    void* context,
+    char* topic_name,
+    int topic_name_length,
+    MQTTAsync_message* message);
+static void on_publish_success(void* context, MQTTAsync_successData* response);
+
+/*
+ * This sample sends telemetry messages to the Azure IoT Hub with the asynchronous Paho client.
+ * X509 self-certification is used. Instead of blocking on each operation, the sample runs an event
+ * loop: the connection is driven by an az_iot_connection state machine, and the QoS 1 messages are
+ * published as long as an az_iot_inflight_window has room, while their PUBACKs arrive.
+ *
+ * The messages are sent twice, to compare the throughput of both modes: first with a window of
+ * one message, which waits for each PUBACK before publishing the next message as the blocking
+ * MQTTClient samples do, then with a window of PIPELINED_WINDOW_CAPACITY messages.
+ */
+int main(void)
+{
+  create_and_configure_mqtt_client();
+  IOT_SAMPLE_LOG_SUCCESS("Client created and configured.");
+
+  connect_mqtt_client_to_iot_hub();
+  IOT_SAMPLE_LOG_SUCCESS("Client connected to IoT Hub.\n");
+
+  send_telemetry_messages_to_iot_hub(1);
+  send_telemetry_messages_to_iot_hub(PIPELINED_WINDOW_CAPACITY);
+  IOT_SAMPLE_LOG_SUCCESS("Client sent telemetry messages to IoT Hub.");
+
+  disconnect_mqtt_client_from_iot_hub();
+  IOT_SAMPLE_LOG_SUCCESS("Client disconnected from IoT Hub.");
+
+  return 0;
+}
+
+static void create_and_configure_mqtt_client(void)
+{
+  int rc;
+
+  // Reads in environment variables set by user for purposes of running sample.
+  iot_sample_read_environment_variables(SAMPLE_TYPE, SAMPLE_NAME, &env_vars);
+
+  // Build an MQTT endpoint c-string.
+  char mqtt_endpoint_buffer[128];
+  iot_sample_create_mqtt_endpoint(
+      SAMPLE_TYPE, &env_vars, mqtt_endpoint_buffer, sizeof(mqtt_endpoint_buffer));
+
+  // Initialize the hub client with the default connection options.
+  rc = az_iot_hub_client_init(&hub_client, env_vars.hub_hostname, env_vars.hub_device_id, NULL);
+  if (az_result_failed(rc))
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to initialize hub client: az_result return code 0x%08x.", rc);
+    exit(rc);
+  }
+
+  // Get the MQTT client id used for the MQTT connection.
+  char mqtt_client_id_buffer[128];
+  rc = az_iot_hub_client_get_client_id(
+      &hub_client, mqtt_client_id_buffer, sizeof(mqtt_client_id_buffer), NULL);
+  if (az_result_failed(rc))
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to get MQTT client id: az_result return code 0x%08x.", rc);
+    exit(rc);
+  }
+
+  // Get the Telemetry topic to publish the telemetry messages.
+  rc = az_iot_hub_client_telemetry_get_publish_topic(
+      &hub_client, NULL, telemetry_topic_buffer, sizeof(telemetry_topic_buffer), NULL);
+  if (az_result_failed(rc))
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to get the Telemetry topic: az_result return code 0x%08x.", rc);
+    exit(rc);
+  }
+
+  // Create the event the Paho callbacks wake up the event loop with.
+  rc = az_platform_event_init(&event_queue_signal);
+  if (az_result_failed(rc))
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to create the event: az_result return code 0x%08x.", rc);
+    exit(rc);
+  }
+#ifdef _WIN32
+  InitializeCriticalSection(&event_queue_lock);
+#endif
+
+  // Create the Paho MQTT client.
+  rc = MQTTAsync_create(
+      &mqtt_client, mqtt_endpoint_buffer, mqtt_client_id_buffer, MQTTCLIENT_PERSISTENCE_NONE, NULL);
+  if (rc != MQTTASYNC_SUCCESS)
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to create MQTT client: MQTTAsync return code %d.", rc);
+    exit(rc);
+  }
+
+  rc = MQTTAsync_setCallbacks(mqtt_client, NULL, on_connection_lost, on_message_arrived, NULL);
+  if (rc != MQTTASYNC_SUCCESS)
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to set MQTT callbacks: MQTTAsync return code %d.", rc);
+    exit(rc);
+  }
+
+  // Get the MQTT client username.
+  rc = az_iot_hub_client_get_user_name(
+      &hub_client, mqtt_client_username_buffer, sizeof(mqtt_client_username_buffer), NULL);
+  if (az_result_failed(rc))
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to get MQTT client username: az_result return code 0x%08x.", rc);
+    exit(rc);
+  }
+
+  // This sample only publishes, so the connection is established on CONNACK.
+  az_iot_connection_options connection_options = az_iot_connection_options_default();
+  connection_options.subscribe = false;
+  rc = az_iot_connection_init(&connection, &connection_options);
+  if (az_result_failed(rc))
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to initialize the connection: az_result return code 0x%08x.", rc);
+    exit(rc);
+  }
+}
+
+static void connect_mqtt_client_to_iot_hub(void)
+{
+  handle_connection_event((az_iot_connection_event){ .type = AZ_IOT_CONNECTION_EVENT_START });
+
+  while (az_iot_connection_get_state(&connection) != AZ_IOT_CONNECTION_STATE_CONNECTED)
+  {
+    run_event_loop_once();
+  }
+}
+
+static void send_telemetry_messages_to_iot_hub(int32_t window_capacity)
+{
+  int rc = az_iot_inflight_window_init(
+      &inflight_window, inflight_publishes, window_capacity, PUBACK_TIMEOUT_MS);
+  if (az_result_failed(rc))
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to initialize the window: az_result return code 0x%08x.", rc);
+    exit(rc);
+  }
+
+  int32_t message_count = 0;
+  int64_t const start_msec = get_clock_msec();
+
+  // Publish # of telemetry messages, until all of them are acknowledged.
+  while (message_count < MAX_TELEMETRY_MESSAGE_COUNT
+         || az_iot_inflight_window_count(&inflight_window) > 0)
+  {
+    if (az_iot_connection_get_state(&connection) == AZ_IOT_CONNECTION_STATE_CONNECTED)
+    {
+      // Publish again the messages whose PUBACK didn't arrive in time, in their original order.
+      az_iot_inflight_publish expired;
+      while (az_result_succeeded(
+          az_iot_inflight_window_get_expired(&inflight_window, get_clock_msec(), &expired)))
+      {
+        publish_telemetry_message((int32_t)(intptr_t)expired.context, expired.packet_id);
+      }
+
+      while (message_count < MAX_TELEMETRY_MESSAGE_COUNT
+             && !az_iot_inflight_window_is_full(&inflight_window))
+      {
+        uint16_t packet_id;
+        rc = az_iot_inflight_window_add(
+            &inflight_window, (void*)(intptr_t)message_count, get_clock_msec(), &packet_id);
+        if (az_result_failed(rc))
+        {
+          IOT_SAMPLE_LOG_ERROR("Failed to track the message: az_result return code 0x%08x.", rc);
+          exit(rc);
+        }
+
+        publish_telemetry_message(message_count, packet_id);
+        message_count++;
+      }
+    }
+
+    run_event_loop_once();
+  }
+
+  int64_t const elapsed_msec = get_clock_msec() - start_msec;
+  IOT_SAMPLE_LOG_SUCCESS(
+      "Client published %d messages with a window of %d in %d ms: %.1f messages per second.",
+      MAX_TELEMETRY_MESSAGE_COUNT,
+      window_capacity,
+      (int)elapsed_msec,
+      elapsed_msec > 0 ? MAX_TELEMETRY_MESSAGE_COUNT * 1000.0 / (double)elapsed_msec : 0.0);
+}
+
+static void disconnect_mqtt_client_from_iot_hub(void)
+{
+  MQTTAsync_disconnectOptions mqtt_disconnect_options = MQTTAsync_disconnectOptions_initializer;
+  mqtt_disconnect_options.timeout = MQTT_TIMEOUT_DISCONNECT_MS;
+
+  int rc = MQTTAsync_disconnect(mqtt_client, &mqtt_disconnect_options);
+  if (rc != MQTTASYNC_SUCCESS)
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to disconnect MQTT client: MQTTAsync return code %d.", rc);
+    exit(rc);
+  }
+
+  // Wait for the disconnection to complete before destroying the client.
+  while (MQTTAsync_isConnected(mqtt_client))
+  {
+    az_result const sleep_result = az_platform_sleep_msec(EVENT_LOOP_WAIT_MS);
+    (void)sleep_result;
+  }
+
+  MQTTAsync_destroy(&mqtt_client);
+  az_platform_event_deinit(&event_queue_signal);
+#ifdef _WIN32
+  DeleteCriticalSection(&event_queue_lock);
+#endif
+}
+
+/*
+ * Handles the queued events, then waits for the next event, or the next deadline, whichever comes
+ * first.
+ */
+static void run_event_loop_once(void)
+{
+  int rc;
+  sample_event event;
+  while (pop_event(&event))
+  {
+    switch (event.type)
+    {
+      case SAMPLE_EVENT_CONNECTED:
+        handle_connection_event((az_iot_connection_event){
+            .type = AZ_IOT_CONNECTION_EVENT_CONNACK, .return_code = 0 });
+        break;
+
+      case SAMPLE_EVENT_CONNECT_FAILED:
+        // A positive code is the CONNACK return code, a negative one a transport failure.
+        if (event.code > 0)
+        {
+          handle_connection_event((az_iot_connection_event){
+              .type = AZ_IOT_CONNECTION_EVENT_CONNACK, .return_code = event.code });
+        }
+        else
+        {
+          handle_connection_event(
+              (az_iot_connection_event){ .type = AZ_IOT_CONNECTION_EVENT_DISCONNECT });
+        }
+        break;
+
+      case SAMPLE_EVENT_CONNECTION_LOST:
+        IOT_SAMPLE_LOG("Connection lost, reconnecting.");
+        handle_connection_event(
+            (az_iot_connection_event){ .type = AZ_IOT_CONNECTION_EVENT_DISCONNECT });
+
+        // The messages in flight are published again once reconnected.
+        az_iot_inflight_window_expire_all(&inflight_window);
+        break;
+
+      case SAMPLE_EVENT_PUBACK:
+        // A PUBACK for a message which was published again may arrive twice: the second one isn't
+        // found.
+        rc = az_iot_inflight_window_acknowledge(&inflight_window, event.packet_id, NULL);
+        (void)rc;
+        break;
+    }
+  }
+
+  if (az_iot_connection_get_state(&connection) == AZ_IOT_CONNECTION_STATE_FAILED)
+  {
+    IOT_SAMPLE_LOG_ERROR(
+        "Failed to connect: az_iot_status %d.", (int)az_iot_connection_get_status(&connection));
+    exit(1);
+  }
+
+  int64_t const now_msec = get_clock_msec();
+  int64_t deadline_msec = az_iot_connection_get_deadline(&connection);
+  if (deadline_msec <= now_msec)
+  {
+    handle_connection_event((az_iot_connection_event){ .type = AZ_IOT_CONNECTION_EVENT_TIMEOUT });
+    return;
+  }
+
+  // The messages in flight are only published again while connected.
+  int64_t window_deadline_msec;
+  if (az_iot_connection_get_state(&connection) == AZ_IOT_CONNECTION_STATE_CONNECTED
+      && az_result_succeeded(
+          az_iot_inflight_window_get_next_deadline(&inflight_window, &window_deadline_msec))
+      && window_deadline_msec < deadline_msec)
+  {
+    deadline_msec = window_deadline_msec < now_msec ? now_msec : window_deadline_msec;
+  }
+
+  int32_t const wait_msec = deadline_msec - now_msec < EVENT_LOOP_WAIT_MS
+      ? (int32_t)(deadline_msec - now_msec)
+      : EVENT_LOOP_WAIT_MS;
+
+  bool is_set;
+  az_result const wait_result = az_platform_event_wait(&event_queue_signal, wait_msec, &is_set);
+  (void)wait_result;
+}
+
+static void handle_connection_event(az_iot_connection_event event)
+{
+  az_iot_connection_action action;
+  int rc = az_iot_connection_handle_event(
+      &connection, event, get_clock_msec(), rand() % MAX_RETRY_JITTER_MS, &action);
+  if (az_result_failed(rc))
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to handle connection event: az_result return code 0x%08x.", rc);
+    exit(rc);
+  }
+
+  perform_connection_action(action);
+}
+
+static void perform_connection_action(az_iot_connection_action action)
+{
+  int rc;
+
+  switch (action)
+  {
+    case AZ_IOT_CONNECTION_ACTION_CONNECT:
+    {
+      // Set MQTT connection options.
+      MQTTAsync_connectOptions mqtt_connect_options = MQTTAsync_connectOptions_initializer;
+      mqtt_connect_options.username = mqtt_client_username_buffer;
+      mqtt_connect_options.password = NULL; // This sample uses x509 authentication.
+      // The in-flight window publishes again the messages in flight, rather than the session.
+      mqtt_connect_options.cleansession = true;
+      mqtt_connect_options.keepAliveInterval = AZ_IOT_DEFAULT_MQTT_CONNECT_KEEPALIVE_SECONDS;
+      mqtt_connect_options.onSuccess = on_connect_success;
+      mqtt_connect_options.onFailure = on_connect_failure;
+
+      MQTTAsync_SSLOptions mqtt_ssl_options = MQTTAsync_SSLOptions_initializer;
+      mqtt_ssl_options.verify = 1;
+      mqtt_ssl_options.enableServerCertAuth = 1;
+      mqtt_ssl_options.keyStore = (char*)az_span_ptr(env_vars.x509_cert_pem_file_path);
+      if (az_span_size(env_vars.x509_trust_pem_file_path) != 0) // Is only set if required by OS.
+      {
+        mqtt_ssl_options.trustStore = (char*)az_span_ptr(env_vars.x509_trust_pem_file_path);
+      }
+      mqtt_connect_options.ssl = &mqtt_ssl_options;
+
+      // Start connecting the MQTT client to the Azure IoT Hub. The outcome is queued by the
+      // callbacks.
+      rc = MQTTAsync_connect(mqtt_client, &mqtt_connect_options);
+      if (rc != MQTTASYNC_SUCCESS)
+      {
+        push_event((sample_event){ .type = SAMPLE_EVENT_CONNECT_FAILED, .code = rc });
+      }
+      break;
+    }
+
+    case AZ_IOT_CONNECTION_ACTION_DISCONNECT:
+    {
+      MQTTAsync_disconnectOptions mqtt_disconnect_options = MQTTAsync_disconnectOptions_initializer;
+      mqtt_disconnect_options.timeout = MQTT_TIMEOUT_DISCONNECT_MS;
+      (void)MQTTAsync_disconnect(mqtt_client, &mqtt_disconnect_options);
+      break;
+    }
+
+    case AZ_IOT_CONNECTION_ACTION_SUBSCRIBE: // This sample doesn't subscribe.
+    case AZ_IOT_CONNECTION_ACTION_NONE:
+      break;
+  }
+}
+
+static void publish_telemetry_message(int32_t message_index, uint16_t packet_id)
+{
+  char telemetry_message_payload[32];
+  int const payload_length = snprintf(
+      telemetry_message_payload,
+      sizeof(telemetry_message_payload),
+      "{\"message_number\":%d}",
+      (int)message_index + 1);
+
+  // Paho numbers the messages itself, so the window's packet identifier is carried in the context
+  // of the PUBACK callback. Publishing again sends a new PUBLISH, Paho not exposing the DUP flag.
+  MQTTAsync_responseOptions mqtt_response_options = MQTTAsync_responseOptions_initializer;
+  mqtt_response_options.onSuccess = on_publish_success;
+  mqtt_response_options.context = (void*)(uintptr_t)packet_id;
+
+  // Paho copies the payload, which doesn't need to outlive the call. A failed publish is left for
+  // the window to publish again once its PUBACK timeout elapses.
+  int rc = MQTTAsync_send(
+      mqtt_client,
+      telemetry_topic_buffer,
+      payload_length,
+      telemetry_message_payload,
+      MQTT_PUBLISH_QOS,
+      0,
+      &mqtt_response_options);
+  if (rc != MQTTASYNC_SUCCESS)
+  {
+    IOT_SAMPLE_LOG(
+        "Failed to publish Telemetry message #%d: MQTTAsync return code %d.",
+        (int)message_index + 1,
+        rc);
+  }
+}
+
+static int64_t get_clock_msec(void)
+{
+  int64_t clock_msec;
+  int rc = az_platform_clock_msec(&clock_msec);
+  if (az_result_failed(rc))
+  {
+    IOT_SAMPLE_LOG_ERROR("Failed to read the clock: az_result return code 0x%08x.", rc);
+    exit(rc);
+  }
+
+  return clock_msec;
+}
+
+/*
+ * Event queue shared with the Paho thread.
+ */
+static void push_event(sample_event event)
+{
+#ifdef _WIN32
+  EnterCriticalSection(&event_queue_lock);
+#else
+  (void)pthread_mutex_lock(&event_queue_lock);
+#endif
+
+  // A full queue drops the event: a dropped PUBACK only leads to the message being published again.
+  if (event_queue_count < EVENT_QUEUE_CAPACITY)
+  {
+    event_queue[(event_queue_head + event_queue_count) % EVENT_QUEUE_CAPACITY] = event;
+    event_queue_count++;
+  }
+
+#ifdef _WIN32
+  LeaveCriticalSection(&event_queue_lock);
+#else
+  (void)pthread_mutex_unlock(&event_queue_lock);
+#endif
+
+  az_result const set_result = az_platform_event_set(&event_queue_signal);
+  (void)set_result;
+}
+
+static bool pop_event(sample_event* out_event)
+{
+#ifdef _WIN32
+  EnterCriticalSection(&event_queue_lock);
+#else
+  (void)pthread_mutex_lock(&event_queue_lock);
+#endif
+
+  bool const is_popped = event_queue_count > 0;
+  if (is_popped)
+  {
+    *out_event = event_queue[event_queue_head];
+    event_queue_head = (event_queue_head + 1) % EVENT_QUEUE_CAPACITY;
+    event_queue_count--;
+  }
+
+#ifdef _WIN32
+  LeaveCriticalSection(&event_queue_lock);
+#else
+  (void)pthread_mutex_unlock(&event_queue_lock);
+#endif
+
+  return is_popped;
+}
+
+static void on_connect_success(void* context, MQTTAsync_successData* response)
+{
+  (void)context;
+  (void)response;
+
+  push_event((sample_event){ .type = SAMPLE_EVENT_CONNECTED });
+}
+
+static void on_connect_failure(void* context, MQTTAsync_failureData* response)
+{
+  (void)context;
+
+  push_event((sample_event){ .type = SAMPLE_EVENT_CONNECT_FAILED,
+                             .code = response != NULL ? response->code : MQTTASYNC_FAILURE });
+}
+
+static void on_connection_lost(void* context, char* cause)
+{
+  (void)context;
+  (void)cause;
+
+  push_event((sample_event){ .type = SAMPLE_EVENT_CONNECTION_LOST });
+}
+
+static int on_message_arrived(
+    void* context,
+    char* topic_name,
+    int topic_name_length,
+    MQTTAsync_message* message)
+{
+  (void)context;
+  (void)topic_name_length;
+
+  // This sample doesn't subscribe, but Paho requires the callback.
+  MQTTAsync_freeMessage(&message);
+  MQTTAsync_free(topic_name);
+  return 1;
+}
+
+static void on_publish_success(void* context, MQTTAsync_successData* response)
+{
+  (void)response;
+
+  push_event(
+      (sample_event){ .type = SAMPLE_EVENT_PUBACK, .packet_id = (uint16_t)(uintptr_t)context });
+}
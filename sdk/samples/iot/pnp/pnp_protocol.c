@@ -27,6 +27,11 @@ static az_span const command_separator = AZ_SPAN_LITERAL_FROM_STR("/");
 static az_span const iot_hub_twin_desired_version = AZ_SPAN_LITERAL_FROM_STR("$version");
 static az_span const iot_hub_twin_desired = AZ_SPAN_LITERAL_FROM_STR("desired");
 
+// Property names skipped when visiting the properties of a component.
+static az_span const component_skipped_names[]
+    = { AZ_SPAN_LITERAL_FROM_STR("__t"), AZ_SPAN_LITERAL_FROM_STR("$version") };
+static uint32_t component_skipped_name_hashes[2];
+
 // Visit each valid property for the component
 static void visit_component_properties(
     az_span component_name,
@@ -37,12 +42,16 @@ static void visit_component_properties(
 {
   char const* const log = "Failed to process device twin message";
 
+  // Most property names are rejected by their hash, without comparing the text.
+  az_json_property_name_table skipped_names;
+  az_json_property_name_table_init(
+      &skipped_names, component_skipped_names, component_skipped_name_hashes, 2);
+
   while (az_result_succeeded(az_json_reader_next_token(jr)))
   {
     if (jr->token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
     {
-      if (az_json_token_is_text_equal(&(jr->token), component_specifier_name)
-          || az_json_token_is_text_equal(&(jr->token), iot_hub_twin_desired_version))
+      if (az_json_token_find_property_name(&(jr->token), &skipped_names) != -1)
       {
         IOT_SAMPLE_EXIT_IF_AZ_FAILED(az_json_reader_next_token(jr), log);
         continue;
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/az_arena.h>
+#include <azure/core/internal/az_precondition_internal.h>
+
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  // Large enough for int64_t, double and pointers on all the supported platforms.
+  _az_ARENA_ALIGNMENT = 8,
+};
+
+AZ_NODISCARD az_arena az_arena_create(az_span buffer)
+{
+  _az_PRECONDITION_VALID_SPAN(buffer, 0, true);
+
+  return (az_arena){ ._internal = { .buffer = buffer, .used = 0 } };
+}
+
+AZ_NODISCARD az_result az_arena_allocate(az_arena* ref_arena, int32_t size, az_span* out_span)
+{
+  _az_PRECONDITION_NOT_NULL(ref_arena);
+  _az_PRECONDITION_NOT_NULL(out_span);
+  _az_PRECONDITION(size >= 0);
+
+  uint8_t* const next = az_span_ptr(ref_arena->_internal.buffer) + ref_arena->_internal.used;
+  int32_t const padding
+      = (int32_t)((_az_ARENA_ALIGNMENT - ((uintptr_t)next % _az_ARENA_ALIGNMENT))
+                  % _az_ARENA_ALIGNMENT);
+
+  if (size > az_span_size(ref_arena->_internal.buffer) - ref_arena->_internal.used - padding)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  *out_span = az_span_create(next + padding, size);
+  ref_arena->_internal.used += padding + size;
+  return AZ_OK;
+}
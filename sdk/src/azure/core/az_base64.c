@@ -0,0 +1,494 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_simd_private.h"
+#include <azure/core/az_precondition.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+// The decode tables hold this for the characters which aren't part of the alphabet. Being the only
+// value with the high bit set, the values of a group can be checked at once by or'ing them.
+#define _az_BASE64_INVALID 0xFF
+
+#define _az_BASE64_DECODE_ROW_INVALID                                                 \
+  _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID,     \
+      _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID, \
+      _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID, \
+      _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID
+
+// The values of the ASCII characters from 0x40 (`@`) to 0x7F, which are the same for both alphabets
+// but for `_`.
+#define _az_BASE64_DECODE_ROWS_LETTERS(underscore_value)                                        \
+  _az_BASE64_INVALID, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, \
+      21, 22, 23, 24, 25, _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID,           \
+      _az_BASE64_INVALID, underscore_value, _az_BASE64_INVALID, 26, 27, 28, 29, 30, 31, 32, 33, \
+      34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51,                   \
+      _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID,           \
+      _az_BASE64_INVALID
+
+// The values of the ASCII characters from 0x20 (space) to 0x3F (`?`), with the values of `+`, `-`
+// and `/` given as parameters.
+#define _az_BASE64_DECODE_ROWS_DIGITS(plus_value, dash_value, slash_value)                     \
+  _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID,              \
+      _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID,          \
+      _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID, plus_value,                  \
+      _az_BASE64_INVALID, dash_value, _az_BASE64_INVALID, slash_value, 52, 53, 54, 55, 56, 57, \
+      58, 59, 60, 61, _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID,              \
+      _az_BASE64_INVALID, _az_BASE64_INVALID, _az_BASE64_INVALID
+
+static uint8_t const _az_base64_decode_table[128] = {
+  _az_BASE64_DECODE_ROW_INVALID,
+  _az_BASE64_DECODE_ROW_INVALID,
+  _az_BASE64_DECODE_ROWS_DIGITS(62, _az_BASE64_INVALID, 63),
+  _az_BASE64_DECODE_ROWS_LETTERS(_az_BASE64_INVALID),
+};
+
+static uint8_t const _az_base64url_decode_table[128] = {
+  _az_BASE64_DECODE_ROW_INVALID,
+  _az_BASE64_DECODE_ROW_INVALID,
+  _az_BASE64_DECODE_ROWS_DIGITS(_az_BASE64_INVALID, 62, _az_BASE64_INVALID),
+  _az_BASE64_DECODE_ROWS_LETTERS(63),
+};
+
+typedef struct
+{
+  uint8_t const* encode_table; // The 64 characters, by value.
+  uint8_t const* decode_table; // The values of the 128 ASCII characters.
+  bool is_padded; // Whether the text is padded with `=` to a multiple of 4 characters.
+} _az_base64_alphabet;
+
+static _az_base64_alphabet const _az_base64 = {
+  .encode_table
+  = (uint8_t const*)"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+  .decode_table = _az_base64_decode_table,
+  .is_padded = true,
+};
+
+static _az_base64_alphabet const _az_base64url = {
+  .encode_table
+  = (uint8_t const*)"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_",
+  .decode_table = _az_base64url_decode_table,
+  .is_padded = false,
+};
+
+// Encodes as many bytes of `source` as possible by blocks, and returns their number, which is a
+// multiple of 3. The blocks are encoded 12 bytes at a time with SSSE3 (reading 16), or 48 with
+// NEON, as described by Wojciech Mula and Daniel Lemire, "Faster Base64 Encoding and Decoding
+// Using AVX2 Instructions" (2018).
+AZ_NODISCARD static int32_t _az_base64_encode_blocks(
+    uint8_t const* source,
+    int32_t source_size,
+    uint8_t* destination,
+    _az_base64_alphabet const* alphabet)
+{
+  int32_t index = 0;
+  uint8_t const char_62 = alphabet->encode_table[62];
+  uint8_t const char_63 = alphabet->encode_table[63];
+
+#if defined(_az_SIMD_SSSE3)
+  // Each group of 3 bytes is spread over a 32-bit lane, whose four 6-bit values are then moved to
+  // the low bits of its bytes by multiplications.
+  __m128i const spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  __m128i const mask_ac = _mm_set1_epi32(0x0FC0FC00);
+  __m128i const shift_ac = _mm_set1_epi32(0x04000040);
+  __m128i const mask_bd = _mm_set1_epi32(0x003F03F0);
+  __m128i const shift_bd = _mm_set1_epi32(0x01000010);
+
+  // Maps the values to an index of `offsets`: 13 for [0, 25], 0 for [26, 51], 1 to 10 for the
+  // digits, 11 for 62 and 12 for 63. Adding the offset to the value gives its character.
+  __m128i const max_upper = _mm_set1_epi8(25);
+  __m128i const lower_offset = _mm_set1_epi8(51);
+  __m128i const upper_index = _mm_set1_epi8(13);
+  __m128i const offsets = _mm_setr_epi8(
+      'a' - 26,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      (char)(char_62 - 62),
+      (char)(char_63 - 63),
+      'A',
+      0,
+      0);
+
+  for (; index + 16 <= source_size; index += 12, destination += 16)
+  {
+    __m128i const block = _mm_shuffle_epi8(
+        _mm_loadu_si128((__m128i const*)(void const*)(source + index)), spread);
+    __m128i const values = _mm_or_si128(
+        _mm_mulhi_epu16(_mm_and_si128(block, mask_ac), shift_ac),
+        _mm_mullo_epi16(_mm_and_si128(block, mask_bd), shift_bd));
+
+    __m128i const is_upper = _mm_cmpeq_epi8(_mm_min_epu8(values, max_upper), values);
+    __m128i const offset_index
+        = _mm_or_si128(_mm_subs_epu8(values, lower_offset), _mm_and_si128(is_upper, upper_index));
+    _mm_storeu_si128(
+        (__m128i*)(void*)destination,
+        _mm_add_epi8(values, _mm_shuffle_epi8(offsets, offset_index)));
+  }
+#elif defined(_az_SIMD_NEON)
+  uint8x16_t const mask_6_bits = vdupq_n_u8(0x3F);
+  uint8x16_t const value_26 = vdupq_n_u8(26);
+  uint8x16_t const value_52 = vdupq_n_u8(52);
+  uint8x16_t const value_62 = vdupq_n_u8(62);
+  uint8x16_t const offset_upper = vdupq_n_u8('A');
+  uint8x16_t const offset_lower = vdupq_n_u8((uint8_t)('a' - 26));
+  uint8x16_t const offset_digit = vdupq_n_u8((uint8_t)('0' - 52));
+  uint8x16_t const offset_62 = vdupq_n_u8((uint8_t)(char_62 - 62));
+  uint8x16_t const offset_63 = vdupq_n_u8((uint8_t)(char_63 - 63));
+
+  for (; index + 48 <= source_size; index += 48, destination += 64)
+  {
+    // The loads and stores deinterleave the bytes of the groups, and interleave their characters.
+    uint8x16x3_t const bytes = vld3q_u8(source + index);
+    uint8x16x4_t text;
+    text.val[0] = vshrq_n_u8(bytes.val[0], 2);
+    text.val[1] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(bytes.val[0], 4), vshrq_n_u8(bytes.val[1], 4)), mask_6_bits);
+    text.val[2] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(bytes.val[1], 2), vshrq_n_u8(bytes.val[2], 6)), mask_6_bits);
+    text.val[3] = vandq_u8(bytes.val[2], mask_6_bits);
+
+    for (int32_t i = 0; i < 4; i++)
+    {
+      uint8x16_t const values = text.val[i];
+      uint8x16_t offset = vbslq_u8(vceqq_u8(values, value_62), offset_62, offset_63);
+      offset = vbslq_u8(vcltq_u8(values, value_62), offset_digit, offset);
+      offset = vbslq_u8(vcltq_u8(values, value_52), offset_lower, offset);
+      offset = vbslq_u8(vcltq_u8(values, value_26), offset_upper, offset);
+      text.val[i] = vaddq_u8(values, offset);
+    }
+
+    vst4q_u8(destination, text);
+  }
+#else
+  (void)source;
+  (void)source_size;
+  (void)destination;
+  (void)char_62;
+  (void)char_63;
+#endif
+
+  return index;
+}
+
+// Decodes as many full groups of `source` as possible by blocks, and returns the number of
+// characters decoded, which is a multiple of 4. It stops before a block with a character which
+// isn't part of the alphabet, for the scalar code to report it. With SSSE3, 16 characters are
+// decoded at a time into 12 bytes (writing 16), and 64 into 48 with NEON.
+AZ_NODISCARD static int32_t _az_base64_decode_blocks(
+    uint8_t const* source,
+    int32_t source_size,
+    uint8_t* destination,
+    int32_t destination_size,
+    _az_base64_alphabet const* alphabet)
+{
+  int32_t index = 0;
+  uint8_t const char_62 = alphabet->encode_table[62];
+  uint8_t const char_63 = alphabet->encode_table[63];
+
+#if defined(_az_SIMD_SSSE3)
+  __m128i const upper_a = _mm_set1_epi8('A');
+  __m128i const lower_a = _mm_set1_epi8('a');
+  __m128i const zero = _mm_set1_epi8('0');
+  __m128i const max_letter_offset = _mm_set1_epi8('z' - 'a');
+  __m128i const max_digit_offset = _mm_set1_epi8('9' - '0');
+  __m128i const value_26 = _mm_set1_epi8(26);
+  __m128i const value_52 = _mm_set1_epi8(52);
+  __m128i const character_62 = _mm_set1_epi8((char)char_62);
+  __m128i const character_63 = _mm_set1_epi8((char)char_63);
+  __m128i const value_62 = _mm_set1_epi8(62);
+  __m128i const value_63 = _mm_set1_epi8(63);
+
+  // Merges the four 6-bit values of each 32-bit lane into 24 bits, then packs the 3 bytes of the
+  // lanes, most significant first.
+  __m128i const merge_pairs = _mm_set1_epi32(0x01400140);
+  __m128i const merge_quads = _mm_set1_epi32(0x00011000);
+  __m128i const pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+  for (int32_t written = 0; index + 16 <= source_size && written + 16 <= destination_size;
+       index += 16, written += 12, destination += 12)
+  {
+    __m128i const block = _mm_loadu_si128((__m128i const*)(void const*)(source + index));
+
+    // A byte is in a range if its (unsigned) offset from the start of the range is small enough.
+    __m128i const upper_offset = _mm_sub_epi8(block, upper_a);
+    __m128i const lower_offset = _mm_sub_epi8(block, lower_a);
+    __m128i const digit_offset = _mm_sub_epi8(block, zero);
+    __m128i const is_upper
+        = _mm_cmpeq_epi8(_mm_min_epu8(upper_offset, max_letter_offset), upper_offset);
+    __m128i const is_lower
+        = _mm_cmpeq_epi8(_mm_min_epu8(lower_offset, max_letter_offset), lower_offset);
+    __m128i const is_digit
+        = _mm_cmpeq_epi8(_mm_min_epu8(digit_offset, max_digit_offset), digit_offset);
+    __m128i const is_62 = _mm_cmpeq_epi8(block, character_62);
+    __m128i const is_63 = _mm_cmpeq_epi8(block, character_63);
+
+    __m128i const is_valid = _mm_or_si128(
+        _mm_or_si128(_mm_or_si128(is_upper, is_lower), is_digit), _mm_or_si128(is_62, is_63));
+    if (_mm_movemask_epi8(is_valid) != 0xFFFF)
+    {
+      break;
+    }
+
+    __m128i const values = _mm_or_si128(
+        _mm_or_si128(
+            _mm_and_si128(is_upper, upper_offset),
+            _mm_and_si128(is_lower, _mm_add_epi8(lower_offset, value_26))),
+        _mm_or_si128(
+            _mm_and_si128(is_digit, _mm_add_epi8(digit_offset, value_52)),
+            _mm_or_si128(_mm_and_si128(is_62, value_62), _mm_and_si128(is_63, value_63))));
+
+    __m128i const merged
+        = _mm_madd_epi16(_mm_maddubs_epi16(values, merge_pairs), merge_quads);
+    _mm_storeu_si128((__m128i*)(void*)destination, _mm_shuffle_epi8(merged, pack));
+  }
+#elif defined(_az_SIMD_NEON)
+  uint8x16_t const upper_a = vdupq_n_u8('A');
+  uint8x16_t const lower_a = vdupq_n_u8('a');
+  uint8x16_t const zero = vdupq_n_u8('0');
+  uint8x16_t const max_letter_offset = vdupq_n_u8('z' - 'a');
+  uint8x16_t const max_digit_offset = vdupq_n_u8('9' - '0');
+  uint8x16_t const value_26 = vdupq_n_u8(26);
+  uint8x16_t const value_52 = vdupq_n_u8(52);
+  uint8x16_t const character_62 = vdupq_n_u8(char_62);
+  uint8x16_t const character_63 = vdupq_n_u8(char_63);
+  uint8x16_t const value_62 = vdupq_n_u8(62);
+  uint8x16_t const value_63 = vdupq_n_u8(63);
+  (void)destination_size;
+
+  for (; index + 64 <= source_size; index += 64, destination += 48)
+  {
+    // The load deinterleaves the four characters of the groups.
+    uint8x16x4_t text = vld4q_u8(source + index);
+    uint8x16_t is_valid = vdupq_n_u8(0xFF);
+
+    for (int32_t i = 0; i < 4; i++)
+    {
+      uint8x16_t const block = text.val[i];
+      uint8x16_t const upper_offset = vsubq_u8(block, upper_a);
+      uint8x16_t const lower_offset = vsubq_u8(block, lower_a);
+      uint8x16_t const digit_offset = vsubq_u8(block, zero);
+      uint8x16_t const is_upper = vcleq_u8(upper_offset, max_letter_offset);
+      uint8x16_t const is_lower = vcleq_u8(lower_offset, max_letter_offset);
+      uint8x16_t const is_digit = vcleq_u8(digit_offset, max_digit_offset);
+      uint8x16_t const is_62 = vceqq_u8(block, character_62);
+      uint8x16_t const is_63 = vceqq_u8(block, character_63);
+
+      is_valid = vandq_u8(
+          is_valid,
+          vorrq_u8(vorrq_u8(vorrq_u8(is_upper, is_lower), is_digit), vorrq_u8(is_62, is_63)));
+      text.val[i] = vorrq_u8(
+          vorrq_u8(
+              vandq_u8(is_upper, upper_offset),
+              vandq_u8(is_lower, vaddq_u8(lower_offset, value_26))),
+          vorrq_u8(
+              vandq_u8(is_digit, vaddq_u8(digit_offset, value_52)),
+              vorrq_u8(vandq_u8(is_62, value_62), vandq_u8(is_63, value_63))));
+    }
+
+    if (_az_simd_neon_mask(vmvnq_u8(is_valid)) != 0)
+    {
+      break;
+    }
+
+    uint8x16x3_t bytes;
+    bytes.val[0] = vorrq_u8(vshlq_n_u8(text.val[0], 2), vshrq_n_u8(text.val[1], 4));
+    bytes.val[1] = vorrq_u8(vshlq_n_u8(text.val[1], 4), vshrq_n_u8(text.val[2], 2));
+    bytes.val[2] = vorrq_u8(vshlq_n_u8(text.val[2], 6), text.val[3]);
+    vst3q_u8(destination, bytes);
+  }
+#else
+  (void)source;
+  (void)source_size;
+  (void)destination;
+  (void)destination_size;
+  (void)char_62;
+  (void)char_63;
+#endif
+
+  return index;
+}
+
+AZ_NODISCARD static az_result _az_base64_encode(
+    az_span destination,
+    az_span source,
+    _az_base64_alphabet const* alphabet,
+    int32_t* out_written)
+{
+  _az_PRECONDITION_VALID_SPAN(destination, 0, true);
+  _az_PRECONDITION_VALID_SPAN(source, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_written);
+
+  int32_t const source_size = az_span_size(source);
+  int32_t const destination_size = az_span_size(destination);
+  int32_t const full_group_count = source_size / 3;
+  int32_t const remaining_size = source_size % 3;
+  int32_t const last_group_size
+      = remaining_size == 0 ? 0 : (alphabet->is_padded ? 4 : remaining_size + 1);
+
+  // Compare group counts, since the encoded size of a large source may not fit in an int32_t.
+  if (full_group_count > destination_size / 4
+      || last_group_size > destination_size - (full_group_count * 4))
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  uint8_t const* const table = alphabet->encode_table;
+  uint8_t const* const source_ptr = az_span_ptr(source);
+  uint8_t* destination_ptr = az_span_ptr(destination);
+
+  int32_t index = _az_base64_encode_blocks(source_ptr, source_size, destination_ptr, alphabet);
+  destination_ptr += (index / 3) * 4;
+
+  for (; index + 3 <= source_size; index += 3, destination_ptr += 4)
+  {
+    uint32_t const group = ((uint32_t)source_ptr[index] << 16)
+        | ((uint32_t)source_ptr[index + 1] << 8) | (uint32_t)source_ptr[index + 2];
+    destination_ptr[0] = table[group >> 18];
+    destination_ptr[1] = table[(group >> 12) & 0x3F];
+    destination_ptr[2] = table[(group >> 6) & 0x3F];
+    destination_ptr[3] = table[group & 0x3F];
+  }
+
+  if (remaining_size != 0)
+  {
+    uint32_t group = (uint32_t)source_ptr[index] << 16;
+    if (remaining_size == 2)
+    {
+      group |= (uint32_t)source_ptr[index + 1] << 8;
+    }
+
+    destination_ptr[0] = table[group >> 18];
+    destination_ptr[1] = table[(group >> 12) & 0x3F];
+    if (remaining_size == 2)
+    {
+      destination_ptr[2] = table[(group >> 6) & 0x3F];
+    }
+
+    for (int32_t i = remaining_size + 1; i < last_group_size; i++)
+    {
+      destination_ptr[i] = '=';
+    }
+  }
+
+  *out_written = (full_group_count * 4) + last_group_size;
+  return AZ_OK;
+}
+
+AZ_NODISCARD static az_result _az_base64_decode(
+    az_span destination,
+    az_span source,
+    _az_base64_alphabet const* alphabet,
+    int32_t* out_written)
+{
+  _az_PRECONDITION_VALID_SPAN(destination, 0, true);
+  _az_PRECONDITION_VALID_SPAN(source, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_written);
+
+  uint8_t const* const source_ptr = az_span_ptr(source);
+  int32_t source_size = az_span_size(source);
+
+  if (source_size % 4 != 0 && alphabet->is_padded)
+  {
+    return AZ_ERROR_UNEXPECTED_END;
+  }
+
+  // The padding of a group of 4 characters, which can only be the last one.
+  if (source_size % 4 == 0)
+  {
+    for (int32_t i = 0; i < 2 && source_size > 0 && source_ptr[source_size - 1] == '='; i++)
+    {
+      source_size--;
+    }
+  }
+
+  int32_t const remaining_size = source_size % 4;
+  if (remaining_size == 1)
+  {
+    return AZ_ERROR_UNEXPECTED_END;
+  }
+
+  int32_t const full_size = source_size - remaining_size;
+  int32_t const decoded_size
+      = ((full_size / 4) * 3) + (remaining_size == 0 ? 0 : remaining_size - 1);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, decoded_size);
+
+  uint8_t const* const table = alphabet->decode_table;
+  uint8_t* destination_ptr = az_span_ptr(destination);
+
+  int32_t index = _az_base64_decode_blocks(
+      source_ptr, full_size, destination_ptr, az_span_size(destination), alphabet);
+  destination_ptr += (index / 4) * 3;
+
+  for (; index < source_size; index += 4, destination_ptr += 3)
+  {
+    int32_t const group_size = source_size - index < 4 ? source_size - index : 4;
+
+    // The characters past the 7-bit ASCII range are out of the table.
+    uint32_t values[4] = { 0 };
+    uint32_t invalid = 0;
+    for (int32_t i = 0; i < group_size; i++)
+    {
+      uint8_t const c = source_ptr[index + i];
+      values[i] = c < 128 ? table[c] : _az_BASE64_INVALID;
+      invalid |= values[i];
+    }
+
+    if ((invalid & 0x80U) != 0)
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+
+    uint32_t const group = (values[0] << 18) | (values[1] << 12) | (values[2] << 6) | values[3];
+    destination_ptr[0] = (uint8_t)(group >> 16);
+    if (group_size > 2)
+    {
+      destination_ptr[1] = (uint8_t)(group >> 8);
+    }
+    if (group_size > 3)
+    {
+      destination_ptr[2] = (uint8_t)group;
+    }
+  }
+
+  *out_written = decoded_size;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_span_base64_encode(az_span destination, az_span source, int32_t* out_written)
+{
+  return _az_base64_encode(destination, source, &_az_base64, out_written);
+}
+
+AZ_NODISCARD az_result
+az_span_base64_decode(az_span destination, az_span source, int32_t* out_written)
+{
+  return _az_base64_decode(destination, source, &_az_base64, out_written);
+}
+
+AZ_NODISCARD az_result
+az_span_base64url_encode(az_span destination, az_span source, int32_t* out_written)
+{
+  return _az_base64_encode(destination, source, &_az_base64url, out_written);
+}
+
+AZ_NODISCARD az_result
+az_span_base64url_decode(az_span destination, az_span source, int32_t* out_written)
+{
+  return _az_base64_decode(destination, source, &_az_base64url, out_written);
+}
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#ifndef _az_CBOR_PRIVATE_H
+#define _az_CBOR_PRIVATE_H
+
+#include <azure/core/az_cbor.h>
+
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+// The major types, held in the 3 high bits of the initial byte of a data item.
+enum
+{
+  _az_CBOR_MAJOR_TYPE_UNSIGNED = 0,
+  _az_CBOR_MAJOR_TYPE_NEGATIVE = 1,
+  _az_CBOR_MAJOR_TYPE_BYTE_STRING = 2,
+  _az_CBOR_MAJOR_TYPE_TEXT_STRING = 3,
+  _az_CBOR_MAJOR_TYPE_ARRAY = 4,
+  _az_CBOR_MAJOR_TYPE_MAP = 5,
+  _az_CBOR_MAJOR_TYPE_TAG = 6,
+  _az_CBOR_MAJOR_TYPE_SIMPLE = 7,
+};
+
+// The additional information, held in the 5 low bits of the initial byte of a data item.
+enum
+{
+  // Arguments below this value are held in the additional information itself.
+  _az_CBOR_INFO_ONE_BYTE = 24,
+  _az_CBOR_INFO_TWO_BYTES = 25,
+  _az_CBOR_INFO_FOUR_BYTES = 26,
+  _az_CBOR_INFO_EIGHT_BYTES = 27,
+  _az_CBOR_INFO_INDEFINITE = 31,
+
+  _az_CBOR_SIMPLE_FALSE = 20,
+  _az_CBOR_SIMPLE_TRUE = 21,
+  _az_CBOR_SIMPLE_NULL = 22,
+  _az_CBOR_SIMPLE_UNDEFINED = 23,
+};
+
+enum
+{
+  _az_CBOR_BREAK = 0xFF,
+
+  // The initial byte, followed by an argument of up to 8 bytes.
+  _az_CBOR_MAX_HEAD_SIZE = 9,
+};
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_CBOR_PRIVATE_H
@@ -0,0 +1,403 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_cbor_private.h"
+#include <azure/core/az_cbor.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+
+#include <string.h>
+
+#include <azure/core/_az_cfg.h>
+
+AZ_NODISCARD az_result az_cbor_reader_init(az_cbor_reader* out_cbor_reader, az_span cbor_buffer)
+{
+  _az_PRECONDITION_NOT_NULL(out_cbor_reader);
+
+  *out_cbor_reader = (az_cbor_reader){
+    .token = (az_cbor_token){ .kind = AZ_CBOR_TOKEN_NONE, ._internal = { 0 } },
+    ._internal = {
+      .cbor_buffer = cbor_buffer,
+      .bytes_consumed = 0,
+      .depth = 0,
+      .map_stack = 0,
+    },
+  };
+  return AZ_OK;
+}
+
+AZ_NODISCARD static bool _az_cbor_reader_is_in_map(az_cbor_reader const* cbor_reader)
+{
+  return ((cbor_reader->_internal.map_stack >> (cbor_reader->_internal.depth - 1)) & 1) != 0;
+}
+
+// Returns the end token of the innermost open container.
+static void _az_cbor_reader_end_container(az_cbor_reader* ref_cbor_reader, az_span slice)
+{
+  ref_cbor_reader->token = (az_cbor_token){
+    .slice = slice,
+    .kind = _az_cbor_reader_is_in_map(ref_cbor_reader) ? AZ_CBOR_TOKEN_END_MAP
+                                                       : AZ_CBOR_TOKEN_END_ARRAY,
+    .size = 0,
+    ._internal = { 0 },
+  };
+  ref_cbor_reader->_internal.depth--;
+}
+
+AZ_NODISCARD static az_result _az_cbor_reader_begin_container(
+    az_cbor_reader* ref_cbor_reader,
+    uint8_t major_type,
+    uint64_t argument,
+    bool is_indefinite)
+{
+  int32_t const depth = ref_cbor_reader->_internal.depth;
+  if (depth >= _az_CBOR_READER_MAX_NESTING_DEPTH)
+  {
+    return AZ_ERROR_CBOR_NESTING_OVERFLOW;
+  }
+
+  bool const is_map = major_type == _az_CBOR_MAJOR_TYPE_MAP;
+  int32_t remaining_items = -1;
+  if (!is_indefinite)
+  {
+    // The items of a map are its keys and values. Anything longer than the buffer is malformed.
+    if (argument > (uint64_t)(is_map ? INT32_MAX / 2 : INT32_MAX))
+    {
+      return AZ_ERROR_UNEXPECTED_END;
+    }
+    remaining_items = is_map ? (int32_t)argument * 2 : (int32_t)argument;
+  }
+
+  uint32_t const bit = (uint32_t)1 << depth;
+  ref_cbor_reader->_internal.map_stack
+      = is_map ? ref_cbor_reader->_internal.map_stack | bit
+               : ref_cbor_reader->_internal.map_stack & ~bit;
+  ref_cbor_reader->_internal.remaining_items[depth] = remaining_items;
+  ref_cbor_reader->_internal.depth++;
+
+  ref_cbor_reader->token.kind = is_map ? AZ_CBOR_TOKEN_BEGIN_MAP : AZ_CBOR_TOKEN_BEGIN_ARRAY;
+  ref_cbor_reader->token.size = is_indefinite ? -1 : (int32_t)argument;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_cbor_reader_next_token(az_cbor_reader* ref_cbor_reader)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_reader);
+
+  az_span const buffer = ref_cbor_reader->_internal.cbor_buffer;
+  int32_t const buffer_size = az_span_size(buffer);
+  uint8_t const* const bytes = az_span_ptr(buffer);
+  int32_t const depth = ref_cbor_reader->_internal.depth;
+
+  // A definite length container ends right after its last item, with no bytes of its own.
+  if (depth > 0 && ref_cbor_reader->_internal.remaining_items[depth - 1] == 0)
+  {
+    int32_t const position = ref_cbor_reader->_internal.bytes_consumed;
+    _az_cbor_reader_end_container(ref_cbor_reader, az_span_slice(buffer, position, position));
+    return AZ_OK;
+  }
+
+  az_cbor_token_kind const previous_kind = ref_cbor_reader->token.kind;
+  if (depth == 0 && previous_kind != AZ_CBOR_TOKEN_NONE
+      && previous_kind != AZ_CBOR_TOKEN_BEGIN_ARRAY && previous_kind != AZ_CBOR_TOKEN_BEGIN_MAP)
+  {
+    return ref_cbor_reader->_internal.bytes_consumed == buffer_size ? AZ_ERROR_CBOR_READER_DONE
+                                                                     : AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  // Tags are skipped over, leaving the data item they apply to.
+  while (true)
+  {
+    int32_t const start = ref_cbor_reader->_internal.bytes_consumed;
+    if (start >= buffer_size)
+    {
+      return AZ_ERROR_UNEXPECTED_END;
+    }
+
+    uint8_t const initial_byte = bytes[start];
+    uint8_t const major_type = (uint8_t)(initial_byte >> 5);
+    uint8_t const info = (uint8_t)(initial_byte & 0x1F);
+
+    if (initial_byte == _az_CBOR_BREAK)
+    {
+      if (depth == 0 || ref_cbor_reader->_internal.remaining_items[depth - 1] != -1)
+      {
+        return AZ_ERROR_UNEXPECTED_CHAR;
+      }
+      ref_cbor_reader->_internal.bytes_consumed = start + 1;
+      _az_cbor_reader_end_container(ref_cbor_reader, az_span_slice(buffer, start, start + 1));
+      return AZ_OK;
+    }
+
+    int32_t argument_size;
+    bool const is_indefinite = info == _az_CBOR_INFO_INDEFINITE;
+    if (info < _az_CBOR_INFO_ONE_BYTE || is_indefinite)
+    {
+      argument_size = 0;
+    }
+    else if (info <= _az_CBOR_INFO_EIGHT_BYTES)
+    {
+      argument_size = 1 << (info - _az_CBOR_INFO_ONE_BYTE);
+    }
+    else
+    {
+      // Reserved additional information.
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+
+    if (argument_size >= buffer_size - start)
+    {
+      return AZ_ERROR_UNEXPECTED_END;
+    }
+
+    uint64_t argument = argument_size == 0 ? info : 0;
+    for (int32_t i = 1; i <= argument_size; i++)
+    {
+      argument = (argument << 8) | bytes[start + i];
+    }
+
+    int32_t const head_end = start + 1 + argument_size;
+    ref_cbor_reader->_internal.bytes_consumed = head_end;
+
+    if (major_type == _az_CBOR_MAJOR_TYPE_TAG)
+    {
+      if (is_indefinite)
+      {
+        return AZ_ERROR_UNEXPECTED_CHAR;
+      }
+      continue;
+    }
+
+    if (is_indefinite && major_type != _az_CBOR_MAJOR_TYPE_ARRAY
+        && major_type != _az_CBOR_MAJOR_TYPE_MAP)
+    {
+      // Strings made of chunks would need to be copied to be returned as a single slice.
+      return major_type == _az_CBOR_MAJOR_TYPE_BYTE_STRING
+              || major_type == _az_CBOR_MAJOR_TYPE_TEXT_STRING
+          ? AZ_ERROR_NOT_SUPPORTED
+          : AZ_ERROR_UNEXPECTED_CHAR;
+    }
+
+    ref_cbor_reader->token = (az_cbor_token){
+      .slice = az_span_slice(buffer, start, head_end),
+      .kind = AZ_CBOR_TOKEN_NONE,
+      .size = 0,
+      ._internal = { .argument = argument, .float_size = 0 },
+    };
+
+    switch (major_type)
+    {
+      case _az_CBOR_MAJOR_TYPE_UNSIGNED:
+        ref_cbor_reader->token.kind = AZ_CBOR_TOKEN_UNSIGNED;
+        break;
+      case _az_CBOR_MAJOR_TYPE_NEGATIVE:
+        ref_cbor_reader->token.kind = AZ_CBOR_TOKEN_NEGATIVE;
+        break;
+      case _az_CBOR_MAJOR_TYPE_BYTE_STRING:
+      case _az_CBOR_MAJOR_TYPE_TEXT_STRING:
+        if (argument > (uint64_t)(buffer_size - head_end))
+        {
+          return AZ_ERROR_UNEXPECTED_END;
+        }
+        ref_cbor_reader->token.kind = major_type == _az_CBOR_MAJOR_TYPE_TEXT_STRING
+            ? AZ_CBOR_TOKEN_TEXT_STRING
+            : AZ_CBOR_TOKEN_BYTE_STRING;
+        ref_cbor_reader->token.slice
+            = az_span_slice(buffer, head_end, head_end + (int32_t)argument);
+        ref_cbor_reader->_internal.bytes_consumed = head_end + (int32_t)argument;
+        break;
+      case _az_CBOR_MAJOR_TYPE_ARRAY:
+      case _az_CBOR_MAJOR_TYPE_MAP:
+        // The container is an item of its parent, not of itself.
+        if (depth > 0 && ref_cbor_reader->_internal.remaining_items[depth - 1] > 0)
+        {
+          ref_cbor_reader->_internal.remaining_items[depth - 1]--;
+        }
+        return _az_cbor_reader_begin_container(
+            ref_cbor_reader, major_type, argument, is_indefinite);
+      default:
+        switch (info)
+        {
+          case _az_CBOR_SIMPLE_FALSE:
+            ref_cbor_reader->token.kind = AZ_CBOR_TOKEN_FALSE;
+            break;
+          case _az_CBOR_SIMPLE_TRUE:
+            ref_cbor_reader->token.kind = AZ_CBOR_TOKEN_TRUE;
+            break;
+          case _az_CBOR_SIMPLE_NULL:
+          case _az_CBOR_SIMPLE_UNDEFINED:
+            ref_cbor_reader->token.kind = AZ_CBOR_TOKEN_NULL;
+            break;
+          case _az_CBOR_INFO_TWO_BYTES:
+          case _az_CBOR_INFO_FOUR_BYTES:
+          case _az_CBOR_INFO_EIGHT_BYTES:
+            ref_cbor_reader->token.kind = AZ_CBOR_TOKEN_FLOAT;
+            ref_cbor_reader->token._internal.float_size = argument_size;
+            break;
+          default:
+            // Unassigned simple values.
+            return AZ_ERROR_UNEXPECTED_CHAR;
+        }
+        break;
+    }
+
+    if (depth > 0 && ref_cbor_reader->_internal.remaining_items[depth - 1] > 0)
+    {
+      ref_cbor_reader->_internal.remaining_items[depth - 1]--;
+    }
+    return AZ_OK;
+  }
+}
+
+AZ_NODISCARD az_result az_cbor_reader_skip_children(az_cbor_reader* ref_cbor_reader)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_reader);
+
+  az_cbor_token_kind const kind = ref_cbor_reader->token.kind;
+  if (kind != AZ_CBOR_TOKEN_BEGIN_ARRAY && kind != AZ_CBOR_TOKEN_BEGIN_MAP)
+  {
+    return AZ_OK;
+  }
+
+  int32_t const depth = ref_cbor_reader->_internal.depth - 1;
+  while (ref_cbor_reader->_internal.depth > depth)
+  {
+    _az_RETURN_IF_FAILED(az_cbor_reader_next_token(ref_cbor_reader));
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_cbor_token_get_uint64(az_cbor_token const* cbor_token, uint64_t* out_value)
+{
+  _az_PRECONDITION_NOT_NULL(cbor_token);
+  _az_PRECONDITION_NOT_NULL(out_value);
+
+  if (cbor_token->kind != AZ_CBOR_TOKEN_UNSIGNED)
+  {
+    return AZ_ERROR_CBOR_INVALID_STATE;
+  }
+
+  *out_value = cbor_token->_internal.argument;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_cbor_token_get_int64(az_cbor_token const* cbor_token, int64_t* out_value)
+{
+  _az_PRECONDITION_NOT_NULL(cbor_token);
+  _az_PRECONDITION_NOT_NULL(out_value);
+
+  uint64_t const argument = cbor_token->_internal.argument;
+
+  if (cbor_token->kind == AZ_CBOR_TOKEN_UNSIGNED)
+  {
+    if (argument > INT64_MAX)
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+    *out_value = (int64_t)argument;
+    return AZ_OK;
+  }
+
+  if (cbor_token->kind == AZ_CBOR_TOKEN_NEGATIVE)
+  {
+    // The value is -1 - argument, which is at least INT64_MIN when argument fits in an int64_t.
+    if (argument > INT64_MAX)
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+    *out_value = -1 - (int64_t)argument;
+    return AZ_OK;
+  }
+
+  return AZ_ERROR_CBOR_INVALID_STATE;
+}
+
+// Converts the bits of a half precision float to its value.
+AZ_NODISCARD static double _az_cbor_half_to_double(uint16_t half_bits)
+{
+  uint32_t const sign = (uint32_t)(half_bits & 0x8000) << 16;
+  uint32_t const exponent = (uint32_t)(half_bits >> 10) & 0x1F;
+  uint32_t const mantissa = (uint32_t)half_bits & 0x3FF;
+
+  if (exponent == 0)
+  {
+    // Zero and subnormal numbers, m * 2^-24.
+    double const value = (double)mantissa / 16777216.0;
+    return sign != 0 ? -value : value;
+  }
+
+  // Normal numbers, infinities and NaN map to a single precision float with a wider exponent.
+  uint32_t const float_bits = exponent == 0x1F
+      ? sign | 0x7F800000 | (mantissa << 13)
+      : sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+  float value;
+  memcpy(&value, &float_bits, sizeof(value));
+  return (double)value;
+}
+
+AZ_NODISCARD az_result az_cbor_token_get_double(az_cbor_token const* cbor_token, double* out_value)
+{
+  _az_PRECONDITION_NOT_NULL(cbor_token);
+  _az_PRECONDITION_NOT_NULL(out_value);
+
+  uint64_t const argument = cbor_token->_internal.argument;
+
+  switch (cbor_token->kind)
+  {
+    case AZ_CBOR_TOKEN_UNSIGNED:
+      *out_value = (double)argument;
+      return AZ_OK;
+    case AZ_CBOR_TOKEN_NEGATIVE:
+      *out_value = -1.0 - (double)argument;
+      return AZ_OK;
+    case AZ_CBOR_TOKEN_FLOAT:
+      break;
+    default:
+      return AZ_ERROR_CBOR_INVALID_STATE;
+  }
+
+  if (cbor_token->_internal.float_size == 2)
+  {
+    *out_value = _az_cbor_half_to_double((uint16_t)argument);
+  }
+  else if (cbor_token->_internal.float_size == 4)
+  {
+    uint32_t const float_bits = (uint32_t)argument;
+    float value;
+    memcpy(&value, &float_bits, sizeof(value));
+    *out_value = (double)value;
+  }
+  else
+  {
+    memcpy(out_value, &argument, sizeof(*out_value));
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_cbor_token_get_bool(az_cbor_token const* cbor_token, bool* out_value)
+{
+  _az_PRECONDITION_NOT_NULL(cbor_token);
+  _az_PRECONDITION_NOT_NULL(out_value);
+
+  if (cbor_token->kind != AZ_CBOR_TOKEN_TRUE && cbor_token->kind != AZ_CBOR_TOKEN_FALSE)
+  {
+    return AZ_ERROR_CBOR_INVALID_STATE;
+  }
+
+  *out_value = cbor_token->kind == AZ_CBOR_TOKEN_TRUE;
+  return AZ_OK;
+}
+
+AZ_NODISCARD bool az_cbor_token_is_text_equal(
+    az_cbor_token const* cbor_token,
+    az_span expected_text)
+{
+  _az_PRECONDITION_NOT_NULL(cbor_token);
+
+  return cbor_token->kind == AZ_CBOR_TOKEN_TEXT_STRING
+      && az_span_is_content_equal(cbor_token->slice, expected_text);
+}
@@ -0,0 +1,458 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_cbor_private.h"
+#include <azure/core/az_cbor.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+
+#include <string.h>
+
+#include <azure/core/_az_cfg.h>
+
+AZ_NODISCARD az_result
+az_cbor_writer_init(az_cbor_writer* out_cbor_writer, az_span destination_buffer)
+{
+  _az_PRECONDITION_NOT_NULL(out_cbor_writer);
+
+  *out_cbor_writer = (az_cbor_writer){
+    ._internal = {
+      .destination_buffer = destination_buffer,
+      .bytes_written = 0,
+      .total_bytes_written = 0,
+      .allocator_callback = NULL,
+      .user_context = NULL,
+      .depth = 0,
+      .map_stack = 0,
+    },
+  };
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_cbor_writer_chunked_init(
+    az_cbor_writer* out_cbor_writer,
+    az_span first_destination_buffer,
+    az_span_allocator_fn allocator_callback,
+    void* user_context)
+{
+  _az_PRECONDITION_NOT_NULL(out_cbor_writer);
+  _az_PRECONDITION_NOT_NULL(allocator_callback);
+
+  *out_cbor_writer = (az_cbor_writer){
+    ._internal = {
+      .destination_buffer = first_destination_buffer,
+      .bytes_written = 0,
+      .total_bytes_written = 0,
+      .allocator_callback = allocator_callback,
+      .user_context = user_context,
+      .depth = 0,
+      .map_stack = 0,
+    },
+  };
+  return AZ_OK;
+}
+
+static AZ_NODISCARD az_span
+_az_cbor_writer_get_remaining_span(az_cbor_writer* ref_cbor_writer, int32_t required_size)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+  _az_PRECONDITION(required_size > 0);
+
+  az_span remaining = az_span_slice_to_end(
+      ref_cbor_writer->_internal.destination_buffer, ref_cbor_writer->_internal.bytes_written);
+
+  if (az_span_size(remaining) < required_size
+      && ref_cbor_writer->_internal.allocator_callback != NULL)
+  {
+    az_span_allocator_context context = {
+      .user_context = ref_cbor_writer->_internal.user_context,
+      .bytes_used = ref_cbor_writer->_internal.bytes_written,
+      .minimum_required_size = required_size,
+    };
+
+    // No more space left in the destination, let the caller fail with AZ_ERROR_NOT_ENOUGH_SPACE.
+    if (az_result_failed(ref_cbor_writer->_internal.allocator_callback(&context, &remaining)))
+    {
+      return AZ_SPAN_EMPTY;
+    }
+    ref_cbor_writer->_internal.destination_buffer = remaining;
+    ref_cbor_writer->_internal.bytes_written = 0;
+  }
+
+  return remaining;
+}
+
+static void _az_cbor_writer_update_state(az_cbor_writer* ref_cbor_writer, int32_t bytes_written)
+{
+  ref_cbor_writer->_internal.bytes_written += bytes_written;
+  ref_cbor_writer->_internal.total_bytes_written += bytes_written;
+}
+
+// Returns the number of bytes following the initial byte for the shortest encoding of an argument.
+AZ_NODISCARD static int32_t _az_cbor_argument_size(uint64_t argument)
+{
+  if (argument < _az_CBOR_INFO_ONE_BYTE)
+  {
+    return 0;
+  }
+  if (argument <= UINT8_MAX)
+  {
+    return 1;
+  }
+  if (argument <= UINT16_MAX)
+  {
+    return 2;
+  }
+  if (argument <= UINT32_MAX)
+  {
+    return 4;
+  }
+  return 8;
+}
+
+// Writes the head of a data item, made of the initial byte and the argument in big endian order.
+// Arguments held within the initial byte have an argument_size of 0.
+AZ_NODISCARD static az_result _az_cbor_writer_append_head_with_size(
+    az_cbor_writer* ref_cbor_writer,
+    uint8_t major_type,
+    uint64_t argument,
+    int32_t argument_size)
+{
+  int32_t const required_size = 1 + argument_size;
+  az_span remaining = _az_cbor_writer_get_remaining_span(ref_cbor_writer, required_size);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining, required_size);
+
+  uint8_t* head = az_span_ptr(remaining);
+  uint8_t info;
+  switch (argument_size)
+  {
+    case 0:
+      info = (uint8_t)argument;
+      break;
+    case 1:
+      info = _az_CBOR_INFO_ONE_BYTE;
+      break;
+    case 2:
+      info = _az_CBOR_INFO_TWO_BYTES;
+      break;
+    case 4:
+      info = _az_CBOR_INFO_FOUR_BYTES;
+      break;
+    default:
+      info = _az_CBOR_INFO_EIGHT_BYTES;
+      break;
+  }
+
+  head[0] = (uint8_t)((major_type << 5) | info);
+  for (int32_t i = argument_size; i > 0; i--)
+  {
+    head[i] = (uint8_t)argument;
+    argument >>= 8;
+  }
+
+  _az_cbor_writer_update_state(ref_cbor_writer, required_size);
+  return AZ_OK;
+}
+
+AZ_NODISCARD static az_result
+_az_cbor_writer_append_head(az_cbor_writer* ref_cbor_writer, uint8_t major_type, uint64_t argument)
+{
+  return _az_cbor_writer_append_head_with_size(
+      ref_cbor_writer, major_type, argument, _az_cbor_argument_size(argument));
+}
+
+AZ_NODISCARD static az_result _az_cbor_writer_append_string(
+    az_cbor_writer* ref_cbor_writer,
+    uint8_t major_type,
+    az_span value)
+{
+  int32_t const value_size = az_span_size(value);
+
+  // A single buffer is checked up front, to leave it untouched when the string doesn't fit.
+  if (ref_cbor_writer->_internal.allocator_callback == NULL)
+  {
+    az_span remaining = az_span_slice_to_end(
+        ref_cbor_writer->_internal.destination_buffer, ref_cbor_writer->_internal.bytes_written);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(
+        remaining, 1 + _az_cbor_argument_size((uint64_t)value_size) + value_size);
+  }
+
+  _az_RETURN_IF_FAILED(
+      _az_cbor_writer_append_head(ref_cbor_writer, major_type, (uint64_t)value_size));
+
+  // The content of the string is copied into as many buffers as it takes.
+  while (az_span_size(value) > 0)
+  {
+    az_span remaining = _az_cbor_writer_get_remaining_span(ref_cbor_writer, 1);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining, 1);
+
+    int32_t const chunk_size = az_span_size(remaining) < az_span_size(value)
+        ? az_span_size(remaining)
+        : az_span_size(value);
+    az_span_copy(remaining, az_span_slice(value, 0, chunk_size));
+    _az_cbor_writer_update_state(ref_cbor_writer, chunk_size);
+    value = az_span_slice_to_end(value, chunk_size);
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_cbor_writer_append_uint64(az_cbor_writer* ref_cbor_writer, uint64_t value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+
+  return _az_cbor_writer_append_head(ref_cbor_writer, _az_CBOR_MAJOR_TYPE_UNSIGNED, value);
+}
+
+AZ_NODISCARD az_result az_cbor_writer_append_int64(az_cbor_writer* ref_cbor_writer, int64_t value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+
+  if (value >= 0)
+  {
+    return _az_cbor_writer_append_head(
+        ref_cbor_writer, _az_CBOR_MAJOR_TYPE_UNSIGNED, (uint64_t)value);
+  }
+
+  // A negative integer n is encoded as -1 - n, which doesn't overflow for INT64_MIN.
+  return _az_cbor_writer_append_head(
+      ref_cbor_writer, _az_CBOR_MAJOR_TYPE_NEGATIVE, (uint64_t)(-(value + 1)));
+}
+
+// Converts the bits of a single precision float to those of a half precision float with the same
+// value, if there is one.
+AZ_NODISCARD static bool _az_cbor_float_to_half(uint32_t float_bits, uint16_t* out_half_bits)
+{
+  uint16_t const sign = (uint16_t)((float_bits >> 16) & 0x8000);
+  int32_t const exponent = (int32_t)((float_bits >> 23) & 0xFF);
+  uint32_t const mantissa = float_bits & 0x7FFFFF;
+
+  if (exponent == 0xFF)
+  {
+    // Infinities keep their sign, and NaN payloads are dropped for the canonical quiet NaN.
+    *out_half_bits = mantissa == 0 ? (uint16_t)(sign | 0x7C00) : (uint16_t)0x7E00;
+    return true;
+  }
+
+  if (exponent == 0 && mantissa == 0)
+  {
+    *out_half_bits = sign;
+    return true;
+  }
+
+  int32_t const unbiased_exponent = exponent - 127;
+
+  // Normal half precision numbers, whose mantissa keeps 10 of the 23 bits.
+  if (unbiased_exponent >= -14 && unbiased_exponent <= 15)
+  {
+    if ((mantissa & 0x1FFF) != 0)
+    {
+      return false;
+    }
+    *out_half_bits
+        = (uint16_t)(sign | (uint32_t)(unbiased_exponent + 15) << 10 | (mantissa >> 13));
+    return true;
+  }
+
+  // Subnormal half precision numbers, m * 2^-24 for m < 1024, which single precision subnormals are
+  // all too small to be.
+  if (exponent != 0 && unbiased_exponent >= -24 && unbiased_exponent < -14)
+  {
+    uint32_t const significand = 0x800000 | mantissa;
+    int32_t const shift = -(unbiased_exponent + 1);
+    if ((significand & ((1u << shift) - 1)) != 0)
+    {
+      return false;
+    }
+    *out_half_bits = (uint16_t)(sign | (significand >> shift));
+    return true;
+  }
+
+  return false;
+}
+
+AZ_NODISCARD az_result az_cbor_writer_append_double(az_cbor_writer* ref_cbor_writer, double value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+
+  uint64_t double_bits;
+  memcpy(&double_bits, &value, sizeof(double_bits));
+
+  // The value is compared bitwise after a round trip through a single precision float, which also
+  // tells -0.0 apart. NaN is written as a half precision float regardless of its payload.
+  float const single_value = (float)value;
+  double const round_trip_value = (double)single_value;
+  uint64_t round_trip_bits;
+  memcpy(&round_trip_bits, &round_trip_value, sizeof(round_trip_bits));
+
+  bool const is_nan = (double_bits & 0x7FF0000000000000) == 0x7FF0000000000000
+      && (double_bits & 0x000FFFFFFFFFFFFF) != 0;
+
+  if (is_nan || round_trip_bits == double_bits)
+  {
+    uint32_t float_bits;
+    memcpy(&float_bits, &single_value, sizeof(float_bits));
+
+    uint16_t half_bits;
+    if (_az_cbor_float_to_half(float_bits, &half_bits))
+    {
+      return _az_cbor_writer_append_head_with_size(
+          ref_cbor_writer, _az_CBOR_MAJOR_TYPE_SIMPLE, half_bits, 2);
+    }
+
+    return _az_cbor_writer_append_head_with_size(
+        ref_cbor_writer, _az_CBOR_MAJOR_TYPE_SIMPLE, float_bits, 4);
+  }
+
+  return _az_cbor_writer_append_head_with_size(
+      ref_cbor_writer, _az_CBOR_MAJOR_TYPE_SIMPLE, double_bits, 8);
+}
+
+AZ_NODISCARD az_result az_cbor_writer_append_bool(az_cbor_writer* ref_cbor_writer, bool value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+
+  return _az_cbor_writer_append_head_with_size(
+      ref_cbor_writer,
+      _az_CBOR_MAJOR_TYPE_SIMPLE,
+      value ? _az_CBOR_SIMPLE_TRUE : _az_CBOR_SIMPLE_FALSE,
+      0);
+}
+
+AZ_NODISCARD az_result az_cbor_writer_append_null(az_cbor_writer* ref_cbor_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+
+  return _az_cbor_writer_append_head_with_size(
+      ref_cbor_writer, _az_CBOR_MAJOR_TYPE_SIMPLE, _az_CBOR_SIMPLE_NULL, 0);
+}
+
+AZ_NODISCARD az_result
+az_cbor_writer_append_text_string(az_cbor_writer* ref_cbor_writer, az_span value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+  _az_PRECONDITION_VALID_SPAN(value, 0, true);
+
+  return _az_cbor_writer_append_string(ref_cbor_writer, _az_CBOR_MAJOR_TYPE_TEXT_STRING, value);
+}
+
+AZ_NODISCARD az_result
+az_cbor_writer_append_byte_string(az_cbor_writer* ref_cbor_writer, az_span value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+  _az_PRECONDITION_VALID_SPAN(value, 0, true);
+
+  return _az_cbor_writer_append_string(ref_cbor_writer, _az_CBOR_MAJOR_TYPE_BYTE_STRING, value);
+}
+
+AZ_NODISCARD static az_result
+_az_cbor_writer_append_begin_container(az_cbor_writer* ref_cbor_writer, uint8_t major_type)
+{
+  if (ref_cbor_writer->_internal.depth >= _az_CBOR_WRITER_MAX_NESTING_DEPTH)
+  {
+    return AZ_ERROR_CBOR_NESTING_OVERFLOW;
+  }
+
+  _az_RETURN_IF_FAILED(_az_cbor_writer_append_head_with_size(
+      ref_cbor_writer, major_type, _az_CBOR_INFO_INDEFINITE, 0));
+
+  uint64_t const bit = (uint64_t)1 << ref_cbor_writer->_internal.depth;
+  if (major_type == _az_CBOR_MAJOR_TYPE_MAP)
+  {
+    ref_cbor_writer->_internal.map_stack |= bit;
+  }
+  else
+  {
+    ref_cbor_writer->_internal.map_stack &= ~bit;
+  }
+  ref_cbor_writer->_internal.depth++;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD static az_result
+_az_cbor_writer_append_end_container(az_cbor_writer* ref_cbor_writer, bool is_map)
+{
+  // The end must match the innermost container which is still open.
+  _az_PRECONDITION(ref_cbor_writer->_internal.depth > 0);
+  _az_PRECONDITION(
+      ((ref_cbor_writer->_internal.map_stack >> (ref_cbor_writer->_internal.depth - 1)) & 1)
+      == (is_map ? 1u : 0u));
+  (void)is_map;
+
+  az_span remaining = _az_cbor_writer_get_remaining_span(ref_cbor_writer, 1);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining, 1);
+
+  az_span_ptr(remaining)[0] = _az_CBOR_BREAK;
+  _az_cbor_writer_update_state(ref_cbor_writer, 1);
+  ref_cbor_writer->_internal.depth--;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_cbor_writer_append_begin_array(az_cbor_writer* ref_cbor_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+
+  return _az_cbor_writer_append_begin_container(ref_cbor_writer, _az_CBOR_MAJOR_TYPE_ARRAY);
+}
+
+AZ_NODISCARD az_result az_cbor_writer_append_begin_map(az_cbor_writer* ref_cbor_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+
+  return _az_cbor_writer_append_begin_container(ref_cbor_writer, _az_CBOR_MAJOR_TYPE_MAP);
+}
+
+AZ_NODISCARD az_result az_cbor_writer_append_end_array(az_cbor_writer* ref_cbor_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+
+  return _az_cbor_writer_append_end_container(ref_cbor_writer, false);
+}
+
+AZ_NODISCARD az_result az_cbor_writer_append_end_map(az_cbor_writer* ref_cbor_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+
+  return _az_cbor_writer_append_end_container(ref_cbor_writer, true);
+}
+
+AZ_NODISCARD az_result az_cbor_writer_append_int64_delta_array(
+    az_cbor_writer* ref_cbor_writer,
+    int64_t const* values,
+    int32_t values_count)
+{
+  _az_PRECONDITION_NOT_NULL(ref_cbor_writer);
+  _az_PRECONDITION(values_count >= 0);
+  _az_PRECONDITION(values != NULL || values_count == 0);
+
+  // The number of elements is known, so the array has a definite length and no break byte.
+  _az_RETURN_IF_FAILED(_az_cbor_writer_append_head(
+      ref_cbor_writer, _az_CBOR_MAJOR_TYPE_ARRAY, (uint64_t)values_count));
+
+  int64_t previous = 0;
+  for (int32_t i = 0; i < values_count; i++)
+  {
+    // The difference of two 64-bit integers can need 65 bits, which CBOR integers have: it is
+    // computed as a magnitude and a sign rather than as an int64_t which could overflow.
+    int64_t const value = values[i];
+    if (value >= previous)
+    {
+      _az_RETURN_IF_FAILED(_az_cbor_writer_append_head(
+          ref_cbor_writer, _az_CBOR_MAJOR_TYPE_UNSIGNED, (uint64_t)value - (uint64_t)previous));
+    }
+    else
+    {
+      _az_RETURN_IF_FAILED(_az_cbor_writer_append_head(
+          ref_cbor_writer,
+          _az_CBOR_MAJOR_TYPE_NEGATIVE,
+          (uint64_t)previous - (uint64_t)value - 1));
+    }
+
+    previous = value;
+  }
+
+  return AZ_OK;
+}
@@ -5,6 +5,7 @@
 #include <azure/core/internal/az_precondition_internal.h>
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -12,15 +13,30 @@
 // never expires. Call az_context_cancel passing a pointer to this node to cancel the entire
 // application (which cancels all the child nodes).
 az_context az_context_application = {
-  ._internal
-  = { .parent = NULL, .expiration = _az_CONTEXT_MAX_EXPIRATION, .key = NULL, .value = NULL }
+  ._internal = {
+    .parent = NULL,
+    .expiration = _az_CONTEXT_MAX_EXPIRATION,
+    .key = NULL,
+    .value = NULL,
+    .effective_expiration = _az_CONTEXT_MAX_EXPIRATION,
+    .cancel_epoch = 0,
+  },
 };
 
+// Changes every time a node is canceled. A canceled node may have children, which can't be found
+// from it, so the expiration cached by every node created before is no longer trusted.
+static uint32_t volatile _az_context_cancel_epoch = 0;
+
 // Returns the soonest expiration time of this az_context node or any of its parent nodes.
 AZ_NODISCARD int64_t az_context_get_expiration(az_context const* context)
 {
   _az_PRECONDITION_NOT_NULL(context);
 
+  if (context->_internal.cancel_epoch == _az_context_cancel_epoch)
+  {
+    return context->_internal.effective_expiration;
+  }
+
   int64_t expiration = _az_CONTEXT_MAX_EXPIRATION;
   for (; context != NULL; context = context->_internal.parent)
   {
@@ -60,7 +76,18 @@ az_context_create_with_expiration(az_context const* parent, int64_t expiration)
   _az_PRECONDITION_NOT_NULL(parent);
   _az_PRECONDITION(expiration >= 0);
 
-  return (az_context){ ._internal = { .parent = parent, .expiration = expiration } };
+  // Read the epoch first, so that a node canceled while the expiration is computed isn't missed.
+  uint32_t const cancel_epoch = _az_context_cancel_epoch;
+  int64_t const parent_expiration = az_context_get_expiration(parent);
+
+  return (az_context){ ._internal = {
+    .parent = parent,
+    .expiration = expiration,
+    .key = NULL,
+    .value = NULL,
+    .effective_expiration = expiration < parent_expiration ? expiration : parent_expiration,
+    .cancel_epoch = cancel_epoch,
+  } };
 }
 
 AZ_NODISCARD az_context
@@ -69,10 +96,40 @@ az_context_create_with_value(az_context const* parent, void const* key, void con
   _az_PRECONDITION_NOT_NULL(parent);
   _az_PRECONDITION_NOT_NULL(key);
 
-  return (az_context){
-    ._internal
-    = { .parent = parent, .expiration = _az_CONTEXT_MAX_EXPIRATION, .key = key, .value = value }
-  };
+  uint32_t const cancel_epoch = _az_context_cancel_epoch;
+  int64_t const parent_expiration = az_context_get_expiration(parent);
+
+  return (az_context){ ._internal = {
+    .parent = parent,
+    .expiration = _az_CONTEXT_MAX_EXPIRATION,
+    .key = key,
+    .value = value,
+    .effective_expiration = parent_expiration,
+    .cancel_epoch = cancel_epoch,
+  } };
+}
+
+// The key of the nodes holding a wake event, of which only the address matters.
+static uint8_t const _az_context_wake_event_key = 0;
+
+AZ_NODISCARD az_context
+az_context_create_with_wake_event(az_context const* parent, az_platform_event* wake_event)
+{
+  _az_PRECONDITION_NOT_NULL(wake_event);
+  return az_context_create_with_value(parent, &_az_context_wake_event_key, wake_event);
+}
+
+AZ_NODISCARD az_result
+az_context_get_wake_event(az_context const* context, az_platform_event** out_wake_event)
+{
+  _az_PRECONDITION_NOT_NULL(out_wake_event);
+
+  void const* value = NULL;
+  az_result const result = az_context_get_value(context, &_az_context_wake_event_key, &value);
+
+  // The event was given as a mutable pointer to az_context_create_with_wake_event().
+  *out_wake_event = (az_platform_event*)(uintptr_t)value;
+  return result;
 }
 
 void az_context_cancel(az_context* ref_context)
@@ -80,6 +137,8 @@ void az_context_cancel(az_context* ref_context)
   _az_PRECONDITION_NOT_NULL(ref_context);
 
   ref_context->_internal.expiration = 0; // The beginning of time
+  ref_context->_internal.effective_expiration = 0;
+  _az_context_cancel_epoch++;
 }
 
 AZ_NODISCARD bool az_context_has_expired(az_context const* context, int64_t current_time)
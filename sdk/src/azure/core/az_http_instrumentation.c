@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/az_http_instrumentation.h>
+#include <azure/core/internal/az_http_internal.h>
+
+#include <stddef.h>
+
+#include <azure/core/_az_cfg.h>
+
+// Only using volatile here, not for thread safety, but so that the compiler does not optimize what
+// it falsely thinks are stale reads.
+static az_http_instrumentation_fn volatile _az_http_instrumentation_callback = NULL;
+
+void az_http_set_instrumentation_callback(az_http_instrumentation_fn instrumentation_callback)
+{
+  // We assume assignments are atomic for the supported platforms and compilers.
+  _az_http_instrumentation_callback = instrumentation_callback;
+}
+
+bool _az_http_instrumentation_enabled(void) { return _az_http_instrumentation_callback != NULL; }
+
+void _az_http_instrumentation_write(
+    az_http_request const* request,
+    az_http_instrumentation_kind kind,
+    az_http_instrumentation_phase phase,
+    int32_t index,
+    az_result result,
+    int64_t elapsed_usec)
+{
+  // Copy the volatile field to a local variable so that it doesn't change within this function.
+  az_http_instrumentation_fn const callback = _az_http_instrumentation_callback;
+  if (callback == NULL)
+  {
+    return;
+  }
+
+  az_http_instrumentation_event const event = {
+    .request = request,
+    .elapsed_usec = elapsed_usec,
+    .index = index,
+    .result = result,
+    .kind = kind,
+    .phase = phase,
+  };
+
+  callback(&event);
+}
+
+AZ_NODISCARD az_result _az_http_pipeline_process_instrumented_policy(
+    _az_http_policy* ref_policies,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  int32_t const index = ref_request->_internal.policy_depth++;
+  _az_http_instrumentation_write(
+      ref_request, AZ_HTTP_INSTRUMENTATION_POLICY, AZ_HTTP_INSTRUMENTATION_BEGIN, index, AZ_OK, 0);
+
+  az_result const result = ref_policies[0]._internal.process(
+      &(ref_policies[1]), ref_policies[0]._internal.options, ref_request, ref_response);
+
+  ref_request->_internal.policy_depth = index;
+  _az_http_instrumentation_write(
+      ref_request, AZ_HTTP_INSTRUMENTATION_POLICY, AZ_HTTP_INSTRUMENTATION_END, index, result, 0);
+
+  return result;
+}
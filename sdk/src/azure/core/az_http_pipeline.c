@@ -2,8 +2,10 @@
 // SPDX-License-Identifier: MIT
 
 #include <azure/core/az_http.h>
+#include <azure/core/az_platform.h>
 #include <azure/core/internal/az_http_internal.h>
 #include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -16,9 +18,91 @@ AZ_NODISCARD az_result az_http_pipeline_process(
   _az_PRECONDITION_NOT_NULL(ref_response);
   _az_PRECONDITION_NOT_NULL(ref_pipeline);
 
+  if (_az_http_instrumentation_enabled())
+  {
+    ref_request->_internal.policy_depth = 0;
+    return _az_http_pipeline_process_instrumented_policy(
+        ref_pipeline->_internal.policies, ref_request, ref_response);
+  }
+
   return ref_pipeline->_internal.policies[0]._internal.process(
       &(ref_pipeline->_internal.policies[1]),
       ref_pipeline->_internal.policies[0]._internal.options,
       ref_request,
       ref_response);
 }
+
+static az_result _az_http_pipeline_operation_complete(
+    _az_http_pipeline_operation* ref_operation,
+    az_result result)
+{
+  if (result != AZ_ERROR_HTTP_PIPELINE_SUSPENDED)
+  {
+    // Detach, so the request can be sent through the pipeline again.
+    ref_operation->_internal.request->_internal.pipeline_operation = NULL;
+    ref_operation->_internal.resume_policy = NULL;
+  }
+
+  return result;
+}
+
+AZ_NODISCARD az_result az_http_pipeline_process_start(
+    _az_http_pipeline* ref_pipeline,
+    _az_http_pipeline_operation* out_operation,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  _az_PRECONDITION_NOT_NULL(ref_pipeline);
+  _az_PRECONDITION_NOT_NULL(out_operation);
+  _az_PRECONDITION_NOT_NULL(ref_request);
+  _az_PRECONDITION_NOT_NULL(ref_response);
+
+  *out_operation = (_az_http_pipeline_operation){ ._internal = {
+                                                      .pipeline = ref_pipeline,
+                                                      .request = ref_request,
+                                                      .response = ref_response,
+                                                      .resume_policy = NULL,
+                                                      .resume_at_msec = 0,
+                                                      .retry_attempt = 0,
+                                                      .retry_delay_msec = 0,
+                                                  } };
+
+  ref_request->_internal.pipeline_operation = out_operation;
+
+  return _az_http_pipeline_operation_complete(
+      out_operation, az_http_pipeline_process(ref_pipeline, ref_request, ref_response));
+}
+
+AZ_NODISCARD az_result az_http_pipeline_process_resume(_az_http_pipeline_operation* ref_operation)
+{
+  _az_PRECONDITION_NOT_NULL(ref_operation);
+  _az_PRECONDITION_NOT_NULL(ref_operation->_internal.resume_policy);
+
+  int64_t clock = 0;
+  _az_RETURN_IF_FAILED(az_platform_clock_msec(&clock));
+  if (clock < ref_operation->_internal.resume_at_msec)
+  {
+    return AZ_ERROR_HTTP_PIPELINE_SUSPENDED;
+  }
+
+  _az_http_policy* const policy = ref_operation->_internal.resume_policy;
+  ref_operation->_internal.resume_policy = NULL;
+
+  if (_az_http_instrumentation_enabled())
+  {
+    ref_operation->_internal.request->_internal.policy_depth
+        = (int32_t)(policy - ref_operation->_internal.pipeline->_internal.policies);
+    return _az_http_pipeline_operation_complete(
+        ref_operation,
+        _az_http_pipeline_process_instrumented_policy(
+            policy, ref_operation->_internal.request, ref_operation->_internal.response));
+  }
+
+  return _az_http_pipeline_operation_complete(
+      ref_operation,
+      policy->_internal.process(
+          &(policy[1]),
+          policy->_internal.options,
+          ref_operation->_internal.request,
+          ref_operation->_internal.response));
+}
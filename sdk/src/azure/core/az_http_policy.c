@@ -1,12 +1,17 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
+#include "az_http_header_validation_private.h"
 #include "az_http_private.h"
+#include "az_span_private.h"
 #include <azure/core/az_credentials.h>
 #include <azure/core/az_http.h>
+#include <azure/core/az_platform.h>
 #include <azure/core/az_span.h>
 #include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
 #include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -26,7 +31,7 @@ AZ_NODISCARD az_result az_http_pipeline_policy_apiversion(
   {
     case _az_http_policy_apiversion_option_location_header:
       // Add the version as a header
-      _az_RETURN_IF_FAILED(az_http_request_append_header(
+      _az_RETURN_IF_FAILED(_az_http_request_append_header_literal_name(
           ref_request, options->_internal.name, options->_internal.version));
       break;
     case _az_http_policy_apiversion_option_location_queryparameter:
@@ -51,12 +56,215 @@ AZ_NODISCARD az_result az_http_pipeline_policy_telemetry(
 
   _az_http_policy_telemetry_options* options = (_az_http_policy_telemetry_options*)(ref_options);
 
-  _az_RETURN_IF_FAILED(
-      az_http_request_append_header(ref_request, AZ_HTTP_HEADER_USER_AGENT, options->os));
+  _az_RETURN_IF_FAILED(_az_http_request_append_header_literal_name(
+      ref_request, AZ_HTTP_HEADER_USER_AGENT, options->os));
 
   return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
 }
 
+AZ_NODISCARD az_result az_http_pipeline_policy_static_headers(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  _az_http_policy_static_headers_options const* const options
+      = (_az_http_policy_static_headers_options const*)ref_options;
+
+  _az_RETURN_IF_FAILED(_az_http_request_append_headers(
+      ref_request, options->_internal.headers, options->_internal.headers_length));
+
+  _az_RETURN_IF_FAILED(_az_http_request_append_query(
+      ref_request,
+      az_span_slice(options->_internal.query_buffer, 0, options->_internal.query_length)));
+
+  return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+}
+
+AZ_NODISCARD az_result _az_http_policy_static_headers_options_add_header(
+    _az_http_policy_static_headers_options* ref_options,
+    az_span name,
+    az_span value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_options);
+
+  name = _az_span_trim_whitespace(name);
+  value = _az_span_trim_whitespace(value);
+
+  // Validated here, and not only as a precondition, as that is done once rather than per request.
+  if (az_span_size(name) == 0 || !az_http_is_valid_header_name(name))
+  {
+    return AZ_ERROR_ARG;
+  }
+
+  if (ref_options->_internal.headers_length >= _az_HTTP_POLICY_STATIC_HEADERS_MAX)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  ref_options->_internal.headers[ref_options->_internal.headers_length++]
+      = (_az_http_request_header){ .name = name, .value = value };
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result _az_http_policy_static_headers_options_add_query_parameter(
+    _az_http_policy_static_headers_options* ref_options,
+    az_span name,
+    az_span value,
+    bool is_value_url_encoded)
+{
+  _az_PRECONDITION_NOT_NULL(ref_options);
+  _az_PRECONDITION_VALID_SPAN(name, 1, false);
+  _az_PRECONDITION_VALID_SPAN(value, 1, false);
+
+  int32_t const query_length = ref_options->_internal.query_length;
+  az_span remainder = az_span_slice_to_end(ref_options->_internal.query_buffer, query_length);
+
+  // Adding 1 for the `=`, and, after the first parameter, 1 for the `&` before the name.
+  int32_t const name_length = (query_length == 0 ? 1 : 2) + az_span_size(name);
+  int32_t value_length = az_span_size(value);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, name_length + value_length);
+
+  if (query_length != 0)
+  {
+    remainder = az_span_copy_u8(remainder, '&');
+  }
+
+  remainder = az_span_copy(remainder, name);
+  remainder = az_span_copy_u8(remainder, '=');
+
+  if (is_value_url_encoded)
+  {
+    az_span_copy(remainder, value);
+  }
+  else
+  {
+    // query_length is only updated below, so anything written on failure is ignored.
+    _az_RETURN_IF_FAILED(_az_span_url_encode(remainder, value, &value_length));
+  }
+
+  ref_options->_internal.query_length += name_length + value_length;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result _az_http_pipeline_freeze(
+    _az_http_pipeline* ref_pipeline,
+    _az_http_policy_static_headers_options* ref_options)
+{
+  _az_PRECONDITION_NOT_NULL(ref_pipeline);
+  _az_PRECONDITION_NOT_NULL(ref_options);
+  _az_PRECONDITION(!ref_pipeline->_internal.is_shared);
+
+  _az_http_policy* const policies = ref_pipeline->_internal.policies;
+
+  // Work on a copy, so the options are left unchanged if anything fails.
+  _az_http_policy_static_headers_options options = *ref_options;
+  int32_t first_frozen = -1;
+  int32_t policies_length = 0;
+
+  for (int32_t i = 0; i < _az_MAXIMUM_NUMBER_OF_POLICIES && policies[i]._internal.process != NULL;
+       ++i)
+  {
+    _az_http_policy_process_fn const process = policies[i]._internal.process;
+    if (process == az_http_pipeline_policy_apiversion)
+    {
+      _az_http_policy_apiversion_options const* const apiversion
+          = (_az_http_policy_apiversion_options const*)policies[i]._internal.options;
+
+      _az_RETURN_IF_FAILED(
+          apiversion->_internal.option_location
+                  == _az_http_policy_apiversion_option_location_header
+              ? _az_http_policy_static_headers_options_add_header(
+                  &options, apiversion->_internal.name, apiversion->_internal.version)
+              : _az_http_policy_static_headers_options_add_query_parameter(
+                  &options, apiversion->_internal.name, apiversion->_internal.version, true));
+    }
+    else if (process == az_http_pipeline_policy_telemetry)
+    {
+      _az_http_policy_telemetry_options const* const telemetry
+          = (_az_http_policy_telemetry_options const*)policies[i]._internal.options;
+
+      _az_RETURN_IF_FAILED(_az_http_policy_static_headers_options_add_header(
+          &options, AZ_HTTP_HEADER_USER_AGENT, telemetry->os));
+    }
+    else
+    {
+      continue;
+    }
+
+    if (first_frozen < 0)
+    {
+      first_frozen = i;
+    }
+  }
+
+  if (first_frozen < 0)
+  {
+    return AZ_OK;
+  }
+
+  *ref_options = options;
+
+  // Replace the first frozen policy by the static headers policy, and drop the others, keeping the
+  // order of the remaining policies.
+  for (int32_t i = 0; i < _az_MAXIMUM_NUMBER_OF_POLICIES && policies[i]._internal.process != NULL;
+       ++i)
+  {
+    _az_http_policy_process_fn const process = policies[i]._internal.process;
+    if (i == first_frozen)
+    {
+      policies[policies_length]._internal.process = az_http_pipeline_policy_static_headers;
+      policies[policies_length]._internal.options = ref_options;
+      policies_length++;
+    }
+    else if (process != az_http_pipeline_policy_apiversion
+             && process != az_http_pipeline_policy_telemetry)
+    {
+      policies[policies_length++] = policies[i];
+    }
+  }
+
+  for (int32_t i = policies_length; i < _az_MAXIMUM_NUMBER_OF_POLICIES; ++i)
+  {
+    policies[i]._internal.process = NULL;
+    policies[i]._internal.options = NULL;
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result _az_http_pipeline_share(_az_http_pipeline* ref_pipeline)
+{
+  _az_PRECONDITION_NOT_NULL(ref_pipeline);
+
+  _az_http_policy const* const policies = ref_pipeline->_internal.policies;
+  for (int32_t i = 0; i < _az_MAXIMUM_NUMBER_OF_POLICIES && policies[i]._internal.process != NULL;
+       ++i)
+  {
+    _az_http_policy_process_fn const process = policies[i]._internal.process;
+    if (process == az_http_pipeline_policy_hedging || process == az_http_pipeline_policy_compression
+        || process == az_http_pipeline_policy_rate_limit
+        || process == az_http_pipeline_policy_cache)
+    {
+      return AZ_ERROR_NOT_SUPPORTED;
+    }
+
+#if !defined(__GNUC__) && !defined(__clang__)
+    // Without atomic operations, the circuit breaker policy can't guard the health of its hosts.
+    if (process == az_http_pipeline_policy_circuit_breaker)
+    {
+      return AZ_ERROR_NOT_SUPPORTED;
+    }
+#endif
+
+  }
+
+  ref_pipeline->_internal.is_shared = true;
+  return AZ_OK;
+}
+
 AZ_NODISCARD az_result az_http_pipeline_policy_credential(
     _az_http_policy* ref_policies,
     void* ref_options,
@@ -87,5 +295,133 @@ AZ_NODISCARD az_result az_http_pipeline_policy_transport(
   // make sure the response is resetted
   _az_http_response_reset(ref_response);
 
-  return az_http_client_send_request(ref_request, ref_response);
+  _az_http_instrumentation_write(
+      ref_request, AZ_HTTP_INSTRUMENTATION_TRANSPORT, AZ_HTTP_INSTRUMENTATION_BEGIN, 0, AZ_OK, 0);
+
+  az_result const result = az_http_client_send_request(ref_request, ref_response);
+
+  _az_http_instrumentation_write(
+      ref_request, AZ_HTTP_INSTRUMENTATION_TRANSPORT, AZ_HTTP_INSTRUMENTATION_END, 0, result, 0);
+
+  return result;
+}
+
+AZ_NODISCARD _az_http_policy_hedging_options
+_az_http_policy_hedging_options_default(az_span hedge_response_buffer)
+{
+  return (_az_http_policy_hedging_options){
+    ._internal = {
+      .hedge_response_buffer = hedge_response_buffer,
+      .percentile = 95,
+      .initial_delay_msec = 1000,
+      .latencies_msec = { 0 },
+      .latency_count = 0,
+    },
+  };
+}
+
+AZ_NODISCARD int32_t
+_az_http_policy_hedging_get_delay_msec(_az_http_policy_hedging_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(options);
+
+  // Until there are enough samples, a single slow request would set the delay.
+  int32_t const count = options->_internal.latency_count < _az_HTTP_POLICY_HEDGING_LATENCY_SAMPLES
+      ? options->_internal.latency_count
+      : _az_HTTP_POLICY_HEDGING_LATENCY_SAMPLES;
+  if (count < _az_HTTP_POLICY_HEDGING_LATENCY_SAMPLES / 4)
+  {
+    return options->_internal.initial_delay_msec;
+  }
+
+  // Insertion sort, the sample count is small.
+  int32_t sorted[_az_HTTP_POLICY_HEDGING_LATENCY_SAMPLES];
+  for (int32_t i = 0; i < count; ++i)
+  {
+    int32_t const latency = options->_internal.latencies_msec[i];
+    int32_t j = i;
+    for (; j > 0 && sorted[j - 1] > latency; --j)
+    {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = latency;
+  }
+
+  int32_t const index = (count * options->_internal.percentile) / 100;
+  return sorted[index < count ? index : count - 1];
+}
+
+static void _az_http_policy_hedging_add_latency(
+    _az_http_policy_hedging_options* ref_options,
+    int64_t latency_msec)
+{
+  int32_t const count = ref_options->_internal.latency_count;
+  ref_options->_internal.latencies_msec[count % _az_HTTP_POLICY_HEDGING_LATENCY_SAMPLES]
+      = latency_msec < INT32_MAX ? (int32_t)latency_msec : INT32_MAX;
+
+  // Wrap around to a count that still shows there are enough samples.
+  ref_options->_internal.latency_count = count < INT32_MAX - 1
+      ? count + 1
+      : _az_HTTP_POLICY_HEDGING_LATENCY_SAMPLES;
+}
+
+AZ_NODISCARD az_result az_http_pipeline_policy_hedging(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  _az_http_policy_hedging_options* const options = (_az_http_policy_hedging_options*)ref_options;
+
+  az_http_method method = { 0 };
+  _az_RETURN_IF_FAILED(az_http_request_get_method(ref_request, &method));
+
+  // Only requests which can safely be sent twice are hedged. If the body goes to an allocator, the
+  // two responses would be mixed up in the allocated buffers.
+  if ((!az_span_is_content_equal(method, az_http_method_get())
+       && !az_span_is_content_equal(method, az_http_method_head()))
+      || ref_response->_internal.body_stream.allocator_callback != NULL
+      || az_span_size(options->_internal.hedge_response_buffer) == 0)
+  {
+    return az_http_pipeline_policy_transport(ref_policies, NULL, ref_request, ref_response);
+  }
+
+  _az_http_response_reset(ref_response);
+
+  az_http_response hedge_response = { 0 };
+  _az_RETURN_IF_FAILED(
+      az_http_response_init(&hedge_response, options->_internal.hedge_response_buffer));
+
+  int64_t start = 0;
+  _az_RETURN_IF_FAILED(az_platform_clock_msec(&start));
+
+  bool hedge_won = false;
+  az_result const result = az_http_client_send_hedged_request(
+      ref_request,
+      ref_response,
+      &hedge_response,
+      _az_http_policy_hedging_get_delay_msec(options),
+      &hedge_won);
+
+  if (result == AZ_ERROR_NOT_SUPPORTED)
+  {
+    return az_http_pipeline_policy_transport(ref_policies, NULL, ref_request, ref_response);
+  }
+
+  _az_RETURN_IF_FAILED(result);
+
+  int64_t end = 0;
+  _az_RETURN_IF_FAILED(az_platform_clock_msec(&end));
+  _az_http_policy_hedging_add_latency(options, end - start);
+
+  if (hedge_won)
+  {
+    _az_http_response_reset(ref_response);
+    _az_RETURN_IF_FAILED(az_http_response_append(
+        ref_response,
+        az_span_slice(
+            options->_internal.hedge_response_buffer, 0, hedge_response._internal.written)));
+  }
+
+  return AZ_OK;
 }
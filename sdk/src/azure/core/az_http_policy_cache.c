@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_http_private.h"
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+AZ_NODISCARD _az_http_policy_cache_options _az_http_policy_cache_options_default(az_span buffer)
+{
+  return (_az_http_policy_cache_options){
+    ._internal = {
+      .buffer = buffer,
+      .entries = { { { 0 } } },
+      .use_count = 0,
+    },
+  };
+}
+
+// FNV-1a hash, continued from hash so that the method and the URL are hashed as one key.
+static AZ_NODISCARD uint32_t _az_http_policy_cache_hash(uint32_t hash, az_span span)
+{
+  uint8_t const* const ptr = az_span_ptr(span);
+  int32_t const size = az_span_size(span);
+  for (int32_t i = 0; i < size; i++)
+  {
+    hash = (hash ^ ptr[i]) * 16777619U;
+  }
+  return hash;
+}
+
+static AZ_NODISCARD int32_t
+_az_http_policy_cache_slot_size(_az_http_policy_cache_options const* options)
+{
+  return az_span_size(options->_internal.buffer) / _az_HTTP_POLICY_CACHE_ENTRIES;
+}
+
+static AZ_NODISCARD az_span _az_http_policy_cache_get_slot(
+    _az_http_policy_cache_options const* options,
+    _az_http_policy_cache_entry const* entry)
+{
+  int32_t const slot_size = _az_http_policy_cache_slot_size(options);
+  int32_t const index = (int32_t)(entry - options->_internal.entries);
+  return az_span_slice(options->_internal.buffer, index * slot_size, (index + 1) * slot_size);
+}
+
+static AZ_NODISCARD _az_http_policy_cache_entry* _az_http_policy_cache_find(
+    _az_http_policy_cache_options* ref_options,
+    uint32_t key_hash,
+    az_span method,
+    az_span url)
+{
+  int32_t const key_size = az_span_size(method) + 1 + az_span_size(url);
+  for (int32_t i = 0; i < _az_HTTP_POLICY_CACHE_ENTRIES; i++)
+  {
+    _az_http_policy_cache_entry* const entry = &ref_options->_internal.entries[i];
+    if (!entry->_internal.is_used || entry->_internal.key_hash != key_hash
+        || entry->_internal.key_size != key_size)
+    {
+      continue;
+    }
+
+    az_span const slot = _az_http_policy_cache_get_slot(ref_options, entry);
+    if (az_span_is_content_equal(az_span_slice(slot, 0, az_span_size(method)), method)
+        && az_span_is_content_equal(az_span_slice(slot, az_span_size(method) + 1, key_size), url))
+    {
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+// Keeps the response in the slot of entry, or of the least recently used entry if it is NULL.
+static void _az_http_policy_cache_store(
+    _az_http_policy_cache_options* ref_options,
+    _az_http_policy_cache_entry* entry,
+    uint32_t key_hash,
+    az_span method,
+    az_span url,
+    az_span etag,
+    az_span last_modified,
+    az_span response)
+{
+  int32_t const key_size = az_span_size(method) + 1 + az_span_size(url);
+  if (key_size + az_span_size(etag) + az_span_size(last_modified) + az_span_size(response)
+      > _az_http_policy_cache_slot_size(ref_options))
+  {
+    if (entry != NULL)
+    {
+      entry->_internal.is_used = false;
+    }
+
+    return;
+  }
+
+  if (entry == NULL)
+  {
+    entry = &ref_options->_internal.entries[0];
+    for (int32_t i = 1; i < _az_HTTP_POLICY_CACHE_ENTRIES && entry->_internal.is_used; i++)
+    {
+      _az_http_policy_cache_entry* const candidate = &ref_options->_internal.entries[i];
+      if (!candidate->_internal.is_used
+          || candidate->_internal.used_at < entry->_internal.used_at)
+      {
+        entry = candidate;
+      }
+    }
+  }
+
+  az_span remainder = _az_http_policy_cache_get_slot(ref_options, entry);
+  remainder = az_span_copy(remainder, method);
+  remainder = az_span_copy_u8(remainder, ' ');
+  remainder = az_span_copy(remainder, url);
+  remainder = az_span_copy(remainder, etag);
+  remainder = az_span_copy(remainder, last_modified);
+  remainder = az_span_copy(remainder, response);
+
+  *entry = (_az_http_policy_cache_entry){
+    ._internal = {
+      .key_hash = key_hash,
+      .key_size = key_size,
+      .etag_size = az_span_size(etag),
+      .last_modified_size = az_span_size(last_modified),
+      .response_size = az_span_size(response),
+      .used_at = ++ref_options->_internal.use_count,
+      .is_used = true,
+    },
+  };
+}
+
+AZ_NODISCARD az_result az_http_pipeline_policy_cache(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  _az_http_policy_cache_options* const options = (_az_http_policy_cache_options*)ref_options;
+
+  az_http_method method = { 0 };
+  _az_RETURN_IF_FAILED(az_http_request_get_method(ref_request, &method));
+
+  // The body of a response received through an allocator isn't in the response buffer to be kept.
+  if ((!az_span_is_content_equal(method, az_http_method_get())
+       && !az_span_is_content_equal(method, az_http_method_head()))
+      || ref_response->_internal.body_stream.allocator_callback != NULL
+      || _az_http_policy_cache_slot_size(options) == 0)
+  {
+    return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  az_span url = { 0 };
+  _az_RETURN_IF_FAILED(az_http_request_get_url(ref_request, &url));
+
+  uint32_t const key_hash = _az_http_policy_cache_hash(
+      _az_http_policy_cache_hash(2166136261U, method), url);
+  _az_http_policy_cache_entry* entry = _az_http_policy_cache_find(options, key_hash, method, url);
+
+  if (entry != NULL)
+  {
+    az_span const slot = _az_http_policy_cache_get_slot(options, entry);
+    az_span const etag = az_span_slice(
+        slot, entry->_internal.key_size, entry->_internal.key_size + entry->_internal.etag_size);
+    az_span const last_modified = az_span_slice(
+        slot,
+        entry->_internal.key_size + entry->_internal.etag_size,
+        entry->_internal.key_size + entry->_internal.etag_size
+            + entry->_internal.last_modified_size);
+
+    if (az_span_size(etag) > 0)
+    {
+      _az_RETURN_IF_FAILED(_az_http_request_append_header_literal_name(
+          ref_request, AZ_SPAN_FROM_STR("If-None-Match"), etag));
+    }
+
+    if (az_span_size(last_modified) > 0)
+    {
+      _az_RETURN_IF_FAILED(_az_http_request_append_header_literal_name(
+          ref_request, AZ_SPAN_FROM_STR("If-Modified-Since"), last_modified));
+    }
+  }
+
+  az_result const result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  if (az_result_failed(result))
+  {
+    return result;
+  }
+
+  // Read from a copy, to leave the response for the policies ahead of this one.
+  az_http_response response_copy = *ref_response;
+  az_http_response_status_line status_line = { 0 };
+  _az_RETURN_IF_FAILED(az_http_response_get_status_line(&response_copy, &status_line));
+
+  if (status_line.status_code == AZ_HTTP_STATUS_CODE_NOT_MODIFIED && entry != NULL)
+  {
+    az_span const slot = _az_http_policy_cache_get_slot(options, entry);
+    int32_t const response_start = entry->_internal.key_size + entry->_internal.etag_size
+        + entry->_internal.last_modified_size;
+
+    entry->_internal.used_at = ++options->_internal.use_count;
+    _az_http_response_reset(ref_response);
+    return az_http_response_append(
+        ref_response,
+        az_span_slice(slot, response_start, response_start + entry->_internal.response_size));
+  }
+
+  if (status_line.status_code != AZ_HTTP_STATUS_CODE_OK)
+  {
+    return result;
+  }
+
+  az_span etag = AZ_SPAN_EMPTY;
+  az_span last_modified = AZ_SPAN_EMPTY;
+  bool no_store = false;
+  az_span header_name = { 0 };
+  az_span header_value = { 0 };
+  while (az_result_succeeded(
+      az_http_response_get_next_header(&response_copy, &header_name, &header_value)))
+  {
+    if (az_span_is_content_equal_ignoring_case(header_name, AZ_SPAN_FROM_STR("ETag")))
+    {
+      etag = header_value;
+    }
+    else if (az_span_is_content_equal_ignoring_case(header_name, AZ_SPAN_FROM_STR("Last-Modified")))
+    {
+      last_modified = header_value;
+    }
+    else if (az_span_is_content_equal_ignoring_case(header_name, AZ_SPAN_FROM_STR("Cache-Control")))
+    {
+      no_store = no_store || az_span_find(header_value, AZ_SPAN_FROM_STR("no-store")) >= 0;
+    }
+  }
+
+  if (no_store || (az_span_size(etag) == 0 && az_span_size(last_modified) == 0))
+  {
+    // The response can't be revalidated, forget any response kept for the URL.
+    if (entry != NULL)
+    {
+      entry->_internal.is_used = false;
+    }
+
+    return result;
+  }
+
+  _az_http_policy_cache_store(
+      options,
+      entry,
+      key_hash,
+      method,
+      url,
+      etag,
+      last_modified,
+      az_span_slice(ref_response->_internal.http_response, 0, ref_response->_internal.written));
+
+  return result;
+}
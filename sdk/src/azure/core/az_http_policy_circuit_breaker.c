@@ -0,0 +1,296 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_http_private.h"
+#include <azure/core/az_http.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_config_internal.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+AZ_NODISCARD _az_http_policy_circuit_breaker_options
+_az_http_policy_circuit_breaker_options_default(void)
+{
+  return (_az_http_policy_circuit_breaker_options){
+    ._internal = {
+      .hosts = { { { 0 } } },
+      .min_requests = 5,
+      .failure_percent = 50,
+      .window_msec = 10 * _az_TIME_MILLISECONDS_PER_SECOND,
+      .open_msec = 5 * _az_TIME_MILLISECONDS_PER_SECOND,
+      .lock = 0,
+    },
+  };
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+static void
+_az_http_policy_circuit_breaker_lock(_az_http_policy_circuit_breaker_options* ref_options)
+{
+  int32_t* const lock = &ref_options->_internal.lock;
+  while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) != 0)
+  {
+    while (__atomic_load_n(lock, __ATOMIC_RELAXED) != 0)
+    {
+    }
+  }
+}
+
+static void
+_az_http_policy_circuit_breaker_unlock(_az_http_policy_circuit_breaker_options* ref_options)
+{
+  __atomic_store_n(&ref_options->_internal.lock, 0, __ATOMIC_RELEASE);
+}
+#else
+// Without atomic operations, the hosts are only safe to use from a single thread.
+static void
+_az_http_policy_circuit_breaker_lock(_az_http_policy_circuit_breaker_options* ref_options)
+{
+  (void)ref_options;
+}
+
+static void
+_az_http_policy_circuit_breaker_unlock(_az_http_policy_circuit_breaker_options* ref_options)
+{
+  (void)ref_options;
+}
+#endif // defined(__GNUC__) || defined(__clang__)
+
+// FNV-1a hash of a host, with ASCII letters lower cased since host names are compared ignoring
+// case. Only the hash is kept, as the URL the host is read from doesn't outlive the request.
+static AZ_NODISCARD uint32_t _az_http_policy_circuit_breaker_host_hash(az_span host)
+{
+  uint32_t hash = 2166136261U;
+  uint8_t const* const ptr = az_span_ptr(host);
+  int32_t const size = az_span_size(host);
+  for (int32_t i = 0; i < size; i++)
+  {
+    uint8_t c = ptr[i];
+    if ('A' <= c && c <= 'Z')
+    {
+      c = (uint8_t)(c + ('a' - 'A'));
+    }
+    hash = (hash ^ c) * 16777619U;
+  }
+  return hash;
+}
+
+// The host, and port, of a URL: what is between the scheme and the path.
+static AZ_NODISCARD az_span _az_http_policy_circuit_breaker_get_host(az_span url)
+{
+  int32_t const scheme_end = az_span_find(url, AZ_SPAN_FROM_STR("://"));
+  if (scheme_end >= 0)
+  {
+    url = az_span_slice_to_end(url, scheme_end + 3);
+  }
+
+  uint8_t const* const ptr = az_span_ptr(url);
+  int32_t const size = az_span_size(url);
+  int32_t host_end = 0;
+  while (host_end < size && ptr[host_end] != '/' && ptr[host_end] != '?' && ptr[host_end] != '#')
+  {
+    host_end++;
+  }
+
+  return az_span_slice(url, 0, host_end);
+}
+
+static _az_http_policy_circuit_breaker_host* _az_http_policy_circuit_breaker_find(
+    _az_http_policy_circuit_breaker_options* ref_options,
+    uint32_t host_hash)
+{
+  for (int32_t i = 0; i < _az_HTTP_POLICY_CIRCUIT_BREAKER_HOSTS; i++)
+  {
+    _az_http_policy_circuit_breaker_host* const entry = &ref_options->_internal.hosts[i];
+    if (entry->_internal.is_used && entry->_internal.host_hash == host_hash)
+    {
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+// Checks whether a request can be sent to a host, with the lock held.
+static AZ_NODISCARD az_result _az_http_policy_circuit_breaker_acquire_locked(
+    _az_http_policy_circuit_breaker_options* ref_options,
+    uint32_t host_hash,
+    int64_t now_msec)
+{
+  _az_http_policy_circuit_breaker_host* const entry
+      = _az_http_policy_circuit_breaker_find(ref_options, host_hash);
+  if (entry == NULL || entry->_internal.opened_at_msec < 0)
+  {
+    return AZ_OK;
+  }
+
+  if (now_msec - entry->_internal.opened_at_msec < ref_options->_internal.open_msec)
+  {
+    return AZ_ERROR_HTTP_CIRCUIT_OPEN;
+  }
+
+  // This request is the probe. Restarting the open period holds back the other requests until it
+  // is recorded, or sends another probe later if it never is, such as when it gets canceled.
+  entry->_internal.opened_at_msec = now_msec;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result _az_http_policy_circuit_breaker_acquire(
+    _az_http_policy_circuit_breaker_options* ref_options,
+    az_span host,
+    int64_t now_msec)
+{
+  _az_PRECONDITION_NOT_NULL(ref_options);
+
+  uint32_t const host_hash = _az_http_policy_circuit_breaker_host_hash(host);
+
+  _az_http_policy_circuit_breaker_lock(ref_options);
+  az_result const result
+      = _az_http_policy_circuit_breaker_acquire_locked(ref_options, host_hash, now_msec);
+  _az_http_policy_circuit_breaker_unlock(ref_options);
+
+  return result;
+}
+
+// Records whether a request to a host failed, with the lock held.
+static void _az_http_policy_circuit_breaker_record_locked(
+    _az_http_policy_circuit_breaker_options* ref_options,
+    uint32_t host_hash,
+    bool failed,
+    int64_t now_msec)
+{
+  _az_http_policy_circuit_breaker_host* entry
+      = _az_http_policy_circuit_breaker_find(ref_options, host_hash);
+  if (entry == NULL)
+  {
+    // Take an unused entry, or forget the host used the longest time ago.
+    entry = &ref_options->_internal.hosts[0];
+    for (int32_t i = 1; i < _az_HTTP_POLICY_CIRCUIT_BREAKER_HOSTS && entry->_internal.is_used; i++)
+    {
+      _az_http_policy_circuit_breaker_host* const candidate = &ref_options->_internal.hosts[i];
+      if (!candidate->_internal.is_used
+          || candidate->_internal.used_at_msec < entry->_internal.used_at_msec)
+      {
+        entry = candidate;
+      }
+    }
+
+    *entry = (_az_http_policy_circuit_breaker_host){
+      ._internal = {
+        .host_hash = host_hash,
+        .requests = 0,
+        .failures = 0,
+        .window_start_msec = now_msec,
+        .opened_at_msec = -1,
+        .used_at_msec = now_msec,
+        .is_used = true,
+      },
+    };
+  }
+
+  entry->_internal.used_at_msec = now_msec;
+
+  if (entry->_internal.opened_at_msec >= 0)
+  {
+    // The probe of an open circuit: close it and start over, or keep it open for another while.
+    if (failed)
+    {
+      entry->_internal.opened_at_msec = now_msec;
+    }
+    else
+    {
+      entry->_internal.opened_at_msec = -1;
+      entry->_internal.requests = 0;
+      entry->_internal.failures = 0;
+      entry->_internal.window_start_msec = now_msec;
+    }
+
+    return;
+  }
+
+  if (now_msec - entry->_internal.window_start_msec >= ref_options->_internal.window_msec)
+  {
+    entry->_internal.requests = 0;
+    entry->_internal.failures = 0;
+    entry->_internal.window_start_msec = now_msec;
+  }
+
+  entry->_internal.requests++;
+  if (failed)
+  {
+    entry->_internal.failures++;
+  }
+
+  if (entry->_internal.requests >= ref_options->_internal.min_requests
+      && (int64_t)entry->_internal.failures * 100
+          >= (int64_t)entry->_internal.requests * ref_options->_internal.failure_percent)
+  {
+    entry->_internal.opened_at_msec = now_msec;
+  }
+}
+
+void _az_http_policy_circuit_breaker_record(
+    _az_http_policy_circuit_breaker_options* ref_options,
+    az_span host,
+    bool failed,
+    int64_t now_msec)
+{
+  _az_PRECONDITION_NOT_NULL(ref_options);
+
+  uint32_t const host_hash = _az_http_policy_circuit_breaker_host_hash(host);
+
+  _az_http_policy_circuit_breaker_lock(ref_options);
+  _az_http_policy_circuit_breaker_record_locked(ref_options, host_hash, failed, now_msec);
+  _az_http_policy_circuit_breaker_unlock(ref_options);
+}
+
+AZ_NODISCARD az_result az_http_pipeline_policy_circuit_breaker(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  _az_http_policy_circuit_breaker_options* const options
+      = (_az_http_policy_circuit_breaker_options*)ref_options;
+
+  az_span url = { 0 };
+  _az_RETURN_IF_FAILED(az_http_request_get_url(ref_request, &url));
+  az_span const host = _az_http_policy_circuit_breaker_get_host(url);
+
+  int64_t now_msec = 0;
+  _az_RETURN_IF_FAILED(az_platform_clock_msec(&now_msec));
+  _az_RETURN_IF_FAILED(_az_http_policy_circuit_breaker_acquire(options, host, now_msec));
+
+  az_result const result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+
+  // A canceled or suspended request says nothing about the health of the host.
+  if (result == AZ_ERROR_CANCELED || result == AZ_ERROR_HTTP_PIPELINE_SUSPENDED)
+  {
+    return result;
+  }
+
+  bool failed = az_result_failed(result);
+  if (!failed)
+  {
+    // Read from a copy, to leave the response for the policies ahead of this one.
+    az_http_response response_copy = *ref_response;
+    az_http_response_status_line status_line = { 0 };
+    _az_RETURN_IF_FAILED(az_http_response_get_status_line(&response_copy, &status_line));
+
+    failed = status_line.status_code == AZ_HTTP_STATUS_CODE_INTERNAL_SERVER_ERROR
+        || status_line.status_code == AZ_HTTP_STATUS_CODE_BAD_GATEWAY
+        || status_line.status_code == AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE
+        || status_line.status_code == AZ_HTTP_STATUS_CODE_GATEWAY_TIMEOUT;
+  }
+
+  _az_RETURN_IF_FAILED(az_platform_clock_msec(&now_msec));
+  _az_http_policy_circuit_breaker_record(options, host, failed, now_msec);
+  return result;
+}
@@ -0,0 +1,502 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_http_private.h"
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+// The compressed body is a gzip member (RFC 1952) holding DEFLATE blocks (RFC 1951) encoded with
+// the fixed Huffman codes. These need no code tables to be built or sent, and LZ77 matches are
+// found with a single-candidate hash table, which keeps the encoder small and free of any
+// allocation, while JSON still compresses several times.
+
+static az_span const _az_http_policy_compression_content_encoding
+    = AZ_SPAN_LITERAL_FROM_STR("Content-Encoding");
+static az_span const _az_http_policy_compression_gzip = AZ_SPAN_LITERAL_FROM_STR("gzip");
+
+enum
+{
+  // ID1, ID2, CM = 8 (deflate), FLG = 0, MTIME = 0, XFL = 0, OS = 255 (unknown).
+  _az_GZIP_HEADER_SIZE = 10,
+  // CRC32 and ISIZE.
+  _az_GZIP_TRAILER_SIZE = 8,
+  // The gzip header and trailer, the block headers, the end of block codes, and the final block.
+  _az_GZIP_OVERHEAD = 32,
+
+  _az_DEFLATE_MIN_MATCH = 3,
+  _az_DEFLATE_MAX_MATCH = 258,
+  _az_DEFLATE_MAX_DISTANCE = 32768,
+  _az_DEFLATE_END_OF_BLOCK = 256,
+};
+
+static uint16_t const _az_deflate_length_base[29] = {
+  3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+
+static uint8_t const _az_deflate_length_extra_bits[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+
+static uint16_t const _az_deflate_distance_base[30] = {
+  1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+  193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+};
+
+static uint8_t const _az_deflate_distance_extra_bits[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+// Writes bits least significant bit first, as DEFLATE requires. Writing past the end of the
+// destination is recorded by overflow, rather than checked for every bit.
+typedef struct
+{
+  uint8_t* ptr;
+  int32_t size;
+  int32_t position;
+  uint32_t bit_buffer;
+  int32_t bit_count;
+  bool overflow;
+} _az_deflate_writer;
+
+static void _az_deflate_put_bits(_az_deflate_writer* ref_writer, uint32_t value, int32_t count)
+{
+  ref_writer->bit_buffer |= value << (uint32_t)ref_writer->bit_count;
+  ref_writer->bit_count += count;
+  while (ref_writer->bit_count >= 8)
+  {
+    if (ref_writer->position < ref_writer->size)
+    {
+      ref_writer->ptr[ref_writer->position++] = (uint8_t)ref_writer->bit_buffer;
+    }
+    else
+    {
+      ref_writer->overflow = true;
+    }
+    ref_writer->bit_buffer >>= 8U;
+    ref_writer->bit_count -= 8;
+  }
+}
+
+static void _az_deflate_put_byte(_az_deflate_writer* ref_writer, uint8_t value)
+{
+  _az_deflate_put_bits(ref_writer, value, 8);
+}
+
+static void _az_deflate_put_uint32(_az_deflate_writer* ref_writer, uint32_t value)
+{
+  for (int32_t i = 0; i < 4; i++)
+  {
+    _az_deflate_put_byte(ref_writer, (uint8_t)(value >> (8U * (uint32_t)i)));
+  }
+}
+
+// Huffman codes are defined most significant bit first, so they are written reversed.
+static void _az_deflate_put_code(_az_deflate_writer* ref_writer, uint32_t code, int32_t length)
+{
+  uint32_t reversed = 0;
+  for (int32_t i = 0; i < length; i++)
+  {
+    reversed = (reversed << 1U) | ((code >> (uint32_t)i) & 1U);
+  }
+  _az_deflate_put_bits(ref_writer, reversed, length);
+}
+
+// The fixed literal/length codes, see RFC 1951 section 3.2.6.
+static void _az_deflate_put_symbol(_az_deflate_writer* ref_writer, int32_t symbol)
+{
+  if (symbol < 144)
+  {
+    _az_deflate_put_code(ref_writer, 0x30U + (uint32_t)symbol, 8);
+  }
+  else if (symbol < 256)
+  {
+    _az_deflate_put_code(ref_writer, 0x190U + (uint32_t)(symbol - 144), 9);
+  }
+  else if (symbol < 280)
+  {
+    _az_deflate_put_code(ref_writer, (uint32_t)(symbol - 256), 7);
+  }
+  else
+  {
+    _az_deflate_put_code(ref_writer, 0xC0U + (uint32_t)(symbol - 280), 8);
+  }
+}
+
+static void _az_deflate_put_match(_az_deflate_writer* ref_writer, int32_t length, int32_t distance)
+{
+  int32_t code = 28;
+  while (_az_deflate_length_base[code] > length)
+  {
+    code--;
+  }
+  _az_deflate_put_symbol(ref_writer, 257 + code);
+  _az_deflate_put_bits(
+      ref_writer,
+      (uint32_t)(length - _az_deflate_length_base[code]),
+      _az_deflate_length_extra_bits[code]);
+
+  code = 29;
+  while (_az_deflate_distance_base[code] > distance)
+  {
+    code--;
+  }
+  // Distance codes are all 5 bits long with the fixed codes.
+  _az_deflate_put_code(ref_writer, (uint32_t)code, 5);
+  _az_deflate_put_bits(
+      ref_writer,
+      (uint32_t)(distance - _az_deflate_distance_base[code]),
+      _az_deflate_distance_extra_bits[code]);
+}
+
+static uint32_t _az_deflate_hash(uint8_t const* ptr)
+{
+  uint32_t const value = (uint32_t)ptr[0] | ((uint32_t)ptr[1] << 8U) | ((uint32_t)ptr[2] << 16U);
+  return (value * 2654435761U) >> (32U - 9U); // 2^9 == _az_HTTP_POLICY_COMPRESSION_HASH_SIZE
+}
+
+// Writes source as a non-final block. Matches are only searched within source.
+static void _az_deflate_put_block(
+    _az_deflate_writer* ref_writer,
+    int32_t* hash_heads,
+    uint8_t const* source,
+    int32_t size)
+{
+  // BFINAL = 0, BTYPE = 01 (fixed Huffman codes).
+  _az_deflate_put_bits(ref_writer, 2U, 3);
+
+  for (int32_t i = 0; i < _az_HTTP_POLICY_COMPRESSION_HASH_SIZE; i++)
+  {
+    hash_heads[i] = -1;
+  }
+
+  int32_t position = 0;
+  while (position < size)
+  {
+    int32_t match_length = 0;
+    int32_t match_distance = 0;
+    int32_t const remaining = size - position;
+    if (remaining >= _az_DEFLATE_MIN_MATCH)
+    {
+      uint32_t const hash = _az_deflate_hash(source + position);
+      int32_t const candidate = hash_heads[hash];
+      hash_heads[hash] = position;
+
+      if (candidate >= 0 && position - candidate <= _az_DEFLATE_MAX_DISTANCE)
+      {
+        int32_t const max_length
+            = remaining < _az_DEFLATE_MAX_MATCH ? remaining : _az_DEFLATE_MAX_MATCH;
+        while (match_length < max_length
+               && source[candidate + match_length] == source[position + match_length])
+        {
+          match_length++;
+        }
+        match_distance = position - candidate;
+      }
+    }
+
+    if (match_length >= _az_DEFLATE_MIN_MATCH)
+    {
+      _az_deflate_put_match(ref_writer, match_length, match_distance);
+
+      // Index the positions within the match too, so that later repetitions of them are found.
+      int32_t const match_end = position + match_length;
+      for (position++; position < match_end && position + _az_DEFLATE_MIN_MATCH <= size;
+           position++)
+      {
+        hash_heads[_az_deflate_hash(source + position)] = position;
+      }
+      position = match_end;
+    }
+    else
+    {
+      _az_deflate_put_symbol(ref_writer, source[position]);
+      position++;
+    }
+  }
+
+  _az_deflate_put_symbol(ref_writer, _az_DEFLATE_END_OF_BLOCK);
+}
+
+static void _az_gzip_put_header(_az_deflate_writer* ref_writer)
+{
+  static uint8_t const header[_az_GZIP_HEADER_SIZE] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+  for (int32_t i = 0; i < _az_GZIP_HEADER_SIZE; i++)
+  {
+    _az_deflate_put_byte(ref_writer, header[i]);
+  }
+}
+
+// Ends the DEFLATE stream with an empty final block, and writes the gzip trailer.
+static void _az_gzip_put_trailer(_az_deflate_writer* ref_writer, uint32_t crc, uint32_t size)
+{
+  // BFINAL = 1, BTYPE = 01, then the end of block code.
+  _az_deflate_put_bits(ref_writer, 3U, 3);
+  _az_deflate_put_symbol(ref_writer, _az_DEFLATE_END_OF_BLOCK);
+
+  if (ref_writer->bit_count > 0)
+  {
+    _az_deflate_put_bits(ref_writer, 0U, 8 - ref_writer->bit_count);
+  }
+
+  _az_deflate_put_uint32(ref_writer, crc);
+  _az_deflate_put_uint32(ref_writer, size);
+}
+
+// The size of the chunks a body read with a body reader is compressed by, so that the compressed
+// form of a chunk always fits in the rest of the work buffer.
+static int32_t _az_http_policy_compression_chunk_size(az_span work_buffer)
+{
+  return ((az_span_size(work_buffer) - _az_GZIP_OVERHEAD) * 8) / 17;
+}
+
+AZ_NODISCARD _az_http_policy_compression_options
+_az_http_policy_compression_options_default(az_span work_buffer)
+{
+  _az_PRECONDITION_VALID_SPAN(work_buffer, _az_HTTP_POLICY_COMPRESSION_MIN_WORK_BUFFER_SIZE, false);
+
+  return (_az_http_policy_compression_options){
+    ._internal = {
+      .work_buffer = work_buffer,
+      .min_body_size = 1024,
+      .hash_heads = { 0 },
+      .source_read_callback = NULL,
+      .source_user_context = NULL,
+      .source_offset = 0,
+      .compressed_offset = 0,
+      .pending_start = 0,
+      .pending_end = 0,
+      .crc = 0,
+      .bit_buffer = 0,
+      .bit_count = 0,
+      .started = false,
+      .finished = false,
+    },
+  };
+}
+
+static void _az_http_policy_compression_restart(_az_http_policy_compression_options* ref_options)
+{
+  ref_options->_internal.source_offset = 0;
+  ref_options->_internal.compressed_offset = 0;
+  ref_options->_internal.pending_start = 0;
+  ref_options->_internal.pending_end = 0;
+  ref_options->_internal.crc = 0;
+  ref_options->_internal.bit_buffer = 0;
+  ref_options->_internal.bit_count = 0;
+  ref_options->_internal.started = false;
+  ref_options->_internal.finished = false;
+}
+
+// Reads the next chunk of the body from the source reader, and compresses it.
+static AZ_NODISCARD az_result
+_az_http_policy_compression_fill(_az_http_policy_compression_options* ref_options)
+{
+  az_span const work_buffer = ref_options->_internal.work_buffer;
+  int32_t const chunk_size = _az_http_policy_compression_chunk_size(work_buffer);
+  uint8_t* const chunk = az_span_ptr(work_buffer);
+
+  int32_t read = 0;
+  bool end_of_body = false;
+  while (read < chunk_size)
+  {
+    int32_t size = 0;
+    _az_RETURN_IF_FAILED(ref_options->_internal.source_read_callback(
+        ref_options->_internal.source_user_context,
+        ref_options->_internal.source_offset + read,
+        az_span_create(chunk + read, chunk_size - read),
+        &size));
+    if (size == 0)
+    {
+      end_of_body = true;
+      break;
+    }
+    read += size;
+  }
+
+  _az_deflate_writer writer = {
+    .ptr = chunk + chunk_size,
+    .size = az_span_size(work_buffer) - chunk_size,
+    .position = 0,
+    .bit_buffer = ref_options->_internal.bit_buffer,
+    .bit_count = ref_options->_internal.bit_count,
+    .overflow = false,
+  };
+
+  if (!ref_options->_internal.started)
+  {
+    _az_gzip_put_header(&writer);
+    ref_options->_internal.started = true;
+  }
+
+  if (read > 0)
+  {
+    ref_options->_internal.crc
+        = _az_span_crc32(ref_options->_internal.crc, az_span_create(chunk, read));
+    ref_options->_internal.source_offset += read;
+    _az_deflate_put_block(&writer, ref_options->_internal.hash_heads, chunk, read);
+  }
+
+  if (end_of_body)
+  {
+    _az_gzip_put_trailer(
+        &writer, ref_options->_internal.crc, (uint32_t)ref_options->_internal.source_offset);
+    ref_options->_internal.finished = true;
+  }
+
+  // The chunk size leaves room for the worst case, where every byte is a 9 bit literal.
+  _az_PRECONDITION(!writer.overflow);
+
+  ref_options->_internal.bit_buffer = writer.bit_buffer;
+  ref_options->_internal.bit_count = writer.bit_count;
+  ref_options->_internal.pending_start = chunk_size;
+  ref_options->_internal.pending_end = chunk_size + writer.position;
+
+  return AZ_OK;
+}
+
+static AZ_NODISCARD az_result _az_http_policy_compression_read(
+    void* user_context,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size)
+{
+  _az_http_policy_compression_options* const options
+      = (_az_http_policy_compression_options*)user_context;
+
+  if (offset == 0 && options->_internal.compressed_offset != 0)
+  {
+    // The transport sends the request again, so the body is compressed again from the start.
+    _az_http_policy_compression_restart(options);
+  }
+
+  if (offset != options->_internal.compressed_offset)
+  {
+    // The compressed body can only be read in order.
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  while (options->_internal.pending_start == options->_internal.pending_end
+         && !options->_internal.finished)
+  {
+    _az_RETURN_IF_FAILED(_az_http_policy_compression_fill(options));
+  }
+
+  int32_t const pending = options->_internal.pending_end - options->_internal.pending_start;
+  int32_t const size
+      = pending < az_span_size(destination) ? pending : az_span_size(destination);
+  az_span_copy(
+      destination,
+      az_span_slice(options->_internal.work_buffer, options->_internal.pending_start,
+                    options->_internal.pending_start + size));
+
+  options->_internal.pending_start += size;
+  options->_internal.compressed_offset += size;
+  *out_size = size;
+
+  return AZ_OK;
+}
+
+// Compresses body, all at once, into work_buffer. Fails if the compressed body doesn't fit, or
+// isn't smaller than body.
+static AZ_NODISCARD az_result _az_http_policy_compression_compress(
+    _az_http_policy_compression_options* ref_options,
+    az_span body,
+    az_span* out_compressed)
+{
+  _az_deflate_writer writer = {
+    .ptr = az_span_ptr(ref_options->_internal.work_buffer),
+    .size = az_span_size(ref_options->_internal.work_buffer),
+    .position = 0,
+    .bit_buffer = 0,
+    .bit_count = 0,
+    .overflow = false,
+  };
+
+  _az_gzip_put_header(&writer);
+  _az_deflate_put_block(
+      &writer, ref_options->_internal.hash_heads, az_span_ptr(body), az_span_size(body));
+  _az_gzip_put_trailer(&writer, _az_span_crc32(0, body), (uint32_t)az_span_size(body));
+
+  if (writer.overflow || writer.position >= az_span_size(body))
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  *out_compressed = az_span_slice(ref_options->_internal.work_buffer, 0, writer.position);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_http_pipeline_policy_compression(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  _az_PRECONDITION_NOT_NULL(ref_options);
+
+  _az_http_policy_compression_options* const options
+      = (_az_http_policy_compression_options*)ref_options;
+  int64_t const body_length = az_http_request_get_body_length(ref_request);
+
+  if (az_http_request_has_body_reader(ref_request))
+  {
+    if (body_length >= 0 && body_length < options->_internal.min_body_size)
+    {
+      return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+    }
+
+    _az_RETURN_IF_FAILED(_az_http_request_append_header_literal_name(
+        ref_request,
+        _az_http_policy_compression_content_encoding,
+        _az_http_policy_compression_gzip));
+
+    // Read the body through the compressor while the next policies process the request.
+    az_http_request_body_read_fn const read_callback
+        = ref_request->_internal.body_reader.read_callback;
+    void* const user_context = ref_request->_internal.body_reader.user_context;
+    options->_internal.source_read_callback = read_callback;
+    options->_internal.source_user_context = user_context;
+    _az_http_policy_compression_restart(options);
+
+    _az_RETURN_IF_FAILED(az_http_request_set_body_reader(
+        ref_request, _az_http_policy_compression_read, options, -1));
+
+    az_result const result
+        = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+
+    _az_RETURN_IF_FAILED(
+        az_http_request_set_body_reader(ref_request, read_callback, user_context, body_length));
+    return result;
+  }
+
+  az_span const body = ref_request->_internal.body;
+  az_span compressed = AZ_SPAN_EMPTY;
+  if (body_length < options->_internal.min_body_size
+      || az_result_failed(_az_http_policy_compression_compress(options, body, &compressed)))
+  {
+    return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  _az_RETURN_IF_FAILED(_az_http_request_append_header_literal_name(
+      ref_request,
+      _az_http_policy_compression_content_encoding,
+      _az_http_policy_compression_gzip));
+
+  ref_request->_internal.body = compressed;
+  az_result const result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  ref_request->_internal.body = body;
+
+  return result;
+}
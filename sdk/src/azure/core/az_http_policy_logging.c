@@ -207,14 +207,108 @@ static az_result _az_http_policy_logging_append_http_response_msg(
   return AZ_OK;
 }
 
-void _az_http_policy_logging_log_http_request(az_http_request const* request)
+AZ_NODISCARD az_result az_http_log_record_format(
+    az_http_log_record const* record,
+    az_span destination,
+    az_span* out_message)
+{
+  _az_PRECONDITION_NOT_NULL(record);
+  _az_PRECONDITION(
+      record->classification == AZ_LOG_HTTP_REQUEST
+      || record->classification == AZ_LOG_HTTP_RESPONSE);
+  _az_PRECONDITION_NOT_NULL(out_message);
+
+  az_span log_msg = destination;
+  if (record->classification == AZ_LOG_HTTP_RESPONSE)
+  {
+    // Reading the headers moves the cursor of the response, so read them from a copy.
+    az_http_response response_copy = { 0 };
+    az_http_response* response = NULL;
+    if (record->response != NULL)
+    {
+      response_copy = *record->response;
+      response = &response_copy;
+    }
+
+    _az_RETURN_IF_FAILED(_az_http_policy_logging_append_http_response_msg(
+        response, record->duration_msec, record->request, &log_msg));
+  }
+  else
+  {
+    _az_RETURN_IF_FAILED(
+        _az_http_policy_logging_append_http_request_msg(record->request, &log_msg));
+  }
+
+  *out_message = log_msg;
+  return AZ_OK;
+}
+
+static az_http_log_record _az_http_policy_logging_get_record(
+    az_log_classification classification,
+    az_http_request const* request,
+    az_http_response const* response,
+    int64_t duration_msec)
+{
+  az_http_log_record record = {
+    .classification = classification,
+    .method = AZ_SPAN_EMPTY,
+    .url = AZ_SPAN_EMPTY,
+    .request = request,
+    .response = response,
+    .status_code = AZ_HTTP_STATUS_CODE_NONE,
+    .duration_msec = duration_msec,
+  };
+
+  if (request != NULL)
+  {
+    record.method = request->_internal.method;
+    record.url = az_span_slice(request->_internal.url, 0, request->_internal.url_length);
+  }
+
+  if (response != NULL && az_span_size(response->_internal.http_response) > 0)
+  {
+    az_http_response response_copy = *response;
+    az_http_response_status_line status_line = { 0 };
+    if (az_result_succeeded(az_http_response_get_status_line(&response_copy, &status_line)))
+    {
+      record.status_code = status_line.status_code;
+    }
+  }
+
+  return record;
+}
+
+static void _az_http_policy_logging_log_record(az_http_log_record const* record)
 {
+#ifndef AZ_NO_LOGGING
+  az_http_log_record_fn const record_callback
+      = _az_http_log_get_record_callback(record->classification);
+  if (record_callback != NULL)
+  {
+    if (_az_log_sampler_keep(record->classification))
+    {
+      record_callback(record);
+    }
+    return;
+  }
+#endif // AZ_NO_LOGGING
+
   uint8_t log_msg_buf[AZ_LOG_MESSAGE_BUFFER_SIZE] = { 0 };
   az_span log_msg = AZ_SPAN_FROM_BUFFER(log_msg_buf);
 
-  (void)_az_http_policy_logging_append_http_request_msg(request, &log_msg);
+  // A message which doesn't fit is logged as far as it was written.
+  az_result const result = az_http_log_record_format(record, log_msg, &log_msg);
+  (void)result;
 
-  _az_LOG_WRITE(AZ_LOG_HTTP_REQUEST, log_msg);
+  _az_LOG_WRITE(record->classification, log_msg);
+}
+
+void _az_http_policy_logging_log_http_request(az_http_request const* request)
+{
+  az_http_log_record const record
+      = _az_http_policy_logging_get_record(AZ_LOG_HTTP_REQUEST, request, NULL, -1);
+
+  _az_http_policy_logging_log_record(&record);
 }
 
 void _az_http_policy_logging_log_http_response(
@@ -222,15 +316,12 @@ void _az_http_policy_logging_log_http_response(
     int64_t duration_msec,
     az_http_request const* request)
 {
-  uint8_t log_msg_buf[AZ_LOG_MESSAGE_BUFFER_SIZE] = { 0 };
-  az_span log_msg = AZ_SPAN_FROM_BUFFER(log_msg_buf);
-
-  az_http_response response_copy = *response;
+  _az_PRECONDITION_NOT_NULL(response);
 
-  (void)_az_http_policy_logging_append_http_response_msg(
-      &response_copy, duration_msec, request, &log_msg);
+  az_http_log_record const record = _az_http_policy_logging_get_record(
+      AZ_LOG_HTTP_RESPONSE, request, response, duration_msec);
 
-  _az_LOG_WRITE(AZ_LOG_HTTP_RESPONSE, log_msg);
+  _az_http_policy_logging_log_record(&record);
 }
 
 #ifndef AZ_NO_LOGGING
@@ -242,12 +333,12 @@ AZ_NODISCARD az_result az_http_pipeline_policy_logging(
 {
   (void)ref_options;
 
-  if (_az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_REQUEST))
+  if (_az_http_log_should_write(AZ_LOG_HTTP_REQUEST))
   {
     _az_http_policy_logging_log_http_request(ref_request);
   }
 
-  if (!_az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_RESPONSE))
+  if (!_az_http_log_should_write(AZ_LOG_HTTP_RESPONSE))
   {
     // If no logging is needed, do not even measure the response time.
     return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
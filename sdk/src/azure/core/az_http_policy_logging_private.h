@@ -11,6 +11,16 @@
 
 #include <azure/core/_az_cfg_prefix.h>
 
+#ifndef AZ_NO_LOGGING
+// Returns the #az_http_log_record_fn set by the application, if any and if the
+// #az_log_classification_filter_fn allows the classification.
+az_http_log_record_fn _az_http_log_get_record_callback(az_log_classification classification);
+
+// Returns whether an HTTP request or response message should be logged, either as text or as an
+// #az_http_log_record.
+bool _az_http_log_should_write(az_log_classification classification);
+#endif // AZ_NO_LOGGING
+
 void _az_http_policy_logging_log_http_request(az_http_request const* request);
 
 void _az_http_policy_logging_log_http_response(
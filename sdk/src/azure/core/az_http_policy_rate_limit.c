@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_http_private.h"
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/internal/az_config_internal.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+// An additive increase, multiplicative decrease (AIMD) rate, as TCP does for its congestion window:
+// the rate probes slowly for the quota of the service, and backs off quickly once it is reached,
+// so that requests are paced rather than rejected and retried.
+
+enum
+{
+  _az_RATE_LIMIT_RATE_SCALE = 1000, // A rate is in thousandths of a request per second.
+  _az_RATE_LIMIT_TOKENS_PER_REQUEST = 1000000,
+  _az_RATE_LIMIT_MIN_RATE = 100, // A tenth of a request per second.
+  _az_RATE_LIMIT_MAX_REQUESTS_PER_SECOND = 1000000,
+};
+
+AZ_NODISCARD _az_http_policy_rate_limit_options
+_az_http_policy_rate_limit_options_default(int32_t max_requests_per_second)
+{
+  _az_PRECONDITION_RANGE(1, max_requests_per_second, _az_RATE_LIMIT_MAX_REQUESTS_PER_SECOND);
+
+  int32_t const max_rate = max_requests_per_second * _az_RATE_LIMIT_RATE_SCALE;
+  return (_az_http_policy_rate_limit_options){
+    ._internal = {
+      .tokens = (int64_t)max_rate * _az_TIME_MILLISECONDS_PER_SECOND,
+      .refilled_at_msec = -1,
+      .held_until_msec = 0,
+      .rate = max_rate,
+      .min_rate = _az_RATE_LIMIT_MIN_RATE,
+      .max_rate = max_rate,
+    },
+  };
+}
+
+// The bucket holds one second worth of requests at the current rate, and at least one request.
+static int64_t _az_http_policy_rate_limit_max_tokens(int32_t rate)
+{
+  int64_t const max_tokens = (int64_t)rate * _az_TIME_MILLISECONDS_PER_SECOND;
+  return max_tokens > _az_RATE_LIMIT_TOKENS_PER_REQUEST ? max_tokens
+                                                        : _az_RATE_LIMIT_TOKENS_PER_REQUEST;
+}
+
+static void _az_http_policy_rate_limit_refill(
+    _az_http_policy_rate_limit_options* ref_options,
+    int64_t now_msec)
+{
+  int64_t const refilled_at_msec = ref_options->_internal.refilled_at_msec;
+  ref_options->_internal.refilled_at_msec = now_msec;
+
+  // The first request only starts the clock, the bucket is full already.
+  if (refilled_at_msec < 0 || now_msec <= refilled_at_msec)
+  {
+    return;
+  }
+
+  int32_t const rate = ref_options->_internal.rate;
+  int64_t const max_tokens = _az_http_policy_rate_limit_max_tokens(rate);
+  int64_t const tokens = ref_options->_internal.tokens;
+
+  // Comparing the elapsed time, rather than the tokens, keeps the product from overflowing after a
+  // long idle time.
+  int64_t const elapsed_msec = now_msec - refilled_at_msec;
+  int64_t const refilled = tokens >= max_tokens || elapsed_msec > (max_tokens - tokens) / rate
+      ? max_tokens
+      : tokens + elapsed_msec * rate;
+
+  ref_options->_internal.tokens = refilled < max_tokens ? refilled : max_tokens;
+}
+
+AZ_NODISCARD int32_t _az_http_policy_rate_limit_acquire(
+    _az_http_policy_rate_limit_options* ref_options,
+    int64_t now_msec)
+{
+  _az_PRECONDITION_NOT_NULL(ref_options);
+
+  int64_t const held_until_msec = ref_options->_internal.held_until_msec;
+  if (now_msec < held_until_msec)
+  {
+    int64_t const delay_msec = held_until_msec - now_msec;
+    return delay_msec < INT32_MAX ? (int32_t)delay_msec : INT32_MAX;
+  }
+
+  _az_http_policy_rate_limit_refill(ref_options, now_msec);
+
+  int64_t const tokens = ref_options->_internal.tokens;
+  if (tokens >= _az_RATE_LIMIT_TOKENS_PER_REQUEST)
+  {
+    ref_options->_internal.tokens = tokens - _az_RATE_LIMIT_TOKENS_PER_REQUEST;
+    return 0;
+  }
+
+  // Rounded up, so that the bucket has refilled by then.
+  int32_t const rate = ref_options->_internal.rate;
+  return (int32_t)((_az_RATE_LIMIT_TOKENS_PER_REQUEST - tokens + rate - 1) / rate);
+}
+
+void _az_http_policy_rate_limit_update(
+    _az_http_policy_rate_limit_options* ref_options,
+    az_http_status_code status_code,
+    int32_t retry_after_msec,
+    int64_t now_msec)
+{
+  _az_PRECONDITION_NOT_NULL(ref_options);
+
+  int32_t const rate = ref_options->_internal.rate;
+  if (status_code == AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS
+      || status_code == AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE)
+  {
+    // The quota is used up: halve the rate, and drop the burst the bucket held.
+    ref_options->_internal.rate
+        = rate / 2 > ref_options->_internal.min_rate ? rate / 2 : ref_options->_internal.min_rate;
+    ref_options->_internal.tokens = 0;
+    ref_options->_internal.refilled_at_msec = now_msec;
+
+    int64_t const held_until_msec = now_msec + retry_after_msec;
+    if (retry_after_msec > 0 && held_until_msec > ref_options->_internal.held_until_msec)
+    {
+      ref_options->_internal.held_until_msec = held_until_msec;
+    }
+  }
+  else if (status_code < AZ_HTTP_STATUS_CODE_INTERNAL_SERVER_ERROR)
+  {
+    // Adding 1000000 / rate for each request adds a request per second once a second worth of
+    // requests succeeded, at any rate. Other server errors say nothing about the quota.
+    int32_t const increase = _az_RATE_LIMIT_TOKENS_PER_REQUEST / rate > 0
+        ? _az_RATE_LIMIT_TOKENS_PER_REQUEST / rate
+        : 1;
+    ref_options->_internal.rate = rate < ref_options->_internal.max_rate - increase
+        ? rate + increase
+        : ref_options->_internal.max_rate;
+  }
+}
+
+AZ_NODISCARD az_result az_http_pipeline_policy_rate_limit(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  _az_http_policy_rate_limit_options* const options
+      = (_az_http_policy_rate_limit_options*)ref_options;
+  az_context const* const context = ref_request->_internal.context;
+
+  int64_t now_msec = 0;
+  while (true)
+  {
+    _az_RETURN_IF_FAILED(az_platform_clock_msec(&now_msec));
+    if (context != NULL && az_context_has_expired(context, now_msec))
+    {
+      return AZ_ERROR_CANCELED;
+    }
+
+    int32_t const delay_msec = _az_http_policy_rate_limit_acquire(options, now_msec);
+    if (delay_msec == 0)
+    {
+      break;
+    }
+
+    _az_RETURN_IF_FAILED(_az_http_policy_wait(context, delay_msec));
+  }
+
+  az_result const result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  if (az_result_failed(result))
+  {
+    return result;
+  }
+
+  // Read from a copy, to leave the response for the policies ahead of this one.
+  az_http_response response_copy = *ref_response;
+  az_http_response_status_line status_line = { 0 };
+  _az_RETURN_IF_FAILED(az_http_response_get_status_line(&response_copy, &status_line));
+
+  int32_t retry_after_msec = -1;
+  if (status_line.status_code == AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS
+      || status_line.status_code == AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE)
+  {
+    _az_RETURN_IF_FAILED(_az_http_response_get_retry_after_msec(&response_copy, &retry_after_msec));
+  }
+
+  _az_RETURN_IF_FAILED(az_platform_clock_msec(&now_msec));
+  _az_http_policy_rate_limit_update(options, status_line.status_code, retry_after_msec, now_msec);
+  return result;
+}
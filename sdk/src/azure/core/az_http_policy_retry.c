@@ -7,6 +7,7 @@
 #include <azure/core/internal/az_config_internal.h>
 #include <azure/core/internal/az_http_internal.h>
 #include <azure/core/internal/az_log_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
 #include <azure/core/internal/az_result_internal.h>
 #include <azure/core/internal/az_retry_internal.h>
 #include <azure/core/internal/az_span_internal.h>
@@ -24,9 +25,248 @@ AZ_NODISCARD az_http_policy_retry_options _az_http_policy_retry_options_default(
     .retry_delay_msec = 4 * _az_TIME_MILLISECONDS_PER_SECOND, // 4 seconds
     .max_retry_delay_msec
     = 2 * _az_TIME_SECONDS_PER_MINUTE * _az_TIME_MILLISECONDS_PER_SECOND, // 2 minutes
+    .jitter = AZ_HTTP_POLICY_RETRY_JITTER_NONE,
+    .retry_budget = NULL,
+    .metrics = NULL,
   };
 }
 
+enum
+{
+  // A token is a hundredth of a retry, so the share of retries can be set in percent.
+  _az_RETRY_BUDGET_TOKENS_PER_RETRY = 100,
+  _az_RETRY_BUDGET_MAX_BURST_RETRIES = 1000000,
+};
+
+AZ_NODISCARD az_result az_http_policy_retry_budget_init(
+    az_http_policy_retry_budget* out_budget,
+    int32_t max_burst_retries,
+    int32_t retry_percent)
+{
+  _az_PRECONDITION_NOT_NULL(out_budget);
+  _az_PRECONDITION_RANGE(1, max_burst_retries, _az_RETRY_BUDGET_MAX_BURST_RETRIES);
+  _az_PRECONDITION_RANGE(0, retry_percent, 100);
+
+  int32_t const max_tokens = max_burst_retries * _az_RETRY_BUDGET_TOKENS_PER_RETRY;
+  *out_budget = (az_http_policy_retry_budget){ ._internal = {
+                                                   .tokens = max_tokens,
+                                                   .max_tokens = max_tokens,
+                                                   .tokens_per_request = retry_percent,
+                                               } };
+
+  return AZ_OK;
+}
+
+// Adds delta tokens to the budget, up to its maximum. Returns false, leaving the budget unchanged,
+// if that would take the number of tokens below 0.
+static bool _az_http_policy_retry_budget_add(az_http_policy_retry_budget* ref_budget, int32_t delta)
+{
+  int32_t* const tokens = &ref_budget->_internal.tokens;
+  int32_t const max_tokens = ref_budget->_internal.max_tokens;
+
+#if defined(__GNUC__) || defined(__clang__)
+  int32_t current = __atomic_load_n(tokens, __ATOMIC_RELAXED);
+  int32_t next = 0;
+  do
+  {
+    next = current + delta;
+    if (next < 0)
+    {
+      return false;
+    }
+
+    next = next > max_tokens ? max_tokens : next;
+  } while (!__atomic_compare_exchange_n(
+      tokens, &current, next, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#else
+  int32_t next = *tokens + delta;
+  if (next < 0)
+  {
+    return false;
+  }
+
+  *tokens = next > max_tokens ? max_tokens : next;
+#endif
+
+  return true;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define _az_HTTP_METRICS_ADD(counter, value) \
+  ((void)__atomic_fetch_add(&(counter), (value), __ATOMIC_RELAXED))
+#define _az_HTTP_METRICS_LOAD(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+#else
+#define _az_HTTP_METRICS_ADD(counter, value) ((counter) += (value))
+#define _az_HTTP_METRICS_LOAD(counter) (counter)
+#endif
+
+AZ_NODISCARD az_result az_http_metrics_init(az_http_metrics* out_metrics)
+{
+  _az_PRECONDITION_NOT_NULL(out_metrics);
+
+  *out_metrics = (az_http_metrics){ 0 };
+  return AZ_OK;
+}
+
+void az_http_metrics_read(az_http_metrics const* metrics, az_http_metrics_values* out_values)
+{
+  _az_PRECONDITION_NOT_NULL(metrics);
+  _az_PRECONDITION_NOT_NULL(out_values);
+
+  az_http_metrics_values const* const values = &metrics->_internal.values;
+
+  out_values->requests = _az_HTTP_METRICS_LOAD(values->requests);
+  out_values->attempts = _az_HTTP_METRICS_LOAD(values->attempts);
+  out_values->retries = _az_HTTP_METRICS_LOAD(values->retries);
+  out_values->bytes_sent = _az_HTTP_METRICS_LOAD(values->bytes_sent);
+  out_values->bytes_received = _az_HTTP_METRICS_LOAD(values->bytes_received);
+  out_values->backoff_msec = _az_HTTP_METRICS_LOAD(values->backoff_msec);
+
+  for (int32_t i = 0; i < AZ_HTTP_METRICS_STATUS_COUNT; i++)
+  {
+    out_values->retries_by_status[i] = _az_HTTP_METRICS_LOAD(values->retries_by_status[i]);
+  }
+
+  for (int32_t i = 0; i < AZ_HTTP_METRICS_LATENCY_BUCKETS; i++)
+  {
+    out_values->attempt_latency_histogram[i]
+        = _az_HTTP_METRICS_LOAD(values->attempt_latency_histogram[i]);
+    out_values->backoff_histogram[i] = _az_HTTP_METRICS_LOAD(values->backoff_histogram[i]);
+  }
+}
+
+// Returns the bucket, of the histograms of az_http_metrics_values, a duration is counted in.
+static int32_t _az_http_metrics_bucket(int64_t msec)
+{
+  static int64_t const upper_bounds[AZ_HTTP_METRICS_LATENCY_BUCKETS - 1]
+      = { 10, 50, 100, 500, 1000, 5000, 30000 };
+
+  int32_t bucket = 0;
+  while (bucket < AZ_HTTP_METRICS_LATENCY_BUCKETS - 1 && msec > upper_bounds[bucket])
+  {
+    ++bucket;
+  }
+
+  return bucket;
+}
+
+// Counts an attempt, and the bytes it sent and received.
+static void _az_http_metrics_record_attempt(
+    az_http_metrics* ref_metrics,
+    az_http_request const* request,
+    az_http_response const* response,
+    int64_t start_clock)
+{
+  az_http_metrics_values* const values = &ref_metrics->_internal.values;
+
+  int64_t body_size = az_span_size(request->_internal.body);
+  if (request->_internal.body_reader.read_callback != NULL)
+  {
+    int64_t const length = request->_internal.body_reader.length;
+    body_size = length < 0 ? 0 : length;
+  }
+
+  _az_HTTP_METRICS_ADD(values->attempts, 1U);
+  _az_HTTP_METRICS_ADD(values->bytes_sent, (uint32_t)body_size);
+  _az_HTTP_METRICS_ADD(values->bytes_received, (uint32_t)response->_internal.written);
+
+  // The latency isn't known when the clock failed.
+  int64_t clock = 0;
+  if (start_clock >= 0 && az_result_succeeded(az_platform_clock_msec(&clock)))
+  {
+    _az_HTTP_METRICS_ADD(
+        values->attempt_latency_histogram[_az_http_metrics_bucket(clock - start_clock)], 1U);
+  }
+}
+
+// Counts a retry, by the status code which caused it, and the delay before it.
+static void _az_http_metrics_record_retry(
+    az_http_metrics* ref_metrics,
+    az_http_status_code status_code,
+    int32_t delay_msec)
+{
+  az_http_metrics_values* const values = &ref_metrics->_internal.values;
+
+  int32_t status = -1;
+  switch (status_code)
+  {
+    case AZ_HTTP_STATUS_CODE_REQUEST_TIMEOUT:
+      status = AZ_HTTP_METRICS_STATUS_REQUEST_TIMEOUT;
+      break;
+    case AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS:
+      status = AZ_HTTP_METRICS_STATUS_TOO_MANY_REQUESTS;
+      break;
+    case AZ_HTTP_STATUS_CODE_INTERNAL_SERVER_ERROR:
+      status = AZ_HTTP_METRICS_STATUS_INTERNAL_SERVER_ERROR;
+      break;
+    case AZ_HTTP_STATUS_CODE_BAD_GATEWAY:
+      status = AZ_HTTP_METRICS_STATUS_BAD_GATEWAY;
+      break;
+    case AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE:
+      status = AZ_HTTP_METRICS_STATUS_SERVICE_UNAVAILABLE;
+      break;
+    case AZ_HTTP_STATUS_CODE_GATEWAY_TIMEOUT:
+      status = AZ_HTTP_METRICS_STATUS_GATEWAY_TIMEOUT;
+      break;
+    default:
+      break;
+  }
+
+  _az_HTTP_METRICS_ADD(values->retries, 1U);
+  if (status >= 0)
+  {
+    _az_HTTP_METRICS_ADD(values->retries_by_status[status], 1U);
+  }
+
+  _az_HTTP_METRICS_ADD(values->backoff_msec, (uint32_t)delay_msec);
+  _az_HTTP_METRICS_ADD(values->backoff_histogram[_az_http_metrics_bucket(delay_msec)], 1U);
+}
+
+// There is no entropy source in core, so the random value is derived from the time the retry is
+// decided at, which varies with the network timings of each client, and from the request.
+static uint32_t _az_http_policy_retry_random(
+    az_http_request const* request,
+    int64_t clock,
+    int32_t attempt)
+{
+  // The splitmix64 finalizer.
+  uint64_t x = (uint64_t)clock ^ ((uint64_t)(uintptr_t)request << 16U)
+      ^ ((uint64_t)attempt * UINT64_C(0x9E3779B97F4A7C15));
+  x = (x ^ (x >> 30U)) * UINT64_C(0xBF58476D1CE4E5B9);
+  x = (x ^ (x >> 27U)) * UINT64_C(0x94D049BB133111EB);
+  return (uint32_t)(x ^ (x >> 31U));
+}
+
+static AZ_NODISCARD az_result _az_http_policy_retry_calc_delay(
+    az_http_policy_retry_options const* retry_options,
+    az_http_request const* request,
+    int32_t attempt,
+    int32_t previous_delay_msec,
+    int32_t* out_delay_msec)
+{
+  if (retry_options->jitter == AZ_HTTP_POLICY_RETRY_JITTER_NONE)
+  {
+    *out_delay_msec = _az_retry_calc_delay(
+        attempt, retry_options->retry_delay_msec, retry_options->max_retry_delay_msec);
+    return AZ_OK;
+  }
+
+  int64_t clock = 0;
+  _az_RETURN_IF_FAILED(az_platform_clock_msec(&clock));
+  uint32_t const random = _az_http_policy_retry_random(request, clock, attempt);
+
+  *out_delay_msec = retry_options->jitter == AZ_HTTP_POLICY_RETRY_JITTER_DECORRELATED
+      ? _az_retry_calc_delay_decorrelated(
+          previous_delay_msec,
+          retry_options->retry_delay_msec,
+          retry_options->max_retry_delay_msec,
+          random)
+      : _az_retry_calc_delay_full_jitter(
+          attempt, retry_options->retry_delay_msec, retry_options->max_retry_delay_msec, random);
+
+  return AZ_OK;
+}
+
 // TODO: Add unit tests
 AZ_INLINE az_result _az_http_policy_retry_append_http_retry_msg(
     int32_t attempt,
@@ -92,23 +332,10 @@ AZ_INLINE AZ_NODISCARD bool _az_http_policy_retry_should_retry_http_response_cod
   }
 }
 
-AZ_INLINE AZ_NODISCARD az_result _az_http_policy_retry_get_retry_after(
+AZ_NODISCARD az_result _az_http_response_get_retry_after_msec(
     az_http_response* ref_response,
-    bool* should_retry,
-    int32_t* retry_after_msec)
+    int32_t* out_retry_after_msec)
 {
-  az_http_response_status_line status_line = { 0 };
-  _az_RETURN_IF_FAILED(az_http_response_get_status_line(ref_response, &status_line));
-
-  if (!_az_http_policy_retry_should_retry_http_response_code(status_line.status_code))
-  {
-    *should_retry = false;
-    *retry_after_msec = -1;
-    return AZ_OK;
-  }
-
-  *should_retry = true;
-
   // Try to get the value of retry-after header, if there's one.
   az_span header_name = { 0 };
   az_span header_value = { 0 };
@@ -123,7 +350,7 @@ AZ_INLINE AZ_NODISCARD az_result _az_http_policy_retry_get_retry_after(
       int32_t const msec = _az_uint32_span_to_int32(header_value);
       if (msec >= 0) // int32_t max == ~24 days
       {
-        *retry_after_msec = msec;
+        *out_retry_after_msec = msec;
         return AZ_OK;
       }
     }
@@ -133,7 +360,7 @@ AZ_INLINE AZ_NODISCARD az_result _az_http_policy_retry_get_retry_after(
       int32_t const seconds = _az_uint32_span_to_int32(header_value);
       if (seconds >= 0) // int32_t max == ~68 years
       {
-        *retry_after_msec = (seconds <= (INT32_MAX / _az_TIME_MILLISECONDS_PER_SECOND))
+        *out_retry_after_msec = (seconds <= (INT32_MAX / _az_TIME_MILLISECONDS_PER_SECOND))
             ? seconds * _az_TIME_MILLISECONDS_PER_SECOND
             : INT32_MAX;
 
@@ -146,10 +373,43 @@ AZ_INLINE AZ_NODISCARD az_result _az_http_policy_retry_get_retry_after(
     }
   }
 
-  *retry_after_msec = -1;
+  *out_retry_after_msec = -1;
   return AZ_OK;
 }
 
+AZ_INLINE AZ_NODISCARD az_result _az_http_policy_retry_get_retry_after(
+    az_http_response* ref_response,
+    az_http_status_code* status_code,
+    bool* should_retry,
+    int32_t* retry_after_msec)
+{
+  az_http_response_status_line status_line = { 0 };
+  _az_RETURN_IF_FAILED(az_http_response_get_status_line(ref_response, &status_line));
+  *status_code = status_line.status_code;
+
+  if (!_az_http_policy_retry_should_retry_http_response_code(status_line.status_code))
+  {
+    *should_retry = false;
+    *retry_after_msec = -1;
+    return AZ_OK;
+  }
+
+  *should_retry = true;
+  return _az_http_response_get_retry_after_msec(ref_response, retry_after_msec);
+}
+
+AZ_NODISCARD az_result _az_http_policy_wait(az_context const* context, int32_t delay_msec)
+{
+  az_platform_event* wake_event = NULL;
+  if (context == NULL || az_result_failed(az_context_get_wake_event(context, &wake_event)))
+  {
+    return az_platform_sleep_msec(delay_msec);
+  }
+
+  bool is_set = false;
+  return az_platform_event_wait(wake_event, delay_msec, &is_set);
+}
+
 AZ_NODISCARD az_result az_http_pipeline_policy_retry(
     _az_http_policy* ref_policies,
     void* ref_options,
@@ -160,24 +420,84 @@ AZ_NODISCARD az_result az_http_pipeline_policy_retry(
       = (az_http_policy_retry_options const*)ref_options;
 
   int32_t const max_retries = retry_options->max_retries;
-  int32_t const retry_delay_msec = retry_options->retry_delay_msec;
-  int32_t const max_retry_delay_msec = retry_options->max_retry_delay_msec;
-
-  _az_RETURN_IF_FAILED(_az_http_request_mark_retry_headers_start(ref_request));
+  az_http_policy_retry_budget* const retry_budget = retry_options->retry_budget;
+  az_http_metrics* const metrics = retry_options->metrics;
 
   az_context* const context = ref_request->_internal.context;
+  _az_http_pipeline_operation* const operation = ref_request->_internal.pipeline_operation;
+
+  int32_t attempt = 1;
+  int32_t previous_delay_msec = 0;
+  if (operation != NULL && operation->_internal.retry_attempt > 0)
+  {
+    // Resuming after the operation was suspended for the retry delay.
+    attempt = operation->_internal.retry_attempt;
+    previous_delay_msec = operation->_internal.retry_delay_msec;
+    operation->_internal.retry_attempt = 0;
+  }
+  else
+  {
+    _az_RETURN_IF_FAILED(_az_http_request_mark_retry_headers_start(ref_request));
+
+    if (retry_budget != NULL)
+    {
+      (void)_az_http_policy_retry_budget_add(
+          retry_budget, retry_budget->_internal.tokens_per_request);
+    }
+
+    if (metrics != NULL)
+    {
+      _az_HTTP_METRICS_ADD(metrics->_internal.values.requests, 1U);
+    }
+  }
 
   bool const should_log = _az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_RETRY);
   az_result result = AZ_OK;
-  int32_t attempt = 1;
   while (true)
   {
-    _az_RETURN_IF_FAILED(
-        az_http_response_init(ref_response, ref_response->_internal.http_response));
+    if (attempt > 1 && context != NULL)
+    {
+      int64_t clock = 0;
+      _az_RETURN_IF_FAILED(az_platform_clock_msec(&clock));
+      if (az_context_has_expired(context, clock))
+      {
+        return AZ_ERROR_CANCELED;
+      }
+    }
+
+    _az_http_response_reset(ref_response);
     _az_RETURN_IF_FAILED(_az_http_request_remove_retry_headers(ref_request));
 
+    _az_http_instrumentation_write(
+        ref_request,
+        AZ_HTTP_INSTRUMENTATION_RETRY_ATTEMPT,
+        AZ_HTTP_INSTRUMENTATION_BEGIN,
+        attempt,
+        AZ_OK,
+        0);
+
+    // The clock is only read when the latency is counted.
+    int64_t start_clock = -1;
+    if (metrics != NULL && az_result_failed(az_platform_clock_msec(&start_clock)))
+    {
+      start_clock = -1;
+    }
+
     result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
 
+    if (metrics != NULL)
+    {
+      _az_http_metrics_record_attempt(metrics, ref_request, ref_response, start_clock);
+    }
+
+    _az_http_instrumentation_write(
+        ref_request,
+        AZ_HTTP_INSTRUMENTATION_RETRY_ATTEMPT,
+        AZ_HTTP_INSTRUMENTATION_END,
+        attempt,
+        result,
+        0);
+
     // Even HTTP 429, or 502 are expected to be AZ_OK, so the failed result is not retriable.
     if (attempt > max_retries || az_result_failed(result))
     {
@@ -185,22 +505,38 @@ AZ_NODISCARD az_result az_http_pipeline_policy_retry(
     }
 
     int32_t retry_after_msec = -1;
+    az_http_status_code status_code = AZ_HTTP_STATUS_CODE_NONE;
     bool should_retry = false;
     az_http_response response_copy = *ref_response;
 
-    _az_RETURN_IF_FAILED(
-        _az_http_policy_retry_get_retry_after(&response_copy, &should_retry, &retry_after_msec));
+    _az_RETURN_IF_FAILED(_az_http_policy_retry_get_retry_after(
+        &response_copy, &status_code, &should_retry, &retry_after_msec));
 
     if (!should_retry)
     {
       return result;
     }
 
+    // Give up when the clients sharing the budget have used up their share of retries.
+    if (retry_budget != NULL
+        && !_az_http_policy_retry_budget_add(retry_budget, -_az_RETRY_BUDGET_TOKENS_PER_RETRY))
+    {
+      return result;
+    }
+
     ++attempt;
 
     if (retry_after_msec < 0)
     { // there wasn't any kind of "retry-after" response header
-      retry_after_msec = _az_retry_calc_delay(attempt, retry_delay_msec, max_retry_delay_msec);
+      _az_RETURN_IF_FAILED(_az_http_policy_retry_calc_delay(
+          retry_options, ref_request, attempt, previous_delay_msec, &retry_after_msec));
+    }
+
+    previous_delay_msec = retry_after_msec;
+
+    if (metrics != NULL)
+    {
+      _az_http_metrics_record_retry(metrics, status_code, retry_after_msec);
     }
 
     if (should_log)
@@ -208,17 +544,19 @@ AZ_NODISCARD az_result az_http_pipeline_policy_retry(
       _az_http_policy_retry_log(attempt, retry_after_msec);
     }
 
-    _az_RETURN_IF_FAILED(az_platform_sleep_msec(retry_after_msec));
-
-    if (context != NULL)
+    if (operation != NULL)
     {
+      // Hand the delay back to the caller rather than blocking the thread. The policy itself is
+      // right before ref_policies in the pipeline.
       int64_t clock = 0;
       _az_RETURN_IF_FAILED(az_platform_clock_msec(&clock));
-      if (az_context_has_expired(context, clock))
-      {
-        return AZ_ERROR_CANCELED;
-      }
+      operation->_internal.retry_attempt = attempt;
+      operation->_internal.retry_delay_msec = retry_after_msec;
+      return _az_http_pipeline_operation_suspend(
+          operation, &(ref_policies[-1]), clock + retry_after_msec);
     }
+
+    _az_RETURN_IF_FAILED(_az_http_policy_wait(context, retry_after_msec));
   }
 
   return result;
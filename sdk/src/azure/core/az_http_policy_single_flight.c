@@ -0,0 +1,340 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_http_private.h"
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define _az_SINGLE_FLIGHT_ENABLED
+#endif
+
+enum
+{
+  // How often a waiting request checks whether its context expired.
+  _az_SINGLE_FLIGHT_POLL_MSEC = 100,
+};
+
+struct _az_http_policy_single_flight_waiter
+{
+  az_platform_event event;
+  az_http_response* response;
+  az_result result;
+  bool is_delivered; // Set, under the lock, once the response was copied.
+  struct _az_http_policy_single_flight_waiter* next;
+};
+
+AZ_NODISCARD _az_http_policy_single_flight_options
+_az_http_policy_single_flight_options_default(void)
+{
+  return (_az_http_policy_single_flight_options){
+    ._internal = {
+      .calls = { { { 0 } } },
+      .lock = 0,
+    },
+  };
+}
+
+#ifdef _az_SINGLE_FLIGHT_ENABLED
+
+static void _az_http_policy_single_flight_lock(_az_http_policy_single_flight_options* ref_options)
+{
+  int32_t* const lock = &ref_options->_internal.lock;
+  while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) != 0)
+  {
+    while (__atomic_load_n(lock, __ATOMIC_RELAXED) != 0)
+    {
+    }
+  }
+}
+
+static void _az_http_policy_single_flight_unlock(_az_http_policy_single_flight_options* ref_options)
+{
+  __atomic_store_n(&ref_options->_internal.lock, 0, __ATOMIC_RELEASE);
+}
+
+static AZ_NODISCARD uint32_t _az_http_policy_single_flight_hash_span(uint32_t hash, az_span span)
+{
+  for (int32_t i = 0; i < az_span_size(span); i++)
+  {
+    hash = (hash ^ az_span_ptr(span)[i]) * 16777619U;
+  }
+
+  return hash;
+}
+
+// FNV-1a hash of the method, the URL, and the names and values of the headers.
+static AZ_NODISCARD uint32_t
+_az_http_policy_single_flight_hash(az_http_request const* request, az_span method, az_span url)
+{
+  uint32_t hash = _az_http_policy_single_flight_hash_span(2166136261U, method);
+  hash = _az_http_policy_single_flight_hash_span(hash, url);
+
+  int32_t const headers_count = az_http_request_headers_count(request);
+  for (int32_t i = 0; i < headers_count; i++)
+  {
+    az_span name = { 0 };
+    az_span value = { 0 };
+    if (az_result_succeeded(az_http_request_get_header(request, i, &name, &value)))
+    {
+      hash = _az_http_policy_single_flight_hash_span(hash, name);
+      hash = _az_http_policy_single_flight_hash_span(hash, value);
+    }
+  }
+
+  return hash;
+}
+
+// Whether a request has the same headers, in the same order, as the request in flight.
+static AZ_NODISCARD bool _az_http_policy_single_flight_headers_equal(
+    az_http_request const* request,
+    _az_http_policy_single_flight_call const* call)
+{
+  int32_t const headers_count = az_http_request_headers_count(request);
+  if (az_span_size(call->_internal.headers)
+      != headers_count * (int32_t)sizeof(_az_http_request_header))
+  {
+    return false;
+  }
+
+  _az_http_request_header const* const call_headers
+      = (_az_http_request_header const*)az_span_ptr(call->_internal.headers);
+  for (int32_t i = 0; i < headers_count; i++)
+  {
+    az_span name = { 0 };
+    az_span value = { 0 };
+    if (az_result_failed(az_http_request_get_header(request, i, &name, &value))
+        || !az_span_is_content_equal(name, call_headers[i].name)
+        || !az_span_is_content_equal(value, call_headers[i].value))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Takes the waiter out of the call it waits for, unless the response was copied already.
+static AZ_NODISCARD bool _az_http_policy_single_flight_leave(
+    _az_http_policy_single_flight_options* ref_options,
+    struct _az_http_policy_single_flight_waiter* waiter)
+{
+  _az_http_policy_single_flight_lock(ref_options);
+
+  bool const is_delivered = waiter->is_delivered;
+  for (int32_t i = 0; i < _az_HTTP_POLICY_SINGLE_FLIGHT_CALLS && !is_delivered; i++)
+  {
+    struct _az_http_policy_single_flight_waiter** link
+        = &ref_options->_internal.calls[i]._internal.waiters;
+    while (*link != NULL && *link != waiter)
+    {
+      link = &(*link)->next;
+    }
+
+    if (*link == waiter)
+    {
+      *link = waiter->next;
+      break;
+    }
+  }
+
+  _az_http_policy_single_flight_unlock(ref_options);
+  return !is_delivered;
+}
+
+// Waits for the response of the request in flight, or for the context of the request to expire.
+static AZ_NODISCARD az_result _az_http_policy_single_flight_wait(
+    _az_http_policy_single_flight_options* ref_options,
+    struct _az_http_policy_single_flight_waiter* waiter,
+    az_context const* context)
+{
+  while (true)
+  {
+    bool is_set = false;
+    az_result result
+        = az_platform_event_wait(&waiter->event, _az_SINGLE_FLIGHT_POLL_MSEC, &is_set);
+    if (az_result_succeeded(result) && is_set)
+    {
+      return waiter->result;
+    }
+
+    int64_t clock = 0;
+    if (az_result_succeeded(result) && context != NULL
+        && az_result_succeeded(az_platform_clock_msec(&clock))
+        && az_context_has_expired(context, clock))
+    {
+      result = AZ_ERROR_CANCELED;
+    }
+
+    // Once the response was copied, the event is about to be set, which has to be waited for as
+    // the waiter lives on the stack.
+    if (az_result_failed(result) && _az_http_policy_single_flight_leave(ref_options, waiter))
+    {
+      return result;
+    }
+  }
+}
+
+// Sends the request, and copies its response into the responses of the requests which waited for
+// it.
+static AZ_NODISCARD az_result _az_http_policy_single_flight_send(
+    _az_http_policy_single_flight_options* ref_options,
+    _az_http_policy_single_flight_call* ref_call,
+    _az_http_policy* ref_policies,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  az_result const result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  az_span const response
+      = az_span_slice(ref_response->_internal.http_response, 0, ref_response->_internal.written);
+
+  _az_http_policy_single_flight_lock(ref_options);
+
+  struct _az_http_policy_single_flight_waiter* const waiters = ref_call->_internal.waiters;
+  ref_call->_internal.waiters = NULL;
+  ref_call->_internal.is_used = false;
+
+  for (struct _az_http_policy_single_flight_waiter* waiter = waiters; waiter != NULL;
+       waiter = waiter->next)
+  {
+    waiter->result = result;
+    if (az_result_succeeded(result))
+    {
+      _az_http_response_reset(waiter->response);
+      waiter->result = az_http_response_append(waiter->response, response);
+    }
+
+    waiter->is_delivered = true;
+  }
+
+  _az_http_policy_single_flight_unlock(ref_options);
+
+  // The next waiter is read first, as a waiter returns as soon as its event is set.
+  struct _az_http_policy_single_flight_waiter* waiter = waiters;
+  while (waiter != NULL)
+  {
+    struct _az_http_policy_single_flight_waiter* const next = waiter->next;
+    az_result const set_result = az_platform_event_set(&waiter->event);
+    (void)set_result;
+    waiter = next;
+  }
+
+  return result;
+}
+
+#endif // _az_SINGLE_FLIGHT_ENABLED
+
+AZ_NODISCARD az_result az_http_pipeline_policy_single_flight(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+#ifdef _az_SINGLE_FLIGHT_ENABLED
+  _az_http_policy_single_flight_options* const options
+      = (_az_http_policy_single_flight_options*)ref_options;
+
+  az_http_method method = { 0 };
+  _az_RETURN_IF_FAILED(az_http_request_get_method(ref_request, &method));
+
+  // Only requests which can safely be shared are. A body going to an allocator can't be copied.
+  if ((!az_span_is_content_equal(method, az_http_method_get())
+       && !az_span_is_content_equal(method, az_http_method_head()))
+      || ref_response->_internal.body_stream.allocator_callback != NULL)
+  {
+    return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  az_span url = { 0 };
+  _az_RETURN_IF_FAILED(az_http_request_get_url(ref_request, &url));
+  uint32_t const key_hash = _az_http_policy_single_flight_hash(ref_request, method, url);
+
+  _az_http_policy_single_flight_lock(options);
+
+  _az_http_policy_single_flight_call* free_call = NULL;
+  for (int32_t i = 0; i < _az_HTTP_POLICY_SINGLE_FLIGHT_CALLS; i++)
+  {
+    _az_http_policy_single_flight_call* const call = &options->_internal.calls[i];
+    if (!call->_internal.is_used)
+    {
+      free_call = free_call == NULL ? call : free_call;
+      continue;
+    }
+
+    if (call->_internal.key_hash != key_hash
+        || !az_span_is_content_equal(call->_internal.method, method)
+        || !az_span_is_content_equal(call->_internal.url, url)
+        || !_az_http_policy_single_flight_headers_equal(ref_request, call))
+    {
+      continue;
+    }
+
+    // The same request is in flight: wait for its response.
+    struct _az_http_policy_single_flight_waiter waiter = { 0 };
+    if (az_result_failed(az_platform_event_init(&waiter.event)))
+    {
+      _az_http_policy_single_flight_unlock(options);
+      return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+    }
+
+    waiter.response = ref_response;
+    waiter.next = call->_internal.waiters;
+    call->_internal.waiters = &waiter;
+    _az_http_policy_single_flight_unlock(options);
+
+    az_result const result
+        = _az_http_policy_single_flight_wait(options, &waiter, ref_request->_internal.context);
+    az_platform_event_deinit(&waiter.event);
+
+    // The request in flight was canceled by its own context, which this one may not be.
+    if (waiter.is_delivered && result == AZ_ERROR_CANCELED)
+    {
+      return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+    }
+
+    return result;
+  }
+
+  if (free_call != NULL)
+  {
+    *free_call = (_az_http_policy_single_flight_call){
+      ._internal = {
+        .method = method,
+        .url = url,
+        // The policies after this one only append headers, so these stay as they are.
+        .headers = az_span_slice(
+            ref_request->_internal.headers,
+            0,
+            az_http_request_headers_count(ref_request) * (int32_t)sizeof(_az_http_request_header)),
+        .key_hash = key_hash,
+        .waiters = NULL,
+        .is_used = true,
+      },
+    };
+  }
+
+  _az_http_policy_single_flight_unlock(options);
+
+  if (free_call != NULL)
+  {
+    return _az_http_policy_single_flight_send(
+        options, free_call, ref_policies, ref_request, ref_response);
+  }
+#else
+  (void)ref_options;
+#endif // _az_SINGLE_FLIGHT_ENABLED
+
+  return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+}
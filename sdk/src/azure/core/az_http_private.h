@@ -4,6 +4,7 @@
 #ifndef _az_HTTP_PRIVATE_H
 #define _az_HTTP_PRIVATE_H
 
+#include <azure/core/az_context.h>
 #include <azure/core/az_http.h>
 #include <azure/core/az_http_transport.h>
 #include <azure/core/az_precondition.h>
@@ -11,6 +12,7 @@
 #include <azure/core/internal/az_precondition_internal.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <azure/core/_az_cfg_prefix.h>
 
@@ -41,6 +43,64 @@ AZ_NODISCARD AZ_INLINE az_result _az_http_request_remove_retry_headers(az_http_r
   return AZ_OK;
 }
 
+/**
+ * @brief Appends a header whose name is a compile-time literal to \p ref_request.
+ *
+ * @details Unlike az_http_request_append_header(), the name is neither trimmed nor validated, as it
+ * is known to be valid when the SDK is written. The value is still trimmed. Building with
+ * `AZ_NO_LITERAL_HEADER_VALIDATION` also removes the precondition that checks the name, even when
+ * other preconditions are enabled.
+ *
+ * @return
+ *   - *`AZ_OK`* success.
+ *   - *`AZ_ERROR_NOT_ENOUGH_SPACE`* the headers buffer of the request is too small.
+ */
+AZ_NODISCARD az_result _az_http_request_append_header_literal_name(
+    az_http_request* ref_request,
+    az_span name,
+    az_span value);
+
+/**
+ * @brief Appends headers that were validated already to \p ref_request, with a single copy.
+ *
+ * @return
+ *   - *`AZ_OK`* success.
+ *   - *`AZ_ERROR_NOT_ENOUGH_SPACE`* the headers buffer of the request is too small.
+ */
+AZ_NODISCARD az_result _az_http_request_append_headers(
+    az_http_request* ref_request,
+    _az_http_request_header const* headers,
+    int32_t headers_length);
+
+/**
+ * @brief Appends query parameters that were serialized and URL-encoded already, as
+ * `name=value&name=value`, to the URL of \p ref_request, with a single copy.
+ *
+ * @return
+ *   - *`AZ_OK`* success.
+ *   - *`AZ_ERROR_NOT_ENOUGH_SPACE`* the URL buffer of the request is too small.
+ */
+AZ_NODISCARD az_result _az_http_request_append_query(az_http_request* ref_request, az_span query);
+
+/**
+ * @brief Gets the delay a service asked for before the next request, from the `retry-after-ms`,
+ * `x-ms-retry-after-ms` or `Retry-After` header of \p ref_response.
+ *
+ * @details The headers are read from where the parser of \p ref_response is, so the status line
+ * must have been read already. Pass a copy of the response to leave the original untouched.
+ *
+ * @param[out] out_retry_after_msec The delay in milliseconds, or -1 if the response has none.
+ */
+AZ_NODISCARD az_result _az_http_response_get_retry_after_msec(
+    az_http_response* ref_response,
+    int32_t* out_retry_after_msec);
+
+/**
+ * @brief Waits for \p delay_msec. When \p context has a wake event, setting it ends the delay, so
+ * that a canceled request returns at once rather than after the delay.
+ */
+AZ_NODISCARD az_result _az_http_policy_wait(az_context const* context, int32_t delay_msec);
+
 /**
  * @brief Sets buffer and parser to its initial state.
  *
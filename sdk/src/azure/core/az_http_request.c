@@ -14,6 +14,7 @@
 #include <azure/core/internal/az_span_internal.h>
 
 #include <assert.h>
+#include <string.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -57,12 +58,88 @@ AZ_NODISCARD az_result az_http_request_init(
                                .max_headers = az_span_size(headers_buffer)
                                    / (int32_t)sizeof(_az_http_request_header),
                                .retry_headers_start_byte_offset = 0,
+                               .saved = {
+                                 .url_length = url_length,
+                                 .query_start = query_start == url_length ? 0 : query_start + 1,
+                                 .headers_length = 0,
+                               },
                                .body = body,
+                               .body_reader = {
+                                 .read_callback = NULL,
+                                 .user_context = NULL,
+                                 .length = 0,
+                               },
+                               .pipeline_operation = NULL,
+                               .policy_depth = 0,
+                               .arena = NULL,
                            } };
 
   return AZ_OK;
 }
 
+void az_http_request_save_template(az_http_request* ref_request)
+{
+  _az_PRECONDITION_NOT_NULL(ref_request);
+
+  ref_request->_internal.saved.url_length = ref_request->_internal.url_length;
+  ref_request->_internal.saved.query_start = ref_request->_internal.query_start;
+  ref_request->_internal.saved.headers_length = ref_request->_internal.headers_length;
+}
+
+void az_http_request_reset(az_http_request* ref_request, az_context* context, az_span body)
+{
+  _az_PRECONDITION_NOT_NULL(ref_request);
+
+  ref_request->_internal.context = context;
+  ref_request->_internal.url_length = ref_request->_internal.saved.url_length;
+  ref_request->_internal.query_start = ref_request->_internal.saved.query_start;
+  ref_request->_internal.headers_length = ref_request->_internal.saved.headers_length;
+  ref_request->_internal.retry_headers_start_byte_offset = 0;
+  ref_request->_internal.body = body;
+  ref_request->_internal.body_reader.read_callback = NULL;
+  ref_request->_internal.body_reader.user_context = NULL;
+  ref_request->_internal.body_reader.length = 0;
+  ref_request->_internal.pipeline_operation = NULL;
+  ref_request->_internal.policy_depth = 0;
+}
+
+AZ_NODISCARD az_result az_http_request_init_from_template(
+    az_http_request* out_request,
+    az_http_request const* template_request,
+    az_context* context,
+    az_span url,
+    az_span headers_buffer,
+    az_span body)
+{
+  _az_PRECONDITION_NOT_NULL(out_request);
+  _az_PRECONDITION_NOT_NULL(template_request);
+  _az_PRECONDITION_VALID_SPAN(url, 1, false);
+  _az_PRECONDITION_VALID_SPAN(headers_buffer, 0, false);
+
+  int32_t const url_length = template_request->_internal.saved.url_length;
+  int32_t const headers_size = template_request->_internal.saved.headers_length
+      * (int32_t)sizeof(_az_http_request_header);
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(url, url_length);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(headers_buffer, headers_size);
+
+  // The URL and headers of the template are copied as they are, they were validated and encoded
+  // when they were added to it.
+  az_span_copy(url, az_span_slice(template_request->_internal.url, 0, url_length));
+  az_span_copy(
+      headers_buffer, az_span_slice(template_request->_internal.headers, 0, headers_size));
+
+  *out_request = *template_request;
+  out_request->_internal.url = url;
+  out_request->_internal.headers = headers_buffer;
+  out_request->_internal.max_headers
+      = az_span_size(headers_buffer) / (int32_t)sizeof(_az_http_request_header);
+  out_request->_internal.arena = NULL;
+  az_http_request_reset(out_request, context, body);
+
+  return AZ_OK;
+}
+
 AZ_NODISCARD az_result az_http_request_set_query_parameter(
     az_http_request* ref_request,
     az_span name,
@@ -80,21 +157,16 @@ AZ_NODISCARD az_result az_http_request_set_query_parameter(
   az_span url_remainder = az_span_slice_to_end(ref_request->_internal.url, initial_url_length);
 
   // Adding query parameter. Adding +2 to required length to include extra required symbols `=`
-  // and `?` or `&`.
-  int32_t required_length = 2 + az_span_size(name)
-      + (is_value_url_encoded ? az_span_size(value) : _az_span_url_encode_calc_length(value));
+  // and `?` or `&`. A value that still needs to be URL-encoded can only get longer, so this is
+  // checked again, in the same pass that encodes it, below.
+  int32_t value_length = az_span_size(value);
+  int32_t const name_length = 2 + az_span_size(name);
 
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(url_remainder, required_length);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(url_remainder, name_length + value_length);
 
   // Append either '?' or '&'
-  uint8_t separator = '&';
-  if (ref_request->_internal.query_start == 0)
-  {
-    separator = '?';
-
-    // update QPs starting position when it's 0
-    ref_request->_internal.query_start = initial_url_length + 1;
-  }
+  bool const is_first_query_parameter = ref_request->_internal.query_start == 0;
+  uint8_t const separator = is_first_query_parameter ? '?' : '&';
 
   url_remainder = az_span_copy_u8(url_remainder, separator);
   url_remainder = az_span_copy(url_remainder, name);
@@ -109,11 +181,18 @@ AZ_NODISCARD az_result az_http_request_set_query_parameter(
   }
   else
   {
-    int32_t encoding_size = 0;
-    _az_RETURN_IF_FAILED(_az_span_url_encode(url_remainder, value, &encoding_size));
+    // The request is only updated below, so anything written past the current URL on failure is
+    // ignored.
+    _az_RETURN_IF_FAILED(_az_span_url_encode(url_remainder, value, &value_length));
+  }
+
+  if (is_first_query_parameter)
+  {
+    // update QPs starting position when it's 0
+    ref_request->_internal.query_start = initial_url_length + 1;
   }
 
-  ref_request->_internal.url_length += required_length;
+  ref_request->_internal.url_length += name_length + value_length;
 
   return AZ_OK;
 }
@@ -132,6 +211,24 @@ az_http_request_append_header(az_http_request* ref_request, az_span name, az_spa
   // Make this function to only work with valid input for header name
   _az_PRECONDITION(az_http_is_valid_header_name(name));
 
+  return _az_http_request_append_header_literal_name(ref_request, name, value);
+}
+
+AZ_NODISCARD az_result _az_http_request_append_header_literal_name(
+    az_http_request* ref_request,
+    az_span name,
+    az_span value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_request);
+
+#ifndef AZ_NO_LITERAL_HEADER_VALIDATION
+  _az_PRECONDITION_VALID_SPAN(name, 1, false);
+  _az_PRECONDITION(az_http_is_valid_header_name(name));
+  _az_PRECONDITION(az_span_is_content_equal(name, _az_span_trim_whitespace(name)));
+#endif // AZ_NO_LITERAL_HEADER_VALIDATION
+
+  value = _az_span_trim_whitespace(value);
+
   az_span headers = ref_request->_internal.headers;
   _az_http_request_header header_to_append = { .name = name, .value = value };
 
@@ -148,6 +245,60 @@ az_http_request_append_header(az_http_request* ref_request, az_span name, az_spa
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result _az_http_request_append_headers(
+    az_http_request* ref_request,
+    _az_http_request_header const* headers,
+    int32_t headers_length)
+{
+  _az_PRECONDITION_NOT_NULL(ref_request);
+  _az_PRECONDITION(headers_length >= 0);
+
+  az_span const headers_remainder = az_span_slice_to_end(
+      ref_request->_internal.headers,
+      (int32_t)sizeof(_az_http_request_header) * ref_request->_internal.headers_length);
+  int32_t const size = (int32_t)sizeof(_az_http_request_header) * headers_length;
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(headers_remainder, size);
+
+  if (size > 0)
+  {
+    memcpy(az_span_ptr(headers_remainder), (void const*)headers, (size_t)size);
+  }
+  ref_request->_internal.headers_length += headers_length;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result _az_http_request_append_query(az_http_request* ref_request, az_span query)
+{
+  _az_PRECONDITION_NOT_NULL(ref_request);
+  _az_PRECONDITION_VALID_SPAN(query, 0, true);
+
+  if (az_span_size(query) == 0)
+  {
+    return AZ_OK;
+  }
+
+  int32_t const initial_url_length = ref_request->_internal.url_length;
+  az_span url_remainder = az_span_slice_to_end(ref_request->_internal.url, initial_url_length);
+
+  // Adding 1 for the `?` or `&` separator.
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(url_remainder, 1 + az_span_size(query));
+
+  bool const is_first_query_parameter = ref_request->_internal.query_start == 0;
+  url_remainder = az_span_copy_u8(url_remainder, is_first_query_parameter ? '?' : '&');
+  az_span_copy(url_remainder, query);
+
+  if (is_first_query_parameter)
+  {
+    ref_request->_internal.query_start = initial_url_length + 1;
+  }
+
+  ref_request->_internal.url_length += 1 + az_span_size(query);
+
+  return AZ_OK;
+}
+
 AZ_NODISCARD az_result az_http_request_get_header(
     az_http_request const* request,
     int32_t index,
@@ -202,6 +353,78 @@ AZ_NODISCARD az_result az_http_request_get_body(az_http_request const* request,
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result az_http_request_set_body_reader(
+    az_http_request* ref_request,
+    az_http_request_body_read_fn read_callback,
+    void* user_context,
+    int64_t body_length)
+{
+  _az_PRECONDITION_NOT_NULL(ref_request);
+  _az_PRECONDITION_NOT_NULL(read_callback);
+  _az_PRECONDITION(body_length >= -1);
+
+  ref_request->_internal.body = AZ_SPAN_EMPTY;
+  ref_request->_internal.body_reader.read_callback = read_callback;
+  ref_request->_internal.body_reader.user_context = user_context;
+  ref_request->_internal.body_reader.length = body_length;
+
+  return AZ_OK;
+}
+
+void az_http_request_set_arena(az_http_request* ref_request, az_arena* arena)
+{
+  _az_PRECONDITION_NOT_NULL(ref_request);
+
+  ref_request->_internal.arena = arena;
+}
+
+AZ_NODISCARD bool az_http_request_has_body_reader(az_http_request const* request)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+  return request->_internal.body_reader.read_callback != NULL;
+}
+
+AZ_NODISCARD int64_t az_http_request_get_body_length(az_http_request const* request)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+
+  return request->_internal.body_reader.read_callback != NULL
+      ? request->_internal.body_reader.length
+      : (int64_t)az_span_size(request->_internal.body);
+}
+
+AZ_NODISCARD az_result az_http_request_read_body(
+    az_http_request const* request,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION(offset >= 0);
+  _az_PRECONDITION_NOT_NULL(out_size);
+
+  if (request->_internal.body_reader.read_callback != NULL)
+  {
+    *out_size = 0;
+    return request->_internal.body_reader.read_callback(
+        request->_internal.body_reader.user_context, offset, destination, out_size);
+  }
+
+  az_span const body = request->_internal.body;
+  if (offset >= az_span_size(body))
+  {
+    *out_size = 0;
+    return AZ_OK;
+  }
+
+  az_span const remaining = az_span_slice_to_end(body, (int32_t)offset);
+  *out_size = az_span_size(remaining) < az_span_size(destination) ? az_span_size(remaining)
+                                                                   : az_span_size(destination);
+  az_span_copy(destination, az_span_slice(remaining, 0, *out_size));
+
+  return AZ_OK;
+}
+
 AZ_NODISCARD int32_t az_http_request_headers_count(az_http_request const* request)
 {
   return request->_internal.headers_length;
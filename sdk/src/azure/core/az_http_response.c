@@ -9,6 +9,7 @@
 #include <azure/core/az_precondition.h>
 #include <azure/core/internal/az_precondition_internal.h>
 #include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
 
 #include <azure/core/_az_cfg.h>
 #include <ctype.h>
@@ -76,8 +77,13 @@ _az_get_http_status_line(az_span* ref_span, az_http_response_status_line* out_st
 
   // status-code = 3DIGIT
   {
+    if (az_span_size(*ref_span) < 3)
+    {
+      return AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER;
+    }
+
     uint64_t code = 0;
-    _az_RETURN_IF_FAILED(az_span_atou64(az_span_create(az_span_ptr(*ref_span), 3), &code));
+    _az_RETURN_IF_FAILED(az_span_atou64(az_span_slice(*ref_span, 0, 3), &code));
     out_status_line->status_code = (az_http_status_code)code;
     // move reader
     *ref_span = az_span_slice_to_end(*ref_span, 3);
@@ -106,8 +112,10 @@ _az_get_http_status_line(az_span* ref_span, az_http_response_status_line* out_st
     return AZ_ERROR_ITEM_NOT_FOUND;
   }
 
-  // save reason-phrase in status line now that we got the offset. Remove 1 last chars(\r)
-  out_status_line->reason_phrase = az_span_slice(*ref_span, 0, offset - 1);
+  // save reason-phrase in status line now that we got the offset. Remove the last char (\r), if
+  // the reason-phrase isn't empty and ends with one.
+  out_status_line->reason_phrase
+      = az_span_slice(*ref_span, 0, offset > 0 && ptr[offset - 1] == '\r' ? offset - 1 : offset);
   // move position of reader after reason-phrase (parsed done)
   *ref_span = az_span_slice_to_end(*ref_span, offset + 1);
   // CR LF
@@ -248,9 +256,17 @@ AZ_NODISCARD az_result az_http_response_get_next_header(
   {
     int32_t offset = 0;
     int32_t offset_value_end = offset;
+    int32_t const input_size = az_span_size(*reader);
+    uint8_t const* const ptr = az_span_ptr(*reader);
     while (true)
     {
-      uint8_t c = az_span_ptr(*reader)[offset];
+      // A value must end with CR, a response truncated before it is corrupt.
+      if (offset == input_size)
+      {
+        return AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER;
+      }
+
+      uint8_t c = ptr[offset];
       offset += 1;
       if (c == '\r')
       {
@@ -279,6 +295,189 @@ AZ_NODISCARD az_result az_http_response_get_next_header(
   return AZ_OK;
 }
 
+// FNV-1a hash of a header name, with ASCII letters lower cased since header names are compared
+// ignoring case.
+static AZ_NODISCARD uint32_t _az_http_response_header_name_hash(az_span name)
+{
+  uint32_t hash = 2166136261U;
+  uint8_t const* const ptr = az_span_ptr(name);
+  int32_t const size = az_span_size(name);
+  for (int32_t i = 0; i < size; i++)
+  {
+    uint8_t c = ptr[i];
+    if ('A' <= c && c <= 'Z')
+    {
+      c = (uint8_t)(c + ('a' - 'A'));
+    }
+    hash = (hash ^ c) * 16777619U;
+  }
+  return hash;
+}
+
+// Walks the headers of response, a copy positioned at the next header to read, until one named
+// name is found.
+static AZ_NODISCARD az_result
+_az_http_response_find_next_header(az_http_response response, az_span name, az_span* out_value)
+{
+  while (true)
+  {
+    az_span header_name = { 0 };
+    az_span header_value = { 0 };
+    az_result const result
+        = az_http_response_get_next_header(&response, &header_name, &header_value);
+    if (result == AZ_ERROR_HTTP_END_OF_HEADERS)
+    {
+      return AZ_ERROR_ITEM_NOT_FOUND;
+    }
+    _az_RETURN_IF_FAILED(result);
+
+    if (az_span_is_content_equal_ignoring_case(header_name, name))
+    {
+      *out_value = header_value;
+      return AZ_OK;
+    }
+  }
+}
+
+static AZ_NODISCARD az_result _az_http_response_build_header_index(az_http_response* ref_response)
+{
+  az_http_response_header_index_entry* const entries
+      = ref_response->_internal.header_index.entries;
+  int32_t const capacity = ref_response->_internal.header_index.capacity;
+  uint8_t* const response_ptr = az_span_ptr(ref_response->_internal.http_response);
+
+  // Only mark the index as built once all the headers it covers have been parsed successfully.
+  ref_response->_internal.header_index.length = -1;
+  ref_response->_internal.header_index.unindexed_offset = -1;
+  for (int32_t i = 0; i < capacity; i++)
+  {
+    entries[i]._internal.name_length = 0;
+  }
+
+  // Parse a copy, so that the state of the caller's parser is kept.
+  az_http_response response = *ref_response;
+  az_http_response_status_line status_line = { 0 };
+  _az_RETURN_IF_FAILED(az_http_response_get_status_line(&response, &status_line));
+
+  int32_t length = 0;
+  while (true)
+  {
+    uint8_t* const header_start = az_span_ptr(response._internal.parser.remaining);
+    az_span header_name = { 0 };
+    az_span header_value = { 0 };
+    az_result const result
+        = az_http_response_get_next_header(&response, &header_name, &header_value);
+    if (result == AZ_ERROR_HTTP_END_OF_HEADERS)
+    {
+      break;
+    }
+    _az_RETURN_IF_FAILED(result);
+
+    if (length == capacity)
+    {
+      ref_response->_internal.header_index.unindexed_offset
+          = (int32_t)(header_start - response_ptr);
+      break;
+    }
+
+    // Open addressing with linear probing. Since the slots are filled in the order of the headers,
+    // the first of several headers with the same name is always the first one found.
+    uint32_t const hash = _az_http_response_header_name_hash(header_name);
+    int32_t slot = (int32_t)(hash % (uint32_t)capacity);
+    while (entries[slot]._internal.name_length != 0)
+    {
+      slot = slot + 1 == capacity ? 0 : slot + 1;
+    }
+
+    entries[slot]._internal.name_hash = hash;
+    entries[slot]._internal.name_offset = (int32_t)(az_span_ptr(header_name) - response_ptr);
+    entries[slot]._internal.name_length = az_span_size(header_name);
+    entries[slot]._internal.value_offset = (int32_t)(az_span_ptr(header_value) - response_ptr);
+    entries[slot]._internal.value_length = az_span_size(header_value);
+    length++;
+  }
+
+  ref_response->_internal.header_index.length = length;
+  ref_response->_internal.header_index.indexed_written = ref_response->_internal.written;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_http_response_set_header_index(
+    az_http_response* ref_response,
+    az_http_response_header_index_entry* index_entries,
+    int32_t index_entries_length)
+{
+  _az_PRECONDITION_NOT_NULL(ref_response);
+  _az_PRECONDITION_NOT_NULL(index_entries);
+  _az_PRECONDITION(index_entries_length > 0);
+
+  ref_response->_internal.header_index.entries = index_entries;
+  ref_response->_internal.header_index.capacity = index_entries_length;
+  ref_response->_internal.header_index.length = -1;
+  ref_response->_internal.header_index.unindexed_offset = -1;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_http_response_find_header(az_http_response* ref_response, az_span name, az_span* out_value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_response);
+  _az_PRECONDITION_VALID_SPAN(name, 1, false);
+  _az_PRECONDITION_NOT_NULL(out_value);
+
+  if (ref_response->_internal.header_index.entries == NULL)
+  {
+    az_http_response response = *ref_response;
+    az_http_response_status_line status_line = { 0 };
+    _az_RETURN_IF_FAILED(az_http_response_get_status_line(&response, &status_line));
+    return _az_http_response_find_next_header(response, name, out_value);
+  }
+
+  if (ref_response->_internal.header_index.length < 0
+      || ref_response->_internal.header_index.indexed_written != ref_response->_internal.written)
+  {
+    _az_RETURN_IF_FAILED(_az_http_response_build_header_index(ref_response));
+  }
+
+  az_http_response_header_index_entry const* const entries
+      = ref_response->_internal.header_index.entries;
+  int32_t const capacity = ref_response->_internal.header_index.capacity;
+  uint8_t* const response_ptr = az_span_ptr(ref_response->_internal.http_response);
+
+  uint32_t const hash = _az_http_response_header_name_hash(name);
+  int32_t slot = (int32_t)(hash % (uint32_t)capacity);
+  for (int32_t probes = 0; probes < capacity && entries[slot]._internal.name_length != 0; probes++)
+  {
+    if (entries[slot]._internal.name_hash == hash
+        && az_span_is_content_equal_ignoring_case(
+            az_span_create(
+                response_ptr + entries[slot]._internal.name_offset,
+                entries[slot]._internal.name_length),
+            name))
+    {
+      *out_value = az_span_create(
+          response_ptr + entries[slot]._internal.value_offset,
+          entries[slot]._internal.value_length);
+      return AZ_OK;
+    }
+    slot = slot + 1 == capacity ? 0 : slot + 1;
+  }
+
+  int32_t const unindexed_offset = ref_response->_internal.header_index.unindexed_offset;
+  if (unindexed_offset < 0)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  // Some headers didn't fit in the index, so only those need to be parsed again.
+  az_http_response response = *ref_response;
+  response._internal.parser.remaining
+      = az_span_slice_to_end(ref_response->_internal.http_response, unindexed_offset);
+  response._internal.parser.next_kind = _az_HTTP_RESPONSE_KIND_HEADER;
+  return _az_http_response_find_next_header(response, name, out_value);
+}
+
 AZ_NODISCARD az_result az_http_response_get_body(az_http_response* ref_response, az_span* out_body)
 {
   _az_PRECONDITION_NOT_NULL(ref_response);
@@ -310,8 +509,10 @@ AZ_NODISCARD az_result az_http_response_get_body(az_http_response* ref_response,
     }
   }
 
-  // take all the remaining content from reader as body
-  *out_body = az_span_slice_to_end(ref_response->_internal.parser.remaining, 0);
+  // take all the remaining content from reader as body, unless it went to the body allocator
+  *out_body = ref_response->_internal.body_stream.allocator_callback != NULL
+      ? AZ_SPAN_EMPTY
+      : az_span_slice_to_end(ref_response->_internal.parser.remaining, 0);
 
   ref_response->_internal.parser.next_kind = _az_HTTP_RESPONSE_KIND_EOF;
   return AZ_OK;
@@ -321,9 +522,43 @@ void _az_http_response_reset(az_http_response* ref_response)
 {
   // never fails, discard the result
   // init will set written to 0 and will use the same az_span. Internal parser's state is also
-  // reset
+  // reset. The header index stays attached, and is rebuilt the next time it is used. So do the body
+  // allocator and the event callback, which raises the events of the next response from the start.
+  az_http_response_header_index_entry* const index_entries
+      = ref_response->_internal.header_index.entries;
+  int32_t const index_capacity = ref_response->_internal.header_index.capacity;
+  az_span_allocator_fn const body_allocator
+      = ref_response->_internal.body_stream.allocator_callback;
+  void* const body_user_context = ref_response->_internal.body_stream.user_context;
+  az_http_response_event_fn const event_callback = ref_response->_internal.events.callback;
+  void* const event_user_context = ref_response->_internal.events.user_context;
+
   az_result result = az_http_response_init(ref_response, ref_response->_internal.http_response);
   (void)result;
+
+  ref_response->_internal.events.callback = event_callback;
+  ref_response->_internal.events.user_context = event_user_context;
+
+  ref_response->_internal.header_index.entries = index_entries;
+  ref_response->_internal.header_index.capacity = index_capacity;
+  ref_response->_internal.body_stream.allocator_callback = body_allocator;
+  ref_response->_internal.body_stream.user_context = body_user_context;
+}
+
+AZ_NODISCARD az_result az_http_response_set_body_allocator(
+    az_http_response* ref_response,
+    az_span_allocator_fn allocator_callback,
+    void* user_context)
+{
+  _az_PRECONDITION_NOT_NULL(ref_response);
+  _az_PRECONDITION_NOT_NULL(allocator_callback);
+
+  ref_response->_internal.body_stream.allocator_callback = allocator_callback;
+  ref_response->_internal.body_stream.user_context = user_context;
+  ref_response->_internal.body_stream.destination = AZ_SPAN_EMPTY;
+  ref_response->_internal.body_stream.bytes_used = 0;
+
+  return AZ_OK;
 }
 
 // internal function to get az_http_response remainder
@@ -332,6 +567,105 @@ static az_span _az_http_response_get_remaining(az_http_response const* response)
   return az_span_slice_to_end(response->_internal.http_response, response->_internal.written);
 }
 
+AZ_NODISCARD az_result az_http_response_set_event_callback(
+    az_http_response* ref_response,
+    az_http_response_event_fn event_callback,
+    void* user_context)
+{
+  _az_PRECONDITION_NOT_NULL(ref_response);
+  _az_PRECONDITION_NOT_NULL(event_callback);
+
+  ref_response->_internal.events.callback = event_callback;
+  ref_response->_internal.events.user_context = user_context;
+  ref_response->_internal.events.parsed = 0;
+  ref_response->_internal.events.next_kind = _az_HTTP_RESPONSE_KIND_STATUS_LINE;
+
+  return AZ_OK;
+}
+
+static AZ_NODISCARD az_result
+_az_http_response_raise_body_event(az_http_response const* response, az_span body)
+{
+  if (az_span_size(body) == 0)
+  {
+    return AZ_OK;
+  }
+
+  az_http_response_event const event = {
+    .status_line = { 0 },
+    .name = AZ_SPAN_EMPTY,
+    .value = body,
+    .kind = AZ_HTTP_RESPONSE_EVENT_BODY,
+  };
+
+  return response->_internal.events.callback(&event, response->_internal.events.user_context);
+}
+
+// Raises the events for every complete line the transport appended since the last call, until the
+// end of the headers. Whatever follows the headers is raised as body.
+static AZ_NODISCARD az_result _az_http_response_raise_events(az_http_response* ref_response)
+{
+  uint8_t* const response_ptr = az_span_ptr(ref_response->_internal.http_response);
+  int32_t const written = ref_response->_internal.written;
+
+  while (ref_response->_internal.events.next_kind != _az_HTTP_RESPONSE_KIND_BODY)
+  {
+    int32_t const parsed = ref_response->_internal.events.parsed;
+    az_span const unparsed = az_span_create(response_ptr + parsed, written - parsed);
+    int32_t const line_size = az_span_find(unparsed, AZ_SPAN_FROM_STR("\n")) + 1;
+    if (line_size <= 0)
+    {
+      // The line is not complete yet.
+      return AZ_OK;
+    }
+
+    az_span line = az_span_create(response_ptr + parsed, line_size);
+    az_http_response_event event = {
+      .status_line = { 0 },
+      .name = AZ_SPAN_EMPTY,
+      .value = AZ_SPAN_EMPTY,
+      .kind = AZ_HTTP_RESPONSE_EVENT_STATUS_LINE,
+    };
+
+    if (ref_response->_internal.events.next_kind == _az_HTTP_RESPONSE_KIND_STATUS_LINE)
+    {
+      _az_RETURN_IF_FAILED(_az_get_http_status_line(&line, &event.status_line));
+      ref_response->_internal.events.next_kind = _az_HTTP_RESPONSE_KIND_HEADER;
+    }
+    else
+    {
+      // Parse the line with a copy of the response, positioned at the header, so the state of the
+      // pull parser is kept.
+      az_http_response response = *ref_response;
+      response._internal.parser.remaining = line;
+      response._internal.parser.next_kind = _az_HTTP_RESPONSE_KIND_HEADER;
+      az_result const result
+          = az_http_response_get_next_header(&response, &event.name, &event.value);
+      if (result == AZ_ERROR_HTTP_END_OF_HEADERS)
+      {
+        event.kind = AZ_HTTP_RESPONSE_EVENT_END_OF_HEADERS;
+        ref_response->_internal.events.next_kind = _az_HTTP_RESPONSE_KIND_BODY;
+      }
+      else
+      {
+        _az_RETURN_IF_FAILED(result);
+        event.kind = AZ_HTTP_RESPONSE_EVENT_HEADER;
+      }
+    }
+
+    ref_response->_internal.events.parsed += line_size;
+    _az_RETURN_IF_FAILED(ref_response->_internal.events.callback(
+        &event, ref_response->_internal.events.user_context));
+  }
+
+  // The transport may have appended the beginning of the body along with the headers.
+  az_span const body = az_span_create(
+      response_ptr + ref_response->_internal.events.parsed,
+      written - ref_response->_internal.events.parsed);
+  ref_response->_internal.events.parsed = written;
+  return _az_http_response_raise_body_event(ref_response, body);
+}
+
 AZ_NODISCARD az_result az_http_response_append(az_http_response* ref_response, az_span source)
 {
   _az_PRECONDITION_NOT_NULL(ref_response);
@@ -343,5 +677,62 @@ AZ_NODISCARD az_result az_http_response_append(az_http_response* ref_response, a
   az_span_copy(remaining, source);
   ref_response->_internal.written += write_size;
 
+  if (ref_response->_internal.events.callback != NULL)
+  {
+    return _az_http_response_raise_events(ref_response);
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_http_response_append_body(az_http_response* ref_response, az_span source)
+{
+  _az_PRECONDITION_NOT_NULL(ref_response);
+
+  if (ref_response->_internal.body_stream.allocator_callback == NULL)
+  {
+    return az_http_response_append(ref_response, source);
+  }
+
+  while (az_span_size(source) > 0)
+  {
+    az_span remaining = az_span_slice_to_end(
+        ref_response->_internal.body_stream.destination,
+        ref_response->_internal.body_stream.bytes_used);
+
+    if (az_span_size(remaining) == 0)
+    {
+      az_span_allocator_context context = {
+        .user_context = ref_response->_internal.body_stream.user_context,
+        .bytes_used = ref_response->_internal.body_stream.bytes_used,
+        .minimum_required_size = 0,
+      };
+
+      _az_RETURN_IF_FAILED(
+          ref_response->_internal.body_stream.allocator_callback(&context, &remaining));
+
+      if (az_span_size(remaining) == 0)
+      {
+        return AZ_ERROR_NOT_ENOUGH_SPACE;
+      }
+
+      ref_response->_internal.body_stream.destination = remaining;
+      ref_response->_internal.body_stream.bytes_used = 0;
+    }
+
+    int32_t const write_size = az_span_size(remaining) < az_span_size(source)
+        ? az_span_size(remaining)
+        : az_span_size(source);
+    az_span_copy(remaining, az_span_slice(source, 0, write_size));
+    ref_response->_internal.body_stream.bytes_used += write_size;
+    source = az_span_slice_to_end(source, write_size);
+
+    if (ref_response->_internal.events.callback != NULL)
+    {
+      _az_RETURN_IF_FAILED(_az_http_response_raise_body_event(
+          ref_response, az_span_slice(remaining, 0, write_size)));
+    }
+  }
+
   return AZ_OK;
 }
@@ -0,0 +1,359 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_json_private.h"
+#include <azure/core/az_json.h>
+#include <azure/core/az_precondition.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+
+#include <azure/core/_az_cfg.h>
+
+// FNV-1a hash of a property name.
+static AZ_NODISCARD uint32_t _az_json_path_name_hash(az_span name)
+{
+  uint32_t hash = 2166136261U;
+  uint8_t const* const ptr = az_span_ptr(name);
+  int32_t const size = az_span_size(name);
+  for (int32_t i = 0; i < size; i++)
+  {
+    hash = (hash ^ ptr[i]) * 16777619U;
+  }
+  return hash;
+}
+
+static AZ_NODISCARD az_span _az_json_path_get_name(az_json_path const* json_path, int32_t index)
+{
+  int32_t const start = index == 0 ? 0 : json_path->_internal.name_ends[index - 1] + 1;
+  return az_span_slice(json_path->_internal.path, start, json_path->_internal.name_ends[index]);
+}
+
+AZ_NODISCARD az_result az_json_path_init(az_json_path* out_json_path, az_span path)
+{
+  _az_PRECONDITION_NOT_NULL(out_json_path);
+  _az_PRECONDITION_VALID_SPAN(path, 0, true);
+
+  *out_json_path = (az_json_path){
+    ._internal = {
+      .path = path,
+      .name_count = 0,
+      .name_ends = { 0 },
+      .name_hashes = { 0 },
+    },
+  };
+
+  int32_t const size = az_span_size(path);
+  int32_t start = 0;
+  while (true)
+  {
+    int32_t const dot_index
+        = az_span_find(az_span_slice_to_end(path, start), AZ_SPAN_FROM_STR("."));
+    int32_t const end = dot_index == -1 ? size : start + dot_index;
+
+    int32_t const name_count = out_json_path->_internal.name_count;
+    if (end == start || name_count == _az_JSON_PATH_MAX_NAMES)
+    {
+      return AZ_ERROR_ARG;
+    }
+
+    out_json_path->_internal.name_ends[name_count] = end;
+    out_json_path->_internal.name_hashes[name_count]
+        = _az_json_path_name_hash(az_span_slice(path, start, end));
+    out_json_path->_internal.name_count++;
+
+    if (dot_index == -1)
+    {
+      return AZ_OK;
+    }
+    start = end + 1;
+  }
+}
+
+// Returns the index of the path among the candidates that ends with the property name, or -1, and
+// sets the candidates that go deeper through it. Names read as is from a single buffer can be
+// hashed, the others are compared to each candidate.
+static AZ_NODISCARD int32_t _az_json_path_match_name(
+    az_json_token const* name,
+    az_json_path const paths[],
+    int32_t paths_count,
+    uint32_t candidates,
+    int32_t name_index,
+    uint32_t* out_deeper_candidates)
+{
+  bool const is_hashable
+      = !name->_internal.string_has_escaped_chars && !name->_internal.is_multisegment;
+  uint32_t const hash = is_hashable ? _az_json_path_name_hash(name->slice) : 0;
+
+  *out_deeper_candidates = 0;
+  for (int32_t i = 0; i < paths_count; i++)
+  {
+    uint32_t const bit = 1U << (uint32_t)i;
+    if ((candidates & bit) == 0
+        || (is_hashable && paths[i]._internal.name_hashes[name_index] != hash)
+        || !az_json_token_is_text_equal(name, _az_json_path_get_name(&paths[i], name_index)))
+    {
+      continue;
+    }
+
+    if (paths[i]._internal.name_count == name_index + 1)
+    {
+      return i;
+    }
+    *out_deeper_candidates |= bit;
+  }
+
+  return -1;
+}
+
+// Reads the JSON object starting at the current token, whose properties the paths within the
+// candidates bit mask expect to find as their name at name_index.
+static AZ_NODISCARD az_result _az_json_reader_select_within_object(
+    az_json_reader* ref_json_reader,
+    az_json_path const paths[],
+    int32_t paths_count,
+    uint32_t candidates,
+    int32_t name_index,
+    az_json_path_handler_fn handler,
+    void* user_context)
+{
+  while (true)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+    if (ref_json_reader->token.kind == AZ_JSON_TOKEN_END_OBJECT)
+    {
+      return AZ_OK;
+    }
+
+    // Within an object, the reader only returns property names, or the end of the object.
+    uint32_t deeper_candidates = 0;
+    int32_t const matched_index = _az_json_path_match_name(
+        &ref_json_reader->token, paths, paths_count, candidates, name_index, &deeper_candidates);
+
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+    az_json_token_kind const kind = ref_json_reader->token.kind;
+
+    if (matched_index != -1)
+    {
+      int32_t const value_depth = ref_json_reader->_internal.bit_stack._internal.current_depth;
+      _az_RETURN_IF_FAILED(handler(ref_json_reader, matched_index, user_context));
+
+      // Skip what the handler didn't read of an object or array.
+      az_json_token_kind const handled_kind = ref_json_reader->token.kind;
+      if ((handled_kind == AZ_JSON_TOKEN_BEGIN_OBJECT || handled_kind == AZ_JSON_TOKEN_BEGIN_ARRAY)
+          && ref_json_reader->_internal.bit_stack._internal.current_depth == value_depth)
+      {
+        _az_RETURN_IF_FAILED(az_json_reader_skip_children(ref_json_reader));
+      }
+    }
+    else if (deeper_candidates != 0 && kind == AZ_JSON_TOKEN_BEGIN_OBJECT)
+    {
+      _az_RETURN_IF_FAILED(_az_json_reader_select_within_object(
+          ref_json_reader,
+          paths,
+          paths_count,
+          deeper_candidates,
+          name_index + 1,
+          handler,
+          user_context));
+    }
+    else
+    {
+      _az_RETURN_IF_FAILED(az_json_reader_skip_children(ref_json_reader));
+    }
+  }
+}
+
+AZ_NODISCARD az_result az_json_reader_select(
+    az_json_reader* ref_json_reader,
+    az_json_path const paths[],
+    int32_t paths_count,
+    az_json_path_handler_fn handler,
+    void* user_context)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+  _az_PRECONDITION_RANGE(0, paths_count, _az_JSON_PATH_MAX_COUNT);
+  _az_PRECONDITION(paths != NULL || paths_count == 0);
+  _az_PRECONDITION_NOT_NULL(handler);
+
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_NONE)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+
+  if (ref_json_reader->token.kind != AZ_JSON_TOKEN_BEGIN_OBJECT)
+  {
+    return az_json_reader_skip_children(ref_json_reader);
+  }
+
+  uint32_t const candidates
+      = paths_count == _az_JSON_PATH_MAX_COUNT ? UINT32_MAX : (1U << (uint32_t)paths_count) - 1U;
+
+  return _az_json_reader_select_within_object(
+      ref_json_reader, paths, paths_count, candidates, 0, handler, user_context);
+}
+
+// Returns the offset within the JSON buffer of the first byte of the current token, including the
+// opening quote of a string or property name.
+static AZ_NODISCARD int32_t _az_json_reader_get_token_offset(az_json_reader const* json_reader)
+{
+  az_json_token_kind const kind = json_reader->token.kind;
+  int32_t const quote_size
+      = kind == AZ_JSON_TOKEN_STRING || kind == AZ_JSON_TOKEN_PROPERTY_NAME ? 1 : 0;
+  return (int32_t)(az_span_ptr(json_reader->token.slice)
+                   - az_span_ptr(json_reader->_internal.json_buffer))
+      - quote_size;
+}
+
+// Copies the name/value pairs of the JSON text between the start and end offsets to the writer.
+static AZ_NODISCARD az_result _az_json_transcode_copy_members(
+    az_json_reader const* json_reader,
+    az_json_writer* ref_json_writer,
+    int32_t start,
+    int32_t end,
+    az_json_token_kind last_token_kind)
+{
+  return _az_json_writer_append_trusted_members(
+      ref_json_writer,
+      az_span_slice(json_reader->_internal.json_buffer, start, end),
+      last_token_kind);
+}
+
+// Copies the members of the JSON object starting at the current token, rewriting the values
+// found at the paths within the candidates bit mask, which expect their name at name_index.
+static AZ_NODISCARD az_result _az_json_transcode_object(
+    az_json_reader* ref_json_reader,
+    az_json_writer* ref_json_writer,
+    az_json_path const paths[],
+    int32_t paths_count,
+    uint32_t candidates,
+    int32_t name_index,
+    az_json_transcode_handler_fn handler,
+    void* user_context)
+{
+  // The run of consecutive members copied as is, not written yet.
+  int32_t run_start = -1;
+  int32_t run_end = -1;
+  az_json_token_kind run_last_token_kind = AZ_JSON_TOKEN_NONE;
+
+  while (true)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+    if (ref_json_reader->token.kind == AZ_JSON_TOKEN_END_OBJECT)
+    {
+      break;
+    }
+
+    // Within an object, the reader only returns property names, or the end of the object.
+    int32_t const name_start = _az_json_reader_get_token_offset(ref_json_reader);
+    uint32_t deeper_candidates = 0;
+    int32_t const matched_index = _az_json_path_match_name(
+        &ref_json_reader->token, paths, paths_count, candidates, name_index, &deeper_candidates);
+
+    // The property name is followed by its colon separator.
+    int32_t const name_end = ref_json_reader->_internal.bytes_consumed;
+
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+    bool const is_deeper
+        = deeper_candidates != 0 && ref_json_reader->token.kind == AZ_JSON_TOKEN_BEGIN_OBJECT;
+
+    if (matched_index == -1 && !is_deeper)
+    {
+      if (run_start == -1)
+      {
+        run_start = name_start;
+      }
+      _az_RETURN_IF_FAILED(az_json_reader_skip_children(ref_json_reader));
+      run_end = ref_json_reader->_internal.bytes_consumed;
+      run_last_token_kind = ref_json_reader->token.kind;
+      continue;
+    }
+
+    if (run_start != -1)
+    {
+      _az_RETURN_IF_FAILED(_az_json_transcode_copy_members(
+          ref_json_reader, ref_json_writer, run_start, run_end, run_last_token_kind));
+      run_start = -1;
+    }
+
+    _az_RETURN_IF_FAILED(_az_json_transcode_copy_members(
+        ref_json_reader, ref_json_writer, name_start, name_end, AZ_JSON_TOKEN_PROPERTY_NAME));
+
+    if (matched_index != -1)
+    {
+      int32_t const value_depth = ref_json_reader->_internal.bit_stack._internal.current_depth;
+      _az_RETURN_IF_FAILED(handler(ref_json_reader, ref_json_writer, matched_index, user_context));
+
+      // Skip what the handler didn't read of an object or array.
+      az_json_token_kind const handled_kind = ref_json_reader->token.kind;
+      if ((handled_kind == AZ_JSON_TOKEN_BEGIN_OBJECT || handled_kind == AZ_JSON_TOKEN_BEGIN_ARRAY)
+          && ref_json_reader->_internal.bit_stack._internal.current_depth == value_depth)
+      {
+        _az_RETURN_IF_FAILED(az_json_reader_skip_children(ref_json_reader));
+      }
+    }
+    else
+    {
+      _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_json_writer));
+      _az_RETURN_IF_FAILED(_az_json_transcode_object(
+          ref_json_reader,
+          ref_json_writer,
+          paths,
+          paths_count,
+          deeper_candidates,
+          name_index + 1,
+          handler,
+          user_context));
+      _az_RETURN_IF_FAILED(az_json_writer_append_end_object(ref_json_writer));
+    }
+  }
+
+  if (run_start != -1)
+  {
+    _az_RETURN_IF_FAILED(_az_json_transcode_copy_members(
+        ref_json_reader, ref_json_writer, run_start, run_end, run_last_token_kind));
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_transcode(
+    az_json_reader* ref_json_reader,
+    az_json_writer* ref_json_writer,
+    az_json_path const paths[],
+    int32_t paths_count,
+    az_json_transcode_handler_fn handler,
+    void* user_context)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+  _az_PRECONDITION(ref_json_reader->_internal.number_of_buffers == 1);
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_RANGE(0, paths_count, _az_JSON_PATH_MAX_COUNT);
+  _az_PRECONDITION(paths != NULL || paths_count == 0);
+  _az_PRECONDITION_NOT_NULL(handler);
+
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_NONE)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+
+  if (ref_json_reader->token.kind != AZ_JSON_TOKEN_BEGIN_OBJECT)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_json_writer));
+
+  uint32_t const candidates
+      = paths_count == _az_JSON_PATH_MAX_COUNT ? UINT32_MAX : (1U << (uint32_t)paths_count) - 1U;
+
+  return _az_json_transcode_object(
+      ref_json_reader,
+      ref_json_writer,
+      paths,
+      paths_count,
+      candidates,
+      0,
+      handler,
+      user_context);
+}
@@ -4,6 +4,8 @@
 #ifndef _az_JSON_PRIVATE_H
 #define _az_JSON_PRIVATE_H
 
+#include "az_simd_private.h"
+#include "az_span_private.h"
 #include <azure/core/az_json.h>
 #include <azure/core/internal/az_precondition_internal.h>
 
@@ -17,10 +19,14 @@
 
 enum
 {
-  // We are using a uint64_t to represent our nested state, so we can only go 64 levels deep.
+  // We are using a uint64_t to represent our nested state, so we can only go 64 levels deep, unless
+  // the stack is extended with more words of the same size.
   // This is safe to do because sizeof will not dereference the pointer and is used to find the size
   // of the field used as the stack.
-  _az_MAX_JSON_STACK_SIZE = sizeof(((_az_json_bit_stack*)0)->_internal.az_json_stack) * 8 // 64
+  _az_MAX_JSON_STACK_SIZE = sizeof(((_az_json_bit_stack*)0)->_internal.az_json_stack) * 8, // 64
+
+  // The largest number of extension words, for which the maximum depth still fits in an int32_t.
+  _az_MAX_JSON_STACK_EXTENSION_SIZE = INT32_MAX / _az_MAX_JSON_STACK_SIZE - 1,
 };
 
 enum
@@ -39,6 +45,7 @@ enum
   = _az_MAX_ESCAPED_STRING_SIZE / _az_MAX_EXPANSION_FACTOR_WHILE_ESCAPING, // 166_666_666 bytes
 
   // [-][0-9]{16}.[0-9]{15}, i.e. 1+16+1+15 since _az_MAX_SUPPORTED_FRACTIONAL_DIGITS is 15
+  // This is also enough for the up to 25 bytes written by az_span_dtoa_shortest().
   _az_MAX_SIZE_FOR_WRITING_DOUBLE = 33,
 
   // When writing large JSON strings in chunks, ask for at least 64 bytes, to avoid writing one
@@ -60,17 +67,148 @@ enum
   _az_NUMBER_OF_HEX_VALUES = 16,
 };
 
+// Returns true for the bytes that need further processing within a JSON string: the quote, the
+// start of an escape sequence, and the control characters. The reader validates these bytes, and
+// the writer escapes them.
+AZ_NODISCARD AZ_INLINE bool _az_json_is_special_string_byte(uint8_t byte)
+{
+  return byte == '"' || byte == '\\' || byte < _az_ASCII_SPACE_CHARACTER;
+}
+
+// Returns the index of the first special string byte of `ptr` at or after `index`, or `size` if
+// there is none. Blocks of 32 or 16 bytes are tested at once when SIMD instructions are available.
+AZ_NODISCARD AZ_INLINE int32_t
+_az_json_skip_plain_string_bytes(uint8_t const* ptr, int32_t index, int32_t size)
+{
+#if defined(_az_SIMD_AVX2)
+  {
+    __m256i const quote = _mm256_set1_epi8('"');
+    __m256i const backslash = _mm256_set1_epi8('\\');
+    __m256i const max_control = _mm256_set1_epi8(_az_ASCII_SPACE_CHARACTER - 1);
+
+    for (; index + 32 <= size; index += 32)
+    {
+      __m256i const block = _mm256_loadu_si256((__m256i const*)(void const*)(ptr + index));
+      // A byte is a control character if it is (unsigned) less than or equal to 0x1F.
+      __m256i const special = _mm256_or_si256(
+          _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, backslash)),
+          _mm256_cmpeq_epi8(_mm256_min_epu8(block, max_control), block));
+
+      uint32_t const mask = (uint32_t)_mm256_movemask_epi8(special);
+      if (mask != 0)
+      {
+        return index + _az_simd_lowest_bit(mask);
+      }
+    }
+  }
+#endif
+
+#if defined(_az_SIMD_SSE2)
+  {
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const max_control = _mm_set1_epi8(_az_ASCII_SPACE_CHARACTER - 1);
+
+    for (; index + 16 <= size; index += 16)
+    {
+      __m128i const block = _mm_loadu_si128((__m128i const*)(void const*)(ptr + index));
+      // A byte is a control character if it is (unsigned) less than or equal to 0x1F.
+      __m128i const special = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)),
+          _mm_cmpeq_epi8(_mm_min_epu8(block, max_control), block));
+
+      uint32_t const mask = (uint32_t)_mm_movemask_epi8(special);
+      if (mask != 0)
+      {
+        return index + _az_simd_lowest_bit(mask);
+      }
+    }
+  }
+#elif defined(_az_SIMD_NEON)
+  {
+    uint8x16_t const quote = vdupq_n_u8('"');
+    uint8x16_t const backslash = vdupq_n_u8('\\');
+    uint8x16_t const space = vdupq_n_u8(_az_ASCII_SPACE_CHARACTER);
+
+    for (; index + 16 <= size; index += 16)
+    {
+      uint8x16_t const block = vld1q_u8(ptr + index);
+      uint8x16_t const special = vorrq_u8(
+          vorrq_u8(vceqq_u8(block, quote), vceqq_u8(block, backslash)), vcltq_u8(block, space));
+
+      uint64_t const mask = _az_simd_neon_mask(special);
+      if (mask != 0)
+      {
+        return index + _az_simd_lowest_bit(mask) / 4;
+      }
+    }
+  }
+#endif
+
+  for (; index < size; index++)
+  {
+    if (_az_json_is_special_string_byte(ptr[index]))
+    {
+      break;
+    }
+  }
+
+  return index;
+}
+
+// The 32-bit FNV-1a offset basis and prime, used to hash property names.
+#define _az_JSON_PROPERTY_NAME_HASH_BASIS 2166136261U
+#define _az_JSON_PROPERTY_NAME_HASH_PRIME 16777619U
+
+AZ_NODISCARD AZ_INLINE uint32_t _az_json_property_name_hash(az_span name)
+{
+  uint8_t const* const ptr = az_span_ptr(name);
+  int32_t const size = az_span_size(name);
+
+  uint32_t hash = _az_JSON_PROPERTY_NAME_HASH_BASIS;
+  for (int32_t i = 0; i < size; i++)
+  {
+    hash = (hash ^ ptr[i]) * _az_JSON_PROPERTY_NAME_HASH_PRIME;
+  }
+
+  return hash;
+}
+
 typedef enum
 {
   _az_JSON_STACK_OBJECT = 1,
   _az_JSON_STACK_ARRAY = 0,
 } _az_json_stack_item;
 
+AZ_INLINE void _az_json_stack_init(
+    _az_json_bit_stack* out_json_stack,
+    uint64_t* extension,
+    int32_t extension_size)
+{
+  _az_PRECONDITION(extension_size >= 0 && extension_size <= _az_MAX_JSON_STACK_EXTENSION_SIZE);
+  _az_PRECONDITION(extension != NULL || extension_size == 0);
+
+  *out_json_stack = (_az_json_bit_stack){
+    ._internal = {
+      .az_json_stack = 0,
+      .current_depth = 0,
+      .extension = extension,
+      .extension_size = extension_size,
+    },
+  };
+}
+
+// The maximum depth, including the levels provided by the extension words.
+AZ_NODISCARD AZ_INLINE int32_t _az_json_stack_max_depth(_az_json_bit_stack const* json_stack)
+{
+  return (json_stack->_internal.extension_size + 1) * _az_MAX_JSON_STACK_SIZE;
+}
+
 AZ_INLINE _az_json_stack_item _az_json_stack_pop(_az_json_bit_stack* ref_json_stack)
 {
   _az_PRECONDITION(
       ref_json_stack->_internal.current_depth > 0
-      && ref_json_stack->_internal.current_depth <= _az_MAX_JSON_STACK_SIZE);
+      && ref_json_stack->_internal.current_depth <= _az_json_stack_max_depth(ref_json_stack));
 
   // Don't do the right bit shift if we are at the last bit in the stack.
   if (ref_json_stack->_internal.current_depth != 0)
@@ -80,6 +218,17 @@ AZ_INLINE _az_json_stack_item _az_json_stack_pop(_az_json_bit_stack* ref_json_st
     // We don't want current_depth to become negative, in case preconditions are off, and if
     // append_container_end is called before append_X_start.
     ref_json_stack->_internal.current_depth--;
+
+    // Bring back the outermost state that was moved to the extension when pushing, if any.
+    int32_t const extension_index
+        = ref_json_stack->_internal.current_depth - _az_MAX_JSON_STACK_SIZE;
+    if (extension_index >= 0)
+    {
+      uint64_t const word
+          = ref_json_stack->_internal.extension[extension_index / _az_MAX_JSON_STACK_SIZE];
+      uint64_t const bit = (word >> (uint32_t)(extension_index % _az_MAX_JSON_STACK_SIZE)) & 1U;
+      ref_json_stack->_internal.az_json_stack |= bit << (_az_MAX_JSON_STACK_SIZE - 1U);
+    }
   }
 
   // true (i.e. 1) means _az_JSON_STACK_OBJECT, while false (i.e. 0) means _az_JSON_STACK_ARRAY
@@ -91,7 +240,18 @@ AZ_INLINE void _az_json_stack_push(_az_json_bit_stack* ref_json_stack, _az_json_
 {
   _az_PRECONDITION(
       ref_json_stack->_internal.current_depth >= 0
-      && ref_json_stack->_internal.current_depth < _az_MAX_JSON_STACK_SIZE);
+      && ref_json_stack->_internal.current_depth < _az_json_stack_max_depth(ref_json_stack));
+
+  // Once the word is full, move its outermost state to the extension, before shifting it out.
+  int32_t const extension_index = ref_json_stack->_internal.current_depth - _az_MAX_JSON_STACK_SIZE;
+  if (extension_index >= 0)
+  {
+    uint64_t* const word
+        = &ref_json_stack->_internal.extension[extension_index / _az_MAX_JSON_STACK_SIZE];
+    uint64_t const mask = 1ULL << (uint32_t)(extension_index % _az_MAX_JSON_STACK_SIZE);
+    uint64_t const bit = ref_json_stack->_internal.az_json_stack >> (_az_MAX_JSON_STACK_SIZE - 1U);
+    *word = bit != 0 ? (*word | mask) : (*word & ~mask);
+  }
 
   ref_json_stack->_internal.current_depth++;
   ref_json_stack->_internal.az_json_stack <<= 1U;
@@ -102,13 +262,40 @@ AZ_NODISCARD AZ_INLINE _az_json_stack_item _az_json_stack_peek(_az_json_bit_stac
 {
   _az_PRECONDITION(
       json_stack->_internal.current_depth >= 0
-      && json_stack->_internal.current_depth <= _az_MAX_JSON_STACK_SIZE);
+      && json_stack->_internal.current_depth <= _az_json_stack_max_depth(json_stack));
 
   // true (i.e. 1) means _az_JSON_STACK_OBJECT, while false (i.e. 0) means _az_JSON_STACK_ARRAY
   return (json_stack->_internal.az_json_stack & 1U) != 0 ? _az_JSON_STACK_OBJECT
                                                          : _az_JSON_STACK_ARRAY;
 }
 
+// Validates appending a value (or the start of a container), given the containers the writer is
+// within and the kind of the last token it wrote.
+AZ_NODISCARD bool _az_json_writer_is_appending_value_valid(
+    _az_json_bit_stack const* bit_stack,
+    az_json_token_kind last_token_kind);
+
+// Validates appending a property name, given the containers the writer is within and the kind of
+// the last token it wrote.
+AZ_NODISCARD bool _az_json_writer_is_appending_property_name_valid(
+    _az_json_bit_stack const* bit_stack,
+    az_json_token_kind last_token_kind);
+
+// Validates appending the end of the given kind of container, given the containers the writer is
+// within and the kind of the last token it wrote.
+AZ_NODISCARD bool _az_json_writer_is_appending_container_end_valid(
+    _az_json_bit_stack const* bit_stack,
+    az_json_token_kind last_token_kind,
+    _az_json_stack_item container);
+
+// Copies the members of an object, read from a JSON payload that has already been validated, as
+// is: either a property name with its colon separator, or any number of complete name/value pairs
+// separated by commas. The last token of the text is of the given kind.
+AZ_NODISCARD az_result _az_json_writer_append_trusted_members(
+    az_json_writer* ref_json_writer,
+    az_span json_members,
+    az_json_token_kind last_token_kind);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_SPAN_PRIVATE_H
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "az_json_private.h"
+#include "az_simd_private.h"
 #include "az_span_private.h"
 #include <azure/core/az_precondition.h>
 #include <azure/core/internal/az_result_internal.h>
@@ -41,10 +42,16 @@ AZ_NODISCARD az_result az_json_reader_init(
       .bytes_consumed = 0,
       .total_bytes_consumed = 0,
       .is_complex_json = false,
-      .bit_stack = { 0 },
       .options = options == NULL ? az_json_reader_options_default() : *options,
+      .incremental_buffer = AZ_SPAN_EMPTY,
+      .is_final_feed = false,
     },
   };
+
+  _az_json_stack_init(
+      &out_json_reader->_internal.bit_stack,
+      out_json_reader->_internal.options.nesting_stack_extension,
+      out_json_reader->_internal.options.nesting_stack_extension_size);
   return AZ_OK;
 }
 
@@ -57,6 +64,14 @@ AZ_NODISCARD az_result az_json_reader_chunked_init(
   _az_PRECONDITION(number_of_buffers >= 1);
   _az_PRECONDITION(az_span_size(json_buffers[0]) >= 1);
 
+#ifdef AZ_NO_JSON_READER_CHUNKS
+  // The reader is built to only read contiguous JSON payloads.
+  if (number_of_buffers > 1)
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+#endif // AZ_NO_JSON_READER_CHUNKS
+
   *out_json_reader = (az_json_reader){
     .token = (az_json_token){
       .kind = AZ_JSON_TOKEN_NONE,
@@ -80,10 +95,60 @@ AZ_NODISCARD az_result az_json_reader_chunked_init(
       .bytes_consumed = 0,
       .total_bytes_consumed = 0,
       .is_complex_json = false,
-      .bit_stack = { 0 },
       .options = options == NULL ? az_json_reader_options_default() : *options,
+      .incremental_buffer = AZ_SPAN_EMPTY,
+      .is_final_feed = false,
+    },
+  };
+
+  _az_json_stack_init(
+      &out_json_reader->_internal.bit_stack,
+      out_json_reader->_internal.options.nesting_stack_extension,
+      out_json_reader->_internal.options.nesting_stack_extension_size);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_reader_incremental_init(
+    az_json_reader* out_json_reader,
+    az_span buffer,
+    az_json_reader_options const* options)
+{
+  _az_PRECONDITION(az_span_size(buffer) >= 1);
+
+  // The reader starts with no JSON text, and reads the text fed to it as a single buffer.
+  *out_json_reader = (az_json_reader){
+    .token = (az_json_token){
+      .kind = AZ_JSON_TOKEN_NONE,
+      .slice = AZ_SPAN_EMPTY,
+      .size = 0,
+      ._internal = {
+        .is_multisegment = false,
+        .string_has_escaped_chars = false,
+        .pointer_to_first_buffer = &AZ_SPAN_EMPTY,
+        .start_buffer_index = -1,
+        .start_buffer_offset = -1,
+        .end_buffer_index = -1,
+        .end_buffer_offset = -1,
+      },
+    },
+    ._internal = {
+      .json_buffer = az_span_slice(buffer, 0, 0),
+      .json_buffers = &AZ_SPAN_EMPTY,
+      .number_of_buffers = 1,
+      .buffer_index = 0,
+      .bytes_consumed = 0,
+      .total_bytes_consumed = 0,
+      .is_complex_json = false,
+      .options = options == NULL ? az_json_reader_options_default() : *options,
+      .incremental_buffer = buffer,
+      .is_final_feed = false,
     },
   };
+
+  _az_json_stack_init(
+      &out_json_reader->_internal.bit_stack,
+      out_json_reader->_internal.options.nesting_stack_extension,
+      out_json_reader->_internal.options.nesting_stack_extension_size);
   return AZ_OK;
 }
 
@@ -108,6 +173,7 @@ static void _az_json_reader_update_state(
   ref_json_reader->_internal.bytes_consumed += current_segment_consumed;
   ref_json_reader->_internal.total_bytes_consumed += consumed;
 
+#ifndef AZ_NO_JSON_READER_CHUNKS
   // We should have already set start_buffer_index and offset before moving to the next buffer.
   ref_json_reader->token._internal.end_buffer_index = ref_json_reader->_internal.buffer_index;
   ref_json_reader->token._internal.end_buffer_offset = ref_json_reader->_internal.bytes_consumed;
@@ -120,6 +186,7 @@ static void _az_json_reader_update_state(
   {
     ref_json_reader->token._internal.is_multisegment = true;
   }
+#endif // AZ_NO_JSON_READER_CHUNKS
 
   ref_json_reader->token.slice = token_slice;
 }
@@ -129,6 +196,14 @@ AZ_NODISCARD static az_result _az_json_reader_get_next_buffer(
     az_span* remaining,
     bool skip_whitespace)
 {
+#ifdef AZ_NO_JSON_READER_CHUNKS
+  // There is never a next buffer, which lets the compiler drop the code handling it at the end of
+  // each buffer.
+  (void)ref_json_reader;
+  (void)remaining;
+  (void)skip_whitespace;
+  return AZ_ERROR_UNEXPECTED_END;
+#else
   // If we only had one buffer, or we ran out of the set of discontiguous buffers, return error.
   if (ref_json_reader->_internal.buffer_index >= ref_json_reader->_internal.number_of_buffers - 1)
   {
@@ -160,6 +235,33 @@ AZ_NODISCARD static az_result _az_json_reader_get_next_buffer(
 
   *remaining = place_holder;
   return AZ_OK;
+#endif // AZ_NO_JSON_READER_CHUNKS
+}
+
+AZ_NODISCARD az_result
+az_json_reader_feed(az_json_reader* ref_json_reader, az_span json_piece, bool is_final_piece)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+  _az_PRECONDITION(az_span_size(ref_json_reader->_internal.incremental_buffer) >= 1);
+  _az_PRECONDITION(!ref_json_reader->_internal.is_final_feed);
+
+  az_span const buffer = ref_json_reader->_internal.incremental_buffer;
+  az_span const remaining = _get_remaining_json(ref_json_reader);
+  int32_t const remaining_size = az_span_size(remaining);
+  if (remaining_size + az_span_size(json_piece) > az_span_size(buffer))
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  // Only the text left to read, typically the start of a token the previous piece ended within, is
+  // moved, the tokens read before it aren't needed anymore.
+  az_span const remainder = az_span_copy(az_span_copy(buffer, remaining), json_piece);
+
+  ref_json_reader->_internal.json_buffer
+      = az_span_slice(buffer, 0, az_span_size(buffer) - az_span_size(remainder));
+  ref_json_reader->_internal.bytes_consumed = 0;
+  ref_json_reader->_internal.is_final_feed = is_final_piece;
+  return AZ_OK;
 }
 
 AZ_NODISCARD static az_span _az_json_reader_skip_whitespace(az_json_reader* ref_json_reader)
@@ -211,9 +313,10 @@ AZ_NODISCARD static az_result _az_json_reader_process_container_start(
     az_json_token_kind token_kind,
     _az_json_stack_item container_kind)
 {
-  // The current depth is equal to or larger than the maximum allowed depth of 64. Cannot read the
-  // next JSON object or array.
-  if (ref_json_reader->_internal.bit_stack._internal.current_depth >= _az_MAX_JSON_STACK_SIZE)
+  // The current depth is equal to or larger than the maximum allowed depth of 64 (or more, with an
+  // extension of the stack). Cannot read the next JSON object or array.
+  if (ref_json_reader->_internal.bit_stack._internal.current_depth
+      >= _az_json_stack_max_depth(&ref_json_reader->_internal.bit_stack))
   {
     return AZ_ERROR_JSON_NESTING_OVERFLOW;
   }
@@ -243,6 +346,346 @@ AZ_NODISCARD static bool _az_is_valid_escaped_character(uint8_t byte)
   }
 }
 
+// Gets the number of continuation bytes following the UTF-8 lead byte `lead`, and the range of
+// the first of them (RFC 3629, section 4), which excludes the overlong encodings, the surrogates
+// and the code points past U+10FFFF. Returns -1 if `lead` can't start a sequence.
+AZ_NODISCARD static int32_t
+_az_json_utf8_get_continuation_count(uint8_t lead, uint8_t* out_min, uint8_t* out_max)
+{
+  *out_min = 0x80;
+  *out_max = 0xBF;
+
+  if (lead >= 0xC2 && lead <= 0xDF)
+  {
+    return 1;
+  }
+
+  if (lead >= 0xE0 && lead <= 0xEF)
+  {
+    *out_min = lead == 0xE0 ? 0xA0 : 0x80;
+    *out_max = lead == 0xED ? 0x9F : 0xBF;
+    return 2;
+  }
+
+  if (lead >= 0xF0 && lead <= 0xF4)
+  {
+    *out_min = lead == 0xF0 ? 0x90 : 0x80;
+    *out_max = lead == 0xF4 ? 0x8F : 0xBF;
+    return 3;
+  }
+
+  return -1;
+}
+
+#if defined(_az_SIMD_SSSE3) || (defined(_az_SIMD_NEON) && defined(__aarch64__))
+#define _az_JSON_UTF8_SIMD
+
+// The errors a pair of bytes can reveal, looked up from the high and low nibbles of the first byte
+// and the high nibble of the second one, as described by John Keiser and Daniel Lemire, "Validating
+// UTF-8 In Less Than One Instruction Per Byte" (2021). An error is set by all three lookups.
+#define _az_UTF8_TOO_SHORT 0x01 // A lead byte, not followed by a continuation byte.
+#define _az_UTF8_TOO_LONG 0x02 // A continuation byte, following an ASCII byte.
+#define _az_UTF8_OVERLONG_3 0x04 // 0xE0 followed by 0x80 to 0x9F.
+#define _az_UTF8_TOO_LARGE 0x08 // 0xF4 followed by 0x90 to 0xBF, or 0xF5 to 0xFF.
+#define _az_UTF8_SURROGATE 0x10 // 0xED followed by 0xA0 to 0xBF.
+#define _az_UTF8_OVERLONG_2 0x20 // 0xC0 or 0xC1.
+#define _az_UTF8_TOO_LARGE_1000 0x40 // 0xF5 to 0xFF followed by 0x80 to 0x8F.
+#define _az_UTF8_OVERLONG_4 0x40 // 0xF0 followed by 0x80 to 0x8F.
+#define _az_UTF8_TWO_CONTINUATIONS 0x80 // Two continuation bytes, checked against the lead bytes.
+#define _az_UTF8_CARRY (_az_UTF8_TOO_SHORT | _az_UTF8_TOO_LONG | _az_UTF8_TWO_CONTINUATIONS)
+
+static uint8_t const _az_json_utf8_byte_1_high[16] = {
+  _az_UTF8_TOO_LONG,
+  _az_UTF8_TOO_LONG,
+  _az_UTF8_TOO_LONG,
+  _az_UTF8_TOO_LONG,
+  _az_UTF8_TOO_LONG,
+  _az_UTF8_TOO_LONG,
+  _az_UTF8_TOO_LONG,
+  _az_UTF8_TOO_LONG,
+  _az_UTF8_TWO_CONTINUATIONS,
+  _az_UTF8_TWO_CONTINUATIONS,
+  _az_UTF8_TWO_CONTINUATIONS,
+  _az_UTF8_TWO_CONTINUATIONS,
+  _az_UTF8_TOO_SHORT | _az_UTF8_OVERLONG_2,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT | _az_UTF8_OVERLONG_3 | _az_UTF8_SURROGATE,
+  _az_UTF8_TOO_SHORT | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000 | _az_UTF8_OVERLONG_4,
+};
+
+static uint8_t const _az_json_utf8_byte_1_low[16] = {
+  _az_UTF8_CARRY | _az_UTF8_OVERLONG_3 | _az_UTF8_OVERLONG_2 | _az_UTF8_OVERLONG_4,
+  _az_UTF8_CARRY | _az_UTF8_OVERLONG_2,
+  _az_UTF8_CARRY,
+  _az_UTF8_CARRY,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000 | _az_UTF8_SURROGATE,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000,
+  _az_UTF8_CARRY | _az_UTF8_TOO_LARGE | _az_UTF8_TOO_LARGE_1000,
+};
+
+static uint8_t const _az_json_utf8_byte_2_high[16] = {
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_LONG | _az_UTF8_OVERLONG_2 | _az_UTF8_TWO_CONTINUATIONS | _az_UTF8_OVERLONG_3
+      | _az_UTF8_TOO_LARGE_1000 | _az_UTF8_OVERLONG_4,
+  _az_UTF8_TOO_LONG | _az_UTF8_OVERLONG_2 | _az_UTF8_TWO_CONTINUATIONS | _az_UTF8_OVERLONG_3
+      | _az_UTF8_TOO_LARGE,
+  _az_UTF8_TOO_LONG | _az_UTF8_OVERLONG_2 | _az_UTF8_TWO_CONTINUATIONS | _az_UTF8_SURROGATE
+      | _az_UTF8_TOO_LARGE,
+  _az_UTF8_TOO_LONG | _az_UTF8_OVERLONG_2 | _az_UTF8_TWO_CONTINUATIONS | _az_UTF8_SURROGATE
+      | _az_UTF8_TOO_LARGE,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT,
+  _az_UTF8_TOO_SHORT,
+};
+
+// A block ends within a sequence if one of its last three bytes is a lead byte needing more bytes
+// than remain, which is when it is greater than these.
+static uint8_t const _az_json_utf8_max_complete[16] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+#endif // _az_SIMD_SSSE3 || (_az_SIMD_NEON && __aarch64__)
+
+// Returns the index of the first byte of `ptr` at or after `index` which is a special string byte,
+// or which starts a UTF-8 sequence that is invalid or continues past `size`, or `size` if there is
+// none. Blocks of 16 bytes are validated at once when SIMD instructions are available, up to the
+// last one ending on a complete sequence, before the bytes left are validated one sequence at a
+// time.
+AZ_NODISCARD static int32_t
+_az_json_skip_valid_utf8_string_bytes(uint8_t const* ptr, int32_t index, int32_t size)
+{
+#if defined(_az_JSON_UTF8_SIMD) && defined(_az_SIMD_SSSE3)
+  {
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const max_control = _mm_set1_epi8(_az_ASCII_SPACE_CHARACTER - 1);
+    __m128i const low_nibble = _mm_set1_epi8(0x0F);
+    __m128i const high_bit = _mm_set1_epi8((char)0x80);
+    __m128i const third_byte_lead = _mm_set1_epi8(0xE0 - 0x80);
+    __m128i const fourth_byte_lead = _mm_set1_epi8(0xF0 - 0x80);
+    __m128i const byte_1_high
+        = _mm_loadu_si128((__m128i const*)(void const*)_az_json_utf8_byte_1_high);
+    __m128i const byte_1_low
+        = _mm_loadu_si128((__m128i const*)(void const*)_az_json_utf8_byte_1_low);
+    __m128i const byte_2_high
+        = _mm_loadu_si128((__m128i const*)(void const*)_az_json_utf8_byte_2_high);
+    __m128i const max_complete
+        = _mm_loadu_si128((__m128i const*)(void const*)_az_json_utf8_max_complete);
+    __m128i const zero = _mm_setzero_si128();
+
+    __m128i previous = zero;
+    int32_t valid_index = index;
+    for (; index + 16 <= size; index += 16)
+    {
+      __m128i const block = _mm_loadu_si128((__m128i const*)(void const*)(ptr + index));
+      __m128i const special = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)),
+          _mm_cmpeq_epi8(_mm_min_epu8(block, max_control), block));
+      if (_mm_movemask_epi8(special) != 0)
+      {
+        break;
+      }
+
+      if (_mm_movemask_epi8(block) == 0 && valid_index == index)
+      {
+        // ASCII, following a complete sequence.
+        previous = block;
+        valid_index = index + 16;
+        continue;
+      }
+
+      __m128i const previous_1 = _mm_alignr_epi8(block, previous, 15);
+      __m128i const special_cases = _mm_and_si128(
+          _mm_and_si128(
+              _mm_shuffle_epi8(
+                  byte_1_high, _mm_and_si128(_mm_srli_epi16(previous_1, 4), low_nibble)),
+              _mm_shuffle_epi8(byte_1_low, _mm_and_si128(previous_1, low_nibble))),
+          _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(block, 4), low_nibble)));
+
+      // The bytes which must be continuation bytes as the second or third one after a lead byte.
+      __m128i const must_be_continuation = _mm_and_si128(
+          _mm_or_si128(
+              _mm_subs_epu8(_mm_alignr_epi8(block, previous, 14), third_byte_lead),
+              _mm_subs_epu8(_mm_alignr_epi8(block, previous, 13), fourth_byte_lead)),
+          high_bit);
+
+      previous = block;
+      __m128i const error = _mm_xor_si128(must_be_continuation, special_cases);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) != 0xFFFF)
+      {
+        break;
+      }
+
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(block, max_complete), zero)) == 0xFFFF)
+      {
+        valid_index = index + 16;
+      }
+    }
+
+    index = valid_index;
+  }
+#elif defined(_az_JSON_UTF8_SIMD)
+  {
+    uint8x16_t const quote = vdupq_n_u8('"');
+    uint8x16_t const backslash = vdupq_n_u8('\\');
+    uint8x16_t const space = vdupq_n_u8(_az_ASCII_SPACE_CHARACTER);
+    uint8x16_t const low_nibble = vdupq_n_u8(0x0F);
+    uint8x16_t const high_bit = vdupq_n_u8(0x80);
+    uint8x16_t const third_byte_lead = vdupq_n_u8(0xE0 - 0x80);
+    uint8x16_t const fourth_byte_lead = vdupq_n_u8(0xF0 - 0x80);
+    uint8x16_t const byte_1_high = vld1q_u8(_az_json_utf8_byte_1_high);
+    uint8x16_t const byte_1_low = vld1q_u8(_az_json_utf8_byte_1_low);
+    uint8x16_t const byte_2_high = vld1q_u8(_az_json_utf8_byte_2_high);
+    uint8x16_t const max_complete = vld1q_u8(_az_json_utf8_max_complete);
+
+    uint8x16_t previous = vdupq_n_u8(0);
+    int32_t valid_index = index;
+    for (; index + 16 <= size; index += 16)
+    {
+      uint8x16_t const block = vld1q_u8(ptr + index);
+      uint8x16_t const special = vorrq_u8(
+          vorrq_u8(vceqq_u8(block, quote), vceqq_u8(block, backslash)), vcltq_u8(block, space));
+      if (vmaxvq_u8(special) != 0)
+      {
+        break;
+      }
+
+      if (vmaxvq_u8(block) < 0x80 && valid_index == index)
+      {
+        // ASCII, following a complete sequence.
+        previous = block;
+        valid_index = index + 16;
+        continue;
+      }
+
+      uint8x16_t const previous_1 = vextq_u8(previous, block, 15);
+      uint8x16_t const special_cases = vandq_u8(
+          vandq_u8(
+              vqtbl1q_u8(byte_1_high, vshrq_n_u8(previous_1, 4)),
+              vqtbl1q_u8(byte_1_low, vandq_u8(previous_1, low_nibble))),
+          vqtbl1q_u8(byte_2_high, vshrq_n_u8(block, 4)));
+
+      // The bytes which must be continuation bytes as the second or third one after a lead byte.
+      uint8x16_t const must_be_continuation = vandq_u8(
+          vorrq_u8(
+              vqsubq_u8(vextq_u8(previous, block, 14), third_byte_lead),
+              vqsubq_u8(vextq_u8(previous, block, 13), fourth_byte_lead)),
+          high_bit);
+
+      previous = block;
+      if (vmaxvq_u8(veorq_u8(must_be_continuation, special_cases)) != 0)
+      {
+        break;
+      }
+
+      if (vmaxvq_u8(vqsubq_u8(block, max_complete)) == 0)
+      {
+        valid_index = index + 16;
+      }
+    }
+
+    index = valid_index;
+  }
+#endif // _az_JSON_UTF8_SIMD
+
+  while (index < size)
+  {
+    uint8_t const byte = ptr[index];
+    if (byte < 0x80)
+    {
+      if (_az_json_is_special_string_byte(byte))
+      {
+        break;
+      }
+
+      index++;
+      continue;
+    }
+
+    uint8_t min = 0;
+    uint8_t max = 0;
+    int32_t const continuation_count = _az_json_utf8_get_continuation_count(byte, &min, &max);
+    if (continuation_count < 0 || index + continuation_count >= size)
+    {
+      break;
+    }
+
+    int32_t i = 1;
+    for (; i <= continuation_count && ptr[index + i] >= min && ptr[index + i] <= max; i++)
+    {
+      min = 0x80;
+      max = 0xBF;
+    }
+
+    if (i <= continuation_count)
+    {
+      break;
+    }
+
+    index += continuation_count + 1;
+  }
+
+  return index;
+}
+
+// Validates the UTF-8 sequence starting at `*ref_index` of the token, which
+// _az_json_skip_valid_utf8_string_bytes() stopped at, either because it is invalid or because it
+// continues in the next buffer. Leaves `*ref_index` at the last byte of the sequence.
+AZ_NODISCARD static az_result _az_json_reader_process_utf8_sequence(
+    az_json_reader* ref_json_reader,
+    az_span* ref_token,
+    int32_t* ref_index,
+    int32_t* ref_string_length)
+{
+  uint8_t min = 0;
+  uint8_t max = 0;
+  int32_t const continuation_count
+      = _az_json_utf8_get_continuation_count(az_span_ptr(*ref_token)[*ref_index], &min, &max);
+  if (continuation_count < 0)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  for (int32_t i = 0; i < continuation_count; i++)
+  {
+    (*ref_index)++;
+    (*ref_string_length)++;
+    if (*ref_index >= az_span_size(*ref_token))
+    {
+      _az_RETURN_IF_FAILED(_az_json_reader_get_next_buffer(ref_json_reader, ref_token, false));
+      *ref_index = 0;
+    }
+
+    uint8_t const next_byte = az_span_ptr(*ref_token)[*ref_index];
+    if (next_byte < min || next_byte > max)
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+
+    min = 0x80;
+    max = 0xBF;
+  }
+
+  return AZ_OK;
+}
+
 AZ_NODISCARD static az_result _az_json_reader_process_string(az_json_reader* ref_json_reader)
 {
   // Move past the first '"' character
@@ -262,17 +705,48 @@ AZ_NODISCARD static az_result _az_json_reader_process_string(az_json_reader* ref
   uint8_t* token_ptr = az_span_ptr(token);
   uint8_t next_byte = token_ptr[0];
 
+  bool const validate_utf8 = ref_json_reader->_internal.options.validate_utf8;
+
   // Clear the state of any previous string token.
   ref_json_reader->token._internal.string_has_escaped_chars = false;
 
   while (true)
   {
-    if (next_byte == '"')
+    if (!_az_json_is_special_string_byte(next_byte))
+    {
+      // Fast path: skip the run of bytes that don't need any validation, or that are valid UTF-8,
+      // within the current buffer, at once.
+      int32_t const special_index = validate_utf8
+          ? _az_json_skip_valid_utf8_string_bytes(token_ptr, current_index, remaining_size)
+          : _az_json_skip_plain_string_bytes(token_ptr, current_index + 1, remaining_size);
+
+      if (special_index > current_index)
+      {
+        string_length += special_index - current_index;
+        current_index = special_index;
+
+        if (current_index >= remaining_size)
+        {
+          _az_RETURN_IF_FAILED(_az_json_reader_get_next_buffer(ref_json_reader, &token, false));
+          current_index = 0;
+          token_ptr = az_span_ptr(token);
+          remaining_size = az_span_size(token);
+        }
+        next_byte = token_ptr[current_index];
+        continue;
+      }
+
+      // A UTF-8 sequence which is invalid, or which continues in the next buffer.
+      _az_RETURN_IF_FAILED(_az_json_reader_process_utf8_sequence(
+          ref_json_reader, &token, &current_index, &string_length));
+      token_ptr = az_span_ptr(token);
+      remaining_size = az_span_size(token);
+    }
+    else if (next_byte == '"')
     {
       break;
     }
-
-    if (next_byte == '\\')
+    else if (next_byte == '\\')
     {
       ref_json_reader->token._internal.string_has_escaped_chars = true;
       current_index++;
@@ -381,6 +855,17 @@ AZ_NODISCARD static az_result _az_json_reader_process_property_name(az_json_read
   // in _az_json_reader_process_string when processing the string portion of the property name.
   // Therefore, we don't call _az_json_reader_update_state here.
   ref_json_reader->token.kind = AZ_JSON_TOKEN_PROPERTY_NAME;
+
+  // Record the hash of the name while its bytes are still hot in the cache, so that matching it
+  // against a table of names rarely needs to compare the text. Names with escaped characters, or
+  // straddling non-contiguous buffers, are always compared instead.
+  if (!ref_json_reader->token._internal.string_has_escaped_chars
+      && !ref_json_reader->token._internal.is_multisegment)
+  {
+    ref_json_reader->token._internal.property_name_hash
+        = _az_json_property_name_hash(ref_json_reader->token.slice);
+  }
+
   ref_json_reader->_internal.bytes_consumed++; // For the name / value separator
   ref_json_reader->_internal.total_bytes_consumed++; // For the name / value separator
 
@@ -421,12 +906,50 @@ AZ_NODISCARD static bool _az_finished_consuming_json_number(
   return false;
 }
 
+// Loads 8 bytes in little-endian order, so that the first byte ends up in the least significant
+// position, regardless of the endianness of the platform.
+AZ_NODISCARD AZ_INLINE uint64_t _az_json_load_eight_bytes(uint8_t const* ptr)
+{
+  uint64_t value = 0;
+  for (int32_t i = 7; i >= 0; i--)
+  {
+    value = (value << 8U) | ptr[i];
+  }
+  return value;
+}
+
+// Returns true if all the bytes loaded by _az_json_load_eight_bytes() are within '0' and '9'.
+AZ_NODISCARD AZ_INLINE bool _az_json_is_eight_digits(uint64_t eight_bytes)
+{
+  // Once every high nibble is 3, adding 6 to each byte can't carry over to the next one, and it
+  // keeps the high nibble at 3 only for the bytes that are less than or equal to '9'.
+  return (eight_bytes & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL
+      && ((eight_bytes + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL;
+}
+
+// Converts the 8 digits loaded by _az_json_load_eight_bytes() into their value, combining adjacent
+// pairs of digits, then of 2-digit and of 4-digit values.
+AZ_NODISCARD AZ_INLINE uint64_t _az_json_parse_eight_digits(uint64_t eight_bytes)
+{
+  eight_bytes -= 0x3030303030303030ULL;
+  eight_bytes = (eight_bytes * 10 + (eight_bytes >> 8U)) & 0x00FF00FF00FF00FFULL;
+  eight_bytes = (eight_bytes * 100 + (eight_bytes >> 16U)) & 0x0000FFFF0000FFFFULL;
+  return (eight_bytes * 10000 + (eight_bytes >> 32U)) & 0x00000000FFFFFFFFULL;
+}
+
+// Consumes a run of digits, potentially straddling multiple buffers.
+// If ref_integer_value is not NULL, the value of the digits is accumulated into it, and
+// ref_is_integer is set to false if that value overflows a uint64_t.
 static void _az_json_reader_consume_digits(
     az_json_reader* ref_json_reader,
     az_span* token,
     int32_t* current_consumed,
-    int32_t* total_consumed)
+    int32_t* total_consumed,
+    uint64_t* ref_integer_value,
+    bool* ref_is_integer)
 {
+  uint64_t const eight_digits_multiplier = 100000000;
+
   int32_t counter = 0;
   az_span current = az_span_slice_to_end(*token, *current_consumed);
   while (true)
@@ -434,10 +957,43 @@ static void _az_json_reader_consume_digits(
     int32_t const token_size = az_span_size(current);
     uint8_t* next_byte_ptr = az_span_ptr(current);
 
+    // Fast path, validating (and if needed, converting) 8 digits at a time.
+    while (counter + 8 <= token_size)
+    {
+      uint64_t const eight_bytes = _az_json_load_eight_bytes(next_byte_ptr);
+      if (!_az_json_is_eight_digits(eight_bytes))
+      {
+        break;
+      }
+
+      if (ref_integer_value != NULL)
+      {
+        uint64_t const value = _az_json_parse_eight_digits(eight_bytes);
+        if ((UINT64_MAX - value) / eight_digits_multiplier < *ref_integer_value)
+        {
+          *ref_is_integer = false;
+        }
+        *ref_integer_value = *ref_integer_value * eight_digits_multiplier + value;
+      }
+
+      counter += 8;
+      next_byte_ptr += 8;
+    }
+
     while (counter < token_size)
     {
       if (isdigit(*next_byte_ptr))
       {
+        if (ref_integer_value != NULL)
+        {
+          uint64_t const d = (uint64_t)*next_byte_ptr - '0';
+          if ((UINT64_MAX - d) / _az_NUMBER_OF_DECIMAL_VALUES < *ref_integer_value)
+          {
+            *ref_is_integer = false;
+          }
+          *ref_integer_value = *ref_integer_value * _az_NUMBER_OF_DECIMAL_VALUES + d;
+        }
+
         counter++;
         next_byte_ptr++;
       }
@@ -468,7 +1024,10 @@ AZ_NODISCARD static az_result _az_json_reader_update_number_state_if_single_valu
     int32_t current_consumed,
     int32_t total_consumed)
 {
-  if (ref_json_reader->_internal.is_complex_json)
+  // More digits may still be fed to an incremental reader.
+  if (ref_json_reader->_internal.is_complex_json
+      || (az_span_size(ref_json_reader->_internal.incremental_buffer) > 0
+          && !ref_json_reader->_internal.is_final_feed))
   {
     return AZ_ERROR_UNEXPECTED_END;
   }
@@ -500,7 +1059,13 @@ AZ_NODISCARD static az_result _az_validate_next_byte_is_digit(
   return AZ_OK;
 }
 
-AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* ref_json_reader)
+// Consumes a JSON number, recording whether it is an integer (without a fraction or exponent) that
+// fits within a uint64_t, along with its sign and absolute value.
+AZ_NODISCARD static az_result _az_json_reader_consume_number(
+    az_json_reader* ref_json_reader,
+    bool* ref_is_integer,
+    bool* ref_is_negative,
+    uint64_t* ref_integer_value)
 {
   az_span token = _get_remaining_json(ref_json_reader);
 
@@ -510,6 +1075,7 @@ AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* ref
   uint8_t next_byte = az_span_ptr(token)[0];
   if (next_byte == '-')
   {
+    *ref_is_negative = true;
     total_consumed++;
     current_consumed++;
 
@@ -562,7 +1128,13 @@ AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* ref
     _az_PRECONDITION(isdigit(next_byte));
 
     // Integer part before decimal
-    _az_json_reader_consume_digits(ref_json_reader, &token, &current_consumed, &total_consumed);
+    _az_json_reader_consume_digits(
+        ref_json_reader,
+        &token,
+        &current_consumed,
+        &total_consumed,
+        ref_integer_value,
+        ref_is_integer);
 
     if (current_consumed >= az_span_size(token))
     {
@@ -597,6 +1169,8 @@ AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* ref
     }
   }
 
+  *ref_is_integer = false;
+
   if (next_byte == '.')
   {
     total_consumed++;
@@ -607,7 +1181,8 @@ AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* ref
         _az_validate_next_byte_is_digit(ref_json_reader, &token, &current_consumed));
 
     // Integer part after decimal
-    _az_json_reader_consume_digits(ref_json_reader, &token, &current_consumed, &total_consumed);
+    _az_json_reader_consume_digits(
+        ref_json_reader, &token, &current_consumed, &total_consumed, NULL, NULL);
 
     if (current_consumed >= az_span_size(token))
     {
@@ -665,7 +1240,8 @@ AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* ref
   }
 
   // Integer part after the 'e'/'E'
-  _az_json_reader_consume_digits(ref_json_reader, &token, &current_consumed, &total_consumed);
+  _az_json_reader_consume_digits(
+      ref_json_reader, &token, &current_consumed, &total_consumed, NULL, NULL);
 
   if (current_consumed >= az_span_size(token))
   {
@@ -702,6 +1278,23 @@ AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* ref
   return AZ_OK;
 }
 
+AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* ref_json_reader)
+{
+  bool is_integer = true;
+  bool is_negative = false;
+  uint64_t integer_value = 0;
+
+  _az_RETURN_IF_FAILED(
+      _az_json_reader_consume_number(ref_json_reader, &is_integer, &is_negative, &integer_value));
+
+  // Record the value of integers so that the token getters don't need to parse them again.
+  ref_json_reader->token._internal.number_is_integer = is_integer;
+  ref_json_reader->token._internal.number_is_negative = is_negative;
+  ref_json_reader->token._internal.number_magnitude = integer_value;
+
+  return AZ_OK;
+}
+
 AZ_INLINE int32_t _az_min(int32_t a, int32_t b) { return a < b ? a : b; }
 
 AZ_NODISCARD static az_result _az_json_reader_process_literal(
@@ -877,10 +1470,8 @@ AZ_NODISCARD static az_result _az_json_reader_process_next_byte(
   return AZ_ERROR_UNEXPECTED_CHAR;
 }
 
-AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader)
+AZ_NODISCARD static az_result _az_json_reader_read_next_token(az_json_reader* ref_json_reader)
 {
-  _az_PRECONDITION_NOT_NULL(ref_json_reader);
-
   az_span json = _az_json_reader_skip_whitespace(ref_json_reader);
 
   if (az_span_size(json) < 1)
@@ -892,15 +1483,25 @@ AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader
       return AZ_ERROR_UNEXPECTED_END;
     }
 
+    // More text may still be fed to an incremental reader, which must then be checked for
+    // characters after the root value.
+    if (az_span_size(ref_json_reader->_internal.incremental_buffer) > 0
+        && !ref_json_reader->_internal.is_final_feed)
+    {
+      return AZ_ERROR_UNEXPECTED_END;
+    }
+
     // No more JSON text left to process, we are done.
     return AZ_ERROR_JSON_READER_DONE;
   }
 
+#ifndef AZ_NO_JSON_READER_CHUNKS
   // Clear the internal state of any previous token.
   ref_json_reader->token._internal.start_buffer_index = -1;
   ref_json_reader->token._internal.start_buffer_offset = -1;
   ref_json_reader->token._internal.end_buffer_index = -1;
   ref_json_reader->token._internal.end_buffer_offset = -1;
+#endif // AZ_NO_JSON_READER_CHUNKS
 
   uint8_t const first_byte = az_span_ptr(json)[0];
 
@@ -949,24 +1550,262 @@ AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader
   }
 }
 
-AZ_NODISCARD az_result az_json_reader_skip_children(az_json_reader* ref_json_reader)
+// The state of the search for the end of a container, skipped without validating its content.
+typedef struct
 {
-  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+  int32_t depth;
+  bool in_string;
+  bool escaped;
+} _az_json_skip_state;
+
+// Returns the index of the byte of `ptr` closing the container, between `index` and `size`, or -1
+// if there is none.
+AZ_NODISCARD static int32_t _az_json_skip_scan_bytes(
+    _az_json_skip_state* ref_state,
+    uint8_t const* ptr,
+    int32_t index,
+    int32_t size)
+{
+  for (; index < size; index++)
+  {
+    uint8_t const byte = ptr[index];
+    if (ref_state->in_string)
+    {
+      if (ref_state->escaped)
+      {
+        ref_state->escaped = false;
+      }
+      else if (byte == '\\')
+      {
+        ref_state->escaped = true;
+      }
+      else if (byte == '"')
+      {
+        ref_state->in_string = false;
+      }
+    }
+    else if (byte == '"')
+    {
+      ref_state->in_string = true;
+    }
+    else if (byte == '{' || byte == '[')
+    {
+      ref_state->depth++;
+    }
+    else if (byte == '}' || byte == ']')
+    {
+      ref_state->depth--;
+      if (ref_state->depth == 0)
+      {
+        return index;
+      }
+    }
+  }
+  return -1;
+}
+
+#if defined(_az_SIMD_AVX2)
+#define _az_JSON_SKIP_BLOCK_SIZE 32
+#define _az_JSON_SKIP_LANE_BITS 1
+#define _az_JSON_SKIP_ALL_LANES 0xFFFFFFFFULL
+#elif defined(_az_SIMD_SSE2)
+#define _az_JSON_SKIP_BLOCK_SIZE 16
+#define _az_JSON_SKIP_LANE_BITS 1
+#define _az_JSON_SKIP_ALL_LANES 0xFFFFULL
+#elif defined(_az_SIMD_NEON)
+// Each lane of a NEON mask is 4 bits wide, see _az_simd_neon_mask().
+#define _az_JSON_SKIP_BLOCK_SIZE 16
+#define _az_JSON_SKIP_LANE_BITS 4
+#define _az_JSON_SKIP_ALL_LANES UINT64_MAX
+#endif
+
+// Returns the index of the byte of `ptr` closing the container, or -1 if there is none.
+// Like simdjson, blocks of bytes are classified at once: the quotes toggle whether the following
+// bytes are within a string, and the brackets outside of the strings change the depth. The rare
+// blocks containing backslashes, or possibly the end of the container, are scanned byte by byte.
+AZ_NODISCARD static int32_t
+_az_json_skip_scan(_az_json_skip_state* ref_state, uint8_t const* ptr, int32_t size)
+{
+  int32_t index = 0;
+
+#if defined(_az_JSON_SKIP_BLOCK_SIZE)
+  for (; index + _az_JSON_SKIP_BLOCK_SIZE <= size; index += _az_JSON_SKIP_BLOCK_SIZE)
+  {
+    // As 0x20 is the only bit by which '{' and '[', and '}' and ']', differ, setting it in each
+    // byte finds both brackets with a single comparison.
+#if defined(_az_SIMD_AVX2)
+    __m256i const block = _mm256_loadu_si256((__m256i const*)(void const*)(ptr + index));
+    __m256i const folded = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+    uint64_t const quotes
+        = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('"')));
+    uint64_t const backslashes
+        = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\')));
+    uint64_t opens
+        = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')));
+    uint64_t closes
+        = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+#elif defined(_az_SIMD_SSE2)
+    __m128i const block = _mm_loadu_si128((__m128i const*)(void const*)(ptr + index));
+    __m128i const folded = _mm_or_si128(block, _mm_set1_epi8(0x20));
+    uint64_t const quotes = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')));
+    uint64_t const backslashes
+        = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+    uint64_t opens = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')));
+    uint64_t closes = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+#else
+    uint8x16_t const block = vld1q_u8(ptr + index);
+    uint8x16_t const folded = vorrq_u8(block, vdupq_n_u8(0x20));
+    uint64_t const quotes = _az_simd_neon_mask(vceqq_u8(block, vdupq_n_u8('"')));
+    uint64_t const backslashes = _az_simd_neon_mask(vceqq_u8(block, vdupq_n_u8('\\')));
+    uint64_t opens = _az_simd_neon_mask(vceqq_u8(folded, vdupq_n_u8('{')));
+    uint64_t closes = _az_simd_neon_mask(vceqq_u8(folded, vdupq_n_u8('}')));
+#endif
+
+    if (backslashes != 0 || ref_state->escaped)
+    {
+      int32_t const end_index
+          = _az_json_skip_scan_bytes(ref_state, ptr, index, index + _az_JSON_SKIP_BLOCK_SIZE);
+      if (end_index != -1)
+      {
+        return end_index;
+      }
+      continue;
+    }
+
+    // Each lane is within a string if it follows an odd number of quotes, counting the quote in
+    // that lane, and the string the previous block ended within, if any.
+    uint64_t in_string = quotes;
+    for (uint32_t shift = _az_JSON_SKIP_LANE_BITS;
+         shift < _az_JSON_SKIP_BLOCK_SIZE * _az_JSON_SKIP_LANE_BITS;
+         shift <<= 1U)
+    {
+      in_string ^= in_string << shift;
+    }
+    if (ref_state->in_string)
+    {
+      in_string = ~in_string;
+    }
+    in_string &= _az_JSON_SKIP_ALL_LANES;
+
+    opens &= ~in_string;
+    closes &= ~in_string;
+    int32_t const close_count = _az_simd_bit_count(closes) / _az_JSON_SKIP_LANE_BITS;
+    if (close_count >= ref_state->depth)
+    {
+      // The container may end within this block.
+      int32_t const end_index
+          = _az_json_skip_scan_bytes(ref_state, ptr, index, index + _az_JSON_SKIP_BLOCK_SIZE);
+      if (end_index != -1)
+      {
+        return end_index;
+      }
+      continue;
+    }
+
+    ref_state->depth += _az_simd_bit_count(opens) / _az_JSON_SKIP_LANE_BITS - close_count;
+    ref_state->in_string
+        = (in_string >> (_az_JSON_SKIP_BLOCK_SIZE * _az_JSON_SKIP_LANE_BITS - 1U)) != 0;
+  }
+#endif // _az_JSON_SKIP_BLOCK_SIZE
+
+  return _az_json_skip_scan_bytes(ref_state, ptr, index, size);
+}
+
+// Moves the reader from the start of an object or array to its end, without validating the JSON
+// in between.
+AZ_NODISCARD static az_result _az_json_reader_skip_container(az_json_reader* ref_json_reader)
+{
+  _az_json_skip_state state = { .depth = 1, .in_string = false, .escaped = false };
+  az_span remaining = _get_remaining_json(ref_json_reader);
+
+  while (true)
+  {
+    int32_t const size = az_span_size(remaining);
+    int32_t const end_index = _az_json_skip_scan(&state, az_span_ptr(remaining), size);
+    if (end_index != -1)
+    {
+      ref_json_reader->_internal.bytes_consumed += end_index;
+      ref_json_reader->_internal.total_bytes_consumed += end_index;
+      break;
+    }
 
+    ref_json_reader->_internal.bytes_consumed += size;
+    ref_json_reader->_internal.total_bytes_consumed += size;
+    _az_RETURN_IF_FAILED(_az_json_reader_get_next_buffer(ref_json_reader, &remaining, true));
+  }
+
+  az_span const token = _get_remaining_json(ref_json_reader);
+  az_json_token_kind const token_kind
+      = az_span_ptr(token)[0] == '}' ? AZ_JSON_TOKEN_END_OBJECT : AZ_JSON_TOKEN_END_ARRAY;
+
+#ifndef AZ_NO_JSON_READER_CHUNKS
+  ref_json_reader->token._internal.start_buffer_index = -1;
+  ref_json_reader->token._internal.start_buffer_offset = -1;
+#endif // AZ_NO_JSON_READER_CHUNKS
+
+  _az_json_stack_pop(&ref_json_reader->_internal.bit_stack);
+  _az_json_reader_update_state(ref_json_reader, token_kind, az_span_slice(token, 0, 1), 1, 1);
+  return AZ_OK;
+}
+
+AZ_NODISCARD static az_result _az_json_reader_skip_children(az_json_reader* ref_json_reader)
+{
   if (ref_json_reader->token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
   {
-    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+    _az_RETURN_IF_FAILED(_az_json_reader_read_next_token(ref_json_reader));
   }
 
   az_json_token_kind const token_kind = ref_json_reader->token.kind;
   if (token_kind == AZ_JSON_TOKEN_BEGIN_OBJECT || token_kind == AZ_JSON_TOKEN_BEGIN_ARRAY)
   {
+    if (ref_json_reader->_internal.options.skip_children_without_validation)
+    {
+      return _az_json_reader_skip_container(ref_json_reader);
+    }
+
     // Keep moving the reader until we come back to the same depth.
     int32_t const depth = ref_json_reader->_internal.bit_stack._internal.current_depth;
     do
     {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+      _az_RETURN_IF_FAILED(_az_json_reader_read_next_token(ref_json_reader));
     } while (depth <= ref_json_reader->_internal.bit_stack._internal.current_depth);
   }
   return AZ_OK;
 }
+
+// Reads with the read function. When the JSON text fed to an incremental reader so far ends within
+// what is read, the reader is moved back to where it was, for the read to be repeated once more of
+// the text is fed.
+AZ_NODISCARD static az_result _az_json_reader_read_or_rewind(
+    az_json_reader* ref_json_reader,
+    az_result (*read)(az_json_reader*))
+{
+  if (az_span_size(ref_json_reader->_internal.incremental_buffer) == 0)
+  {
+    return read(ref_json_reader);
+  }
+
+  az_json_reader const previous_json_reader = *ref_json_reader;
+  az_result const result = read(ref_json_reader);
+  if (result == AZ_ERROR_UNEXPECTED_END && !ref_json_reader->_internal.is_final_feed)
+  {
+    *ref_json_reader = previous_json_reader;
+    return AZ_ERROR_JSON_READER_NEED_MORE_DATA;
+  }
+
+  return result;
+}
+
+AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+
+  return _az_json_reader_read_or_rewind(ref_json_reader, _az_json_reader_read_next_token);
+}
+
+AZ_NODISCARD az_result az_json_reader_skip_children(az_json_reader* ref_json_reader)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+
+  return _az_json_reader_read_or_rewind(ref_json_reader, _az_json_reader_skip_children);
+}
@@ -0,0 +1,181 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_json_private.h"
+#include <azure/core/az_json.h>
+#include <azure/core/az_precondition.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+
+#include <azure/core/_az_cfg.h>
+
+// Sets the next index of the property name the value ending at value_end_index belongs to, if any.
+static void _az_json_tape_end_value(
+    az_json_tape_entry* entries,
+    int32_t value_start_index,
+    int32_t value_end_index)
+{
+  if (value_start_index > 0
+      && entries[value_start_index - 1]._internal.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    entries[value_start_index - 1]._internal.next = value_end_index + 1;
+  }
+}
+
+AZ_NODISCARD az_result az_json_tape_init(
+    az_json_tape* out_json_tape,
+    az_span json_buffer,
+    az_json_tape_entry* entries,
+    int32_t entries_size,
+    az_json_reader_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(out_json_tape);
+  _az_PRECONDITION(az_span_size(json_buffer) >= 1);
+  _az_PRECONDITION(entries_size >= 0);
+  _az_PRECONDITION(entries != NULL || entries_size == 0);
+
+  *out_json_tape = (az_json_tape){
+    ._internal = {
+      .json = json_buffer,
+      .entries = entries,
+      .count = 0,
+    },
+  };
+
+  az_json_reader reader = { 0 };
+  _az_RETURN_IF_FAILED(az_json_reader_init(&reader, json_buffer, options));
+
+  // The objects and arrays not ended yet are linked through the next index of their first entry,
+  // from the innermost one, until their end sets it.
+  int32_t innermost_container_index = -1;
+  int32_t count = 0;
+
+  az_result result = AZ_OK;
+  while (az_result_succeeded(result = az_json_reader_next_token(&reader)))
+  {
+    if (count == entries_size)
+    {
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+
+    az_json_token_kind const kind = reader.token.kind;
+    az_json_tape_entry* const entry = &entries[count];
+    entry->_internal.offset = (int32_t)(az_span_ptr(reader.token.slice) - az_span_ptr(json_buffer));
+    entry->_internal.size = az_span_size(reader.token.slice);
+    entry->_internal.next = count + 1;
+    entry->_internal.kind = (uint8_t)kind;
+    entry->_internal.string_has_escaped_chars = reader.token._internal.string_has_escaped_chars;
+
+    switch (kind)
+    {
+      case AZ_JSON_TOKEN_BEGIN_OBJECT:
+      case AZ_JSON_TOKEN_BEGIN_ARRAY:
+        entry->_internal.next = innermost_container_index;
+        innermost_container_index = count;
+        break;
+      case AZ_JSON_TOKEN_END_OBJECT:
+      case AZ_JSON_TOKEN_END_ARRAY:
+      {
+        int32_t const start_index = innermost_container_index;
+        innermost_container_index = entries[start_index]._internal.next;
+        entries[start_index]._internal.next = count + 1;
+        _az_json_tape_end_value(entries, start_index, count);
+        break;
+      }
+      case AZ_JSON_TOKEN_PROPERTY_NAME:
+        break;
+      default:
+        _az_json_tape_end_value(entries, count, count);
+        break;
+    }
+
+    count++;
+  }
+
+  if (result != AZ_ERROR_JSON_READER_DONE)
+  {
+    return result;
+  }
+
+  out_json_tape->_internal.count = count;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_json_token az_json_tape_get_token(az_json_tape const* json_tape, int32_t index)
+{
+  _az_PRECONDITION_NOT_NULL(json_tape);
+  _az_PRECONDITION_RANGE(0, index, json_tape->_internal.count - 1);
+
+  az_json_tape_entry const* const entry = &json_tape->_internal.entries[index];
+  az_span const slice = az_span_slice(
+      json_tape->_internal.json,
+      entry->_internal.offset,
+      entry->_internal.offset + entry->_internal.size);
+
+  // The hash isn't worth storing in every entry, and is only needed for property names.
+  uint32_t property_name_hash = 0;
+  if (entry->_internal.kind == AZ_JSON_TOKEN_PROPERTY_NAME
+      && !entry->_internal.string_has_escaped_chars)
+  {
+    property_name_hash = _az_json_property_name_hash(slice);
+  }
+
+  return (az_json_token){
+    .kind = (az_json_token_kind)entry->_internal.kind,
+    .slice = slice,
+    .size = entry->_internal.size,
+    ._internal = {
+      .is_multisegment = false,
+      .string_has_escaped_chars = entry->_internal.string_has_escaped_chars,
+      .property_name_hash = property_name_hash,
+      .pointer_to_first_buffer = &AZ_SPAN_EMPTY,
+      .start_buffer_index = -1,
+      .start_buffer_offset = -1,
+      .end_buffer_index = -1,
+      .end_buffer_offset = -1,
+    },
+  };
+}
+
+AZ_NODISCARD int32_t
+az_json_tape_find_property(az_json_tape const* json_tape, int32_t object_index, az_span name)
+{
+  _az_PRECONDITION_NOT_NULL(json_tape);
+  _az_PRECONDITION_RANGE(0, object_index, json_tape->_internal.count - 1);
+  _az_PRECONDITION(
+      json_tape->_internal.entries[object_index]._internal.kind == AZ_JSON_TOKEN_BEGIN_OBJECT);
+  _az_PRECONDITION_VALID_SPAN(name, 0, true);
+
+  az_json_tape_entry const* const entries = json_tape->_internal.entries;
+
+  // Within an object, each property name is followed by the next one, or the end of the object.
+  int32_t index = object_index + 1;
+  while (entries[index]._internal.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    az_json_tape_entry const* const entry = &entries[index];
+    bool is_equal;
+    if (entry->_internal.string_has_escaped_chars)
+    {
+      az_json_token const token = az_json_tape_get_token(json_tape, index);
+      is_equal = az_json_token_is_text_equal(&token, name);
+    }
+    else
+    {
+      is_equal = az_span_is_content_equal(
+          az_span_slice(
+              json_tape->_internal.json,
+              entry->_internal.offset,
+              entry->_internal.offset + entry->_internal.size),
+          name);
+    }
+
+    if (is_equal)
+    {
+      return index + 1;
+    }
+    index = entry->_internal.next;
+  }
+
+  return -1;
+}
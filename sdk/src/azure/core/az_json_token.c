@@ -5,11 +5,33 @@
 #include <azure/core/internal/az_result_internal.h>
 #include <azure/core/internal/az_span_internal.h>
 
+#include "az_hex_private.h"
 #include "az_json_private.h"
 
 #include "az_span_private.h"
+
+#include <ctype.h>
+#include <string.h>
+
 #include <azure/core/_az_cfg.h>
 
+// Gets the part of the token within the buffer at the given index, for tokens straddling
+// non-contiguous buffers.
+AZ_NODISCARD static az_span
+_az_json_token_get_segment(az_json_token const* json_token, int32_t index)
+{
+  az_span segment = json_token->_internal.pointer_to_first_buffer[index];
+  if (index == json_token->_internal.start_buffer_index)
+  {
+    return az_span_slice_to_end(segment, json_token->_internal.start_buffer_offset);
+  }
+  if (index == json_token->_internal.end_buffer_index)
+  {
+    return az_span_slice(segment, 0, json_token->_internal.end_buffer_offset);
+  }
+  return segment;
+}
+
 static az_span _az_json_token_copy_into_span_helper(
     az_json_token const* json_token,
     az_span destination)
@@ -25,15 +47,7 @@ static az_span _az_json_token_copy_into_span_helper(
        i <= json_token->_internal.end_buffer_index;
        i++)
   {
-    az_span source = json_token->_internal.pointer_to_first_buffer[i];
-    if (i == json_token->_internal.start_buffer_index)
-    {
-      source = az_span_slice_to_end(source, json_token->_internal.start_buffer_offset);
-    }
-    else if (i == json_token->_internal.end_buffer_index)
-    {
-      source = az_span_slice(source, 0, json_token->_internal.end_buffer_offset);
-    }
+    az_span const source = _az_json_token_get_segment(json_token, i);
     destination = az_span_copy(destination, source);
   }
 
@@ -176,15 +190,7 @@ AZ_NODISCARD bool az_json_token_is_text_equal(
          i <= json_token->_internal.end_buffer_index;
          i++)
     {
-      az_span source = json_token->_internal.pointer_to_first_buffer[i];
-      if (i == json_token->_internal.start_buffer_index)
-      {
-        source = az_span_slice_to_end(source, json_token->_internal.start_buffer_offset);
-      }
-      else if (i == json_token->_internal.end_buffer_index)
-      {
-        source = az_span_slice(source, 0, json_token->_internal.end_buffer_offset);
-      }
+      az_span const source = _az_json_token_get_segment(json_token, i);
 
       int32_t source_size = az_span_size(source);
       if (az_span_size(expected_text) < source_size
@@ -222,15 +228,7 @@ AZ_NODISCARD bool az_json_token_is_text_equal(
        i <= json_token->_internal.end_buffer_index;
        i++)
   {
-    az_span source = json_token->_internal.pointer_to_first_buffer[i];
-    if (i == json_token->_internal.start_buffer_index)
-    {
-      source = az_span_slice_to_end(source, json_token->_internal.start_buffer_offset);
-    }
-    else if (i == json_token->_internal.end_buffer_index)
-    {
-      source = az_span_slice(source, 0, json_token->_internal.end_buffer_offset);
-    }
+    az_span const source = _az_json_token_get_segment(json_token, i);
 
     if (!_az_json_token_is_text_equal_helper(source, &expected_text, &next_char_escaped)
         && az_span_size(expected_text) == 0)
@@ -243,6 +241,93 @@ AZ_NODISCARD bool az_json_token_is_text_equal(
   return az_span_size(expected_text) == 0;
 }
 
+AZ_NODISCARD uint32_t az_json_property_name_hash(az_span name)
+{
+  _az_PRECONDITION_VALID_SPAN(name, 0, true);
+
+  return _az_json_property_name_hash(name);
+}
+
+AZ_NODISCARD az_result
+az_json_token_get_property_name_hash(az_json_token const* json_token, uint32_t* out_hash)
+{
+  _az_PRECONDITION_NOT_NULL(json_token);
+  _az_PRECONDITION_NOT_NULL(out_hash);
+
+  if (json_token->kind != AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    return AZ_ERROR_JSON_INVALID_STATE;
+  }
+
+  if (json_token->_internal.string_has_escaped_chars || json_token->_internal.is_multisegment)
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  *out_hash = json_token->_internal.property_name_hash;
+  return AZ_OK;
+}
+
+void az_json_property_name_table_init(
+    az_json_property_name_table* out_table,
+    az_span const names[],
+    uint32_t hashes[],
+    int32_t size)
+{
+  _az_PRECONDITION_NOT_NULL(out_table);
+  _az_PRECONDITION(size >= 0);
+  _az_PRECONDITION((names != NULL && hashes != NULL) || size == 0);
+
+  for (int32_t i = 0; i < size; i++)
+  {
+    hashes[i] = _az_json_property_name_hash(names[i]);
+  }
+
+  *out_table = (az_json_property_name_table){
+    ._internal = {
+      .names = names,
+      .hashes = hashes,
+      .size = size,
+    },
+  };
+}
+
+AZ_NODISCARD int32_t az_json_token_find_property_name(
+    az_json_token const* json_token,
+    az_json_property_name_table const* table)
+{
+  _az_PRECONDITION_NOT_NULL(json_token);
+  _az_PRECONDITION_NOT_NULL(table);
+
+  az_span const* const names = table->_internal.names;
+  int32_t const size = table->_internal.size;
+
+  uint32_t hash = 0;
+  if (az_result_failed(az_json_token_get_property_name_hash(json_token, &hash)))
+  {
+    // Without a recorded hash, every name needs to be compared.
+    for (int32_t i = 0; i < size; i++)
+    {
+      if (az_json_token_is_text_equal(json_token, names[i]))
+      {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  uint32_t const* const hashes = table->_internal.hashes;
+  for (int32_t i = 0; i < size; i++)
+  {
+    if (hashes[i] == hash && az_span_is_content_equal(json_token->slice, names[i]))
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
 AZ_NODISCARD az_result az_json_token_get_boolean(az_json_token const* json_token, bool* out_value)
 {
   _az_PRECONDITION_NOT_NULL(json_token);
@@ -399,15 +484,7 @@ AZ_NODISCARD az_result az_json_token_get_string(
          i <= json_token->_internal.end_buffer_index;
          i++)
     {
-      az_span source = json_token->_internal.pointer_to_first_buffer[i];
-      if (i == json_token->_internal.start_buffer_index)
-      {
-        source = az_span_slice_to_end(source, json_token->_internal.start_buffer_offset);
-      }
-      else if (i == json_token->_internal.end_buffer_index)
-      {
-        source = az_span_slice(source, 0, json_token->_internal.end_buffer_offset);
-      }
+      az_span const source = _az_json_token_get_segment(json_token, i);
 
       _az_RETURN_IF_FAILED(_az_json_token_get_string_helper(
           source, destination, destination_max_size, &dest_idx, &next_char_escaped));
@@ -429,110 +506,276 @@ AZ_NODISCARD az_result az_json_token_get_string(
 }
 
 AZ_NODISCARD az_result
-az_json_token_get_uint64(az_json_token const* json_token, uint64_t* out_value)
+az_json_token_get_string_slice(az_json_token const* json_token, az_span* out_string)
 {
   _az_PRECONDITION_NOT_NULL(json_token);
-  _az_PRECONDITION_NOT_NULL(out_value);
+  _az_PRECONDITION_NOT_NULL(out_string);
 
-  if (json_token->kind != AZ_JSON_TOKEN_NUMBER)
+  if (json_token->kind != AZ_JSON_TOKEN_STRING && json_token->kind != AZ_JSON_TOKEN_PROPERTY_NAME)
   {
     return AZ_ERROR_JSON_INVALID_STATE;
   }
 
-  az_span token_slice = json_token->slice;
-
-  // Contiguous token
-  if (!json_token->_internal.is_multisegment)
+  if (json_token->_internal.string_has_escaped_chars || json_token->_internal.is_multisegment)
   {
-    return az_span_atou64(token_slice, out_value);
+    return AZ_ERROR_NOT_SUPPORTED;
   }
 
-  // Any number that won't fit in the scratch buffer, will overflow.
-  if (json_token->size > _az_MAX_SIZE_FOR_UINT64)
+  *out_string = json_token->slice;
+  return AZ_OK;
+}
+
+// Reads the 4 hexadecimal digits of a \uXXXX escape sequence, already validated by the reader.
+AZ_NODISCARD static uint32_t _az_json_read_utf16_code_unit(uint8_t const* hex_digits)
+{
+  uint32_t code_unit = 0;
+  for (int32_t i = 0; i < 4; i++)
   {
-    return AZ_ERROR_UNEXPECTED_CHAR;
+    uint8_t const digit = hex_digits[i];
+    code_unit = (code_unit << 4U)
+        | (uint32_t)(digit <= '9' ? digit - '0' : (digit | 0x20) - _az_HEX_LOWER_OFFSET);
   }
+  return code_unit;
+}
 
-  // Token straddles more than one segment.
-  // Used to copy discontiguous token values into a contiguous buffer, for number parsing.
-  uint8_t scratch_buffer[_az_MAX_SIZE_FOR_UINT64] = { 0 };
-  az_span scratch = AZ_SPAN_FROM_BUFFER(scratch_buffer);
-
-  az_span remainder = _az_json_token_copy_into_span_helper(json_token, scratch);
-
-  return az_span_atou64(az_span_slice(scratch, 0, _az_span_diff(remainder, scratch)), out_value);
+// Writes the UTF-8 encoding of the code point, and returns the number of bytes written.
+static int32_t _az_json_write_utf8(uint8_t* destination, uint32_t code_point)
+{
+  if (code_point < 0x80U)
+  {
+    destination[0] = (uint8_t)code_point;
+    return 1;
+  }
+  if (code_point < 0x800U)
+  {
+    destination[0] = (uint8_t)(0xC0U | (code_point >> 6U));
+    destination[1] = (uint8_t)(0x80U | (code_point & 0x3FU));
+    return 2;
+  }
+  if (code_point < 0x10000U)
+  {
+    destination[0] = (uint8_t)(0xE0U | (code_point >> 12U));
+    destination[1] = (uint8_t)(0x80U | ((code_point >> 6U) & 0x3FU));
+    destination[2] = (uint8_t)(0x80U | (code_point & 0x3FU));
+    return 3;
+  }
+  destination[0] = (uint8_t)(0xF0U | (code_point >> 18U));
+  destination[1] = (uint8_t)(0x80U | ((code_point >> 12U) & 0x3FU));
+  destination[2] = (uint8_t)(0x80U | ((code_point >> 6U) & 0x3FU));
+  destination[3] = (uint8_t)(0x80U | (code_point & 0x3FU));
+  return 4;
 }
 
 AZ_NODISCARD az_result
-az_json_token_get_uint32(az_json_token const* json_token, uint32_t* out_value)
+az_json_token_unescape_in_place(az_json_token const* json_token, az_span* out_string)
 {
   _az_PRECONDITION_NOT_NULL(json_token);
-  _az_PRECONDITION_NOT_NULL(out_value);
+  _az_PRECONDITION_NOT_NULL(out_string);
 
-  if (json_token->kind != AZ_JSON_TOKEN_NUMBER)
+  if (json_token->kind != AZ_JSON_TOKEN_STRING && json_token->kind != AZ_JSON_TOKEN_PROPERTY_NAME)
   {
     return AZ_ERROR_JSON_INVALID_STATE;
   }
 
-  az_span token_slice = json_token->slice;
+  if (json_token->_internal.is_multisegment)
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
 
-  // Contiguous token
-  if (!json_token->_internal.is_multisegment)
+  az_span const token_slice = json_token->slice;
+  if (!json_token->_internal.string_has_escaped_chars)
   {
-    return az_span_atou32(token_slice, out_value);
+    *out_string = token_slice;
+    return AZ_OK;
   }
 
-  // Any number that won't fit in the scratch buffer, will overflow.
-  if (json_token->size > _az_MAX_SIZE_FOR_UINT32)
+  uint8_t* const ptr = az_span_ptr(token_slice);
+  int32_t const size = az_span_size(token_slice);
+
+  // Within a string validated by the reader, the only special byte left is the backslash starting
+  // an escape sequence. Every escape sequence is longer than the bytes it stands for, so the
+  // unescaped string is written behind what is left to read.
+  int32_t read_index = _az_json_skip_plain_string_bytes(ptr, 0, size);
+  int32_t write_index = read_index;
+  while (read_index < size)
   {
-    return AZ_ERROR_UNEXPECTED_CHAR;
+    uint8_t const escaped = ptr[read_index + 1];
+    if (escaped != 'u')
+    {
+      ptr[write_index++] = _az_json_unescape_single_byte(escaped);
+      read_index += 2;
+    }
+    else
+    {
+      uint32_t code_point = _az_json_read_utf16_code_unit(ptr + read_index + 2);
+      read_index += 6;
+
+      // A high surrogate followed by an escaped low surrogate make up a single code point.
+      // Unpaired surrogates are encoded on their own.
+      if (code_point >= 0xD800U && code_point <= 0xDBFFU && read_index + 6 <= size
+          && ptr[read_index] == '\\' && ptr[read_index + 1] == 'u')
+      {
+        uint32_t const low_surrogate = _az_json_read_utf16_code_unit(ptr + read_index + 2);
+        if (low_surrogate >= 0xDC00U && low_surrogate <= 0xDFFFU)
+        {
+          code_point = 0x10000U + ((code_point - 0xD800U) << 10U) + (low_surrogate - 0xDC00U);
+          read_index += 6;
+        }
+      }
+
+      write_index += _az_json_write_utf8(ptr + write_index, code_point);
+    }
+
+    // Move the run of bytes up to the next escape sequence at once.
+    int32_t const next_escape_index = _az_json_skip_plain_string_bytes(ptr, read_index, size);
+    memmove(ptr + write_index, ptr + read_index, (size_t)(next_escape_index - read_index));
+    write_index += next_escape_index - read_index;
+    read_index = next_escape_index;
   }
 
-  // Token straddles more than one segment.
-  // Used to copy discontiguous token values into a contiguous buffer, for number parsing.
-  uint8_t scratch_buffer[_az_MAX_SIZE_FOR_UINT32] = { 0 };
-  az_span scratch = AZ_SPAN_FROM_BUFFER(scratch_buffer);
+  *out_string = az_span_slice(token_slice, 0, write_index);
+  return AZ_OK;
+}
 
-  az_span remainder = _az_json_token_copy_into_span_helper(json_token, scratch);
+// Gets the integer value recorded by the reader for a number token, if it is within the range
+// [0, max_value].
+// Gets an integer, given its sign and absolute value, if it is within the range [0, max_value].
+AZ_NODISCARD static az_result _az_json_token_get_unsigned_integer(
+    bool is_negative,
+    uint64_t magnitude,
+    uint64_t max_value,
+    uint64_t* out_value)
+{
+  // There is no unsigned representation for negative numbers, including -0.
+  if (is_negative || magnitude > max_value)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
 
-  return az_span_atou32(az_span_slice(scratch, 0, _az_span_diff(remainder, scratch)), out_value);
+  *out_value = magnitude;
+  return AZ_OK;
 }
 
-AZ_NODISCARD az_result az_json_token_get_int64(az_json_token const* json_token, int64_t* out_value)
+// Gets an integer, given its sign and absolute value, if it is within the range
+// [-max_value - 1, max_value].
+AZ_NODISCARD static az_result _az_json_token_get_signed_integer(
+    bool is_negative,
+    uint64_t magnitude,
+    uint64_t max_value,
+    int64_t* out_value)
 {
-  _az_PRECONDITION_NOT_NULL(json_token);
-  _az_PRECONDITION_NOT_NULL(out_value);
+  if (is_negative)
+  {
+    if (magnitude > max_value + 1)
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
 
-  if (json_token->kind != AZ_JSON_TOKEN_NUMBER)
+    // The absolute value of the minimum doesn't fit in an int64_t, so negate it in two steps.
+    *out_value = magnitude == 0 ? 0 : -(int64_t)(magnitude - 1) - 1;
+    return AZ_OK;
+  }
+
+  if (magnitude > max_value)
   {
-    return AZ_ERROR_JSON_INVALID_STATE;
+    return AZ_ERROR_UNEXPECTED_CHAR;
   }
 
-  az_span token_slice = json_token->slice;
+  *out_value = (int64_t)magnitude;
+  return AZ_OK;
+}
 
-  // Contiguous token
-  if (!json_token->_internal.is_multisegment)
+// Gets the sign and absolute value of an integer number token, either recorded by the reader while
+// validating the number, or straddling non-contiguous buffers. In the latter case, the number is
+// parsed one segment at a time, rather than copying it into a contiguous buffer first.
+AZ_NODISCARD static az_result _az_json_token_get_integer_magnitude(
+    az_json_token const* json_token,
+    bool* out_is_negative,
+    uint64_t* out_magnitude)
+{
+  if (json_token->_internal.number_is_integer)
   {
-    return az_span_atoi64(token_slice, out_value);
+    *out_is_negative = json_token->_internal.number_is_negative;
+    *out_magnitude = json_token->_internal.number_magnitude;
+    return AZ_OK;
   }
 
-  // Any number that won't fit in the scratch buffer, will overflow.
-  if (json_token->size > _az_MAX_SIZE_FOR_INT64)
+  bool is_negative = false;
+  bool has_digits = false;
+  uint64_t magnitude = 0;
+
+  for (int32_t i = json_token->_internal.start_buffer_index;
+       i <= json_token->_internal.end_buffer_index;
+       i++)
+  {
+    az_span const source = _az_json_token_get_segment(json_token, i);
+    uint8_t const* const source_ptr = az_span_ptr(source);
+    int32_t const source_size = az_span_size(source);
+
+    for (int32_t j = 0; j < source_size; j++)
+    {
+      uint8_t const next_byte = source_ptr[j];
+      if (next_byte == '-' && !has_digits && !is_negative)
+      {
+        is_negative = true;
+        continue;
+      }
+
+      // Fractions and exponents aren't allowed.
+      if (!isdigit(next_byte))
+      {
+        return AZ_ERROR_UNEXPECTED_CHAR;
+      }
+      uint64_t const d = (uint64_t)next_byte - '0';
+
+      // Check whether the next digit will cause an integer overflow.
+      // Before actually doing the math below, this is checking whether magnitude * 10 + d >
+      // UINT64_MAX.
+      if ((UINT64_MAX - d) / _az_NUMBER_OF_DECIMAL_VALUES < magnitude)
+      {
+        return AZ_ERROR_UNEXPECTED_CHAR;
+      }
+
+      magnitude = magnitude * _az_NUMBER_OF_DECIMAL_VALUES + d;
+      has_digits = true;
+    }
+  }
+
+  if (!has_digits)
   {
     return AZ_ERROR_UNEXPECTED_CHAR;
   }
 
-  // Token straddles more than one segment.
-  // Used to copy discontiguous token values into a contiguous buffer, for number parsing.
-  uint8_t scratch_buffer[_az_MAX_SIZE_FOR_INT64] = { 0 };
-  az_span scratch = AZ_SPAN_FROM_BUFFER(scratch_buffer);
+  *out_is_negative = is_negative;
+  *out_magnitude = magnitude;
+  return AZ_OK;
+}
 
-  az_span remainder = _az_json_token_copy_into_span_helper(json_token, scratch);
+AZ_NODISCARD az_result
+az_json_token_get_uint64(az_json_token const* json_token, uint64_t* out_value)
+{
+  _az_PRECONDITION_NOT_NULL(json_token);
+  _az_PRECONDITION_NOT_NULL(out_value);
 
-  return az_span_atoi64(az_span_slice(scratch, 0, _az_span_diff(remainder, scratch)), out_value);
+  if (json_token->kind != AZ_JSON_TOKEN_NUMBER)
+  {
+    return AZ_ERROR_JSON_INVALID_STATE;
+  }
+
+  // Contiguous token, which wasn't recorded by the reader
+  if (!json_token->_internal.number_is_integer && !json_token->_internal.is_multisegment)
+  {
+    return az_span_atou64(json_token->slice, out_value);
+  }
+
+  bool is_negative = false;
+  uint64_t magnitude = 0;
+  _az_RETURN_IF_FAILED(_az_json_token_get_integer_magnitude(json_token, &is_negative, &magnitude));
+  return _az_json_token_get_unsigned_integer(is_negative, magnitude, UINT64_MAX, out_value);
 }
 
-AZ_NODISCARD az_result az_json_token_get_int32(az_json_token const* json_token, int32_t* out_value)
+AZ_NODISCARD az_result
+az_json_token_get_uint32(az_json_token const* json_token, uint32_t* out_value)
 {
   _az_PRECONDITION_NOT_NULL(json_token);
   _az_PRECONDITION_NOT_NULL(out_value);
@@ -542,28 +785,68 @@ AZ_NODISCARD az_result az_json_token_get_int32(az_json_token const* json_token,
     return AZ_ERROR_JSON_INVALID_STATE;
   }
 
-  az_span token_slice = json_token->slice;
+  // Contiguous token, which wasn't recorded by the reader
+  if (!json_token->_internal.number_is_integer && !json_token->_internal.is_multisegment)
+  {
+    return az_span_atou32(json_token->slice, out_value);
+  }
 
-  // Contiguous token
-  if (!json_token->_internal.is_multisegment)
+  bool is_negative = false;
+  uint64_t magnitude = 0;
+  uint64_t value = 0;
+  _az_RETURN_IF_FAILED(_az_json_token_get_integer_magnitude(json_token, &is_negative, &magnitude));
+  _az_RETURN_IF_FAILED(
+      _az_json_token_get_unsigned_integer(is_negative, magnitude, UINT32_MAX, &value));
+  *out_value = (uint32_t)value;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_token_get_int64(az_json_token const* json_token, int64_t* out_value)
+{
+  _az_PRECONDITION_NOT_NULL(json_token);
+  _az_PRECONDITION_NOT_NULL(out_value);
+
+  if (json_token->kind != AZ_JSON_TOKEN_NUMBER)
   {
-    return az_span_atoi32(token_slice, out_value);
+    return AZ_ERROR_JSON_INVALID_STATE;
   }
 
-  // Any number that won't fit in the scratch buffer, will overflow.
-  if (json_token->size > _az_MAX_SIZE_FOR_INT32)
+  // Contiguous token, which wasn't recorded by the reader
+  if (!json_token->_internal.number_is_integer && !json_token->_internal.is_multisegment)
   {
-    return AZ_ERROR_UNEXPECTED_CHAR;
+    return az_span_atoi64(json_token->slice, out_value);
   }
 
-  // Token straddles more than one segment.
-  // Used to copy discontiguous token values into a contiguous buffer, for number parsing.
-  uint8_t scratch_buffer[_az_MAX_SIZE_FOR_INT32] = { 0 };
-  az_span scratch = AZ_SPAN_FROM_BUFFER(scratch_buffer);
+  bool is_negative = false;
+  uint64_t magnitude = 0;
+  _az_RETURN_IF_FAILED(_az_json_token_get_integer_magnitude(json_token, &is_negative, &magnitude));
+  return _az_json_token_get_signed_integer(is_negative, magnitude, INT64_MAX, out_value);
+}
 
-  az_span remainder = _az_json_token_copy_into_span_helper(json_token, scratch);
+AZ_NODISCARD az_result az_json_token_get_int32(az_json_token const* json_token, int32_t* out_value)
+{
+  _az_PRECONDITION_NOT_NULL(json_token);
+  _az_PRECONDITION_NOT_NULL(out_value);
+
+  if (json_token->kind != AZ_JSON_TOKEN_NUMBER)
+  {
+    return AZ_ERROR_JSON_INVALID_STATE;
+  }
+
+  // Contiguous token, which wasn't recorded by the reader
+  if (!json_token->_internal.number_is_integer && !json_token->_internal.is_multisegment)
+  {
+    return az_span_atoi32(json_token->slice, out_value);
+  }
 
-  return az_span_atoi32(az_span_slice(scratch, 0, _az_span_diff(remainder, scratch)), out_value);
+  bool is_negative = false;
+  uint64_t magnitude = 0;
+  int64_t value = 0;
+  _az_RETURN_IF_FAILED(_az_json_token_get_integer_magnitude(json_token, &is_negative, &magnitude));
+  _az_RETURN_IF_FAILED(
+      _az_json_token_get_signed_integer(is_negative, magnitude, INT32_MAX, &value));
+  *out_value = (int32_t)value;
+  return AZ_OK;
 }
 
 AZ_NODISCARD az_result az_json_token_get_double(az_json_token const* json_token, double* out_value)
@@ -576,6 +859,15 @@ AZ_NODISCARD az_result az_json_token_get_double(az_json_token const* json_token,
     return AZ_ERROR_JSON_INVALID_STATE;
   }
 
+  // Integers recorded by the reader don't need to be parsed again. Converting them is correctly
+  // rounded, just like parsing their text.
+  if (json_token->_internal.number_is_integer)
+  {
+    double const value = (double)json_token->_internal.number_magnitude;
+    *out_value = json_token->_internal.number_is_negative ? -value : value;
+    return AZ_OK;
+  }
+
   az_span token_slice = json_token->slice;
 
   // Contiguous token
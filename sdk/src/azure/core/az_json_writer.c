@@ -23,15 +23,21 @@ AZ_NODISCARD az_result az_json_writer_init(
     ._internal = {
       .destination_buffer = destination_buffer,
       .allocator_callback = NULL,
+      .sink_callback = NULL,
       .user_context = NULL,
       .bytes_written = 0,
       .total_bytes_written = 0,
+      .previous_buffer_count = 0,
       .need_comma = false,
       .token_kind = AZ_JSON_TOKEN_NONE,
-      .bit_stack = { 0 },
       .options = options == NULL ? az_json_writer_options_default() : *options,
     },
   };
+
+  _az_json_stack_init(
+      &out_json_writer->_internal.bit_stack,
+      out_json_writer->_internal.options.nesting_stack_extension,
+      out_json_writer->_internal.options.nesting_stack_extension_size);
   return AZ_OK;
 }
 
@@ -49,18 +55,140 @@ AZ_NODISCARD az_result az_json_writer_chunked_init(
     ._internal = {
       .destination_buffer = first_destination_buffer,
       .allocator_callback = allocator_callback,
+      .sink_callback = NULL,
       .user_context = user_context,
       .bytes_written = 0,
       .total_bytes_written = 0,
+      .previous_buffer_count = 0,
       .need_comma = false,
       .token_kind = AZ_JSON_TOKEN_NONE,
-      .bit_stack = { 0 },
       .options = options == NULL ? az_json_writer_options_default() : *options,
     },
   };
+
+  _az_json_stack_init(
+      &out_json_writer->_internal.bit_stack,
+      out_json_writer->_internal.options.nesting_stack_extension,
+      out_json_writer->_internal.options.nesting_stack_extension_size);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_writer_sink_init(
+    az_json_writer* out_json_writer,
+    az_span working_buffer,
+    az_json_writer_sink_fn sink_callback,
+    void* user_context,
+    az_json_writer_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(sink_callback);
+  // Long strings are written in chunks of at least this size.
+  _az_PRECONDITION(az_span_size(working_buffer) >= _az_MINIMUM_STRING_CHUNK_SIZE);
+
+  _az_RETURN_IF_FAILED(az_json_writer_init(out_json_writer, working_buffer, options));
+
+  out_json_writer->_internal.sink_callback = sink_callback;
+  out_json_writer->_internal.user_context = user_context;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_writer_flush(az_json_writer* ref_json_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_NOT_NULL(ref_json_writer->_internal.sink_callback);
+
+  if (ref_json_writer->_internal.bytes_written > 0)
+  {
+    _az_RETURN_IF_FAILED(ref_json_writer->_internal.sink_callback(
+        ref_json_writer->_internal.user_context,
+        az_json_writer_get_bytes_used_in_destination(ref_json_writer)));
+    ref_json_writer->_internal.bytes_written = 0;
+    ref_json_writer->_internal.previous_buffer_count++;
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_json_writer_checkpoint
+az_json_writer_get_checkpoint(az_json_writer const* json_writer)
+{
+  _az_PRECONDITION_NOT_NULL(json_writer);
+
+  return (az_json_writer_checkpoint){
+    ._internal = {
+      .bytes_written = json_writer->_internal.bytes_written,
+      .total_bytes_written = json_writer->_internal.total_bytes_written,
+      .vectors_count = json_writer->_internal.vectors_count,
+      .vector_start = json_writer->_internal.vector_start,
+      .previous_buffer_count = json_writer->_internal.previous_buffer_count,
+      .need_comma = json_writer->_internal.need_comma,
+      .token_kind = json_writer->_internal.token_kind,
+      .bit_stack = json_writer->_internal.bit_stack,
+    },
+  };
+}
+
+AZ_NODISCARD az_result az_json_writer_rollback(
+    az_json_writer* ref_json_writer,
+    az_json_writer_checkpoint const* checkpoint)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_NOT_NULL(checkpoint);
+  _az_PRECONDITION(
+      checkpoint->_internal.total_bytes_written <= ref_json_writer->_internal.total_bytes_written);
+
+  if (ref_json_writer->_internal.previous_buffer_count
+      != checkpoint->_internal.previous_buffer_count)
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  ref_json_writer->_internal.bytes_written = checkpoint->_internal.bytes_written;
+  ref_json_writer->_internal.total_bytes_written = checkpoint->_internal.total_bytes_written;
+  ref_json_writer->_internal.vectors_count = checkpoint->_internal.vectors_count;
+  ref_json_writer->_internal.vector_start = checkpoint->_internal.vector_start;
+  ref_json_writer->_internal.need_comma = checkpoint->_internal.need_comma;
+  ref_json_writer->_internal.token_kind = checkpoint->_internal.token_kind;
+  ref_json_writer->_internal.bit_stack = checkpoint->_internal.bit_stack;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_writer_vectored_init(
+    az_json_writer* out_json_writer,
+    az_span destination_buffer,
+    az_span vectors[],
+    int32_t vectors_size,
+    az_json_writer_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(vectors);
+  _az_PRECONDITION(vectors_size >= 1);
+
+  _az_RETURN_IF_FAILED(az_json_writer_init(out_json_writer, destination_buffer, options));
+
+  out_json_writer->_internal.vectors = vectors;
+  out_json_writer->_internal.vectors_size = vectors_size;
   return AZ_OK;
 }
 
+AZ_NODISCARD int32_t az_json_writer_get_vectors_count(az_json_writer* ref_json_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_NOT_NULL(ref_json_writer->_internal.vectors);
+
+  int32_t vectors_count = ref_json_writer->_internal.vectors_count;
+
+  // There is always room left for the slice written since the last referenced JSON text.
+  if (ref_json_writer->_internal.bytes_written > ref_json_writer->_internal.vector_start)
+  {
+    ref_json_writer->_internal.vectors[vectors_count] = az_span_slice(
+        ref_json_writer->_internal.destination_buffer,
+        ref_json_writer->_internal.vector_start,
+        ref_json_writer->_internal.bytes_written);
+    vectors_count++;
+  }
+
+  return vectors_count;
+}
+
 static AZ_NODISCARD az_span
 _get_remaining_span(az_json_writer* ref_json_writer, int32_t required_size)
 {
@@ -86,20 +214,33 @@ _get_remaining_span(az_json_writer* ref_json_writer, int32_t required_size)
     }
     ref_json_writer->_internal.destination_buffer = remaining;
     ref_json_writer->_internal.bytes_written = 0;
+    ref_json_writer->_internal.previous_buffer_count++;
+  }
+  else if (
+      az_span_size(remaining) < required_size && ref_json_writer->_internal.sink_callback != NULL)
+  {
+    // Let the caller fail with AZ_ERROR_NOT_ENOUGH_SPACE if the sink fails.
+    if (az_result_failed(az_json_writer_flush(ref_json_writer)))
+    {
+      return AZ_SPAN_EMPTY;
+    }
+    remaining = ref_json_writer->_internal.destination_buffer;
   }
 
   return remaining;
 }
 
-// This validation method is used outside of just preconditions, within
-// az_json_writer_append_json_text.
-static AZ_NODISCARD bool _az_is_appending_value_valid(az_json_writer const* json_writer)
+// The validation of the container state is shared with the other writers that follow the JSON data
+// model, such as az_msgpack_writer.
+AZ_NODISCARD bool _az_json_writer_is_appending_value_valid(
+    _az_json_bit_stack const* bit_stack,
+    az_json_token_kind last_token_kind)
 {
-  _az_PRECONDITION_NOT_NULL(json_writer);
+  _az_PRECONDITION_NOT_NULL(bit_stack);
 
-  az_json_token_kind kind = json_writer->_internal.token_kind;
+  az_json_token_kind kind = last_token_kind;
 
-  if (_az_json_stack_peek(&json_writer->_internal.bit_stack))
+  if (_az_json_stack_peek(bit_stack))
   {
     // Cannot write a JSON value within an object without a property name first.
     // That includes writing the start of an object or array without a property name.
@@ -125,7 +266,7 @@ static AZ_NODISCARD bool _az_is_appending_value_valid(az_json_writer const* json
 
     // It is more likely for current_depth to not equal 0 when writing valid JSON, so check that
     // first to rely on short-circuiting and return quickly.
-    if (json_writer->_internal.bit_stack._internal.current_depth == 0 && kind != AZ_JSON_TOKEN_NONE)
+    if (bit_stack->_internal.current_depth == 0 && kind != AZ_JSON_TOKEN_NONE)
     {
       return false;
     }
@@ -135,17 +276,17 @@ static AZ_NODISCARD bool _az_is_appending_value_valid(az_json_writer const* json
   return true;
 }
 
-#ifndef AZ_NO_PRECONDITION_CHECKING
-static AZ_NODISCARD bool _az_is_appending_property_name_valid(az_json_writer const* json_writer)
+AZ_NODISCARD bool _az_json_writer_is_appending_property_name_valid(
+    _az_json_bit_stack const* bit_stack,
+    az_json_token_kind last_token_kind)
 {
-  _az_PRECONDITION_NOT_NULL(json_writer);
+  _az_PRECONDITION_NOT_NULL(bit_stack);
 
-  az_json_token_kind kind = json_writer->_internal.token_kind;
+  az_json_token_kind kind = last_token_kind;
 
   // Cannot write a JSON property within an array or as the first JSON token.
   // Cannot write a JSON property name following another property name. A JSON value is missing.
-  if (!_az_json_stack_peek(&json_writer->_internal.bit_stack)
-      || kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  if (!_az_json_stack_peek(bit_stack) || kind == AZ_JSON_TOKEN_PROPERTY_NAME)
   {
     _az_PRECONDITION(kind != AZ_JSON_TOKEN_BEGIN_OBJECT);
     return false;
@@ -155,26 +296,26 @@ static AZ_NODISCARD bool _az_is_appending_property_name_valid(az_json_writer con
   return true;
 }
 
-static AZ_NODISCARD bool _az_is_appending_container_end_valid(
-    az_json_writer const* json_writer,
-    uint8_t byte)
+AZ_NODISCARD bool _az_json_writer_is_appending_container_end_valid(
+    _az_json_bit_stack const* bit_stack,
+    az_json_token_kind last_token_kind,
+    _az_json_stack_item container)
 {
-  _az_PRECONDITION_NOT_NULL(json_writer);
+  _az_PRECONDITION_NOT_NULL(bit_stack);
 
-  az_json_token_kind kind = json_writer->_internal.token_kind;
+  az_json_token_kind kind = last_token_kind;
 
   // Cannot write an end of a container without a matching start.
   // This includes writing the end token as the first token in the JSON or right after a property
   // name.
-  if (json_writer->_internal.bit_stack._internal.current_depth <= 0
-      || kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  if (bit_stack->_internal.current_depth <= 0 || kind == AZ_JSON_TOKEN_PROPERTY_NAME)
   {
     return false;
   }
 
-  _az_json_stack_item stack_item = _az_json_stack_peek(&json_writer->_internal.bit_stack);
+  _az_json_stack_item stack_item = _az_json_stack_peek(bit_stack);
 
-  if (byte == ']')
+  if (container == _az_JSON_STACK_ARRAY)
   {
     // If inside a JSON object, then appending an end bracket is invalid:
     if (stack_item)
@@ -185,8 +326,6 @@ static AZ_NODISCARD bool _az_is_appending_container_end_valid(
   }
   else
   {
-    _az_PRECONDITION(byte == '}');
-
     // If not inside a JSON object, then appending an end brace is invalid:
     if (!stack_item)
     {
@@ -197,7 +336,103 @@ static AZ_NODISCARD bool _az_is_appending_container_end_valid(
   // JSON writer state is valid and an end of a container can be appended.
   return true;
 }
-#endif // AZ_NO_PRECONDITION_CHECKING
+
+// This validation method is used outside of just preconditions, within
+// az_json_writer_append_json_text.
+static AZ_NODISCARD bool _az_is_appending_value_valid(az_json_writer const* json_writer)
+{
+  _az_PRECONDITION_NOT_NULL(json_writer);
+
+  return _az_json_writer_is_appending_value_valid(
+      &json_writer->_internal.bit_stack, json_writer->_internal.token_kind);
+}
+
+// These are also needed when preconditions are assumed rather than checked.
+#if !defined(AZ_NO_PRECONDITION_CHECKING) || defined(AZ_PRECONDITION_ASSUMPTIONS)
+static AZ_NODISCARD bool _az_is_appending_property_name_valid(az_json_writer const* json_writer)
+{
+  _az_PRECONDITION_NOT_NULL(json_writer);
+
+  return _az_json_writer_is_appending_property_name_valid(
+      &json_writer->_internal.bit_stack, json_writer->_internal.token_kind);
+}
+
+static AZ_NODISCARD bool _az_is_appending_container_end_valid(
+    az_json_writer const* json_writer,
+    uint8_t byte)
+{
+  _az_PRECONDITION_NOT_NULL(json_writer);
+  _az_PRECONDITION(byte == ']' || byte == '}');
+
+  return _az_json_writer_is_appending_container_end_valid(
+      &json_writer->_internal.bit_stack,
+      json_writer->_internal.token_kind,
+      byte == '}' ? _az_JSON_STACK_OBJECT : _az_JSON_STACK_ARRAY);
+}
+
+static AZ_NODISCARD bool _az_is_escaped_property_name_valid(az_span json_name)
+{
+  int32_t const size = az_span_size(json_name);
+  uint8_t const* const ptr = az_span_ptr(json_name);
+
+  // The name must be quoted, and followed by the key:value separator colon.
+  if (size < 3 || ptr[0] != '"' || ptr[size - 2] != '"' || ptr[size - 1] != ':')
+  {
+    return false;
+  }
+
+  for (int32_t i = 1; i < size - 2; i++)
+  {
+    uint8_t const ch = ptr[i];
+    if (ch == '"' || ch < _az_ASCII_SPACE_CHARACTER)
+    {
+      return false;
+    }
+
+    if (ch == '\\')
+    {
+      i++;
+      if (i == size - 2)
+      {
+        return false;
+      }
+
+      switch (ptr[i])
+      {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+          break;
+        case 'u':
+        {
+          if (i + 4 >= size - 2)
+          {
+            return false;
+          }
+          for (int32_t j = 0; j < 4; j++)
+          {
+            uint8_t const digit = (uint8_t)(ptr[++i] | 0x20); // Lowercase the letters.
+            if (!((digit >= '0' && digit <= '9') || (digit >= 'a' && digit <= 'f')))
+            {
+              return false;
+            }
+          }
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+  }
+
+  return true;
+}
+#endif // !defined(AZ_NO_PRECONDITION_CHECKING) || defined(AZ_PRECONDITION_ASSUMPTIONS)
 
 // Returns the length of the JSON string within the az_span after it has been escaped.
 // The out parameter contains the index where the first character to escape is found.
@@ -215,12 +450,15 @@ static int32_t _az_json_writer_escaped_length(
   int32_t value_size = az_span_size(value);
   _az_PRECONDITION(value_size <= _az_MAX_UNESCAPED_STRING_SIZE);
 
-  int32_t escaped_length = 0;
-  *out_index_of_first_escaped_char = -1;
-
-  int32_t i = 0;
   uint8_t* value_ptr = az_span_ptr(value);
 
+  // Skip the run of bytes that don't need to be escaped at once.
+  int32_t i = _az_json_skip_plain_string_bytes(value_ptr, 0, value_size);
+  int32_t escaped_length = i;
+
+  // In most common cases, no character needs to be escaped.
+  *out_index_of_first_escaped_char = i == value_size ? -1 : i;
+
   while (i < value_size)
   {
     uint8_t const ch = value_ptr[i];
@@ -240,33 +478,22 @@ static int32_t _az_json_writer_escaped_length(
       }
       default:
       {
-        // Check if the character has to be escaped as a UNICODE escape sequence.
-        if (ch < _az_ASCII_SPACE_CHARACTER)
-        {
-          escaped_length += _az_MAX_EXPANSION_FACTOR_WHILE_ESCAPING;
-        }
-        else
-        {
-          escaped_length++; // No escaping required.
-        }
+        // The other characters to escape are escaped as a UNICODE escape sequence.
+        escaped_length += _az_MAX_EXPANSION_FACTOR_WHILE_ESCAPING;
         break;
       }
     }
 
-    i++;
-
-    // If this is the first time that we found a character that needs to be escaped,
-    // set out_index_of_first_escaped_char to the corresponding index.
-    // If escaped_length == i, then we haven't found a character that needs to be escaped yet.
-    if (escaped_length != i && *out_index_of_first_escaped_char == -1)
+    if (break_on_first_escaped)
     {
-      *out_index_of_first_escaped_char = i - 1;
-      if (break_on_first_escaped)
-      {
-        break;
-      }
+      break;
     }
 
+    int32_t const next_escaped_index
+        = _az_json_skip_plain_string_bytes(value_ptr, i + 1, value_size);
+    escaped_length += next_escaped_index - (i + 1);
+    i = next_escaped_index;
+
     // If the length overflows, in case the precondition is not honored, stop processing and break
     // The caller will return AZ_ERROR_NOT_ENOUGH_SPACE since az_span can't contain it.
     // TODO: Consider removing this if it is too costly.
@@ -277,8 +504,6 @@ static int32_t _az_json_writer_escaped_length(
     }
   }
 
-  // In most common cases, escaped_length will equal value_size and out_index_of_first_escaped_char
-  // will be -1.
   return escaped_length;
 }
 
@@ -375,9 +600,17 @@ static AZ_NODISCARD az_span _az_json_writer_escape_and_copy(az_span destination,
 
   while (i < src_size)
   {
-    uint8_t const ch = value_ptr[i];
-    _az_json_writer_escape_next_byte_and_copy(&remaining_destination, ch);
-    i++;
+    // Bulk copy the run of characters that don't need to be escaped, before escaping the next one.
+    int32_t const escaped_index = _az_json_skip_plain_string_bytes(value_ptr, i, src_size);
+    remaining_destination
+        = az_span_copy(remaining_destination, az_span_slice(source, i, escaped_index));
+    if (escaped_index == src_size)
+    {
+      break;
+    }
+
+    _az_json_writer_escape_next_byte_and_copy(&remaining_destination, value_ptr[escaped_index]);
+    i = escaped_index + 1;
   }
 
   return remaining_destination;
@@ -714,6 +947,58 @@ az_json_writer_append_property_name(az_json_writer* ref_json_writer, az_span nam
   return az_json_writer_append_property_name_chunked(ref_json_writer, name);
 }
 
+AZ_NODISCARD az_result
+az_json_writer_append_escaped_property_name(az_json_writer* ref_json_writer, az_span json_name)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_VALID_SPAN(json_name, 3, false);
+  _az_PRECONDITION(_az_is_escaped_property_name_valid(json_name));
+  _az_PRECONDITION(_az_is_appending_property_name_valid(ref_json_writer));
+
+  int32_t const name_size = az_span_size(json_name);
+  int32_t required_size = name_size;
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    required_size++; // For the leading comma separator.
+  }
+
+  // The name is copied as is, without looking at its characters.
+  if (required_size <= _az_MINIMUM_STRING_CHUNK_SIZE)
+  {
+    az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+
+    if (ref_json_writer->_internal.need_comma)
+    {
+      remaining_json = az_span_copy_u8(remaining_json, ',');
+    }
+
+    az_span_copy(remaining_json, json_name);
+
+    _az_update_json_writer_state(
+        ref_json_writer, required_size, required_size, false, AZ_JSON_TOKEN_PROPERTY_NAME);
+    return AZ_OK;
+  }
+
+  az_span remaining_json = _get_remaining_span(ref_json_writer, _az_MINIMUM_STRING_CHUNK_SIZE);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, _az_MINIMUM_STRING_CHUNK_SIZE);
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    remaining_json = az_span_copy_u8(remaining_json, ',');
+    ref_json_writer->_internal.bytes_written++;
+  }
+
+  _az_RETURN_IF_FAILED(
+      az_json_writer_span_copy_chunked(ref_json_writer, &remaining_json, json_name));
+
+  // We already tracked and updated bytes_written while writing, so no need to update it here.
+  _az_update_json_writer_state(
+      ref_json_writer, 0, required_size, false, AZ_JSON_TOKEN_PROPERTY_NAME);
+  return AZ_OK;
+}
+
 static AZ_NODISCARD az_result _az_validate_json(
     az_span json_text,
     az_json_token_kind* first_token_kind,
@@ -749,19 +1034,51 @@ static AZ_NODISCARD az_result _az_validate_json(
   return AZ_OK;
 }
 
-AZ_NODISCARD az_result
-az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_text)
+// Returns the kind of the last token of a JSON text trusted to be valid, from its last byte.
+static AZ_NODISCARD az_json_token_kind _az_json_trusted_last_token_kind(az_span json_text)
 {
-  _az_PRECONDITION_NOT_NULL(ref_json_writer);
-  // A null or empty span is not allowed since that is invalid JSON.
-  _az_PRECONDITION_VALID_SPAN(json_text, 0, false);
+  az_span const trimmed = _az_span_trim_whitespace(json_text);
+  int32_t const size = az_span_size(trimmed);
+  _az_PRECONDITION(size > 0);
 
-  az_json_token_kind first_token_kind = AZ_JSON_TOKEN_NONE;
-  az_json_token_kind last_token_kind = AZ_JSON_TOKEN_NONE;
+  uint8_t const* const ptr = az_span_ptr(trimmed);
+  switch (ptr[size - 1])
+  {
+    case '}':
+      return AZ_JSON_TOKEN_END_OBJECT;
+    case ']':
+      return AZ_JSON_TOKEN_END_ARRAY;
+    case '"':
+      return AZ_JSON_TOKEN_STRING;
+    case 'l':
+      return AZ_JSON_TOKEN_NULL;
+    case 'e':
+      // A JSON text ending with true or false is that single literal.
+      return ptr[0] == 't' ? AZ_JSON_TOKEN_TRUE : AZ_JSON_TOKEN_FALSE;
+    default:
+      return AZ_JSON_TOKEN_NUMBER;
+  }
+}
+
+// Validates the JSON text, and that it can be appended by the writer in its current state.
+static AZ_NODISCARD az_result _az_json_writer_validate_json_text(
+    az_json_writer const* json_writer,
+    az_span json_text,
+    az_json_token_kind* out_last_token_kind)
+{
+  if (json_writer->_internal.options.append_json_text_without_validation)
+  {
+    *out_last_token_kind = _az_json_trusted_last_token_kind(json_text);
+  }
+  else
+  {
+    az_json_token_kind first_token_kind = AZ_JSON_TOKEN_NONE;
 
-  // This runtime validation is necessary since the input could be user defined and malformed.
-  // This cannot be caught at dev time by a precondition, especially since they can be turned off.
-  _az_RETURN_IF_FAILED(_az_validate_json(json_text, &first_token_kind, &last_token_kind));
+    // This runtime validation is necessary since the input could be user defined and malformed.
+    // This cannot be caught at dev time by a precondition, especially since they can be turned
+    // off.
+    _az_RETURN_IF_FAILED(_az_validate_json(json_text, &first_token_kind, out_last_token_kind));
+  }
 
   // It is guaranteed that first_token_kind is NOT:
   // AZ_JSON_TOKEN_NONE, AZ_JSON_TOKEN_END_ARRAY, AZ_JSON_TOKEN_END_OBJECT,
@@ -772,13 +1089,27 @@ az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_te
 
   // The JSON text is valid, but appending it to the the JSON writer at the current state still may
   // not be valid.
-  if (!_az_is_appending_value_valid(ref_json_writer))
+  if (!_az_is_appending_value_valid(json_writer))
   {
     // All other tokens, including start array and object are validated here.
     // Also first_token_kind cannot be AZ_JSON_TOKEN_NONE at this point.
     return AZ_ERROR_JSON_INVALID_STATE;
   }
 
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_text)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  // A null or empty span is not allowed since that is invalid JSON.
+  _az_PRECONDITION_VALID_SPAN(json_text, 0, false);
+
+  az_json_token_kind last_token_kind = AZ_JSON_TOKEN_NONE;
+  _az_RETURN_IF_FAILED(
+      _az_json_writer_validate_json_text(ref_json_writer, json_text, &last_token_kind));
+
   az_span remaining_json = _get_remaining_span(ref_json_writer, _az_MINIMUM_STRING_CHUNK_SIZE);
   _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, _az_MINIMUM_STRING_CHUNK_SIZE);
 
@@ -803,6 +1134,85 @@ az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_te
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result
+az_json_writer_append_json_text_reference(az_json_writer* ref_json_writer, az_span json_text)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_NOT_NULL(ref_json_writer->_internal.vectors);
+  // A null or empty span is not allowed since that is invalid JSON.
+  _az_PRECONDITION_VALID_SPAN(json_text, 0, false);
+
+  az_json_token_kind last_token_kind = AZ_JSON_TOKEN_NONE;
+  _az_RETURN_IF_FAILED(
+      _az_json_writer_validate_json_text(ref_json_writer, json_text, &last_token_kind));
+
+  // Room for the slice written before the JSON text, the JSON text, and the slice that follows it.
+  if (ref_json_writer->_internal.vectors_count + 3 > ref_json_writer->_internal.vectors_size)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    az_span remaining_json = _get_remaining_span(ref_json_writer, 1);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, 1);
+
+    az_span_copy_u8(remaining_json, ',');
+    ref_json_writer->_internal.bytes_written++;
+    ref_json_writer->_internal.total_bytes_written++;
+  }
+
+  az_span* const vectors = ref_json_writer->_internal.vectors;
+  int32_t const bytes_written = ref_json_writer->_internal.bytes_written;
+
+  if (bytes_written > ref_json_writer->_internal.vector_start)
+  {
+    vectors[ref_json_writer->_internal.vectors_count++] = az_span_slice(
+        ref_json_writer->_internal.destination_buffer,
+        ref_json_writer->_internal.vector_start,
+        bytes_written);
+  }
+  vectors[ref_json_writer->_internal.vectors_count++] = json_text;
+  ref_json_writer->_internal.vector_start = bytes_written;
+
+  // The JSON text isn't written into the destination buffer, so only the total grows.
+  _az_update_json_writer_state(ref_json_writer, 0, az_span_size(json_text), true, last_token_kind);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result _az_json_writer_append_trusted_members(
+    az_json_writer* ref_json_writer,
+    az_span json_members,
+    az_json_token_kind last_token_kind)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_VALID_SPAN(json_members, 1, false);
+  _az_PRECONDITION(_az_is_appending_property_name_valid(ref_json_writer));
+
+  az_span remaining_json = _get_remaining_span(ref_json_writer, _az_MINIMUM_STRING_CHUNK_SIZE);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, _az_MINIMUM_STRING_CHUNK_SIZE);
+
+  int32_t total_size = az_span_size(json_members);
+  if (ref_json_writer->_internal.need_comma)
+  {
+    remaining_json = az_span_copy_u8(remaining_json, ',');
+    ref_json_writer->_internal.bytes_written++;
+    total_size++;
+  }
+
+  _az_RETURN_IF_FAILED(
+      az_json_writer_span_copy_chunked(ref_json_writer, &remaining_json, json_members));
+
+  // A value must follow a property name, while more members follow a value after a comma.
+  _az_update_json_writer_state(
+      ref_json_writer,
+      0,
+      total_size,
+      last_token_kind != AZ_JSON_TOKEN_PROPERTY_NAME,
+      last_token_kind);
+  return AZ_OK;
+}
+
 static AZ_NODISCARD az_result _az_json_writer_append_literal(
     az_json_writer* ref_json_writer,
     az_span literal,
@@ -885,7 +1295,108 @@ AZ_NODISCARD az_result az_json_writer_append_int32(az_json_writer* ref_json_writ
   return AZ_OK;
 }
 
-AZ_NODISCARD az_result az_json_writer_append_double(
+AZ_NODISCARD az_result az_json_writer_append_int64(az_json_writer* ref_json_writer, int64_t value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
+
+  int32_t required_size = _az_MAX_SIZE_FOR_INT64; // Need enough space to write any 64-bit integer.
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    required_size++; // For the leading comma separator.
+  }
+
+  az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    remaining_json = az_span_copy_u8(remaining_json, ',');
+  }
+
+  // Since we asked for the maximum needed space above, this is guaranteed not to fail due to
+  // AZ_ERROR_NOT_ENOUGH_SPACE. Still checking the returned az_result, for other potential failure
+  // cases.
+  az_span leftover;
+  _az_RETURN_IF_FAILED(az_span_i64toa(remaining_json, value, &leftover));
+
+  // We already accounted for the maximum size needed in required_size, so subtract that to get the
+  // actual bytes written.
+  int32_t written
+      = required_size + _az_span_diff(leftover, remaining_json) - _az_MAX_SIZE_FOR_INT64;
+  _az_update_json_writer_state(ref_json_writer, written, written, true, AZ_JSON_TOKEN_NUMBER);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_json_writer_append_uint64(az_json_writer* ref_json_writer, uint64_t value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
+
+  // Need enough space to write any unsigned 64-bit integer.
+  int32_t required_size = _az_MAX_SIZE_FOR_UINT64;
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    required_size++; // For the leading comma separator.
+  }
+
+  az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    remaining_json = az_span_copy_u8(remaining_json, ',');
+  }
+
+  // Since we asked for the maximum needed space above, this is guaranteed not to fail due to
+  // AZ_ERROR_NOT_ENOUGH_SPACE. Still checking the returned az_result, for other potential failure
+  // cases.
+  az_span leftover;
+  _az_RETURN_IF_FAILED(az_span_u64toa(remaining_json, value, &leftover));
+
+  // We already accounted for the maximum size needed in required_size, so subtract that to get the
+  // actual bytes written.
+  int32_t written
+      = required_size + _az_span_diff(leftover, remaining_json) - _az_MAX_SIZE_FOR_UINT64;
+  _az_update_json_writer_state(ref_json_writer, written, written, true, AZ_JSON_TOKEN_NUMBER);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_json_writer_append_iso8601(az_json_writer* ref_json_writer, int64_t unix_time_msec)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
+
+  int32_t required_size = _az_ISO8601_SIZE + 2; // For the surrounding quotes.
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    required_size++; // For the leading comma separator.
+  }
+
+  az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    remaining_json = az_span_copy_u8(remaining_json, ',');
+  }
+
+  // The timestamp is formatted in place, between the quotes.
+  remaining_json = az_span_copy_u8(remaining_json, '"');
+  _az_RETURN_IF_FAILED(az_span_format_iso8601(remaining_json, unix_time_msec, &remaining_json));
+  az_span_copy_u8(remaining_json, '"');
+
+  _az_update_json_writer_state(
+      ref_json_writer, required_size, required_size, true, AZ_JSON_TOKEN_STRING);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_writer_append_double(
     az_json_writer* ref_json_writer,
     double value,
     int32_t fractional_digits)
@@ -927,6 +1438,45 @@ AZ_NODISCARD az_result az_json_writer_append_double(
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result
+az_json_writer_append_double_shortest(az_json_writer* ref_json_writer, double value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
+  // Non-finite numbers are not supported because they lead to invalid JSON.
+  // Unquoted strings such as nan and -inf are invalid as JSON numbers.
+  _az_PRECONDITION(_az_isfinite(value));
+
+  // Need enough space to write any double number.
+  int32_t required_size = _az_MAX_SIZE_FOR_WRITING_DOUBLE;
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    required_size++; // For the leading comma separator.
+  }
+
+  az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    remaining_json = az_span_copy_u8(remaining_json, ',');
+  }
+
+  // Since we asked for the maximum needed space above, this is guaranteed not to fail due to
+  // AZ_ERROR_NOT_ENOUGH_SPACE. Still checking the returned az_result, for other potential failure
+  // cases.
+  az_span leftover;
+  _az_RETURN_IF_FAILED(az_span_dtoa_shortest(remaining_json, value, &leftover));
+
+  // We already accounted for the maximum size needed in required_size, so subtract that to get the
+  // actual bytes written.
+  int32_t written
+      = required_size + _az_span_diff(leftover, remaining_json) - _az_MAX_SIZE_FOR_WRITING_DOUBLE;
+  _az_update_json_writer_state(ref_json_writer, written, written, true, AZ_JSON_TOKEN_NUMBER);
+  return AZ_OK;
+}
+
 static AZ_NODISCARD az_result _az_json_writer_append_container_start(
     az_json_writer* ref_json_writer,
     uint8_t byte,
@@ -937,9 +1487,10 @@ static AZ_NODISCARD az_result _az_json_writer_append_container_start(
       container_kind == AZ_JSON_TOKEN_BEGIN_OBJECT || container_kind == AZ_JSON_TOKEN_BEGIN_ARRAY);
   _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
 
-  // The current depth is equal to or larger than the maximum allowed depth of 64. Cannot write the
-  // next JSON object or array.
-  if (ref_json_writer->_internal.bit_stack._internal.current_depth >= _az_MAX_JSON_STACK_SIZE)
+  // The current depth is equal to or larger than the maximum allowed depth of 64 (or more, with an
+  // extension of the stack). Cannot write the next JSON object or array.
+  if (ref_json_writer->_internal.bit_stack._internal.current_depth
+      >= _az_json_stack_max_depth(&ref_json_writer->_internal.bit_stack))
   {
     return AZ_ERROR_JSON_NESTING_OVERFLOW;
   }
@@ -1017,3 +1568,445 @@ AZ_NODISCARD az_result az_json_writer_append_end_array(az_json_writer* ref_json_
 {
   return az_json_writer_append_container_end(ref_json_writer, ']', AZ_JSON_TOKEN_END_ARRAY);
 }
+
+// Records the bytes written into the destination buffer, up to the start of remaining_json.
+AZ_INLINE void _az_json_writer_update_bytes_written(
+    az_json_writer* ref_json_writer,
+    az_span remaining_json)
+{
+  int32_t const bytes_written
+      = _az_span_diff(remaining_json, ref_json_writer->_internal.destination_buffer);
+  ref_json_writer->_internal.total_bytes_written
+      += bytes_written - ref_json_writer->_internal.bytes_written;
+  ref_json_writer->_internal.bytes_written = bytes_written;
+}
+
+// Makes sure there is room for the next element of an array within remaining_json, asking for a
+// new chunk only once the current one runs out.
+static AZ_NODISCARD az_result _az_json_writer_reserve_array_element(
+    az_json_writer* ref_json_writer,
+    az_span* ref_remaining_json,
+    int32_t required_size)
+{
+  if (az_span_size(*ref_remaining_json) < required_size)
+  {
+    _az_json_writer_update_bytes_written(ref_json_writer, *ref_remaining_json);
+    *ref_remaining_json = _get_remaining_span(ref_json_writer, required_size);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(*ref_remaining_json, required_size);
+  }
+  return AZ_OK;
+}
+
+// Returns the rest of the destination buffer following the start of an array.
+static AZ_NODISCARD az_span _az_json_writer_begin_array_elements(az_json_writer* ref_json_writer)
+{
+  return az_span_slice_to_end(
+      ref_json_writer->_internal.destination_buffer, ref_json_writer->_internal.bytes_written);
+}
+
+// Records the elements written up to the start of remaining_json, and ends the array.
+static AZ_NODISCARD az_result _az_json_writer_end_array_elements(
+    az_json_writer* ref_json_writer,
+    az_span remaining_json,
+    int32_t values_count,
+    az_json_token_kind last_token_kind)
+{
+  _az_json_writer_update_bytes_written(ref_json_writer, remaining_json);
+  if (values_count > 0)
+  {
+    _az_update_json_writer_state(ref_json_writer, 0, 0, true, last_token_kind);
+  }
+  return az_json_writer_append_end_array(ref_json_writer);
+}
+
+AZ_NODISCARD az_result az_json_writer_append_int32_array(
+    az_json_writer* ref_json_writer,
+    int32_t const values[],
+    int32_t values_count)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(values_count >= 0);
+  _az_PRECONDITION(values != NULL || values_count == 0);
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_json_writer));
+
+  az_span remaining_json = _az_json_writer_begin_array_elements(ref_json_writer);
+  for (int32_t i = 0; i < values_count; i++)
+  {
+    // Need enough space to write any 32-bit integer, and the leading comma separator.
+    _az_RETURN_IF_FAILED(_az_json_writer_reserve_array_element(
+        ref_json_writer, &remaining_json, _az_MAX_SIZE_FOR_INT32 + 1));
+
+    if (i > 0)
+    {
+      remaining_json = az_span_copy_u8(remaining_json, ',');
+    }
+    _az_RETURN_IF_FAILED(az_span_i32toa(remaining_json, values[i], &remaining_json));
+  }
+
+  return _az_json_writer_end_array_elements(
+      ref_json_writer, remaining_json, values_count, AZ_JSON_TOKEN_NUMBER);
+}
+
+AZ_NODISCARD az_result az_json_writer_append_int64_array(
+    az_json_writer* ref_json_writer,
+    int64_t const values[],
+    int32_t values_count)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(values_count >= 0);
+  _az_PRECONDITION(values != NULL || values_count == 0);
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_json_writer));
+
+  az_span remaining_json = _az_json_writer_begin_array_elements(ref_json_writer);
+  for (int32_t i = 0; i < values_count; i++)
+  {
+    // Need enough space to write any 64-bit integer, and the leading comma separator.
+    _az_RETURN_IF_FAILED(_az_json_writer_reserve_array_element(
+        ref_json_writer, &remaining_json, _az_MAX_SIZE_FOR_INT64 + 1));
+
+    if (i > 0)
+    {
+      remaining_json = az_span_copy_u8(remaining_json, ',');
+    }
+    _az_RETURN_IF_FAILED(az_span_i64toa(remaining_json, values[i], &remaining_json));
+  }
+
+  return _az_json_writer_end_array_elements(
+      ref_json_writer, remaining_json, values_count, AZ_JSON_TOKEN_NUMBER);
+}
+
+AZ_NODISCARD az_result az_json_writer_append_double_array(
+    az_json_writer* ref_json_writer,
+    double const values[],
+    int32_t values_count,
+    int32_t fractional_digits)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(values_count >= 0);
+  _az_PRECONDITION(values != NULL || values_count == 0);
+  _az_PRECONDITION_RANGE(0, fractional_digits, _az_MAX_SUPPORTED_FRACTIONAL_DIGITS);
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_json_writer));
+
+  az_span remaining_json = _az_json_writer_begin_array_elements(ref_json_writer);
+  for (int32_t i = 0; i < values_count; i++)
+  {
+    // Non-finite numbers are not supported because they lead to invalid JSON.
+    _az_PRECONDITION(_az_isfinite(values[i]));
+
+    // Need enough space to write any double number, and the leading comma separator.
+    _az_RETURN_IF_FAILED(_az_json_writer_reserve_array_element(
+        ref_json_writer, &remaining_json, _az_MAX_SIZE_FOR_WRITING_DOUBLE + 1));
+
+    if (i > 0)
+    {
+      remaining_json = az_span_copy_u8(remaining_json, ',');
+    }
+    _az_RETURN_IF_FAILED(
+        az_span_dtoa(remaining_json, values[i], fractional_digits, &remaining_json));
+  }
+
+  return _az_json_writer_end_array_elements(
+      ref_json_writer, remaining_json, values_count, AZ_JSON_TOKEN_NUMBER);
+}
+
+AZ_NODISCARD az_result az_json_writer_append_bool_array(
+    az_json_writer* ref_json_writer,
+    bool const values[],
+    int32_t values_count)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(values_count >= 0);
+  _az_PRECONDITION(values != NULL || values_count == 0);
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_json_writer));
+
+  az_span remaining_json = _az_json_writer_begin_array_elements(ref_json_writer);
+  for (int32_t i = 0; i < values_count; i++)
+  {
+    // Need enough space to write false, and the leading comma separator.
+    _az_RETURN_IF_FAILED(
+        _az_json_writer_reserve_array_element(ref_json_writer, &remaining_json, 6));
+
+    if (i > 0)
+    {
+      remaining_json = az_span_copy_u8(remaining_json, ',');
+    }
+    remaining_json = az_span_copy(
+        remaining_json, values[i] ? AZ_SPAN_FROM_STR("true") : AZ_SPAN_FROM_STR("false"));
+  }
+
+  return _az_json_writer_end_array_elements(
+      ref_json_writer,
+      remaining_json,
+      values_count,
+      values_count > 0 && values[values_count - 1] ? AZ_JSON_TOKEN_TRUE : AZ_JSON_TOKEN_FALSE);
+}
+
+AZ_NODISCARD az_result az_json_template_init(
+    az_json_template* out_json_template,
+    int32_t slot_offsets[],
+    int32_t slots_size)
+{
+  _az_PRECONDITION_NOT_NULL(out_json_template);
+  _az_PRECONDITION(slots_size >= 0);
+  _az_PRECONDITION(slot_offsets != NULL || slots_size == 0);
+
+  *out_json_template = (az_json_template){
+    ._internal = {
+      .json = AZ_SPAN_EMPTY,
+      .slot_offsets = slot_offsets,
+      .slots_size = slots_size,
+      .slot_count = 0,
+    },
+  };
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_template_append_slot(
+    az_json_template* ref_json_template,
+    az_json_writer* ref_json_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_template);
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  // The slot offsets are offsets within the one destination buffer of the writer.
+  _az_PRECONDITION(ref_json_writer->_internal.allocator_callback == NULL);
+  _az_PRECONDITION(ref_json_writer->_internal.sink_callback == NULL);
+  _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
+
+  if (ref_json_template->_internal.slot_count == ref_json_template->_internal.slots_size)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  int32_t required_size = 0;
+
+  if (ref_json_writer->_internal.need_comma)
+  {
+    required_size++; // For the leading comma separator.
+
+    az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+
+    az_span_copy_u8(remaining_json, ',');
+  }
+
+  ref_json_template->_internal.slot_offsets[ref_json_template->_internal.slot_count]
+      = ref_json_writer->_internal.bytes_written + required_size;
+  ref_json_template->_internal.slot_count++;
+
+  // Whatever value fills the slot later, the writer continues as if it had written a primitive one.
+  _az_update_json_writer_state(
+      ref_json_writer, required_size, required_size, true, AZ_JSON_TOKEN_NUMBER);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_json_template_end(az_json_template* ref_json_template, az_json_writer const* json_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_template);
+  _az_PRECONDITION_NOT_NULL(json_writer);
+  _az_PRECONDITION(json_writer->_internal.allocator_callback == NULL);
+  _az_PRECONDITION(json_writer->_internal.sink_callback == NULL);
+
+  ref_json_template->_internal.json = az_json_writer_get_bytes_used_in_destination(json_writer);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_template_writer_init(
+    az_json_template_writer* out_json_template_writer,
+    az_json_template const* json_template,
+    az_span destination_buffer)
+{
+  _az_PRECONDITION_NOT_NULL(out_json_template_writer);
+  _az_PRECONDITION_NOT_NULL(json_template);
+
+  *out_json_template_writer = (az_json_template_writer){
+    ._internal = {
+      .json_template = json_template,
+      .destination_buffer = destination_buffer,
+      .bytes_written = 0,
+      .slot_index = 0,
+    },
+  };
+  return AZ_OK;
+}
+
+// Copies the text of the template from the end of the previous slot up to the offset given, and
+// returns the remaining destination following it.
+static AZ_NODISCARD az_result _az_json_template_writer_copy_text(
+    az_json_template_writer const* json_template_writer,
+    int32_t end_offset,
+    az_span* out_remaining_json)
+{
+  az_json_template const* const json_template = json_template_writer->_internal.json_template;
+  int32_t const slot_index = json_template_writer->_internal.slot_index;
+
+  int32_t const start_offset
+      = slot_index == 0 ? 0 : json_template->_internal.slot_offsets[slot_index - 1];
+  az_span const text = az_span_slice(json_template->_internal.json, start_offset, end_offset);
+
+  az_span remaining_json = az_span_slice_to_end(
+      json_template_writer->_internal.destination_buffer,
+      json_template_writer->_internal.bytes_written);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, az_span_size(text));
+
+  *out_remaining_json = az_span_copy(remaining_json, text);
+  return AZ_OK;
+}
+
+// Copies the text of the template up to the next slot, and returns the remaining destination to
+// fill the slot into.
+static AZ_NODISCARD az_result _az_json_template_writer_copy_to_slot(
+    az_json_template_writer const* json_template_writer,
+    az_span* out_remaining_json)
+{
+  _az_PRECONDITION_NOT_NULL(json_template_writer);
+
+  az_json_template const* const json_template = json_template_writer->_internal.json_template;
+  int32_t const slot_index = json_template_writer->_internal.slot_index;
+  _az_PRECONDITION(slot_index < json_template->_internal.slot_count);
+
+  return _az_json_template_writer_copy_text(
+      json_template_writer, json_template->_internal.slot_offsets[slot_index], out_remaining_json);
+}
+
+// Moves on to the next slot, once the value filling the current one is written up to the start of
+// the remaining destination.
+static void _az_json_template_writer_end_slot(
+    az_json_template_writer* ref_json_template_writer,
+    az_span remaining_json)
+{
+  ref_json_template_writer->_internal.bytes_written
+      = _az_span_diff(remaining_json, ref_json_template_writer->_internal.destination_buffer);
+  ref_json_template_writer->_internal.slot_index++;
+}
+
+AZ_NODISCARD az_result az_json_template_writer_append_string(
+    az_json_template_writer* ref_json_template_writer,
+    az_span value)
+{
+  _az_PRECONDITION_VALID_SPAN(value, 0, true);
+
+  az_span remaining_json;
+  _az_RETURN_IF_FAILED(
+      _az_json_template_writer_copy_to_slot(ref_json_template_writer, &remaining_json));
+
+  int32_t index_of_first_escaped_char = -1;
+  int32_t const required_size
+      = 2 + _az_json_writer_escaped_length(value, &index_of_first_escaped_char, false);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+
+  remaining_json = az_span_copy_u8(remaining_json, '"');
+
+  // No character needed to be escaped, copy the whole string as is.
+  if (index_of_first_escaped_char == -1)
+  {
+    remaining_json = az_span_copy(remaining_json, value);
+  }
+  else
+  {
+    remaining_json
+        = az_span_copy(remaining_json, az_span_slice(value, 0, index_of_first_escaped_char));
+    remaining_json = _az_json_writer_escape_and_copy(
+        remaining_json, az_span_slice_to_end(value, index_of_first_escaped_char));
+  }
+
+  remaining_json = az_span_copy_u8(remaining_json, '"');
+
+  _az_json_template_writer_end_slot(ref_json_template_writer, remaining_json);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_json_template_writer_append_bool(az_json_template_writer* ref_json_template_writer, bool value)
+{
+  az_span remaining_json;
+  _az_RETURN_IF_FAILED(
+      _az_json_template_writer_copy_to_slot(ref_json_template_writer, &remaining_json));
+
+  az_span const literal = value ? AZ_SPAN_FROM_STR("true") : AZ_SPAN_FROM_STR("false");
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, az_span_size(literal));
+
+  _az_json_template_writer_end_slot(
+      ref_json_template_writer, az_span_copy(remaining_json, literal));
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_template_writer_append_int32(
+    az_json_template_writer* ref_json_template_writer,
+    int32_t value)
+{
+  az_span remaining_json;
+  _az_RETURN_IF_FAILED(
+      _az_json_template_writer_copy_to_slot(ref_json_template_writer, &remaining_json));
+
+  az_span leftover;
+  _az_RETURN_IF_FAILED(az_span_i32toa(remaining_json, value, &leftover));
+
+  _az_json_template_writer_end_slot(ref_json_template_writer, leftover);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_template_writer_append_double(
+    az_json_template_writer* ref_json_template_writer,
+    double value,
+    int32_t fractional_digits)
+{
+  // Non-finite numbers are not supported because they lead to invalid JSON.
+  _az_PRECONDITION(_az_isfinite(value));
+  _az_PRECONDITION_RANGE(0, fractional_digits, _az_MAX_SUPPORTED_FRACTIONAL_DIGITS);
+
+  az_span remaining_json;
+  _az_RETURN_IF_FAILED(
+      _az_json_template_writer_copy_to_slot(ref_json_template_writer, &remaining_json));
+
+  az_span leftover;
+  _az_RETURN_IF_FAILED(az_span_dtoa(remaining_json, value, fractional_digits, &leftover));
+
+  _az_json_template_writer_end_slot(ref_json_template_writer, leftover);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_template_writer_append_double_shortest(
+    az_json_template_writer* ref_json_template_writer,
+    double value)
+{
+  // Non-finite numbers are not supported because they lead to invalid JSON.
+  _az_PRECONDITION(_az_isfinite(value));
+
+  az_span remaining_json;
+  _az_RETURN_IF_FAILED(
+      _az_json_template_writer_copy_to_slot(ref_json_template_writer, &remaining_json));
+
+  az_span leftover;
+  _az_RETURN_IF_FAILED(az_span_dtoa_shortest(remaining_json, value, &leftover));
+
+  _az_json_template_writer_end_slot(ref_json_template_writer, leftover);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_json_template_writer_end(az_json_template_writer* ref_json_template_writer, az_span* out_json)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_template_writer);
+  _az_PRECONDITION_NOT_NULL(out_json);
+
+  az_json_template const* const json_template = ref_json_template_writer->_internal.json_template;
+  _az_PRECONDITION(
+      ref_json_template_writer->_internal.slot_index == json_template->_internal.slot_count);
+
+  az_span remaining_json;
+  _az_RETURN_IF_FAILED(_az_json_template_writer_copy_text(
+      ref_json_template_writer, az_span_size(json_template->_internal.json), &remaining_json));
+
+  int32_t const bytes_written
+      = _az_span_diff(remaining_json, ref_json_template_writer->_internal.destination_buffer);
+  ref_json_template_writer->_internal.bytes_written = bytes_written;
+
+  *out_json
+      = az_span_slice(ref_json_template_writer->_internal.destination_buffer, 0, bytes_written);
+  return AZ_OK;
+}
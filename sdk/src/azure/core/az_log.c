@@ -1,46 +1,481 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
+#include "az_http_policy_logging_private.h"
 #include "az_span_private.h"
 #include <azure/core/az_config.h>
 #include <azure/core/az_http.h>
 #include <azure/core/az_http_transport.h>
 #include <azure/core/az_log.h>
+#include <azure/core/az_platform.h>
 #include <azure/core/az_span.h>
 #include <azure/core/internal/az_http_internal.h>
 #include <azure/core/internal/az_log_internal.h>
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 #include <azure/core/_az_cfg.h>
 
 #ifndef AZ_NO_LOGGING
 
-// Only using volatile here, not for thread safety, but so that the compiler does not optimize what
-// it falsely thinks are stale reads.
+#if defined(__GNUC__) || defined(__clang__)
+#define _az_LOG_ATOMIC_LOAD_ACQUIRE(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define _az_LOG_ATOMIC_LOAD_RELAXED(ptr) __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define _az_LOG_ATOMIC_STORE_RELEASE(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#define _az_LOG_ATOMIC_COMPARE_EXCHANGE(ptr, ref_expected, desired) \
+  __atomic_compare_exchange_n(ptr, ref_expected, desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#define _az_LOG_ATOMIC_FETCH_INCREMENT(ptr) __atomic_fetch_add(ptr, 1U, __ATOMIC_RELAXED)
+#else
+// Without atomic operations, the registrations, the queue and the samplers are only safe to use
+// from a single thread.
+#define _az_LOG_ATOMIC_LOAD_ACQUIRE(ptr) (*(ptr))
+#define _az_LOG_ATOMIC_LOAD_RELAXED(ptr) (*(ptr))
+#define _az_LOG_ATOMIC_STORE_RELEASE(ptr, value) (*(ptr) = (value))
+#define _az_LOG_ATOMIC_COMPARE_EXCHANGE(ptr, ref_expected, desired) \
+  (*(ptr) == *(ref_expected) ? (*(ptr) = (desired), true) : (*(ref_expected) = *(ptr), false))
+#define _az_LOG_ATOMIC_FETCH_INCREMENT(ptr) ((*(ptr))++)
+#endif // defined(__GNUC__) || defined(__clang__)
+
+// Only using volatile here for the compilers without atomic operations, so that they do not
+// optimize what they falsely think are stale reads.
 static az_log_message_fn volatile _az_log_message_callback = NULL;
 static az_log_classification_filter_fn volatile _az_message_filter_callback = NULL;
+static az_log_queue* volatile _az_log_queue = NULL;
+#ifndef AZ_NO_HTTP
+static az_http_log_record_fn volatile _az_http_log_record_callback = NULL;
+#endif // AZ_NO_HTTP
+static az_log_sampler* volatile _az_log_samplers = NULL;
+static int32_t volatile _az_log_samplers_count = 0;
+
+/*
+ * Whether a message is written is cached, per classification, in a bitmap which is rebuilt as the
+ * callbacks are set: a classification has a bit if its facility is between 1 and 8 and its code
+ * below 4, which covers the SDK's own classifications. Checking whether to log one of them is then
+ * a single load, with no call to the filter. The other classifications ask the filter every time.
+ */
+enum
+{
+  _az_LOG_ENABLED_FACILITIES = 8,
+  _az_LOG_ENABLED_CODES = 4,
+};
+
+static uint32_t volatile _az_log_enabled = 0;
+static int32_t volatile _az_log_registration_lock = 0;
+
+// Returns the bit of the classification in _az_log_enabled, or -1 if it has none.
+AZ_INLINE int32_t _az_log_get_enabled_bit(az_log_classification classification)
+{
+  uint32_t const facility = (uint32_t)classification >> 16U;
+  uint32_t const code = (uint32_t)classification & 0xFFFFU;
+  if (facility == 0 || facility > _az_LOG_ENABLED_FACILITIES || code >= _az_LOG_ENABLED_CODES)
+  {
+    return -1;
+  }
+
+  return (int32_t)((facility - 1U) * _az_LOG_ENABLED_CODES + code);
+}
+
+// Setters are serialized, so that the bitmap always matches the last callbacks set.
+static void _az_log_lock_registration(void)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  while (__atomic_exchange_n(&_az_log_registration_lock, 1, __ATOMIC_ACQUIRE) != 0)
+  {
+    while (__atomic_load_n(&_az_log_registration_lock, __ATOMIC_RELAXED) != 0)
+    {
+    }
+  }
+#endif // defined(__GNUC__) || defined(__clang__)
+}
+
+static void _az_log_unlock_registration(void)
+{
+  _az_LOG_ATOMIC_STORE_RELEASE(&_az_log_registration_lock, 0);
+}
+
+// Rebuilds the bitmap from the callbacks. Called with the registration lock held.
+static void _az_log_update_enabled(void)
+{
+  az_log_message_fn const message_callback = _az_LOG_ATOMIC_LOAD_RELAXED(&_az_log_message_callback);
+  az_log_classification_filter_fn const message_filter_callback
+      = _az_LOG_ATOMIC_LOAD_RELAXED(&_az_message_filter_callback);
+
+  uint32_t enabled = 0;
+  if (message_callback != NULL)
+  {
+    for (uint32_t facility = 1; facility <= _az_LOG_ENABLED_FACILITIES; facility++)
+    {
+      for (uint32_t code = 0; code < _az_LOG_ENABLED_CODES; code++)
+      {
+        az_log_classification const classification = _az_LOG_MAKE_CLASSIFICATION(facility, code);
+        if (message_filter_callback == NULL || message_filter_callback(classification))
+        {
+          enabled |= 1U << (uint32_t)_az_log_get_enabled_bit(classification);
+        }
+      }
+    }
+  }
+
+  _az_LOG_ATOMIC_STORE_RELEASE(&_az_log_enabled, enabled);
+}
 
 void az_log_set_message_callback(az_log_message_fn log_message_callback)
 {
-  // We assume assignments are atomic for the supported platforms and compilers.
-  _az_log_message_callback = log_message_callback;
+  _az_log_lock_registration();
+  _az_LOG_ATOMIC_STORE_RELEASE(&_az_log_message_callback, log_message_callback);
+  _az_log_update_enabled();
+  _az_log_unlock_registration();
 }
 
 void az_log_set_classification_filter_callback(
     az_log_classification_filter_fn message_filter_callback)
 {
-  // We assume assignments are atomic for the supported platforms and compilers.
-  _az_message_filter_callback = message_filter_callback;
+  _az_log_lock_registration();
+  _az_LOG_ATOMIC_STORE_RELEASE(&_az_message_filter_callback, message_filter_callback);
+  _az_log_update_enabled();
+  _az_log_unlock_registration();
+}
+
+#ifndef AZ_NO_HTTP
+void az_http_log_set_record_callback(az_http_log_record_fn record_callback)
+{
+  _az_LOG_ATOMIC_STORE_RELEASE(&_az_http_log_record_callback, record_callback);
+}
+#endif // AZ_NO_HTTP
+
+/*
+ * The log queue is a bounded multi-producer queue (after Dmitry Vyukov's), in which every record
+ * has a sequence number telling whether it is free for the enqueue at a position, or holds the
+ * message for the dequeue at that position. Producers claim a position with a compare-exchange on
+ * the enqueue position, write the record, then publish it by updating its sequence number.
+ */
+
+typedef struct
+{
+  uint32_t sequence;
+  az_log_classification classification;
+  int32_t size;
+} _az_log_queue_record_header;
+
+enum
+{
+  _az_LOG_QUEUE_ALIGNMENT = 8,
+};
+
+static _az_log_queue_record_header* _az_log_queue_get_record(
+    az_log_queue const* queue,
+    uint32_t position)
+{
+  size_t const index = (size_t)(position & queue->_internal.mask);
+  return (_az_log_queue_record_header*)(void*)(queue->_internal.records
+                                               + index * (size_t)queue->_internal.record_size);
+}
+
+AZ_NODISCARD az_result
+az_log_queue_init(az_log_queue* out_queue, az_span buffer, int32_t max_message_size)
+{
+  _az_PRECONDITION_NOT_NULL(out_queue);
+  _az_PRECONDITION_VALID_SPAN(buffer, 0, true);
+  _az_PRECONDITION(max_message_size > 0);
+
+  int32_t const header_size = (int32_t)sizeof(_az_log_queue_record_header);
+  int32_t const record_size
+      = ((header_size + max_message_size + _az_LOG_QUEUE_ALIGNMENT - 1) / _az_LOG_QUEUE_ALIGNMENT)
+      * _az_LOG_QUEUE_ALIGNMENT;
+
+  uint8_t* const ptr = az_span_ptr(buffer);
+  int32_t const padding = (int32_t)((_az_LOG_QUEUE_ALIGNMENT
+                                     - ((uintptr_t)ptr % _az_LOG_QUEUE_ALIGNMENT))
+                                    % _az_LOG_QUEUE_ALIGNMENT);
+  int32_t const available = az_span_size(buffer) - padding;
+  if (available < 2 * record_size)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  uint32_t capacity = 2;
+  while (capacity <= (uint32_t)(available / record_size) / 2U)
+  {
+    capacity *= 2U;
+  }
+
+  *out_queue = (az_log_queue){ ._internal = {
+                                   .records = ptr + padding,
+                                   .record_size = record_size,
+                                   .max_message_size = max_message_size,
+                                   .mask = capacity - 1U,
+                                   .enqueue_position = 0,
+                                   .dequeue_position = 0,
+                                   .dropped = 0,
+                               } };
+
+  // Every record is free for the enqueue at its own position.
+  for (uint32_t position = 0; position < capacity; position++)
+  {
+    _az_log_queue_get_record(out_queue, position)->sequence = position;
+  }
+
+  return AZ_OK;
+}
+
+static void _az_log_queue_enqueue(
+    az_log_queue* ref_queue,
+    az_log_classification classification,
+    az_span message)
+{
+  uint32_t position = _az_LOG_ATOMIC_LOAD_RELAXED(&ref_queue->_internal.enqueue_position);
+  _az_log_queue_record_header* record = NULL;
+  while (true)
+  {
+    record = _az_log_queue_get_record(ref_queue, position);
+    int32_t const difference
+        = (int32_t)(_az_LOG_ATOMIC_LOAD_ACQUIRE(&record->sequence) - position);
+    if (difference == 0)
+    {
+      if (_az_LOG_ATOMIC_COMPARE_EXCHANGE(
+              &ref_queue->_internal.enqueue_position, &position, position + 1U))
+      {
+        break;
+      }
+    }
+    else if (difference < 0)
+    {
+      // The record still holds the message from one lap before, the queue is full.
+      _az_LOG_ATOMIC_FETCH_INCREMENT(&ref_queue->_internal.dropped);
+      return;
+    }
+    else
+    {
+      position = _az_LOG_ATOMIC_LOAD_RELAXED(&ref_queue->_internal.enqueue_position);
+    }
+  }
+
+  int32_t const size = az_span_size(message) < ref_queue->_internal.max_message_size
+      ? az_span_size(message)
+      : ref_queue->_internal.max_message_size;
+  record->classification = classification;
+  record->size = size;
+  if (size > 0)
+  {
+    memcpy(record + 1, az_span_ptr(message), (size_t)size);
+  }
+
+  _az_LOG_ATOMIC_STORE_RELEASE(&record->sequence, position + 1U);
+}
+
+int32_t az_log_queue_drain(az_log_queue* ref_queue, int32_t max_messages)
+{
+  _az_PRECONDITION_NOT_NULL(ref_queue);
+  _az_PRECONDITION(max_messages >= -1);
+
+  int32_t count = 0;
+  uint32_t position = ref_queue->_internal.dequeue_position;
+  while (max_messages < 0 || count < max_messages)
+  {
+    _az_log_queue_record_header* const record = _az_log_queue_get_record(ref_queue, position);
+    if (_az_LOG_ATOMIC_LOAD_ACQUIRE(&record->sequence) != position + 1U)
+    {
+      // Either empty, or the producer that claimed this record is still writing it.
+      break;
+    }
+
+    az_log_message_fn const message_callback
+        = _az_LOG_ATOMIC_LOAD_ACQUIRE(&_az_log_message_callback);
+    if (message_callback != NULL)
+    {
+      message_callback(
+          record->classification, az_span_create((uint8_t*)(record + 1), record->size));
+    }
+
+    // Free the record for the enqueue one lap later.
+    _az_LOG_ATOMIC_STORE_RELEASE(&record->sequence, position + ref_queue->_internal.mask + 1U);
+    position++;
+    count++;
+  }
+
+  ref_queue->_internal.dequeue_position = position;
+  return count;
+}
+
+AZ_NODISCARD uint32_t az_log_queue_get_dropped(az_log_queue const* queue)
+{
+  _az_PRECONDITION_NOT_NULL(queue);
+  return _az_LOG_ATOMIC_LOAD_RELAXED(&queue->_internal.dropped);
+}
+
+void az_log_set_queue(az_log_queue* queue)
+{
+  _az_LOG_ATOMIC_STORE_RELEASE(&_az_log_queue, queue);
+}
+
+/*
+ * The rate limit of a sampler is a token bucket, kept as the time at which it would be full again
+ * (the generic cell rate algorithm), so that a single compare-exchange updates it. Time is counted
+ * in ticks of 1/(1000 * max_per_second) seconds, in which each message costs 1000 ticks. The ticks
+ * wrap around, which is fine since the arrival time of a used bucket is never more than
+ * max_burst_ticks ahead of the clock: anything else means the bucket has been full for a while.
+ */
+enum
+{
+  _az_LOG_SAMPLER_TICKS_PER_MESSAGE = 1000,
+  _az_LOG_SAMPLER_MAX_VALUE = 1000000,
+};
+
+AZ_NODISCARD az_result az_log_sampler_init(
+    az_log_sampler* out_sampler,
+    az_log_classification classification,
+    int32_t sample_rate,
+    int32_t max_per_second,
+    int32_t max_burst)
+{
+  _az_PRECONDITION_NOT_NULL(out_sampler);
+  _az_PRECONDITION(classification > 0);
+  _az_PRECONDITION_RANGE(1, sample_rate, _az_LOG_SAMPLER_MAX_VALUE);
+  _az_PRECONDITION_RANGE(0, max_per_second, _az_LOG_SAMPLER_MAX_VALUE);
+  _az_PRECONDITION_RANGE(1, max_burst, _az_LOG_SAMPLER_MAX_VALUE);
+
+  *out_sampler = (az_log_sampler){
+    ._internal = {
+      .classification = classification,
+      .sample_rate = (uint32_t)sample_rate,
+      .max_per_second = (uint32_t)max_per_second,
+      .max_burst_ticks = (uint32_t)max_burst * _az_LOG_SAMPLER_TICKS_PER_MESSAGE,
+      .count = 0,
+      .theoretical_arrival_ticks = 0,
+      .suppressed = 0,
+    },
+  };
+
+  return AZ_OK;
+}
+
+void az_log_set_samplers(az_log_sampler* samplers, int32_t samplers_count)
+{
+  _az_PRECONDITION(samplers_count >= 0);
+  _az_PRECONDITION(samplers != NULL || samplers_count == 0);
+
+  // The array and its count are separate stores, so a thread logging while they change could pair
+  // one with the other, and concurrent calls could leave them mismatched. Setting the samplers is
+  // therefore not supported while other threads log or set them. Clearing the array first only
+  // keeps a message logged in between, from a callback for instance, from using a stale count.
+  _az_LOG_ATOMIC_STORE_RELEASE(&_az_log_samplers, NULL);
+  _az_LOG_ATOMIC_STORE_RELEASE(&_az_log_samplers_count, samplers == NULL ? 0 : samplers_count);
+  _az_LOG_ATOMIC_STORE_RELEASE(&_az_log_samplers, samplers);
+}
+
+AZ_NODISCARD uint32_t az_log_sampler_get_suppressed(az_log_sampler const* sampler)
+{
+  _az_PRECONDITION_NOT_NULL(sampler);
+  return _az_LOG_ATOMIC_LOAD_RELAXED(&sampler->_internal.suppressed);
+}
+
+static az_log_sampler* _az_log_get_sampler(az_log_classification classification)
+{
+  az_log_sampler* const samplers = _az_LOG_ATOMIC_LOAD_ACQUIRE(&_az_log_samplers);
+  if (samplers != NULL)
+  {
+    int32_t const samplers_count = _az_LOG_ATOMIC_LOAD_ACQUIRE(&_az_log_samplers_count);
+    for (int32_t i = 0; i < samplers_count; ++i)
+    {
+      if (samplers[i]._internal.classification == classification)
+      {
+        return &samplers[i];
+      }
+    }
+  }
+
+  return NULL;
+}
+
+// Returns whether the rate limit of the sampler has room for a message. If so, and take is true,
+// the message is counted against the limit.
+static bool _az_log_sampler_has_room(az_log_sampler* ref_sampler, bool take)
+{
+  int64_t now_msec = 0;
+  if (ref_sampler->_internal.max_per_second == 0
+      || az_result_failed(az_platform_clock_msec(&now_msec)))
+  {
+    return true;
+  }
+
+  uint32_t const now
+      = (uint32_t)((uint64_t)now_msec * (uint64_t)ref_sampler->_internal.max_per_second);
+  uint32_t const max_burst_ticks = ref_sampler->_internal.max_burst_ticks;
+
+  uint32_t arrival
+      = _az_LOG_ATOMIC_LOAD_RELAXED(&ref_sampler->_internal.theoretical_arrival_ticks);
+  for (;;)
+  {
+    uint32_t ahead = arrival - now;
+    if ((int32_t)ahead < 0 || ahead > max_burst_ticks)
+    {
+      // The bucket is full.
+      ahead = 0;
+    }
+
+    if (ahead + (uint32_t)_az_LOG_SAMPLER_TICKS_PER_MESSAGE > max_burst_ticks)
+    {
+      return false;
+    }
+
+    if (!take
+        || _az_LOG_ATOMIC_COMPARE_EXCHANGE(
+            &ref_sampler->_internal.theoretical_arrival_ticks,
+            &arrival,
+            now + ahead + (uint32_t)_az_LOG_SAMPLER_TICKS_PER_MESSAGE))
+    {
+      return true;
+    }
+  }
+}
+
+// Returns whether the sampler of the classification, if any, would keep a message, without
+// counting it. Used to skip formatting messages which would be suppressed anyway.
+static bool _az_log_sampler_would_keep(az_log_classification classification)
+{
+  az_log_sampler* const sampler = _az_log_get_sampler(classification);
+  return sampler == NULL || _az_log_sampler_has_room(sampler, false);
+}
+
+bool _az_log_sampler_keep(az_log_classification classification)
+{
+  az_log_sampler* const sampler = _az_log_get_sampler(classification);
+  if (sampler == NULL)
+  {
+    return true;
+  }
+
+  uint32_t const count = _az_LOG_ATOMIC_FETCH_INCREMENT(&sampler->_internal.count);
+  if (count % sampler->_internal.sample_rate == 0 && _az_log_sampler_has_room(sampler, true))
+  {
+    return true;
+  }
+
+  _az_LOG_ATOMIC_FETCH_INCREMENT(&sampler->_internal.suppressed);
+  return false;
 }
 
 AZ_INLINE az_log_message_fn _az_log_get_message_callback(az_log_classification classification)
 {
   _az_PRECONDITION(classification > 0);
 
+  // The hot path: a classification with a bit is only looked up in the bitmap, and when it is off,
+  // which is the common case, nothing else is read.
+  int32_t const enabled_bit = _az_log_get_enabled_bit(classification);
+  if (enabled_bit >= 0)
+  {
+    return (_az_LOG_ATOMIC_LOAD_RELAXED(&_az_log_enabled) & (1U << (uint32_t)enabled_bit)) != 0
+        ? _az_LOG_ATOMIC_LOAD_ACQUIRE(&_az_log_message_callback)
+        : NULL;
+  }
+
   // Copy the volatile fields to local variables so that they don't change within this function.
-  az_log_message_fn const message_callback = _az_log_message_callback;
-  az_log_classification_filter_fn const message_filter_callback = _az_message_filter_callback;
+  az_log_message_fn const message_callback
+      = _az_LOG_ATOMIC_LOAD_ACQUIRE(&_az_log_message_callback);
+  az_log_classification_filter_fn const message_filter_callback
+      = _az_LOG_ATOMIC_LOAD_ACQUIRE(&_az_message_filter_callback);
 
   // If the user hasn't registered a message_filter_callback, then we log everything, as long as a
   // message_callback method was provided.
@@ -59,9 +494,37 @@ AZ_INLINE az_log_message_fn _az_log_get_message_callback(az_log_classification c
 // This function returns whether or not the passed-in message should be logged.
 bool _az_log_should_write(az_log_classification classification)
 {
-  return _az_log_get_message_callback(classification) != NULL;
+  return _az_log_get_message_callback(classification) != NULL
+      && _az_log_sampler_would_keep(classification);
 }
 
+#ifndef AZ_NO_HTTP
+az_http_log_record_fn _az_http_log_get_record_callback(az_log_classification classification)
+{
+  _az_PRECONDITION(classification > 0);
+
+  az_http_log_record_fn const record_callback
+      = _az_LOG_ATOMIC_LOAD_ACQUIRE(&_az_http_log_record_callback);
+  az_log_classification_filter_fn const message_filter_callback
+      = _az_LOG_ATOMIC_LOAD_ACQUIRE(&_az_message_filter_callback);
+
+  if (record_callback != NULL
+      && (message_filter_callback == NULL || message_filter_callback(classification)))
+  {
+    return record_callback;
+  }
+
+  return NULL;
+}
+
+bool _az_http_log_should_write(az_log_classification classification)
+{
+  return (_az_log_get_message_callback(classification) != NULL
+          || _az_http_log_get_record_callback(classification) != NULL)
+      && _az_log_sampler_would_keep(classification);
+}
+#endif // AZ_NO_HTTP
+
 // This function attempts to log the passed-in message.
 void _az_log_write(az_log_classification classification, az_span message)
 {
@@ -69,9 +532,17 @@ void _az_log_write(az_log_classification classification, az_span message)
 
   az_log_message_fn const message_callback = _az_log_get_message_callback(classification);
 
-  if (message_callback != NULL)
+  if (message_callback != NULL && _az_log_sampler_keep(classification))
   {
-    message_callback(classification, message);
+    az_log_queue* const queue = _az_LOG_ATOMIC_LOAD_ACQUIRE(&_az_log_queue);
+    if (queue != NULL)
+    {
+      _az_log_queue_enqueue(queue, classification, message);
+    }
+    else
+    {
+      message_callback(classification, message);
+    }
   }
 }
 
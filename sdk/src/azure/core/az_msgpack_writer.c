@@ -0,0 +1,408 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_json_private.h"
+#include <azure/core/az_json.h>
+#include <azure/core/az_msgpack.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+
+#include <string.h>
+
+#include <azure/core/_az_cfg.h>
+
+// The first bytes of the MessagePack formats used by the writer.
+enum
+{
+  _az_MSGPACK_NIL = 0xc0,
+  _az_MSGPACK_FALSE = 0xc2,
+  _az_MSGPACK_TRUE = 0xc3,
+  _az_MSGPACK_FLOAT32 = 0xca,
+  _az_MSGPACK_FLOAT64 = 0xcb,
+  _az_MSGPACK_UINT8 = 0xcc,
+  _az_MSGPACK_INT8 = 0xd0,
+  _az_MSGPACK_STR8 = 0xd9,
+  _az_MSGPACK_ARRAY16 = 0xdc,
+  _az_MSGPACK_MAP16 = 0xde,
+
+  _az_MSGPACK_POSITIVE_FIXINT_MAX = 0x7f,
+  _az_MSGPACK_NEGATIVE_FIXINT_MIN = -32,
+  _az_MSGPACK_FIXMAP = 0x80,
+  _az_MSGPACK_FIXARRAY = 0x90,
+  _az_MSGPACK_FIXSTR = 0xa0,
+  _az_MSGPACK_FIXMAP_MAX_COUNT = 15,
+  _az_MSGPACK_FIXSTR_MAX_SIZE = 31,
+
+  // The space reserved at the start of a map or an array for its largest header: map32 or array32.
+  _az_MSGPACK_CONTAINER_HEADER_MAX_SIZE = 5,
+};
+
+AZ_NODISCARD az_result
+az_msgpack_writer_init(az_msgpack_writer* out_msgpack_writer, az_span destination_buffer)
+{
+  _az_PRECONDITION_NOT_NULL(out_msgpack_writer);
+
+  *out_msgpack_writer = (az_msgpack_writer){
+    ._internal = {
+      .destination_buffer = destination_buffer,
+      .bytes_written = 0,
+      .token_kind = AZ_JSON_TOKEN_NONE,
+    },
+  };
+
+  _az_json_stack_init(&out_msgpack_writer->_internal.bit_stack, NULL, 0);
+  return AZ_OK;
+}
+
+// Writes the value in big endian order, in the given number of bytes.
+static void _az_msgpack_write_big_endian(uint8_t* destination, uint64_t value, int32_t size)
+{
+  for (int32_t i = size - 1; i >= 0; i--)
+  {
+    destination[i] = (uint8_t)value;
+    value >>= 8;
+  }
+}
+
+AZ_NODISCARD static az_span
+_az_msgpack_writer_get_remaining_span(az_msgpack_writer const* msgpack_writer)
+{
+  return az_span_slice_to_end(
+      msgpack_writer->_internal.destination_buffer, msgpack_writer->_internal.bytes_written);
+}
+
+// Counts the item about to be written as an element of the array the writer is within, if any.
+// The entries of a map are counted with their property name.
+static void _az_msgpack_writer_count_value(az_msgpack_writer* ref_msgpack_writer)
+{
+  int32_t const depth = ref_msgpack_writer->_internal.bit_stack._internal.current_depth;
+  if (depth > 0
+      && _az_json_stack_peek(&ref_msgpack_writer->_internal.bit_stack) == _az_JSON_STACK_ARRAY)
+  {
+    ref_msgpack_writer->_internal.container_counts[depth - 1]++;
+  }
+}
+
+// Writes a value made of a one byte format, followed by an argument of argument_size bytes in big
+// endian order.
+AZ_NODISCARD static az_result _az_msgpack_writer_append_value(
+    az_msgpack_writer* ref_msgpack_writer,
+    uint8_t format,
+    uint64_t argument,
+    int32_t argument_size,
+    az_json_token_kind token_kind)
+{
+  _az_PRECONDITION(_az_json_writer_is_appending_value_valid(
+      &ref_msgpack_writer->_internal.bit_stack, ref_msgpack_writer->_internal.token_kind));
+
+  int32_t const required_size = 1 + argument_size;
+  az_span remaining = _az_msgpack_writer_get_remaining_span(ref_msgpack_writer);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining, required_size);
+
+  uint8_t* destination = az_span_ptr(remaining);
+  destination[0] = format;
+  _az_msgpack_write_big_endian(destination + 1, argument, argument_size);
+
+  _az_msgpack_writer_count_value(ref_msgpack_writer);
+  ref_msgpack_writer->_internal.bytes_written += required_size;
+  ref_msgpack_writer->_internal.token_kind = token_kind;
+  return AZ_OK;
+}
+
+// Writes a string with its header, as a value or as the key of a map entry.
+AZ_NODISCARD static az_result _az_msgpack_writer_append_str(
+    az_msgpack_writer* ref_msgpack_writer,
+    az_span value,
+    az_json_token_kind token_kind)
+{
+  int32_t const size = az_span_size(value);
+
+  int32_t header_size;
+  uint8_t format;
+  if (size <= _az_MSGPACK_FIXSTR_MAX_SIZE)
+  {
+    header_size = 1;
+    format = (uint8_t)(_az_MSGPACK_FIXSTR | size);
+  }
+  else if (size <= UINT8_MAX)
+  {
+    header_size = 2;
+    format = _az_MSGPACK_STR8;
+  }
+  else if (size <= UINT16_MAX)
+  {
+    header_size = 3;
+    format = _az_MSGPACK_STR8 + 1;
+  }
+  else
+  {
+    header_size = 5;
+    format = _az_MSGPACK_STR8 + 2;
+  }
+
+  az_span remaining = _az_msgpack_writer_get_remaining_span(ref_msgpack_writer);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining, header_size + size);
+
+  uint8_t* destination = az_span_ptr(remaining);
+  destination[0] = format;
+  _az_msgpack_write_big_endian(destination + 1, (uint64_t)size, header_size - 1);
+  az_span_copy(az_span_slice_to_end(remaining, header_size), value);
+
+  ref_msgpack_writer->_internal.bytes_written += header_size + size;
+  ref_msgpack_writer->_internal.token_kind = token_kind;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_msgpack_writer_append_string(az_msgpack_writer* ref_msgpack_writer, az_span value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_msgpack_writer);
+  _az_PRECONDITION_VALID_SPAN(value, 0, true);
+  _az_PRECONDITION(_az_json_writer_is_appending_value_valid(
+      &ref_msgpack_writer->_internal.bit_stack, ref_msgpack_writer->_internal.token_kind));
+
+  _az_RETURN_IF_FAILED(
+      _az_msgpack_writer_append_str(ref_msgpack_writer, value, AZ_JSON_TOKEN_STRING));
+
+  _az_msgpack_writer_count_value(ref_msgpack_writer);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_msgpack_writer_append_property_name(az_msgpack_writer* ref_msgpack_writer, az_span name)
+{
+  _az_PRECONDITION_NOT_NULL(ref_msgpack_writer);
+  _az_PRECONDITION_VALID_SPAN(name, 0, true);
+  _az_PRECONDITION(_az_json_writer_is_appending_property_name_valid(
+      &ref_msgpack_writer->_internal.bit_stack, ref_msgpack_writer->_internal.token_kind));
+
+  _az_RETURN_IF_FAILED(
+      _az_msgpack_writer_append_str(ref_msgpack_writer, name, AZ_JSON_TOKEN_PROPERTY_NAME));
+
+  int32_t const depth = ref_msgpack_writer->_internal.bit_stack._internal.current_depth;
+  ref_msgpack_writer->_internal.container_counts[depth - 1]++;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_msgpack_writer_append_bool(az_msgpack_writer* ref_msgpack_writer, bool value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_msgpack_writer);
+
+  if (value)
+  {
+    return _az_msgpack_writer_append_value(
+        ref_msgpack_writer, _az_MSGPACK_TRUE, 0, 0, AZ_JSON_TOKEN_TRUE);
+  }
+
+  return _az_msgpack_writer_append_value(
+      ref_msgpack_writer, _az_MSGPACK_FALSE, 0, 0, AZ_JSON_TOKEN_FALSE);
+}
+
+AZ_NODISCARD az_result
+az_msgpack_writer_append_uint64(az_msgpack_writer* ref_msgpack_writer, uint64_t value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_msgpack_writer);
+
+  if (value <= _az_MSGPACK_POSITIVE_FIXINT_MAX)
+  {
+    return _az_msgpack_writer_append_value(
+        ref_msgpack_writer, (uint8_t)value, 0, 0, AZ_JSON_TOKEN_NUMBER);
+  }
+
+  // uint8, uint16, uint32 and uint64 follow each other.
+  uint8_t format = _az_MSGPACK_UINT8;
+  int32_t size = 1;
+  while (size < 8 && value > (UINT64_MAX >> (64 - 8 * size)))
+  {
+    format++;
+    size *= 2;
+  }
+
+  return _az_msgpack_writer_append_value(
+      ref_msgpack_writer, format, value, size, AZ_JSON_TOKEN_NUMBER);
+}
+
+AZ_NODISCARD az_result
+az_msgpack_writer_append_int64(az_msgpack_writer* ref_msgpack_writer, int64_t value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_msgpack_writer);
+
+  if (value >= 0)
+  {
+    return az_msgpack_writer_append_uint64(ref_msgpack_writer, (uint64_t)value);
+  }
+
+  if (value >= _az_MSGPACK_NEGATIVE_FIXINT_MIN)
+  {
+    return _az_msgpack_writer_append_value(
+        ref_msgpack_writer, (uint8_t)value, 0, 0, AZ_JSON_TOKEN_NUMBER);
+  }
+
+  // int8, int16, int32 and int64 follow each other, holding the two's complement of the value.
+  uint8_t format = _az_MSGPACK_INT8;
+  int32_t size = 1;
+  while (size < 8 && value < -(INT64_C(1) << (8 * size - 1)))
+  {
+    format++;
+    size *= 2;
+  }
+
+  return _az_msgpack_writer_append_value(
+      ref_msgpack_writer, format, (uint64_t)value, size, AZ_JSON_TOKEN_NUMBER);
+}
+
+AZ_NODISCARD az_result
+az_msgpack_writer_append_int32(az_msgpack_writer* ref_msgpack_writer, int32_t value)
+{
+  return az_msgpack_writer_append_int64(ref_msgpack_writer, value);
+}
+
+AZ_NODISCARD az_result
+az_msgpack_writer_append_double(az_msgpack_writer* ref_msgpack_writer, double value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_msgpack_writer);
+
+  uint64_t double_bits;
+  memcpy(&double_bits, &value, sizeof(double_bits));
+
+  // The value is compared bitwise after a round trip through a 32-bit float, which also tells -0.0
+  // apart. NaN is written as a 32-bit float regardless of its payload.
+  float const single_value = (float)value;
+  double const round_trip_value = (double)single_value;
+  uint64_t round_trip_bits;
+  memcpy(&round_trip_bits, &round_trip_value, sizeof(round_trip_bits));
+
+  bool const is_nan = (double_bits & 0x7FF0000000000000) == 0x7FF0000000000000
+      && (double_bits & 0x000FFFFFFFFFFFFF) != 0;
+
+  if (is_nan || round_trip_bits == double_bits)
+  {
+    uint32_t float_bits;
+    memcpy(&float_bits, &single_value, sizeof(float_bits));
+    return _az_msgpack_writer_append_value(
+        ref_msgpack_writer, _az_MSGPACK_FLOAT32, float_bits, 4, AZ_JSON_TOKEN_NUMBER);
+  }
+
+  return _az_msgpack_writer_append_value(
+      ref_msgpack_writer, _az_MSGPACK_FLOAT64, double_bits, 8, AZ_JSON_TOKEN_NUMBER);
+}
+
+AZ_NODISCARD az_result az_msgpack_writer_append_null(az_msgpack_writer* ref_msgpack_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_msgpack_writer);
+
+  return _az_msgpack_writer_append_value(
+      ref_msgpack_writer, _az_MSGPACK_NIL, 0, 0, AZ_JSON_TOKEN_NULL);
+}
+
+AZ_NODISCARD static az_result _az_msgpack_writer_append_container_start(
+    az_msgpack_writer* ref_msgpack_writer,
+    az_json_token_kind container_kind)
+{
+  _az_PRECONDITION_NOT_NULL(ref_msgpack_writer);
+  _az_PRECONDITION(
+      container_kind == AZ_JSON_TOKEN_BEGIN_OBJECT || container_kind == AZ_JSON_TOKEN_BEGIN_ARRAY);
+  _az_PRECONDITION(_az_json_writer_is_appending_value_valid(
+      &ref_msgpack_writer->_internal.bit_stack, ref_msgpack_writer->_internal.token_kind));
+
+  int32_t const depth = ref_msgpack_writer->_internal.bit_stack._internal.current_depth;
+  if (depth >= _az_MSGPACK_WRITER_MAX_NESTING_DEPTH)
+  {
+    return AZ_ERROR_JSON_NESTING_OVERFLOW;
+  }
+
+  // The header is written once the number of entries is known.
+  az_span remaining = _az_msgpack_writer_get_remaining_span(ref_msgpack_writer);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining, _az_MSGPACK_CONTAINER_HEADER_MAX_SIZE);
+
+  _az_msgpack_writer_count_value(ref_msgpack_writer);
+
+  ref_msgpack_writer->_internal.container_offsets[depth]
+      = ref_msgpack_writer->_internal.bytes_written;
+  ref_msgpack_writer->_internal.container_counts[depth] = 0;
+  ref_msgpack_writer->_internal.bytes_written += _az_MSGPACK_CONTAINER_HEADER_MAX_SIZE;
+  ref_msgpack_writer->_internal.token_kind = container_kind;
+  _az_json_stack_push(
+      &ref_msgpack_writer->_internal.bit_stack,
+      container_kind == AZ_JSON_TOKEN_BEGIN_OBJECT ? _az_JSON_STACK_OBJECT : _az_JSON_STACK_ARRAY);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_msgpack_writer_append_begin_object(az_msgpack_writer* ref_msgpack_writer)
+{
+  return _az_msgpack_writer_append_container_start(ref_msgpack_writer, AZ_JSON_TOKEN_BEGIN_OBJECT);
+}
+
+AZ_NODISCARD az_result az_msgpack_writer_append_begin_array(az_msgpack_writer* ref_msgpack_writer)
+{
+  return _az_msgpack_writer_append_container_start(ref_msgpack_writer, AZ_JSON_TOKEN_BEGIN_ARRAY);
+}
+
+AZ_NODISCARD static az_result _az_msgpack_writer_append_container_end(
+    az_msgpack_writer* ref_msgpack_writer,
+    az_json_token_kind container_kind)
+{
+  _az_PRECONDITION_NOT_NULL(ref_msgpack_writer);
+  _az_PRECONDITION(
+      container_kind == AZ_JSON_TOKEN_END_OBJECT || container_kind == AZ_JSON_TOKEN_END_ARRAY);
+
+  bool const is_object = container_kind == AZ_JSON_TOKEN_END_OBJECT;
+  _az_PRECONDITION(_az_json_writer_is_appending_container_end_valid(
+      &ref_msgpack_writer->_internal.bit_stack,
+      ref_msgpack_writer->_internal.token_kind,
+      is_object ? _az_JSON_STACK_OBJECT : _az_JSON_STACK_ARRAY));
+
+  int32_t const depth = ref_msgpack_writer->_internal.bit_stack._internal.current_depth;
+  int32_t const offset = ref_msgpack_writer->_internal.container_offsets[depth - 1];
+  uint32_t const count = ref_msgpack_writer->_internal.container_counts[depth - 1];
+
+  // fixmap and fixarray hold the count in their first byte, then map16/array16 and map32/array32
+  // follow each other.
+  int32_t header_size;
+  uint8_t format;
+  if (count <= _az_MSGPACK_FIXMAP_MAX_COUNT)
+  {
+    header_size = 1;
+    format = (uint8_t)((is_object ? _az_MSGPACK_FIXMAP : _az_MSGPACK_FIXARRAY) | count);
+  }
+  else
+  {
+    header_size = count <= UINT16_MAX ? 3 : 5;
+    format = (uint8_t)((is_object ? _az_MSGPACK_MAP16 : _az_MSGPACK_ARRAY16) + header_size / 4);
+  }
+
+  // Move the entries back over the part of the reserved space the header doesn't need.
+  uint8_t* const header = az_span_ptr(ref_msgpack_writer->_internal.destination_buffer) + offset;
+  int32_t const unused_size = _az_MSGPACK_CONTAINER_HEADER_MAX_SIZE - header_size;
+  if (unused_size > 0)
+  {
+    int32_t const entries_size = ref_msgpack_writer->_internal.bytes_written - offset
+        - _az_MSGPACK_CONTAINER_HEADER_MAX_SIZE;
+    memmove(
+        header + header_size,
+        header + _az_MSGPACK_CONTAINER_HEADER_MAX_SIZE,
+        (size_t)entries_size);
+  }
+
+  header[0] = format;
+  _az_msgpack_write_big_endian(header + 1, count, header_size - 1);
+
+  ref_msgpack_writer->_internal.bytes_written -= unused_size;
+  ref_msgpack_writer->_internal.token_kind = container_kind;
+  _az_json_stack_pop(&ref_msgpack_writer->_internal.bit_stack);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_msgpack_writer_append_end_object(az_msgpack_writer* ref_msgpack_writer)
+{
+  return _az_msgpack_writer_append_container_end(ref_msgpack_writer, AZ_JSON_TOKEN_END_OBJECT);
+}
+
+AZ_NODISCARD az_result az_msgpack_writer_append_end_array(az_msgpack_writer* ref_msgpack_writer)
+{
+  return _az_msgpack_writer_append_container_end(ref_msgpack_writer, AZ_JSON_TOKEN_END_ARRAY);
+}
@@ -16,12 +16,23 @@ static void az_precondition_failed_default()
 
 az_precondition_failed_fn _az_precondition_failed_callback = az_precondition_failed_default;
 
+// The callback is published with release semantics and read with acquire semantics, so that a
+// thread failing a precondition sees the callback, and whatever it uses, as they were set.
 void az_precondition_failed_set_callback(az_precondition_failed_fn az_precondition_failed_callback)
 {
+#if defined(__GNUC__) || defined(__clang__)
+  __atomic_store_n(
+      &_az_precondition_failed_callback, az_precondition_failed_callback, __ATOMIC_RELEASE);
+#else
   _az_precondition_failed_callback = az_precondition_failed_callback;
+#endif // defined(__GNUC__) || defined(__clang__)
 }
 
 az_precondition_failed_fn az_precondition_failed_get_callback()
 {
+#if defined(__GNUC__) || defined(__clang__)
+  return __atomic_load_n(&_az_precondition_failed_callback, __ATOMIC_ACQUIRE);
+#else
   return _az_precondition_failed_callback;
+#endif // defined(__GNUC__) || defined(__clang__)
 }
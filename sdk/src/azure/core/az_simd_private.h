@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_simd_private.h
+ *
+ * @brief Detects which SIMD instruction set can be used by the byte scanning loops (such as
+ * #az_span_find() and the JSON reader), and defines helpers shared by those loops.
+ *
+ * @details Exactly one of `_az_SIMD_SSE2` or `_az_SIMD_NEON` is defined when vector instructions
+ * are available to the compiler. `_az_SIMD_AVX2` is additionally defined, together with
+ * `_az_SIMD_SSE2`, when 32-byte AVX2 instructions are available, and `_az_SIMD_SSSE3` when the
+ * SSSE3 byte shuffles are (as they are with AVX2). When none is defined, callers use portable C
+ * code.
+ */
+
+#ifndef _az_SIMD_PRIVATE_H
+#define _az_SIMD_PRIVATE_H
+
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define _az_SIMD_AVX2
+#define _az_SIMD_SSSE3
+#define _az_SIMD_SSE2
+#elif defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define _az_SIMD_SSSE3
+#define _az_SIMD_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define _az_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define _az_SIMD_NEON
+#endif
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/**
+ * @brief Returns the index of the lowest set bit of a non-zero \p mask.
+ */
+AZ_NODISCARD AZ_INLINE int32_t _az_simd_lowest_bit(uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (int32_t)__builtin_ctzll(mask);
+#else
+  int32_t index = 0;
+  while ((mask & 1U) == 0)
+  {
+    mask >>= 1U;
+    index++;
+  }
+  return index;
+#endif
+}
+
+/**
+ * @brief Returns the number of set bits of \p mask.
+ */
+AZ_NODISCARD AZ_INLINE int32_t _az_simd_bit_count(uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (int32_t)__builtin_popcountll(mask);
+#else
+  int32_t count = 0;
+  for (; mask != 0; mask &= mask - 1U)
+  {
+    count++;
+  }
+  return count;
+#endif
+}
+
+#if defined(_az_SIMD_NEON)
+/**
+ * @brief NEON has no movemask instruction, so narrow each 8-bit lane comparison result of \p
+ * matches into 4 bits of a 64-bit mask. The lane index of a set bit is its bit index divided by 4.
+ */
+AZ_NODISCARD AZ_INLINE uint64_t _az_simd_neon_mask(uint8x16_t matches)
+{
+  return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+}
+#endif // _az_SIMD_NEON
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_SIMD_PRIVATE_H
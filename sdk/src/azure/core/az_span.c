@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "az_hex_private.h"
+#include "az_simd_private.h"
 #include "az_span_private.h"
 #include <azure/core/az_precondition.h>
 #include <azure/core/az_span.h>
@@ -13,14 +14,25 @@
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 
 #include <azure/core/_az_cfg.h>
 
+// This file defines the functions exported for the applications, so it doesn't use the inline
+// definitions the rest of the SDK calls instead when AZ_INLINE_CORE is defined.
+#ifdef AZ_INLINE_CORE
+#undef az_span_slice
+#undef az_span_slice_to_end
+#undef az_span_copy
+#undef az_span_copy_u8
+#endif // AZ_INLINE_CORE
+
 // The maximum integer value that can be stored in a double without losing precision (2^53 - 1)
 // An IEEE 64-bit double has 52 bits of mantissa
 #define _az_MAX_SAFE_INTEGER 9007199254740991
 
+// The factor applied to the value parsed so far, for each block of eight decimal digits.
+#define _az_SPAN_EIGHT_DIGITS_FACTOR 100000000U
+
 #ifndef AZ_NO_PRECONDITION_CHECKING
 // Note: If you are modifying this function, make sure to modify the inline version in the az_span.h
 // file as well.
@@ -55,21 +67,12 @@ AZ_NODISCARD az_span az_span_create_from_str(char* str)
 
 AZ_NODISCARD az_span az_span_slice(az_span span, int32_t start_index, int32_t end_index)
 {
-  _az_PRECONDITION_VALID_SPAN(span, 0, true);
-
-  // The following set of preconditions validate that:
-  //    0 <= end_index <= span.size
-  // And
-  //    0 <= start_index <= end_index
-  _az_PRECONDITION_RANGE(0, end_index, az_span_size(span));
-  _az_PRECONDITION((uint32_t)start_index <= (uint32_t)end_index);
-
-  return az_span_create(az_span_ptr(span) + start_index, end_index - start_index);
+  return _az_span_slice(span, start_index, end_index);
 }
 
 AZ_NODISCARD az_span az_span_slice_to_end(az_span span, int32_t start_index)
 {
-  return az_span_slice(span, start_index, az_span_size(span));
+  return _az_span_slice(span, start_index, az_span_size(span));
 }
 
 AZ_NODISCARD AZ_INLINE uint8_t _az_tolower(uint8_t value)
@@ -83,6 +86,24 @@ AZ_NODISCARD AZ_INLINE uint8_t _az_tolower(uint8_t value)
   return value;
 }
 
+// Lower cases the ASCII letters within the eight bytes of a word at once, leaving all other bytes,
+// including the ones that are not ASCII, unchanged.
+AZ_NODISCARD AZ_INLINE uint64_t _az_tolower_eight_bytes(uint64_t word)
+{
+  uint64_t const ones = 0x0101010101010101ULL;
+  uint64_t const high_bits = 0x8080808080808080ULL;
+
+  // Adding to the low 7 bits of each byte can't carry over to the next byte, and a byte's high bit
+  // then tells whether it was at least 'A', or more than 'Z', respectively.
+  uint64_t const low_bits = word & ~high_bits;
+  uint64_t const at_least_a = low_bits + ones * (uint64_t)(0x80 - 'A');
+  uint64_t const more_than_z = low_bits + ones * (uint64_t)(0x7F - 'Z');
+  uint64_t const is_upper = at_least_a & ~more_than_z & ~word & high_bits;
+
+  // Moving each high bit to 0x20 adds the difference between an upper and lower case letter.
+  return word | (is_upper >> 2U);
+}
+
 AZ_NODISCARD bool az_span_is_content_equal_ignoring_case(az_span span1, az_span span2)
 {
   int32_t const size = az_span_size(span1);
@@ -90,9 +111,28 @@ AZ_NODISCARD bool az_span_is_content_equal_ignoring_case(az_span span1, az_span
   {
     return false;
   }
-  for (int32_t i = 0; i < size; ++i)
+
+  uint8_t const* const ptr1 = az_span_ptr(span1);
+  uint8_t const* const ptr2 = az_span_ptr(span2);
+
+  // Compare eight bytes at a time while possible, which covers most HTTP header names in a few
+  // steps.
+  int32_t i = 0;
+  for (; i + 8 <= size; i += 8)
   {
-    if (_az_tolower(az_span_ptr(span1)[i]) != _az_tolower(az_span_ptr(span2)[i]))
+    uint64_t word1 = 0;
+    uint64_t word2 = 0;
+    memcpy(&word1, ptr1 + i, sizeof(word1));
+    memcpy(&word2, ptr2 + i, sizeof(word2));
+    if (word1 != word2 && _az_tolower_eight_bytes(word1) != _az_tolower_eight_bytes(word2))
+    {
+      return false;
+    }
+  }
+
+  for (; i < size; ++i)
+  {
+    if (_az_tolower(ptr1[i]) != _az_tolower(ptr2[i]))
     {
       return false;
     }
@@ -100,46 +140,82 @@ AZ_NODISCARD bool az_span_is_content_equal_ignoring_case(az_span span1, az_span
   return true;
 }
 
-AZ_NODISCARD az_result az_span_atou64(az_span source, uint64_t* out_number)
+// Reads eight bytes as a little-endian word, i.e. with the first byte in the lowest bits, which
+// compilers turn into a single load on little-endian targets.
+AZ_NODISCARD AZ_INLINE uint64_t _az_span_read_eight_bytes(uint8_t const* ptr)
 {
-  _az_PRECONDITION_VALID_SPAN(source, 1, false);
-  _az_PRECONDITION_NOT_NULL(out_number);
+  return (uint64_t)ptr[0] | ((uint64_t)ptr[1] << 8U) | ((uint64_t)ptr[2] << 16U)
+      | ((uint64_t)ptr[3] << 24U) | ((uint64_t)ptr[4] << 32U) | ((uint64_t)ptr[5] << 40U)
+      | ((uint64_t)ptr[6] << 48U) | ((uint64_t)ptr[7] << 56U);
+}
 
-  int32_t const span_size = az_span_size(source);
+// Unlike isdigit(), this doesn't depend on the locale, and doesn't need a function call.
+AZ_NODISCARD AZ_INLINE bool _az_span_is_digit(uint8_t byte)
+{
+  return (uint8_t)(byte - '0') <= 9;
+}
 
-  if (span_size < 1)
+// Parses the decimal digits within ptr, failing if any of them isn't a digit, or if the value would
+// exceed max_value. Leading zeros are allowed.
+AZ_NODISCARD AZ_INLINE az_result
+_az_span_parse_digits(uint8_t const* ptr, int32_t size, uint64_t max_value, uint64_t* out_value)
+{
+  // Leading zeros don't change the value, and skipping them bounds the number of digits left.
+  int32_t i = 0;
+  while (i < size && ptr[i] == '0')
+  {
+    i++;
+  }
+
+  if (size - i > _az_MAX_SIZE_FOR_UINT64)
   {
     return AZ_ERROR_UNEXPECTED_CHAR;
   }
 
-  // If the first character is not a digit or an optional + sign, return error.
-  int32_t starting_index = 0;
-  uint8_t* source_ptr = az_span_ptr(source);
-  uint8_t next_byte = source_ptr[0];
+  // Up to 19 digits can't overflow a uint64_t, so only the 20th digit, if any, needs a check.
+  int32_t const unchecked_size = size - i == _az_MAX_SIZE_FOR_UINT64 ? size - 1 : size;
+  uint64_t value = 0;
 
-  if (!isdigit(next_byte))
+  // Validate and convert eight digits at a time while possible, within a single word (SWAR).
+  for (; i + 8 <= unchecked_size; i += 8)
   {
-    // There must be another byte after a sign.
-    // The loop below checks that it must be a digit.
-    if (next_byte != '+' || span_size < 2)
+    uint64_t word = _az_span_read_eight_bytes(ptr + i);
+
+    // Every byte must be 0x30 to 0x39: its high nibble must be 3, and adding 6 to its low nibble
+    // mustn't carry into the high nibble.
+    if ((word & 0xF0F0F0F0F0F0F0F0ULL) != 0x3030303030303030ULL
+        || ((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) != 0x3030303030303030ULL)
     {
       return AZ_ERROR_UNEXPECTED_CHAR;
     }
-    starting_index++;
+
+    // Combine adjacent digits into 2-digit values, then into 4-digit values, and finally into the
+    // 8-digit value, in the top half of the word.
+    word = ((word & 0x0F0F0F0F0F0F0F0FULL) * (10U * 0x100U + 1U)) >> 8U;
+    word = ((word & 0x00FF00FF00FF00FFULL) * (100U * 0x10000U + 1U)) >> 16U;
+    word = ((word & 0x0000FFFF0000FFFFULL) * (10000ULL * 0x100000000ULL + 1U)) >> 32U;
+
+    value = value * _az_SPAN_EIGHT_DIGITS_FACTOR + word;
   }
 
-  uint64_t value = 0;
+  for (; i < unchecked_size; ++i)
+  {
+    if (!_az_span_is_digit(ptr[i]))
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+    value = value * _az_NUMBER_OF_DECIMAL_VALUES + (uint64_t)(ptr[i] - '0');
+  }
 
-  for (int32_t i = starting_index; i < span_size; ++i)
+  if (i < size)
   {
-    next_byte = source_ptr[i];
-    if (!isdigit(next_byte))
+    if (!_az_span_is_digit(ptr[i]))
     {
       return AZ_ERROR_UNEXPECTED_CHAR;
     }
-    uint64_t const d = (uint64_t)next_byte - '0';
+    uint64_t const d = (uint64_t)ptr[i] - '0';
 
-    // Check whether the next digit will cause an integer overflow.
+    // Check whether the last digit will cause an integer overflow.
     // Before actually doing the math below, this is checking whether value * 10 + d > UINT64_MAX.
     if ((UINT64_MAX - d) / _az_NUMBER_OF_DECIMAL_VALUES < value)
     {
@@ -149,11 +225,16 @@ AZ_NODISCARD az_result az_span_atou64(az_span source, uint64_t* out_number)
     value = value * _az_NUMBER_OF_DECIMAL_VALUES + d;
   }
 
-  *out_number = value;
+  if (value > max_value)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  *out_value = value;
   return AZ_OK;
 }
 
-AZ_NODISCARD az_result az_span_atou32(az_span source, uint32_t* out_number)
+AZ_NODISCARD az_result az_span_atou64(az_span source, uint64_t* out_number)
 {
   _az_PRECONDITION_VALID_SPAN(source, 1, false);
   _az_PRECONDITION_NOT_NULL(out_number);
@@ -181,28 +262,47 @@ AZ_NODISCARD az_result az_span_atou32(az_span source, uint32_t* out_number)
     starting_index++;
   }
 
-  uint32_t value = 0;
+  uint64_t value = 0;
+  _az_RETURN_IF_FAILED(_az_span_parse_digits(
+      source_ptr + starting_index, span_size - starting_index, UINT64_MAX, &value));
+
+  *out_number = value;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_span_atou32(az_span source, uint32_t* out_number)
+{
+  _az_PRECONDITION_VALID_SPAN(source, 1, false);
+  _az_PRECONDITION_NOT_NULL(out_number);
 
-  for (int32_t i = starting_index; i < span_size; ++i)
+  int32_t const span_size = az_span_size(source);
+
+  if (span_size < 1)
   {
-    next_byte = source_ptr[i];
-    if (!isdigit(next_byte))
-    {
-      return AZ_ERROR_UNEXPECTED_CHAR;
-    }
-    uint32_t const d = (uint32_t)next_byte - '0';
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
 
-    // Check whether the next digit will cause an integer overflow.
-    // Before actually doing the math below, this is checking whether value * 10 + d > UINT32_MAX.
-    if ((UINT32_MAX - d) / _az_NUMBER_OF_DECIMAL_VALUES < value)
+  // If the first character is not a digit or an optional + sign, return error.
+  int32_t starting_index = 0;
+  uint8_t* source_ptr = az_span_ptr(source);
+  uint8_t next_byte = source_ptr[0];
+
+  if (!isdigit(next_byte))
+  {
+    // There must be another byte after a sign.
+    // The loop below checks that it must be a digit.
+    if (next_byte != '+' || span_size < 2)
     {
       return AZ_ERROR_UNEXPECTED_CHAR;
     }
-
-    value = value * _az_NUMBER_OF_DECIMAL_VALUES + d;
+    starting_index++;
   }
 
-  *out_number = value;
+  uint64_t value = 0;
+  _az_RETURN_IF_FAILED(_az_span_parse_digits(
+      source_ptr + starting_index, span_size - starting_index, UINT32_MAX, &value));
+
+  *out_number = (uint32_t)value;
   return AZ_OK;
 }
 
@@ -251,28 +351,14 @@ AZ_NODISCARD az_result az_span_atoi64(az_span source, int64_t* out_number)
 
   // Using unsigned int while parsing to account for potential overflow.
   uint64_t value = 0;
-
-  for (int32_t i = starting_index; i < span_size; ++i)
-  {
-    next_byte = source_ptr[i];
-    if (!isdigit(next_byte))
-    {
-      return AZ_ERROR_UNEXPECTED_CHAR;
-    }
-    uint64_t const d = (uint64_t)next_byte - '0';
-
-    // Check whether the next digit will cause an integer overflow.
-    // Before actually doing the math below, this is checking whether value * 10 + d > INT64_MAX, or
-    // in the case of negative numbers, checking whether value * 10 + d > INT64_MAX + 1.
-    if ((uint64_t)(INT64_MAX - d + sign_factor) / _az_NUMBER_OF_DECIMAL_VALUES < value)
-    {
-      return AZ_ERROR_UNEXPECTED_CHAR;
-    }
-
-    value = value * _az_NUMBER_OF_DECIMAL_VALUES + d;
-  }
-
-  *out_number = (int64_t)value * sign;
+  _az_RETURN_IF_FAILED(_az_span_parse_digits(
+      source_ptr + starting_index,
+      span_size - starting_index,
+      (uint64_t)INT64_MAX + sign_factor,
+      &value));
+
+  // Negate as an unsigned value, since the magnitude of INT64_MIN doesn't fit in an int64_t.
+  *out_number = sign < 0 ? (int64_t)(0U - value) : (int64_t)value;
   return AZ_OK;
 }
 
@@ -320,108 +406,42 @@ AZ_NODISCARD az_result az_span_atoi32(az_span source, int32_t* out_number)
   uint32_t sign_factor = (uint32_t)(-1 * sign + 1) / 2;
 
   // Using unsigned int while parsing to account for potential overflow.
-  uint32_t value = 0;
-
-  for (int32_t i = starting_index; i < span_size; ++i)
-  {
-    next_byte = source_ptr[i];
-    if (!isdigit(next_byte))
-    {
-      return AZ_ERROR_UNEXPECTED_CHAR;
-    }
-    uint32_t const d = (uint32_t)next_byte - '0';
-
-    // Check whether the next digit will cause an integer overflow.
-    // Before actually doing the math below, this is checking whether value * 10 + d > INT32_MAX, or
-    // in the case of negative numbers, checking whether value * 10 + d > INT32_MAX + 1.
-    if ((uint32_t)(INT32_MAX - d + sign_factor) / _az_NUMBER_OF_DECIMAL_VALUES < value)
-    {
-      return AZ_ERROR_UNEXPECTED_CHAR;
-    }
-
-    value = value * _az_NUMBER_OF_DECIMAL_VALUES + d;
-  }
-
-  *out_number = (int32_t)value * sign;
+  uint64_t value = 0;
+  _az_RETURN_IF_FAILED(_az_span_parse_digits(
+      source_ptr + starting_index,
+      span_size - starting_index,
+      (uint64_t)INT32_MAX + sign_factor,
+      &value));
+
+  // Negate as an unsigned value, since the magnitude of INT32_MIN doesn't fit in an int32_t.
+  *out_number = sign < 0 ? (int32_t)(uint32_t)(0U - value) : (int32_t)value;
   return AZ_OK;
 }
 
-static bool _is_valid_start_of_double(uint8_t first_byte)
+// Returns true if the `target_size` bytes at `candidate` match `target`, given that the first and
+// last bytes are already known to match.
+AZ_NODISCARD AZ_INLINE bool _az_span_find_is_match_at(
+    uint8_t const* candidate,
+    uint8_t const* target_ptr,
+    int32_t target_size)
 {
-  // ".123", "  123", "nan", or "inf" are considered invalid
-  bool result = isdigit(first_byte) || first_byte == '+' || first_byte == '-';
-
-  return result;
+  return target_size <= 2
+      || memcmp(candidate + 1, target_ptr + 1, (size_t)(target_size - 2)) == 0;
 }
 
-// Disable the following warning just for this particular use case.
-// C4996: 'sscanf': This function or variable may be unsafe. Consider using sscanf_s instead.
-// C4710: 'sscanf': function not inlined
-#ifdef _MSC_VER
-#pragma warning(push)
-#pragma warning(disable : 4996)
-#pragma warning(disable : 4710)
-#endif
-
-AZ_NODISCARD az_result az_span_atod(az_span source, double* out_number)
-{
-  _az_PRECONDITION_VALID_SPAN(source, 1, false);
-  _az_PRECONDITION_NOT_NULL(out_number);
-
-  int32_t size = az_span_size(source);
-
-  _az_PRECONDITION_RANGE(1, size, _az_MAX_SIZE_FOR_PARSING_DOUBLE);
-
-  // This check is necessary to prevent sscanf from reading bytes past the end of the span, when the
-  // span might contain whitespace or other invalid bytes at the start.
-  uint8_t* source_ptr = az_span_ptr(source);
-  if (size < 1 || !_is_valid_start_of_double(source_ptr[0]))
-  {
-    return AZ_ERROR_UNEXPECTED_CHAR;
-  }
-
-  // Stack based string to allow thread-safe mutation.
-  // The length is 8 to allow space for the null-terminating character.
-  // NOLINTNEXTLINE(readability-magic-numbers,  cppcoreguidelines-avoid-magic-numbers)
-  char format[8] = "%00lf%n";
-
-  // Starting at 1 to skip the '%' character
-  format[1] = (char)((size / _az_NUMBER_OF_DECIMAL_VALUES) + '0');
-  format[2] = (char)((size % _az_NUMBER_OF_DECIMAL_VALUES) + '0');
-
-  int32_t chars_consumed = 0;
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
-  int32_t n = sscanf((char*)source_ptr, format, out_number, &chars_consumed);
-
-  // Success if the entire source was consumed by sscanf and it set the out_number argument.
-  return (size == chars_consumed && n == 1 && _az_isfinite(*out_number)) ? AZ_OK
-                                                                         : AZ_ERROR_UNEXPECTED_CHAR;
-}
-
-#ifdef _MSC_VER
-#pragma warning(pop)
-#endif
-
 AZ_NODISCARD int32_t az_span_find(az_span source, az_span target)
 {
-  /* This function implements the Naive string-search algorithm.
-   * The rationale to use this algorithm instead of other potentially more
-   * performing ones (Rabin-Karp, e.g.) is due to no additional space needed.
-   * The logic:
-   * 1. The function will look into each position of `source` if it contains the same value as the
-   * first position of `target`.
-   * 2. If it does, it could be that the next bytes in `source` are a perfect match of the remaining
-   * bytes of `target`.
-   * 3. Being so, it loops through the remaining bytes of `target` and see if they match exactly the
-   * next bytes of `source`.
-   * 4. If the loop gets to the end (all bytes of `target` are evaluated), it means `target` indeed
-   * occurs in that position of `source`.
-   * 5. If the loop gets interrupted before cruising through the entire `target`, the function must
-   * go back to step 1. from  the next position in `source`.
-   *   The loop in 5. gets interrupted if
-   *     - a byte in `target` is different than `source`, in the expected corresponding position;
-   *     - the loop has reached the end of `source` (and there are still remaining bytes of `target`
-   *         to be checked).
+  /* This function implements a first/last byte filtered string search.
+   * Like the naive string-search algorithm it needs no additional space, but instead of comparing
+   * `target` at every position of `source`, it only does so at positions where both the first and
+   * the last bytes of `target` match:
+   * 1. For every candidate position `i` in `source`, check if `source[i]` is equal to the first
+   * byte of `target` and `source[i + target_size - 1]` is equal to the last byte of `target`.
+   * 2. Only if both match, compare the bytes in between (memcmp) to confirm the match.
+   * 3. The first position that passes step 2. is returned, which is the same index as the naive
+   * search would return.
+   * When SIMD instructions are available (AVX2, SSE2 or NEON), step 1. is evaluated for 32 or 16
+   * consecutive positions at once, and the remaining positions are handled one by one.
    */
 
   int32_t source_size = az_span_size(source);
@@ -438,86 +458,116 @@ AZ_NODISCARD int32_t az_span_find(az_span source, az_span target)
     return target_not_found;
   }
 
-  uint8_t* source_ptr = az_span_ptr(source);
-  uint8_t* target_ptr = az_span_ptr(target);
+  uint8_t const* source_ptr = az_span_ptr(source);
+  uint8_t const* target_ptr = az_span_ptr(target);
 
-  // This loop traverses `source` position by position (step 1.)
-  for (int32_t i = 0; i < (source_size - target_size + 1); i++)
+  uint8_t const first = target_ptr[0];
+  uint8_t const last = target_ptr[target_size - 1];
+
+  // The number of positions in `source` in which `target` could start.
+  int32_t const candidates = source_size - target_size + 1;
+  int32_t i = 0;
+
+#if defined(_az_SIMD_AVX2)
   {
-    // This is the check done in step 1. above.
-    if (source_ptr[i] == target_ptr[0])
+    __m256i const first_block = _mm256_set1_epi8((char)first);
+    __m256i const last_block = _mm256_set1_epi8((char)last);
+
+    for (; i + 32 <= candidates; i += 32)
     {
-      // The condition in step 2. has been satisfied.
-      int32_t j = 1;
-      // This is the loop defined in step 3.
-      // The loop must be broken if it reaches the ends of `target` (step 3.) OR `source`
-      // (step 5.).
-      for (; j < target_size && (i + j) < source_size; j++)
+      __m256i const block_first = _mm256_loadu_si256((__m256i const*)(void const*)(source_ptr + i));
+      __m256i const block_last = _mm256_loadu_si256(
+          (__m256i const*)(void const*)(source_ptr + i + target_size - 1));
+
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(
+          _mm256_cmpeq_epi8(block_first, first_block), _mm256_cmpeq_epi8(block_last, last_block)));
+
+      while (mask != 0)
       {
-        // Condition defined in step 5.
-        if (source_ptr[i + j] != target_ptr[j])
+        int32_t const index = i + _az_simd_lowest_bit(mask);
+        if (_az_span_find_is_match_at(source_ptr + index, target_ptr, target_size))
         {
-          break;
+          return index;
         }
+        mask &= mask - 1U;
       }
+    }
+  }
+#endif
 
-      if (j == target_size)
-      {
-        // All bytes in `target` have been checked and matched the corresponding bytes in `source`
-        // (from the start point `i`), so this is indeed an instance of `target` in that position
-        // of `source` (step 4.).
+#if defined(_az_SIMD_SSE2)
+  {
+    __m128i const first_block = _mm_set1_epi8((char)first);
+    __m128i const last_block = _mm_set1_epi8((char)last);
+
+    for (; i + 16 <= candidates; i += 16)
+    {
+      __m128i const block_first = _mm_loadu_si128((__m128i const*)(void const*)(source_ptr + i));
+      __m128i const block_last
+          = _mm_loadu_si128((__m128i const*)(void const*)(source_ptr + i + target_size - 1));
+
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(
+          _mm_cmpeq_epi8(block_first, first_block), _mm_cmpeq_epi8(block_last, last_block)));
 
-        return i;
+      while (mask != 0)
+      {
+        int32_t const index = i + _az_simd_lowest_bit(mask);
+        if (_az_span_find_is_match_at(source_ptr + index, target_ptr, target_size))
+        {
+          return index;
+        }
+        mask &= mask - 1U;
       }
     }
   }
+#elif defined(_az_SIMD_NEON)
+  {
+    uint8x16_t const first_block = vdupq_n_u8(first);
+    uint8x16_t const last_block = vdupq_n_u8(last);
 
-  // If the function hasn't returned before, all positions
-  // of `source` have been evaluated but `target` could not be found.
-  return target_not_found;
-}
-
-az_span az_span_copy(az_span destination, az_span source)
-{
-  int32_t src_size = az_span_size(source);
+    for (; i + 16 <= candidates; i += 16)
+    {
+      uint8x16_t const matches = vandq_u8(
+          vceqq_u8(vld1q_u8(source_ptr + i), first_block),
+          vceqq_u8(vld1q_u8(source_ptr + i + target_size - 1), last_block));
 
-  _az_PRECONDITION_VALID_SPAN(destination, src_size, false);
+      uint64_t mask = _az_simd_neon_mask(matches);
 
-  if (src_size == 0)
-  {
-    return destination;
+      for (int32_t lane = 0; mask != 0; lane++, mask >>= 4U)
+      {
+        if ((mask & 0xFU) != 0
+            && _az_span_find_is_match_at(source_ptr + i + lane, target_ptr, target_size))
+        {
+          return i + lane;
+        }
+      }
+    }
   }
+#endif
 
-  // Even though the contract of this function is that the destination must be larger than source,
-  // cap the data move if the source is too large, to avoid memory corruption.
-  int32_t dest_size = az_span_size(destination);
-  if (src_size > dest_size)
+  // Scalar search for the remaining positions (or all of them, when SIMD is not available).
+  for (; i < candidates; i++)
   {
-    src_size = dest_size;
+    if (source_ptr[i] == first && source_ptr[i + target_size - 1] == last
+        && _az_span_find_is_match_at(source_ptr + i, target_ptr, target_size))
+    {
+      return i;
+    }
   }
 
-  uint8_t* ptr = az_span_ptr(destination);
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
-  memmove((void*)ptr, (void const*)az_span_ptr(source), (size_t)src_size);
+  // If the function hasn't returned before, all positions
+  // of `source` have been evaluated but `target` could not be found.
+  return target_not_found;
+}
 
-  return az_span_slice_to_end(destination, src_size);
+az_span az_span_copy(az_span destination, az_span source)
+{
+  return _az_span_copy(destination, source);
 }
 
 az_span az_span_copy_u8(az_span destination, uint8_t byte)
 {
-  _az_PRECONDITION_VALID_SPAN(destination, 1, false);
-
-  // Even though the contract of the function is that the destination must be at least 1 byte large,
-  // no-op if it is empty to avoid memory corruption.
-  int32_t dest_size = az_span_size(destination);
-  if (dest_size < 1)
-  {
-    return destination;
-  }
-
-  uint8_t* dst_ptr = az_span_ptr(destination);
-  dst_ptr[0] = byte;
-  return az_span_create(dst_ptr + 1, dest_size - 1);
+  return _az_span_copy_u8(destination, byte);
 }
 
 void az_span_to_str(char* destination, int32_t destination_max_size, az_span source)
@@ -563,36 +613,101 @@ AZ_INLINE uint8_t _az_decimal_to_ascii(uint8_t d)
   return (uint8_t)((uint32_t)('0' + d) & (uint8_t)UINT8_MAX);
 }
 
-static AZ_NODISCARD az_result _az_span_builder_append_uint64(az_span* ref_span, uint64_t n)
+// The two decimal digits of every number from 0 to 99, so that digits can be produced in pairs,
+// halving the number of divisions needed to format an integer.
+static char const _az_two_digits_table[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// The powers of ten from 10^1 to 10^19, used to correct the digit count estimate.
+// The first entry is 0 rather than 10^0, since every number with an estimate of 0 has one digit.
+static uint64_t const _az_powers_of_ten[_az_MAX_SIZE_FOR_UINT64] = {
+  0ULL,
+  10ULL,
+  100ULL,
+  1000ULL,
+  10000ULL,
+  100000ULL,
+  1000000ULL,
+  10000000ULL,
+  100000000ULL,
+  1000000000ULL,
+  10000000000ULL,
+  100000000000ULL,
+  1000000000000ULL,
+  10000000000000ULL,
+  100000000000000ULL,
+  1000000000000000ULL,
+  10000000000000000ULL,
+  100000000000000000ULL,
+  1000000000000000000ULL,
+  _az_SMALLEST_20_DIGIT_NUMBER,
+};
+
+AZ_NODISCARD AZ_INLINE int32_t _az_bit_length(uint64_t n)
 {
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(*ref_span, 1);
-
-  if (n == 0)
+#if defined(__GNUC__) || defined(__clang__)
+  return n == 0 ? 0 : 64 - (int32_t)__builtin_clzll(n);
+#else
+  int32_t length = 0;
+  while (n != 0)
   {
-    *ref_span = az_span_copy_u8(*ref_span, '0');
-    return AZ_OK;
+    n >>= 1U;
+    length++;
   }
+  return length;
+#endif
+}
 
-  uint64_t div = _az_SMALLEST_20_DIGIT_NUMBER;
-  uint64_t nn = n;
-  int32_t digit_count = _az_MAX_SIZE_FOR_UINT64;
-  while (nn / div == 0)
+static AZ_NODISCARD int32_t _az_count_decimal_digits(uint64_t n)
+{
+  // 1233 / 4096 is slightly more than log10(2), so this underestimates the digit count of n by at
+  // most one, which the comparison against the matching power of ten then corrects.
+  int32_t const estimate = (_az_bit_length(n | 1U) * 1233) >> 12;
+  return estimate + 1 - (n < _az_powers_of_ten[estimate] ? 1 : 0);
+}
+
+// Writes the decimal digits of n backwards, ending just before end, two digits at a time.
+// The caller must make sure there is room for _az_count_decimal_digits(n) bytes before end.
+static void _az_write_decimal_digits(uint8_t* end, uint64_t n)
+{
+  // Only use 64-bit divisions while they're needed, since those are expensive on 32-bit targets.
+  while (n > UINT32_MAX)
   {
-    div /= _az_NUMBER_OF_DECIMAL_VALUES;
-    digit_count--;
+    uint32_t const index = (uint32_t)(n % 100U) * 2U;
+    n /= 100U;
+    *--end = (uint8_t)_az_two_digits_table[index + 1U];
+    *--end = (uint8_t)_az_two_digits_table[index];
   }
 
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(*ref_span, digit_count);
+  uint32_t nn = (uint32_t)n;
+  while (nn >= 100U)
+  {
+    uint32_t const index = (nn % 100U) * 2U;
+    nn /= 100U;
+    *--end = (uint8_t)_az_two_digits_table[index + 1U];
+    *--end = (uint8_t)_az_two_digits_table[index];
+  }
 
-  while (div > 1)
+  if (nn >= 10U)
   {
-    uint8_t value_to_append = _az_decimal_to_ascii((uint8_t)(nn / div));
-    *ref_span = az_span_copy_u8(*ref_span, value_to_append);
-    nn %= div;
-    div /= _az_NUMBER_OF_DECIMAL_VALUES;
+    *--end = (uint8_t)_az_two_digits_table[nn * 2U + 1U];
+    *--end = (uint8_t)_az_two_digits_table[nn * 2U];
   }
-  uint8_t value_to_append = _az_decimal_to_ascii((uint8_t)nn);
-  *ref_span = az_span_copy_u8(*ref_span, value_to_append);
+  else
+  {
+    *--end = _az_decimal_to_ascii((uint8_t)nn);
+  }
+}
+
+static AZ_NODISCARD az_result _az_span_builder_append_uint64(az_span* ref_span, uint64_t n)
+{
+  int32_t const digit_count = _az_count_decimal_digits(n);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(*ref_span, digit_count);
+
+  _az_write_decimal_digits(az_span_ptr(*ref_span) + digit_count, n);
+  *ref_span = az_span_slice_to_end(*ref_span, digit_count);
   return AZ_OK;
 }
 
@@ -614,7 +729,8 @@ AZ_NODISCARD az_result az_span_i64toa(az_span destination, int64_t source, az_sp
   {
     _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, 1);
     *out_span = az_span_copy_u8(destination, '-');
-    return _az_span_builder_append_uint64(out_span, (uint64_t)-source);
+    // Negate as unsigned, so that INT64_MIN doesn't overflow.
+    return _az_span_builder_append_uint64(out_span, 0U - (uint64_t)source);
   }
 
   // make out_span point to destination before trying to write on it (might be an empty az_span or
@@ -626,38 +742,11 @@ AZ_NODISCARD az_result az_span_i64toa(az_span destination, int64_t source, az_sp
 static AZ_NODISCARD az_result
 _az_span_builder_append_u32toa(az_span destination, uint32_t n, az_span* out_span)
 {
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, 1);
-
-  if (n == 0)
-  {
-    *out_span = az_span_copy_u8(destination, '0');
-    return AZ_OK;
-  }
-
-  uint32_t div = _az_SMALLEST_10_DIGIT_NUMBER;
-  uint32_t nn = n;
-  int32_t digit_count = _az_MAX_SIZE_FOR_UINT32;
-  while (nn / div == 0)
-  {
-    div /= _az_NUMBER_OF_DECIMAL_VALUES;
-    digit_count--;
-  }
-
+  int32_t const digit_count = _az_count_decimal_digits(n);
   _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, digit_count);
 
-  *out_span = destination;
-
-  while (div > 1)
-  {
-    uint8_t value_to_append = _az_decimal_to_ascii((uint8_t)(nn / div));
-    *out_span = az_span_copy_u8(*out_span, value_to_append);
-
-    nn %= div;
-    div /= _az_NUMBER_OF_DECIMAL_VALUES;
-  }
-
-  uint8_t value_to_append = _az_decimal_to_ascii((uint8_t)nn);
-  *out_span = az_span_copy_u8(*out_span, value_to_append);
+  _az_write_decimal_digits(az_span_ptr(destination) + digit_count, n);
+  *out_span = az_span_slice_to_end(destination, digit_count);
   return AZ_OK;
 }
 
@@ -685,6 +774,181 @@ AZ_NODISCARD az_result az_span_i32toa(az_span destination, int32_t source, az_sp
   return _az_span_builder_append_u32toa(*out_span, (uint32_t)source, out_span);
 }
 
+enum
+{
+  _az_MSEC_PER_DAY = 86400000,
+
+  // The days from 0000-03-01, the start of a 400-year cycle of the days as they are counted, to
+  // 1970-01-01.
+  _az_DAYS_FROM_CIVIL_EPOCH_TO_UNIX_EPOCH = 719468,
+
+  // The days in a 400-year cycle of the Gregorian calendar.
+  _az_DAYS_PER_400_YEARS = 146097,
+};
+
+// The times of 0000-01-01T00:00:00.000Z and 9999-12-31T23:59:59.999Z.
+#define _az_ISO8601_MIN_MSEC (-62167219200000LL)
+#define _az_ISO8601_MAX_MSEC 253402300799999LL
+
+// The days before the start of each month, in a year starting in March as the days are counted in,
+// so that the leap day is at the end of the year.
+static int32_t const _az_days_before_month_from_march[12]
+    = { 0, 31, 61, 92, 122, 153, 184, 214, 245, 275, 306, 337 };
+
+// Writes the two decimal digits of n, less than 100.
+AZ_INLINE uint8_t* _az_write_two_digits(uint8_t* ptr, int32_t n)
+{
+  ptr[0] = (uint8_t)_az_two_digits_table[n * 2];
+  ptr[1] = (uint8_t)_az_two_digits_table[n * 2 + 1];
+  return ptr + 2;
+}
+
+AZ_NODISCARD az_result
+az_span_format_iso8601(az_span destination, int64_t unix_time_msec, az_span* out_span)
+{
+  _az_PRECONDITION_VALID_SPAN(destination, 0, false);
+  _az_PRECONDITION_NOT_NULL(out_span);
+
+  if (unix_time_msec < _az_ISO8601_MIN_MSEC || unix_time_msec > _az_ISO8601_MAX_MSEC)
+  {
+    return AZ_ERROR_ARG;
+  }
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, _az_ISO8601_SIZE);
+
+  // Count the days from -0400-03-01, 60 days before 0000-01-01 in the previous 400-year cycle,
+  // which keeps them non-negative within the supported years.
+  int64_t const msec = unix_time_msec - _az_ISO8601_MIN_MSEC;
+  int32_t const days = (int32_t)(msec / _az_MSEC_PER_DAY) - 60 + _az_DAYS_PER_400_YEARS;
+  int32_t msec_of_day = (int32_t)(msec % _az_MSEC_PER_DAY);
+
+  // Like in Howard Hinnant's civil_from_days(), with the years starting in March.
+  int32_t const era = days / _az_DAYS_PER_400_YEARS;
+  int32_t const day_of_era = days - era * _az_DAYS_PER_400_YEARS;
+  int32_t const year_of_era
+      = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+  int32_t const day_of_year
+      = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  int32_t const month_from_march = (5 * day_of_year + 2) / 153;
+  int32_t const day = day_of_year - _az_days_before_month_from_march[month_from_march] + 1;
+  int32_t const month = month_from_march < 10 ? month_from_march + 3 : month_from_march - 9;
+  int32_t const year = (era - 1) * 400 + year_of_era + (month <= 2 ? 1 : 0);
+
+  uint8_t* ptr = az_span_ptr(destination);
+  ptr = _az_write_two_digits(ptr, year / 100);
+  ptr = _az_write_two_digits(ptr, year % 100);
+  *ptr++ = '-';
+  ptr = _az_write_two_digits(ptr, month);
+  *ptr++ = '-';
+  ptr = _az_write_two_digits(ptr, day);
+  *ptr++ = 'T';
+  ptr = _az_write_two_digits(ptr, msec_of_day / 3600000);
+  msec_of_day %= 3600000;
+  *ptr++ = ':';
+  ptr = _az_write_two_digits(ptr, msec_of_day / 60000);
+  msec_of_day %= 60000;
+  *ptr++ = ':';
+  ptr = _az_write_two_digits(ptr, msec_of_day / 1000);
+  msec_of_day %= 1000;
+  *ptr++ = '.';
+  *ptr++ = _az_decimal_to_ascii((uint8_t)(msec_of_day / 100));
+  ptr = _az_write_two_digits(ptr, msec_of_day % 100);
+  *ptr = 'Z';
+
+  *out_span = az_span_slice_to_end(destination, _az_ISO8601_SIZE);
+  return AZ_OK;
+}
+
+// Parses the two decimal digits at ptr, or returns -1 if they aren't digits.
+AZ_NODISCARD AZ_INLINE int32_t _az_parse_two_digits(uint8_t const* ptr)
+{
+  uint32_t const high = (uint32_t)ptr[0] - '0';
+  uint32_t const low = (uint32_t)ptr[1] - '0';
+  return high <= 9U && low <= 9U ? (int32_t)(high * 10U + low) : -1;
+}
+
+AZ_NODISCARD az_result az_span_parse_iso8601(az_span source, int64_t* out_unix_time_msec)
+{
+  _az_PRECONDITION_VALID_SPAN(source, 0, false);
+  _az_PRECONDITION_NOT_NULL(out_unix_time_msec);
+
+  // The shortest timestamp has no fraction of a second (i.e. 2021-03-04T05:06:07Z).
+  int32_t const size = az_span_size(source);
+  if (size < _az_ISO8601_SIZE - 4)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  uint8_t const* const ptr = az_span_ptr(source);
+  int32_t const century = _az_parse_two_digits(ptr);
+  int32_t const year_of_century = _az_parse_two_digits(ptr + 2);
+  int32_t const month = _az_parse_two_digits(ptr + 5);
+  int32_t const day = _az_parse_two_digits(ptr + 8);
+  int32_t const hour = _az_parse_two_digits(ptr + 11);
+  int32_t const minute = _az_parse_two_digits(ptr + 14);
+  int32_t const second = _az_parse_two_digits(ptr + 17);
+  if (century < 0 || year_of_century < 0 || ptr[4] != '-' || month < 1 || month > 12
+      || ptr[7] != '-' || day < 1 || ptr[10] != 'T' || hour < 0 || hour > 23 || ptr[13] != ':'
+      || minute < 0 || minute > 59 || ptr[16] != ':' || second < 0 || second > 59)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  // Up to three digits of the fraction of a second are kept, the following ones are only checked.
+  int32_t msec = 0;
+  int32_t index = 19;
+  if (ptr[index] == '.')
+  {
+    index++;
+    int32_t const fraction_start = index;
+    int32_t scale = 100;
+    while (index < size && (uint32_t)ptr[index] - '0' <= 9U)
+    {
+      msec += (ptr[index] - '0') * scale;
+      scale /= 10;
+      index++;
+    }
+
+    if (index == fraction_start)
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+  }
+
+  if (index != size - 1 || ptr[index] != 'Z')
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  // Like in Howard Hinnant's days_from_civil(), with the years starting in March.
+  int32_t const month_from_march = month > 2 ? month - 3 : month + 9;
+  int32_t const year = century * 100 + year_of_century - (month <= 2 ? 1 : 0);
+  // The leap day ends the year starting in March of the year before.
+  int32_t const next_year = year + 1;
+  bool const is_leap_year
+      = next_year % 4 == 0 && (next_year % 100 != 0 || next_year % 400 == 0);
+  int32_t const month_size = month_from_march == 11
+      ? (is_leap_year ? 29 : 28)
+      : _az_days_before_month_from_march[month_from_march + 1]
+          - _az_days_before_month_from_march[month_from_march];
+  if (day > month_size)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  // The year 0000 up to February belongs to the last year of the previous 400-year cycle.
+  int32_t const era = (year >= 0 ? year : year - 399) / 400;
+  int32_t const year_of_era = year - era * 400;
+  int32_t const day_of_year = _az_days_before_month_from_march[month_from_march] + day - 1;
+  int32_t const day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  int64_t const days = (int64_t)era * _az_DAYS_PER_400_YEARS + day_of_era
+      - _az_DAYS_FROM_CIVIL_EPOCH_TO_UNIX_EPOCH;
+
+  *out_unix_time_msec = days * _az_MSEC_PER_DAY
+      + ((int64_t)hour * 3600 + (int64_t)minute * 60 + second) * 1000 + msec;
+  return AZ_OK;
+}
+
 AZ_NODISCARD az_result
 az_span_dtoa(az_span destination, double source, int32_t fractional_digits, az_span* out_span)
 {
@@ -696,6 +960,12 @@ az_span_dtoa(az_span destination, double source, int32_t fractional_digits, az_s
 
   *out_span = destination;
 
+#ifdef AZ_NO_DOUBLE
+  // Built without double support, which also drops the floating-point code pulled in by modf.
+  (void)source;
+  (void)fractional_digits;
+  return AZ_ERROR_NOT_SUPPORTED;
+#else
   // The input is either positive or negative infinity, or not a number.
   if (!_az_isfinite(source))
   {
@@ -785,6 +1055,7 @@ az_span_dtoa(az_span destination, double source, int32_t fractional_digits, az_s
 
   // Append the fractional part.
   return _az_span_builder_append_uint64(out_span, fractional_part);
+#endif // AZ_NO_DOUBLE
 }
 
 // TODO: pass az_span by value
@@ -810,12 +1081,6 @@ AZ_NODISCARD az_result _az_is_expected_span(az_span* ref_span, az_span expected)
   return AZ_OK;
 }
 
-AZ_NODISCARD az_span _az_span_trim_whitespace(az_span source)
-{
-  // Trim from end after trim from start
-  return _az_span_trim_whitespace_from_end(_az_span_trim_whitespace_from_start(source));
-}
-
 AZ_NODISCARD AZ_INLINE bool _az_is_whitespace(uint8_t c)
 {
   switch (c)
@@ -830,6 +1095,21 @@ AZ_NODISCARD AZ_INLINE bool _az_is_whitespace(uint8_t c)
   }
 }
 
+AZ_NODISCARD az_span _az_span_trim_whitespace(az_span source)
+{
+  // Most spans don't need any trimming, which only needs their first and last bytes to be checked.
+  int32_t const size = az_span_size(source);
+  if (size == 0
+      || (!_az_is_whitespace(az_span_ptr(source)[0])
+          && !_az_is_whitespace(az_span_ptr(source)[size - 1])))
+  {
+    return source;
+  }
+
+  // Trim from end after trim from start
+  return _az_span_trim_whitespace_from_end(_az_span_trim_whitespace_from_start(source));
+}
+
 typedef enum
 {
   LEFT = 0,
@@ -893,18 +1173,148 @@ AZ_NODISCARD AZ_INLINE bool _az_span_is_byte_letter(uint8_t c)
   return ((uint32_t)(c - 'A') & ~(uint32_t)_az_ASCII_SPACE_CHARACTER) <= 'Z' - 'A';
 }
 
+// Whether each byte value is an unreserved character, as defined in RFC 3986 section 2.3, which is
+// copied as is instead of being percent-encoded: [A-Za-z0-9], '-', '.', '_', and '~'.
+static uint8_t const _az_span_url_unreserved_bytes[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x00 - 0x0F
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10 - 0x1F
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, // 0x20 - 0x2F
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, // 0x30 - 0x3F
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x40 - 0x4F
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, // 0x50 - 0x5F
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x60 - 0x6F
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0, // 0x70 - 0x7F
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x80 - 0x8F
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x90 - 0x9F
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xA0 - 0xAF
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xB0 - 0xBF
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xC0 - 0xCF
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xD0 - 0xDF
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xE0 - 0xEF
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xF0 - 0xFF
+};
+
 AZ_NODISCARD AZ_INLINE bool _az_span_url_should_encode(uint8_t c)
 {
-  switch (c)
+  return _az_span_url_unreserved_bytes[c] == 0;
+}
+
+// Returns the index of the first byte of `ptr` at or after `index` that needs to be
+// percent-encoded, or `size` if there is none. Blocks of 32 or 16 bytes are tested at once when
+// SIMD instructions are available.
+AZ_NODISCARD static int32_t
+_az_span_url_skip_unreserved_bytes(uint8_t const* ptr, int32_t index, int32_t size)
+{
+#if defined(_az_SIMD_AVX2)
   {
-    case '-':
-    case '_':
-    case '.':
-    case '~':
-      return false;
-    default:
-      return !(_az_span_is_byte_digit(c) || _az_span_is_byte_letter(c));
+    __m256i const case_bit = _mm256_set1_epi8(_az_ASCII_SPACE_CHARACTER);
+    __m256i const lower_a = _mm256_set1_epi8('a');
+    __m256i const max_letter_offset = _mm256_set1_epi8('z' - 'a');
+    __m256i const zero = _mm256_set1_epi8('0');
+    __m256i const max_digit_offset = _mm256_set1_epi8('9' - '0');
+    __m256i const dash = _mm256_set1_epi8('-');
+    __m256i const dot = _mm256_set1_epi8('.');
+    __m256i const underscore = _mm256_set1_epi8('_');
+    __m256i const tilde = _mm256_set1_epi8('~');
+
+    for (; index + 32 <= size; index += 32)
+    {
+      __m256i const block = _mm256_loadu_si256((__m256i const*)(void const*)(ptr + index));
+      // A byte is in a range if its (unsigned) offset from the start of the range is small enough.
+      __m256i const letter_offset = _mm256_sub_epi8(_mm256_or_si256(block, case_bit), lower_a);
+      __m256i const digit_offset = _mm256_sub_epi8(block, zero);
+      __m256i const unreserved = _mm256_or_si256(
+          _mm256_or_si256(
+              _mm256_cmpeq_epi8(_mm256_min_epu8(letter_offset, max_letter_offset), letter_offset),
+              _mm256_cmpeq_epi8(_mm256_min_epu8(digit_offset, max_digit_offset), digit_offset)),
+          _mm256_or_si256(
+              _mm256_or_si256(_mm256_cmpeq_epi8(block, dash), _mm256_cmpeq_epi8(block, dot)),
+              _mm256_or_si256(
+                  _mm256_cmpeq_epi8(block, underscore), _mm256_cmpeq_epi8(block, tilde))));
+
+      uint32_t const mask = ~(uint32_t)_mm256_movemask_epi8(unreserved);
+      if (mask != 0)
+      {
+        return index + _az_simd_lowest_bit(mask);
+      }
+    }
+  }
+#endif
+
+#if defined(_az_SIMD_SSE2)
+  {
+    __m128i const case_bit = _mm_set1_epi8(_az_ASCII_SPACE_CHARACTER);
+    __m128i const lower_a = _mm_set1_epi8('a');
+    __m128i const max_letter_offset = _mm_set1_epi8('z' - 'a');
+    __m128i const zero = _mm_set1_epi8('0');
+    __m128i const max_digit_offset = _mm_set1_epi8('9' - '0');
+    __m128i const dash = _mm_set1_epi8('-');
+    __m128i const dot = _mm_set1_epi8('.');
+    __m128i const underscore = _mm_set1_epi8('_');
+    __m128i const tilde = _mm_set1_epi8('~');
+
+    for (; index + 16 <= size; index += 16)
+    {
+      __m128i const block = _mm_loadu_si128((__m128i const*)(void const*)(ptr + index));
+      // A byte is in a range if its (unsigned) offset from the start of the range is small enough.
+      __m128i const letter_offset = _mm_sub_epi8(_mm_or_si128(block, case_bit), lower_a);
+      __m128i const digit_offset = _mm_sub_epi8(block, zero);
+      __m128i const unreserved = _mm_or_si128(
+          _mm_or_si128(
+              _mm_cmpeq_epi8(_mm_min_epu8(letter_offset, max_letter_offset), letter_offset),
+              _mm_cmpeq_epi8(_mm_min_epu8(digit_offset, max_digit_offset), digit_offset)),
+          _mm_or_si128(
+              _mm_or_si128(_mm_cmpeq_epi8(block, dash), _mm_cmpeq_epi8(block, dot)),
+              _mm_or_si128(_mm_cmpeq_epi8(block, underscore), _mm_cmpeq_epi8(block, tilde))));
+
+      uint32_t const mask = ~(uint32_t)_mm_movemask_epi8(unreserved) & 0xFFFFU;
+      if (mask != 0)
+      {
+        return index + _az_simd_lowest_bit(mask);
+      }
+    }
   }
+#elif defined(_az_SIMD_NEON)
+  {
+    uint8x16_t const case_bit = vdupq_n_u8(_az_ASCII_SPACE_CHARACTER);
+    uint8x16_t const lower_a = vdupq_n_u8('a');
+    uint8x16_t const max_letter_offset = vdupq_n_u8('z' - 'a');
+    uint8x16_t const zero = vdupq_n_u8('0');
+    uint8x16_t const max_digit_offset = vdupq_n_u8('9' - '0');
+    uint8x16_t const dash = vdupq_n_u8('-');
+    uint8x16_t const dot = vdupq_n_u8('.');
+    uint8x16_t const underscore = vdupq_n_u8('_');
+    uint8x16_t const tilde = vdupq_n_u8('~');
+
+    for (; index + 16 <= size; index += 16)
+    {
+      uint8x16_t const block = vld1q_u8(ptr + index);
+      uint8x16_t const unreserved = vorrq_u8(
+          vorrq_u8(
+              vcleq_u8(vsubq_u8(vorrq_u8(block, case_bit), lower_a), max_letter_offset),
+              vcleq_u8(vsubq_u8(block, zero), max_digit_offset)),
+          vorrq_u8(
+              vorrq_u8(vceqq_u8(block, dash), vceqq_u8(block, dot)),
+              vorrq_u8(vceqq_u8(block, underscore), vceqq_u8(block, tilde))));
+
+      uint64_t const mask = _az_simd_neon_mask(vmvnq_u8(unreserved));
+      if (mask != 0)
+      {
+        return index + _az_simd_lowest_bit(mask) / 4;
+      }
+    }
+  }
+#endif
+
+  for (; index < size; index++)
+  {
+    if (_az_span_url_should_encode(ptr[index]))
+    {
+      break;
+    }
+  }
+
+  return index;
 }
 
 AZ_NODISCARD int32_t _az_span_url_encode_calc_length(az_span source)
@@ -918,14 +1328,11 @@ AZ_NODISCARD int32_t _az_span_url_encode_calc_length(az_span source)
   uint8_t const* const src_ptr = az_span_ptr(source);
 
   int32_t encoded_length = source_size;
-  for (int32_t i = 0; i < source_size; i++)
+  for (int32_t i = _az_span_url_skip_unreserved_bytes(src_ptr, 0, source_size); i < source_size;
+       i = _az_span_url_skip_unreserved_bytes(src_ptr, i + 1, source_size))
   {
-    uint8_t c = src_ptr[i];
-    if (_az_span_url_should_encode(c))
-    {
-      // Adding '%' plus 2 digits (minus 1 as original symbol is counted as 1)
-      encoded_length += 2;
-    }
+    // Adding '%' plus 2 digits (minus 1 as original symbol is counted as 1)
+    encoded_length += 2;
   }
 
   // If source_size is 0, this will return 0.
@@ -942,42 +1349,196 @@ AZ_NODISCARD az_result _az_span_url_encode(az_span destination, az_span source,
 
   _az_PRECONDITION_NO_OVERLAP_SPANS(destination, source);
 
-  uint8_t* const dest_begin = az_span_ptr(destination);
-  uint8_t* const dest_end = dest_begin + az_span_size(destination);
+  uint8_t* const dest_ptr = az_span_ptr(destination);
+  int32_t const dest_size = az_span_size(destination);
+  uint8_t const* const src_ptr = az_span_ptr(source);
+
+  // Spans overlap only when preconditions are off. They are then encoded a byte at a time, each
+  // byte read after the previous ones were written, so that the result doesn't depend on how a
+  // block copy handles overlapping memory.
+  bool const overlap = _az_span_overlap(destination, source);
 
-  uint8_t* const src_ptr = az_span_ptr(source);
-  uint8_t* dest_ptr = dest_begin;
+  int32_t src_index = 0;
+  int32_t dest_index = 0;
 
-  for (int32_t i = 0; i < source_size; i++)
+  while (src_index < source_size)
   {
-    uint8_t c = src_ptr[i];
-    if (!_az_span_url_should_encode(c))
+    // Copy the whole run of bytes that don't need encoding at once, or as much of it as fits.
+    int32_t run_size = _az_span_url_skip_unreserved_bytes(src_ptr, src_index, source_size)
+        - src_index;
+    if (overlap && run_size > 1)
     {
-      if (dest_ptr >= dest_end)
-      {
-        *out_length = 0;
-        return AZ_ERROR_NOT_ENOUGH_SPACE;
-      }
+      run_size = 1;
+    }
 
-      *dest_ptr = c;
-      ++dest_ptr;
+    bool const run_fits = run_size <= dest_size - dest_index;
+    if (!run_fits)
+    {
+      run_size = dest_size - dest_index;
     }
-    else
+
+    if (run_size > 0)
     {
-      if (dest_ptr >= dest_end - 2)
+      if (overlap)
       {
-        *out_length = 0;
-        return AZ_ERROR_NOT_ENOUGH_SPACE;
+        dest_ptr[dest_index] = src_ptr[src_index];
+      }
+      else
+      {
+        memcpy(dest_ptr + dest_index, src_ptr + src_index, (size_t)run_size);
       }
 
-      dest_ptr[0] = '%';
-      dest_ptr[1] = _az_number_to_upper_hex(c >> 4U);
-      dest_ptr[2] = _az_number_to_upper_hex(c & (uint32_t)_az_LARGEST_HEX_VALUE);
-      dest_ptr += 3;
+      src_index += run_size;
+      dest_index += run_size;
     }
+
+    if (!run_fits || src_index == source_size)
+    {
+      break;
+    }
+
+    // The next byte may have been overwritten, so whether it needs encoding is checked again.
+    if (overlap && run_size > 0)
+    {
+      continue;
+    }
+
+    if (dest_size - dest_index < 3)
+    {
+      break;
+    }
+
+    uint8_t const c = src_ptr[src_index];
+    dest_ptr[dest_index] = '%';
+    dest_ptr[dest_index + 1] = _az_number_to_upper_hex(c >> 4U);
+    dest_ptr[dest_index + 2] = _az_number_to_upper_hex(c & (uint32_t)_az_LARGEST_HEX_VALUE);
+    src_index++;
+    dest_index += 3;
   }
 
-  *out_length = (int32_t)(dest_ptr - dest_begin);
+  if (src_index < source_size)
+  {
+    // Everything before src_index was encoded into dest_index bytes, so only the rest of the
+    // source needs to be measured to report the total size needed.
+    *out_length = dest_index
+        + _az_span_url_encode_calc_length(az_span_slice_to_end(source, src_index));
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  *out_length = dest_index;
+  return AZ_OK;
+}
+
+// Gets where the next size bytes go in the destination of the builder, and counts them. Once they
+// don't fit, the length is past the end of the destination, so nothing fits anymore.
+AZ_NODISCARD static uint8_t* _az_span_builder_reserve(az_span_builder* ref_builder, int32_t size)
+{
+  int32_t const length = ref_builder->_internal.length;
+  ref_builder->_internal.length = length + size;
+  if (size > az_span_size(ref_builder->_internal.destination) - length)
+  {
+    return NULL;
+  }
+
+  return az_span_ptr(ref_builder->_internal.destination) + length;
+}
+
+void az_span_builder_append(az_span_builder* ref_builder, az_span source)
+{
+  _az_PRECONDITION_NOT_NULL(ref_builder);
+  _az_PRECONDITION_VALID_SPAN(source, 0, true);
+
+  int32_t const size = az_span_size(source);
+  uint8_t* const ptr = _az_span_builder_reserve(ref_builder, size);
+  if (ptr != NULL && size > 0)
+  {
+    memmove(ptr, az_span_ptr(source), (size_t)size);
+  }
+}
+
+void az_span_builder_append_u8(az_span_builder* ref_builder, uint8_t byte)
+{
+  _az_PRECONDITION_NOT_NULL(ref_builder);
+
+  uint8_t* const ptr = _az_span_builder_reserve(ref_builder, 1);
+  if (ptr != NULL)
+  {
+    *ptr = byte;
+  }
+}
+
+void az_span_builder_append_u64(az_span_builder* ref_builder, uint64_t source)
+{
+  _az_PRECONDITION_NOT_NULL(ref_builder);
+
+  int32_t const digit_count = _az_count_decimal_digits(source);
+  uint8_t* const ptr = _az_span_builder_reserve(ref_builder, digit_count);
+  if (ptr != NULL)
+  {
+    _az_write_decimal_digits(ptr + digit_count, source);
+  }
+}
+
+void az_span_builder_append_i64(az_span_builder* ref_builder, int64_t source)
+{
+  _az_PRECONDITION_NOT_NULL(ref_builder);
+
+  if (source < 0)
+  {
+    az_span_builder_append_u8(ref_builder, '-');
+    // Negate as unsigned, so that INT64_MIN doesn't overflow.
+    az_span_builder_append_u64(ref_builder, 0U - (uint64_t)source);
+    return;
+  }
+
+  az_span_builder_append_u64(ref_builder, (uint64_t)source);
+}
+
+void az_span_builder_append_u32(az_span_builder* ref_builder, uint32_t source)
+{
+  az_span_builder_append_u64(ref_builder, source);
+}
+
+void az_span_builder_append_i32(az_span_builder* ref_builder, int32_t source)
+{
+  az_span_builder_append_i64(ref_builder, source);
+}
+
+void az_span_builder_append_url_encoded(az_span_builder* ref_builder, az_span source)
+{
+  _az_PRECONDITION_NOT_NULL(ref_builder);
+  _az_PRECONDITION_VALID_SPAN(source, 0, true);
+
+  int32_t const length = ref_builder->_internal.length;
+  int32_t const available = az_span_size(ref_builder->_internal.destination) - length;
+
+  // Encoding never shrinks the source, so a destination smaller than it is only measured.
+  if (az_span_size(source) > available)
+  {
+    ref_builder->_internal.length = length + _az_span_url_encode_calc_length(source);
+    return;
+  }
+
+  if (az_span_size(source) == 0)
+  {
+    return;
+  }
+
+  int32_t encoded_length = 0;
+  az_result const result = _az_span_url_encode(
+      az_span_slice_to_end(ref_builder->_internal.destination, length), source, &encoded_length);
+  (void)result; // The length needed is set even if the encoded bytes don't fit.
+  ref_builder->_internal.length = length + encoded_length;
+}
+
+AZ_NODISCARD az_result az_span_builder_get_span(az_span_builder const* builder, az_span* out_span)
+{
+  _az_PRECONDITION_NOT_NULL(builder);
+  _az_PRECONDITION_NOT_NULL(out_span);
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(builder->_internal.destination, builder->_internal.length);
+
+  *out_span = az_span_slice(builder->_internal.destination, 0, builder->_internal.length);
   return AZ_OK;
 }
 
@@ -987,10 +1548,18 @@ az_span _az_span_token(
     az_span* out_remainder,
     int32_t* out_index)
 {
-  _az_PRECONDITION_VALID_SPAN(source, 1, false);
+  _az_PRECONDITION_VALID_SPAN(source, 0, true);
   _az_PRECONDITION_VALID_SPAN(delimiter, 1, false);
   _az_PRECONDITION_NOT_NULL(out_remainder);
 
+  // An empty source, such as the remainder after a trailing delimiter, has no more tokens.
+  if (az_span_size(source) == 0)
+  {
+    *out_index = -1;
+    *out_remainder = AZ_SPAN_EMPTY;
+    return AZ_SPAN_EMPTY;
+  }
+
   *out_index = az_span_find(source, delimiter);
 
   if (*out_index != -1)
@@ -1004,3 +1573,27 @@ az_span _az_span_token(
   *out_remainder = AZ_SPAN_EMPTY;
   return source;
 }
+
+// CRC-32 (IEEE 802.3, reflected), four bits at a time.
+static uint32_t const _az_span_crc32_table[16] = {
+  0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U,
+  0x4DB26158U, 0x5005713CU, 0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+  0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+};
+
+AZ_NODISCARD uint32_t _az_span_crc32(uint32_t crc, az_span source)
+{
+  _az_PRECONDITION_VALID_SPAN(source, 0, true);
+
+  uint8_t const* const ptr = az_span_ptr(source);
+  int32_t const size = az_span_size(source);
+
+  crc = ~crc;
+  for (int32_t i = 0; i < size; i++)
+  {
+    crc ^= ptr[i];
+    crc = (crc >> 4U) ^ _az_span_crc32_table[crc & 0x0FU];
+    crc = (crc >> 4U) ^ _az_span_crc32_table[crc & 0x0FU];
+  }
+  return ~crc;
+}
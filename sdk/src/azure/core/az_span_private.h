@@ -33,7 +33,11 @@ enum
   // 19 + sign (i.e. -9,223,372,036,854,775,808)
   _az_MAX_SIZE_FOR_INT64 = 20,
 
-  // Two digit length to create the "format" passed to sscanf.
+  // The size of an ISO 8601 timestamp with milliseconds (i.e. 2021-03-04T05:06:07.089Z).
+  _az_ISO8601_SIZE = 24,
+
+  // The largest JSON number token straddling multiple segments that can be parsed into a double,
+  // since it needs to be copied into a contiguous buffer on the stack.
   _az_MAX_SIZE_FOR_PARSING_DOUBLE = 99,
 
   // The number value of the ASCII space character ' '.
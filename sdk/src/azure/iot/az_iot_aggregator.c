@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/iot/az_iot_common.h>
+
+#include <azure/core/_az_cfg.h>
+
+// Any non-zero seed works for the xorshift generator, which doesn't need to be unpredictable.
+#define _az_IOT_AGGREGATOR_RANDOM_SEED 0x9E3779B9U
+
+AZ_NODISCARD az_result az_iot_aggregator_init(
+    az_iot_aggregator* aggregator,
+    double* samples,
+    int32_t sample_capacity,
+    int64_t window_length)
+{
+  _az_PRECONDITION_NOT_NULL(aggregator);
+  _az_PRECONDITION(sample_capacity >= 0);
+  _az_PRECONDITION(samples != NULL || sample_capacity == 0);
+  _az_PRECONDITION(window_length > 0);
+
+  *aggregator = (az_iot_aggregator){
+    ._internal = {
+      .samples = samples,
+      .window_length = window_length,
+      .window_start = 0,
+      .minimum = 0,
+      .maximum = 0,
+      .sum = 0,
+      .sample_capacity = sample_capacity,
+      .count = 0,
+      .random_state = _az_IOT_AGGREGATOR_RANDOM_SEED,
+    },
+  };
+
+  return AZ_OK;
+}
+
+// Returns a random number from 0 to bound - 1, from a xorshift generator.
+AZ_INLINE uint32_t _az_iot_aggregator_random(az_iot_aggregator* aggregator, uint32_t bound)
+{
+  uint32_t x = aggregator->_internal.random_state;
+  x ^= x << 13U;
+  x ^= x >> 17U;
+  x ^= x << 5U;
+  aggregator->_internal.random_state = x;
+
+  // Scale rather than take the remainder, which avoids a division.
+  return (uint32_t)(((uint64_t)x * bound) >> 32U);
+}
+
+void az_iot_aggregator_add(az_iot_aggregator* aggregator, double value, int64_t now)
+{
+  _az_PRECONDITION_NOT_NULL(aggregator);
+  _az_PRECONDITION(aggregator->_internal.count < INT32_MAX);
+
+  int32_t const count = aggregator->_internal.count;
+  if (count == 0)
+  {
+    aggregator->_internal.window_start = now;
+    aggregator->_internal.minimum = value;
+    aggregator->_internal.maximum = value;
+    aggregator->_internal.sum = 0;
+  }
+  else if (value < aggregator->_internal.minimum)
+  {
+    aggregator->_internal.minimum = value;
+  }
+  else if (value > aggregator->_internal.maximum)
+  {
+    aggregator->_internal.maximum = value;
+  }
+
+  aggregator->_internal.sum += value;
+
+  // Reservoir sampling: the first values fill the sample, then each value replaces a random one of
+  // it with the probability that keeps every value of the window equally likely to be in it.
+  if (count < aggregator->_internal.sample_capacity)
+  {
+    aggregator->_internal.samples[count] = value;
+  }
+  else if (aggregator->_internal.sample_capacity > 0)
+  {
+    uint32_t const index = _az_iot_aggregator_random(aggregator, (uint32_t)count + 1U);
+    if (index < (uint32_t)aggregator->_internal.sample_capacity)
+    {
+      aggregator->_internal.samples[index] = value;
+    }
+  }
+
+  aggregator->_internal.count = count + 1;
+}
+
+AZ_NODISCARD az_result az_iot_aggregator_append_json(
+    az_iot_aggregator const* aggregator,
+    az_json_writer* ref_json_writer,
+    int32_t fractional_digits)
+{
+  _az_PRECONDITION_NOT_NULL(aggregator);
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(aggregator->_internal.count > 0);
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_json_writer));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("count")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_int32(ref_json_writer, aggregator->_internal.count));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("min")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_double(
+      ref_json_writer, aggregator->_internal.minimum, fractional_digits));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("max")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_double(
+      ref_json_writer, aggregator->_internal.maximum, fractional_digits));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("mean")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_double(
+      ref_json_writer, az_iot_aggregator_get_mean(aggregator), fractional_digits));
+
+  if (aggregator->_internal.sample_capacity > 0)
+  {
+    int32_t const sample_count = aggregator->_internal.count < aggregator->_internal.sample_capacity
+        ? aggregator->_internal.count
+        : aggregator->_internal.sample_capacity;
+
+    _az_RETURN_IF_FAILED(
+        az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("samples")));
+    _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_json_writer));
+    for (int32_t i = 0; i < sample_count; i++)
+    {
+      _az_RETURN_IF_FAILED(az_json_writer_append_double(
+          ref_json_writer, aggregator->_internal.samples[i], fractional_digits));
+    }
+    _az_RETURN_IF_FAILED(az_json_writer_append_end_array(ref_json_writer));
+  }
+
+  return az_json_writer_append_end_object(ref_json_writer);
+}
+
+AZ_NODISCARD az_result az_iot_dead_band_filter_init(
+    az_iot_dead_band_filter* filter,
+    double dead_band,
+    int64_t max_interval)
+{
+  _az_PRECONDITION_NOT_NULL(filter);
+  _az_PRECONDITION(dead_band >= 0);
+  _az_PRECONDITION(max_interval >= 0);
+
+  *filter = (az_iot_dead_band_filter){
+    ._internal = {
+      .dead_band = dead_band,
+      .last_sent_value = 0,
+      .max_interval = max_interval,
+      .last_sent_time = 0,
+      .has_sent = false,
+    },
+  };
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD bool
+az_iot_dead_band_filter_should_send(az_iot_dead_band_filter* filter, double value, int64_t now)
+{
+  _az_PRECONDITION_NOT_NULL(filter);
+
+  if (filter->_internal.has_sent)
+  {
+    double const change = value - filter->_internal.last_sent_value;
+    bool const is_within_dead_band
+        = change <= filter->_internal.dead_band && change >= -filter->_internal.dead_band;
+    bool const is_interval_elapsed = filter->_internal.max_interval > 0
+        && now - filter->_internal.last_sent_time >= filter->_internal.max_interval;
+
+    if (is_within_dead_band && !is_interval_elapsed)
+    {
+      return false;
+    }
+  }
+
+  filter->_internal.last_sent_value = value;
+  filter->_internal.last_sent_time = now;
+  filter->_internal.has_sent = true;
+  return true;
+}
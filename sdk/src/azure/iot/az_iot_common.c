@@ -19,6 +19,13 @@
 static const az_span hub_client_param_separator_span = AZ_SPAN_LITERAL_FROM_STR("&");
 static const az_span hub_client_param_equals_span = AZ_SPAN_LITERAL_FROM_STR("=");
 
+static const az_span message_system_property_encoded_prefix = AZ_SPAN_LITERAL_FROM_STR("%24.");
+static const az_span message_system_property_prefix = AZ_SPAN_LITERAL_FROM_STR("$.");
+static const az_span message_id_property_name = AZ_SPAN_LITERAL_FROM_STR("mid");
+static const az_span correlation_id_property_name = AZ_SPAN_LITERAL_FROM_STR("cid");
+static const az_span content_type_property_name = AZ_SPAN_LITERAL_FROM_STR("ct");
+static const az_span content_encoding_property_name = AZ_SPAN_LITERAL_FROM_STR("ce");
+
 AZ_NODISCARD az_result az_iot_message_properties_init(
     az_iot_message_properties* properties,
     az_span buffer,
@@ -31,6 +38,66 @@ AZ_NODISCARD az_result az_iot_message_properties_init(
   properties->_internal.properties_buffer = buffer;
   properties->_internal.properties_written = written_length;
   properties->_internal.current_property_index = 0;
+  properties->_internal.index = NULL;
+  properties->_internal.index_capacity = 0;
+  properties->_internal.index_length = 0;
+  properties->_internal.indexed_length = 0;
+
+  return AZ_OK;
+}
+
+// Adds index entries for the properties written after `indexed_length`, as long as there are
+// unused index entries. `indexed_length` always points to the start of the next property name that
+// is not indexed yet (or to the end of the written properties).
+static void _az_iot_message_properties_update_index(az_iot_message_properties* properties)
+{
+  az_span const buffer = properties->_internal.properties_buffer;
+  int32_t const written = properties->_internal.properties_written;
+  int32_t offset = properties->_internal.indexed_length;
+
+  while (offset < written
+         && properties->_internal.index_length < properties->_internal.index_capacity)
+  {
+    int32_t index = 0;
+    az_span remaining = az_span_slice(buffer, offset, written);
+    az_span name = _az_span_token(remaining, hub_client_param_equals_span, &remaining, &index);
+    if (index == -1)
+    {
+      // A trailing name without a value can never be found.
+      offset = written;
+      break;
+    }
+
+    az_span value = _az_span_token(remaining, hub_client_param_separator_span, &remaining, &index);
+
+    az_iot_message_properties_index_entry* entry
+        = &properties->_internal.index[properties->_internal.index_length];
+    entry->_internal.name_offset = offset;
+    entry->_internal.name_length = az_span_size(name);
+    entry->_internal.value_length = az_span_size(value);
+    properties->_internal.index_length++;
+
+    offset = index == -1 ? written : written - az_span_size(remaining);
+  }
+
+  properties->_internal.indexed_length = offset;
+}
+
+AZ_NODISCARD az_result az_iot_message_properties_set_index(
+    az_iot_message_properties* properties,
+    az_iot_message_properties_index_entry* index_entries,
+    int32_t index_entries_length)
+{
+  _az_PRECONDITION_NOT_NULL(properties);
+  _az_PRECONDITION_NOT_NULL(index_entries);
+  _az_PRECONDITION(index_entries_length > 0);
+
+  properties->_internal.index = index_entries;
+  properties->_internal.index_capacity = index_entries_length;
+  properties->_internal.index_length = 0;
+  properties->_internal.indexed_length = 0;
+
+  _az_iot_message_properties_update_index(properties);
 
   return AZ_OK;
 }
@@ -66,6 +133,17 @@ az_iot_message_properties_append(az_iot_message_properties* properties, az_span
 
   properties->_internal.properties_written += required_length;
 
+  if (properties->_internal.index != NULL)
+  {
+    // Skip the separator if the new property follows the last indexed one.
+    if (prop_length > 0 && properties->_internal.indexed_length == prop_length)
+    {
+      properties->_internal.indexed_length++;
+    }
+
+    _az_iot_message_properties_update_index(properties);
+  }
+
   return AZ_OK;
 }
 
@@ -78,8 +156,33 @@ AZ_NODISCARD az_result az_iot_message_properties_find(
   _az_PRECONDITION_VALID_SPAN(name, 1, false);
   _az_PRECONDITION_NOT_NULL(out_value);
 
+  int32_t start = 0;
+
+  if (properties->_internal.index != NULL)
+  {
+    uint8_t* const buffer_ptr = az_span_ptr(properties->_internal.properties_buffer);
+    int32_t const name_size = az_span_size(name);
+
+    for (int32_t i = 0; i < properties->_internal.index_length; i++)
+    {
+      az_iot_message_properties_index_entry const* entry = &properties->_internal.index[i];
+      if (entry->_internal.name_length == name_size
+          && az_span_is_content_equal(
+              az_span_create(buffer_ptr + entry->_internal.name_offset, name_size), name))
+      {
+        *out_value = az_span_create(
+            buffer_ptr + entry->_internal.name_offset + name_size + 1,
+            entry->_internal.value_length);
+        return AZ_OK;
+      }
+    }
+
+    // Only the properties which didn't fit in the index need to be parsed.
+    start = properties->_internal.indexed_length;
+  }
+
   az_span remaining = az_span_slice(
-      properties->_internal.properties_buffer, 0, properties->_internal.properties_written);
+      properties->_internal.properties_buffer, start, properties->_internal.properties_written);
 
   while (az_span_size(remaining) != 0)
   {
@@ -138,6 +241,76 @@ AZ_NODISCARD az_result az_iot_message_properties_next(
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result az_iot_message_properties_get_system_properties(
+    az_iot_message_properties const* properties,
+    az_iot_message_system_properties* out_system_properties)
+{
+  _az_PRECONDITION_NOT_NULL(properties);
+  _az_PRECONDITION_NOT_NULL(out_system_properties);
+
+  *out_system_properties = (az_iot_message_system_properties){
+    .message_id = AZ_SPAN_EMPTY,
+    .correlation_id = AZ_SPAN_EMPTY,
+    .content_type = AZ_SPAN_EMPTY,
+    .content_encoding = AZ_SPAN_EMPTY,
+  };
+
+  az_span remaining = az_span_slice(
+      properties->_internal.properties_buffer, 0, properties->_internal.properties_written);
+
+  while (az_span_size(remaining) != 0)
+  {
+    int32_t index = 0;
+    az_span name = _az_span_token(remaining, hub_client_param_equals_span, &remaining, &index);
+    if (index == -1)
+    {
+      break;
+    }
+
+    az_span const value
+        = _az_span_token(remaining, hub_client_param_separator_span, &remaining, &index);
+
+    if (_az_span_starts_with(name, message_system_property_encoded_prefix))
+    {
+      name = az_span_slice_to_end(name, az_span_size(message_system_property_encoded_prefix));
+    }
+    else if (_az_span_starts_with(name, message_system_property_prefix))
+    {
+      name = az_span_slice_to_end(name, az_span_size(message_system_property_prefix));
+    }
+    else
+    {
+      continue;
+    }
+
+    // The first occurrence of a property wins, as with az_iot_message_properties_find().
+    az_span* target = NULL;
+    if (az_span_is_content_equal(name, message_id_property_name))
+    {
+      target = &out_system_properties->message_id;
+    }
+    else if (az_span_is_content_equal(name, correlation_id_property_name))
+    {
+      target = &out_system_properties->correlation_id;
+    }
+    else if (az_span_is_content_equal(name, content_type_property_name))
+    {
+      target = &out_system_properties->content_type;
+    }
+    else if (az_span_is_content_equal(name, content_encoding_property_name))
+    {
+      target = &out_system_properties->content_encoding;
+    }
+
+    if (target != NULL && az_span_ptr(*target) == NULL)
+    {
+      *target = value;
+    }
+  }
+
+  return AZ_OK;
+}
+
 AZ_NODISCARD int32_t az_iot_calculate_retry_delay(
     int32_t operation_msec,
     int16_t attempt,
@@ -173,6 +346,93 @@ AZ_NODISCARD int32_t az_iot_calculate_retry_delay(
   return delay > 0 ? delay : 0;
 }
 
+AZ_NODISCARD int32_t az_iot_calculate_retry_delay_decorrelated(
+    int32_t operation_msec,
+    int32_t previous_delay_msec,
+    int32_t min_retry_delay_msec,
+    int32_t max_retry_delay_msec,
+    uint32_t random)
+{
+  _az_PRECONDITION_RANGE(0, operation_msec, INT32_MAX - 1);
+  _az_PRECONDITION_RANGE(0, previous_delay_msec, INT32_MAX - 1);
+  _az_PRECONDITION_RANGE(0, min_retry_delay_msec, INT32_MAX - 1);
+  _az_PRECONDITION_RANGE(0, max_retry_delay_msec, INT32_MAX - 1);
+
+  if (_az_LOG_SHOULD_WRITE(AZ_LOG_IOT_RETRY))
+  {
+    _az_LOG_WRITE(AZ_LOG_IOT_RETRY, AZ_SPAN_EMPTY);
+  }
+
+  int32_t const delay = _az_retry_calc_delay_decorrelated(
+                            previous_delay_msec, min_retry_delay_msec, max_retry_delay_msec, random)
+      - operation_msec;
+
+  return delay > 0 ? delay : 0;
+}
+
+// The finalizer of MurmurHash3: each bit of the result depends on every bit of the value.
+static uint32_t _az_iot_mix32(uint32_t value)
+{
+  value ^= value >> 16;
+  value *= 0x85EBCA6BU;
+  value ^= value >> 13;
+  value *= 0xC2B2AE35U;
+  value ^= value >> 16;
+  return value;
+}
+
+AZ_NODISCARD az_result az_iot_calculate_retry_schedule(
+    az_span device_id,
+    uint32_t seed,
+    int32_t min_retry_delay_msec,
+    int32_t max_retry_delay_msec,
+    int32_t spread_msec,
+    int32_t out_schedule_msec[],
+    int32_t schedule_length)
+{
+  _az_PRECONDITION_VALID_SPAN(device_id, 0, true);
+  _az_PRECONDITION_RANGE(0, min_retry_delay_msec, INT32_MAX - 1);
+  _az_PRECONDITION_RANGE(min_retry_delay_msec, max_retry_delay_msec, INT32_MAX - 1);
+  _az_PRECONDITION_RANGE(0, spread_msec, INT32_MAX - 1);
+  _az_PRECONDITION_NOT_NULL(out_schedule_msec);
+  _az_PRECONDITION_RANGE(1, schedule_length, INT32_MAX);
+
+  if (_az_LOG_SHOULD_WRITE(AZ_LOG_IOT_RETRY))
+  {
+    _az_LOG_WRITE(AZ_LOG_IOT_RETRY, AZ_SPAN_EMPTY);
+  }
+
+  // FNV-1a of the device ID, so that each device of the fleet gets its own offsets.
+  uint32_t hash = 0x811C9DC5U;
+  uint8_t const* const id = az_span_ptr(device_id);
+  for (int32_t i = 0; i < az_span_size(device_id); i++)
+  {
+    hash = (hash ^ id[i]) * 0x01000193U;
+  }
+
+  hash = _az_iot_mix32(hash ^ seed);
+
+  int32_t const window
+      = spread_msec < max_retry_delay_msec - min_retry_delay_msec
+      ? spread_msec
+      : max_retry_delay_msec - min_retry_delay_msec;
+
+  for (int32_t i = 0; i < schedule_length; i++)
+  {
+    int32_t start = _az_retry_calc_delay(i, min_retry_delay_msec, max_retry_delay_msec);
+    if (start < 0 || start > max_retry_delay_msec - window)
+    {
+      start = max_retry_delay_msec - window;
+    }
+
+    // Maps the hash of the attempt onto the window without the bias of a modulo.
+    uint32_t const random = _az_iot_mix32(hash + (uint32_t)i * 0x9E3779B9U);
+    out_schedule_msec[i] = start + (int32_t)(((uint64_t)random * (uint64_t)window) >> 32);
+  }
+
+  return AZ_OK;
+}
+
 AZ_NODISCARD int32_t _az_iot_u32toa_size(uint32_t number)
 {
   if (number == 0)
@@ -0,0 +1,397 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <azure/core/az_precondition.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/iot/az_iot_common.h>
+#include <azure/iot/internal/az_iot_common_internal.h>
+
+// The SHA-256 instructions are only used when the compiler targets them, like the SIMD byte
+// scanning loops of the core library.
+#if defined(__SHA__) && defined(__SSE4_1__)
+#include <immintrin.h>
+#define _az_IOT_SHA256_X86
+#elif defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+#include <arm_neon.h>
+#define _az_IOT_SHA256_ARM
+#endif
+
+#include <azure/core/_az_cfg.h>
+
+#define _az_SHA256_BLOCK_SIZE 64
+#define _az_SHA256_STATE_WORDS 8
+#define _az_HMAC_INNER_PAD 0x36
+#define _az_HMAC_OUTER_PAD 0x5C
+
+static const uint32_t _az_sha256_initial_state[_az_SHA256_STATE_WORDS]
+    = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+static const uint32_t _az_sha256_round_constants[64]
+    = { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+        0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+        0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+        0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+        0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+        0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+        0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+        0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+        0xc67178f2 };
+
+static az_iot_hmac_sha256_fn volatile _az_iot_hmac_sha256_callback = NULL;
+
+#if defined(_az_IOT_SHA256_X86)
+
+static void _az_sha256_compress(uint32_t state[8], uint8_t const* blocks, int32_t block_count)
+{
+  // The instructions work on the state words rearranged as ABEF and CDGH.
+  __m128i const byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+  __m128i const cdab = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)&state[0]), 0xB1);
+  __m128i const efgh = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)&state[4]), 0x1B);
+  __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+  __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xF0);
+
+  for (; block_count > 0; block_count--, blocks += _az_SHA256_BLOCK_SIZE)
+  {
+    __m128i const previous_abef = abef;
+    __m128i const previous_cdgh = cdgh;
+
+    __m128i words[4];
+    for (int32_t i = 0; i < 4; i++)
+    {
+      words[i] = _mm_shuffle_epi8(
+          _mm_loadu_si128((__m128i const*)(blocks + (i * 16))), byte_swap_mask);
+    }
+
+    // Each iteration runs 4 rounds, and schedules the 4 message words used 4 iterations later.
+    for (int32_t i = 0; i < 16; i++)
+    {
+      if (i >= 4)
+      {
+        words[i & 3] = _mm_sha256msg2_epu32(
+            _mm_add_epi32(
+                _mm_sha256msg1_epu32(words[i & 3], words[(i + 1) & 3]),
+                _mm_alignr_epi8(words[(i + 3) & 3], words[(i + 2) & 3], 4)),
+            words[(i + 3) & 3]);
+      }
+
+      __m128i message = _mm_add_epi32(
+          words[i & 3], _mm_loadu_si128((__m128i const*)&_az_sha256_round_constants[i * 4]));
+      cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+      message = _mm_shuffle_epi32(message, 0x0E);
+      abef = _mm_sha256rnds2_epu32(abef, cdgh, message);
+    }
+
+    abef = _mm_add_epi32(abef, previous_abef);
+    cdgh = _mm_add_epi32(cdgh, previous_cdgh);
+  }
+
+  __m128i const feba = _mm_shuffle_epi32(abef, 0x1B);
+  __m128i const dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+  _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(feba, dchg, 0xF0));
+  _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(dchg, feba, 8));
+}
+
+#elif defined(_az_IOT_SHA256_ARM)
+
+static void _az_sha256_compress(uint32_t state[8], uint8_t const* blocks, int32_t block_count)
+{
+  uint32x4_t abcd = vld1q_u32(&state[0]);
+  uint32x4_t efgh = vld1q_u32(&state[4]);
+
+  for (; block_count > 0; block_count--, blocks += _az_SHA256_BLOCK_SIZE)
+  {
+    uint32x4_t const previous_abcd = abcd;
+    uint32x4_t const previous_efgh = efgh;
+
+    uint32x4_t words[4];
+    for (int32_t i = 0; i < 4; i++)
+    {
+      words[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + (i * 16))));
+    }
+
+    // Each iteration runs 4 rounds, and schedules the 4 message words used 4 iterations later.
+    for (int32_t i = 0; i < 16; i++)
+    {
+      uint32x4_t const message
+          = vaddq_u32(words[i & 3], vld1q_u32(&_az_sha256_round_constants[i * 4]));
+      if (i < 12)
+      {
+        words[i & 3] = vsha256su1q_u32(
+            vsha256su0q_u32(words[i & 3], words[(i + 1) & 3]),
+            words[(i + 2) & 3],
+            words[(i + 3) & 3]);
+      }
+
+      uint32x4_t const rounds_abcd = abcd;
+      abcd = vsha256hq_u32(abcd, efgh, message);
+      efgh = vsha256h2q_u32(efgh, rounds_abcd, message);
+    }
+
+    abcd = vaddq_u32(abcd, previous_abcd);
+    efgh = vaddq_u32(efgh, previous_efgh);
+  }
+
+  vst1q_u32(&state[0], abcd);
+  vst1q_u32(&state[4], efgh);
+}
+
+#else
+
+#define _az_ROTR32(value, count) (((value) >> (count)) | ((value) << (32 - (count))))
+
+static void _az_sha256_compress(uint32_t state[8], uint8_t const* blocks, int32_t block_count)
+{
+  for (; block_count > 0; block_count--, blocks += _az_SHA256_BLOCK_SIZE)
+  {
+    uint32_t words[64];
+    for (int32_t i = 0; i < 16; i++)
+    {
+      uint8_t const* const word = blocks + (i * 4);
+      words[i] = ((uint32_t)word[0] << 24) | ((uint32_t)word[1] << 16) | ((uint32_t)word[2] << 8)
+          | (uint32_t)word[3];
+    }
+
+    for (int32_t i = 16; i < 64; i++)
+    {
+      uint32_t const s0
+          = _az_ROTR32(words[i - 15], 7) ^ _az_ROTR32(words[i - 15], 18) ^ (words[i - 15] >> 3);
+      uint32_t const s1
+          = _az_ROTR32(words[i - 2], 17) ^ _az_ROTR32(words[i - 2], 19) ^ (words[i - 2] >> 10);
+      words[i] = words[i - 16] + s0 + words[i - 7] + s1;
+    }
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    uint32_t f = state[5];
+    uint32_t g = state[6];
+    uint32_t h = state[7];
+
+    for (int32_t i = 0; i < 64; i++)
+    {
+      uint32_t const s1 = _az_ROTR32(e, 6) ^ _az_ROTR32(e, 11) ^ _az_ROTR32(e, 25);
+      uint32_t const choice = (e & f) ^ (~e & g);
+      uint32_t const temp1 = h + s1 + choice + _az_sha256_round_constants[i] + words[i];
+      uint32_t const s0 = _az_ROTR32(a, 2) ^ _az_ROTR32(a, 13) ^ _az_ROTR32(a, 22);
+      uint32_t const majority = (a & b) ^ (a & c) ^ (b & c);
+      uint32_t const temp2 = s0 + majority;
+
+      h = g;
+      g = f;
+      f = e;
+      e = d + temp1;
+      d = c;
+      c = b;
+      b = a;
+      a = temp1 + temp2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+}
+
+#endif // _az_IOT_SHA256_X86
+
+// Hashes the last bytes of a message, whose first prefix_size bytes were already compressed into
+// state, and writes the SHA-256 hash to out_hash.
+static void _az_sha256_final(
+    uint32_t state[8],
+    int32_t prefix_size,
+    uint8_t const* data,
+    int32_t size,
+    uint8_t out_hash[AZ_IOT_HMAC_SHA256_SIZE])
+{
+  int32_t const full_block_count = size / _az_SHA256_BLOCK_SIZE;
+  _az_sha256_compress(state, data, full_block_count);
+
+  // The message is padded with 0x80, then zeros, then its size in bits, to fill the last block, or
+  // the last two blocks if the size doesn't fit in the first one.
+  int32_t const remaining_size = size - (full_block_count * _az_SHA256_BLOCK_SIZE);
+  uint8_t last_blocks[2 * _az_SHA256_BLOCK_SIZE] = { 0 };
+  if (remaining_size > 0)
+  {
+    memcpy(
+        last_blocks, data + (full_block_count * _az_SHA256_BLOCK_SIZE), (size_t)remaining_size);
+  }
+  last_blocks[remaining_size] = 0x80;
+
+  int32_t const last_block_count = remaining_size < (_az_SHA256_BLOCK_SIZE - 8) ? 1 : 2;
+  uint64_t const bit_size = ((uint64_t)prefix_size + (uint64_t)size) * 8U;
+  uint8_t* const size_bytes = last_blocks + (last_block_count * _az_SHA256_BLOCK_SIZE) - 8;
+  for (int32_t i = 0; i < 8; i++)
+  {
+    size_bytes[i] = (uint8_t)(bit_size >> (56 - (i * 8)));
+  }
+
+  _az_sha256_compress(state, last_blocks, last_block_count);
+
+  for (int32_t i = 0; i < _az_SHA256_STATE_WORDS; i++)
+  {
+    out_hash[i * 4] = (uint8_t)(state[i] >> 24);
+    out_hash[(i * 4) + 1] = (uint8_t)(state[i] >> 16);
+    out_hash[(i * 4) + 2] = (uint8_t)(state[i] >> 8);
+    out_hash[(i * 4) + 3] = (uint8_t)state[i];
+  }
+}
+
+// Compresses the key, XORed with the inner and outer pads of the HMAC, into the states every
+// HMAC-SHA256 hash with that key starts from.
+static void _az_hmac_sha256_init_states(
+    az_span key,
+    uint32_t inner_state[8],
+    uint32_t outer_state[8])
+{
+  uint8_t key_block[_az_SHA256_BLOCK_SIZE] = { 0 };
+  int32_t const key_size = az_span_size(key);
+  if (key_size > _az_SHA256_BLOCK_SIZE)
+  {
+    // Keys longer than a block are hashed first.
+    uint32_t key_state[_az_SHA256_STATE_WORDS];
+    memcpy(key_state, _az_sha256_initial_state, sizeof(key_state));
+    _az_sha256_final(key_state, 0, az_span_ptr(key), key_size, key_block);
+  }
+  else if (key_size > 0)
+  {
+    memcpy(key_block, az_span_ptr(key), (size_t)key_size);
+  }
+
+  uint8_t pad_block[_az_SHA256_BLOCK_SIZE];
+
+  for (int32_t i = 0; i < _az_SHA256_BLOCK_SIZE; i++)
+  {
+    pad_block[i] = (uint8_t)(key_block[i] ^ _az_HMAC_INNER_PAD);
+  }
+  memcpy(inner_state, _az_sha256_initial_state, sizeof(_az_sha256_initial_state));
+  _az_sha256_compress(inner_state, pad_block, 1);
+
+  for (int32_t i = 0; i < _az_SHA256_BLOCK_SIZE; i++)
+  {
+    pad_block[i] = (uint8_t)(key_block[i] ^ _az_HMAC_OUTER_PAD);
+  }
+  memcpy(outer_state, _az_sha256_initial_state, sizeof(_az_sha256_initial_state));
+  _az_sha256_compress(outer_state, pad_block, 1);
+}
+
+static void _az_hmac_sha256_from_states(
+    uint32_t const inner_state[8],
+    uint32_t const outer_state[8],
+    az_span data,
+    uint8_t out_hash[AZ_IOT_HMAC_SHA256_SIZE])
+{
+  uint32_t state[_az_SHA256_STATE_WORDS];
+  uint8_t inner_hash[AZ_IOT_HMAC_SHA256_SIZE];
+
+  memcpy(state, inner_state, sizeof(state));
+  _az_sha256_final(state, _az_SHA256_BLOCK_SIZE, az_span_ptr(data), az_span_size(data), inner_hash);
+
+  memcpy(state, outer_state, sizeof(state));
+  _az_sha256_final(state, _az_SHA256_BLOCK_SIZE, inner_hash, AZ_IOT_HMAC_SHA256_SIZE, out_hash);
+}
+
+void az_iot_set_hmac_sha256_callback(az_iot_hmac_sha256_fn hmac_sha256_callback)
+{
+  _az_iot_hmac_sha256_callback = hmac_sha256_callback;
+}
+
+AZ_NODISCARD az_result az_iot_hmac_sha256(az_span key, az_span data, az_span destination_hash)
+{
+  _az_PRECONDITION_VALID_SPAN(key, 0, true);
+  _az_PRECONDITION_VALID_SPAN(data, 0, true);
+  _az_PRECONDITION_VALID_SPAN(destination_hash, 0, true);
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination_hash, AZ_IOT_HMAC_SHA256_SIZE);
+
+  az_iot_hmac_sha256_fn const callback = _az_iot_hmac_sha256_callback;
+  if (callback != NULL)
+  {
+    return callback(key, data, destination_hash);
+  }
+
+  uint32_t inner_state[_az_SHA256_STATE_WORDS];
+  uint32_t outer_state[_az_SHA256_STATE_WORDS];
+  _az_hmac_sha256_init_states(key, inner_state, outer_state);
+  _az_hmac_sha256_from_states(inner_state, outer_state, data, az_span_ptr(destination_hash));
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_iot_base64_encode(az_span destination_base64_text, az_span source_bytes, int32_t* out_written)
+{
+  return az_span_base64_encode(destination_base64_text, source_bytes, out_written);
+}
+
+AZ_NODISCARD az_result
+az_iot_base64_decode(az_span destination_bytes, az_span source_base64_text, int32_t* out_written)
+{
+  return az_span_base64_decode(destination_bytes, source_base64_text, out_written);
+}
+
+AZ_NODISCARD az_result az_iot_sas_key_init(az_iot_sas_key* out_sas_key, az_span key)
+{
+  _az_PRECONDITION_NOT_NULL(out_sas_key);
+  _az_PRECONDITION_VALID_SPAN(key, 1, false);
+
+  out_sas_key->_internal.key = key;
+  _az_hmac_sha256_init_states(
+      key, out_sas_key->_internal.inner_state, out_sas_key->_internal.outer_state);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+_az_iot_sas_key_hmac_sha256(az_iot_sas_key const* sas_key, az_span data, uint8_t* out_hash)
+{
+  az_iot_hmac_sha256_fn const callback = _az_iot_hmac_sha256_callback;
+  if (callback != NULL)
+  {
+    return callback(
+        sas_key->_internal.key, data, az_span_create(out_hash, AZ_IOT_HMAC_SHA256_SIZE));
+  }
+
+  _az_hmac_sha256_from_states(
+      sas_key->_internal.inner_state, sas_key->_internal.outer_state, data, out_hash);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_sas_key_sign(
+    az_iot_sas_key const* sas_key,
+    az_span signature,
+    az_span destination_base64_hmac_sha256,
+    az_span* out_base64_hmac_sha256)
+{
+  _az_PRECONDITION_NOT_NULL(sas_key);
+  _az_PRECONDITION_VALID_SPAN(signature, 1, false);
+  _az_PRECONDITION_VALID_SPAN(destination_base64_hmac_sha256, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_base64_hmac_sha256);
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination_base64_hmac_sha256, AZ_IOT_BASE64_HMAC_SHA256_SIZE);
+
+  uint8_t hash[AZ_IOT_HMAC_SHA256_SIZE];
+  _az_RETURN_IF_FAILED(_az_iot_sas_key_hmac_sha256(sas_key, signature, hash));
+
+  int32_t written = 0;
+  _az_RETURN_IF_FAILED(
+      az_iot_base64_encode(destination_base64_hmac_sha256, AZ_SPAN_FROM_BUFFER(hash), &written));
+
+  *out_base64_hmac_sha256 = az_span_slice(destination_base64_hmac_sha256, 0, written);
+  return AZ_OK;
+}
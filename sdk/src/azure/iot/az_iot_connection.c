@@ -0,0 +1,296 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/iot/az_iot_common.h>
+
+#include <azure/core/_az_cfg.h>
+
+// MQTT 3.1.1 CONNACK return codes, and the SUBACK failure return code.
+#define _az_MQTT_CONNACK_ACCEPTED 0
+#define _az_MQTT_CONNACK_SERVER_UNAVAILABLE 3
+#define _az_MQTT_CONNACK_BAD_USER_NAME_OR_PASSWORD 4
+#define _az_MQTT_CONNACK_NOT_AUTHORIZED 5
+#define _az_MQTT_SUBACK_FAILURE 0x80
+
+static az_iot_status _az_iot_connection_status_from_connack(int32_t return_code)
+{
+  switch (return_code)
+  {
+    case _az_MQTT_CONNACK_ACCEPTED:
+      return AZ_IOT_STATUS_OK;
+    case _az_MQTT_CONNACK_SERVER_UNAVAILABLE:
+      return AZ_IOT_STATUS_SERVER_ERROR;
+    case _az_MQTT_CONNACK_BAD_USER_NAME_OR_PASSWORD:
+    case _az_MQTT_CONNACK_NOT_AUTHORIZED:
+      return AZ_IOT_STATUS_UNAUTHORIZED;
+    default:
+      return AZ_IOT_STATUS_BAD_REQUEST;
+  }
+}
+
+// Whether the transport is open, from the CONNECT until the connection is lost or closed.
+AZ_INLINE bool _az_iot_connection_is_open(az_iot_connection_state state)
+{
+  return state == AZ_IOT_CONNECTION_STATE_CONNECTING || state == AZ_IOT_CONNECTION_STATE_SUBSCRIBING
+      || state == AZ_IOT_CONNECTION_STATE_CONNECTED;
+}
+
+static void _az_iot_connection_set_state(
+    az_iot_connection* connection,
+    az_iot_connection_state state,
+    int64_t deadline)
+{
+  connection->_internal.state = (uint8_t)state;
+  connection->_internal.deadline = deadline;
+}
+
+static az_iot_connection_action _az_iot_connection_connect(
+    az_iot_connection* connection,
+    int64_t now_msec)
+{
+  connection->_internal.operation_start = now_msec;
+  _az_iot_connection_set_state(
+      connection,
+      AZ_IOT_CONNECTION_STATE_CONNECTING,
+      now_msec + connection->_internal.options.connect_timeout_msec);
+  return AZ_IOT_CONNECTION_ACTION_CONNECT;
+}
+
+static void _az_iot_connection_connected(az_iot_connection* connection)
+{
+  connection->_internal.status = AZ_IOT_STATUS_OK;
+  connection->_internal.attempt = 0;
+  _az_iot_connection_set_state(connection, AZ_IOT_CONNECTION_STATE_CONNECTED, INT64_MAX);
+}
+
+// Waits for the retry delay, counting the time the failed attempt took towards it.
+static az_iot_connection_action _az_iot_connection_retry(
+    az_iot_connection* connection,
+    az_iot_status status,
+    int64_t now_msec,
+    int32_t random_jitter_msec,
+    az_iot_connection_action action)
+{
+  int64_t operation_msec = now_msec - connection->_internal.operation_start;
+  if (operation_msec < 0)
+  {
+    operation_msec = 0;
+  }
+  else if (operation_msec > INT32_MAX - 1)
+  {
+    operation_msec = INT32_MAX - 1;
+  }
+
+  int32_t delay;
+  if (connection->_internal.options.retry_schedule_msec != NULL)
+  {
+    // Once the schedule is exhausted, keeps retrying after its last delay.
+    int32_t const last = connection->_internal.options.retry_schedule_length - 1;
+    int32_t const index
+        = connection->_internal.attempt < last ? connection->_internal.attempt : last;
+    delay = connection->_internal.options.retry_schedule_msec[index] - (int32_t)operation_msec;
+    if (delay < 0)
+    {
+      delay = 0;
+    }
+  }
+  else
+  {
+    delay = az_iot_calculate_retry_delay(
+        (int32_t)operation_msec,
+        connection->_internal.attempt,
+        connection->_internal.options.min_retry_delay_msec,
+        connection->_internal.options.max_retry_delay_msec,
+        random_jitter_msec);
+  }
+
+  if (connection->_internal.attempt < INT16_MAX - 1)
+  {
+    connection->_internal.attempt++;
+  }
+
+  connection->_internal.status = status;
+  _az_iot_connection_set_state(
+      connection, AZ_IOT_CONNECTION_STATE_WAITING_TO_RETRY, now_msec + delay);
+  return action;
+}
+
+AZ_NODISCARD az_iot_connection_options az_iot_connection_options_default()
+{
+  return (az_iot_connection_options){ .connect_timeout_msec = 30000,
+                                      .subscribe_timeout_msec = 30000,
+                                      .min_retry_delay_msec = 1000,
+                                      .max_retry_delay_msec = 100000,
+                                      .retry_schedule_msec = NULL,
+                                      .retry_schedule_length = 0,
+                                      .subscribe = true };
+}
+
+AZ_NODISCARD az_result
+az_iot_connection_init(az_iot_connection* connection, az_iot_connection_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(connection);
+
+  connection->_internal.options = options == NULL ? az_iot_connection_options_default() : *options;
+  connection->_internal.deadline = INT64_MAX;
+  connection->_internal.operation_start = 0;
+  connection->_internal.status = AZ_IOT_STATUS_UNKNOWN;
+  connection->_internal.attempt = 0;
+  connection->_internal.state = (uint8_t)AZ_IOT_CONNECTION_STATE_DISCONNECTED;
+
+  _az_PRECONDITION_RANGE(0, connection->_internal.options.connect_timeout_msec, INT32_MAX - 1);
+  _az_PRECONDITION_RANGE(0, connection->_internal.options.subscribe_timeout_msec, INT32_MAX - 1);
+  _az_PRECONDITION_RANGE(0, connection->_internal.options.min_retry_delay_msec, INT32_MAX - 1);
+  _az_PRECONDITION_RANGE(
+      connection->_internal.options.min_retry_delay_msec,
+      connection->_internal.options.max_retry_delay_msec,
+      INT32_MAX - 1);
+  if (connection->_internal.options.retry_schedule_msec != NULL)
+  {
+    _az_PRECONDITION_RANGE(1, connection->_internal.options.retry_schedule_length, INT32_MAX);
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_connection_handle_event(
+    az_iot_connection* connection,
+    az_iot_connection_event event,
+    int64_t now_msec,
+    int32_t random_jitter_msec,
+    az_iot_connection_action* out_action)
+{
+  _az_PRECONDITION_NOT_NULL(connection);
+  _az_PRECONDITION_RANGE(0, random_jitter_msec, INT32_MAX - 1);
+  _az_PRECONDITION_NOT_NULL(out_action);
+
+  az_iot_connection_state const state = az_iot_connection_get_state(connection);
+  *out_action = AZ_IOT_CONNECTION_ACTION_NONE;
+
+  switch (event.type)
+  {
+    case AZ_IOT_CONNECTION_EVENT_START:
+      if (state == AZ_IOT_CONNECTION_STATE_DISCONNECTED || state == AZ_IOT_CONNECTION_STATE_FAILED)
+      {
+        connection->_internal.status = AZ_IOT_STATUS_UNKNOWN;
+        connection->_internal.attempt = 0;
+        *out_action = _az_iot_connection_connect(connection, now_msec);
+      }
+      break;
+
+    case AZ_IOT_CONNECTION_EVENT_CONNACK:
+      if (state == AZ_IOT_CONNECTION_STATE_CONNECTING)
+      {
+        az_iot_status const status = _az_iot_connection_status_from_connack(event.return_code);
+        if (status == AZ_IOT_STATUS_OK)
+        {
+          if (connection->_internal.options.subscribe)
+          {
+            _az_iot_connection_set_state(
+                connection,
+                AZ_IOT_CONNECTION_STATE_SUBSCRIBING,
+                now_msec + connection->_internal.options.subscribe_timeout_msec);
+            *out_action = AZ_IOT_CONNECTION_ACTION_SUBSCRIBE;
+          }
+          else
+          {
+            _az_iot_connection_connected(connection);
+          }
+        }
+        else if (az_iot_status_retriable(status))
+        {
+          *out_action = _az_iot_connection_retry(
+              connection,
+              status,
+              now_msec,
+              random_jitter_msec,
+              AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+        }
+        else
+        {
+          connection->_internal.status = status;
+          _az_iot_connection_set_state(connection, AZ_IOT_CONNECTION_STATE_FAILED, INT64_MAX);
+          *out_action = AZ_IOT_CONNECTION_ACTION_DISCONNECT;
+        }
+      }
+      break;
+
+    case AZ_IOT_CONNECTION_EVENT_SUBACK:
+      if (state == AZ_IOT_CONNECTION_STATE_SUBSCRIBING)
+      {
+        if (event.return_code == _az_MQTT_SUBACK_FAILURE)
+        {
+          *out_action = _az_iot_connection_retry(
+              connection,
+              AZ_IOT_STATUS_SERVER_ERROR,
+              now_msec,
+              random_jitter_msec,
+              AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+        }
+        else
+        {
+          _az_iot_connection_connected(connection);
+        }
+      }
+      break;
+
+    case AZ_IOT_CONNECTION_EVENT_TIMEOUT:
+      if (now_msec >= connection->_internal.deadline)
+      {
+        if (state == AZ_IOT_CONNECTION_STATE_WAITING_TO_RETRY)
+        {
+          *out_action = _az_iot_connection_connect(connection, now_msec);
+        }
+        else if (
+            state == AZ_IOT_CONNECTION_STATE_CONNECTING
+            || state == AZ_IOT_CONNECTION_STATE_SUBSCRIBING)
+        {
+          *out_action = _az_iot_connection_retry(
+              connection,
+              AZ_IOT_STATUS_TIMEOUT,
+              now_msec,
+              random_jitter_msec,
+              AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+        }
+      }
+      break;
+
+    case AZ_IOT_CONNECTION_EVENT_DISCONNECT:
+      if (state == AZ_IOT_CONNECTION_STATE_CONNECTED)
+      {
+        // The connection was established, so the backoff starts over.
+        connection->_internal.operation_start = now_msec;
+      }
+
+      if (_az_iot_connection_is_open(state))
+      {
+        *out_action = _az_iot_connection_retry(
+            connection,
+            AZ_IOT_STATUS_TIMEOUT,
+            now_msec,
+            random_jitter_msec,
+            AZ_IOT_CONNECTION_ACTION_NONE);
+      }
+      break;
+
+    case AZ_IOT_CONNECTION_EVENT_STOP:
+      if (_az_iot_connection_is_open(state))
+      {
+        *out_action = AZ_IOT_CONNECTION_ACTION_DISCONNECT;
+      }
+
+      _az_iot_connection_set_state(connection, AZ_IOT_CONNECTION_STATE_DISCONNECTED, INT64_MAX);
+      break;
+
+    default:
+      break;
+  }
+
+  return AZ_OK;
+}
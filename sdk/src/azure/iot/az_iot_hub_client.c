@@ -11,6 +11,7 @@
 #include <azure/core/internal/az_span_internal.h>
 #include <azure/iot/az_iot_hub_client.h>
 #include <azure/iot/internal/az_iot_common_internal.h>
+#include <azure/iot/internal/az_iot_hub_client_internal.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -31,6 +32,7 @@ AZ_NODISCARD az_iot_hub_client_options az_iot_hub_client_options_default()
                                       .model_id = AZ_SPAN_EMPTY };
 }
 
+#ifndef AZ_IOT_HUB_CLIENT_COMPACT
 AZ_NODISCARD az_result az_iot_hub_client_init(
     az_iot_hub_client* client,
     az_span iot_hub_hostname,
@@ -44,9 +46,75 @@ AZ_NODISCARD az_result az_iot_hub_client_init(
   client->_internal.iot_hub_hostname = iot_hub_hostname;
   client->_internal.device_id = device_id;
   client->_internal.options = options == NULL ? az_iot_hub_client_options_default() : *options;
+  client->_internal.sas_resource_uri = AZ_SPAN_EMPTY;
 
   return AZ_OK;
 }
+#endif // AZ_IOT_HUB_CLIENT_COMPACT
+
+AZ_NODISCARD az_result az_iot_hub_client_config_init(
+    az_iot_hub_client_config* config,
+    az_span iot_hub_hostname,
+    az_iot_hub_client_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(config);
+  _az_PRECONDITION_VALID_SPAN(iot_hub_hostname, 1, false);
+
+  az_iot_hub_client_options const client_options
+      = options == NULL ? az_iot_hub_client_options_default() : *options;
+
+  config->_internal.iot_hub_hostname = iot_hub_hostname;
+  config->_internal.user_agent = client_options.user_agent;
+  config->_internal.model_id = client_options.model_id;
+  config->_internal.reference_count = 0;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_init_from_config(
+    az_iot_hub_client* client,
+    az_iot_hub_client_config* config,
+    az_span device_id,
+    az_span module_id)
+{
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION_NOT_NULL(config);
+  _az_PRECONDITION_VALID_SPAN(device_id, 1, false);
+  _az_PRECONDITION_VALID_SPAN(module_id, 0, true);
+
+#ifdef AZ_IOT_HUB_CLIENT_COMPACT
+  client->_internal.config = config;
+  client->_internal.module_id = module_id;
+  config->_internal.reference_count++;
+#else
+  client->_internal.iot_hub_hostname = config->_internal.iot_hub_hostname;
+  client->_internal.options = (az_iot_hub_client_options){
+    .module_id = module_id,
+    .user_agent = config->_internal.user_agent,
+    .model_id = config->_internal.model_id,
+  };
+#endif // AZ_IOT_HUB_CLIENT_COMPACT
+  client->_internal.device_id = device_id;
+  client->_internal.sas_resource_uri = AZ_SPAN_EMPTY;
+
+  return AZ_OK;
+}
+
+void az_iot_hub_client_deinit(az_iot_hub_client* client)
+{
+  _az_PRECONDITION_NOT_NULL(client);
+
+#ifdef AZ_IOT_HUB_CLIENT_COMPACT
+  if (client->_internal.config != NULL)
+  {
+    _az_PRECONDITION(client->_internal.config->_internal.reference_count > 0);
+    client->_internal.config->_internal.reference_count--;
+    client->_internal.config = NULL;
+  }
+#endif // AZ_IOT_HUB_CLIENT_COMPACT
+  client->_internal.device_id = AZ_SPAN_EMPTY;
+  client->_internal.sas_resource_uri = AZ_SPAN_EMPTY;
+}
 
 AZ_NODISCARD az_result az_iot_hub_client_get_user_name(
     az_iot_hub_client const* client,
@@ -55,63 +123,68 @@ AZ_NODISCARD az_result az_iot_hub_client_get_user_name(
     size_t* out_mqtt_user_name_length)
 {
   _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_NOT_NULL(mqtt_user_name);
-  _az_PRECONDITION(mqtt_user_name_size > 0);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(
+      mqtt_user_name, mqtt_user_name_size, out_mqtt_user_name_length);
 
-  const az_span* const module_id = &(client->_internal.options.module_id);
-  const az_span* const user_agent = &(client->_internal.options.user_agent);
-  const az_span* const model_id = &(client->_internal.options.model_id);
+  az_span const module_id = _az_iot_hub_client_get_module_id(client);
+  az_span const user_agent = _az_iot_hub_client_get_user_agent(client);
+  az_span const model_id = _az_iot_hub_client_get_model_id(client);
 
   az_span mqtt_user_name_span
       = az_span_create((uint8_t*)mqtt_user_name, (int32_t)mqtt_user_name_size);
 
-  int32_t required_length = az_span_size(client->_internal.iot_hub_hostname)
+  int32_t required_length = az_span_size(_az_iot_hub_client_get_hostname(client))
       + az_span_size(client->_internal.device_id) + (int32_t)sizeof(hub_client_forward_slash)
       + az_span_size(hub_service_api_version);
-  if (az_span_size(*module_id) > 0)
+  if (az_span_size(module_id) > 0)
   {
-    required_length += az_span_size(*module_id) + (int32_t)sizeof(hub_client_forward_slash);
+    required_length += az_span_size(module_id) + (int32_t)sizeof(hub_client_forward_slash);
   }
-  if (az_span_size(*user_agent) > 0)
+  if (az_span_size(user_agent) > 0)
   {
-    required_length += az_span_size(*user_agent) + az_span_size(hub_client_param_separator_span);
+    required_length += az_span_size(user_agent) + az_span_size(hub_client_param_separator_span);
   }
   // Note we skip the length of the model id since we have to url encode it. Bound checking is done
   // later.
-  if (az_span_size(*model_id) > 0)
+  if (az_span_size(model_id) > 0)
   {
     required_length += az_span_size(hub_client_param_separator_span)
-        + az_span_size(hub_client_param_equals_span);
+        + az_span_size(hub_digital_twin_model_id) + az_span_size(hub_client_param_equals_span);
   }
 
+  _az_IOT_RETURN_IF_MEASURING(
+      mqtt_user_name,
+      required_length + _az_span_url_encode_calc_length(model_id),
+      out_mqtt_user_name_length);
+
   _az_RETURN_IF_NOT_ENOUGH_SIZE(
       mqtt_user_name_span, required_length + (int32_t)sizeof(null_terminator));
 
-  az_span remainder = az_span_copy(mqtt_user_name_span, client->_internal.iot_hub_hostname);
+  az_span remainder = az_span_copy(mqtt_user_name_span, _az_iot_hub_client_get_hostname(client));
   remainder = az_span_copy_u8(remainder, hub_client_forward_slash);
   remainder = az_span_copy(remainder, client->_internal.device_id);
 
-  if (az_span_size(*module_id) > 0)
+  if (az_span_size(module_id) > 0)
   {
     remainder = az_span_copy_u8(remainder, hub_client_forward_slash);
-    remainder = az_span_copy(remainder, *module_id);
+    remainder = az_span_copy(remainder, module_id);
   }
 
   remainder = az_span_copy(remainder, hub_service_api_version);
 
-  if (az_span_size(*user_agent) > 0)
+  if (az_span_size(user_agent) > 0)
   {
     remainder = az_span_copy_u8(remainder, *az_span_ptr(hub_client_param_separator_span));
-    remainder = az_span_copy(remainder, *user_agent);
+    remainder = az_span_copy(remainder, user_agent);
   }
 
-  if (az_span_size(*model_id) > 0)
+  if (az_span_size(model_id) > 0)
   {
     remainder = az_span_copy_u8(remainder, *az_span_ptr(hub_client_param_separator_span));
     remainder = az_span_copy(remainder, hub_digital_twin_model_id);
     remainder = az_span_copy_u8(remainder, *az_span_ptr(hub_client_param_equals_span));
 
-    _az_RETURN_IF_FAILED(_az_span_copy_url_encode(remainder, *model_id, &remainder));
+    _az_RETURN_IF_FAILED(_az_span_copy_url_encode(remainder, model_id, &remainder));
   }
   if (az_span_size(remainder) > 0)
   {
@@ -138,28 +211,30 @@ AZ_NODISCARD az_result az_iot_hub_client_get_client_id(
     size_t* out_mqtt_client_id_length)
 {
   _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_NOT_NULL(mqtt_client_id);
-  _az_PRECONDITION(mqtt_client_id_size > 0);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(
+      mqtt_client_id, mqtt_client_id_size, out_mqtt_client_id_length);
 
   az_span mqtt_client_id_span
       = az_span_create((uint8_t*)mqtt_client_id, (int32_t)mqtt_client_id_size);
-  const az_span* const module_id = &(client->_internal.options.module_id);
+  az_span const module_id = _az_iot_hub_client_get_module_id(client);
 
   int32_t required_length = az_span_size(client->_internal.device_id);
-  if (az_span_size(*module_id) > 0)
+  if (az_span_size(module_id) > 0)
   {
-    required_length += az_span_size(*module_id) + (int32_t)sizeof(hub_client_forward_slash);
+    required_length += az_span_size(module_id) + (int32_t)sizeof(hub_client_forward_slash);
   }
 
+  _az_IOT_RETURN_IF_MEASURING(mqtt_client_id, required_length, out_mqtt_client_id_length);
+
   _az_RETURN_IF_NOT_ENOUGH_SIZE(
       mqtt_client_id_span, required_length + (int32_t)sizeof(null_terminator));
 
   az_span remainder = az_span_copy(mqtt_client_id_span, client->_internal.device_id);
 
-  if (az_span_size(*module_id) > 0)
+  if (az_span_size(module_id) > 0)
   {
     remainder = az_span_copy_u8(remainder, hub_client_forward_slash);
-    remainder = az_span_copy(remainder, *module_id);
+    remainder = az_span_copy(remainder, module_id);
   }
 
   az_span_copy_u8(remainder, null_terminator);
@@ -171,3 +246,12 @@ AZ_NODISCARD az_result az_iot_hub_client_get_client_id(
 
   return AZ_OK;
 }
+
+AZ_NODISCARD az_result
+az_iot_hub_client_parse_request_id(az_span request_id, uint64_t* out_request_id)
+{
+  _az_PRECONDITION_VALID_SPAN(request_id, 1, false);
+  _az_PRECONDITION_NOT_NULL(out_request_id);
+
+  return az_span_atou64(request_id, out_request_id);
+}
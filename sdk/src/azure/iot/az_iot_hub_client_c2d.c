@@ -8,6 +8,7 @@
 #include <azure/core/internal/az_result_internal.h>
 #include <azure/core/internal/az_span_internal.h>
 #include <azure/iot/az_iot_hub_client.h>
+#include <azure/iot/internal/az_iot_hub_client_internal.h>
 
 #include <azure/core/internal/az_log_internal.h>
 #include <azure/core/internal/az_precondition_internal.h>
@@ -16,13 +17,28 @@
 
 static const az_span c2d_topic_suffix = AZ_SPAN_LITERAL_FROM_STR("/messages/devicebound/");
 
+AZ_NODISCARD az_result _az_iot_hub_client_c2d_parse_topic_suffix(
+    az_span topic_suffix,
+    az_iot_hub_client_c2d_request* out_request)
+{
+  int32_t index = 0;
+  az_span token = az_span_size(topic_suffix) == 0
+      ? AZ_SPAN_EMPTY
+      : _az_span_token(topic_suffix, c2d_topic_suffix, &topic_suffix, &index);
+
+  _az_RETURN_IF_FAILED(
+      az_iot_message_properties_init(&out_request->properties, token, az_span_size(token)));
+
+  return AZ_OK;
+}
+
 AZ_NODISCARD az_result az_iot_hub_client_c2d_parse_received_topic(
     az_iot_hub_client const* client,
     az_span received_topic,
     az_iot_hub_client_c2d_request* out_request)
 {
   _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_VALID_SPAN(client->_internal.iot_hub_hostname, 1, false);
+  _az_PRECONDITION_VALID_SPAN(_az_iot_hub_client_get_hostname(client), 1, false);
   _az_PRECONDITION_VALID_SPAN(received_topic, 1, false);
   _az_PRECONDITION_NOT_NULL(out_request);
   (void)client;
@@ -40,12 +56,23 @@ AZ_NODISCARD az_result az_iot_hub_client_c2d_parse_received_topic(
     _az_LOG_WRITE(AZ_LOG_MQTT_RECEIVED_TOPIC, received_topic);
   }
 
-  az_span token = az_span_size(remainder) == 0
-      ? AZ_SPAN_EMPTY
-      : _az_span_token(remainder, c2d_topic_suffix, &remainder, &index);
+  return _az_iot_hub_client_c2d_parse_topic_suffix(remainder, out_request);
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_c2d_parse_received_topic_indexed(
+    az_iot_hub_client const* client,
+    az_span received_topic,
+    az_iot_message_properties_index_entry* index_entries,
+    int32_t index_entries_length,
+    az_iot_hub_client_c2d_request* out_request)
+{
+  _az_PRECONDITION_NOT_NULL(index_entries);
+  _az_PRECONDITION(index_entries_length > 0);
 
   _az_RETURN_IF_FAILED(
-      az_iot_message_properties_init(&out_request->properties, token, az_span_size(token)));
+      az_iot_hub_client_c2d_parse_received_topic(client, received_topic, out_request));
 
-  return AZ_OK;
+  // The properties are tokenized once, while building the index.
+  return az_iot_message_properties_set_index(
+      &out_request->properties, index_entries, index_entries_length);
 }
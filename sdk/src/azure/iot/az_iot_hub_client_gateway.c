@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+#include <azure/iot/internal/az_iot_common_internal.h>
+
+#include <azure/core/_az_cfg.h>
+
+static const az_span hub_gateway_devices_prefix = AZ_SPAN_LITERAL_FROM_STR("devices/");
+
+// A free slot of the pool has no device ID.
+AZ_INLINE bool _az_iot_hub_client_gateway_device_is_free(
+    az_iot_hub_client_gateway_device const* device)
+{
+  return az_span_size(device->_internal.client._internal.device_id) == 0;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_gateway_init(
+    az_iot_hub_client_gateway* gateway,
+    az_iot_hub_client_gateway_device devices[],
+    int32_t capacity,
+    az_span iot_hub_hostname,
+    az_iot_hub_client_options const* options,
+    az_iot_connection_options const* connection_options)
+{
+  _az_PRECONDITION_NOT_NULL(gateway);
+  _az_PRECONDITION_NOT_NULL(devices);
+  _az_PRECONDITION(capacity > 0);
+  _az_PRECONDITION_VALID_SPAN(iot_hub_hostname, 1, false);
+
+  _az_RETURN_IF_FAILED(
+      az_iot_hub_client_config_init(&gateway->_internal.config, iot_hub_hostname, options));
+
+  gateway->_internal.devices = devices;
+  gateway->_internal.capacity = capacity;
+  gateway->_internal.count = 0;
+  gateway->_internal.module_id = options == NULL ? AZ_SPAN_EMPTY : options->module_id;
+  gateway->_internal.connection_options
+      = connection_options == NULL ? az_iot_connection_options_default() : *connection_options;
+
+  for (int32_t i = 0; i < capacity; i++)
+  {
+    devices[i]._internal.client._internal.device_id = AZ_SPAN_EMPTY;
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_gateway_add_device(
+    az_iot_hub_client_gateway* gateway,
+    az_span device_id,
+    void* context,
+    az_iot_hub_client_gateway_device** out_device)
+{
+  _az_PRECONDITION_NOT_NULL(gateway);
+  _az_PRECONDITION_VALID_SPAN(device_id, 1, false);
+  _az_PRECONDITION_NOT_NULL(out_device);
+
+  if (gateway->_internal.count == gateway->_internal.capacity)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  // As the pool isn't full, a free slot is found.
+  az_iot_hub_client_gateway_device* device = gateway->_internal.devices;
+  while (!_az_iot_hub_client_gateway_device_is_free(device))
+  {
+    device++;
+  }
+
+  // The client is initialized last, so that it only refers to the config of the gateway once the
+  // device is added.
+  _az_RETURN_IF_FAILED(az_iot_connection_init(
+      &device->_internal.connection, &gateway->_internal.connection_options));
+  _az_RETURN_IF_FAILED(az_iot_hub_client_init_from_config(
+      &device->_internal.client,
+      &gateway->_internal.config,
+      device_id,
+      gateway->_internal.module_id));
+  device->_internal.context = context;
+  device->_internal.device_id_hash = _az_span_crc32(0, device_id);
+
+  gateway->_internal.count++;
+
+  *out_device = device;
+  return AZ_OK;
+}
+
+void az_iot_hub_client_gateway_remove_device(
+    az_iot_hub_client_gateway* gateway,
+    az_iot_hub_client_gateway_device* device)
+{
+  _az_PRECONDITION_NOT_NULL(gateway);
+  _az_PRECONDITION_NOT_NULL(device);
+  _az_PRECONDITION(
+      device >= gateway->_internal.devices
+      && device < gateway->_internal.devices + gateway->_internal.capacity);
+  _az_PRECONDITION(!_az_iot_hub_client_gateway_device_is_free(device));
+
+  // Frees the slot, as the client no longer has a device ID.
+  az_iot_hub_client_deinit(&device->_internal.client);
+  device->_internal.context = NULL;
+  gateway->_internal.count--;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_gateway_find_device(
+    az_iot_hub_client_gateway* gateway,
+    az_span device_id,
+    az_iot_hub_client_gateway_device** out_device)
+{
+  _az_PRECONDITION_NOT_NULL(gateway);
+  _az_PRECONDITION_VALID_SPAN(device_id, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_device);
+
+  if (az_span_size(device_id) == 0)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  // Comparing the hashes first only compares the device IDs of the likely matches.
+  uint32_t const hash = _az_span_crc32(0, device_id);
+  az_iot_hub_client_gateway_device* const end
+      = gateway->_internal.devices + gateway->_internal.capacity;
+  for (az_iot_hub_client_gateway_device* device = gateway->_internal.devices; device < end;
+       device++)
+  {
+    if (device->_internal.device_id_hash == hash
+        && !_az_iot_hub_client_gateway_device_is_free(device)
+        && az_span_is_content_equal(device->_internal.client._internal.device_id, device_id))
+    {
+      *out_device = device;
+      return AZ_OK;
+    }
+  }
+
+  return AZ_ERROR_ITEM_NOT_FOUND;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_gateway_parse_received_topic(
+    az_iot_hub_client_gateway* gateway,
+    az_iot_hub_client_gateway_device* device,
+    az_span received_topic,
+    az_iot_hub_client_gateway_device** out_device,
+    az_iot_hub_client_topic* out_topic)
+{
+  _az_PRECONDITION_NOT_NULL(gateway);
+  _az_PRECONDITION(device == NULL || !_az_iot_hub_client_gateway_device_is_free(device));
+  _az_PRECONDITION_VALID_SPAN(received_topic, 1, false);
+  _az_PRECONDITION_NOT_NULL(out_device);
+  _az_PRECONDITION_NOT_NULL(out_topic);
+
+  if (device == NULL)
+  {
+    // devices/{device_id}[/modules/{module_id}]/messages/devicebound/{properties}
+    if (!_az_span_starts_with(received_topic, hub_gateway_devices_prefix))
+    {
+      return AZ_ERROR_ITEM_NOT_FOUND;
+    }
+
+    az_span const device_path
+        = az_span_slice_to_end(received_topic, az_span_size(hub_gateway_devices_prefix));
+    int32_t const index = az_span_find(device_path, AZ_SPAN_FROM_STR("/"));
+    if (index <= 0)
+    {
+      return AZ_ERROR_IOT_TOPIC_NO_MATCH;
+    }
+
+    _az_RETURN_IF_FAILED(az_iot_hub_client_gateway_find_device(
+        gateway, az_span_slice(device_path, 0, index), &device));
+  }
+
+  _az_RETURN_IF_FAILED(
+      az_iot_hub_client_topic_parse(&device->_internal.client, received_topic, out_topic));
+
+  *out_device = device;
+  return AZ_OK;
+}
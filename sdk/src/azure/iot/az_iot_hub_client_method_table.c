@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <azure/core/_az_cfg.h>
+
+/*
+The table is a hash-and-displace minimal perfect hash. The hash of a name selects one of size
+buckets, and the seed of the bucket tells where the names of that bucket are:
+
+  seed > 0          slot = mix(hash, seed) % size, with a seed chosen so that the names of the
+                    bucket don't collide with any name placed before them
+  seed < 0          the bucket has a single name, at slot -seed - 1
+  seed == 0         the bucket is empty
+
+The buckets are placed from the largest to the smallest, while the table still has room to find a
+seed quickly.
+*/
+#define _az_IOT_HUB_METHOD_TABLE_MAX_SEED 0x10000
+
+AZ_INLINE int32_t _az_iot_hub_method_table_bucket(uint32_t hash, int32_t size)
+{
+  return (int32_t)(hash % (uint32_t)size);
+}
+
+// The MurmurHash3 finalizer, mixing the seed into the hash of the name.
+AZ_INLINE int32_t _az_iot_hub_method_table_slot(uint32_t hash, int32_t seed, int32_t size)
+{
+  uint32_t h = hash ^ ((uint32_t)seed * 0x9E3779B9U);
+  h ^= h >> 16;
+  h *= 0x85EBCA6BU;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35U;
+  h ^= h >> 16;
+  return (int32_t)(h % (uint32_t)size);
+}
+
+// Places the names of a bucket with a seed, returning false and leaving the slots unchanged if any
+// of them collides.
+static bool _az_iot_hub_method_table_try_seed(
+    az_iot_hub_client_method_table* table,
+    int32_t bucket,
+    int32_t seed)
+{
+  int32_t const size = table->_internal.size;
+  uint32_t const* const hashes = table->_internal.hashes;
+  int32_t* const slots = table->_internal.slots;
+
+  for (int32_t i = 0; i < size; i++)
+  {
+    if (_az_iot_hub_method_table_bucket(hashes[i], size) != bucket)
+    {
+      continue;
+    }
+
+    int32_t const slot = _az_iot_hub_method_table_slot(hashes[i], seed, size);
+    if (slots[slot] >= 0)
+    {
+      // Free the slots of the names placed so far.
+      for (int32_t j = 0; j < i; j++)
+      {
+        if (_az_iot_hub_method_table_bucket(hashes[j], size) == bucket)
+        {
+          slots[_az_iot_hub_method_table_slot(hashes[j], seed, size)] = -1;
+        }
+      }
+
+      return false;
+    }
+
+    slots[slot] = i;
+  }
+
+  return true;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_method_table_init(
+    az_iot_hub_client_method_table* table,
+    az_span const names[],
+    uint32_t hashes[],
+    int32_t seeds[],
+    int32_t slots[],
+    int32_t size)
+{
+  _az_PRECONDITION_NOT_NULL(table);
+  _az_PRECONDITION_NOT_NULL(names);
+  _az_PRECONDITION_NOT_NULL(hashes);
+  _az_PRECONDITION_NOT_NULL(seeds);
+  _az_PRECONDITION_NOT_NULL(slots);
+  _az_PRECONDITION(size > 0);
+
+  table->_internal.names = names;
+  table->_internal.hashes = hashes;
+  table->_internal.seeds = seeds;
+  table->_internal.slots = slots;
+  table->_internal.size = size;
+
+  for (int32_t i = 0; i < size; i++)
+  {
+    seeds[i] = 0;
+    slots[i] = -1;
+  }
+
+  // While building, the seed of a bucket not placed yet holds the negated number of its names.
+  int32_t largest_bucket = 0;
+  for (int32_t i = 0; i < size; i++)
+  {
+    hashes[i] = _az_span_crc32(0, names[i]);
+    int32_t const bucket = _az_iot_hub_method_table_bucket(hashes[i], size);
+    for (int32_t j = 0; j < i; j++)
+    {
+      if (hashes[j] == hashes[i] && az_span_is_content_equal(names[j], names[i]))
+      {
+        return AZ_ERROR_ARG;
+      }
+    }
+
+    seeds[bucket]--;
+    if (-seeds[bucket] > largest_bucket)
+    {
+      largest_bucket = -seeds[bucket];
+    }
+  }
+
+  for (int32_t bucket_size = largest_bucket; bucket_size > 1; bucket_size--)
+  {
+    for (int32_t bucket = 0; bucket < size; bucket++)
+    {
+      if (seeds[bucket] != -bucket_size)
+      {
+        continue;
+      }
+
+      int32_t seed = 1;
+      while (!_az_iot_hub_method_table_try_seed(table, bucket, seed))
+      {
+        if (++seed > _az_IOT_HUB_METHOD_TABLE_MAX_SEED)
+        {
+          return AZ_ERROR_NOT_SUPPORTED;
+        }
+      }
+
+      seeds[bucket] = seed;
+    }
+  }
+
+  // The names alone in their bucket fill the free slots directly.
+  int32_t free_slot = 0;
+  for (int32_t i = 0; i < size; i++)
+  {
+    int32_t const bucket = _az_iot_hub_method_table_bucket(hashes[i], size);
+    if (seeds[bucket] == -1)
+    {
+      while (slots[free_slot] >= 0)
+      {
+        free_slot++;
+      }
+
+      slots[free_slot] = i;
+      seeds[bucket] = -free_slot - 1;
+    }
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD int32_t
+az_iot_hub_client_method_table_find(az_iot_hub_client_method_table const* table, az_span name)
+{
+  _az_PRECONDITION_NOT_NULL(table);
+  _az_PRECONDITION_VALID_SPAN(name, 0, true);
+
+  int32_t const size = table->_internal.size;
+  uint32_t const hash = _az_span_crc32(0, name);
+  int32_t const seed = table->_internal.seeds[_az_iot_hub_method_table_bucket(hash, size)];
+  if (seed == 0)
+  {
+    return -1;
+  }
+
+  int32_t const slot = seed > 0 ? _az_iot_hub_method_table_slot(hash, seed, size) : -seed - 1;
+  int32_t const index = table->_internal.slots[slot];
+  if (table->_internal.hashes[index] != hash
+      || !az_span_is_content_equal(table->_internal.names[index], name))
+  {
+    return -1;
+  }
+
+  return index;
+}
@@ -9,6 +9,7 @@
 #include <azure/core/internal/az_span_internal.h>
 #include <azure/iot/az_iot_hub_client.h>
 #include <azure/iot/internal/az_iot_common_internal.h>
+#include <azure/iot/internal/az_iot_hub_client_internal.h>
 
 #include <azure/core/internal/az_log_internal.h>
 #include <azure/core/internal/az_precondition_internal.h>
@@ -21,13 +22,33 @@ static const az_span methods_topic_filter_suffix = AZ_SPAN_LITERAL_FROM_STR("POS
 static const az_span methods_response_topic_result = AZ_SPAN_LITERAL_FROM_STR("res/");
 static const az_span methods_response_topic_properties = AZ_SPAN_LITERAL_FROM_STR("/?$rid=");
 
+AZ_NODISCARD az_result _az_iot_hub_client_methods_parse_topic_suffix(
+    az_span topic_suffix,
+    az_iot_hub_client_method_request* out_request)
+{
+  int32_t index = az_span_find(topic_suffix, methods_response_topic_properties);
+
+  if (index == -1)
+  {
+    return AZ_ERROR_IOT_TOPIC_NO_MATCH;
+  }
+
+  out_request->name = az_span_slice(topic_suffix, 0, index);
+  out_request->request_id = az_span_slice(
+      topic_suffix,
+      index + az_span_size(methods_response_topic_properties),
+      az_span_size(topic_suffix));
+
+  return AZ_OK;
+}
+
 AZ_NODISCARD az_result az_iot_hub_client_methods_parse_received_topic(
     az_iot_hub_client const* client,
     az_span received_topic,
     az_iot_hub_client_method_request* out_request)
 {
   _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_VALID_SPAN(client->_internal.iot_hub_hostname, 1, false);
+  _az_PRECONDITION_VALID_SPAN(_az_iot_hub_client_get_hostname(client), 1, false);
   _az_PRECONDITION_VALID_SPAN(received_topic, 1, false);
   _az_PRECONDITION_NOT_NULL(out_request);
 
@@ -55,25 +76,9 @@ AZ_NODISCARD az_result az_iot_hub_client_methods_parse_received_topic(
     return AZ_ERROR_IOT_TOPIC_NO_MATCH;
   }
 
-  received_topic = az_span_slice(
-      received_topic,
-      index + az_span_size(methods_topic_filter_suffix),
-      az_span_size(received_topic));
-
-  index = az_span_find(received_topic, methods_response_topic_properties);
-
-  if (index == -1)
-  {
-    return AZ_ERROR_IOT_TOPIC_NO_MATCH;
-  }
-
-  out_request->name = az_span_slice(received_topic, 0, index);
-  out_request->request_id = az_span_slice(
-      received_topic,
-      index + az_span_size(methods_response_topic_properties),
-      az_span_size(received_topic));
-
-  return AZ_OK;
+  return _az_iot_hub_client_methods_parse_topic_suffix(
+      az_span_slice_to_end(received_topic, index + az_span_size(methods_topic_filter_suffix)),
+      out_request);
 }
 
 AZ_NODISCARD az_result az_iot_hub_client_methods_response_get_publish_topic(
@@ -85,10 +90,9 @@ AZ_NODISCARD az_result az_iot_hub_client_methods_response_get_publish_topic(
     size_t* out_mqtt_topic_length)
 {
   _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_VALID_SPAN(client->_internal.iot_hub_hostname, 1, false);
+  _az_PRECONDITION_VALID_SPAN(_az_iot_hub_client_get_hostname(client), 1, false);
   _az_PRECONDITION_VALID_SPAN(request_id, 1, false);
-  _az_PRECONDITION_NOT_NULL(mqtt_topic);
-  _az_PRECONDITION(mqtt_topic_size);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(mqtt_topic, mqtt_topic_size, out_mqtt_topic_length);
 
   (void)client;
 
@@ -97,6 +101,8 @@ AZ_NODISCARD az_result az_iot_hub_client_methods_response_get_publish_topic(
       + az_span_size(methods_response_topic_result) + _az_iot_u32toa_size(status)
       + az_span_size(methods_response_topic_properties) + az_span_size(request_id);
 
+  _az_IOT_RETURN_IF_MEASURING(mqtt_topic, required_length, out_mqtt_topic_length);
+
   _az_RETURN_IF_NOT_ENOUGH_SIZE(
       mqtt_topic_span, required_length + (int32_t)sizeof(null_terminator));
 
@@ -116,3 +122,26 @@ AZ_NODISCARD az_result az_iot_hub_client_methods_response_get_publish_topic(
 
   return AZ_OK;
 }
+
+AZ_NODISCARD az_result az_iot_hub_client_methods_response_get_publish_topic_u64(
+    az_iot_hub_client const* client,
+    uint64_t request_id,
+    uint16_t status,
+    char* mqtt_topic,
+    size_t mqtt_topic_size,
+    size_t* out_mqtt_topic_length)
+{
+  uint8_t request_id_buffer[_az_MAX_SIZE_FOR_UINT64];
+  az_span remainder;
+  _az_RETURN_IF_FAILED(
+      az_span_u64toa(AZ_SPAN_FROM_BUFFER(request_id_buffer), request_id, &remainder));
+
+  return az_iot_hub_client_methods_response_get_publish_topic(
+      client,
+      az_span_create(
+          request_id_buffer, (int32_t)sizeof(request_id_buffer) - az_span_size(remainder)),
+      status,
+      mqtt_topic,
+      mqtt_topic_size,
+      out_mqtt_topic_length);
+}
@@ -0,0 +1,258 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+static const uint8_t null_terminator = '\0';
+static const uint8_t pnp_command_separator = '*';
+static const az_span pnp_component_property = AZ_SPAN_LITERAL_FROM_STR("$.sub=");
+static const az_span pnp_component_marker_name = AZ_SPAN_LITERAL_FROM_STR("__t");
+static const az_span twin_desired_name = AZ_SPAN_LITERAL_FROM_STR("desired");
+static const az_span twin_version_name = AZ_SPAN_LITERAL_FROM_STR("$version");
+
+AZ_NODISCARD az_result az_iot_hub_client_pnp_components_init(
+    az_iot_hub_client_pnp_components* components,
+    az_iot_hub_client const* client,
+    az_span const names[],
+    uint32_t hashes[],
+    int32_t seeds[],
+    int32_t slots[],
+    az_span telemetry_topics[],
+    int32_t size,
+    az_span topic_buffer)
+{
+  _az_PRECONDITION_NOT_NULL(components);
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION_NOT_NULL(telemetry_topics);
+  _az_PRECONDITION_VALID_SPAN(topic_buffer, 0, false);
+
+  _az_RETURN_IF_FAILED(az_iot_hub_client_method_table_init(
+      &components->_internal.table, names, hashes, seeds, slots, size));
+  components->_internal.telemetry_topics = telemetry_topics;
+
+  // The prefix is the same for every component, so it is only formatted once, then copied.
+  size_t prefix_length = 0;
+  _az_RETURN_IF_FAILED(az_iot_hub_client_telemetry_get_publish_topic_prefix(
+      client,
+      (char*)az_span_ptr(topic_buffer),
+      (size_t)az_span_size(topic_buffer),
+      &prefix_length));
+  az_span const prefix = az_span_slice(topic_buffer, 0, (int32_t)prefix_length);
+
+  az_span remainder = topic_buffer;
+  for (int32_t i = 0; i < size; i++)
+  {
+    int32_t const topic_length
+        = (int32_t)prefix_length + az_span_size(pnp_component_property) + az_span_size(names[i]);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, topic_length + (int32_t)sizeof(null_terminator));
+
+    // The first topic is written over the prefix, which az_span_copy() allows.
+    az_span topic_remainder = az_span_copy(remainder, prefix);
+    topic_remainder = az_span_copy(topic_remainder, pnp_component_property);
+    topic_remainder = az_span_copy(topic_remainder, names[i]);
+    az_span_copy_u8(topic_remainder, null_terminator);
+
+    telemetry_topics[i] = az_span_slice(remainder, 0, topic_length);
+    remainder = az_span_slice_to_end(remainder, topic_length + (int32_t)sizeof(null_terminator));
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_pnp_components_parse_command(
+    az_iot_hub_client_pnp_components const* components,
+    az_span method_name,
+    int32_t* out_component_index,
+    az_span* out_command_name)
+{
+  _az_PRECONDITION_NOT_NULL(components);
+  _az_PRECONDITION_VALID_SPAN(method_name, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_component_index);
+  _az_PRECONDITION_NOT_NULL(out_command_name);
+
+  uint8_t const* const name = az_span_ptr(method_name);
+  int32_t const name_size = az_span_size(method_name);
+  int32_t separator = 0;
+  while (separator < name_size && name[separator] != pnp_command_separator)
+  {
+    separator++;
+  }
+
+  if (separator == name_size)
+  {
+    *out_component_index = -1;
+    *out_command_name = method_name;
+    return AZ_OK;
+  }
+
+  int32_t const component_index = az_iot_hub_client_pnp_components_find(
+      components, az_span_slice(method_name, 0, separator));
+  if (component_index < 0)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  *out_component_index = component_index;
+  *out_command_name = az_span_slice_to_end(method_name, separator + 1);
+  return AZ_OK;
+}
+
+// Finds the `$version` property of the desired properties object the reader is positioned on,
+// without moving the reader.
+AZ_NODISCARD static az_result _az_iot_hub_client_pnp_find_version(
+    az_json_reader const* json_reader,
+    int64_t* out_version)
+{
+  az_json_reader jr = *json_reader;
+  _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+
+  while (jr.token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    bool const is_version = az_json_token_is_text_equal(&jr.token, twin_version_name);
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+
+    if (is_version)
+    {
+      return az_json_token_get_int64(&jr.token, out_version);
+    }
+
+    _az_RETURN_IF_FAILED(az_json_reader_skip_children(&jr));
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+  }
+
+  return AZ_ERROR_ITEM_NOT_FOUND;
+}
+
+// Calls back for each property of the object the reader is positioned on, moving the reader to the
+// end of the object. The callback reads a copy of the reader, so it can leave it anywhere.
+AZ_NODISCARD static az_result _az_iot_hub_client_pnp_visit_properties(
+    az_iot_hub_client_pnp_components const* components,
+    az_json_reader* ref_json_reader,
+    int32_t component_index,
+    int64_t version,
+    az_iot_hub_client_pnp_property_fn callback,
+    void* context)
+{
+  _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+
+  while (ref_json_reader->token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    az_json_token const property_name = ref_json_reader->token;
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+
+    if (component_index < 0)
+    {
+      if (az_json_token_is_text_equal(&property_name, twin_version_name))
+      {
+        _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+        continue;
+      }
+
+      // Only the default component holds components.
+      int32_t const index = ref_json_reader->token.kind == AZ_JSON_TOKEN_BEGIN_OBJECT
+          ? az_iot_hub_client_pnp_components_find(components, property_name.slice)
+          : -1;
+      if (index >= 0)
+      {
+        _az_RETURN_IF_FAILED(_az_iot_hub_client_pnp_visit_properties(
+            components, ref_json_reader, index, version, callback, context));
+        _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+        continue;
+      }
+    }
+    else if (az_json_token_is_text_equal(&property_name, pnp_component_marker_name))
+    {
+      _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+      continue;
+    }
+
+    az_json_reader property_value = *ref_json_reader;
+    callback(component_index, &property_name, &property_value, version, context);
+
+    _az_RETURN_IF_FAILED(az_json_reader_skip_children(ref_json_reader));
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_pnp_components_visit_desired(
+    az_iot_hub_client_pnp_components const* components,
+    az_iot_hub_client_twin_response const* response,
+    az_span payload,
+    az_iot_hub_client_pnp_property_fn callback,
+    void* context)
+{
+  _az_PRECONDITION_NOT_NULL(components);
+  _az_PRECONDITION_NOT_NULL(response);
+  _az_PRECONDITION_NOT_NULL(callback);
+
+  az_json_reader jr;
+  int64_t version;
+
+  if (response->response_type == AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_GET)
+  {
+    if (!az_iot_status_succeeded(response->status))
+    {
+      return AZ_OK;
+    }
+
+    // The document holds the desired properties along with the reported ones.
+    _az_RETURN_IF_FAILED(az_json_reader_init(&jr, payload, NULL));
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+
+    while (true)
+    {
+      if (jr.token.kind != AZ_JSON_TOKEN_PROPERTY_NAME)
+      {
+        return AZ_ERROR_ITEM_NOT_FOUND;
+      }
+
+      bool const is_desired = az_json_token_is_text_equal(&jr.token, twin_desired_name);
+      _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+
+      if (is_desired)
+      {
+        break;
+      }
+
+      _az_RETURN_IF_FAILED(az_json_reader_skip_children(&jr));
+      _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+    }
+  }
+  else if (response->response_type == AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_DESIRED_PROPERTIES)
+  {
+    // The payload is the desired properties patch.
+    _az_RETURN_IF_FAILED(az_json_reader_init(&jr, payload, NULL));
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+  }
+  else
+  {
+    return AZ_OK;
+  }
+
+  if (jr.token.kind != AZ_JSON_TOKEN_BEGIN_OBJECT)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  if (az_span_size(response->version) == 0
+      || az_result_failed(az_span_atoi64(response->version, &version)))
+  {
+    _az_RETURN_IF_FAILED(_az_iot_hub_client_pnp_find_version(&jr, &version));
+  }
+
+  return _az_iot_hub_client_pnp_visit_properties(components, &jr, -1, version, callback, context);
+}
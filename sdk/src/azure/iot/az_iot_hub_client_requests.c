@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <azure/core/_az_cfg.h>
+
+// Request IDs are handed out in sequence, skipping those whose slot is taken, so that a request
+// always lives in the slot given by the low bits of its ID.
+AZ_INLINE az_iot_hub_client_pending_request* _az_iot_hub_client_request_table_slot(
+    az_iot_hub_client_request_table* table,
+    uint64_t request_id)
+{
+  return &table->_internal.requests[request_id & (uint64_t)(table->_internal.capacity - 1)];
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_request_table_init(
+    az_iot_hub_client_request_table* table,
+    az_iot_hub_client_pending_request* requests,
+    int32_t capacity)
+{
+  _az_PRECONDITION_NOT_NULL(table);
+  _az_PRECONDITION_NOT_NULL(requests);
+  _az_PRECONDITION(capacity > 0 && (capacity & (capacity - 1)) == 0);
+
+  table->_internal.requests = requests;
+  table->_internal.next_request_id = 1;
+  table->_internal.capacity = capacity;
+  table->_internal.count = 0;
+
+  for (int32_t i = 0; i < capacity; i++)
+  {
+    requests[i].request_id = 0;
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_request_table_add(
+    az_iot_hub_client_request_table* table,
+    int64_t deadline,
+    void* context,
+    uint64_t* out_request_id)
+{
+  _az_PRECONDITION_NOT_NULL(table);
+  _az_PRECONDITION_NOT_NULL(out_request_id);
+
+  if (table->_internal.count == table->_internal.capacity)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  // As the table isn't full, a free slot is found within capacity IDs.
+  uint64_t request_id = table->_internal.next_request_id;
+  az_iot_hub_client_pending_request* slot;
+  while (true)
+  {
+    // Zero marks a free slot, so it's never handed out.
+    if (request_id == 0)
+    {
+      request_id++;
+    }
+
+    slot = _az_iot_hub_client_request_table_slot(table, request_id);
+    if (slot->request_id == 0)
+    {
+      break;
+    }
+
+    request_id++;
+  }
+
+  slot->request_id = request_id;
+  slot->deadline = deadline;
+  slot->context = context;
+
+  table->_internal.next_request_id = request_id + 1;
+  table->_internal.count++;
+
+  *out_request_id = request_id;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_request_table_resolve(
+    az_iot_hub_client_request_table* table,
+    az_span request_id,
+    az_iot_hub_client_pending_request* out_request)
+{
+  _az_PRECONDITION_NOT_NULL(table);
+
+  uint64_t number;
+  if (az_span_size(request_id) == 0 || az_result_failed(az_span_atou64(request_id, &number))
+      || number == 0)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  az_iot_hub_client_pending_request* slot = _az_iot_hub_client_request_table_slot(table, number);
+  if (slot->request_id != number)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  if (out_request != NULL)
+  {
+    *out_request = *slot;
+  }
+
+  slot->request_id = 0;
+  table->_internal.count--;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_request_table_remove_expired(
+    az_iot_hub_client_request_table* table,
+    int64_t now,
+    az_iot_hub_client_pending_request* out_request)
+{
+  _az_PRECONDITION_NOT_NULL(table);
+
+  for (int32_t i = 0; i < table->_internal.capacity && table->_internal.count > 0; i++)
+  {
+    az_iot_hub_client_pending_request* slot = &table->_internal.requests[i];
+    if (slot->request_id != 0 && slot->deadline <= now)
+    {
+      if (out_request != NULL)
+      {
+        *out_request = *slot;
+      }
+
+      slot->request_id = 0;
+      table->_internal.count--;
+
+      return AZ_OK;
+    }
+  }
+
+  return AZ_ERROR_ITEM_NOT_FOUND;
+}
@@ -6,6 +6,7 @@
 #include <azure/core/internal/az_result_internal.h>
 #include <azure/iot/az_iot_hub_client.h>
 #include <azure/iot/internal/az_iot_common_internal.h>
+#include <azure/iot/internal/az_iot_hub_client_internal.h>
 
 #include <azure/core/internal/az_log_internal.h>
 #include <azure/core/internal/az_precondition_internal.h>
@@ -33,48 +34,67 @@ static const az_span sr_string = AZ_SPAN_LITERAL_FROM_STR(SAS_TOKEN_SR);
 static const az_span sig_string = AZ_SPAN_LITERAL_FROM_STR(SAS_TOKEN_SIG);
 static const az_span se_string = AZ_SPAN_LITERAL_FROM_STR(SAS_TOKEN_SE);
 
-AZ_NODISCARD az_result az_iot_hub_client_sas_get_signature(
+// Appends the resource URI of the SAS tokens: the one cached by
+// az_iot_hub_client_sas_cache_resource_uri(), if any, or the URL-encoded hostname, device ID and
+// module ID.
+static void _az_iot_hub_client_sas_append_resource_uri(
     az_iot_hub_client const* client,
-    uint64_t token_expiration_epoch_time,
-    az_span signature,
-    az_span* out_signature)
+    az_span_builder* ref_builder)
 {
-  _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION(token_expiration_epoch_time > 0);
-  _az_PRECONDITION_VALID_SPAN(signature, 1, false);
-  _az_PRECONDITION_NOT_NULL(out_signature);
+  if (az_span_size(client->_internal.sas_resource_uri) > 0)
+  {
+    az_span_builder_append(ref_builder, client->_internal.sas_resource_uri);
+    return;
+  }
 
-  az_span remainder = signature;
-  int32_t signature_size = az_span_size(signature);
+  az_span_builder_append_url_encoded(ref_builder, _az_iot_hub_client_get_hostname(client));
+  az_span_builder_append(ref_builder, devices_string);
+  az_span_builder_append_url_encoded(ref_builder, client->_internal.device_id);
 
-  _az_RETURN_IF_FAILED(
-      _az_span_copy_url_encode(remainder, client->_internal.iot_hub_hostname, &remainder));
+  if (az_span_size(_az_iot_hub_client_get_module_id(client)) > 0)
+  {
+    az_span_builder_append(ref_builder, modules_string);
+    az_span_builder_append_url_encoded(ref_builder, _az_iot_hub_client_get_module_id(client));
+  }
+}
 
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(devices_string));
-  remainder = az_span_copy(remainder, devices_string);
+AZ_NODISCARD az_result az_iot_hub_client_sas_cache_resource_uri(
+    az_iot_hub_client* client,
+    az_span resource_uri_buffer)
+{
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION_VALID_SPAN(resource_uri_buffer, 1, false);
 
-  _az_RETURN_IF_FAILED(
-      _az_span_copy_url_encode(remainder, client->_internal.device_id, &remainder));
+  // Keep encoding for every token if the buffer is too small.
+  client->_internal.sas_resource_uri = AZ_SPAN_EMPTY;
 
-  if (az_span_size(client->_internal.options.module_id) > 0)
-  {
-    _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(modules_string));
-    remainder = az_span_copy(remainder, modules_string);
+  az_span_builder builder = az_span_builder_create(resource_uri_buffer);
+  _az_iot_hub_client_sas_append_resource_uri(client, &builder);
 
-    _az_RETURN_IF_FAILED(
-        _az_span_copy_url_encode(remainder, client->_internal.options.module_id, &remainder));
-  }
+  az_span resource_uri = AZ_SPAN_EMPTY;
+  _az_RETURN_IF_FAILED(az_span_builder_get_span(&builder, &resource_uri));
 
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(
-      remainder,
-      1 + // LF
-          _az_iot_u64toa_size(token_expiration_epoch_time));
+  client->_internal.sas_resource_uri = resource_uri;
+  return AZ_OK;
+}
 
-  remainder = az_span_copy_u8(remainder, LF);
+AZ_NODISCARD az_result az_iot_hub_client_sas_get_signature(
+    az_iot_hub_client const* client,
+    uint64_t token_expiration_epoch_time,
+    az_span signature,
+    az_span* out_signature)
+{
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION(token_expiration_epoch_time > 0);
+  _az_PRECONDITION_VALID_SPAN(signature, 1, false);
+  _az_PRECONDITION_NOT_NULL(out_signature);
 
-  _az_RETURN_IF_FAILED(az_span_u64toa(remainder, token_expiration_epoch_time, &remainder));
+  az_span_builder builder = az_span_builder_create(signature);
+  _az_iot_hub_client_sas_append_resource_uri(client, &builder);
+  az_span_builder_append_u8(&builder, LF);
+  az_span_builder_append_u64(&builder, token_expiration_epoch_time);
 
-  *out_signature = az_span_slice(signature, 0, signature_size - az_span_size(remainder));
+  _az_RETURN_IF_FAILED(az_span_builder_get_span(&builder, out_signature));
   _az_LOG_WRITE(AZ_LOG_IOT_SAS_TOKEN, *out_signature);
 
   return AZ_OK;
@@ -92,80 +112,184 @@ AZ_NODISCARD az_result az_iot_hub_client_sas_get_password(
   _az_PRECONDITION_NOT_NULL(client);
   _az_PRECONDITION_VALID_SPAN(base64_hmac_sha256_signature, 1, false);
   _az_PRECONDITION(token_expiration_epoch_time > 0);
-  _az_PRECONDITION_NOT_NULL(mqtt_password);
-  _az_PRECONDITION(mqtt_password_size > 0);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(
+      mqtt_password, mqtt_password_size, out_mqtt_password_length);
 
   // Concatenates: "SharedAccessSignature sr=" scope "&sig=" sig  "&se=" expiration_time_secs
   //               plus, if key_name size > 0, "&skn=" key_name
+  // In measure mode, the builder has no destination and only counts the length.
+  az_span_builder builder = az_span_builder_create(
+      az_span_create((uint8_t*)mqtt_password, (int32_t)mqtt_password_size));
 
-  az_span mqtt_password_span = az_span_create((uint8_t*)mqtt_password, (int32_t)mqtt_password_size);
+  az_span_builder_append(&builder, sr_string);
+  az_span_builder_append_u8(&builder, EQUAL_SIGN);
+  _az_iot_hub_client_sas_append_resource_uri(client, &builder);
 
-  // SharedAccessSignature
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(mqtt_password_span, az_span_size(sr_string) + 1 /* EQUAL_SIGN */);
-  mqtt_password_span = az_span_copy(mqtt_password_span, sr_string);
-  mqtt_password_span = az_span_copy_u8(mqtt_password_span, EQUAL_SIGN);
+  az_span_builder_append_u8(&builder, AMPERSAND);
+  az_span_builder_append(&builder, sig_string);
+  az_span_builder_append_u8(&builder, EQUAL_SIGN);
+  az_span_builder_append_url_encoded(&builder, base64_hmac_sha256_signature);
 
-  _az_RETURN_IF_FAILED(_az_span_copy_url_encode(
-      mqtt_password_span, client->_internal.iot_hub_hostname, &mqtt_password_span));
+  az_span_builder_append_u8(&builder, AMPERSAND);
+  az_span_builder_append(&builder, se_string);
+  az_span_builder_append_u8(&builder, EQUAL_SIGN);
+  az_span_builder_append_u64(&builder, token_expiration_epoch_time);
 
-  // Device ID
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(mqtt_password_span, az_span_size(devices_string));
-  mqtt_password_span = az_span_copy(mqtt_password_span, devices_string);
-
-  _az_RETURN_IF_FAILED(_az_span_copy_url_encode(
-      mqtt_password_span, client->_internal.device_id, &mqtt_password_span));
-
-  // Module ID
-  if (az_span_size(client->_internal.options.module_id) > 0)
+  if (az_span_size(key_name) > 0)
   {
-    _az_RETURN_IF_NOT_ENOUGH_SIZE(mqtt_password_span, az_span_size(modules_string));
-    mqtt_password_span = az_span_copy(mqtt_password_span, modules_string);
-
-    _az_RETURN_IF_FAILED(_az_span_copy_url_encode(
-        mqtt_password_span, client->_internal.options.module_id, &mqtt_password_span));
+    az_span_builder_append_u8(&builder, AMPERSAND);
+    az_span_builder_append(&builder, skn_string);
+    az_span_builder_append_u8(&builder, EQUAL_SIGN);
+    az_span_builder_append(&builder, key_name);
   }
 
-  // Signature
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(
-      mqtt_password_span, 1 /* AMPERSAND */ + az_span_size(sig_string) + 1 /* EQUAL_SIGN */);
+  az_span_builder_append_u8(&builder, STRING_NULL_TERMINATOR);
 
-  mqtt_password_span = az_span_copy_u8(mqtt_password_span, AMPERSAND);
-  mqtt_password_span = az_span_copy(mqtt_password_span, sig_string);
-  mqtt_password_span = az_span_copy_u8(mqtt_password_span, EQUAL_SIGN);
+  _az_IOT_RETURN_IF_MEASURING(
+      mqtt_password,
+      az_span_builder_get_length(&builder) - 1 /* NULL TERMINATOR */,
+      out_mqtt_password_length);
 
-  _az_RETURN_IF_FAILED(_az_span_copy_url_encode(
-      mqtt_password_span, base64_hmac_sha256_signature, &mqtt_password_span));
+  az_span password = AZ_SPAN_EMPTY;
+  _az_RETURN_IF_FAILED(az_span_builder_get_span(&builder, &password));
 
-  // Expiration
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(
-      mqtt_password_span, 1 /* AMPERSAND */ + az_span_size(se_string) + 1 /* EQUAL_SIGN */);
-  mqtt_password_span = az_span_copy_u8(mqtt_password_span, AMPERSAND);
-  mqtt_password_span = az_span_copy(mqtt_password_span, se_string);
-  mqtt_password_span = az_span_copy_u8(mqtt_password_span, EQUAL_SIGN);
+  if (out_mqtt_password_length != NULL)
+  {
+    *out_mqtt_password_length = (size_t)az_span_size(password) - 1 /* NULL TERMINATOR */;
+  }
 
-  _az_RETURN_IF_FAILED(
-      az_span_u64toa(mqtt_password_span, token_expiration_epoch_time, &mqtt_password_span));
+  return AZ_OK;
+}
 
-  if (az_span_size(key_name) > 0)
+AZ_NODISCARD az_result az_iot_hub_client_sas_get_passwords(
+    az_span iot_hub_hostname,
+    az_span const* device_ids,
+    int32_t device_ids_length,
+    uint64_t token_expiration_epoch_time,
+    az_iot_sas_key const* sas_key,
+    bool derive_device_keys,
+    az_span key_name,
+    az_span passwords_buffer,
+    az_span* out_passwords)
+{
+  _az_PRECONDITION_VALID_SPAN(iot_hub_hostname, 1, false);
+  _az_PRECONDITION(device_ids_length >= 0);
+  _az_PRECONDITION(device_ids != NULL || device_ids_length == 0);
+  _az_PRECONDITION(token_expiration_epoch_time > 0);
+  _az_PRECONDITION_NOT_NULL(sas_key);
+  _az_PRECONDITION_VALID_SPAN(key_name, 0, true);
+  _az_PRECONDITION_VALID_SPAN(passwords_buffer, 0, true);
+  _az_PRECONDITION(out_passwords != NULL || device_ids_length == 0);
+
+  // The hostname is URL-encoded into the first password only, and copied from there. The size of
+  // the remainder is checked before URL-encoding into it, since running out of space is expected
+  // when the passwords buffer is too small.
+  az_span encoded_hostname = AZ_SPAN_EMPTY;
+  az_span remainder = passwords_buffer;
+
+  for (int32_t i = 0; i < device_ids_length; i++)
   {
-    // Key Name
+    _az_PRECONDITION_VALID_SPAN(device_ids[i], 1, false);
+
+    az_span const password = remainder;
+
+    // SharedAccessSignature
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(sr_string) + 1 /* EQUAL_SIGN */);
+    remainder = az_span_copy(remainder, sr_string);
+    remainder = az_span_copy_u8(remainder, EQUAL_SIGN);
+
+    // Hostname and Device ID
+    az_span const resource_uri = remainder;
+    if (az_span_size(encoded_hostname) == 0)
+    {
+      _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(iot_hub_hostname));
+      _az_RETURN_IF_FAILED(_az_span_copy_url_encode(remainder, iot_hub_hostname, &remainder));
+      encoded_hostname = az_span_slice(resource_uri, 0, _az_span_diff(remainder, resource_uri));
+    }
+    else
+    {
+      _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(encoded_hostname));
+      remainder = az_span_copy(remainder, encoded_hostname);
+    }
+
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(devices_string));
+    remainder = az_span_copy(remainder, devices_string);
+
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(device_ids[i]));
+    _az_RETURN_IF_FAILED(_az_span_copy_url_encode(remainder, device_ids[i], &remainder));
+
+    // The signature is the resource URI followed by a line feed and the expiration time. It is
+    // written where the signed signature goes, and signed in place.
+    az_span signature_end = remainder;
     _az_RETURN_IF_NOT_ENOUGH_SIZE(
-        mqtt_password_span,
-        1 /* AMPERSAND */ + az_span_size(skn_string) + 1 /* EQUAL_SIGN */ + az_span_size(key_name));
-    mqtt_password_span = az_span_copy_u8(mqtt_password_span, AMPERSAND);
-    mqtt_password_span = az_span_copy(mqtt_password_span, skn_string);
-    mqtt_password_span = az_span_copy_u8(mqtt_password_span, EQUAL_SIGN);
-    mqtt_password_span = az_span_copy(mqtt_password_span, key_name);
-  }
-
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(mqtt_password_span, 1 /* NULL TERMINATOR */);
+        signature_end,
+        1 + // LF
+            _az_iot_u64toa_size(token_expiration_epoch_time));
+    signature_end = az_span_copy_u8(signature_end, LF);
+    _az_RETURN_IF_FAILED(
+        az_span_u64toa(signature_end, token_expiration_epoch_time, &signature_end));
+
+    az_span const signature
+        = az_span_slice(resource_uri, 0, _az_span_diff(signature_end, resource_uri));
+
+    uint8_t signed_signature_buffer[AZ_IOT_BASE64_HMAC_SHA256_SIZE];
+    az_span signed_signature = AZ_SPAN_EMPTY;
+
+    if (derive_device_keys)
+    {
+      uint8_t device_key[AZ_IOT_HMAC_SHA256_SIZE];
+      _az_RETURN_IF_FAILED(_az_iot_sas_key_hmac_sha256(sas_key, device_ids[i], device_key));
+
+      az_iot_sas_key device_sas_key;
+      _az_RETURN_IF_FAILED(az_iot_sas_key_init(&device_sas_key, AZ_SPAN_FROM_BUFFER(device_key)));
+      _az_RETURN_IF_FAILED(az_iot_sas_key_sign(
+          &device_sas_key,
+          signature,
+          AZ_SPAN_FROM_BUFFER(signed_signature_buffer),
+          &signed_signature));
+    }
+    else
+    {
+      _az_RETURN_IF_FAILED(az_iot_sas_key_sign(
+          sas_key, signature, AZ_SPAN_FROM_BUFFER(signed_signature_buffer), &signed_signature));
+    }
+
+    // Signature
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(
+        remainder, 1 /* AMPERSAND */ + az_span_size(sig_string) + 1 /* EQUAL_SIGN */);
+    remainder = az_span_copy_u8(remainder, AMPERSAND);
+    remainder = az_span_copy(remainder, sig_string);
+    remainder = az_span_copy_u8(remainder, EQUAL_SIGN);
 
-  mqtt_password_span = az_span_copy_u8(mqtt_password_span, STRING_NULL_TERMINATOR);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(signed_signature));
+    _az_RETURN_IF_FAILED(_az_span_copy_url_encode(remainder, signed_signature, &remainder));
 
-  if (out_mqtt_password_length != NULL)
-  {
-    *out_mqtt_password_length
-        = mqtt_password_size - (size_t)az_span_size(mqtt_password_span) - 1 /* NULL TERMINATOR */;
+    // Expiration
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(
+        remainder, 1 /* AMPERSAND */ + az_span_size(se_string) + 1 /* EQUAL_SIGN */);
+    remainder = az_span_copy_u8(remainder, AMPERSAND);
+    remainder = az_span_copy(remainder, se_string);
+    remainder = az_span_copy_u8(remainder, EQUAL_SIGN);
+
+    _az_RETURN_IF_FAILED(az_span_u64toa(remainder, token_expiration_epoch_time, &remainder));
+
+    if (az_span_size(key_name) > 0)
+    {
+      // Key Name
+      _az_RETURN_IF_NOT_ENOUGH_SIZE(
+          remainder,
+          1 /* AMPERSAND */ + az_span_size(skn_string) + 1 /* EQUAL_SIGN */
+              + az_span_size(key_name));
+      remainder = az_span_copy_u8(remainder, AMPERSAND);
+      remainder = az_span_copy(remainder, skn_string);
+      remainder = az_span_copy_u8(remainder, EQUAL_SIGN);
+      remainder = az_span_copy(remainder, key_name);
+    }
+
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, 1 /* NULL TERMINATOR */);
+
+    out_passwords[i] = az_span_slice(password, 0, _az_span_diff(remainder, password));
+    remainder = az_span_copy_u8(remainder, STRING_NULL_TERMINATOR);
   }
 
   return AZ_OK;
@@ -1,13 +1,18 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
+#include <azure/core/az_json.h>
 #include <azure/core/az_precondition.h>
 #include <azure/core/az_result.h>
 #include <azure/core/az_span.h>
 #include <azure/core/internal/az_precondition_internal.h>
 #include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
 #include <azure/iot/az_iot_hub_client.h>
+#include <azure/iot/internal/az_iot_common_internal.h>
+#include <azure/iot/internal/az_iot_hub_client_internal.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <azure/core/_az_cfg.h>
@@ -16,6 +21,44 @@ static const uint8_t null_terminator = '\0';
 static const az_span telemetry_topic_prefix = AZ_SPAN_LITERAL_FROM_STR("devices/");
 static const az_span telemetry_topic_modules_mid = AZ_SPAN_LITERAL_FROM_STR("/modules/");
 static const az_span telemetry_topic_suffix = AZ_SPAN_LITERAL_FROM_STR("/messages/events/");
+static const az_span telemetry_batch_content_type = AZ_SPAN_LITERAL_FROM_STR("application%2Fjson");
+static const az_span telemetry_batch_content_encoding = AZ_SPAN_LITERAL_FROM_STR("utf-8");
+static const az_span telemetry_cbor_content_type = AZ_SPAN_LITERAL_FROM_STR("application%2Fcbor");
+
+// Gets the size of the part of the telemetry topic which doesn't depend on the message:
+// "devices/{device_id}[/modules/{module_id}]/messages/events/".
+AZ_NODISCARD static int32_t _az_iot_hub_client_telemetry_topic_prefix_size(
+    az_iot_hub_client const* client)
+{
+  int32_t size = az_span_size(telemetry_topic_prefix) + az_span_size(client->_internal.device_id)
+      + az_span_size(telemetry_topic_suffix);
+
+  int32_t const module_id_length = az_span_size(_az_iot_hub_client_get_module_id(client));
+  if (module_id_length > 0)
+  {
+    size += az_span_size(telemetry_topic_modules_mid) + module_id_length;
+  }
+
+  return size;
+}
+
+// Writes the part of the telemetry topic which doesn't depend on the message, to a destination
+// large enough for it.
+static az_span _az_iot_hub_client_telemetry_copy_topic_prefix(
+    az_iot_hub_client const* client,
+    az_span destination)
+{
+  az_span remainder = az_span_copy(destination, telemetry_topic_prefix);
+  remainder = az_span_copy(remainder, client->_internal.device_id);
+
+  if (az_span_size(_az_iot_hub_client_get_module_id(client)) > 0)
+  {
+    remainder = az_span_copy(remainder, telemetry_topic_modules_mid);
+    remainder = az_span_copy(remainder, _az_iot_hub_client_get_module_id(client));
+  }
+
+  return az_span_copy(remainder, telemetry_topic_suffix);
+}
 
 AZ_NODISCARD az_result az_iot_hub_client_telemetry_get_publish_topic(
     az_iot_hub_client const* client,
@@ -25,37 +68,21 @@ AZ_NODISCARD az_result az_iot_hub_client_telemetry_get_publish_topic(
     size_t* out_mqtt_topic_length)
 {
   _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_NOT_NULL(mqtt_topic);
-  _az_PRECONDITION(mqtt_topic_size > 0);
-
-  const az_span* const module_id = &(client->_internal.options.module_id);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(mqtt_topic, mqtt_topic_size, out_mqtt_topic_length);
 
   az_span mqtt_topic_span = az_span_create((uint8_t*)mqtt_topic, (int32_t)mqtt_topic_size);
-  int32_t required_length = az_span_size(telemetry_topic_prefix)
-      + az_span_size(client->_internal.device_id) + az_span_size(telemetry_topic_suffix);
-  int32_t module_id_length = az_span_size(*module_id);
-  if (module_id_length > 0)
-  {
-    required_length += az_span_size(telemetry_topic_modules_mid) + module_id_length;
-  }
+  int32_t required_length = _az_iot_hub_client_telemetry_topic_prefix_size(client);
   if (properties != NULL)
   {
     required_length += properties->_internal.properties_written;
   }
 
+  _az_IOT_RETURN_IF_MEASURING(mqtt_topic, required_length, out_mqtt_topic_length);
+
   _az_RETURN_IF_NOT_ENOUGH_SIZE(
       mqtt_topic_span, required_length + (int32_t)sizeof(null_terminator));
 
-  az_span remainder = az_span_copy(mqtt_topic_span, telemetry_topic_prefix);
-  remainder = az_span_copy(remainder, client->_internal.device_id);
-
-  if (module_id_length > 0)
-  {
-    remainder = az_span_copy(remainder, telemetry_topic_modules_mid);
-    remainder = az_span_copy(remainder, *module_id);
-  }
-
-  remainder = az_span_copy(remainder, telemetry_topic_suffix);
+  az_span remainder = _az_iot_hub_client_telemetry_copy_topic_prefix(client, mqtt_topic_span);
 
   if (properties != NULL)
   {
@@ -74,3 +101,184 @@ AZ_NODISCARD az_result az_iot_hub_client_telemetry_get_publish_topic(
 
   return AZ_OK;
 }
+
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_get_publish_topic_prefix(
+    az_iot_hub_client const* client,
+    char* mqtt_topic,
+    size_t mqtt_topic_size,
+    size_t* out_mqtt_topic_prefix_length)
+{
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(mqtt_topic, mqtt_topic_size, out_mqtt_topic_prefix_length);
+  _az_PRECONDITION_NOT_NULL(out_mqtt_topic_prefix_length);
+
+  az_span mqtt_topic_span = az_span_create((uint8_t*)mqtt_topic, (int32_t)mqtt_topic_size);
+  int32_t const prefix_length = _az_iot_hub_client_telemetry_topic_prefix_size(client);
+  _az_IOT_RETURN_IF_MEASURING(mqtt_topic, prefix_length, out_mqtt_topic_prefix_length);
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(mqtt_topic_span, prefix_length + (int32_t)sizeof(null_terminator));
+
+  az_span_copy_u8(
+      _az_iot_hub_client_telemetry_copy_topic_prefix(client, mqtt_topic_span), null_terminator);
+
+  *out_mqtt_topic_prefix_length = (size_t)prefix_length;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_set_publish_topic_properties(
+    az_iot_message_properties const* properties,
+    char* mqtt_topic,
+    size_t mqtt_topic_size,
+    size_t mqtt_topic_prefix_length,
+    size_t* out_mqtt_topic_length)
+{
+  _az_PRECONDITION_NOT_NULL(mqtt_topic);
+  _az_PRECONDITION(mqtt_topic_prefix_length > 0);
+  _az_PRECONDITION(mqtt_topic_size > mqtt_topic_prefix_length);
+
+  // Only the properties are written, after the prefix already in the topic buffer.
+  az_span remainder = az_span_create(
+      (uint8_t*)mqtt_topic + mqtt_topic_prefix_length,
+      (int32_t)(mqtt_topic_size - mqtt_topic_prefix_length));
+  int32_t properties_length = 0;
+  if (properties != NULL)
+  {
+    properties_length = properties->_internal.properties_written;
+  }
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, properties_length + (int32_t)sizeof(null_terminator));
+
+  if (properties_length > 0)
+  {
+    remainder = az_span_copy(
+        remainder, az_span_slice(properties->_internal.properties_buffer, 0, properties_length));
+  }
+
+  az_span_copy_u8(remainder, null_terminator);
+
+  if (out_mqtt_topic_length)
+  {
+    *out_mqtt_topic_length = mqtt_topic_prefix_length + (size_t)properties_length;
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_batch_init(
+    az_iot_hub_client_telemetry_batch* batch,
+    az_span buffer,
+    int32_t max_count,
+    int64_t max_delay)
+{
+  _az_PRECONDITION_NOT_NULL(batch);
+  _az_PRECONDITION_VALID_SPAN(buffer, 2, false);
+  _az_PRECONDITION(max_count > 0);
+  _az_PRECONDITION(max_delay >= 0);
+
+  batch->_internal.buffer = buffer;
+  batch->_internal.max_count = max_count;
+  batch->_internal.max_delay = max_delay;
+  az_iot_hub_client_telemetry_batch_clear(batch);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_batch_append(
+    az_iot_hub_client_telemetry_batch* batch,
+    az_span json_message,
+    int64_t now)
+{
+  _az_PRECONDITION_NOT_NULL(batch);
+  _az_PRECONDITION_VALID_SPAN(json_message, 1, false);
+
+  if (batch->_internal.count == batch->_internal.max_count)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  // Keep the writer as it was if the message doesn't fit or isn't valid.
+  az_json_writer writer = batch->_internal.writer;
+  _az_RETURN_IF_FAILED(az_json_writer_append_json_text(&writer, json_message));
+  batch->_internal.writer = writer;
+
+  if (batch->_internal.count == 0)
+  {
+    batch->_internal.first_message_time = now;
+  }
+
+  batch->_internal.count++;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD bool az_iot_hub_client_telemetry_batch_should_flush(
+    az_iot_hub_client_telemetry_batch const* batch,
+    int64_t now)
+{
+  _az_PRECONDITION_NOT_NULL(batch);
+
+  return batch->_internal.count > 0
+      && (batch->_internal.count == batch->_internal.max_count
+          || now - batch->_internal.first_message_time >= batch->_internal.max_delay);
+}
+
+AZ_NODISCARD az_span
+az_iot_hub_client_telemetry_batch_get_payload(az_iot_hub_client_telemetry_batch* batch)
+{
+  _az_PRECONDITION_NOT_NULL(batch);
+
+  // The writer is kept one byte short of the buffer, leaving room for the end of the array.
+  int32_t const used
+      = az_span_size(az_json_writer_get_bytes_used_in_destination(&batch->_internal.writer));
+  az_span_copy_u8(az_span_slice_to_end(batch->_internal.buffer, used), ']');
+
+  return az_span_slice(batch->_internal.buffer, 0, used + 1);
+}
+
+void az_iot_hub_client_telemetry_batch_clear(az_iot_hub_client_telemetry_batch* batch)
+{
+  _az_PRECONDITION_NOT_NULL(batch);
+
+  // The writer is kept one byte short of the buffer, leaving room for the end of the array. The
+  // buffer was checked at init to hold at least the empty array.
+  az_span const buffer = batch->_internal.buffer;
+  az_result result = az_json_writer_init(
+      &batch->_internal.writer, az_span_slice(buffer, 0, az_span_size(buffer) - 1), NULL);
+  if (az_result_succeeded(result))
+  {
+    result = az_json_writer_append_begin_array(&batch->_internal.writer);
+  }
+
+  _az_PRECONDITION(az_result_succeeded(result));
+  (void)result;
+
+  batch->_internal.count = 0;
+  batch->_internal.first_message_time = 0;
+}
+
+AZ_NODISCARD az_result
+az_iot_hub_client_telemetry_batch_append_properties(az_iot_message_properties* properties)
+{
+  _az_PRECONDITION_NOT_NULL(properties);
+
+  _az_RETURN_IF_FAILED(az_iot_message_properties_append(
+      properties,
+      AZ_SPAN_FROM_STR(AZ_IOT_MESSAGE_PROPERTIES_CONTENT_TYPE),
+      telemetry_batch_content_type));
+
+  return az_iot_message_properties_append(
+      properties,
+      AZ_SPAN_FROM_STR(AZ_IOT_MESSAGE_PROPERTIES_CONTENT_ENCODING),
+      telemetry_batch_content_encoding);
+}
+
+AZ_NODISCARD az_result
+az_iot_hub_client_telemetry_append_cbor_properties(az_iot_message_properties* properties)
+{
+  _az_PRECONDITION_NOT_NULL(properties);
+
+  return az_iot_message_properties_append(
+      properties,
+      AZ_SPAN_FROM_STR(AZ_IOT_MESSAGE_PROPERTIES_CONTENT_TYPE),
+      telemetry_cbor_content_type);
+}
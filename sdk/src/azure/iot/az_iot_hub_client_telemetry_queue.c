@@ -0,0 +1,436 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <azure/core/_az_cfg.h>
+
+/*
+Storage layout, with every integer little-endian:
+
+  header 0          20 bytes
+  header 1          20 bytes
+  ring              the rest of the storage
+
+The state is written to the header given by the parity of its generation, so that the other one
+still holds the previous state if the write is interrupted. A header is:
+
+  magic             4 bytes
+  generation        4 bytes
+  head              4 bytes, ring offset of the oldest message
+  tail              4 bytes, ring offset the next message is written at
+  CRC-32            4 bytes, of all the preceding bytes
+
+A message is written contiguously in the ring, before the header is updated:
+
+  topic size        2 bytes
+  payload size      4 bytes
+  topic
+  payload
+  CRC-32            4 bytes, of all the preceding bytes of the message
+
+A message which doesn't fit before the end of the ring is written at its start, leaving a topic size
+of 0xFFFF at the tail to mark the wrap. Fewer than 6 bytes left at the end of the ring are skipped
+without a mark. The tail never reaches the head unless the queue is empty, so a message takes at
+most the size of the ring less 6 bytes, to keep room for the next message header or wrap mark.
+*/
+#define _az_IOT_HUB_TELEMETRY_QUEUE_MAGIC 0x31515441 // "ATQ1"
+#define _az_IOT_HUB_TELEMETRY_QUEUE_HEADER_SIZE 20
+#define _az_IOT_HUB_TELEMETRY_QUEUE_RING_OFFSET (2 * _az_IOT_HUB_TELEMETRY_QUEUE_HEADER_SIZE)
+#define _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_HEADER_SIZE (2 + 4)
+#define _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_OVERHEAD \
+  (_az_IOT_HUB_TELEMETRY_QUEUE_RECORD_HEADER_SIZE + 4)
+#define _az_IOT_HUB_TELEMETRY_QUEUE_WRAP_MARK 0xFFFF
+
+static uint32_t _az_iot_hub_telemetry_queue_read_uint(uint8_t const* source, int32_t size)
+{
+  uint32_t value = 0;
+  for (int32_t i = 0; i < size; i++)
+  {
+    value |= (uint32_t)source[i] << (8 * i);
+  }
+  return value;
+}
+
+static void
+_az_iot_hub_telemetry_queue_write_uint(uint8_t* destination, uint32_t value, int32_t size)
+{
+  for (int32_t i = 0; i < size; i++)
+  {
+    destination[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+AZ_INLINE az_span
+_az_iot_hub_telemetry_queue_get_ring(az_iot_hub_client_telemetry_queue const* queue)
+{
+  return az_span_slice_to_end(queue->_internal.storage, _az_IOT_HUB_TELEMETRY_QUEUE_RING_OFFSET);
+}
+
+// Moves an offset at the end of the ring, with no room for a message header, to its start.
+AZ_INLINE int32_t _az_iot_hub_telemetry_queue_normalize(az_span ring, int32_t offset)
+{
+  return az_span_size(ring) - offset < _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_HEADER_SIZE ? 0 : offset;
+}
+
+static void _az_iot_hub_telemetry_queue_write_header(az_iot_hub_client_telemetry_queue* queue)
+{
+  queue->_internal.generation++;
+
+  uint8_t* const header = az_span_ptr(queue->_internal.storage)
+      + (queue->_internal.generation & 1) * _az_IOT_HUB_TELEMETRY_QUEUE_HEADER_SIZE;
+  _az_iot_hub_telemetry_queue_write_uint(header, _az_IOT_HUB_TELEMETRY_QUEUE_MAGIC, 4);
+  _az_iot_hub_telemetry_queue_write_uint(header + 4, queue->_internal.generation, 4);
+  _az_iot_hub_telemetry_queue_write_uint(header + 8, (uint32_t)queue->_internal.head, 4);
+  _az_iot_hub_telemetry_queue_write_uint(header + 12, (uint32_t)queue->_internal.tail, 4);
+  _az_iot_hub_telemetry_queue_write_uint(
+      header + 16, _az_span_crc32(0, az_span_create(header, 16)), 4);
+}
+
+// Reads a header, returning false if it doesn't hold a valid state.
+static bool _az_iot_hub_telemetry_queue_read_header(
+    az_span storage,
+    int32_t index,
+    uint32_t* out_generation,
+    int32_t* out_head,
+    int32_t* out_tail)
+{
+  uint8_t* const header = az_span_ptr(storage) + index * _az_IOT_HUB_TELEMETRY_QUEUE_HEADER_SIZE;
+  if (_az_iot_hub_telemetry_queue_read_uint(header, 4) != _az_IOT_HUB_TELEMETRY_QUEUE_MAGIC
+      || _az_iot_hub_telemetry_queue_read_uint(header + 16, 4)
+          != _az_span_crc32(0, az_span_create(header, 16)))
+  {
+    return false;
+  }
+
+  az_span const ring = az_span_slice_to_end(storage, _az_IOT_HUB_TELEMETRY_QUEUE_RING_OFFSET);
+  uint32_t const head = _az_iot_hub_telemetry_queue_read_uint(header + 8, 4);
+  uint32_t const tail = _az_iot_hub_telemetry_queue_read_uint(header + 12, 4);
+  if (head >= (uint32_t)az_span_size(ring) || tail >= (uint32_t)az_span_size(ring)
+      || _az_iot_hub_telemetry_queue_normalize(ring, (int32_t)head) != (int32_t)head
+      || _az_iot_hub_telemetry_queue_normalize(ring, (int32_t)tail) != (int32_t)tail)
+  {
+    return false;
+  }
+
+  *out_generation = _az_iot_hub_telemetry_queue_read_uint(header + 4, 4);
+  *out_head = (int32_t)head;
+  *out_tail = (int32_t)tail;
+  return true;
+}
+
+// Moves an offset past the end of the ring or a wrap mark to the start of the ring, returning true
+// if it did.
+static bool _az_iot_hub_telemetry_queue_skip_wrap(az_span ring, int32_t* ref_offset)
+{
+  int32_t const offset = _az_iot_hub_telemetry_queue_normalize(ring, *ref_offset);
+  if (offset != *ref_offset
+      || _az_iot_hub_telemetry_queue_read_uint(az_span_ptr(ring) + offset, 2)
+          == _az_IOT_HUB_TELEMETRY_QUEUE_WRAP_MARK)
+  {
+    *ref_offset = 0;
+    return true;
+  }
+
+  return false;
+}
+
+// Parses the message at an offset, without going past limit, and returns the offset after it.
+// Returns -1 if the message is corrupt.
+static int32_t _az_iot_hub_telemetry_queue_parse_record(
+    az_span ring,
+    int32_t offset,
+    int32_t limit,
+    az_span* out_topic,
+    az_span* out_payload)
+{
+  uint8_t* const record = az_span_ptr(ring) + offset;
+  int64_t const topic_size = _az_iot_hub_telemetry_queue_read_uint(record, 2);
+  int64_t const payload_size = _az_iot_hub_telemetry_queue_read_uint(record + 2, 4);
+  int64_t const end
+      = offset + _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_OVERHEAD + topic_size + payload_size;
+  if (end > limit)
+  {
+    return -1;
+  }
+
+  int32_t const crc_offset = (int32_t)end - 4 - offset;
+  if (_az_iot_hub_telemetry_queue_read_uint(record + crc_offset, 4)
+      != _az_span_crc32(0, az_span_create(record, crc_offset)))
+  {
+    return -1;
+  }
+
+  *out_topic = az_span_create(
+      record + _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_HEADER_SIZE, (int32_t)topic_size);
+  *out_payload = az_span_create(
+      record + _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_HEADER_SIZE + topic_size, (int32_t)payload_size);
+  return (int32_t)end;
+}
+
+// Reads the message at an offset, known to be valid, and returns the offset after it.
+static int32_t _az_iot_hub_telemetry_queue_next_record(
+    az_span ring,
+    int32_t offset,
+    az_span* out_topic,
+    az_span* out_payload)
+{
+  (void)_az_iot_hub_telemetry_queue_skip_wrap(ring, &offset);
+
+  uint8_t* const record = az_span_ptr(ring) + offset;
+  int32_t const topic_size = (int32_t)_az_iot_hub_telemetry_queue_read_uint(record, 2);
+  int32_t const payload_size = (int32_t)_az_iot_hub_telemetry_queue_read_uint(record + 2, 4);
+  *out_topic = az_span_create(record + _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_HEADER_SIZE, topic_size);
+  *out_payload = az_span_create(
+      record + _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_HEADER_SIZE + topic_size, payload_size);
+
+  return _az_iot_hub_telemetry_queue_normalize(
+      ring, offset + _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_OVERHEAD + topic_size + payload_size);
+}
+
+// Counts the messages from the head to the tail, moving the tail back to the first corrupt one.
+static void _az_iot_hub_telemetry_queue_recover(az_iot_hub_client_telemetry_queue* queue)
+{
+  az_span const ring = _az_iot_hub_telemetry_queue_get_ring(queue);
+  int32_t const head = queue->_internal.head;
+  int32_t tail = queue->_internal.tail;
+  int32_t offset = head;
+  bool wrapped = false;
+
+  queue->_internal.count = 0;
+  while (offset != tail)
+  {
+    int32_t const record_offset = offset;
+    if (_az_iot_hub_telemetry_queue_skip_wrap(ring, &offset))
+    {
+      // The messages only wrap once, when the tail is before the head.
+      if (wrapped || head < tail)
+      {
+        tail = record_offset;
+        break;
+      }
+
+      wrapped = true;
+      continue;
+    }
+
+    az_span topic;
+    az_span payload;
+    int32_t const limit = head > tail && !wrapped ? az_span_size(ring) : tail;
+    int32_t const end
+        = _az_iot_hub_telemetry_queue_parse_record(ring, offset, limit, &topic, &payload);
+    if (end < 0)
+    {
+      tail = offset;
+      break;
+    }
+
+    queue->_internal.count++;
+    offset = end;
+  }
+
+  if (queue->_internal.count == 0)
+  {
+    tail = 0;
+    queue->_internal.head = 0;
+  }
+
+  if (tail != queue->_internal.tail || head != queue->_internal.head)
+  {
+    queue->_internal.tail = tail;
+    _az_iot_hub_telemetry_queue_write_header(queue);
+  }
+}
+
+AZ_NODISCARD az_result
+az_iot_hub_client_telemetry_queue_init(az_iot_hub_client_telemetry_queue* queue, az_span storage)
+{
+  _az_PRECONDITION_NOT_NULL(queue);
+  _az_PRECONDITION_VALID_SPAN(
+      storage,
+      _az_IOT_HUB_TELEMETRY_QUEUE_RING_OFFSET + _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_OVERHEAD + 2,
+      false);
+
+  queue->_internal.storage = storage;
+
+  uint32_t generation[2];
+  int32_t head[2];
+  int32_t tail[2];
+  bool const valid[2] = {
+    _az_iot_hub_telemetry_queue_read_header(storage, 0, &generation[0], &head[0], &tail[0]),
+    _az_iot_hub_telemetry_queue_read_header(storage, 1, &generation[1], &head[1], &tail[1]),
+  };
+
+  if (!valid[0] && !valid[1])
+  {
+    queue->_internal.generation = 0;
+    queue->_internal.head = 0;
+    queue->_internal.tail = 0;
+    queue->_internal.count = 0;
+    _az_iot_hub_telemetry_queue_write_header(queue);
+    return AZ_OK;
+  }
+
+  // The generations may wrap around.
+  int32_t const latest
+      = !valid[0] || (valid[1] && (int32_t)(generation[1] - generation[0]) > 0) ? 1 : 0;
+  queue->_internal.generation = generation[latest];
+  queue->_internal.head = head[latest];
+  queue->_internal.tail = tail[latest];
+  _az_iot_hub_telemetry_queue_recover(queue);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_queue_append(
+    az_iot_hub_client_telemetry_queue* queue,
+    az_span topic,
+    az_span payload)
+{
+  _az_PRECONDITION_NOT_NULL(queue);
+  _az_PRECONDITION_VALID_SPAN(topic, 1, false);
+  _az_PRECONDITION(az_span_size(topic) < _az_IOT_HUB_TELEMETRY_QUEUE_WRAP_MARK);
+  _az_PRECONDITION_VALID_SPAN(payload, 0, true);
+
+  az_span const ring = _az_iot_hub_telemetry_queue_get_ring(queue);
+  int32_t const ring_size = az_span_size(ring);
+  if (az_span_size(payload) > ring_size - _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_HEADER_SIZE
+          - _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_OVERHEAD - az_span_size(topic))
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  int32_t const size
+      = _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_OVERHEAD + az_span_size(topic) + az_span_size(payload);
+  int32_t const head = queue->_internal.head;
+  int32_t const tail = queue->_internal.tail;
+  int32_t offset = tail;
+  int32_t end;
+
+  if (tail < head)
+  {
+    end = offset + size;
+    if (end >= head)
+    {
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+  }
+  else if (tail + size <= ring_size)
+  {
+    end = _az_iot_hub_telemetry_queue_normalize(ring, offset + size);
+    if (end == head)
+    {
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+  }
+  else
+  {
+    offset = 0;
+    end = size;
+    if (end >= head)
+    {
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+  }
+
+  uint8_t* const record = az_span_ptr(ring) + offset;
+  _az_iot_hub_telemetry_queue_write_uint(record, (uint32_t)az_span_size(topic), 2);
+  _az_iot_hub_telemetry_queue_write_uint(record + 2, (uint32_t)az_span_size(payload), 4);
+  az_span remainder = az_span_create(
+      record + _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_HEADER_SIZE,
+      size - _az_IOT_HUB_TELEMETRY_QUEUE_RECORD_HEADER_SIZE);
+  remainder = az_span_copy(remainder, topic);
+  remainder = az_span_copy(remainder, payload);
+  _az_iot_hub_telemetry_queue_write_uint(
+      az_span_ptr(remainder), _az_span_crc32(0, az_span_create(record, size - 4)), 4);
+
+  if (offset != tail)
+  {
+    _az_iot_hub_telemetry_queue_write_uint(
+        az_span_ptr(ring) + tail, _az_IOT_HUB_TELEMETRY_QUEUE_WRAP_MARK, 2);
+  }
+
+  queue->_internal.tail = end;
+  queue->_internal.count++;
+  _az_iot_hub_telemetry_queue_write_header(queue);
+
+  return AZ_OK;
+}
+
+void az_iot_hub_client_telemetry_queue_cursor_init(
+    az_iot_hub_client_telemetry_queue const* queue,
+    az_iot_hub_client_telemetry_queue_cursor* cursor)
+{
+  _az_PRECONDITION_NOT_NULL(queue);
+  _az_PRECONDITION_NOT_NULL(cursor);
+
+  cursor->_internal.offset = queue->_internal.head;
+  cursor->_internal.remaining = queue->_internal.count;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_telemetry_queue_read(
+    az_iot_hub_client_telemetry_queue const* queue,
+    az_iot_hub_client_telemetry_queue_cursor* cursor,
+    az_span* out_topic,
+    az_span* out_payload)
+{
+  _az_PRECONDITION_NOT_NULL(queue);
+  _az_PRECONDITION_NOT_NULL(cursor);
+  _az_PRECONDITION_NOT_NULL(out_topic);
+  _az_PRECONDITION_NOT_NULL(out_payload);
+
+  if (cursor->_internal.remaining == 0)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  // The messages were checked when the queue was initialized or appended.
+  cursor->_internal.offset = _az_iot_hub_telemetry_queue_next_record(
+      _az_iot_hub_telemetry_queue_get_ring(queue),
+      cursor->_internal.offset,
+      out_topic,
+      out_payload);
+  cursor->_internal.remaining--;
+  return AZ_OK;
+}
+
+void az_iot_hub_client_telemetry_queue_remove(
+    az_iot_hub_client_telemetry_queue* queue,
+    int32_t count)
+{
+  _az_PRECONDITION_NOT_NULL(queue);
+  _az_PRECONDITION_RANGE(0, count, queue->_internal.count);
+
+  if (count == 0)
+  {
+    return;
+  }
+
+  if (count == queue->_internal.count)
+  {
+    // Starting over at the start of the ring leaves the most room for the next message.
+    queue->_internal.head = 0;
+    queue->_internal.tail = 0;
+  }
+  else
+  {
+    az_span const ring = _az_iot_hub_telemetry_queue_get_ring(queue);
+    for (int32_t i = 0; i < count; i++)
+    {
+      az_span topic;
+      az_span payload;
+      queue->_internal.head
+          = _az_iot_hub_telemetry_queue_next_record(ring, queue->_internal.head, &topic, &payload);
+    }
+  }
+
+  queue->_internal.count -= count;
+  _az_iot_hub_telemetry_queue_write_header(queue);
+}
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_log_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+#include <azure/iot/internal/az_iot_common_internal.h>
+#include <azure/iot/internal/az_iot_hub_client_internal.h>
+
+#include <azure/core/_az_cfg.h>
+
+static const az_span hub_topic_iothub_prefix = AZ_SPAN_LITERAL_FROM_STR("$iothub/");
+static const az_span hub_topic_methods_prefix = AZ_SPAN_LITERAL_FROM_STR("methods/POST/");
+static const az_span hub_topic_twin_prefix = AZ_SPAN_LITERAL_FROM_STR("twin/");
+static const az_span hub_topic_devices_prefix = AZ_SPAN_LITERAL_FROM_STR("devices/");
+static const az_span hub_topic_c2d_infix = AZ_SPAN_LITERAL_FROM_STR("/messages/devicebound/");
+
+AZ_NODISCARD az_result az_iot_hub_client_topic_parse(
+    az_iot_hub_client const* client,
+    az_span received_topic,
+    az_iot_hub_client_topic* out_topic)
+{
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION_VALID_SPAN(_az_iot_hub_client_get_hostname(client), 1, false);
+  _az_PRECONDITION_VALID_SPAN(received_topic, 1, false);
+  _az_PRECONDITION_NOT_NULL(out_topic);
+  (void)client;
+
+  az_result result = AZ_ERROR_IOT_TOPIC_NO_MATCH;
+
+  if (_az_span_starts_with(received_topic, hub_topic_iothub_prefix))
+  {
+    az_span const feature
+        = az_span_slice_to_end(received_topic, az_span_size(hub_topic_iothub_prefix));
+
+    if (_az_span_starts_with(feature, hub_topic_methods_prefix))
+    {
+      out_topic->type = AZ_IOT_HUB_CLIENT_TOPIC_TYPE_METHOD;
+      result = _az_iot_hub_client_methods_parse_topic_suffix(
+          az_span_slice_to_end(feature, az_span_size(hub_topic_methods_prefix)),
+          &out_topic->parsed.method);
+    }
+    else if (_az_span_starts_with(feature, hub_topic_twin_prefix))
+    {
+      out_topic->type = AZ_IOT_HUB_CLIENT_TOPIC_TYPE_TWIN;
+      result = _az_iot_hub_client_twin_parse_topic_suffix(
+          az_span_slice_to_end(feature, az_span_size(hub_topic_twin_prefix)),
+          &out_topic->parsed.twin);
+    }
+  }
+  else if (_az_span_starts_with(received_topic, hub_topic_devices_prefix))
+  {
+    // devices/{device_id}[/modules/{module_id}]/messages/devicebound/{properties}
+    az_span const device_path
+        = az_span_slice_to_end(received_topic, az_span_size(hub_topic_devices_prefix));
+    int32_t const index = az_span_find(device_path, hub_topic_c2d_infix);
+
+    if (index >= 0)
+    {
+      out_topic->type = AZ_IOT_HUB_CLIENT_TOPIC_TYPE_C2D;
+      result = _az_iot_hub_client_c2d_parse_topic_suffix(
+          az_span_slice_to_end(device_path, index + az_span_size(hub_topic_c2d_infix)),
+          &out_topic->parsed.c2d);
+    }
+  }
+
+  if (result != AZ_ERROR_IOT_TOPIC_NO_MATCH && _az_LOG_SHOULD_WRITE(AZ_LOG_MQTT_RECEIVED_TOPIC))
+  {
+    _az_LOG_WRITE(AZ_LOG_MQTT_RECEIVED_TOPIC, received_topic);
+  }
+
+  return result;
+}
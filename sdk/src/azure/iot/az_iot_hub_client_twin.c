@@ -11,6 +11,8 @@
 #include <azure/core/internal/az_result_internal.h>
 #include <azure/core/internal/az_span_internal.h>
 #include <azure/iot/az_iot_hub_client.h>
+#include <azure/iot/internal/az_iot_common_internal.h>
+#include <azure/iot/internal/az_iot_hub_client_internal.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -35,10 +37,9 @@ AZ_NODISCARD az_result az_iot_hub_client_twin_document_get_publish_topic(
     size_t* out_mqtt_topic_length)
 {
   _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_VALID_SPAN(client->_internal.iot_hub_hostname, 1, false);
+  _az_PRECONDITION_VALID_SPAN(_az_iot_hub_client_get_hostname(client), 1, false);
   _az_PRECONDITION_VALID_SPAN(request_id, 1, false);
-  _az_PRECONDITION_NOT_NULL(mqtt_topic);
-  _az_PRECONDITION(mqtt_topic_size > 0);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(mqtt_topic, mqtt_topic_size, out_mqtt_topic_length);
   (void)client;
 
   az_span mqtt_topic_span = az_span_create((uint8_t*)mqtt_topic, (int32_t)mqtt_topic_size);
@@ -48,6 +49,8 @@ AZ_NODISCARD az_result az_iot_hub_client_twin_document_get_publish_topic(
       + az_span_size(az_iot_hub_client_request_id_span)
       + (int32_t)sizeof(az_iot_hub_client_twin_equals) + az_span_size(request_id);
 
+  _az_IOT_RETURN_IF_MEASURING(mqtt_topic, required_length, out_mqtt_topic_length);
+
   _az_RETURN_IF_NOT_ENOUGH_SIZE(
       mqtt_topic_span, required_length + (int32_t)sizeof(null_terminator));
 
@@ -67,6 +70,27 @@ AZ_NODISCARD az_result az_iot_hub_client_twin_document_get_publish_topic(
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result az_iot_hub_client_twin_document_get_publish_topic_u64(
+    az_iot_hub_client const* client,
+    uint64_t request_id,
+    char* mqtt_topic,
+    size_t mqtt_topic_size,
+    size_t* out_mqtt_topic_length)
+{
+  uint8_t request_id_buffer[_az_MAX_SIZE_FOR_UINT64];
+  az_span remainder;
+  _az_RETURN_IF_FAILED(
+      az_span_u64toa(AZ_SPAN_FROM_BUFFER(request_id_buffer), request_id, &remainder));
+
+  return az_iot_hub_client_twin_document_get_publish_topic(
+      client,
+      az_span_create(
+          request_id_buffer, (int32_t)sizeof(request_id_buffer) - az_span_size(remainder)),
+      mqtt_topic,
+      mqtt_topic_size,
+      out_mqtt_topic_length);
+}
+
 AZ_NODISCARD az_result az_iot_hub_client_twin_patch_get_publish_topic(
     az_iot_hub_client const* client,
     az_span request_id,
@@ -75,10 +99,9 @@ AZ_NODISCARD az_result az_iot_hub_client_twin_patch_get_publish_topic(
     size_t* out_mqtt_topic_length)
 {
   _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_VALID_SPAN(client->_internal.iot_hub_hostname, 1, false);
+  _az_PRECONDITION_VALID_SPAN(_az_iot_hub_client_get_hostname(client), 1, false);
   _az_PRECONDITION_VALID_SPAN(request_id, 1, false);
-  _az_PRECONDITION_NOT_NULL(mqtt_topic);
-  _az_PRECONDITION(mqtt_topic_size > 0);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(mqtt_topic, mqtt_topic_size, out_mqtt_topic_length);
   (void)client;
 
   az_span mqtt_topic_span = az_span_create((uint8_t*)mqtt_topic, (int32_t)mqtt_topic_size);
@@ -88,6 +111,8 @@ AZ_NODISCARD az_result az_iot_hub_client_twin_patch_get_publish_topic(
       + az_span_size(az_iot_hub_client_request_id_span)
       + (int32_t)sizeof(az_iot_hub_client_twin_equals) + az_span_size(request_id);
 
+  _az_IOT_RETURN_IF_MEASURING(mqtt_topic, required_length, out_mqtt_topic_length);
+
   _az_RETURN_IF_NOT_ENOUGH_SIZE(
       mqtt_topic_span, required_length + (int32_t)sizeof(null_terminator));
 
@@ -107,109 +132,135 @@ AZ_NODISCARD az_result az_iot_hub_client_twin_patch_get_publish_topic(
   return AZ_OK;
 }
 
-AZ_NODISCARD az_result az_iot_hub_client_twin_parse_received_topic(
+AZ_NODISCARD az_result az_iot_hub_client_twin_patch_get_publish_topic_u64(
     az_iot_hub_client const* client,
-    az_span received_topic,
-    az_iot_hub_client_twin_response* out_response)
+    uint64_t request_id,
+    char* mqtt_topic,
+    size_t mqtt_topic_size,
+    size_t* out_mqtt_topic_length)
 {
-  _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_VALID_SPAN(client->_internal.iot_hub_hostname, 1, false);
-  _az_PRECONDITION_VALID_SPAN(received_topic, 1, false);
-  _az_PRECONDITION_NOT_NULL(out_response);
-  (void)client;
+  uint8_t request_id_buffer[_az_MAX_SIZE_FOR_UINT64];
+  az_span remainder;
+  _az_RETURN_IF_FAILED(
+      az_span_u64toa(AZ_SPAN_FROM_BUFFER(request_id_buffer), request_id, &remainder));
 
-  az_result result = AZ_OK;
+  return az_iot_hub_client_twin_patch_get_publish_topic(
+      client,
+      az_span_create(
+          request_id_buffer, (int32_t)sizeof(request_id_buffer) - az_span_size(remainder)),
+      mqtt_topic,
+      mqtt_topic_size,
+      out_mqtt_topic_length);
+}
 
-  int32_t twin_index = az_span_find(received_topic, az_iot_hub_twin_topic_prefix);
-  // Check if is related to twin or not
-  if (twin_index >= 0)
+AZ_NODISCARD az_result _az_iot_hub_client_twin_parse_topic_suffix(
+    az_span topic_suffix,
+    az_iot_hub_client_twin_response* out_response)
+{
+  if (_az_span_starts_with(topic_suffix, az_iot_hub_twin_response_sub_topic))
   {
-    _az_LOG_WRITE(AZ_LOG_MQTT_RECEIVED_TOPIC, received_topic);
+    // Is a res case
+    az_span const status_and_properties
+        = az_span_slice_to_end(topic_suffix, az_span_size(az_iot_hub_twin_response_sub_topic));
+    if (az_span_size(status_and_properties) == 0)
+    {
+      return AZ_ERROR_UNEXPECTED_END;
+    }
 
-    int32_t twin_feature_index = -1;
-    az_span twin_feature_span
-        = az_span_slice(received_topic, twin_index, az_span_size(received_topic));
+    int32_t index = 0;
+    az_span remainder;
+    az_span status_str
+        = _az_span_token(status_and_properties, AZ_SPAN_FROM_STR("/"), &remainder, &index);
 
-    if ((twin_feature_index = az_span_find(twin_feature_span, az_iot_hub_twin_response_sub_topic))
-        >= 0)
+    // An empty status, as in "$iothub/twin/res//", isn't a number.
+    if (az_span_size(status_str) == 0)
     {
-      // Is a res case
-      int32_t index = 0;
-      az_span remainder;
-      az_span status_str = _az_span_token(
-          az_span_slice(
-              received_topic,
-              twin_feature_index + az_span_size(az_iot_hub_twin_response_sub_topic),
-              az_span_size(received_topic)),
-          AZ_SPAN_FROM_STR("/"),
-          &remainder,
-          &index);
-
-      // Get status and convert to enum
-      uint32_t status_int = 0;
-      _az_RETURN_IF_FAILED(az_span_atou32(status_str, &status_int));
-      out_response->status = (az_iot_status)status_int;
-
-      if (index == -1)
-      {
-        return AZ_ERROR_UNEXPECTED_END;
-      }
-
-      // Get request id prop value
-      az_iot_message_properties props;
-      az_span prop_span = az_span_slice(remainder, 1, az_span_size(remainder));
-      _az_RETURN_IF_FAILED(
-          az_iot_message_properties_init(&props, prop_span, az_span_size(prop_span)));
-      _az_RETURN_IF_FAILED(az_iot_message_properties_find(
-          &props, az_iot_hub_client_request_id_span, &out_response->request_id));
-
-      if (out_response->status == AZ_IOT_STATUS_NO_CONTENT)
-      {
-        // Is a reported prop response
-        out_response->response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_REPORTED_PROPERTIES;
-        _az_RETURN_IF_FAILED(az_iot_message_properties_find(
-            &props, az_iot_hub_twin_version_prop, &out_response->version));
-      }
-      else
-      {
-        // Is a twin GET response
-        out_response->response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_GET;
-        out_response->version = AZ_SPAN_EMPTY;
-      }
-
-      result = AZ_OK;
+      return AZ_ERROR_UNEXPECTED_CHAR;
     }
-    else if (
-        (twin_feature_index = az_span_find(twin_feature_span, az_iot_hub_twin_patch_sub_topic))
-        >= 0)
+
+    // Get status and convert to enum
+    uint32_t status_int = 0;
+    _az_RETURN_IF_FAILED(az_span_atou32(status_str, &status_int));
+    out_response->status = (az_iot_status)status_int;
+
+    if (index == -1 || az_span_size(remainder) == 0)
     {
-      // Is a /PATCH case (desired props)
-      az_iot_message_properties props;
-      az_span prop_span = az_span_slice(
-          received_topic,
-          twin_feature_index + az_span_size(az_iot_hub_twin_patch_sub_topic)
-              + (int32_t)sizeof(az_iot_hub_client_twin_question),
-          az_span_size(received_topic));
-      _az_RETURN_IF_FAILED(
-          az_iot_message_properties_init(&props, prop_span, az_span_size(prop_span)));
-      _az_RETURN_IF_FAILED(az_iot_message_properties_find(
-          &props, az_iot_hub_twin_version_prop, &out_response->version));
+      return AZ_ERROR_UNEXPECTED_END;
+    }
 
-      out_response->response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_DESIRED_PROPERTIES;
-      out_response->request_id = AZ_SPAN_EMPTY;
-      out_response->status = AZ_IOT_STATUS_OK;
+    // Get request id prop value
+    az_iot_message_properties props;
+    az_span prop_span = az_span_slice(remainder, 1, az_span_size(remainder));
+    _az_RETURN_IF_FAILED(
+        az_iot_message_properties_init(&props, prop_span, az_span_size(prop_span)));
+    _az_RETURN_IF_FAILED(az_iot_message_properties_find(
+        &props, az_iot_hub_client_request_id_span, &out_response->request_id));
 
-      result = AZ_OK;
+    if (out_response->status == AZ_IOT_STATUS_NO_CONTENT)
+    {
+      // Is a reported prop response
+      out_response->response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_REPORTED_PROPERTIES;
+      _az_RETURN_IF_FAILED(az_iot_message_properties_find(
+          &props, az_iot_hub_twin_version_prop, &out_response->version));
     }
     else
     {
-      result = AZ_ERROR_IOT_TOPIC_NO_MATCH;
+      // Is a twin GET response
+      out_response->response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_GET;
+      out_response->version = AZ_SPAN_EMPTY;
     }
+
+    return AZ_OK;
   }
-  else
+
+  if (_az_span_starts_with(topic_suffix, az_iot_hub_twin_patch_sub_topic))
+  {
+    // Is a /PATCH case (desired props)
+    int32_t const properties_index = az_span_size(az_iot_hub_twin_patch_sub_topic)
+        + (int32_t)sizeof(az_iot_hub_client_twin_question);
+    if (az_span_size(topic_suffix) < properties_index)
+    {
+      return AZ_ERROR_UNEXPECTED_END;
+    }
+
+    az_iot_message_properties props;
+    az_span prop_span = az_span_slice(topic_suffix, properties_index, az_span_size(topic_suffix));
+    _az_RETURN_IF_FAILED(
+        az_iot_message_properties_init(&props, prop_span, az_span_size(prop_span)));
+    _az_RETURN_IF_FAILED(az_iot_message_properties_find(
+        &props, az_iot_hub_twin_version_prop, &out_response->version));
+
+    out_response->response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_DESIRED_PROPERTIES;
+    out_response->request_id = AZ_SPAN_EMPTY;
+    out_response->status = AZ_IOT_STATUS_OK;
+
+    return AZ_OK;
+  }
+
+  return AZ_ERROR_IOT_TOPIC_NO_MATCH;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_twin_parse_received_topic(
+    az_iot_hub_client const* client,
+    az_span received_topic,
+    az_iot_hub_client_twin_response* out_response)
+{
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION_VALID_SPAN(_az_iot_hub_client_get_hostname(client), 1, false);
+  _az_PRECONDITION_VALID_SPAN(received_topic, 1, false);
+  _az_PRECONDITION_NOT_NULL(out_response);
+  (void)client;
+
+  int32_t twin_index = az_span_find(received_topic, az_iot_hub_twin_topic_prefix);
+  // Check if is related to twin or not
+  if (twin_index < 0)
   {
-    result = AZ_ERROR_IOT_TOPIC_NO_MATCH;
+    return AZ_ERROR_IOT_TOPIC_NO_MATCH;
   }
 
-  return result;
+  _az_LOG_WRITE(AZ_LOG_MQTT_RECEIVED_TOPIC, received_topic);
+
+  return _az_iot_hub_client_twin_parse_topic_suffix(
+      az_span_slice_to_end(received_topic, twin_index + az_span_size(az_iot_hub_twin_topic_prefix)),
+      out_response);
 }
@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <azure/core/_az_cfg.h>
+
+static const az_span twin_desired_name = AZ_SPAN_LITERAL_FROM_STR("desired");
+static const az_span twin_version_name = AZ_SPAN_LITERAL_FROM_STR("$version");
+
+// Zero marks a property whose value hasn't been seen yet.
+static const uint32_t twin_desired_no_value = 0;
+
+// Computes a digest of the JSON text of the value the reader is positioned on, moving the reader to
+// the end of the value.
+AZ_NODISCARD static az_result _az_iot_hub_client_twin_desired_hash_value(
+    az_json_reader* ref_json_reader,
+    uint32_t* out_hash)
+{
+  az_json_token_kind const kind = ref_json_reader->token.kind;
+  uint8_t const* start = az_span_ptr(ref_json_reader->token.slice);
+  _az_RETURN_IF_FAILED(az_json_reader_skip_children(ref_json_reader));
+  uint8_t const* end
+      = az_span_ptr(ref_json_reader->token.slice) + az_span_size(ref_json_reader->token.slice);
+
+  // FNV-1a, seeded with the token kind so that "1" and 1 differ.
+  uint32_t hash = 2166136261u;
+  hash = (hash ^ (uint32_t)kind) * 16777619u;
+  for (uint8_t const* p = start; p < end; p++)
+  {
+    hash = (hash ^ *p) * 16777619u;
+  }
+
+  *out_hash = hash == twin_desired_no_value ? 1 : hash;
+  return AZ_OK;
+}
+
+// Finds the `$version` property of the desired properties object the reader is positioned on,
+// without moving the reader.
+AZ_NODISCARD static az_result _az_iot_hub_client_twin_desired_find_version(
+    az_json_reader const* json_reader,
+    int64_t* out_version)
+{
+  az_json_reader jr = *json_reader;
+  _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+
+  while (jr.token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    bool const is_version = az_json_token_is_text_equal(&jr.token, twin_version_name);
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+
+    if (is_version)
+    {
+      return az_json_token_get_int64(&jr.token, out_version);
+    }
+
+    _az_RETURN_IF_FAILED(az_json_reader_skip_children(&jr));
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+  }
+
+  return AZ_ERROR_ITEM_NOT_FOUND;
+}
+
+// Calls back for the tracked properties which changed, in the desired properties object the reader
+// is positioned on.
+AZ_NODISCARD static az_result _az_iot_hub_client_twin_desired_apply_properties(
+    az_iot_hub_client_twin_desired* twin,
+    az_json_reader* ref_json_reader,
+    int64_t version)
+{
+  _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+
+  while (ref_json_reader->token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    int32_t const index
+        = az_json_token_find_property_name(&ref_json_reader->token, twin->_internal.property_names);
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+
+    if (index < 0)
+    {
+      _az_RETURN_IF_FAILED(az_json_reader_skip_children(ref_json_reader));
+    }
+    else
+    {
+      az_json_reader property_value = *ref_json_reader;
+      uint32_t hash;
+      _az_RETURN_IF_FAILED(_az_iot_hub_client_twin_desired_hash_value(ref_json_reader, &hash));
+
+      if (hash != twin->_internal.value_hashes[index])
+      {
+        twin->_internal.value_hashes[index] = hash;
+        twin->_internal.callback(index, &property_value, version, twin->_internal.callback_context);
+      }
+    }
+
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_twin_desired_init(
+    az_iot_hub_client_twin_desired* twin,
+    az_json_property_name_table const* property_names,
+    uint32_t value_hashes[],
+    az_iot_hub_client_twin_desired_property_fn callback,
+    void* context)
+{
+  _az_PRECONDITION_NOT_NULL(twin);
+  _az_PRECONDITION_NOT_NULL(property_names);
+  _az_PRECONDITION_NOT_NULL(value_hashes);
+  _az_PRECONDITION_NOT_NULL(callback);
+
+  twin->_internal.property_names = property_names;
+  twin->_internal.value_hashes = value_hashes;
+  twin->_internal.callback = callback;
+  twin->_internal.callback_context = context;
+  twin->_internal.version = -1;
+
+  for (int32_t i = 0; i < property_names->_internal.size; i++)
+  {
+    value_hashes[i] = twin_desired_no_value;
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_twin_desired_apply(
+    az_iot_hub_client_twin_desired* twin,
+    az_iot_hub_client_twin_response const* response,
+    az_span payload)
+{
+  _az_PRECONDITION_NOT_NULL(twin);
+  _az_PRECONDITION_NOT_NULL(response);
+
+  az_json_reader jr;
+  int64_t version;
+
+  if (response->response_type == AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_GET)
+  {
+    if (!az_iot_status_succeeded(response->status))
+    {
+      return AZ_OK;
+    }
+
+    // The document holds the desired properties along with the reported ones.
+    _az_RETURN_IF_FAILED(az_json_reader_init(&jr, payload, NULL));
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+
+    while (true)
+    {
+      if (jr.token.kind != AZ_JSON_TOKEN_PROPERTY_NAME)
+      {
+        return AZ_ERROR_ITEM_NOT_FOUND;
+      }
+
+      bool const is_desired = az_json_token_is_text_equal(&jr.token, twin_desired_name);
+      _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+
+      if (is_desired)
+      {
+        break;
+      }
+
+      _az_RETURN_IF_FAILED(az_json_reader_skip_children(&jr));
+      _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+    }
+  }
+  else if (response->response_type == AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_DESIRED_PROPERTIES)
+  {
+    // The payload is the desired properties patch.
+    _az_RETURN_IF_FAILED(az_json_reader_init(&jr, payload, NULL));
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+  }
+  else
+  {
+    return AZ_OK;
+  }
+
+  if (jr.token.kind != AZ_JSON_TOKEN_BEGIN_OBJECT)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  // Notifications also carry the version in their topic, which saves looking for it.
+  if (az_span_size(response->version) == 0
+      || az_result_failed(az_span_atoi64(response->version, &version)))
+  {
+    _az_RETURN_IF_FAILED(_az_iot_hub_client_twin_desired_find_version(&jr, &version));
+  }
+
+  // Duplicate or out-of-order desired properties.
+  if (version <= twin->_internal.version)
+  {
+    return AZ_OK;
+  }
+
+  _az_RETURN_IF_FAILED(_az_iot_hub_client_twin_desired_apply_properties(twin, &jr, version));
+  twin->_internal.version = version;
+
+  return AZ_OK;
+}
@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <azure/core/_az_cfg.h>
+
+static const az_span component_marker_name = AZ_SPAN_LITERAL_FROM_STR("__t");
+static const az_span component_marker_value = AZ_SPAN_LITERAL_FROM_STR("c");
+
+AZ_NODISCARD az_result az_iot_hub_client_twin_reported_batch_init(
+    az_iot_hub_client_twin_reported_batch* batch,
+    az_iot_hub_client_twin_reported_property* properties,
+    int32_t properties_capacity,
+    az_span values_buffer,
+    int64_t max_delay)
+{
+  _az_PRECONDITION_NOT_NULL(batch);
+  _az_PRECONDITION_NOT_NULL(properties);
+  _az_PRECONDITION(properties_capacity > 0);
+  _az_PRECONDITION_VALID_SPAN(values_buffer, 1, false);
+  _az_PRECONDITION(max_delay >= 0);
+
+  batch->_internal.properties = properties;
+  batch->_internal.properties_capacity = properties_capacity;
+  batch->_internal.values_buffer = values_buffer;
+  batch->_internal.max_delay = max_delay;
+  az_iot_hub_client_twin_reported_batch_clear(batch);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_twin_reported_batch_append(
+    az_iot_hub_client_twin_reported_batch* batch,
+    az_span component_name,
+    az_span property_name,
+    az_span json_value,
+    int64_t now)
+{
+  _az_PRECONDITION_NOT_NULL(batch);
+  _az_PRECONDITION_VALID_SPAN(component_name, 0, true);
+  _az_PRECONDITION_VALID_SPAN(property_name, 1, false);
+  _az_PRECONDITION_VALID_SPAN(json_value, 1, false);
+
+  az_span remainder
+      = az_span_slice_to_end(batch->_internal.values_buffer, batch->_internal.values_written);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(json_value));
+
+  // An update of a pending property replaces its value. The space of the previous value is only
+  // reclaimed when the batch is cleared.
+  az_iot_hub_client_twin_reported_property* property = NULL;
+  for (int32_t i = 0; i < batch->_internal.properties_count; i++)
+  {
+    az_iot_hub_client_twin_reported_property* pending = &batch->_internal.properties[i];
+    if (az_span_is_content_equal(pending->_internal.property_name, property_name)
+        && az_span_is_content_equal(pending->_internal.component_name, component_name))
+    {
+      property = pending;
+      break;
+    }
+  }
+
+  if (property == NULL)
+  {
+    if (batch->_internal.properties_count == batch->_internal.properties_capacity)
+    {
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+
+    if (batch->_internal.properties_count == 0)
+    {
+      batch->_internal.first_update_time = now;
+    }
+
+    property = &batch->_internal.properties[batch->_internal.properties_count++];
+    property->_internal.component_name = component_name;
+    property->_internal.property_name = property_name;
+  }
+
+  az_span_copy(remainder, json_value);
+  property->_internal.value = az_span_slice(remainder, 0, az_span_size(json_value));
+  batch->_internal.values_written += az_span_size(json_value);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD bool az_iot_hub_client_twin_reported_batch_should_flush(
+    az_iot_hub_client_twin_reported_batch const* batch,
+    int64_t now)
+{
+  _az_PRECONDITION_NOT_NULL(batch);
+
+  return batch->_internal.properties_count > 0
+      && (batch->_internal.properties_count == batch->_internal.properties_capacity
+          || now - batch->_internal.first_update_time >= batch->_internal.max_delay);
+}
+
+AZ_NODISCARD az_result az_iot_hub_client_twin_reported_batch_get_payload(
+    az_iot_hub_client_twin_reported_batch const* batch,
+    az_span payload_buffer,
+    az_span* out_payload)
+{
+  _az_PRECONDITION_NOT_NULL(batch);
+  _az_PRECONDITION_VALID_SPAN(payload_buffer, 1, false);
+  _az_PRECONDITION_NOT_NULL(out_payload);
+
+  az_iot_hub_client_twin_reported_property const* properties = batch->_internal.properties;
+  int32_t const count = batch->_internal.properties_count;
+
+  az_json_writer jw;
+  _az_RETURN_IF_FAILED(az_json_writer_init(&jw, payload_buffer, NULL));
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(&jw));
+
+  for (int32_t i = 0; i < count; i++)
+  {
+    az_span const component_name = properties[i]._internal.component_name;
+
+    if (az_span_size(component_name) == 0)
+    {
+      _az_RETURN_IF_FAILED(
+          az_json_writer_append_property_name(&jw, properties[i]._internal.property_name));
+      _az_RETURN_IF_FAILED(az_json_writer_append_json_text(&jw, properties[i]._internal.value));
+      continue;
+    }
+
+    // The properties of a component are all written with its first one.
+    bool already_written = false;
+    for (int32_t j = 0; j < i; j++)
+    {
+      if (az_span_is_content_equal(properties[j]._internal.component_name, component_name))
+      {
+        already_written = true;
+        break;
+      }
+    }
+
+    if (already_written)
+    {
+      continue;
+    }
+
+    _az_RETURN_IF_FAILED(az_json_writer_append_property_name(&jw, component_name));
+    _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(&jw));
+    _az_RETURN_IF_FAILED(az_json_writer_append_property_name(&jw, component_marker_name));
+    _az_RETURN_IF_FAILED(az_json_writer_append_string(&jw, component_marker_value));
+
+    for (int32_t j = i; j < count; j++)
+    {
+      if (az_span_is_content_equal(properties[j]._internal.component_name, component_name))
+      {
+        _az_RETURN_IF_FAILED(
+            az_json_writer_append_property_name(&jw, properties[j]._internal.property_name));
+        _az_RETURN_IF_FAILED(az_json_writer_append_json_text(&jw, properties[j]._internal.value));
+      }
+    }
+
+    _az_RETURN_IF_FAILED(az_json_writer_append_end_object(&jw));
+  }
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_object(&jw));
+
+  *out_payload = az_json_writer_get_bytes_used_in_destination(&jw);
+  return AZ_OK;
+}
+
+void az_iot_hub_client_twin_reported_batch_clear(az_iot_hub_client_twin_reported_batch* batch)
+{
+  _az_PRECONDITION_NOT_NULL(batch);
+
+  batch->_internal.properties_count = 0;
+  batch->_internal.values_written = 0;
+  batch->_internal.first_update_time = 0;
+}
@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/iot/az_iot_common.h>
+
+#include <azure/core/_az_cfg.h>
+
+// Packet identifiers are handed out in sequence, skipping those whose slot is taken, so that a
+// message always lives in the slot given by the low bits of its packet identifier. As the capacity
+// divides 65536, this still holds when the packet identifiers wrap around.
+AZ_INLINE az_iot_inflight_publish* _az_iot_inflight_window_slot(
+    az_iot_inflight_window* window,
+    uint16_t packet_id)
+{
+  return &window->_internal.publishes[packet_id & (uint16_t)(window->_internal.capacity - 1)];
+}
+
+// Compares the order of two messages, allowing the sequence numbers to wrap around.
+AZ_INLINE bool _az_iot_inflight_window_is_before(uint32_t sequence, uint32_t other_sequence)
+{
+  return (int32_t)(sequence - other_sequence) < 0;
+}
+
+AZ_NODISCARD az_result az_iot_inflight_window_init(
+    az_iot_inflight_window* window,
+    az_iot_inflight_publish* publishes,
+    int32_t capacity,
+    int64_t timeout)
+{
+  _az_PRECONDITION_NOT_NULL(window);
+  _az_PRECONDITION_NOT_NULL(publishes);
+  _az_PRECONDITION(capacity > 0 && capacity <= 32768 && (capacity & (capacity - 1)) == 0);
+  _az_PRECONDITION(timeout > 0);
+
+  window->_internal.publishes = publishes;
+  window->_internal.timeout = timeout;
+  window->_internal.next_sequence = 0;
+  window->_internal.capacity = capacity;
+  window->_internal.count = 0;
+  window->_internal.next_packet_id = 1;
+
+  for (int32_t i = 0; i < capacity; i++)
+  {
+    publishes[i].packet_id = 0;
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_inflight_window_add(
+    az_iot_inflight_window* window,
+    void* context,
+    int64_t now,
+    uint16_t* out_packet_id)
+{
+  _az_PRECONDITION_NOT_NULL(window);
+  _az_PRECONDITION_NOT_NULL(out_packet_id);
+
+  if (window->_internal.count == window->_internal.capacity)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  // As the window isn't full, a free slot is found within capacity packet identifiers.
+  uint16_t packet_id = window->_internal.next_packet_id;
+  az_iot_inflight_publish* slot;
+  while (true)
+  {
+    // Zero isn't a valid packet identifier, and marks a free slot.
+    if (packet_id == 0)
+    {
+      packet_id++;
+    }
+
+    slot = _az_iot_inflight_window_slot(window, packet_id);
+    if (slot->packet_id == 0)
+    {
+      break;
+    }
+
+    packet_id++;
+  }
+
+  slot->context = context;
+  slot->deadline = now + window->_internal.timeout;
+  slot->sequence = window->_internal.next_sequence++;
+  slot->attempts = 1;
+  slot->packet_id = packet_id;
+
+  window->_internal.next_packet_id = (uint16_t)(packet_id + 1);
+  window->_internal.count++;
+
+  *out_packet_id = packet_id;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_inflight_window_acknowledge(
+    az_iot_inflight_window* window,
+    uint16_t packet_id,
+    az_iot_inflight_publish* out_publish)
+{
+  _az_PRECONDITION_NOT_NULL(window);
+
+  az_iot_inflight_publish* slot = _az_iot_inflight_window_slot(window, packet_id);
+  if (packet_id == 0 || slot->packet_id != packet_id)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  if (out_publish != NULL)
+  {
+    *out_publish = *slot;
+  }
+
+  slot->packet_id = 0;
+  window->_internal.count--;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_inflight_window_get_expired(
+    az_iot_inflight_window* window,
+    int64_t now,
+    az_iot_inflight_publish* out_publish)
+{
+  _az_PRECONDITION_NOT_NULL(window);
+  _az_PRECONDITION_NOT_NULL(out_publish);
+
+  az_iot_inflight_publish* earliest = NULL;
+  for (int32_t i = 0; i < window->_internal.capacity; i++)
+  {
+    az_iot_inflight_publish* slot = &window->_internal.publishes[i];
+    if (slot->packet_id != 0 && slot->deadline <= now
+        && (earliest == NULL
+            || _az_iot_inflight_window_is_before(slot->sequence, earliest->sequence)))
+    {
+      earliest = slot;
+    }
+  }
+
+  if (earliest == NULL)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  earliest->deadline = now + window->_internal.timeout;
+  earliest->attempts++;
+
+  *out_publish = *earliest;
+  return AZ_OK;
+}
+
+void az_iot_inflight_window_expire_all(az_iot_inflight_window* window)
+{
+  _az_PRECONDITION_NOT_NULL(window);
+
+  for (int32_t i = 0; i < window->_internal.capacity; i++)
+  {
+    window->_internal.publishes[i].deadline = INT64_MIN;
+  }
+}
+
+AZ_NODISCARD az_result az_iot_inflight_window_get_next_deadline(
+    az_iot_inflight_window const* window,
+    int64_t* out_deadline)
+{
+  _az_PRECONDITION_NOT_NULL(window);
+  _az_PRECONDITION_NOT_NULL(out_deadline);
+
+  if (window->_internal.count == 0)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  int64_t deadline = INT64_MAX;
+  for (int32_t i = 0; i < window->_internal.capacity; i++)
+  {
+    az_iot_inflight_publish const* slot = &window->_internal.publishes[i];
+    if (slot->packet_id != 0 && slot->deadline < deadline)
+    {
+      deadline = slot->deadline;
+    }
+  }
+
+  *out_deadline = deadline;
+  return AZ_OK;
+}
@@ -10,6 +10,7 @@
 #include <azure/core/internal/az_span_internal.h>
 #include <azure/iot/az_iot_common.h>
 #include <azure/iot/az_iot_provisioning_client.h>
+#include <azure/iot/internal/az_iot_common_internal.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -64,6 +65,7 @@ AZ_NODISCARD az_result az_iot_provisioning_client_init(
 
   client->_internal.options
       = options == NULL ? az_iot_provisioning_client_options_default() : *options;
+  client->_internal.sas_resource_uri = AZ_SPAN_EMPTY;
 
   return AZ_OK;
 }
@@ -76,8 +78,8 @@ AZ_NODISCARD az_result az_iot_provisioning_client_get_user_name(
     size_t* out_mqtt_user_name_length)
 {
   _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_NOT_NULL(mqtt_user_name);
-  _az_PRECONDITION(mqtt_user_name_size > 0);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(
+      mqtt_user_name, mqtt_user_name_size, out_mqtt_user_name_length);
 
   az_span provisioning_service_api_version
       = AZ_SPAN_LITERAL_FROM_STR("/api-version=" AZ_IOT_PROVISIONING_SERVICE_VERSION);
@@ -97,6 +99,8 @@ AZ_NODISCARD az_result az_iot_provisioning_client_get_user_name(
     required_length += az_span_size(user_agent_version_prefix) + az_span_size(*user_agent);
   }
 
+  _az_IOT_RETURN_IF_MEASURING(mqtt_user_name, required_length, out_mqtt_user_name_length);
+
   _az_RETURN_IF_NOT_ENOUGH_SIZE(
       mqtt_user_name_span, required_length + (int32_t)sizeof((uint8_t)'\0'));
 
@@ -129,13 +133,14 @@ AZ_NODISCARD az_result az_iot_provisioning_client_get_client_id(
     size_t* out_mqtt_client_id_length)
 {
   _az_PRECONDITION_NOT_NULL(client);
-  _az_PRECONDITION_NOT_NULL(mqtt_client_id);
-  _az_PRECONDITION(mqtt_client_id_size > 0);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(
+      mqtt_client_id, mqtt_client_id_size, out_mqtt_client_id_length);
 
   az_span mqtt_client_id_span
       = az_span_create((uint8_t*)mqtt_client_id, (int32_t)mqtt_client_id_size);
 
   int32_t required_length = az_span_size(client->_internal.registration_id);
+  _az_IOT_RETURN_IF_MEASURING(mqtt_client_id, required_length, out_mqtt_client_id_length);
 
   _az_RETURN_IF_NOT_ENOUGH_SIZE(
       mqtt_client_id_span, required_length + (int32_t)sizeof((uint8_t)'\0'));
@@ -162,14 +167,14 @@ AZ_NODISCARD az_result az_iot_provisioning_client_register_get_publish_topic(
 
   _az_PRECONDITION_NOT_NULL(client);
   _az_PRECONDITION_VALID_SPAN(client->_internal.global_device_endpoint, 1, false);
-  _az_PRECONDITION_NOT_NULL(mqtt_topic);
-  _az_PRECONDITION(mqtt_topic_size > 0);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(mqtt_topic, mqtt_topic_size, out_mqtt_topic_length);
 
   az_span mqtt_topic_span = az_span_create((uint8_t*)mqtt_topic, (int32_t)mqtt_topic_size);
   az_span str_dps_registrations = _az_iot_provisioning_get_str_dps_registrations();
 
   int32_t required_length
       = az_span_size(str_dps_registrations) + az_span_size(str_put_iotdps_register);
+  _az_IOT_RETURN_IF_MEASURING(mqtt_topic, required_length, out_mqtt_topic_length);
 
   _az_RETURN_IF_NOT_ENOUGH_SIZE(mqtt_topic_span, required_length + (int32_t)sizeof((uint8_t)'\0'));
 
@@ -197,8 +202,7 @@ AZ_NODISCARD az_result az_iot_provisioning_client_query_status_get_publish_topic
 
   _az_PRECONDITION_NOT_NULL(client);
   _az_PRECONDITION_VALID_SPAN(client->_internal.global_device_endpoint, 1, false);
-  _az_PRECONDITION_NOT_NULL(mqtt_topic);
-  _az_PRECONDITION(mqtt_topic_size > 0);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(mqtt_topic, mqtt_topic_size, out_mqtt_topic_length);
 
   _az_PRECONDITION_VALID_SPAN(operation_id, 1, false);
 
@@ -207,6 +211,7 @@ AZ_NODISCARD az_result az_iot_provisioning_client_query_status_get_publish_topic
 
   int32_t required_length = az_span_size(str_dps_registrations)
       + az_span_size(str_get_iotdps_get_operationstatus) + az_span_size(operation_id);
+  _az_IOT_RETURN_IF_MEASURING(mqtt_topic, required_length, out_mqtt_topic_length);
 
   _az_RETURN_IF_NOT_ENOUGH_SIZE(mqtt_topic_span, required_length + (int32_t)sizeof((uint8_t)'\0'));
 
@@ -255,20 +260,98 @@ https://docs.microsoft.com/en-us/rest/api/iot-dps/runtimeregistration/registerde
     "lastUpdatedDateTimeUtc":"2020-04-10T03:11:13.2096201Z",
     "etag":"IjYxMDA4ZDQ2LTAwMDAtMDEwMC0wMDAwLTVlOGZlM2QxMDAwMCI="}}
 */
-AZ_INLINE az_result _az_iot_provisioning_client_parse_payload_error_code(
+// The property names of a registration response and of its registrationState object, with their
+// hashes as computed by az_json_property_name_hash(), so that each name read is matched in one
+// lookup.
+enum
+{
+  _az_PROVISIONING_RESPONSE_OPERATION_ID,
+  _az_PROVISIONING_RESPONSE_STATUS,
+  _az_PROVISIONING_RESPONSE_REGISTRATION_STATE,
+  _az_PROVISIONING_RESPONSE_TRACKING_ID,
+  _az_PROVISIONING_RESPONSE_MESSAGE,
+  _az_PROVISIONING_RESPONSE_TIMESTAMP_UTC,
+  _az_PROVISIONING_RESPONSE_ERROR_CODE,
+  _az_PROVISIONING_RESPONSE_NAME_COUNT,
+};
+
+static az_span const response_names[_az_PROVISIONING_RESPONSE_NAME_COUNT] = {
+  AZ_SPAN_LITERAL_FROM_STR("operationId"),
+  AZ_SPAN_LITERAL_FROM_STR("status"),
+  AZ_SPAN_LITERAL_FROM_STR("registrationState"),
+  AZ_SPAN_LITERAL_FROM_STR("trackingId"),
+  AZ_SPAN_LITERAL_FROM_STR("message"),
+  AZ_SPAN_LITERAL_FROM_STR("timestampUtc"),
+  AZ_SPAN_LITERAL_FROM_STR("errorCode"),
+};
+
+static uint32_t const response_name_hashes[_az_PROVISIONING_RESPONSE_NAME_COUNT] = {
+  0x86E076BBU, 0xBA4B77EFU, 0xBA82E59DU, 0x2407A951U, 0x24F208E4U, 0x6DC7E433U, 0x7536DCB8U,
+};
+
+static az_json_property_name_table const response_name_table = {
+  ._internal = {
+    .names = response_names,
+    .hashes = response_name_hashes,
+    .size = _az_PROVISIONING_RESPONSE_NAME_COUNT,
+  },
+};
+
+enum
+{
+  _az_PROVISIONING_STATE_ASSIGNED_HUB,
+  _az_PROVISIONING_STATE_DEVICE_ID,
+  _az_PROVISIONING_STATE_ERROR_MESSAGE,
+  _az_PROVISIONING_STATE_LAST_UPDATED_DATE_TIME_UTC,
+  _az_PROVISIONING_STATE_ERROR_CODE,
+  _az_PROVISIONING_STATE_NAME_COUNT,
+};
+
+static az_span const registration_state_names[_az_PROVISIONING_STATE_NAME_COUNT] = {
+  AZ_SPAN_LITERAL_FROM_STR("assignedHub"),
+  AZ_SPAN_LITERAL_FROM_STR("deviceId"),
+  AZ_SPAN_LITERAL_FROM_STR("errorMessage"),
+  AZ_SPAN_LITERAL_FROM_STR("lastUpdatedDateTimeUtc"),
+  AZ_SPAN_LITERAL_FROM_STR("errorCode"),
+};
+
+static uint32_t const registration_state_name_hashes[_az_PROVISIONING_STATE_NAME_COUNT] = {
+  0xDDA181A4U, 0x7C291D9EU, 0x88288548U, 0xCB1406D9U, 0x7536DCB8U,
+};
+
+static az_json_property_name_table const registration_state_name_table = {
+  ._internal = {
+    .names = registration_state_names,
+    .hashes = registration_state_name_hashes,
+    .size = _az_PROVISIONING_STATE_NAME_COUNT,
+  },
+};
+
+// Moves the reader to the value of the current property, which must be a string.
+AZ_NODISCARD static az_result _az_iot_provisioning_client_parse_string_value(
     az_json_reader* jr,
-    az_iot_provisioning_client_registration_state* out_state)
+    az_span* out_value)
 {
-  if (az_json_token_is_text_equal(&jr->token, AZ_SPAN_FROM_STR("errorCode")))
+  _az_RETURN_IF_FAILED(az_json_reader_next_token(jr));
+  if (jr->token.kind != AZ_JSON_TOKEN_STRING)
   {
-    _az_RETURN_IF_FAILED(az_json_reader_next_token(jr));
-    _az_RETURN_IF_FAILED(az_json_token_get_uint32(&jr->token, &out_state->extended_error_code));
-    out_state->error_code = _az_iot_status_from_extended_status(out_state->extended_error_code);
-
-    return AZ_OK;
+    return AZ_ERROR_ITEM_NOT_FOUND;
   }
 
-  return AZ_ERROR_ITEM_NOT_FOUND;
+  *out_value = jr->token.slice;
+  return AZ_OK;
+}
+
+// Moves the reader to the value of the current errorCode property.
+AZ_INLINE az_result _az_iot_provisioning_client_parse_payload_error_code(
+    az_json_reader* jr,
+    az_iot_provisioning_client_registration_state* out_state)
+{
+  _az_RETURN_IF_FAILED(az_json_reader_next_token(jr));
+  _az_RETURN_IF_FAILED(az_json_token_get_uint32(&jr->token, &out_state->extended_error_code));
+  out_state->error_code = _az_iot_status_from_extended_status(out_state->extended_error_code);
+
+  return AZ_OK;
 }
 
 AZ_INLINE az_result _az_iot_provisioning_client_payload_registration_state_parse(
@@ -283,57 +366,36 @@ AZ_INLINE az_result _az_iot_provisioning_client_payload_registration_state_parse
   bool found_assigned_hub = false;
   bool found_device_id = false;
 
-  while ((!(found_device_id && found_assigned_hub))
-         && az_result_succeeded(az_json_reader_next_token(jr))
+  while (az_result_succeeded(az_json_reader_next_token(jr))
          && jr->token.kind != AZ_JSON_TOKEN_END_OBJECT)
   {
-    if (az_json_token_is_text_equal(&jr->token, AZ_SPAN_FROM_STR("assignedHub")))
-    {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(jr));
-      if (jr->token.kind != AZ_JSON_TOKEN_STRING)
-      {
-        return AZ_ERROR_ITEM_NOT_FOUND;
-      }
-      out_state->assigned_hub_hostname = jr->token.slice;
-      found_assigned_hub = true;
-    }
-    else if (az_json_token_is_text_equal(&jr->token, AZ_SPAN_FROM_STR("deviceId")))
-    {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(jr));
-      if (jr->token.kind != AZ_JSON_TOKEN_STRING)
-      {
-        return AZ_ERROR_ITEM_NOT_FOUND;
-      }
-      out_state->device_id = jr->token.slice;
-      found_device_id = true;
-    }
-    else if (az_json_token_is_text_equal(&jr->token, AZ_SPAN_FROM_STR("errorMessage")))
-    {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(jr));
-      if (jr->token.kind != AZ_JSON_TOKEN_STRING)
-      {
-        return AZ_ERROR_ITEM_NOT_FOUND;
-      }
-      out_state->error_message = jr->token.slice;
-    }
-    else if (az_json_token_is_text_equal(&jr->token, AZ_SPAN_FROM_STR("lastUpdatedDateTimeUtc")))
-    {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(jr));
-      if (jr->token.kind != AZ_JSON_TOKEN_STRING)
-      {
-        return AZ_ERROR_ITEM_NOT_FOUND;
-      }
-      out_state->error_timestamp = jr->token.slice;
-    }
-    else if (az_result_succeeded(
-                 _az_iot_provisioning_client_parse_payload_error_code(jr, out_state)))
-    {
-      // Do nothing
-    }
-    else
+    switch (az_json_token_find_property_name(&jr->token, &registration_state_name_table))
     {
-      // ignore other tokens
-      _az_RETURN_IF_FAILED(az_json_reader_skip_children(jr));
+      case _az_PROVISIONING_STATE_ASSIGNED_HUB:
+        _az_RETURN_IF_FAILED(
+            _az_iot_provisioning_client_parse_string_value(jr, &out_state->assigned_hub_hostname));
+        found_assigned_hub = true;
+        break;
+      case _az_PROVISIONING_STATE_DEVICE_ID:
+        _az_RETURN_IF_FAILED(
+            _az_iot_provisioning_client_parse_string_value(jr, &out_state->device_id));
+        found_device_id = true;
+        break;
+      case _az_PROVISIONING_STATE_ERROR_MESSAGE:
+        _az_RETURN_IF_FAILED(
+            _az_iot_provisioning_client_parse_string_value(jr, &out_state->error_message));
+        break;
+      case _az_PROVISIONING_STATE_LAST_UPDATED_DATE_TIME_UTC:
+        _az_RETURN_IF_FAILED(
+            _az_iot_provisioning_client_parse_string_value(jr, &out_state->error_timestamp));
+        break;
+      case _az_PROVISIONING_STATE_ERROR_CODE:
+        _az_RETURN_IF_FAILED(_az_iot_provisioning_client_parse_payload_error_code(jr, out_state));
+        break;
+      default:
+        // ignore other properties, along with all of their children
+        _az_RETURN_IF_FAILED(az_json_reader_skip_children(jr));
+        break;
     }
   }
 
@@ -384,6 +446,12 @@ AZ_INLINE az_result az_iot_provisioning_client_parse_payload(
     az_span received_payload,
     az_iot_provisioning_client_register_response* out_response)
 {
+  // An empty payload isn't a JSON object.
+  if (az_span_size(received_payload) == 0)
+  {
+    return AZ_ERROR_UNEXPECTED_END;
+  }
+
   // Parse the payload:
   az_json_reader jr;
   _az_RETURN_IF_FAILED(az_json_reader_init(&jr, received_payload, NULL));
@@ -403,70 +471,47 @@ AZ_INLINE az_result az_iot_provisioning_client_parse_payload(
   while (az_result_succeeded(az_json_reader_next_token(&jr))
          && jr.token.kind != AZ_JSON_TOKEN_END_OBJECT)
   {
-    if (az_json_token_is_text_equal(&jr.token, AZ_SPAN_FROM_STR("operationId")))
-    {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-      if (jr.token.kind != AZ_JSON_TOKEN_STRING)
-      {
-        return AZ_ERROR_ITEM_NOT_FOUND;
-      }
-      out_response->operation_id = jr.token.slice;
-      found_operation_id = true;
-    }
-    else if (az_json_token_is_text_equal(&jr.token, AZ_SPAN_FROM_STR("status")))
-    {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-      if (jr.token.kind != AZ_JSON_TOKEN_STRING)
-      {
-        return AZ_ERROR_ITEM_NOT_FOUND;
-      }
-      _az_RETURN_IF_FAILED(_az_iot_provisioning_client_parse_operation_status(
-          jr.token.slice, &out_response->operation_status));
-
-      found_operation_status = true;
-    }
-    else if (az_json_token_is_text_equal(&jr.token, AZ_SPAN_FROM_STR("registrationState")))
-    {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-      _az_RETURN_IF_FAILED(_az_iot_provisioning_client_payload_registration_state_parse(
-          &jr, &out_response->registration_state));
-    }
-    else if (az_json_token_is_text_equal(&jr.token, AZ_SPAN_FROM_STR("trackingId")))
-    {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-      if (jr.token.kind != AZ_JSON_TOKEN_STRING)
-      {
-        return AZ_ERROR_ITEM_NOT_FOUND;
-      }
-      out_response->registration_state.error_tracking_id = jr.token.slice;
-    }
-    else if (az_json_token_is_text_equal(&jr.token, AZ_SPAN_FROM_STR("message")))
-    {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-      if (jr.token.kind != AZ_JSON_TOKEN_STRING)
-      {
-        return AZ_ERROR_ITEM_NOT_FOUND;
-      }
-      out_response->registration_state.error_message = jr.token.slice;
-    }
-    else if (az_json_token_is_text_equal(&jr.token, AZ_SPAN_FROM_STR("timestampUtc")))
-    {
-      _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-      if (jr.token.kind != AZ_JSON_TOKEN_STRING)
-      {
-        return AZ_ERROR_ITEM_NOT_FOUND;
-      }
-      out_response->registration_state.error_timestamp = jr.token.slice;
-    }
-    else if (az_result_succeeded(_az_iot_provisioning_client_parse_payload_error_code(
-                 &jr, &out_response->registration_state)))
-    {
-      found_error = true;
-    }
-    else
+    az_iot_provisioning_client_registration_state* const state = &out_response->registration_state;
+    az_span status = AZ_SPAN_EMPTY;
+
+    switch (az_json_token_find_property_name(&jr.token, &response_name_table))
     {
-      // ignore other tokens
-      _az_RETURN_IF_FAILED(az_json_reader_skip_children(&jr));
+      case _az_PROVISIONING_RESPONSE_OPERATION_ID:
+        _az_RETURN_IF_FAILED(
+            _az_iot_provisioning_client_parse_string_value(&jr, &out_response->operation_id));
+        found_operation_id = true;
+        break;
+      case _az_PROVISIONING_RESPONSE_STATUS:
+        _az_RETURN_IF_FAILED(_az_iot_provisioning_client_parse_string_value(&jr, &status));
+        _az_RETURN_IF_FAILED(_az_iot_provisioning_client_parse_operation_status(
+            status, &out_response->operation_status));
+        found_operation_status = true;
+        break;
+      case _az_PROVISIONING_RESPONSE_REGISTRATION_STATE:
+        _az_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
+        _az_RETURN_IF_FAILED(
+            _az_iot_provisioning_client_payload_registration_state_parse(&jr, state));
+        break;
+      case _az_PROVISIONING_RESPONSE_TRACKING_ID:
+        _az_RETURN_IF_FAILED(
+            _az_iot_provisioning_client_parse_string_value(&jr, &state->error_tracking_id));
+        break;
+      case _az_PROVISIONING_RESPONSE_MESSAGE:
+        _az_RETURN_IF_FAILED(
+            _az_iot_provisioning_client_parse_string_value(&jr, &state->error_message));
+        break;
+      case _az_PROVISIONING_RESPONSE_TIMESTAMP_UTC:
+        _az_RETURN_IF_FAILED(
+            _az_iot_provisioning_client_parse_string_value(&jr, &state->error_timestamp));
+        break;
+      case _az_PROVISIONING_RESPONSE_ERROR_CODE:
+        _az_RETURN_IF_FAILED(_az_iot_provisioning_client_parse_payload_error_code(&jr, state));
+        found_error = true;
+        break;
+      default:
+        // ignore other properties, along with all of their children
+        _az_RETURN_IF_FAILED(az_json_reader_skip_children(&jr));
+        break;
     }
   }
 
@@ -537,6 +582,11 @@ AZ_NODISCARD az_result az_iot_provisioning_client_parse_received_topic_and_paylo
 
   int32_t index = 0;
   az_span int_slice = _az_span_token(remainder, AZ_SPAN_FROM_STR("/"), &remainder, &index);
+  if (az_span_size(int_slice) == 0)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
   _az_RETURN_IF_FAILED(az_span_atou32(int_slice, (uint32_t*)(&out_response->status)));
 
   // Parse the optional retry-after= field.
@@ -546,6 +596,10 @@ AZ_NODISCARD az_result az_iot_provisioning_client_parse_received_topic_and_paylo
   {
     remainder = az_span_slice_to_end(remainder, idx + az_span_size(retry_after));
     int_slice = _az_span_token(remainder, AZ_SPAN_FROM_STR("&"), &remainder, &index);
+    if (az_span_size(int_slice) == 0)
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
 
     _az_RETURN_IF_FAILED(az_span_atou32(int_slice, &out_response->retry_after_seconds));
   }
@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+#include <azure/iot/az_iot_provisioning_client.h>
+
+#include <azure/core/_az_cfg.h>
+
+/*
+Cached state layout, with every integer little-endian:
+
+  version           1 byte
+  expiration        8 bytes, signed
+  identity          4 bytes, CRC-32 of the ID scope, '/' and the registration ID
+  hub hostname      2 bytes of length, followed by the bytes
+  device ID         2 bytes of length, followed by the bytes
+  CRC-32            4 bytes, of all the preceding bytes
+*/
+#define _az_IOT_PROVISIONING_CACHE_VERSION 1
+#define _az_IOT_PROVISIONING_CACHE_HEADER_SIZE (1 + 8 + 4)
+#define _az_IOT_PROVISIONING_CACHE_CRC_SIZE 4
+
+static uint32_t _az_iot_provisioning_client_get_identity(az_iot_provisioning_client const* client)
+{
+  uint32_t crc = _az_span_crc32(0, client->_internal.id_scope);
+  crc = _az_span_crc32(crc, AZ_SPAN_FROM_STR("/"));
+  return _az_span_crc32(crc, client->_internal.registration_id);
+}
+
+static az_span
+_az_iot_provisioning_cache_write_uint(az_span destination, uint64_t value, int32_t size)
+{
+  for (int32_t i = 0; i < size; i++)
+  {
+    destination = az_span_copy_u8(destination, (uint8_t)(value >> (8 * i)));
+  }
+  return destination;
+}
+
+static uint64_t _az_iot_provisioning_cache_read_uint(az_span* ref_source, int32_t size)
+{
+  uint8_t const* const ptr = az_span_ptr(*ref_source);
+  uint64_t value = 0;
+  for (int32_t i = 0; i < size; i++)
+  {
+    value |= (uint64_t)ptr[i] << (8 * i);
+  }
+
+  *ref_source = az_span_slice_to_end(*ref_source, size);
+  return value;
+}
+
+// Reads a length-prefixed string, returning false if it overruns the source.
+static bool _az_iot_provisioning_cache_read_string(az_span* ref_source, az_span* out_value)
+{
+  if (az_span_size(*ref_source) < 2)
+  {
+    return false;
+  }
+
+  int32_t const size = (int32_t)_az_iot_provisioning_cache_read_uint(ref_source, 2);
+  if (az_span_size(*ref_source) < size)
+  {
+    return false;
+  }
+
+  *out_value = az_span_slice(*ref_source, 0, size);
+  *ref_source = az_span_slice_to_end(*ref_source, size);
+  return true;
+}
+
+AZ_NODISCARD az_result az_iot_provisioning_client_registration_state_serialize(
+    az_iot_provisioning_client const* client,
+    az_iot_provisioning_client_registration_state const* state,
+    int64_t expiration,
+    az_span destination,
+    az_span* out_cached_state)
+{
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION_NOT_NULL(state);
+  _az_PRECONDITION_VALID_SPAN(state->assigned_hub_hostname, 1, false);
+  _az_PRECONDITION_VALID_SPAN(state->device_id, 1, false);
+  _az_PRECONDITION(az_span_size(state->assigned_hub_hostname) <= UINT16_MAX);
+  _az_PRECONDITION(az_span_size(state->device_id) <= UINT16_MAX);
+  _az_PRECONDITION_VALID_SPAN(destination, 0, false);
+  _az_PRECONDITION_NOT_NULL(out_cached_state);
+
+  int32_t const hub_size = az_span_size(state->assigned_hub_hostname);
+  int32_t const device_id_size = az_span_size(state->device_id);
+  int32_t const required_size = _az_IOT_PROVISIONING_CACHE_HEADER_SIZE + 2 + hub_size + 2
+      + device_id_size + _az_IOT_PROVISIONING_CACHE_CRC_SIZE;
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, required_size);
+
+  az_span remainder = az_span_copy_u8(destination, _az_IOT_PROVISIONING_CACHE_VERSION);
+  remainder = _az_iot_provisioning_cache_write_uint(remainder, (uint64_t)expiration, 8);
+  remainder = _az_iot_provisioning_cache_write_uint(
+      remainder, _az_iot_provisioning_client_get_identity(client), 4);
+  remainder = _az_iot_provisioning_cache_write_uint(remainder, (uint64_t)hub_size, 2);
+  remainder = az_span_copy(remainder, state->assigned_hub_hostname);
+  remainder = _az_iot_provisioning_cache_write_uint(remainder, (uint64_t)device_id_size, 2);
+  remainder = az_span_copy(remainder, state->device_id);
+
+  uint32_t const crc = _az_span_crc32(
+      0, az_span_slice(destination, 0, required_size - _az_IOT_PROVISIONING_CACHE_CRC_SIZE));
+  _az_iot_provisioning_cache_write_uint(remainder, crc, _az_IOT_PROVISIONING_CACHE_CRC_SIZE);
+
+  *out_cached_state = az_span_slice(destination, 0, required_size);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_provisioning_client_registration_state_deserialize(
+    az_iot_provisioning_client const* client,
+    az_span cached_state,
+    int64_t now,
+    az_iot_provisioning_client_registration_state* out_state)
+{
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION_VALID_SPAN(cached_state, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_state);
+
+  int32_t const size = az_span_size(cached_state);
+  if (size < _az_IOT_PROVISIONING_CACHE_HEADER_SIZE + _az_IOT_PROVISIONING_CACHE_CRC_SIZE)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  // Check the CRC first, so that nothing is read from a corrupted cache.
+  az_span content = az_span_slice(cached_state, 0, size - _az_IOT_PROVISIONING_CACHE_CRC_SIZE);
+  az_span crc_span
+      = az_span_slice_to_end(cached_state, size - _az_IOT_PROVISIONING_CACHE_CRC_SIZE);
+  if (_az_iot_provisioning_cache_read_uint(&crc_span, _az_IOT_PROVISIONING_CACHE_CRC_SIZE)
+      != _az_span_crc32(0, content))
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  if (_az_iot_provisioning_cache_read_uint(&content, 1) != _az_IOT_PROVISIONING_CACHE_VERSION)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  int64_t const expiration = (int64_t)_az_iot_provisioning_cache_read_uint(&content, 8);
+  uint32_t const identity = (uint32_t)_az_iot_provisioning_cache_read_uint(&content, 4);
+  if (now > expiration || identity != _az_iot_provisioning_client_get_identity(client))
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  az_span hub_hostname;
+  az_span device_id;
+  if (!_az_iot_provisioning_cache_read_string(&content, &hub_hostname)
+      || !_az_iot_provisioning_cache_read_string(&content, &device_id)
+      || az_span_size(hub_hostname) == 0 || az_span_size(device_id) == 0
+      || az_span_size(content) != 0)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  // As parsed from an assigned registration state, which has no error code.
+  out_state->assigned_hub_hostname = hub_hostname;
+  out_state->device_id = device_id;
+  out_state->error_code = AZ_IOT_STATUS_UNKNOWN;
+  out_state->extended_error_code = 0;
+  out_state->error_message = AZ_SPAN_EMPTY;
+  out_state->error_tracking_id = AZ_SPAN_EMPTY;
+  out_state->error_timestamp = AZ_SPAN_EMPTY;
+
+  return AZ_OK;
+}
@@ -30,6 +30,96 @@ static const az_span sig_string = AZ_SPAN_LITERAL_FROM_STR(SAS_TOKEN_SIG);
 static const az_span skn_string = AZ_SPAN_LITERAL_FROM_STR(SAS_TOKEN_SKN);
 static const az_span se_string = AZ_SPAN_LITERAL_FROM_STR(SAS_TOKEN_SE);
 
+// URL-encodes the resource URI of the SAS tokens.
+AZ_NODISCARD static az_result _az_iot_provisioning_client_sas_encode_resource_uri(
+    az_iot_provisioning_client const* client,
+    az_span destination,
+    az_span* out_remainder)
+{
+  az_span remainder = destination;
+
+  _az_RETURN_IF_FAILED(_az_span_copy_url_encode(remainder, client->_internal.id_scope, &remainder));
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(resources_string));
+  remainder = az_span_copy(remainder, resources_string);
+
+  _az_RETURN_IF_FAILED(
+      _az_span_copy_url_encode(remainder, client->_internal.registration_id, &remainder));
+
+  *out_remainder = remainder;
+  return AZ_OK;
+}
+
+// Gets the length of the password az_iot_provisioning_client_sas_get_password() writes.
+AZ_NODISCARD static int32_t _az_iot_provisioning_client_sas_get_password_length(
+    az_iot_provisioning_client const* client,
+    az_span base64_hmac_sha256_signature,
+    uint64_t token_expiration_epoch_time,
+    az_span key_name)
+{
+  int32_t length = az_span_size(sr_string) + 1 /* EQUAL_SIGN */ + 1 /* AMPERSAND */
+      + az_span_size(sig_string) + 1 /* EQUAL_SIGN */
+      + _az_span_url_encode_calc_length(base64_hmac_sha256_signature) + 1 /* AMPERSAND */
+      + az_span_size(se_string) + 1 /* EQUAL_SIGN */
+      + _az_iot_u64toa_size(token_expiration_epoch_time);
+
+  if (az_span_size(client->_internal.sas_resource_uri) > 0)
+  {
+    length += az_span_size(client->_internal.sas_resource_uri);
+  }
+  else
+  {
+    length += _az_span_url_encode_calc_length(client->_internal.id_scope)
+        + az_span_size(resources_string)
+        + _az_span_url_encode_calc_length(client->_internal.registration_id);
+  }
+
+  if (az_span_size(key_name) > 0)
+  {
+    length += 1 /* AMPERSAND */ + az_span_size(skn_string) + 1 /* EQUAL_SIGN */
+        + az_span_size(key_name);
+  }
+
+  return length;
+}
+
+// Copies the resource URI cached by az_iot_provisioning_client_sas_cache_resource_uri(), if any, or
+// encodes it.
+AZ_NODISCARD static az_result _az_iot_provisioning_client_sas_copy_resource_uri(
+    az_iot_provisioning_client const* client,
+    az_span destination,
+    az_span* out_remainder)
+{
+  az_span const resource_uri = client->_internal.sas_resource_uri;
+  if (az_span_size(resource_uri) == 0)
+  {
+    return _az_iot_provisioning_client_sas_encode_resource_uri(client, destination, out_remainder);
+  }
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, az_span_size(resource_uri));
+  *out_remainder = az_span_copy(destination, resource_uri);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_provisioning_client_sas_cache_resource_uri(
+    az_iot_provisioning_client* client,
+    az_span resource_uri_buffer)
+{
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION_VALID_SPAN(resource_uri_buffer, 1, false);
+
+  // Keep encoding for every token if the buffer is too small.
+  client->_internal.sas_resource_uri = AZ_SPAN_EMPTY;
+
+  az_span remainder = AZ_SPAN_EMPTY;
+  _az_RETURN_IF_FAILED(
+      _az_iot_provisioning_client_sas_encode_resource_uri(client, resource_uri_buffer, &remainder));
+
+  client->_internal.sas_resource_uri
+      = az_span_slice(resource_uri_buffer, 0, _az_span_diff(remainder, resource_uri_buffer));
+  return AZ_OK;
+}
+
 AZ_NODISCARD az_result az_iot_provisioning_client_sas_get_signature(
     az_iot_provisioning_client const* client,
     uint64_t token_expiration_epoch_time,
@@ -49,13 +139,8 @@ AZ_NODISCARD az_result az_iot_provisioning_client_sas_get_signature(
   az_span remainder = signature;
   int32_t signature_size = az_span_size(signature);
 
-  _az_RETURN_IF_FAILED(_az_span_copy_url_encode(remainder, client->_internal.id_scope, &remainder));
-
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, az_span_size(resources_string));
-  remainder = az_span_copy(remainder, resources_string);
-
   _az_RETURN_IF_FAILED(
-      _az_span_copy_url_encode(remainder, client->_internal.registration_id, &remainder));
+      _az_iot_provisioning_client_sas_copy_resource_uri(client, remainder, &remainder));
 
   _az_RETURN_IF_NOT_ENOUGH_SIZE(remainder, 1 /* LF */);
   remainder = az_span_copy_u8(remainder, LF);
@@ -80,8 +165,14 @@ AZ_NODISCARD az_result az_iot_provisioning_client_sas_get_password(
   _az_PRECONDITION_NOT_NULL(client);
   _az_PRECONDITION_VALID_SPAN(base64_hmac_sha256_signature, 1, false);
   _az_PRECONDITION(token_expiration_epoch_time > 0);
-  _az_PRECONDITION_NOT_NULL(mqtt_password);
-  _az_PRECONDITION(mqtt_password_size > 0);
+  _az_PRECONDITION_IOT_BUFFER_OR_MEASURE(
+      mqtt_password, mqtt_password_size, out_mqtt_password_length);
+
+  _az_IOT_RETURN_IF_MEASURING(
+      mqtt_password,
+      _az_iot_provisioning_client_sas_get_password_length(
+          client, base64_hmac_sha256_signature, token_expiration_epoch_time, key_name),
+      out_mqtt_password_length);
 
   // Concatenates:
   // "SharedAccessSignature sr=<url-encoded(resource-string)>&sig=<signature>&se=<expiration-time>"
@@ -98,14 +189,8 @@ AZ_NODISCARD az_result az_iot_provisioning_client_sas_get_password(
   mqtt_password_span = az_span_copy_u8(mqtt_password_span, EQUAL_SIGN);
 
   // Resource string
-  _az_RETURN_IF_FAILED(_az_span_copy_url_encode(
-      mqtt_password_span, client->_internal.id_scope, &mqtt_password_span));
-
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(mqtt_password_span, az_span_size(resources_string));
-  mqtt_password_span = az_span_copy(mqtt_password_span, resources_string);
-
-  _az_RETURN_IF_FAILED(_az_span_copy_url_encode(
-      mqtt_password_span, client->_internal.registration_id, &mqtt_password_span));
+  _az_RETURN_IF_FAILED(_az_iot_provisioning_client_sas_copy_resource_uri(
+      client, mqtt_password_span, &mqtt_password_span));
 
   // Signature
   _az_RETURN_IF_NOT_ENOUGH_SIZE(
@@ -0,0 +1,327 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/iot/az_iot_provisioning_client.h>
+
+#include <azure/core/_az_cfg.h>
+
+// The low bit of the state tells whether the request was published, and is awaiting a response
+// until the deadline. The other bits hold the action of the request.
+#define _az_IOT_PROVISIONING_REGISTRATION_AWAITING_RESPONSE 0x01
+#define _az_IOT_PROVISIONING_REGISTRATION_ACTION_SHIFT 1
+
+AZ_INLINE az_iot_provisioning_client_action
+_az_iot_provisioning_registration_get_action(az_iot_provisioning_client_registration const* reg)
+{
+  return (az_iot_provisioning_client_action)(
+      reg->_internal.state >> _az_IOT_PROVISIONING_REGISTRATION_ACTION_SHIFT);
+}
+
+AZ_INLINE void _az_iot_provisioning_registration_set_state(
+    az_iot_provisioning_client_registration* reg,
+    az_iot_provisioning_client_action action,
+    bool awaiting_response)
+{
+  reg->_internal.state = (uint8_t)(
+      ((uint8_t)action << _az_IOT_PROVISIONING_REGISTRATION_ACTION_SHIFT)
+      | (awaiting_response ? _az_IOT_PROVISIONING_REGISTRATION_AWAITING_RESPONSE : 0));
+}
+
+AZ_INLINE void _az_iot_provisioning_scheduler_place(
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* reg,
+    int32_t index)
+{
+  scheduler->_internal.heap[index] = reg;
+  reg->_internal.heap_index = index;
+}
+
+// Moves the registration at the given index up or down the heap, after its deadline changed.
+static void _az_iot_provisioning_scheduler_fix(
+    az_iot_provisioning_client_scheduler* scheduler,
+    int32_t index)
+{
+  az_iot_provisioning_client_registration** heap = scheduler->_internal.heap;
+  az_iot_provisioning_client_registration* reg = heap[index];
+  int64_t const deadline = reg->_internal.deadline;
+
+  while (index > 0)
+  {
+    int32_t const parent = (index - 1) / 2;
+    if (heap[parent]->_internal.deadline <= deadline)
+    {
+      break;
+    }
+
+    _az_iot_provisioning_scheduler_place(scheduler, heap[parent], index);
+    index = parent;
+  }
+
+  int32_t const count = scheduler->_internal.count;
+  while (true)
+  {
+    int32_t child = (2 * index) + 1;
+    if (child >= count)
+    {
+      break;
+    }
+
+    if (child + 1 < count && heap[child + 1]->_internal.deadline < heap[child]->_internal.deadline)
+    {
+      child++;
+    }
+
+    if (deadline <= heap[child]->_internal.deadline)
+    {
+      break;
+    }
+
+    _az_iot_provisioning_scheduler_place(scheduler, heap[child], index);
+    index = child;
+  }
+
+  _az_iot_provisioning_scheduler_place(scheduler, reg, index);
+}
+
+AZ_INLINE bool _az_iot_provisioning_scheduler_contains(
+    az_iot_provisioning_client_scheduler const* scheduler,
+    az_iot_provisioning_client_registration const* reg)
+{
+  int32_t const index = reg->_internal.heap_index;
+  return index >= 0 && index < scheduler->_internal.count
+      && scheduler->_internal.heap[index] == reg;
+}
+
+AZ_INLINE void _az_iot_provisioning_scheduler_reschedule(
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* reg,
+    int64_t deadline)
+{
+  reg->_internal.deadline = deadline;
+  _az_iot_provisioning_scheduler_fix(scheduler, reg->_internal.heap_index);
+}
+
+AZ_NODISCARD az_iot_provisioning_client_scheduler_options
+az_iot_provisioning_client_scheduler_options_default()
+{
+  return (az_iot_provisioning_client_scheduler_options){
+    .units_per_second = 1000,
+    .response_timeout = 30000,
+    .default_retry_after = 3000,
+  };
+}
+
+AZ_NODISCARD az_result az_iot_provisioning_client_registration_init(
+    az_iot_provisioning_client_registration* registration,
+    az_iot_provisioning_client const* client,
+    az_span operation_id_buffer,
+    void* context)
+{
+  _az_PRECONDITION_NOT_NULL(registration);
+  _az_PRECONDITION_NOT_NULL(client);
+  _az_PRECONDITION_VALID_SPAN(operation_id_buffer, 1, false);
+
+  registration->_internal.client = client;
+  registration->_internal.context = context;
+  registration->_internal.operation_id_buffer = operation_id_buffer;
+  registration->_internal.operation_id = AZ_SPAN_EMPTY;
+  registration->_internal.deadline = 0;
+  registration->_internal.heap_index = -1;
+  registration->_internal.attempts = 0;
+  registration->_internal.state = 0;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_init(
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* heap[],
+    int32_t capacity,
+    az_iot_provisioning_client_scheduler_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(scheduler);
+  _az_PRECONDITION_NOT_NULL(heap);
+  _az_PRECONDITION(capacity > 0);
+
+  scheduler->_internal.heap = heap;
+  scheduler->_internal.capacity = capacity;
+  scheduler->_internal.count = 0;
+  scheduler->_internal.options
+      = options == NULL ? az_iot_provisioning_client_scheduler_options_default() : *options;
+
+  _az_PRECONDITION(scheduler->_internal.options.units_per_second > 0);
+  _az_PRECONDITION(scheduler->_internal.options.response_timeout > 0);
+  _az_PRECONDITION(scheduler->_internal.options.default_retry_after >= 0);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_add(
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* registration,
+    int64_t now)
+{
+  _az_PRECONDITION_NOT_NULL(scheduler);
+  _az_PRECONDITION_NOT_NULL(registration);
+  _az_PRECONDITION(!_az_iot_provisioning_scheduler_contains(scheduler, registration));
+
+  if (scheduler->_internal.count == scheduler->_internal.capacity)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  registration->_internal.operation_id = AZ_SPAN_EMPTY;
+  registration->_internal.attempts = 0;
+  _az_iot_provisioning_registration_set_state(
+      registration, AZ_IOT_PROVISIONING_CLIENT_ACTION_REGISTER, false);
+
+  registration->_internal.heap_index = scheduler->_internal.count;
+  scheduler->_internal.heap[scheduler->_internal.count] = registration;
+  scheduler->_internal.count++;
+  _az_iot_provisioning_scheduler_reschedule(scheduler, registration, now);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_remove(
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* registration)
+{
+  _az_PRECONDITION_NOT_NULL(scheduler);
+  _az_PRECONDITION_NOT_NULL(registration);
+
+  if (!_az_iot_provisioning_scheduler_contains(scheduler, registration))
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  int32_t const index = registration->_internal.heap_index;
+  registration->_internal.heap_index = -1;
+  scheduler->_internal.count--;
+
+  // Fill the hole with the last registration, which may belong above or below it.
+  if (index < scheduler->_internal.count)
+  {
+    _az_iot_provisioning_scheduler_place(
+        scheduler, scheduler->_internal.heap[scheduler->_internal.count], index);
+    _az_iot_provisioning_scheduler_fix(scheduler, index);
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_get_next_deadline(
+    az_iot_provisioning_client_scheduler const* scheduler,
+    int64_t* out_deadline)
+{
+  _az_PRECONDITION_NOT_NULL(scheduler);
+  _az_PRECONDITION_NOT_NULL(out_deadline);
+
+  if (scheduler->_internal.count == 0)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  *out_deadline = scheduler->_internal.heap[0]->_internal.deadline;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_get_next(
+    az_iot_provisioning_client_scheduler* scheduler,
+    int64_t now,
+    az_iot_provisioning_client_registration** out_registration,
+    az_iot_provisioning_client_action* out_action)
+{
+  _az_PRECONDITION_NOT_NULL(scheduler);
+  _az_PRECONDITION_NOT_NULL(out_registration);
+  _az_PRECONDITION_NOT_NULL(out_action);
+
+  if (scheduler->_internal.count == 0 || scheduler->_internal.heap[0]->_internal.deadline > now)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  // Whether the request is due, or its response timed out, the same request is published.
+  az_iot_provisioning_client_registration* registration = scheduler->_internal.heap[0];
+  az_iot_provisioning_client_action const action
+      = _az_iot_provisioning_registration_get_action(registration);
+
+  registration->_internal.attempts++;
+  _az_iot_provisioning_registration_set_state(registration, action, true);
+  _az_iot_provisioning_scheduler_reschedule(
+      scheduler, registration, now + scheduler->_internal.options.response_timeout);
+
+  *out_registration = registration;
+  *out_action = action;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_iot_provisioning_client_scheduler_handle_response(
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* registration,
+    az_iot_provisioning_client_register_response const* response,
+    int64_t now,
+    bool* out_complete)
+{
+  _az_PRECONDITION_NOT_NULL(scheduler);
+  _az_PRECONDITION_NOT_NULL(registration);
+  _az_PRECONDITION_NOT_NULL(response);
+  _az_PRECONDITION_NOT_NULL(out_complete);
+
+  if (!_az_iot_provisioning_scheduler_contains(scheduler, registration))
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  *out_complete = false;
+
+  int64_t retry_after = response->retry_after_seconds == 0
+      ? scheduler->_internal.options.default_retry_after
+      : (int64_t)response->retry_after_seconds * scheduler->_internal.options.units_per_second;
+
+  // Throttled and server error responses carry a failed operation status, but the request is
+  // published again rather than completing the operation.
+  if (az_iot_status_retriable(response->status))
+  {
+    _az_iot_provisioning_registration_set_state(
+        registration, _az_iot_provisioning_registration_get_action(registration), false);
+    _az_iot_provisioning_scheduler_reschedule(scheduler, registration, now + retry_after);
+    return AZ_OK;
+  }
+
+  if (az_iot_provisioning_client_operation_complete(response->operation_status))
+  {
+    _az_RETURN_IF_FAILED(az_iot_provisioning_client_scheduler_remove(scheduler, registration));
+    *out_complete = true;
+    return AZ_OK;
+  }
+
+  // The operation is still in progress: keep its ID to query its status with.
+  if (az_span_size(response->operation_id) > 0)
+  {
+    if (az_span_size(response->operation_id)
+        > az_span_size(registration->_internal.operation_id_buffer))
+    {
+      _az_RETURN_IF_FAILED(az_iot_provisioning_client_scheduler_remove(scheduler, registration));
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+
+    az_span_copy(registration->_internal.operation_id_buffer, response->operation_id);
+    registration->_internal.operation_id = az_span_slice(
+        registration->_internal.operation_id_buffer, 0, az_span_size(response->operation_id));
+  }
+
+  registration->_internal.attempts = 0;
+  _az_iot_provisioning_registration_set_state(
+      registration, AZ_IOT_PROVISIONING_CLIENT_ACTION_QUERY_STATUS, false);
+  _az_iot_provisioning_scheduler_reschedule(scheduler, registration, now + retry_after);
+
+  return AZ_OK;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/iot/az_iot_common.h>
+
+#include <azure/core/_az_cfg.h>
+
+AZ_NODISCARD az_iot_publish_scheduler_options az_iot_publish_scheduler_options_default()
+{
+  return (az_iot_publish_scheduler_options){ .telemetry_latency_msec = 60000,
+                                             .reported_properties_latency_msec = 10000,
+                                             .twin_request_latency_msec = 0 };
+}
+
+AZ_NODISCARD az_result az_iot_publish_scheduler_init(
+    az_iot_publish_scheduler* scheduler,
+    az_iot_publish_scheduler_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(scheduler);
+
+  *scheduler = (az_iot_publish_scheduler){
+    ._internal = {
+      .options = options == NULL ? az_iot_publish_scheduler_options_default() : *options,
+      .deadline = INT64_MAX,
+      .pending_count = { 0 },
+    },
+  };
+
+  _az_PRECONDITION_RANGE(0, scheduler->_internal.options.telemetry_latency_msec, INT32_MAX - 1);
+  _az_PRECONDITION_RANGE(
+      0, scheduler->_internal.options.reported_properties_latency_msec, INT32_MAX - 1);
+  _az_PRECONDITION_RANGE(0, scheduler->_internal.options.twin_request_latency_msec, INT32_MAX - 1);
+
+  return AZ_OK;
+}
+
+void az_iot_publish_scheduler_add(
+    az_iot_publish_scheduler* scheduler,
+    az_iot_publish_class publish_class,
+    int64_t now_msec)
+{
+  _az_PRECONDITION_NOT_NULL(scheduler);
+  _az_PRECONDITION(
+      publish_class == AZ_IOT_PUBLISH_CLASS_TELEMETRY
+      || publish_class == AZ_IOT_PUBLISH_CLASS_REPORTED_PROPERTIES
+      || publish_class == AZ_IOT_PUBLISH_CLASS_TWIN_REQUEST);
+
+  int32_t latency_msec;
+  switch (publish_class)
+  {
+    case AZ_IOT_PUBLISH_CLASS_TELEMETRY:
+      latency_msec = scheduler->_internal.options.telemetry_latency_msec;
+      break;
+    case AZ_IOT_PUBLISH_CLASS_REPORTED_PROPERTIES:
+      latency_msec = scheduler->_internal.options.reported_properties_latency_msec;
+      break;
+    default:
+      latency_msec = scheduler->_internal.options.twin_request_latency_msec;
+      break;
+  }
+
+  // A message which can wait longer than the window already due joins it, so the window is only
+  // ever brought forward.
+  int64_t const deadline = now_msec + latency_msec;
+  if (deadline < scheduler->_internal.deadline)
+  {
+    scheduler->_internal.deadline = deadline;
+  }
+
+  scheduler->_internal.pending_count[publish_class]++;
+}
+
+void az_iot_publish_scheduler_complete_window(az_iot_publish_scheduler* scheduler)
+{
+  _az_PRECONDITION_NOT_NULL(scheduler);
+
+  scheduler->_internal.deadline = INT64_MAX;
+  scheduler->_internal.pending_count[AZ_IOT_PUBLISH_CLASS_TELEMETRY] = 0;
+  scheduler->_internal.pending_count[AZ_IOT_PUBLISH_CLASS_REPORTED_PROPERTIES] = 0;
+  scheduler->_internal.pending_count[AZ_IOT_PUBLISH_CLASS_TWIN_REQUEST] = 0;
+}
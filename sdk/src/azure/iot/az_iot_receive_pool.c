@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/iot/az_iot_common.h>
+
+#include <azure/core/_az_cfg.h>
+
+AZ_NODISCARD az_result az_iot_receive_pool_init(
+    az_iot_receive_pool* pool,
+    az_iot_receive_buffer buffers[],
+    int32_t buffer_count,
+    az_span storage)
+{
+  _az_PRECONDITION_NOT_NULL(pool);
+  _az_PRECONDITION_NOT_NULL(buffers);
+  _az_PRECONDITION(buffer_count > 0);
+  _az_PRECONDITION_VALID_SPAN(storage, buffer_count, false);
+
+  int32_t const buffer_size = az_span_size(storage) / buffer_count;
+  for (int32_t i = 0; i < buffer_count; i++)
+  {
+    buffers[i] = (az_iot_receive_buffer){
+      ._internal = {
+        .buffer = az_span_slice(storage, i * buffer_size, (i + 1) * buffer_size),
+        .topic = AZ_SPAN_EMPTY,
+        .payload = AZ_SPAN_EMPTY,
+        .reference_count = 0,
+      },
+    };
+  }
+
+  pool->_internal.buffers = buffers;
+  pool->_internal.buffer_count = buffer_count;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_iot_receive_pool_acquire(az_iot_receive_pool* pool, az_iot_receive_buffer** out_buffer)
+{
+  _az_PRECONDITION_NOT_NULL(pool);
+  _az_PRECONDITION_NOT_NULL(out_buffer);
+
+  for (int32_t i = 0; i < pool->_internal.buffer_count; i++)
+  {
+    az_iot_receive_buffer* const buffer = &pool->_internal.buffers[i];
+    if (buffer->_internal.reference_count == 0)
+    {
+      buffer->_internal.topic = AZ_SPAN_EMPTY;
+      buffer->_internal.payload = AZ_SPAN_EMPTY;
+      buffer->_internal.reference_count = 1;
+      *out_buffer = buffer;
+      return AZ_OK;
+    }
+  }
+
+  return AZ_ERROR_NOT_ENOUGH_SPACE;
+}
+
+void az_iot_receive_buffer_set_message(
+    az_iot_receive_buffer* buffer,
+    az_span topic,
+    az_span payload)
+{
+  _az_PRECONDITION_NOT_NULL(buffer);
+  _az_PRECONDITION(buffer->_internal.reference_count > 0);
+  _az_PRECONDITION(
+      az_span_ptr(topic) >= az_span_ptr(buffer->_internal.buffer)
+      && az_span_ptr(topic) + az_span_size(topic)
+          <= az_span_ptr(buffer->_internal.buffer) + az_span_size(buffer->_internal.buffer));
+  _az_PRECONDITION(
+      az_span_size(payload) == 0
+      || (az_span_ptr(payload) >= az_span_ptr(buffer->_internal.buffer)
+          && az_span_ptr(payload) + az_span_size(payload)
+              <= az_span_ptr(buffer->_internal.buffer) + az_span_size(buffer->_internal.buffer)));
+
+  buffer->_internal.topic = topic;
+  buffer->_internal.payload = payload;
+}
+
+AZ_NODISCARD int32_t az_iot_receive_pool_get_used_count(az_iot_receive_pool const* pool)
+{
+  _az_PRECONDITION_NOT_NULL(pool);
+
+  int32_t used_count = 0;
+  for (int32_t i = 0; i < pool->_internal.buffer_count; i++)
+  {
+    if (pool->_internal.buffers[i]._internal.reference_count > 0)
+    {
+      used_count++;
+    }
+  }
+
+  return used_count;
+}
@@ -3,20 +3,56 @@
 
 #include <azure/core/az_http.h>
 #include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
 #include <azure/core/az_span.h>
+#include <azure/core/internal/az_arena_internal.h>
+#include <azure/core/internal/az_http_internal.h>
 #include <azure/core/internal/az_result_internal.h>
 #include <azure/core/internal/az_span_internal.h>
 
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
 #include <curl/curl.h>
 
+#ifdef _az_CURL_MULTI_ENABLED
+#include "az_curl_multi_private.h"
+// Transfers are driven by the multi handle shared by all requests, which multiplexes them over
+// HTTP/2 connections.
+#define _az_http_client_curl_perform(ref_curl) _az_http_client_curl_multi_perform(ref_curl)
+#else
+#define _az_http_client_curl_perform(ref_curl) curl_easy_perform(ref_curl)
+#endif // _az_CURL_MULTI_ENABLED
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
 #include <azure/core/_az_cfg.h>
 
-static AZ_NODISCARD az_result _az_span_malloc(int32_t size, az_span* out)
+// Buffers come from the arena of the request, if it has one with enough space left, and from the
+// heap otherwise. Those from the arena are freed all at once, by rewinding it once the request was
+// sent.
+static AZ_NODISCARD az_result
+_az_span_malloc(az_http_request const* request, int32_t size, az_span* out)
 {
   _az_PRECONDITION_NOT_NULL(out);
 
+  az_arena* const arena = request->_internal.arena;
+  if (arena != NULL && az_result_succeeded(az_arena_allocate(arena, size, out)))
+  {
+    return AZ_OK;
+  }
+
   uint8_t* const p = (uint8_t*)malloc((size_t)size);
   if (p == NULL)
   {
@@ -26,13 +62,18 @@ static AZ_NODISCARD az_result _az_span_malloc(int32_t size, az_span* out)
   return AZ_OK;
 }
 
-static void _az_span_free(az_span* p)
+static void _az_span_free(az_http_request const* request, az_span* p)
 {
   if (p == NULL)
   {
     return;
   }
-  free(az_span_ptr(*p));
+
+  az_arena const* const arena = request->_internal.arena;
+  if (arena == NULL || !_az_arena_contains(arena, az_span_ptr(*p)))
+  {
+    free(az_span_ptr(*p));
+  }
   *p = AZ_SPAN_EMPTY;
 }
 
@@ -62,9 +103,237 @@ static AZ_NODISCARD az_result _az_http_client_curl_code_to_result(CURLcode code)
 #define _az_RETURN_IF_CURL_FAILED(exp) \
   _az_RETURN_IF_FAILED(_az_http_client_curl_code_to_result(exp))
 
+#ifdef TRANSPORT_CURL_REUSE_CONNECTIONS
+// Each thread keeps the CURL handle of its last request, so that the connection cache of the handle
+// (along with its DNS and TLS session caches) is reused by the next request of that thread. The
+// handle is cleaned up when the thread exits.
+#ifdef _WIN32
+static INIT_ONCE _az_http_client_curl_handle_key_once = INIT_ONCE_STATIC_INIT;
+static DWORD _az_http_client_curl_handle_key = FLS_OUT_OF_INDEXES;
+
+static VOID WINAPI _az_http_client_curl_handle_cleanup(PVOID handle)
+{
+  if (handle != NULL)
+  {
+    curl_easy_cleanup((CURL*)handle);
+  }
+}
+
+static BOOL CALLBACK
+_az_http_client_curl_handle_key_init(PINIT_ONCE once, PVOID parameter, PVOID* context)
+{
+  (void)once;
+  (void)parameter;
+  (void)context;
+  _az_http_client_curl_handle_key = FlsAlloc(_az_http_client_curl_handle_cleanup);
+  return _az_http_client_curl_handle_key != FLS_OUT_OF_INDEXES;
+}
+
+static AZ_NODISCARD bool _az_http_client_curl_handle_key_ready(void)
+{
+  return InitOnceExecuteOnce(
+             &_az_http_client_curl_handle_key_once,
+             _az_http_client_curl_handle_key_init,
+             NULL,
+             NULL)
+      != FALSE;
+}
+
+static CURL* _az_http_client_curl_get_thread_handle(void)
+{
+  return (CURL*)FlsGetValue(_az_http_client_curl_handle_key);
+}
+
+static AZ_NODISCARD bool _az_http_client_curl_set_thread_handle(CURL* handle)
+{
+  return FlsSetValue(_az_http_client_curl_handle_key, (PVOID)handle) != FALSE;
+}
+#else
+static pthread_once_t _az_http_client_curl_handle_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t _az_http_client_curl_handle_key;
+static bool _az_http_client_curl_handle_key_created = false;
+
+// Only called for threads which stored a handle, since the stored value is never NULL.
+static void _az_http_client_curl_handle_cleanup(void* handle) { curl_easy_cleanup((CURL*)handle); }
+
+static void _az_http_client_curl_handle_key_init(void)
+{
+  _az_http_client_curl_handle_key_created
+      = pthread_key_create(&_az_http_client_curl_handle_key, _az_http_client_curl_handle_cleanup)
+      == 0;
+}
+
+static AZ_NODISCARD bool _az_http_client_curl_handle_key_ready(void)
+{
+  return pthread_once(&_az_http_client_curl_handle_key_once, _az_http_client_curl_handle_key_init)
+      == 0
+      && _az_http_client_curl_handle_key_created;
+}
+
+static CURL* _az_http_client_curl_get_thread_handle(void)
+{
+  return (CURL*)pthread_getspecific(_az_http_client_curl_handle_key);
+}
+
+static AZ_NODISCARD bool _az_http_client_curl_set_thread_handle(CURL* handle)
+{
+  return pthread_setspecific(_az_http_client_curl_handle_key, (void const*)handle) == 0;
+}
+#endif
+#endif // TRANSPORT_CURL_REUSE_CONNECTIONS
+
+#ifdef TRANSPORT_CURL_SHARE
+// All the CURL handles of the process use one share object, so that a host name resolved or a TLS
+// session negotiated by any pipeline or thread is reused by the others. The share object lives as
+// long as the process.
+static CURLSH* _az_http_client_curl_share = NULL;
+
+#ifdef _WIN32
+static INIT_ONCE _az_http_client_curl_share_once = INIT_ONCE_STATIC_INIT;
+static SRWLOCK _az_http_client_curl_share_locks[CURL_LOCK_DATA_LAST] = { SRWLOCK_INIT };
+
+static void _az_http_client_curl_share_lock(
+    CURL* handle,
+    curl_lock_data data,
+    curl_lock_access access,
+    void* user_context)
+{
+  (void)handle;
+  (void)access;
+  (void)user_context;
+  AcquireSRWLockExclusive(&_az_http_client_curl_share_locks[data]);
+}
+
+static void _az_http_client_curl_share_unlock(CURL* handle, curl_lock_data data, void* user_context)
+{
+  (void)handle;
+  (void)user_context;
+  ReleaseSRWLockExclusive(&_az_http_client_curl_share_locks[data]);
+}
+#else
+static pthread_once_t _az_http_client_curl_share_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t _az_http_client_curl_share_locks[CURL_LOCK_DATA_LAST];
+
+static void _az_http_client_curl_share_lock(
+    CURL* handle,
+    curl_lock_data data,
+    curl_lock_access access,
+    void* user_context)
+{
+  (void)handle;
+  (void)access;
+  (void)user_context;
+  (void)pthread_mutex_lock(&_az_http_client_curl_share_locks[data]);
+}
+
+static void _az_http_client_curl_share_unlock(CURL* handle, curl_lock_data data, void* user_context)
+{
+  (void)handle;
+  (void)user_context;
+  (void)pthread_mutex_unlock(&_az_http_client_curl_share_locks[data]);
+}
+#endif
+
+static void _az_http_client_curl_share_create(void)
+{
+#ifndef _WIN32
+  for (int32_t i = 0; i < (int32_t)CURL_LOCK_DATA_LAST; i++)
+  {
+    if (pthread_mutex_init(&_az_http_client_curl_share_locks[i], NULL) != 0)
+    {
+      return;
+    }
+  }
+#endif
+
+  CURLSH* const share = curl_share_init();
+  if (share == NULL)
+  {
+    return;
+  }
+
+  if (curl_share_setopt(share, CURLSHOPT_LOCKFUNC, _az_http_client_curl_share_lock) != CURLSHE_OK
+      || curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, _az_http_client_curl_share_unlock)
+          != CURLSHE_OK
+      || curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS) != CURLSHE_OK
+      || curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION) != CURLSHE_OK)
+  {
+    (void)curl_share_cleanup(share);
+    return;
+  }
+
+#if defined(TRANSPORT_CURL_SHARE_CONNECTIONS) && LIBCURL_VERSION_NUM >= 0x073900 // 7.57.0
+  // libcurl doesn't support a shared connection cache used by handles running concurrently in
+  // different threads, so this is only enabled for applications sending their requests from a
+  // single thread. Not sharing it still lets handles resume each other's TLS sessions.
+  (void)curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+
+  _az_http_client_curl_share = share;
+}
+
+#ifdef _WIN32
+static BOOL CALLBACK
+_az_http_client_curl_share_init(PINIT_ONCE once, PVOID parameter, PVOID* context)
+{
+  (void)once;
+  (void)parameter;
+  (void)context;
+  _az_http_client_curl_share_create();
+  return TRUE;
+}
+#endif
+
+/**
+ * @brief Makes \p ref_curl use the share object of the process. Options of the handle are cleared
+ * when it is reset, so this is done for every request.
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_setup_share(CURL* ref_curl)
+{
+#ifdef _WIN32
+  (void)InitOnceExecuteOnce(
+      &_az_http_client_curl_share_once, _az_http_client_curl_share_init, NULL, NULL);
+#else
+  (void)pthread_once(&_az_http_client_curl_share_once, _az_http_client_curl_share_create);
+#endif
+
+  // Without a share object, each handle still keeps its own caches.
+  if (_az_http_client_curl_share != NULL)
+  {
+    _az_RETURN_IF_CURL_FAILED(
+        curl_easy_setopt(ref_curl, CURLOPT_SHARE, _az_http_client_curl_share));
+  }
+
+  return AZ_OK;
+}
+#endif // TRANSPORT_CURL_SHARE
+
 AZ_NODISCARD AZ_INLINE az_result _az_http_client_curl_init(CURL** out)
 {
+#ifdef TRANSPORT_CURL_REUSE_CONNECTIONS
+  if (_az_http_client_curl_handle_key_ready())
+  {
+    CURL* const handle = _az_http_client_curl_get_thread_handle();
+    if (handle != NULL)
+    {
+      // The handle was already reset when the previous request of this thread was done.
+      *out = handle;
+#ifdef TRANSPORT_CURL_SHARE
+      return _az_http_client_curl_setup_share(handle);
+#else
+      return AZ_OK;
+#endif // TRANSPORT_CURL_SHARE
+    }
+  }
+#endif // TRANSPORT_CURL_REUSE_CONNECTIONS
+
   *out = curl_easy_init();
+#ifdef TRANSPORT_CURL_SHARE
+  if (*out != NULL)
+  {
+    return _az_http_client_curl_setup_share(*out);
+  }
+#endif // TRANSPORT_CURL_SHARE
   return AZ_OK;
 }
 
@@ -73,6 +342,21 @@ AZ_NODISCARD AZ_INLINE az_result _az_http_client_curl_done(CURL** pp)
   _az_PRECONDITION_NOT_NULL(pp);
   _az_PRECONDITION_NOT_NULL(*pp);
 
+#ifdef TRANSPORT_CURL_REUSE_CONNECTIONS
+  if (_az_http_client_curl_handle_key_ready())
+  {
+    // Reset all the options set for this request, which point into the request and response, but
+    // keep the open connections and caches of the handle for the next request.
+    curl_easy_reset(*pp);
+    if (_az_http_client_curl_get_thread_handle() == *pp
+        || _az_http_client_curl_set_thread_handle(*pp))
+    {
+      *pp = NULL;
+      return AZ_OK;
+    }
+  }
+#endif // TRANSPORT_CURL_REUSE_CONNECTIONS
+
   curl_easy_cleanup(*pp);
   *pp = NULL;
   return AZ_OK;
@@ -126,10 +410,12 @@ _az_http_client_curl_slist_append(struct curl_slist** ref_list, char const* str)
 }
 
 /**
- * @brief allocate a buffer for a header. Then reads the header name and value and writes a buffer.
- * Then uses that buffer to set curl header. Header is set only if write operations were OK. Buffer
- * can be reused after setting setting curl header.
+ * @brief writes a header into the scratch buffer of the request. Then uses that buffer to set curl
+ * header. Header is set only if write operations were OK. curl copies the header, so the buffer is
+ * reused for the next one.
  *
+ * @param scratch buffer large enough for any header of the request, see
+ * _az_http_client_curl_get_scratch_size()
  * @param header_name http header name
  * @param header_value http header value
  * @param ref_list list of headers as curl list
@@ -137,6 +423,7 @@ _az_http_client_curl_slist_append(struct curl_slist** ref_list, char const* str)
  * @return az_result
  */
 static AZ_NODISCARD az_result _az_http_client_curl_add_header_to_curl_list(
+    az_span scratch,
     az_span header_name,
     az_span header_value,
     struct curl_slist** ref_list,
@@ -144,29 +431,12 @@ static AZ_NODISCARD az_result _az_http_client_curl_add_header_to_curl_list(
 {
   _az_PRECONDITION_NOT_NULL(ref_list);
 
-  // allocate a buffer for header
-  az_span writable_buffer;
-  {
-    int32_t const buffer_size = az_span_size(header_name) + az_span_size(separator)
-        + az_span_size(header_value) + 1 /*one for 0 terminated*/;
-
-    _az_RETURN_IF_FAILED(_az_span_malloc(buffer_size, &writable_buffer));
-  }
-
   // write buffer
-  az_result result
-      = _az_span_append_header_to_buffer(writable_buffer, header_name, header_value, separator);
+  _az_RETURN_IF_FAILED(
+      _az_span_append_header_to_buffer(scratch, header_name, header_value, separator));
 
   // attach header only when write was OK
-  if (az_result_succeeded(result))
-  {
-    char const* const buffer = (char const*)az_span_ptr(writable_buffer);
-    result = _az_http_client_curl_slist_append(ref_list, buffer);
-  }
-
-  // at any case, error or OK, free the allocated memory
-  _az_span_free(&writable_buffer);
-  return result;
+  return _az_http_client_curl_slist_append(ref_list, (char const*)az_span_ptr(scratch));
 }
 
 /**
@@ -195,12 +465,21 @@ static AZ_NODISCARD az_result _az_http_client_curl_add_header_to_curl_list(
  *
  * @return az_result
  */
-static AZ_NODISCARD az_result
-_az_http_client_curl_add_expect_header(CURL* ref_curl, struct curl_slist** ref_list)
+static AZ_NODISCARD az_result _az_http_client_curl_add_expect_header(
+    CURL* ref_curl,
+    struct curl_slist** ref_list,
+    az_http_request const* request)
 {
   _az_PRECONDITION_NOT_NULL(ref_curl);
   _az_PRECONDITION_NOT_NULL(ref_list);
 
+  az_arena const* const arena = request->_internal.arena;
+  if (arena != NULL && *ref_list != NULL && _az_arena_contains(arena, *ref_list))
+  {
+    // Lists built in the arena already end with the header.
+    return AZ_OK;
+  }
+
   // Append header to current custom headers list
   _az_RETURN_IF_FAILED(_az_http_client_curl_slist_append(ref_list, "Expect:"));
   // Update the reference to curl custom list (in case it gets moved in memory due to appending)
@@ -212,11 +491,14 @@ _az_http_client_curl_add_expect_header(CURL* ref_curl, struct curl_slist** ref_l
  * @brief loop all the headers from a HTTP request and set each header into easy curl
  *
  * @param request an http builder request reference
+ * @param scratch buffer to write each header into
  * @param ref_headers list of headers in curl specific list
  * @return az_result
  */
-static AZ_NODISCARD az_result
-_az_http_client_curl_build_headers(az_http_request const* request, struct curl_slist** ref_headers)
+static AZ_NODISCARD az_result _az_http_client_curl_build_headers(
+    az_http_request const* request,
+    az_span scratch,
+    struct curl_slist** ref_headers)
 {
   _az_PRECONDITION_NOT_NULL(request);
 
@@ -226,12 +508,84 @@ _az_http_client_curl_build_headers(az_http_request const* request, struct curl_s
   {
     _az_RETURN_IF_FAILED(az_http_request_get_header(request, offset, &header_name, &header_value));
     _az_RETURN_IF_FAILED(_az_http_client_curl_add_header_to_curl_list(
-        header_name, header_value, ref_headers, AZ_SPAN_FROM_STR(":")));
+        scratch, header_name, header_value, ref_headers, AZ_SPAN_FROM_STR(":")));
+  }
+
+  return AZ_OK;
+}
+
+static az_span const _az_http_client_curl_expect_header = AZ_SPAN_LITERAL_FROM_STR("Expect:");
+
+/**
+ * @brief Builds the list of headers of a request in its arena, nodes included, so that neither
+ * the strings nor the nodes of the list come from the heap. libcurl never frees or modifies the
+ * list it is given, so it is enough for it to outlive the transfer.
+ *
+ * @param request an http request with an arena
+ * @param expect whether to end the list with the "Expect:" header
+ * @param ref_headers list of headers in curl specific list
+ * @return AZ_ERROR_NOT_ENOUGH_SPACE if the arena can't hold the whole list
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_build_headers_in_arena(
+    az_http_request const* request,
+    bool expect,
+    struct curl_slist** ref_headers)
+{
+  int32_t const headers_count = az_http_request_headers_count(request);
+  int32_t const nodes_count = headers_count + (expect ? 1 : 0);
+
+  // All the nodes, followed by all the zero-terminated strings.
+  int32_t size = nodes_count * (int32_t)sizeof(struct curl_slist);
+  az_span header_name = { 0 };
+  az_span header_value = { 0 };
+  for (int32_t offset = 0; offset < headers_count; ++offset)
+  {
+    _az_RETURN_IF_FAILED(az_http_request_get_header(request, offset, &header_name, &header_value));
+    size += az_span_size(header_name) + az_span_size(header_value) + 2;
+  }
+  size += expect ? az_span_size(_az_http_client_curl_expect_header) + 1 : 0;
+
+  az_span block = { 0 };
+  _az_RETURN_IF_FAILED(az_arena_allocate(request->_internal.arena, size, &block));
+
+  struct curl_slist* const nodes = (struct curl_slist*)(void*)az_span_ptr(block);
+  az_span strings = az_span_slice_to_end(block, nodes_count * (int32_t)sizeof(struct curl_slist));
+  for (int32_t index = 0; index < nodes_count; ++index)
+  {
+    nodes[index].data = (char*)az_span_ptr(strings);
+    nodes[index].next = index + 1 < nodes_count ? &nodes[index + 1] : NULL;
+
+    if (index < headers_count)
+    {
+      _az_RETURN_IF_FAILED(az_http_request_get_header(request, index, &header_name, &header_value));
+      strings = az_span_copy(strings, header_name);
+      strings = az_span_copy_u8(strings, ':');
+      strings = az_span_copy(strings, header_value);
+    }
+    else
+    {
+      strings = az_span_copy(strings, _az_http_client_curl_expect_header);
+    }
+    strings = az_span_copy_u8(strings, 0);
   }
 
+  *ref_headers = nodes_count > 0 ? nodes : NULL;
   return AZ_OK;
 }
 
+/**
+ * @brief frees a list of headers, unless it was built in the arena of the request
+ */
+static void
+_az_http_client_curl_slist_free(az_http_request const* request, struct curl_slist* list)
+{
+  az_arena const* const arena = request->_internal.arena;
+  if (arena == NULL || list == NULL || !_az_arena_contains(arena, list))
+  {
+    curl_slist_free_all(list);
+  }
+}
+
 /**
  * @brief writes a url request adds a zero to make it a c-string. Return error if any of the write
  * operations fails.
@@ -284,6 +638,29 @@ static size_t _az_http_client_curl_write_to_span(
   return expected_size;
 }
 
+/**
+ * @brief Same as _az_http_client_curl_write_to_span(), for the body, which may go to the buffers
+ * of the response's body allocator.
+ */
+static size_t _az_http_client_curl_write_body(
+    void* contents,
+    size_t size,
+    size_t nmemb,
+    void* userp)
+{
+  size_t const expected_size = size * nmemb;
+  az_http_response* response = (az_http_response*)userp;
+
+  az_span const span_for_content = az_span_create((uint8_t*)contents, (int32_t)expected_size);
+
+  if (az_result_failed(az_http_response_append_body(response, span_for_content)))
+  {
+    return expected_size + 1;
+  }
+
+  return expected_size;
+}
+
 /**
  * handles GET request
  */
@@ -292,7 +669,7 @@ static AZ_NODISCARD az_result _az_http_client_curl_send_get_request(CURL* ref_cu
   _az_PRECONDITION_NOT_NULL(ref_curl);
 
   // send
-  _az_RETURN_IF_CURL_FAILED(curl_easy_perform(ref_curl));
+  _az_RETURN_IF_CURL_FAILED(_az_http_client_curl_perform(ref_curl));
 
   return AZ_OK;
 }
@@ -307,68 +684,42 @@ static AZ_NODISCARD az_result _az_http_client_curl_send_delete_request(CURL* ref
   _az_RETURN_IF_FAILED(_az_http_client_curl_code_to_result(
       curl_easy_setopt(ref_curl, CURLOPT_CUSTOMREQUEST, "DELETE")));
 
-  _az_RETURN_IF_FAILED(_az_http_client_curl_code_to_result(curl_easy_perform(ref_curl)));
+  _az_RETURN_IF_FAILED(_az_http_client_curl_code_to_result(_az_http_client_curl_perform(ref_curl)));
 
   return AZ_OK;
 }
 
 /**
- * handles POST request. It handles seting up a body for request
+ * @brief Progress of an upload, shared by the read and seek callbacks.
  */
-static AZ_NODISCARD az_result
-_az_http_client_curl_send_post_request(CURL* ref_curl, az_http_request const* request)
+typedef struct
 {
-  _az_PRECONDITION_NOT_NULL(ref_curl);
-  _az_PRECONDITION_NOT_NULL(request);
-
-  // Method
-  az_span request_body = { 0 };
-  _az_RETURN_IF_FAILED(az_http_request_get_body(request, &request_body));
-  az_span body = { 0 };
-  int32_t const required_length = az_span_size(request_body) + az_span_size(AZ_SPAN_FROM_STR("\0"));
-
-  _az_RETURN_IF_FAILED(_az_span_malloc(required_length, &body));
-
-  char* b = (char*)az_span_ptr(body);
-  az_span_to_str(b, required_length, request_body);
-
-  az_result res_code
-      = _az_http_client_curl_code_to_result(curl_easy_setopt(ref_curl, CURLOPT_POSTFIELDS, b));
-  if (az_result_succeeded(res_code))
-  {
-    res_code = _az_http_client_curl_code_to_result(curl_easy_perform(ref_curl));
-  }
-
-  _az_span_free(&body);
-  _az_RETURN_IF_FAILED(res_code);
-
-  return AZ_OK;
-}
+  az_http_request const* request;
+  int64_t offset;
+} _az_http_client_curl_upload_state;
 
 /**
  * @brief UPLOAD requests are done via callbacks.  The callback is passed in a buffer address which
- * is filled with the userdata content. The callback will occur until the callback returns 0 (no
- * more data). The callback will return CURL_READFUNC_ABORT should an error occur.  This in turn
- * terminates the POST request.
+ * is filled with the next chunk of the request body. The callback will occur until the callback
+ * returns 0 (no more data). The callback will return CURL_READFUNC_ABORT should an error occur.
+ * This in turn terminates the request.
  *
  * @param dst Destination address buffer
  * @param size Size of an item
  * @param nmemb Number of items to copy
- * @param userdata Source data to upload
- *                 Passed as the pointer to an az_span
- * @return int
+ * @param userdata Passed as the pointer to an _az_http_client_curl_upload_state
+ * @return The number of bytes copied into dst
  */
-static int32_t _az_http_client_curl_upload_read_callback(
+static size_t _az_http_client_curl_upload_read_callback(
     void* dst,
     size_t size,
     size_t nmemb,
     void* userdata)
 {
-
-  az_span* upload_content = (az_span*)userdata;
+  _az_http_client_curl_upload_state* upload = (_az_http_client_curl_upload_state*)userdata;
 
   // Calculate the size of the *dst buffer
-  int32_t dst_buffer_size = (int32_t)(nmemb * size);
+  size_t const dst_buffer_size = nmemb * size;
 
   // Terminate the upload if the destination buffer is too small
   if (dst_buffer_size < 1)
@@ -376,29 +727,105 @@ static int32_t _az_http_client_curl_upload_read_callback(
     return CURL_READFUNC_ABORT;
   }
 
-  int32_t userdata_length = az_span_size(*upload_content);
+  // The body comes either from the request's body span or from its body reader, which may produce
+  // less than the destination size at a time, curl calls back until it returns 0.
+  int32_t const chunk_size = dst_buffer_size > INT32_MAX ? INT32_MAX : (int32_t)dst_buffer_size;
+  int32_t size_of_copy = 0;
+  if (az_result_failed(az_http_request_read_body(
+          upload->request,
+          upload->offset,
+          az_span_create((uint8_t*)dst, chunk_size),
+          &size_of_copy)))
+  {
+    return CURL_READFUNC_ABORT;
+  }
+
+  upload->offset += size_of_copy;
+
+  return (size_t)size_of_copy;
+}
+
+/**
+ * @brief Curl seeks back, usually to the beginning, when it has to send the body again, such as
+ * when following a redirect.
+ */
+static int _az_http_client_curl_upload_seek_callback(void* userdata, curl_off_t offset, int origin)
+{
+  _az_http_client_curl_upload_state* upload = (_az_http_client_curl_upload_state*)userdata;
+
+  if (origin != SEEK_SET || offset < 0)
+  {
+    return CURL_SEEKFUNC_CANTSEEK;
+  }
+
+  upload->offset = (int64_t)offset;
+  return CURL_SEEKFUNC_OK;
+}
+
+/**
+ * @brief Makes curl pull the request body through the upload callbacks.
+ */
+static AZ_NODISCARD az_result
+_az_http_client_curl_setup_upload(CURL* ref_curl, _az_http_client_curl_upload_state* upload)
+{
+  _az_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(ref_curl, CURLOPT_READFUNCTION, _az_http_client_curl_upload_read_callback));
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_READDATA, (void*)upload));
+  _az_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(ref_curl, CURLOPT_SEEKFUNCTION, _az_http_client_curl_upload_seek_callback));
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_SEEKDATA, (void*)upload));
+
+  return AZ_OK;
+}
+
+/**
+ * handles POST request. It handles seting up a body for request
+ */
+static AZ_NODISCARD az_result
+_az_http_client_curl_send_post_request(CURL* ref_curl, az_http_request const* request)
+{
+  _az_PRECONDITION_NOT_NULL(ref_curl);
+  _az_PRECONDITION_NOT_NULL(request);
 
-  // Return if nothing to copy
-  if (userdata_length < 1)
+  if (az_http_request_has_body_reader(request))
   {
-    return CURLE_OK; // Success, all bytes copied
+    // Stream the body rather than copying it into a string.
+    _az_http_client_curl_upload_state upload = { .request = request, .offset = 0 };
+    _az_RETURN_IF_FAILED(_az_http_client_curl_setup_upload(ref_curl, &upload));
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_POST, 1L));
+
+    // -1 (unknown) makes curl send the body with chunked transfer encoding.
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(
+        ref_curl,
+        CURLOPT_POSTFIELDSIZE_LARGE,
+        (curl_off_t)az_http_request_get_body_length(request)));
+
+    _az_RETURN_IF_CURL_FAILED(_az_http_client_curl_perform(ref_curl));
+    return AZ_OK;
   }
 
-  // Calculate how many bytes can we copy from customer data (upload_content)
-  // Curl provides dst buffer with a max size of dest_buffer_size, if customer data size is less
-  // than the max, we can copy all customer data directly and have it uploaded at once.
-  // If not, we can only copy the max dst size from customer data and wait for another upload to
-  // copy a next chunk of data
-  int32_t size_of_copy = (userdata_length < dst_buffer_size) ? userdata_length : dst_buffer_size;
+  // Method
+  az_span request_body = { 0 };
+  _az_RETURN_IF_FAILED(az_http_request_get_body(request, &request_body));
+  az_span body = { 0 };
+  int32_t const required_length = az_span_size(request_body) + az_span_size(AZ_SPAN_FROM_STR("\0"));
 
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
-  memcpy(dst, az_span_ptr(*upload_content), (size_t)size_of_copy);
+  _az_RETURN_IF_FAILED(_az_span_malloc(request, required_length, &body));
 
-  // Update the userdata span. If we already copied all content, slice will set upload_content with
-  // 0 length
-  *upload_content = az_span_slice_to_end(*upload_content, size_of_copy);
+  char* b = (char*)az_span_ptr(body);
+  az_span_to_str(b, required_length, request_body);
+
+  az_result res_code
+      = _az_http_client_curl_code_to_result(curl_easy_setopt(ref_curl, CURLOPT_POSTFIELDS, b));
+  if (az_result_succeeded(res_code))
+  {
+    res_code = _az_http_client_curl_code_to_result(_az_http_client_curl_perform(ref_curl));
+  }
 
-  return size_of_copy;
+  _az_span_free(request, &body);
+  _az_RETURN_IF_FAILED(res_code);
+
+  return AZ_OK;
 }
 
 /**
@@ -411,24 +838,19 @@ _az_http_client_curl_send_upload_request(CURL* ref_curl, az_http_request const*
   _az_PRECONDITION_NOT_NULL(ref_curl);
   _az_PRECONDITION_NOT_NULL(request);
 
-  az_span body = { 0 };
-  _az_RETURN_IF_FAILED(az_http_request_get_body(request, &body));
-
   _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_UPLOAD, 1L));
-  _az_RETURN_IF_CURL_FAILED(
-      curl_easy_setopt(ref_curl, CURLOPT_READFUNCTION, _az_http_client_curl_upload_read_callback));
 
-  // Setup the request to pass body into the read callback
-  // The read callback receives the address of body
-  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_READDATA, &body));
+  // Setup the request to pass the body into the read callback
+  _az_http_client_curl_upload_state upload = { .request = request, .offset = 0 };
+  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_upload(ref_curl, &upload));
 
-  // Set the size of the upload
-  _az_RETURN_IF_CURL_FAILED(
-      curl_easy_setopt(ref_curl, CURLOPT_INFILESIZE, (curl_off_t)az_span_size(body)));
+  // Set the size of the upload, -1 (unknown) makes curl use chunked transfer encoding
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(
+      ref_curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)az_http_request_get_body_length(request)));
 
   // Do the curl work
-  // curl_easy_perform does not return until the CURLOPT_READFUNCTION callbacks complete.
-  _az_RETURN_IF_CURL_FAILED(curl_easy_perform(ref_curl));
+  // The transfer does not complete until the CURLOPT_READFUNCTION callbacks complete.
+  _az_RETURN_IF_CURL_FAILED(_az_http_client_curl_perform(ref_curl));
 
   return AZ_OK;
 }
@@ -439,16 +861,35 @@ _az_http_client_curl_send_upload_request(CURL* ref_curl, az_http_request const*
  * @param ref_curl curl specific structure to send a request
  * @param ref_list curl headers list
  * @param request an http request
+ * @param scratch buffer to write each header into
  * @return az_result
  */
 static AZ_NODISCARD az_result _az_http_client_curl_setup_headers(
     CURL* ref_curl,
     struct curl_slist** ref_list,
-    az_http_request const* request)
+    az_http_request const* request,
+    az_span scratch)
 {
   _az_PRECONDITION_NOT_NULL(ref_curl);
   _az_PRECONDITION_NOT_NULL(request);
 
+  if (request->_internal.arena != NULL)
+  {
+    az_http_method method;
+    _az_RETURN_IF_FAILED(az_http_request_get_method(request, &method));
+    bool const expect = az_span_is_content_equal(method, az_http_method_post())
+        || az_span_is_content_equal(method, az_http_method_put());
+
+    // Build the list on the heap when the arena doesn't have enough space left.
+    if (az_result_succeeded(_az_http_client_curl_build_headers_in_arena(request, expect, ref_list)))
+    {
+      return *ref_list == NULL
+          ? AZ_OK
+          : _az_http_client_curl_code_to_result(
+              curl_easy_setopt(ref_curl, CURLOPT_HTTPHEADER, *ref_list));
+    }
+  }
+
   if (az_http_request_headers_count(request) == 0)
   {
     // no headers, no need to set it up
@@ -456,7 +897,7 @@ static AZ_NODISCARD az_result _az_http_client_curl_setup_headers(
   }
 
   // build headers into a slist as curl is expecting
-  _az_RETURN_IF_FAILED(_az_http_client_curl_build_headers(request, ref_list));
+  _az_RETURN_IF_FAILED(_az_http_client_curl_build_headers(request, scratch, ref_list));
   // set all headers from slist
   _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_HTTPHEADER, *ref_list));
 
@@ -468,10 +909,11 @@ static AZ_NODISCARD az_result _az_http_client_curl_setup_headers(
  *
  * @param ref_curl specific curl struct to send a request
  * @param request an az http request builder holding all data to send request
+ * @param scratch buffer to write the zero-terminated url into, which curl copies
  * @return az_result
  */
 static AZ_NODISCARD az_result
-_az_http_client_curl_setup_url(CURL* ref_curl, az_http_request const* request)
+_az_http_client_curl_setup_url(CURL* ref_curl, az_http_request const* request, az_span scratch)
 {
   _az_PRECONDITION_NOT_NULL(ref_curl);
   _az_PRECONDITION_NOT_NULL(request);
@@ -480,39 +922,104 @@ _az_http_client_curl_setup_url(CURL* ref_curl, az_http_request const* request)
   // get request_url. It will have the size of what it has written in it only
   _az_RETURN_IF_FAILED(az_http_request_get_url(request, &request_url));
   // Note: the url from request is already url-encoded.
-  int32_t request_url_size = az_span_size(request_url);
-
-  az_span writable_buffer;
-  {
-    // Add 1 for 0-terminated str
-    int32_t const url_final_size = request_url_size + 1;
-
-    // allocate buffer to add \0
-    _az_RETURN_IF_FAILED(_az_span_malloc(url_final_size, &writable_buffer));
-  }
 
   // write url in buffer (will add \0 at the end)
   // request_url is already the right size containing only what has been written into it
-  az_result result = _az_http_client_curl_append_url(writable_buffer, request_url);
+  az_result result = _az_http_client_curl_append_url(scratch, request_url);
 
   if (az_result_succeeded(result))
   {
-    char* buffer = (char*)az_span_ptr(writable_buffer);
+    char* buffer = (char*)az_span_ptr(scratch);
     result = _az_http_client_curl_code_to_result(curl_easy_setopt(ref_curl, CURLOPT_URL, buffer));
+#ifdef _az_CURL_MULTI_ENABLED
+    if (az_result_succeeded(result))
+    {
+      result = _az_http_client_curl_code_to_result(
+          _az_http_client_curl_multi_setup(ref_curl, buffer));
+    }
+#endif // _az_CURL_MULTI_ENABLED
   }
 
-  // free used buffer before anything else
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
-  memset(az_span_ptr(writable_buffer), 0, (size_t)az_span_size(writable_buffer));
-  _az_span_free(&writable_buffer);
-
   return result;
 }
 
-// TODO: Fix up the documentation here.
+enum
+{
+  // Most URLs and headers are shorter than this, and are written on the stack.
+  _az_CURL_SCRATCH_STACK_SIZE = 256,
+};
+
 /**
- * @brief set url the response redirection to user buffer
- *
+ * @brief gets the size of a buffer that can hold the zero-terminated url, or any of the
+ * zero-terminated headers, of a request
+ */
+static AZ_NODISCARD az_result
+_az_http_client_curl_get_scratch_size(az_http_request const* request, int32_t* out_size)
+{
+  az_span request_url = { 0 };
+  _az_RETURN_IF_FAILED(az_http_request_get_url(request, &request_url));
+  int32_t size = az_span_size(request_url) + 1;
+
+  az_span header_name = { 0 };
+  az_span header_value = { 0 };
+  for (int32_t offset = 0; offset < az_http_request_headers_count(request); ++offset)
+  {
+    _az_RETURN_IF_FAILED(az_http_request_get_header(request, offset, &header_name, &header_value));
+    int32_t const header_size = az_span_size(header_name) + az_span_size(header_value) + 2;
+    size = header_size > size ? header_size : size;
+  }
+
+  *out_size = size;
+  return AZ_OK;
+}
+
+/**
+ * @brief sets the headers and the url of the request. They are written, one at a time, into a
+ * single scratch buffer, which curl copies each of them out of. The buffer is on the stack, unless
+ * the longest of them doesn't fit, in which case it is allocated once for the whole request.
+ *
+ * @param ref_curl curl specific structure to send a request
+ * @param ref_list curl headers list
+ * @param request an http request
+ * @return az_result
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_setup_headers_and_url(
+    CURL* ref_curl,
+    struct curl_slist** ref_list,
+    az_http_request const* request)
+{
+  int32_t scratch_size = 0;
+  _az_RETURN_IF_FAILED(_az_http_client_curl_get_scratch_size(request, &scratch_size));
+
+  uint8_t stack_buffer[_az_CURL_SCRATCH_STACK_SIZE];
+  az_span scratch = AZ_SPAN_FROM_BUFFER(stack_buffer);
+  bool const allocated = scratch_size > _az_CURL_SCRATCH_STACK_SIZE;
+  if (allocated)
+  {
+    _az_RETURN_IF_FAILED(_az_span_malloc(request, scratch_size, &scratch));
+  }
+
+  az_result result = _az_http_client_curl_setup_headers(ref_curl, ref_list, request, scratch);
+  if (az_result_succeeded(result))
+  {
+    result = _az_http_client_curl_setup_url(ref_curl, request, scratch);
+  }
+
+  // The url and headers may hold secrets, don't leave them around.
+  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
+  memset(az_span_ptr(scratch), 0, (size_t)az_span_size(scratch));
+  if (allocated)
+  {
+    _az_span_free(request, &scratch);
+  }
+
+  return result;
+}
+
+// TODO: Fix up the documentation here.
+/**
+ * @brief set url the response redirection to user buffer
+ *
  * @param ref_curl specific curl structure used to send http request
  * @param response an http response object which will hold all the HTTP response
  * @return az_result
@@ -528,13 +1035,111 @@ _az_http_client_curl_setup_response_redirect(CURL* ref_curl, az_http_response* r
   _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_HEADERDATA, (void*)response));
 
   _az_RETURN_IF_CURL_FAILED(
-      curl_easy_setopt(ref_curl, CURLOPT_WRITEFUNCTION, _az_http_client_curl_write_to_span));
+      curl_easy_setopt(ref_curl, CURLOPT_WRITEFUNCTION, _az_http_client_curl_write_body));
 
   _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_WRITEDATA, (void*)response));
 
+#ifdef TRANSPORT_CURL_ACCEPT_ENCODING
+  // An empty string makes libcurl send Accept-Encoding with every encoding it was built with (gzip,
+  // deflate, and br when available), and decode the body as it is received, before it reaches the
+  // write callback. Chunked transfer encoding is always decoded by libcurl.
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_ACCEPT_ENCODING, ""));
+#endif // TRANSPORT_CURL_ACCEPT_ENCODING
+
   return AZ_OK;
 }
 
+#if LIBCURL_VERSION_NUM >= 0x072000 // CURLOPT_XFERINFOFUNCTION was added in 7.32.0
+/**
+ * @brief This is the function that curl calls while a transfer is in progress (at least once per
+ * second). It aborts the transfer once the context of the request has been canceled.
+ */
+static int _az_http_client_curl_xferinfo_callback(
+    void* clientp,
+    curl_off_t dltotal,
+    curl_off_t dlnow,
+    curl_off_t ultotal,
+    curl_off_t ulnow)
+{
+  (void)dltotal;
+  (void)dlnow;
+  (void)ultotal;
+  (void)ulnow;
+
+  int64_t clock = 0;
+  if (az_result_failed(az_platform_clock_msec(&clock)))
+  {
+    return 0;
+  }
+
+  return az_context_has_expired((az_context const*)clientp, clock) ? 1 : 0;
+}
+#endif // LIBCURL_VERSION_NUM >= 0x072000
+
+/**
+ * @brief makes the transfer honor the context of the request. The time left until the context
+ * expires becomes the timeout of the transfer, and canceling the context aborts the transfer in
+ * progress.
+ *
+ * @param ref_curl specific curl struct to send a request
+ * @param context the context of the request, if any
+ * @return AZ_ERROR_CANCELED if the context already expired
+ */
+static AZ_NODISCARD az_result
+_az_http_client_curl_setup_context(CURL* ref_curl, az_context const* context)
+{
+  if (context == NULL)
+  {
+    return AZ_OK;
+  }
+
+  int64_t const expiration = az_context_get_expiration(context);
+  if (expiration < _az_CONTEXT_MAX_EXPIRATION)
+  {
+    int64_t clock = 0;
+    _az_RETURN_IF_FAILED(az_platform_clock_msec(&clock));
+
+    int64_t const remaining = expiration - clock;
+    if (remaining <= 0)
+    {
+      return AZ_ERROR_CANCELED;
+    }
+
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(
+        ref_curl, CURLOPT_TIMEOUT_MS, remaining < LONG_MAX ? (long)remaining : LONG_MAX));
+  }
+
+#if LIBCURL_VERSION_NUM >= 0x072000
+  // Even a context that doesn't expire can be canceled, through any of its parents.
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(
+      ref_curl, CURLOPT_XFERINFOFUNCTION, _az_http_client_curl_xferinfo_callback));
+  _az_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(ref_curl, CURLOPT_XFERINFODATA, (void*)(uintptr_t)context));
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_NOPROGRESS, 0L));
+#endif // LIBCURL_VERSION_NUM >= 0x072000
+
+  return AZ_OK;
+}
+
+/**
+ * @brief reports the failure of a transfer that was aborted, or timed out, because the context of
+ * the request expired as AZ_ERROR_CANCELED
+ */
+static AZ_NODISCARD az_result
+_az_http_client_curl_context_result(az_http_request const* request, az_result result)
+{
+  az_context const* const context = request->_internal.context;
+  int64_t clock = 0;
+  if (az_result_failed(result) && context != NULL
+      && az_result_succeeded(az_platform_clock_msec(&clock))
+      && az_context_has_expired(context, clock))
+  {
+    return AZ_ERROR_CANCELED;
+  }
+
+  return result;
+}
+
 /**
  * @brief use this function to group all the actions that we do with CURL so we can clean it after
  * it no matter is there is an error at any step.
@@ -555,10 +1160,11 @@ static AZ_NODISCARD az_result _az_http_client_curl_send_request_impl_process(
 
   az_result result = AZ_ERROR_ARG;
 
-  struct curl_slist* list = NULL;
-  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_headers(ref_curl, &list, request));
+  // Before the headers are built, so that nothing is left to clean up if it already expired.
+  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_context(ref_curl, request->_internal.context));
 
-  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_url(ref_curl, request));
+  struct curl_slist* list = NULL;
+  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_headers_and_url(ref_curl, &list, request));
 
   _az_RETURN_IF_FAILED(_az_http_client_curl_setup_response_redirect(ref_curl, ref_response));
 
@@ -575,14 +1181,14 @@ static AZ_NODISCARD az_result _az_http_client_curl_send_request_impl_process(
   }
   else if (az_span_is_content_equal(method, az_http_method_post()))
   {
-    _az_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(ref_curl, &list));
+    _az_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(ref_curl, &list, request));
     result = _az_http_client_curl_send_post_request(ref_curl, request);
   }
   else if (az_span_is_content_equal(method, az_http_method_put()))
   {
     // As of CURL 7.12.1 CURLOPT_PUT is deprecated.  PUT requests should be made using
     // CURLOPT_UPLOAD
-    _az_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(ref_curl, &list));
+    _az_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(ref_curl, &list, request));
     result = _az_http_client_curl_send_upload_request(ref_curl, request);
   }
   else
@@ -591,11 +1197,75 @@ static AZ_NODISCARD az_result _az_http_client_curl_send_request_impl_process(
   }
 
   // Clean custom headers previously appended
-  curl_slist_free_all(list);
+  _az_http_client_curl_slist_free(request, list);
 
   return result;
 }
 
+/**
+ * @brief Reports one of the transfer phases measured by curl as an instrumentation event.
+ */
+static void _az_http_client_curl_report_time(
+    CURL* ref_curl,
+    az_http_request const* request,
+    CURLINFO info,
+    az_http_instrumentation_kind kind)
+{
+#if LIBCURL_VERSION_NUM >= 0x073D00 // The _TIME_T variants were added in 7.61.0
+  curl_off_t elapsed_usec = 0;
+  if (curl_easy_getinfo(ref_curl, info, &elapsed_usec) == CURLE_OK && elapsed_usec > 0)
+  {
+    _az_http_instrumentation_write(
+        request, kind, AZ_HTTP_INSTRUMENTATION_MEASURED, 0, AZ_OK, (int64_t)elapsed_usec);
+  }
+#else
+  double elapsed_sec = 0;
+  if (curl_easy_getinfo(ref_curl, info, &elapsed_sec) == CURLE_OK && elapsed_sec > 0)
+  {
+    _az_http_instrumentation_write(
+        request, kind, AZ_HTTP_INSTRUMENTATION_MEASURED, 0, AZ_OK, (int64_t)(elapsed_sec * 1e6));
+  }
+#endif
+}
+
+/**
+ * @brief Reports the transfer phases curl measured while performing \p request. Phases that were
+ * skipped, like the connect phase of a reused connection, are not reported.
+ */
+static void _az_http_client_curl_report_times(CURL* ref_curl, az_http_request const* request)
+{
+  if (!_az_http_instrumentation_enabled())
+  {
+    return;
+  }
+
+#if LIBCURL_VERSION_NUM >= 0x073D00
+  _az_http_client_curl_report_time(
+      ref_curl, request, CURLINFO_NAMELOOKUP_TIME_T, AZ_HTTP_INSTRUMENTATION_TRANSPORT_NAME_LOOKUP);
+  _az_http_client_curl_report_time(
+      ref_curl, request, CURLINFO_CONNECT_TIME_T, AZ_HTTP_INSTRUMENTATION_TRANSPORT_CONNECT);
+  _az_http_client_curl_report_time(
+      ref_curl,
+      request,
+      CURLINFO_APPCONNECT_TIME_T,
+      AZ_HTTP_INSTRUMENTATION_TRANSPORT_TLS_HANDSHAKE);
+  _az_http_client_curl_report_time(
+      ref_curl,
+      request,
+      CURLINFO_STARTTRANSFER_TIME_T,
+      AZ_HTTP_INSTRUMENTATION_TRANSPORT_FIRST_BYTE);
+#else
+  _az_http_client_curl_report_time(
+      ref_curl, request, CURLINFO_NAMELOOKUP_TIME, AZ_HTTP_INSTRUMENTATION_TRANSPORT_NAME_LOOKUP);
+  _az_http_client_curl_report_time(
+      ref_curl, request, CURLINFO_CONNECT_TIME, AZ_HTTP_INSTRUMENTATION_TRANSPORT_CONNECT);
+  _az_http_client_curl_report_time(
+      ref_curl, request, CURLINFO_APPCONNECT_TIME, AZ_HTTP_INSTRUMENTATION_TRANSPORT_TLS_HANDSHAKE);
+  _az_http_client_curl_report_time(
+      ref_curl, request, CURLINFO_STARTTRANSFER_TIME, AZ_HTTP_INSTRUMENTATION_TRANSPORT_FIRST_BYTE);
+#endif
+}
+
 AZ_NODISCARD az_result
 az_http_client_send_request(az_http_request const* request, az_http_response* ref_response)
 {
@@ -607,12 +1277,535 @@ az_http_client_send_request(az_http_request const* request, az_http_response* re
   // init curl
   _az_RETURN_IF_FAILED(_az_http_client_curl_init(&curl));
 
+  az_arena* const arena = request->_internal.arena;
+  int32_t const arena_mark = arena == NULL ? 0 : _az_arena_get_mark(arena);
+
   // process request
-  az_result process_result
-      = _az_http_client_curl_send_request_impl_process(curl, request, ref_response);
+  az_result const process_result = _az_http_client_curl_context_result(
+      request, _az_http_client_curl_send_request_impl_process(curl, request, ref_response));
+
+  _az_http_client_curl_report_times(curl, request);
 
   // no matter if error or not, call curl done before returning to let curl clean everything
-  _az_RETURN_IF_FAILED(_az_http_client_curl_done(&curl));
+  az_result const done_result = _az_http_client_curl_done(&curl);
+
+  // Everything the transport allocated from the arena is no longer used by curl.
+  if (arena != NULL)
+  {
+    _az_arena_rewind(arena, arena_mark);
+  }
+
+  _az_RETURN_IF_FAILED(done_result);
 
   return process_result;
 }
+
+/**
+ * @brief Sets up a GET or HEAD request on \p ref_curl, without performing it.
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_setup_idempotent_request(
+    CURL* ref_curl,
+    struct curl_slist** ref_list,
+    az_http_request const* request,
+    az_http_response* ref_response)
+{
+  _az_PRECONDITION_NOT_NULL(ref_curl);
+  _az_PRECONDITION_NOT_NULL(request);
+
+  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_headers_and_url(ref_curl, ref_list, request));
+  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_response_redirect(ref_curl, ref_response));
+  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_context(ref_curl, request->_internal.context));
+
+  az_http_method method;
+  _az_RETURN_IF_FAILED(az_http_request_get_method(request, &method));
+
+  if (az_span_is_content_equal(method, az_http_method_head()))
+  {
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_NOBODY, 1L));
+  }
+  else if (!az_span_is_content_equal(method, az_http_method_get()))
+  {
+    return AZ_ERROR_HTTP_INVALID_METHOD_VERB;
+  }
+
+  return AZ_OK;
+}
+
+enum
+{
+  // How long to wait for network activity at once, after the hedged request was sent.
+  _az_CURL_HEDGING_POLL_TIMEOUT_MILLISECONDS = 1000,
+};
+
+// The hedging delay is measured with a monotonic clock of its own, since the resolution of
+// az_platform_clock_msec() depends on the platform implementation linked in.
+static int64_t _az_http_client_curl_monotonic_msec(void)
+{
+#ifdef _WIN32
+  return (int64_t)GetTickCount64();
+#else
+  struct timespec now = { 0 };
+  (void)clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * 1000 + (int64_t)(now.tv_nsec / 1000000);
+#endif
+}
+
+/**
+ * @brief The two requests run on a multi handle of their own, which is driven by the calling
+ * thread until one of them completes successfully, or both failed.
+ */
+AZ_NODISCARD az_result az_http_client_send_hedged_request(
+    az_http_request const* request,
+    az_http_response* ref_response,
+    az_http_response* ref_hedge_response,
+    int32_t hedge_delay_msec,
+    bool* out_hedge_won)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(ref_response);
+  _az_PRECONDITION_NOT_NULL(ref_hedge_response);
+  _az_PRECONDITION_NOT_NULL(out_hedge_won);
+
+  *out_hedge_won = false;
+
+  CURLM* const multi = curl_multi_init();
+  if (multi == NULL)
+  {
+    return AZ_ERROR_OUT_OF_MEMORY;
+  }
+
+  az_arena* const arena = request->_internal.arena;
+  int32_t const arena_mark = arena == NULL ? 0 : _az_arena_get_mark(arena);
+
+  // The first handle may come from the handles reused by the thread, the hedged one can't.
+  CURL* handles[2] = { NULL, NULL };
+  struct curl_slist* lists[2] = { NULL, NULL };
+  bool in_flight[2] = { false, false };
+
+  az_result result = _az_http_client_curl_init(&handles[0]);
+  if (az_result_succeeded(result))
+  {
+    result = handles[0] == NULL ? AZ_ERROR_OUT_OF_MEMORY
+                                : _az_http_client_curl_setup_idempotent_request(
+                                    handles[0], &lists[0], request, ref_response);
+  }
+
+  int64_t const start = _az_http_client_curl_monotonic_msec();
+
+  if (az_result_succeeded(result))
+  {
+    in_flight[0] = curl_multi_add_handle(multi, handles[0]) == CURLM_OK;
+    result = in_flight[0] ? AZ_OK : AZ_ERROR_HTTP_ADAPTER;
+  }
+
+  bool hedge_sent = false;
+  while (az_result_succeeded(result))
+  {
+    int running = 0;
+    if (curl_multi_perform(multi, &running) != CURLM_OK)
+    {
+      result = AZ_ERROR_HTTP_ADAPTER;
+      break;
+    }
+
+    bool completed = false;
+    int queued = 0;
+    for (CURLMsg* msg = curl_multi_info_read(multi, &queued); msg != NULL;
+         msg = curl_multi_info_read(multi, &queued))
+    {
+      if (msg->msg != CURLMSG_DONE)
+      {
+        continue;
+      }
+
+      int const index = msg->easy_handle == handles[0] ? 0 : 1;
+      (void)curl_multi_remove_handle(multi, msg->easy_handle);
+      in_flight[index] = false;
+
+      // A failed request only decides the result once the other one isn't in flight anymore.
+      result = _az_http_client_curl_code_to_result(msg->data.result);
+      if (az_result_succeeded(result) || !in_flight[1 - index])
+      {
+        *out_hedge_won = index == 1;
+        completed = true;
+        break;
+      }
+
+      result = AZ_OK;
+    }
+
+    if (completed)
+    {
+      break;
+    }
+
+    int64_t const now = _az_http_client_curl_monotonic_msec();
+    int64_t timeout = _az_CURL_HEDGING_POLL_TIMEOUT_MILLISECONDS;
+    if (!hedge_sent)
+    {
+      int64_t const remaining = hedge_delay_msec - (now - start);
+      if (remaining <= 0)
+      {
+        // Send the request again. If that can't be done, keep waiting for the first one.
+        hedge_sent = true;
+        handles[1] = curl_easy_init();
+        if (handles[1] != NULL
+#ifdef TRANSPORT_CURL_SHARE
+            && az_result_succeeded(_az_http_client_curl_setup_share(handles[1]))
+#endif // TRANSPORT_CURL_SHARE
+            && az_result_succeeded(_az_http_client_curl_setup_idempotent_request(
+                handles[1], &lists[1], request, ref_hedge_response)))
+        {
+          in_flight[1] = curl_multi_add_handle(multi, handles[1]) == CURLM_OK;
+        }
+
+        continue;
+      }
+
+      timeout = remaining < timeout ? remaining : timeout;
+    }
+
+#if LIBCURL_VERSION_NUM >= 0x074200 // curl_multi_poll() was added in 7.66.0
+    (void)curl_multi_poll(multi, NULL, 0, (int)timeout, NULL);
+#else
+    (void)curl_multi_wait(multi, NULL, 0, (int)timeout, NULL);
+#endif
+  }
+
+  // Cancel the request that didn't complete, if any.
+  for (int index = 0; index < 2; ++index)
+  {
+    if (in_flight[index])
+    {
+      (void)curl_multi_remove_handle(multi, handles[index]);
+    }
+
+    _az_http_client_curl_slist_free(request, lists[index]);
+  }
+
+  (void)curl_multi_cleanup(multi);
+
+  if (handles[1] != NULL)
+  {
+    curl_easy_cleanup(handles[1]);
+  }
+
+  if (arena != NULL)
+  {
+    _az_arena_rewind(arena, arena_mark);
+  }
+
+  if (handles[0] != NULL)
+  {
+    _az_RETURN_IF_FAILED(_az_http_client_curl_done(&handles[0]));
+  }
+
+  return _az_http_client_curl_context_result(request, result);
+}
+
+/**
+ * @brief The state of one of the requests of a batch, which lives until all of them completed.
+ */
+typedef struct
+{
+  CURL* curl;
+  struct curl_slist* list;
+  _az_http_client_curl_upload_state upload;
+  int32_t arena_mark;
+  bool in_flight;
+} _az_http_client_curl_batch_transfer;
+
+enum
+{
+  // How long to wait for network activity at once, while the requests of a batch are in flight.
+  _az_CURL_BATCH_POLL_TIMEOUT_MILLISECONDS = 1000,
+};
+
+/**
+ * @brief Sets up a request of a batch on \p ref_transfer, without performing it. The body of POST
+ * and PUT requests is read from the request as curl sends it, so nothing has to be freed once the
+ * transfer completed but the list of headers.
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_setup_batch_request(
+    _az_http_client_curl_batch_transfer* ref_transfer,
+    az_http_request const* request,
+    az_http_response* ref_response)
+{
+  CURL* const curl = ref_transfer->curl;
+
+  az_http_method method;
+  _az_RETURN_IF_FAILED(az_http_request_get_method(request, &method));
+
+  if (az_span_is_content_equal(method, az_http_method_get())
+      || az_span_is_content_equal(method, az_http_method_head()))
+  {
+    return _az_http_client_curl_setup_idempotent_request(
+        curl, &ref_transfer->list, request, ref_response);
+  }
+
+  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_context(curl, request->_internal.context));
+  _az_RETURN_IF_FAILED(
+      _az_http_client_curl_setup_headers_and_url(curl, &ref_transfer->list, request));
+  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_response_redirect(curl, ref_response));
+
+  if (az_span_is_content_equal(method, az_http_method_delete()))
+  {
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE"));
+    return AZ_OK;
+  }
+
+  bool const is_post = az_span_is_content_equal(method, az_http_method_post());
+  if (!is_post && !az_span_is_content_equal(method, az_http_method_put()))
+  {
+    return AZ_ERROR_HTTP_INVALID_METHOD_VERB;
+  }
+
+  _az_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(curl, &ref_transfer->list, request));
+
+  ref_transfer->upload = (_az_http_client_curl_upload_state){ .request = request, .offset = 0 };
+  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_upload(curl, &ref_transfer->upload));
+
+  // -1 (unknown) makes curl send the body with chunked transfer encoding.
+  curl_off_t const body_length = (curl_off_t)az_http_request_get_body_length(request);
+  if (is_post)
+  {
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(curl, CURLOPT_POST, 1L));
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, body_length));
+  }
+  else
+  {
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L));
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, body_length));
+  }
+
+  return AZ_OK;
+}
+
+/**
+ * @brief The requests run on a multi handle of their own, which is driven by the calling thread
+ * until all of them completed.
+ */
+AZ_NODISCARD az_result az_http_client_send_requests(
+    az_http_request const requests[],
+    az_http_response ref_responses[],
+    az_result out_results[],
+    int32_t count)
+{
+  _az_PRECONDITION_NOT_NULL(requests);
+  _az_PRECONDITION_NOT_NULL(ref_responses);
+  _az_PRECONDITION_NOT_NULL(out_results);
+  _az_PRECONDITION_RANGE(1, count, INT32_MAX);
+
+  _az_http_client_curl_batch_transfer* const transfers
+      = (_az_http_client_curl_batch_transfer*)calloc(
+          (size_t)count, sizeof(_az_http_client_curl_batch_transfer));
+  CURLM* const multi = transfers == NULL ? NULL : curl_multi_init();
+  if (multi == NULL)
+  {
+    free(transfers);
+    return AZ_ERROR_OUT_OF_MEMORY;
+  }
+
+  // The handles can't come from the handles reused by the thread, which has only one.
+  int32_t in_flight = 0;
+  for (int32_t i = 0; i < count; i++)
+  {
+    az_http_request const* const request = &requests[i];
+    _az_http_client_curl_batch_transfer* const transfer = &transfers[i];
+
+    out_results[i] = AZ_OK;
+    transfer->arena_mark
+        = request->_internal.arena == NULL ? 0 : _az_arena_get_mark(request->_internal.arena);
+    transfer->curl = curl_easy_init();
+    if (transfer->curl == NULL)
+    {
+      out_results[i] = AZ_ERROR_OUT_OF_MEMORY;
+      continue;
+    }
+
+#ifdef TRANSPORT_CURL_SHARE
+    out_results[i] = _az_http_client_curl_setup_share(transfer->curl);
+#endif // TRANSPORT_CURL_SHARE
+
+    if (az_result_succeeded(out_results[i]))
+    {
+      out_results[i]
+          = _az_http_client_curl_setup_batch_request(transfer, request, &ref_responses[i]);
+    }
+
+    if (az_result_succeeded(out_results[i]))
+    {
+      transfer->in_flight = curl_multi_add_handle(multi, transfer->curl) == CURLM_OK;
+      out_results[i] = transfer->in_flight ? AZ_OK : AZ_ERROR_HTTP_ADAPTER;
+      in_flight += transfer->in_flight ? 1 : 0;
+    }
+  }
+
+  while (in_flight > 0)
+  {
+    int running = 0;
+    if (curl_multi_perform(multi, &running) != CURLM_OK)
+    {
+      break;
+    }
+
+    int queued = 0;
+    for (CURLMsg* msg = curl_multi_info_read(multi, &queued); msg != NULL;
+         msg = curl_multi_info_read(multi, &queued))
+    {
+      if (msg->msg != CURLMSG_DONE)
+      {
+        continue;
+      }
+
+      for (int32_t i = 0; i < count; i++)
+      {
+        if (transfers[i].in_flight && transfers[i].curl == msg->easy_handle)
+        {
+          out_results[i] = _az_http_client_curl_code_to_result(msg->data.result);
+          _az_http_client_curl_report_times(transfers[i].curl, &requests[i]);
+          (void)curl_multi_remove_handle(multi, transfers[i].curl);
+          transfers[i].in_flight = false;
+          --in_flight;
+          break;
+        }
+      }
+    }
+
+    if (in_flight > 0)
+    {
+#if LIBCURL_VERSION_NUM >= 0x074200 // curl_multi_poll() was added in 7.66.0
+      (void)curl_multi_poll(multi, NULL, 0, _az_CURL_BATCH_POLL_TIMEOUT_MILLISECONDS, NULL);
+#else
+      (void)curl_multi_wait(multi, NULL, 0, _az_CURL_BATCH_POLL_TIMEOUT_MILLISECONDS, NULL);
+#endif
+    }
+  }
+
+  az_result result = AZ_OK;
+  for (int32_t i = 0; i < count; i++)
+  {
+    // Only left in flight when driving the multi handle failed.
+    if (transfers[i].in_flight)
+    {
+      (void)curl_multi_remove_handle(multi, transfers[i].curl);
+      out_results[i] = AZ_ERROR_HTTP_ADAPTER;
+    }
+
+    out_results[i] = _az_http_client_curl_context_result(&requests[i], out_results[i]);
+    if (az_result_failed(out_results[i]) && az_result_succeeded(result))
+    {
+      result = out_results[i];
+    }
+  }
+
+  (void)curl_multi_cleanup(multi);
+
+  // Everything the transport allocated from the arenas is no longer used by curl. They are rewound
+  // in reverse order, so that an arena shared by several requests goes back to where it was before
+  // the first of them.
+  for (int32_t i = count - 1; i >= 0; i--)
+  {
+    _az_http_client_curl_slist_free(&requests[i], transfers[i].list);
+    if (transfers[i].curl != NULL)
+    {
+      curl_easy_cleanup(transfers[i].curl);
+    }
+
+    if (requests[i]._internal.arena != NULL)
+    {
+      _az_arena_rewind(requests[i]._internal.arena, transfers[i].arena_mark);
+    }
+  }
+
+  free(transfers);
+  return result;
+}
+
+// curl_global_init() isn't thread-safe, and is otherwise called by the first curl_easy_init(),
+// during the first request. The libraries it initializes are kept for the lifetime of the process.
+#ifdef _WIN32
+static INIT_ONCE _az_http_client_curl_global_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK
+_az_http_client_curl_global_init(PINIT_ONCE once, PVOID parameter, PVOID* context)
+{
+  (void)once;
+  (void)parameter;
+  (void)context;
+  return curl_global_init(CURL_GLOBAL_DEFAULT) == CURLE_OK;
+}
+#else
+static pthread_once_t _az_http_client_curl_global_once = PTHREAD_ONCE_INIT;
+static bool _az_http_client_curl_global_initialized = false;
+
+static void _az_http_client_curl_global_init(void)
+{
+  _az_http_client_curl_global_initialized = curl_global_init(CURL_GLOBAL_DEFAULT) == CURLE_OK;
+}
+#endif
+
+/**
+ * @brief Sends a HEAD request to \p url, which resolves its host name, opens a connection and
+ * negotiates a TLS session. They are reused by the next requests as long as the handle of the
+ * thread (TRANSPORT_CURL_REUSE_CONNECTIONS) or the share object (TRANSPORT_CURL_SHARE, and
+ * TRANSPORT_CURL_SHARE_CONNECTIONS for the connection) keeps them.
+ */
+static void _az_http_client_curl_warm_up(az_context const* context, az_span url)
+{
+  char* const buffer = (char*)malloc((size_t)az_span_size(url) + 1);
+  if (buffer == NULL)
+  {
+    return;
+  }
+
+  CURL* curl = NULL;
+  if (az_result_succeeded(_az_http_client_curl_init(&curl)) && curl != NULL)
+  {
+    az_span_to_str(buffer, az_span_size(url) + 1, url);
+
+    if (curl_easy_setopt(curl, CURLOPT_URL, buffer) == CURLE_OK
+#ifdef _az_CURL_MULTI_ENABLED
+        && _az_http_client_curl_multi_setup(curl, buffer) == CURLE_OK
+#endif // _az_CURL_MULTI_ENABLED
+        && curl_easy_setopt(curl, CURLOPT_NOBODY, 1L) == CURLE_OK
+        && az_result_succeeded(_az_http_client_curl_setup_context(curl, context)))
+    {
+      // The response doesn't matter, the connection is left open whatever its status code.
+      (void)_az_http_client_curl_perform(curl);
+    }
+
+    az_result const done_result = _az_http_client_curl_done(&curl);
+    (void)done_result;
+  }
+
+  free(buffer);
+}
+
+AZ_NODISCARD az_result
+az_http_client_init(az_context const* context, az_span const urls[], int32_t url_count)
+{
+  _az_PRECONDITION_RANGE(0, url_count, INT32_MAX);
+  _az_PRECONDITION(url_count == 0 || urls != NULL);
+
+#ifdef _WIN32
+  if (!InitOnceExecuteOnce(
+          &_az_http_client_curl_global_once, _az_http_client_curl_global_init, NULL, NULL))
+  {
+    return AZ_ERROR_HTTP_ADAPTER;
+  }
+#else
+  if (pthread_once(&_az_http_client_curl_global_once, _az_http_client_curl_global_init) != 0
+      || !_az_http_client_curl_global_initialized)
+  {
+    return AZ_ERROR_HTTP_ADAPTER;
+  }
+#endif
+
+  for (int32_t i = 0; i < url_count; i++)
+  {
+    _az_http_client_curl_warm_up(context == NULL ? &az_context_application : context, urls[i]);
+  }
+
+  return AZ_OK;
+}
@@ -0,0 +1,213 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_curl_multi_private.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <curl/curl.h>
+
+#include <azure/core/_az_cfg.h>
+
+// curl_multi_poll() and curl_multi_wakeup() were added in 7.68.0
+#if LIBCURL_VERSION_NUM < 0x074400
+#error "The az_curl_multi transport requires libcurl 7.68.0 or later."
+#endif
+
+enum
+{
+  // The longest time the driving thread waits for activity before checking its transfers again.
+  _az_CURL_MULTI_POLL_TIMEOUT_MILLISECONDS = 1000,
+};
+
+// A transfer waiting for, or being driven by, the shared multi handle. It lives on the stack of the
+// thread waiting for it, and is only touched with _az_curl_multi_mutex held.
+typedef struct _az_curl_multi_transfer
+{
+  CURL* easy;
+  struct _az_curl_multi_transfer* next;
+  CURLcode result;
+  bool is_done;
+} _az_curl_multi_transfer;
+
+static pthread_mutex_t _az_curl_multi_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _az_curl_multi_done_condition = PTHREAD_COND_INITIALIZER;
+
+static CURLM* _az_curl_multi = NULL;
+
+// Transfers submitted by any thread, which the driving thread adds to the multi handle. The multi
+// handle itself is only used by the driving thread, except for curl_multi_wakeup().
+static _az_curl_multi_transfer* _az_curl_multi_pending = NULL;
+
+// Transfers added to the multi handle.
+static _az_curl_multi_transfer* _az_curl_multi_active = NULL;
+
+// Whether a thread currently drives the multi handle.
+static bool _az_curl_multi_is_driven = false;
+
+// Must be called with _az_curl_multi_mutex held, and removes transfer from the active list.
+static void _az_curl_multi_complete(_az_curl_multi_transfer* transfer, CURLcode result)
+{
+  _az_curl_multi_transfer** link = &_az_curl_multi_active;
+  while (*link != transfer)
+  {
+    link = &(*link)->next;
+  }
+  *link = transfer->next;
+
+  transfer->result = result;
+  transfer->is_done = true;
+  pthread_cond_broadcast(&_az_curl_multi_done_condition);
+}
+
+// Must be called with _az_curl_multi_mutex held.
+static void _az_curl_multi_add_pending(void)
+{
+  while (_az_curl_multi_pending != NULL)
+  {
+    _az_curl_multi_transfer* const transfer = _az_curl_multi_pending;
+    _az_curl_multi_pending = transfer->next;
+
+    transfer->next = _az_curl_multi_active;
+    _az_curl_multi_active = transfer;
+
+    if (curl_multi_add_handle(_az_curl_multi, transfer->easy) != CURLM_OK)
+    {
+      _az_curl_multi_complete(transfer, CURLE_FAILED_INIT);
+    }
+  }
+}
+
+// Must be called with _az_curl_multi_mutex held.
+static void _az_curl_multi_complete_finished(void)
+{
+  CURLMsg* message = NULL;
+  int messages_left = 0;
+  while ((message = curl_multi_info_read(_az_curl_multi, &messages_left)) != NULL)
+  {
+    if (message->msg == CURLMSG_DONE)
+    {
+      char* transfer = NULL;
+      (void)curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &transfer);
+      CURLcode const result = message->data.result;
+
+      (void)curl_multi_remove_handle(_az_curl_multi, message->easy_handle);
+      _az_curl_multi_complete((_az_curl_multi_transfer*)(void*)transfer, result);
+    }
+  }
+}
+
+// Must be called with _az_curl_multi_mutex held, which is released while the transfers make
+// progress. Returns once own_transfer is done.
+static void _az_curl_multi_drive(_az_curl_multi_transfer const* own_transfer)
+{
+  while (true)
+  {
+    _az_curl_multi_add_pending();
+    if (own_transfer->is_done)
+    {
+      return;
+    }
+
+    pthread_mutex_unlock(&_az_curl_multi_mutex);
+    int running = 0;
+    CURLMcode const perform_result = curl_multi_perform(_az_curl_multi, &running);
+    pthread_mutex_lock(&_az_curl_multi_mutex);
+
+    if (perform_result != CURLM_OK)
+    {
+      // The multi handle can't make progress anymore, so fail every transfer it has.
+      while (_az_curl_multi_active != NULL)
+      {
+        (void)curl_multi_remove_handle(_az_curl_multi, _az_curl_multi_active->easy);
+        _az_curl_multi_complete(_az_curl_multi_active, CURLE_FAILED_INIT);
+      }
+      continue;
+    }
+
+    _az_curl_multi_complete_finished();
+    if (own_transfer->is_done)
+    {
+      return;
+    }
+
+    pthread_mutex_unlock(&_az_curl_multi_mutex);
+    (void)curl_multi_poll(_az_curl_multi, NULL, 0, _az_CURL_MULTI_POLL_TIMEOUT_MILLISECONDS, NULL);
+    pthread_mutex_lock(&_az_curl_multi_mutex);
+  }
+}
+
+CURLcode _az_http_client_curl_multi_setup(CURL* ref_curl, char const* url)
+{
+  // HTTP/2 is only negotiated over TLS, plain HTTP keeps using HTTP/1.1.
+  CURLcode const result = curl_easy_setopt(ref_curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+  if (result != CURLE_OK)
+  {
+    return result;
+  }
+
+  // Waiting for an HTTP/1.1 connection to find out whether it can be multiplexed only serializes
+  // the requests, so only wait when HTTP/2 is possible.
+  long const pipe_wait = strncmp(url, "https://", sizeof("https://") - 1) == 0 ? 1L : 0L;
+  return curl_easy_setopt(ref_curl, CURLOPT_PIPEWAIT, pipe_wait);
+}
+
+CURLcode _az_http_client_curl_multi_perform(CURL* ref_curl)
+{
+  _az_curl_multi_transfer transfer = {
+    .easy = ref_curl,
+    .next = NULL,
+    .result = CURLE_OK,
+    .is_done = false,
+  };
+
+  CURLcode const result = curl_easy_setopt(ref_curl, CURLOPT_PRIVATE, (void*)&transfer);
+  if (result != CURLE_OK)
+  {
+    return result;
+  }
+
+  pthread_mutex_lock(&_az_curl_multi_mutex);
+
+  if (_az_curl_multi == NULL)
+  {
+    _az_curl_multi = curl_multi_init();
+    if (_az_curl_multi == NULL)
+    {
+      pthread_mutex_unlock(&_az_curl_multi_mutex);
+      return CURLE_FAILED_INIT;
+    }
+    (void)curl_multi_setopt(_az_curl_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  }
+
+  transfer.next = _az_curl_multi_pending;
+  _az_curl_multi_pending = &transfer;
+
+  if (_az_curl_multi_is_driven)
+  {
+    // Let the driving thread pick up the new transfer right away.
+    (void)curl_multi_wakeup(_az_curl_multi);
+  }
+
+  while (!transfer.is_done)
+  {
+    if (_az_curl_multi_is_driven)
+    {
+      pthread_cond_wait(&_az_curl_multi_done_condition, &_az_curl_multi_mutex);
+      continue;
+    }
+
+    _az_curl_multi_is_driven = true;
+    _az_curl_multi_drive(&transfer);
+    _az_curl_multi_is_driven = false;
+
+    // Another waiting thread takes over driving the transfers which are still in progress.
+    pthread_cond_broadcast(&_az_curl_multi_done_condition);
+  }
+
+  pthread_mutex_unlock(&_az_curl_multi_mutex);
+  return transfer.result;
+}
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_curl_multi_private.h
+ *
+ * @brief The shared CURL multi handle driving the transfers of the `az_curl_multi` transport.
+ */
+
+#ifndef _az_CURL_MULTI_PRIVATE_H
+#define _az_CURL_MULTI_PRIVATE_H
+
+#include <curl/curl.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/**
+ * @brief Sets up \p ref_curl to use HTTP/2 when sending a request to \p url.
+ *
+ * @details For `https` URLs, where HTTP/2 can be negotiated, the transfer waits for a connection
+ * that can be multiplexed rather than opening a new one, so concurrent requests to the same host
+ * share one connection. Plain HTTP/1.1 transfers don't wait, since they can't share connections.
+ *
+ * @param ref_curl The CURL easy handle of the transfer.
+ * @param[in] url The 0-terminated URL of the request.
+ *
+ * @return The result of setting the options.
+ */
+CURLcode _az_http_client_curl_multi_setup(CURL* ref_curl, char const* url);
+
+/**
+ * @brief Performs the transfer of \p ref_curl, which must be fully set up, through the CURL multi
+ * handle shared by all the threads of the process, and waits for it to complete.
+ *
+ * @details This is a drop-in replacement of `curl_easy_perform()`. While a thread waits for its
+ * transfer, either it or another waiting thread drives all the transfers of the multi handle.
+ *
+ * @param ref_curl The CURL easy handle of the transfer.
+ *
+ * @return The result of the transfer, as `curl_easy_perform()` would have returned it.
+ */
+CURLcode _az_http_client_curl_multi_perform(CURL* ref_curl);
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_CURL_MULTI_PRIVATE_H
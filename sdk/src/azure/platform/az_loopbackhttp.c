@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_loopback.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  // The request body is read, as a network transport would, through a buffer of this size.
+  _az_LOOPBACK_BODY_BUFFER_SIZE = 256,
+
+  // "HTTP/1.1 200 \r\n", the reason phrase being empty.
+  _az_LOOPBACK_STATUS_LINE_SIZE = 15,
+
+  // "Content-Length: " followed by up to 10 digits and a CRLF.
+  _az_LOOPBACK_CONTENT_LENGTH_SIZE = 28,
+};
+
+static az_http_loopback* _az_http_loopback_current = NULL;
+
+AZ_NODISCARD az_result az_http_loopback_init(
+    az_http_loopback* out_loopback,
+    az_http_loopback_response const responses[],
+    int32_t response_count,
+    int32_t latency_usec)
+{
+  _az_PRECONDITION_NOT_NULL(out_loopback);
+  _az_PRECONDITION_NOT_NULL(responses);
+  _az_PRECONDITION_RANGE(1, response_count, INT32_MAX);
+  _az_PRECONDITION_RANGE(0, latency_usec, INT32_MAX);
+
+  *out_loopback = (az_http_loopback){
+    ._internal = {
+      .responses = responses,
+      .response_count = response_count,
+      .latency_usec = latency_usec,
+      .next_response = 0,
+      .request_count = 0,
+    },
+  };
+
+  return AZ_OK;
+}
+
+void az_http_loopback_set(az_http_loopback* loopback) { _az_http_loopback_current = loopback; }
+
+// Waits for the latency of the loopback, without giving up the CPU.
+static void _az_http_loopback_wait(int32_t latency_usec)
+{
+  int64_t start = 0;
+  if (latency_usec == 0 || az_result_failed(az_platform_clock_usec(&start)))
+  {
+    return;
+  }
+
+  int64_t now = start;
+  while (now - start < latency_usec && az_result_succeeded(az_platform_clock_usec(&now)))
+  {
+  }
+}
+
+// Reads the whole body of the request, so that body readers and compressed bodies are produced as
+// they would be for the network.
+static AZ_NODISCARD az_result _az_http_loopback_read_body(az_http_request const* request)
+{
+  uint8_t buffer[_az_LOOPBACK_BODY_BUFFER_SIZE];
+  int64_t offset = 0;
+  int32_t size = 0;
+  do
+  {
+    _az_RETURN_IF_FAILED(
+        az_http_request_read_body(request, offset, AZ_SPAN_FROM_BUFFER(buffer), &size));
+    offset += size;
+  } while (size > 0);
+
+  return AZ_OK;
+}
+
+static AZ_NODISCARD az_result _az_http_loopback_write_response(
+    az_http_loopback_response const* response,
+    az_http_response* ref_response)
+{
+  uint8_t status_line[_az_LOOPBACK_STATUS_LINE_SIZE] = "HTTP/1.1 000 \r\n";
+  int32_t status_code = (int32_t)response->status_code;
+  for (int32_t i = 11; i >= 9; i--)
+  {
+    status_line[i] = (uint8_t)('0' + (status_code % 10));
+    status_code /= 10;
+  }
+
+  _az_RETURN_IF_FAILED(az_http_response_append(ref_response, AZ_SPAN_FROM_BUFFER(status_line)));
+  _az_RETURN_IF_FAILED(az_http_response_append(ref_response, response->headers));
+
+  uint8_t content_length[_az_LOOPBACK_CONTENT_LENGTH_SIZE];
+  az_span remainder
+      = az_span_copy(AZ_SPAN_FROM_BUFFER(content_length), AZ_SPAN_FROM_STR("Content-Length: "));
+  _az_RETURN_IF_FAILED(az_span_i32toa(remainder, az_span_size(response->body), &remainder));
+  remainder = az_span_copy(remainder, AZ_SPAN_FROM_STR("\r\n\r\n"));
+  _az_RETURN_IF_FAILED(az_http_response_append(
+      ref_response,
+      az_span_slice(
+          AZ_SPAN_FROM_BUFFER(content_length),
+          0,
+          _az_LOOPBACK_CONTENT_LENGTH_SIZE - az_span_size(remainder))));
+
+  return az_http_response_append_body(ref_response, response->body);
+}
+
+AZ_NODISCARD az_result
+az_http_client_send_request(az_http_request const* request, az_http_response* ref_response)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(ref_response);
+
+  az_http_loopback* const loopback = _az_http_loopback_current;
+  if (loopback == NULL)
+  {
+    return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
+  }
+
+  _az_RETURN_IF_FAILED(_az_http_loopback_read_body(request));
+  _az_http_loopback_wait(loopback->_internal.latency_usec);
+
+  az_http_loopback_response const* const response
+      = &loopback->_internal.responses[loopback->_internal.next_response];
+  loopback->_internal.next_response
+      = (loopback->_internal.next_response + 1) % loopback->_internal.response_count;
+  loopback->_internal.request_count++;
+
+  return _az_http_loopback_write_response(response, ref_response);
+}
+
+AZ_NODISCARD az_result az_http_client_send_hedged_request(
+    az_http_request const* request,
+    az_http_response* ref_response,
+    az_http_response* ref_hedge_response,
+    int32_t hedge_delay_msec,
+    bool* out_hedge_won)
+{
+  (void)request;
+  (void)ref_response;
+  (void)ref_hedge_response;
+  (void)hedge_delay_msec;
+  (void)out_hedge_won;
+  return AZ_ERROR_NOT_SUPPORTED;
+}
+
+AZ_NODISCARD az_result az_http_client_send_requests(
+    az_http_request const requests[],
+    az_http_response ref_responses[],
+    az_result out_results[],
+    int32_t count)
+{
+  _az_PRECONDITION_NOT_NULL(requests);
+  _az_PRECONDITION_NOT_NULL(ref_responses);
+  _az_PRECONDITION_NOT_NULL(out_results);
+  _az_PRECONDITION_RANGE(1, count, INT32_MAX);
+
+  // The loopback serves one request at a time.
+  az_result result = AZ_OK;
+  for (int32_t i = 0; i < count; i++)
+  {
+    out_results[i] = az_http_client_send_request(&requests[i], &ref_responses[i]);
+    if (az_result_failed(out_results[i]) && az_result_succeeded(result))
+    {
+      result = out_results[i];
+    }
+  }
+
+  return result;
+}
+
+AZ_NODISCARD az_result
+az_http_client_init(az_context const* context, az_span const urls[], int32_t url_count)
+{
+  (void)context;
+  (void)urls;
+  (void)url_count;
+  return AZ_OK;
+}
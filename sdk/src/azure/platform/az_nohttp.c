@@ -12,3 +12,40 @@ az_http_client_send_request(az_http_request const* request, az_http_response* re
   (void)ref_response;
   return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
 }
+
+AZ_NODISCARD az_result az_http_client_send_hedged_request(
+    az_http_request const* request,
+    az_http_response* ref_response,
+    az_http_response* ref_hedge_response,
+    int32_t hedge_delay_msec,
+    bool* out_hedge_won)
+{
+  (void)request;
+  (void)ref_response;
+  (void)ref_hedge_response;
+  (void)hedge_delay_msec;
+  (void)out_hedge_won;
+  return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
+}
+
+AZ_NODISCARD az_result az_http_client_send_requests(
+    az_http_request const requests[],
+    az_http_response ref_responses[],
+    az_result out_results[],
+    int32_t count)
+{
+  (void)requests;
+  (void)ref_responses;
+  (void)out_results;
+  (void)count;
+  return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
+}
+
+AZ_NODISCARD az_result
+az_http_client_init(az_context const* context, az_span const urls[], int32_t url_count)
+{
+  (void)context;
+  (void)urls;
+  (void)url_count;
+  return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
+}
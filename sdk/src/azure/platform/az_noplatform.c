@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 
 #include <azure/core/az_platform.h>
+#include <azure/core/internal/az_platform_internal.h>
 #include <azure/core/internal/az_precondition_internal.h>
 
 #include <azure/core/_az_cfg.h>
@@ -13,8 +14,74 @@ AZ_NODISCARD az_result az_platform_clock_msec(int64_t* out_clock_msec)
   return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
 }
 
+AZ_NODISCARD az_result az_platform_clock_usec(int64_t* out_clock_usec)
+{
+  _az_PRECONDITION_NOT_NULL(out_clock_usec);
+  *out_clock_usec = 0;
+  return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
+}
+
 AZ_NODISCARD az_result az_platform_sleep_msec(int32_t milliseconds)
 {
   (void)milliseconds;
   return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
 }
+
+AZ_NODISCARD az_result az_platform_event_init(az_platform_event* out_event)
+{
+  _az_PRECONDITION_NOT_NULL(out_event);
+  out_event->_internal.handle = NULL;
+  out_event->_internal.is_set = false;
+  return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
+}
+
+AZ_NODISCARD az_result az_platform_event_set(az_platform_event* ref_event)
+{
+  (void)ref_event;
+  return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
+}
+
+AZ_NODISCARD az_result
+az_platform_event_wait(az_platform_event* ref_event, int32_t timeout_msec, bool* out_is_set)
+{
+  (void)ref_event;
+  (void)timeout_msec;
+  _az_PRECONDITION_NOT_NULL(out_is_set);
+  *out_is_set = false;
+  return AZ_ERROR_DEPENDENCY_NOT_PROVIDED;
+}
+
+void az_platform_event_deinit(az_platform_event* ref_event) { (void)ref_event; }
+
+// Without threads, the executor runs every work item on the thread submitting it.
+AZ_NODISCARD az_result az_platform_executor_init(
+    az_platform_executor* out_executor,
+    az_platform_executor_worker workers[],
+    int32_t worker_count,
+    az_platform_work_item work_items[],
+    int32_t work_item_count)
+{
+  _az_platform_executor_init(out_executor, workers, worker_count, work_items, work_item_count);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_platform_executor_submit(
+    az_platform_executor* ref_executor,
+    az_platform_work_fn work,
+    void* work_context)
+{
+  _az_PRECONDITION_NOT_NULL(ref_executor);
+  _az_PRECONDITION_NOT_NULL(work);
+  (void)ref_executor;
+
+  work(work_context);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_platform_executor_wait(az_platform_executor* ref_executor)
+{
+  (void)ref_executor;
+  return AZ_OK;
+}
+
+void az_platform_executor_deinit(az_platform_executor* ref_executor) { (void)ref_executor; }
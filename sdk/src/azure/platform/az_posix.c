@@ -3,8 +3,13 @@
 
 #include <azure/core/az_platform.h>
 #include <azure/core/internal/az_config_internal.h>
+#include <azure/core/internal/az_platform_internal.h>
 #include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
 
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
 #include <time.h>
 
 #include <unistd.h>
@@ -15,8 +20,27 @@ AZ_NODISCARD az_result az_platform_clock_msec(int64_t* out_clock_msec)
 {
   _az_PRECONDITION_NOT_NULL(out_clock_msec);
 
-  // NOLINTNEXTLINE(bugprone-misplaced-widening-cast)
-  *out_clock_msec = (int64_t)((clock() / CLOCKS_PER_SEC) * _az_TIME_MILLISECONDS_PER_SECOND);
+  int64_t clock_usec = 0;
+  _az_RETURN_IF_FAILED(az_platform_clock_usec(&clock_usec));
+  *out_clock_msec = clock_usec / _az_TIME_MICROSECONDS_PER_MILLISECOND;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_platform_clock_usec(int64_t* out_clock_usec)
+{
+  _az_PRECONDITION_NOT_NULL(out_clock_usec);
+
+  // Unlike clock(), which is the processor time of the process, or CLOCK_REALTIME, which follows
+  // the adjustments of the wall clock, CLOCK_MONOTONIC measures the time elapsed.
+  struct timespec now;
+  if (clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  *out_clock_usec = (int64_t)now.tv_sec * _az_TIME_MICROSECONDS_PER_SECOND
+      + (int64_t)now.tv_nsec / _az_TIME_NANOSECONDS_PER_MICROSECOND;
 
   return AZ_OK;
 }
@@ -26,3 +50,247 @@ AZ_NODISCARD az_result az_platform_sleep_msec(int32_t milliseconds)
   (void)usleep((useconds_t)milliseconds * _az_TIME_MICROSECONDS_PER_MILLISECOND);
   return AZ_OK;
 }
+
+// All the events share one mutex and condition variable, so that an event needs no storage of its
+// own. Setting one event wakes up the threads waiting for the others too, which go back to waiting
+// as their own event isn't set.
+static pthread_mutex_t _az_posix_event_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _az_posix_event_condition = PTHREAD_COND_INITIALIZER;
+static pthread_once_t _az_posix_event_once = PTHREAD_ONCE_INIT;
+
+// The clock the condition variable times out on.
+static clockid_t _az_posix_event_clock = CLOCK_REALTIME;
+
+// Makes the waits time out on the monotonic clock when the platform supports it, so that they
+// aren't shortened or extended by the adjustments of the wall clock.
+static void _az_posix_event_init_condition(void)
+{
+#ifndef __APPLE__
+  pthread_condattr_t attributes;
+  if (pthread_condattr_init(&attributes) != 0)
+  {
+    return;
+  }
+
+  if (pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC) == 0
+      && pthread_cond_destroy(&_az_posix_event_condition) == 0)
+  {
+    if (pthread_cond_init(&_az_posix_event_condition, &attributes) == 0)
+    {
+      _az_posix_event_clock = CLOCK_MONOTONIC;
+    }
+    else
+    {
+      (void)pthread_cond_init(&_az_posix_event_condition, NULL);
+    }
+  }
+
+  (void)pthread_condattr_destroy(&attributes);
+#endif // __APPLE__
+}
+
+AZ_NODISCARD az_result az_platform_event_init(az_platform_event* out_event)
+{
+  _az_PRECONDITION_NOT_NULL(out_event);
+
+  (void)pthread_once(&_az_posix_event_once, _az_posix_event_init_condition);
+
+  out_event->_internal.handle = NULL;
+  out_event->_internal.is_set = false;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_platform_event_set(az_platform_event* ref_event)
+{
+  _az_PRECONDITION_NOT_NULL(ref_event);
+
+  (void)pthread_mutex_lock(&_az_posix_event_mutex);
+  ref_event->_internal.is_set = true;
+  (void)pthread_cond_broadcast(&_az_posix_event_condition);
+  (void)pthread_mutex_unlock(&_az_posix_event_mutex);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_platform_event_wait(az_platform_event* ref_event, int32_t timeout_msec, bool* out_is_set)
+{
+  _az_PRECONDITION_NOT_NULL(ref_event);
+  _az_PRECONDITION_RANGE(0, timeout_msec, INT32_MAX);
+  _az_PRECONDITION_NOT_NULL(out_is_set);
+
+  struct timespec deadline;
+  if (clock_gettime(_az_posix_event_clock, &deadline) != 0)
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  deadline.tv_sec += timeout_msec / _az_TIME_MILLISECONDS_PER_SECOND;
+  deadline.tv_nsec += (long)(timeout_msec % _az_TIME_MILLISECONDS_PER_SECOND)
+      * _az_TIME_NANOSECONDS_PER_MILLISECOND;
+  if (deadline.tv_nsec >= _az_TIME_NANOSECONDS_PER_SECOND)
+  {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= _az_TIME_NANOSECONDS_PER_SECOND;
+  }
+
+  (void)pthread_mutex_lock(&_az_posix_event_mutex);
+  while (!ref_event->_internal.is_set)
+  {
+    if (pthread_cond_timedwait(&_az_posix_event_condition, &_az_posix_event_mutex, &deadline)
+        == ETIMEDOUT)
+    {
+      break;
+    }
+  }
+
+  *out_is_set = ref_event->_internal.is_set;
+  ref_event->_internal.is_set = false;
+  (void)pthread_mutex_unlock(&_az_posix_event_mutex);
+
+  return AZ_OK;
+}
+
+void az_platform_event_deinit(az_platform_event* ref_event)
+{
+  _az_PRECONDITION_NOT_NULL(ref_event);
+  ref_event->_internal.is_set = false;
+}
+
+// The executors are serialized by a single lock, whose condition wakes the idle workers and the
+// waiting threads.
+static pthread_mutex_t _az_posix_executor_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _az_posix_executor_condition = PTHREAD_COND_INITIALIZER;
+
+// The pthread_t of a worker is kept in its thread handle.
+typedef char _az_posix_thread_fits_handle[sizeof(pthread_t) <= sizeof(void*) ? 1 : -1];
+
+static void* _az_posix_executor_run(void* worker_context)
+{
+  az_platform_executor_worker* const worker = (az_platform_executor_worker*)worker_context;
+  az_platform_executor* const executor = worker->_internal.executor;
+
+  (void)pthread_mutex_lock(&_az_posix_executor_mutex);
+  while (true)
+  {
+    az_platform_work_item item;
+    if (_az_platform_executor_take(executor, worker->_internal.index, &item))
+    {
+      (void)pthread_mutex_unlock(&_az_posix_executor_mutex);
+      item._internal.work(item._internal.work_context);
+      (void)pthread_mutex_lock(&_az_posix_executor_mutex);
+
+      if (_az_platform_executor_done(executor))
+      {
+        (void)pthread_cond_broadcast(&_az_posix_executor_condition);
+      }
+    }
+    else if (executor->_internal.is_stopping)
+    {
+      break;
+    }
+    else
+    {
+      (void)pthread_cond_wait(&_az_posix_executor_condition, &_az_posix_executor_mutex);
+    }
+  }
+  (void)pthread_mutex_unlock(&_az_posix_executor_mutex);
+
+  return NULL;
+}
+
+static void _az_posix_executor_join(az_platform_executor* ref_executor, int32_t worker_count)
+{
+  (void)pthread_mutex_lock(&_az_posix_executor_mutex);
+  ref_executor->_internal.is_stopping = true;
+  (void)pthread_cond_broadcast(&_az_posix_executor_condition);
+  (void)pthread_mutex_unlock(&_az_posix_executor_mutex);
+
+  for (int32_t i = 0; i < worker_count; i++)
+  {
+    pthread_t thread;
+    memcpy(&thread, &ref_executor->_internal.workers[i]._internal.thread, sizeof(thread));
+    (void)pthread_join(thread, NULL);
+  }
+}
+
+AZ_NODISCARD az_result az_platform_executor_init(
+    az_platform_executor* out_executor,
+    az_platform_executor_worker workers[],
+    int32_t worker_count,
+    az_platform_work_item work_items[],
+    int32_t work_item_count)
+{
+  _az_platform_executor_init(out_executor, workers, worker_count, work_items, work_item_count);
+
+  for (int32_t i = 0; i < worker_count; i++)
+  {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, _az_posix_executor_run, &workers[i]) != 0)
+    {
+      _az_posix_executor_join(out_executor, i);
+      return AZ_ERROR_OUT_OF_MEMORY;
+    }
+
+    memcpy(&workers[i]._internal.thread, &thread, sizeof(thread));
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_platform_executor_submit(
+    az_platform_executor* ref_executor,
+    az_platform_work_fn work,
+    void* work_context)
+{
+  _az_PRECONDITION_NOT_NULL(ref_executor);
+  _az_PRECONDITION_NOT_NULL(work);
+
+  az_platform_work_item const item
+      = { ._internal = { .work = work, .work_context = work_context } };
+
+  (void)pthread_mutex_lock(&_az_posix_executor_mutex);
+  az_result const result = _az_platform_executor_push(ref_executor, item);
+  if (az_result_succeeded(result))
+  {
+    (void)pthread_cond_broadcast(&_az_posix_executor_condition);
+  }
+  (void)pthread_mutex_unlock(&_az_posix_executor_mutex);
+
+  return result;
+}
+
+AZ_NODISCARD az_result az_platform_executor_wait(az_platform_executor* ref_executor)
+{
+  _az_PRECONDITION_NOT_NULL(ref_executor);
+
+  (void)pthread_mutex_lock(&_az_posix_executor_mutex);
+  while (ref_executor->_internal.pending_count > 0)
+  {
+    az_platform_work_item item;
+    if (_az_platform_executor_take(ref_executor, -1, &item))
+    {
+      (void)pthread_mutex_unlock(&_az_posix_executor_mutex);
+      item._internal.work(item._internal.work_context);
+      (void)pthread_mutex_lock(&_az_posix_executor_mutex);
+
+      if (_az_platform_executor_done(ref_executor))
+      {
+        (void)pthread_cond_broadcast(&_az_posix_executor_condition);
+      }
+    }
+    else
+    {
+      (void)pthread_cond_wait(&_az_posix_executor_condition, &_az_posix_executor_mutex);
+    }
+  }
+  (void)pthread_mutex_unlock(&_az_posix_executor_mutex);
+
+  return AZ_OK;
+}
+
+void az_platform_executor_deinit(az_platform_executor* ref_executor)
+{
+  _az_PRECONDITION_NOT_NULL(ref_executor);
+  _az_posix_executor_join(ref_executor, ref_executor->_internal.worker_count);
+}
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: MIT
 
 #include <azure/core/az_platform.h>
+#include <azure/core/internal/az_config_internal.h>
+#include <azure/core/internal/az_platform_internal.h>
 #include <azure/core/internal/az_precondition_internal.h>
 
 // Two macros below are not used in the code below, it is windows.h that consumes them.
@@ -18,8 +20,217 @@ AZ_NODISCARD az_result az_platform_clock_msec(int64_t* out_clock_msec)
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result az_platform_clock_usec(int64_t* out_clock_usec)
+{
+  _az_PRECONDITION_NOT_NULL(out_clock_usec);
+
+  // The frequency of the performance counter is fixed at boot, so it is only queried once.
+  static LARGE_INTEGER frequency = { 0 };
+  if (frequency.QuadPart == 0 && !QueryPerformanceFrequency(&frequency))
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  LARGE_INTEGER counter;
+  (void)QueryPerformanceCounter(&counter);
+
+  // Converting the seconds and the remaining ticks separately doesn't overflow.
+  *out_clock_usec = (counter.QuadPart / frequency.QuadPart) * _az_TIME_MICROSECONDS_PER_SECOND
+      + ((counter.QuadPart % frequency.QuadPart) * _az_TIME_MICROSECONDS_PER_SECOND)
+          / frequency.QuadPart;
+  return AZ_OK;
+}
+
 AZ_NODISCARD az_result az_platform_sleep_msec(int32_t milliseconds)
 {
   Sleep(milliseconds);
   return AZ_OK;
 }
+
+AZ_NODISCARD az_result az_platform_event_init(az_platform_event* out_event)
+{
+  _az_PRECONDITION_NOT_NULL(out_event);
+
+  // An auto-reset event, which a wait resets as it returns.
+  HANDLE const event = CreateEventW(NULL, FALSE, FALSE, NULL);
+  if (event == NULL)
+  {
+    return AZ_ERROR_OUT_OF_MEMORY;
+  }
+
+  out_event->_internal.handle = event;
+  out_event->_internal.is_set = false;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_platform_event_set(az_platform_event* ref_event)
+{
+  _az_PRECONDITION_NOT_NULL(ref_event);
+  (void)SetEvent(ref_event->_internal.handle);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_platform_event_wait(az_platform_event* ref_event, int32_t timeout_msec, bool* out_is_set)
+{
+  _az_PRECONDITION_NOT_NULL(ref_event);
+  _az_PRECONDITION_RANGE(0, timeout_msec, INT32_MAX);
+  _az_PRECONDITION_NOT_NULL(out_is_set);
+
+  DWORD const result = WaitForSingleObject(ref_event->_internal.handle, (DWORD)timeout_msec);
+  if (result != WAIT_OBJECT_0 && result != WAIT_TIMEOUT)
+  {
+    return AZ_ERROR_ARG;
+  }
+
+  *out_is_set = result == WAIT_OBJECT_0;
+  return AZ_OK;
+}
+
+void az_platform_event_deinit(az_platform_event* ref_event)
+{
+  _az_PRECONDITION_NOT_NULL(ref_event);
+
+  if (ref_event->_internal.handle != NULL)
+  {
+    (void)CloseHandle(ref_event->_internal.handle);
+    ref_event->_internal.handle = NULL;
+  }
+}
+
+// The executors are serialized by a single lock, whose condition wakes the idle workers and the
+// waiting threads.
+static SRWLOCK _az_win32_executor_lock = SRWLOCK_INIT;
+static CONDITION_VARIABLE _az_win32_executor_condition = CONDITION_VARIABLE_INIT;
+
+static DWORD WINAPI _az_win32_executor_run(LPVOID worker_context)
+{
+  az_platform_executor_worker* const worker = (az_platform_executor_worker*)worker_context;
+  az_platform_executor* const executor = worker->_internal.executor;
+
+  AcquireSRWLockExclusive(&_az_win32_executor_lock);
+  while (true)
+  {
+    az_platform_work_item item;
+    if (_az_platform_executor_take(executor, worker->_internal.index, &item))
+    {
+      ReleaseSRWLockExclusive(&_az_win32_executor_lock);
+      item._internal.work(item._internal.work_context);
+      AcquireSRWLockExclusive(&_az_win32_executor_lock);
+
+      if (_az_platform_executor_done(executor))
+      {
+        WakeAllConditionVariable(&_az_win32_executor_condition);
+      }
+    }
+    else if (executor->_internal.is_stopping)
+    {
+      break;
+    }
+    else
+    {
+      (void)SleepConditionVariableSRW(
+          &_az_win32_executor_condition, &_az_win32_executor_lock, INFINITE, 0);
+    }
+  }
+  ReleaseSRWLockExclusive(&_az_win32_executor_lock);
+
+  return 0;
+}
+
+static void _az_win32_executor_join(az_platform_executor* ref_executor, int32_t worker_count)
+{
+  AcquireSRWLockExclusive(&_az_win32_executor_lock);
+  ref_executor->_internal.is_stopping = true;
+  WakeAllConditionVariable(&_az_win32_executor_condition);
+  ReleaseSRWLockExclusive(&_az_win32_executor_lock);
+
+  for (int32_t i = 0; i < worker_count; i++)
+  {
+    HANDLE const thread = ref_executor->_internal.workers[i]._internal.thread;
+    (void)WaitForSingleObject(thread, INFINITE);
+    (void)CloseHandle(thread);
+  }
+}
+
+AZ_NODISCARD az_result az_platform_executor_init(
+    az_platform_executor* out_executor,
+    az_platform_executor_worker workers[],
+    int32_t worker_count,
+    az_platform_work_item work_items[],
+    int32_t work_item_count)
+{
+  _az_platform_executor_init(out_executor, workers, worker_count, work_items, work_item_count);
+
+  for (int32_t i = 0; i < worker_count; i++)
+  {
+    HANDLE const thread = CreateThread(NULL, 0, _az_win32_executor_run, &workers[i], 0, NULL);
+    if (thread == NULL)
+    {
+      _az_win32_executor_join(out_executor, i);
+      return AZ_ERROR_OUT_OF_MEMORY;
+    }
+
+    workers[i]._internal.thread = thread;
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_platform_executor_submit(
+    az_platform_executor* ref_executor,
+    az_platform_work_fn work,
+    void* work_context)
+{
+  _az_PRECONDITION_NOT_NULL(ref_executor);
+  _az_PRECONDITION_NOT_NULL(work);
+
+  az_platform_work_item const item
+      = { ._internal = { .work = work, .work_context = work_context } };
+
+  AcquireSRWLockExclusive(&_az_win32_executor_lock);
+  az_result const result = _az_platform_executor_push(ref_executor, item);
+  if (az_result_succeeded(result))
+  {
+    WakeAllConditionVariable(&_az_win32_executor_condition);
+  }
+  ReleaseSRWLockExclusive(&_az_win32_executor_lock);
+
+  return result;
+}
+
+AZ_NODISCARD az_result az_platform_executor_wait(az_platform_executor* ref_executor)
+{
+  _az_PRECONDITION_NOT_NULL(ref_executor);
+
+  AcquireSRWLockExclusive(&_az_win32_executor_lock);
+  while (ref_executor->_internal.pending_count > 0)
+  {
+    az_platform_work_item item;
+    if (_az_platform_executor_take(ref_executor, -1, &item))
+    {
+      ReleaseSRWLockExclusive(&_az_win32_executor_lock);
+      item._internal.work(item._internal.work_context);
+      AcquireSRWLockExclusive(&_az_win32_executor_lock);
+
+      if (_az_platform_executor_done(ref_executor))
+      {
+        WakeAllConditionVariable(&_az_win32_executor_condition);
+      }
+    }
+    else
+    {
+      (void)SleepConditionVariableSRW(
+          &_az_win32_executor_condition, &_az_win32_executor_lock, INFINITE, 0);
+    }
+  }
+  ReleaseSRWLockExclusive(&_az_win32_executor_lock);
+
+  return AZ_OK;
+}
+
+void az_platform_executor_deinit(az_platform_executor* ref_executor)
+{
+  _az_PRECONDITION_NOT_NULL(ref_executor);
+  _az_win32_executor_join(ref_executor, ref_executor->_internal.worker_count);
+}
@@ -0,0 +1,818 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Two macros below are not used in the code below, it is windows.h that consumes them.
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+#include <winhttp.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  // How often a transfer in progress checks whether its context was canceled, in milliseconds.
+  _az_WINHTTP_CANCEL_POLL_MSEC = 1000,
+
+  // The response body is read through a buffer of this size on the stack.
+  _az_WINHTTP_READ_BUFFER_SIZE = 8192,
+
+  // The longest method, including its terminating 0.
+  _az_WINHTTP_METHOD_SIZE = 16,
+};
+
+/**
+ * @brief The state of a request, shared with the status callback of the session. WinHTTP completes
+ * every operation of the request asynchronously, and the callback wakes the thread sending the
+ * request, which waits for it with the time left until its context expires.
+ */
+typedef struct
+{
+  HINTERNET request;
+  // An auto-reset event, set by the callback once the pending operation completed.
+  HANDLE completed;
+  // The error of the pending operation, ERROR_SUCCESS if it succeeded.
+  DWORD error;
+  // The number of bytes read by the pending operation.
+  DWORD bytes_read;
+  // Set by the callback once the request handle is closed, after which no callback refers to
+  // this state anymore.
+  LONG volatile closed;
+} _az_http_client_winhttp_request;
+
+static void CALLBACK _az_http_client_winhttp_callback(
+    HINTERNET handle,
+    DWORD_PTR context,
+    DWORD status,
+    LPVOID info,
+    DWORD info_length)
+{
+  (void)handle;
+
+  // The connection handles have no context.
+  _az_http_client_winhttp_request* const state = (_az_http_client_winhttp_request*)context;
+  if (state == NULL)
+  {
+    return;
+  }
+
+  switch (status)
+  {
+    case WINHTTP_CALLBACK_STATUS_SENDREQUEST_COMPLETE:
+    case WINHTTP_CALLBACK_STATUS_WRITE_COMPLETE:
+    case WINHTTP_CALLBACK_STATUS_HEADERS_AVAILABLE:
+      (void)SetEvent(state->completed);
+      break;
+
+    case WINHTTP_CALLBACK_STATUS_READ_COMPLETE:
+      state->bytes_read = info_length;
+      (void)SetEvent(state->completed);
+      break;
+
+    case WINHTTP_CALLBACK_STATUS_REQUEST_ERROR:
+      state->error = ((WINHTTP_ASYNC_RESULT const*)info)->dwError;
+      (void)SetEvent(state->completed);
+      break;
+
+    case WINHTTP_CALLBACK_STATUS_HANDLE_CLOSING:
+      (void)InterlockedExchange(&state->closed, 1);
+      (void)SetEvent(state->completed);
+      break;
+
+    default:
+      break;
+  }
+}
+
+// All the requests share one session, which keeps the connections alive between requests, and
+// multiplexes the requests to a host over a single HTTP/2 connection when the server supports it.
+static INIT_ONCE _az_http_client_winhttp_session_once = INIT_ONCE_STATIC_INIT;
+static HINTERNET _az_http_client_winhttp_session = NULL;
+
+static BOOL CALLBACK
+_az_http_client_winhttp_session_init(PINIT_ONCE once, PVOID parameter, PVOID* context)
+{
+  (void)once;
+  (void)parameter;
+  (void)context;
+
+  HINTERNET const session = WinHttpOpen(
+      L"azsdk-c",
+      WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+      WINHTTP_NO_PROXY_NAME,
+      WINHTTP_NO_PROXY_BYPASS,
+      WINHTTP_FLAG_ASYNC);
+  if (session == NULL)
+  {
+    return FALSE;
+  }
+
+  if (WinHttpSetStatusCallback(
+          session,
+          _az_http_client_winhttp_callback,
+          WINHTTP_CALLBACK_FLAG_ALL_COMPLETIONS | WINHTTP_CALLBACK_FLAG_HANDLES,
+          0)
+      == WINHTTP_INVALID_STATUS_CALLBACK)
+  {
+    (void)WinHttpCloseHandle(session);
+    return FALSE;
+  }
+
+#ifdef WINHTTP_PROTOCOL_FLAG_HTTP2
+  // Windows 10 1607 or later, older versions keep using HTTP/1.1.
+  DWORD protocols = WINHTTP_PROTOCOL_FLAG_HTTP2;
+  (void)WinHttpSetOption(
+      session, WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL, &protocols, sizeof(protocols));
+#endif // WINHTTP_PROTOCOL_FLAG_HTTP2
+
+  _az_http_client_winhttp_session = session;
+  return TRUE;
+}
+
+/**
+ * Converts a WinHTTP error to az_result.
+ */
+static AZ_NODISCARD az_result _az_http_client_winhttp_error_to_result(DWORD error)
+{
+  switch (error)
+  {
+    case ERROR_SUCCESS:
+      return AZ_OK;
+
+    case ERROR_NOT_ENOUGH_MEMORY:
+      return AZ_ERROR_OUT_OF_MEMORY;
+
+    case ERROR_WINHTTP_NAME_NOT_RESOLVED:
+      return AZ_ERROR_HTTP_RESPONSE_COULDNT_RESOLVE_HOST;
+
+    default:
+      // let any other error code be an HTTP PAL ERROR
+      return AZ_ERROR_HTTP_ADAPTER;
+  }
+}
+
+/**
+ * @brief Waits for the pending operation of a request to complete, until the context of the
+ * request expires or is canceled.
+ *
+ * @return AZ_ERROR_CANCELED if the context expired first, in which case the operation is still
+ * pending until the request handle is closed.
+ */
+static AZ_NODISCARD az_result _az_http_client_winhttp_wait(
+    _az_http_client_winhttp_request* ref_state,
+    az_context const* context)
+{
+  while (true)
+  {
+    DWORD timeout = INFINITE;
+    if (context != NULL)
+    {
+      int64_t clock = 0;
+      _az_RETURN_IF_FAILED(az_platform_clock_msec(&clock));
+      if (az_context_has_expired(context, clock))
+      {
+        return AZ_ERROR_CANCELED;
+      }
+
+      // Even a context that doesn't expire can be canceled, through any of its parents.
+      int64_t const remaining = az_context_get_expiration(context) - clock;
+      timeout = remaining < _az_WINHTTP_CANCEL_POLL_MSEC ? (DWORD)remaining
+                                                         : _az_WINHTTP_CANCEL_POLL_MSEC;
+    }
+
+    DWORD const wait = WaitForSingleObject(ref_state->completed, timeout);
+    if (wait == WAIT_OBJECT_0)
+    {
+      return _az_http_client_winhttp_error_to_result(ref_state->error);
+    }
+
+    if (wait != WAIT_TIMEOUT)
+    {
+      return AZ_ERROR_HTTP_ADAPTER;
+    }
+  }
+}
+
+/**
+ * @brief Waits for an operation started on a request, unless it failed to start.
+ */
+static AZ_NODISCARD az_result _az_http_client_winhttp_complete(
+    _az_http_client_winhttp_request* ref_state,
+    az_context const* context,
+    BOOL started)
+{
+  if (!started)
+  {
+    return _az_http_client_winhttp_error_to_result(GetLastError());
+  }
+
+  return _az_http_client_winhttp_wait(ref_state, context);
+}
+
+/**
+ * @brief Converts UTF-8 text to a zero-terminated UTF-16 string.
+ *
+ * @param source the text to convert
+ * @param destination the buffer to write into
+ * @param destination_size the size of \p destination, in characters
+ * @param out_length the number of characters written, without the terminating 0
+ */
+static AZ_NODISCARD az_result _az_http_client_winhttp_to_wide(
+    az_span source,
+    WCHAR* destination,
+    int32_t destination_size,
+    int32_t* out_length)
+{
+  int32_t length = 0;
+  if (az_span_size(source) > 0)
+  {
+    length = MultiByteToWideChar(
+        CP_UTF8,
+        0,
+        (char const*)az_span_ptr(source),
+        az_span_size(source),
+        destination,
+        destination_size - 1);
+    if (length == 0)
+    {
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+  }
+
+  destination[length] = L'\0';
+  if (out_length != NULL)
+  {
+    *out_length = length;
+  }
+
+  return AZ_OK;
+}
+
+/**
+ * @brief Builds the headers of a request into a single UTF-16 string, each of them followed by a
+ * CRLF, which the caller frees.
+ */
+static AZ_NODISCARD az_result
+_az_http_client_winhttp_build_headers(az_http_request const* request, bool chunked, WCHAR** out)
+{
+  az_span const transfer_encoding = AZ_SPAN_FROM_STR("Transfer-Encoding: chunked\r\n");
+
+  // A UTF-8 sequence never converts to more UTF-16 characters than its number of bytes.
+  int32_t size = 1 + (chunked ? az_span_size(transfer_encoding) : 0);
+  az_span name = { 0 };
+  az_span value = { 0 };
+  for (int32_t offset = 0; offset < az_http_request_headers_count(request); ++offset)
+  {
+    _az_RETURN_IF_FAILED(az_http_request_get_header(request, offset, &name, &value));
+    size += az_span_size(name) + az_span_size(value) + 4;
+  }
+
+  WCHAR* const headers = (WCHAR*)malloc((size_t)size * sizeof(WCHAR));
+  if (headers == NULL)
+  {
+    return AZ_ERROR_OUT_OF_MEMORY;
+  }
+
+  int32_t length = 0;
+  for (int32_t offset = 0; offset < az_http_request_headers_count(request); ++offset)
+  {
+    int32_t written = 0;
+    az_result result = az_http_request_get_header(request, offset, &name, &value);
+    if (az_result_succeeded(result))
+    {
+      result = _az_http_client_winhttp_to_wide(name, headers + length, size - length, &written);
+    }
+
+    if (az_result_succeeded(result))
+    {
+      length += written;
+      headers[length++] = L':';
+      headers[length++] = L' ';
+      result = _az_http_client_winhttp_to_wide(value, headers + length, size - length, &written);
+    }
+
+    if (az_result_failed(result))
+    {
+      free(headers);
+      return result;
+    }
+
+    length += written;
+    headers[length++] = L'\r';
+    headers[length++] = L'\n';
+  }
+
+  int32_t written = 0;
+  if (chunked)
+  {
+    az_result const result = _az_http_client_winhttp_to_wide(
+        transfer_encoding, headers + length, size - length, &written);
+    if (az_result_failed(result))
+    {
+      free(headers);
+      return result;
+    }
+  }
+
+  headers[length + written] = L'\0';
+  *out = headers;
+  return AZ_OK;
+}
+
+/**
+ * @brief Writes the body produced by the body reader of a request. A body whose size is unknown is
+ * sent with chunked transfer encoding, which WinHTTP leaves to the application.
+ */
+static AZ_NODISCARD az_result _az_http_client_winhttp_write_body(
+    _az_http_client_winhttp_request* ref_state,
+    az_http_request const* request,
+    bool chunked)
+{
+  az_context const* const context = request->_internal.context;
+
+  // Room for the size line and the CRLF of a chunk around its data.
+  uint8_t buffer[_az_WINHTTP_READ_BUFFER_SIZE + 16];
+  az_span const data = az_span_create(buffer + 10, _az_WINHTTP_READ_BUFFER_SIZE);
+
+  int64_t offset = 0;
+  int32_t size = 0;
+  do
+  {
+    _az_RETURN_IF_FAILED(az_http_request_read_body(request, offset, data, &size));
+    offset += size;
+
+    uint8_t* start = az_span_ptr(data);
+    int32_t length = size;
+    if (chunked)
+    {
+      // The size line is written right before the data, the last chunk is empty.
+      char size_line[11];
+      int const size_line_length = snprintf(size_line, sizeof(size_line), "%X\r\n", (unsigned)size);
+      start -= size_line_length;
+      memcpy(start, size_line, (size_t)size_line_length);
+      length += size_line_length;
+      start[length++] = '\r';
+      start[length++] = '\n';
+    }
+
+    if (length > 0)
+    {
+      ref_state->error = ERROR_SUCCESS;
+      _az_RETURN_IF_FAILED(_az_http_client_winhttp_complete(
+          ref_state,
+          context,
+          WinHttpWriteData(ref_state->request, start, (DWORD)length, NULL)));
+    }
+  } while (size > 0);
+
+  return AZ_OK;
+}
+
+/**
+ * @brief Sends the headers and the body of a request, and waits for the headers of the response.
+ */
+static AZ_NODISCARD az_result _az_http_client_winhttp_send(
+    _az_http_client_winhttp_request* ref_state,
+    az_http_request const* request)
+{
+  az_context const* const context = request->_internal.context;
+
+  az_span body = AZ_SPAN_EMPTY;
+  bool const has_body_reader = az_http_request_has_body_reader(request);
+  int64_t const body_length = az_http_request_get_body_length(request);
+  bool const chunked = has_body_reader && (body_length < 0 || body_length > MAXDWORD);
+  if (!has_body_reader)
+  {
+    _az_RETURN_IF_FAILED(az_http_request_get_body(request, &body));
+  }
+
+  WCHAR* headers = NULL;
+  _az_RETURN_IF_FAILED(_az_http_client_winhttp_build_headers(request, chunked, &headers));
+
+  ref_state->error = ERROR_SUCCESS;
+  az_result result = _az_http_client_winhttp_complete(
+      ref_state,
+      context,
+      WinHttpSendRequest(
+          ref_state->request,
+          headers,
+          (DWORD)-1L,
+          az_span_size(body) > 0 ? (LPVOID)(uintptr_t)az_span_ptr(body) : WINHTTP_NO_REQUEST_DATA,
+          (DWORD)az_span_size(body),
+          chunked ? WINHTTP_IGNORE_REQUEST_TOTAL_LENGTH
+                  : (has_body_reader ? (DWORD)body_length : (DWORD)az_span_size(body)),
+          (DWORD_PTR)ref_state));
+  free(headers);
+  _az_RETURN_IF_FAILED(result);
+
+  if (has_body_reader)
+  {
+    _az_RETURN_IF_FAILED(_az_http_client_winhttp_write_body(ref_state, request, chunked));
+  }
+
+  ref_state->error = ERROR_SUCCESS;
+  return _az_http_client_winhttp_complete(
+      ref_state, context, WinHttpReceiveResponse(ref_state->request, NULL));
+}
+
+/**
+ * @brief Writes the status line and the headers of the response. WinHTTP gives them in UTF-16, and
+ * its status line for HTTP/2 has no minor version, so the status line is written again.
+ */
+static AZ_NODISCARD az_result _az_http_client_winhttp_write_headers(
+    _az_http_client_winhttp_request* ref_state,
+    az_http_response* ref_response)
+{
+  DWORD status_code = 0;
+  DWORD status_code_size = sizeof(status_code);
+  if (!WinHttpQueryHeaders(
+          ref_state->request,
+          WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+          WINHTTP_HEADER_NAME_BY_INDEX,
+          &status_code,
+          &status_code_size,
+          WINHTTP_NO_HEADER_INDEX))
+  {
+    return _az_http_client_winhttp_error_to_result(GetLastError());
+  }
+
+  DWORD protocol = 0;
+#ifdef WINHTTP_PROTOCOL_FLAG_HTTP2
+  DWORD protocol_size = sizeof(protocol);
+  (void)WinHttpQueryOption(
+      ref_state->request, WINHTTP_OPTION_HTTP_PROTOCOL_USED, &protocol, &protocol_size);
+#endif // WINHTTP_PROTOCOL_FLAG_HTTP2
+
+  char status_line[32];
+  int const status_line_length = snprintf(
+      status_line,
+      sizeof(status_line),
+      "HTTP/%s %03u \r\n",
+      protocol != 0 ? "2.0" : "1.1",
+      (unsigned)status_code);
+  _az_RETURN_IF_FAILED(az_http_response_append(
+      ref_response, az_span_create((uint8_t*)status_line, status_line_length)));
+
+  DWORD headers_size = 0;
+  (void)WinHttpQueryHeaders(
+      ref_state->request,
+      WINHTTP_QUERY_RAW_HEADERS_CRLF,
+      WINHTTP_HEADER_NAME_BY_INDEX,
+      WINHTTP_NO_OUTPUT_BUFFER,
+      &headers_size,
+      WINHTTP_NO_HEADER_INDEX);
+  if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+  {
+    return AZ_ERROR_HTTP_ADAPTER;
+  }
+
+  // The UTF-16 headers, followed by their UTF-8 conversion, which is at most 3 bytes per character.
+  int32_t const length = (int32_t)(headers_size / sizeof(WCHAR));
+  uint8_t* const buffer = (uint8_t*)malloc(headers_size + ((size_t)length * 3));
+  if (buffer == NULL)
+  {
+    return AZ_ERROR_OUT_OF_MEMORY;
+  }
+
+  WCHAR* const headers = (WCHAR*)buffer;
+  char* const converted = (char*)(buffer + headers_size);
+  az_result result = AZ_ERROR_HTTP_ADAPTER;
+  if (WinHttpQueryHeaders(
+          ref_state->request,
+          WINHTTP_QUERY_RAW_HEADERS_CRLF,
+          WINHTTP_HEADER_NAME_BY_INDEX,
+          headers,
+          &headers_size,
+          WINHTTP_NO_HEADER_INDEX))
+  {
+    // Skip the status line of WinHTTP.
+    int32_t start = 0;
+    int32_t const headers_length = (int32_t)(headers_size / sizeof(WCHAR));
+    while (start < headers_length && headers[start++] != L'\n')
+    {
+    }
+
+    int32_t const converted_length = headers_length == start
+        ? 0
+        : WideCharToMultiByte(
+            CP_UTF8,
+            0,
+            headers + start,
+            headers_length - start,
+            converted,
+            length * 3,
+            NULL,
+            NULL);
+    result = az_http_response_append(
+        ref_response, az_span_create((uint8_t*)converted, converted_length));
+  }
+
+  free(buffer);
+  return result;
+}
+
+/**
+ * @brief Reads the body of the response until its end.
+ */
+static AZ_NODISCARD az_result _az_http_client_winhttp_read_body(
+    _az_http_client_winhttp_request* ref_state,
+    az_http_request const* request,
+    az_http_response* ref_response)
+{
+  uint8_t buffer[_az_WINHTTP_READ_BUFFER_SIZE];
+  while (true)
+  {
+    ref_state->error = ERROR_SUCCESS;
+    ref_state->bytes_read = 0;
+    _az_RETURN_IF_FAILED(_az_http_client_winhttp_complete(
+        ref_state,
+        request->_internal.context,
+        WinHttpReadData(ref_state->request, buffer, sizeof(buffer), NULL)));
+
+    // WinHTTP completes a read of 0 bytes at the end of the body.
+    if (ref_state->bytes_read == 0)
+    {
+      return AZ_OK;
+    }
+
+    _az_RETURN_IF_FAILED(az_http_response_append_body(
+        ref_response, az_span_create(buffer, (int32_t)ref_state->bytes_read)));
+  }
+}
+
+/**
+ * @brief Opens the request on its own connection handle, which only refers to the host, the
+ * connections themselves being pooled by the session.
+ */
+static AZ_NODISCARD az_result _az_http_client_winhttp_open(
+    _az_http_client_winhttp_request* ref_state,
+    az_span url,
+    az_http_method method,
+    HINTERNET* out_connection)
+{
+  WCHAR wide_method[_az_WINHTTP_METHOD_SIZE];
+  if (az_result_failed(_az_http_client_winhttp_to_wide(
+          method, wide_method, _az_WINHTTP_METHOD_SIZE, NULL)))
+  {
+    return AZ_ERROR_HTTP_INVALID_METHOD_VERB;
+  }
+
+  // The URL, followed by a copy of its host name, which must be zero-terminated.
+  int32_t const url_size = az_span_size(url) + 1;
+  WCHAR* const wide_url = (WCHAR*)malloc((size_t)url_size * 2 * sizeof(WCHAR));
+  if (wide_url == NULL)
+  {
+    return AZ_ERROR_OUT_OF_MEMORY;
+  }
+
+  URL_COMPONENTS components = { 0 };
+  components.dwStructSize = sizeof(components);
+  components.dwHostNameLength = (DWORD)-1;
+  components.dwUrlPathLength = (DWORD)-1;
+  components.dwExtraInfoLength = (DWORD)-1;
+
+  az_result result = _az_http_client_winhttp_to_wide(url, wide_url, url_size, NULL);
+  if (az_result_succeeded(result) && !WinHttpCrackUrl(wide_url, 0, 0, &components))
+  {
+    result = AZ_ERROR_ARG;
+  }
+
+  if (az_result_succeeded(result))
+  {
+    WCHAR* const host = wide_url + url_size;
+    memcpy(host, components.lpszHostName, components.dwHostNameLength * sizeof(WCHAR));
+    host[components.dwHostNameLength] = L'\0';
+
+    *out_connection = WinHttpConnect(_az_http_client_winhttp_session, host, components.nPort, 0);
+    if (*out_connection == NULL)
+    {
+      result = _az_http_client_winhttp_error_to_result(GetLastError());
+    }
+  }
+
+  if (az_result_succeeded(result))
+  {
+    // The path is followed by the query, up to the end of the URL.
+    ref_state->request = WinHttpOpenRequest(
+        *out_connection,
+        wide_method,
+        components.dwUrlPathLength + components.dwExtraInfoLength > 0 ? components.lpszUrlPath
+                                                                       : NULL,
+        NULL,
+        WINHTTP_NO_REFERER,
+        WINHTTP_DEFAULT_ACCEPT_TYPES,
+        components.nScheme == INTERNET_SCHEME_HTTPS ? WINHTTP_FLAG_SECURE : 0);
+    if (ref_state->request == NULL)
+    {
+      result = _az_http_client_winhttp_error_to_result(GetLastError());
+    }
+  }
+
+  if (az_result_succeeded(result))
+  {
+    // Set before any operation, so that the callback gets the state when the handle is closed.
+    DWORD_PTR state = (DWORD_PTR)ref_state;
+    if (!WinHttpSetOption(ref_state->request, WINHTTP_OPTION_CONTEXT_VALUE, &state, sizeof(state)))
+    {
+      result = _az_http_client_winhttp_error_to_result(GetLastError());
+      (void)WinHttpCloseHandle(ref_state->request);
+      ref_state->request = NULL;
+    }
+  }
+
+  free(wide_url);
+  return result;
+}
+
+/**
+ * @brief Closes the handles of a request. Closing the request handle cancels its pending operation,
+ * if any, and the state is only released once the callback is done with it.
+ */
+static void
+_az_http_client_winhttp_close(_az_http_client_winhttp_request* ref_state, HINTERNET connection)
+{
+  if (ref_state->request != NULL)
+  {
+    (void)WinHttpCloseHandle(ref_state->request);
+    while (ref_state->closed == 0)
+    {
+      (void)WaitForSingleObject(ref_state->completed, INFINITE);
+    }
+  }
+
+  if (connection != NULL)
+  {
+    (void)WinHttpCloseHandle(connection);
+  }
+
+  (void)CloseHandle(ref_state->completed);
+}
+
+/**
+ * @brief Sends a HEAD request to \p url, which leaves a connection open to its host, in the pool
+ * of the session, for the requests that follow.
+ */
+static void _az_http_client_winhttp_warm_up(az_context const* context, az_span url)
+{
+  _az_http_client_winhttp_request state = { 0 };
+  state.completed = CreateEventW(NULL, FALSE, FALSE, NULL);
+  if (state.completed == NULL)
+  {
+    return;
+  }
+
+  HINTERNET connection = NULL;
+  if (az_result_succeeded(
+          _az_http_client_winhttp_open(&state, url, az_http_method_head(), &connection))
+      && az_result_succeeded(_az_http_client_winhttp_complete(
+          &state,
+          context,
+          WinHttpSendRequest(
+              state.request,
+              WINHTTP_NO_ADDITIONAL_HEADERS,
+              0,
+              WINHTTP_NO_REQUEST_DATA,
+              0,
+              0,
+              (DWORD_PTR)&state)))
+      && az_result_succeeded(_az_http_client_winhttp_complete(
+          &state, context, WinHttpReceiveResponse(state.request, NULL))))
+  {
+    // The response to a HEAD request has no body, reading its end returns the connection to the
+    // pool.
+    uint8_t buffer[1];
+    az_result const read_result = _az_http_client_winhttp_complete(
+        &state, context, WinHttpReadData(state.request, buffer, sizeof(buffer), NULL));
+    (void)read_result;
+  }
+
+  _az_http_client_winhttp_close(&state, connection);
+}
+
+AZ_NODISCARD az_result
+az_http_client_init(az_context const* context, az_span const urls[], int32_t url_count)
+{
+  _az_PRECONDITION_RANGE(0, url_count, INT32_MAX);
+  _az_PRECONDITION(url_count == 0 || urls != NULL);
+
+  if (!InitOnceExecuteOnce(
+          &_az_http_client_winhttp_session_once, _az_http_client_winhttp_session_init, NULL, NULL))
+  {
+    return AZ_ERROR_HTTP_ADAPTER;
+  }
+
+  for (int32_t i = 0; i < url_count; i++)
+  {
+    _az_http_client_winhttp_warm_up(context == NULL ? &az_context_application : context, urls[i]);
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_http_client_send_request(az_http_request const* request, az_http_response* ref_response)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(ref_response);
+
+  if (!InitOnceExecuteOnce(
+          &_az_http_client_winhttp_session_once, _az_http_client_winhttp_session_init, NULL, NULL))
+  {
+    return AZ_ERROR_HTTP_ADAPTER;
+  }
+
+  _az_http_client_winhttp_request state = { 0 };
+  state.completed = CreateEventW(NULL, FALSE, FALSE, NULL);
+  if (state.completed == NULL)
+  {
+    return AZ_ERROR_OUT_OF_MEMORY;
+  }
+
+  az_span url = { 0 };
+  az_http_method method = { 0 };
+  HINTERNET connection = NULL;
+  az_result result = az_http_request_get_url(request, &url);
+  if (az_result_succeeded(result))
+  {
+    result = az_http_request_get_method(request, &method);
+  }
+
+  if (az_result_succeeded(result))
+  {
+    result = _az_http_client_winhttp_open(&state, url, method, &connection);
+  }
+
+  if (az_result_succeeded(result))
+  {
+    result = _az_http_client_winhttp_send(&state, request);
+  }
+
+  if (az_result_succeeded(result))
+  {
+    result = _az_http_client_winhttp_write_headers(&state, ref_response);
+  }
+
+  if (az_result_succeeded(result))
+  {
+    result = _az_http_client_winhttp_read_body(&state, request, ref_response);
+  }
+
+  _az_http_client_winhttp_close(&state, connection);
+  return result;
+}
+
+AZ_NODISCARD az_result az_http_client_send_hedged_request(
+    az_http_request const* request,
+    az_http_response* ref_response,
+    az_http_response* ref_hedge_response,
+    int32_t hedge_delay_msec,
+    bool* out_hedge_won)
+{
+  (void)request;
+  (void)ref_response;
+  (void)ref_hedge_response;
+  (void)hedge_delay_msec;
+  (void)out_hedge_won;
+  return AZ_ERROR_NOT_SUPPORTED;
+}
+
+AZ_NODISCARD az_result az_http_client_send_requests(
+    az_http_request const requests[],
+    az_http_response ref_responses[],
+    az_result out_results[],
+    int32_t count)
+{
+  _az_PRECONDITION_NOT_NULL(requests);
+  _az_PRECONDITION_NOT_NULL(ref_responses);
+  _az_PRECONDITION_NOT_NULL(out_results);
+  _az_PRECONDITION_RANGE(1, count, INT32_MAX);
+
+  // WinHTTP requests are synchronous here, so they are sent one after the other.
+  az_result result = AZ_OK;
+  for (int32_t i = 0; i < count; i++)
+  {
+    out_results[i] = az_http_client_send_request(&requests[i], &ref_responses[i]);
+    if (az_result_failed(out_results[i]) && az_result_succeeded(result))
+    {
+      result = out_results[i];
+    }
+  }
+
+  return result;
+}
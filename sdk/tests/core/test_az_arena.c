@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_test_definitions.h"
+#include <azure/core/az_arena.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_result.h>
+#include <azure/core/internal/az_arena_internal.h>
+#include <azure/core/internal/az_http_internal.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include <azure/core/_az_cfg.h>
+
+static void test_az_arena_allocate(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[64] = { 0 };
+  az_arena arena = az_arena_create(AZ_SPAN_FROM_BUFFER(buffer));
+  assert_int_equal(az_arena_get_used(&arena), 0);
+
+  az_span first = { 0 };
+  assert_return_code(az_arena_allocate(&arena, 3, &first), AZ_OK);
+  assert_int_equal(az_span_size(first), 3);
+  assert_true(az_span_ptr(first) >= buffer && az_span_ptr(first) + 3 <= buffer + sizeof(buffer));
+
+  // The next allocation is aligned.
+  az_span second = { 0 };
+  assert_return_code(az_arena_allocate(&arena, 8, &second), AZ_OK);
+  assert_int_equal((uintptr_t)az_span_ptr(second) % 8, 0);
+  assert_true(az_span_ptr(second) >= az_span_ptr(first) + 3);
+  assert_true(_az_arena_contains(&arena, az_span_ptr(first)));
+  assert_true(_az_arena_contains(&arena, az_span_ptr(second)));
+
+  // Allocations that don't fit fail, without using any space.
+  int32_t const used = az_arena_get_used(&arena);
+  az_span too_large = { 0 };
+  assert_int_equal(az_arena_allocate(&arena, 64, &too_large), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(az_arena_get_used(&arena), used);
+
+  // Rewinding frees what was allocated since the mark only.
+  int32_t const mark = _az_arena_get_mark(&arena);
+  az_span third = { 0 };
+  assert_return_code(az_arena_allocate(&arena, 16, &third), AZ_OK);
+  _az_arena_rewind(&arena, mark);
+  assert_int_equal(az_arena_get_used(&arena), mark);
+  assert_false(_az_arena_contains(&arena, az_span_ptr(third)));
+  assert_true(_az_arena_contains(&arena, az_span_ptr(second)));
+
+  az_arena_reset(&arena);
+  assert_int_equal(az_arena_get_used(&arena), 0);
+  assert_false(_az_arena_contains(&arena, az_span_ptr(first)));
+
+  // After the reset, the whole buffer can be allocated again.
+  az_span whole = { 0 };
+  uint8_t* const aligned = buffer + ((8 - ((uintptr_t)buffer % 8)) % 8);
+  int32_t const whole_size = (int32_t)(buffer + sizeof(buffer) - aligned);
+  assert_return_code(az_arena_allocate(&arena, whole_size, &whole), AZ_OK);
+  assert_ptr_equal(az_span_ptr(whole), aligned);
+  assert_return_code(az_arena_allocate(&arena, 0, &whole), AZ_OK);
+  assert_int_equal(az_arena_allocate(&arena, 1, &whole), AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void test_az_arena_http_request(void** state)
+{
+  (void)state;
+
+  // The buffers of the request are carved from the same arena the transport allocates from.
+  uint8_t buffer[512] = { 0 };
+  az_arena arena = az_arena_create(AZ_SPAN_FROM_BUFFER(buffer));
+
+  az_span url = { 0 };
+  az_span headers = { 0 };
+  assert_return_code(az_arena_allocate(&arena, 64, &url), AZ_OK);
+  assert_return_code(
+      az_arena_allocate(&arena, 2 * (int32_t)sizeof(_az_http_request_header), &headers), AZ_OK);
+  (void)az_span_copy(url, AZ_SPAN_FROM_STR("https://www.microsoft.com"));
+
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          url,
+          25,
+          headers,
+          AZ_SPAN_EMPTY),
+      AZ_OK);
+  assert_null(request._internal.arena);
+
+  az_http_request_set_arena(&request, &arena);
+  assert_ptr_equal(request._internal.arena, &arena);
+  assert_int_equal(az_http_request_headers_count(&request), 0);
+
+  az_http_request_set_arena(&request, NULL);
+  assert_null(request._internal.arena);
+}
+
+int test_az_arena()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_arena_allocate),
+    cmocka_unit_test(test_az_arena_http_request),
+  };
+  return cmocka_run_group_tests_name("az_core_arena", tests, NULL, NULL);
+}
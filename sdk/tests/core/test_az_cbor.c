@@ -0,0 +1,504 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_test_definitions.h"
+#include <azure/core/az_cbor.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <math.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include <azure/core/_az_cfg.h>
+
+#define TEST_EXPECT_BYTES(writer, ...)                                                  \
+  do                                                                                   \
+  {                                                                                    \
+    uint8_t const _expected[] = { __VA_ARGS__ };                                       \
+    az_span const _actual = az_cbor_writer_get_bytes_used_in_destination(&(writer));   \
+    assert_int_equal(az_span_size(_actual), sizeof(_expected));                        \
+    assert_memory_equal(az_span_ptr(_actual), _expected, sizeof(_expected));           \
+  } while (0)
+
+// Encodings from RFC 8949, Appendix A.
+static void test_az_cbor_writer_integers(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[16];
+  az_cbor_writer writer;
+
+#define TEST_UINT64(value, ...)                                                   \
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK); \
+  assert_int_equal(az_cbor_writer_append_uint64(&writer, value), AZ_OK);            \
+  TEST_EXPECT_BYTES(writer, __VA_ARGS__)
+
+#define TEST_INT64(value, ...)                                                    \
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK); \
+  assert_int_equal(az_cbor_writer_append_int64(&writer, value), AZ_OK);             \
+  TEST_EXPECT_BYTES(writer, __VA_ARGS__)
+
+  TEST_UINT64(0, 0x00);
+  TEST_UINT64(23, 0x17);
+  TEST_UINT64(24, 0x18, 0x18);
+  TEST_UINT64(100, 0x18, 0x64);
+  TEST_UINT64(1000, 0x19, 0x03, 0xe8);
+  TEST_UINT64(1000000, 0x1a, 0x00, 0x0f, 0x42, 0x40);
+  TEST_UINT64(1000000000000, 0x1b, 0x00, 0x00, 0x00, 0xe8, 0xd4, 0xa5, 0x10, 0x00);
+  TEST_UINT64(UINT64_MAX, 0x1b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff);
+
+  TEST_INT64(10, 0x0a);
+  TEST_INT64(-1, 0x20);
+  TEST_INT64(-10, 0x29);
+  TEST_INT64(-100, 0x38, 0x63);
+  TEST_INT64(-1000, 0x39, 0x03, 0xe7);
+  TEST_INT64(INT64_MIN, 0x3b, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff);
+
+#undef TEST_UINT64
+#undef TEST_INT64
+}
+
+static void test_az_cbor_writer_floats(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[16];
+  az_cbor_writer writer;
+
+#define TEST_DOUBLE(value, ...)                                                   \
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK); \
+  assert_int_equal(az_cbor_writer_append_double(&writer, value), AZ_OK);            \
+  TEST_EXPECT_BYTES(writer, __VA_ARGS__)
+
+  TEST_DOUBLE(0.0, 0xf9, 0x00, 0x00);
+  TEST_DOUBLE(-0.0, 0xf9, 0x80, 0x00);
+  TEST_DOUBLE(1.0, 0xf9, 0x3c, 0x00);
+  TEST_DOUBLE(1.1, 0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a);
+  TEST_DOUBLE(1.5, 0xf9, 0x3e, 0x00);
+  TEST_DOUBLE(65504.0, 0xf9, 0x7b, 0xff);
+  TEST_DOUBLE(100000.0, 0xfa, 0x47, 0xc3, 0x50, 0x00);
+  TEST_DOUBLE(3.4028234663852886e+38, 0xfa, 0x7f, 0x7f, 0xff, 0xff);
+  TEST_DOUBLE(1.0e+300, 0xfb, 0x7e, 0x37, 0xe4, 0x3c, 0x88, 0x00, 0x75, 0x9c);
+  TEST_DOUBLE(5.960464477539063e-8, 0xf9, 0x00, 0x01);
+  TEST_DOUBLE(0.00006103515625, 0xf9, 0x04, 0x00);
+  TEST_DOUBLE(-4.0, 0xf9, 0xc4, 0x00);
+  TEST_DOUBLE(-4.1, 0xfb, 0xc0, 0x10, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66);
+  TEST_DOUBLE(INFINITY, 0xf9, 0x7c, 0x00);
+  TEST_DOUBLE(-INFINITY, 0xf9, 0xfc, 0x00);
+  TEST_DOUBLE(NAN, 0xf9, 0x7e, 0x00);
+
+#undef TEST_DOUBLE
+}
+
+static void test_az_cbor_writer_simple_values_and_strings(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[64];
+  az_cbor_writer writer;
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+
+  assert_int_equal(az_cbor_writer_append_bool(&writer, false), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_bool(&writer, true), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_null(&writer), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_text_string(&writer, AZ_SPAN_EMPTY), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_text_string(&writer, AZ_SPAN_FROM_STR("IETF")), AZ_OK);
+  uint8_t bytes[] = { 0x01, 0x02, 0x03, 0x04 };
+  assert_int_equal(
+      az_cbor_writer_append_byte_string(&writer, AZ_SPAN_FROM_BUFFER(bytes)), AZ_OK);
+
+  TEST_EXPECT_BYTES(
+      writer,
+      0xf4,
+      0xf5,
+      0xf6,
+      0x60,
+      0x64,
+      'I',
+      'E',
+      'T',
+      'F',
+      0x44,
+      0x01,
+      0x02,
+      0x03,
+      0x04);
+}
+
+static void test_az_cbor_writer_containers(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[64];
+  az_cbor_writer writer;
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+
+  // {_ "a": 1, "b": [_ 2, 3]}
+  assert_int_equal(az_cbor_writer_append_begin_map(&writer), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_text_string(&writer, AZ_SPAN_FROM_STR("a")), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_uint64(&writer, 1), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_text_string(&writer, AZ_SPAN_FROM_STR("b")), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_begin_array(&writer), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_uint64(&writer, 2), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_uint64(&writer, 3), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_end_array(&writer), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_end_map(&writer), AZ_OK);
+
+  TEST_EXPECT_BYTES(writer, 0xbf, 0x61, 'a', 0x01, 0x61, 'b', 0x9f, 0x02, 0x03, 0xff, 0xff);
+
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  for (int32_t i = 0; i < _az_CBOR_WRITER_MAX_NESTING_DEPTH; i++)
+  {
+    assert_int_equal(az_cbor_writer_append_begin_array(&writer), AZ_OK);
+  }
+  assert_int_equal(az_cbor_writer_append_begin_array(&writer), AZ_ERROR_CBOR_NESTING_OVERFLOW);
+}
+
+static void test_az_cbor_writer_int64_delta_array(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[64];
+  az_cbor_writer writer;
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+
+  // [2150, 2, -2, 0, 100], which is 8 bytes instead of 14 for [2150, 2152, 2150, 2150, 2250].
+  int64_t const series[] = { 2150, 2152, 2150, 2150, 2250 };
+  assert_int_equal(az_cbor_writer_append_int64_delta_array(&writer, series, 5), AZ_OK);
+  TEST_EXPECT_BYTES(writer, 0x85, 0x19, 0x08, 0x66, 0x02, 0x21, 0x00, 0x18, 0x64);
+
+  // The differences between the extremes take 65 bits.
+  int64_t const extremes[] = { INT64_MIN, INT64_MAX, INT64_MIN };
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_int64_delta_array(&writer, extremes, 3), AZ_OK);
+  uint8_t extremes_expected[]
+      = { 0x83, 0x3b, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x1b, 0xff, 0xff, 0xff,
+          0xff, 0xff, 0xff, 0xff, 0xff, 0x3b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe };
+  assert_true(az_span_is_content_equal(
+      az_cbor_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_BUFFER(extremes_expected)));
+
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_int64_delta_array(&writer, NULL, 0), AZ_OK);
+  TEST_EXPECT_BYTES(writer, 0x80);
+
+  // The reader sums the elements back into the series.
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_int64_delta_array(&writer, series, 5), AZ_OK);
+
+  az_cbor_reader reader;
+  assert_int_equal(
+      az_cbor_reader_init(&reader, az_cbor_writer_get_bytes_used_in_destination(&writer)), AZ_OK);
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_BEGIN_ARRAY);
+  assert_int_equal(reader.token.size, 5);
+
+  int64_t value = 0;
+  for (int32_t i = 0; i < 5; i++)
+  {
+    int64_t delta = 0;
+    assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+    assert_int_equal(az_cbor_token_get_int64(&reader.token, &delta), AZ_OK);
+    value += delta;
+    assert_true(value == series[i]);
+  }
+
+  uint8_t small_buffer[4];
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(small_buffer)), AZ_OK);
+  assert_int_equal(
+      az_cbor_writer_append_int64_delta_array(&writer, series, 5), AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void test_az_cbor_writer_not_enough_space(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[6] = { 0 };
+  az_cbor_writer writer;
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+
+  assert_int_equal(az_cbor_writer_append_uint64(&writer, 1000), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_uint64(&writer, 1000000), AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  // A string that doesn't fit is not written at all.
+  assert_int_equal(
+      az_cbor_writer_append_text_string(&writer, AZ_SPAN_FROM_STR("abc")),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(buffer[3], 0);
+  TEST_EXPECT_BYTES(writer, 0x19, 0x03, 0xe8);
+
+  assert_int_equal(az_cbor_writer_append_text_string(&writer, AZ_SPAN_FROM_STR("ab")), AZ_OK);
+  TEST_EXPECT_BYTES(writer, 0x19, 0x03, 0xe8, 0x62, 'a', 'b');
+}
+
+typedef struct
+{
+  uint8_t* buffer;
+  int32_t chunk_size;
+  int32_t chunks_used;
+  int32_t chunks_count;
+  int32_t bytes_used[8];
+} test_cbor_chunks;
+
+static az_result _test_cbor_allocator(az_span_allocator_context* allocator_context, az_span* out)
+{
+  test_cbor_chunks* chunks = (test_cbor_chunks*)allocator_context->user_context;
+  chunks->bytes_used[chunks->chunks_used - 1] = allocator_context->bytes_used;
+
+  if (chunks->chunks_used == chunks->chunks_count
+      || allocator_context->minimum_required_size > chunks->chunk_size)
+  {
+    return AZ_ERROR_OUT_OF_MEMORY;
+  }
+
+  *out = az_span_create(
+      chunks->buffer + chunks->chunks_used * chunks->chunk_size, chunks->chunk_size);
+  chunks->chunks_used++;
+  return AZ_OK;
+}
+
+static void test_az_cbor_writer_chunked(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[4 * 10] = { 0 };
+  test_cbor_chunks chunks
+      = { .buffer = buffer, .chunk_size = 10, .chunks_used = 1, .chunks_count = 4 };
+
+  az_cbor_writer writer;
+  assert_int_equal(
+      az_cbor_writer_chunked_init(
+          &writer, az_span_create(buffer, 10), _test_cbor_allocator, &chunks),
+      AZ_OK);
+
+  // [_ 1000, 1000000000000, "abcdefghijkl", true]
+  assert_int_equal(az_cbor_writer_append_begin_array(&writer), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_uint64(&writer, 1000), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_uint64(&writer, 1000000000000), AZ_OK);
+  assert_int_equal(
+      az_cbor_writer_append_text_string(&writer, AZ_SPAN_FROM_STR("abcdefghijkl")), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_bool(&writer, true), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_end_array(&writer), AZ_OK);
+  assert_int_equal(writer._internal.total_bytes_written, 1 + 3 + 9 + 13 + 1 + 1);
+
+  // The head of the second integer doesn't fit in the rest of the first buffer, and the string
+  // straddles the second, third and fourth ones.
+  assert_int_equal(chunks.chunks_used, 4);
+  assert_int_equal(chunks.bytes_used[0], 4);
+  assert_int_equal(chunks.bytes_used[1], 10);
+  assert_int_equal(chunks.bytes_used[2], 10);
+  uint8_t const second[] = { 0x1b, 0x00, 0x00, 0x00, 0xe8, 0xd4, 0xa5, 0x10, 0x00, 0x6c };
+  assert_memory_equal(buffer + 10, second, sizeof(second));
+  assert_memory_equal(buffer + 20, "abcdefghij", 10);
+  TEST_EXPECT_BYTES(writer, 'k', 'l', 0xf5, 0xff);
+
+  // The allocator has no more buffers.
+  assert_int_equal(
+      az_cbor_writer_append_text_string(&writer, AZ_SPAN_FROM_STR("abcdefghijkl")),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void test_az_cbor_reader_definite(void** state)
+{
+  (void)state;
+
+  // {"a": 1, "b": [2, 3], "c": h'01', "d": -500, "e": 0(1.5), "f": {}}
+  uint8_t cbor[] = { 0xa6, 0x61, 'a',  0x01, 0x61, 'b',  0x82, 0x02, 0x03, 0x61, 'c',
+                           0x41, 0x01, 0x61, 'd',  0x39, 0x01, 0xf3, 0x61, 'e',  0xc0, 0xf9,
+                           0x3e, 0x00, 0x61, 'f',  0xa0 };
+
+  az_cbor_reader reader;
+  assert_int_equal(az_cbor_reader_init(&reader, AZ_SPAN_FROM_BUFFER(cbor)), AZ_OK);
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_BEGIN_MAP);
+  assert_int_equal(reader.token.size, 6);
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_true(az_cbor_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("a")));
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  uint64_t u64 = 0;
+  assert_int_equal(az_cbor_token_get_uint64(&reader.token, &u64), AZ_OK);
+  assert_true(u64 == 1);
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_true(az_cbor_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("b")));
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_BEGIN_ARRAY);
+  assert_int_equal(reader.token.size, 2);
+  assert_int_equal(az_cbor_reader_skip_children(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_END_ARRAY);
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_true(az_cbor_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("c")));
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_BYTE_STRING);
+  assert_false(az_cbor_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("\x01")));
+  assert_int_equal(az_span_size(reader.token.slice), 1);
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  int64_t i64 = 0;
+  assert_int_equal(az_cbor_token_get_int64(&reader.token, &i64), AZ_OK);
+  assert_true(i64 == -500);
+  assert_int_equal(az_cbor_token_get_uint64(&reader.token, &u64), AZ_ERROR_CBOR_INVALID_STATE);
+
+  // The tag is skipped.
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_FLOAT);
+  double d = 0;
+  assert_int_equal(az_cbor_token_get_double(&reader.token, &d), AZ_OK);
+  assert_true(d >= 1.5 && d <= 1.5);
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_BEGIN_MAP);
+  assert_int_equal(reader.token.size, 0);
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_END_MAP);
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_END_MAP);
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_ERROR_CBOR_READER_DONE);
+}
+
+static void test_az_cbor_reader_reads_writer_output(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[128];
+  az_cbor_writer writer;
+  assert_int_equal(az_cbor_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+
+  double const doubles[] = { 0.0, -2.5, 65504.0, 100000.0, 1.1, 5.960464477539063e-8, -1.0e+300 };
+  int32_t const doubles_count = (int32_t)(sizeof(doubles) / sizeof(doubles[0]));
+
+  assert_int_equal(az_cbor_writer_append_begin_array(&writer), AZ_OK);
+  for (int32_t i = 0; i < doubles_count; i++)
+  {
+    assert_int_equal(az_cbor_writer_append_double(&writer, doubles[i]), AZ_OK);
+  }
+  assert_int_equal(az_cbor_writer_append_int64(&writer, INT64_MIN), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_bool(&writer, true), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_null(&writer), AZ_OK);
+  assert_int_equal(az_cbor_writer_append_end_array(&writer), AZ_OK);
+
+  az_cbor_reader reader;
+  assert_int_equal(
+      az_cbor_reader_init(&reader, az_cbor_writer_get_bytes_used_in_destination(&writer)), AZ_OK);
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_BEGIN_ARRAY);
+  assert_int_equal(reader.token.size, -1);
+
+  for (int32_t i = 0; i < doubles_count; i++)
+  {
+    assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+    double value = 0;
+    assert_int_equal(az_cbor_token_get_double(&reader.token, &value), AZ_OK);
+    assert_true(value >= doubles[i] && value <= doubles[i]);
+  }
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  int64_t i64 = 0;
+  assert_int_equal(az_cbor_token_get_int64(&reader.token, &i64), AZ_OK);
+  assert_true(i64 == INT64_MIN);
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  bool b = false;
+  assert_int_equal(az_cbor_token_get_bool(&reader.token, &b), AZ_OK);
+  assert_true(b);
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_NULL);
+  assert_int_equal(az_cbor_token_get_bool(&reader.token, &b), AZ_ERROR_CBOR_INVALID_STATE);
+
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_OK);
+  assert_int_equal(reader.token.kind, AZ_CBOR_TOKEN_END_ARRAY);
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_ERROR_CBOR_READER_DONE);
+}
+
+static void test_az_cbor_reader_invalid(void** state)
+{
+  (void)state;
+
+  az_cbor_reader reader;
+
+#define TEST_READ_FAILS(expected_result, ...)                                            \
+  do                                                                                     \
+  {                                                                                      \
+    uint8_t _cbor[] = { __VA_ARGS__ };                                             \
+    assert_int_equal(                                                                    \
+        az_cbor_reader_init(&reader, AZ_SPAN_FROM_BUFFER(_cbor)), AZ_OK);    \
+    az_result _result;                                                                   \
+    do                                                                                   \
+    {                                                                                    \
+      _result = az_cbor_reader_next_token(&reader);                                      \
+    } while (_result == AZ_OK);                                                          \
+    assert_int_equal(_result, expected_result);                                          \
+  } while (0)
+
+  // Truncated argument, string and array.
+  TEST_READ_FAILS(AZ_ERROR_UNEXPECTED_END, 0x19, 0x03);
+  TEST_READ_FAILS(AZ_ERROR_UNEXPECTED_END, 0x63, 'a', 'b');
+  TEST_READ_FAILS(AZ_ERROR_UNEXPECTED_END, 0x82, 0x01);
+  TEST_READ_FAILS(AZ_ERROR_UNEXPECTED_END, 0x9f, 0x01);
+
+  // Indefinite length string.
+  TEST_READ_FAILS(AZ_ERROR_NOT_SUPPORTED, 0x7f, 0x61, 'a', 0xff);
+
+  // Reserved additional information, break outside of a container, and trailing bytes.
+  TEST_READ_FAILS(AZ_ERROR_UNEXPECTED_CHAR, 0x1c);
+  TEST_READ_FAILS(AZ_ERROR_UNEXPECTED_CHAR, 0xff);
+  TEST_READ_FAILS(AZ_ERROR_UNEXPECTED_CHAR, 0x82, 0x01, 0x02, 0xff);
+  TEST_READ_FAILS(AZ_ERROR_UNEXPECTED_CHAR, 0x01, 0x02);
+
+  TEST_READ_FAILS(
+      AZ_ERROR_CBOR_NESTING_OVERFLOW,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x81,
+      0x00);
+
+  // An empty buffer has no data item.
+  assert_int_equal(az_cbor_reader_init(&reader, AZ_SPAN_EMPTY), AZ_OK);
+  assert_int_equal(az_cbor_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_END);
+
+#undef TEST_READ_FAILS
+}
+
+int test_az_cbor()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_cbor_writer_integers),
+    cmocka_unit_test(test_az_cbor_writer_floats),
+    cmocka_unit_test(test_az_cbor_writer_simple_values_and_strings),
+    cmocka_unit_test(test_az_cbor_writer_containers),
+    cmocka_unit_test(test_az_cbor_writer_int64_delta_array),
+    cmocka_unit_test(test_az_cbor_writer_not_enough_space),
+    cmocka_unit_test(test_az_cbor_writer_chunked),
+    cmocka_unit_test(test_az_cbor_reader_definite),
+    cmocka_unit_test(test_az_cbor_reader_reads_writer_output),
+    cmocka_unit_test(test_az_cbor_reader_invalid),
+  };
+  return cmocka_run_group_tests_name("az_core_cbor", tests, NULL, NULL);
+}
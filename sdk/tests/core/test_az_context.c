@@ -41,10 +41,78 @@ static void az_context_test(void** state)
   assert_true(expiration == 0);
 }
 
+static void az_context_cached_expiration_test(void** state)
+{
+  (void)state;
+
+  az_context root = az_context_create_with_expiration(&az_context_application, 1000);
+  az_context nodes[16];
+  az_context const* parent = &root;
+  for (int i = 0; i < 16; i++)
+  {
+    // Expirations later than the one of root don't change the effective expiration.
+    nodes[i] = (i % 2 == 0) ? az_context_create_with_expiration(parent, 2000 + i)
+                            : az_context_create_with_value(parent, &nodes[i], NULL);
+    parent = &nodes[i];
+  }
+  assert_int_equal(az_context_get_expiration(&nodes[15]), 1000);
+  assert_int_equal(nodes[15]._internal.effective_expiration, 1000);
+
+  az_context sooner = az_context_create_with_expiration(&nodes[15], 500);
+  assert_int_equal(az_context_get_expiration(&sooner), 500);
+  assert_false(az_context_has_expired(&sooner, 499));
+  assert_true(az_context_has_expired(&sooner, 501));
+
+  // Canceling a node reaches the nodes created from it before.
+  az_context sibling = az_context_create_with_expiration(&root, 3000);
+  az_context_cancel(&nodes[7]);
+  assert_int_equal(az_context_get_expiration(&nodes[6]), 1000);
+  assert_int_equal(az_context_get_expiration(&nodes[7]), 0);
+  assert_int_equal(az_context_get_expiration(&nodes[15]), 0);
+  assert_true(az_context_has_expired(&sooner, 1));
+  assert_int_equal(az_context_get_expiration(&sibling), 1000);
+
+  // And the ones created from it after.
+  az_context after = az_context_create_with_value(&nodes[15], &after, NULL);
+  assert_int_equal(after._internal.effective_expiration, 0);
+  assert_int_equal(az_context_get_expiration(&after), 0);
+
+  az_context_cancel(&root);
+  assert_int_equal(az_context_get_expiration(&sibling), 0);
+}
+
+static void az_context_wake_event_test(void** state)
+{
+  (void)state;
+
+  az_platform_event wake_event = { 0 };
+  az_platform_event* found = &wake_event;
+
+  // Without a wake event, the operations sleep.
+  assert_int_equal(
+      az_context_get_wake_event(&az_context_application, &found), AZ_ERROR_ITEM_NOT_FOUND);
+  assert_true(found == NULL);
+
+  az_context with_event = az_context_create_with_wake_event(&az_context_application, &wake_event);
+  az_context child = az_context_create_with_expiration(&with_event, 1000);
+  az_context with_value = az_context_create_with_value(&child, "k", "v");
+
+  assert_int_equal(az_context_get_wake_event(&with_value, &found), AZ_OK);
+  assert_true(found == &wake_event);
+
+  // The nearest wake event wins.
+  az_platform_event other_event = { 0 };
+  az_context with_other_event = az_context_create_with_wake_event(&with_value, &other_event);
+  assert_int_equal(az_context_get_wake_event(&with_other_event, &found), AZ_OK);
+  assert_true(found == &other_event);
+}
+
 int test_az_context()
 {
   const struct CMUnitTest tests[] = {
     cmocka_unit_test(az_context_test),
+    cmocka_unit_test(az_context_cached_expiration_test),
+    cmocka_unit_test(az_context_wake_event_test),
   };
   return cmocka_run_group_tests_name("az_core_context", tests, NULL, NULL);
 }
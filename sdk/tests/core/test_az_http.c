@@ -598,6 +598,42 @@ static void test_http_response(void** state)
     }
   }
 
+  // Bad response. handle a status code shorter than 3 digits, and an empty reason-phrase without
+  // CR
+  {
+    az_http_response response = { 0 };
+    az_http_response_status_line status_line = { 0 };
+
+    assert_int_equal(az_http_response_init(&response, AZ_SPAN_FROM_STR("HTTP/1.1 20")), AZ_OK);
+    assert_int_equal(
+        az_http_response_get_status_line(&response, &status_line),
+        AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER);
+
+    assert_int_equal(
+        az_http_response_init(&response, AZ_SPAN_FROM_STR("HTTP/1.1 200 \n\r\n")), AZ_OK);
+    assert_int_equal(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_OK);
+    assert_int_equal(az_span_size(status_line.reason_phrase), 0);
+  }
+
+  // Bad response. handle a header value truncated before its CR
+  {
+    az_span response_span = AZ_SPAN_FROM_STR( //
+        "HTTP/1.1 200 OK\r\n"
+        "header: value");
+
+    az_http_response response = { 0 };
+    assert_int_equal(az_http_response_init(&response, response_span), AZ_OK);
+
+    az_http_response_status_line status_line = { 0 };
+    assert_int_equal(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    az_span header_name = { 0 };
+    az_span header_value = { 0 };
+    assert_int_equal(
+        az_http_response_get_next_header(&response, &header_name, &header_value),
+        AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER);
+  }
+
   // Bad response. handle unexpected end when getting headers
   {
     az_span response_span = AZ_SPAN_FROM_STR( //
@@ -644,6 +680,126 @@ static void test_http_response(void** state)
   }
 }
 
+#define EXAMPLE_HEADERS_RESPONSE \
+  "HTTP/1.1 503 Service Unavailable\r\n" \
+  "Content-Type: application/json\r\n" \
+  "x-ms-request-id:  1234-abcd  \r\n" \
+  "ETag: \"0x8D\"\r\n" \
+  "Retry-After: 10\r\n" \
+  "x-ms-Request-ID: second\r\n" \
+  "Empty:\r\n" \
+  "\r\n" \
+  "{}"
+
+static void _test_http_response_find_header(az_http_response* ref_response)
+{
+  az_span value = { 0 };
+
+  TEST_EXPECT_SUCCESS(
+      az_http_response_find_header(ref_response, AZ_SPAN_FROM_STR("content-type"), &value));
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("application/json")));
+
+  // The first of several headers with the same name is found.
+  TEST_EXPECT_SUCCESS(
+      az_http_response_find_header(ref_response, AZ_SPAN_FROM_STR("X-MS-REQUEST-ID"), &value));
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("1234-abcd")));
+
+  TEST_EXPECT_SUCCESS(az_http_response_find_header(ref_response, AZ_SPAN_FROM_STR("ETag"), &value));
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("\"0x8D\"")));
+
+  TEST_EXPECT_SUCCESS(
+      az_http_response_find_header(ref_response, AZ_SPAN_FROM_STR("retry-after"), &value));
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("10")));
+
+  TEST_EXPECT_SUCCESS(
+      az_http_response_find_header(ref_response, AZ_SPAN_FROM_STR("empty"), &value));
+  assert_int_equal(az_span_size(value), 0);
+
+  assert_int_equal(
+      az_http_response_find_header(ref_response, AZ_SPAN_FROM_STR("Retry-After-Ms"), &value),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_http_response_find_header(ref_response, AZ_SPAN_FROM_STR("ETa"), &value),
+      AZ_ERROR_ITEM_NOT_FOUND);
+}
+
+static void test_http_response_find_header(void** state)
+{
+  (void)state;
+
+  // Without an index, and then with indexes that are too small, just large enough, or larger than
+  // the number of headers.
+  for (int32_t capacity = 0; capacity <= 9; capacity++)
+  {
+    az_http_response response = { 0 };
+    TEST_EXPECT_SUCCESS(
+        az_http_response_init(&response, AZ_SPAN_FROM_STR(EXAMPLE_HEADERS_RESPONSE)));
+
+    az_http_response_header_index_entry index[9];
+    if (capacity > 0)
+    {
+      TEST_EXPECT_SUCCESS(az_http_response_set_header_index(&response, index, capacity));
+    }
+
+    _test_http_response_find_header(&response);
+    // Once the index is built, it is used again.
+    _test_http_response_find_header(&response);
+
+    // Finding headers doesn't change the state of the parser.
+    az_http_response_status_line status_line = { 0 };
+    TEST_EXPECT_SUCCESS(az_http_response_get_status_line(&response, &status_line));
+    assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE);
+
+    az_span name = { 0 };
+    az_span value = { 0 };
+    TEST_EXPECT_SUCCESS(az_http_response_get_next_header(&response, &name, &value));
+    TEST_EXPECT_SUCCESS(
+        az_http_response_find_header(&response, AZ_SPAN_FROM_STR("Retry-After"), &value));
+    TEST_EXPECT_SUCCESS(az_http_response_get_next_header(&response, &name, &value));
+    assert_true(az_span_is_content_equal(name, AZ_SPAN_FROM_STR("x-ms-request-id")));
+  }
+}
+
+static void test_http_response_find_header_appended(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[256] = { 0 };
+  az_http_response response = { 0 };
+  TEST_EXPECT_SUCCESS(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)));
+
+  az_http_response_header_index_entry index[4];
+  TEST_EXPECT_SUCCESS(az_http_response_set_header_index(&response, index, _az_COUNTOF(index)));
+
+  // A response that is still incomplete can't be indexed.
+  TEST_EXPECT_SUCCESS(az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n")));
+  TEST_EXPECT_SUCCESS(az_http_response_append(&response, AZ_SPAN_FROM_STR("ETag: 1\r\n")));
+  az_span value = { 0 };
+  assert_true(
+      az_result_failed(az_http_response_find_header(&response, AZ_SPAN_FROM_STR("ETag"), &value)));
+
+  // Appending more of the response rebuilds the index.
+  TEST_EXPECT_SUCCESS(az_http_response_append(&response, AZ_SPAN_FROM_STR("Retry-After: 2\r\n")));
+  TEST_EXPECT_SUCCESS(az_http_response_append(&response, AZ_SPAN_FROM_STR("\r\n")));
+  TEST_EXPECT_SUCCESS(az_http_response_find_header(&response, AZ_SPAN_FROM_STR("etag"), &value));
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("1")));
+  TEST_EXPECT_SUCCESS(
+      az_http_response_find_header(&response, AZ_SPAN_FROM_STR("retry-after"), &value));
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("2")));
+
+  // Resetting the response keeps the index attached, and rebuilds it for the new response.
+  _az_http_response_reset(&response);
+  TEST_EXPECT_SUCCESS(az_http_response_append(
+      &response, AZ_SPAN_FROM_STR("HTTP/1.1 429 Too Many Requests\r\nRetry-After: 7\r\n\r\n")));
+  TEST_EXPECT_SUCCESS(
+      az_http_response_find_header(&response, AZ_SPAN_FROM_STR("Retry-After"), &value));
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("7")));
+  assert_ptr_equal(response._internal.header_index.entries, index);
+  assert_int_equal(
+      az_http_response_find_header(&response, AZ_SPAN_FROM_STR("ETag"), &value),
+      AZ_ERROR_ITEM_NOT_FOUND);
+}
+
 #ifndef AZ_NO_PRECONDITION_CHECKING
 ENABLE_PRECONDITION_CHECK_TESTS()
 
@@ -763,6 +919,25 @@ static void test_http_request_header_validation_range(void** state)
   }
 }
 
+static void test_http_request_header_name_validation(void** state)
+{
+  (void)state;
+  {
+    assert_true(az_http_is_valid_header_name(AZ_SPAN_EMPTY));
+    assert_true(az_http_is_valid_header_name(AZ_SPAN_FROM_STR("Accept")));
+    assert_true(az_http_is_valid_header_name(AZ_SPAN_FROM_STR("x-ms-client-request-id")));
+
+    // Invalid bytes within a full word, and within the remaining bytes.
+    assert_false(az_http_is_valid_header_name(AZ_SPAN_FROM_STR("x-ms(client-request-id")));
+    assert_false(az_http_is_valid_header_name(AZ_SPAN_FROM_STR("x-ms-client-request:id")));
+    assert_false(az_http_is_valid_header_name(AZ_SPAN_FROM_STR("Accept:")));
+
+    // Non-ASCII bytes within a full word, and within the remaining bytes.
+    assert_false(az_http_is_valid_header_name(AZ_SPAN_FROM_STR("x-ms-\xC3\xA9t\xC3\xA9")));
+    assert_false(az_http_is_valid_header_name(AZ_SPAN_FROM_STR("x-ms-client-\xFF")));
+  }
+}
+
 static void test_http_response_header_validation(void** state)
 {
   (void)state;
@@ -957,6 +1132,394 @@ static void test_http_response_append_overflow_on_second_call(void** state)
   }
 }
 
+static az_result _test_body_reader(
+    void* user_context,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size)
+{
+  // Produces the bytes of user_context, at most 4 at a time.
+  az_span const source = *(az_span*)user_context;
+  az_span const remaining = az_span_slice_to_end(source, (int32_t)offset);
+  int32_t size = az_span_size(remaining) < 4 ? az_span_size(remaining) : 4;
+  size = size < az_span_size(destination) ? size : az_span_size(destination);
+  az_span_copy(destination, az_span_slice(remaining, 0, size));
+  *out_size = size;
+  return AZ_OK;
+}
+
+static void test_http_request_read_body(void** state)
+{
+  (void)state;
+  uint8_t url_buf[20] = "http://x";
+  uint8_t header_buf[sizeof(_az_http_request_header)];
+  uint8_t chunk_buf[6];
+  az_span const chunk = AZ_SPAN_FROM_BUFFER(chunk_buf);
+  int32_t size = -1;
+  {
+    az_http_request request;
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_put(),
+            AZ_SPAN_FROM_BUFFER(url_buf),
+            8,
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            AZ_SPAN_FROM_STR("0123456789")),
+        AZ_OK);
+
+    assert_false(az_http_request_has_body_reader(&request));
+    assert_true(az_http_request_get_body_length(&request) == 10);
+
+    assert_return_code(az_http_request_read_body(&request, 0, chunk, &size), AZ_OK);
+    assert_int_equal(size, 6);
+    assert_memory_equal(chunk_buf, "012345", 6);
+    assert_return_code(az_http_request_read_body(&request, 6, chunk, &size), AZ_OK);
+    assert_int_equal(size, 4);
+    assert_memory_equal(chunk_buf, "6789", 4);
+    assert_return_code(az_http_request_read_body(&request, 10, chunk, &size), AZ_OK);
+    assert_int_equal(size, 0);
+  }
+  {
+    az_span source = AZ_SPAN_FROM_STR("abcdefghij");
+    az_http_request request;
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_post(),
+            AZ_SPAN_FROM_BUFFER(url_buf),
+            8,
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            AZ_SPAN_EMPTY),
+        AZ_OK);
+    assert_return_code(
+        az_http_request_set_body_reader(&request, _test_body_reader, &source, -1), AZ_OK);
+
+    assert_true(az_http_request_has_body_reader(&request));
+    assert_true(az_http_request_get_body_length(&request) == -1);
+
+    az_span body = { 0 };
+    assert_return_code(az_http_request_get_body(&request, &body), AZ_OK);
+    assert_int_equal(az_span_size(body), 0);
+
+    assert_return_code(az_http_request_read_body(&request, 0, chunk, &size), AZ_OK);
+    assert_int_equal(size, 4);
+    assert_memory_equal(chunk_buf, "abcd", 4);
+    assert_return_code(az_http_request_read_body(&request, 8, chunk, &size), AZ_OK);
+    assert_int_equal(size, 2);
+    assert_memory_equal(chunk_buf, "ij", 2);
+    assert_return_code(az_http_request_read_body(&request, 10, chunk, &size), AZ_OK);
+    assert_int_equal(size, 0);
+  }
+}
+
+static void test_http_request_reset(void** state)
+{
+  (void)state;
+
+  uint8_t url_buf[100] = { 0 };
+  uint8_t header_buf[3 * sizeof(_az_http_request_header)] = { 0 };
+  az_span const url = AZ_SPAN_FROM_BUFFER(url_buf);
+  (void)az_span_copy(url, request_url);
+
+  az_http_request request;
+  TEST_EXPECT_SUCCESS(az_http_request_init(
+      &request,
+      &az_context_application,
+      az_http_method_put(),
+      url,
+      az_span_size(request_url),
+      AZ_SPAN_FROM_BUFFER(header_buf),
+      AZ_SPAN_EMPTY));
+
+  // The API version and the content type are the same for every request.
+  TEST_EXPECT_SUCCESS(az_http_request_set_query_parameter(
+      &request, request_param_api_version_name, request_param_api_version_token, true));
+  TEST_EXPECT_SUCCESS(az_http_request_append_header(
+      &request, request_header_content_type_name, request_header_content_type_token));
+  az_http_request_save_template(&request);
+
+  az_span url_out = { 0 };
+  az_span name = { 0 };
+  az_span value = { 0 };
+  for (int32_t i = 0; i < 3; ++i)
+  {
+    az_http_request_reset(&request, &az_context_application, AZ_SPAN_FROM_STR("body"));
+    assert_int_equal(az_http_request_headers_count(&request), 1);
+    assert_true(az_span_is_content_equal(request._internal.body, AZ_SPAN_FROM_STR("body")));
+
+    TEST_EXPECT_SUCCESS(az_http_request_set_query_parameter(
+        &request, request_param_test_param_name, request_param_test_param_token, true));
+    TEST_EXPECT_SUCCESS(az_http_request_append_header(
+        &request, request_header_authorization_name, request_header_authorization_token1));
+    TEST_EXPECT_SUCCESS(_az_http_request_mark_retry_headers_start(&request));
+    TEST_EXPECT_SUCCESS(az_http_request_append_header(
+        &request, request_header_authorization_name, request_header_authorization_token2));
+
+    TEST_EXPECT_SUCCESS(az_http_request_get_url(&request, &url_out));
+    assert_true(az_span_is_content_equal(url_out, request_url3));
+    assert_int_equal(az_http_request_headers_count(&request), 3);
+  }
+
+  // Another request starts with the URL and headers of the template, in its own buffers.
+  uint8_t url_buf2[100] = { 0 };
+  uint8_t header_buf2[2 * sizeof(_az_http_request_header)] = { 0 };
+  az_http_request request2;
+  TEST_EXPECT_SUCCESS(az_http_request_init_from_template(
+      &request2,
+      &request,
+      &az_context_application,
+      AZ_SPAN_FROM_BUFFER(url_buf2),
+      AZ_SPAN_FROM_BUFFER(header_buf2),
+      AZ_SPAN_EMPTY));
+
+  TEST_EXPECT_SUCCESS(az_http_request_get_url(&request2, &url_out));
+  assert_true(az_span_is_content_equal(url_out, request_url2));
+  assert_ptr_equal(az_span_ptr(url_out), url_buf2);
+  assert_int_equal(az_http_request_headers_count(&request2), 1);
+  TEST_EXPECT_SUCCESS(az_http_request_get_header(&request2, 0, &name, &value));
+  assert_true(az_span_is_content_equal(name, request_header_content_type_name));
+  assert_true(az_span_is_content_equal(value, request_header_content_type_token));
+
+  // Query parameters go after the ones of the template.
+  TEST_EXPECT_SUCCESS(az_http_request_set_query_parameter(
+      &request2, request_param_test_param_name, request_param_test_param_token, true));
+  TEST_EXPECT_SUCCESS(az_http_request_get_url(&request2, &url_out));
+  assert_true(az_span_is_content_equal(url_out, request_url3));
+
+  // The buffers have to be large enough for the template.
+  assert_int_equal(
+      az_http_request_init_from_template(
+          &request2,
+          &request,
+          &az_context_application,
+          az_span_slice(AZ_SPAN_FROM_BUFFER(url_buf2), 0, 10),
+          AZ_SPAN_FROM_BUFFER(header_buf2),
+          AZ_SPAN_EMPTY),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+typedef struct
+{
+  uint8_t* buffer;
+  int32_t offset;
+  int32_t calls;
+  int32_t bytes_used_sum;
+} _test_body_chunks;
+
+static az_result _test_body_chunks_allocator(
+    az_span_allocator_context* allocator_context,
+    az_span* out_next_destination)
+{
+  _test_body_chunks* const chunks = (_test_body_chunks*)allocator_context->user_context;
+  chunks->bytes_used_sum += allocator_context->bytes_used;
+  chunks->calls++;
+
+  // Hand out consecutive 4 byte chunks of the same buffer, up to 16 bytes.
+  if (chunks->offset == 16)
+  {
+    return AZ_ERROR_OUT_OF_MEMORY;
+  }
+
+  *out_next_destination = az_span_create(chunks->buffer + chunks->offset, 4);
+  chunks->offset += 4;
+  return AZ_OK;
+}
+
+static void test_http_response_append_body_to_allocator(void** state)
+{
+  (void)state;
+  {
+    // The fixed buffer only needs to hold the status line and the headers.
+    uint8_t buffer[40];
+    uint8_t body[16] = { 0 };
+    _test_body_chunks chunks = { .buffer = body, .offset = 0, .calls = 0, .bytes_used_sum = 0 };
+
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    assert_return_code(
+        az_http_response_set_body_allocator(&response, _test_body_chunks_allocator, &chunks),
+        AZ_OK);
+    assert_int_equal(az_http_response_get_bytes_used_in_body_destination(&response), 0);
+
+    assert_return_code(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\nA: b\r\n\r\n")),
+        AZ_OK);
+    assert_return_code(
+        az_http_response_append_body(&response, AZ_SPAN_FROM_STR("0123456789")), AZ_OK);
+    assert_return_code(az_http_response_append_body(&response, AZ_SPAN_FROM_STR("abc")), AZ_OK);
+
+    assert_memory_equal(body, "0123456789abc", 13);
+    assert_int_equal(chunks.calls, 4);
+    assert_int_equal(chunks.bytes_used_sum, 12);
+    assert_int_equal(az_http_response_get_bytes_used_in_body_destination(&response), 1);
+
+    az_span body_in_response = { 0 };
+    assert_return_code(az_http_response_get_body(&response, &body_in_response), AZ_OK);
+    assert_int_equal(az_span_size(body_in_response), 0);
+
+    // The allocator failure is returned once it runs out of buffers.
+    assert_true(
+        az_http_response_append_body(&response, AZ_SPAN_FROM_STR("defghi"))
+        == AZ_ERROR_OUT_OF_MEMORY);
+  }
+  {
+    // Without an allocator, the body goes into the response buffer.
+    uint8_t buffer[10];
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    assert_return_code(
+        az_http_response_append_body(&response, AZ_SPAN_FROM_STR("0123456789")), AZ_OK);
+    assert_memory_equal(buffer, "0123456789", 10);
+    assert_true(
+        az_http_response_append_body(&response, AZ_SPAN_FROM_STR("a"))
+        == AZ_ERROR_NOT_ENOUGH_SPACE);
+  }
+}
+
+typedef struct
+{
+  az_http_response_event events[8];
+  int32_t count;
+  az_span body_chunks[4];
+  int32_t body_chunk_count;
+} _test_response_events;
+
+static az_result _test_response_event_callback(
+    az_http_response_event const* event,
+    void* user_context)
+{
+  _test_response_events* const events = (_test_response_events*)user_context;
+  if (events->count == 8)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  events->events[events->count++] = *event;
+  if (event->kind == AZ_HTTP_RESPONSE_EVENT_BODY)
+  {
+    events->body_chunks[events->body_chunk_count++] = event->value;
+  }
+
+  return AZ_OK;
+}
+
+static void test_http_response_events(void** state)
+{
+  (void)state;
+  {
+    uint8_t buffer[100];
+    _test_response_events events = { 0 };
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    assert_return_code(
+        az_http_response_set_event_callback(&response, _test_response_event_callback, &events),
+        AZ_OK);
+
+    // Lines split across appends are only raised once complete.
+    assert_return_code(az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 2")), AZ_OK);
+    assert_int_equal(events.count, 0);
+    assert_return_code(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("01 Created\r\nContent-Type: ")),
+        AZ_OK);
+    assert_int_equal(events.count, 1);
+    assert_int_equal(events.events[0].kind, AZ_HTTP_RESPONSE_EVENT_STATUS_LINE);
+    assert_int_equal(events.events[0].status_line.status_code, AZ_HTTP_STATUS_CODE_CREATED);
+    assert_true(az_span_is_content_equal(
+        events.events[0].status_line.reason_phrase, AZ_SPAN_FROM_STR("Created")));
+
+    // The beginning of the body can come along with the end of the headers.
+    assert_return_code(
+        az_http_response_append(
+            &response, AZ_SPAN_FROM_STR("application/json\r\nx-a:  b \r\n\r\n{\"n\":")),
+        AZ_OK);
+    assert_int_equal(events.count, 5);
+    assert_int_equal(events.events[1].kind, AZ_HTTP_RESPONSE_EVENT_HEADER);
+    assert_true(az_span_is_content_equal(events.events[1].name, AZ_SPAN_FROM_STR("Content-Type")));
+    assert_true(
+        az_span_is_content_equal(events.events[1].value, AZ_SPAN_FROM_STR("application/json")));
+    assert_int_equal(events.events[2].kind, AZ_HTTP_RESPONSE_EVENT_HEADER);
+    assert_true(az_span_is_content_equal(events.events[2].name, AZ_SPAN_FROM_STR("x-a")));
+    assert_true(az_span_is_content_equal(events.events[2].value, AZ_SPAN_FROM_STR("b")));
+    assert_int_equal(events.events[3].kind, AZ_HTTP_RESPONSE_EVENT_END_OF_HEADERS);
+    assert_int_equal(events.events[4].kind, AZ_HTTP_RESPONSE_EVENT_BODY);
+
+    assert_return_code(az_http_response_append_body(&response, AZ_SPAN_FROM_STR("42}")), AZ_OK);
+    assert_int_equal(events.count, 6);
+    assert_int_equal(events.body_chunk_count, 2);
+
+    // The body parts can be read by the JSON reader without being copied together.
+    az_json_reader reader = { 0 };
+    assert_return_code(
+        az_json_reader_chunked_init(&reader, events.body_chunks, events.body_chunk_count, NULL),
+        AZ_OK);
+    assert_return_code(az_json_reader_next_token(&reader), AZ_OK);
+    assert_return_code(az_json_reader_next_token(&reader), AZ_OK);
+    assert_true(az_json_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("n")));
+    assert_return_code(az_json_reader_next_token(&reader), AZ_OK);
+    int32_t value = 0;
+    assert_return_code(az_json_token_get_int32(&reader.token, &value), AZ_OK);
+    assert_int_equal(value, 42);
+
+    // The pull parser is not affected. It returns the rest of the buffer as body.
+    az_span body = { 0 };
+    assert_return_code(az_http_response_get_body(&response, &body), AZ_OK);
+    assert_true(
+        az_span_is_content_equal(az_span_slice(body, 0, 8), AZ_SPAN_FROM_STR("{\"n\":42}")));
+
+    // Once reset, the events are raised again for the next response.
+    _az_http_response_reset(&response);
+    assert_return_code(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 404 Not Found\r\n")),
+        AZ_OK);
+    assert_int_equal(events.count, 7);
+    assert_int_equal(events.events[6].status_line.status_code, AZ_HTTP_STATUS_CODE_NOT_FOUND);
+  }
+  {
+    // With a body allocator, each part of the body points into the buffer it was written into.
+    uint8_t buffer[40];
+    uint8_t body[16] = { 0 };
+    _test_body_chunks chunks = { .buffer = body, .offset = 0, .calls = 0, .bytes_used_sum = 0 };
+    _test_response_events events = { 0 };
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    assert_return_code(
+        az_http_response_set_body_allocator(&response, _test_body_chunks_allocator, &chunks),
+        AZ_OK);
+    assert_return_code(
+        az_http_response_set_event_callback(&response, _test_response_event_callback, &events),
+        AZ_OK);
+
+    assert_return_code(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\n")), AZ_OK);
+    assert_return_code(
+        az_http_response_append_body(&response, AZ_SPAN_FROM_STR("012345")), AZ_OK);
+    assert_int_equal(events.count, 4);
+    assert_int_equal(events.events[1].kind, AZ_HTTP_RESPONSE_EVENT_END_OF_HEADERS);
+    assert_int_equal(events.body_chunk_count, 2);
+    assert_ptr_equal(az_span_ptr(events.body_chunks[0]), body);
+    assert_true(az_span_is_content_equal(events.body_chunks[0], AZ_SPAN_FROM_STR("0123")));
+    assert_ptr_equal(az_span_ptr(events.body_chunks[1]), body + 4);
+    assert_true(az_span_is_content_equal(events.body_chunks[1], AZ_SPAN_FROM_STR("45")));
+  }
+  {
+    // A corrupt header fails the append, so the transport stops receiving the response.
+    uint8_t buffer[40];
+    _test_response_events events = { 0 };
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    assert_return_code(
+        az_http_response_set_event_callback(&response, _test_response_event_callback, &events),
+        AZ_OK);
+    assert_int_equal(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\nA(: b\r\n")),
+        AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER);
+    assert_int_equal(events.count, 1);
+  }
+}
+
 int test_az_http()
 {
 #ifndef AZ_NO_PRECONDITION_CHECKING
@@ -972,13 +1535,20 @@ int test_az_http()
 #endif // AZ_NO_PRECONDITION_CHECKING
     cmocka_unit_test(test_http_request),
     cmocka_unit_test(test_http_response),
+    cmocka_unit_test(test_http_response_find_header),
+    cmocka_unit_test(test_http_response_find_header_appended),
     cmocka_unit_test(test_http_request_header_validation_range),
+    cmocka_unit_test(test_http_request_header_name_validation),
     cmocka_unit_test(test_http_response_header_validation),
     cmocka_unit_test(test_http_response_header_validation_fail),
     cmocka_unit_test(test_http_response_header_validation_space),
     cmocka_unit_test(test_http_response_append_overflow),
     cmocka_unit_test(test_http_response_append),
     cmocka_unit_test(test_http_response_append_overflow_on_second_call),
+    cmocka_unit_test(test_http_response_append_body_to_allocator),
+    cmocka_unit_test(test_http_response_events),
+    cmocka_unit_test(test_http_request_read_body),
+    cmocka_unit_test(test_http_request_reset),
   };
   return cmocka_run_group_tests_name("az_core_http", tests, NULL, NULL);
 }
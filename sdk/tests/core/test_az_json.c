@@ -9,6 +9,8 @@
 #include <math.h>
 #include <setjmp.h>
 #include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
 
 #include <cmocka.h>
 
@@ -142,6 +144,78 @@ static void test_json_writer(void** state)
       assert_string_equal(array, "0");
     }
   }
+  {
+    uint8_t array[100] = { 0 };
+    az_json_writer writer = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 23.75));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 0.1 + 0.2));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, -1e-300));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 1e21));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 0));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+
+    az_span_to_str((char*)array, 100, az_json_writer_get_bytes_used_in_destination(&writer));
+    assert_string_equal(array, "[23.75,0.30000000000000004,-1e-300,1e+21,0]");
+
+    // The writer needs room for the longest double, regardless of the value.
+    uint8_t small_array[38] = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(small_array), NULL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, -1.5));
+    assert_int_equal(
+        az_json_writer_append_double_shortest(&writer, 1), AZ_ERROR_NOT_ENOUGH_SPACE);
+  }
+  {
+    uint8_t array[100] = { 0 };
+    az_json_writer writer = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_int64(&writer, INT64_MIN));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_int64(&writer, 1602744332522LL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_int64(&writer, 0));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_uint64(&writer, UINT64_MAX));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_uint64(&writer, 9007199254740993ULL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+
+    az_span_to_str((char*)array, 100, az_json_writer_get_bytes_used_in_destination(&writer));
+    assert_string_equal(
+        array,
+        "[-9223372036854775808,1602744332522,0,18446744073709551615,9007199254740993]");
+
+    // The writer needs room for the longest integer, regardless of the value.
+    uint8_t small_array[20] = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(small_array), NULL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_uint64(&writer, 1));
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(small_array), NULL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+    assert_int_equal(az_json_writer_append_int64(&writer, 1), AZ_ERROR_NOT_ENOUGH_SPACE);
+  }
+  {
+    uint8_t array[200] = { 0 };
+    az_json_writer writer = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("sent")));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_iso8601(&writer, 1602744332522LL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("times")));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_iso8601(&writer, 0));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_iso8601(&writer, -1));
+    assert_int_equal(az_json_writer_append_iso8601(&writer, 253402300800000LL), AZ_ERROR_ARG);
+    TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+
+    az_span_to_str((char*)array, 200, az_json_writer_get_bytes_used_in_destination(&writer));
+    assert_string_equal(
+        array,
+        "{\"sent\":\"2020-10-15T06:45:32.522Z\",\"times\":[\"1970-01-01T00:00:00.000Z\","
+        "\"1969-12-31T23:59:59.999Z\"]}");
+  }
   {
     // json with AZ_JSON_TOKEN_STRING
     uint8_t array[200] = { 0 };
@@ -248,6 +322,28 @@ static void test_json_writer_append_nested(void** state)
       assert_string_equal(array, "{\"name\":  \"f\\u0065o\", \"values\": [1, 2, 3,{}]}");
     }
 
+    {
+      // Without validation, the JSON text is appended as is, even when it is malformed.
+      az_json_writer_options options = az_json_writer_options_default();
+      options.append_json_text_without_validation = true;
+
+      TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), &options));
+      TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+      TEST_EXPECT_SUCCESS(
+          az_json_writer_append_json_text(&writer, AZ_SPAN_FROM_STR(" {\"a\": 1} ")));
+      TEST_EXPECT_SUCCESS(az_json_writer_append_json_text(&writer, AZ_SPAN_FROM_STR("false")));
+      TEST_EXPECT_SUCCESS(az_json_writer_append_json_text(&writer, AZ_SPAN_FROM_STR("[1,]")));
+      TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+
+      az_span_to_str((char*)array, 200, az_json_writer_get_bytes_used_in_destination(&writer));
+      assert_string_equal(array, "[ {\"a\": 1} ,false,[1,]]");
+
+      // The state of the writer is still validated.
+      assert_int_equal(
+          az_json_writer_append_json_text(&writer, AZ_SPAN_FROM_STR("1")),
+          AZ_ERROR_JSON_INVALID_STATE);
+    }
+
     {
       TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
       TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
@@ -984,6 +1080,531 @@ static void test_json_writer_large_string_chunked(void** state)
   }
 }
 
+static void test_json_writer_escaped_string_blocks(void** state)
+{
+  (void)state;
+
+  // The characters to escape are found, and escaped, at any position within and across the blocks
+  // of bytes that are scanned at once.
+  uint8_t const to_escape[] = { '"', '\\', '\n', 0x01 };
+  char const* const escaped[] = { "\\\"", "\\\\", "\\n", "\\u0001" };
+
+  for (int32_t c = 0; c < 4; c++)
+  {
+    for (int32_t size = 1; size <= 70; size++)
+    {
+      for (int32_t position = 0; position < size; position++)
+      {
+        uint8_t value[70];
+        memset(value, 'a', sizeof(value));
+        value[position] = to_escape[c];
+        az_span const value_span = az_span_create(value, size);
+
+        char expected[160] = { 0 };
+        memset(expected, 'a', (size_t)position);
+        strcat(expected, escaped[c]);
+        memset(expected + strlen(expected), 'a', (size_t)(size - position - 1));
+
+        uint8_t array[400] = { 0 };
+        az_json_writer writer = { 0 };
+        TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+        TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+        TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, value_span));
+        TEST_EXPECT_SUCCESS(az_json_writer_append_string(&writer, value_span));
+        TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+
+        char expected_json[400] = { 0 };
+        assert_true(
+            snprintf(expected_json, sizeof(expected_json), "{\"%s\":\"%s\"}", expected, expected)
+            > 0);
+        az_span const json = az_json_writer_get_bytes_used_in_destination(&writer);
+        assert_int_equal(az_span_size(json), (int32_t)strlen(expected_json));
+        assert_memory_equal(az_span_ptr(json), expected_json, strlen(expected_json));
+      }
+    }
+  }
+}
+
+static void test_json_writer_append_escaped_property_name(void** state)
+{
+  (void)state;
+
+  static az_span const temperature = AZ_JSON_NAME_LITERAL("temperature");
+
+  // The pre-escaped names give the same JSON as the names escaped by the writer.
+  uint8_t array[200] = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_escaped_property_name(&writer, temperature));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_int32(&writer, 21));
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_append_escaped_property_name(&writer, AZ_JSON_NAME("a\\\"b\\u001F")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("c")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_escaped_property_name(&writer, AZ_JSON_NAME("d")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_null(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+
+  az_span const expected
+      = AZ_SPAN_FROM_STR("{\"temperature\":21,\"a\\\"b\\u001F\":[],\"c\":{\"d\":null}}");
+  assert_true(
+      az_span_is_content_equal(az_json_writer_get_bytes_used_in_destination(&writer), expected));
+  assert_int_equal(writer._internal.total_bytes_written, az_span_size(expected));
+
+  uint8_t escaped_array[200] = { 0 };
+  az_json_writer escaping_writer = { 0 };
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_init(&escaping_writer, AZ_SPAN_FROM_BUFFER(escaped_array), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&escaping_writer));
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_append_property_name(&escaping_writer, AZ_SPAN_FROM_STR("temperature")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_int32(&escaping_writer, 21));
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_append_property_name(&escaping_writer, AZ_SPAN_FROM_STR("a\"b\x1F")));
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&escaping_writer),
+      AZ_SPAN_FROM_STR("{\"temperature\":21,\"a\\\"b\\u001F\":")));
+
+  // A buffer of the exact size is enough, a smaller one isn't.
+  uint8_t exact_array[10] = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(exact_array), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_escaped_property_name(&writer, AZ_JSON_NAME("a")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_null(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer), AZ_SPAN_FROM_STR("{\"a\":null}")));
+
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, az_span_create(exact_array, 4), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+  assert_int_equal(
+      az_json_writer_append_escaped_property_name(&writer, AZ_JSON_NAME("a")),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  // Names longer than a chunk are split across the buffers of a chunked writer.
+  uint8_t long_name[302] = { 0 };
+  memset(long_name, 'n', sizeof(long_name));
+  long_name[0] = '"';
+  long_name[300] = '"';
+  long_name[301] = ':';
+
+  az_span_allocator_fn allocator = &test_allocator_chunked;
+  int32_t previous = 0;
+  _az_user_context user_context = { .current_index = &previous };
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_chunked_init(&writer, AZ_SPAN_EMPTY, allocator, (void*)&user_context, NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_append_escaped_property_name(&writer, AZ_SPAN_FROM_BUFFER(long_name)));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_int32(&writer, 1));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+  assert_int_equal(writer._internal.total_bytes_written, 305);
+
+  uint8_t written[305] = { 0 };
+  az_span remaining = AZ_SPAN_FROM_BUFFER(written);
+  for (int32_t i = 0; i < previous - 1; i++)
+  {
+    remaining = az_span_copy(remaining, json_buffers[i]);
+  }
+  remaining = az_span_copy(remaining, az_json_writer_get_bytes_used_in_destination(&writer));
+  assert_int_equal(az_span_size(remaining), 0);
+  assert_int_equal(written[0], '{');
+  assert_true(az_span_is_content_equal(
+      az_span_slice(AZ_SPAN_FROM_BUFFER(written), 1, 303), AZ_SPAN_FROM_BUFFER(long_name)));
+  assert_int_equal(written[303], '1');
+  assert_int_equal(written[304], '}');
+}
+
+static void test_json_writer_vectored(void** state)
+{
+  (void)state;
+
+  az_span const component = AZ_SPAN_FROM_STR("{\"targetTemperature\":21.5}");
+
+  uint8_t array[100] = { 0 };
+  az_span vectors[6] = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_vectored_init(&writer, AZ_SPAN_FROM_BUFFER(array), vectors, 6, NULL));
+
+  // A JSON text at the very start doesn't need a slice of the buffer before it.
+  TEST_EXPECT_SUCCESS(az_json_writer_append_json_text_reference(&writer, AZ_SPAN_FROM_STR("[1]")));
+  assert_int_equal(az_json_writer_get_vectors_count(&writer), 1);
+
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_vectored_init(&writer, AZ_SPAN_FROM_BUFFER(array), vectors, 6, NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("a")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_json_text_reference(&writer, component));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("b")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_json_text_reference(&writer, component));
+
+  // There is no room for a third reference, with its slices before and after.
+  assert_int_equal(
+      az_json_writer_append_json_text_reference(&writer, component), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_json_writer_append_json_text_reference(&writer, AZ_SPAN_FROM_STR("{")),
+      AZ_ERROR_UNEXPECTED_END);
+
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+
+  int32_t const vectors_count = az_json_writer_get_vectors_count(&writer);
+  assert_int_equal(vectors_count, 5);
+  assert_ptr_equal(az_span_ptr(vectors[1]), az_span_ptr(component));
+  assert_ptr_equal(az_span_ptr(vectors[3]), az_span_ptr(component));
+
+  uint8_t json[200] = { 0 };
+  az_span remaining = AZ_SPAN_FROM_BUFFER(json);
+  for (int32_t i = 0; i < vectors_count; i++)
+  {
+    remaining = az_span_copy(remaining, vectors[i]);
+  }
+
+  az_span const expected = AZ_SPAN_FROM_STR(
+      "{\"a\":{\"targetTemperature\":21.5},\"b\":[{\"targetTemperature\":21.5}]}");
+  assert_true(az_span_is_content_equal(
+      az_span_slice(AZ_SPAN_FROM_BUFFER(json), 0, 200 - az_span_size(remaining)), expected));
+  assert_int_equal(writer._internal.total_bytes_written, az_span_size(expected));
+
+  // Only the JSON text around the references is written into the buffer.
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_STR("{\"a\":,\"b\":[]}")));
+}
+
+typedef struct
+{
+  az_span remaining;
+  int32_t call_count;
+  int32_t fail_after;
+} _az_test_json_sink;
+
+static az_result _az_test_json_sink_callback(void* user_context, az_span json_text)
+{
+  _az_test_json_sink* sink = (_az_test_json_sink*)user_context;
+  sink->call_count++;
+  if (sink->call_count > sink->fail_after)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  // Each part of the JSON text is handed to the sink only once, and doesn't come back empty.
+  assert_true(az_span_size(json_text) > 0);
+  sink->remaining = az_span_copy(sink->remaining, json_text);
+  return AZ_OK;
+}
+
+static az_result _az_test_json_write_report(az_json_writer* ref_json_writer)
+{
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_json_writer));
+  for (int32_t i = 0; i < 10; i++)
+  {
+    _az_RETURN_IF_FAILED(
+        az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("temperature")));
+    _az_RETURN_IF_FAILED(az_json_writer_append_double(ref_json_writer, 21.5 + i, 2));
+    _az_RETURN_IF_FAILED(
+        az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("status")));
+    _az_RETURN_IF_FAILED(az_json_writer_append_string(
+        ref_json_writer,
+        AZ_SPAN_FROM_STR("a \"quoted\" status, long enough to be split between the parts of the "
+                         "JSON text handed to the sink\n")));
+  }
+  return az_json_writer_append_end_object(ref_json_writer);
+}
+
+static void test_json_writer_sink(void** state)
+{
+  (void)state;
+
+  uint8_t expected_json[2048] = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(expected_json), NULL));
+  TEST_EXPECT_SUCCESS(_az_test_json_write_report(&writer));
+  az_span const expected = az_json_writer_get_bytes_used_in_destination(&writer);
+
+  // The whole JSON text goes through a working buffer much smaller than it.
+  uint8_t json[2048] = { 0 };
+  uint8_t working_buffer[64] = { 0 };
+  _az_test_json_sink sink = { .remaining = AZ_SPAN_FROM_BUFFER(json), .fail_after = INT32_MAX };
+  TEST_EXPECT_SUCCESS(az_json_writer_sink_init(
+      &writer, AZ_SPAN_FROM_BUFFER(working_buffer), _az_test_json_sink_callback, &sink, NULL));
+  TEST_EXPECT_SUCCESS(_az_test_json_write_report(&writer));
+  assert_true(sink.call_count > az_span_size(expected) / 64);
+  TEST_EXPECT_SUCCESS(az_json_writer_flush(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_flush(&writer));
+
+  assert_true(az_span_is_content_equal(
+      az_span_slice(AZ_SPAN_FROM_BUFFER(json), 0, 2048 - az_span_size(sink.remaining)),
+      expected));
+  assert_int_equal(writer._internal.total_bytes_written, az_span_size(expected));
+
+  // A failing sink fails the writer.
+  sink = (_az_test_json_sink){ .remaining = AZ_SPAN_FROM_BUFFER(json), .fail_after = 2 };
+  TEST_EXPECT_SUCCESS(az_json_writer_sink_init(
+      &writer, AZ_SPAN_FROM_BUFFER(working_buffer), _az_test_json_sink_callback, &sink, NULL));
+  assert_int_equal(_az_test_json_write_report(&writer), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(sink.call_count, 3);
+}
+
+static void test_json_writer_rollback(void** state)
+{
+  (void)state;
+
+  // Batch as many elements as fit, rolling back the one that doesn't, before closing the batch.
+  uint8_t array[200] = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+
+  int32_t element_count = 0;
+  az_result result = AZ_OK;
+  while (true)
+  {
+    az_json_writer_checkpoint const checkpoint = az_json_writer_get_checkpoint(&writer);
+    result = az_json_writer_append_begin_object(&writer);
+    if (az_result_succeeded(result))
+    {
+      result = az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("value"));
+    }
+    if (az_result_succeeded(result))
+    {
+      result = az_json_writer_append_string(&writer, AZ_SPAN_FROM_STR("a \"quoted\" reading"));
+    }
+    if (az_result_succeeded(result))
+    {
+      result = az_json_writer_append_end_object(&writer);
+    }
+    if (az_result_failed(result))
+    {
+      TEST_EXPECT_SUCCESS(az_json_writer_rollback(&writer, &checkpoint));
+      break;
+    }
+    element_count++;
+  }
+  assert_int_equal(result, AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(element_count, 4);
+
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+  az_span const expected = AZ_SPAN_FROM_STR("[{\"value\":\"a \\\"quoted\\\" reading\"},"
+                                            "{\"value\":\"a \\\"quoted\\\" reading\"},"
+                                            "{\"value\":\"a \\\"quoted\\\" reading\"},"
+                                            "{\"value\":\"a \\\"quoted\\\" reading\"}]");
+  assert_true(
+      az_span_is_content_equal(az_json_writer_get_bytes_used_in_destination(&writer), expected));
+  assert_int_equal(writer._internal.total_bytes_written, az_span_size(expected));
+
+  // Rolling back to before the end of a container opens it again.
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("a")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_int32(&writer, 1));
+  az_json_writer_checkpoint const checkpoint = az_json_writer_get_checkpoint(&writer);
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_rollback(&writer, &checkpoint));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("b")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_STR("{\"a\":1,\"b\":[]}")));
+
+  // The text handed to a sink can't be rolled back.
+  uint8_t json[200] = { 0 };
+  uint8_t working_buffer[64] = { 0 };
+  _az_test_json_sink sink = { .remaining = AZ_SPAN_FROM_BUFFER(json), .fail_after = INT32_MAX };
+  TEST_EXPECT_SUCCESS(az_json_writer_sink_init(
+      &writer, AZ_SPAN_FROM_BUFFER(working_buffer), _az_test_json_sink_callback, &sink, NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+  az_json_writer_checkpoint const sink_checkpoint = az_json_writer_get_checkpoint(&writer);
+  TEST_EXPECT_SUCCESS(az_json_writer_append_string(&writer, AZ_SPAN_FROM_STR("short")));
+  TEST_EXPECT_SUCCESS(az_json_writer_rollback(&writer, &sink_checkpoint));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_string(&writer, expected));
+  assert_int_equal(az_json_writer_rollback(&writer, &sink_checkpoint), AZ_ERROR_NOT_SUPPORTED);
+}
+
+static void test_json_writer_append_arrays(void** state)
+{
+  (void)state;
+
+  {
+    int32_t const int32_values[] = { 0, -1, INT32_MIN, INT32_MAX };
+    int64_t const int64_values[] = { INT64_MIN, 5 };
+    double const double_values[] = { 1.5, -0.25, 3.14159 };
+    bool const bool_values[] = { true, false };
+
+    uint8_t array[200] = { 0 };
+    az_json_writer writer = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("i")));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_int32_array(&writer, int32_values, 4));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("l")));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_int64_array(&writer, int64_values, 2));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("d")));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_double_array(&writer, double_values, 3, 2));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("b")));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_bool_array(&writer, bool_values, 2));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_int32_array(&writer, NULL, 0));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+
+    az_span const expected = AZ_SPAN_FROM_STR(
+        "{\"i\":[0,-1,-2147483648,2147483647],\"l\":[-9223372036854775808,5],"
+        "\"d\":[1.5,-0.25,3.14],\"b\":[[true,false],[]]}");
+    assert_true(
+        az_span_is_content_equal(az_json_writer_get_bytes_used_in_destination(&writer), expected));
+    assert_int_equal(writer._internal.total_bytes_written, az_span_size(expected));
+
+    // The space for the largest value is needed, even when the actual values are shorter.
+    uint8_t small_array[12] = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(small_array), NULL));
+    assert_int_equal(
+        az_json_writer_append_int32_array(&writer, int32_values, 1), AZ_ERROR_NOT_ENOUGH_SPACE);
+  }
+
+  // The values are split across the buffers of a chunked writer, only between values.
+  {
+    int32_t values[200] = { 0 };
+    for (int32_t i = 0; i < 200; i++)
+    {
+      values[i] = 1000000 + i;
+    }
+
+    uint8_t expected_array[1700] = { 0 };
+    az_json_writer writer = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(expected_array), NULL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+    for (int32_t i = 0; i < 200; i++)
+    {
+      TEST_EXPECT_SUCCESS(az_json_writer_append_int32(&writer, values[i]));
+    }
+    TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+    az_span const expected = az_json_writer_get_bytes_used_in_destination(&writer);
+
+    az_span_allocator_fn allocator = &test_allocator_chunked;
+    int32_t previous = 0;
+    _az_user_context user_context = { .current_index = &previous };
+    TEST_EXPECT_SUCCESS(
+        az_json_writer_chunked_init(&writer, AZ_SPAN_EMPTY, allocator, (void*)&user_context, NULL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_int32_array(&writer, values, 200));
+    assert_int_equal(writer._internal.total_bytes_written, az_span_size(expected));
+
+    uint8_t written[1700] = { 0 };
+    az_span remaining = AZ_SPAN_FROM_BUFFER(written);
+    for (int32_t i = 0; i < previous - 1; i++)
+    {
+      remaining = az_span_copy(remaining, json_buffers[i]);
+    }
+    remaining = az_span_copy(remaining, az_json_writer_get_bytes_used_in_destination(&writer));
+    assert_true(az_span_is_content_equal(
+        az_span_slice(AZ_SPAN_FROM_BUFFER(written), 0, 1700 - az_span_size(remaining)),
+        expected));
+  }
+}
+
+static void test_json_template(void** state)
+{
+  (void)state;
+
+  int32_t slot_offsets[4] = { 0 };
+  az_json_template json_template = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_template_init(&json_template, slot_offsets, 4));
+
+  uint8_t template_array[100] = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(template_array), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("id")));
+  TEST_EXPECT_SUCCESS(az_json_template_append_slot(&json_template, &writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("samples")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_template_append_slot(&json_template, &writer));
+  TEST_EXPECT_SUCCESS(az_json_template_append_slot(&json_template, &writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("on")));
+  TEST_EXPECT_SUCCESS(az_json_template_append_slot(&json_template, &writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+  TEST_EXPECT_SUCCESS(az_json_template_end(&json_template, &writer));
+
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_STR("{\"id\":,\"samples\":[,],\"on\":}")));
+
+  // There is no room for more slots than the template has offsets.
+  {
+    int32_t small_slot_offsets[1] = { 0 };
+    az_json_template small_template = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_template_init(&small_template, small_slot_offsets, 1));
+    az_json_writer small_writer = { 0 };
+    uint8_t small_array[10] = { 0 };
+    TEST_EXPECT_SUCCESS(
+        az_json_writer_init(&small_writer, AZ_SPAN_FROM_BUFFER(small_array), NULL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&small_writer));
+    TEST_EXPECT_SUCCESS(az_json_template_append_slot(&small_template, &small_writer));
+    assert_int_equal(
+        az_json_template_append_slot(&small_template, &small_writer), AZ_ERROR_NOT_ENOUGH_SPACE);
+  }
+
+  uint8_t array[100] = { 0 };
+  for (int32_t i = 0; i < 2; i++)
+  {
+    az_json_template_writer template_writer = { 0 };
+    TEST_EXPECT_SUCCESS(
+        az_json_template_writer_init(&template_writer, &json_template, AZ_SPAN_FROM_BUFFER(array)));
+    TEST_EXPECT_SUCCESS(az_json_template_writer_append_string(
+        &template_writer, i == 0 ? AZ_SPAN_FROM_STR("dev\"1") : AZ_SPAN_FROM_STR("dev2")));
+    TEST_EXPECT_SUCCESS(az_json_template_writer_append_int32(&template_writer, -42 * i));
+    TEST_EXPECT_SUCCESS(az_json_template_writer_append_double(&template_writer, 1.25 + i, 2));
+    TEST_EXPECT_SUCCESS(az_json_template_writer_append_bool(&template_writer, i == 0));
+
+    az_span json = AZ_SPAN_EMPTY;
+    TEST_EXPECT_SUCCESS(az_json_template_writer_end(&template_writer, &json));
+    assert_true(az_span_is_content_equal(
+        json,
+        i == 0 ? AZ_SPAN_FROM_STR("{\"id\":\"dev\\\"1\",\"samples\":[0,1.25],\"on\":true}")
+               : AZ_SPAN_FROM_STR("{\"id\":\"dev2\",\"samples\":[-42,2.25],\"on\":false}")));
+  }
+
+  // The message doesn't fit, wherever the destination runs out.
+  for (int32_t size = 0; size < 40; size++)
+  {
+    az_json_template_writer template_writer = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_template_writer_init(
+        &template_writer, &json_template, az_span_create(array, size)));
+
+    az_span json = AZ_SPAN_EMPTY;
+    az_result result
+        = az_json_template_writer_append_string(&template_writer, AZ_SPAN_FROM_STR("d"));
+    if (az_result_succeeded(result))
+    {
+      result = az_json_template_writer_append_int32(&template_writer, 1234);
+    }
+    if (az_result_succeeded(result))
+    {
+      result = az_json_template_writer_append_double(&template_writer, 0.5, 1);
+    }
+    if (az_result_succeeded(result))
+    {
+      result = az_json_template_writer_append_bool(&template_writer, false);
+    }
+    if (az_result_succeeded(result))
+    {
+      result = az_json_template_writer_end(&template_writer, &json);
+    }
+
+    // {"id":"d","samples":[1234,0.5],"on":false} is 40 bytes long.
+    assert_int_equal(result, AZ_ERROR_NOT_ENOUGH_SPACE);
+  }
+}
+
 /** Json reader **/
 az_result read_write(az_span input, az_span* output, int32_t* o);
 az_result read_write_token(
@@ -2617,6 +3238,125 @@ static void test_az_json_token_literal(void** state)
   _az_json_token_literal_helper(AZ_SPAN_FROM_STR("null"), false);
 }
 
+static void test_az_json_token_find_property_name(void** state)
+{
+  (void)state;
+
+  az_span const names[] = {
+    AZ_SPAN_LITERAL_FROM_STR("__t"),
+    AZ_SPAN_LITERAL_FROM_STR("$version"),
+    AZ_SPAN_LITERAL_FROM_STR("targetTemperature"),
+    AZ_SPAN_LITERAL_FROM_STR("a\"b"),
+  };
+  uint32_t hashes[4] = { 0 };
+  az_json_property_name_table table = { 0 };
+  az_json_property_name_table_init(&table, names, hashes, 4);
+  assert_int_equal(hashes[1], az_json_property_name_hash(AZ_SPAN_FROM_STR("$version")));
+  assert_int_not_equal(hashes[0], hashes[1]);
+
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(
+      &reader,
+      AZ_SPAN_FROM_STR("{\"$version\":\"__t\",\"other\":1,\"a\\\"b\":2,\"targetTemperature\":3}"),
+      NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+
+  uint32_t hash = 0;
+  assert_int_equal(
+      az_json_token_get_property_name_hash(&reader.token, &hash), AZ_ERROR_JSON_INVALID_STATE);
+  assert_int_equal(az_json_token_find_property_name(&reader.token, &table), -1);
+
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_token_get_property_name_hash(&reader.token, &hash));
+  assert_int_equal(hash, hashes[1]);
+  assert_int_equal(az_json_token_find_property_name(&reader.token, &table), 1);
+
+  // String values are compared against every name.
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(az_json_token_find_property_name(&reader.token, &table), 0);
+
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(az_json_token_find_property_name(&reader.token, &table), -1);
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+
+  // Property names with escaped characters don't have a recorded hash.
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(
+      az_json_token_get_property_name_hash(&reader.token, &hash), AZ_ERROR_NOT_SUPPORTED);
+  assert_int_equal(az_json_token_find_property_name(&reader.token, &table), 3);
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(az_json_token_find_property_name(&reader.token, &table), 2);
+
+  // Neither do property names straddling non-contiguous buffers.
+  az_span buffers[2] = { AZ_SPAN_FROM_STR("{\"$ver"), AZ_SPAN_FROM_STR("sion\":1}") };
+  TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(
+      az_json_token_get_property_name_hash(&reader.token, &hash), AZ_ERROR_NOT_SUPPORTED);
+  assert_int_equal(az_json_token_find_property_name(&reader.token, &table), 1);
+
+  az_json_property_name_table empty_table = { 0 };
+  az_json_property_name_table_init(&empty_table, NULL, NULL, 0);
+  assert_int_equal(az_json_token_find_property_name(&reader.token, &empty_table), -1);
+}
+
+static void test_az_json_token_unescape_in_place(void** state)
+{
+  (void)state;
+
+  char json[] = "{\"plain\":\"abc\",\"a\\\"b\":"
+                "\"\\\\c\\/d\\n\\u00e9\\u20AC\\ud83d\\ude00x\\ud800y\"}";
+
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, az_span_create_from_str(json), NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+
+  az_span string = AZ_SPAN_EMPTY;
+  assert_int_equal(
+      az_json_token_get_string_slice(&reader.token, &string), AZ_ERROR_JSON_INVALID_STATE);
+  assert_int_equal(
+      az_json_token_unescape_in_place(&reader.token, &string), AZ_ERROR_JSON_INVALID_STATE);
+
+  // Strings without escaped characters are returned as they are, in both cases.
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_token_get_string_slice(&reader.token, &string));
+  assert_ptr_equal(az_span_ptr(string), az_span_ptr(reader.token.slice));
+  assert_true(az_span_is_content_equal(string, AZ_SPAN_FROM_STR("plain")));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_token_unescape_in_place(&reader.token, &string));
+  assert_true(az_span_is_content_equal(string, AZ_SPAN_FROM_STR("abc")));
+
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(
+      az_json_token_get_string_slice(&reader.token, &string), AZ_ERROR_NOT_SUPPORTED);
+  TEST_EXPECT_SUCCESS(az_json_token_unescape_in_place(&reader.token, &string));
+  assert_true(az_span_is_content_equal(string, AZ_SPAN_FROM_STR("a\"b")));
+
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_token_unescape_in_place(&reader.token, &string));
+  assert_ptr_equal(az_span_ptr(string), az_span_ptr(reader.token.slice));
+  assert_true(az_span_is_content_equal(
+      string,
+      AZ_SPAN_FROM_STR("\\c/d\n\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80x\xED\xA0\x80y")));
+
+  // The reader carries on after the unescaped token.
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+
+  // Tokens straddling non-contiguous buffers aren't supported.
+  char first[] = "[\"a\\n";
+  char second[] = "b\"]";
+  az_span buffers[2] = { az_span_create_from_str(first), az_span_create_from_str(second) };
+  TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(
+      az_json_token_unescape_in_place(&reader.token, &string), AZ_ERROR_NOT_SUPPORTED);
+}
+
 static void test_az_json_token_copy(void** state)
 {
   (void)state;
@@ -2822,6 +3562,915 @@ static void test_az_json_reader_chunked(void** state)
   assert_true(az_span_is_content_equal(expected, az_span_create_from_str(m.name_string)));
 }
 
+#define _az_LONG_STRING_TEST_LENGTH 100
+
+// Builds a JSON string, of _az_LONG_STRING_TEST_LENGTH bytes between the quotes, consisting of
+// plain (ASCII as well as non-ASCII) bytes, with an optional special sequence at special_index.
+static az_span _az_create_long_string_json(uint8_t* buffer, int32_t special_index, char special)
+{
+  buffer[0] = '"';
+  for (int32_t i = 0; i < _az_LONG_STRING_TEST_LENGTH; i++)
+  {
+    uint8_t b = (uint8_t)(0x20 + (i * 37) % 0xE0);
+    buffer[i + 1] = (b == '"' || b == '\\') ? (uint8_t)'x' : b;
+  }
+  buffer[_az_LONG_STRING_TEST_LENGTH + 1] = '"';
+
+  if (special == '\\')
+  {
+    buffer[special_index + 1] = '\\';
+    buffer[special_index + 2] = 'n';
+  }
+  else if (special != 0)
+  {
+    buffer[special_index + 1] = (uint8_t)special;
+  }
+
+  return az_span_create(buffer, _az_LONG_STRING_TEST_LENGTH + 2);
+}
+
+static void _az_split_buffers_by_size(az_span input, int32_t chunk_size, az_span* output)
+{
+  for (int32_t i = 0; i < az_span_size(input); i += chunk_size)
+  {
+    int32_t end = i + chunk_size < az_span_size(input) ? i + chunk_size : az_span_size(input);
+    output[i / chunk_size] = az_span_slice(input, i, end);
+  }
+}
+
+static void _az_test_long_string_token(az_span json, bool expected_escaped, az_result expected)
+{
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  assert_int_equal(az_json_reader_next_token(&reader), expected);
+  if (expected == AZ_OK)
+  {
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_STRING);
+    assert_int_equal(reader.token.size, _az_LONG_STRING_TEST_LENGTH);
+    assert_true(az_span_is_content_equal(
+        reader.token.slice, az_span_slice(json, 1, _az_LONG_STRING_TEST_LENGTH + 1)));
+    assert_true(reader.token._internal.string_has_escaped_chars == expected_escaped);
+  }
+
+  // Chunk sizes that don't line up with the 16 and 32 byte blocks scanned at once.
+  int32_t const chunk_sizes[] = { 1, 3, 16, 17, 33 };
+  for (size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); c++)
+  {
+    az_span buffers[_az_LONG_STRING_TEST_LENGTH + 2] = { 0 };
+    int32_t const chunk_size = chunk_sizes[c];
+    int32_t const chunk_count = (az_span_size(json) + chunk_size - 1) / chunk_size;
+    _az_split_buffers_by_size(json, chunk_size, buffers);
+
+    TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, chunk_count, NULL));
+    assert_int_equal(az_json_reader_next_token(&reader), expected);
+    if (expected == AZ_OK)
+    {
+      assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_STRING);
+      assert_int_equal(reader.token.size, _az_LONG_STRING_TEST_LENGTH);
+      assert_true(reader.token._internal.string_has_escaped_chars == expected_escaped);
+    }
+  }
+}
+
+static void test_az_json_reader_long_string(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[_az_LONG_STRING_TEST_LENGTH + 2] = { 0 };
+
+  _az_test_long_string_token(_az_create_long_string_json(buffer, 0, 0), false, AZ_OK);
+
+  for (int32_t i = 0; i < _az_LONG_STRING_TEST_LENGTH; i++)
+  {
+    if (i < _az_LONG_STRING_TEST_LENGTH - 1)
+    {
+      _az_test_long_string_token(_az_create_long_string_json(buffer, i, '\\'), true, AZ_OK);
+    }
+
+    _az_test_long_string_token(
+        _az_create_long_string_json(buffer, i, '\n'), false, AZ_ERROR_UNEXPECTED_CHAR);
+    _az_test_long_string_token(
+        _az_create_long_string_json(buffer, i, 0x1F), false, AZ_ERROR_UNEXPECTED_CHAR);
+  }
+}
+
+// Checks that the integer getters return the same result for a number token, whether or not the
+// reader recorded its value, as parsing the JSON text of the number again.
+static void _az_test_json_number_token_getters(az_json_token const* token, az_span number)
+{
+  uint64_t expected_u64 = 0;
+  uint64_t u64 = 0;
+  uint32_t expected_u32 = 0;
+  uint32_t u32 = 0;
+  int64_t expected_i64 = 0;
+  int64_t i64 = 0;
+  int32_t expected_i32 = 0;
+  int32_t i32 = 0;
+
+  az_result const expected_u64_result = az_span_atou64(number, &expected_u64);
+  assert_int_equal(az_json_token_get_uint64(token, &u64), expected_u64_result);
+  assert_true(az_result_failed(expected_u64_result) || u64 == expected_u64);
+
+  az_result const expected_u32_result = az_span_atou32(number, &expected_u32);
+  assert_int_equal(az_json_token_get_uint32(token, &u32), expected_u32_result);
+  assert_true(az_result_failed(expected_u32_result) || u32 == expected_u32);
+
+  az_result const expected_i64_result = az_span_atoi64(number, &expected_i64);
+  assert_int_equal(az_json_token_get_int64(token, &i64), expected_i64_result);
+  assert_true(az_result_failed(expected_i64_result) || i64 == expected_i64);
+
+  az_result const expected_i32_result = az_span_atoi32(number, &expected_i32);
+  assert_int_equal(az_json_token_get_int32(token, &i32), expected_i32_result);
+  assert_true(az_result_failed(expected_i32_result) || i32 == expected_i32);
+}
+
+static void test_az_json_token_get_recorded_integer(void** state)
+{
+  (void)state;
+
+  char* const numbers[] = {
+    "0",
+    "-0",
+    "7",
+    "-7",
+    "1.5",
+    "-0.0",
+    "1e3",
+    "10E-1",
+    "12345678",
+    "123456789",
+    "-1234567890123456",
+    "2147483647",
+    "2147483648",
+    "-2147483648",
+    "-2147483649",
+    "4294967295",
+    "4294967296",
+    "9223372036854775807",
+    "9223372036854775808",
+    "-9223372036854775808",
+    "-9223372036854775809",
+    "18446744073709551615",
+    "18446744073709551616",
+    "99999999999999999999",
+    "123456789012345678901234567890",
+  };
+
+  for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); i++)
+  {
+    az_span const number = az_span_create_from_str(numbers[i]);
+
+    // A single number value, as well as a number within an array.
+    uint8_t buffer[64] = { 0 };
+    az_span remainder = az_span_copy_u8(AZ_SPAN_FROM_BUFFER(buffer), '[');
+    remainder = az_span_copy(remainder, number);
+    remainder = az_span_copy_u8(remainder, ']');
+    (void)remainder;
+    az_span const array_json
+        = az_span_slice(AZ_SPAN_FROM_BUFFER(buffer), 0, 2 + az_span_size(number));
+
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, number, NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    _az_test_json_number_token_getters(&reader.token, number);
+
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, array_json, NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    _az_test_json_number_token_getters(&reader.token, number);
+
+    // The same number, straddling single byte buffers.
+    az_span buffers[64] = { 0 };
+    _az_split_buffers_single_byte(array_json, buffers);
+    TEST_EXPECT_SUCCESS(
+        az_json_reader_chunked_init(&reader, buffers, az_span_size(array_json), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    _az_test_json_number_token_getters(&reader.token, number);
+
+    // Without the value recorded by the reader, the number is parsed from each of the buffers.
+    reader.token._internal.number_is_integer = false;
+    _az_test_json_number_token_getters(&reader.token, number);
+  }
+
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("[-123456789012,1.5]"), NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_true(reader.token._internal.number_is_integer);
+  assert_true(reader.token._internal.number_is_negative);
+  assert_true(reader.token._internal.number_magnitude == 123456789012);
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_false(reader.token._internal.number_is_integer);
+
+  // A number token that wasn't produced by the reader is still parsed from its slice.
+  az_json_token token = { 0 };
+  token.kind = AZ_JSON_TOKEN_NUMBER;
+  token.slice = AZ_SPAN_FROM_STR("-42");
+  token.size = 3;
+  _az_test_json_number_token_getters(&token, token.slice);
+}
+
+// Builds JSON nested `depth` levels deep, mixing objects and arrays so that the reader and writer
+// must track each level.
+static az_span _az_test_build_nested_json(az_span buffer, int32_t depth)
+{
+  az_span remaining = buffer;
+  for (int32_t i = 0; i < depth; i++)
+  {
+    remaining = i % 3 == 0 ? az_span_copy(remaining, AZ_SPAN_FROM_STR("{\"a\":"))
+                           : az_span_copy_u8(remaining, '[');
+  }
+  remaining = az_span_copy_u8(remaining, '0');
+  for (int32_t i = depth - 1; i >= 0; i--)
+  {
+    remaining = az_span_copy_u8(remaining, i % 3 == 0 ? '}' : ']');
+  }
+  return az_span_slice(buffer, 0, _az_span_diff(remaining, buffer));
+}
+
+static az_result _az_test_read_all_tokens(az_span json, az_json_reader_options const* options)
+{
+  az_json_reader reader = { 0 };
+  _az_RETURN_IF_FAILED(az_json_reader_init(&reader, json, options));
+
+  az_result result;
+  while (az_result_succeeded(result = az_json_reader_next_token(&reader)))
+  {
+  }
+  return result == AZ_ERROR_JSON_READER_DONE ? AZ_OK : result;
+}
+
+static void test_json_nesting_stack_extension(void** state)
+{
+  (void)state;
+
+  uint8_t json_buffer[1200] = { 0 };
+  uint64_t extension[3] = { 0 };
+
+  // Without an extension, the depth stays limited to 64.
+  az_span json = _az_test_build_nested_json(AZ_SPAN_FROM_BUFFER(json_buffer), 64);
+  assert_int_equal(_az_test_read_all_tokens(json, NULL), AZ_OK);
+  json = _az_test_build_nested_json(AZ_SPAN_FROM_BUFFER(json_buffer), 65);
+  assert_int_equal(_az_test_read_all_tokens(json, NULL), AZ_ERROR_JSON_NESTING_OVERFLOW);
+
+  // Each word of the extension adds 64 levels.
+  az_json_reader_options reader_options = az_json_reader_options_default();
+  reader_options.nesting_stack_extension = extension;
+  reader_options.nesting_stack_extension_size = 2;
+  json = _az_test_build_nested_json(AZ_SPAN_FROM_BUFFER(json_buffer), 192);
+  assert_int_equal(_az_test_read_all_tokens(json, &reader_options), AZ_OK);
+  json = _az_test_build_nested_json(AZ_SPAN_FROM_BUFFER(json_buffer), 193);
+  assert_int_equal(
+      _az_test_read_all_tokens(json, &reader_options), AZ_ERROR_JSON_NESTING_OVERFLOW);
+
+  reader_options.nesting_stack_extension_size = 3;
+  assert_int_equal(_az_test_read_all_tokens(json, &reader_options), AZ_OK);
+
+  // The reader tells the outer containers apart once coming back from the deepest levels.
+  uint8_t mismatched_buffer[1200] = { 0 };
+  az_span mismatched = AZ_SPAN_FROM_BUFFER(mismatched_buffer);
+  az_span_copy(mismatched, json);
+  mismatched = az_span_slice(mismatched, 0, az_span_size(json));
+  az_span_ptr(mismatched)[az_span_size(mismatched) - 1] = ']';
+  assert_int_equal(
+      _az_test_read_all_tokens(mismatched, &reader_options), AZ_ERROR_UNEXPECTED_CHAR);
+
+  // The writer goes as deep, and writes the same JSON back.
+  uint8_t written_buffer[1200] = { 0 };
+  az_json_writer_options writer_options = az_json_writer_options_default();
+  writer_options.nesting_stack_extension = extension;
+  writer_options.nesting_stack_extension_size = 3;
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(written_buffer), &writer_options));
+
+  int32_t const depth = 193;
+  for (int32_t i = 0; i < depth; i++)
+  {
+    if (i % 3 == 0)
+    {
+      TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+      TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("a")));
+    }
+    else
+    {
+      TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+    }
+  }
+  TEST_EXPECT_SUCCESS(az_json_writer_append_int32(&writer, 0));
+  for (int32_t i = depth - 1; i >= 0; i--)
+  {
+    TEST_EXPECT_SUCCESS(
+        i % 3 == 0 ? az_json_writer_append_end_object(&writer)
+                   : az_json_writer_append_end_array(&writer));
+  }
+  assert_true(
+      az_span_is_content_equal(az_json_writer_get_bytes_used_in_destination(&writer), json));
+
+  // Without an extension, the writer refuses to go deeper than 64 levels.
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(written_buffer), NULL));
+  for (int32_t i = 0; i < 64; i++)
+  {
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+  }
+  assert_int_equal(az_json_writer_append_begin_array(&writer), AZ_ERROR_JSON_NESTING_OVERFLOW);
+}
+
+typedef struct
+{
+  int32_t path_indexes[8];
+  int64_t values[8];
+  int32_t count;
+} _az_test_selected_values;
+
+static az_result _az_test_select_handler(
+    az_json_reader* ref_json_reader,
+    int32_t path_index,
+    void* user_context)
+{
+  _az_test_selected_values* const selected = (_az_test_selected_values*)user_context;
+  int64_t value = -1;
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_NUMBER)
+  {
+    _az_RETURN_IF_FAILED(az_json_token_get_int64(&ref_json_reader->token, &value));
+  }
+  else if (ref_json_reader->token.kind == AZ_JSON_TOKEN_BEGIN_ARRAY)
+  {
+    // Read the whole array, leaving the reader on its end.
+    value = 0;
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+    while (ref_json_reader->token.kind != AZ_JSON_TOKEN_END_ARRAY)
+    {
+      value++;
+      _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+    }
+  }
+
+  selected->path_indexes[selected->count] = path_index;
+  selected->values[selected->count] = value;
+  selected->count++;
+  return AZ_OK;
+}
+
+static az_result _az_test_failing_select_handler(
+    az_json_reader* ref_json_reader,
+    int32_t path_index,
+    void* user_context)
+{
+  (void)ref_json_reader;
+  (void)path_index;
+  (void)user_context;
+  return AZ_ERROR_CANCELED;
+}
+
+static void test_json_reader_select(void** state)
+{
+  (void)state;
+
+  az_json_path paths[5];
+  TEST_EXPECT_SUCCESS(
+      az_json_path_init(&paths[0], AZ_SPAN_FROM_STR("desired.targetTemperature")));
+  TEST_EXPECT_SUCCESS(az_json_path_init(&paths[1], AZ_SPAN_FROM_STR("$version")));
+  TEST_EXPECT_SUCCESS(az_json_path_init(&paths[2], AZ_SPAN_FROM_STR("desired.thermostat.level")));
+  TEST_EXPECT_SUCCESS(az_json_path_init(&paths[3], AZ_SPAN_FROM_STR("reported.history")));
+  TEST_EXPECT_SUCCESS(az_json_path_init(&paths[4], AZ_SPAN_FROM_STR("reported.a/b")));
+
+  az_span const json = AZ_SPAN_FROM_STR(
+      "{\"desired\":{\"targetTemperature\":21,\"other\":{\"targetTemperature\":99},"
+      "\"thermostat\":{\"level\":3,\"mode\":[1,{\"level\":98}]},\"missing\":{}},\"level\":97,"
+      "\"reported\":{\"history\":[4,5,6],\"next\":7,\"a\\/b\":8},\"$version\":42}");
+
+  az_json_reader reader = { 0 };
+  _az_test_selected_values selected = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  TEST_EXPECT_SUCCESS(
+      az_json_reader_select(&reader, paths, 5, _az_test_select_handler, &selected));
+
+  // The values are found in document order, including through escaped property names.
+  assert_int_equal(selected.count, 5);
+  assert_int_equal(selected.path_indexes[0], 0);
+  assert_int_equal(selected.values[0], 21);
+  assert_int_equal(selected.path_indexes[1], 2);
+  assert_int_equal(selected.values[1], 3);
+  assert_int_equal(selected.path_indexes[2], 3);
+  assert_int_equal(selected.values[2], 3);
+  assert_int_equal(selected.path_indexes[3], 4);
+  assert_int_equal(selected.values[3], 8);
+  assert_int_equal(selected.path_indexes[4], 1);
+  assert_int_equal(selected.values[4], 42);
+
+  // The whole object was read.
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+
+  // A path that is a prefix of another hides it, and the unread part of the value is skipped.
+  az_json_path prefix_paths[2];
+  TEST_EXPECT_SUCCESS(
+      az_json_path_init(&prefix_paths[0], AZ_SPAN_FROM_STR("desired.thermostat.level")));
+  TEST_EXPECT_SUCCESS(az_json_path_init(&prefix_paths[1], AZ_SPAN_FROM_STR("desired")));
+  selected = (_az_test_selected_values){ 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  TEST_EXPECT_SUCCESS(
+      az_json_reader_select(&reader, prefix_paths, 2, _az_test_select_handler, &selected));
+  assert_int_equal(selected.count, 1);
+  assert_int_equal(selected.path_indexes[0], 1);
+  assert_int_equal(selected.values[0], -1);
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+
+  // Values that aren't objects have nothing to select.
+  selected = (_az_test_selected_values){ 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("[{\"$version\":1}]"), NULL));
+  TEST_EXPECT_SUCCESS(
+      az_json_reader_select(&reader, paths, 5, _az_test_select_handler, &selected));
+  assert_int_equal(selected.count, 0);
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_ARRAY);
+
+  // Errors of the reader and of the handler stop the selection.
+  TEST_EXPECT_SUCCESS(
+      az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"desired\":{\"x\":1"), NULL));
+  assert_int_equal(
+      az_json_reader_select(&reader, paths, 5, _az_test_select_handler, &selected),
+      AZ_ERROR_UNEXPECTED_END);
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  assert_int_equal(
+      az_json_reader_select(&reader, paths, 5, _az_test_failing_select_handler, NULL),
+      AZ_ERROR_CANCELED);
+
+  // Invalid paths.
+  az_json_path path;
+  assert_int_equal(az_json_path_init(&path, AZ_SPAN_EMPTY), AZ_ERROR_ARG);
+  assert_int_equal(az_json_path_init(&path, AZ_SPAN_FROM_STR("a..b")), AZ_ERROR_ARG);
+  assert_int_equal(az_json_path_init(&path, AZ_SPAN_FROM_STR("a.")), AZ_ERROR_ARG);
+  assert_int_equal(az_json_path_init(&path, AZ_SPAN_FROM_STR("a.b.c.d.e.f.g.h.i")), AZ_ERROR_ARG);
+  TEST_EXPECT_SUCCESS(az_json_path_init(&path, AZ_SPAN_FROM_STR("a.b.c.d.e.f.g.h")));
+}
+
+// Doubles the number values found, and replaces the other ones with null.
+static az_result _az_test_transcode_handler(
+    az_json_reader* ref_json_reader,
+    az_json_writer* ref_json_writer,
+    int32_t path_index,
+    void* user_context)
+{
+  int32_t* const count = (int32_t*)user_context;
+  (*count)++;
+  (void)path_index;
+
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_NUMBER)
+  {
+    int32_t value = 0;
+    _az_RETURN_IF_FAILED(az_json_token_get_int32(&ref_json_reader->token, &value));
+    return az_json_writer_append_int32(ref_json_writer, value * 2);
+  }
+
+  return az_json_writer_append_null(ref_json_writer);
+}
+
+static void test_json_transcode(void** state)
+{
+  (void)state;
+
+  az_json_path paths[3];
+  TEST_EXPECT_SUCCESS(az_json_path_init(&paths[0], AZ_SPAN_FROM_STR("desired.targetTemperature")));
+  TEST_EXPECT_SUCCESS(az_json_path_init(&paths[1], AZ_SPAN_FROM_STR("$version")));
+  TEST_EXPECT_SUCCESS(az_json_path_init(&paths[2], AZ_SPAN_FROM_STR("desired.thermostat")));
+
+  // The members that no path goes through are copied as is, whitespace included.
+  az_span const json = AZ_SPAN_FROM_STR(
+      "{ \"id\" : \"a\\/b\", \"desired\":{\"targetTemperature\":21,\"other\":[1, {\"x\":2}],"
+      "\"thermostat\":{\"level\":3}},\"$version\":42,\"tail\":true }");
+
+  uint8_t buffer[256];
+  az_json_writer writer = { 0 };
+  az_json_reader reader = { 0 };
+  int32_t count = 0;
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer), NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  TEST_EXPECT_SUCCESS(
+      az_json_transcode(&reader, &writer, paths, 3, _az_test_transcode_handler, &count));
+  assert_int_equal(count, 3);
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+
+  // Properties can be appended before the end of the object.
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("gateway")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_int32(&writer, 1));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+
+  char actual[256];
+  az_span_to_str(actual, sizeof(actual), az_json_writer_get_bytes_used_in_destination(&writer));
+  assert_string_equal(
+      actual,
+      "{\"id\" : \"a\\/b\",\"desired\":{\"targetTemperature\":42,\"other\":[1, {\"x\":2}],"
+      "\"thermostat\":null},\"$version\":84,\"tail\":true,\"gateway\":1}");
+
+  // Without any path, the members are copied in a single run, into a chunked writer too.
+  int32_t chunk_index = 0;
+  _az_user_context user_context = { .current_index = &chunk_index };
+  TEST_EXPECT_SUCCESS(az_json_writer_chunked_init(
+      &writer, AZ_SPAN_EMPTY, test_allocator_chunked, &user_context, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  TEST_EXPECT_SUCCESS(
+      az_json_transcode(&reader, &writer, NULL, 0, _az_test_transcode_handler, &count));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+  assert_int_equal(count, 3);
+  assert_int_equal(writer._internal.total_bytes_written, az_span_size(json) - 2);
+
+  // The value read must be an object, and errors stop the transcoding.
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer), NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("[1]"), NULL));
+  assert_int_equal(
+      az_json_transcode(&reader, &writer, paths, 3, _az_test_transcode_handler, &count),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer), NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"a\":[1,"), NULL));
+  assert_int_equal(
+      az_json_transcode(&reader, &writer, paths, 3, _az_test_transcode_handler, &count),
+      AZ_ERROR_UNEXPECTED_END);
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, az_span_create(buffer, 64), NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  assert_int_equal(
+      az_json_transcode(&reader, &writer, paths, 3, _az_test_transcode_handler, &count),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+// Skips the value of the "skip" property, expecting to then read the "after" property.
+static void _az_test_skip_value(az_json_reader* reader, az_json_token_kind expected_end_kind)
+{
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(reader));
+  assert_int_equal(reader->token.kind, AZ_JSON_TOKEN_BEGIN_OBJECT);
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(reader));
+  assert_true(az_json_token_is_text_equal(&reader->token, AZ_SPAN_FROM_STR("skip")));
+
+  TEST_EXPECT_SUCCESS(az_json_reader_skip_children(reader));
+  assert_int_equal(reader->token.kind, expected_end_kind);
+  assert_int_equal(reader->_internal.bit_stack._internal.current_depth, 1);
+
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(reader));
+  assert_true(az_json_token_is_text_equal(&reader->token, AZ_SPAN_FROM_STR("after")));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(reader));
+  assert_int_equal(reader->token.kind, AZ_JSON_TOKEN_NUMBER);
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(reader));
+  assert_int_equal(reader->token.kind, AZ_JSON_TOKEN_END_OBJECT);
+  assert_int_equal(az_json_reader_next_token(reader), AZ_ERROR_JSON_READER_DONE);
+}
+
+static void test_json_skip_children_without_validation(void** state)
+{
+  (void)state;
+
+  az_json_reader_options options = az_json_reader_options_default();
+  options.skip_children_without_validation = true;
+
+  az_span const valid_json[] = {
+    AZ_SPAN_LITERAL_FROM_STR("{\"skip\":{},\"after\":1}"),
+    AZ_SPAN_LITERAL_FROM_STR("{\"skip\":[[],[[{}]],{\"a\":[1,2]}] ,\"after\":1}"),
+    AZ_SPAN_LITERAL_FROM_STR(
+        "{\"skip\":{\"brackets in strings\":\"}]}]\",\"quotes\":\"\\\"}\\\\\",\"x\":\"\\\\\"},"
+        "\"after\":1}"),
+    AZ_SPAN_LITERAL_FROM_STR(
+        "{\"skip\":{\"reported\":{\"temperature\":{\"value\":21.5,\"unit\":\"celsius\"},"
+        "\"history\":[[1,2,3],[4,5,6],[7,8,9]],\"text\":\"a string longer than a single "
+        "block of bytes, with [brackets] and {braces} inside of it\",\"nested\":{\"a\":{\"b\":{"
+        "\"c\":[{\"d\":\"}\"},{\"e\":\"]\"}]}}},\"escaped\":\"\\\"{\\\"[\\\\\"}},\"after\":1}"),
+  };
+  az_json_token_kind const expected_end_kinds[] = {
+    AZ_JSON_TOKEN_END_OBJECT,
+    AZ_JSON_TOKEN_END_ARRAY,
+    AZ_JSON_TOKEN_END_OBJECT,
+    AZ_JSON_TOKEN_END_OBJECT,
+  };
+
+  for (size_t i = 0; i < sizeof(valid_json) / sizeof(valid_json[0]); i++)
+  {
+    az_span const json = valid_json[i];
+    az_json_reader reader = { 0 };
+
+    // The validating skip and the fast one must leave the reader in the same state.
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+    _az_test_skip_value(&reader, expected_end_kinds[i]);
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, &options));
+    _az_test_skip_value(&reader, expected_end_kinds[i]);
+
+    // Split the JSON at every position.
+    for (int32_t split = 1; split < az_span_size(json); split++)
+    {
+      az_span buffers[2] = { az_span_slice(json, 0, split), az_span_slice_to_end(json, split) };
+      TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, &options));
+      _az_test_skip_value(&reader, expected_end_kinds[i]);
+    }
+  }
+
+  // Invalid JSON within the skipped value goes unnoticed.
+  az_span const invalid_json = AZ_SPAN_FROM_STR("{\"skip\":[tru 1 2,,:{\"a\" 3}],\"after\":1}");
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, invalid_json, &options));
+  _az_test_skip_value(&reader, AZ_JSON_TOKEN_END_ARRAY);
+
+  // Containers that don't end are still detected.
+  TEST_EXPECT_SUCCESS(
+      az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"skip\":{\"a\":\"}]\",[{}]"), &options));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(az_json_reader_skip_children(&reader), AZ_ERROR_UNEXPECTED_END);
+}
+
+static void test_json_reader_validate_utf8(void** state)
+{
+  (void)state;
+
+  az_json_reader_options options = az_json_reader_options_default();
+  options.validate_utf8 = true;
+
+  // Sequences of 2, 3 and 4 bytes, the largest code point, and text long enough to be validated by
+  // blocks.
+  az_span const valid_json[] = {
+    AZ_SPAN_LITERAL_FROM_STR("\"caf\xC3\xA9\""),
+    AZ_SPAN_LITERAL_FROM_STR("{\"\xE2\x82\xAC\":"
+                             "\"\xF0\x9D\x84\x9E\xF4\x8F\xBF\xBF\xED\x9F\xBF\"}"),
+    AZ_SPAN_LITERAL_FROM_STR("\"Gr\xC3\xBC\xC3\x9F\x65 aus M\xC3\xBCnchen, \xE6\x9D\xB1\xE4\xBA\xAC "
+                             "\xE2\x80\x94 temp\xC3\xA9rature 21 \xC2\xB0\x43, \\\"escaped\\\" "
+                             "\xF0\x9F\x8C\xA1\xEF\xB8\x8F and plain ASCII at the end\""),
+  };
+
+  // A lone continuation byte, a truncated sequence, overlong encodings, a surrogate, a code point
+  // past U+10FFFF, and an invalid byte at the end of a long text.
+  az_span const invalid_json[] = {
+    AZ_SPAN_LITERAL_FROM_STR("\"\x80\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"caf\xC3\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"\xC0\xAF\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"\xE0\x80\xAF\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"\xED\xA0\x80\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"\xF4\x90\x80\x80\""),
+    AZ_SPAN_LITERAL_FROM_STR("{\"name\":\"Gr\xC3\xBC\xC3\x9F\x65 aus M\xC3\xBCnchen, \xE6\x9D\xB1 "
+                             "with an invalid byte \xFF\"}"),
+  };
+
+  for (size_t i = 0; i < sizeof(valid_json) / sizeof(valid_json[0]); i++)
+  {
+    az_span const json = valid_json[i];
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, &options));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_skip_children(&reader));
+
+    // Split the JSON at every position, including within the sequences.
+    for (int32_t split = 1; split < az_span_size(json); split++)
+    {
+      az_span buffers[2] = { az_span_slice(json, 0, split), az_span_slice_to_end(json, split) };
+      TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, &options));
+      TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+      TEST_EXPECT_SUCCESS(az_json_reader_skip_children(&reader));
+    }
+  }
+
+  for (size_t i = 0; i < sizeof(invalid_json) / sizeof(invalid_json[0]); i++)
+  {
+    az_span const json = invalid_json[i];
+    az_json_reader reader = { 0 };
+
+    // Without the option, any byte that isn't a control character is accepted.
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_skip_children(&reader));
+
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, &options));
+    az_result result = az_json_reader_next_token(&reader);
+    if (az_result_succeeded(result))
+    {
+      result = az_json_reader_skip_children(&reader);
+    }
+    assert_int_equal(result, AZ_ERROR_UNEXPECTED_CHAR);
+
+    for (int32_t split = 1; split < az_span_size(json); split++)
+    {
+      az_span buffers[2] = { az_span_slice(json, 0, split), az_span_slice_to_end(json, split) };
+      TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, &options));
+      result = az_json_reader_next_token(&reader);
+      if (az_result_succeeded(result))
+      {
+        result = az_json_reader_skip_children(&reader);
+      }
+      assert_int_equal(result, AZ_ERROR_UNEXPECTED_CHAR);
+    }
+  }
+}
+
+static void test_json_reader_incremental(void** state)
+{
+  (void)state;
+
+  az_span const json = AZ_SPAN_FROM_STR(
+      "{\"id\": 12345, \"name\": \"temp\\\"sensor\", \"values\": [-1.5e3, true, null, false],"
+      " \"nested\": {\"a\": [], \"b\": {}}, \"last\": 0}");
+  uint8_t buffer[128] = { 0 };
+
+  // Feed the JSON in pieces of every size, and read the same tokens as from a single buffer.
+  for (int32_t piece_size = 1; piece_size <= az_span_size(json); piece_size++)
+  {
+    az_json_reader expected_reader = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&expected_reader, json, NULL));
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(
+        az_json_reader_incremental_init(&reader, AZ_SPAN_FROM_BUFFER(buffer), NULL));
+
+    int32_t fed = 0;
+    while (true)
+    {
+      az_result const result = az_json_reader_next_token(&reader);
+      if (result == AZ_ERROR_JSON_READER_NEED_MORE_DATA)
+      {
+        assert_true(fed < az_span_size(json));
+        int32_t const end
+            = fed + piece_size < az_span_size(json) ? fed + piece_size : az_span_size(json);
+        TEST_EXPECT_SUCCESS(az_json_reader_feed(
+            &reader, az_span_slice(json, fed, end), end == az_span_size(json)));
+        fed = end;
+        continue;
+      }
+
+      assert_int_equal(result, az_json_reader_next_token(&expected_reader));
+      if (az_result_failed(result))
+      {
+        break;
+      }
+
+      assert_int_equal(reader.token.kind, expected_reader.token.kind);
+      assert_true(az_span_is_content_equal(reader.token.slice, expected_reader.token.slice));
+    }
+    assert_int_equal(
+        reader._internal.total_bytes_consumed, expected_reader._internal.total_bytes_consumed);
+  }
+
+  // A number at the end of a piece may continue in the next one.
+  {
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(
+        az_json_reader_incremental_init(&reader, AZ_SPAN_FROM_BUFFER(buffer), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("12"), false));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_NEED_MORE_DATA);
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("34"), false));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_NEED_MORE_DATA);
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_EMPTY, true));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_true(az_span_is_content_equal(reader.token.slice, AZ_SPAN_FROM_STR("1234")));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+  }
+
+  // Skipping children waits for the end of the container, and the end of the text is still an
+  // error once it is fed.
+  {
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(
+        az_json_reader_incremental_init(&reader, AZ_SPAN_FROM_BUFFER(buffer), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("[{\"a\": [1, "), false));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(az_json_reader_skip_children(&reader), AZ_ERROR_JSON_READER_NEED_MORE_DATA);
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_BEGIN_ARRAY);
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("2]}]"), false));
+    TEST_EXPECT_SUCCESS(az_json_reader_skip_children(&reader));
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_ARRAY);
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_NEED_MORE_DATA);
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_EMPTY, true));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+
+    TEST_EXPECT_SUCCESS(
+        az_json_reader_incremental_init(&reader, AZ_SPAN_FROM_BUFFER(buffer), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("{\"a\": tr"), true));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_END);
+  }
+
+  // Until the final piece is fed, text may still follow the root value, and is checked like the
+  // text of a single buffer.
+  {
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(
+        az_json_reader_incremental_init(&reader, AZ_SPAN_FROM_BUFFER(buffer), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("{}"), false));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_NEED_MORE_DATA);
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("x"), true));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_CHAR);
+
+    TEST_EXPECT_SUCCESS(
+        az_json_reader_incremental_init(&reader, AZ_SPAN_FROM_BUFFER(buffer), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("tru"), false));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_NEED_MORE_DATA);
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("e"), false));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_TRUE);
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_NEED_MORE_DATA);
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("x"), false));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_CHAR);
+  }
+
+  // The text left to read, and the piece fed, must fit in the buffer.
+  {
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(
+        az_json_reader_incremental_init(&reader, az_span_create(buffer, 9), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("[\"abcde"), false));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_NEED_MORE_DATA);
+    assert_int_equal(
+        az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("fgh\"]"), false),
+        AZ_ERROR_NOT_ENOUGH_SPACE);
+    TEST_EXPECT_SUCCESS(az_json_reader_feed(&reader, AZ_SPAN_FROM_STR("f\"]"), true));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_true(az_span_is_content_equal(reader.token.slice, AZ_SPAN_FROM_STR("abcdef")));
+  }
+}
+
+static void test_json_tape(void** state)
+{
+  (void)state;
+
+  az_span const json = AZ_SPAN_FROM_STR(
+      "{\"$version\":42,\"thermostat1\":{\"targetTemperature\":21.5,\"history\":[1,[2,3],{}]},"
+      "\"a\\/b\":\"c\\/d\",\"empty\":[],\"last\":null}");
+
+  az_json_tape_entry entries[32];
+  az_json_tape tape = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_tape_init(&tape, json, entries, 32, NULL));
+
+  // The tape has the same tokens as the reader.
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  int32_t count = 0;
+  while (az_result_succeeded(az_json_reader_next_token(&reader)))
+  {
+    az_json_token const token = az_json_tape_get_token(&tape, count);
+    assert_int_equal(token.kind, reader.token.kind);
+    assert_ptr_equal(az_span_ptr(token.slice), az_span_ptr(reader.token.slice));
+    assert_int_equal(az_span_size(token.slice), az_span_size(reader.token.slice));
+    assert_int_equal(token.size, reader.token.size);
+    assert_int_equal(
+        token._internal.string_has_escaped_chars, reader.token._internal.string_has_escaped_chars);
+    count++;
+  }
+  assert_int_equal(az_json_tape_get_count(&tape), count);
+  assert_int_equal(count, 26);
+
+  // Values are skipped over, including through the value of a property name.
+  assert_int_equal(az_json_tape_skip(&tape, 0), 26);
+  assert_int_equal(az_json_tape_skip(&tape, 1), 3);
+  assert_int_equal(az_json_tape_skip(&tape, 3), 18);
+  assert_int_equal(az_json_tape_skip(&tape, 4), 18);
+  assert_int_equal(az_json_tape_skip(&tape, 8), 17);
+  assert_int_equal(az_json_tape_skip(&tape, 10), 14);
+  assert_int_equal(az_json_tape_skip(&tape, 14), 16);
+  assert_int_equal(az_json_tape_skip(&tape, 20), 23);
+  assert_int_equal(az_json_tape_skip(&tape, 21), 23);
+
+  // Properties are found among the ones of the object itself, any number of times.
+  int32_t const version_index = az_json_tape_find_property(&tape, 0, AZ_SPAN_FROM_STR("$version"));
+  assert_int_equal(version_index, 2);
+  az_json_token token = az_json_tape_get_token(&tape, version_index);
+  int32_t version = 0;
+  TEST_EXPECT_SUCCESS(az_json_token_get_int32(&token, &version));
+  assert_int_equal(version, 42);
+
+  int32_t const component_index
+      = az_json_tape_find_property(&tape, 0, AZ_SPAN_FROM_STR("thermostat1"));
+  assert_int_equal(component_index, 4);
+  int32_t const temperature_index
+      = az_json_tape_find_property(&tape, component_index, AZ_SPAN_FROM_STR("targetTemperature"));
+  token = az_json_tape_get_token(&tape, temperature_index);
+  double temperature = 0;
+  TEST_EXPECT_SUCCESS(az_json_token_get_double(&token, &temperature));
+  assert_true(temperature == 21.5);
+
+  int32_t const escaped_index = az_json_tape_find_property(&tape, 0, AZ_SPAN_FROM_STR("a/b"));
+  assert_int_equal(escaped_index, 19);
+  token = az_json_tape_get_token(&tape, escaped_index);
+  char value[8] = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_token_get_string(&token, value, sizeof(value), NULL));
+  assert_string_equal(value, "c/d");
+
+  assert_int_equal(az_json_tape_find_property(&tape, 0, AZ_SPAN_FROM_STR("last")), 24);
+  assert_int_equal(az_json_tape_find_property(&tape, 0, AZ_SPAN_FROM_STR("targetTemperature")), -1);
+  assert_int_equal(az_json_tape_find_property(&tape, 14, AZ_SPAN_FROM_STR("a")), -1);
+
+  // A single value has a single entry.
+  TEST_EXPECT_SUCCESS(az_json_tape_init(&tape, AZ_SPAN_FROM_STR(" \"a\" "), entries, 1, NULL));
+  assert_int_equal(az_json_tape_get_count(&tape), 1);
+  assert_int_equal(az_json_tape_skip(&tape, 0), 1);
+
+  // Errors.
+  assert_int_equal(az_json_tape_init(&tape, json, entries, 25, NULL), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_json_tape_init(&tape, AZ_SPAN_FROM_STR("{\"a\":[1,2"), entries, 32, NULL),
+      AZ_ERROR_UNEXPECTED_END);
+  assert_int_equal(
+      az_json_tape_init(&tape, AZ_SPAN_FROM_STR("{\"a\":1} {}"), entries, 32, NULL),
+      AZ_ERROR_UNEXPECTED_CHAR);
+}
+
 int test_az_json()
 {
   const struct CMUnitTest tests[]
@@ -2832,6 +4481,13 @@ int test_az_json()
           cmocka_unit_test(test_json_writer_chunked),
           cmocka_unit_test(test_json_writer_chunked_no_callback),
           cmocka_unit_test(test_json_writer_large_string_chunked),
+          cmocka_unit_test(test_json_writer_escaped_string_blocks),
+          cmocka_unit_test(test_json_writer_append_escaped_property_name),
+          cmocka_unit_test(test_json_writer_vectored),
+          cmocka_unit_test(test_json_writer_sink),
+          cmocka_unit_test(test_json_writer_rollback),
+          cmocka_unit_test(test_json_writer_append_arrays),
+          cmocka_unit_test(test_json_template),
           cmocka_unit_test(test_json_reader),
           cmocka_unit_test(test_json_reader_invalid),
           cmocka_unit_test(test_json_reader_incomplete),
@@ -2841,8 +4497,19 @@ int test_az_json()
           cmocka_unit_test(test_az_json_token_get_string_and_text_equal_discontiguous),
           cmocka_unit_test(test_az_json_reader_double),
           cmocka_unit_test(test_az_json_token_number_too_large),
+          cmocka_unit_test(test_az_json_token_get_recorded_integer),
           cmocka_unit_test(test_az_json_token_literal),
           cmocka_unit_test(test_az_json_token_copy),
-          cmocka_unit_test(test_az_json_reader_chunked) };
+          cmocka_unit_test(test_az_json_token_unescape_in_place),
+          cmocka_unit_test(test_az_json_token_find_property_name),
+          cmocka_unit_test(test_az_json_reader_chunked),
+          cmocka_unit_test(test_az_json_reader_long_string),
+          cmocka_unit_test(test_json_nesting_stack_extension),
+          cmocka_unit_test(test_json_reader_select),
+          cmocka_unit_test(test_json_transcode),
+          cmocka_unit_test(test_json_skip_children_without_validation),
+          cmocka_unit_test(test_json_reader_validate_utf8),
+          cmocka_unit_test(test_json_reader_incremental),
+          cmocka_unit_test(test_json_tape) };
   return cmocka_run_group_tests_name("az_core_json", tests, NULL, NULL);
 }
@@ -21,6 +21,10 @@
 
 #define TEST_EXPECT_SUCCESS(exp) assert_true(az_result_succeeded(exp))
 
+#ifdef _az_MOCK_ENABLED
+az_result __wrap_az_platform_clock_msec(int64_t* out_clock_msec);
+#endif // _az_MOCK_ENABLED
+
 static bool _log_invoked_for_http_request = false;
 static bool _log_invoked_for_http_response = false;
 
@@ -108,6 +112,41 @@ static void _log_listener_NULL(az_log_classification classification, az_span mes
   }
 }
 
+static int32_t _log_record_count = 0;
+
+static void _log_record_listener(az_http_log_record const* record)
+{
+  _log_record_count++;
+
+  assert_true(az_span_is_content_equal(record->method, AZ_SPAN_FROM_STR("GET")));
+  assert_true(az_span_is_content_equal(record->url, AZ_SPAN_FROM_STR("https://www.example.com")));
+  assert_non_null(record->request);
+
+  if (record->classification == AZ_LOG_HTTP_RESPONSE)
+  {
+    assert_non_null(record->response);
+    assert_int_equal(record->status_code, AZ_HTTP_STATUS_CODE_NOT_FOUND);
+    assert_int_equal(record->duration_msec, 3456);
+  }
+  else
+  {
+    assert_null(record->response);
+    assert_int_equal(record->status_code, AZ_HTTP_STATUS_CODE_NONE);
+    assert_int_equal(record->duration_msec, -1);
+  }
+
+  uint8_t too_small[20] = { 0 };
+  az_span message = { 0 };
+  assert_int_equal(
+      az_http_log_record_format(record, AZ_SPAN_FROM_BUFFER(too_small), &message),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  uint8_t buffer[AZ_LOG_MESSAGE_BUFFER_SIZE] = { 0 };
+  assert_return_code(
+      az_http_log_record_format(record, AZ_SPAN_FROM_BUFFER(buffer), &message), AZ_OK);
+  _log_listener(record->classification, message);
+}
+
 static void test_az_log(void** state)
 {
   (void)state;
@@ -233,6 +272,30 @@ static void test_az_log(void** state)
     assert_true(_log_invoked_for_http_request == _az_BUILT_WITH_LOGGING(true, false));
     assert_true(_log_invoked_for_http_response == false);
   }
+  {
+    // Verify that a record callback receives the fields instead of the text, which it can still
+    // format into the same text. The message callback is not invoked anymore.
+    _reset_log_invocation_status();
+    _log_record_count = 0;
+    az_log_set_message_callback(_log_listener_NULL);
+    az_log_set_classification_filter_callback(NULL);
+    az_http_log_set_record_callback(_log_record_listener);
+
+    _az_http_policy_logging_log_http_request(&request);
+    _az_http_policy_logging_log_http_response(&response, 3456, &request);
+
+    assert_int_equal(_log_record_count, _az_BUILT_WITH_LOGGING(2, 0));
+    assert_true(_log_invoked_for_http_request == _az_BUILT_WITH_LOGGING(true, false));
+    assert_true(_log_invoked_for_http_response == _az_BUILT_WITH_LOGGING(true, false));
+
+    // The classification filter applies to the record callback too.
+    _log_record_count = 0;
+    az_log_set_classification_filter_callback(_should_write_http_request_only);
+    _az_http_policy_logging_log_http_response(&response, 3456, &request);
+    assert_int_equal(_log_record_count, 0);
+
+    az_http_log_set_record_callback(NULL);
+  }
 
   az_log_set_message_callback(NULL);
   az_log_set_classification_filter_callback(NULL);
@@ -399,6 +462,193 @@ static void test_az_log_everything_on_null(void** state)
   }
 }
 
+static bool _filter_allows_http_request = false;
+static int32_t _filter_calls = 0;
+static bool _should_write_http_request_if_allowed(az_log_classification classification)
+{
+  _filter_calls++;
+  return classification == AZ_LOG_HTTP_REQUEST && _filter_allows_http_request;
+}
+
+static void test_az_log_filter_cached(void** state)
+{
+  (void)state;
+  {
+    az_log_set_message_callback(_log_listener_count_logs);
+    _filter_allows_http_request = true;
+    az_log_set_classification_filter_callback(_should_write_http_request_if_allowed);
+
+    // The SDK's classifications are checked without invoking the filter.
+    _filter_calls = 0;
+    assert_true(_az_BUILT_WITH_LOGGING(true, false) == _az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_REQUEST));
+    assert_false(_az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_RESPONSE));
+    assert_int_equal(_filter_calls, 0);
+
+    // The other classifications still are.
+    assert_false(_az_LOG_SHOULD_WRITE((az_log_classification)12345));
+    assert_int_equal(_filter_calls, _az_BUILT_WITH_LOGGING(1, 0));
+
+    // A change of the answers of the filter takes effect once it is set again.
+    _filter_allows_http_request = false;
+    assert_true(_az_BUILT_WITH_LOGGING(true, false) == _az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_REQUEST));
+    az_log_set_classification_filter_callback(_should_write_http_request_if_allowed);
+    assert_false(_az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_REQUEST));
+
+    // Without a message callback, nothing is logged.
+    _filter_allows_http_request = true;
+    az_log_set_classification_filter_callback(_should_write_http_request_if_allowed);
+    az_log_set_message_callback(NULL);
+    assert_false(_az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_REQUEST));
+
+    az_log_set_classification_filter_callback(NULL);
+  }
+}
+
+static int32_t _queued_log_count = 0;
+static az_log_classification _queued_log_last_classification = 0;
+static uint8_t _queued_log_last_message[16];
+static int32_t _queued_log_last_message_size = 0;
+
+static void _log_listener_queued(az_log_classification classification, az_span message)
+{
+  _queued_log_count++;
+  _queued_log_last_classification = classification;
+  _queued_log_last_message_size = az_span_size(message);
+  (void)az_span_copy(AZ_SPAN_FROM_BUFFER(_queued_log_last_message), message);
+}
+
+static void test_az_log_queue(void** state)
+{
+  (void)state;
+
+  uint8_t too_small[40] = { 0 };
+  az_log_queue queue;
+  assert_int_equal(
+      az_log_queue_init(&queue, AZ_SPAN_FROM_BUFFER(too_small), 16),
+      _az_BUILT_WITH_LOGGING(AZ_ERROR_NOT_ENOUGH_SPACE, AZ_OK));
+
+  // Room for 5 records of 16 byte messages, of which the queue uses 4.
+  uint8_t buffer[5 * (16 + 16)] = { 0 };
+  assert_return_code(az_log_queue_init(&queue, AZ_SPAN_FROM_BUFFER(buffer), 16), AZ_OK);
+
+  _queued_log_count = 0;
+  az_log_set_message_callback(_log_listener_queued);
+  az_log_set_queue(&queue);
+
+  // Messages are only passed to the callback when the queue is drained.
+  _az_LOG_WRITE(AZ_LOG_HTTP_REQUEST, AZ_SPAN_FROM_STR("request"));
+  _az_LOG_WRITE(AZ_LOG_HTTP_RESPONSE, AZ_SPAN_FROM_STR("a message longer than 16 bytes"));
+  assert_int_equal(_queued_log_count, 0);
+
+  assert_int_equal(az_log_queue_drain(&queue, 1), _az_BUILT_WITH_LOGGING(1, 0));
+  assert_int_equal(_queued_log_count, _az_BUILT_WITH_LOGGING(1, 0));
+#ifndef AZ_NO_LOGGING
+  assert_int_equal(_queued_log_last_classification, AZ_LOG_HTTP_REQUEST);
+  assert_int_equal(_queued_log_last_message_size, 7);
+  assert_memory_equal(_queued_log_last_message, "request", 7);
+#endif // AZ_NO_LOGGING
+
+  // Long messages are truncated to the size of the records.
+  assert_int_equal(az_log_queue_drain(&queue, -1), _az_BUILT_WITH_LOGGING(1, 0));
+#ifndef AZ_NO_LOGGING
+  assert_int_equal(_queued_log_last_classification, AZ_LOG_HTTP_RESPONSE);
+  assert_int_equal(_queued_log_last_message_size, 16);
+  assert_memory_equal(_queued_log_last_message, "a message longer", 16);
+#endif // AZ_NO_LOGGING
+  assert_int_equal(az_log_queue_drain(&queue, -1), 0);
+
+  // Messages logged while the queue is full are dropped, and counted.
+  for (int i = 0; i < 6; i++)
+  {
+    _az_LOG_WRITE(AZ_LOG_HTTP_RETRY, AZ_SPAN_FROM_STR("retry"));
+  }
+  assert_int_equal(az_log_queue_get_dropped(&queue), _az_BUILT_WITH_LOGGING(2, 0));
+  assert_int_equal(az_log_queue_drain(&queue, -1), _az_BUILT_WITH_LOGGING(4, 0));
+
+  // The records are reused once drained.
+  _az_LOG_WRITE(AZ_LOG_HTTP_REQUEST, AZ_SPAN_FROM_STR("again"));
+  assert_int_equal(az_log_queue_drain(&queue, -1), _az_BUILT_WITH_LOGGING(1, 0));
+  assert_int_equal(_queued_log_count, _az_BUILT_WITH_LOGGING(7, 0));
+
+  // Without a queue, messages are passed right away again.
+  az_log_set_queue(NULL);
+  _az_LOG_WRITE(AZ_LOG_HTTP_REQUEST, AZ_SPAN_FROM_STR("direct"));
+  assert_int_equal(_queued_log_count, _az_BUILT_WITH_LOGGING(8, 0));
+
+  az_log_set_message_callback(NULL);
+}
+
+static void test_az_log_sampler(void** state)
+{
+  (void)state;
+
+  az_log_sampler samplers[2];
+  assert_return_code(az_log_sampler_init(&samplers[0], AZ_LOG_HTTP_RESPONSE, 3, 0, 1), AZ_OK);
+  assert_return_code(az_log_sampler_init(&samplers[1], AZ_LOG_HTTP_RETRY, 1, 0, 1), AZ_OK);
+
+  _queued_log_count = 0;
+  az_log_set_message_callback(_log_listener_queued);
+  az_log_set_samplers(samplers, 2);
+
+  // One in three messages is kept, starting with the first one.
+  for (int i = 0; i < 7; i++)
+  {
+    _az_LOG_WRITE(AZ_LOG_HTTP_RESPONSE, AZ_SPAN_FROM_STR("response"));
+  }
+  assert_int_equal(_queued_log_count, _az_BUILT_WITH_LOGGING(3, 0));
+  assert_int_equal(az_log_sampler_get_suppressed(&samplers[0]), _az_BUILT_WITH_LOGGING(4, 0));
+
+  // Without a rate limit, a sample rate of 1 keeps everything, and other classifications are not
+  // sampled.
+  _az_LOG_WRITE(AZ_LOG_HTTP_RETRY, AZ_SPAN_FROM_STR("retry"));
+  _az_LOG_WRITE(AZ_LOG_HTTP_REQUEST, AZ_SPAN_FROM_STR("request"));
+  assert_int_equal(_queued_log_count, _az_BUILT_WITH_LOGGING(5, 0));
+  assert_int_equal(az_log_sampler_get_suppressed(&samplers[1]), 0);
+
+  az_log_set_samplers(NULL, 0);
+  _az_LOG_WRITE(AZ_LOG_HTTP_RESPONSE, AZ_SPAN_FROM_STR("response"));
+  _az_LOG_WRITE(AZ_LOG_HTTP_RESPONSE, AZ_SPAN_FROM_STR("response"));
+  assert_int_equal(_queued_log_count, _az_BUILT_WITH_LOGGING(7, 0));
+
+#ifdef _az_MOCK_ENABLED
+  // At most 2 messages per second after a burst of 3.
+  az_log_sampler sampler;
+  assert_return_code(az_log_sampler_init(&sampler, AZ_LOG_HTTP_RETRY, 1, 2, 3), AZ_OK);
+  az_log_set_samplers(&sampler, 1);
+  _queued_log_count = 0;
+
+  will_return_count(__wrap_az_platform_clock_msec, 1000, _az_BUILT_WITH_LOGGING(6, 0));
+  for (int i = 0; i < 5; i++)
+  {
+    _az_LOG_WRITE(AZ_LOG_HTTP_RETRY, AZ_SPAN_FROM_STR("retry"));
+  }
+  assert_int_equal(_queued_log_count, _az_BUILT_WITH_LOGGING(3, 0));
+
+  // The classification is not worth formatting before the bucket refills.
+  assert_true(_az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_RETRY) == false);
+
+  // Half a second later, there is room for one more.
+  will_return_count(__wrap_az_platform_clock_msec, 1500, _az_BUILT_WITH_LOGGING(3, 0));
+  assert_true(_az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_RETRY) == _az_BUILT_WITH_LOGGING(true, false));
+  _az_LOG_WRITE(AZ_LOG_HTTP_RETRY, AZ_SPAN_FROM_STR("retry"));
+  _az_LOG_WRITE(AZ_LOG_HTTP_RETRY, AZ_SPAN_FROM_STR("retry"));
+  assert_int_equal(_queued_log_count, _az_BUILT_WITH_LOGGING(4, 0));
+
+  // After a long while, the whole burst is available again.
+  will_return_count(__wrap_az_platform_clock_msec, 1000000, _az_BUILT_WITH_LOGGING(4, 0));
+  for (int i = 0; i < 4; i++)
+  {
+    _az_LOG_WRITE(AZ_LOG_HTTP_RETRY, AZ_SPAN_FROM_STR("retry"));
+  }
+  assert_int_equal(_queued_log_count, _az_BUILT_WITH_LOGGING(7, 0));
+  assert_int_equal(az_log_sampler_get_suppressed(&sampler), _az_BUILT_WITH_LOGGING(4, 0));
+
+  az_log_set_samplers(NULL, 0);
+#endif // _az_MOCK_ENABLED
+
+  az_log_set_message_callback(NULL);
+}
+
 int test_az_logging()
 {
   const struct CMUnitTest tests[] = {
@@ -407,6 +657,9 @@ int test_az_logging()
     cmocka_unit_test(test_az_log_incorrect_list_fails_gracefully),
     cmocka_unit_test(test_az_log_everything_valid),
     cmocka_unit_test(test_az_log_everything_on_null),
+    cmocka_unit_test(test_az_log_filter_cached),
+    cmocka_unit_test(test_az_log_queue),
+    cmocka_unit_test(test_az_log_sampler),
   };
   return cmocka_run_group_tests_name("az_core_logging", tests, NULL, NULL);
 }
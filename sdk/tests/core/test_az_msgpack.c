@@ -0,0 +1,249 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_test_definitions.h"
+#include <azure/core/az_msgpack.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <math.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include <azure/core/_az_cfg.h>
+
+#define TEST_EXPECT_BYTES(writer, ...)                                                  \
+  do                                                                                    \
+  {                                                                                     \
+    uint8_t const _expected[] = { __VA_ARGS__ };                                        \
+    az_span const _actual = az_msgpack_writer_get_bytes_used_in_destination(&(writer)); \
+    assert_int_equal(az_span_size(_actual), sizeof(_expected));                         \
+    assert_memory_equal(az_span_ptr(_actual), _expected, sizeof(_expected));            \
+  } while (0)
+
+static void test_az_msgpack_writer_integers(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[16];
+  az_msgpack_writer writer;
+
+#define TEST_UINT64(value, ...)                                                            \
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK); \
+  assert_int_equal(az_msgpack_writer_append_uint64(&writer, value), AZ_OK);              \
+  TEST_EXPECT_BYTES(writer, __VA_ARGS__)
+
+#define TEST_INT64(value, ...)                                                             \
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK); \
+  assert_int_equal(az_msgpack_writer_append_int64(&writer, value), AZ_OK);               \
+  TEST_EXPECT_BYTES(writer, __VA_ARGS__)
+
+  TEST_UINT64(0, 0x00);
+  TEST_UINT64(127, 0x7f);
+  TEST_UINT64(128, 0xcc, 0x80);
+  TEST_UINT64(255, 0xcc, 0xff);
+  TEST_UINT64(256, 0xcd, 0x01, 0x00);
+  TEST_UINT64(65535, 0xcd, 0xff, 0xff);
+  TEST_UINT64(65536, 0xce, 0x00, 0x01, 0x00, 0x00);
+  TEST_UINT64(4294967296, 0xcf, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00);
+  TEST_UINT64(UINT64_MAX, 0xcf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff);
+
+  TEST_INT64(1, 0x01);
+  TEST_INT64(-1, 0xff);
+  TEST_INT64(-32, 0xe0);
+  TEST_INT64(-33, 0xd0, 0xdf);
+  TEST_INT64(-128, 0xd0, 0x80);
+  TEST_INT64(-129, 0xd1, 0xff, 0x7f);
+  TEST_INT64(-32768, 0xd1, 0x80, 0x00);
+  TEST_INT64(-32769, 0xd2, 0xff, 0xff, 0x7f, 0xff);
+  TEST_INT64(INT64_MIN, 0xd3, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00);
+
+#undef TEST_UINT64
+#undef TEST_INT64
+
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_int32(&writer, INT32_MIN), AZ_OK);
+  TEST_EXPECT_BYTES(writer, 0xd2, 0x80, 0x00, 0x00, 0x00);
+}
+
+static void test_az_msgpack_writer_floats(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[16];
+  az_msgpack_writer writer;
+
+#define TEST_DOUBLE(value, ...)                                                            \
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK); \
+  assert_int_equal(az_msgpack_writer_append_double(&writer, value), AZ_OK);              \
+  TEST_EXPECT_BYTES(writer, __VA_ARGS__)
+
+  TEST_DOUBLE(0.0, 0xca, 0x00, 0x00, 0x00, 0x00);
+  TEST_DOUBLE(-0.0, 0xca, 0x80, 0x00, 0x00, 0x00);
+  TEST_DOUBLE(1.5, 0xca, 0x3f, 0xc0, 0x00, 0x00);
+  TEST_DOUBLE(INFINITY, 0xca, 0x7f, 0x80, 0x00, 0x00);
+  TEST_DOUBLE(1.1, 0xcb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a);
+  TEST_DOUBLE(1.0e300, 0xcb, 0x7e, 0x37, 0xe4, 0x3c, 0x88, 0x00, 0x75, 0x9c);
+
+#undef TEST_DOUBLE
+
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_double(&writer, NAN), AZ_OK);
+  az_span const written = az_msgpack_writer_get_bytes_used_in_destination(&writer);
+  assert_int_equal(az_span_size(written), 5);
+  assert_int_equal(az_span_ptr(written)[0], 0xca);
+}
+
+static void test_az_msgpack_writer_simple_values_and_strings(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[64];
+  az_msgpack_writer writer;
+
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_begin_array(&writer), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_null(&writer), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_bool(&writer, false), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_bool(&writer, true), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_string(&writer, AZ_SPAN_EMPTY), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_string(&writer, AZ_SPAN_FROM_STR("IETF")), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_end_array(&writer), AZ_OK);
+  TEST_EXPECT_BYTES(writer, 0x95, 0xc0, 0xc2, 0xc3, 0xa0, 0xa4, 'I', 'E', 'T', 'F');
+
+  // 32 bytes no longer fit a fixstr.
+  az_span const long_string = AZ_SPAN_FROM_STR("0123456789abcdef0123456789abcdef");
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_string(&writer, long_string), AZ_OK);
+  az_span const written = az_msgpack_writer_get_bytes_used_in_destination(&writer);
+  assert_int_equal(az_span_size(written), 34);
+  assert_int_equal(az_span_ptr(written)[0], 0xd9);
+  assert_int_equal(az_span_ptr(written)[1], 32);
+  assert_true(az_span_is_content_equal(az_span_slice_to_end(written, 2), long_string));
+}
+
+static void test_az_msgpack_writer_containers(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[64];
+  az_msgpack_writer writer;
+
+  // {"a":1,"b":[2,3],"c":{}}
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_begin_object(&writer), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("a")), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_int32(&writer, 1), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("b")), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_begin_array(&writer), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_int32(&writer, 2), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_int32(&writer, 3), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_end_array(&writer), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("c")), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_begin_object(&writer), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_end_object(&writer), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_end_object(&writer), AZ_OK);
+  TEST_EXPECT_BYTES(
+      writer, 0x83, 0xa1, 'a', 0x01, 0xa1, 'b', 0x92, 0x02, 0x03, 0xa1, 'c', 0x80);
+
+  // An array of 16 entries no longer fits a fixarray.
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_begin_array(&writer), AZ_OK);
+  for (int32_t i = 0; i < 16; i++)
+  {
+    assert_int_equal(az_msgpack_writer_append_int32(&writer, i), AZ_OK);
+  }
+  assert_int_equal(az_msgpack_writer_append_end_array(&writer), AZ_OK);
+  TEST_EXPECT_BYTES(
+      writer,
+      0xdc,
+      0x00,
+      0x10,
+      0x00,
+      0x01,
+      0x02,
+      0x03,
+      0x04,
+      0x05,
+      0x06,
+      0x07,
+      0x08,
+      0x09,
+      0x0a,
+      0x0b,
+      0x0c,
+      0x0d,
+      0x0e,
+      0x0f);
+}
+
+static void test_az_msgpack_writer_not_enough_space(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[8];
+  az_msgpack_writer writer;
+
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(
+      az_msgpack_writer_append_uint64(&writer, UINT64_MAX), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_msgpack_writer_append_string(&writer, AZ_SPAN_FROM_STR("12345678")),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(az_span_size(az_msgpack_writer_get_bytes_used_in_destination(&writer)), 0);
+
+  // The header of a map is reserved up front, even if the map ends up using a single byte.
+  assert_int_equal(az_msgpack_writer_init(&writer, az_span_create(buffer, 4)), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_begin_object(&writer), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_begin_object(&writer), AZ_OK);
+  assert_int_equal(az_msgpack_writer_append_end_object(&writer), AZ_OK);
+  TEST_EXPECT_BYTES(writer, 0x80);
+}
+
+static void test_az_msgpack_writer_nesting_overflow(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[128];
+  az_msgpack_writer writer;
+
+  assert_int_equal(az_msgpack_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+  for (int32_t i = 0; i < _az_MSGPACK_WRITER_MAX_NESTING_DEPTH; i++)
+  {
+    assert_int_equal(az_msgpack_writer_append_begin_array(&writer), AZ_OK);
+  }
+  assert_int_equal(az_msgpack_writer_append_begin_array(&writer), AZ_ERROR_JSON_NESTING_OVERFLOW);
+  assert_int_equal(az_msgpack_writer_append_begin_object(&writer), AZ_ERROR_JSON_NESTING_OVERFLOW);
+
+  for (int32_t i = 0; i < _az_MSGPACK_WRITER_MAX_NESTING_DEPTH; i++)
+  {
+    assert_int_equal(az_msgpack_writer_append_end_array(&writer), AZ_OK);
+  }
+
+  // Every array but the innermost one holds a single entry.
+  az_span const written = az_msgpack_writer_get_bytes_used_in_destination(&writer);
+  assert_int_equal(az_span_size(written), _az_MSGPACK_WRITER_MAX_NESTING_DEPTH);
+  for (int32_t i = 0; i < _az_MSGPACK_WRITER_MAX_NESTING_DEPTH - 1; i++)
+  {
+    assert_int_equal(az_span_ptr(written)[i], 0x91);
+  }
+  assert_int_equal(az_span_ptr(written)[_az_MSGPACK_WRITER_MAX_NESTING_DEPTH - 1], 0x90);
+}
+
+int test_az_msgpack()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_msgpack_writer_integers),
+    cmocka_unit_test(test_az_msgpack_writer_floats),
+    cmocka_unit_test(test_az_msgpack_writer_simple_values_and_strings),
+    cmocka_unit_test(test_az_msgpack_writer_containers),
+    cmocka_unit_test(test_az_msgpack_writer_not_enough_space),
+    cmocka_unit_test(test_az_msgpack_writer_nesting_overflow),
+  };
+  return cmocka_run_group_tests_name("az_core_msgpack", tests, NULL, NULL);
+}
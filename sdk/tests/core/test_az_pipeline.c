@@ -3,6 +3,7 @@
 
 #include "az_test_definitions.h"
 #include <azure/core/az_http.h>
+#include <azure/core/az_http_instrumentation.h>
 #include <azure/core/az_http_transport.h>
 #include <azure/core/az_span.h>
 #include <azure/core/internal/az_http_internal.h>
@@ -87,6 +88,91 @@ void test_az_http_pipeline_process()
   assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
 }
 
+static az_http_instrumentation_event _test_instrumentation_events[8];
+static int32_t _test_instrumentation_event_count = 0;
+
+static void _test_instrumentation_callback(az_http_instrumentation_event const* event)
+{
+  if (_test_instrumentation_event_count < 8)
+  {
+    _test_instrumentation_events[_test_instrumentation_event_count] = *event;
+  }
+  _test_instrumentation_event_count++;
+}
+
+static void test_az_http_pipeline_process_instrumented(void** state)
+{
+  (void)state;
+
+  uint8_t buf[100] = { 0 };
+  uint8_t header_buf[(2 * sizeof(_az_http_request_header))] = { 0 };
+  az_span url_span = AZ_SPAN_FROM_BUFFER(buf);
+  (void)az_span_copy(url_span, AZ_SPAN_FROM_STR("url"));
+
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          url_span,
+          3,
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_EMPTY),
+      AZ_OK);
+
+  _az_http_pipeline pipeline = (_az_http_pipeline){
+        ._internal = {
+          .policies = {
+            {
+              ._internal = {
+                .process = test_policy_1,
+                .options= NULL,
+              },
+            },
+            {
+              ._internal = {
+                .process = test_policy_2,
+                .options = NULL,
+              },
+            },
+        },
+      },
+  };
+
+  uint8_t buffer[10];
+  az_http_response response;
+  assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+
+  _test_instrumentation_event_count = 0;
+  az_http_set_instrumentation_callback(_test_instrumentation_callback);
+  assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+  az_http_set_instrumentation_callback(NULL);
+
+  // Both policies are reported, the second one nested in the first one.
+  assert_int_equal(_test_instrumentation_event_count, 4);
+  int32_t const expected_index[] = { 0, 1, 1, 0 };
+  az_http_instrumentation_phase const expected_phase[] = {
+    AZ_HTTP_INSTRUMENTATION_BEGIN,
+    AZ_HTTP_INSTRUMENTATION_BEGIN,
+    AZ_HTTP_INSTRUMENTATION_END,
+    AZ_HTTP_INSTRUMENTATION_END,
+  };
+  for (int32_t i = 0; i < 4; ++i)
+  {
+    assert_true(_test_instrumentation_events[i].request == &request);
+    assert_int_equal(_test_instrumentation_events[i].kind, AZ_HTTP_INSTRUMENTATION_POLICY);
+    assert_int_equal(_test_instrumentation_events[i].phase, expected_phase[i]);
+    assert_int_equal(_test_instrumentation_events[i].index, expected_index[i]);
+    assert_int_equal(_test_instrumentation_events[i].result, AZ_OK);
+  }
+
+  // Once the callback is removed, nothing is reported anymore.
+  _test_instrumentation_event_count = 0;
+  assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+  assert_int_equal(_test_instrumentation_event_count, 0);
+}
+
 az_result test_policy_1(
     _az_http_policy* ref_policies,
     void* ref_options,
@@ -117,6 +203,7 @@ int test_az_pipeline()
 {
   const struct CMUnitTest tests[] = {
     cmocka_unit_test(az_pipeline_test),
+    cmocka_unit_test(test_az_http_pipeline_process_instrumented),
   };
   return cmocka_run_group_tests_name("az_core_pipeline", tests, NULL, NULL);
 }
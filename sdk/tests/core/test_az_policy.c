@@ -38,6 +38,10 @@ void test_az_http_pipeline_policy_credential(void** state);
 void test_az_http_pipeline_policy_retry(void** state);
 void test_az_http_pipeline_policy_retry_with_header(void** state);
 void test_az_http_pipeline_policy_retry_with_header_2(void** state);
+void test_az_http_pipeline_process_suspends_retry(void** state);
+void test_az_http_pipeline_policy_retry_budget(void** state);
+void test_az_http_pipeline_policy_retry_jitter(void** state);
+void test_az_http_pipeline_policy_retry_metrics(void** state);
 #endif // _az_MOCK_ENABLED
 
 static az_result test_policy_transport(
@@ -48,6 +52,15 @@ static az_result test_policy_transport(
 
 void test_az_http_pipeline_policy_apiversion(void** state);
 void test_az_http_pipeline_policy_telemetry(void** state);
+void test_az_http_pipeline_freeze(void** state);
+void test_az_http_pipeline_share(void** state);
+void test_az_http_pipeline_policy_compression(void** state);
+void test_az_http_pipeline_policy_hedging_delay(void** state);
+void test_az_http_pipeline_policy_rate_limit(void** state);
+void test_az_http_pipeline_policy_circuit_breaker(void** state);
+void test_az_http_pipeline_policy_cache(void** state);
+void test_az_http_pipeline_policy_single_flight(void** state);
+void test_az_http_pipeline_policy_single_flight_headers(void** state);
 
 az_result test_policy_transport(
     _az_http_policy* ref_policies,
@@ -104,6 +117,371 @@ void test_az_http_pipeline_policy_telemetry(void** state)
       az_http_pipeline_policy_telemetry(policies, &telemetry, &request, NULL), AZ_OK);
 }
 
+void test_az_http_pipeline_freeze(void** state)
+{
+  (void)state;
+
+  _az_http_policy_apiversion_options api_version = _az_http_policy_apiversion_options_default();
+  api_version._internal.option_location = _az_http_policy_apiversion_option_location_queryparameter;
+  api_version._internal.name = AZ_SPAN_FROM_STR("api-version");
+  api_version._internal.version = AZ_SPAN_FROM_STR("2020-01-01");
+  _az_http_policy_telemetry_options telemetry = _az_http_policy_telemetry_options_default();
+
+  _az_http_pipeline pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        { ._internal = { .process = az_http_pipeline_policy_apiversion, .options = &api_version } },
+        { ._internal = { .process = az_http_pipeline_policy_telemetry, .options = &telemetry } },
+        { ._internal = { .process = test_policy_transport, .options = NULL } },
+      },
+    },
+  };
+
+  uint8_t query_buf[64] = { 0 };
+  _az_http_policy_static_headers_options options
+      = _az_http_policy_static_headers_options_default(AZ_SPAN_FROM_BUFFER(query_buf));
+  assert_return_code(
+      _az_http_policy_static_headers_options_add_header(
+          &options, AZ_SPAN_FROM_STR(" x-ms-client "), AZ_SPAN_FROM_STR("test ")),
+      AZ_OK);
+  assert_int_equal(
+      _az_http_policy_static_headers_options_add_header(
+          &options, AZ_SPAN_FROM_STR("bad:name"), AZ_SPAN_FROM_STR("value")),
+      AZ_ERROR_ARG);
+  assert_return_code(
+      _az_http_policy_static_headers_options_add_query_parameter(
+          &options, AZ_SPAN_FROM_STR("q"), AZ_SPAN_FROM_STR("a b"), false),
+      AZ_OK);
+
+  assert_return_code(_az_http_pipeline_freeze(&pipeline, &options), AZ_OK);
+
+  // Both policies were replaced by a single one, in front of the remaining ones.
+  assert_true(
+      pipeline._internal.policies[0]._internal.process == az_http_pipeline_policy_static_headers);
+  assert_true(pipeline._internal.policies[0]._internal.options == &options);
+  assert_true(pipeline._internal.policies[1]._internal.process == test_policy_transport);
+  assert_null(pipeline._internal.policies[2]._internal.process);
+  assert_int_equal(options._internal.headers_length, 2);
+
+  uint8_t url_buf[100] = { 0 };
+  uint8_t header_buf[(4 * sizeof(_az_http_request_header))] = { 0 };
+  az_span url_span = AZ_SPAN_FROM_BUFFER(url_buf);
+  (void)az_span_copy(url_span, AZ_SPAN_FROM_STR("url"));
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          url_span,
+          3,
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_EMPTY),
+      AZ_OK);
+
+  uint8_t response_buf[10] = { 0 };
+  az_http_response response;
+  assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+  assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+
+  az_span url = { 0 };
+  assert_return_code(az_http_request_get_url(&request, &url), AZ_OK);
+  assert_true(
+      az_span_is_content_equal(url, AZ_SPAN_FROM_STR("url?q=a%20b&api-version=2020-01-01")));
+
+  assert_int_equal(az_http_request_headers_count(&request), 2);
+  az_span name = { 0 };
+  az_span value = { 0 };
+  assert_return_code(az_http_request_get_header(&request, 0, &name, &value), AZ_OK);
+  assert_true(az_span_is_content_equal(name, AZ_SPAN_FROM_STR("x-ms-client")));
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("test")));
+  assert_return_code(az_http_request_get_header(&request, 1, &name, &value), AZ_OK);
+  assert_true(az_span_is_content_equal(name, AZ_SPAN_FROM_STR("User-Agent")));
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("Unknown OS")));
+
+  // A pipeline without any of these policies is left unchanged.
+  _az_http_policy_static_headers_options unused
+      = _az_http_policy_static_headers_options_default(AZ_SPAN_EMPTY);
+  assert_return_code(_az_http_pipeline_freeze(&pipeline, &unused), AZ_OK);
+  assert_true(pipeline._internal.policies[0]._internal.options == &options);
+  assert_int_equal(unused._internal.headers_length, 0);
+}
+
+void test_az_http_pipeline_share(void** state)
+{
+  (void)state;
+
+  _az_http_policy_telemetry_options telemetry = _az_http_policy_telemetry_options_default();
+  _az_http_pipeline pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        { ._internal = { .process = az_http_pipeline_policy_telemetry, .options = &telemetry } },
+        { ._internal = { .process = az_http_pipeline_policy_logging, .options = NULL } },
+        { ._internal = { .process = test_policy_transport, .options = NULL } },
+      },
+    },
+  };
+
+  assert_false(_az_http_pipeline_is_shared(&pipeline));
+  assert_return_code(_az_http_pipeline_share(&pipeline), AZ_OK);
+  assert_true(_az_http_pipeline_is_shared(&pipeline));
+
+  // A policy which keeps state in its options makes the pipeline unshareable.
+  _az_http_policy_cache_options cache = _az_http_policy_cache_options_default(AZ_SPAN_EMPTY);
+  _az_http_pipeline cached_pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        { ._internal = { .process = az_http_pipeline_policy_cache, .options = &cache } },
+        { ._internal = { .process = test_policy_transport, .options = NULL } },
+      },
+    },
+  };
+
+  assert_int_equal(_az_http_pipeline_share(&cached_pipeline), AZ_ERROR_NOT_SUPPORTED);
+  assert_false(_az_http_pipeline_is_shared(&cached_pipeline));
+
+  // The circuit breaker policy guards the health of the hosts with a lock, when it can.
+  _az_http_policy_circuit_breaker_options circuit_breaker
+      = _az_http_policy_circuit_breaker_options_default();
+  _az_http_pipeline guarded_pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        { ._internal = { .process = az_http_pipeline_policy_circuit_breaker,
+                         .options = &circuit_breaker } },
+        { ._internal = { .process = test_policy_transport, .options = NULL } },
+      },
+    },
+  };
+
+#if defined(__GNUC__) || defined(__clang__)
+  assert_return_code(_az_http_pipeline_share(&guarded_pipeline), AZ_OK);
+  assert_true(_az_http_pipeline_is_shared(&guarded_pipeline));
+#else
+  assert_int_equal(_az_http_pipeline_share(&guarded_pipeline), AZ_ERROR_NOT_SUPPORTED);
+#endif
+}
+
+static uint8_t _test_compression_sent[1024];
+static int32_t _test_compression_sent_size;
+
+// Records the body the way a transport sends it.
+static az_result _test_compression_transport(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_response;
+
+  _test_compression_sent_size = 0;
+  int32_t size = 0;
+  do
+  {
+    // Small reads, so that the compressed body is served over several of them.
+    int32_t const chunk_size = 7;
+    assert_true(
+        _test_compression_sent_size + chunk_size <= (int32_t)sizeof(_test_compression_sent));
+    az_result const result = az_http_request_read_body(
+        ref_request,
+        _test_compression_sent_size,
+        az_span_create(_test_compression_sent + _test_compression_sent_size, chunk_size),
+        &size);
+    if (az_result_failed(result))
+    {
+      return result;
+    }
+    _test_compression_sent_size += size;
+  } while (size > 0);
+
+  return AZ_OK;
+}
+
+typedef struct
+{
+  az_span body;
+  int32_t max_chunk_size;
+} _test_compression_source;
+
+static az_result _test_compression_read(
+    void* user_context,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size)
+{
+  _test_compression_source const* source = (_test_compression_source const*)user_context;
+  az_span remainder = az_span_slice_to_end(source->body, (int32_t)offset);
+  int32_t size = az_span_size(remainder) < az_span_size(destination) ? az_span_size(remainder)
+                                                                      : az_span_size(destination);
+  size = size < source->max_chunk_size ? size : source->max_chunk_size;
+  az_span_copy(destination, az_span_slice(remainder, 0, size));
+  *out_size = size;
+  return AZ_OK;
+}
+
+static void _test_compression_assert_gzip(int32_t body_size)
+{
+  // The gzip header, with the deflate compression method.
+  assert_true(_test_compression_sent_size > 18);
+  assert_true(_test_compression_sent_size < body_size);
+  assert_int_equal(_test_compression_sent[0], 0x1F);
+  assert_int_equal(_test_compression_sent[1], 0x8B);
+  assert_int_equal(_test_compression_sent[2], 8);
+
+  // ISIZE is the size of the uncompressed body.
+  uint8_t const* isize = _test_compression_sent + _test_compression_sent_size - 4;
+  assert_int_equal(
+      (uint32_t)isize[0] | ((uint32_t)isize[1] << 8U) | ((uint32_t)isize[2] << 16U)
+          | ((uint32_t)isize[3] << 24U),
+      (uint32_t)body_size);
+}
+
+void test_az_http_pipeline_policy_compression(void** state)
+{
+  (void)state;
+
+  uint8_t body_buf[2048] = { 0 };
+  az_span remainder = AZ_SPAN_FROM_BUFFER(body_buf);
+  remainder = az_span_copy_u8(remainder, '[');
+  for (int32_t i = 0; i < 40; i++)
+  {
+    remainder = az_span_copy(remainder, AZ_SPAN_FROM_STR("{\"temperature\":21.5,\"humidity\":"));
+    remainder = az_span_copy_u8(remainder, (uint8_t)('0' + (i % 10)));
+    remainder = az_span_copy(remainder, AZ_SPAN_FROM_STR("},"));
+  }
+  remainder = az_span_copy_u8(remainder, ']');
+  az_span const body = az_span_slice(
+      AZ_SPAN_FROM_BUFFER(body_buf), 0, (int32_t)(az_span_ptr(remainder) - body_buf));
+
+  uint8_t work_buf[1200] = { 0 };
+  _az_http_policy_compression_options options
+      = _az_http_policy_compression_options_default(AZ_SPAN_FROM_BUFFER(work_buf));
+
+  _az_http_pipeline pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        { ._internal = { .process = az_http_pipeline_policy_compression, .options = &options } },
+        { ._internal = { .process = _test_compression_transport, .options = NULL } },
+      },
+    },
+  };
+
+  uint8_t url_buf[100] = { 0 };
+  uint8_t header_buf[(2 * sizeof(_az_http_request_header))] = { 0 };
+  az_span url_span = AZ_SPAN_FROM_BUFFER(url_buf);
+  (void)az_span_copy(url_span, AZ_SPAN_FROM_STR("url"));
+  uint8_t response_buf[10] = { 0 };
+  az_http_response response;
+  assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+  az_span name = { 0 };
+  az_span value = { 0 };
+
+  // A body in memory.
+  {
+    az_http_request request;
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_post(),
+            url_span,
+            3,
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            body),
+        AZ_OK);
+    assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+
+    _test_compression_assert_gzip(az_span_size(body));
+    assert_int_equal(az_http_request_headers_count(&request), 1);
+    assert_return_code(az_http_request_get_header(&request, 0, &name, &value), AZ_OK);
+    assert_true(az_span_is_content_equal(name, AZ_SPAN_FROM_STR("Content-Encoding")));
+    assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("gzip")));
+
+    // The body of the request is restored.
+    az_span request_body = { 0 };
+    assert_return_code(az_http_request_get_body(&request, &request_body), AZ_OK);
+    assert_true(az_span_is_content_equal(request_body, body));
+  }
+
+  // A body produced by a reader, compressed chunk by chunk, is identical, as chunks are as large
+  // as a whole body of that size.
+  {
+    uint8_t in_memory[sizeof(_test_compression_sent)] = { 0 };
+    int32_t const in_memory_size = _test_compression_sent_size;
+    memcpy(in_memory, _test_compression_sent, (size_t)in_memory_size);
+
+    uint8_t stream_work_buf[2 * 2048 + 64] = { 0 };
+    options = _az_http_policy_compression_options_default(AZ_SPAN_FROM_BUFFER(stream_work_buf));
+
+    _test_compression_source source = { .body = body, .max_chunk_size = 100 };
+    az_http_request request;
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_post(),
+            url_span,
+            3,
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            AZ_SPAN_EMPTY),
+        AZ_OK);
+    assert_return_code(
+        az_http_request_set_body_reader(
+            &request, _test_compression_read, &source, az_span_size(body)),
+        AZ_OK);
+    assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+
+    _test_compression_assert_gzip(az_span_size(body));
+    assert_int_equal(_test_compression_sent_size, in_memory_size);
+    assert_memory_equal(_test_compression_sent, in_memory, (size_t)in_memory_size);
+    assert_int_equal(az_http_request_get_body_length(&request), az_span_size(body));
+
+    // Sending the request again compresses the body again.
+    assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+    _test_compression_assert_gzip(az_span_size(body));
+  }
+
+  // A small work buffer compresses the body over several blocks.
+  {
+    options = _az_http_policy_compression_options_default(AZ_SPAN_FROM_BUFFER(work_buf));
+    _test_compression_source source = { .body = body, .max_chunk_size = 100 };
+    az_http_request request;
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_post(),
+            url_span,
+            3,
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            AZ_SPAN_EMPTY),
+        AZ_OK);
+    assert_return_code(
+        az_http_request_set_body_reader(&request, _test_compression_read, &source, -1), AZ_OK);
+    assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+    _test_compression_assert_gzip(az_span_size(body));
+  }
+
+  // Bodies smaller than the minimum size are sent as they are.
+  {
+    az_http_request request;
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_post(),
+            url_span,
+            3,
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            az_span_slice(body, 0, 100)),
+        AZ_OK);
+    assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+    assert_int_equal(_test_compression_sent_size, 100);
+    assert_int_equal(az_http_request_headers_count(&request), 0);
+  }
+}
+
 void test_az_http_pipeline_policy_apiversion(void** state)
 {
   (void)state;
@@ -154,6 +532,438 @@ void test_az_http_pipeline_policy_apiversion(void** state)
       az_http_pipeline_policy_apiversion(policies, &api_version, &request, NULL), AZ_OK);
 }
 
+void test_az_http_pipeline_policy_hedging_delay(void** state)
+{
+  (void)state;
+
+  uint8_t hedge_buffer[16];
+  _az_http_policy_hedging_options options
+      = _az_http_policy_hedging_options_default(AZ_SPAN_FROM_BUFFER(hedge_buffer));
+
+  // Not enough samples yet.
+  assert_int_equal(_az_http_policy_hedging_get_delay_msec(&options), 1000);
+  options._internal.latency_count = 7;
+  assert_int_equal(_az_http_policy_hedging_get_delay_msec(&options), 1000);
+
+  // Latencies of 100, 99, ..., 69: the 95th percentile is the 31st smallest.
+  for (int32_t i = 0; i < _az_HTTP_POLICY_HEDGING_LATENCY_SAMPLES; ++i)
+  {
+    options._internal.latencies_msec[i] = 100 - i;
+  }
+
+  options._internal.latency_count = _az_HTTP_POLICY_HEDGING_LATENCY_SAMPLES;
+  assert_int_equal(_az_http_policy_hedging_get_delay_msec(&options), 99);
+
+  // Only the recorded samples are used.
+  options._internal.latency_count = 8;
+  assert_int_equal(_az_http_policy_hedging_get_delay_msec(&options), 100);
+
+  options._internal.percentile = 50;
+  assert_int_equal(_az_http_policy_hedging_get_delay_msec(&options), 97);
+
+  // Once the samples wrapped around, all of them are used.
+  options._internal.latency_count = 1000;
+  assert_int_equal(_az_http_policy_hedging_get_delay_msec(&options), 85);
+}
+
+void test_az_http_pipeline_policy_rate_limit(void** state)
+{
+  (void)state;
+
+  // 10 requests per second, with a bucket of 10 requests.
+  _az_http_policy_rate_limit_options options = _az_http_policy_rate_limit_options_default(10);
+  for (int32_t i = 0; i < 10; ++i)
+  {
+    assert_int_equal(_az_http_policy_rate_limit_acquire(&options, 1000), 0);
+  }
+
+  assert_int_equal(_az_http_policy_rate_limit_acquire(&options, 1000), 100);
+  assert_int_equal(_az_http_policy_rate_limit_acquire(&options, 1100), 0);
+
+  // Throttled: the rate halves, the bucket empties, and the Retry-After holds every request.
+  _az_http_policy_rate_limit_update(&options, AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS, 2000, 1100);
+  assert_int_equal(options._internal.rate, 5000);
+  assert_int_equal(_az_http_policy_rate_limit_acquire(&options, 1200), 1900);
+
+  // The bucket refilled up to one second at the new rate.
+  assert_int_equal(_az_http_policy_rate_limit_acquire(&options, 3100), 0);
+  assert_true(options._internal.tokens == 4000000);
+
+  // Successes add a request per second every second, up to the maximum rate.
+  _az_http_policy_rate_limit_update(&options, AZ_HTTP_STATUS_CODE_OK, -1, 3100);
+  assert_int_equal(options._internal.rate, 5200);
+  for (int32_t i = 0; i < 100; ++i)
+  {
+    _az_http_policy_rate_limit_update(&options, AZ_HTTP_STATUS_CODE_OK, -1, 3100);
+  }
+
+  assert_int_equal(options._internal.rate, 10000);
+
+  // Other server errors leave the rate as is.
+  _az_http_policy_rate_limit_update(&options, AZ_HTTP_STATUS_CODE_BAD_GATEWAY, -1, 3100);
+  assert_int_equal(options._internal.rate, 10000);
+
+  // Never below a tenth of a request per second.
+  for (int32_t i = 0; i < 20; ++i)
+  {
+    _az_http_policy_rate_limit_update(&options, AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE, -1, 4000);
+  }
+
+  assert_int_equal(options._internal.rate, 100);
+  assert_int_equal(_az_http_policy_rate_limit_acquire(&options, 4000), 10000);
+}
+
+void test_az_http_pipeline_policy_circuit_breaker(void** state)
+{
+  (void)state;
+
+  _az_http_policy_circuit_breaker_options options
+      = _az_http_policy_circuit_breaker_options_default();
+  az_span const host = AZ_SPAN_FROM_STR("myaccount.blob.core.windows.net");
+  az_span const other_host = AZ_SPAN_FROM_STR("myaccount.queue.core.windows.net");
+
+  // 2 failures out of 5 requests keep the circuit closed, a 3rd one opens it.
+  for (int32_t i = 0; i < 3; ++i)
+  {
+    _az_http_policy_circuit_breaker_record(&options, host, false, 0);
+  }
+
+  _az_http_policy_circuit_breaker_record(&options, host, true, 0);
+  _az_http_policy_circuit_breaker_record(&options, host, true, 0);
+  assert_return_code(_az_http_policy_circuit_breaker_acquire(&options, host, 100), AZ_OK);
+
+  _az_http_policy_circuit_breaker_record(&options, host, true, 100);
+  assert_int_equal(
+      _az_http_policy_circuit_breaker_acquire(&options, host, 200), AZ_ERROR_HTTP_CIRCUIT_OPEN);
+  assert_int_equal(
+      _az_http_policy_circuit_breaker_acquire(
+          &options, AZ_SPAN_FROM_STR("MyAccount.Blob.Core.Windows.Net"), 200),
+      AZ_ERROR_HTTP_CIRCUIT_OPEN);
+  assert_return_code(_az_http_policy_circuit_breaker_acquire(&options, other_host, 200), AZ_OK);
+
+  // After 5 seconds, a single probe is let through, and its failure keeps the circuit open.
+  assert_return_code(_az_http_policy_circuit_breaker_acquire(&options, host, 5100), AZ_OK);
+  assert_int_equal(
+      _az_http_policy_circuit_breaker_acquire(&options, host, 5101), AZ_ERROR_HTTP_CIRCUIT_OPEN);
+  _az_http_policy_circuit_breaker_record(&options, host, true, 5200);
+  assert_int_equal(
+      _az_http_policy_circuit_breaker_acquire(&options, host, 10199), AZ_ERROR_HTTP_CIRCUIT_OPEN);
+
+  // A successful probe closes the circuit.
+  assert_return_code(_az_http_policy_circuit_breaker_acquire(&options, host, 10200), AZ_OK);
+  _az_http_policy_circuit_breaker_record(&options, host, false, 10300);
+  assert_return_code(_az_http_policy_circuit_breaker_acquire(&options, host, 10300), AZ_OK);
+
+  // Failures from a previous window don't count.
+  for (int32_t i = 0; i < 4; ++i)
+  {
+    _az_http_policy_circuit_breaker_record(&options, host, true, 10300);
+  }
+
+  _az_http_policy_circuit_breaker_record(&options, host, true, 20300);
+  assert_return_code(_az_http_policy_circuit_breaker_acquire(&options, host, 20300), AZ_OK);
+
+  // The lock guarding the hosts is only held within the calls.
+  assert_int_equal(options._internal.lock, 0);
+}
+
+// Answers 304 to the requests with an If-None-Match header, and 200 with an ETag to the others.
+// The options point to whether the request is expected to have the header.
+static az_result _test_cache_transport(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+
+  bool is_conditional = false;
+  az_span name = { 0 };
+  az_span value = { 0 };
+  for (int32_t i = 0; i < az_http_request_headers_count(ref_request); ++i)
+  {
+    assert_return_code(az_http_request_get_header(ref_request, i, &name, &value), AZ_OK);
+    if (az_span_is_content_equal(name, AZ_SPAN_FROM_STR("If-None-Match")))
+    {
+      assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("\"v1\"")));
+      is_conditional = true;
+    }
+  }
+
+  assert_int_equal(is_conditional, *(bool const*)ref_options);
+  return az_http_response_append(
+      ref_response,
+      is_conditional ? AZ_SPAN_FROM_STR("HTTP/1.1 304 Not Modified\r\n"
+                                        "ETag: \"v1\"\r\n"
+                                        "\r\n")
+                     : AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n"
+                                        "ETag: \"v1\"\r\n"
+                                        "Content-Length: 6\r\n"
+                                        "\r\n"
+                                        "config"));
+}
+
+void test_az_http_pipeline_policy_cache(void** state)
+{
+  (void)state;
+
+  uint8_t cache_buf[_az_HTTP_POLICY_CACHE_ENTRIES * 128] = { 0 };
+  _az_http_policy_cache_options options
+      = _az_http_policy_cache_options_default(AZ_SPAN_FROM_BUFFER(cache_buf));
+  bool is_conditional = false;
+
+  _az_http_pipeline pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        { ._internal = { .process = az_http_pipeline_policy_cache, .options = &options } },
+        { ._internal = { .process = _test_cache_transport, .options = &is_conditional } },
+      },
+    },
+  };
+
+  uint8_t url_buf[32] = { 0 };
+  az_span const url = AZ_SPAN_FROM_BUFFER(url_buf);
+  (void)az_span_copy(url, AZ_SPAN_FROM_STR("https://host/config"));
+  uint8_t header_buf[2 * sizeof(_az_http_request_header)] = { 0 };
+  uint8_t response_buf[128] = { 0 };
+  az_http_response_status_line status_line = { 0 };
+  az_span body = { 0 };
+
+  for (int32_t i = 0; i < 3; ++i)
+  {
+    // The first GET fetches the configuration, the next ones revalidate it.
+    is_conditional = i > 0;
+
+    az_http_request request;
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_get(),
+            url,
+            19,
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            AZ_SPAN_EMPTY),
+        AZ_OK);
+    az_http_response response;
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+    assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+
+    // The 304 response is replaced by the response that was kept.
+    assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_OK);
+    // The body runs up to the end of the response buffer.
+    assert_return_code(az_http_response_get_body(&response, &body), AZ_OK);
+    assert_true(az_span_is_content_equal(az_span_slice(body, 0, 6), AZ_SPAN_FROM_STR("config")));
+  }
+
+  // Other methods, and other URLs, go through as they are.
+  is_conditional = false;
+  {
+    az_http_request request;
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_put(),
+            url,
+            19,
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            AZ_SPAN_EMPTY),
+        AZ_OK);
+    az_http_response response;
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+    assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_get(),
+            url,
+            18,
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            AZ_SPAN_EMPTY),
+        AZ_OK);
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+    assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+  }
+}
+
+// Checks that the request being sent is in flight in the options of the single flight policy.
+static az_result _test_single_flight_transport(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_request;
+
+  // Without atomic operations, the policy sends requests as they are.
+#if defined(__GNUC__) || defined(__clang__)
+  _az_http_policy_single_flight_options const* const options
+      = (_az_http_policy_single_flight_options const*)ref_options;
+  assert_true(options->_internal.calls[0]._internal.is_used);
+  assert_null(options->_internal.calls[0]._internal.waiters);
+#else
+  (void)ref_options;
+#endif
+
+  return az_http_response_append(
+      ref_response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n"));
+}
+
+void test_az_http_pipeline_policy_single_flight(void** state)
+{
+  (void)state;
+
+  _az_http_policy_single_flight_options options = _az_http_policy_single_flight_options_default();
+
+  _az_http_pipeline pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        { ._internal = { .process = az_http_pipeline_policy_single_flight, .options = &options } },
+        { ._internal = { .process = _test_single_flight_transport, .options = &options } },
+      },
+    },
+  };
+
+  uint8_t url_buf[32] = { 0 };
+  az_span const url = AZ_SPAN_FROM_BUFFER(url_buf);
+  (void)az_span_copy(url, AZ_SPAN_FROM_STR("https://host/token"));
+  uint8_t header_buf[sizeof(_az_http_request_header)] = { 0 };
+  uint8_t response_buf[64] = { 0 };
+
+  // Without another thread sending the same request, each request is sent, and is no longer in
+  // flight once it returns.
+  for (int32_t i = 0; i < 2; ++i)
+  {
+    az_http_request request;
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_get(),
+            url,
+            18,
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            AZ_SPAN_EMPTY),
+        AZ_OK);
+    az_http_response response;
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+    assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+
+#if defined(__GNUC__) || defined(__clang__)
+    assert_false(options._internal.calls[0]._internal.is_used);
+    assert_int_equal(options._internal.lock, 0);
+#endif
+  }
+}
+
+static _az_http_pipeline* _test_single_flight_pipeline;
+
+// Sends a GET request for a range, and checks that the response is for that range.
+static void _test_single_flight_send_range(az_span range)
+{
+  uint8_t url_buf[32] = { 0 };
+  az_span const url = AZ_SPAN_FROM_BUFFER(url_buf);
+  (void)az_span_copy(url, AZ_SPAN_FROM_STR("https://host/blob"));
+  uint8_t header_buf[sizeof(_az_http_request_header)] = { 0 };
+  uint8_t response_buf[64] = { 0 };
+
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          url,
+          17,
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_EMPTY),
+      AZ_OK);
+  assert_return_code(
+      az_http_request_append_header(&request, AZ_SPAN_FROM_STR("Range"), range), AZ_OK);
+  az_http_response response;
+  assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+  assert_return_code(
+      az_http_pipeline_process(_test_single_flight_pipeline, &request, &response), AZ_OK);
+
+  az_http_response_status_line status_line = { 0 };
+  az_span body = { 0 };
+  assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+  assert_return_code(az_http_response_get_body(&response, &body), AZ_OK);
+  // The body is the rest of the response buffer.
+  assert_true(az_span_is_content_equal(az_span_slice(body, 0, az_span_size(range)), range));
+}
+
+// Responds with the range of the request, after sending a request for another range of the same
+// URL while the first one is in flight.
+static az_result _test_single_flight_range_transport(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+
+  az_span name = { 0 };
+  az_span range = { 0 };
+  assert_return_code(az_http_request_get_header(ref_request, 0, &name, &range), AZ_OK);
+
+#if defined(__GNUC__) || defined(__clang__)
+  _az_http_policy_single_flight_options const* const options
+      = (_az_http_policy_single_flight_options const*)ref_options;
+  assert_true(options->_internal.calls[0]._internal.is_used);
+  assert_null(options->_internal.calls[0]._internal.waiters);
+#else
+  (void)ref_options;
+#endif
+
+  if (az_span_is_content_equal(range, AZ_SPAN_FROM_STR("bytes=0-9")))
+  {
+    _test_single_flight_send_range(AZ_SPAN_FROM_STR("bytes=10-19"));
+  }
+  else
+  {
+    // The request for the other range is in flight too, instead of waiting for the first one.
+#if defined(__GNUC__) || defined(__clang__)
+    assert_true(options->_internal.calls[1]._internal.is_used);
+#endif
+  }
+
+  az_result const result
+      = az_http_response_append(ref_response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\n"));
+  return az_result_failed(result) ? result : az_http_response_append(ref_response, range);
+}
+
+void test_az_http_pipeline_policy_single_flight_headers(void** state)
+{
+  (void)state;
+
+  _az_http_policy_single_flight_options options = _az_http_policy_single_flight_options_default();
+
+  _az_http_pipeline pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        { ._internal = { .process = az_http_pipeline_policy_single_flight, .options = &options } },
+        { ._internal = { .process = _test_single_flight_range_transport, .options = &options } },
+      },
+    },
+  };
+  _test_single_flight_pipeline = &pipeline;
+
+  // Requests for different ranges of the same URL each get their own response.
+  _test_single_flight_send_range(AZ_SPAN_FROM_STR("bytes=0-9"));
+
+#if defined(__GNUC__) || defined(__clang__)
+  assert_false(options._internal.calls[0]._internal.is_used);
+  assert_false(options._internal.calls[1]._internal.is_used);
+  assert_int_equal(options._internal.lock, 0);
+#endif
+}
+
 #ifdef _az_MOCK_ENABLED
 
 const az_span retry_response = AZ_SPAN_LITERAL_FROM_STR("HTTP/1.1 408 Request Timeout\r\n"
@@ -359,6 +1169,253 @@ void test_az_http_pipeline_policy_retry_with_header_2(void** state)
       az_http_pipeline_policy_retry(policies, &retry_options, &request, &response), AZ_OK);
 }
 
+static int32_t test_policy_transport_retry_calls = 0;
+
+static az_result test_policy_transport_retry_response_counted(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  ++test_policy_transport_retry_calls;
+  return test_policy_transport_retry_response_with_header(
+      ref_policies, ref_options, ref_request, ref_response);
+}
+
+void test_az_http_pipeline_process_suspends_retry(void** state)
+{
+  (void)state;
+
+  uint8_t buf[100];
+  uint8_t header_buf[(2 * sizeof(_az_http_request_header))];
+  memset(buf, 0, sizeof(buf));
+  memset(header_buf, 0, sizeof(header_buf));
+
+  az_span url_span = AZ_SPAN_FROM_BUFFER(buf);
+  az_span remainder = az_span_copy(url_span, AZ_SPAN_FROM_STR("url"));
+  assert_int_equal(az_span_size(remainder), 97);
+  az_span header_span = AZ_SPAN_FROM_BUFFER(header_buf);
+  az_http_request request;
+
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          url_span,
+          3,
+          header_span,
+          AZ_SPAN_EMPTY),
+      AZ_OK);
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  retry_options.max_retries = 1;
+
+  _az_http_pipeline pipeline = (_az_http_pipeline){
+        ._internal = {
+          .policies = {
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_retry,
+                .options = &retry_options,
+              },
+            },
+            {
+              ._internal = {
+                .process = test_policy_transport_retry_response_counted,
+                .options = NULL,
+              },
+            },
+        },
+      },
+  };
+
+  test_policy_transport_retry_calls = 0;
+  _az_http_pipeline_operation operation;
+  az_http_response response;
+
+  // The first attempt gets "retry-after-ms: 1600", so the operation suspends until 1000 + 1600,
+  // instead of sleeping.
+  will_return(__wrap_az_platform_clock_msec, 1000);
+  assert_int_equal(
+      az_http_pipeline_process_start(&pipeline, &operation, &request, &response),
+      AZ_ERROR_HTTP_PIPELINE_SUSPENDED);
+  assert_int_equal(test_policy_transport_retry_calls, 1);
+  assert_true(_az_http_pipeline_operation_get_resume_msec(&operation) == 2600);
+  assert_ptr_equal(request._internal.pipeline_operation, &operation);
+
+  // Too early, nothing is sent.
+  will_return(__wrap_az_platform_clock_msec, 2000);
+  assert_int_equal(az_http_pipeline_process_resume(&operation), AZ_ERROR_HTTP_PIPELINE_SUSPENDED);
+  assert_int_equal(test_policy_transport_retry_calls, 1);
+
+  // The retry policy checks the context before the second and last attempt.
+  will_return_count(__wrap_az_platform_clock_msec, 2600, 2);
+  assert_return_code(az_http_pipeline_process_resume(&operation), AZ_OK);
+  assert_int_equal(test_policy_transport_retry_calls, 2);
+  assert_null(request._internal.pipeline_operation);
+
+  az_http_response_status_line status_line = { 0 };
+  assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+  assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_REQUEST_TIMEOUT);
+}
+
+static int32_t test_policy_last_sleep_msec = -1;
+
+static void _test_az_http_pipeline_policy_retry_send(
+    az_http_policy_retry_options* retry_options,
+    _az_http_policy_process_fn transport)
+{
+  uint8_t buf[100];
+  uint8_t header_buf[(2 * sizeof(_az_http_request_header))];
+  memset(buf, 0, sizeof(buf));
+  memset(header_buf, 0, sizeof(header_buf));
+
+  az_span url_span = AZ_SPAN_FROM_BUFFER(buf);
+  az_span remainder = az_span_copy(url_span, AZ_SPAN_FROM_STR("url"));
+  assert_int_equal(az_span_size(remainder), 97);
+  az_http_request request;
+
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          url_span,
+          3,
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_EMPTY),
+      AZ_OK);
+
+  _az_http_policy policies[1] = {
+            {
+              ._internal = {
+                .process = transport,
+                .options = NULL,
+              },
+            },
+        };
+
+  az_http_response response;
+  assert_return_code(
+      az_http_pipeline_policy_retry(policies, retry_options, &request, &response), AZ_OK);
+}
+
+void test_az_http_pipeline_policy_retry_budget(void** state)
+{
+  (void)state;
+
+  // One retry in a row, then one retry for every two requests.
+  az_http_policy_retry_budget budget;
+  assert_return_code(az_http_policy_retry_budget_init(&budget, 1, 50), AZ_OK);
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  retry_options.retry_budget = &budget;
+
+  // The burst allows a single retry, the context is checked before it.
+  test_policy_transport_retry_calls = 0;
+  will_return(__wrap_az_platform_clock_msec, 0);
+  _test_az_http_pipeline_policy_retry_send(
+      &retry_options, test_policy_transport_retry_response_counted);
+  assert_int_equal(test_policy_transport_retry_calls, 2);
+
+  // Half a retry was earned, which isn't enough.
+  test_policy_transport_retry_calls = 0;
+  _test_az_http_pipeline_policy_retry_send(
+      &retry_options, test_policy_transport_retry_response_counted);
+  assert_int_equal(test_policy_transport_retry_calls, 1);
+
+  // Now there is a whole one.
+  test_policy_transport_retry_calls = 0;
+  will_return(__wrap_az_platform_clock_msec, 0);
+  _test_az_http_pipeline_policy_retry_send(
+      &retry_options, test_policy_transport_retry_response_counted);
+  assert_int_equal(test_policy_transport_retry_calls, 2);
+}
+
+void test_az_http_pipeline_policy_retry_jitter(void** state)
+{
+  (void)state;
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  retry_options.max_retries = 1;
+  int32_t const min_delay = retry_options.retry_delay_msec;
+
+  // The response has no retry-after header, so the delay is randomized, which takes the time.
+  retry_options.jitter = AZ_HTTP_POLICY_RETRY_JITTER_DECORRELATED;
+  for (int64_t clock = 0; clock < 10; ++clock)
+  {
+    test_policy_last_sleep_msec = -1;
+    will_return_count(__wrap_az_platform_clock_msec, clock * 7919, 2);
+    _test_az_http_pipeline_policy_retry_send(&retry_options, test_policy_transport_retry_response);
+    assert_in_range(test_policy_last_sleep_msec, min_delay, 3 * min_delay);
+  }
+
+  retry_options.jitter = AZ_HTTP_POLICY_RETRY_JITTER_FULL;
+  for (int64_t clock = 0; clock < 10; ++clock)
+  {
+    test_policy_last_sleep_msec = -1;
+    will_return_count(__wrap_az_platform_clock_msec, clock * 7919, 2);
+    _test_az_http_pipeline_policy_retry_send(&retry_options, test_policy_transport_retry_response);
+    assert_in_range(test_policy_last_sleep_msec, 0, 4 * min_delay);
+  }
+}
+
+// Writes the response the way a transport does, so that the bytes received are counted.
+static az_result test_policy_transport_retry_response_appended(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_request;
+  static uint8_t response_buf[256];
+  assert_return_code(
+      az_http_response_init(ref_response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+  assert_return_code(az_http_response_append(ref_response, retry_response_with_header), AZ_OK);
+  return AZ_OK;
+}
+
+void test_az_http_pipeline_policy_retry_metrics(void** state)
+{
+  (void)state;
+
+  az_http_metrics metrics;
+  assert_return_code(az_http_metrics_init(&metrics), AZ_OK);
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  retry_options.max_retries = 1;
+  retry_options.metrics = &metrics;
+
+  // The first attempt takes 30ms, and gets "retry-after-ms: 1600". The context is checked before
+  // the second attempt, which takes 5ms.
+  will_return(__wrap_az_platform_clock_msec, 0);
+  will_return(__wrap_az_platform_clock_msec, 30);
+  will_return_count(__wrap_az_platform_clock_msec, 1630, 2);
+  will_return(__wrap_az_platform_clock_msec, 1635);
+  _test_az_http_pipeline_policy_retry_send(
+      &retry_options, test_policy_transport_retry_response_appended);
+
+  az_http_metrics_values values;
+  az_http_metrics_read(&metrics, &values);
+  assert_int_equal(values.requests, 1);
+  assert_int_equal(values.attempts, 2);
+  assert_int_equal(values.retries, 1);
+  assert_int_equal(values.retries_by_status[AZ_HTTP_METRICS_STATUS_REQUEST_TIMEOUT], 1);
+  assert_int_equal(values.retries_by_status[AZ_HTTP_METRICS_STATUS_TOO_MANY_REQUESTS], 0);
+  assert_int_equal(values.bytes_sent, 0);
+  assert_int_equal(values.bytes_received, 2 * az_span_size(retry_response_with_header));
+  assert_int_equal(values.backoff_msec, 1600);
+
+  // 5ms is at most 10ms, 30ms at most 50ms, and 1600ms at most 5000ms.
+  assert_int_equal(values.attempt_latency_histogram[0], 1);
+  assert_int_equal(values.attempt_latency_histogram[1], 1);
+  assert_int_equal(values.backoff_histogram[5], 1);
+  assert_int_equal(values.backoff_histogram[4], 0);
+}
+
 az_result __wrap_az_platform_clock_msec(int64_t* out_clock_msec);
 az_result __wrap_az_platform_clock_msec(int64_t* out_clock_msec)
 {
@@ -370,7 +1427,7 @@ az_result __wrap_az_platform_clock_msec(int64_t* out_clock_msec)
 az_result __wrap_az_platform_sleep_msec(int32_t milliseconds);
 az_result __wrap_az_platform_sleep_msec(int32_t milliseconds)
 {
-  (void)milliseconds;
+  test_policy_last_sleep_msec = milliseconds;
   return AZ_OK;
 }
 
@@ -383,9 +1440,22 @@ int test_az_policy()
     cmocka_unit_test(test_az_http_pipeline_policy_retry),
     cmocka_unit_test(test_az_http_pipeline_policy_retry_with_header),
     cmocka_unit_test(test_az_http_pipeline_policy_retry_with_header_2),
+    cmocka_unit_test(test_az_http_pipeline_process_suspends_retry),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_budget),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_jitter),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_metrics),
 #endif // _az_MOCK_ENABLED
     cmocka_unit_test(test_az_http_pipeline_policy_apiversion),
     cmocka_unit_test(test_az_http_pipeline_policy_telemetry),
+    cmocka_unit_test(test_az_http_pipeline_freeze),
+    cmocka_unit_test(test_az_http_pipeline_share),
+    cmocka_unit_test(test_az_http_pipeline_policy_compression),
+    cmocka_unit_test(test_az_http_pipeline_policy_hedging_delay),
+    cmocka_unit_test(test_az_http_pipeline_policy_rate_limit),
+    cmocka_unit_test(test_az_http_pipeline_policy_circuit_breaker),
+    cmocka_unit_test(test_az_http_pipeline_policy_cache),
+    cmocka_unit_test(test_az_http_pipeline_policy_single_flight),
+    cmocka_unit_test(test_az_http_pipeline_policy_single_flight_headers),
   };
   return cmocka_run_group_tests_name("az_core_policy", tests, NULL, NULL);
 }
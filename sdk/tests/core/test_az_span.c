@@ -92,6 +92,41 @@ static void az_span_to_lower_test(void** state)
   assert_false(az_span_is_content_equal_ignoring_case(a, d));
 }
 
+static void az_span_is_content_equal_ignoring_case_long_test(void** state)
+{
+  (void)state;
+
+  // Compare every pair of byte values at positions handled both eight bytes at a time, and one
+  // byte at a time, within otherwise matching spans.
+  int32_t const positions[] = { 0, 5, 7, 8, 15, 16, 18 };
+  uint8_t buffer1[19];
+  uint8_t buffer2[19];
+
+  for (size_t p = 0; p < _az_COUNTOF(positions); p++)
+  {
+    for (int32_t i = 0; i <= UINT8_MAX; i++)
+    {
+      for (int32_t j = 0; j <= UINT8_MAX; j++)
+      {
+        for (size_t k = 0; k < sizeof(buffer1); k++)
+        {
+          buffer1[k] = (uint8_t)"Content-Type-Header"[k];
+          buffer2[k] = (uint8_t)"cONTENT-tYPE-hEADER"[k];
+        }
+        buffer1[positions[p]] = (uint8_t)i;
+        buffer2[positions[p]] = (uint8_t)j;
+
+        bool const expected = i == j || (('A' <= i && i <= 'Z') && j == i + 32)
+            || (('a' <= i && i <= 'z') && j == i - 32);
+        assert_int_equal(
+            az_span_is_content_equal_ignoring_case(
+                AZ_SPAN_FROM_BUFFER(buffer1), AZ_SPAN_FROM_BUFFER(buffer2)),
+            expected);
+      }
+    }
+  }
+}
+
 static void test_az_span_is_content_equal(void** state)
 {
   (void)state;
@@ -352,6 +387,38 @@ static void az_span_atoi64_test(void** state)
       az_span_atoi64(AZ_SPAN_FROM_STR("-9223372036854775809"), &value), AZ_ERROR_UNEXPECTED_CHAR);
 }
 
+static void az_span_atox_eight_digit_blocks(void** state)
+{
+  (void)state;
+  uint64_t value = 0;
+  uint32_t value32 = 0;
+  int32_t signed_value32 = 0;
+
+  assert_int_equal(az_span_atou64(AZ_SPAN_FROM_STR("12345678"), &value), AZ_OK);
+  assert_int_equal(value, 12345678);
+  assert_int_equal(az_span_atou64(AZ_SPAN_FROM_STR("123456789"), &value), AZ_OK);
+  assert_int_equal(value, 123456789);
+  assert_int_equal(az_span_atou64(AZ_SPAN_FROM_STR("9081726354453627"), &value), AZ_OK);
+  assert_int_equal(value, 9081726354453627UL);
+  assert_int_equal(az_span_atou32(AZ_SPAN_FROM_STR("0000000000000000001"), &value32), AZ_OK);
+  assert_int_equal(value32, 1);
+  assert_int_equal(az_span_atoi32(AZ_SPAN_FROM_STR("-87654321"), &signed_value32), AZ_OK);
+  assert_int_equal(signed_value32, -87654321);
+
+  // Every byte of an eight digit block is validated, including those just outside the digit range.
+  uint8_t const invalid_bytes[] = { '/', ':', ' ', '.', 0x00, 0x80, 0xB0, 0xB9, 0xFF };
+  for (int32_t i = 0; i < 16; i++)
+  {
+    for (size_t j = 0; j < sizeof(invalid_bytes); j++)
+    {
+      uint8_t digits[] = "1234567890123456";
+      digits[i] = invalid_bytes[j];
+      assert_int_equal(
+          az_span_atou64(az_span_create(digits, 16), &value), AZ_ERROR_UNEXPECTED_CHAR);
+    }
+  }
+}
+
 #define TEST_AZ_ISFINITE_HELPER(source, expected)      \
   do                                                   \
   {                                                    \
@@ -638,6 +705,77 @@ static void az_span_atod_test(void** state)
   assert_true(value == 0);
 }
 
+static void az_span_atod_correctly_rounded(void** state)
+{
+  (void)state;
+  double value = 0;
+
+  // Exactly halfway between 1 and the next double, which rounds to even.
+  assert_int_equal(
+      az_span_atod(
+          AZ_SPAN_FROM_STR("1.00000000000000011102230246251565404236316680908203125"), &value),
+      AZ_OK);
+  assert_true(value == 1.0);
+  assert_int_equal(
+      az_span_atod(
+          AZ_SPAN_FROM_STR("1.000000000000000111022302462515654042363166809082031249999"), &value),
+      AZ_OK);
+  assert_true(value == 1.0);
+  assert_int_equal(
+      az_span_atod(
+          AZ_SPAN_FROM_STR("1.000000000000000111022302462515654042363166809082031250001"), &value),
+      AZ_OK);
+  assert_true(value == 1.0000000000000002);
+
+  // Exactly halfway between 2^53 and the next double, which rounds to even, with the
+  // significant digits spread out across the integer and fraction parts.
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("9007199254740993"), &value), AZ_OK);
+  assert_true(value == 9007199254740992.0);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("900719925474099.3e1"), &value), AZ_OK);
+  assert_true(value == 9007199254740992.0);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("9007199254740993.0000000001"), &value), AZ_OK);
+  assert_true(value == 9007199254740994.0);
+
+  // Subnormal numbers, and the boundaries of the range of doubles.
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("4.9406564584124654e-324"), &value), AZ_OK);
+  assert_true(value == 4.9406564584124654e-324);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("2.4703282292062328e-324"), &value), AZ_OK);
+  assert_true(value == 4.9406564584124654e-324);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("2.4703282292062327e-324"), &value), AZ_OK);
+  assert_true(value == 0);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("2.2250738585072011e-308"), &value), AZ_OK);
+  assert_true(value == 2.2250738585072011e-308);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1.7976931348623157e308"), &value), AZ_OK);
+  assert_true(value == 1.7976931348623157e308);
+  assert_int_equal(
+      az_span_atod(AZ_SPAN_FROM_STR("1.7976931348623159e308"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+
+  // Numbers are no longer limited in size.
+  uint8_t buffer[300] = { 0 };
+  memset(buffer, '0', sizeof(buffer));
+  buffer[0] = '1';
+  buffer[150] = '.';
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_BUFFER(buffer), &value), AZ_OK);
+  assert_true(value == 1e149);
+  buffer[0] = '0';
+  buffer[sizeof(buffer) - 1] = '5';
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_BUFFER(buffer), &value), AZ_OK);
+  assert_true(value == 5e-149);
+
+  // Trailing characters, and incomplete fractions or exponents.
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("+.5"), &value), AZ_OK);
+  assert_true(value == 0.5);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("."), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("-."), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1e"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1e+"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("+e1"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1.2.3"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1,5"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("0x10"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1 "), &value), AZ_ERROR_UNEXPECTED_CHAR);
+}
+
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif // __GNUC__
@@ -934,6 +1072,78 @@ static void az_span_find_overlapping_checks_success(void** state)
   assert_int_equal(az_span_find(source, az_span_slice(span, 2, 4)), 1);
 }
 
+// Reference implementation of the naive search, used to validate the results of az_span_find.
+static int32_t _naive_span_find(az_span source, az_span target)
+{
+  int32_t const source_size = az_span_size(source);
+  int32_t const target_size = az_span_size(target);
+  for (int32_t i = 0; i + target_size <= source_size; i++)
+  {
+    if (memcmp(az_span_ptr(source) + i, az_span_ptr(target), (size_t)target_size) == 0)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void az_span_find_long_source_window_boundaries_success(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[100];
+  memset(buffer, 'a', sizeof(buffer));
+  az_span source = AZ_SPAN_FROM_BUFFER(buffer);
+
+  // Target found at every position, including those crossing 16 and 32 byte windows.
+  int32_t const positions[] = { 0, 14, 15, 16, 17, 31, 32, 33, 47, 63, 64, 90, 95 };
+  for (size_t p = 0; p < sizeof(positions) / sizeof(positions[0]); p++)
+  {
+    buffer[positions[p]] = 'x';
+    buffer[positions[p] + 4] = 'y';
+
+    assert_int_equal(az_span_find(source, AZ_SPAN_FROM_STR("xaaay")), positions[p]);
+    assert_int_equal(az_span_find(source, AZ_SPAN_FROM_STR("x")), positions[p]);
+    assert_int_equal(az_span_find(source, AZ_SPAN_FROM_STR("xa")), positions[p]);
+    assert_int_equal(az_span_find(source, AZ_SPAN_FROM_STR("xaaaz")), -1);
+
+    buffer[positions[p]] = 'a';
+    buffer[positions[p] + 4] = 'a';
+  }
+
+  // Target at the very end of the source.
+  buffer[98] = 'x';
+  buffer[99] = 'y';
+  assert_int_equal(az_span_find(source, AZ_SPAN_FROM_STR("xy")), 98);
+  assert_int_equal(az_span_find(source, AZ_SPAN_FROM_STR("y")), 99);
+  assert_int_equal(az_span_find(source, AZ_SPAN_FROM_STR("ay")), -1);
+}
+
+static void az_span_find_matches_naive_search_success(void** state)
+{
+  (void)state;
+
+  // Small alphabet to produce many partial (first and last byte) matches.
+  uint8_t buffer[80];
+  for (int32_t i = 0; i < (int32_t)sizeof(buffer); i++)
+  {
+    buffer[i] = (uint8_t)('a' + ((i * 7 + i / 5) % 3));
+  }
+
+  for (int32_t source_size = 0; source_size <= (int32_t)sizeof(buffer); source_size++)
+  {
+    az_span source = az_span_create(buffer, source_size);
+    for (int32_t target_start = 0; target_start < 40; target_start++)
+    {
+      for (int32_t target_size = 1; target_size <= 12; target_size++)
+      {
+        az_span target = az_span_create(buffer + target_start, target_size);
+        assert_int_equal(az_span_find(source, target), _naive_span_find(source, target));
+      }
+    }
+  }
+}
+
 static void az_span_i64toa_test(void** state)
 {
   (void)state;
@@ -1134,6 +1344,47 @@ static void az_span_i32toa_overflow_fails(void** state)
   assert_true(az_span_i32toa(buffer, v, &out_span) == AZ_ERROR_NOT_ENOUGH_SPACE);
 }
 
+static void _az_span_u64toa_check(uint64_t value, az_span expected)
+{
+  uint8_t raw_buffer[_az_MAX_SIZE_FOR_UINT64];
+  az_span buffer = AZ_SPAN_FROM_BUFFER(raw_buffer);
+  az_span out_span;
+
+  assert_int_equal(az_span_u64toa(buffer, value, &out_span), AZ_OK);
+  assert_int_equal(az_span_size(out_span), az_span_size(buffer) - az_span_size(expected));
+  assert_true(az_span_is_content_equal(
+      az_span_slice(buffer, 0, az_span_size(expected)), expected));
+  assert_int_equal(
+      az_span_u64toa(az_span_slice(buffer, 0, az_span_size(expected) - 1), value, &out_span),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void az_span_u64toa_digit_count_boundaries_succeeds(void** state)
+{
+  (void)state;
+  uint8_t ones[_az_MAX_SIZE_FOR_UINT64];
+  uint8_t nines[_az_MAX_SIZE_FOR_UINT64];
+  uint64_t power_of_ten = 1;
+
+  // Check 10^k and 10^(k+1) - 1, the smallest and largest numbers with k+1 digits.
+  for (int32_t digit_count = 1; digit_count < _az_MAX_SIZE_FOR_UINT64; digit_count++)
+  {
+    ones[0] = '1';
+    for (int32_t i = 0; i < digit_count; i++)
+    {
+      ones[i + 1] = '0';
+      nines[i] = '9';
+    }
+
+    _az_span_u64toa_check(power_of_ten, az_span_create(ones, digit_count));
+    _az_span_u64toa_check(power_of_ten * 10 - 1, az_span_create(nines, digit_count));
+    power_of_ten *= 10;
+  }
+
+  _az_span_u64toa_check(power_of_ten, AZ_SPAN_FROM_STR("10000000000000000000"));
+  _az_span_u64toa_check(UINT64_MAX, AZ_SPAN_FROM_STR("18446744073709551615"));
+}
+
 static void az_span_u32toa_succeeds(void** state)
 {
   (void)state;
@@ -1343,6 +1594,77 @@ static void az_span_dtoa_succeeds(void** state)
   AZ_SPAN_DTOA_SUCCEEDS_HELPER(1e-300, 2, AZ_SPAN_FROM_STR("0"));
 }
 
+#define AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(v, expected)                              \
+  do                                                                                    \
+  {                                                                                     \
+    double const value = v;                                                             \
+    uint8_t raw_buffer[25] = { 0 };                                                     \
+    az_span buffer = AZ_SPAN_FROM_BUFFER(raw_buffer);                                   \
+    az_span out_span = AZ_SPAN_EMPTY;                                                   \
+    assert_int_equal(az_span_dtoa_shortest(buffer, value, &out_span), AZ_OK);           \
+    az_span output = az_span_slice(buffer, 0, _az_span_diff(out_span, buffer));         \
+    assert_int_equal(az_span_size(output), az_span_size(expected));                     \
+    assert_memory_equal(                                                                \
+        az_span_ptr(output), az_span_ptr(expected), (size_t)az_span_size(expected));    \
+    double round_trip = 0;                                                              \
+    assert_int_equal(az_span_atod(output, &round_trip), AZ_OK);                         \
+    assert_memory_equal(&round_trip, &value, sizeof(value));                            \
+    assert_int_equal(                                                                   \
+        az_span_dtoa_shortest(az_span_slice(buffer, 0, az_span_size(expected) - 1),     \
+                              value,                                                    \
+                              &out_span),                                               \
+        AZ_ERROR_NOT_ENOUGH_SPACE);                                                     \
+  } while (0)
+
+static void az_span_dtoa_shortest_succeeds(void** state)
+{
+  (void)state;
+
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.0, AZ_SPAN_FROM_STR("0"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-0.0, AZ_SPAN_FROM_STR("-0"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1.0, AZ_SPAN_FROM_STR("1"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-1.5, AZ_SPAN_FROM_STR("-1.5"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.1, AZ_SPAN_FROM_STR("0.1"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.1 + 0.2, AZ_SPAN_FROM_STR("0.30000000000000004"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(12.1, AZ_SPAN_FROM_STR("12.1"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(23.75, AZ_SPAN_FROM_STR("23.75"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1000.0, AZ_SPAN_FROM_STR("1000"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(123456789.125, AZ_SPAN_FROM_STR("123456789.125"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(9007199254740993.0, AZ_SPAN_FROM_STR("9007199254740992"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1e20, AZ_SPAN_FROM_STR("100000000000000000000"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1e21, AZ_SPAN_FROM_STR("1e+21"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-1.25e100, AZ_SPAN_FROM_STR("-1.25e+100"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.000001, AZ_SPAN_FROM_STR("0.000001"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-0.0000012345, AZ_SPAN_FROM_STR("-0.0000012345"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1e-7, AZ_SPAN_FROM_STR("1e-7"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1.5e-10, AZ_SPAN_FROM_STR("1.5e-10"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1e-300, AZ_SPAN_FROM_STR("1e-300"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(5e-324, AZ_SPAN_FROM_STR("5e-324"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(
+      -2.2250738585072014e-308, AZ_SPAN_FROM_STR("-2.2250738585072014e-308"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(
+      1.7976931348623157e308, AZ_SPAN_FROM_STR("1.7976931348623157e+308"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(
+      -0.0000012345678901234567, AZ_SPAN_FROM_STR("-0.0000012345678901234567"));
+}
+
+static void az_span_dtoa_shortest_non_finite_fails(void** state)
+{
+  (void)state;
+  uint8_t raw_buffer[25] = { 0 };
+  az_span out_span = AZ_SPAN_EMPTY;
+
+  assert_int_equal(
+      az_span_dtoa_shortest(AZ_SPAN_FROM_BUFFER(raw_buffer), HUGE_VAL, &out_span),
+      AZ_ERROR_NOT_SUPPORTED);
+  assert_int_equal(
+      az_span_dtoa_shortest(AZ_SPAN_FROM_BUFFER(raw_buffer), -HUGE_VAL, &out_span),
+      AZ_ERROR_NOT_SUPPORTED);
+  assert_int_equal(
+      az_span_dtoa_shortest(AZ_SPAN_FROM_BUFFER(raw_buffer), HUGE_VAL - HUGE_VAL, &out_span),
+      AZ_ERROR_NOT_SUPPORTED);
+}
+
 static void az_span_dtoa_overflow_fails(void** state)
 {
   (void)state;
@@ -1747,6 +2069,234 @@ static void test_az_span_token_success(void** state)
   assert_true(az_span_ptr(token) == az_span_ptr(span));
   assert_int_equal(az_span_size(token), 4);
   assert_true(az_span_size(out_span) == 0);
+
+  // token: "" (end of span)
+  span = out_span;
+
+  token = _az_span_token(span, delim, &out_span, &index);
+  assert_int_equal(index, -1);
+  assert_int_equal(az_span_size(token), 0);
+  assert_int_equal(az_span_size(out_span), 0);
+}
+
+static void test_az_span_builder(void** state)
+{
+  (void)state;
+  uint8_t buffer[64] = { 0 };
+  az_span out_span = { 0 };
+
+  az_span_builder builder = az_span_builder_create(AZ_SPAN_FROM_BUFFER(buffer));
+  az_span_builder_append(&builder, AZ_SPAN_FROM_STR("n="));
+  az_span_builder_append_i32(&builder, -42);
+  az_span_builder_append_u8(&builder, '&');
+  az_span_builder_append_u32(&builder, 4294967295U);
+  az_span_builder_append_u8(&builder, '&');
+  az_span_builder_append_i64(&builder, INT64_MIN);
+  az_span_builder_append_u8(&builder, '&');
+  az_span_builder_append_url_encoded(&builder, AZ_SPAN_FROM_STR("a b/c"));
+  assert_return_code(az_span_builder_get_span(&builder, &out_span), AZ_OK);
+  assert_true(az_span_is_content_equal(
+      out_span, AZ_SPAN_FROM_STR("n=-42&4294967295&-9223372036854775808&a%20b%2Fc")));
+  assert_int_equal(az_span_builder_get_length(&builder), az_span_size(out_span));
+
+  // Appending past the end writes nothing more, but the length keeps being counted.
+  uint8_t small_buffer[8] = { 0 };
+  builder = az_span_builder_create(az_span_create(small_buffer, 4));
+  az_span_builder_append(&builder, AZ_SPAN_FROM_STR("abc"));
+  az_span_builder_append_u64(&builder, 12345);
+  az_span_builder_append_url_encoded(&builder, AZ_SPAN_FROM_STR("/"));
+  assert_int_equal(az_span_builder_get_length(&builder), 11);
+  assert_int_equal(az_span_builder_get_span(&builder, &out_span), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(small_buffer[4], 0);
+
+  // A builder over AZ_SPAN_EMPTY only measures.
+  builder = az_span_builder_create(AZ_SPAN_EMPTY);
+  az_span_builder_append(&builder, AZ_SPAN_FROM_STR("n="));
+  az_span_builder_append_i64(&builder, -1);
+  az_span_builder_append_url_encoded(&builder, AZ_SPAN_FROM_STR("a b"));
+  assert_int_equal(az_span_builder_get_length(&builder), 9);
+}
+
+static void test_az_span_base64(void** state)
+{
+  (void)state;
+  // The test vectors of RFC 4648, section 10.
+  az_span const decoded[] = {
+    AZ_SPAN_FROM_STR(""),     AZ_SPAN_FROM_STR("f"),     AZ_SPAN_FROM_STR("fo"),
+    AZ_SPAN_FROM_STR("foo"),  AZ_SPAN_FROM_STR("foob"),  AZ_SPAN_FROM_STR("fooba"),
+    AZ_SPAN_FROM_STR("foobar"),
+  };
+  az_span const encoded[] = {
+    AZ_SPAN_FROM_STR(""),         AZ_SPAN_FROM_STR("Zg=="),     AZ_SPAN_FROM_STR("Zm8="),
+    AZ_SPAN_FROM_STR("Zm9v"),     AZ_SPAN_FROM_STR("Zm9vYg=="), AZ_SPAN_FROM_STR("Zm9vYmE="),
+    AZ_SPAN_FROM_STR("Zm9vYmFy"),
+  };
+  az_span const url_encoded[] = {
+    AZ_SPAN_FROM_STR(""),     AZ_SPAN_FROM_STR("Zg"),     AZ_SPAN_FROM_STR("Zm8"),
+    AZ_SPAN_FROM_STR("Zm9v"), AZ_SPAN_FROM_STR("Zm9vYg"), AZ_SPAN_FROM_STR("Zm9vYmE"),
+    AZ_SPAN_FROM_STR("Zm9vYmFy"),
+  };
+
+  uint8_t buffer[256] = { 0 };
+  int32_t written = 0;
+  for (size_t i = 0; i < sizeof(decoded) / sizeof(decoded[0]); i++)
+  {
+    assert_return_code(
+        az_span_base64_encode(AZ_SPAN_FROM_BUFFER(buffer), decoded[i], &written), AZ_OK);
+    assert_true(az_span_is_content_equal(az_span_create(buffer, written), encoded[i]));
+    assert_return_code(
+        az_span_base64_decode(AZ_SPAN_FROM_BUFFER(buffer), encoded[i], &written), AZ_OK);
+    assert_true(az_span_is_content_equal(az_span_create(buffer, written), decoded[i]));
+
+    assert_return_code(
+        az_span_base64url_encode(AZ_SPAN_FROM_BUFFER(buffer), decoded[i], &written), AZ_OK);
+    assert_true(az_span_is_content_equal(az_span_create(buffer, written), url_encoded[i]));
+    assert_return_code(
+        az_span_base64url_decode(AZ_SPAN_FROM_BUFFER(buffer), url_encoded[i], &written), AZ_OK);
+    assert_true(az_span_is_content_equal(az_span_create(buffer, written), decoded[i]));
+    assert_return_code(
+        az_span_base64url_decode(AZ_SPAN_FROM_BUFFER(buffer), encoded[i], &written), AZ_OK);
+    assert_true(az_span_is_content_equal(az_span_create(buffer, written), decoded[i]));
+  }
+
+  // Every byte value, long enough to go through the vectorized blocks, and through both alphabets.
+  uint8_t bytes[96] = { 0 };
+  for (size_t i = 0; i < sizeof(bytes); i++)
+  {
+    bytes[i] = (uint8_t)(i * 0xA7);
+  }
+
+  uint8_t text[128] = { 0 };
+  assert_return_code(
+      az_span_base64_encode(AZ_SPAN_FROM_BUFFER(text), AZ_SPAN_FROM_BUFFER(bytes), &written),
+      AZ_OK);
+  assert_int_equal(written, 128);
+  assert_return_code(
+      az_span_base64_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_BUFFER(text), &written),
+      AZ_OK);
+  assert_true(
+      az_span_is_content_equal(az_span_create(buffer, written), AZ_SPAN_FROM_BUFFER(bytes)));
+
+  assert_return_code(
+      az_span_base64url_encode(AZ_SPAN_FROM_BUFFER(text), AZ_SPAN_FROM_BUFFER(bytes), &written),
+      AZ_OK);
+  assert_int_equal(az_span_find(AZ_SPAN_FROM_BUFFER(text), AZ_SPAN_FROM_STR("+")), -1);
+  assert_int_equal(az_span_find(AZ_SPAN_FROM_BUFFER(text), AZ_SPAN_FROM_STR("/")), -1);
+  assert_return_code(
+      az_span_base64url_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_BUFFER(text), &written),
+      AZ_OK);
+  assert_true(
+      az_span_is_content_equal(az_span_create(buffer, written), AZ_SPAN_FROM_BUFFER(bytes)));
+
+  // A character of the other alphabet, or past ASCII, late in a long text.
+  text[100] = '-';
+  assert_int_equal(
+      az_span_base64_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_BUFFER(text), &written),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  text[100] = 0xC3;
+  assert_int_equal(
+      az_span_base64url_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_BUFFER(text), &written),
+      AZ_ERROR_UNEXPECTED_CHAR);
+
+  assert_int_equal(
+      az_span_base64_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_STR("Zm9vYg"), &written),
+      AZ_ERROR_UNEXPECTED_END);
+  assert_int_equal(
+      az_span_base64url_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_STR("Zm9vY"), &written),
+      AZ_ERROR_UNEXPECTED_END);
+  assert_int_equal(
+      az_span_base64url_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_STR("Zm+v"), &written),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(
+      az_span_base64url_encode(az_span_create(buffer, 6), AZ_SPAN_FROM_STR("fooba"), &written),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_span_base64url_decode(az_span_create(buffer, 4), AZ_SPAN_FROM_STR("Zm9vYmE"), &written),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void test_az_span_iso8601(void** state)
+{
+  (void)state;
+
+  // The epoch, a leap day, the times just before the epoch, and the first and last supported ones.
+  struct
+  {
+    int64_t unix_time_msec;
+    char* timestamp;
+  } const cases[] = {
+    { 0, "1970-01-01T00:00:00.000Z" },
+    { 1602744332522LL, "2020-10-15T06:45:32.522Z" },
+    { 951825600001LL, "2000-02-29T12:00:00.001Z" },
+    { -1, "1969-12-31T23:59:59.999Z" },
+    { -86400000LL, "1969-12-31T00:00:00.000Z" },
+    { -62167219200000LL, "0000-01-01T00:00:00.000Z" },
+    { -62162121600000LL, "0000-02-29T00:00:00.000Z" },
+    { 253402300799999LL, "9999-12-31T23:59:59.999Z" },
+  };
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    uint8_t buffer[30] = { 0 };
+    az_span remainder = AZ_SPAN_EMPTY;
+    TEST_EXPECT_SUCCESS(
+        az_span_format_iso8601(AZ_SPAN_FROM_BUFFER(buffer), cases[i].unix_time_msec, &remainder));
+    assert_int_equal(az_span_size(remainder), 6);
+    az_span const timestamp = az_span_create_from_str(cases[i].timestamp);
+    assert_true(az_span_is_content_equal(az_span_create(buffer, 24), timestamp));
+
+    int64_t unix_time_msec = 0;
+    TEST_EXPECT_SUCCESS(az_span_parse_iso8601(timestamp, &unix_time_msec));
+    assert_int_equal(unix_time_msec, cases[i].unix_time_msec);
+  }
+
+  uint8_t buffer[24] = { 0 };
+  az_span remainder = AZ_SPAN_EMPTY;
+  assert_int_equal(
+      az_span_format_iso8601(az_span_create(buffer, 23), 0, &remainder),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_span_format_iso8601(AZ_SPAN_FROM_BUFFER(buffer), -62167219200001LL, &remainder),
+      AZ_ERROR_ARG);
+  assert_int_equal(
+      az_span_format_iso8601(AZ_SPAN_FROM_BUFFER(buffer), 253402300800000LL, &remainder),
+      AZ_ERROR_ARG);
+
+  // The fraction of a second is optional, and truncated to milliseconds.
+  int64_t unix_time_msec = 0;
+  TEST_EXPECT_SUCCESS(
+      az_span_parse_iso8601(AZ_SPAN_FROM_STR("2020-10-15T06:45:32Z"), &unix_time_msec));
+  assert_int_equal(unix_time_msec, 1602744332000LL);
+  TEST_EXPECT_SUCCESS(
+      az_span_parse_iso8601(AZ_SPAN_FROM_STR("2020-10-15T06:45:32.5229Z"), &unix_time_msec));
+  assert_int_equal(unix_time_msec, 1602744332522LL);
+  TEST_EXPECT_SUCCESS(
+      az_span_parse_iso8601(AZ_SPAN_FROM_STR("2020-10-15T06:45:32.5Z"), &unix_time_msec));
+  assert_int_equal(unix_time_msec, 1602744332500LL);
+
+  // Dates and times that don't exist, and other formats.
+  az_span const invalid_timestamps[] = {
+    AZ_SPAN_LITERAL_FROM_STR("2021-02-29T00:00:00Z"),
+    AZ_SPAN_LITERAL_FROM_STR("1900-02-29T00:00:00Z"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-04-31T00:00:00Z"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-00-01T00:00:00Z"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-13-01T00:00:00Z"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-01-00T00:00:00Z"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-01-01T24:00:00Z"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-01-01T00:60:00Z"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-01-01T00:00:60Z"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-01-01T00:00:00.Z"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-01-01T00:00:00"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-01-01T00:00:00+01:00"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-01-01 00:00:00Z"),
+    AZ_SPAN_LITERAL_FROM_STR("2020-1-01T00:00:00.000Z"),
+    AZ_SPAN_LITERAL_FROM_STR("20-01-01T00:00:00Z"),
+  };
+  for (size_t i = 0; i < sizeof(invalid_timestamps) / sizeof(invalid_timestamps[0]); i++)
+  {
+    assert_int_equal(
+        az_span_parse_iso8601(invalid_timestamps[i], &unix_time_msec), AZ_ERROR_UNEXPECTED_CHAR);
+  }
 }
 
 int test_az_span()
@@ -1756,6 +2306,7 @@ int test_az_span()
     cmocka_unit_test(test_az_span_getters),
     cmocka_unit_test(az_single_char_ascii_lower_test),
     cmocka_unit_test(az_span_to_lower_test),
+    cmocka_unit_test(az_span_is_content_equal_ignoring_case_long_test),
     cmocka_unit_test(az_span_to_str_test),
     cmocka_unit_test(test_az_span_is_content_equal),
     cmocka_unit_test(az_span_find_beginning_success),
@@ -1771,13 +2322,17 @@ int test_az_span()
     cmocka_unit_test(az_span_find_embedded_NULLs_success),
     cmocka_unit_test(az_span_find_capacity_checks_success),
     cmocka_unit_test(az_span_find_overlapping_checks_success),
+    cmocka_unit_test(az_span_find_long_source_window_boundaries_success),
+    cmocka_unit_test(az_span_find_matches_naive_search_success),
     cmocka_unit_test(az_span_atox_return_errors),
     cmocka_unit_test(az_span_atou32_test),
     cmocka_unit_test(az_span_atoi32_test),
     cmocka_unit_test(az_span_atou64_test),
     cmocka_unit_test(az_span_atoi64_test),
+    cmocka_unit_test(az_span_atox_eight_digit_blocks),
     cmocka_unit_test(test_az_isfinite),
     cmocka_unit_test(az_span_atod_test),
+    cmocka_unit_test(az_span_atod_correctly_rounded),
     cmocka_unit_test(az_span_atod_non_finite_not_allowed),
     cmocka_unit_test(az_span_ato_number_whitespace_or_invalid_not_allowed),
     cmocka_unit_test(az_span_ato_number_no_out_of_bounds_reads),
@@ -1791,12 +2346,15 @@ int test_az_span()
     cmocka_unit_test(az_span_i32toa_max_int_succeeds),
     cmocka_unit_test(az_span_i32toa_zero_succeeds),
     cmocka_unit_test(az_span_i32toa_overflow_fails),
+    cmocka_unit_test(az_span_u64toa_digit_count_boundaries_succeeds),
     cmocka_unit_test(az_span_u32toa_succeeds),
     cmocka_unit_test(az_span_u32toa_zero_succeeds),
     cmocka_unit_test(az_span_u32toa_max_uint_succeeds),
     cmocka_unit_test(az_span_u32toa_overflow_fails),
     cmocka_unit_test(az_span_dtoa_succeeds),
     cmocka_unit_test(az_span_dtoa_overflow_fails),
+    cmocka_unit_test(az_span_dtoa_shortest_succeeds),
+    cmocka_unit_test(az_span_dtoa_shortest_non_finite_fails),
     cmocka_unit_test(az_span_dtoa_too_large),
     cmocka_unit_test(az_span_copy_empty),
     cmocka_unit_test(test_az_span_is_valid),
@@ -1810,6 +2368,9 @@ int test_az_span()
     cmocka_unit_test(az_span_trim_zero),
     cmocka_unit_test(az_span_trim_null),
     cmocka_unit_test(test_az_span_token_success),
+    cmocka_unit_test(test_az_span_builder),
+    cmocka_unit_test(test_az_span_base64),
+    cmocka_unit_test(test_az_span_iso8601),
     cmocka_unit_test(az_span_trim_start),
     cmocka_unit_test(az_span_trim_end),
     cmocka_unit_test(az_span_trim_unicode),
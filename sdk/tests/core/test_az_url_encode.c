@@ -101,7 +101,7 @@ static void test_url_encode_basic(void** state)
         _az_span_url_encode(buffer2, AZ_SPAN_FROM_STR("/"), &url_length)
         == AZ_ERROR_NOT_ENOUGH_SPACE);
 
-    assert_int_equal(url_length, 0);
+    assert_int_equal(url_length, sizeof("%2F") - 1);
     assert_true(az_span_is_content_equal(
         AZ_SPAN_FROM_BUFFER(buf20), AZ_SPAN_FROM_STR("********************")));
   }
@@ -170,7 +170,7 @@ static void test_url_encode_basic(void** state)
         _az_span_url_encode(buffer10, AZ_SPAN_FROM_STR("AbC///"), &url_length)
         == AZ_ERROR_NOT_ENOUGH_SPACE);
 
-    assert_int_equal(url_length, 0);
+    assert_int_equal(url_length, sizeof("AbC%2F%2F%2F") - 1);
     assert_true(az_span_is_content_equal(
         AZ_SPAN_FROM_BUFFER(buf20), AZ_SPAN_FROM_STR("AbC%2F%2F***********")));
   }
@@ -189,7 +189,7 @@ static void test_url_encode_basic(void** state)
         _az_span_url_encode(buffer11, AZ_SPAN_FROM_STR("AbC///"), &url_length)
         == AZ_ERROR_NOT_ENOUGH_SPACE);
 
-    assert_int_equal(url_length, 0);
+    assert_int_equal(url_length, sizeof("AbC%2F%2F%2F") - 1);
     assert_true(az_span_is_content_equal(
         AZ_SPAN_FROM_BUFFER(buf20), AZ_SPAN_FROM_STR("AbC%2F%2F***********")));
   }
@@ -267,7 +267,7 @@ static void test_url_encode_preconditions(void** state)
           _az_span_url_encode(buffer5, AZ_SPAN_FROM_STR("1234567890"), &url_length)
           == AZ_ERROR_NOT_ENOUGH_SPACE);
 
-      assert_int_equal(url_length, 0);
+      assert_int_equal(url_length, sizeof("1234567890") - 1);
       assert_true(az_span_is_content_equal(buffer5, AZ_SPAN_FROM_STR("12345")));
     }
     {
@@ -475,6 +475,64 @@ static void test_url_encode_full(void** state)
                        "****")));
 }
 
+static void test_url_encode_long_runs(void** state)
+{
+  // Put each byte value at every position of long runs of unreserved characters, so that every
+  // lane of the block-at-a-time scanning is covered.
+  (void)state;
+
+  uint8_t source_buffer[70];
+  uint8_t encoded_buffer[_az_COUNTOF(source_buffer) + 2];
+  az_span const source = AZ_SPAN_FROM_BUFFER(source_buffer);
+
+  for (int32_t value = 0; value < 256; value++)
+  {
+    bool const should_encode = !(
+        ('0' <= value && value <= '9') || ('A' <= value && value <= 'Z')
+        || ('a' <= value && value <= 'z') || value == '-' || value == '.' || value == '_'
+        || value == '~');
+    int32_t const expected_length = az_span_size(source) + (should_encode ? 2 : 0);
+
+    for (int32_t position = 0; position < az_span_size(source); position++)
+    {
+      for (int32_t i = 0; i < az_span_size(source); i++)
+      {
+        source_buffer[i] = (uint8_t)"Az09-._~"[i % 8];
+      }
+      source_buffer[position] = (uint8_t)value;
+
+      assert_int_equal(_az_span_url_encode_calc_length(source), expected_length);
+
+      int32_t url_length = 0xFF;
+      assert_true(az_result_succeeded(
+          _az_span_url_encode(AZ_SPAN_FROM_BUFFER(encoded_buffer), source, &url_length)));
+      assert_int_equal(url_length, expected_length);
+
+      assert_memory_equal(encoded_buffer, source_buffer, (size_t)position);
+      if (should_encode)
+      {
+        assert_int_equal(encoded_buffer[position], '%');
+        assert_memory_equal(
+            encoded_buffer + position + 3,
+            source_buffer + position + 1,
+            (size_t)(az_span_size(source) - position - 1));
+
+        // One byte short of the required size is not enough, which still reports the size needed.
+        url_length = 0xFF;
+        assert_int_equal(
+            _az_span_url_encode(
+                az_span_create(encoded_buffer, expected_length - 1), source, &url_length),
+            AZ_ERROR_NOT_ENOUGH_SPACE);
+        assert_int_equal(url_length, expected_length);
+      }
+      else
+      {
+        assert_memory_equal(encoded_buffer, source_buffer, sizeof(source_buffer));
+      }
+    }
+  }
+}
+
 int test_az_url_encode()
 {
   struct CMUnitTest const tests[] = {
@@ -482,6 +540,7 @@ int test_az_url_encode()
     cmocka_unit_test(test_url_encode_preconditions),
     cmocka_unit_test(test_url_encode_usage),
     cmocka_unit_test(test_url_encode_full),
+    cmocka_unit_test(test_url_encode_long_runs),
   };
 
   return cmocka_run_group_tests_name("az_core_encode", tests, NULL, NULL);
@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#ifndef _az_FUZZ_H
+#define _az_FUZZ_H
+
+#include <azure/core/az_span.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Runs one input through the parser of a harness.
+ *
+ * @details This is the entry point of libFuzzer, which AFL and the replay driver of
+ * az_fuzz_main.c call as well. It returns 0 whatever the result of the parser, crashes and
+ * sanitizer reports being the only failures.
+ *
+ * @param[in] data The input.
+ * @param[in] size The size of \p data, in bytes.
+ * @return 0.
+ */
+int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size);
+
+/**
+ * @brief The precondition callback of the harnesses.
+ *
+ * @details A harness failing a precondition is a bug of the parser it runs, since no input should
+ * get there: this crashes, rather than spin forever as the default callback does.
+ */
+void az_fuzz_precondition_failed(void);
+
+/**
+ * @brief Returns the input of a harness as an #az_span, truncated to the largest size an #az_span
+ * can have.
+ */
+AZ_INLINE az_span az_fuzz_span(uint8_t const* data, size_t size)
+{
+  return az_span_create((uint8_t*)(uintptr_t)data, size > INT32_MAX ? INT32_MAX : (int32_t)size);
+}
+
+#endif // _az_FUZZ_H
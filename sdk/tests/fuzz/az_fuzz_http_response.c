@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_fuzz.h"
+
+#include <azure/core/az_http.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <azure/core/_az_cfg.h>
+
+// Accumulates values read from the response, so that the compiler can't discard the getters.
+static volatile uint64_t az_fuzz_http_sink;
+
+int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size)
+{
+  if (size < 1 || size > INT32_MAX)
+  {
+    return 0;
+  }
+
+  // The response is parsed in place, in a buffer it owns.
+  uint8_t* const buffer = (uint8_t*)malloc(size);
+  if (buffer == NULL)
+  {
+    return 0;
+  }
+
+  memcpy(buffer, data, size);
+
+  az_http_response response;
+  if (az_result_succeeded(az_http_response_init(&response, az_span_create(buffer, (int32_t)size))))
+  {
+    az_http_response_status_line status_line = { 0 };
+    if (az_result_succeeded(az_http_response_get_status_line(&response, &status_line)))
+    {
+      az_fuzz_http_sink += (uint64_t)status_line.status_code;
+
+      az_span name = AZ_SPAN_EMPTY;
+      az_span value = AZ_SPAN_EMPTY;
+      while (az_result_succeeded(az_http_response_get_next_header(&response, &name, &value)))
+      {
+        az_fuzz_http_sink += (uint64_t)az_span_size(name) + (uint64_t)az_span_size(value);
+      }
+
+      az_span body = AZ_SPAN_EMPTY;
+      if (az_result_succeeded(az_http_response_get_body(&response, &body)))
+      {
+        az_fuzz_http_sink += (uint64_t)az_span_size(body);
+      }
+    }
+  }
+
+  free(buffer);
+  return 0;
+}
@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_fuzz.h"
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/iot/az_iot_common.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+// Accumulates values read from the topics, so that the compiler can't discard the parsers.
+static volatile uint64_t az_fuzz_hub_sink;
+
+static az_iot_hub_client az_fuzz_hub_client;
+static bool az_fuzz_hub_client_initialized = false;
+
+int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size)
+{
+  az_span const topic = az_fuzz_span(data, size);
+  if (az_span_size(topic) < 1)
+  {
+    return 0;
+  }
+
+  if (!az_fuzz_hub_client_initialized)
+  {
+    if (az_result_failed(az_iot_hub_client_init(
+            &az_fuzz_hub_client,
+            AZ_SPAN_FROM_STR("contoso.azure-devices.net"),
+            AZ_SPAN_FROM_STR("my_device"),
+            NULL)))
+    {
+      return 0;
+    }
+
+    az_fuzz_hub_client_initialized = true;
+  }
+
+  az_iot_hub_client_c2d_request c2d_request;
+  if (az_result_succeeded(
+          az_iot_hub_client_c2d_parse_received_topic(&az_fuzz_hub_client, topic, &c2d_request)))
+  {
+    az_span value = AZ_SPAN_EMPTY;
+    az_fuzz_hub_sink += (uint64_t)(az_iot_message_properties_find(
+                                       &c2d_request.properties, AZ_SPAN_FROM_STR("missing"), &value)
+                                   == AZ_OK);
+
+    az_span name = AZ_SPAN_EMPTY;
+    while (az_result_succeeded(
+        az_iot_message_properties_next(&c2d_request.properties, &name, &value)))
+    {
+      az_fuzz_hub_sink += (uint64_t)az_span_size(name) + (uint64_t)az_span_size(value);
+    }
+  }
+
+  az_iot_hub_client_method_request method_request;
+  if (az_result_succeeded(az_iot_hub_client_methods_parse_received_topic(
+          &az_fuzz_hub_client, topic, &method_request)))
+  {
+    az_fuzz_hub_sink += (uint64_t)az_span_size(method_request.name);
+  }
+
+  az_iot_hub_client_twin_response twin_response;
+  if (az_result_succeeded(
+          az_iot_hub_client_twin_parse_received_topic(&az_fuzz_hub_client, topic, &twin_response)))
+  {
+    az_fuzz_hub_sink += (uint64_t)twin_response.status;
+  }
+
+  az_iot_hub_client_topic parsed;
+  if (az_result_succeeded(az_iot_hub_client_topic_parse(&az_fuzz_hub_client, topic, &parsed)))
+  {
+    az_fuzz_hub_sink += (uint64_t)parsed.type;
+  }
+
+  return 0;
+}
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_fuzz.h"
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/iot/az_iot_provisioning_client.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+// Accumulates values read from the responses, so that the compiler can't discard the parser.
+static volatile uint64_t az_fuzz_provisioning_sink;
+
+static az_iot_provisioning_client az_fuzz_provisioning_client;
+static bool az_fuzz_provisioning_client_initialized = false;
+
+// The input is the topic, a line feed, and the payload. An input without a line feed is a topic
+// with an empty payload.
+int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size)
+{
+  az_span const input = az_fuzz_span(data, size);
+
+  if (!az_fuzz_provisioning_client_initialized)
+  {
+    if (az_result_failed(az_iot_provisioning_client_init(
+            &az_fuzz_provisioning_client,
+            AZ_SPAN_FROM_STR("global.azure-devices-provisioning.net"),
+            AZ_SPAN_FROM_STR("0ne00000000"),
+            AZ_SPAN_FROM_STR("my-registration-id"),
+            NULL)))
+    {
+      return 0;
+    }
+
+    az_fuzz_provisioning_client_initialized = true;
+  }
+
+  int32_t const separator = az_span_find(input, AZ_SPAN_FROM_STR("\n"));
+  az_span const topic = separator < 0 ? input : az_span_slice(input, 0, separator);
+  // The parser takes an empty payload that still points somewhere, rather than AZ_SPAN_EMPTY.
+  az_span const payload
+      = az_span_slice_to_end(input, separator < 0 ? az_span_size(input) : separator + 1);
+
+  az_iot_provisioning_client_register_response response;
+  if (az_result_succeeded(az_iot_provisioning_client_parse_received_topic_and_payload(
+          &az_fuzz_provisioning_client, topic, payload, &response)))
+  {
+    az_fuzz_provisioning_sink += (uint64_t)response.status + (uint64_t)response.retry_after_seconds
+        + (uint64_t)az_iot_provisioning_client_operation_complete(response.operation_status);
+  }
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_fuzz.h"
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  // The input is also read split into this many buffers, so that tokens straddle them.
+  AZ_FUZZ_JSON_CHUNKS = 7,
+};
+
+// Accumulates values read from the tokens, so that the compiler can't discard the getters.
+static volatile uint64_t az_fuzz_json_sink;
+
+static void az_fuzz_json_read_all(az_json_reader* ref_reader)
+{
+  char string_buffer[64];
+  while (az_result_succeeded(az_json_reader_next_token(ref_reader)))
+  {
+    az_json_token const* const token = &ref_reader->token;
+    switch (token->kind)
+    {
+      case AZ_JSON_TOKEN_PROPERTY_NAME:
+      case AZ_JSON_TOKEN_STRING:
+      {
+        int32_t length = 0;
+        if (az_result_succeeded(
+                az_json_token_get_string(token, string_buffer, sizeof(string_buffer), &length)))
+        {
+          az_fuzz_json_sink += (uint64_t)length;
+        }
+
+        // The comparisons unescape the token as they go, and stop at the first difference.
+        az_fuzz_json_sink
+            += (uint64_t)az_json_token_is_text_equal(token, AZ_SPAN_FROM_STR("status"));
+        az_fuzz_json_sink
+            += (uint64_t)az_json_token_is_text_equal(token, AZ_SPAN_FROM_STR("a\"b\\c/d\n"));
+        break;
+      }
+      case AZ_JSON_TOKEN_NUMBER:
+      {
+        int64_t integer = 0;
+        double number = 0;
+        if (az_result_succeeded(az_json_token_get_int64(token, &integer)))
+        {
+          az_fuzz_json_sink += (uint64_t)integer;
+        }
+
+        if (az_result_succeeded(az_json_token_get_double(token, &number)))
+        {
+          az_fuzz_json_sink += (uint64_t)(number > 0);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size)
+{
+  az_span const json = az_fuzz_span(data, size);
+  if (az_span_size(json) < 1)
+  {
+    return 0;
+  }
+
+  az_json_reader reader;
+  if (az_result_succeeded(az_json_reader_init(&reader, json, NULL)))
+  {
+    az_fuzz_json_read_all(&reader);
+  }
+
+  // Skipping the whole document, with and without validating what is skipped.
+  az_json_reader_options options = az_json_reader_options_default();
+  for (int32_t validate = 0; validate < 2; validate++)
+  {
+    options.skip_children_without_validation = validate == 0;
+    if (az_result_succeeded(az_json_reader_init(&reader, json, &options))
+        && az_result_succeeded(az_json_reader_next_token(&reader)))
+    {
+      az_fuzz_json_sink += (uint64_t)(az_json_reader_skip_children(&reader) == AZ_OK);
+    }
+  }
+
+  // The same document, in buffers of about the same size.
+  az_span chunks[AZ_FUZZ_JSON_CHUNKS];
+  int32_t number_of_chunks = 0;
+  int32_t const chunk_size = (az_span_size(json) + AZ_FUZZ_JSON_CHUNKS - 1) / AZ_FUZZ_JSON_CHUNKS;
+  for (int32_t offset = 0; offset < az_span_size(json); offset += chunk_size)
+  {
+    int32_t const end = az_span_size(json) - offset > chunk_size ? offset + chunk_size
+                                                                 : az_span_size(json);
+    chunks[number_of_chunks++] = az_span_slice(json, offset, end);
+  }
+
+  if (az_result_succeeded(az_json_reader_chunked_init(&reader, chunks, number_of_chunks, NULL)))
+  {
+    az_fuzz_json_read_all(&reader);
+  }
+
+  return 0;
+}
@@ -0,0 +1,149 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief Runs a harness over input files, or over the standard input, for the compilers without
+ * libFuzzer and for AFL. Each input is also timed, which catches the inputs the parser takes
+ * super-linear time on: their cost per byte is far higher than the one of typical inputs.
+ */
+
+#include "az_fuzz.h"
+
+#include <azure/core/az_precondition.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum
+{
+  // Each input is run until this many bytes were processed, so that small inputs are timed too.
+  AZ_FUZZ_TIMED_BYTES = 4 * 1024 * 1024,
+
+  // The cost of the calls themselves is spread over at least this many bytes.
+  AZ_FUZZ_MIN_TIMED_SIZE = 64,
+};
+
+static void usage(char const* program)
+{
+  printf("Usage: %s [--max-ns-per-byte N] [file...]\n", program);
+  printf("Runs each file, or the standard input if there is none, through the harness. With\n");
+  printf("--max-ns-per-byte, fails when an input takes longer than N nanoseconds per byte.\n");
+}
+
+static uint8_t* az_fuzz_read(FILE* file, size_t* out_size)
+{
+  size_t capacity = 4096;
+  size_t size = 0;
+  uint8_t* buffer = (uint8_t*)malloc(capacity);
+  while (buffer != NULL)
+  {
+    size += fread(buffer + size, 1, capacity - size, file);
+    if (size < capacity)
+    {
+      break;
+    }
+
+    uint8_t* const larger = (uint8_t*)realloc(buffer, capacity * 2);
+    if (larger == NULL)
+    {
+      free(buffer);
+      return NULL;
+    }
+
+    buffer = larger;
+    capacity *= 2;
+  }
+
+  *out_size = size;
+  return buffer;
+}
+
+// Returns the time the harness takes on the input, in nanoseconds per byte.
+static double az_fuzz_time(uint8_t const* data, size_t size)
+{
+  size_t const timed_size = size > AZ_FUZZ_MIN_TIMED_SIZE ? size : AZ_FUZZ_MIN_TIMED_SIZE;
+  size_t const runs = AZ_FUZZ_TIMED_BYTES / timed_size > 0 ? AZ_FUZZ_TIMED_BYTES / timed_size : 1;
+
+  clock_t const start = clock();
+  for (size_t i = 0; i < runs; i++)
+  {
+    (void)LLVMFuzzerTestOneInput(data, size);
+  }
+
+  double const seconds = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+  return seconds * 1e9 / ((double)runs * (double)timed_size);
+}
+
+static int az_fuzz_run(char const* name, FILE* file, double max_ns_per_byte)
+{
+  size_t size = 0;
+  uint8_t* const data = az_fuzz_read(file, &size);
+  if (data == NULL)
+  {
+    printf("%s: failed to read\n", name);
+    return 1;
+  }
+
+  (void)LLVMFuzzerTestOneInput(data, size);
+
+  int result = 0;
+  if (max_ns_per_byte > 0)
+  {
+    double const ns_per_byte = az_fuzz_time(data, size);
+    printf("%-60s %10zu bytes %10.2f ns/byte\n", name, size, ns_per_byte);
+    if (ns_per_byte > max_ns_per_byte)
+    {
+      printf("%s: slower than %.2f ns/byte\n", name, max_ns_per_byte);
+      result = 1;
+    }
+  }
+
+  free(data);
+  return result;
+}
+
+int main(int argc, char** argv)
+{
+  az_precondition_failed_set_callback(az_fuzz_precondition_failed);
+
+  double max_ns_per_byte = 0;
+  int first_file = 1;
+  if (argc > 2 && strcmp(argv[1], "--max-ns-per-byte") == 0)
+  {
+    max_ns_per_byte = strtod(argv[2], NULL);
+    first_file = 3;
+  }
+  else if (argc > 1 && strncmp(argv[1], "--", 2) == 0)
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (first_file >= argc)
+  {
+    return az_fuzz_run("<stdin>", stdin, max_ns_per_byte);
+  }
+
+  int result = 0;
+  for (int i = first_file; i < argc; i++)
+  {
+    FILE* const file = fopen(argv[i], "rb");
+    if (file == NULL)
+    {
+      printf("%s: failed to open\n", argv[i]);
+      result = 1;
+      continue;
+    }
+
+    result |= az_fuzz_run(argv[i], file, max_ns_per_byte);
+    (void)fclose(file);
+  }
+
+  return result;
+}
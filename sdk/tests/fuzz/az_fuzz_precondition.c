@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_fuzz.h"
+
+#include <azure/core/az_precondition.h>
+
+#include <stdlib.h>
+
+void az_fuzz_precondition_failed(void) { abort(); }
+
+// Called by libFuzzer before the first input, the replay driver sets the callback in main().
+int LLVMFuzzerInitialize(int* argc, char*** argv);
+
+int LLVMFuzzerInitialize(int* argc, char*** argv)
+{
+  (void)argc;
+  (void)argv;
+  az_precondition_failed_set_callback(az_fuzz_precondition_failed);
+  return 0;
+}
@@ -16,6 +16,11 @@ int main()
   int result = 0;
 
   result += test_az_iot_common();
+  result += test_az_iot_connection();
+  result += test_az_iot_inflight_window();
+  result += test_az_iot_aggregator();
+  result += test_az_iot_publish_scheduler();
+  result += test_az_iot_receive_pool();
 
   return result;
 }
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_common.h"
+#include <azure/core/az_json.h>
+#include <azure/iot/az_iot_common.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include <azure/core/_az_cfg.h>
+
+static void test_az_iot_aggregator_add_succeed()
+{
+  az_iot_aggregator aggregator;
+  assert_int_equal(az_iot_aggregator_init(&aggregator, NULL, 0, 100), AZ_OK);
+  assert_false(az_iot_aggregator_is_window_elapsed(&aggregator, 1000));
+
+  // The window starts with its first value.
+  az_iot_aggregator_add(&aggregator, 21.5, 50);
+  az_iot_aggregator_add(&aggregator, 20.5, 80);
+  az_iot_aggregator_add(&aggregator, 23.25, 120);
+  az_iot_aggregator_add(&aggregator, 21.75, 149);
+  assert_false(az_iot_aggregator_is_window_elapsed(&aggregator, 149));
+  assert_true(az_iot_aggregator_is_window_elapsed(&aggregator, 150));
+
+  assert_int_equal(az_iot_aggregator_get_count(&aggregator), 4);
+  assert_true(az_iot_aggregator_get_minimum(&aggregator) == 20.5);
+  assert_true(az_iot_aggregator_get_maximum(&aggregator) == 23.25);
+  assert_true(az_iot_aggregator_get_mean(&aggregator) == 21.75);
+
+  uint8_t buffer[128];
+  az_json_writer writer;
+  assert_int_equal(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer), NULL), AZ_OK);
+  assert_int_equal(az_iot_aggregator_append_json(&aggregator, &writer, 2), AZ_OK);
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_STR("{\"count\":4,\"min\":20.5,\"max\":23.25,\"mean\":21.75}")));
+
+  // The next window starts with the next value.
+  az_iot_aggregator_reset(&aggregator);
+  assert_int_equal(az_iot_aggregator_get_count(&aggregator), 0);
+  assert_false(az_iot_aggregator_is_window_elapsed(&aggregator, 1000));
+  az_iot_aggregator_add(&aggregator, -3, 1000);
+  assert_false(az_iot_aggregator_is_window_elapsed(&aggregator, 1099));
+  assert_true(az_iot_aggregator_get_minimum(&aggregator) == -3);
+  assert_true(az_iot_aggregator_get_maximum(&aggregator) == -3);
+  assert_true(az_iot_aggregator_get_mean(&aggregator) == -3);
+}
+
+static void test_az_iot_aggregator_samples_succeed()
+{
+  double samples[4];
+  az_iot_aggregator aggregator;
+  assert_int_equal(az_iot_aggregator_init(&aggregator, samples, 4, 100), AZ_OK);
+
+  // Until the sample is full, it holds every value.
+  az_iot_aggregator_add(&aggregator, 1, 0);
+  az_iot_aggregator_add(&aggregator, 3, 0);
+
+  uint8_t buffer[128];
+  az_json_writer writer;
+  assert_int_equal(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(buffer), NULL), AZ_OK);
+  assert_int_equal(az_iot_aggregator_append_json(&aggregator, &writer, 0), AZ_OK);
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_STR("{\"count\":2,\"min\":1,\"max\":3,\"mean\":2,\"samples\":[1,3]}")));
+
+  // Then each value is kept with the same probability: over many windows of the values 0 to 15,
+  // each one is in about a quarter of the samples.
+  int32_t kept[16] = { 0 };
+  for (int32_t window = 0; window < 4000; window++)
+  {
+    az_iot_aggregator_reset(&aggregator);
+    for (int32_t i = 0; i < 16; i++)
+    {
+      az_iot_aggregator_add(&aggregator, i, 0);
+    }
+
+    for (int32_t i = 0; i < 4; i++)
+    {
+      kept[(int32_t)samples[i]]++;
+    }
+  }
+
+  for (int32_t i = 0; i < 16; i++)
+  {
+    assert_in_range(kept[i], 800, 1200);
+  }
+
+  // The statistics don't depend on the sample.
+  assert_int_equal(az_iot_aggregator_get_count(&aggregator), 16);
+  assert_true(az_iot_aggregator_get_minimum(&aggregator) == 0);
+  assert_true(az_iot_aggregator_get_maximum(&aggregator) == 15);
+  assert_true(az_iot_aggregator_get_mean(&aggregator) == 7.5);
+
+  uint8_t small_buffer[32];
+  assert_int_equal(
+      az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(small_buffer), NULL), AZ_OK);
+  assert_int_equal(
+      az_iot_aggregator_append_json(&aggregator, &writer, 0), AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void test_az_iot_dead_band_filter_should_send_succeed()
+{
+  az_iot_dead_band_filter filter;
+  assert_int_equal(az_iot_dead_band_filter_init(&filter, 0.5, 0), AZ_OK);
+
+  // The change is measured from the last reading sent, so a slow drift is sent eventually.
+  assert_true(az_iot_dead_band_filter_should_send(&filter, 21.0, 0));
+  assert_false(az_iot_dead_band_filter_should_send(&filter, 21.5, 1));
+  assert_false(az_iot_dead_band_filter_should_send(&filter, 20.5, 2));
+  assert_false(az_iot_dead_band_filter_should_send(&filter, 21.25, 3));
+  assert_true(az_iot_dead_band_filter_should_send(&filter, 21.75, 4));
+  assert_false(az_iot_dead_band_filter_should_send(&filter, 21.5, 5));
+  assert_true(az_iot_dead_band_filter_should_send(&filter, 21.0, 6));
+  assert_false(az_iot_dead_band_filter_should_send(&filter, 21.0, 1000));
+
+  // A reading is sent at least once per interval, even when it doesn't change.
+  assert_int_equal(az_iot_dead_band_filter_init(&filter, 0, 100), AZ_OK);
+  assert_true(az_iot_dead_band_filter_should_send(&filter, 7, 50));
+  assert_false(az_iot_dead_band_filter_should_send(&filter, 7, 149));
+  assert_true(az_iot_dead_band_filter_should_send(&filter, 7, 150));
+  assert_true(az_iot_dead_band_filter_should_send(&filter, 8, 151));
+  assert_false(az_iot_dead_band_filter_should_send(&filter, 8, 250));
+  assert_true(az_iot_dead_band_filter_should_send(&filter, 8, 251));
+}
+
+int test_az_iot_aggregator()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_iot_aggregator_add_succeed),
+    cmocka_unit_test(test_az_iot_aggregator_samples_succeed),
+    cmocka_unit_test(test_az_iot_dead_band_filter_should_send_succeed),
+  };
+
+  return cmocka_run_group_tests_name("az_iot_aggregator", tests, NULL, NULL);
+}
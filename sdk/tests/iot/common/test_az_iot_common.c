@@ -16,6 +16,8 @@
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
 #include <cmocka.h>
 
@@ -115,6 +117,27 @@ static void test_az_iot_message_properties_find_NULL_value_fail(void** state)
   ASSERT_PRECONDITION_CHECKED(az_iot_message_properties_find(&props, test_key_one, NULL));
 }
 
+static void test_az_iot_message_properties_set_index_NULL_props_fail(void** state)
+{
+  (void)state;
+
+  az_iot_message_properties_index_entry index[2];
+
+  ASSERT_PRECONDITION_CHECKED(az_iot_message_properties_set_index(NULL, index, 2));
+}
+
+static void test_az_iot_message_properties_set_index_NULL_index_fail(void** state)
+{
+  (void)state;
+
+  az_span test_span = az_span_create_from_str(TEST_KEY_VALUE_ONE);
+  az_iot_message_properties props;
+  assert_int_equal(
+      az_iot_message_properties_init(&props, test_span, az_span_size(test_span)), AZ_OK);
+
+  ASSERT_PRECONDITION_CHECKED(az_iot_message_properties_set_index(&props, NULL, 2));
+}
+
 static void test_az_iot_message_properties_next_NULL_props_fail(void** state)
 {
   (void)state;
@@ -271,6 +294,98 @@ static void test_az_iot_calculate_retry_delay_overflow_time_success()
       az_iot_calculate_retry_delay(0, INT16_MAX - 1, INT32_MAX - 1, INT32_MAX - 1, INT32_MAX - 1));
 }
 
+static void test_az_iot_calculate_retry_delay_decorrelated_success()
+{
+  // First retry, a random delay between 500 and 1500.
+  assert_int_equal(728, az_iot_calculate_retry_delay_decorrelated(5, 0, 500, 100000, 1234));
+
+  // Between 500 and 3 times the previous delay.
+  assert_int_equal(4816, az_iot_calculate_retry_delay_decorrelated(5, 2000, 500, 100000, 4321));
+
+  // Capped at the maximum.
+  assert_int_equal(599, az_iot_calculate_retry_delay_decorrelated(0, 50000, 500, 10000, 9600));
+  assert_int_equal(400, az_iot_calculate_retry_delay_decorrelated(0, 0, 500, 400, 4321));
+
+  // Operation already took more than the back-off interval.
+  assert_int_equal(0, az_iot_calculate_retry_delay_decorrelated(10000, 0, 500, 100000, 1234));
+
+  assert_int_equal(
+      INT32_MAX - 1,
+      az_iot_calculate_retry_delay_decorrelated(
+          0, INT32_MAX - 1, INT32_MAX - 1, INT32_MAX - 1, UINT32_MAX));
+}
+
+static void test_az_iot_calculate_retry_schedule_succeed()
+{
+  int32_t schedule[10];
+  int32_t again[10];
+  assert_int_equal(
+      az_iot_calculate_retry_schedule(
+          AZ_SPAN_FROM_STR("device-1"), 0, 1000, 60000, 5000, schedule, 10),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_calculate_retry_schedule(
+          AZ_SPAN_FROM_STR("device-1"), 0, 1000, 60000, 5000, again, 10),
+      AZ_OK);
+  assert_memory_equal(schedule, again, sizeof(schedule));
+
+  // Each delay is within the window after the exponential delay, the window ending at the maximum.
+  int32_t start = 1000;
+  for (int32_t i = 0; i < 10; i++)
+  {
+    assert_true(schedule[i] >= (start < 55000 ? start : 55000));
+    assert_true(schedule[i] < (start < 55000 ? start + 5000 : 60000));
+    start *= 2;
+  }
+
+  // Another device, or another seed, gets other offsets.
+  assert_int_equal(
+      az_iot_calculate_retry_schedule(
+          AZ_SPAN_FROM_STR("device-2"), 0, 1000, 60000, 5000, again, 10),
+      AZ_OK);
+  assert_memory_not_equal(schedule, again, sizeof(schedule));
+  assert_int_equal(
+      az_iot_calculate_retry_schedule(
+          AZ_SPAN_FROM_STR("device-1"), 1, 1000, 60000, 5000, again, 10),
+      AZ_OK);
+  assert_memory_not_equal(schedule, again, sizeof(schedule));
+
+  // The window is narrowed to the range of the delays.
+  assert_int_equal(
+      az_iot_calculate_retry_schedule(AZ_SPAN_EMPTY, 0, 1000, 1500, 5000, schedule, 3), AZ_OK);
+  for (int32_t i = 0; i < 3; i++)
+  {
+    assert_true(schedule[i] >= 1000 && schedule[i] < 1500);
+  }
+
+  assert_int_equal(
+      az_iot_calculate_retry_schedule(AZ_SPAN_EMPTY, 0, 1000, 1000, 5000, schedule, 1), AZ_OK);
+  assert_int_equal(schedule[0], 1000);
+}
+
+static void test_az_iot_calculate_retry_schedule_spreads_fleet_succeed()
+{
+  // A fleet of 1000 devices disconnected at once retries evenly over the window.
+  int32_t buckets[10] = { 0 };
+  for (int32_t device = 0; device < 1000; device++)
+  {
+    char device_id[16];
+    int const length = snprintf(device_id, sizeof(device_id), "device-%d", (int)device);
+    int32_t delay;
+    assert_int_equal(
+        az_iot_calculate_retry_schedule(
+            az_span_create((uint8_t*)device_id, length), 42, 1000, 60000, 10000, &delay, 1),
+        AZ_OK);
+    assert_true(delay >= 1000 && delay < 11000);
+    buckets[(delay - 1000) / 1000]++;
+  }
+
+  for (int32_t i = 0; i < 10; i++)
+  {
+    assert_true(buckets[i] > 60 && buckets[i] < 140);
+  }
+}
+
 static int _log_retry = 0;
 static void _log_listener(az_log_classification classification, az_span message)
 {
@@ -359,6 +474,182 @@ static void test_az_span_copy_url_encode_insufficient_size_fail()
       AZ_ERROR_NOT_ENOUGH_SPACE);
 }
 
+static void test_az_iot_base64_encode_decode_succeed()
+{
+  // RFC 4648 test vectors.
+  az_span const decoded[] = {
+    AZ_SPAN_LITERAL_FROM_STR(""),      AZ_SPAN_LITERAL_FROM_STR("f"),
+    AZ_SPAN_LITERAL_FROM_STR("fo"),    AZ_SPAN_LITERAL_FROM_STR("foo"),
+    AZ_SPAN_LITERAL_FROM_STR("foob"),  AZ_SPAN_LITERAL_FROM_STR("fooba"),
+    AZ_SPAN_LITERAL_FROM_STR("foobar"),
+  };
+  az_span const encoded[] = {
+    AZ_SPAN_LITERAL_FROM_STR(""),         AZ_SPAN_LITERAL_FROM_STR("Zg=="),
+    AZ_SPAN_LITERAL_FROM_STR("Zm8="),     AZ_SPAN_LITERAL_FROM_STR("Zm9v"),
+    AZ_SPAN_LITERAL_FROM_STR("Zm9vYg=="), AZ_SPAN_LITERAL_FROM_STR("Zm9vYmE="),
+    AZ_SPAN_LITERAL_FROM_STR("Zm9vYmFy"),
+  };
+
+  for (size_t i = 0; i < _az_COUNTOF(decoded); i++)
+  {
+    uint8_t buffer[TEST_SPAN_BUFFER_SIZE];
+    int32_t written = -1;
+
+    assert_int_equal(
+        az_iot_base64_encode(AZ_SPAN_FROM_BUFFER(buffer), decoded[i], &written), AZ_OK);
+    assert_true(az_span_is_content_equal(az_span_create(buffer, written), encoded[i]));
+
+    written = -1;
+    assert_int_equal(
+        az_iot_base64_decode(AZ_SPAN_FROM_BUFFER(buffer), encoded[i], &written), AZ_OK);
+    assert_true(az_span_is_content_equal(az_span_create(buffer, written), decoded[i]));
+  }
+}
+
+static void test_az_iot_base64_decode_fail()
+{
+  uint8_t buffer[TEST_SPAN_BUFFER_SIZE];
+  int32_t written = 0;
+
+  assert_int_equal(
+      az_iot_base64_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_STR("Zm9"), &written),
+      AZ_ERROR_UNEXPECTED_END);
+  assert_int_equal(
+      az_iot_base64_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_STR("Zm9*"), &written),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(
+      az_iot_base64_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_STR("Zm=v"), &written),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(
+      az_iot_base64_decode(az_span_create(buffer, 5), AZ_SPAN_FROM_STR("Zm9vYmFy"), &written),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_iot_base64_encode(az_span_create(buffer, 7), AZ_SPAN_FROM_STR("foobar"), &written),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void test_az_iot_hmac_sha256_succeed()
+{
+  // RFC 4231 test case 2.
+  uint8_t const expected_hash[]
+      = { 0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24,
+          0x26, 0x08, 0x95, 0x75, 0xc7, 0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27,
+          0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43 };
+  uint8_t hash[AZ_IOT_HMAC_SHA256_SIZE];
+
+  assert_int_equal(
+      az_iot_hmac_sha256(
+          AZ_SPAN_FROM_STR("Jefe"),
+          AZ_SPAN_FROM_STR("what do ya want for nothing?"),
+          AZ_SPAN_FROM_BUFFER(hash)),
+      AZ_OK);
+  assert_memory_equal(hash, expected_hash, sizeof(expected_hash));
+
+  // RFC 4231 test case 6, with a key larger than a SHA-256 block.
+  uint8_t const expected_long_key_hash[]
+      = { 0x60, 0xe4, 0x31, 0x59, 0x1e, 0xe0, 0xb6, 0x7f, 0x0d, 0x8a, 0x26,
+          0xaa, 0xcb, 0xf5, 0xb7, 0x7f, 0x8e, 0x0b, 0xc6, 0x21, 0x37, 0x28,
+          0xc5, 0x14, 0x05, 0x46, 0x04, 0x0f, 0x0e, 0xe3, 0x7f, 0x54 };
+  uint8_t long_key[131];
+  memset(long_key, 0xaa, sizeof(long_key));
+
+  assert_int_equal(
+      az_iot_hmac_sha256(
+          AZ_SPAN_FROM_BUFFER(long_key),
+          AZ_SPAN_FROM_STR("Test Using Larger Than Block-Size Key - Hash Key First"),
+          AZ_SPAN_FROM_BUFFER(hash)),
+      AZ_OK);
+  assert_memory_equal(hash, expected_long_key_hash, sizeof(expected_long_key_hash));
+
+  assert_int_equal(
+      az_iot_hmac_sha256(
+          AZ_SPAN_FROM_STR("Jefe"),
+          AZ_SPAN_FROM_STR("what do ya want for nothing?"),
+          az_span_create(hash, AZ_IOT_HMAC_SHA256_SIZE - 1)),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void test_az_iot_sas_key_sign_succeed()
+{
+  uint8_t key_buffer[64];
+  int32_t key_size = 0;
+  assert_int_equal(
+      az_iot_base64_decode(
+          AZ_SPAN_FROM_BUFFER(key_buffer),
+          AZ_SPAN_FROM_STR("YWJjZGVmZ2hpamtsbW5vcHFyc3R1dnd4eXoxMjM0NTY="),
+          &key_size),
+      AZ_OK);
+
+  az_iot_sas_key sas_key;
+  assert_int_equal(az_iot_sas_key_init(&sas_key, az_span_create(key_buffer, key_size)), AZ_OK);
+
+  uint8_t signed_signature_buffer[AZ_IOT_BASE64_HMAC_SHA256_SIZE];
+  az_span signed_signature;
+  assert_int_equal(
+      az_iot_sas_key_sign(
+          &sas_key,
+          AZ_SPAN_FROM_STR("myiothub.azure-devices.net%2Fdevices%2Fmy_device\n1578941692"),
+          AZ_SPAN_FROM_BUFFER(signed_signature_buffer),
+          &signed_signature),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(
+      signed_signature, AZ_SPAN_FROM_STR("ZAdGD9JAHPAGziMjVF667XjakFPYowZESUX1Py5uWOo=")));
+
+  assert_int_equal(
+      az_iot_sas_key_sign(
+          &sas_key,
+          AZ_SPAN_FROM_STR("myiothub.azure-devices.net%2Fdevices%2Fmy_device\n1578941692"),
+          az_span_create(signed_signature_buffer, AZ_IOT_BASE64_HMAC_SHA256_SIZE - 1),
+          &signed_signature),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static int _hmac_sha256_invoked = 0;
+static az_result _hmac_sha256_callback(az_span key, az_span data, az_span destination_hash)
+{
+  (void)key;
+  (void)data;
+  _hmac_sha256_invoked++;
+  az_span_fill(az_span_slice(destination_hash, 0, AZ_IOT_HMAC_SHA256_SIZE), 0);
+  return AZ_OK;
+}
+
+static void test_az_iot_sas_key_sign_hmac_sha256_callback_succeed()
+{
+  az_iot_sas_key sas_key;
+  assert_int_equal(az_iot_sas_key_init(&sas_key, AZ_SPAN_FROM_STR("key")), AZ_OK);
+
+  uint8_t signed_signature_buffer[AZ_IOT_BASE64_HMAC_SHA256_SIZE];
+  az_span signed_signature;
+
+  _hmac_sha256_invoked = 0;
+  az_iot_set_hmac_sha256_callback(_hmac_sha256_callback);
+
+  assert_int_equal(
+      az_iot_sas_key_sign(
+          &sas_key,
+          AZ_SPAN_FROM_STR("signature"),
+          AZ_SPAN_FROM_BUFFER(signed_signature_buffer),
+          &signed_signature),
+      AZ_OK);
+  assert_int_equal(_hmac_sha256_invoked, 1);
+  assert_true(az_span_is_content_equal(
+      signed_signature, AZ_SPAN_FROM_STR("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA=")));
+
+  az_iot_set_hmac_sha256_callback(NULL);
+
+  assert_int_equal(
+      az_iot_sas_key_sign(
+          &sas_key,
+          AZ_SPAN_FROM_STR("signature"),
+          AZ_SPAN_FROM_BUFFER(signed_signature_buffer),
+          &signed_signature),
+      AZ_OK);
+  assert_int_equal(_hmac_sha256_invoked, 1);
+  assert_false(az_span_is_content_equal(
+      signed_signature, AZ_SPAN_FROM_STR("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA=")));
+}
+
 static void test_az_iot_message_properties_init_succeed(void** state)
 {
   (void)state;
@@ -520,6 +811,34 @@ static void test_az_iot_message_properties_find_end_succeed(void** state)
       az_span_ptr(out_value), az_span_ptr(test_value_two), (size_t)az_span_size(test_value_two));
 }
 
+static void test_az_iot_message_properties_find_trailing_empty_value_succeed(void** state)
+{
+  (void)state;
+
+  az_span test_span = AZ_SPAN_FROM_STR("key=value&key_two=");
+  az_iot_message_properties props;
+
+  assert_int_equal(
+      az_iot_message_properties_init(&props, test_span, az_span_size(test_span)), AZ_OK);
+
+  az_span out_value;
+  assert_int_equal(
+      az_iot_message_properties_find(&props, AZ_SPAN_FROM_STR("key_two"), &out_value), AZ_OK);
+  assert_int_equal(az_span_size(out_value), 0);
+  assert_int_equal(
+      az_iot_message_properties_find(&props, AZ_SPAN_FROM_STR("missing"), &out_value),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  az_span out_name;
+  assert_int_equal(az_iot_message_properties_next(&props, &out_name, &out_value), AZ_OK);
+  assert_int_equal(az_iot_message_properties_next(&props, &out_name, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_name, AZ_SPAN_FROM_STR("key_two")));
+  assert_int_equal(az_span_size(out_value), 0);
+  assert_int_equal(
+      az_iot_message_properties_next(&props, &out_name, &out_value),
+      AZ_ERROR_IOT_END_OF_PROPERTIES);
+}
+
 static void test_az_iot_message_properties_find_substring_succeed(void** state)
 {
   (void)state;
@@ -645,6 +964,104 @@ static void test_az_iot_message_properties_find_value_match_end_fail(void** stat
       AZ_ERROR_ITEM_NOT_FOUND);
 }
 
+static void test_az_iot_message_properties_set_index_find_succeed(void** state)
+{
+  (void)state;
+
+  az_span test_span = az_span_create_from_str(TEST_KEY_VALUE_THREE);
+  az_iot_message_properties props;
+  az_iot_message_properties_index_entry index[4];
+
+  assert_int_equal(
+      az_iot_message_properties_init(&props, test_span, az_span_size(test_span)), AZ_OK);
+  assert_int_equal(az_iot_message_properties_set_index(&props, index, _az_COUNTOF(index)), AZ_OK);
+
+  az_span out_value;
+  assert_int_equal(az_iot_message_properties_find(&props, test_key_three, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_value, test_value_three));
+  assert_int_equal(az_iot_message_properties_find(&props, test_key_one, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_value, test_value_one));
+  assert_int_equal(az_iot_message_properties_find(&props, test_key_two, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_value, test_value_two));
+  assert_int_equal(
+      az_iot_message_properties_find(&props, test_key, &out_value), AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_iot_message_properties_find(&props, test_value_one, &out_value),
+      AZ_ERROR_ITEM_NOT_FOUND);
+}
+
+static void test_az_iot_message_properties_set_index_too_small_find_succeed(void** state)
+{
+  (void)state;
+
+  az_span test_span = az_span_create_from_str(TEST_KEY_VALUE_THREE);
+  az_iot_message_properties props;
+  az_iot_message_properties_index_entry index[1];
+
+  assert_int_equal(
+      az_iot_message_properties_init(&props, test_span, az_span_size(test_span)), AZ_OK);
+  assert_int_equal(az_iot_message_properties_set_index(&props, index, _az_COUNTOF(index)), AZ_OK);
+
+  // Properties beyond the index capacity are still found by parsing.
+  az_span out_value;
+  assert_int_equal(az_iot_message_properties_find(&props, test_key_one, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_value, test_value_one));
+  assert_int_equal(az_iot_message_properties_find(&props, test_key_two, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_value, test_value_two));
+  assert_int_equal(az_iot_message_properties_find(&props, test_key_three, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_value, test_value_three));
+  assert_int_equal(
+      az_iot_message_properties_find(&props, test_key, &out_value), AZ_ERROR_ITEM_NOT_FOUND);
+}
+
+static void test_az_iot_message_properties_set_index_append_find_succeed(void** state)
+{
+  (void)state;
+
+  uint8_t test_span_buf[TEST_SPAN_BUFFER_SIZE] = { 0 };
+  az_span test_span = az_span_create(test_span_buf, sizeof(test_span_buf));
+  az_iot_message_properties props;
+  az_iot_message_properties_index_entry index[2];
+
+  assert_int_equal(az_iot_message_properties_init(&props, test_span, 0), AZ_OK);
+  assert_int_equal(az_iot_message_properties_set_index(&props, index, _az_COUNTOF(index)), AZ_OK);
+
+  az_span out_value;
+  assert_int_equal(
+      az_iot_message_properties_find(&props, test_key_one, &out_value), AZ_ERROR_ITEM_NOT_FOUND);
+
+  assert_int_equal(az_iot_message_properties_append(&props, test_key_one, test_value_one), AZ_OK);
+  assert_int_equal(az_iot_message_properties_append(&props, test_key_two, test_value_two), AZ_OK);
+  assert_int_equal(
+      az_iot_message_properties_append(&props, test_key_three, test_value_three), AZ_OK);
+
+  assert_memory_equal(test_span_buf, TEST_KEY_VALUE_THREE, sizeof(TEST_KEY_VALUE_THREE) - 1);
+
+  assert_int_equal(az_iot_message_properties_find(&props, test_key_one, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_value, test_value_one));
+  assert_int_equal(az_iot_message_properties_find(&props, test_key_two, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_value, test_value_two));
+  assert_int_equal(az_iot_message_properties_find(&props, test_key_three, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_value, test_value_three));
+}
+
+static void test_az_iot_message_properties_set_index_substring_succeed(void** state)
+{
+  (void)state;
+
+  az_span test_span = az_span_create_from_str(TEST_KEY_VALUE_SAME);
+  az_iot_message_properties props;
+  az_iot_message_properties_index_entry index[2];
+
+  assert_int_equal(
+      az_iot_message_properties_init(&props, test_span, az_span_size(test_span)), AZ_OK);
+  assert_int_equal(az_iot_message_properties_set_index(&props, index, _az_COUNTOF(index)), AZ_OK);
+
+  az_span out_value;
+  assert_int_equal(az_iot_message_properties_find(&props, test_key, &out_value), AZ_OK);
+  assert_true(az_span_is_content_equal(out_value, test_value_two));
+}
+
 static void test_az_iot_message_properties_next_succeed(void** state)
 {
   (void)state;
@@ -763,6 +1180,8 @@ int test_az_iot_common()
     cmocka_unit_test(test_az_iot_message_properties_find_NULL_props_fail),
     cmocka_unit_test(test_az_iot_message_properties_find_NULL_name_fail),
     cmocka_unit_test(test_az_iot_message_properties_find_NULL_value_fail),
+    cmocka_unit_test(test_az_iot_message_properties_set_index_NULL_props_fail),
+    cmocka_unit_test(test_az_iot_message_properties_set_index_NULL_index_fail),
     cmocka_unit_test(test_az_iot_message_properties_next_NULL_props_fail),
     cmocka_unit_test(test_az_iot_message_properties_next_NULL_out_name_fail),
     cmocka_unit_test(test_az_iot_message_properties_next_NULL_out_value_fail),
@@ -774,10 +1193,18 @@ int test_az_iot_common()
     cmocka_unit_test(test_az_iot_status_retriable_translate_success),
     cmocka_unit_test(test_az_iot_calculate_retry_delay_common_timings_success),
     cmocka_unit_test(test_az_iot_calculate_retry_delay_overflow_time_success),
+    cmocka_unit_test(test_az_iot_calculate_retry_delay_decorrelated_success),
+    cmocka_unit_test(test_az_iot_calculate_retry_schedule_succeed),
+    cmocka_unit_test(test_az_iot_calculate_retry_schedule_spreads_fleet_succeed),
     cmocka_unit_test(test_az_iot_calculate_retry_delay_logging_succeed),
     cmocka_unit_test(test_az_iot_calculate_retry_delay_no_logging_succeed),
     cmocka_unit_test(test_az_span_copy_url_encode_succeed),
     cmocka_unit_test(test_az_span_copy_url_encode_insufficient_size_fail),
+    cmocka_unit_test(test_az_iot_base64_encode_decode_succeed),
+    cmocka_unit_test(test_az_iot_base64_decode_fail),
+    cmocka_unit_test(test_az_iot_hmac_sha256_succeed),
+    cmocka_unit_test(test_az_iot_sas_key_sign_succeed),
+    cmocka_unit_test(test_az_iot_sas_key_sign_hmac_sha256_callback_succeed),
     cmocka_unit_test(test_az_iot_message_properties_init_succeed),
     cmocka_unit_test(test_az_iot_message_properties_init_user_set_params_succeed),
     cmocka_unit_test(test_az_iot_message_properties_append_succeed),
@@ -788,6 +1215,7 @@ int test_az_iot_common()
     cmocka_unit_test(test_az_iot_message_properties_find_succeed),
     cmocka_unit_test(test_az_iot_message_properties_find_middle_succeed),
     cmocka_unit_test(test_az_iot_message_properties_find_end_succeed),
+    cmocka_unit_test(test_az_iot_message_properties_find_trailing_empty_value_succeed),
     cmocka_unit_test(test_az_iot_message_properties_find_substring_succeed),
     cmocka_unit_test(test_az_iot_message_properties_find_name_value_same_succeed),
     cmocka_unit_test(test_az_iot_message_properties_find_empty_buffer_fail),
@@ -796,6 +1224,10 @@ int test_az_iot_common()
     cmocka_unit_test(test_az_iot_message_properties_find_substring_suffix_fail),
     cmocka_unit_test(test_az_iot_message_properties_find_value_match_fail),
     cmocka_unit_test(test_az_iot_message_properties_find_value_match_end_fail),
+    cmocka_unit_test(test_az_iot_message_properties_set_index_find_succeed),
+    cmocka_unit_test(test_az_iot_message_properties_set_index_too_small_find_succeed),
+    cmocka_unit_test(test_az_iot_message_properties_set_index_append_find_succeed),
+    cmocka_unit_test(test_az_iot_message_properties_set_index_substring_succeed),
     cmocka_unit_test(test_az_iot_message_properties_next_succeed),
     cmocka_unit_test(test_az_iot_message_properties_next_twice_succeed),
     cmocka_unit_test(test_az_iot_message_properties_next_empty_succeed),
@@ -2,3 +2,8 @@
 // SPDX-License-Identifier: MIT
 
 int test_az_iot_common();
+int test_az_iot_connection();
+int test_az_iot_inflight_window();
+int test_az_iot_aggregator();
+int test_az_iot_publish_scheduler();
+int test_az_iot_receive_pool();
@@ -0,0 +1,231 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_common.h"
+#include <azure/iot/az_iot_common.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include <azure/core/_az_cfg.h>
+
+static az_iot_connection_action _test_handle(
+    az_iot_connection* connection,
+    az_iot_connection_event_type type,
+    int32_t return_code,
+    int64_t now_msec)
+{
+  az_iot_connection_event event = { .type = type, .return_code = return_code };
+  az_iot_connection_action action = AZ_IOT_CONNECTION_ACTION_DISCONNECT;
+  assert_int_equal(az_iot_connection_handle_event(connection, event, now_msec, 0, &action), AZ_OK);
+  return action;
+}
+
+static void _test_connection_init(az_iot_connection* connection, bool subscribe)
+{
+  az_iot_connection_options options = az_iot_connection_options_default();
+  options.connect_timeout_msec = 100;
+  options.subscribe_timeout_msec = 50;
+  options.min_retry_delay_msec = 1000;
+  options.max_retry_delay_msec = 4000;
+  options.subscribe = subscribe;
+  assert_int_equal(az_iot_connection_init(connection, &options), AZ_OK);
+  assert_int_equal(az_iot_connection_get_state(connection), AZ_IOT_CONNECTION_STATE_DISCONNECTED);
+  assert_int_equal(az_iot_connection_get_deadline(connection), INT64_MAX);
+}
+
+static void test_az_iot_connection_connect_subscribe_succeed()
+{
+  az_iot_connection connection;
+  _test_connection_init(&connection, true);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_START, 0, 0),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+  assert_int_equal(az_iot_connection_get_state(&connection), AZ_IOT_CONNECTION_STATE_CONNECTING);
+  assert_int_equal(az_iot_connection_get_deadline(&connection), 100);
+
+  // Out of order events are ignored.
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_SUBACK, 1, 10),
+      AZ_IOT_CONNECTION_ACTION_NONE);
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_TIMEOUT, 0, 99),
+      AZ_IOT_CONNECTION_ACTION_NONE);
+  assert_int_equal(az_iot_connection_get_state(&connection), AZ_IOT_CONNECTION_STATE_CONNECTING);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_CONNACK, 0, 20),
+      AZ_IOT_CONNECTION_ACTION_SUBSCRIBE);
+  assert_int_equal(az_iot_connection_get_state(&connection), AZ_IOT_CONNECTION_STATE_SUBSCRIBING);
+  assert_int_equal(az_iot_connection_get_deadline(&connection), 70);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_SUBACK, 1, 30),
+      AZ_IOT_CONNECTION_ACTION_NONE);
+  assert_int_equal(az_iot_connection_get_state(&connection), AZ_IOT_CONNECTION_STATE_CONNECTED);
+  assert_int_equal(az_iot_connection_get_status(&connection), AZ_IOT_STATUS_OK);
+  assert_int_equal(az_iot_connection_get_deadline(&connection), INT64_MAX);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_STOP, 0, 40),
+      AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+  assert_int_equal(az_iot_connection_get_state(&connection), AZ_IOT_CONNECTION_STATE_DISCONNECTED);
+}
+
+static void test_az_iot_connection_connect_without_subscribe_succeed()
+{
+  az_iot_connection connection;
+  _test_connection_init(&connection, false);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_START, 0, 0),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_CONNACK, 0, 20),
+      AZ_IOT_CONNECTION_ACTION_NONE);
+  assert_int_equal(az_iot_connection_get_state(&connection), AZ_IOT_CONNECTION_STATE_CONNECTED);
+}
+
+static void test_az_iot_connection_retry_backoff_succeed()
+{
+  az_iot_connection connection;
+  _test_connection_init(&connection, true);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_START, 0, 0),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+
+  // The CONNACK times out: the time spent waiting counts towards the first retry delay.
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_TIMEOUT, 0, 100),
+      AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+  assert_int_equal(
+      az_iot_connection_get_state(&connection), AZ_IOT_CONNECTION_STATE_WAITING_TO_RETRY);
+  assert_int_equal(az_iot_connection_get_status(&connection), AZ_IOT_STATUS_TIMEOUT);
+  assert_int_equal(az_iot_connection_get_deadline(&connection), 1000);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_TIMEOUT, 0, 1000),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+
+  // Server unavailable is retried, with an exponentially longer delay.
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_CONNACK, 3, 1000),
+      AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+  assert_int_equal(az_iot_connection_get_status(&connection), AZ_IOT_STATUS_SERVER_ERROR);
+  assert_int_equal(az_iot_connection_get_deadline(&connection), 3000);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_TIMEOUT, 0, 3000),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_CONNACK, 0, 3000),
+      AZ_IOT_CONNECTION_ACTION_SUBSCRIBE);
+
+  // A failed subscription is retried too.
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_SUBACK, 0x80, 3000),
+      AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+  assert_int_equal(az_iot_connection_get_deadline(&connection), 7000);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_TIMEOUT, 0, 7000),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_CONNACK, 0, 7000),
+      AZ_IOT_CONNECTION_ACTION_SUBSCRIBE);
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_SUBACK, 0, 7000),
+      AZ_IOT_CONNECTION_ACTION_NONE);
+
+  // Once connected, a lost connection starts the backoff over.
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_DISCONNECT, 0, 9000),
+      AZ_IOT_CONNECTION_ACTION_NONE);
+  assert_int_equal(
+      az_iot_connection_get_state(&connection), AZ_IOT_CONNECTION_STATE_WAITING_TO_RETRY);
+  assert_int_equal(az_iot_connection_get_deadline(&connection), 10000);
+}
+
+static void test_az_iot_connection_unauthorized_fails()
+{
+  az_iot_connection connection;
+  _test_connection_init(&connection, true);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_START, 0, 0),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_CONNACK, 5, 10),
+      AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+  assert_int_equal(az_iot_connection_get_state(&connection), AZ_IOT_CONNECTION_STATE_FAILED);
+  assert_int_equal(az_iot_connection_get_status(&connection), AZ_IOT_STATUS_UNAUTHORIZED);
+  assert_false(az_iot_status_retriable(az_iot_connection_get_status(&connection)));
+  assert_int_equal(az_iot_connection_get_deadline(&connection), INT64_MAX);
+
+  // After rotating its credentials, the application starts again.
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_START, 0, 20),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_CONNACK, 2, 30),
+      AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+  assert_int_equal(az_iot_connection_get_status(&connection), AZ_IOT_STATUS_BAD_REQUEST);
+}
+
+static void test_az_iot_connection_retry_schedule_succeed()
+{
+  int32_t const schedule[] = { 1500, 2500 };
+  az_iot_connection_options options = az_iot_connection_options_default();
+  options.connect_timeout_msec = 100;
+  options.retry_schedule_msec = schedule;
+  options.retry_schedule_length = 2;
+
+  az_iot_connection connection;
+  assert_int_equal(az_iot_connection_init(&connection, &options), AZ_OK);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_START, 0, 0),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+
+  // The delays come from the schedule, minus the time the failed attempt took.
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_TIMEOUT, 0, 100),
+      AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+  assert_int_equal(az_iot_connection_get_deadline(&connection), 1500);
+
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_TIMEOUT, 0, 1500),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_CONNACK, 3, 1510),
+      AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+  assert_int_equal(az_iot_connection_get_deadline(&connection), 1500 + 2500);
+
+  // Once the schedule is exhausted, its last delay is used.
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_TIMEOUT, 0, 4000),
+      AZ_IOT_CONNECTION_ACTION_CONNECT);
+  assert_int_equal(
+      _test_handle(&connection, AZ_IOT_CONNECTION_EVENT_CONNACK, 3, 4000),
+      AZ_IOT_CONNECTION_ACTION_DISCONNECT);
+  assert_int_equal(az_iot_connection_get_deadline(&connection), 4000 + 2500);
+}
+
+int test_az_iot_connection()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_iot_connection_connect_subscribe_succeed),
+    cmocka_unit_test(test_az_iot_connection_connect_without_subscribe_succeed),
+    cmocka_unit_test(test_az_iot_connection_retry_backoff_succeed),
+    cmocka_unit_test(test_az_iot_connection_retry_schedule_succeed),
+    cmocka_unit_test(test_az_iot_connection_unauthorized_fails),
+  };
+
+  return cmocka_run_group_tests_name("az_iot_connection", tests, NULL, NULL);
+}
@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_common.h"
+#include <azure/iot/az_iot_common.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include <azure/core/_az_cfg.h>
+
+static void test_az_iot_inflight_window_add_acknowledge_succeed()
+{
+  az_iot_inflight_window window;
+  az_iot_inflight_publish publishes[4];
+  assert_int_equal(az_iot_inflight_window_init(&window, publishes, 4, 100), AZ_OK);
+
+  int contexts[5] = { 0 };
+  uint16_t packet_ids[5];
+  for (int i = 0; i < 4; i++)
+  {
+    assert_int_equal(az_iot_inflight_window_add(&window, &contexts[i], 0, &packet_ids[i]), AZ_OK);
+    assert_int_equal(packet_ids[i], i + 1);
+  }
+
+  assert_true(az_iot_inflight_window_is_full(&window));
+  assert_int_equal(
+      az_iot_inflight_window_add(&window, &contexts[4], 0, &packet_ids[4]),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  // PUBACKs may arrive in any order.
+  az_iot_inflight_publish publish;
+  assert_int_equal(az_iot_inflight_window_acknowledge(&window, packet_ids[2], &publish), AZ_OK);
+  assert_ptr_equal(publish.context, &contexts[2]);
+  assert_int_equal(publish.attempts, 1);
+  assert_int_equal(
+      az_iot_inflight_window_acknowledge(&window, packet_ids[2], &publish),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(az_iot_inflight_window_acknowledge(&window, 0, NULL), AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(az_iot_inflight_window_count(&window), 3);
+
+  // The next packet identifier lands in the freed slot.
+  assert_int_equal(az_iot_inflight_window_add(&window, &contexts[4], 0, &packet_ids[4]), AZ_OK);
+  assert_int_equal(packet_ids[4], 7);
+  assert_int_equal(az_iot_inflight_window_acknowledge(&window, packet_ids[4], &publish), AZ_OK);
+  assert_ptr_equal(publish.context, &contexts[4]);
+
+  for (int i = 0; i < 2; i++)
+  {
+    assert_int_equal(az_iot_inflight_window_acknowledge(&window, packet_ids[i], NULL), AZ_OK);
+  }
+  assert_int_equal(az_iot_inflight_window_acknowledge(&window, packet_ids[3], NULL), AZ_OK);
+  assert_int_equal(az_iot_inflight_window_count(&window), 0);
+
+  int64_t deadline;
+  assert_int_equal(
+      az_iot_inflight_window_get_next_deadline(&window, &deadline), AZ_ERROR_ITEM_NOT_FOUND);
+}
+
+static void test_az_iot_inflight_window_packet_id_wraps_succeed()
+{
+  az_iot_inflight_window window;
+  az_iot_inflight_publish publishes[2];
+  assert_int_equal(az_iot_inflight_window_init(&window, publishes, 2, 100), AZ_OK);
+
+  // Packet identifier 0 is skipped when wrapping around.
+  uint16_t packet_id = 0;
+  for (int32_t i = 0; i < UINT16_MAX; i++)
+  {
+    assert_int_equal(az_iot_inflight_window_add(&window, NULL, 0, &packet_id), AZ_OK);
+    assert_int_equal(az_iot_inflight_window_acknowledge(&window, packet_id, NULL), AZ_OK);
+  }
+  assert_int_equal(packet_id, UINT16_MAX);
+
+  assert_int_equal(az_iot_inflight_window_add(&window, NULL, 0, &packet_id), AZ_OK);
+  assert_int_equal(packet_id, 1);
+}
+
+static void test_az_iot_inflight_window_get_expired_succeed()
+{
+  az_iot_inflight_window window;
+  az_iot_inflight_publish publishes[4];
+  assert_int_equal(az_iot_inflight_window_init(&window, publishes, 4, 100), AZ_OK);
+
+  int contexts[3] = { 0 };
+  uint16_t packet_ids[3];
+  assert_int_equal(az_iot_inflight_window_add(&window, &contexts[0], 0, &packet_ids[0]), AZ_OK);
+  assert_int_equal(az_iot_inflight_window_add(&window, &contexts[1], 10, &packet_ids[1]), AZ_OK);
+  assert_int_equal(az_iot_inflight_window_add(&window, &contexts[2], 20, &packet_ids[2]), AZ_OK);
+
+  int64_t deadline;
+  assert_int_equal(az_iot_inflight_window_get_next_deadline(&window, &deadline), AZ_OK);
+  assert_int_equal(deadline, 100);
+
+  az_iot_inflight_publish publish;
+  assert_int_equal(
+      az_iot_inflight_window_get_expired(&window, 99, &publish), AZ_ERROR_ITEM_NOT_FOUND);
+
+  // Expired messages are republished oldest first, with a new deadline.
+  assert_int_equal(az_iot_inflight_window_get_expired(&window, 115, &publish), AZ_OK);
+  assert_ptr_equal(publish.context, &contexts[0]);
+  assert_int_equal(publish.packet_id, packet_ids[0]);
+  assert_int_equal(publish.attempts, 2);
+  assert_int_equal(publish.deadline, 215);
+  assert_int_equal(az_iot_inflight_window_get_expired(&window, 115, &publish), AZ_OK);
+  assert_ptr_equal(publish.context, &contexts[1]);
+  assert_int_equal(
+      az_iot_inflight_window_get_expired(&window, 115, &publish), AZ_ERROR_ITEM_NOT_FOUND);
+
+  assert_int_equal(az_iot_inflight_window_get_next_deadline(&window, &deadline), AZ_OK);
+  assert_int_equal(deadline, 120);
+
+  // After reconnecting, every unacknowledged message is republished in order.
+  az_iot_inflight_window_expire_all(&window);
+  for (int i = 0; i < 3; i++)
+  {
+    assert_int_equal(az_iot_inflight_window_get_expired(&window, 130, &publish), AZ_OK);
+    assert_ptr_equal(publish.context, &contexts[i]);
+    assert_int_equal(publish.packet_id, packet_ids[i]);
+  }
+  assert_int_equal(
+      az_iot_inflight_window_get_expired(&window, 130, &publish), AZ_ERROR_ITEM_NOT_FOUND);
+}
+
+int test_az_iot_inflight_window()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_iot_inflight_window_add_acknowledge_succeed),
+    cmocka_unit_test(test_az_iot_inflight_window_packet_id_wraps_succeed),
+    cmocka_unit_test(test_az_iot_inflight_window_get_expired_succeed),
+  };
+
+  return cmocka_run_group_tests_name("az_iot_inflight_window", tests, NULL, NULL);
+}
@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_common.h"
+#include <azure/iot/az_iot_common.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include <azure/core/_az_cfg.h>
+
+static void test_az_iot_publish_scheduler_window_succeed()
+{
+  az_iot_publish_scheduler scheduler;
+  assert_int_equal(az_iot_publish_scheduler_init(&scheduler, NULL), AZ_OK);
+  assert_true(az_iot_publish_scheduler_get_deadline(&scheduler) == INT64_MAX);
+  assert_false(az_iot_publish_scheduler_is_window_open(&scheduler, 1000000));
+
+  // Telemetry read every 10 seconds waits for the window of the first reading.
+  for (int64_t now = 0; now < 60000; now += 10000)
+  {
+    az_iot_publish_scheduler_add(&scheduler, AZ_IOT_PUBLISH_CLASS_TELEMETRY, now);
+  }
+  assert_true(az_iot_publish_scheduler_get_deadline(&scheduler) == 60000);
+  assert_int_equal(
+      az_iot_publish_scheduler_get_pending_count(&scheduler, AZ_IOT_PUBLISH_CLASS_TELEMETRY), 6);
+
+  // A reported property with a shorter budget brings the window forward, and the telemetry goes
+  // with it.
+  az_iot_publish_scheduler_add(&scheduler, AZ_IOT_PUBLISH_CLASS_REPORTED_PROPERTIES, 45000);
+  assert_true(az_iot_publish_scheduler_get_deadline(&scheduler) == 55000);
+  assert_false(az_iot_publish_scheduler_is_window_open(&scheduler, 54999));
+  assert_true(az_iot_publish_scheduler_is_window_open(&scheduler, 55000));
+  assert_int_equal(
+      az_iot_publish_scheduler_get_pending_count(
+          &scheduler, AZ_IOT_PUBLISH_CLASS_REPORTED_PROPERTIES),
+      1);
+
+  az_iot_publish_scheduler_complete_window(&scheduler);
+  assert_true(az_iot_publish_scheduler_get_deadline(&scheduler) == INT64_MAX);
+  assert_int_equal(
+      az_iot_publish_scheduler_get_pending_count(&scheduler, AZ_IOT_PUBLISH_CLASS_TELEMETRY), 0);
+  assert_int_equal(
+      az_iot_publish_scheduler_get_pending_count(
+          &scheduler, AZ_IOT_PUBLISH_CLASS_REPORTED_PROPERTIES),
+      0);
+
+  // A twin request opens a window right away.
+  az_iot_publish_scheduler_add(&scheduler, AZ_IOT_PUBLISH_CLASS_TWIN_REQUEST, 70000);
+  assert_true(az_iot_publish_scheduler_is_window_open(&scheduler, 70000));
+}
+
+static void test_az_iot_publish_scheduler_options_succeed()
+{
+  az_iot_publish_scheduler_options options = az_iot_publish_scheduler_options_default();
+  assert_int_equal(options.telemetry_latency_msec, 60000);
+  assert_int_equal(options.reported_properties_latency_msec, 10000);
+  assert_int_equal(options.twin_request_latency_msec, 0);
+
+  options.telemetry_latency_msec = 300000;
+  options.twin_request_latency_msec = 5000;
+
+  az_iot_publish_scheduler scheduler;
+  assert_int_equal(az_iot_publish_scheduler_init(&scheduler, &options), AZ_OK);
+  az_iot_publish_scheduler_add(&scheduler, AZ_IOT_PUBLISH_CLASS_TELEMETRY, 1000);
+  assert_true(az_iot_publish_scheduler_get_deadline(&scheduler) == 301000);
+  az_iot_publish_scheduler_add(&scheduler, AZ_IOT_PUBLISH_CLASS_TWIN_REQUEST, 2000);
+  assert_true(az_iot_publish_scheduler_get_deadline(&scheduler) == 7000);
+}
+
+int test_az_iot_publish_scheduler()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_iot_publish_scheduler_window_succeed),
+    cmocka_unit_test(test_az_iot_publish_scheduler_options_succeed),
+  };
+
+  return cmocka_run_group_tests_name("az_iot_publish_scheduler", tests, NULL, NULL);
+}
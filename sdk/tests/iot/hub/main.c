@@ -18,9 +18,16 @@ int main()
   result += test_az_iot_hub_client();
   result += test_az_iot_hub_client_c2d();
   result += test_az_iot_hub_client_methods();
+  result += test_az_iot_hub_client_requests();
   result += test_az_iot_hub_client_sas_token();
   result += test_az_iot_hub_client_telemetry();
+  result += test_az_iot_hub_client_telemetry_queue();
   result += test_az_iot_hub_client_twin();
+  result += test_az_iot_hub_client_twin_desired();
+  result += test_az_iot_hub_client_twin_reported();
+  result += test_az_iot_hub_client_topic();
+  result += test_az_iot_hub_client_gateway();
+  result += test_az_iot_hub_client_pnp();
 
   return result;
 }
@@ -389,6 +389,32 @@ static void test_az_iot_hub_client_get_user_name_with_model_id_user_options_smal
       AZ_ERROR_NOT_ENOUGH_SPACE);
 }
 
+static void test_az_iot_hub_client_get_user_name_and_client_id_measure_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  az_iot_hub_client_options options;
+  options.model_id = AZ_SPAN_FROM_STR(TEST_MODEL_ID);
+  options.module_id = AZ_SPAN_FROM_STR(TEST_MODULE_ID);
+  options.user_agent = AZ_SPAN_FROM_STR(TEST_USER_AGENT);
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_hub_hostname, test_device_id, &options), AZ_OK);
+
+  // A NULL buffer of size 0 only gets the length, which is exactly what the string needs.
+  size_t test_length = 0;
+  assert_int_equal(az_iot_hub_client_get_user_name(&client, NULL, 0, &test_length), AZ_OK);
+  assert_int_equal(sizeof(test_correct_user_name_with_model_id_with_module_id) - 1, test_length);
+
+  char mqtt_user_name_buf[sizeof(test_correct_user_name_with_model_id_with_module_id)];
+  assert_int_equal(
+      az_iot_hub_client_get_user_name(&client, mqtt_user_name_buf, test_length + 1, NULL), AZ_OK);
+  assert_string_equal(test_correct_user_name_with_model_id_with_module_id, mqtt_user_name_buf);
+
+  assert_int_equal(az_iot_hub_client_get_client_id(&client, NULL, 0, &test_length), AZ_OK);
+  assert_int_equal(sizeof(test_correct_client_id_with_module_id) - 1, test_length);
+}
+
 static void test_az_iot_hub_client_get_client_id_succeed(void** state)
 {
   (void)state;
@@ -463,6 +489,67 @@ static void test_az_iot_hub_client_get_client_id_module_small_buffer_fail(void**
       AZ_ERROR_NOT_ENOUGH_SPACE);
 }
 
+static void test_az_iot_hub_client_init_from_config_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_options options = az_iot_hub_client_options_default();
+  options.user_agent = AZ_SPAN_FROM_STR(TEST_USER_AGENT);
+  options.model_id = AZ_SPAN_FROM_STR(TEST_MODEL_ID);
+
+  az_iot_hub_client_config config;
+  assert_int_equal(az_iot_hub_client_config_init(&config, test_hub_hostname, &options), AZ_OK);
+
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init_from_config(
+          &client, &config, test_device_id, AZ_SPAN_FROM_STR(TEST_MODULE_ID)),
+      AZ_OK);
+
+  char mqtt_topic_buf[TEST_SPAN_BUFFER_SIZE];
+  size_t test_length;
+
+  assert_int_equal(
+      az_iot_hub_client_get_user_name(
+          &client, mqtt_topic_buf, sizeof(mqtt_topic_buf), &test_length),
+      AZ_OK);
+  assert_string_equal(test_correct_user_name_with_model_id_with_module_id, mqtt_topic_buf);
+
+  assert_int_equal(
+      az_iot_hub_client_get_client_id(
+          &client, mqtt_topic_buf, sizeof(mqtt_topic_buf), &test_length),
+      AZ_OK);
+  assert_string_equal(test_correct_client_id_with_module_id, mqtt_topic_buf);
+
+  // The client copies the settings of the config, rather than referring to it.
+  assert_int_equal(az_iot_hub_client_config_get_reference_count(&config), 0);
+
+  az_iot_hub_client_deinit(&client);
+  assert_int_equal(az_span_size(client._internal.device_id), 0);
+}
+
+static void test_az_iot_hub_client_config_init_default_options_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_config config;
+  assert_int_equal(az_iot_hub_client_config_init(&config, test_hub_hostname, NULL), AZ_OK);
+
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init_from_config(&client, &config, test_device_id, AZ_SPAN_EMPTY), AZ_OK);
+
+  char mqtt_topic_buf[TEST_SPAN_BUFFER_SIZE];
+  size_t test_length;
+
+  assert_int_equal(
+      az_iot_hub_client_get_user_name(
+          &client, mqtt_topic_buf, sizeof(mqtt_topic_buf), &test_length),
+      AZ_OK);
+  assert_string_equal(test_correct_user_name, mqtt_topic_buf);
+  assert_int_equal(sizeof(test_correct_user_name) - 1, test_length);
+}
+
 int test_az_iot_hub_client()
 {
 #ifndef AZ_NO_PRECONDITION_CHECKING
@@ -495,10 +582,13 @@ int test_az_iot_hub_client()
     cmocka_unit_test(test_az_iot_hub_client_get_user_name_with_model_id_user_options_succeed),
     cmocka_unit_test(
         test_az_iot_hub_client_get_user_name_with_model_id_user_options_small_buffer_fail),
+    cmocka_unit_test(test_az_iot_hub_client_get_user_name_and_client_id_measure_succeed),
     cmocka_unit_test(test_az_iot_hub_client_get_client_id_succeed),
     cmocka_unit_test(test_az_iot_hub_client_get_client_id_small_buffer_fail),
     cmocka_unit_test(test_az_iot_hub_client_get_client_id_module_succeed),
     cmocka_unit_test(test_az_iot_hub_client_get_client_id_module_small_buffer_fail),
+    cmocka_unit_test(test_az_iot_hub_client_init_from_config_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_config_init_default_options_succeed),
   };
   return cmocka_run_group_tests_name("az_iot_hub_client", tests, NULL, NULL);
 }
@@ -4,6 +4,13 @@
 int test_az_iot_hub_client();
 int test_az_iot_hub_client_c2d();
 int test_az_iot_hub_client_methods();
+int test_az_iot_hub_client_requests();
 int test_az_iot_hub_client_sas_token();
 int test_az_iot_hub_client_telemetry();
+int test_az_iot_hub_client_telemetry_queue();
 int test_az_iot_hub_client_twin();
+int test_az_iot_hub_client_twin_desired();
+int test_az_iot_hub_client_twin_reported();
+int test_az_iot_hub_client_topic();
+int test_az_iot_hub_client_gateway();
+int test_az_iot_hub_client_pnp();
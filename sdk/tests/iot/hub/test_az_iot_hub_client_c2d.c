@@ -274,6 +274,81 @@ static void test_az_iot_hub_client_c2d_no_logging_succeed()
   az_log_set_classification_filter_callback(NULL);
 }
 
+static void test_az_iot_hub_client_c2d_parse_received_topic_indexed_succeed()
+{
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL), AZ_OK);
+
+  az_iot_hub_client_c2d_request out_request;
+  az_iot_message_properties_index_entry index[2];
+  assert_int_equal(
+      az_iot_hub_client_c2d_parse_received_topic_indexed(
+          &client, test_url_decoded_topic, index, 2, &out_request),
+      AZ_OK);
+
+  // The properties which don't fit in the index are still found.
+  az_span value;
+  assert_int_equal(
+      az_iot_message_properties_find(&out_request.properties, AZ_SPAN_FROM_STR("abc"), &value),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("123")));
+  assert_int_equal(
+      az_iot_message_properties_find(&out_request.properties, AZ_SPAN_FROM_STR("$.to"), &value),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(
+      value, AZ_SPAN_FROM_STR("/devices/useragent_c/messages/deviceBound")));
+
+  assert_int_equal(
+      az_iot_hub_client_c2d_parse_received_topic_indexed(
+          &client, AZ_SPAN_FROM_STR("$iothub/methods/POST/m/?$rid=1"), index, 2, &out_request),
+      AZ_ERROR_IOT_TOPIC_NO_MATCH);
+}
+
+static void test_az_iot_hub_client_c2d_get_system_properties_succeed()
+{
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL), AZ_OK);
+
+  az_iot_hub_client_c2d_request out_request;
+  assert_int_equal(
+      az_iot_hub_client_c2d_parse_received_topic(
+          &client,
+          AZ_SPAN_FROM_STR("devices/useragent_c/messages/devicebound/%24.mid=id1&%24.to=%2Fdevices"
+                           "&$.cid=id2&%24.ct=application%2Fjson&abc=123&%24.ce=utf-8&%24.mid=id3"),
+          &out_request),
+      AZ_OK);
+
+  az_iot_message_system_properties system_properties;
+  assert_int_equal(
+      az_iot_message_properties_get_system_properties(
+          &out_request.properties, &system_properties),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(system_properties.message_id, AZ_SPAN_FROM_STR("id1")));
+  assert_true(
+      az_span_is_content_equal(system_properties.correlation_id, AZ_SPAN_FROM_STR("id2")));
+  assert_true(az_span_is_content_equal(
+      system_properties.content_type, AZ_SPAN_FROM_STR("application%2Fjson")));
+  assert_true(
+      az_span_is_content_equal(system_properties.content_encoding, AZ_SPAN_FROM_STR("utf-8")));
+
+  // The iteration over the properties is unaffected.
+  az_span name;
+  az_span value;
+  assert_int_equal(az_iot_message_properties_next(&out_request.properties, &name, &value), AZ_OK);
+  assert_true(az_span_is_content_equal(name, AZ_SPAN_FROM_STR("%24.mid")));
+
+  assert_int_equal(
+      az_iot_hub_client_c2d_parse_received_topic(&client, test_url_no_props, &out_request), AZ_OK);
+  assert_int_equal(
+      az_iot_message_properties_get_system_properties(
+          &out_request.properties, &system_properties),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(system_properties.message_id, AZ_SPAN_EMPTY));
+  assert_int_equal(az_span_size(system_properties.content_type), 0);
+}
+
 #ifdef _MSC_VER
 // warning C4113: 'void (__cdecl *)()' differs in parameter lists from 'CMUnitTestFunction'
 #pragma warning(disable : 4113)
@@ -297,6 +372,8 @@ int test_az_iot_hub_client_c2d()
     cmocka_unit_test(test_az_iot_hub_client_c2d_parse_received_topic_no_props_succeed),
     cmocka_unit_test(test_az_iot_hub_client_c2d_parse_received_topic_reject),
     cmocka_unit_test(test_az_iot_hub_client_c2d_parse_received_topic_malformed_reject),
+    cmocka_unit_test(test_az_iot_hub_client_c2d_parse_received_topic_indexed_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_c2d_get_system_properties_succeed),
     cmocka_unit_test(test_az_iot_hub_client_c2d_logging_succeed),
     cmocka_unit_test(test_az_iot_hub_client_c2d_no_logging_succeed),
   };
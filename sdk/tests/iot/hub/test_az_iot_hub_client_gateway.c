@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_hub_client.h"
+#include <azure/core/az_span.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#define TEST_DEVICE_HOSTNAME_STR "myiothub.azure-devices.net"
+
+static const az_span test_device_hostname = AZ_SPAN_LITERAL_FROM_STR(TEST_DEVICE_HOSTNAME_STR);
+
+static void test_az_iot_hub_client_gateway_add_find_remove_succeed()
+{
+  az_iot_hub_client_gateway gateway;
+  az_iot_hub_client_gateway_device devices[3];
+  assert_int_equal(
+      az_iot_hub_client_gateway_init(&gateway, devices, 3, test_device_hostname, NULL, NULL),
+      AZ_OK);
+
+  int contexts[3] = { 0 };
+  az_iot_hub_client_gateway_device* device_a;
+  az_iot_hub_client_gateway_device* device_b;
+  az_iot_hub_client_gateway_device* device_c;
+  az_iot_hub_client_gateway_device* found = NULL;
+  assert_int_equal(
+      az_iot_hub_client_gateway_add_device(
+          &gateway, AZ_SPAN_FROM_STR("device-a"), &contexts[0], &device_a),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_gateway_add_device(
+          &gateway, AZ_SPAN_FROM_STR("device-b"), &contexts[1], &device_b),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_gateway_add_device(
+          &gateway, AZ_SPAN_FROM_STR("device-c"), &contexts[2], &device_c),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_gateway_add_device(&gateway, AZ_SPAN_FROM_STR("device-d"), NULL, &found),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(az_iot_hub_client_gateway_count(&gateway), 3);
+
+  assert_int_equal(
+      az_iot_hub_client_gateway_find_device(&gateway, AZ_SPAN_FROM_STR("device-b"), &found),
+      AZ_OK);
+  assert_ptr_equal(found, device_b);
+  assert_ptr_equal(az_iot_hub_client_gateway_device_get_context(found), &contexts[1]);
+  assert_true(az_span_is_content_equal(
+      az_iot_hub_client_gateway_device_get_client(found)->_internal.device_id,
+      AZ_SPAN_FROM_STR("device-b")));
+  assert_int_equal(
+      az_iot_connection_get_state(az_iot_hub_client_gateway_device_get_connection(found)),
+      AZ_IOT_CONNECTION_STATE_DISCONNECTED);
+
+  // A removed device's slot is reused.
+  az_iot_hub_client_gateway_remove_device(&gateway, device_b);
+  assert_int_equal(az_iot_hub_client_gateway_count(&gateway), 2);
+  assert_int_equal(
+      az_iot_hub_client_gateway_find_device(&gateway, AZ_SPAN_FROM_STR("device-b"), &found),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_iot_hub_client_gateway_add_device(&gateway, AZ_SPAN_FROM_STR("device-d"), NULL, &found),
+      AZ_OK);
+  assert_ptr_equal(found, device_b);
+  assert_int_equal(
+      az_iot_hub_client_gateway_find_device(&gateway, AZ_SPAN_FROM_STR("device-d"), &found),
+      AZ_OK);
+  assert_ptr_equal(found, device_b);
+}
+
+static void test_az_iot_hub_client_gateway_parse_received_topic_succeed()
+{
+  az_iot_hub_client_gateway gateway;
+  az_iot_hub_client_gateway_device devices[2];
+  assert_int_equal(
+      az_iot_hub_client_gateway_init(&gateway, devices, 2, test_device_hostname, NULL, NULL),
+      AZ_OK);
+
+  az_iot_hub_client_gateway_device* device_a;
+  az_iot_hub_client_gateway_device* device_b;
+  assert_int_equal(
+      az_iot_hub_client_gateway_add_device(&gateway, AZ_SPAN_FROM_STR("device-a"), NULL, &device_a),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_gateway_add_device(&gateway, AZ_SPAN_FROM_STR("device-b"), NULL, &device_b),
+      AZ_OK);
+
+  // A cloud-to-device topic names its device.
+  az_iot_hub_client_gateway_device* device = NULL;
+  az_iot_hub_client_topic topic;
+  assert_int_equal(
+      az_iot_hub_client_gateway_parse_received_topic(
+          &gateway,
+          NULL,
+          AZ_SPAN_FROM_STR("devices/device-b/messages/devicebound/abc=123"),
+          &device,
+          &topic),
+      AZ_OK);
+  assert_ptr_equal(device, device_b);
+  assert_int_equal(topic.type, AZ_IOT_HUB_CLIENT_TOPIC_TYPE_C2D);
+
+  assert_int_equal(
+      az_iot_hub_client_gateway_parse_received_topic(
+          &gateway,
+          NULL,
+          AZ_SPAN_FROM_STR("devices/device-c/messages/devicebound/abc=123"),
+          &device,
+          &topic),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  // A method topic is dispatched to the device whose connection received it.
+  az_span const method_topic = AZ_SPAN_FROM_STR("$iothub/methods/POST/TestMethod/?$rid=1");
+  assert_int_equal(
+      az_iot_hub_client_gateway_parse_received_topic(
+          &gateway, NULL, method_topic, &device, &topic),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_iot_hub_client_gateway_parse_received_topic(
+          &gateway, device_a, method_topic, &device, &topic),
+      AZ_OK);
+  assert_ptr_equal(device, device_a);
+  assert_int_equal(topic.type, AZ_IOT_HUB_CLIENT_TOPIC_TYPE_METHOD);
+  assert_true(
+      az_span_is_content_equal(topic.parsed.method.name, AZ_SPAN_FROM_STR("TestMethod")));
+
+  assert_int_equal(
+      az_iot_hub_client_gateway_parse_received_topic(
+          &gateway, device_a, AZ_SPAN_FROM_STR("$iothub/unknown"), &device, &topic),
+      AZ_ERROR_IOT_TOPIC_NO_MATCH);
+}
+
+int test_az_iot_hub_client_gateway()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_iot_hub_client_gateway_add_find_remove_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_gateway_parse_received_topic_succeed),
+  };
+  return cmocka_run_group_tests_name("az_iot_hub_gateway", tests, NULL, NULL);
+}
@@ -290,6 +290,55 @@ static void test_az_iot_hub_client_methods_parse_received_topic_succeed()
       _az_COUNTOF(expected_request_id) - 1);
 }
 
+static void test_az_iot_hub_client_methods_response_get_publish_topic_u64_succeed()
+{
+  char test_buf[TEST_SPAN_BUFFER_SIZE];
+  size_t test_length;
+
+  az_iot_hub_client client;
+  assert_true(az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL) == AZ_OK);
+
+  const char expected_topic[] = "$iothub/methods/res/200/?$rid=1234567890";
+
+  assert_true(
+      az_iot_hub_client_methods_response_get_publish_topic_u64(
+          &client, 1234567890, 200, test_buf, sizeof(test_buf), &test_length)
+      == AZ_OK);
+
+  assert_string_equal(expected_topic, test_buf);
+  assert_int_equal(sizeof(expected_topic) - 1, test_length);
+}
+
+static void test_az_iot_hub_client_parse_request_id_succeed()
+{
+  az_iot_hub_client client;
+  assert_true(az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL) == AZ_OK);
+
+  az_span received_topic
+      = AZ_SPAN_FROM_STR("$iothub/methods/POST/TestMethod/?$rid=18446744073709551615");
+
+  az_iot_hub_client_method_request out_request;
+  uint64_t request_id;
+
+  assert_true(
+      az_iot_hub_client_methods_parse_received_topic(&client, received_topic, &out_request)
+      == AZ_OK);
+  assert_true(az_iot_hub_client_parse_request_id(out_request.request_id, &request_id) == AZ_OK);
+  assert_true(request_id == UINT64_MAX);
+}
+
+static void test_az_iot_hub_client_parse_request_id_not_numeric_fail()
+{
+  uint64_t request_id;
+
+  assert_true(
+      az_iot_hub_client_parse_request_id(AZ_SPAN_FROM_STR("id_one"), &request_id)
+      == AZ_ERROR_UNEXPECTED_CHAR);
+  assert_true(
+      az_iot_hub_client_parse_request_id(AZ_SPAN_FROM_STR("18446744073709551616"), &request_id)
+      == AZ_ERROR_UNEXPECTED_CHAR);
+}
+
 static void test_az_iot_hub_client_methods_parse_received_topic_c2d_topic_fail()
 {
   az_iot_hub_client client;
@@ -446,6 +495,72 @@ static void test_az_iot_hub_client_methods_no_logging_succeed()
   az_log_set_classification_filter_callback(NULL);
 }
 
+#define TEST_METHOD_TABLE_SIZE 200
+
+static void test_az_iot_hub_client_method_table_find_succeed()
+{
+  // Each name is "command" followed by its index.
+  uint8_t name_buffers[TEST_METHOD_TABLE_SIZE][16];
+  az_span names[TEST_METHOD_TABLE_SIZE];
+  for (int32_t i = 0; i < TEST_METHOD_TABLE_SIZE; i++)
+  {
+    az_span const buffer = AZ_SPAN_FROM_BUFFER(name_buffers[i]);
+    az_span remainder = az_span_copy(buffer, AZ_SPAN_FROM_STR("command"));
+    assert_int_equal(az_span_i32toa(remainder, i, &remainder), AZ_OK);
+    names[i] = az_span_slice(buffer, 0, az_span_size(buffer) - az_span_size(remainder));
+  }
+
+  az_iot_hub_client_method_table table;
+  uint32_t hashes[TEST_METHOD_TABLE_SIZE];
+  int32_t seeds[TEST_METHOD_TABLE_SIZE];
+  int32_t slots[TEST_METHOD_TABLE_SIZE];
+  assert_int_equal(
+      az_iot_hub_client_method_table_init(
+          &table, names, hashes, seeds, slots, TEST_METHOD_TABLE_SIZE),
+      AZ_OK);
+
+  for (int32_t i = 0; i < TEST_METHOD_TABLE_SIZE; i++)
+  {
+    assert_int_equal(az_iot_hub_client_method_table_find(&table, names[i]), i);
+  }
+
+  assert_int_equal(az_iot_hub_client_method_table_find(&table, AZ_SPAN_FROM_STR("command200")), -1);
+  assert_int_equal(az_iot_hub_client_method_table_find(&table, AZ_SPAN_FROM_STR("command")), -1);
+  assert_int_equal(az_iot_hub_client_method_table_find(&table, AZ_SPAN_EMPTY), -1);
+
+  // A received method request is dispatched by its name.
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL), AZ_OK);
+  az_iot_hub_client_method_request request;
+  assert_int_equal(
+      az_iot_hub_client_methods_parse_received_topic(
+          &client, AZ_SPAN_FROM_STR("$iothub/methods/POST/command42/?$rid=1"), &request),
+      AZ_OK);
+  assert_int_equal(az_iot_hub_client_method_table_find(&table, request.name), 42);
+}
+
+static void test_az_iot_hub_client_method_table_duplicate_name_fail()
+{
+  az_span const names[] = {
+    AZ_SPAN_LITERAL_FROM_STR("reboot"),
+    AZ_SPAN_LITERAL_FROM_STR("thermostat1*getMaxMinReport"),
+    AZ_SPAN_LITERAL_FROM_STR("reboot"),
+  };
+
+  az_iot_hub_client_method_table table;
+  uint32_t hashes[3];
+  int32_t seeds[3];
+  int32_t slots[3];
+  assert_int_equal(
+      az_iot_hub_client_method_table_init(&table, names, hashes, seeds, slots, 3), AZ_ERROR_ARG);
+  assert_int_equal(
+      az_iot_hub_client_method_table_init(&table, names, hashes, seeds, slots, 2), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_method_table_find(&table, AZ_SPAN_FROM_STR("thermostat1*getMaxMinReport")),
+      1);
+}
+
 #ifdef _MSC_VER
 // warning C4113: 'void (__cdecl *)()' differs in parameter lists from 'CMUnitTestFunction'
 #pragma warning(disable : 4113)
@@ -489,8 +604,13 @@ int test_az_iot_hub_client_methods()
     cmocka_unit_test(test_az_iot_hub_client_methods_parse_received_topic_twin_patch_topic_fail),
     cmocka_unit_test(test_az_iot_hub_client_methods_parse_received_topic_topic_filter_fail),
     cmocka_unit_test(test_az_iot_hub_client_methods_parse_received_topic_response_topic_fail),
+    cmocka_unit_test(test_az_iot_hub_client_methods_response_get_publish_topic_u64_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_parse_request_id_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_parse_request_id_not_numeric_fail),
     cmocka_unit_test(test_az_iot_hub_client_methods_logging_succeed),
     cmocka_unit_test(test_az_iot_hub_client_methods_no_logging_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_method_table_find_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_method_table_duplicate_name_fail),
   };
 
   return cmocka_run_group_tests_name("az_iot_hub_methods", tests, NULL, NULL);
@@ -0,0 +1,276 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_hub_client.h"
+#include <azure/core/az_json.h>
+#include <azure/core/az_span.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#define TEST_TOPIC_PREFIX "devices/my_device/messages/events/"
+
+static az_span const test_component_names[] = {
+  AZ_SPAN_LITERAL_FROM_STR("thermostat1"),
+  AZ_SPAN_LITERAL_FROM_STR("thermostat2"),
+  AZ_SPAN_LITERAL_FROM_STR("deviceInformation"),
+};
+
+static void _test_pnp_components_init(
+    az_iot_hub_client* client,
+    az_iot_hub_client_pnp_components* components,
+    az_span topic_buffer)
+{
+  static uint32_t hashes[3];
+  static int32_t seeds[3];
+  static int32_t slots[3];
+  static az_span telemetry_topics[3];
+
+  assert_int_equal(
+      az_iot_hub_client_init(
+          client,
+          AZ_SPAN_FROM_STR("myiothub.azure-devices.net"),
+          AZ_SPAN_FROM_STR("my_device"),
+          NULL),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_init(
+          components,
+          client,
+          test_component_names,
+          hashes,
+          seeds,
+          slots,
+          telemetry_topics,
+          3,
+          topic_buffer),
+      AZ_OK);
+}
+
+static void test_az_iot_hub_client_pnp_components_telemetry_topic_succeed()
+{
+  uint8_t topic_buffer[256];
+  az_iot_hub_client client;
+  az_iot_hub_client_pnp_components components;
+  _test_pnp_components_init(&client, &components, AZ_SPAN_FROM_BUFFER(topic_buffer));
+
+  az_span const topic = az_iot_hub_client_pnp_components_get_telemetry_topic(&components, 1);
+  assert_true(az_span_is_content_equal(
+      topic, AZ_SPAN_FROM_STR(TEST_TOPIC_PREFIX "$.sub=thermostat2")));
+  assert_int_equal(az_span_ptr(topic)[az_span_size(topic)], '\0');
+  assert_string_equal(
+      (char const*)az_span_ptr(
+          az_iot_hub_client_pnp_components_get_telemetry_topic(&components, 0)),
+      TEST_TOPIC_PREFIX "$.sub=thermostat1");
+  assert_string_equal(
+      (char const*)az_span_ptr(
+          az_iot_hub_client_pnp_components_get_telemetry_topic(&components, 2)),
+      TEST_TOPIC_PREFIX "$.sub=deviceInformation");
+
+  // The three topics take 162 bytes, with their null terminators.
+  uint32_t hashes[3];
+  int32_t seeds[3];
+  int32_t slots[3];
+  az_span telemetry_topics[3];
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_init(
+          &components,
+          &client,
+          test_component_names,
+          hashes,
+          seeds,
+          slots,
+          telemetry_topics,
+          3,
+          az_span_create(topic_buffer, 161)),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_init(
+          &components,
+          &client,
+          test_component_names,
+          hashes,
+          seeds,
+          slots,
+          telemetry_topics,
+          3,
+          az_span_create(topic_buffer, 162)),
+      AZ_OK);
+}
+
+static void test_az_iot_hub_client_pnp_components_find_succeed()
+{
+  uint8_t topic_buffer[256];
+  az_iot_hub_client client;
+  az_iot_hub_client_pnp_components components;
+  _test_pnp_components_init(&client, &components, AZ_SPAN_FROM_BUFFER(topic_buffer));
+
+  for (int32_t i = 0; i < 3; i++)
+  {
+    assert_int_equal(
+        az_iot_hub_client_pnp_components_find(&components, test_component_names[i]), i);
+  }
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_find(&components, AZ_SPAN_FROM_STR("$version")), -1);
+
+  int32_t component_index = 0;
+  az_span command_name = AZ_SPAN_EMPTY;
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_parse_command(
+          &components,
+          AZ_SPAN_FROM_STR("thermostat2*getMaxMinReport"),
+          &component_index,
+          &command_name),
+      AZ_OK);
+  assert_int_equal(component_index, 1);
+  assert_true(az_span_is_content_equal(command_name, AZ_SPAN_FROM_STR("getMaxMinReport")));
+
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_parse_command(
+          &components, AZ_SPAN_FROM_STR("reboot"), &component_index, &command_name),
+      AZ_OK);
+  assert_int_equal(component_index, -1);
+  assert_true(az_span_is_content_equal(command_name, AZ_SPAN_FROM_STR("reboot")));
+
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_parse_command(
+          &components, AZ_SPAN_FROM_STR("thermostat3*reboot"), &component_index, &command_name),
+      AZ_ERROR_ITEM_NOT_FOUND);
+}
+
+typedef struct
+{
+  int32_t count;
+  int64_t version;
+  // Each visited property, as "component/name=value", or "name=value" for the default component.
+  char visited[256];
+  int32_t visited_length;
+} test_visit_state;
+
+static void _test_property_callback(
+    int32_t component_index,
+    az_json_token const* property_name,
+    az_json_reader* property_value,
+    int64_t version,
+    void* context)
+{
+  test_visit_state* state = (test_visit_state*)context;
+  az_span remainder = az_span_slice_to_end(
+      AZ_SPAN_FROM_BUFFER(state->visited), state->visited_length);
+  az_span const start = remainder;
+
+  if (component_index >= 0)
+  {
+    remainder = az_span_copy(remainder, test_component_names[component_index]);
+    remainder = az_span_copy_u8(remainder, '/');
+  }
+  remainder = az_span_copy(remainder, property_name->slice);
+  remainder = az_span_copy_u8(remainder, '=');
+
+  // Objects are visited as a whole.
+  if (property_value->token.kind == AZ_JSON_TOKEN_BEGIN_OBJECT)
+  {
+    remainder = az_span_copy_u8(remainder, '{');
+    assert_int_equal(az_json_reader_skip_children(property_value), AZ_OK);
+  }
+  else
+  {
+    remainder = az_span_copy(remainder, property_value->token.slice);
+  }
+  remainder = az_span_copy_u8(remainder, ';');
+
+  state->visited_length += (int32_t)(az_span_ptr(remainder) - az_span_ptr(start));
+  state->count++;
+  state->version = version;
+}
+
+static void test_az_iot_hub_client_pnp_components_visit_desired_succeed()
+{
+  uint8_t topic_buffer[256];
+  az_iot_hub_client client;
+  az_iot_hub_client_pnp_components components;
+  _test_pnp_components_init(&client, &components, AZ_SPAN_FROM_BUFFER(topic_buffer));
+
+  az_iot_hub_client_twin_response response = { 0 };
+  response.response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_GET;
+  response.status = AZ_IOT_STATUS_OK;
+
+  // A GET document, whose `$version` comes after the properties.
+  test_visit_state state = { 0 };
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_visit_desired(
+          &components,
+          &response,
+          AZ_SPAN_FROM_STR("{\"desired\":{\"thermostat1\":{\"__t\":\"c\",\"targetTemperature\":"
+                           "21.5},\"thermostat3\":{\"a\":1},\"targetTemperature\":20,"
+                           "\"thermostat2\":{\"__t\":\"c\",\"targetTemperature\":{\"x\":[1]},"
+                           "\"mode\":\"eco\"},\"$version\":7},\"reported\":{\"$version\":1}}"),
+          _test_property_callback,
+          &state),
+      AZ_OK);
+  assert_int_equal(state.count, 5);
+  assert_true(state.version == 7);
+  assert_string_equal(
+      state.visited,
+      "thermostat1/targetTemperature=21.5;thermostat3={;targetTemperature=20;"
+      "thermostat2/targetTemperature={;thermostat2/mode=eco;");
+
+  // A notification, with the `$version` in its topic.
+  response.response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_DESIRED_PROPERTIES;
+  response.version = AZ_SPAN_FROM_STR("8");
+  state = (test_visit_state){ 0 };
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_visit_desired(
+          &components,
+          &response,
+          AZ_SPAN_FROM_STR("{\"thermostat2\":{\"__t\":\"c\",\"mode\":\"off\"},\"$version\":8}"),
+          _test_property_callback,
+          &state),
+      AZ_OK);
+  assert_true(state.version == 8);
+  assert_string_equal(state.visited, "thermostat2/mode=off;");
+
+  // Without a `$version`, nothing is visited.
+  response.version = AZ_SPAN_EMPTY;
+  state = (test_visit_state){ 0 };
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_visit_desired(
+          &components,
+          &response,
+          AZ_SPAN_FROM_STR("{\"thermostat2\":{\"mode\":\"off\"}}"),
+          _test_property_callback,
+          &state),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(state.count, 0);
+
+  // Failed GET responses and other responses are ignored.
+  response.response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_GET;
+  response.status = AZ_IOT_STATUS_NOT_FOUND;
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_visit_desired(
+          &components, &response, AZ_SPAN_FROM_STR("{}"), _test_property_callback, &state),
+      AZ_OK);
+  response.response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_REPORTED_PROPERTIES;
+  response.status = AZ_IOT_STATUS_NO_CONTENT;
+  assert_int_equal(
+      az_iot_hub_client_pnp_components_visit_desired(
+          &components, &response, AZ_SPAN_EMPTY, _test_property_callback, &state),
+      AZ_OK);
+  assert_int_equal(state.count, 0);
+}
+
+int test_az_iot_hub_client_pnp()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_iot_hub_client_pnp_components_telemetry_topic_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_pnp_components_find_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_pnp_components_visit_desired_succeed),
+  };
+  return cmocka_run_group_tests_name("az_iot_hub_pnp", tests, NULL, NULL);
+}
@@ -0,0 +1,231 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_hub_client.h"
+#include <az_test_precondition.h>
+#include <azure/core/az_precondition.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#define TEST_TABLE_CAPACITY 4
+
+static az_iot_hub_client_pending_request test_requests[TEST_TABLE_CAPACITY];
+
+// Formats a request ID as it's received back in a response topic.
+static az_span _request_id_span(uint64_t request_id, az_span buffer)
+{
+  az_span remainder;
+  assert_int_equal(az_span_u64toa(buffer, request_id, &remainder), AZ_OK);
+  return az_span_slice(buffer, 0, az_span_size(buffer) - az_span_size(remainder));
+}
+
+#ifndef AZ_NO_PRECONDITION_CHECKING
+ENABLE_PRECONDITION_CHECK_TESTS()
+
+static void test_az_iot_hub_client_request_table_init_NULL_table_fail(void** state)
+{
+  (void)state;
+
+  ASSERT_PRECONDITION_CHECKED(
+      az_iot_hub_client_request_table_init(NULL, test_requests, TEST_TABLE_CAPACITY));
+}
+
+static void test_az_iot_hub_client_request_table_init_capacity_not_power_of_two_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_request_table table;
+
+  ASSERT_PRECONDITION_CHECKED(az_iot_hub_client_request_table_init(&table, test_requests, 3));
+}
+
+static void test_az_iot_hub_client_request_table_add_NULL_out_request_id_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_request_table table;
+  assert_int_equal(
+      az_iot_hub_client_request_table_init(&table, test_requests, TEST_TABLE_CAPACITY), AZ_OK);
+
+  ASSERT_PRECONDITION_CHECKED(az_iot_hub_client_request_table_add(&table, 0, NULL, NULL));
+}
+
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+static void test_az_iot_hub_client_request_table_resolve_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_request_table table;
+  assert_int_equal(
+      az_iot_hub_client_request_table_init(&table, test_requests, TEST_TABLE_CAPACITY), AZ_OK);
+
+  int contexts[2];
+  uint64_t request_ids[2];
+  assert_int_equal(
+      az_iot_hub_client_request_table_add(&table, 100, &contexts[0], &request_ids[0]), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_request_table_add(&table, 200, &contexts[1], &request_ids[1]), AZ_OK);
+  assert_true(request_ids[0] != 0);
+  assert_true(request_ids[0] != request_ids[1]);
+  assert_int_equal(az_iot_hub_client_request_table_count(&table), 2);
+
+  uint8_t buffer[20];
+  az_iot_hub_client_pending_request request;
+
+  assert_int_equal(
+      az_iot_hub_client_request_table_resolve(
+          &table, _request_id_span(request_ids[1], AZ_SPAN_FROM_BUFFER(buffer)), &request),
+      AZ_OK);
+  assert_true(request.request_id == request_ids[1]);
+  assert_true(request.deadline == 200);
+  assert_ptr_equal(request.context, &contexts[1]);
+  assert_int_equal(az_iot_hub_client_request_table_count(&table), 1);
+
+  // A response is only resolved once.
+  assert_int_equal(
+      az_iot_hub_client_request_table_resolve(
+          &table, _request_id_span(request_ids[1], AZ_SPAN_FROM_BUFFER(buffer)), &request),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  assert_int_equal(
+      az_iot_hub_client_request_table_resolve(
+          &table, _request_id_span(request_ids[0], AZ_SPAN_FROM_BUFFER(buffer)), &request),
+      AZ_OK);
+  assert_ptr_equal(request.context, &contexts[0]);
+  assert_int_equal(az_iot_hub_client_request_table_count(&table), 0);
+}
+
+static void test_az_iot_hub_client_request_table_resolve_unknown_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_request_table table;
+  assert_int_equal(
+      az_iot_hub_client_request_table_init(&table, test_requests, TEST_TABLE_CAPACITY), AZ_OK);
+
+  uint64_t request_id;
+  assert_int_equal(az_iot_hub_client_request_table_add(&table, 0, NULL, &request_id), AZ_OK);
+
+  uint8_t buffer[20];
+
+  // Same slot as the outstanding request, but a different ID.
+  assert_int_equal(
+      az_iot_hub_client_request_table_resolve(
+          &table,
+          _request_id_span(request_id + TEST_TABLE_CAPACITY, AZ_SPAN_FROM_BUFFER(buffer)),
+          NULL),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_iot_hub_client_request_table_resolve(&table, AZ_SPAN_EMPTY, NULL),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_iot_hub_client_request_table_resolve(&table, AZ_SPAN_FROM_STR("id_one"), NULL),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_iot_hub_client_request_table_resolve(&table, AZ_SPAN_FROM_STR("0"), NULL),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(az_iot_hub_client_request_table_count(&table), 1);
+}
+
+static void test_az_iot_hub_client_request_table_add_full_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_request_table table;
+  assert_int_equal(
+      az_iot_hub_client_request_table_init(&table, test_requests, TEST_TABLE_CAPACITY), AZ_OK);
+
+  uint64_t request_ids[TEST_TABLE_CAPACITY];
+  for (int32_t i = 0; i < TEST_TABLE_CAPACITY; i++)
+  {
+    assert_int_equal(
+        az_iot_hub_client_request_table_add(&table, 0, NULL, &request_ids[i]), AZ_OK);
+  }
+
+  uint64_t request_id;
+  assert_int_equal(
+      az_iot_hub_client_request_table_add(&table, 0, NULL, &request_id),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  // Freeing a slot other than the next one makes room, with an ID mapping to that slot.
+  uint8_t buffer[20];
+  assert_int_equal(
+      az_iot_hub_client_request_table_resolve(
+          &table, _request_id_span(request_ids[2], AZ_SPAN_FROM_BUFFER(buffer)), NULL),
+      AZ_OK);
+  assert_int_equal(az_iot_hub_client_request_table_add(&table, 0, NULL, &request_id), AZ_OK);
+  assert_true(request_id == request_ids[2] + TEST_TABLE_CAPACITY);
+
+  assert_int_equal(
+      az_iot_hub_client_request_table_resolve(
+          &table, _request_id_span(request_id, AZ_SPAN_FROM_BUFFER(buffer)), NULL),
+      AZ_OK);
+}
+
+static void test_az_iot_hub_client_request_table_remove_expired_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_request_table table;
+  assert_int_equal(
+      az_iot_hub_client_request_table_init(&table, test_requests, TEST_TABLE_CAPACITY), AZ_OK);
+
+  uint64_t request_ids[3];
+  assert_int_equal(az_iot_hub_client_request_table_add(&table, 300, NULL, &request_ids[0]), AZ_OK);
+  assert_int_equal(az_iot_hub_client_request_table_add(&table, 100, NULL, &request_ids[1]), AZ_OK);
+  assert_int_equal(az_iot_hub_client_request_table_add(&table, 200, NULL, &request_ids[2]), AZ_OK);
+
+  az_iot_hub_client_pending_request request;
+
+  assert_int_equal(
+      az_iot_hub_client_request_table_remove_expired(&table, 50, &request),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  assert_int_equal(az_iot_hub_client_request_table_remove_expired(&table, 200, &request), AZ_OK);
+  assert_int_equal(az_iot_hub_client_request_table_remove_expired(&table, 200, NULL), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_request_table_remove_expired(&table, 200, &request),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(az_iot_hub_client_request_table_count(&table), 1);
+
+  uint8_t buffer[20];
+  assert_int_equal(
+      az_iot_hub_client_request_table_resolve(
+          &table, _request_id_span(request_ids[0], AZ_SPAN_FROM_BUFFER(buffer)), &request),
+      AZ_OK);
+  assert_true(request.deadline == 300);
+}
+
+#ifdef _MSC_VER
+// warning C4113: 'void (__cdecl *)()' differs in parameter lists from 'CMUnitTestFunction'
+#pragma warning(disable : 4113)
+#endif
+
+int test_az_iot_hub_client_requests()
+{
+#ifndef AZ_NO_PRECONDITION_CHECKING
+  SETUP_PRECONDITION_CHECK_TESTS();
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+  const struct CMUnitTest tests[] = {
+#ifndef AZ_NO_PRECONDITION_CHECKING
+    cmocka_unit_test(test_az_iot_hub_client_request_table_init_NULL_table_fail),
+    cmocka_unit_test(test_az_iot_hub_client_request_table_init_capacity_not_power_of_two_fail),
+    cmocka_unit_test(test_az_iot_hub_client_request_table_add_NULL_out_request_id_fail),
+#endif // AZ_NO_PRECONDITION_CHECKING
+    cmocka_unit_test(test_az_iot_hub_client_request_table_resolve_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_request_table_resolve_unknown_fail),
+    cmocka_unit_test(test_az_iot_hub_client_request_table_add_full_fail),
+    cmocka_unit_test(test_az_iot_hub_client_request_table_remove_expired_succeed),
+  };
+  return cmocka_run_group_tests_name("az_iot_hub_requests", tests, NULL, NULL);
+}
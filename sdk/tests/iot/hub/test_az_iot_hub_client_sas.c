@@ -343,6 +343,43 @@ static void az_iot_hub_client_sas_get_password_module_with_keyname_succeeds()
   assert_memory_equal(password, expected_password, length + 1); // +1 to account for '\0'.
 }
 
+static void az_iot_hub_client_sas_get_password_measure_succeeds()
+{
+  az_iot_hub_client client;
+  az_iot_hub_client_options options;
+  options.module_id = test_module_id;
+  assert_true(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, &options) == AZ_OK);
+
+  const char expected_password[]
+      = "SharedAccessSignature sr=" TEST_DEVICE_HOSTNAME_STR "%2Fdevices%2F" TEST_DEVICE_ID_STR
+        "%2Fmodules%2F" TEST_MODULE_ID_STR "&sig=" TEST_URL_ENC_SIG "&se=" TEST_EXPIRATION_STR
+        "&skn=" TEST_KEY_NAME;
+
+  az_span key_name = AZ_SPAN_FROM_STR(TEST_KEY_NAME);
+
+  // A NULL buffer of size 0 only gets the length, which is exactly what the password needs.
+  size_t length = 0;
+  assert_true(az_result_succeeded(az_iot_hub_client_sas_get_password(
+      &client, test_sas_expiry_time_secs, test_signature, key_name, NULL, 0, &length)));
+  assert_int_equal(length, _az_COUNTOF(expected_password) - 1);
+
+  char password[_az_COUNTOF(expected_password)];
+  assert_true(az_result_succeeded(az_iot_hub_client_sas_get_password(
+      &client, test_sas_expiry_time_secs, test_signature, key_name, password, length + 1, NULL)));
+  assert_memory_equal(password, expected_password, length + 1); // +1 to account for '\0'.
+
+  // The length of the resource URI is the one cached, if any.
+  uint8_t resource_uri[TEST_SPAN_BUFFER_SIZE];
+  assert_int_equal(
+      az_iot_hub_client_sas_cache_resource_uri(&client, AZ_SPAN_FROM_BUFFER(resource_uri)),
+      AZ_OK);
+  size_t cached_length = 0;
+  assert_true(az_result_succeeded(az_iot_hub_client_sas_get_password(
+      &client, test_sas_expiry_time_secs, test_signature, key_name, NULL, 0, &cached_length)));
+  assert_int_equal(cached_length, length);
+}
+
 static void az_iot_hub_client_sas_get_password_device_overflow_fails()
 {
   az_iot_hub_client client;
@@ -421,6 +458,220 @@ static void az_iot_hub_client_sas_get_signature_module_signature_overflow_fails(
       AZ_ERROR_NOT_ENOUGH_SPACE);
 }
 
+static void az_iot_hub_client_sas_cache_resource_uri_module_succeeds()
+{
+  az_iot_hub_client client;
+  az_iot_hub_client_options options = az_iot_hub_client_options_default();
+  options.module_id = test_module_id;
+  assert_true(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, &options) == AZ_OK);
+
+  // The resource URI doesn't fit, so it keeps being encoded for every token.
+  uint8_t small_buffer[30];
+  assert_int_equal(
+      az_iot_hub_client_sas_cache_resource_uri(
+          &client, az_span_create(small_buffer, _az_COUNTOF(small_buffer))),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  uint8_t resource_uri_buffer[TEST_SPAN_BUFFER_SIZE];
+  assert_int_equal(
+      az_iot_hub_client_sas_cache_resource_uri(
+          &client, az_span_create(resource_uri_buffer, _az_COUNTOF(resource_uri_buffer))),
+      AZ_OK);
+
+  const char expected_signature[] = TEST_DEVICE_HOSTNAME_STR "%2Fdevices%2F" TEST_DEVICE_ID_STR
+                                    "%2Fmodules%2F" TEST_MODULE_ID_STR "\n" TEST_EXPIRATION_STR;
+
+  uint8_t signature_buffer[TEST_SPAN_BUFFER_SIZE];
+  az_span signature = az_span_for_test_init(signature_buffer, _az_COUNTOF(signature_buffer));
+  az_span out_signature;
+
+  assert_true(az_result_succeeded(az_iot_hub_client_sas_get_signature(
+      &client, test_sas_expiry_time_secs, signature, &out_signature)));
+
+  az_span_for_test_verify(
+      out_signature,
+      expected_signature,
+      _az_COUNTOF(expected_signature) - 1,
+      signature,
+      TEST_SPAN_BUFFER_SIZE);
+
+  const char expected_password[]
+      = "SharedAccessSignature sr=" TEST_DEVICE_HOSTNAME_STR "%2Fdevices%2F" TEST_DEVICE_ID_STR
+        "%2Fmodules%2F" TEST_MODULE_ID_STR "&sig=" TEST_URL_ENC_SIG "&se=" TEST_EXPIRATION_STR;
+
+  char password[TEST_SPAN_BUFFER_SIZE];
+  size_t length = 0;
+
+  assert_true(az_result_succeeded(az_iot_hub_client_sas_get_password(
+      &client,
+      test_sas_expiry_time_secs,
+      test_signature,
+      AZ_SPAN_EMPTY,
+      password,
+      _az_COUNTOF(password),
+      &length)));
+
+  assert_int_equal(length, _az_COUNTOF(expected_password) - 1);
+  assert_memory_equal(password, expected_password, length + 1); // +1 to account for '\0'.
+}
+
+// Gets the password of a device one token at a time, to compare with the batch API.
+static void _get_device_password(
+    az_span device_id,
+    az_iot_sas_key const* sas_key,
+    az_span key_name,
+    char* password,
+    size_t password_size,
+    size_t* out_length)
+{
+  az_iot_hub_client client;
+  assert_int_equal(az_iot_hub_client_init(&client, test_device_hostname, device_id, NULL), AZ_OK);
+
+  uint8_t signature_buffer[TEST_SPAN_BUFFER_SIZE];
+  az_span signature;
+  assert_int_equal(
+      az_iot_hub_client_sas_get_signature(
+          &client, test_sas_expiry_time_secs, AZ_SPAN_FROM_BUFFER(signature_buffer), &signature),
+      AZ_OK);
+
+  uint8_t signed_signature_buffer[AZ_IOT_BASE64_HMAC_SHA256_SIZE];
+  az_span signed_signature;
+  assert_int_equal(
+      az_iot_sas_key_sign(
+          sas_key, signature, AZ_SPAN_FROM_BUFFER(signed_signature_buffer), &signed_signature),
+      AZ_OK);
+
+  assert_int_equal(
+      az_iot_hub_client_sas_get_password(
+          &client,
+          test_sas_expiry_time_secs,
+          signed_signature,
+          key_name,
+          password,
+          password_size,
+          out_length),
+      AZ_OK);
+}
+
+static void az_iot_hub_client_sas_get_passwords_succeeds()
+{
+  az_iot_sas_key sas_key;
+  assert_int_equal(az_iot_sas_key_init(&sas_key, AZ_SPAN_FROM_STR("policy key")), AZ_OK);
+
+  az_span const device_ids[]
+      = { AZ_SPAN_LITERAL_FROM_STR(TEST_DEVICE_ID_STR), AZ_SPAN_LITERAL_FROM_STR("device/2") };
+  az_span key_name = AZ_SPAN_FROM_STR(TEST_KEY_NAME);
+
+  uint8_t passwords_buffer[2 * TEST_SPAN_BUFFER_SIZE];
+  az_span passwords[2];
+  assert_int_equal(
+      az_iot_hub_client_sas_get_passwords(
+          test_device_hostname,
+          device_ids,
+          2,
+          test_sas_expiry_time_secs,
+          &sas_key,
+          false,
+          key_name,
+          AZ_SPAN_FROM_BUFFER(passwords_buffer),
+          passwords),
+      AZ_OK);
+
+  for (int32_t i = 0; i < 2; i++)
+  {
+    char expected_password[TEST_SPAN_BUFFER_SIZE];
+    size_t expected_length = 0;
+    _get_device_password(
+        device_ids[i],
+        &sas_key,
+        key_name,
+        expected_password,
+        sizeof(expected_password),
+        &expected_length);
+
+    assert_int_equal(az_span_size(passwords[i]), expected_length);
+    // +1 to account for '\0'.
+    assert_memory_equal(az_span_ptr(passwords[i]), expected_password, expected_length + 1);
+  }
+
+  // The passwords are contiguous.
+  assert_ptr_equal(az_span_ptr(passwords[0]), passwords_buffer);
+  assert_ptr_equal(
+      az_span_ptr(passwords[1]), az_span_ptr(passwords[0]) + az_span_size(passwords[0]) + 1);
+}
+
+static void az_iot_hub_client_sas_get_passwords_derived_keys_succeeds()
+{
+  az_span group_key = AZ_SPAN_FROM_STR("group key");
+  az_iot_sas_key group_sas_key;
+  assert_int_equal(az_iot_sas_key_init(&group_sas_key, group_key), AZ_OK);
+
+  az_span const device_ids[] = { AZ_SPAN_LITERAL_FROM_STR(TEST_DEVICE_ID_STR) };
+
+  uint8_t passwords_buffer[TEST_SPAN_BUFFER_SIZE];
+  az_span passwords[1];
+  assert_int_equal(
+      az_iot_hub_client_sas_get_passwords(
+          test_device_hostname,
+          device_ids,
+          1,
+          test_sas_expiry_time_secs,
+          &group_sas_key,
+          true,
+          AZ_SPAN_EMPTY,
+          AZ_SPAN_FROM_BUFFER(passwords_buffer),
+          passwords),
+      AZ_OK);
+
+  uint8_t device_key[AZ_IOT_HMAC_SHA256_SIZE];
+  assert_int_equal(
+      az_iot_hmac_sha256(group_key, device_ids[0], AZ_SPAN_FROM_BUFFER(device_key)), AZ_OK);
+  az_iot_sas_key device_sas_key;
+  assert_int_equal(az_iot_sas_key_init(&device_sas_key, AZ_SPAN_FROM_BUFFER(device_key)), AZ_OK);
+
+  char expected_password[TEST_SPAN_BUFFER_SIZE];
+  size_t expected_length = 0;
+  _get_device_password(
+      device_ids[0],
+      &device_sas_key,
+      AZ_SPAN_EMPTY,
+      expected_password,
+      sizeof(expected_password),
+      &expected_length);
+
+  assert_int_equal(az_span_size(passwords[0]), expected_length);
+  assert_memory_equal(az_span_ptr(passwords[0]), expected_password, expected_length + 1);
+}
+
+static void az_iot_hub_client_sas_get_passwords_overflow_fails()
+{
+  az_iot_sas_key sas_key;
+  assert_int_equal(az_iot_sas_key_init(&sas_key, AZ_SPAN_FROM_STR("policy key")), AZ_OK);
+
+  az_span const device_ids[]
+      = { AZ_SPAN_LITERAL_FROM_STR(TEST_DEVICE_ID_STR), AZ_SPAN_LITERAL_FROM_STR("device/2") };
+
+  // Enough for the first password only.
+  uint8_t passwords_buffer[200];
+  az_span passwords[2] = { AZ_SPAN_EMPTY, AZ_SPAN_EMPTY };
+  assert_int_equal(
+      az_iot_hub_client_sas_get_passwords(
+          test_device_hostname,
+          device_ids,
+          2,
+          test_sas_expiry_time_secs,
+          &sas_key,
+          false,
+          AZ_SPAN_EMPTY,
+          AZ_SPAN_FROM_BUFFER(passwords_buffer),
+          passwords),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  assert_true(az_span_size(passwords[0]) > 0);
+  assert_int_equal(az_span_size(passwords[1]), 0);
+}
+
 static int _log_invoked_sas = 0;
 static void _log_listener(az_log_classification classification, az_span message)
 {
@@ -529,10 +780,15 @@ int test_az_iot_hub_client_sas_token()
     cmocka_unit_test(az_iot_hub_client_sas_get_password_module_succeeds),
     cmocka_unit_test(az_iot_hub_client_sas_get_password_device_with_keyname_succeeds),
     cmocka_unit_test(az_iot_hub_client_sas_get_password_module_with_keyname_succeeds),
+    cmocka_unit_test(az_iot_hub_client_sas_get_password_measure_succeeds),
     cmocka_unit_test(az_iot_hub_client_sas_get_password_device_overflow_fails),
     cmocka_unit_test(az_iot_hub_client_sas_get_password_module_overflow_fails),
     cmocka_unit_test(az_iot_hub_client_sas_get_signature_device_signature_overflow_fails),
     cmocka_unit_test(az_iot_hub_client_sas_get_signature_module_signature_overflow_fails),
+    cmocka_unit_test(az_iot_hub_client_sas_cache_resource_uri_module_succeeds),
+    cmocka_unit_test(az_iot_hub_client_sas_get_passwords_succeeds),
+    cmocka_unit_test(az_iot_hub_client_sas_get_passwords_derived_keys_succeeds),
+    cmocka_unit_test(az_iot_hub_client_sas_get_passwords_overflow_fails),
     cmocka_unit_test(test_az_iot_hub_client_sas_logging_succeed),
     cmocka_unit_test(test_az_iot_hub_client_sas_no_logging_succeed),
   };
@@ -318,6 +318,205 @@ test_az_iot_hub_client_telemetry_get_publish_topic_with_options_module_id_with_p
       == AZ_ERROR_NOT_ENOUGH_SPACE);
 }
 
+static void test_az_iot_hub_client_telemetry_get_publish_topic_prefix_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_options options = az_iot_hub_client_options_default();
+  options.module_id = test_module_id;
+
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, &options), AZ_OK);
+
+  az_iot_message_properties props;
+  assert_int_equal(
+      az_iot_message_properties_init(&props, test_props, az_span_size(test_props)), AZ_OK);
+
+  char test_buf[TEST_SPAN_BUFFER_SIZE];
+  size_t prefix_length;
+  size_t test_length;
+
+  assert_int_equal(
+      az_iot_hub_client_telemetry_get_publish_topic_prefix(
+          &client, test_buf, sizeof(test_buf), &prefix_length),
+      AZ_OK);
+  assert_string_equal(g_test_correct_topic_with_options_no_props, test_buf);
+  assert_int_equal(sizeof(g_test_correct_topic_with_options_no_props) - 1, prefix_length);
+
+  assert_int_equal(
+      az_iot_hub_client_telemetry_set_publish_topic_properties(
+          &props, test_buf, sizeof(test_buf), prefix_length, &test_length),
+      AZ_OK);
+  assert_string_equal(g_test_correct_topic_with_options_with_props, test_buf);
+  assert_int_equal(sizeof(g_test_correct_topic_with_options_with_props) - 1, test_length);
+
+  // The next message reuses the same prefix.
+  assert_int_equal(
+      az_iot_hub_client_telemetry_set_publish_topic_properties(
+          NULL, test_buf, sizeof(test_buf), prefix_length, &test_length),
+      AZ_OK);
+  assert_string_equal(g_test_correct_topic_with_options_no_props, test_buf);
+  assert_int_equal(sizeof(g_test_correct_topic_with_options_no_props) - 1, test_length);
+}
+
+static void test_az_iot_hub_client_telemetry_get_publish_topic_prefix_small_buffer_fails(
+    void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL), AZ_OK);
+
+  char test_buf[sizeof(g_test_correct_topic_no_options_no_props) - 1];
+  size_t prefix_length;
+
+  assert_int_equal(
+      az_iot_hub_client_telemetry_get_publish_topic_prefix(
+          &client, test_buf, sizeof(test_buf), &prefix_length),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void test_az_iot_hub_client_telemetry_set_publish_topic_properties_small_buffer_fails(
+    void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL), AZ_OK);
+
+  az_iot_message_properties props;
+  assert_int_equal(
+      az_iot_message_properties_init(&props, test_props, az_span_size(test_props)), AZ_OK);
+
+  char test_buf[sizeof(g_test_correct_topic_no_options_with_props) - 1];
+  size_t prefix_length;
+  size_t test_length;
+
+  assert_int_equal(
+      az_iot_hub_client_telemetry_get_publish_topic_prefix(
+          &client, test_buf, sizeof(test_buf), &prefix_length),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_set_publish_topic_properties(
+          &props, test_buf, sizeof(test_buf), prefix_length, &test_length),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_string_equal(g_test_correct_topic_no_options_no_props, test_buf);
+}
+
+static void test_az_iot_hub_client_telemetry_batch_get_payload_succeed(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[TEST_SPAN_BUFFER_SIZE];
+  az_iot_hub_client_telemetry_batch batch;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_batch_init(&batch, AZ_SPAN_FROM_BUFFER(buffer), 4, 100), AZ_OK);
+
+  assert_true(az_span_is_content_equal(
+      az_iot_hub_client_telemetry_batch_get_payload(&batch), AZ_SPAN_FROM_STR("[]")));
+
+  assert_int_equal(
+      az_iot_hub_client_telemetry_batch_append(&batch, AZ_SPAN_FROM_STR("{\"t\":21.5}"), 0), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_batch_append(&batch, AZ_SPAN_FROM_STR("{\"t\":22}"), 10), AZ_OK);
+
+  // Invalid JSON leaves the batch unchanged.
+  assert_int_not_equal(
+      az_iot_hub_client_telemetry_batch_append(&batch, AZ_SPAN_FROM_STR("{\"t\":"), 20), AZ_OK);
+  assert_int_equal(az_iot_hub_client_telemetry_batch_count(&batch), 2);
+
+  assert_true(az_span_is_content_equal(
+      az_iot_hub_client_telemetry_batch_get_payload(&batch),
+      AZ_SPAN_FROM_STR("[{\"t\":21.5},{\"t\":22}]")));
+
+  az_iot_hub_client_telemetry_batch_clear(&batch);
+  assert_int_equal(az_iot_hub_client_telemetry_batch_count(&batch), 0);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_batch_append(&batch, AZ_SPAN_FROM_STR("3"), 0), AZ_OK);
+  assert_true(az_span_is_content_equal(
+      az_iot_hub_client_telemetry_batch_get_payload(&batch), AZ_SPAN_FROM_STR("[3]")));
+}
+
+static void test_az_iot_hub_client_telemetry_batch_should_flush_succeed(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[TEST_SPAN_BUFFER_SIZE];
+  az_iot_hub_client_telemetry_batch batch;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_batch_init(&batch, AZ_SPAN_FROM_BUFFER(buffer), 2, 100), AZ_OK);
+
+  assert_false(az_iot_hub_client_telemetry_batch_should_flush(&batch, 1000));
+
+  assert_int_equal(
+      az_iot_hub_client_telemetry_batch_append(&batch, AZ_SPAN_FROM_STR("1"), 1000), AZ_OK);
+  assert_false(az_iot_hub_client_telemetry_batch_should_flush(&batch, 1099));
+  assert_true(az_iot_hub_client_telemetry_batch_should_flush(&batch, 1100));
+
+  assert_int_equal(
+      az_iot_hub_client_telemetry_batch_append(&batch, AZ_SPAN_FROM_STR("2"), 1010), AZ_OK);
+  assert_true(az_iot_hub_client_telemetry_batch_should_flush(&batch, 1010));
+
+  assert_int_equal(
+      az_iot_hub_client_telemetry_batch_append(&batch, AZ_SPAN_FROM_STR("3"), 1020),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void test_az_iot_hub_client_telemetry_batch_append_small_buffer_fails(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[80];
+  az_iot_hub_client_telemetry_batch batch;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_batch_init(&batch, AZ_SPAN_FROM_BUFFER(buffer), 10, 100), AZ_OK);
+
+  az_span const message = AZ_SPAN_FROM_STR(
+      "{\"temperature\":21.5,\"humidity\":40.25,\"pressure\":1013.25,\"co2\":4}");
+  assert_int_equal(az_iot_hub_client_telemetry_batch_append(&batch, message, 0), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_batch_append(&batch, AZ_SPAN_FROM_STR("1"), 0),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  az_span const payload = az_iot_hub_client_telemetry_batch_get_payload(&batch);
+  assert_int_equal(az_span_size(payload), az_span_size(message) + 2);
+  assert_true(
+      az_span_is_content_equal(az_span_slice(payload, 1, az_span_size(message) + 1), message));
+}
+
+static void test_az_iot_hub_client_telemetry_batch_append_properties_succeed(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[TEST_SPAN_BUFFER_SIZE];
+  az_iot_message_properties props;
+  assert_int_equal(
+      az_iot_message_properties_init(&props, AZ_SPAN_FROM_BUFFER(buffer), 0), AZ_OK);
+
+  assert_int_equal(az_iot_hub_client_telemetry_batch_append_properties(&props), AZ_OK);
+  assert_true(az_span_is_content_equal(
+      az_span_slice(props._internal.properties_buffer, 0, props._internal.properties_written),
+      AZ_SPAN_FROM_STR("%24.ct=application%2Fjson&%24.ce=utf-8")));
+}
+
+static void test_az_iot_hub_client_telemetry_append_cbor_properties_succeed(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[TEST_SPAN_BUFFER_SIZE];
+  az_iot_message_properties props;
+  assert_int_equal(
+      az_iot_message_properties_init(&props, AZ_SPAN_FROM_BUFFER(buffer), 0), AZ_OK);
+
+  assert_int_equal(az_iot_hub_client_telemetry_append_cbor_properties(&props), AZ_OK);
+  assert_true(az_span_is_content_equal(
+      az_span_slice(props._internal.properties_buffer, 0, props._internal.properties_written),
+      AZ_SPAN_FROM_STR("%24.ct=application%2Fcbor")));
+}
+
 int test_az_iot_hub_client_telemetry()
 {
 #ifndef AZ_NO_PRECONDITION_CHECKING
@@ -348,6 +547,15 @@ int test_az_iot_hub_client_telemetry()
         test_az_iot_hub_client_telemetry_get_publish_topic_with_options_module_id_with_props_succeed),
     cmocka_unit_test(
         test_az_iot_hub_client_telemetry_get_publish_topic_with_options_module_id_with_props_small_buffer_fails),
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_get_publish_topic_prefix_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_get_publish_topic_prefix_small_buffer_fails),
+    cmocka_unit_test(
+        test_az_iot_hub_client_telemetry_set_publish_topic_properties_small_buffer_fails),
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_batch_get_payload_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_batch_should_flush_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_batch_append_small_buffer_fails),
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_batch_append_properties_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_append_cbor_properties_succeed),
   };
 
   return cmocka_run_group_tests_name("az_iot_hub_client_telemetry", tests, NULL, NULL);
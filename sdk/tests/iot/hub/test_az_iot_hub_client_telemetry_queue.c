@@ -0,0 +1,197 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_hub_client.h"
+#include <azure/core/az_span.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#define TEST_TOPIC "devices/useragent_c/messages/events/"
+
+// Two 20 byte headers, then a 110 byte ring.
+#define TEST_STORAGE_SIZE 150
+#define TEST_RING_OFFSET 40
+
+static void _test_queue_read(
+    az_iot_hub_client_telemetry_queue const* queue,
+    az_iot_hub_client_telemetry_queue_cursor* cursor,
+    az_span expected_payload)
+{
+  az_span topic;
+  az_span payload;
+  assert_int_equal(az_iot_hub_client_telemetry_queue_read(queue, cursor, &topic, &payload), AZ_OK);
+  assert_true(az_span_is_content_equal(topic, AZ_SPAN_FROM_STR(TEST_TOPIC)));
+  assert_true(az_span_is_content_equal(payload, expected_payload));
+}
+
+static void test_az_iot_hub_client_telemetry_queue_append_read_remove_succeed()
+{
+  uint8_t storage[TEST_STORAGE_SIZE] = { 0 };
+  az_iot_hub_client_telemetry_queue queue;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_init(&queue, AZ_SPAN_FROM_BUFFER(storage)), AZ_OK);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_count(&queue), 0);
+
+  az_span const topic = AZ_SPAN_FROM_STR(TEST_TOPIC);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("{}")), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("[]")), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_BUFFER(storage)),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_count(&queue), 2);
+
+  // The messages are restored from the storage after a restart.
+  az_iot_hub_client_telemetry_queue restored;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_init(&restored, AZ_SPAN_FROM_BUFFER(storage)), AZ_OK);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_count(&restored), 2);
+
+  az_iot_hub_client_telemetry_queue_cursor cursor;
+  az_iot_hub_client_telemetry_queue_cursor_init(&restored, &cursor);
+  _test_queue_read(&restored, &cursor, AZ_SPAN_FROM_STR("{}"));
+  _test_queue_read(&restored, &cursor, AZ_SPAN_FROM_STR("[]"));
+  az_span read_topic;
+  az_span read_payload;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_read(&restored, &cursor, &read_topic, &read_payload),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  az_iot_hub_client_telemetry_queue_remove(&restored, 1);
+  az_iot_hub_client_telemetry_queue_cursor_init(&restored, &cursor);
+  _test_queue_read(&restored, &cursor, AZ_SPAN_FROM_STR("[]"));
+
+  az_iot_hub_client_telemetry_queue_remove(&restored, 1);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_init(&restored, AZ_SPAN_FROM_BUFFER(storage)), AZ_OK);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_count(&restored), 0);
+}
+
+static void test_az_iot_hub_client_telemetry_queue_wrap_succeed()
+{
+  uint8_t storage[TEST_STORAGE_SIZE];
+  memset(storage, 0xFF, sizeof(storage));
+  az_iot_hub_client_telemetry_queue queue;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_init(&queue, AZ_SPAN_FROM_BUFFER(storage)), AZ_OK);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_count(&queue), 0);
+
+  // Each message takes 10 bytes of overhead, 36 of topic and the payload.
+  az_span const topic = AZ_SPAN_FROM_STR(TEST_TOPIC);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("aa")), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("b")), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("c")),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  // A message which doesn't fit before the end of the ring wraps to its start.
+  az_iot_hub_client_telemetry_queue_remove(&queue, 1);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("c")), AZ_OK);
+  az_iot_hub_client_telemetry_queue_remove(&queue, 1);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("d")), AZ_OK);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_count(&queue), 2);
+
+  az_iot_hub_client_telemetry_queue restored;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_init(&restored, AZ_SPAN_FROM_BUFFER(storage)), AZ_OK);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_count(&restored), 2);
+
+  az_iot_hub_client_telemetry_queue_cursor cursor;
+  az_iot_hub_client_telemetry_queue_cursor_init(&restored, &cursor);
+  _test_queue_read(&restored, &cursor, AZ_SPAN_FROM_STR("c"));
+  _test_queue_read(&restored, &cursor, AZ_SPAN_FROM_STR("d"));
+}
+
+static void test_az_iot_hub_client_telemetry_queue_largest_message_succeed()
+{
+  uint8_t storage[TEST_STORAGE_SIZE] = { 0 };
+  az_iot_hub_client_telemetry_queue queue;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_init(&queue, AZ_SPAN_FROM_BUFFER(storage)), AZ_OK);
+
+  // The largest message takes the ring less a message header: 110 - 6 bytes, of which 10 bytes of
+  // overhead and 36 of topic.
+  uint8_t payload_buffer[59];
+  memset(payload_buffer, 'a', sizeof(payload_buffer));
+  az_span const topic = AZ_SPAN_FROM_STR(TEST_TOPIC);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_BUFFER(payload_buffer)),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  az_span const payload = az_span_create(payload_buffer, sizeof(payload_buffer) - 1);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_append(&queue, topic, payload), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("b")),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  az_iot_hub_client_telemetry_queue restored;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_init(&restored, AZ_SPAN_FROM_BUFFER(storage)), AZ_OK);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_count(&restored), 1);
+
+  az_iot_hub_client_telemetry_queue_cursor cursor;
+  az_iot_hub_client_telemetry_queue_cursor_init(&restored, &cursor);
+  _test_queue_read(&restored, &cursor, payload);
+
+  az_iot_hub_client_telemetry_queue_remove(&restored, 1);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_append(&restored, topic, payload), AZ_OK);
+}
+
+static void test_az_iot_hub_client_telemetry_queue_recover_succeed()
+{
+  uint8_t storage[TEST_STORAGE_SIZE] = { 0 };
+  az_iot_hub_client_telemetry_queue queue;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_init(&queue, AZ_SPAN_FROM_BUFFER(storage)), AZ_OK);
+
+  az_span const topic = AZ_SPAN_FROM_STR(TEST_TOPIC);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("a")), AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("b")), AZ_OK);
+
+  // An interrupted header write leaves the previous state.
+  uint8_t saved[TEST_STORAGE_SIZE];
+  memcpy(saved, storage, sizeof(storage));
+  storage[20 + 8] ^= 1; // The head of the second header, written last.
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_init(&queue, AZ_SPAN_FROM_BUFFER(storage)), AZ_OK);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_count(&queue), 1);
+
+  // A corrupt message is dropped, with the ones after it.
+  memcpy(storage, saved, sizeof(storage));
+  storage[TEST_RING_OFFSET + 47 + 6 + 36] ^= 1;
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_init(&queue, AZ_SPAN_FROM_BUFFER(storage)), AZ_OK);
+  assert_int_equal(az_iot_hub_client_telemetry_queue_count(&queue), 1);
+
+  assert_int_equal(
+      az_iot_hub_client_telemetry_queue_append(&queue, topic, AZ_SPAN_FROM_STR("c")), AZ_OK);
+  az_iot_hub_client_telemetry_queue_cursor cursor;
+  az_iot_hub_client_telemetry_queue_cursor_init(&queue, &cursor);
+  _test_queue_read(&queue, &cursor, AZ_SPAN_FROM_STR("a"));
+  _test_queue_read(&queue, &cursor, AZ_SPAN_FROM_STR("c"));
+}
+
+int test_az_iot_hub_client_telemetry_queue()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_queue_append_read_remove_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_queue_wrap_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_queue_largest_message_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_telemetry_queue_recover_succeed),
+  };
+  return cmocka_run_group_tests_name("az_iot_hub_telemetry_queue", tests, NULL, NULL);
+}
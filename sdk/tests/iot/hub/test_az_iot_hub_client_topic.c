@@ -0,0 +1,252 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_hub_client.h"
+#include <az_test_precondition.h>
+#include <azure/core/az_precondition.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#define TEST_DEVICE_ID_STR "my_device"
+#define TEST_DEVICE_HOSTNAME_STR "myiothub.azure-devices.net"
+
+static const az_span test_device_hostname = AZ_SPAN_LITERAL_FROM_STR(TEST_DEVICE_HOSTNAME_STR);
+static const az_span test_device_id = AZ_SPAN_LITERAL_FROM_STR(TEST_DEVICE_ID_STR);
+
+static void _init_client(az_iot_hub_client* client)
+{
+  assert_int_equal(
+      az_iot_hub_client_init(client, test_device_hostname, test_device_id, NULL), AZ_OK);
+}
+
+#ifndef AZ_NO_PRECONDITION_CHECKING
+ENABLE_PRECONDITION_CHECK_TESTS()
+
+static void test_az_iot_hub_client_topic_parse_NULL_client_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_topic out_topic;
+
+  ASSERT_PRECONDITION_CHECKED(az_iot_hub_client_topic_parse(
+      NULL, AZ_SPAN_FROM_STR("$iothub/methods/POST/TestMethod/?$rid=1"), &out_topic));
+}
+
+static void test_az_iot_hub_client_topic_parse_AZ_SPAN_EMPTY_received_topic_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  _init_client(&client);
+
+  az_iot_hub_client_topic out_topic;
+
+  ASSERT_PRECONDITION_CHECKED(az_iot_hub_client_topic_parse(&client, AZ_SPAN_EMPTY, &out_topic));
+}
+
+static void test_az_iot_hub_client_topic_parse_NULL_out_topic_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  _init_client(&client);
+
+  ASSERT_PRECONDITION_CHECKED(az_iot_hub_client_topic_parse(
+      &client, AZ_SPAN_FROM_STR("$iothub/methods/POST/TestMethod/?$rid=1"), NULL));
+}
+
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+static void test_az_iot_hub_client_topic_parse_c2d_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  _init_client(&client);
+
+  az_iot_hub_client_topic out_topic;
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client,
+          AZ_SPAN_FROM_STR("devices/useragent_c/messages/devicebound/$.mid=79eadb01&abc=123"),
+          &out_topic),
+      AZ_OK);
+  assert_int_equal(out_topic.type, AZ_IOT_HUB_CLIENT_TOPIC_TYPE_C2D);
+
+  az_span value;
+  assert_int_equal(
+      az_iot_message_properties_find(
+          &out_topic.parsed.c2d.properties, AZ_SPAN_FROM_STR("abc"), &value),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("123")));
+}
+
+static void test_az_iot_hub_client_topic_parse_c2d_no_props_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  _init_client(&client);
+
+  az_iot_hub_client_topic out_topic;
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client, AZ_SPAN_FROM_STR("devices/useragent_c/messages/devicebound/"), &out_topic),
+      AZ_OK);
+  assert_int_equal(out_topic.type, AZ_IOT_HUB_CLIENT_TOPIC_TYPE_C2D);
+  assert_int_equal(
+      az_span_size(out_topic.parsed.c2d.properties._internal.properties_buffer), 0);
+}
+
+static void test_az_iot_hub_client_topic_parse_method_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  _init_client(&client);
+
+  az_iot_hub_client_topic out_topic;
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client, AZ_SPAN_FROM_STR("$iothub/methods/POST/TestMethod/?$rid=1"), &out_topic),
+      AZ_OK);
+  assert_int_equal(out_topic.type, AZ_IOT_HUB_CLIENT_TOPIC_TYPE_METHOD);
+  assert_true(
+      az_span_is_content_equal(out_topic.parsed.method.name, AZ_SPAN_FROM_STR("TestMethod")));
+  assert_true(az_span_is_content_equal(out_topic.parsed.method.request_id, AZ_SPAN_FROM_STR("1")));
+}
+
+static void test_az_iot_hub_client_topic_parse_twin_get_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  _init_client(&client);
+
+  az_iot_hub_client_topic out_topic;
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client, AZ_SPAN_FROM_STR("$iothub/twin/res/200/?$rid=2"), &out_topic),
+      AZ_OK);
+  assert_int_equal(out_topic.type, AZ_IOT_HUB_CLIENT_TOPIC_TYPE_TWIN);
+  assert_int_equal(
+      out_topic.parsed.twin.response_type, AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_GET);
+  assert_int_equal(out_topic.parsed.twin.status, AZ_IOT_STATUS_OK);
+  assert_true(az_span_is_content_equal(out_topic.parsed.twin.request_id, AZ_SPAN_FROM_STR("2")));
+  assert_int_equal(az_span_size(out_topic.parsed.twin.version), 0);
+}
+
+static void test_az_iot_hub_client_topic_parse_twin_reported_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  _init_client(&client);
+
+  az_iot_hub_client_topic out_topic;
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client, AZ_SPAN_FROM_STR("$iothub/twin/res/204/?$rid=4&$version=3"), &out_topic),
+      AZ_OK);
+  assert_int_equal(out_topic.type, AZ_IOT_HUB_CLIENT_TOPIC_TYPE_TWIN);
+  assert_int_equal(
+      out_topic.parsed.twin.response_type,
+      AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_REPORTED_PROPERTIES);
+  assert_int_equal(out_topic.parsed.twin.status, AZ_IOT_STATUS_NO_CONTENT);
+  assert_true(az_span_is_content_equal(out_topic.parsed.twin.request_id, AZ_SPAN_FROM_STR("4")));
+  assert_true(az_span_is_content_equal(out_topic.parsed.twin.version, AZ_SPAN_FROM_STR("3")));
+}
+
+static void test_az_iot_hub_client_topic_parse_twin_desired_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  _init_client(&client);
+
+  az_iot_hub_client_topic out_topic;
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client, AZ_SPAN_FROM_STR("$iothub/twin/PATCH/properties/desired/?$version=16"),
+          &out_topic),
+      AZ_OK);
+  assert_int_equal(out_topic.type, AZ_IOT_HUB_CLIENT_TOPIC_TYPE_TWIN);
+  assert_int_equal(
+      out_topic.parsed.twin.response_type,
+      AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_DESIRED_PROPERTIES);
+  assert_int_equal(out_topic.parsed.twin.status, AZ_IOT_STATUS_OK);
+  assert_int_equal(az_span_size(out_topic.parsed.twin.request_id), 0);
+  assert_true(az_span_is_content_equal(out_topic.parsed.twin.version, AZ_SPAN_FROM_STR("16")));
+}
+
+static void test_az_iot_hub_client_topic_parse_no_match_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client client;
+  _init_client(&client);
+
+  az_iot_hub_client_topic out_topic;
+
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client, AZ_SPAN_FROM_STR("$iothub/methods/res/200/?$rid=2"), &out_topic),
+      AZ_ERROR_IOT_TOPIC_NO_MATCH);
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client, AZ_SPAN_FROM_STR("$iothub/methods/POST/TestMethod"), &out_topic),
+      AZ_ERROR_IOT_TOPIC_NO_MATCH);
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client, AZ_SPAN_FROM_STR("$iothub/twin/GET/?$rid=2"), &out_topic),
+      AZ_ERROR_IOT_TOPIC_NO_MATCH);
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client, AZ_SPAN_FROM_STR("devices/useragent_c/message#$vicebound/a=1"), &out_topic),
+      AZ_ERROR_IOT_TOPIC_NO_MATCH);
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(
+          &client,
+          AZ_SPAN_FROM_STR("$iothub/devices/useragent_c/messages/devicebound/abc=123"),
+          &out_topic),
+      AZ_ERROR_IOT_TOPIC_NO_MATCH);
+  assert_int_equal(
+      az_iot_hub_client_topic_parse(&client, AZ_SPAN_FROM_STR("$iot"), &out_topic),
+      AZ_ERROR_IOT_TOPIC_NO_MATCH);
+}
+
+#ifdef _MSC_VER
+// warning C4113: 'void (__cdecl *)()' differs in parameter lists from 'CMUnitTestFunction'
+#pragma warning(disable : 4113)
+#endif
+
+int test_az_iot_hub_client_topic()
+{
+#ifndef AZ_NO_PRECONDITION_CHECKING
+  SETUP_PRECONDITION_CHECK_TESTS();
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+  const struct CMUnitTest tests[] = {
+#ifndef AZ_NO_PRECONDITION_CHECKING
+    cmocka_unit_test(test_az_iot_hub_client_topic_parse_NULL_client_fail),
+    cmocka_unit_test(test_az_iot_hub_client_topic_parse_AZ_SPAN_EMPTY_received_topic_fail),
+    cmocka_unit_test(test_az_iot_hub_client_topic_parse_NULL_out_topic_fail),
+#endif // AZ_NO_PRECONDITION_CHECKING
+    cmocka_unit_test(test_az_iot_hub_client_topic_parse_c2d_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_topic_parse_c2d_no_props_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_topic_parse_method_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_topic_parse_twin_get_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_topic_parse_twin_reported_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_topic_parse_twin_desired_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_topic_parse_no_match_fail),
+  };
+  return cmocka_run_group_tests_name("az_iot_hub_topic", tests, NULL, NULL);
+}
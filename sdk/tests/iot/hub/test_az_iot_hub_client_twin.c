@@ -247,6 +247,57 @@ static void test_az_iot_hub_client_twin_patch_get_publish_topic_small_buffer_fai
       AZ_ERROR_NOT_ENOUGH_SPACE);
 }
 
+static void test_az_iot_hub_client_twin_document_get_publish_topic_u64_succeed()
+{
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL), AZ_OK);
+
+  char test_buf[TEST_SPAN_BUFFER_SIZE];
+  size_t test_length;
+  const char expected_topic[] = "$iothub/twin/GET/?$rid=18446744073709551615";
+
+  assert_int_equal(
+      az_iot_hub_client_twin_document_get_publish_topic_u64(
+          &client, UINT64_MAX, test_buf, sizeof(test_buf), &test_length),
+      AZ_OK);
+  assert_string_equal(expected_topic, test_buf);
+  assert_int_equal(sizeof(expected_topic) - 1, test_length);
+}
+
+static void test_az_iot_hub_client_twin_patch_get_publish_topic_u64_succeed()
+{
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL), AZ_OK);
+
+  char test_buf[TEST_SPAN_BUFFER_SIZE];
+  size_t test_length;
+  const char expected_topic[] = "$iothub/twin/PATCH/properties/reported/?$rid=0";
+
+  assert_int_equal(
+      az_iot_hub_client_twin_patch_get_publish_topic_u64(
+          &client, 0, test_buf, sizeof(test_buf), &test_length),
+      AZ_OK);
+  assert_string_equal(expected_topic, test_buf);
+  assert_int_equal(sizeof(expected_topic) - 1, test_length);
+}
+
+static void test_az_iot_hub_client_twin_patch_get_publish_topic_u64_small_buffer_fails()
+{
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL), AZ_OK);
+
+  char test_buf[sizeof("$iothub/twin/PATCH/properties/reported/?$rid=42") - 1];
+  size_t test_length;
+
+  assert_int_equal(
+      az_iot_hub_client_twin_patch_get_publish_topic_u64(
+          &client, 42, test_buf, sizeof(test_buf), &test_length),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
 static void test_az_iot_hub_client_twin_parse_received_topic_desired_found_succeed()
 {
   az_iot_hub_client client;
@@ -338,6 +389,40 @@ static void test_az_iot_hub_client_twin_parse_received_topic_not_found_prefix_fa
       AZ_ERROR_IOT_TOPIC_NO_MATCH);
 }
 
+static void test_az_iot_hub_client_twin_parse_received_topic_empty_status_fails()
+{
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL), AZ_OK);
+  az_iot_hub_client_twin_response response;
+
+  assert_int_equal(
+      az_iot_hub_client_twin_parse_received_topic(
+          &client, AZ_SPAN_FROM_STR("$iothub/twin/res//?$rid=2"), &response),
+      AZ_ERROR_UNEXPECTED_CHAR);
+}
+
+static void test_az_iot_hub_client_twin_parse_received_topic_truncated_fails()
+{
+  az_iot_hub_client client;
+  assert_int_equal(
+      az_iot_hub_client_init(&client, test_device_hostname, test_device_id, NULL), AZ_OK);
+  az_iot_hub_client_twin_response response;
+
+  assert_int_equal(
+      az_iot_hub_client_twin_parse_received_topic(
+          &client, AZ_SPAN_FROM_STR("$iothub/twin/res/"), &response),
+      AZ_ERROR_UNEXPECTED_END);
+  assert_int_equal(
+      az_iot_hub_client_twin_parse_received_topic(
+          &client, AZ_SPAN_FROM_STR("$iothub/twin/res/200/"), &response),
+      AZ_ERROR_UNEXPECTED_END);
+  assert_int_equal(
+      az_iot_hub_client_twin_parse_received_topic(
+          &client, AZ_SPAN_FROM_STR("$iothub/twin/PATCH/properties/desired/"), &response),
+      AZ_ERROR_UNEXPECTED_END);
+}
+
 static int _log_invoked_topic = 0;
 static void _log_listener(az_log_classification classification, az_span message)
 {
@@ -451,12 +536,17 @@ int test_az_iot_hub_client_twin()
     cmocka_unit_test(test_az_iot_hub_client_twin_document_get_publish_topic_small_buffer_fails),
     cmocka_unit_test(test_az_iot_hub_client_twin_patch_get_publish_topic_succeed),
     cmocka_unit_test(test_az_iot_hub_client_twin_patch_get_publish_topic_small_buffer_fails),
+    cmocka_unit_test(test_az_iot_hub_client_twin_document_get_publish_topic_u64_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_twin_patch_get_publish_topic_u64_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_twin_patch_get_publish_topic_u64_small_buffer_fails),
     cmocka_unit_test(test_az_iot_hub_client_twin_parse_received_topic_desired_found_succeed),
     cmocka_unit_test(test_az_iot_hub_client_twin_parse_received_topic_get_response_found_succeed),
     cmocka_unit_test(test_az_iot_hub_client_twin_parse_received_topic_reported_props_found_succeed),
     cmocka_unit_test(test_az_iot_hub_client_twin_parse_received_topic_not_found_fails),
     cmocka_unit_test(test_az_iot_hub_client_twin_parse_received_topic_not_found_incomplete_fails),
     cmocka_unit_test(test_az_iot_hub_client_twin_parse_received_topic_not_found_prefix_fails),
+    cmocka_unit_test(test_az_iot_hub_client_twin_parse_received_topic_empty_status_fails),
+    cmocka_unit_test(test_az_iot_hub_client_twin_parse_received_topic_truncated_fails),
     cmocka_unit_test(test_az_iot_hub_client_twin_logging_succeed),
     cmocka_unit_test(test_az_iot_hub_client_twin_no_logging_succeed),
   };
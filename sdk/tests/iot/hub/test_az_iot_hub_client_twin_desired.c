@@ -0,0 +1,249 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_hub_client.h"
+#include <az_test_precondition.h>
+#include <azure/core/az_json.h>
+#include <azure/core/az_precondition.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#define TEST_PROPERTY_COUNT 2
+
+static const az_span test_property_names[TEST_PROPERTY_COUNT]
+    = { AZ_SPAN_LITERAL_FROM_STR("targetTemperature"), AZ_SPAN_LITERAL_FROM_STR("thermostat1") };
+
+typedef struct
+{
+  int32_t count;
+  int32_t last_index;
+  int64_t last_version;
+  az_json_token_kind last_kind;
+} test_callback_state;
+
+static void _property_callback(
+    int32_t property_index,
+    az_json_reader* property_value,
+    int64_t version,
+    void* context)
+{
+  test_callback_state* state = (test_callback_state*)context;
+  state->count++;
+  state->last_index = property_index;
+  state->last_version = version;
+  state->last_kind = property_value->token.kind;
+}
+
+static void _init_twin(
+    az_iot_hub_client_twin_desired* twin,
+    az_json_property_name_table* table,
+    uint32_t name_hashes[],
+    uint32_t value_hashes[],
+    test_callback_state* state)
+{
+  *state = (test_callback_state){ 0 };
+  az_json_property_name_table_init(table, test_property_names, name_hashes, TEST_PROPERTY_COUNT);
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_init(twin, table, value_hashes, _property_callback, state),
+      AZ_OK);
+}
+
+static az_iot_hub_client_twin_response _desired_response(az_span version)
+{
+  az_iot_hub_client_twin_response response = { 0 };
+  response.response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_DESIRED_PROPERTIES;
+  response.status = AZ_IOT_STATUS_OK;
+  response.version = version;
+  return response;
+}
+
+#ifndef AZ_NO_PRECONDITION_CHECKING
+ENABLE_PRECONDITION_CHECK_TESTS()
+
+static void test_az_iot_hub_client_twin_desired_init_NULL_callback_fail(void** state)
+{
+  (void)state;
+
+  az_json_property_name_table table;
+  uint32_t name_hashes[TEST_PROPERTY_COUNT];
+  uint32_t value_hashes[TEST_PROPERTY_COUNT];
+  az_json_property_name_table_init(&table, test_property_names, name_hashes, TEST_PROPERTY_COUNT);
+
+  az_iot_hub_client_twin_desired twin;
+
+  ASSERT_PRECONDITION_CHECKED(
+      az_iot_hub_client_twin_desired_init(&twin, &table, value_hashes, NULL, NULL));
+}
+
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+static void test_az_iot_hub_client_twin_desired_apply_get_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_twin_desired twin;
+  az_json_property_name_table table;
+  uint32_t name_hashes[TEST_PROPERTY_COUNT];
+  uint32_t value_hashes[TEST_PROPERTY_COUNT];
+  test_callback_state callback_state;
+  _init_twin(&twin, &table, name_hashes, value_hashes, &callback_state);
+  assert_true(az_iot_hub_client_twin_desired_get_version(&twin) == -1);
+
+  az_iot_hub_client_twin_response response = { 0 };
+  response.response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_GET;
+  response.status = AZ_IOT_STATUS_OK;
+
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_apply(
+          &twin,
+          &response,
+          AZ_SPAN_FROM_STR("{\"reported\":{\"targetTemperature\":1,\"$version\":9},"
+                           "\"desired\":{\"targetTemperature\":20,\"other\":[1,2],"
+                           "\"thermostat1\":{\"__t\":\"c\",\"targetTemperature\":25},"
+                           "\"$version\":5}}")),
+      AZ_OK);
+  assert_int_equal(callback_state.count, 2);
+  assert_int_equal(callback_state.last_index, 1);
+  assert_int_equal(callback_state.last_kind, AZ_JSON_TOKEN_BEGIN_OBJECT);
+  assert_true(callback_state.last_version == 5);
+  assert_true(az_iot_hub_client_twin_desired_get_version(&twin) == 5);
+
+  // A failed GET response is ignored.
+  response.status = AZ_IOT_STATUS_THROTTLED;
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_apply(&twin, &response, AZ_SPAN_FROM_STR("{}")), AZ_OK);
+  assert_int_equal(callback_state.count, 2);
+}
+
+static void test_az_iot_hub_client_twin_desired_apply_patch_changed_only_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_twin_desired twin;
+  az_json_property_name_table table;
+  uint32_t name_hashes[TEST_PROPERTY_COUNT];
+  uint32_t value_hashes[TEST_PROPERTY_COUNT];
+  test_callback_state callback_state;
+  _init_twin(&twin, &table, name_hashes, value_hashes, &callback_state);
+
+  az_iot_hub_client_twin_response response = _desired_response(AZ_SPAN_FROM_STR("2"));
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_apply(
+          &twin,
+          &response,
+          AZ_SPAN_FROM_STR("{\"targetTemperature\":20,\"thermostat1\":{\"a\":1},\"$version\":2}")),
+      AZ_OK);
+  assert_int_equal(callback_state.count, 2);
+
+  // Only the component changed.
+  response = _desired_response(AZ_SPAN_FROM_STR("3"));
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_apply(
+          &twin,
+          &response,
+          AZ_SPAN_FROM_STR("{\"targetTemperature\":20,\"thermostat1\":{\"a\":2},\"$version\":3}")),
+      AZ_OK);
+  assert_int_equal(callback_state.count, 3);
+  assert_int_equal(callback_state.last_index, 1);
+  assert_true(callback_state.last_version == 3);
+
+  // The same digits as a string are a different value.
+  response = _desired_response(AZ_SPAN_FROM_STR("4"));
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_apply(
+          &twin, &response, AZ_SPAN_FROM_STR("{\"targetTemperature\":\"20\",\"$version\":4}")),
+      AZ_OK);
+  assert_int_equal(callback_state.count, 4);
+  assert_int_equal(callback_state.last_index, 0);
+  assert_int_equal(callback_state.last_kind, AZ_JSON_TOKEN_STRING);
+}
+
+static void test_az_iot_hub_client_twin_desired_apply_stale_version_ignored_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_twin_desired twin;
+  az_json_property_name_table table;
+  uint32_t name_hashes[TEST_PROPERTY_COUNT];
+  uint32_t value_hashes[TEST_PROPERTY_COUNT];
+  test_callback_state callback_state;
+  _init_twin(&twin, &table, name_hashes, value_hashes, &callback_state);
+
+  // The version comes from the payload when the topic has none.
+  az_iot_hub_client_twin_response response = _desired_response(AZ_SPAN_EMPTY);
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_apply(
+          &twin, &response, AZ_SPAN_FROM_STR("{\"targetTemperature\":20,\"$version\":7}")),
+      AZ_OK);
+  assert_int_equal(callback_state.count, 1);
+  assert_true(az_iot_hub_client_twin_desired_get_version(&twin) == 7);
+
+  response = _desired_response(AZ_SPAN_FROM_STR("7"));
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_apply(
+          &twin, &response, AZ_SPAN_FROM_STR("{\"targetTemperature\":21,\"$version\":7}")),
+      AZ_OK);
+  response = _desired_response(AZ_SPAN_FROM_STR("6"));
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_apply(
+          &twin, &response, AZ_SPAN_FROM_STR("{\"targetTemperature\":22,\"$version\":6}")),
+      AZ_OK);
+  assert_int_equal(callback_state.count, 1);
+  assert_true(az_iot_hub_client_twin_desired_get_version(&twin) == 7);
+}
+
+static void test_az_iot_hub_client_twin_desired_apply_no_version_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_twin_desired twin;
+  az_json_property_name_table table;
+  uint32_t name_hashes[TEST_PROPERTY_COUNT];
+  uint32_t value_hashes[TEST_PROPERTY_COUNT];
+  test_callback_state callback_state;
+  _init_twin(&twin, &table, name_hashes, value_hashes, &callback_state);
+
+  az_iot_hub_client_twin_response response = _desired_response(AZ_SPAN_EMPTY);
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_apply(
+          &twin, &response, AZ_SPAN_FROM_STR("{\"targetTemperature\":20}")),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  response.response_type = AZ_IOT_HUB_CLIENT_TWIN_RESPONSE_TYPE_GET;
+  assert_int_equal(
+      az_iot_hub_client_twin_desired_apply(
+          &twin, &response, AZ_SPAN_FROM_STR("{\"reported\":{\"$version\":1}}")),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(callback_state.count, 0);
+}
+
+#ifdef _MSC_VER
+// warning C4113: 'void (__cdecl *)()' differs in parameter lists from 'CMUnitTestFunction'
+#pragma warning(disable : 4113)
+#endif
+
+int test_az_iot_hub_client_twin_desired()
+{
+#ifndef AZ_NO_PRECONDITION_CHECKING
+  SETUP_PRECONDITION_CHECK_TESTS();
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+  const struct CMUnitTest tests[] = {
+#ifndef AZ_NO_PRECONDITION_CHECKING
+    cmocka_unit_test(test_az_iot_hub_client_twin_desired_init_NULL_callback_fail),
+#endif // AZ_NO_PRECONDITION_CHECKING
+    cmocka_unit_test(test_az_iot_hub_client_twin_desired_apply_get_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_twin_desired_apply_patch_changed_only_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_twin_desired_apply_stale_version_ignored_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_twin_desired_apply_no_version_fail),
+  };
+  return cmocka_run_group_tests_name("az_iot_hub_twin_desired", tests, NULL, NULL);
+}
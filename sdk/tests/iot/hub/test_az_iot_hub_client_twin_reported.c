@@ -0,0 +1,211 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_hub_client.h"
+#include <az_test_precondition.h>
+#include <azure/core/az_precondition.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/iot/az_iot_hub_client.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#define TEST_PROPERTIES_CAPACITY 4
+
+static const az_span test_thermostat1 = AZ_SPAN_LITERAL_FROM_STR("thermostat1");
+static const az_span test_thermostat2 = AZ_SPAN_LITERAL_FROM_STR("thermostat2");
+static const az_span test_max_temp = AZ_SPAN_LITERAL_FROM_STR("maxTempSinceLastReboot");
+static const az_span test_serial_number = AZ_SPAN_LITERAL_FROM_STR("serialNumber");
+
+#ifndef AZ_NO_PRECONDITION_CHECKING
+ENABLE_PRECONDITION_CHECK_TESTS()
+
+static void test_az_iot_hub_client_twin_reported_batch_init_NULL_properties_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_twin_reported_batch batch;
+  uint8_t values[64];
+
+  ASSERT_PRECONDITION_CHECKED(az_iot_hub_client_twin_reported_batch_init(
+      &batch, NULL, TEST_PROPERTIES_CAPACITY, AZ_SPAN_FROM_BUFFER(values), 0));
+}
+
+static void test_az_iot_hub_client_twin_reported_batch_append_EMPTY_property_name_fail(
+    void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_twin_reported_batch batch;
+  az_iot_hub_client_twin_reported_property properties[TEST_PROPERTIES_CAPACITY];
+  uint8_t values[64];
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_init(
+          &batch, properties, TEST_PROPERTIES_CAPACITY, AZ_SPAN_FROM_BUFFER(values), 0),
+      AZ_OK);
+
+  ASSERT_PRECONDITION_CHECKED(az_iot_hub_client_twin_reported_batch_append(
+      &batch, AZ_SPAN_EMPTY, AZ_SPAN_EMPTY, AZ_SPAN_FROM_STR("1"), 0));
+}
+
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+static void test_az_iot_hub_client_twin_reported_batch_get_payload_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_twin_reported_batch batch;
+  az_iot_hub_client_twin_reported_property properties[TEST_PROPERTIES_CAPACITY];
+  uint8_t values[64];
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_init(
+          &batch, properties, TEST_PROPERTIES_CAPACITY, AZ_SPAN_FROM_BUFFER(values), 0),
+      AZ_OK);
+
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, test_thermostat1, test_max_temp, AZ_SPAN_FROM_STR("22.5"), 0),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, AZ_SPAN_EMPTY, test_serial_number, AZ_SPAN_FROM_STR("\"SN-1\""), 0),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, test_thermostat2, test_max_temp, AZ_SPAN_FROM_STR("{\"value\":3}"), 0),
+      AZ_OK);
+  // Replaces the pending value.
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, test_thermostat1, test_max_temp, AZ_SPAN_FROM_STR("23"), 0),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, test_thermostat1, test_serial_number, AZ_SPAN_FROM_STR("null"), 0),
+      AZ_OK);
+  assert_int_equal(az_iot_hub_client_twin_reported_batch_count(&batch), 4);
+
+  uint8_t payload_buffer[256];
+  az_span payload;
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_get_payload(
+          &batch, AZ_SPAN_FROM_BUFFER(payload_buffer), &payload),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(
+      payload,
+      AZ_SPAN_FROM_STR("{\"thermostat1\":{\"__t\":\"c\",\"maxTempSinceLastReboot\":23,"
+                       "\"serialNumber\":null},\"serialNumber\":\"SN-1\","
+                       "\"thermostat2\":{\"__t\":\"c\","
+                       "\"maxTempSinceLastReboot\":{\"value\":3}}}")));
+
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_get_payload(
+          &batch, az_span_slice(AZ_SPAN_FROM_BUFFER(payload_buffer), 0, 32), &payload),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  az_iot_hub_client_twin_reported_batch_clear(&batch);
+  assert_int_equal(az_iot_hub_client_twin_reported_batch_count(&batch), 0);
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_get_payload(
+          &batch, AZ_SPAN_FROM_BUFFER(payload_buffer), &payload),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(payload, AZ_SPAN_FROM_STR("{}")));
+}
+
+static void test_az_iot_hub_client_twin_reported_batch_should_flush_succeed(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_twin_reported_batch batch;
+  az_iot_hub_client_twin_reported_property properties[2];
+  uint8_t values[64];
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_init(
+          &batch, properties, 2, AZ_SPAN_FROM_BUFFER(values), 100),
+      AZ_OK);
+
+  assert_false(az_iot_hub_client_twin_reported_batch_should_flush(&batch, 1000));
+
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, AZ_SPAN_EMPTY, test_serial_number, AZ_SPAN_FROM_STR("1"), 1000),
+      AZ_OK);
+  // Later updates don't push the deadline back.
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, AZ_SPAN_EMPTY, test_serial_number, AZ_SPAN_FROM_STR("2"), 1050),
+      AZ_OK);
+  assert_false(az_iot_hub_client_twin_reported_batch_should_flush(&batch, 1099));
+  assert_true(az_iot_hub_client_twin_reported_batch_should_flush(&batch, 1100));
+
+  // A full batch is flushed right away.
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, test_thermostat1, test_max_temp, AZ_SPAN_FROM_STR("3"), 1050),
+      AZ_OK);
+  assert_true(az_iot_hub_client_twin_reported_batch_should_flush(&batch, 1050));
+}
+
+static void test_az_iot_hub_client_twin_reported_batch_append_full_fail(void** state)
+{
+  (void)state;
+
+  az_iot_hub_client_twin_reported_batch batch;
+  az_iot_hub_client_twin_reported_property properties[1];
+  uint8_t values[8];
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_init(
+          &batch, properties, 1, AZ_SPAN_FROM_BUFFER(values), 0),
+      AZ_OK);
+
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, AZ_SPAN_EMPTY, test_serial_number, AZ_SPAN_FROM_STR("\"abc\""), 0),
+      AZ_OK);
+
+  // No room for another property.
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, test_thermostat1, test_max_temp, AZ_SPAN_FROM_STR("1"), 0),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  // No room for another value.
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, AZ_SPAN_EMPTY, test_serial_number, AZ_SPAN_FROM_STR("\"abcd\""), 0),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  az_iot_hub_client_twin_reported_batch_clear(&batch);
+  assert_int_equal(
+      az_iot_hub_client_twin_reported_batch_append(
+          &batch, AZ_SPAN_EMPTY, test_serial_number, AZ_SPAN_FROM_STR("\"abcd\""), 0),
+      AZ_OK);
+}
+
+#ifdef _MSC_VER
+// warning C4113: 'void (__cdecl *)()' differs in parameter lists from 'CMUnitTestFunction'
+#pragma warning(disable : 4113)
+#endif
+
+int test_az_iot_hub_client_twin_reported()
+{
+#ifndef AZ_NO_PRECONDITION_CHECKING
+  SETUP_PRECONDITION_CHECK_TESTS();
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+  const struct CMUnitTest tests[] = {
+#ifndef AZ_NO_PRECONDITION_CHECKING
+    cmocka_unit_test(test_az_iot_hub_client_twin_reported_batch_init_NULL_properties_fail),
+    cmocka_unit_test(test_az_iot_hub_client_twin_reported_batch_append_EMPTY_property_name_fail),
+#endif // AZ_NO_PRECONDITION_CHECKING
+    cmocka_unit_test(test_az_iot_hub_client_twin_reported_batch_get_payload_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_twin_reported_batch_should_flush_succeed),
+    cmocka_unit_test(test_az_iot_hub_client_twin_reported_batch_append_full_fail),
+  };
+  return cmocka_run_group_tests_name("az_iot_hub_twin_reported", tests, NULL, NULL);
+}
@@ -18,6 +18,8 @@ int main()
   result += test_az_iot_provisioning_client();
   result += test_az_iot_provisioning_client_sas_token();
   result += test_az_iot_provisioning_client_parser();
+  result += test_az_iot_provisioning_client_cache();
+  result += test_az_iot_provisioning_client_scheduler();
 
   return result;
 }
@@ -6,3 +6,5 @@
 int test_az_iot_provisioning_client();
 int test_az_iot_provisioning_client_sas_token();
 int test_az_iot_provisioning_client_parser();
+int test_az_iot_provisioning_client_cache();
+int test_az_iot_provisioning_client_scheduler();
@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_provisioning_client.h"
+#include <azure/core/az_span.h>
+#include <azure/iot/az_iot_provisioning_client.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include <azure/core/_az_cfg.h>
+
+#define TEST_HUB_HOSTNAME "contoso.azure-devices.net"
+#define TEST_DEVICE_ID "my-device-id1"
+
+static const az_span test_global_device_hostname
+    = AZ_SPAN_LITERAL_FROM_STR("global.azure-devices-provisioning.net");
+static const az_span test_id_scope = AZ_SPAN_LITERAL_FROM_STR("0neFEEDC0DE");
+static const az_span test_registration_id = AZ_SPAN_LITERAL_FROM_STR("myRegistrationId");
+
+static az_iot_provisioning_client_registration_state _test_assigned_state()
+{
+  az_iot_provisioning_client_registration_state state = { 0 };
+  state.assigned_hub_hostname = AZ_SPAN_FROM_STR(TEST_HUB_HOSTNAME);
+  state.device_id = AZ_SPAN_FROM_STR(TEST_DEVICE_ID);
+  state.error_code = AZ_IOT_STATUS_UNKNOWN;
+  return state;
+}
+
+static void test_az_iot_provisioning_client_registration_state_cache_round_trip_succeed()
+{
+  az_iot_provisioning_client client;
+  assert_int_equal(
+      az_iot_provisioning_client_init(
+          &client, test_global_device_hostname, test_id_scope, test_registration_id, NULL),
+      AZ_OK);
+
+  az_iot_provisioning_client_registration_state state = _test_assigned_state();
+  uint8_t buffer[64];
+  az_span cached = AZ_SPAN_EMPTY;
+  assert_int_equal(
+      az_iot_provisioning_client_registration_state_serialize(
+          &client, &state, 1000, AZ_SPAN_FROM_BUFFER(buffer), &cached),
+      AZ_OK);
+  assert_int_equal(
+      az_span_size(cached),
+      1 + 8 + 4 + 2 + (int32_t)sizeof(TEST_HUB_HOSTNAME) - 1 + 2 + (int32_t)sizeof(TEST_DEVICE_ID)
+          - 1 + 4);
+
+  az_iot_provisioning_client_registration_state restored;
+  assert_int_equal(
+      az_iot_provisioning_client_registration_state_deserialize(&client, cached, 1000, &restored),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(
+      restored.assigned_hub_hostname, AZ_SPAN_FROM_STR(TEST_HUB_HOSTNAME)));
+  assert_true(az_span_is_content_equal(restored.device_id, AZ_SPAN_FROM_STR(TEST_DEVICE_ID)));
+  assert_int_equal(restored.error_code, AZ_IOT_STATUS_UNKNOWN);
+  assert_int_equal(az_span_size(restored.error_message), 0);
+
+  // Past its expiration, the cached state is no longer used.
+  assert_int_equal(
+      az_iot_provisioning_client_registration_state_deserialize(&client, cached, 1001, &restored),
+      AZ_ERROR_ITEM_NOT_FOUND);
+}
+
+static void test_az_iot_provisioning_client_registration_state_cache_rejected_fails()
+{
+  az_iot_provisioning_client client;
+  assert_int_equal(
+      az_iot_provisioning_client_init(
+          &client, test_global_device_hostname, test_id_scope, test_registration_id, NULL),
+      AZ_OK);
+
+  az_iot_provisioning_client_registration_state state = _test_assigned_state();
+  uint8_t buffer[64];
+  az_span cached = AZ_SPAN_EMPTY;
+  assert_int_equal(
+      az_iot_provisioning_client_registration_state_serialize(
+          &client, &state, INT64_MAX, AZ_SPAN_FROM_BUFFER(buffer), &cached),
+      AZ_OK);
+
+  az_iot_provisioning_client_registration_state restored;
+
+  // Any corrupted byte is caught by the CRC.
+  for (int32_t i = 0; i < az_span_size(cached); i++)
+  {
+    buffer[i] ^= 0x20;
+    assert_int_equal(
+        az_iot_provisioning_client_registration_state_deserialize(&client, cached, 0, &restored),
+        AZ_ERROR_ITEM_NOT_FOUND);
+    buffer[i] ^= 0x20;
+  }
+
+  // A truncated cache is rejected.
+  assert_int_equal(
+      az_iot_provisioning_client_registration_state_deserialize(
+          &client, az_span_slice(cached, 0, 10), 0, &restored),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_iot_provisioning_client_registration_state_deserialize(
+          &client, AZ_SPAN_EMPTY, 0, &restored),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  // A cache written for another registration is rejected.
+  az_iot_provisioning_client other_client;
+  assert_int_equal(
+      az_iot_provisioning_client_init(
+          &other_client,
+          test_global_device_hostname,
+          test_id_scope,
+          AZ_SPAN_FROM_STR("otherRegistrationId"),
+          NULL),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_provisioning_client_registration_state_deserialize(
+          &other_client, cached, 0, &restored),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  assert_int_equal(
+      az_iot_provisioning_client_registration_state_deserialize(&client, cached, 0, &restored),
+      AZ_OK);
+}
+
+static void test_az_iot_provisioning_client_registration_state_serialize_small_buffer_fails()
+{
+  az_iot_provisioning_client client;
+  assert_int_equal(
+      az_iot_provisioning_client_init(
+          &client, test_global_device_hostname, test_id_scope, test_registration_id, NULL),
+      AZ_OK);
+
+  az_iot_provisioning_client_registration_state state = _test_assigned_state();
+  uint8_t buffer[50];
+  az_span cached = AZ_SPAN_EMPTY;
+  assert_int_equal(
+      az_iot_provisioning_client_registration_state_serialize(
+          &client, &state, 0, AZ_SPAN_FROM_BUFFER(buffer), &cached),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+int test_az_iot_provisioning_client_cache()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_iot_provisioning_client_registration_state_cache_round_trip_succeed),
+    cmocka_unit_test(test_az_iot_provisioning_client_registration_state_cache_rejected_fails),
+    cmocka_unit_test(
+        test_az_iot_provisioning_client_registration_state_serialize_small_buffer_fails),
+  };
+
+  return cmocka_run_group_tests_name("az_iot_provisioning_client_cache", tests, NULL, NULL);
+}
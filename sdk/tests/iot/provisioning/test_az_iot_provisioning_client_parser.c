@@ -219,6 +219,42 @@ test_az_iot_provisioning_client_parse_received_topic_and_payload_invalid_certifi
       strlen(TEST_ERROR_TRACKING_ID));
 }
 
+static void
+test_az_iot_provisioning_client_parse_received_topic_and_payload_nested_names_succeed()
+{
+  az_iot_provisioning_client client = { 0 };
+  az_result ret = az_iot_provisioning_client_init(
+      &client, test_global_device_hostname, test_id_scope, test_registration_id, NULL);
+  assert_int_equal(AZ_OK, ret);
+
+  // The properties of registrationState and of skipped objects don't override the top-level ones.
+  az_span received_topic = AZ_SPAN_FROM_STR("$dps/registrations/res/200/?$rid=1");
+  az_span received_payload
+      = AZ_SPAN_FROM_STR("{\"registrationState\":{"
+                         "\"assignedHub\":\"" TEST_HUB_HOSTNAME "\","
+                         "\"status\":\"" TEST_STATUS_ASSIGNING "\","
+                         "\"payload\":{\"operationId\":\"other\",\"errorCode\":[1]},"
+                         "\"deviceId\":\"" TEST_DEVICE_ID "\"},"
+                         "\"operationId\":\"" TEST_OPERATION_ID "\","
+                         "\"status\":\"" TEST_STATUS_ASSIGNED "\"}");
+
+  az_iot_provisioning_client_register_response response;
+  ret = az_iot_provisioning_client_parse_received_topic_and_payload(
+      &client, received_topic, received_payload, &response);
+  assert_int_equal(AZ_OK, ret);
+
+  assert_memory_equal(
+      az_span_ptr(response.operation_id), TEST_OPERATION_ID, strlen(TEST_OPERATION_ID));
+  assert_int_equal(AZ_IOT_PROVISIONING_STATUS_ASSIGNED, response.operation_status);
+  assert_memory_equal(
+      az_span_ptr(response.registration_state.assigned_hub_hostname),
+      TEST_HUB_HOSTNAME,
+      strlen(TEST_HUB_HOSTNAME));
+  assert_memory_equal(
+      az_span_ptr(response.registration_state.device_id), TEST_DEVICE_ID, strlen(TEST_DEVICE_ID));
+  assert_int_equal(0, response.registration_state.extended_error_code);
+}
+
 static void test_az_iot_provisioning_client_parse_received_topic_payload_disabled_state_succeed()
 {
   az_iot_provisioning_client client = { 0 };
@@ -315,6 +351,45 @@ test_az_iot_provisioning_client_received_topic_and_payload_parse_invalid_json_pa
   assert_int_equal(AZ_ERROR_UNEXPECTED_CHAR, ret);
 }
 
+static void
+test_az_iot_provisioning_client_received_topic_and_payload_parse_empty_payload_fails()
+{
+  az_iot_provisioning_client client = { 0 };
+  az_result ret = az_iot_provisioning_client_init(
+      &client, test_global_device_hostname, test_id_scope, test_registration_id, NULL);
+  assert_int_equal(AZ_OK, ret);
+
+  az_span received_topic = AZ_SPAN_FROM_STR("$dps/registrations/res/200/?$rid=1");
+  az_span received_payload = AZ_SPAN_FROM_STR("");
+
+  az_iot_provisioning_client_register_response response;
+  ret = az_iot_provisioning_client_parse_received_topic_and_payload(
+      &client, received_topic, received_payload, &response);
+  assert_int_equal(AZ_ERROR_UNEXPECTED_END, ret);
+}
+
+static void test_az_iot_provisioning_client_received_topic_and_payload_parse_empty_number_fails()
+{
+  az_iot_provisioning_client client = { 0 };
+  az_result ret = az_iot_provisioning_client_init(
+      &client, test_global_device_hostname, test_id_scope, test_registration_id, NULL);
+  assert_int_equal(AZ_OK, ret);
+
+  az_span received_payload = AZ_SPAN_FROM_STR("{}");
+
+  az_iot_provisioning_client_register_response response;
+  ret = az_iot_provisioning_client_parse_received_topic_and_payload(
+      &client, AZ_SPAN_FROM_STR("$dps/registrations/res/"), received_payload, &response);
+  assert_int_equal(AZ_ERROR_UNEXPECTED_CHAR, ret);
+
+  ret = az_iot_provisioning_client_parse_received_topic_and_payload(
+      &client,
+      AZ_SPAN_FROM_STR("$dps/registrations/res/202/?$rid=1&retry-after="),
+      received_payload,
+      &response);
+  assert_int_equal(AZ_ERROR_UNEXPECTED_CHAR, ret);
+}
+
 static void
 test_az_iot_provisioning_client_received_topic_and_payload_parse_operationid_not_found_fails()
 {
@@ -658,12 +733,18 @@ int test_az_iot_provisioning_client_parser()
         test_az_iot_provisioning_client_parse_received_topic_and_payload_assigned_state_succeed),
     cmocka_unit_test(
         test_az_iot_provisioning_client_parse_received_topic_and_payload_invalid_certificate_error_succeed),
+    cmocka_unit_test(
+        test_az_iot_provisioning_client_parse_received_topic_and_payload_nested_names_succeed),
     cmocka_unit_test(
         test_az_iot_provisioning_client_parse_received_topic_payload_disabled_state_succeed),
     cmocka_unit_test(
         test_az_iot_provisioning_client_parse_received_topic_and_payload_allocation_error_state_succeed),
     cmocka_unit_test(
         test_az_iot_provisioning_client_received_topic_and_payload_parse_invalid_json_payload_fails),
+    cmocka_unit_test(
+        test_az_iot_provisioning_client_received_topic_and_payload_parse_empty_payload_fails),
+    cmocka_unit_test(
+        test_az_iot_provisioning_client_received_topic_and_payload_parse_empty_number_fails),
     cmocka_unit_test(
         test_az_iot_provisioning_client_received_topic_and_payload_parse_operationid_not_found_fails),
     cmocka_unit_test(
@@ -267,6 +267,62 @@ static void az_iot_provisioning_client_sas_get_signature_device_signature_overfl
       AZ_ERROR_NOT_ENOUGH_SPACE);
 }
 
+static void az_iot_provisioning_client_sas_cache_resource_uri_succeeds()
+{
+  az_iot_provisioning_client client;
+  assert_int_equal(
+      az_iot_provisioning_client_init(
+          &client, test_global_device_hostname, test_id_scope, test_registration_id, NULL),
+      AZ_OK);
+
+  // The resource URI doesn't fit, so it keeps being encoded for every token.
+  uint8_t small_buffer[20];
+  assert_int_equal(
+      az_iot_provisioning_client_sas_cache_resource_uri(
+          &client, az_span_create(small_buffer, _az_COUNTOF(small_buffer))),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  uint8_t resource_uri_buffer[TEST_SPAN_BUFFER_SIZE];
+  assert_int_equal(
+      az_iot_provisioning_client_sas_cache_resource_uri(
+          &client, az_span_create(resource_uri_buffer, _az_COUNTOF(resource_uri_buffer))),
+      AZ_OK);
+
+  const char expected_signature[] = TEST_URL_ENCODED_RESOURCE_URI "\n" TEST_EXPIRATION_STR;
+
+  uint8_t signature_buffer[TEST_SPAN_BUFFER_SIZE];
+  az_span signature = az_span_for_test_init(signature_buffer, _az_COUNTOF(signature_buffer));
+  az_span out_signature;
+
+  assert_true(az_result_succeeded(az_iot_provisioning_client_sas_get_signature(
+      &client, test_sas_expiry_time_secs, signature, &out_signature)));
+
+  az_span_for_test_verify(
+      out_signature,
+      expected_signature,
+      _az_COUNTOF(expected_signature) - 1,
+      signature,
+      TEST_SPAN_BUFFER_SIZE);
+
+  const char expected_password[] = "SharedAccessSignature sr=" TEST_URL_ENCODED_RESOURCE_URI
+                                   "&sig=" TEST_URL_ENC_SIG "&se=" TEST_EXPIRATION_STR;
+
+  char password[TEST_SPAN_BUFFER_SIZE];
+  size_t length = 0;
+
+  assert_true(az_result_succeeded(az_iot_provisioning_client_sas_get_password(
+      &client,
+      test_signature,
+      test_sas_expiry_time_secs,
+      AZ_SPAN_EMPTY,
+      password,
+      _az_COUNTOF(password),
+      &length)));
+
+  assert_int_equal(length, _az_COUNTOF(expected_password) - 1);
+  assert_memory_equal(password, expected_password, length + 1); // +1 to account for '\0'.
+}
+
 static int _log_invoked_sas = 0;
 static void _log_listener(az_log_classification classification, az_span message)
 {
@@ -376,6 +432,7 @@ int test_az_iot_provisioning_client_sas_token()
     cmocka_unit_test(az_iot_provisioning_client_sas_get_password_device_with_keyname_succeeds),
     cmocka_unit_test(az_iot_provisioning_client_sas_get_password_device_overflow_fails),
     cmocka_unit_test(az_iot_provisioning_client_sas_get_signature_device_signature_overflow_fails),
+    cmocka_unit_test(az_iot_provisioning_client_sas_cache_resource_uri_succeeds),
     cmocka_unit_test(test_az_iot_provisioning_client_sas_logging_succeed),
     cmocka_unit_test(test_az_iot_provisioning_client_sas_no_logging_succeed),
   };
@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_iot_provisioning_client.h"
+#include <azure/core/az_span.h>
+#include <azure/iot/az_iot_provisioning_client.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include <azure/core/_az_cfg.h>
+
+#define TEST_OPERATION_ID "4.d0a671905ea5b2c8.42d78160-4c78-479e-8be7-61d5e55dac0d"
+
+static const az_span test_global_device_hostname
+    = AZ_SPAN_LITERAL_FROM_STR("global.azure-devices-provisioning.net");
+static const az_span test_id_scope = AZ_SPAN_LITERAL_FROM_STR("0neFEEDC0DE");
+static const az_span test_registration_id = AZ_SPAN_LITERAL_FROM_STR("myRegistrationId");
+
+static void _test_scheduler_init(
+    az_iot_provisioning_client* client,
+    az_iot_provisioning_client_scheduler* scheduler,
+    az_iot_provisioning_client_registration* heap[],
+    int32_t capacity)
+{
+  assert_int_equal(
+      az_iot_provisioning_client_init(
+          client, test_global_device_hostname, test_id_scope, test_registration_id, NULL),
+      AZ_OK);
+
+  az_iot_provisioning_client_scheduler_options options
+      = az_iot_provisioning_client_scheduler_options_default();
+  options.response_timeout = 100;
+  options.default_retry_after = 50;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_init(scheduler, heap, capacity, &options), AZ_OK);
+}
+
+static void test_az_iot_provisioning_client_scheduler_orders_by_deadline_succeed()
+{
+  az_iot_provisioning_client client;
+  az_iot_provisioning_client_scheduler scheduler;
+  az_iot_provisioning_client_registration* heap[4];
+  _test_scheduler_init(&client, &scheduler, heap, 4);
+
+  uint8_t buffers[4][64];
+  az_iot_provisioning_client_registration registrations[4];
+  int64_t const starts[4] = { 30, 10, 40, 20 };
+  for (int32_t i = 0; i < 4; i++)
+  {
+    assert_int_equal(
+        az_iot_provisioning_client_registration_init(
+            &registrations[i], &client, AZ_SPAN_FROM_BUFFER(buffers[i]), &registrations[i]),
+        AZ_OK);
+    assert_int_equal(
+        az_iot_provisioning_client_scheduler_add(&scheduler, &registrations[i], starts[i]), AZ_OK);
+  }
+
+  az_iot_provisioning_client_registration extra;
+  assert_int_equal(
+      az_iot_provisioning_client_registration_init(
+          &extra, &client, AZ_SPAN_FROM_BUFFER(buffers[0]), NULL),
+      AZ_OK);
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_add(&scheduler, &extra, 0), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(az_iot_provisioning_client_scheduler_count(&scheduler), 4);
+
+  int64_t deadline = 0;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next_deadline(&scheduler, &deadline), AZ_OK);
+  assert_int_equal(deadline, 10);
+
+  az_iot_provisioning_client_registration* registration = NULL;
+  az_iot_provisioning_client_action action = AZ_IOT_PROVISIONING_CLIENT_ACTION_QUERY_STATUS;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next(&scheduler, 5, &registration, &action),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  // Removing a registration keeps the others in order.
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_remove(&scheduler, &registrations[3]), AZ_OK);
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_remove(&scheduler, &registrations[3]),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  int32_t const expected[3] = { 1, 0, 2 };
+  for (int32_t i = 0; i < 3; i++)
+  {
+    assert_int_equal(
+        az_iot_provisioning_client_scheduler_get_next(&scheduler, 40, &registration, &action),
+        AZ_OK);
+    assert_ptr_equal(registration, &registrations[expected[i]]);
+    assert_ptr_equal(
+        az_iot_provisioning_client_registration_get_context(registration),
+        &registrations[expected[i]]);
+    assert_ptr_equal(az_iot_provisioning_client_registration_get_client(registration), &client);
+    assert_int_equal(action, AZ_IOT_PROVISIONING_CLIENT_ACTION_REGISTER);
+    assert_int_equal(az_iot_provisioning_client_registration_get_attempts(registration), 1);
+  }
+
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next(&scheduler, 40, &registration, &action),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  // Every request is now awaiting its response.
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next_deadline(&scheduler, &deadline), AZ_OK);
+  assert_int_equal(deadline, 140);
+}
+
+static void test_az_iot_provisioning_client_scheduler_register_query_complete_succeed()
+{
+  az_iot_provisioning_client client;
+  az_iot_provisioning_client_scheduler scheduler;
+  az_iot_provisioning_client_registration* heap[2];
+  _test_scheduler_init(&client, &scheduler, heap, 2);
+
+  uint8_t buffer[64];
+  az_iot_provisioning_client_registration reg;
+  assert_int_equal(
+      az_iot_provisioning_client_registration_init(
+          &reg, &client, AZ_SPAN_FROM_BUFFER(buffer), NULL),
+      AZ_OK);
+  assert_int_equal(az_iot_provisioning_client_scheduler_add(&scheduler, &reg, 0), AZ_OK);
+
+  az_iot_provisioning_client_registration* registration = NULL;
+  az_iot_provisioning_client_action action = AZ_IOT_PROVISIONING_CLIENT_ACTION_QUERY_STATUS;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next(&scheduler, 0, &registration, &action), AZ_OK);
+  assert_int_equal(action, AZ_IOT_PROVISIONING_CLIENT_ACTION_REGISTER);
+
+  // The service asks to query the status in 3 seconds.
+  bool complete = true;
+  az_iot_provisioning_client_register_response response = { 0 };
+  response.status = AZ_IOT_STATUS_ACCEPTED;
+  response.operation_status = AZ_IOT_PROVISIONING_STATUS_ASSIGNING;
+  response.operation_id = AZ_SPAN_FROM_STR(TEST_OPERATION_ID);
+  response.retry_after_seconds = 3;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_handle_response(
+          &scheduler, &reg, &response, 10, &complete),
+      AZ_OK);
+  assert_false(complete);
+  assert_true(az_span_is_content_equal(
+      az_iot_provisioning_client_registration_get_operation_id(&reg),
+      AZ_SPAN_FROM_STR(TEST_OPERATION_ID)));
+
+  int64_t deadline = 0;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next_deadline(&scheduler, &deadline), AZ_OK);
+  assert_int_equal(deadline, 3010);
+
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next(&scheduler, 3009, &registration, &action),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next(&scheduler, 3010, &registration, &action),
+      AZ_OK);
+  assert_int_equal(action, AZ_IOT_PROVISIONING_CLIENT_ACTION_QUERY_STATUS);
+  assert_int_equal(az_iot_provisioning_client_registration_get_attempts(&reg), 1);
+
+  // Without retry-after, the default polling interval applies.
+  response.retry_after_seconds = 0;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_handle_response(
+          &scheduler, &reg, &response, 3020, &complete),
+      AZ_OK);
+  assert_false(complete);
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next_deadline(&scheduler, &deadline), AZ_OK);
+  assert_int_equal(deadline, 3070);
+
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next(&scheduler, 3070, &registration, &action),
+      AZ_OK);
+  assert_int_equal(action, AZ_IOT_PROVISIONING_CLIENT_ACTION_QUERY_STATUS);
+
+  response.status = AZ_IOT_STATUS_OK;
+  response.operation_status = AZ_IOT_PROVISIONING_STATUS_ASSIGNED;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_handle_response(
+          &scheduler, &reg, &response, 3080, &complete),
+      AZ_OK);
+  assert_true(complete);
+  assert_int_equal(az_iot_provisioning_client_scheduler_count(&scheduler), 0);
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next_deadline(&scheduler, &deadline),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_handle_response(
+          &scheduler, &reg, &response, 3090, &complete),
+      AZ_ERROR_ITEM_NOT_FOUND);
+}
+
+static void test_az_iot_provisioning_client_scheduler_timeout_and_throttling_succeed()
+{
+  az_iot_provisioning_client client;
+  az_iot_provisioning_client_scheduler scheduler;
+  az_iot_provisioning_client_registration* heap[1];
+  _test_scheduler_init(&client, &scheduler, heap, 1);
+
+  uint8_t buffer[8];
+  az_iot_provisioning_client_registration reg;
+  assert_int_equal(
+      az_iot_provisioning_client_registration_init(
+          &reg, &client, AZ_SPAN_FROM_BUFFER(buffer), NULL),
+      AZ_OK);
+  assert_int_equal(az_iot_provisioning_client_scheduler_add(&scheduler, &reg, 0), AZ_OK);
+
+  az_iot_provisioning_client_registration* registration = NULL;
+  az_iot_provisioning_client_action action = AZ_IOT_PROVISIONING_CLIENT_ACTION_QUERY_STATUS;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next(&scheduler, 0, &registration, &action), AZ_OK);
+
+  // The response times out, and the register request is published again.
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next(&scheduler, 99, &registration, &action),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next(&scheduler, 100, &registration, &action),
+      AZ_OK);
+  assert_int_equal(action, AZ_IOT_PROVISIONING_CLIENT_ACTION_REGISTER);
+  assert_int_equal(az_iot_provisioning_client_registration_get_attempts(&reg), 2);
+
+  // A throttled request is published again after its retry-after.
+  bool complete = true;
+  az_iot_provisioning_client_register_response response = { 0 };
+  response.status = AZ_IOT_STATUS_THROTTLED;
+  response.operation_status = AZ_IOT_PROVISIONING_STATUS_FAILED;
+  response.retry_after_seconds = 2;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_handle_response(
+          &scheduler, &reg, &response, 110, &complete),
+      AZ_OK);
+  assert_false(complete);
+
+  int64_t deadline = 0;
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next_deadline(&scheduler, &deadline), AZ_OK);
+  assert_int_equal(deadline, 2110);
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_get_next(&scheduler, 2110, &registration, &action),
+      AZ_OK);
+  assert_int_equal(action, AZ_IOT_PROVISIONING_CLIENT_ACTION_REGISTER);
+  assert_int_equal(az_iot_provisioning_client_registration_get_attempts(&reg), 3);
+
+  // The operation ID doesn't fit the buffer.
+  response.status = AZ_IOT_STATUS_ACCEPTED;
+  response.operation_status = AZ_IOT_PROVISIONING_STATUS_ASSIGNING;
+  response.operation_id = AZ_SPAN_FROM_STR(TEST_OPERATION_ID);
+  assert_int_equal(
+      az_iot_provisioning_client_scheduler_handle_response(
+          &scheduler, &reg, &response, 2120, &complete),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(az_iot_provisioning_client_scheduler_count(&scheduler), 0);
+}
+
+int test_az_iot_provisioning_client_scheduler()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_az_iot_provisioning_client_scheduler_orders_by_deadline_succeed),
+    cmocka_unit_test(test_az_iot_provisioning_client_scheduler_register_query_complete_succeed),
+    cmocka_unit_test(test_az_iot_provisioning_client_scheduler_timeout_and_throttling_succeed),
+  };
+
+  return cmocka_run_group_tests_name("az_iot_provisioning_client_scheduler", tests, NULL, NULL);
+}
@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#ifndef _az_PERF_H
+#define _az_PERF_H
+
+#include <stdint.h>
+
+/**
+ * @brief The measurements of a single benchmark run.
+ */
+typedef struct
+{
+  char const* name; ///< What was measured (e.g. the API name).
+  char const* variant; ///< The input or mode used (e.g. the corpus document).
+  double seconds; ///< Total time spent in the measured loop.
+  int64_t bytes; ///< Total number of input bytes processed.
+  int64_t items; ///< Total number of items (tokens, topics, etc.) processed.
+  int64_t cycles; ///< CPU cycles spent in the measured loop, 0 if there's no cycle counter.
+} perf_result;
+
+/**
+ * @brief Returns a monotonically increasing time, in seconds, used to time benchmark loops.
+ */
+double perf_now_seconds(void);
+
+/**
+ * @brief Returns the CPU time stamp counter, used to count the cycles of benchmark loops.
+ * @details This is the invariant time stamp counter on x86, which ticks at a constant rate close
+ * to the nominal frequency of the CPU. Other architectures return 0, reported as 0 cycles/op.
+ */
+int64_t perf_now_cycles(void);
+
+/**
+ * @brief Prints the header of the results table.
+ */
+void perf_report_header(void);
+
+/**
+ * @brief Prints one line of the results table, with the throughput in MB/s and items/s, and the
+ * cost of each item in nanoseconds and cycles, and records the result.
+ */
+void perf_report(perf_result const* result);
+
+/**
+ * @brief Records a result, to be written by #perf_results_write_json() and compared by
+ * #perf_results_compare(). Called by #perf_report().
+ */
+void perf_results_add(perf_result const* result);
+
+/**
+ * @brief Writes the results recorded so far as JSON, along with what they depend on: the SDK
+ * version, the compiler, the build type, flags and options, and the CPU.
+ *
+ * @param[in] path The file to write.
+ * @param[in] label A name for the run, such as the commit it was built from, or `NULL`.
+ * @param[in] iterations The iterations the benchmarks were run with.
+ * @return 0 on success, non-zero if the file failed to be written.
+ */
+int perf_results_write_json(char const* path, char const* label, int32_t iterations);
+
+/**
+ * @brief Compares the results recorded so far with the ones written by another run, and prints the
+ * ratio of their cost per operation. Results timed over too short a time to be compared are
+ * listed, without a ratio.
+ *
+ * @param[in] baseline_path A file written by #perf_results_write_json().
+ * @param[in] max_slowdown The ratio above which a result is slower than allowed, or 0 to only
+ * print the ratios.
+ * @return 0 on success, non-zero if the file failed to be read, or if any result is slower than
+ * allowed.
+ */
+int perf_results_compare(char const* baseline_path, double max_slowdown);
+
+/**
+ * @brief Runs the az_span search, comparison, copy and number conversion benchmarks.
+ *
+ * @param[in] iterations Scales the number of calls made.
+ * @return 0 on success, non-zero if any of the calls failed.
+ */
+int perf_run_span(int32_t iterations);
+
+/**
+ * @brief Runs the az_json_reader and az_json_token benchmarks.
+ *
+ * @param[in] iterations The number of times each document is processed.
+ * @return 0 on success, non-zero if any of the documents failed to be parsed.
+ */
+int perf_run_json(int32_t iterations);
+
+/**
+ * @brief Runs the az_json_writer benchmarks.
+ *
+ * @param[in] iterations The number of times each document is written.
+ * @return 0 on success, non-zero if any of the documents failed to be written.
+ */
+int perf_run_json_writer(int32_t iterations);
+
+/**
+ * @brief Runs the IoT Hub and Provisioning topic parsing and building, message properties and SAS
+ * signature benchmarks.
+ *
+ * @param[in] iterations Scales the number of topics processed.
+ * @return 0 on success, non-zero if any of the topics failed to be processed.
+ */
+int perf_run_iot(int32_t iterations);
+
+/**
+ * @brief Runs the HTTP pipeline benchmarks, sending requests through all the standard policies to
+ * the loopback transport, with responses that succeed, are throttled, or fail with server errors.
+ *
+ * @param[in] iterations Scales the number of requests sent.
+ * @return 0 on success, non-zero if any of the requests failed.
+ */
+int perf_run_pipeline(int32_t iterations);
+
+/**
+ * @brief Runs the parsers on the shapes of hostile input found while fuzzing them, at two sizes,
+ * as regression guards of their worst case.
+ *
+ * @param[in] iterations Scales the number of bytes parsed.
+ * @return 0 on success, non-zero if any of the inputs failed to be parsed, or cost too much more
+ * per byte at the larger size.
+ */
+int perf_run_adversarial(int32_t iterations);
+
+#endif // _az_PERF_H
@@ -0,0 +1,384 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief Benchmarks of the parsers on the shapes of hostile input found while fuzzing them (see
+ * sdk/tests/fuzz), as regression guards of their worst case. Each shape is parsed at two sizes, and
+ * the benchmark fails when the cost per byte of the larger one grows, which is what a super-linear
+ * parser does.
+ */
+
+#include "az_perf.h"
+
+#include <azure/core/az_http.h>
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/iot/az_iot_common.h>
+#include <azure/iot/az_iot_hub_client.h>
+#include <azure/iot/az_iot_provisioning_client.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  PERF_ADVERSARIAL_SMALL_SIZE = 4 * 1024,
+  PERF_ADVERSARIAL_LARGE_SIZE = 32 * 1024,
+
+  // Each size is parsed until this many bytes times the iterations were processed.
+  PERF_ADVERSARIAL_BYTES_PER_ITERATION = 4 * 1024,
+
+  // The nesting the JSON reader allows without a nesting stack extension, minus the outer array.
+  PERF_ADVERSARIAL_JSON_NESTING = 63,
+};
+
+// The large size may cost this much more per byte than the small one, to allow for cache effects.
+#define PERF_ADVERSARIAL_MAX_GROWTH 4.0
+
+// Shorter runs than this are too noisy to be compared.
+#define PERF_ADVERSARIAL_MIN_SECONDS 0.02
+
+// Writes an input of a shape into a buffer, and returns its size, at most the size of the buffer.
+typedef int32_t (*perf_adversarial_build_fn)(uint8_t* buffer, int32_t size);
+
+// Parses an input. Hostile inputs may be rejected, so this only fails on unexpected errors.
+typedef int (*perf_adversarial_parse_fn)(az_span input);
+
+typedef struct
+{
+  char const* name;
+  char const* variant;
+  perf_adversarial_build_fn build;
+  perf_adversarial_parse_fn parse;
+} perf_adversarial_shape;
+
+static uint8_t perf_adversarial_buffer[PERF_ADVERSARIAL_LARGE_SIZE];
+
+static az_iot_hub_client perf_adversarial_hub_client;
+static az_iot_provisioning_client perf_adversarial_provisioning_client;
+
+// Accumulates values read from the results, so that the compiler can't discard the calls.
+static volatile int64_t perf_adversarial_sink;
+
+// Appends a string if it fits in the buffer, and returns the new size.
+static int32_t
+perf_adversarial_append(uint8_t* buffer, int32_t size, int32_t capacity, char const* str)
+{
+  int32_t const length = (int32_t)strlen(str);
+  if (size + length > capacity)
+  {
+    return -1;
+  }
+
+  memcpy(buffer + size, str, (size_t)length);
+  return size + length;
+}
+
+// Appends copies of a string, followed by a suffix, for as long as they fit in the buffer.
+static int32_t perf_adversarial_repeat(
+    uint8_t* buffer,
+    int32_t capacity,
+    char const* prefix,
+    char const* repeated,
+    char const* suffix)
+{
+  int32_t const reserved = (int32_t)strlen(suffix);
+  int32_t size = perf_adversarial_append(buffer, 0, capacity - reserved, prefix);
+  int32_t next = size;
+  while (next >= 0)
+  {
+    size = next;
+    next = perf_adversarial_append(buffer, size, capacity - reserved, repeated);
+  }
+
+  return size < 0 ? size : perf_adversarial_append(buffer, size, capacity, suffix);
+}
+
+// [[[...]]] arrays nested as deep as the reader allows, one after the other.
+static int32_t perf_adversarial_build_json_nesting(uint8_t* buffer, int32_t size)
+{
+  char nested[2 * PERF_ADVERSARIAL_JSON_NESTING + 2];
+  memset(nested, '[', PERF_ADVERSARIAL_JSON_NESTING);
+  memset(nested + PERF_ADVERSARIAL_JSON_NESTING, ']', PERF_ADVERSARIAL_JSON_NESTING);
+  nested[2 * PERF_ADVERSARIAL_JSON_NESTING] = ',';
+  nested[2 * PERF_ADVERSARIAL_JSON_NESTING + 1] = '\0';
+  return perf_adversarial_repeat(buffer, size, "[", nested, "0]");
+}
+
+// A single string made of escape sequences, which is unescaped when compared or copied.
+static int32_t perf_adversarial_build_json_escapes(uint8_t* buffer, int32_t size)
+{
+  return perf_adversarial_repeat(buffer, size, "\"", "\\t\\n\\\"\\\\\\/", "\"");
+}
+
+// Whitespace between the tokens of a tiny document.
+static int32_t perf_adversarial_build_json_whitespace(uint8_t* buffer, int32_t size)
+{
+  return perf_adversarial_repeat(buffer, size, "{\"a\":", " \t\r\n", "1}");
+}
+
+// A response made of many short headers.
+static int32_t perf_adversarial_build_http_headers(uint8_t* buffer, int32_t size)
+{
+  return perf_adversarial_repeat(buffer, size, "HTTP/1.1 200 OK\r\n", "x-ms-h: v\r\n", "\r\n");
+}
+
+// A source of 'a's, in which every position nearly matches "aa...aba": the target is found nowhere.
+static int32_t perf_adversarial_build_find_near_miss(uint8_t* buffer, int32_t size)
+{
+  memset(buffer, 'a', (size_t)size);
+  return size;
+}
+
+// A C2D topic with many application properties.
+static int32_t perf_adversarial_build_c2d_properties(uint8_t* buffer, int32_t size)
+{
+  return perf_adversarial_repeat(
+      buffer, size, "devices/my_device/messages/devicebound/", "p=v&", "alert=temperature");
+}
+
+// A Provisioning response with many fields the parser doesn't know, which it skips.
+static int32_t perf_adversarial_build_provisioning_unknown(uint8_t* buffer, int32_t size)
+{
+  return perf_adversarial_repeat(
+      buffer,
+      size,
+      "{\"operationId\":\"4.d0a671905ea5b2c8.42d78160\",",
+      "\"unknown\":{\"a\":[1,{\"b\":\"c\"}]},",
+      "\"status\":\"assigning\"}");
+}
+
+static int perf_adversarial_parse_json_tokens(az_span input)
+{
+  az_json_reader reader;
+  if (az_result_failed(az_json_reader_init(&reader, input, NULL)))
+  {
+    return 1;
+  }
+
+  az_result result;
+  while (az_result_succeeded(result = az_json_reader_next_token(&reader)))
+  {
+    perf_adversarial_sink += (int64_t)reader.token.kind;
+  }
+
+  return result == AZ_ERROR_JSON_READER_DONE ? 0 : 1;
+}
+
+static int perf_adversarial_parse_json_string(az_span input)
+{
+  az_json_reader reader;
+  if (az_result_failed(az_json_reader_init(&reader, input, NULL))
+      || az_result_failed(az_json_reader_next_token(&reader)))
+  {
+    return 1;
+  }
+
+  static char unescaped[PERF_ADVERSARIAL_LARGE_SIZE];
+  int32_t unescaped_length = 0;
+  if (az_result_failed(az_json_token_get_string(
+          &reader.token, unescaped, (int32_t)sizeof(unescaped), &unescaped_length)))
+  {
+    return 1;
+  }
+
+  perf_adversarial_sink += unescaped_length
+      + az_json_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("\t\n\"\\/"));
+  return 0;
+}
+
+static int perf_adversarial_parse_http_headers(az_span input)
+{
+  az_http_response response;
+  az_http_response_status_line status_line;
+  if (az_result_failed(az_http_response_init(&response, input))
+      || az_result_failed(az_http_response_get_status_line(&response, &status_line)))
+  {
+    return 1;
+  }
+
+  az_span name = AZ_SPAN_EMPTY;
+  az_span value = AZ_SPAN_EMPTY;
+  az_result result;
+  while (az_result_succeeded(result = az_http_response_get_next_header(&response, &name, &value)))
+  {
+    perf_adversarial_sink += az_span_size(value);
+  }
+
+  return result == AZ_ERROR_HTTP_END_OF_HEADERS ? 0 : 1;
+}
+
+static int perf_adversarial_parse_find_near_miss(az_span input)
+{
+  int32_t const index
+      = az_span_find(input, AZ_SPAN_FROM_STR("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaba"));
+  perf_adversarial_sink += index;
+  return index == -1 ? 0 : 1;
+}
+
+static int perf_adversarial_parse_c2d_properties(az_span input)
+{
+  az_iot_hub_client_c2d_request request;
+  if (az_result_failed(az_iot_hub_client_c2d_parse_received_topic(
+          &perf_adversarial_hub_client, input, &request)))
+  {
+    return 1;
+  }
+
+  // The property looked up is the last one, after all the others.
+  az_span value = AZ_SPAN_EMPTY;
+  if (az_result_failed(az_iot_message_properties_find(
+          &request.properties, AZ_SPAN_FROM_STR("alert"), &value)))
+  {
+    return 1;
+  }
+
+  perf_adversarial_sink += az_span_size(value);
+  return 0;
+}
+
+static int perf_adversarial_parse_provisioning_unknown(az_span input)
+{
+  az_iot_provisioning_client_register_response response;
+  if (az_result_failed(az_iot_provisioning_client_parse_received_topic_and_payload(
+          &perf_adversarial_provisioning_client,
+          AZ_SPAN_FROM_STR("$dps/registrations/res/202/?$rid=1&retry-after=3"),
+          input,
+          &response)))
+  {
+    return 1;
+  }
+
+  perf_adversarial_sink += (int64_t)response.operation_status;
+  return 0;
+}
+
+static perf_adversarial_shape const perf_adversarial_shapes[] = {
+  { "az_json_reader_next_token",
+    "max_nesting",
+    perf_adversarial_build_json_nesting,
+    perf_adversarial_parse_json_tokens },
+  { "az_json_token_get_string",
+    "escaped_string",
+    perf_adversarial_build_json_escapes,
+    perf_adversarial_parse_json_string },
+  { "az_json_reader_next_token",
+    "whitespace",
+    perf_adversarial_build_json_whitespace,
+    perf_adversarial_parse_json_tokens },
+  { "az_http_response_get_next_header",
+    "many_headers",
+    perf_adversarial_build_http_headers,
+    perf_adversarial_parse_http_headers },
+  { "az_span_find",
+    "near_misses",
+    perf_adversarial_build_find_near_miss,
+    perf_adversarial_parse_find_near_miss },
+  { "az_iot_hub_client_c2d_parse_received_topic",
+    "many_properties",
+    perf_adversarial_build_c2d_properties,
+    perf_adversarial_parse_c2d_properties },
+  { "az_iot_provisioning_client_parse_received_topic_and_payload",
+    "unknown_fields",
+    perf_adversarial_build_provisioning_unknown,
+    perf_adversarial_parse_provisioning_unknown },
+};
+
+// Parses an input of a shape as many times as it takes to process the bytes of the iterations, and
+// returns the time it took per byte, or a negative value on failure.
+static double
+perf_adversarial_run(perf_adversarial_shape const* shape, int32_t size, int32_t iterations)
+{
+  int32_t const input_size = shape->build(perf_adversarial_buffer, size);
+  if (input_size <= 0)
+  {
+    printf("%s: failed to build %s\n", shape->name, shape->variant);
+    return -1;
+  }
+
+  az_span const input = az_span_create(perf_adversarial_buffer, input_size);
+  int64_t const runs_bytes = (int64_t)iterations * PERF_ADVERSARIAL_BYTES_PER_ITERATION;
+  int64_t const runs = runs_bytes / input_size > 0 ? runs_bytes / input_size : 1;
+
+  char variant[64];
+  (void)snprintf(variant, sizeof(variant), "%s (%d KB)", shape->variant, (int)(size / 1024));
+
+  perf_result result = {
+    .name = shape->name, .variant = variant, .seconds = 0, .bytes = 0, .items = 0, .cycles = 0
+  };
+
+  double const start = perf_now_seconds();
+  int64_t const start_cycles = perf_now_cycles();
+  for (int64_t i = 0; i < runs; i++)
+  {
+    if (shape->parse(input) != 0)
+    {
+      printf("%s: failed to parse %s\n", shape->name, variant);
+      return -1;
+    }
+
+    result.bytes += input_size;
+    result.items++;
+  }
+  result.cycles = perf_now_cycles() - start_cycles;
+  result.seconds = perf_now_seconds() - start;
+
+  perf_report(&result);
+  return result.seconds < PERF_ADVERSARIAL_MIN_SECONDS ? 0 : result.seconds / (double)result.bytes;
+}
+
+int perf_run_adversarial(int32_t iterations)
+{
+  if (az_result_failed(az_iot_hub_client_init(
+          &perf_adversarial_hub_client,
+          AZ_SPAN_FROM_STR("contoso.azure-devices.net"),
+          AZ_SPAN_FROM_STR("my_device"),
+          NULL))
+      || az_result_failed(az_iot_provisioning_client_init(
+          &perf_adversarial_provisioning_client,
+          AZ_SPAN_FROM_STR("global.azure-devices-provisioning.net"),
+          AZ_SPAN_FROM_STR("0ne00000000"),
+          AZ_SPAN_FROM_STR("my-registration-id"),
+          NULL)))
+  {
+    printf("perf_run_adversarial: failed to initialize the clients\n");
+    return 1;
+  }
+
+  int result = 0;
+  for (size_t s = 0; s < sizeof(perf_adversarial_shapes) / sizeof(perf_adversarial_shapes[0]); s++)
+  {
+    perf_adversarial_shape const* shape = &perf_adversarial_shapes[s];
+    double const small = perf_adversarial_run(shape, PERF_ADVERSARIAL_SMALL_SIZE, iterations);
+    double const large = perf_adversarial_run(shape, PERF_ADVERSARIAL_LARGE_SIZE, iterations);
+    if (small < 0 || large < 0)
+    {
+      result = 1;
+      continue;
+    }
+
+    // Either run being too short to be measured skips the comparison.
+    bool const measured = small > 0 && large > 0;
+    if (measured && large > small * PERF_ADVERSARIAL_MAX_GROWTH)
+    {
+      printf(
+          "%s: %s costs %.1fx more per byte at %d KB than at %d KB\n",
+          shape->name,
+          shape->variant,
+          large / small,
+          PERF_ADVERSARIAL_LARGE_SIZE / 1024,
+          PERF_ADVERSARIAL_SMALL_SIZE / 1024);
+      result = 1;
+    }
+  }
+
+  return result;
+}
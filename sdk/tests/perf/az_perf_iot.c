@@ -0,0 +1,528 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_perf.h"
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/iot/az_iot_common.h>
+#include <azure/iot/az_iot_hub_client.h>
+#include <azure/iot/az_iot_provisioning_client.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  PERF_IOT_TOPIC_BUFFER_SIZE = 256,
+  PERF_IOT_SIGNATURE_BUFFER_SIZE = 256,
+  PERF_IOT_PROPERTIES_INDEX_SIZE = 8,
+};
+
+#define PERF_IOT_COUNT(array) (sizeof(array) / sizeof((array)[0]))
+
+// The MQTT messages given to a benchmark. The payload is only used by the Provisioning parser.
+typedef struct
+{
+  char const* topic;
+  char const* payload;
+} perf_iot_message;
+
+typedef struct
+{
+  az_iot_hub_client hub_client;
+  az_iot_provisioning_client provisioning_client;
+} perf_iot_clients;
+
+typedef az_result (*perf_iot_fn)(perf_iot_clients const* clients, az_span topic, az_span payload);
+
+// Topics as received by a device, in the mix a busy device sees them.
+static perf_iot_message const perf_iot_received_topics[] = {
+  { "devices/my_device/messages/devicebound/%24.mid=79eadb01-bd0d-472d-bd35-ccb76e70eab8&%24.to="
+    "%2Fdevices%2Fmy_device%2Fmessages%2FdeviceBound&%24.ct=application%2Fjson&%24.ce=utf-8&"
+    "alert=temperature",
+    NULL },
+  { "$iothub/methods/POST/reboot/?$rid=1", NULL },
+  { "$iothub/twin/PATCH/properties/desired/?$version=42", NULL },
+  { "$iothub/twin/res/200/?$rid=7", NULL },
+  { "$iothub/twin/res/204/?$rid=8&$version=43", NULL },
+};
+
+static perf_iot_message const perf_iot_c2d_topics[] = {
+  { "devices/my_device/messages/devicebound/%24.mid=79eadb01-bd0d-472d-bd35-ccb76e70eab8&%24.to="
+    "%2Fdevices%2Fmy_device%2Fmessages%2FdeviceBound&%24.ct=application%2Fjson&%24.ce=utf-8&"
+    "alert=temperature",
+    NULL },
+  { "devices/my_device/messages/devicebound/%24.mid=0b1d8a40-5e8b-4d7e-9d9b-2b4fb4d1f6c2&%24.to="
+    "%2Fdevices%2Fmy_device%2Fmessages%2FdeviceBound&%24.cid=1f4b7c1e&firmware=1.2.3&"
+    "channel=beta&region=westus2&alert=none",
+    NULL },
+};
+
+static perf_iot_message const perf_iot_methods_topics[] = {
+  { "$iothub/methods/POST/reboot/?$rid=1", NULL },
+  { "$iothub/methods/POST/getMaxMinReport/?$rid=2a", NULL },
+  { "$iothub/methods/POST/thermostat1*getMaxMinReport/?$rid=ffff", NULL },
+};
+
+static perf_iot_message const perf_iot_twin_topics[] = {
+  { "$iothub/twin/PATCH/properties/desired/?$version=42", NULL },
+  { "$iothub/twin/res/200/?$rid=7", NULL },
+  { "$iothub/twin/res/204/?$rid=8&$version=43", NULL },
+};
+
+// Application properties as carried by C2D messages and telemetry.
+static perf_iot_message const perf_iot_properties[] = {
+  { "%24.mid=79eadb01-bd0d-472d-bd35-ccb76e70eab8&%24.to=%2Fdevices%2Fmy_device%2Fmessages%2F"
+    "deviceBound&%24.ct=application%2Fjson&%24.ce=utf-8&firmware=1.2.3&alert=temperature",
+    NULL },
+};
+
+// A single empty message, for the benchmarks which don't take an input.
+static perf_iot_message const perf_iot_no_input[] = {
+  { "", NULL },
+};
+
+static perf_iot_message const perf_iot_provisioning_assigning[] = {
+  { "$dps/registrations/res/202/?$rid=1&retry-after=3",
+    "{\"operationId\":\"4.d0a671905ea5b2c8.42d78160-4c78-479e-8be7-61d5e55dac0d\","
+    "\"status\":\"assigning\"}" },
+};
+
+static perf_iot_message const perf_iot_provisioning_assigned[] = {
+  { "$dps/registrations/res/200/?$rid=1",
+    "{\"operationId\":\"4.d0a671905ea5b2c8.42d78160-4c78-479e-8be7-61d5e55dac0d\","
+    "\"status\":\"assigned\",\"registrationState\":{\"registrationId\":\"my-registration-id\","
+    "\"createdDateTimeUtc\":\"2020-04-10T03:11:13.0276997Z\","
+    "\"assignedHub\":\"contoso.azure-devices.net\",\"deviceId\":\"my-device-id1\","
+    "\"status\":\"assigned\",\"substatus\":\"initialAssignment\","
+    "\"lastUpdatedDateTimeUtc\":\"2020-04-10T03:11:13.2096201Z\","
+    "\"etag\":\"IjYxMDA4ZDQ2LTAwMDAtMDEwMC0wMDAwLTVlOTAxNDlmMDAwMCI=\"}}" },
+};
+
+// Accumulates values read from the results, so that the compiler can't discard the calls.
+static volatile int64_t perf_iot_sink;
+
+AZ_INLINE az_span perf_iot_span(char const* str)
+{
+  return str == NULL ? AZ_SPAN_EMPTY : az_span_create_from_str((char*)(uintptr_t)str);
+}
+
+static int perf_iot_run(
+    perf_iot_clients const* clients,
+    char const* name,
+    char const* variant,
+    perf_iot_fn fn,
+    perf_iot_message const* messages,
+    size_t messages_count,
+    int32_t iterations)
+{
+  perf_result result = {
+    .name = name, .variant = variant, .seconds = 0, .bytes = 0, .items = 0, .cycles = 0
+  };
+
+  double const start = perf_now_seconds();
+  int64_t const start_cycles = perf_now_cycles();
+  for (int32_t i = 0; i < iterations; i++)
+  {
+    for (size_t m = 0; m < messages_count; m++)
+    {
+      az_span const topic = perf_iot_span(messages[m].topic);
+      az_span const payload = perf_iot_span(messages[m].payload);
+      if (az_result_failed(fn(clients, topic, payload)))
+      {
+        printf("%s: failed to process %s\n", name, messages[m].topic);
+        return 1;
+      }
+
+      result.bytes += az_span_size(topic) + az_span_size(payload);
+      result.items++;
+    }
+  }
+  result.cycles = perf_now_cycles() - start_cycles;
+  result.seconds = perf_now_seconds() - start;
+
+  perf_report(&result);
+  return 0;
+}
+
+static az_result
+perf_iot_topic_parse(perf_iot_clients const* clients, az_span topic, az_span payload)
+{
+  (void)payload;
+
+  az_iot_hub_client_topic parsed;
+  az_result const result = az_iot_hub_client_topic_parse(&clients->hub_client, topic, &parsed);
+  if (az_result_failed(result))
+  {
+    return result;
+  }
+
+  if (parsed.type == AZ_IOT_HUB_CLIENT_TOPIC_TYPE_C2D)
+  {
+    // Applications usually look up a few properties of a C2D message.
+    az_span value = AZ_SPAN_EMPTY;
+    if (az_result_succeeded(az_iot_message_properties_find(
+            &parsed.parsed.c2d.properties, AZ_SPAN_FROM_STR("alert"), &value)))
+    {
+      perf_iot_sink += az_span_size(value);
+    }
+  }
+
+  perf_iot_sink += (int64_t)parsed.type;
+  return AZ_OK;
+}
+
+// Looks up what an application usually reads from a C2D message: the message ID, the content type
+// and a couple of application properties.
+static az_result perf_iot_c2d_lookup(az_iot_message_properties* properties)
+{
+  az_iot_message_system_properties system_properties;
+  az_result result
+      = az_iot_message_properties_get_system_properties(properties, &system_properties);
+  if (az_result_failed(result))
+  {
+    return result;
+  }
+
+  perf_iot_sink += az_span_size(system_properties.message_id)
+      + az_span_size(system_properties.content_type);
+
+  az_span value = AZ_SPAN_EMPTY;
+  if (az_result_succeeded(
+          az_iot_message_properties_find(properties, AZ_SPAN_FROM_STR("alert"), &value)))
+  {
+    perf_iot_sink += az_span_size(value);
+  }
+
+  result = az_iot_message_properties_find(properties, AZ_SPAN_FROM_STR("missing"), &value);
+  return result == AZ_ERROR_ITEM_NOT_FOUND ? AZ_OK : result;
+}
+
+static az_result perf_iot_c2d_parse(perf_iot_clients const* clients, az_span topic, az_span payload)
+{
+  (void)payload;
+
+  az_iot_hub_client_c2d_request request;
+  az_result const result
+      = az_iot_hub_client_c2d_parse_received_topic(&clients->hub_client, topic, &request);
+  if (az_result_failed(result))
+  {
+    return result;
+  }
+
+  return perf_iot_c2d_lookup(&request.properties);
+}
+
+static az_result
+perf_iot_c2d_parse_indexed(perf_iot_clients const* clients, az_span topic, az_span payload)
+{
+  (void)payload;
+
+  az_iot_message_properties_index_entry index[PERF_IOT_PROPERTIES_INDEX_SIZE];
+  az_iot_hub_client_c2d_request request;
+  az_result const result = az_iot_hub_client_c2d_parse_received_topic_indexed(
+      &clients->hub_client, topic, index, PERF_IOT_PROPERTIES_INDEX_SIZE, &request);
+  if (az_result_failed(result))
+  {
+    return result;
+  }
+
+  return perf_iot_c2d_lookup(&request.properties);
+}
+
+static az_result
+perf_iot_methods_parse(perf_iot_clients const* clients, az_span topic, az_span payload)
+{
+  (void)payload;
+
+  az_iot_hub_client_method_request request;
+  az_result const result
+      = az_iot_hub_client_methods_parse_received_topic(&clients->hub_client, topic, &request);
+  if (az_result_succeeded(result))
+  {
+    perf_iot_sink += az_span_size(request.name) + az_span_size(request.request_id);
+  }
+
+  return result;
+}
+
+static az_result
+perf_iot_twin_parse(perf_iot_clients const* clients, az_span topic, az_span payload)
+{
+  (void)payload;
+
+  az_iot_hub_client_twin_response response;
+  az_result const result
+      = az_iot_hub_client_twin_parse_received_topic(&clients->hub_client, topic, &response);
+  if (az_result_succeeded(result))
+  {
+    perf_iot_sink += (int64_t)response.status + az_span_size(response.version);
+  }
+
+  return result;
+}
+
+static az_result
+perf_iot_properties_find(perf_iot_clients const* clients, az_span properties, az_span payload)
+{
+  (void)clients;
+  (void)payload;
+
+  az_iot_message_properties parsed;
+  az_result const result
+      = az_iot_message_properties_init(&parsed, properties, az_span_size(properties));
+  if (az_result_failed(result))
+  {
+    return result;
+  }
+
+  return perf_iot_c2d_lookup(&parsed);
+}
+
+static az_result
+perf_iot_properties_next(perf_iot_clients const* clients, az_span properties, az_span payload)
+{
+  (void)clients;
+  (void)payload;
+
+  az_iot_message_properties parsed;
+  az_result result = az_iot_message_properties_init(&parsed, properties, az_span_size(properties));
+  if (az_result_failed(result))
+  {
+    return result;
+  }
+
+  az_span name;
+  az_span value;
+  while (az_result_succeeded(result = az_iot_message_properties_next(&parsed, &name, &value)))
+  {
+    perf_iot_sink += az_span_size(name) + az_span_size(value);
+  }
+
+  return result == AZ_ERROR_IOT_END_OF_PROPERTIES ? AZ_OK : result;
+}
+
+static az_result
+perf_iot_telemetry_topic(perf_iot_clients const* clients, az_span topic, az_span payload)
+{
+  (void)topic;
+  (void)payload;
+
+  char publish_topic[PERF_IOT_TOPIC_BUFFER_SIZE];
+  size_t publish_topic_length = 0;
+  az_result const result = az_iot_hub_client_telemetry_get_publish_topic(
+      &clients->hub_client, NULL, publish_topic, sizeof(publish_topic), &publish_topic_length);
+  perf_iot_sink += (int64_t)publish_topic_length;
+  return result;
+}
+
+static az_result perf_iot_telemetry_topic_with_properties(
+    perf_iot_clients const* clients,
+    az_span topic,
+    az_span payload)
+{
+  (void)topic;
+  (void)payload;
+
+  uint8_t properties_buffer[PERF_IOT_TOPIC_BUFFER_SIZE];
+  char publish_topic[PERF_IOT_TOPIC_BUFFER_SIZE];
+  az_iot_message_properties properties;
+  size_t publish_topic_length = 0;
+  if (az_result_failed(az_iot_message_properties_init(
+          &properties, AZ_SPAN_FROM_BUFFER(properties_buffer), 0))
+      || az_result_failed(az_iot_message_properties_append(
+          &properties, AZ_SPAN_FROM_STR("$.ct"), AZ_SPAN_FROM_STR("application%2Fjson")))
+      || az_result_failed(az_iot_message_properties_append(
+          &properties, AZ_SPAN_FROM_STR("$.ce"), AZ_SPAN_FROM_STR("utf-8")))
+      || az_result_failed(az_iot_message_properties_append(
+          &properties, AZ_SPAN_FROM_STR("component"), AZ_SPAN_FROM_STR("thermostat1"))))
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  az_result const result = az_iot_hub_client_telemetry_get_publish_topic(
+      &clients->hub_client,
+      &properties,
+      publish_topic,
+      sizeof(publish_topic),
+      &publish_topic_length);
+  perf_iot_sink += (int64_t)publish_topic_length;
+  return result;
+}
+
+static az_result
+perf_iot_hub_sas_signature(perf_iot_clients const* clients, az_span topic, az_span payload)
+{
+  (void)topic;
+  (void)payload;
+
+  uint8_t buffer[PERF_IOT_SIGNATURE_BUFFER_SIZE];
+  az_span signature;
+  az_result const result = az_iot_hub_client_sas_get_signature(
+      &clients->hub_client, 1596000000, AZ_SPAN_FROM_BUFFER(buffer), &signature);
+  perf_iot_sink += az_span_size(signature);
+  return result;
+}
+
+static az_result
+perf_iot_provisioning_sas_signature(perf_iot_clients const* clients, az_span topic, az_span payload)
+{
+  (void)topic;
+  (void)payload;
+
+  uint8_t buffer[PERF_IOT_SIGNATURE_BUFFER_SIZE];
+  az_span signature;
+  az_result const result = az_iot_provisioning_client_sas_get_signature(
+      &clients->provisioning_client, 1596000000, AZ_SPAN_FROM_BUFFER(buffer), &signature);
+  perf_iot_sink += az_span_size(signature);
+  return result;
+}
+
+static az_result
+perf_iot_provisioning_parse(perf_iot_clients const* clients, az_span topic, az_span payload)
+{
+  az_iot_provisioning_client_register_response response;
+  az_result const result = az_iot_provisioning_client_parse_received_topic_and_payload(
+      &clients->provisioning_client, topic, payload, &response);
+  if (az_result_succeeded(result))
+  {
+    perf_iot_sink += (int64_t)response.operation_status
+        + az_span_size(response.registration_state.assigned_hub_hostname);
+  }
+
+  return result;
+}
+
+int perf_run_iot(int32_t iterations)
+{
+  static perf_iot_clients clients;
+  if (az_result_failed(az_iot_hub_client_init(
+          &clients.hub_client,
+          AZ_SPAN_FROM_STR("myiothub.azure-devices.net"),
+          AZ_SPAN_FROM_STR("my_device"),
+          NULL))
+      || az_result_failed(az_iot_provisioning_client_init(
+          &clients.provisioning_client,
+          AZ_SPAN_FROM_STR("global.azure-devices-provisioning.net"),
+          AZ_SPAN_FROM_STR("0neFEEDC0DE"),
+          AZ_SPAN_FROM_STR("my-registration-id"),
+          NULL)))
+  {
+    printf("perf_run_iot: failed to initialize the clients\n");
+    return 1;
+  }
+
+  // The topics are short, so run them more often than the JSON documents.
+  int32_t const topic_iterations = iterations * 16;
+
+  int result = 0;
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_hub_client_topic_parse",
+      "mix",
+      perf_iot_topic_parse,
+      perf_iot_received_topics,
+      PERF_IOT_COUNT(perf_iot_received_topics),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_hub_client_c2d_parse_received_topic",
+      "mix",
+      perf_iot_c2d_parse,
+      perf_iot_c2d_topics,
+      PERF_IOT_COUNT(perf_iot_c2d_topics),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_hub_client_c2d_parse_received_topic_indexed",
+      "mix",
+      perf_iot_c2d_parse_indexed,
+      perf_iot_c2d_topics,
+      PERF_IOT_COUNT(perf_iot_c2d_topics),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_hub_client_methods_parse_received_topic",
+      "mix",
+      perf_iot_methods_parse,
+      perf_iot_methods_topics,
+      PERF_IOT_COUNT(perf_iot_methods_topics),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_hub_client_twin_parse_received_topic",
+      "mix",
+      perf_iot_twin_parse,
+      perf_iot_twin_topics,
+      PERF_IOT_COUNT(perf_iot_twin_topics),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_message_properties_find",
+      "6 properties",
+      perf_iot_properties_find,
+      perf_iot_properties,
+      PERF_IOT_COUNT(perf_iot_properties),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_message_properties_next",
+      "6 properties",
+      perf_iot_properties_next,
+      perf_iot_properties,
+      PERF_IOT_COUNT(perf_iot_properties),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_hub_client_telemetry_get_publish_topic",
+      "no properties",
+      perf_iot_telemetry_topic,
+      perf_iot_no_input,
+      PERF_IOT_COUNT(perf_iot_no_input),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_hub_client_telemetry_get_publish_topic",
+      "3 appended properties",
+      perf_iot_telemetry_topic_with_properties,
+      perf_iot_no_input,
+      PERF_IOT_COUNT(perf_iot_no_input),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_hub_client_sas_get_signature",
+      "device",
+      perf_iot_hub_sas_signature,
+      perf_iot_no_input,
+      PERF_IOT_COUNT(perf_iot_no_input),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_provisioning_client_sas_get_signature",
+      "registration",
+      perf_iot_provisioning_sas_signature,
+      perf_iot_no_input,
+      PERF_IOT_COUNT(perf_iot_no_input),
+      topic_iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_provisioning_client_parse_received_topic_and_payload",
+      "assigning",
+      perf_iot_provisioning_parse,
+      perf_iot_provisioning_assigning,
+      PERF_IOT_COUNT(perf_iot_provisioning_assigning),
+      iterations);
+  result |= perf_iot_run(
+      &clients,
+      "az_iot_provisioning_client_parse_received_topic_and_payload",
+      "assigned",
+      perf_iot_provisioning_parse,
+      perf_iot_provisioning_assigned,
+      PERF_IOT_COUNT(perf_iot_provisioning_assigned),
+      iterations);
+  return result;
+}
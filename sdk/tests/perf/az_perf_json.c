@@ -0,0 +1,614 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_perf.h"
+#include "az_perf_json_corpus.h"
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  // Size of each segment when the documents are parsed with az_json_reader_chunked_init.
+  PERF_JSON_CHUNK_SIZE = 64,
+
+  // Number of elements in the generated PnP telemetry batch.
+  PERF_JSON_PNP_ELEMENTS = 256,
+
+  PERF_JSON_PNP_BUFFER_SIZE
+  = PERF_JSON_PNP_ELEMENTS * (int32_t)sizeof(perf_json_pnp_telemetry_element) + 2,
+
+  PERF_JSON_MAX_CHUNKS = PERF_JSON_PNP_BUFFER_SIZE / PERF_JSON_CHUNK_SIZE + 1,
+};
+
+typedef struct
+{
+  char const* name;
+  az_span json;
+  az_span chunks[PERF_JSON_MAX_CHUNKS];
+  int32_t number_of_chunks;
+} perf_json_document;
+
+typedef az_result (*perf_json_fn)(az_json_reader* ref_reader, int64_t* out_tokens);
+
+static uint8_t perf_json_pnp_buffer[PERF_JSON_PNP_BUFFER_SIZE];
+
+// The written batch is a little larger than the corpus element, since doubles are written with a
+// fixed number of fractional digits.
+static uint8_t perf_json_writer_buffer[PERF_JSON_PNP_BUFFER_SIZE * 2];
+
+// Accumulates values read from the tokens, so that the compiler can't discard the getters.
+static volatile int64_t perf_json_sink;
+
+static az_span perf_json_build_pnp_batch(void)
+{
+  az_span remainder = AZ_SPAN_FROM_BUFFER(perf_json_pnp_buffer);
+  remainder = az_span_copy_u8(remainder, '[');
+  for (int32_t i = 0; i < PERF_JSON_PNP_ELEMENTS; i++)
+  {
+    if (i > 0)
+    {
+      remainder = az_span_copy_u8(remainder, ',');
+    }
+    remainder = az_span_copy(
+        remainder, az_span_create_from_str((char*)(uintptr_t)perf_json_pnp_telemetry_element));
+  }
+  remainder = az_span_copy_u8(remainder, ']');
+
+  return az_span_slice(
+      AZ_SPAN_FROM_BUFFER(perf_json_pnp_buffer),
+      0,
+      (int32_t)sizeof(perf_json_pnp_buffer) - az_span_size(remainder));
+}
+
+static void
+perf_json_document_init(perf_json_document* out_document, char const* name, az_span json)
+{
+  out_document->name = name;
+  out_document->json = json;
+  out_document->number_of_chunks = 0;
+
+  for (int32_t offset = 0; offset < az_span_size(json); offset += PERF_JSON_CHUNK_SIZE)
+  {
+    int32_t const end = offset + PERF_JSON_CHUNK_SIZE < az_span_size(json)
+        ? offset + PERF_JSON_CHUNK_SIZE
+        : az_span_size(json);
+    out_document->chunks[out_document->number_of_chunks++] = az_span_slice(json, offset, end);
+  }
+}
+
+static az_result perf_json_next_token(az_json_reader* ref_reader, int64_t* out_tokens)
+{
+  az_result result = AZ_OK;
+  while (az_result_succeeded(result = az_json_reader_next_token(ref_reader)))
+  {
+    (*out_tokens)++;
+  }
+
+  return result == AZ_ERROR_JSON_READER_DONE ? AZ_OK : result;
+}
+
+static az_result perf_json_skip_children(az_json_reader* ref_reader, int64_t* out_tokens)
+{
+  az_result result = az_json_reader_next_token(ref_reader);
+  if (az_result_failed(result))
+  {
+    return result;
+  }
+
+  result = az_json_reader_skip_children(ref_reader);
+  (*out_tokens)++;
+  return result;
+}
+
+static az_result perf_json_token_getters(az_json_reader* ref_reader, int64_t* out_tokens)
+{
+  char string_buffer[256];
+  az_result result = AZ_OK;
+
+  while (az_result_succeeded(result = az_json_reader_next_token(ref_reader)))
+  {
+    az_json_token const* token = &ref_reader->token;
+    (*out_tokens)++;
+
+    switch (token->kind)
+    {
+      case AZ_JSON_TOKEN_PROPERTY_NAME:
+      case AZ_JSON_TOKEN_STRING:
+      {
+        int32_t length = 0;
+        if (az_result_failed(
+                az_json_token_get_string(token, string_buffer, sizeof(string_buffer), &length)))
+        {
+          return AZ_ERROR_UNEXPECTED_CHAR;
+        }
+        perf_json_sink += length;
+        break;
+      }
+      case AZ_JSON_TOKEN_NUMBER:
+      {
+        int64_t integer = 0;
+        double number = 0;
+        if (az_result_succeeded(az_json_token_get_int64(token, &integer)))
+        {
+          perf_json_sink += integer;
+        }
+        else if (az_result_succeeded(az_json_token_get_double(token, &number)))
+        {
+          perf_json_sink += (int64_t)number;
+        }
+        else
+        {
+          return AZ_ERROR_UNEXPECTED_CHAR;
+        }
+        break;
+      }
+      case AZ_JSON_TOKEN_TRUE:
+      case AZ_JSON_TOKEN_FALSE:
+      {
+        bool value = false;
+        if (az_result_failed(az_json_token_get_boolean(token, &value)))
+        {
+          return AZ_ERROR_UNEXPECTED_CHAR;
+        }
+        perf_json_sink += value ? 1 : 0;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  return result == AZ_ERROR_JSON_READER_DONE ? AZ_OK : result;
+}
+
+static int perf_json_run(
+    char const* name,
+    perf_json_fn fn,
+    perf_json_document* document,
+    bool chunked,
+    az_json_reader_options const* options,
+    int32_t iterations)
+{
+  char variant[64];
+  (void)snprintf(variant, sizeof(variant), "%s%s", document->name, chunked ? " (chunked)" : "");
+
+  perf_result result = {
+    .name = name, .variant = variant, .seconds = 0, .bytes = 0, .items = 0, .cycles = 0
+  };
+
+  double const start = perf_now_seconds();
+  int64_t const start_cycles = perf_now_cycles();
+  for (int32_t i = 0; i < iterations; i++)
+  {
+    az_json_reader reader;
+    az_result init_result = chunked
+        ? az_json_reader_chunked_init(
+            &reader, document->chunks, document->number_of_chunks, options)
+        : az_json_reader_init(&reader, document->json, options);
+
+    if (az_result_failed(init_result) || az_result_failed(fn(&reader, &result.items)))
+    {
+      printf("%s: failed to parse %s\n", name, variant);
+      return 1;
+    }
+
+    result.bytes += az_span_size(document->json);
+  }
+  result.cycles = perf_now_cycles() - start_cycles;
+  result.seconds = perf_now_seconds() - start;
+
+  perf_report(&result);
+  return 0;
+}
+
+int perf_run_json(int32_t iterations)
+{
+  static perf_json_document documents[3];
+
+  perf_json_document_init(
+      &documents[0], "twin", az_span_create_from_str((char*)(uintptr_t)perf_json_twin_document));
+  perf_json_document_init(
+      &documents[1],
+      "dps_registration",
+      az_span_create_from_str((char*)(uintptr_t)perf_json_dps_registration_response));
+  perf_json_document_init(&documents[2], "pnp_telemetry_batch", perf_json_build_pnp_batch());
+
+  az_json_reader_options unvalidated_options = az_json_reader_options_default();
+  unvalidated_options.skip_children_without_validation = true;
+
+  int result = 0;
+  for (int32_t d = 0; d < (int32_t)_az_COUNTOF(documents); d++)
+  {
+    for (int32_t c = 0; c < 2; c++)
+    {
+      bool const chunked = c == 1;
+      result |= perf_json_run(
+          "az_json_reader_next_token",
+          perf_json_next_token,
+          &documents[d],
+          chunked,
+          NULL,
+          iterations);
+      result |= perf_json_run(
+          "az_json_reader_skip_children",
+          perf_json_skip_children,
+          &documents[d],
+          chunked,
+          NULL,
+          iterations);
+      result |= perf_json_run(
+          "az_json_reader_skip_children (unvalidated)",
+          perf_json_skip_children,
+          &documents[d],
+          chunked,
+          &unvalidated_options,
+          iterations);
+      result |= perf_json_run(
+          "az_json_token_get_*",
+          perf_json_token_getters,
+          &documents[d],
+          chunked,
+          NULL,
+          iterations);
+    }
+  }
+
+  return result;
+}
+
+// Appends the property NAME, escaped by the writer, or escaped at compile time when pre_escaped.
+#define PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, NAME)                                   \
+  ((pre_escaped) ? az_json_writer_append_escaped_property_name(ref_writer, AZ_JSON_NAME(NAME)) \
+                 : az_json_writer_append_property_name(ref_writer, AZ_SPAN_FROM_STR(NAME)))
+
+// Writes one element of the PnP telemetry batch, the same content as perf_json_pnp_telemetry_element.
+static az_result
+perf_json_write_pnp_element(az_json_writer* ref_writer, int32_t index, bool pre_escaped)
+{
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_writer));
+  for (int32_t t = 1; t <= 2; t++)
+  {
+    _az_RETURN_IF_FAILED(
+        t == 1 ? PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "thermostat1")
+               : PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "thermostat2"));
+    _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_writer));
+    _az_RETURN_IF_FAILED(PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "temperature"));
+    _az_RETURN_IF_FAILED(az_json_writer_append_double(ref_writer, 21.375 - index * 0.5, 3));
+    _az_RETURN_IF_FAILED(PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "humidity"));
+    _az_RETURN_IF_FAILED(az_json_writer_append_int32(ref_writer, 45 + t));
+    _az_RETURN_IF_FAILED(PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "pressure"));
+    _az_RETURN_IF_FAILED(az_json_writer_append_double_shortest(ref_writer, 1013.25 - t));
+    _az_RETURN_IF_FAILED(az_json_writer_append_end_object(ref_writer));
+  }
+
+  _az_RETURN_IF_FAILED(PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "deviceInformation"));
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_writer));
+  _az_RETURN_IF_FAILED(PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "workingSet"));
+  _az_RETURN_IF_FAILED(az_json_writer_append_int32(ref_writer, 184320 + index));
+  _az_RETURN_IF_FAILED(PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "uptimeSec"));
+  _az_RETURN_IF_FAILED(az_json_writer_append_int32(ref_writer, 86400));
+  _az_RETURN_IF_FAILED(PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "status"));
+  _az_RETURN_IF_FAILED(az_json_writer_append_string(ref_writer, AZ_SPAN_FROM_STR("ok")));
+  _az_RETURN_IF_FAILED(PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "alarm"));
+  _az_RETURN_IF_FAILED(az_json_writer_append_bool(ref_writer, false));
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_object(ref_writer));
+
+  _az_RETURN_IF_FAILED(PERF_JSON_APPEND_NAME(ref_writer, pre_escaped, "timestamp"));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_string(ref_writer, AZ_SPAN_FROM_STR("2020-10-15T06:45:32.5225461Z")));
+  return az_json_writer_append_end_object(ref_writer);
+}
+
+enum
+{
+  // The number of tokens written by perf_json_write_pnp_element.
+  PERF_JSON_PNP_ELEMENT_TOKENS = 33,
+};
+
+static az_result
+perf_json_write_pnp_elements(az_json_writer* ref_writer, int64_t* out_tokens, bool pre_escaped)
+{
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_writer));
+  for (int32_t i = 0; i < PERF_JSON_PNP_ELEMENTS; i++)
+  {
+    _az_RETURN_IF_FAILED(perf_json_write_pnp_element(ref_writer, i, pre_escaped));
+  }
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_array(ref_writer));
+
+  *out_tokens += PERF_JSON_PNP_ELEMENTS * PERF_JSON_PNP_ELEMENT_TOKENS + 2;
+  return AZ_OK;
+}
+
+static az_result perf_json_write_pnp_batch(az_json_writer* ref_writer, int64_t* out_tokens)
+{
+  return perf_json_write_pnp_elements(ref_writer, out_tokens, false);
+}
+
+static az_result
+perf_json_write_pnp_batch_pre_escaped(az_json_writer* ref_writer, int64_t* out_tokens)
+{
+  return perf_json_write_pnp_elements(ref_writer, out_tokens, true);
+}
+
+enum
+{
+  // The number of slots of each element in the PnP telemetry batch template.
+  PERF_JSON_PNP_ELEMENT_SLOTS = 11,
+};
+
+static int32_t
+    perf_json_template_slot_offsets[PERF_JSON_PNP_ELEMENTS * PERF_JSON_PNP_ELEMENT_SLOTS];
+static uint8_t perf_json_template_buffer[PERF_JSON_PNP_BUFFER_SIZE];
+
+// Writes the text of one element of the PnP telemetry batch, with slots for its values.
+static az_result
+perf_json_write_pnp_template_element(az_json_template* ref_template, az_json_writer* ref_writer)
+{
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_writer));
+  for (int32_t t = 1; t <= 2; t++)
+  {
+    _az_RETURN_IF_FAILED(az_json_writer_append_escaped_property_name(
+        ref_writer, t == 1 ? AZ_JSON_NAME("thermostat1") : AZ_JSON_NAME("thermostat2")));
+    _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_writer));
+    _az_RETURN_IF_FAILED(
+        az_json_writer_append_escaped_property_name(ref_writer, AZ_JSON_NAME("temperature")));
+    _az_RETURN_IF_FAILED(az_json_template_append_slot(ref_template, ref_writer));
+    _az_RETURN_IF_FAILED(
+        az_json_writer_append_escaped_property_name(ref_writer, AZ_JSON_NAME("humidity")));
+    _az_RETURN_IF_FAILED(az_json_template_append_slot(ref_template, ref_writer));
+    _az_RETURN_IF_FAILED(
+        az_json_writer_append_escaped_property_name(ref_writer, AZ_JSON_NAME("pressure")));
+    _az_RETURN_IF_FAILED(az_json_template_append_slot(ref_template, ref_writer));
+    _az_RETURN_IF_FAILED(az_json_writer_append_end_object(ref_writer));
+  }
+
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_escaped_property_name(ref_writer, AZ_JSON_NAME("deviceInformation")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_writer));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_escaped_property_name(ref_writer, AZ_JSON_NAME("workingSet")));
+  _az_RETURN_IF_FAILED(az_json_template_append_slot(ref_template, ref_writer));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_escaped_property_name(ref_writer, AZ_JSON_NAME("uptimeSec")));
+  _az_RETURN_IF_FAILED(az_json_template_append_slot(ref_template, ref_writer));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_escaped_property_name(ref_writer, AZ_JSON_NAME("status")));
+  _az_RETURN_IF_FAILED(az_json_template_append_slot(ref_template, ref_writer));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_escaped_property_name(ref_writer, AZ_JSON_NAME("alarm")));
+  _az_RETURN_IF_FAILED(az_json_template_append_slot(ref_template, ref_writer));
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_object(ref_writer));
+
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_escaped_property_name(ref_writer, AZ_JSON_NAME("timestamp")));
+  _az_RETURN_IF_FAILED(az_json_template_append_slot(ref_template, ref_writer));
+  return az_json_writer_append_end_object(ref_writer);
+}
+
+static az_result perf_json_build_pnp_template(az_json_template* out_template)
+{
+  _az_RETURN_IF_FAILED(az_json_template_init(
+      out_template,
+      perf_json_template_slot_offsets,
+      PERF_JSON_PNP_ELEMENTS * PERF_JSON_PNP_ELEMENT_SLOTS));
+
+  az_json_writer writer;
+  _az_RETURN_IF_FAILED(
+      az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(perf_json_template_buffer), NULL));
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(&writer));
+  for (int32_t i = 0; i < PERF_JSON_PNP_ELEMENTS; i++)
+  {
+    _az_RETURN_IF_FAILED(perf_json_write_pnp_template_element(out_template, &writer));
+  }
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_array(&writer));
+
+  return az_json_template_end(out_template, &writer);
+}
+
+// Fills the slots of one element of the PnP telemetry batch, with the values written by
+// perf_json_write_pnp_element.
+static az_result
+perf_json_fill_pnp_template_element(az_json_template_writer* ref_writer, int32_t index)
+{
+  for (int32_t t = 1; t <= 2; t++)
+  {
+    _az_RETURN_IF_FAILED(
+        az_json_template_writer_append_double(ref_writer, 21.375 - index * 0.5, 3));
+    _az_RETURN_IF_FAILED(az_json_template_writer_append_int32(ref_writer, 45 + t));
+    _az_RETURN_IF_FAILED(az_json_template_writer_append_double_shortest(ref_writer, 1013.25 - t));
+  }
+
+  _az_RETURN_IF_FAILED(az_json_template_writer_append_int32(ref_writer, 184320 + index));
+  _az_RETURN_IF_FAILED(az_json_template_writer_append_int32(ref_writer, 86400));
+  _az_RETURN_IF_FAILED(az_json_template_writer_append_string(ref_writer, AZ_SPAN_FROM_STR("ok")));
+  _az_RETURN_IF_FAILED(az_json_template_writer_append_bool(ref_writer, false));
+  return az_json_template_writer_append_string(
+      ref_writer, AZ_SPAN_FROM_STR("2020-10-15T06:45:32.5225461Z"));
+}
+
+static int perf_json_template_run(char const* name, char const* variant, int32_t iterations)
+{
+  perf_result result = {
+    .name = name, .variant = variant, .seconds = 0, .bytes = 0, .items = 0, .cycles = 0
+  };
+
+  az_json_template json_template;
+  if (az_result_failed(perf_json_build_pnp_template(&json_template)))
+  {
+    printf("%s: failed to build %s\n", name, variant);
+    return 1;
+  }
+
+  double const start = perf_now_seconds();
+  int64_t const start_cycles = perf_now_cycles();
+  for (int32_t i = 0; i < iterations; i++)
+  {
+    az_json_template_writer writer;
+    if (az_result_failed(az_json_template_writer_init(
+            &writer, &json_template, AZ_SPAN_FROM_BUFFER(perf_json_writer_buffer))))
+    {
+      printf("%s: failed to write %s\n", name, variant);
+      return 1;
+    }
+
+    for (int32_t e = 0; e < PERF_JSON_PNP_ELEMENTS; e++)
+    {
+      if (az_result_failed(perf_json_fill_pnp_template_element(&writer, e)))
+      {
+        printf("%s: failed to write %s\n", name, variant);
+        return 1;
+      }
+    }
+
+    az_span json;
+    if (az_result_failed(az_json_template_writer_end(&writer, &json)))
+    {
+      printf("%s: failed to write %s\n", name, variant);
+      return 1;
+    }
+
+    result.bytes += az_span_size(json);
+    result.items += PERF_JSON_PNP_ELEMENTS * PERF_JSON_PNP_ELEMENT_TOKENS + 2;
+  }
+  result.cycles = perf_now_cycles() - start_cycles;
+  result.seconds = perf_now_seconds() - start;
+
+  perf_report(&result);
+  return 0;
+}
+
+static az_result perf_json_write_twin_text(az_json_writer* ref_writer, int64_t* out_tokens)
+{
+  // Validates the document and copies it, as done when forwarding a twin document.
+  _az_RETURN_IF_FAILED(az_json_writer_append_json_text(
+      ref_writer, az_span_create_from_str((char*)(uintptr_t)perf_json_twin_document)));
+
+  (*out_tokens)++;
+  return AZ_OK;
+}
+
+enum
+{
+  // The number of samples in the vibration telemetry array.
+  PERF_JSON_SAMPLES = 1000,
+};
+
+static double perf_json_samples[PERF_JSON_SAMPLES];
+
+static void perf_json_build_samples(void)
+{
+  for (int32_t i = 0; i < PERF_JSON_SAMPLES; i++)
+  {
+    perf_json_samples[i] = (i % 200 - 100) * 0.0125;
+  }
+}
+
+static az_result perf_json_write_samples(az_json_writer* ref_writer, int64_t* out_tokens)
+{
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_writer));
+  for (int32_t i = 0; i < PERF_JSON_SAMPLES; i++)
+  {
+    _az_RETURN_IF_FAILED(az_json_writer_append_double(ref_writer, perf_json_samples[i], 4));
+  }
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_array(ref_writer));
+
+  *out_tokens += PERF_JSON_SAMPLES + 2;
+  return AZ_OK;
+}
+
+static az_result perf_json_write_samples_array(az_json_writer* ref_writer, int64_t* out_tokens)
+{
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_double_array(ref_writer, perf_json_samples, PERF_JSON_SAMPLES, 4));
+
+  *out_tokens += PERF_JSON_SAMPLES + 2;
+  return AZ_OK;
+}
+
+typedef az_result (*perf_json_writer_fn)(az_json_writer* ref_writer, int64_t* out_tokens);
+
+static int perf_json_writer_run_with_options(
+    char const* name,
+    char const* variant,
+    perf_json_writer_fn fn,
+    az_json_writer_options const* options,
+    int32_t iterations)
+{
+  perf_result result = {
+    .name = name, .variant = variant, .seconds = 0, .bytes = 0, .items = 0, .cycles = 0
+  };
+
+  double const start = perf_now_seconds();
+  int64_t const start_cycles = perf_now_cycles();
+  for (int32_t i = 0; i < iterations; i++)
+  {
+    az_json_writer writer;
+    if (az_result_failed(
+            az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(perf_json_writer_buffer), options))
+        || az_result_failed(fn(&writer, &result.items)))
+    {
+      printf("%s: failed to write %s\n", name, variant);
+      return 1;
+    }
+
+    result.bytes += az_span_size(az_json_writer_get_bytes_used_in_destination(&writer));
+  }
+  result.cycles = perf_now_cycles() - start_cycles;
+  result.seconds = perf_now_seconds() - start;
+
+  perf_report(&result);
+  return 0;
+}
+
+static int perf_json_writer_run(
+    char const* name,
+    char const* variant,
+    perf_json_writer_fn fn,
+    int32_t iterations)
+{
+  return perf_json_writer_run_with_options(name, variant, fn, NULL, iterations);
+}
+
+int perf_run_json_writer(int32_t iterations)
+{
+  int result = 0;
+  result |= perf_json_writer_run(
+      "az_json_writer_append_*", "pnp_telemetry_batch", perf_json_write_pnp_batch, iterations);
+  result |= perf_json_writer_run(
+      "az_json_writer_append_*",
+      "pnp_telemetry_batch (pre-escaped)",
+      perf_json_write_pnp_batch_pre_escaped,
+      iterations);
+  result |= perf_json_template_run(
+      "az_json_template_writer_append_*", "pnp_telemetry_batch", iterations);
+  perf_json_build_samples();
+  result |= perf_json_writer_run(
+      "az_json_writer_append_double", "vibration_samples", perf_json_write_samples, iterations);
+  result |= perf_json_writer_run(
+      "az_json_writer_append_double_array",
+      "vibration_samples",
+      perf_json_write_samples_array,
+      iterations);
+  result |= perf_json_writer_run(
+      "az_json_writer_append_json_text", "twin", perf_json_write_twin_text, iterations);
+
+  az_json_writer_options options = az_json_writer_options_default();
+  options.append_json_text_without_validation = true;
+  result |= perf_json_writer_run_with_options(
+      "az_json_writer_append_json_text",
+      "twin (without validation)",
+      perf_json_write_twin_text,
+      &options,
+      iterations);
+  return result;
+}
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#ifndef _az_PERF_JSON_CORPUS_H
+#define _az_PERF_JSON_CORPUS_H
+
+// A device twin document, as received on $iothub/twin/res/200.
+static char const perf_json_twin_document[]
+    = "{\"desired\":{\"targetTemperature\":68.5,\"maxTempSinceLastReboot\":74.25,"
+      "\"telemetryIntervalSec\":10,\"firmware\":{\"fwVersion\":\"1.2.3\","
+      "\"fwPackageURI\":\"https://contoso.blob.core.windows.net/fw/pkg-1.2.3.bin\","
+      "\"fwPackageCheckValue\":\"0x5f3759df\",\"fwUpdateStatus\":\"pending\"},"
+      "\"thermostat1\":{\"__t\":\"c\",\"targetTemperature\":{\"value\":22.5,\"ac\":200,\"av\":7,"
+      "\"ad\":\"success\"}},\"thermostat2\":{\"__t\":\"c\",\"targetTemperature\":{\"value\":-4,"
+      "\"ac\":200,\"av\":7,\"ad\":\"success\"}},\"tags\":[\"building43\",\"floor2\",\"room\\t12\","
+      "\"line\\nbreak\"],\"enabled\":true,\"maintenance\":false,\"owner\":null,\"$version\":7},"
+      "\"reported\":{\"serialNumber\":\"SN-000000001\",\"manufacturer\":\"Contoso\","
+      "\"model\":\"TH-2000\",\"swVersion\":\"2020.10.1\",\"osName\":\"FreeRTOS\","
+      "\"processorArchitecture\":\"ARM Cortex-M4\",\"totalStorage\":1048576,\"totalMemory\":262144,"
+      "\"maxTempSinceLastReboot\":{\"value\":74.25,\"ac\":200,\"av\":7,"
+      "\"ad\":\"Successfully executed patch\"},\"lastBoot\":\"2020-10-15T06:45:32.5225461Z\","
+      "\"$version\":42}}";
+
+// A Device Provisioning Service registration response.
+static char const perf_json_dps_registration_response[]
+    = "{\"operationId\":\"4.002305f54fc89692.b1f11200-df88-4b76-b331-309c4c3a5ad6\","
+      "\"status\":\"assigned\",\"registrationState\":{\"x509\":{\"enrollmentGroupId\":"
+      "\"contoso-devices\",\"signingCertificateInfo\":{\"subjectName\":\"CN=contoso-ca\","
+      "\"sha1Thumbprint\":\"3D1E8A98C0DDF1A4DD1F6E6F7C5A3D5C4F1B2A3C\",\"sha256Thumbprint\":"
+      "\"B2B0B4E0886D6C6E2F0A1C3EFB6C0E13A3F6E0A1C1EA0D9B2E3F2C2D5E9A6B7C\","
+      "\"issuerName\":\"CN=contoso-root\",\"notBeforeUtc\":\"2020-01-01T00:00:00Z\","
+      "\"notAfterUtc\":\"2030-01-01T00:00:00Z\",\"serialNumber\":\"0A1B2C3D4E5F\",\"version\":3}},"
+      "\"registrationId\":\"mydevice\",\"createdDateTimeUtc\":\"2020-10-15T06:45:31.1719275Z\","
+      "\"assignedHub\":\"contoso-hub.azure-devices.net\",\"deviceId\":\"mydevice\","
+      "\"status\":\"assigned\",\"substatus\":\"initialAssignment\","
+      "\"lastUpdatedDateTimeUtc\":\"2020-10-15T06:45:31.4064526Z\","
+      "\"etag\":\"IjYxMDBlYzY0LTAwMDAtMDEwMC0wMDAwLTVmODdmMDFiMDAwMCI=\"}}";
+
+// One element of the generated PnP telemetry batch. It is repeated to build a large document.
+static char const perf_json_pnp_telemetry_element[]
+    = "{\"thermostat1\":{\"temperature\":21.375,\"humidity\":45,\"pressure\":1013.25},"
+      "\"thermostat2\":{\"temperature\":-3.5,\"humidity\":80,\"pressure\":1009.5},"
+      "\"deviceInformation\":{\"workingSet\":184320,\"uptimeSec\":86400,\"status\":\"ok\","
+      "\"alarm\":false},\"timestamp\":\"2020-10-15T06:45:32.5225461Z\"}";
+
+#endif // _az_PERF_JSON_CORPUS_H
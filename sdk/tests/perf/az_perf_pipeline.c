@@ -0,0 +1,221 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_perf.h"
+
+#include <azure/core/az_context.h>
+#include <azure/core/az_credentials.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_loopback.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  // Each iteration sends this many requests, so that the default number of iterations sends a
+  // million requests through the pipeline.
+  PERF_PIPELINE_REQUESTS_PER_ITERATION = 500,
+
+  PERF_PIPELINE_URL_BUFFER_SIZE = 256,
+  PERF_PIPELINE_HEADER_COUNT = 8,
+  PERF_PIPELINE_RESPONSE_BUFFER_SIZE = 1024,
+};
+
+#define PERF_PIPELINE_COUNT(array) (sizeof(array) / sizeof((array)[0]))
+
+// AZ_SPAN_EMPTY is a compound literal, which can't initialize a static array.
+#define PERF_PIPELINE_SPAN_EMPTY                 \
+  {                                              \
+    ._internal = { .ptr = NULL, .size = 0 }      \
+  }
+
+static az_span const perf_pipeline_url
+    = AZ_SPAN_LITERAL_FROM_STR("https://myaccount.blob.core.windows.net/container/blob?comp=tags");
+
+static az_span const perf_pipeline_body = AZ_SPAN_LITERAL_FROM_STR(
+    "{\"name\":\"thermostat\",\"temperature\":21.5,\"humidity\":48,\"status\":\"ok\"}");
+
+static az_http_loopback_response const perf_pipeline_ok[] = {
+  { AZ_HTTP_STATUS_CODE_OK,
+    AZ_SPAN_LITERAL_FROM_STR("Content-Type: application/json\r\n"
+                             "x-ms-request-id: 0b1d8a40-5e8b-4d7e-9d9b-2b4fb4d1f6c2\r\n"),
+    AZ_SPAN_LITERAL_FROM_STR("{\"status\":\"ok\"}") },
+};
+
+// Throttled every other time, with a retry delay of 0 so that only the retry itself is measured.
+static az_http_loopback_response const perf_pipeline_throttled[] = {
+  { AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS,
+    AZ_SPAN_LITERAL_FROM_STR("retry-after-ms: 0\r\n"),
+    PERF_PIPELINE_SPAN_EMPTY },
+  { AZ_HTTP_STATUS_CODE_OK,
+    PERF_PIPELINE_SPAN_EMPTY,
+    AZ_SPAN_LITERAL_FROM_STR("{\"status\":\"ok\"}") },
+};
+
+// Two server errors with a Retry-After of 0 seconds before each success.
+static az_http_loopback_response const perf_pipeline_unavailable[] = {
+  { AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE,
+    AZ_SPAN_LITERAL_FROM_STR("Retry-After: 0\r\n"),
+    PERF_PIPELINE_SPAN_EMPTY },
+  { AZ_HTTP_STATUS_CODE_INTERNAL_SERVER_ERROR,
+    AZ_SPAN_LITERAL_FROM_STR("Retry-After: 0\r\n"),
+    PERF_PIPELINE_SPAN_EMPTY },
+  { AZ_HTTP_STATUS_CODE_OK,
+    PERF_PIPELINE_SPAN_EMPTY,
+    AZ_SPAN_LITERAL_FROM_STR("{\"status\":\"ok\"}") },
+};
+
+// The policies a client puts in its pipeline, ending with the transport.
+typedef struct
+{
+  _az_http_policy_apiversion_options apiversion_options;
+  _az_http_policy_telemetry_options telemetry_options;
+  az_http_policy_retry_options retry_options;
+  _az_http_pipeline pipeline;
+} perf_pipeline;
+
+static void perf_pipeline_init(perf_pipeline* out_pipeline)
+{
+  out_pipeline->apiversion_options = _az_http_policy_apiversion_options_default();
+  out_pipeline->apiversion_options._internal.name = AZ_SPAN_FROM_STR("x-ms-version");
+  out_pipeline->apiversion_options._internal.version = AZ_SPAN_FROM_STR("2019-02-02");
+  out_pipeline->telemetry_options = _az_http_policy_telemetry_options_default();
+  out_pipeline->retry_options = _az_http_policy_retry_options_default();
+
+  out_pipeline->pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        { ._internal = { .process = az_http_pipeline_policy_apiversion,
+                         .options = &out_pipeline->apiversion_options } },
+        { ._internal = { .process = az_http_pipeline_policy_telemetry,
+                         .options = &out_pipeline->telemetry_options } },
+        { ._internal = { .process = az_http_pipeline_policy_retry,
+                         .options = &out_pipeline->retry_options } },
+        { ._internal = { .process = az_http_pipeline_policy_credential,
+                         .options = AZ_CREDENTIAL_ANONYMOUS } },
+#ifndef AZ_NO_LOGGING
+        { ._internal = { .process = az_http_pipeline_policy_logging, .options = NULL } },
+#endif // AZ_NO_LOGGING
+        { ._internal = { .process = az_http_pipeline_policy_transport, .options = NULL } },
+      },
+    },
+  };
+}
+
+// Sends a PUT request, as a client would build it, and checks that it eventually succeeded.
+static bool perf_pipeline_send(perf_pipeline* ref_pipeline, int64_t* ref_bytes)
+{
+  uint8_t url_buffer[PERF_PIPELINE_URL_BUFFER_SIZE];
+  uint8_t headers_buffer[PERF_PIPELINE_HEADER_COUNT * sizeof(_az_http_request_header)];
+  uint8_t response_buffer[PERF_PIPELINE_RESPONSE_BUFFER_SIZE];
+
+  az_span const url = AZ_SPAN_FROM_BUFFER(url_buffer);
+  (void)az_span_copy(url, perf_pipeline_url);
+
+  az_http_request request;
+  az_http_response response;
+  az_http_response_status_line status_line;
+  if (az_result_failed(az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_put(),
+          url,
+          az_span_size(perf_pipeline_url),
+          AZ_SPAN_FROM_BUFFER(headers_buffer),
+          perf_pipeline_body))
+      || az_result_failed(az_http_request_append_header(
+          &request, AZ_SPAN_FROM_STR("Content-Type"), AZ_SPAN_FROM_STR("application/json")))
+      || az_result_failed(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buffer)))
+      || az_result_failed(az_http_pipeline_process(&ref_pipeline->pipeline, &request, &response))
+      || az_result_failed(az_http_response_get_status_line(&response, &status_line))
+      || status_line.status_code != AZ_HTTP_STATUS_CODE_OK)
+  {
+    return false;
+  }
+
+  *ref_bytes += az_span_size(perf_pipeline_body);
+  return true;
+}
+
+static int perf_pipeline_run(
+    char const* variant,
+    az_http_loopback_response const* responses,
+    size_t responses_count,
+    int32_t iterations)
+{
+  az_http_loopback loopback;
+  if (az_result_failed(az_http_loopback_init(&loopback, responses, (int32_t)responses_count, 0)))
+  {
+    printf("az_http_pipeline_process: failed to initialize the loopback of %s\n", variant);
+    return 1;
+  }
+
+  az_http_loopback_set(&loopback);
+
+  perf_pipeline pipeline;
+  perf_pipeline_init(&pipeline);
+
+  perf_result result = { .name = "az_http_pipeline_process",
+                         .variant = variant,
+                         .seconds = 0,
+                         .bytes = 0,
+                         .items = 0,
+                         .cycles = 0 };
+
+  double const start = perf_now_seconds();
+  int64_t const start_cycles = perf_now_cycles();
+  for (int32_t i = 0; i < iterations; i++)
+  {
+    for (int32_t r = 0; r < PERF_PIPELINE_REQUESTS_PER_ITERATION; r++)
+    {
+      if (!perf_pipeline_send(&pipeline, &result.bytes))
+      {
+        printf("az_http_pipeline_process: failed to send a request of %s\n", variant);
+        az_http_loopback_set(NULL);
+        return 1;
+      }
+
+      result.items++;
+    }
+  }
+  result.cycles = perf_now_cycles() - start_cycles;
+  result.seconds = perf_now_seconds() - start;
+
+  az_http_loopback_set(NULL);
+
+  perf_report(&result);
+  return 0;
+}
+
+int perf_run_pipeline(int32_t iterations)
+{
+  int result = perf_pipeline_run(
+      "200 OK", perf_pipeline_ok, PERF_PIPELINE_COUNT(perf_pipeline_ok), iterations);
+
+  // Retries wait for their delay, even of 0, which requires a platform implementation.
+  if (az_result_succeeded(az_platform_sleep_msec(0)))
+  {
+    result |= perf_pipeline_run(
+        "429, 200",
+        perf_pipeline_throttled,
+        PERF_PIPELINE_COUNT(perf_pipeline_throttled),
+        iterations);
+    result |= perf_pipeline_run(
+        "503, 500, 200",
+        perf_pipeline_unavailable,
+        PERF_PIPELINE_COUNT(perf_pipeline_unavailable),
+        iterations);
+  }
+
+  return result;
+}
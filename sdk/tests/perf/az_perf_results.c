@@ -0,0 +1,535 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief Keeps the results of the benchmarks, to write them as JSON along with what they depend
+ * on (the SDK version, the compiler, the build flags and the CPU), and to compare them with the
+ * results of another build, such as the previous release.
+ */
+
+#include "az_perf.h"
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/az_version.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define PERF_HAS_CPUID 1
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PERF_HAS_CPUID 1
+#endif
+
+#include <azure/core/_az_cfg.h>
+
+#define PERF_STRINGIFY(x) #x
+#define PERF_TO_STRING(x) PERF_STRINGIFY(x)
+
+#if defined(__clang__)
+#define PERF_COMPILER "clang " __clang_version__
+#elif defined(__GNUC__)
+#define PERF_COMPILER "gcc " __VERSION__
+#elif defined(_MSC_VER)
+#define PERF_COMPILER "msvc " PERF_TO_STRING(_MSC_FULL_VER)
+#else
+#define PERF_COMPILER "unknown"
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PERF_ARCHITECTURE "x86_64"
+#elif defined(__i386__) || defined(_M_IX86)
+#define PERF_ARCHITECTURE "x86"
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PERF_ARCHITECTURE "arm64"
+#elif defined(__arm__) || defined(_M_ARM)
+#define PERF_ARCHITECTURE "arm"
+#else
+#define PERF_ARCHITECTURE "unknown"
+#endif
+
+// Defined by CMake, from the configuration of the build.
+#ifndef PERF_BUILD_TYPE
+#define PERF_BUILD_TYPE "unknown"
+#endif
+#ifndef PERF_C_FLAGS
+#define PERF_C_FLAGS "unknown"
+#endif
+#ifndef PERF_BUILD_OPTIONS
+#define PERF_BUILD_OPTIONS "unknown"
+#endif
+
+enum
+{
+  PERF_RESULTS_MAX = 256,
+  PERF_RESULTS_NAME_SIZE = 80,
+  PERF_RESULTS_WRITER_BUFFER_SIZE = 256,
+  PERF_RESULTS_CPU_SIZE = 64,
+  PERF_RESULTS_TIMESTAMP_SIZE = 32,
+};
+
+// The results timed over less than this are too noisy to be compared.
+#define PERF_RESULTS_MIN_COMPARED_SECONDS 0.02
+
+typedef struct
+{
+  char name[PERF_RESULTS_NAME_SIZE];
+  char variant[PERF_RESULTS_NAME_SIZE];
+  perf_result result;
+  bool compared;
+} perf_results_entry;
+
+static perf_results_entry perf_results[PERF_RESULTS_MAX];
+static int32_t perf_results_count;
+
+// The benchmarks report the cost of each item, so a result without items counts as a single one.
+static double perf_results_ns_per_op(perf_result const* result)
+{
+  return (result->seconds * 1e9) / (result->items > 0 ? (double)result->items : 1);
+}
+
+void perf_results_add(perf_result const* result)
+{
+  if (perf_results_count == PERF_RESULTS_MAX)
+  {
+    printf(
+        "perf_results_add: too many results, %s (%s) is not recorded\n",
+        result->name,
+        result->variant);
+    return;
+  }
+
+  // The names and variants may be formatted into buffers which don't outlive the benchmark.
+  perf_results_entry* const entry = &perf_results[perf_results_count++];
+  (void)snprintf(entry->name, sizeof(entry->name), "%s", result->name);
+  (void)snprintf(entry->variant, sizeof(entry->variant), "%s", result->variant);
+  entry->result = *result;
+  entry->result.name = entry->name;
+  entry->result.variant = entry->variant;
+  entry->compared = false;
+}
+
+// Reads the brand string of the CPU, such as "Intel(R) Xeon(R) Platinum 8375C CPU @ 2.90GHz".
+static void perf_results_get_cpu(char* cpu, size_t cpu_size)
+{
+  (void)snprintf(cpu, cpu_size, "unknown");
+
+#ifdef PERF_HAS_CPUID
+  uint32_t brand[12] = { 0 };
+#if defined(_MSC_VER)
+  int registers[4];
+  __cpuid(registers, (int)0x80000000);
+  if ((uint32_t)registers[0] < 0x80000004U)
+  {
+    return;
+  }
+
+  for (int i = 0; i < 3; i++)
+  {
+    __cpuid(registers, (int)(0x80000002U + (uint32_t)i));
+    memcpy(&brand[i * 4], registers, sizeof(registers));
+  }
+#else
+  if (__get_cpuid_max(0x80000000U, NULL) < 0x80000004U)
+  {
+    return;
+  }
+
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    unsigned int registers[4];
+    __get_cpuid(0x80000002U + i, &registers[0], &registers[1], &registers[2], &registers[3]);
+    memcpy(&brand[i * 4], registers, sizeof(registers));
+  }
+#endif
+
+  char text[sizeof(brand) + 1] = { 0 };
+  memcpy(text, brand, sizeof(brand));
+  char const* start = text;
+  while (*start == ' ')
+  {
+    start++;
+  }
+
+  (void)snprintf(cpu, cpu_size, "%s", start);
+#else
+  // Elsewhere, Linux describes the CPU in /proc/cpuinfo, with a field depending on the
+  // architecture.
+  FILE* const cpuinfo = fopen("/proc/cpuinfo", "r");
+  if (cpuinfo == NULL)
+  {
+    return;
+  }
+
+  char line[256];
+  while (fgets(line, sizeof(line), cpuinfo) != NULL)
+  {
+    char const* const separator = strchr(line, ':');
+    if (separator != NULL
+        && (strncmp(line, "model name", 10) == 0 || strncmp(line, "Hardware", 8) == 0
+            || strncmp(line, "cpu model", 9) == 0))
+    {
+      (void)snprintf(cpu, cpu_size, "%s", separator + 2);
+      cpu[strcspn(cpu, "\n")] = '\0';
+      break;
+    }
+  }
+
+  (void)fclose(cpuinfo);
+#endif
+}
+
+static az_result perf_results_sink(void* user_context, az_span json_text)
+{
+  size_t const size = (size_t)az_span_size(json_text);
+  return fwrite(az_span_ptr(json_text), 1, size, (FILE*)user_context) == size
+      ? AZ_OK
+      : AZ_ERROR_NOT_ENOUGH_SPACE;
+}
+
+static az_result
+perf_results_append_string(az_json_writer* writer, char const* name, char const* value)
+{
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_property_name(writer, az_span_create_from_str((char*)(uintptr_t)name)));
+  return az_json_writer_append_string(writer, az_span_create_from_str((char*)(uintptr_t)value));
+}
+
+static az_result perf_results_append_number(
+    az_json_writer* writer,
+    char const* name,
+    double value,
+    int32_t fractional_digits)
+{
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_property_name(writer, az_span_create_from_str((char*)(uintptr_t)name)));
+  return az_json_writer_append_double(writer, value, fractional_digits);
+}
+
+static az_result
+perf_results_write_entries(az_json_writer* writer, char const* label, int32_t iterations)
+{
+  char cpu[PERF_RESULTS_CPU_SIZE];
+  perf_results_get_cpu(cpu, sizeof(cpu));
+
+  char timestamp[PERF_RESULTS_TIMESTAMP_SIZE] = "unknown";
+  time_t const now = time(NULL);
+  struct tm const* const utc = gmtime(&now);
+  if (utc != NULL)
+  {
+    (void)strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", utc);
+  }
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(writer));
+  _az_RETURN_IF_FAILED(perf_results_append_string(writer, "sdk_version", AZ_SDK_VERSION_STRING));
+  _az_RETURN_IF_FAILED(perf_results_append_string(writer, "label", label == NULL ? "" : label));
+  _az_RETURN_IF_FAILED(perf_results_append_string(writer, "timestamp", timestamp));
+  _az_RETURN_IF_FAILED(perf_results_append_number(writer, "iterations", iterations, 0));
+
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_property_name(writer, AZ_SPAN_FROM_STR("environment")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(writer));
+  _az_RETURN_IF_FAILED(perf_results_append_string(writer, "compiler", PERF_COMPILER));
+  _az_RETURN_IF_FAILED(perf_results_append_string(writer, "build_type", PERF_BUILD_TYPE));
+  _az_RETURN_IF_FAILED(perf_results_append_string(writer, "c_flags", PERF_C_FLAGS));
+  _az_RETURN_IF_FAILED(perf_results_append_string(writer, "build_options", PERF_BUILD_OPTIONS));
+  _az_RETURN_IF_FAILED(perf_results_append_string(writer, "architecture", PERF_ARCHITECTURE));
+  _az_RETURN_IF_FAILED(perf_results_append_string(writer, "cpu", cpu));
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_object(writer));
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_property_name(writer, AZ_SPAN_FROM_STR("results")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(writer));
+  for (int32_t i = 0; i < perf_results_count; i++)
+  {
+    perf_result const* const result = &perf_results[i].result;
+    double const items = result->items > 0 ? (double)result->items : 1;
+    double const seconds = result->seconds > 0 ? result->seconds : 1e-9;
+
+    _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(writer));
+    _az_RETURN_IF_FAILED(perf_results_append_string(writer, "name", result->name));
+    _az_RETURN_IF_FAILED(perf_results_append_string(writer, "variant", result->variant));
+    _az_RETURN_IF_FAILED(perf_results_append_number(writer, "seconds", result->seconds, 6));
+    _az_RETURN_IF_FAILED(perf_results_append_number(writer, "bytes", (double)result->bytes, 0));
+    _az_RETURN_IF_FAILED(perf_results_append_number(writer, "items", (double)result->items, 0));
+    _az_RETURN_IF_FAILED(
+        perf_results_append_number(writer, "ns_per_op", perf_results_ns_per_op(result), 3));
+    _az_RETURN_IF_FAILED(perf_results_append_number(
+        writer, "cycles_per_op", (double)result->cycles / items, 3));
+    _az_RETURN_IF_FAILED(perf_results_append_number(
+        writer, "mb_per_s", ((double)result->bytes / (1024.0 * 1024.0)) / seconds, 3));
+    _az_RETURN_IF_FAILED(az_json_writer_append_end_object(writer));
+  }
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_array(writer));
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_object(writer));
+  return az_json_writer_flush(writer);
+}
+
+int perf_results_write_json(char const* path, char const* label, int32_t iterations)
+{
+  FILE* const file = fopen(path, "wb");
+  if (file == NULL)
+  {
+    printf("perf_results_write_json: failed to open %s\n", path);
+    return 1;
+  }
+
+  uint8_t buffer[PERF_RESULTS_WRITER_BUFFER_SIZE];
+  az_json_writer writer;
+  az_result result = az_json_writer_sink_init(
+      &writer, AZ_SPAN_FROM_BUFFER(buffer), perf_results_sink, file, NULL);
+  if (az_result_succeeded(result))
+  {
+    result = perf_results_write_entries(&writer, label, iterations);
+  }
+
+  if (fclose(file) != 0 || az_result_failed(result))
+  {
+    printf("perf_results_write_json: failed to write %s\n", path);
+    return 1;
+  }
+
+  return 0;
+}
+
+static perf_results_entry*
+perf_results_find(az_json_token const* name, az_json_token const* variant)
+{
+  for (int32_t i = 0; i < perf_results_count; i++)
+  {
+    if (az_json_token_is_text_equal(name, az_span_create_from_str(perf_results[i].name))
+        && az_json_token_is_text_equal(variant, az_span_create_from_str(perf_results[i].variant)))
+    {
+      return &perf_results[i];
+    }
+  }
+
+  return NULL;
+}
+
+// Compares one result of the baseline with the matching result of this run, if there is one.
+// Returns whether it's slower than allowed.
+static bool perf_results_compare_entry(
+    az_json_token const* name,
+    az_json_token const* variant,
+    double baseline_seconds,
+    double baseline_ns_per_op,
+    double max_slowdown)
+{
+  perf_results_entry* const entry = perf_results_find(name, variant);
+  if (entry == NULL)
+  {
+    return false;
+  }
+
+  entry->compared = true;
+
+  double const ns_per_op = perf_results_ns_per_op(&entry->result);
+  if (baseline_seconds < PERF_RESULTS_MIN_COMPARED_SECONDS
+      || entry->result.seconds < PERF_RESULTS_MIN_COMPARED_SECONDS || baseline_ns_per_op <= 0)
+  {
+    printf(
+        "%-60s %-32s %12.1f %12.1f %10s\n",
+        entry->name,
+        entry->variant,
+        baseline_ns_per_op,
+        ns_per_op,
+        "too short");
+    return false;
+  }
+
+  double const ratio = ns_per_op / baseline_ns_per_op;
+  bool const slower = max_slowdown > 0 && ratio > max_slowdown;
+  printf(
+      "%-60s %-32s %12.1f %12.1f %9.2fx%s\n",
+      entry->name,
+      entry->variant,
+      baseline_ns_per_op,
+      ns_per_op,
+      ratio,
+      slower ? " SLOWER" : "");
+  return slower;
+}
+
+// Walks the results of the baseline, comparing each with the matching result of this run.
+static az_result perf_results_compare_baseline(
+    az_json_reader* reader,
+    double max_slowdown,
+    int32_t* out_slower_count)
+{
+  // Finds the "results" array of the top-level object.
+  _az_RETURN_IF_FAILED(az_json_reader_next_token(reader));
+  if (reader->token.kind != AZ_JSON_TOKEN_BEGIN_OBJECT)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  while (true)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(reader));
+    if (reader->token.kind != AZ_JSON_TOKEN_PROPERTY_NAME)
+    {
+      return AZ_ERROR_ITEM_NOT_FOUND;
+    }
+
+    bool const is_results
+        = az_json_token_is_text_equal(&reader->token, AZ_SPAN_FROM_STR("results"));
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(reader));
+    if (is_results)
+    {
+      break;
+    }
+
+    _az_RETURN_IF_FAILED(az_json_reader_skip_children(reader));
+  }
+
+  if (reader->token.kind != AZ_JSON_TOKEN_BEGIN_ARRAY)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  _az_RETURN_IF_FAILED(az_json_reader_next_token(reader));
+  while (reader->token.kind == AZ_JSON_TOKEN_BEGIN_OBJECT)
+  {
+    // The tokens refer to the baseline text, which outlives them.
+    az_json_token name = { 0 };
+    az_json_token variant = { 0 };
+    double seconds = 0;
+    double ns_per_op = 0;
+
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(reader));
+    while (reader->token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+    {
+      az_json_token const property = reader->token;
+      _az_RETURN_IF_FAILED(az_json_reader_next_token(reader));
+      if (az_json_token_is_text_equal(&property, AZ_SPAN_FROM_STR("name")))
+      {
+        name = reader->token;
+      }
+      else if (az_json_token_is_text_equal(&property, AZ_SPAN_FROM_STR("variant")))
+      {
+        variant = reader->token;
+      }
+      else if (az_json_token_is_text_equal(&property, AZ_SPAN_FROM_STR("seconds")))
+      {
+        _az_RETURN_IF_FAILED(az_json_token_get_double(&reader->token, &seconds));
+      }
+      else if (az_json_token_is_text_equal(&property, AZ_SPAN_FROM_STR("ns_per_op")))
+      {
+        _az_RETURN_IF_FAILED(az_json_token_get_double(&reader->token, &ns_per_op));
+      }
+      else
+      {
+        _az_RETURN_IF_FAILED(az_json_reader_skip_children(reader));
+      }
+
+      _az_RETURN_IF_FAILED(az_json_reader_next_token(reader));
+    }
+
+    if (name.kind != AZ_JSON_TOKEN_STRING || variant.kind != AZ_JSON_TOKEN_STRING)
+    {
+      return AZ_ERROR_ITEM_NOT_FOUND;
+    }
+
+    if (perf_results_compare_entry(&name, &variant, seconds, ns_per_op, max_slowdown))
+    {
+      (*out_slower_count)++;
+    }
+
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(reader));
+  }
+
+  return AZ_OK;
+}
+
+static uint8_t* perf_results_read_file(char const* path, int32_t* out_size)
+{
+  FILE* const file = fopen(path, "rb");
+  if (file == NULL)
+  {
+    return NULL;
+  }
+
+  uint8_t* buffer = NULL;
+  long size = 0;
+  if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) > 0 && size < INT32_MAX
+      && fseek(file, 0, SEEK_SET) == 0)
+  {
+    buffer = (uint8_t*)malloc((size_t)size);
+    if (buffer != NULL && fread(buffer, 1, (size_t)size, file) != (size_t)size)
+    {
+      free(buffer);
+      buffer = NULL;
+    }
+  }
+
+  (void)fclose(file);
+  *out_size = (int32_t)size;
+  return buffer;
+}
+
+int perf_results_compare(char const* baseline_path, double max_slowdown)
+{
+  int32_t size = 0;
+  uint8_t* const baseline = perf_results_read_file(baseline_path, &size);
+  if (baseline == NULL)
+  {
+    printf("perf_results_compare: failed to read %s\n", baseline_path);
+    return 1;
+  }
+
+  printf("\nCompared with %s:\n", baseline_path);
+  printf(
+      "%-60s %-32s %12s %12s %10s\n",
+      "benchmark",
+      "variant",
+      "baseline ns",
+      "ns/op",
+      "ratio");
+
+  int32_t slower_count = 0;
+  az_json_reader reader;
+  az_result result = az_json_reader_init(&reader, az_span_create(baseline, size), NULL);
+  if (az_result_succeeded(result))
+  {
+    result = perf_results_compare_baseline(&reader, max_slowdown, &slower_count);
+  }
+
+  free(baseline);
+  if (az_result_failed(result))
+  {
+    printf("perf_results_compare: %s is not a results file\n", baseline_path);
+    return 1;
+  }
+
+  for (int32_t i = 0; i < perf_results_count; i++)
+  {
+    if (!perf_results[i].compared)
+    {
+      printf("%-60s %-32s %12s\n", perf_results[i].name, perf_results[i].variant, "new");
+    }
+  }
+
+  if (slower_count > 0)
+  {
+    printf(
+        "%d benchmarks are more than %.2f times slower than the baseline\n",
+        (int)slower_count,
+        max_slowdown);
+    return 1;
+  }
+
+  return 0;
+}
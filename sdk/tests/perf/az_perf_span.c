@@ -0,0 +1,204 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_perf.h"
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  PERF_SPAN_BUFFER_SIZE = 1024,
+  PERF_SPAN_NUMBER_BUFFER_SIZE = 32,
+};
+
+typedef az_result (*perf_span_fn)(az_span input);
+
+// Accumulates values read from the results, so that the compiler can't discard the calls.
+static volatile int64_t perf_span_sink;
+
+// The text the searches and copies run over: a payload of the size of a typical message, with the
+// searched text at its end.
+static uint8_t perf_span_haystack[PERF_SPAN_BUFFER_SIZE];
+
+static int perf_span_run(
+    char const* name,
+    char const* variant,
+    perf_span_fn fn,
+    az_span input,
+    int32_t iterations)
+{
+  perf_result result = {
+    .name = name, .variant = variant, .seconds = 0, .bytes = 0, .items = 0, .cycles = 0
+  };
+
+  double const start = perf_now_seconds();
+  int64_t const start_cycles = perf_now_cycles();
+  for (int32_t i = 0; i < iterations; i++)
+  {
+    if (az_result_failed(fn(input)))
+    {
+      printf("%s: failed to process %s\n", name, variant);
+      return 1;
+    }
+  }
+  result.cycles = perf_now_cycles() - start_cycles;
+  result.seconds = perf_now_seconds() - start;
+  result.bytes = (int64_t)az_span_size(input) * iterations;
+  result.items = iterations;
+
+  perf_report(&result);
+  return 0;
+}
+
+static az_result perf_span_find(az_span input)
+{
+  int32_t const index = az_span_find(input, AZ_SPAN_FROM_STR("$version="));
+  perf_span_sink += index;
+  return index < 0 ? AZ_ERROR_ITEM_NOT_FOUND : AZ_OK;
+}
+
+static az_result perf_span_is_content_equal(az_span input)
+{
+  perf_span_sink
+      += az_span_is_content_equal(input, az_span_create(perf_span_haystack, 64)) ? 1 : 0;
+  return AZ_OK;
+}
+
+static az_result perf_span_is_content_equal_ignoring_case(az_span input)
+{
+  perf_span_sink
+      += az_span_is_content_equal_ignoring_case(input, AZ_SPAN_FROM_STR("content-type")) ? 1 : 0;
+  return AZ_OK;
+}
+
+static az_result perf_span_copy(az_span input)
+{
+  static uint8_t destination[PERF_SPAN_BUFFER_SIZE];
+  az_span const remainder = az_span_copy(AZ_SPAN_FROM_BUFFER(destination), input);
+  perf_span_sink += az_span_size(remainder) + destination[0];
+  return AZ_OK;
+}
+
+static az_result perf_span_atou64(az_span input)
+{
+  uint64_t number = 0;
+  az_result const result = az_span_atou64(input, &number);
+  perf_span_sink += (int64_t)number;
+  return result;
+}
+
+static az_result perf_span_atoi32(az_span input)
+{
+  int32_t number = 0;
+  az_result const result = az_span_atoi32(input, &number);
+  perf_span_sink += number;
+  return result;
+}
+
+static az_result perf_span_atod(az_span input)
+{
+  double number = 0;
+  az_result const result = az_span_atod(input, &number);
+  perf_span_sink += (int64_t)number;
+  return result;
+}
+
+static az_result perf_span_u64toa(az_span input)
+{
+  (void)input;
+
+  uint8_t buffer[PERF_SPAN_NUMBER_BUFFER_SIZE];
+  az_span remainder;
+  az_result const result
+      = az_span_u64toa(AZ_SPAN_FROM_BUFFER(buffer), 1234567890123ULL, &remainder);
+  perf_span_sink += az_span_size(remainder);
+  return result;
+}
+
+static az_result perf_span_i32toa(az_span input)
+{
+  (void)input;
+
+  uint8_t buffer[PERF_SPAN_NUMBER_BUFFER_SIZE];
+  az_span remainder;
+  az_result const result = az_span_i32toa(AZ_SPAN_FROM_BUFFER(buffer), -1234567, &remainder);
+  perf_span_sink += az_span_size(remainder);
+  return result;
+}
+
+static az_result perf_span_dtoa_shortest(az_span input)
+{
+  (void)input;
+
+  uint8_t buffer[PERF_SPAN_NUMBER_BUFFER_SIZE];
+  az_span remainder;
+  az_result const result = az_span_dtoa_shortest(AZ_SPAN_FROM_BUFFER(buffer), 21.37, &remainder);
+  perf_span_sink += az_span_size(remainder);
+  return result;
+}
+
+int perf_run_span(int32_t iterations)
+{
+  // Topic-like text, with the searched parameter at the end.
+  static char const pattern[] = "$iothub/twin/PATCH/properties/desired/";
+  static char const suffix[] = "?$version=42";
+  for (size_t i = 0; i < sizeof(perf_span_haystack); i++)
+  {
+    perf_span_haystack[i] = (uint8_t)pattern[i % (sizeof(pattern) - 1)];
+  }
+  memcpy(
+      perf_span_haystack + sizeof(perf_span_haystack) - (sizeof(suffix) - 1),
+      suffix,
+      sizeof(suffix) - 1);
+
+  az_span const haystack = AZ_SPAN_FROM_BUFFER(perf_span_haystack);
+
+  // The calls are short, so run them far more often than the JSON documents, for long enough to be
+  // compared with the results of another build.
+  int32_t const span_iterations = iterations * 1024;
+
+  int result = 0;
+  result |= perf_span_run("az_span_find", "1 KB", perf_span_find, haystack, iterations * 256);
+  result |= perf_span_run(
+      "az_span_is_content_equal",
+      "64 bytes",
+      perf_span_is_content_equal,
+      az_span_create(perf_span_haystack, 64),
+      span_iterations);
+  result |= perf_span_run(
+      "az_span_is_content_equal_ignoring_case",
+      "header name",
+      perf_span_is_content_equal_ignoring_case,
+      AZ_SPAN_FROM_STR("Content-Type"),
+      span_iterations);
+  result |= perf_span_run("az_span_copy", "1 KB", perf_span_copy, haystack, span_iterations);
+  result |= perf_span_run(
+      "az_span_atou64",
+      "13 digits",
+      perf_span_atou64,
+      AZ_SPAN_FROM_STR("1234567890123"),
+      span_iterations);
+  result |= perf_span_run(
+      "az_span_atoi32",
+      "-7 digits",
+      perf_span_atoi32,
+      AZ_SPAN_FROM_STR("-1234567"),
+      span_iterations);
+  result |= perf_span_run(
+      "az_span_atod", "decimal", perf_span_atod, AZ_SPAN_FROM_STR("21.375"), span_iterations);
+  result |= perf_span_run(
+      "az_span_u64toa", "13 digits", perf_span_u64toa, AZ_SPAN_EMPTY, span_iterations);
+  result |= perf_span_run(
+      "az_span_i32toa", "-7 digits", perf_span_i32toa, AZ_SPAN_EMPTY, span_iterations);
+  result |= perf_span_run(
+      "az_span_dtoa_shortest", "decimal", perf_span_dtoa_shortest, AZ_SPAN_EMPTY, span_iterations);
+  return result;
+}
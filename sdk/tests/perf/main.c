@@ -0,0 +1,149 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_perf.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PERF_HAS_CYCLE_COUNTER 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PERF_HAS_CYCLE_COUNTER 1
+#endif
+
+enum
+{
+  PERF_DEFAULT_ITERATIONS = 2000,
+};
+
+double perf_now_seconds(void) { return (double)clock() / (double)CLOCKS_PER_SEC; }
+
+int64_t perf_now_cycles(void)
+{
+#ifdef PERF_HAS_CYCLE_COUNTER
+  return (int64_t)__rdtsc();
+#else
+  return 0;
+#endif
+}
+
+void perf_report_header(void)
+{
+  printf(
+      "%-60s %-32s %12s %14s %10s %12s %10s\n",
+      "benchmark",
+      "variant",
+      "MB/s",
+      "items/s",
+      "ns/op",
+      "cycles/op",
+      "seconds");
+}
+
+void perf_report(perf_result const* result)
+{
+  // Avoid dividing by zero when the loop was too short to be measured by the clock.
+  double const seconds = result->seconds > 0 ? result->seconds : 1e-9;
+  double const items = result->items > 0 ? (double)result->items : 1;
+
+  printf(
+      "%-60s %-32s %12.2f %14.0f %10.1f %12.1f %10.3f\n",
+      result->name,
+      result->variant,
+      ((double)result->bytes / (1024.0 * 1024.0)) / seconds,
+      (double)result->items / seconds,
+      (result->seconds * 1e9) / items,
+      (double)result->cycles / items,
+      result->seconds);
+
+  perf_results_add(result);
+}
+
+static void usage(char const* program)
+{
+  printf(
+      "Usage: %s [--iterations N] [--json FILE] [--label TEXT] [--baseline FILE]"
+      " [--max-slowdown RATIO]\n",
+      program);
+  printf("  --json FILE           Writes the results, with the SDK version, the compiler, the\n");
+  printf("                        build flags and the CPU, to FILE as JSON.\n");
+  printf("  --label TEXT          Names the run in the JSON results, e.g. the commit.\n");
+  printf("  --baseline FILE       Compares the results with the JSON results of another run.\n");
+  printf("  --max-slowdown RATIO  Fails when a result costs more than RATIO times the baseline.\n");
+}
+
+int main(int argc, char** argv)
+{
+  int32_t iterations = PERF_DEFAULT_ITERATIONS;
+  char const* json_path = NULL;
+  char const* label = NULL;
+  char const* baseline_path = NULL;
+  double max_slowdown = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+    {
+      iterations = (int32_t)strtol(argv[++i], NULL, 10);
+    }
+    else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+    {
+      json_path = argv[++i];
+    }
+    else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc)
+    {
+      label = argv[++i];
+    }
+    else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+    {
+      baseline_path = argv[++i];
+    }
+    else if (strcmp(argv[i], "--max-slowdown") == 0 && i + 1 < argc)
+    {
+      max_slowdown = strtod(argv[++i], NULL);
+    }
+    else
+    {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (iterations <= 0 || max_slowdown < 0 || (max_slowdown > 0 && baseline_path == NULL))
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  perf_report_header();
+
+  // These also make up the training workload of profile-guided optimization builds, so they cover
+  // the hot paths of the JSON reader and writer and of the IoT topics.
+  int result = 0;
+  result |= perf_run_span(iterations);
+  result |= perf_run_json(iterations);
+  result |= perf_run_json_writer(iterations);
+  result |= perf_run_iot(iterations);
+  result |= perf_run_pipeline(iterations);
+
+  // The worst case of the parsers, on hostile input, rather than a typical workload.
+  result |= perf_run_adversarial(iterations);
+
+  if (json_path != NULL)
+  {
+    result |= perf_results_write_json(json_path, label, iterations);
+  }
+
+  if (baseline_path != NULL)
+  {
+    result |= perf_results_compare(baseline_path, max_slowdown);
+  }
+
+  return result;
+}